@@ -31,6 +31,7 @@
 #include <xkbcommon/xkbcommon-keysyms.h>
 #include <xkbcommon/xkbcommon.h>
 
+#include "libwlclient/dblbuf.h"
 #include "libwlclient/xdg_toplevel.h"
 #include "libwlclient/libwlclient.h"
 
@@ -63,7 +64,10 @@ static void _handle_key(__UNUSED__ struct wl_listener *listener_ptr,
 
 /* ------------------------------------------------------------------------- */
 /** Draws something into the buffer. */
-static bool _callback(bs_gfxbuf_t *gfxbuf_ptr, void *ud_ptr)
+static bool _callback(
+    bs_gfxbuf_t *gfxbuf_ptr,
+    __UNUSED__ wlcl_dblbuf_damage_t *damage_ptr,
+    void *ud_ptr)
 {
     static uint64_t ns_base = 0;
     wlclient_xdg_toplevel_t *toplevel_ptr = ud_ptr;
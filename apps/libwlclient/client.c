@@ -21,6 +21,7 @@
 #include "libwlclient.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <inttypes.h>
 #include <libbase/libbase.h>
 #include <poll.h>
@@ -32,6 +33,7 @@
 #include <string.h>
 #include <sys/mman.h>
 #include <sys/signalfd.h>
+#include <sys/timerfd.h>
 #include <unistd.h>
 #include <wayland-client-core.h>
 #include <wayland-client-protocol.h>
@@ -43,6 +45,11 @@
 #include "xdg-shell-client-protocol.h"
 #include "xdg-decoration-client-protocol.h"
 
+#if defined(WLCLIENT_HAVE_GBM)
+#include <gbm.h>
+#include "linux-dmabuf-unstable-v1-client-protocol.h"
+#endif  // defined(WLCLIENT_HAVE_GBM)
+
 struct wl_keyboard;
 struct wl_pointer;
 struct wl_registry;
@@ -75,9 +82,13 @@ struct _wlclient_t {
 
     /** List of registered timers. TODO(kaeser@gubbe.ch): Replace with HEAP. */
     bs_dllist_t               timers;
+    /** Timer file descriptor, armed for the first of the registered timers. */
+    int                       timer_fd;
 
     /** File descriptor to monitor SIGINT. */
     int                       signal_fd;
+    /** File descriptor of the render node backing the GBM device. */
+    int                       gbm_fd;
 
     /** Whether to keep the client running. */
     volatile bool             keep_running;
@@ -93,8 +104,18 @@ typedef struct {
     wlclient_callback_t       callback;
     /** Argument to the callback. */
     void                      *callback_ud_ptr;
+    /** Period, for a @ref wlclient_periodic_timer_t. 0 for one-time. */
+    uint64_t                  period_usec;
 } wlclient_timer_t;
 
+/** State of a periodic timer. */
+struct _wlclient_periodic_timer_t {
+    /** The registered timer. Re-inserted after triggering. */
+    wlclient_timer_t          timer;
+    /** Back-link to the client. */
+    wlclient_t                *client_ptr;
+};
+
 /** Descriptor for a wayland object to bind to. */
 typedef struct {
     /** The interface definition. */
@@ -129,6 +150,13 @@ static wlclient_timer_t *wlc_timer_create(
     void *callback_ud_ptr);
 static void wlc_timer_destroy(
     wlclient_timer_t *timer_ptr);
+static void wlc_timer_insert(
+    wlclient_t *client_ptr,
+    wlclient_timer_t *timer_ptr);
+static bool wlc_timer_fd_arm(wlclient_t *client_ptr);
+static void wlc_timers_flush(wlclient_t *client_ptr);
+
+static void wlc_gbm_device_open(wlclient_t *client_ptr);
 
 static void wlc_seat_setup(wlclient_t *client_ptr);
 static void wlc_seat_handle_capabilities(
@@ -278,6 +306,10 @@ static const object_t objects[] = {
       offsetof(wlclient_attributes_t, icon_manager_ptr), NULL },
     { &zxdg_decoration_manager_v1_interface, 1,
       offsetof(wlclient_attributes_t, xdg_decoration_manager_ptr), NULL },
+#if defined(WLCLIENT_HAVE_GBM)
+    { &zwp_linux_dmabuf_v1_interface, 3,
+      offsetof(wlclient_attributes_t, linux_dmabuf_ptr), NULL },
+#endif  // defined(WLCLIENT_HAVE_GBM)
     { NULL, 0, 0, NULL }  // sentinel.
 
 };
@@ -327,6 +359,15 @@ wlclient_t *wlclient_create(const char *app_id_ptr)
         return NULL;
     }
 
+    wlclient_ptr->timer_fd = timerfd_create(
+        CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (0 >= wlclient_ptr->timer_fd) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed timerfd_create(CLOCK_REALTIME, "
+               "TFD_NONBLOCK | TFD_CLOEXEC)");
+        wlclient_destroy(wlclient_ptr);
+        return NULL;
+    }
+
     wlclient_ptr->xkb_context_ptr = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
     if (NULL == wlclient_ptr->xkb_context_ptr) {
         bs_log(BS_ERROR, "Failex xkb_context_new(XKB_CONTEXT_NO_FLAGS)");
@@ -378,6 +419,7 @@ wlclient_t *wlclient_create(const char *app_id_ptr)
         wlclient_destroy(wlclient_ptr);
         return NULL;
     }
+    wlc_gbm_device_open(wlclient_ptr);
 
     return wlclient_ptr;
 }
@@ -387,7 +429,25 @@ void wlclient_destroy(wlclient_t *wlclient_ptr)
 {
     bs_dllist_node_t *dlnode_ptr;
     while (NULL != (dlnode_ptr = bs_dllist_pop_front(&wlclient_ptr->timers))) {
-        wlc_timer_destroy((wlclient_timer_t*)dlnode_ptr);
+        wlclient_timer_t *timer_ptr = (wlclient_timer_t*)dlnode_ptr;
+        // Periodic timers are owned, and must be destroyed, by the caller.
+        BS_ASSERT(0 == timer_ptr->period_usec);
+        wlc_timer_destroy(timer_ptr);
+    }
+    if (0 < wlclient_ptr->timer_fd) {
+        close(wlclient_ptr->timer_fd);
+        wlclient_ptr->timer_fd = 0;
+    }
+
+#if defined(WLCLIENT_HAVE_GBM)
+    if (NULL != wlclient_ptr->attributes.gbm_device_ptr) {
+        gbm_device_destroy(wlclient_ptr->attributes.gbm_device_ptr);
+        wlclient_ptr->attributes.gbm_device_ptr = NULL;
+    }
+#endif  // defined(WLCLIENT_HAVE_GBM)
+    if (0 < wlclient_ptr->gbm_fd) {
+        close(wlclient_ptr->gbm_fd);
+        wlclient_ptr->gbm_fd = 0;
     }
 
     if (NULL != wlclient_ptr->wl_registry_ptr) {
@@ -465,7 +525,12 @@ void wlclient_run(wlclient_t *wlclient_ptr)
             }
         }
 
-        struct pollfd pollfds[2];
+        if (!wlc_timer_fd_arm(wlclient_ptr)) {
+            wl_display_cancel_read(wlclient_ptr->attributes.wl_display_ptr);
+            break;  // Error!
+        }
+
+        struct pollfd pollfds[3];
         pollfds[0].fd = wl_display_get_fd(wlclient_ptr->attributes.wl_display_ptr);
         pollfds[0].events = POLLIN;
         pollfds[0].revents = 0;
@@ -474,9 +539,13 @@ void wlclient_run(wlclient_t *wlclient_ptr)
         pollfds[1].events = POLLIN;
         pollfds[1].revents = 0;
 
-        int rv = poll(&pollfds[0], 2, 100);
+        pollfds[2].fd = wlclient_ptr->timer_fd;
+        pollfds[2].events = POLLIN;
+        pollfds[2].revents = 0;
+
+        int rv = poll(&pollfds[0], 3, -1);
         if (0 > rv && EINTR != errno) {
-            bs_log(BS_ERROR | BS_ERRNO, "Failed poll(%p, 1, 100)", &pollfds);
+            bs_log(BS_ERROR | BS_ERRNO, "Failed poll(%p, 3, -1)", &pollfds);
             wl_display_cancel_read(wlclient_ptr->attributes.wl_display_ptr);
             break;  // Error!
         }
@@ -528,17 +597,18 @@ void wlclient_run(wlclient_t *wlclient_ptr)
             break;  // Error!
         }
 
-        // Flush the timer queue.
-        uint64_t current_usec = bs_usec();
-        bs_dllist_node_t *dlnode_ptr;
-        while (NULL != (dlnode_ptr = wlclient_ptr->timers.head_ptr) &&
-               ((wlclient_timer_t*)dlnode_ptr)->target_usec <= current_usec) {
-            bs_dllist_pop_front(&wlclient_ptr->timers);
-
-            wlclient_timer_t *timer_ptr = (wlclient_timer_t*)dlnode_ptr;
-            timer_ptr->callback(wlclient_ptr, timer_ptr->callback_ud_ptr);
-            wlc_timer_destroy(timer_ptr);
+        if (pollfds[2].revents & POLLIN) {
+            uint64_t expirations;
+            if (0 > read(wlclient_ptr->timer_fd,
+                         &expirations, sizeof(expirations)) &&
+                EAGAIN != errno) {
+                bs_log(BS_ERROR | BS_ERRNO, "Failed read(%d, %p, %zu)",
+                       wlclient_ptr->timer_fd, &expirations,
+                       sizeof(expirations));
+                break;
+            }
         }
+        wlc_timers_flush(wlclient_ptr);
 
     } while (wlclient_ptr->keep_running);
 }
@@ -561,6 +631,37 @@ bool wlclient_register_timer(
     return (timer_ptr != NULL);
 }
 
+/* ------------------------------------------------------------------------- */
+wlclient_periodic_timer_t *wlclient_periodic_timer_create(
+    wlclient_t *wlclient_ptr,
+    uint64_t period_usec,
+    wlclient_callback_t callback,
+    void *callback_ud_ptr)
+{
+    BS_ASSERT(0 < period_usec);
+    wlclient_periodic_timer_t *periodic_timer_ptr = logged_calloc(
+        1, sizeof(wlclient_periodic_timer_t));
+    if (NULL == periodic_timer_ptr) return NULL;
+    periodic_timer_ptr->client_ptr = wlclient_ptr;
+
+    wlclient_timer_t *timer_ptr = &periodic_timer_ptr->timer;
+    timer_ptr->period_usec = period_usec;
+    timer_ptr->target_usec = (bs_usec() / period_usec + 1) * period_usec;
+    timer_ptr->callback = callback;
+    timer_ptr->callback_ud_ptr = callback_ud_ptr;
+    wlc_timer_insert(wlclient_ptr, timer_ptr);
+    return periodic_timer_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlclient_periodic_timer_destroy(
+    wlclient_periodic_timer_t *periodic_timer_ptr)
+{
+    bs_dllist_remove(&periodic_timer_ptr->client_ptr->timers,
+                     &periodic_timer_ptr->timer.dlnode);
+    free(periodic_timer_ptr);
+}
+
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -675,7 +776,19 @@ wlclient_timer_t *wlc_timer_create(
     timer_ptr->target_usec = target_usec;
     timer_ptr->callback = callback;
     timer_ptr->callback_ud_ptr = callback_ud_ptr;
+    wlc_timer_insert(client_ptr, timer_ptr);
+    return timer_ptr;
+}
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Inserts the timer into @ref wlclient_t::timers, ordered by target time.
+ *
+ * @param client_ptr
+ * @param timer_ptr
+ */
+void wlc_timer_insert(wlclient_t *client_ptr, wlclient_timer_t *timer_ptr)
+{
     // TODO(kaeser@gubbe.ch): This should be a HEAP.
     bs_dllist_node_t *dlnode_ptr = client_ptr->timers.head_ptr;
     for (; dlnode_ptr != NULL; dlnode_ptr = dlnode_ptr->next_ptr) {
@@ -683,12 +796,70 @@ wlclient_timer_t *wlc_timer_create(
         if (timer_ptr->target_usec > ref_timer_ptr->target_usec) continue;
         bs_dllist_insert_node_before(
             &client_ptr->timers, dlnode_ptr, &timer_ptr->dlnode);
+        return;
+    }
+    bs_dllist_push_back(&client_ptr->timers, &timer_ptr->dlnode);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Arms @ref wlclient_t::timer_fd for the first registered timer, or disarms
+ * it if there is none.
+ *
+ * @param client_ptr
+ *
+ * @return true on success.
+ */
+bool wlc_timer_fd_arm(wlclient_t *client_ptr)
+{
+    struct itimerspec spec = {};
+    bs_dllist_node_t *dlnode_ptr = client_ptr->timers.head_ptr;
+    if (NULL != dlnode_ptr) {
+        // An all-zero value disarms: Round up to fire right away.
+        uint64_t target_usec = BS_MAX(
+            ((wlclient_timer_t*)dlnode_ptr)->target_usec, 1);
+        spec.it_value.tv_sec = target_usec / 1000000;
+        spec.it_value.tv_nsec = (target_usec % 1000000) * 1000;
     }
-    if (NULL == dlnode_ptr) {
-        bs_dllist_push_back(&client_ptr->timers, &timer_ptr->dlnode);
+    if (0 != timerfd_settime(
+            client_ptr->timer_fd, TFD_TIMER_ABSTIME, &spec, NULL)) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed timerfd_settime(%d, "
+               "TFD_TIMER_ABSTIME, %p, NULL)", client_ptr->timer_fd, &spec);
+        return false;
     }
+    return true;
+}
 
-    return timer_ptr;
+/* ------------------------------------------------------------------------- */
+/**
+ * Calls the timers that are due. One-time timers are destroyed, periodic
+ * timers are re-inserted at their next period. Periods that were missed
+ * are skipped, so the timer stays aligned to the period.
+ *
+ * @param client_ptr
+ */
+void wlc_timers_flush(wlclient_t *client_ptr)
+{
+    uint64_t current_usec = bs_usec();
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = client_ptr->timers.head_ptr) &&
+           ((wlclient_timer_t*)dlnode_ptr)->target_usec <= current_usec) {
+        bs_dllist_pop_front(&client_ptr->timers);
+        wlclient_timer_t *timer_ptr = (wlclient_timer_t*)dlnode_ptr;
+
+        if (0 < timer_ptr->period_usec) {
+            // Re-insert before the callback: It may destroy the timer.
+            uint64_t period_usec = timer_ptr->period_usec;
+            timer_ptr->target_usec = (
+                current_usec / period_usec + 1) * period_usec;
+            wlc_timer_insert(client_ptr, timer_ptr);
+            timer_ptr->callback(client_ptr, timer_ptr->callback_ud_ptr);
+            continue;
+        }
+
+        timer_ptr->callback(client_ptr, timer_ptr->callback_ud_ptr);
+        wlc_timer_destroy(timer_ptr);
+    }
 }
 
 /* ------------------------------------------------------------------------- */
@@ -702,6 +873,50 @@ void wlc_timer_destroy(wlclient_timer_t *timer_ptr)
     free(timer_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Opens the GBM device on the render node from `WLCLIENT_DMABUF_DEVICE`, if
+ * that is set and linux-dmabuf is supported. Buffers then get allocated
+ * from GBM and shared as dmabuf, rather than through `wl_shm`.
+ *
+ * Failures are logged, and the client falls back to `wl_shm`.
+ *
+ * @param client_ptr
+ */
+void wlc_gbm_device_open(wlclient_t *client_ptr)
+{
+    const char *device_ptr = getenv("WLCLIENT_DMABUF_DEVICE");
+    if (NULL == device_ptr || '\0' == *device_ptr) return;
+    if (NULL == client_ptr->attributes.linux_dmabuf_ptr) {
+        bs_log(BS_WARNING, "'zwp_linux_dmabuf_v1' not bound, or built "
+               "without GBM. Using wl_shm.");
+        return;
+    }
+
+#if defined(WLCLIENT_HAVE_GBM)
+
+    client_ptr->gbm_fd = open(device_ptr, O_RDWR | O_CLOEXEC);
+    if (0 >= client_ptr->gbm_fd) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed open(\"%s\", O_RDWR | "
+               "O_CLOEXEC). Using wl_shm.", device_ptr);
+        client_ptr->gbm_fd = 0;
+        return;
+    }
+
+    client_ptr->attributes.gbm_device_ptr = gbm_create_device(
+        client_ptr->gbm_fd);
+    if (NULL == client_ptr->attributes.gbm_device_ptr) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed gbm_create_device(%d) for "
+               "\"%s\". Using wl_shm.", client_ptr->gbm_fd, device_ptr);
+        close(client_ptr->gbm_fd);
+        client_ptr->gbm_fd = 0;
+        return;
+    }
+    bs_log(BS_INFO, "Using dmabuf buffers from GBM device \"%s\"",
+           device_ptr);
+#endif  // defined(WLCLIENT_HAVE_GBM)
+}
+
 /* ------------------------------------------------------------------------- */
 /** Set up the seat: Registers the client's seat listeners. */
 void wlc_seat_setup(wlclient_t *client_ptr)
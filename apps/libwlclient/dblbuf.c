@@ -31,23 +31,38 @@
 #include <unistd.h>
 #include <wayland-client-protocol.h>
 
+#if defined(WLCLIENT_HAVE_GBM)
+#include <gbm.h>
+#include "linux-dmabuf-unstable-v1-client-protocol.h"
+#endif  // defined(WLCLIENT_HAVE_GBM)
+
+struct gbm_bo;
 struct wl_buffer;
 struct wl_callback;
 struct wl_shm_pool;
 
 /* == Declarations ========================================================= */
 
-/** How many buffers to hold for the double buffer: Two. */
-#define _WLCL_DBLBUF_NUM 2
-
-/** A single buffer. Two of these are backing the double-buffer. */
+/** A single buffer. A few of these are backing the double-buffer. */
 typedef struct {
     /** The wayland buffer structure. */
     struct wl_buffer          *wl_buffer_ptr;
-    /** Pixel buffer we're using for clients. */
+    /**
+     * Pixel buffer we're using for clients. For a `wl_shm` buffer, this
+     * lasts as long as the buffer. For a GBM buffer object, only while it
+     * is mapped.
+     */
     bs_gfxbuf_t               *gfxbuf_ptr;
+    /** The GBM buffer object, if shared as dmabuf. NULL for `wl_shm`. */
+    struct gbm_bo             *gbm_bo_ptr;
+    /** Mapping data of `gbm_bo_ptr`, while it is mapped. */
+    void                      *gbm_map_data_ptr;
     /** Back-link to the double-buffer. */
     wlcl_dblbuf_t             *dblbuf_ptr;
+    /** Regions that differ from @ref wlcl_dblbuf_t::committed_buffer_ptr. */
+    wlcl_dblbuf_damage_t      stale;
+    /** Sequence number of the frame last committed from it. 0 if none. */
+    uint64_t                  frame;
 } wlcl_buffer_t;
 
 /** State of double-buffered shared memory. */
@@ -57,15 +72,23 @@ struct _wlcl_dblbuf_t {
     /** Height of the buffer, in pixels. */
     unsigned                  height;
 
-    /** Holds the two @ref wlcl_buffer_t backing this double buffer. */
-    wlcl_buffer_t             buffers[_WLCL_DBLBUF_NUM];
+    /** Number of buffers, ie. pages of the shared memory. */
+    unsigned                  num_buffers;
+    /** Holds the @ref wlcl_buffer_t backing this double buffer. */
+    wlcl_buffer_t             *buffers;
 
     /** Holds @ref wlcl_dblbuf_t::buffers items that are released. */
-    wlcl_buffer_t             *released_buffer_ptrs[_WLCL_DBLBUF_NUM];
+    wlcl_buffer_t             **released_buffer_ptrs;
     /** Number of items in @ref wlcl_dblbuf_t::released_buffer_ptrs. */
     int                       released;
+    /** Number of frames committed so far. */
+    uint64_t                  frames;
     /** Indicates that a frame is due to be drawn. */
     bool                      frame_is_due;
+    /** Whether the surface is visible. No frames are drawn if not. */
+    bool                      visible;
+    /** The buffer committed last, or NULL if none was committed yet. */
+    wlcl_buffer_t             *committed_buffer_ptr;
 
     /** Blob of memory-mapped buffer data. */
     void                      *data_ptr;
@@ -82,11 +105,30 @@ struct _wlcl_dblbuf_t {
 };
 
 static void _wlcl_dblbuf_callback_if_ready(wlcl_dblbuf_t *dblbuf_ptr);
+static wlcl_buffer_t *_wlcl_dblbuf_take_youngest(wlcl_dblbuf_t *dblbuf_ptr);
+static void _wlcl_dblbuf_copy_forward(
+    wlcl_dblbuf_t *dblbuf_ptr,
+    wlcl_buffer_t *buffer_ptr);
+static void _wlcl_dblbuf_damage_clip(
+    wlcl_dblbuf_damage_t *damage_ptr,
+    int width,
+    int height);
 static void _wlcl_dblbuf_handle_frame_done(
     void *data_ptr,
     struct wl_callback *callback,
     __UNUSED__ uint32_t time);
 
+static bool _wlcl_dblbuf_create_shm_buffers(
+    wlcl_dblbuf_t *dblbuf_ptr,
+    const char *app_id_ptr,
+    struct wl_shm *wl_shm_ptr);
+static bool _wlcl_dblbuf_create_dmabuf_buffers(
+    wlcl_dblbuf_t *dblbuf_ptr,
+    struct gbm_device *gbm_device_ptr,
+    struct zwp_linux_dmabuf_v1 *linux_dmabuf_ptr);
+static bool _wlcl_buffer_map(wlcl_buffer_t *buffer_ptr);
+static void _wlcl_buffer_unmap(wlcl_buffer_t *buffer_ptr);
+
 static bool _wlcl_dblbuf_create_buffer(
     wlcl_buffer_t *buffer_ptr,
     wlcl_dblbuf_t *dblbuf_ptr,
@@ -122,50 +164,36 @@ wlcl_dblbuf_t *wlcl_dblbuf_create(
     const char *app_id_ptr,
     struct wl_surface *wl_surface_ptr,
     struct wl_shm *wl_shm_ptr,
+    struct zwp_linux_dmabuf_v1 *linux_dmabuf_ptr,
+    struct gbm_device *gbm_device_ptr,
     unsigned width,
-    unsigned height)
+    unsigned height,
+    unsigned num_buffers)
 {
+    BS_ASSERT(2 <= num_buffers);
     wlcl_dblbuf_t *dblbuf_ptr = logged_calloc(1, sizeof(wlcl_dblbuf_t));
     if (NULL == dblbuf_ptr) return NULL;
     dblbuf_ptr->width = width;
     dblbuf_ptr->height = height;
     dblbuf_ptr->wl_surface_ptr = BS_ASSERT_NOTNULL(wl_surface_ptr);
 
-    dblbuf_ptr->data_size = 2 * width * height * sizeof(uint32_t);
-    int fd = _wlcl_dblbuf_shm_create(app_id_ptr, dblbuf_ptr->data_size);
-    if (0 >= fd) goto error;
-
-    dblbuf_ptr->data_ptr = mmap(
-        NULL, dblbuf_ptr->data_size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
-    if (MAP_FAILED == dblbuf_ptr->data_ptr) {
-        bs_log(BS_ERROR | BS_ERRNO, "Failed mmap(NULL, %zu, "
-               "PROT_READ|PROT_WRITE, MAP_SHARED, %d, 0)",
-               dblbuf_ptr->data_size, fd);
-        close(fd);
-        goto error;
-    }
-
-    struct wl_shm_pool *wl_shm_pool_ptr = wl_shm_create_pool(
-        wl_shm_ptr, fd, dblbuf_ptr->data_size);
-    close(fd);
-    if (NULL == wl_shm_pool_ptr) {
-        bs_log(BS_ERROR, "Failed wl_shm_create_pool(%p, %d, %zu)",
-               wl_shm_ptr, fd, dblbuf_ptr->data_size);
-        goto error;
-    }
-
-    for (int i = 0; i < _WLCL_DBLBUF_NUM; ++i) {
-        if (_wlcl_dblbuf_create_buffer(
-                &dblbuf_ptr->buffers[i], dblbuf_ptr,
-                wl_shm_pool_ptr, i, width, height)) {
-            _wlcl_dblbuf_handle_wl_buffer_release(
-                &dblbuf_ptr->buffers[i],
-                dblbuf_ptr->buffers[i].wl_buffer_ptr);
-        }
+    dblbuf_ptr->buffers = logged_calloc(num_buffers, sizeof(wlcl_buffer_t));
+    if (NULL == dblbuf_ptr->buffers) goto error;
+    dblbuf_ptr->num_buffers = num_buffers;
+    dblbuf_ptr->released_buffer_ptrs = logged_calloc(
+        num_buffers, sizeof(wlcl_buffer_t*));
+    if (NULL == dblbuf_ptr->released_buffer_ptrs) goto error;
+
+    if (NULL != gbm_device_ptr && NULL != linux_dmabuf_ptr) {
+        if (!_wlcl_dblbuf_create_dmabuf_buffers(
+                dblbuf_ptr, gbm_device_ptr, linux_dmabuf_ptr)) goto error;
+    } else {
+        if (!_wlcl_dblbuf_create_shm_buffers(
+                dblbuf_ptr, app_id_ptr, wl_shm_ptr)) goto error;
     }
-    if (dblbuf_ptr->released != _WLCL_DBLBUF_NUM) goto error;
 
     dblbuf_ptr->frame_is_due = true;
+    dblbuf_ptr->visible = true;
     return dblbuf_ptr;
 
 error:
@@ -176,16 +204,32 @@ error:
 /* ------------------------------------------------------------------------- */
 void wlcl_dblbuf_destroy(wlcl_dblbuf_t *dblbuf_ptr)
 {
-    for (int i = 0; i < _WLCL_DBLBUF_NUM; ++i) {
+    for (unsigned i = 0; i < dblbuf_ptr->num_buffers; ++i) {
         wlcl_buffer_t *buffer_ptr = &dblbuf_ptr->buffers[i];
         if (NULL != buffer_ptr->wl_buffer_ptr) {
             wl_buffer_destroy(buffer_ptr->wl_buffer_ptr);
             buffer_ptr->wl_buffer_ptr = NULL;
         }
+        _wlcl_buffer_unmap(buffer_ptr);
         if (NULL != buffer_ptr->gfxbuf_ptr) {
             bs_gfxbuf_destroy(buffer_ptr->gfxbuf_ptr);
             buffer_ptr->gfxbuf_ptr = NULL;
         }
+#if defined(WLCLIENT_HAVE_GBM)
+        if (NULL != buffer_ptr->gbm_bo_ptr) {
+            gbm_bo_destroy(buffer_ptr->gbm_bo_ptr);
+            buffer_ptr->gbm_bo_ptr = NULL;
+        }
+#endif  // defined(WLCLIENT_HAVE_GBM)
+    }
+
+    if (NULL != dblbuf_ptr->buffers) {
+        free(dblbuf_ptr->buffers);
+        dblbuf_ptr->buffers = NULL;
+    }
+    if (NULL != dblbuf_ptr->released_buffer_ptrs) {
+        free(dblbuf_ptr->released_buffer_ptrs);
+        dblbuf_ptr->released_buffer_ptrs = NULL;
     }
 
     if (NULL != dblbuf_ptr->data_ptr) {
@@ -207,39 +251,106 @@ void wlcl_dblbuf_register_ready_callback(
     _wlcl_dblbuf_callback_if_ready(dblbuf_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+void wlcl_dblbuf_set_visible(wlcl_dblbuf_t *dblbuf_ptr, bool visible)
+{
+    if (dblbuf_ptr->visible == visible) return;
+    dblbuf_ptr->visible = visible;
+    _wlcl_dblbuf_callback_if_ready(dblbuf_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlcl_dblbuf_damage_add(
+    wlcl_dblbuf_damage_t *damage_ptr,
+    int x,
+    int y,
+    int width,
+    int height)
+{
+    if (0 >= width || 0 >= height) return;
+
+    if (WLCL_DBLBUF_DAMAGE_RECTS > damage_ptr->num_rects) {
+        damage_ptr->rects[damage_ptr->num_rects++] = (wlcl_dblbuf_rect_t){
+            .x = x, .y = y, .width = width, .height = height };
+        return;
+    }
+
+    // Out of rectangles: Merge into the last one's bounding box.
+    wlcl_dblbuf_rect_t *r_ptr = &damage_ptr->rects[damage_ptr->num_rects - 1];
+    int x2 = BS_MAX(r_ptr->x + r_ptr->width, x + width);
+    int y2 = BS_MAX(r_ptr->y + r_ptr->height, y + height);
+    r_ptr->x = BS_MIN(r_ptr->x, x);
+    r_ptr->y = BS_MIN(r_ptr->y, y);
+    r_ptr->width = x2 - r_ptr->x;
+    r_ptr->height = y2 - r_ptr->y;
+}
+
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
 /**
  * Calls @ref wlcl_dblbuf_t::callback, if it is registered, a frame is due,
- * and if there are available buffers. If so, and if the callback returns
- * true, the corresponding buffer will be attached to the surface and the
- * surface is committed.
+ * the surface is visible and if there are available buffers. If so, and if
+ * the callback returns true, the corresponding buffer will be attached to
+ * the surface and the surface is committed.
  *
  * @param dblbuf_ptr
  */
 void _wlcl_dblbuf_callback_if_ready(wlcl_dblbuf_t *dblbuf_ptr)
 {
-    // Only proceed a frame is due, the client asked, and we have a buffer.
+    // Only proceed a frame is due, the client asked, the surface is shown,
+    // and we have a buffer.
     if (!dblbuf_ptr->callback ||
         !dblbuf_ptr->frame_is_due ||
+        !dblbuf_ptr->visible ||
         0 >= dblbuf_ptr->released) return;
 
-    wlcl_buffer_t *buffer_ptr =
-        dblbuf_ptr->released_buffer_ptrs[--dblbuf_ptr->released];
+    wlcl_buffer_t *buffer_ptr = _wlcl_dblbuf_take_youngest(dblbuf_ptr);
+    if (!_wlcl_buffer_map(buffer_ptr)) {
+        dblbuf_ptr->released_buffer_ptrs[dblbuf_ptr->released++] = buffer_ptr;
+        return;
+    }
     dblbuf_ptr->frame_is_due = false;
     wlcl_dblbuf_ready_callback_t callback = dblbuf_ptr->callback;
     dblbuf_ptr->callback = NULL;
-    if (!callback(
-            buffer_ptr->gfxbuf_ptr,
-            dblbuf_ptr->callback_ud_ptr)) {
+    _wlcl_dblbuf_copy_forward(dblbuf_ptr, buffer_ptr);
+
+    wlcl_dblbuf_damage_t damage = {};
+    bool drawn = callback(
+        buffer_ptr->gfxbuf_ptr,
+        &damage,
+        dblbuf_ptr->callback_ud_ptr);
+    _wlcl_buffer_unmap(buffer_ptr);
+    if (!drawn) {
         dblbuf_ptr->released_buffer_ptrs[dblbuf_ptr->released++] = buffer_ptr;
         dblbuf_ptr->frame_is_due = true;
+        // The callback may have drawn partially. Restore it in full.
+        buffer_ptr->stale.num_rects = 0;
+        wlcl_dblbuf_damage_add(&buffer_ptr->stale, 0, 0,
+                               dblbuf_ptr->width, dblbuf_ptr->height);
         return;
     }
-
-    wl_surface_damage_buffer(
-        dblbuf_ptr->wl_surface_ptr, 0, 0, INT32_MAX, INT32_MAX);
+    if (0 >= damage.num_rects) {
+        wlcl_dblbuf_damage_add(&damage, 0, 0,
+                               dblbuf_ptr->width, dblbuf_ptr->height);
+    }
+    _wlcl_dblbuf_damage_clip(&damage, dblbuf_ptr->width, dblbuf_ptr->height);
+
+    // Report the damage, and mark it as stale in the other buffers.
+    for (int r = 0; r < damage.num_rects; ++r) {
+        wlcl_dblbuf_rect_t *r_ptr = &damage.rects[r];
+        wl_surface_damage_buffer(
+            dblbuf_ptr->wl_surface_ptr,
+            r_ptr->x, r_ptr->y, r_ptr->width, r_ptr->height);
+        for (unsigned i = 0; i < dblbuf_ptr->num_buffers; ++i) {
+            if (&dblbuf_ptr->buffers[i] == buffer_ptr) continue;
+            wlcl_dblbuf_damage_add(
+                &dblbuf_ptr->buffers[i].stale,
+                r_ptr->x, r_ptr->y, r_ptr->width, r_ptr->height);
+        }
+    }
+    dblbuf_ptr->committed_buffer_ptr = buffer_ptr;
+    buffer_ptr->frame = ++dblbuf_ptr->frames;
 
     struct wl_callback *wl_callback = wl_surface_frame(
         dblbuf_ptr->wl_surface_ptr);
@@ -256,6 +367,87 @@ void _wlcl_dblbuf_callback_if_ready(wlcl_dblbuf_t *dblbuf_ptr)
     wl_surface_commit(dblbuf_ptr->wl_surface_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Takes the released buffer that was committed most recently, ie. the one
+ * with the lowest age. It has the least stale regions to copy forward.
+ *
+ * @param dblbuf_ptr
+ *
+ * @return Pointer to the buffer, removed from the released buffers.
+ */
+wlcl_buffer_t *_wlcl_dblbuf_take_youngest(wlcl_dblbuf_t *dblbuf_ptr)
+{
+    wlcl_buffer_t **released_ptrs = dblbuf_ptr->released_buffer_ptrs;
+    int youngest = dblbuf_ptr->released - 1;
+    for (int i = 0; i < dblbuf_ptr->released - 1; ++i) {
+        if (released_ptrs[i]->frame > released_ptrs[youngest]->frame) {
+            youngest = i;
+        }
+    }
+
+    wlcl_buffer_t *buffer_ptr = released_ptrs[youngest];
+    released_ptrs[youngest] = released_ptrs[--dblbuf_ptr->released];
+    return buffer_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Brings `buffer_ptr` up to date with the buffer committed last, by copying
+ * the regions that are stale in `buffer_ptr`.
+ *
+ * @param dblbuf_ptr
+ * @param buffer_ptr
+ */
+void _wlcl_dblbuf_copy_forward(
+    wlcl_dblbuf_t *dblbuf_ptr,
+    wlcl_buffer_t *buffer_ptr)
+{
+    wlcl_buffer_t *committed_ptr = dblbuf_ptr->committed_buffer_ptr;
+    if (NULL != committed_ptr &&
+        buffer_ptr != committed_ptr &&
+        0 < buffer_ptr->stale.num_rects &&
+        _wlcl_buffer_map(committed_ptr)) {
+        for (int r = 0; r < buffer_ptr->stale.num_rects; ++r) {
+            wlcl_dblbuf_rect_t *r_ptr = &buffer_ptr->stale.rects[r];
+            bs_gfxbuf_copy_area(
+                buffer_ptr->gfxbuf_ptr, r_ptr->x, r_ptr->y,
+                committed_ptr->gfxbuf_ptr, r_ptr->x, r_ptr->y,
+                r_ptr->width, r_ptr->height);
+        }
+        _wlcl_buffer_unmap(committed_ptr);
+    }
+    buffer_ptr->stale.num_rects = 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Clips the rectangles of the damaged region to the buffer's dimensions,
+ * and drops those that end up empty.
+ *
+ * @param damage_ptr
+ * @param width
+ * @param height
+ */
+void _wlcl_dblbuf_damage_clip(
+    wlcl_dblbuf_damage_t *damage_ptr,
+    int width,
+    int height)
+{
+    int num_rects = 0;
+    for (int r = 0; r < damage_ptr->num_rects; ++r) {
+        wlcl_dblbuf_rect_t *r_ptr = &damage_ptr->rects[r];
+        int x1 = BS_MAX(r_ptr->x, 0);
+        int y1 = BS_MAX(r_ptr->y, 0);
+        int x2 = BS_MIN(r_ptr->x + r_ptr->width, width);
+        int y2 = BS_MIN(r_ptr->y + r_ptr->height, height);
+        if (x1 >= x2 || y1 >= y2) continue;
+        damage_ptr->rects[num_rects++] = (wlcl_dblbuf_rect_t){
+            .x = x1, .y = y1, .width = x2 - x1, .height = y2 - y1 };
+    }
+    damage_ptr->num_rects = num_rects;
+}
+
 /* ------------------------------------------------------------------------- */
 /** Callback for when the compositor indicates a frame is due. */
 void _wlcl_dblbuf_handle_frame_done(
@@ -270,6 +462,196 @@ void _wlcl_dblbuf_handle_frame_done(
     _wlcl_dblbuf_callback_if_ready(dblbuf_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates the buffers as pages of a `wl_shm` pool.
+ *
+ * @param dblbuf_ptr
+ * @param app_id_ptr
+ * @param wl_shm_ptr
+ *
+ * @return true on success.
+ */
+bool _wlcl_dblbuf_create_shm_buffers(
+    wlcl_dblbuf_t *dblbuf_ptr,
+    const char *app_id_ptr,
+    struct wl_shm *wl_shm_ptr)
+{
+    dblbuf_ptr->data_size = dblbuf_ptr->num_buffers * dblbuf_ptr->width *
+        dblbuf_ptr->height * sizeof(uint32_t);
+    int fd = _wlcl_dblbuf_shm_create(app_id_ptr, dblbuf_ptr->data_size);
+    if (0 >= fd) return false;
+
+    dblbuf_ptr->data_ptr = mmap(
+        NULL, dblbuf_ptr->data_size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == dblbuf_ptr->data_ptr) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed mmap(NULL, %zu, "
+               "PROT_READ|PROT_WRITE, MAP_SHARED, %d, 0)",
+               dblbuf_ptr->data_size, fd);
+        close(fd);
+        return false;
+    }
+
+    struct wl_shm_pool *wl_shm_pool_ptr = wl_shm_create_pool(
+        wl_shm_ptr, fd, dblbuf_ptr->data_size);
+    close(fd);
+    if (NULL == wl_shm_pool_ptr) {
+        bs_log(BS_ERROR, "Failed wl_shm_create_pool(%p, %d, %zu)",
+               wl_shm_ptr, fd, dblbuf_ptr->data_size);
+        return false;
+    }
+
+    for (unsigned i = 0; i < dblbuf_ptr->num_buffers; ++i) {
+        if (_wlcl_dblbuf_create_buffer(
+                &dblbuf_ptr->buffers[i], dblbuf_ptr,
+                wl_shm_pool_ptr, i, dblbuf_ptr->width, dblbuf_ptr->height)) {
+            _wlcl_dblbuf_handle_wl_buffer_release(
+                &dblbuf_ptr->buffers[i],
+                dblbuf_ptr->buffers[i].wl_buffer_ptr);
+        }
+    }
+    return dblbuf_ptr->released == (int)dblbuf_ptr->num_buffers;
+
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates the buffers as linear GBM buffer objects, and shares them with the
+ * compositor as dmabuf. Clients still draw through the CPU, into a mapping
+ * of the buffer object. The compositor can then sample from the buffer,
+ * without uploading it.
+ *
+ * @param dblbuf_ptr
+ * @param gbm_device_ptr
+ * @param linux_dmabuf_ptr
+ *
+ * @return true on success.
+ */
+bool _wlcl_dblbuf_create_dmabuf_buffers(
+    wlcl_dblbuf_t *dblbuf_ptr,
+    struct gbm_device *gbm_device_ptr,
+    struct zwp_linux_dmabuf_v1 *linux_dmabuf_ptr)
+{
+#if defined(WLCLIENT_HAVE_GBM)
+    for (unsigned i = 0; i < dblbuf_ptr->num_buffers; ++i) {
+        wlcl_buffer_t *buffer_ptr = &dblbuf_ptr->buffers[i];
+        buffer_ptr->dblbuf_ptr = dblbuf_ptr;
+        buffer_ptr->gbm_bo_ptr = gbm_bo_create(
+            gbm_device_ptr, dblbuf_ptr->width, dblbuf_ptr->height,
+            GBM_FORMAT_ARGB8888, GBM_BO_USE_LINEAR | GBM_BO_USE_RENDERING);
+        if (NULL == buffer_ptr->gbm_bo_ptr) {
+            bs_log(BS_ERROR | BS_ERRNO, "Failed gbm_bo_create(%p, %u, %u, "
+                   "GBM_FORMAT_ARGB8888, GBM_BO_USE_LINEAR | "
+                   "GBM_BO_USE_RENDERING)",
+                   gbm_device_ptr, dblbuf_ptr->width, dblbuf_ptr->height);
+            return false;
+        }
+
+        int fd = gbm_bo_get_fd(buffer_ptr->gbm_bo_ptr);
+        if (0 > fd) {
+            bs_log(BS_ERROR, "Failed gbm_bo_get_fd(%p)",
+                   buffer_ptr->gbm_bo_ptr);
+            return false;
+        }
+        uint64_t modifier = gbm_bo_get_modifier(buffer_ptr->gbm_bo_ptr);
+        struct zwp_linux_buffer_params_v1 *params_ptr =
+            zwp_linux_dmabuf_v1_create_params(linux_dmabuf_ptr);
+        zwp_linux_buffer_params_v1_add(
+            params_ptr, fd, 0,
+            gbm_bo_get_offset(buffer_ptr->gbm_bo_ptr, 0),
+            gbm_bo_get_stride(buffer_ptr->gbm_bo_ptr),
+            modifier >> 32, modifier & 0xffffffff);
+        buffer_ptr->wl_buffer_ptr = zwp_linux_buffer_params_v1_create_immed(
+            params_ptr, dblbuf_ptr->width, dblbuf_ptr->height,
+            GBM_FORMAT_ARGB8888, 0);
+        zwp_linux_buffer_params_v1_destroy(params_ptr);
+        close(fd);
+        if (NULL == buffer_ptr->wl_buffer_ptr) {
+            bs_log(BS_ERROR, "Failed zwp_linux_buffer_params_v1_create_immed"
+                   "(%p, %u, %u, GBM_FORMAT_ARGB8888, 0)",
+                   params_ptr, dblbuf_ptr->width, dblbuf_ptr->height);
+            return false;
+        }
+
+        wl_buffer_add_listener(
+            buffer_ptr->wl_buffer_ptr,
+            &_wlcl_dblbuf_wl_buffer_listener,
+            buffer_ptr);
+        _wlcl_dblbuf_handle_wl_buffer_release(
+            buffer_ptr, buffer_ptr->wl_buffer_ptr);
+    }
+    return true;
+#else  // defined(WLCLIENT_HAVE_GBM)
+    bs_log(BS_ERROR, "Built without GBM. Cannot use device %p, dmabuf %p "
+           "for buffers of %p", gbm_device_ptr, linux_dmabuf_ptr, dblbuf_ptr);
+    return false;
+#endif  // defined(WLCLIENT_HAVE_GBM)
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Maps the buffer for drawing, if it is a GBM buffer object. A `wl_shm`
+ * buffer is always mapped.
+ *
+ * @param buffer_ptr
+ *
+ * @return true on success. Then, `buffer_ptr->gfxbuf_ptr` is valid until
+ *     @ref _wlcl_buffer_unmap is called.
+ */
+bool _wlcl_buffer_map(wlcl_buffer_t *buffer_ptr)
+{
+    if (NULL == buffer_ptr->gbm_bo_ptr) return true;
+#if defined(WLCLIENT_HAVE_GBM)
+    if (NULL != buffer_ptr->gbm_map_data_ptr) return true;
+
+    wlcl_dblbuf_t *dblbuf_ptr = buffer_ptr->dblbuf_ptr;
+    uint32_t stride;
+    void *data_ptr = gbm_bo_map(
+        buffer_ptr->gbm_bo_ptr, 0, 0, dblbuf_ptr->width, dblbuf_ptr->height,
+        GBM_BO_TRANSFER_READ_WRITE, &stride, &buffer_ptr->gbm_map_data_ptr);
+    if (NULL == data_ptr) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed gbm_bo_map(%p, 0, 0, %u, %u, "
+               "GBM_BO_TRANSFER_READ_WRITE, ...)", buffer_ptr->gbm_bo_ptr,
+               dblbuf_ptr->width, dblbuf_ptr->height);
+        buffer_ptr->gbm_map_data_ptr = NULL;
+        return false;
+    }
+
+    buffer_ptr->gfxbuf_ptr = bs_gfxbuf_create_unmanaged(
+        dblbuf_ptr->width, dblbuf_ptr->height, stride / sizeof(uint32_t),
+        data_ptr);
+    if (NULL == buffer_ptr->gfxbuf_ptr) {
+        _wlcl_buffer_unmap(buffer_ptr);
+        return false;
+    }
+    return true;
+#else  // defined(WLCLIENT_HAVE_GBM)
+    return false;
+#endif  // defined(WLCLIENT_HAVE_GBM)
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Unmaps the buffer, if it is a mapped GBM buffer object.
+ *
+ * @param buffer_ptr
+ */
+void _wlcl_buffer_unmap(wlcl_buffer_t *buffer_ptr)
+{
+    if (NULL == buffer_ptr->gbm_bo_ptr) return;
+
+    if (NULL != buffer_ptr->gfxbuf_ptr) {
+        bs_gfxbuf_destroy(buffer_ptr->gfxbuf_ptr);
+        buffer_ptr->gfxbuf_ptr = NULL;
+    }
+#if defined(WLCLIENT_HAVE_GBM)
+    if (NULL != buffer_ptr->gbm_map_data_ptr) {
+        gbm_bo_unmap(buffer_ptr->gbm_bo_ptr, buffer_ptr->gbm_map_data_ptr);
+        buffer_ptr->gbm_map_data_ptr = NULL;
+    }
+#endif  // defined(WLCLIENT_HAVE_GBM)
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Helper: Creates a `struct wl_buffer` from the `wl_shm_pool_ptr` at given
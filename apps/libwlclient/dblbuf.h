@@ -29,25 +29,78 @@
 extern "C" {
 #endif  // __cplusplus
 
+struct gbm_device;
 struct wl_shm;
 struct wl_surface;
+struct zwp_linux_dmabuf_v1;
 
 /** Forward declaration: Double buffer state. */
 typedef struct _wlcl_dblbuf_t wlcl_dblbuf_t;
 
-/** Callback that indicates the buffer is ready to draw into. */
+/** Default number of buffers for @ref wlcl_dblbuf_create: Triple buffer. */
+#define WLCL_DBLBUF_DEFAULT_BUFFERS 3
+
+/** Number of rectangles held by @ref wlcl_dblbuf_damage_t. */
+#define WLCL_DBLBUF_DAMAGE_RECTS 4
+
+/** A rectangle, in buffer coordinates. */
+typedef struct {
+    /** Left edge. */
+    int                       x;
+    /** Top edge. */
+    int                       y;
+    /** Width. */
+    int                       width;
+    /** Height. */
+    int                       height;
+} wlcl_dblbuf_rect_t;
+
+/**
+ * Damaged region of a buffer, as a few rectangles. Rectangles added beyond
+ * @ref WLCL_DBLBUF_DAMAGE_RECTS are merged into their bounding box.
+ */
+typedef struct {
+    /** The rectangles. */
+    wlcl_dblbuf_rect_t        rects[WLCL_DBLBUF_DAMAGE_RECTS];
+    /** Number of rectangles held in `rects`. */
+    int                       num_rects;
+} wlcl_dblbuf_damage_t;
+
+/**
+ * Callback that indicates the buffer is ready to draw into.
+ *
+ * The buffer holds the contents of the frame committed last. The callback
+ * may then redraw just what changed, and report that through `damage_ptr`.
+ * If it reports nothing, the entire buffer is considered damaged.
+ *
+ * @param gfxbuf_ptr
+ * @param damage_ptr          Empty region. The callback adds to it.
+ * @param ud_ptr
+ *
+ * @return true if the buffer was drawn and is to be committed.
+ */
 typedef bool (*wlcl_dblbuf_ready_callback_t)(
     bs_gfxbuf_t *gfxbuf_ptr,
+    wlcl_dblbuf_damage_t *damage_ptr,
     void *ud_ptr);
 
 /**
  * Creates a double buffer for the surface with provided dimensions.
  *
+ * The double buffer is backed by `num_buffers` buffers. With more than two,
+ * a frame can be drawn even while the compositor holds on to two buffers.
+ *
  * @param app_id_ptr
  * @param wl_surface_ptr
  * @param wl_shm_ptr
+ * @param linux_dmabuf_ptr    The linux-dmabuf interface, or NULL.
+ * @param gbm_device_ptr      GBM device to allocate the buffers from, or
+ *                            NULL. If both this and `linux_dmabuf_ptr` are
+ *                            set, the buffers are shared as dmabuf. Else,
+ *                            they are shared through `wl_shm_ptr`.
  * @param width
  * @param height
+ * @param num_buffers         Number of buffers. Must be at least 2.
  *
  * @return Pointer to state of the double buffer, or NULL on error. Call
  *     @ref wlcl_dblbuf_destroy for freeing up the associated resources.
@@ -56,8 +109,11 @@ wlcl_dblbuf_t *wlcl_dblbuf_create(
     const char *app_id_ptr,
     struct wl_surface *wl_surface_ptr,
     struct wl_shm *wl_shm_ptr,
+    struct zwp_linux_dmabuf_v1 *linux_dmabuf_ptr,
+    struct gbm_device *gbm_device_ptr,
     unsigned width,
-    unsigned height);
+    unsigned height,
+    unsigned num_buffers);
 
 /** Destroys the double buffer. */
 void wlcl_dblbuf_destroy(wlcl_dblbuf_t *dblbuf_ptr);
@@ -65,8 +121,9 @@ void wlcl_dblbuf_destroy(wlcl_dblbuf_t *dblbuf_ptr);
 /**
  * Registers a callback for when a frame can be drawn into the buffer.
  *
- * The frame can be drawn if (1) it is due, and (2) there is a back buffer
- * available ("released") for drawing into. If these conditions hold true,
+ * The frame can be drawn if (1) it is due, (2) there is a back buffer
+ * available ("released") for drawing into, and (3) the surface is visible,
+ * see @ref wlcl_dblbuf_set_visible. If these conditions hold true,
  * `callback` will be called right away. Otherwise, it will be called once
  * these conditions are fulfilled.
  *
@@ -87,6 +144,35 @@ void wlcl_dblbuf_register_ready_callback(
     wlcl_dblbuf_ready_callback_t callback,
     void *callback_ud_ptr);
 
+/**
+ * Sets whether the surface is visible, ie. shown on at least one output.
+ *
+ * While not visible, no frames are drawn: A registered callback is kept,
+ * and will be called once the surface is visible again. A double buffer is
+ * created as visible, so the first frame is drawn before the compositor
+ * can report outputs.
+ *
+ * @param dblbuf_ptr
+ * @param visible
+ */
+void wlcl_dblbuf_set_visible(wlcl_dblbuf_t *dblbuf_ptr, bool visible);
+
+/**
+ * Adds the rectangle to the damaged region. Empty rectangles are ignored.
+ *
+ * @param damage_ptr
+ * @param x
+ * @param y
+ * @param width
+ * @param height
+ */
+void wlcl_dblbuf_damage_add(
+    wlcl_dblbuf_damage_t *damage_ptr,
+    int x,
+    int y,
+    int width,
+    int height);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
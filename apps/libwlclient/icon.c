@@ -22,12 +22,14 @@
 
 #include <inttypes.h>
 #include <libbase/libbase.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <wayland-client-protocol.h>
 
 #include "dblbuf.h"
 #include "wlmaker-icon-unstable-v1-client-protocol.h"
 
+struct wl_output;
 struct zwlmaker_toplevel_icon_v1;
 
 /* == Declarations ========================================================= */
@@ -55,6 +57,10 @@ typedef struct _wlclient_icon_t {
     /** Double-buffered state of the surface. */
     wlcl_dblbuf_t             *dblbuf_ptr;
 
+    /** Number of outputs the surface is currently shown on. */
+    unsigned                  outputs;
+    /** Whether the surface has been shown on any output yet. */
+    bool                      entered;
 } wlclient_icon_t;
 
 static void handle_toplevel_icon_configure(
@@ -63,6 +69,15 @@ static void handle_toplevel_icon_configure(
     int32_t width,
     int32_t height,
     uint32_t serial);
+static void handle_surface_enter(
+    void *data_ptr,
+    struct wl_surface *wl_surface_ptr,
+    struct wl_output *wl_output_ptr);
+static void handle_surface_leave(
+    void *data_ptr,
+    struct wl_surface *wl_surface_ptr,
+    struct wl_output *wl_output_ptr);
+static void update_visibility(wlclient_icon_t *icon_ptr);
 
 /* == Data ================================================================= */
 
@@ -71,6 +86,12 @@ static const struct zwlmaker_toplevel_icon_v1_listener toplevel_icon_listener={
     .configure = handle_toplevel_icon_configure,
 };
 
+/** Listener implementation for the icon's surface. */
+static const struct wl_surface_listener surface_listener = {
+    .enter = handle_surface_enter,
+    .leave = handle_surface_leave,
+};
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -93,6 +114,8 @@ wlclient_icon_t *wlclient_icon_create(wlclient_t *wlclient_ptr)
         wlclient_icon_destroy(icon_ptr);
         return NULL;
     }
+    wl_surface_add_listener(
+        icon_ptr->wl_surface_ptr, &surface_listener, icon_ptr);
 
     icon_ptr->toplevel_icon_ptr = zwlmaker_icon_manager_v1_get_toplevel_icon(
         wlclient_attributes(wlclient_ptr)->icon_manager_ptr,
@@ -147,7 +170,7 @@ bool wlclient_icon_supported(
 /* ------------------------------------------------------------------------ */
 void wlclient_icon_register_ready_callback(
     wlclient_icon_t *icon_ptr,
-    bool (*callback)(bs_gfxbuf_t *gfxbuf_ptr, void *ud_ptr),
+    wlcl_dblbuf_ready_callback_t callback,
     void *ud_ptr)
 {
     if (NULL != icon_ptr->dblbuf_ptr) {
@@ -191,8 +214,11 @@ void handle_toplevel_icon_configure(
         wlclient_attributes(wlclient_ptr)->app_id_ptr,
         icon_ptr->wl_surface_ptr,
         wlclient_attributes(wlclient_ptr)->wl_shm_ptr,
+        wlclient_attributes(wlclient_ptr)->linux_dmabuf_ptr,
+        wlclient_attributes(wlclient_ptr)->gbm_device_ptr,
         icon_ptr->width,
-        icon_ptr->height);
+        icon_ptr->height,
+        WLCL_DBLBUF_DEFAULT_BUFFERS);
     if (NULL == icon_ptr->dblbuf_ptr) {
         bs_log(BS_FATAL, "Failed wlcl_dblbuf_create(%p, %p, %u, %u)",
                icon_ptr->wl_surface_ptr,
@@ -201,6 +227,7 @@ void handle_toplevel_icon_configure(
                icon_ptr->height);
         // TODO(kaeser@gubbe.ch): Error handling.
     }
+    update_visibility(icon_ptr);
 
     wlcl_dblbuf_ready_callback_t callback = icon_ptr->ready_callback;
     if (NULL != callback) {
@@ -212,4 +239,43 @@ void handle_toplevel_icon_configure(
     }
 }
 
+/* ------------------------------------------------------------------------- */
+/** Handles `wl_surface.enter`: The icon is shown on one more output. */
+void handle_surface_enter(
+    void *data_ptr,
+    __UNUSED__ struct wl_surface *wl_surface_ptr,
+    __UNUSED__ struct wl_output *wl_output_ptr)
+{
+    wlclient_icon_t *icon_ptr = data_ptr;
+    icon_ptr->outputs++;
+    icon_ptr->entered = true;
+    update_visibility(icon_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles `wl_surface.leave`: The icon is no longer on that output. */
+void handle_surface_leave(
+    void *data_ptr,
+    __UNUSED__ struct wl_surface *wl_surface_ptr,
+    __UNUSED__ struct wl_output *wl_output_ptr)
+{
+    wlclient_icon_t *icon_ptr = data_ptr;
+    if (0 < icon_ptr->outputs) icon_ptr->outputs--;
+    update_visibility(icon_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Forwards the visibility to the double buffer. Until the surface entered
+ * any output, it is considered visible: The first frame must be drawn for
+ * the compositor to show it anywhere.
+ */
+void update_visibility(wlclient_icon_t *icon_ptr)
+{
+    if (NULL == icon_ptr->dblbuf_ptr) return;
+    wlcl_dblbuf_set_visible(
+        icon_ptr->dblbuf_ptr,
+        !icon_ptr->entered || 0 < icon_ptr->outputs);
+}
+
 /* == End of icon.c ======================================================== */
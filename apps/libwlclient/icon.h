@@ -23,6 +23,7 @@
 #include <libbase/libbase.h>
 #include <stdbool.h>
 
+#include "dblbuf.h"
 #include "libwlclient.h"  // IWYU pragma: keep
 
 #ifdef __cplusplus
@@ -61,6 +62,10 @@ bool wlclient_icon_supported(wlclient_t *wlclient_ptr);
 /**
  * Sets a callback to invoke when the background buffer is ready for drawing.
  *
+ * The icon tracks the outputs its surface is shown on. While it is shown on
+ * none, eg. when covered or on an output that's off, the callback is held
+ * back until the icon is shown again.
+ *
  * @see wlcl_dblbuf_register_ready_callback.
  *
  * @param icon_ptr
@@ -69,7 +74,7 @@ bool wlclient_icon_supported(wlclient_t *wlclient_ptr);
  */
 void wlclient_icon_register_ready_callback(
     wlclient_icon_t *icon_ptr,
-    bool (*callback)(bs_gfxbuf_t *gfxbuf_ptr, void *ud_ptr),
+    wlcl_dblbuf_ready_callback_t callback,
     void *ud_ptr);
 
 #ifdef __cplusplus
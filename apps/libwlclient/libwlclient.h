@@ -28,6 +28,10 @@
 
 /** Forward declaration: Wayland client handle. */
 typedef struct _wlclient_t wlclient_t;
+/** Forward declaration: A periodic timer. */
+typedef struct _wlclient_periodic_timer_t wlclient_periodic_timer_t;
+struct gbm_device;
+struct zwp_linux_dmabuf_v1;
 struct zxdg_toplevel_decoration_v1;
 
 #include "icon.h"
@@ -63,6 +67,14 @@ typedef struct {
     struct zwlmaker_icon_manager_v1 *icon_manager_ptr;
     /** The bound XDG decoration manager. NULL if not supported. */
     struct zxdg_decoration_manager_v1 *xdg_decoration_manager_ptr;
+    /** The bound linux-dmabuf interface. NULL if not supported. */
+    struct zwp_linux_dmabuf_v1 *linux_dmabuf_ptr;
+    /**
+     * GBM device for allocating buffers to share through `linux_dmabuf_ptr`.
+     * Only opened when the render node is set in `WLCLIENT_DMABUF_DEVICE`,
+     * eg. as `/dev/dri/renderD128`. Buffers use `wl_shm`, if NULL.
+     */
+    struct gbm_device         *gbm_device_ptr;
 
     /** Application ID, as a string. Or NULL, if not set. */
     const char                *app_id_ptr;
@@ -147,6 +159,37 @@ bool wlclient_register_timer(
     wlclient_callback_t callback,
     void *callback_ud_ptr);
 
+/**
+ * Creates a periodic timer, and registers it with the client.
+ *
+ * `callback` is called on each multiple of `period_usec` since the epoch.
+ * Eg. at each full second, for a period of 1000000. A period that was
+ * missed, eg. since the client was busy, is skipped. The timer is re-used
+ * for each period, and does not drift.
+ *
+ * @param wlclient_ptr
+ * @param period_usec         The period. Must be positive.
+ * @param callback
+ * @param callback_ud_ptr
+ *
+ * @return A pointer to the timer, or NULL on error. Must be destroyed by
+ *     @ref wlclient_periodic_timer_destroy, before destroying the client.
+ */
+wlclient_periodic_timer_t *wlclient_periodic_timer_create(
+    wlclient_t *wlclient_ptr,
+    uint64_t period_usec,
+    wlclient_callback_t callback,
+    void *callback_ud_ptr);
+
+/**
+ * Unregisters and destroys the periodic timer. May be called from within
+ * the timer's callback.
+ *
+ * @param periodic_timer_ptr
+ */
+void wlclient_periodic_timer_destroy(
+    wlclient_periodic_timer_t *periodic_timer_ptr);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
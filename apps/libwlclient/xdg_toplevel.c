@@ -147,8 +147,11 @@ wlclient_xdg_toplevel_t *wlclient_xdg_toplevel_create(
         wlclient_attributes(wlclient_ptr)->app_id_ptr,
         toplevel_ptr->wl_surface_ptr,
         wlclient_attributes(wlclient_ptr)->wl_shm_ptr,
+        wlclient_attributes(wlclient_ptr)->linux_dmabuf_ptr,
+        wlclient_attributes(wlclient_ptr)->gbm_device_ptr,
         width,
-        height);
+        height,
+        WLCL_DBLBUF_DEFAULT_BUFFERS);
     if (NULL == toplevel_ptr->dblbuf_ptr) {
         bs_log(BS_ERROR, "Failed wlcl_dblbuf_create(%p, %p, %u, %u)",
         toplevel_ptr->wl_surface_ptr,
@@ -269,7 +272,7 @@ bool wlclient_xdg_supported(wlclient_t *wlclient_ptr)
 /* ------------------------------------------------------------------------- */
 void wlclient_xdg_toplevel_register_ready_callback(
     wlclient_xdg_toplevel_t *toplevel_ptr,
-    bool (*callback)(bs_gfxbuf_t *gfxbuf_ptr, void *ud_ptr),
+    wlcl_dblbuf_ready_callback_t callback,
     void *callback_ud_ptr)
 {
     if (toplevel_ptr->configured) {
@@ -23,6 +23,7 @@
 #include <libbase/libbase.h>
 #include <stdbool.h>
 
+#include "dblbuf.h"
 #include "libwlclient.h"  // IWYU pragma: keep
 
 #ifdef __cplusplus
@@ -71,7 +72,7 @@ bool wlclient_xdg_supported(wlclient_t *wlclient_ptr);
  */
 void wlclient_xdg_toplevel_register_ready_callback(
     wlclient_xdg_toplevel_t *toplevel_ptr,
-    bool (*callback)(bs_gfxbuf_t *gfxbuf_ptr, void *ud_ptr),
+    wlcl_dblbuf_ready_callback_t callback,
     void *callback_ud_ptr);
 
 #ifdef __cplusplus
@@ -23,10 +23,23 @@
 #include <libbase/libbase.h>
 
 #include <cairo.h>
+#include <math.h>
 #include <stdlib.h>
 
 /* == Declarations ========================================================= */
 
+/** State of the atlas. */
+struct _wlm_cairo_7segment_atlas_t {
+    /** Digits 0 to 9, then the lit and the unlit colon, left to right. */
+    bs_gfxbuf_t               *gfxbuf_ptr;
+    /** Width of a digit's cell. */
+    unsigned                  digit_width;
+    /** Width of a colon's cell. */
+    unsigned                  colon_width;
+    /** Height of the cells. */
+    unsigned                  height;
+};
+
 static void draw_segment(
     cairo_t *cairo_ptr,
     const bs_vector_2f_t origin,
@@ -164,6 +177,114 @@ void wlm_cairo_7segment_display_digit(
     cairo_restore(cairo_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+void wlm_cairo_7segment_display_colon(
+    cairo_t *cairo_ptr,
+    const wlm_cairo_7segment_param_t *pptr,
+    uint32_t x,
+    uint32_t y,
+    uint32_t color)
+{
+    cairo_save(cairo_ptr);
+    cairo_set_source_argb8888(cairo_ptr, color);
+    cairo_rectangle(cairo_ptr,
+                    x + pptr->width / 2.0,
+                    y - pptr->width - 1.5 * pptr->vlength,
+                    pptr->width, pptr->width);
+    cairo_rectangle(cairo_ptr,
+                    x + pptr->width / 2.0,
+                    y - pptr->width - 0.5 * pptr->vlength,
+                    pptr->width, pptr->width);
+    cairo_fill(cairo_ptr);
+    cairo_restore(cairo_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+wlm_cairo_7segment_atlas_t *wlm_cairo_7segment_atlas_create(
+    const wlm_cairo_7segment_param_t *param_ptr,
+    uint32_t color_on,
+    uint32_t color_off,
+    uint32_t color_background)
+{
+    wlm_cairo_7segment_atlas_t *atlas_ptr = logged_calloc(
+        1, sizeof(wlm_cairo_7segment_atlas_t));
+    if (NULL == atlas_ptr) return NULL;
+    atlas_ptr->digit_width = ceil(param_ptr->hlength + param_ptr->width);
+    atlas_ptr->colon_width = ceil(2 * param_ptr->width);
+    atlas_ptr->height = ceil(2 * param_ptr->vlength + param_ptr->width);
+
+    atlas_ptr->gfxbuf_ptr = bs_gfxbuf_create(
+        10 * atlas_ptr->digit_width + 2 * atlas_ptr->colon_width,
+        atlas_ptr->height);
+    if (NULL == atlas_ptr->gfxbuf_ptr) {
+        wlm_cairo_7segment_atlas_destroy(atlas_ptr);
+        return NULL;
+    }
+    bs_gfxbuf_clear(atlas_ptr->gfxbuf_ptr, color_background);
+
+    cairo_t *cairo_ptr = cairo_create_from_bs_gfxbuf(atlas_ptr->gfxbuf_ptr);
+    if (NULL == cairo_ptr) {
+        bs_log(BS_ERROR, "Failed cairo_create_from_bs_gfxbuf(%p)",
+               atlas_ptr->gfxbuf_ptr);
+        wlm_cairo_7segment_atlas_destroy(atlas_ptr);
+        return NULL;
+    }
+    for (uint8_t digit = 0; digit < 10; ++digit) {
+        wlm_cairo_7segment_display_digit(
+            cairo_ptr, param_ptr, digit * atlas_ptr->digit_width,
+            atlas_ptr->height, color_on, color_off, digit);
+    }
+    wlm_cairo_7segment_display_colon(
+        cairo_ptr, param_ptr, 10 * atlas_ptr->digit_width,
+        atlas_ptr->height, color_on);
+    wlm_cairo_7segment_display_colon(
+        cairo_ptr, param_ptr,
+        10 * atlas_ptr->digit_width + atlas_ptr->colon_width,
+        atlas_ptr->height, color_off);
+    cairo_destroy(cairo_ptr);
+    return atlas_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_cairo_7segment_atlas_destroy(wlm_cairo_7segment_atlas_t *atlas_ptr)
+{
+    if (NULL != atlas_ptr->gfxbuf_ptr) {
+        bs_gfxbuf_destroy(atlas_ptr->gfxbuf_ptr);
+        atlas_ptr->gfxbuf_ptr = NULL;
+    }
+    free(atlas_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_cairo_7segment_atlas_draw_digit(
+    wlm_cairo_7segment_atlas_t *atlas_ptr,
+    bs_gfxbuf_t *gfxbuf_ptr,
+    uint32_t x,
+    uint32_t y,
+    uint8_t digit)
+{
+    BS_ASSERT(digit < UINT8_C(10));
+    bs_gfxbuf_copy_area(
+        gfxbuf_ptr, x, y - atlas_ptr->height,
+        atlas_ptr->gfxbuf_ptr, digit * atlas_ptr->digit_width, 0,
+        atlas_ptr->digit_width, atlas_ptr->height);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_cairo_7segment_atlas_draw_colon(
+    wlm_cairo_7segment_atlas_t *atlas_ptr,
+    bs_gfxbuf_t *gfxbuf_ptr,
+    uint32_t x,
+    uint32_t y,
+    bool lit)
+{
+    bs_gfxbuf_copy_area(
+        gfxbuf_ptr, x, y - atlas_ptr->height,
+        atlas_ptr->gfxbuf_ptr,
+        10 * atlas_ptr->digit_width + (lit ? 0 : atlas_ptr->colon_width), 0,
+        atlas_ptr->colon_width, atlas_ptr->height);
+}
+
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -235,11 +356,13 @@ void draw_segment(
 static void test_6x8(bs_test_t *test_ptr);
 static void test_7x10(bs_test_t *test_ptr);
 static void test_16x24(bs_test_t *test_ptr);
+static void test_atlas(bs_test_t *test_ptr);
 
 const bs_test_case_t          wlm_cairo_segment_display_test_cases[] = {
     { 1, "6x8", test_6x8 },
     { 1, "7x10", test_7x10 },
     { 1, "16x24", test_16x24 },
+    { 1, "atlas", test_atlas },
     { 0, NULL, NULL }  // sentinel.
 };
 
@@ -324,4 +447,29 @@ void test_16x24(bs_test_t *test_ptr)
     bs_gfxbuf_destroy(gfxbuf_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Digits copied from the atlas match those drawn through cairo. */
+void test_atlas(bs_test_t *test_ptr)
+{
+    wlm_cairo_7segment_atlas_t *atlas_ptr = wlm_cairo_7segment_atlas_create(
+        &wlm_cairo_7segment_param_7x10, 0xffc0c0ff, 0xff202040, 0);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, atlas_ptr);
+    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_create(70, 10);
+    if (NULL == gfxbuf_ptr) {
+        BS_TEST_FAIL(test_ptr, "Failed bs_gfxbuf_create(70, 10)");
+        wlm_cairo_7segment_atlas_destroy(atlas_ptr);
+        return;
+    }
+
+    for (uint8_t i = 0; i < 10; i++) {
+        wlm_cairo_7segment_atlas_draw_digit(
+            atlas_ptr, gfxbuf_ptr, i * 7, 10, i);
+    }
+    BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
+        test_ptr, gfxbuf_ptr, "segment_display_7x10.png");
+
+    bs_gfxbuf_destroy(gfxbuf_ptr);
+    wlm_cairo_7segment_atlas_destroy(atlas_ptr);
+}
+
 /* == End of segment_display.c ============================================= */
@@ -24,6 +24,7 @@
 
 #include <cairo.h>
 #include <inttypes.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -41,6 +42,12 @@ typedef struct {
     double vlength;
 } wlm_cairo_7segment_param_t;
 
+/**
+ * Forward declaration: Pre-rasterized digits and colons, for one set of
+ * @ref wlm_cairo_7segment_param_t and colors.
+ */
+typedef struct _wlm_cairo_7segment_atlas_t wlm_cairo_7segment_atlas_t;
+
 /** Parameters for a 6x8-pixel-sized 7-segment digit display. */
 extern const wlm_cairo_7segment_param_t wlm_cairo_7segment_param_6x8;
 /** Parameters for a 7x10-pixel-sized 7-segment digit display. */
@@ -70,6 +77,89 @@ void wlm_cairo_7segment_display_digit(
     uint32_t color_off,
     uint8_t digit);
 
+/**
+ * Draws a colon, as two dots of the segment's width, at the height of the
+ * upper and the lower vertical segments' centers.
+ *
+ * @param cairo_ptr           The `cairo_t` target to draw the colon to.
+ * @param param_ptr           Visualization parameters for the segments.
+ * @param x                   X coordinate of lower left corner.
+ * @param y                   Y coordinate of lower left corner.
+ * @param color               An ARGB32 value for the dots.
+ */
+void wlm_cairo_7segment_display_colon(
+    cairo_t *cairo_ptr,
+    const wlm_cairo_7segment_param_t *param_ptr,
+    uint32_t x,
+    uint32_t y,
+    uint32_t color);
+
+/**
+ * Creates an atlas of the 10 digits and the colon, lit and unlit, drawn by
+ * @ref wlm_cairo_7segment_display_digit and
+ * @ref wlm_cairo_7segment_display_colon onto `color_background`.
+ *
+ * Drawing from the atlas is a copy, and yields the same pixels as drawing
+ * the digit with cairo onto a `color_background`-filled area.
+ *
+ * @param param_ptr           Visualization parameters for the segments.
+ *                            Must outlive the atlas.
+ * @param color_on            An ARGB32 value for an illuminated segment.
+ * @param color_off           An ARGB32 value for a non-illuminated segment.
+ * @param color_background    An ARGB32 value for the background.
+ *
+ * @return Pointer to the atlas, or NULL on error. Must be destroyed by
+ *     @ref wlm_cairo_7segment_atlas_destroy.
+ */
+wlm_cairo_7segment_atlas_t *wlm_cairo_7segment_atlas_create(
+    const wlm_cairo_7segment_param_t *param_ptr,
+    uint32_t color_on,
+    uint32_t color_off,
+    uint32_t color_background);
+
+/**
+ * Destroys the atlas.
+ *
+ * @param atlas_ptr
+ */
+void wlm_cairo_7segment_atlas_destroy(wlm_cairo_7segment_atlas_t *atlas_ptr);
+
+/**
+ * Copies a digit from the atlas into `gfxbuf_ptr`.
+ *
+ * The digit's cell is `ceil(hlength + width)` wide and `ceil(2 * vlength +
+ * width)` high, and must fit into `gfxbuf_ptr`.
+ *
+ * @param atlas_ptr
+ * @param gfxbuf_ptr
+ * @param x                   X coordinate of lower left corner.
+ * @param y                   Y coordinate of lower left corner.
+ * @param digit               Digit to draw. Must be 0 <= digit < 10.
+ */
+void wlm_cairo_7segment_atlas_draw_digit(
+    wlm_cairo_7segment_atlas_t *atlas_ptr,
+    bs_gfxbuf_t *gfxbuf_ptr,
+    uint32_t x,
+    uint32_t y,
+    uint8_t digit);
+
+/**
+ * Copies a colon from the atlas into `gfxbuf_ptr`. Its cell is
+ * `ceil(2 * width)` wide, and as high as a digit's.
+ *
+ * @param atlas_ptr
+ * @param gfxbuf_ptr
+ * @param x                   X coordinate of lower left corner.
+ * @param y                   Y coordinate of lower left corner.
+ * @param lit                 Whether to draw the lit or the unlit colon.
+ */
+void wlm_cairo_7segment_atlas_draw_colon(
+    wlm_cairo_7segment_atlas_t *atlas_ptr,
+    bs_gfxbuf_t *gfxbuf_ptr,
+    uint32_t x,
+    uint32_t y,
+    bool lit);
+
 /** Unit test cases. */
 extern const bs_test_case_t wlm_cairo_segment_display_test_cases[];
 
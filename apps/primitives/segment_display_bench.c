@@ -0,0 +1,165 @@
+/* ========================================================================= */
+/**
+ * @file segment_display_bench.c
+ *
+ * Benchmarks drawing the digits of the segment display: Through cairo, and
+ * copied from the pre-rasterized atlas. Prints nanoseconds per digit as
+ * JSON.
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cairo.h>
+#include <inttypes.h>
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "segment_display.h"
+
+/* == Declarations ========================================================= */
+
+/** State of the benchmark. */
+typedef struct {
+    /** Buffer to draw the digits into. */
+    bs_gfxbuf_t               *gfxbuf_ptr;
+    /** A cairo drawing into `gfxbuf_ptr`. */
+    cairo_t                   *cairo_ptr;
+    /** The atlas, for the same parameters and colors. */
+    wlm_cairo_7segment_atlas_t *atlas_ptr;
+} bench_state_t;
+
+/** A benchmarked operation. Will be called with the iteration. */
+typedef void (*bench_fn_t)(bench_state_t *state_ptr, size_t i);
+
+/** Descriptor of a benchmark. */
+typedef struct {
+    /** Name, as used for the key in the JSON output. */
+    const char                *name_ptr;
+    /** The operation. */
+    bench_fn_t                fn;
+} bench_t;
+
+static uint64_t bench_nsec(void);
+static void bench_digit_cairo(bench_state_t *state_ptr, size_t i);
+static void bench_digit_atlas(bench_state_t *state_ptr, size_t i);
+
+/* == Data ================================================================= */
+
+/** Color of an illuminated segment. Same as used in wlmclock. */
+static const uint32_t bench_color_on = 0xff55ffff;
+/** Color of a segment that is off. */
+static const uint32_t bench_color_off = 0xff114444;
+/** Background color. */
+static const uint32_t bench_color_background = 0xff111111;
+/** Size of the buffers, in pixels. One 64x64 clock icon. */
+static const unsigned bench_size = 64;
+
+/** The benchmarks to run. */
+static const bench_t bench_set[] = {
+    { "digit_8x12_cairo", bench_digit_cairo },
+    { "digit_8x12_atlas", bench_digit_atlas },
+    { NULL, NULL }
+};
+
+/* == Main program ========================================================= */
+
+/* ------------------------------------------------------------------------- */
+/** Main program. Optional argument: Number of iterations. */
+int main(int argc, const char **argv)
+{
+    size_t iterations = 1 < argc ? strtoul(argv[1], NULL, 10) : 100000;
+    if (0 == iterations) {
+        fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    bench_state_t state = {};
+    state.gfxbuf_ptr = bs_gfxbuf_create(bench_size, bench_size);
+    if (NULL == state.gfxbuf_ptr) return EXIT_FAILURE;
+    bs_gfxbuf_clear(state.gfxbuf_ptr, bench_color_background);
+    state.cairo_ptr = cairo_create_from_bs_gfxbuf(state.gfxbuf_ptr);
+    state.atlas_ptr = wlm_cairo_7segment_atlas_create(
+        &wlm_cairo_7segment_param_8x12,
+        bench_color_on, bench_color_off, bench_color_background);
+    if (NULL == state.cairo_ptr || NULL == state.atlas_ptr) {
+        bs_log(BS_ERROR, "Failed to set up cairo %p or atlas %p",
+               state.cairo_ptr, state.atlas_ptr);
+        return EXIT_FAILURE;
+    }
+
+    printf("{\n  \"iterations\": %zu,\n  \"ns_per_op\": {", iterations);
+    for (const bench_t *bench_ptr = &bench_set[0];
+         NULL != bench_ptr->name_ptr;
+         ++bench_ptr) {
+        // One round for warming up caches, then measure.
+        for (size_t i = 0; i < BS_MIN(iterations, 100u); ++i) {
+            bench_ptr->fn(&state, i);
+        }
+        uint64_t start_nsec = bench_nsec();
+        for (size_t i = 0; i < iterations; ++i) bench_ptr->fn(&state, i);
+        uint64_t elapsed_nsec = bench_nsec() - start_nsec;
+
+        printf("%s\n    \"%s\": %.1f",
+               bench_ptr == &bench_set[0] ? "" : ",",
+               bench_ptr->name_ptr,
+               (double)elapsed_nsec / (double)iterations);
+    }
+    printf("\n  }\n}\n");
+
+    wlm_cairo_7segment_atlas_destroy(state.atlas_ptr);
+    cairo_destroy(state.cairo_ptr);
+    bs_gfxbuf_destroy(state.gfxbuf_ptr);
+    return EXIT_SUCCESS;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** @return Monotonic time, in nanoseconds. */
+uint64_t bench_nsec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Draws one digit through cairo, cycling through the six clock positions. */
+void bench_digit_cairo(bench_state_t *state_ptr, size_t i)
+{
+    wlm_cairo_7segment_display_digit(
+        state_ptr->cairo_ptr,
+        &wlm_cairo_7segment_param_8x12,
+        6 + (i % 6) * 8, 58,
+        bench_color_on, bench_color_off,
+        i % 10);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Copies one digit from the atlas, at the same positions as above. */
+void bench_digit_atlas(bench_state_t *state_ptr, size_t i)
+{
+    wlm_cairo_7segment_atlas_draw_digit(
+        state_ptr->atlas_ptr,
+        state_ptr->gfxbuf_ptr,
+        6 + (i % 6) * 8, 58,
+        i % 10);
+}
+
+/* == End of segment_display_bench.c ======================================= */
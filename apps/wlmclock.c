@@ -34,6 +34,7 @@
 #include <sys/time.h>
 #include <time.h>
 
+#include "libwlclient/dblbuf.h"
 #include "libwlclient/icon.h"
 
 /** Foreground color of a LED in the VFD-style display. */
@@ -43,25 +44,26 @@ static const uint32_t color_off = 0xff114444;
 /** Background color in the VFD-style display. */
 static const uint32_t color_background = 0xff111111;
 
-/* ------------------------------------------------------------------------- */
-/** Returns the next full second for when to draw the clock. */
-uint64_t next_draw_time(void)
-{
-    return (bs_usec() / 1000000 + 1) * 1000000;
-}
+/** Pre-rasterized digits of the VFD-style display. */
+static wlm_cairo_7segment_atlas_t *digits_atlas_ptr = NULL;
 
 /* ------------------------------------------------------------------------- */
 /**
  * Draws contents into the icon buffer.
  *
+ * The buffer holds the previous frame once drawn, so only the digits and
+ * the clock face are redrawn, and reported as damage.
+ *
  * @param gfxbuf_ptr
+ * @param damage_ptr
  * @param ud_ptr
  */
 bool icon_callback(
     bs_gfxbuf_t *gfxbuf_ptr,
+    wlcl_dblbuf_damage_t *damage_ptr,
     __UNUSED__ void *ud_ptr)
 {
-    bs_gfxbuf_clear(gfxbuf_ptr, 0);
+    static bool drawn = false;
 
     if (gfxbuf_ptr->width != gfxbuf_ptr->height) {
         bs_log(BS_ERROR, "Requiring a square buffer, width %u != height %u",
@@ -79,6 +81,25 @@ bool icon_callback(
         return false;
     }
 
+    if (drawn) {
+        wlcl_dblbuf_damage_add(
+            damage_ptr, outer + 1, width - 18, width - 2 * outer - 2, 14);
+        wlcl_dblbuf_damage_add(
+            damage_ptr, inner, inner,
+            width - 2 * inner, ceil(39.0 * width / 64.0));
+    } else {
+        // The static parts: Bezels around the digits and the clock face.
+        bs_gfxbuf_clear(gfxbuf_ptr, 0);
+        wlm_primitives_draw_bezel_at(
+            cairo_ptr,
+            outer, width - 19, width - 2 * outer, 15, 1.0, false);
+        wlm_primitives_draw_bezel_at(
+            cairo_ptr,
+            outer, outer,
+            width - 2 * outer, 41.0 * width / 64.0,
+            inner - outer, false);
+    }
+
     float r, g, b, alpha;
     bs_gfxbuf_argb8888_to_floats(color_background, &r, &g, &b, &alpha);
     cairo_pattern_t *pattern_ptr = cairo_pattern_create_rgba(r, g, b, alpha);
@@ -90,10 +111,6 @@ bool icon_callback(
         outer + 1, width - 18, width - 2 * outer - 2, 14);
     cairo_fill(cairo_ptr);
 
-    wlm_primitives_draw_bezel_at(
-        cairo_ptr,
-        outer, width - 19, width - 2 * outer, 15, 1.0, false);
-
     struct timeval tv;
     if (0 != gettimeofday(&tv, NULL)) {
         memset(&tv, 0, sizeof(tv));
@@ -103,16 +120,17 @@ bool icon_callback(
     snprintf(time_buf, sizeof(time_buf), "%02d%02d%02d",
              tm_ptr->tm_hour, tm_ptr->tm_min, tm_ptr->tm_sec);
 
+    // The digits are copied from the atlas, bypassing cairo.
+    cairo_surface_flush(cairo_get_target(cairo_ptr));
     for (int i = 0; i < 6; ++i) {
-        wlm_cairo_7segment_display_digit(
-            cairo_ptr,
-            &wlm_cairo_7segment_param_8x12,
+        wlm_cairo_7segment_atlas_draw_digit(
+            digits_atlas_ptr,
+            gfxbuf_ptr,
             width / 2 - 26 + i * 8 + (i / 2) * 2,
             width - 6,
-            color_led,
-            color_off,
             time_buf[i] - '0');
     }
+    cairo_surface_mark_dirty(cairo_get_target(cairo_ptr));
 
     cairo_set_source_argb8888(cairo_ptr, color_led);
     cairo_rectangle(cairo_ptr, width / 2 - 10, width - 14, 1, 1.25);
@@ -127,11 +145,6 @@ bool icon_callback(
     double center_y = 24.5 * width / 64.0;
     double radius = 19 * width / 64.0;
 
-    wlm_primitives_draw_bezel_at(
-        cairo_ptr,
-        outer, outer,
-        width - 2 * outer, 41.0 * width / 64.0,
-        inner - outer, false);
     cairo_set_source_argb8888(cairo_ptr, color_background);
     cairo_rectangle(
         cairo_ptr,
@@ -190,18 +203,17 @@ bool icon_callback(
 
     cairo_destroy(cairo_ptr);
 
+    drawn = true;
     return true;
 }
 
 /* ------------------------------------------------------------------------- */
-/** Called once per second. */
-void timer_callback(wlclient_t *client_ptr, void *ud_ptr)
+/** Called at each full second. */
+void timer_callback(__UNUSED__ wlclient_t *client_ptr, void *ud_ptr)
 {
     wlclient_icon_t *icon_ptr = ud_ptr;
 
     wlclient_icon_register_ready_callback(icon_ptr, icon_callback, NULL);
-    wlclient_register_timer(
-        client_ptr, next_draw_time(), timer_callback, icon_ptr);
 }
 
 /* == Main program ========================================================= */
@@ -210,8 +222,16 @@ int main(__UNUSED__ int argc, __UNUSED__ char **argv)
 {
     bs_log_severity = BS_DEBUG;
 
+    digits_atlas_ptr = wlm_cairo_7segment_atlas_create(
+        &wlm_cairo_7segment_param_8x12, color_led, color_off,
+        color_background);
+    if (NULL == digits_atlas_ptr) return EXIT_FAILURE;
+
     wlclient_t *wlclient_ptr = wlclient_create("wlmclock");
-    if (NULL == wlclient_ptr) return EXIT_FAILURE;
+    if (NULL == wlclient_ptr) {
+        wlm_cairo_7segment_atlas_destroy(digits_atlas_ptr);
+        return EXIT_FAILURE;
+    }
 
     if (wlclient_icon_supported(wlclient_ptr)) {
         wlclient_icon_t *icon_ptr = wlclient_icon_create(wlclient_ptr);
@@ -221,10 +241,16 @@ int main(__UNUSED__ int argc, __UNUSED__ char **argv)
             wlclient_icon_register_ready_callback(
                 icon_ptr, icon_callback, NULL);
 
-            wlclient_register_timer(
-                wlclient_ptr, next_draw_time(), timer_callback, icon_ptr);
-
-            wlclient_run(wlclient_ptr);
+            wlclient_periodic_timer_t *timer_ptr =
+                wlclient_periodic_timer_create(
+                    wlclient_ptr, 1000000, timer_callback, icon_ptr);
+            if (NULL == timer_ptr) {
+                bs_log(BS_ERROR, "Failed wlclient_periodic_timer_create(%p)",
+                       wlclient_ptr);
+            } else {
+                wlclient_run(wlclient_ptr);
+                wlclient_periodic_timer_destroy(timer_ptr);
+            }
             wlclient_icon_destroy(icon_ptr);
         }
     } else {
@@ -232,6 +258,7 @@ int main(__UNUSED__ int argc, __UNUSED__ char **argv)
     }
 
     wlclient_destroy(wlclient_ptr);
+    wlm_cairo_7segment_atlas_destroy(digits_atlas_ptr);
     return EXIT_SUCCESS;
 }
 /* == End of wlmclock.c ==================================================== */
@@ -0,0 +1,167 @@
+# Copyright 2025 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Runs a benchmark and compares the JSON it reports against a baseline.
+#
+# Run in script mode, with `cmake -D<var>=<value>... -P PerfCheck.cmake`:
+#
+# BENCH      Benchmark executable.
+# ARGS       Arguments, separated by spaces.
+# OUTPUT     Optional: File the benchmark writes JSON to. Else, stdout.
+# BASELINE   Baseline JSON file, as written by the benchmark.
+# METRICS    Top-level members holding metrics, separated by spaces. These
+#            are numbers or objects of numbers, where lower is better. All
+#            other top-level members are parameters, and must match.
+# IGNORE     Optional: Names of metrics that are not compared.
+# TOLERANCE  Percent a metric may exceed its baseline. Defaults to 20.
+# UPDATE     If true: Writes the result as new baseline, without comparing.
+#
+# Without a baseline file, prints "No baseline" and returns without running
+# the benchmark. Tests mark that as skipped. Under CI, ie. with the `CI`
+# environment variable set to true, a missing baseline is an error instead.
+
+CMAKE_MINIMUM_REQUIRED(VERSION 3.19)
+
+IF(NOT UPDATE AND NOT EXISTS ${BASELINE})
+  IF("$ENV{CI}")
+    MESSAGE(FATAL_ERROR "Missing baseline at ${BASELINE}. See doc/BUILD.md.")
+  ENDIF()
+  MESSAGE("No baseline at ${BASELINE}, skipping. See doc/BUILD.md.")
+  RETURN()
+ENDIF()
+
+SEPARATE_ARGUMENTS(ARGS UNIX_COMMAND "${ARGS}")
+SEPARATE_ARGUMENTS(METRICS UNIX_COMMAND "${METRICS}")
+SEPARATE_ARGUMENTS(IGNORE UNIX_COMMAND "${IGNORE}")
+IF(NOT DEFINED TOLERANCE)
+  SET(TOLERANCE 20)
+ENDIF()
+
+IF(DEFINED OUTPUT)
+  EXECUTE_PROCESS(COMMAND ${BENCH} ${ARGS} RESULT_VARIABLE rv)
+  IF(rv EQUAL 0)
+    FILE(READ ${OUTPUT} result)
+  ENDIF()
+ELSE()
+  EXECUTE_PROCESS(
+    COMMAND ${BENCH} ${ARGS} RESULT_VARIABLE rv OUTPUT_VARIABLE result)
+ENDIF()
+IF(NOT rv EQUAL 0)
+  MESSAGE(FATAL_ERROR "Failed ${BENCH} ${ARGS}: ${rv}")
+ENDIF()
+
+IF(UPDATE)
+  FILE(WRITE ${BASELINE} "${result}")
+  MESSAGE(STATUS "Wrote ${BASELINE}")
+  RETURN()
+ENDIF()
+FILE(READ ${BASELINE} baseline)
+
+# Converts the JSON number `value` into an integer of thousandths, for
+# MATH(). Digits beyond the thousandths are truncated.
+FUNCTION(_perf_milli out value)
+  IF(NOT value MATCHES "^(-?)([0-9]*)\\.?([0-9]*)([eE]([-+]?[0-9]+))?$")
+    MESSAGE(FATAL_ERROR "Not a number: ${value}")
+  ENDIF()
+  SET(sign "${CMAKE_MATCH_1}")
+  SET(digits "${CMAKE_MATCH_2}${CMAKE_MATCH_3}")
+  IF(digits STREQUAL "")
+    MESSAGE(FATAL_ERROR "Not a number: ${value}")
+  ENDIF()
+  STRING(LENGTH "${CMAKE_MATCH_2}" point)
+  IF(NOT "${CMAKE_MATCH_5}" STREQUAL "")
+    STRING(REGEX REPLACE "^\\+" "" exponent "${CMAKE_MATCH_5}")
+    MATH(EXPR point "${point} + ${exponent}")
+  ENDIF()
+
+  # Shifts the decimal point by the exponent, padding with zeros so that
+  # there are digits up to the thousandths.
+  WHILE(point LESS 0)
+    SET(digits "0${digits}")
+    MATH(EXPR point "${point} + 1")
+  ENDWHILE()
+  STRING(LENGTH "${digits}" length)
+  MATH(EXPR padding "${point} + 3 - ${length}")
+  IF(padding GREATER 0)
+    STRING(REPEAT "0" ${padding} zeros)
+    SET(digits "${digits}${zeros}")
+  ENDIF()
+  STRING(SUBSTRING "${digits}" 0 ${point} integer)
+  STRING(SUBSTRING "${digits}" ${point} 3 fraction)
+  SET(integer "0${integer}")
+  # Strips leading zeros, so these don't read as octal.
+  FOREACH(part integer fraction)
+    IF(${part} MATCHES "^0*([0-9]+)$")
+      SET(${part} "${CMAKE_MATCH_1}")
+    ENDIF()
+  ENDFOREACH()
+  MATH(EXPR milli "${integer} * 1000 + ${fraction}")
+  SET(${out} "${sign}${milli}" PARENT_SCOPE)
+ENDFUNCTION()
+
+# Compares the metric at the member path ARGN, recursing into objects.
+FUNCTION(_perf_compare)
+  STRING(JSON type TYPE "${baseline}" ${ARGN})
+  IF(type STREQUAL "OBJECT")
+    STRING(JSON length LENGTH "${baseline}" ${ARGN})
+    MATH(EXPR last "${length} - 1")
+    FOREACH(i RANGE ${last})
+      STRING(JSON member MEMBER "${baseline}" ${ARGN} ${i})
+      _perf_compare(${ARGN} ${member})
+    ENDFOREACH()
+    RETURN()
+  ENDIF()
+
+  LIST(GET ARGN -1 name)
+  IF(name IN_LIST IGNORE OR NOT type STREQUAL "NUMBER")
+    RETURN()
+  ENDIF()
+  STRING(REPLACE ";" "." path "${ARGN}")
+  STRING(JSON expected GET "${baseline}" ${ARGN})
+  STRING(JSON actual ERROR_VARIABLE error GET "${result}" ${ARGN})
+  IF(error)
+    MESSAGE(SEND_ERROR "${path}: Missing in result.")
+    RETURN()
+  ENDIF()
+
+  _perf_milli(expected_milli ${expected})
+  _perf_milli(actual_milli ${actual})
+  MATH(EXPR limit_milli "${expected_milli} * (100 + ${TOLERANCE}) / 100")
+  IF(actual_milli GREATER limit_milli)
+    MESSAGE(SEND_ERROR
+      "${path}: ${actual} regressed from ${expected}, by more than "
+      "${TOLERANCE}%.")
+  ELSE()
+    MESSAGE("${path}: ${actual}, baseline ${expected}.")
+  ENDIF()
+ENDFUNCTION()
+
+# Checks the parameters first: Metrics of another run don't compare.
+STRING(JSON length LENGTH "${baseline}")
+MATH(EXPR last "${length} - 1")
+FOREACH(i RANGE ${last})
+  STRING(JSON member MEMBER "${baseline}" ${i})
+  IF(NOT member IN_LIST METRICS)
+    STRING(JSON expected GET "${baseline}" ${member})
+    STRING(JSON actual ERROR_VARIABLE error GET "${result}" ${member})
+    IF(error OR NOT actual STREQUAL expected)
+      MESSAGE(FATAL_ERROR
+        "Parameter ${member} is ${actual}, baseline has ${expected}. "
+        "Write the baseline again, see doc/BUILD.md.")
+    ENDIF()
+  ENDIF()
+ENDFOREACH()
+FOREACH(member ${METRICS})
+  _perf_compare(${member})
+ENDFOREACH()
@@ -20,11 +20,16 @@
 #ifndef __WLMBE_BACKEND_H__
 #define __WLMBE_BACKEND_H__
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <libbase/libbase.h>
 #include <libbase/plist.h>
+#include <toolkit/toolkit.h>
 //#include <wayland-server-core.h>
 
+#include "output.h"
+#include "remote.h"
+
 struct wl_display;
 struct wlr_output_layout;
 struct wlr_scene;
@@ -73,6 +78,95 @@ void wlmbe_backend_destroy(wlmbe_backend_t *backend_ptr);
  */
 void wlmbe_backend_switch_to_vt(wlmbe_backend_t *backend_ptr, unsigned vt_num);
 
+/**
+ * Sets the toolkit root, for outputs to look up their fullscreen windows.
+ * Must be reset to NULL before the root is destroyed.
+ *
+ * @param backend_ptr
+ * @param root_ptr            May be NULL.
+ */
+void wlmbe_backend_set_root(
+    wlmbe_backend_t *backend_ptr,
+    wlmtk_root_t *root_ptr);
+
+/**
+ * Configures all outputs discovered, but not yet configured.
+ *
+ * New outputs are otherwise configured after a short delay, to merge bursts
+ * of hotplug events into a single transaction. Call this right after
+ * starting the wlroots backend, to have the initial outputs available.
+ *
+ * @param backend_ptr
+ */
+void wlmbe_backend_configure_pending_outputs(wlmbe_backend_t *backend_ptr);
+
+/**
+ * Powers all outputs on or off, see @ref wlmbe_output_set_powered. While
+ * all outputs are off, no frame callbacks are sent to hidden surfaces
+ * either: The compositor stops rendering.
+ *
+ * @param backend_ptr
+ * @param powered
+ */
+void wlmbe_backend_set_outputs_powered(
+    wlmbe_backend_t *backend_ptr,
+    bool powered);
+
+/**
+ * Logs the frame timing statistics of all outputs.
+ *
+ * @param backend_ptr
+ * @param severity
+ */
+void wlmbe_backend_log_stats(
+    wlmbe_backend_t *backend_ptr,
+    bs_log_severity_t severity);
+
+/**
+ * Calls `func` for each output of the backend.
+ *
+ * @param backend_ptr
+ * @param func
+ * @param ud_ptr
+ */
+void wlmbe_backend_for_each_output(
+    wlmbe_backend_t *backend_ptr,
+    void (*func)(wlmbe_output_t *output_ptr, void *ud_ptr),
+    void *ud_ptr);
+
+/**
+ * Calls `func` for each remote output of the backend. These are configured
+ * through the `Remote` dict, and stream their frames to a consumer set by
+ * @ref wlmbe_remote_set_consumer.
+ *
+ * @param backend_ptr
+ * @param func
+ * @param ud_ptr
+ */
+void wlmbe_backend_for_each_remote(
+    wlmbe_backend_t *backend_ptr,
+    void (*func)(wlmbe_remote_t *remote_ptr, void *ud_ptr),
+    void *ud_ptr);
+
+/**
+ * Magnifies all outputs, see @ref wlmbe_output_set_magnification. Each
+ * output keeps the point at the focus in place, or the closest one on the
+ * output. Zoom and focus animate to the values set here.
+ *
+ * @param backend_ptr
+ * @param zoom                Magnification. 1.0 (or less) to stop.
+ * @param lx                  Focus, horizontal, in layout coordinates.
+ * @param ly                  Focus, vertical, in layout coordinates.
+ */
+void wlmbe_backend_set_magnification(
+    wlmbe_backend_t *backend_ptr,
+    double zoom,
+    double lx,
+    double ly);
+
+/** @return The magnification last set, 1.0 if none. */
+double wlmbe_backend_magnification(wlmbe_backend_t *backend_ptr);
+
 /** Accessor. TODO(kaeser@gubbe.ch): Eliminate. */
 struct wlr_backend *wlmbe_backend_wlr(wlmbe_backend_t *backend_ptr);
 /** Accessor. TODO(kaeser@gubbe.ch): Eliminate. */
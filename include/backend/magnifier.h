@@ -0,0 +1,127 @@
+/* ========================================================================= */
+/**
+ * @file magnifier.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMBE_MAGNIFIER_H__
+#define __WLMBE_MAGNIFIER_H__
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Forward declaration: Magnifier of an output. */
+typedef struct _wlmbe_magnifier_t wlmbe_magnifier_t;
+
+struct wlr_output;
+struct wlr_output_state;
+struct wlr_swapchain;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Creates a magnifier. It shows a viewport of the output's contents, scaled
+ * up to cover the output. The viewport follows a focus point, such that the
+ * point under the focus stays in place: With the focus at the cursor, the
+ * cursor points where it shows.
+ *
+ * Zoom and focus are animated towards their targets, advanced by
+ * @ref wlmbe_magnifier_step on each frame.
+ *
+ * @return The magnifier, or NULL on error. Must be destroyed by calling
+ *     @ref wlmbe_magnifier_destroy.
+ */
+wlmbe_magnifier_t *wlmbe_magnifier_create(void);
+
+/**
+ * Destroys the magnifier.
+ *
+ * @param magnifier_ptr
+ */
+void wlmbe_magnifier_destroy(wlmbe_magnifier_t *magnifier_ptr);
+
+/**
+ * Sets the zoom and focus to animate towards.
+ *
+ * @param magnifier_ptr
+ * @param zoom                Magnification. 1.0 (or less) to stop.
+ * @param x                   Focus, horizontal, in buffer pixels.
+ * @param y                   Focus, vertical, in buffer pixels.
+ */
+void wlmbe_magnifier_set_target(
+    wlmbe_magnifier_t *magnifier_ptr,
+    double zoom,
+    double x,
+    double y);
+
+/**
+ * Advances zoom and focus to `now_msec`.
+ *
+ * @param magnifier_ptr
+ * @param now_msec            Monotonic time, in milliseconds.
+ *
+ * @return Whether the viewport changed since the previous step.
+ */
+bool wlmbe_magnifier_step(wlmbe_magnifier_t *magnifier_ptr, uint64_t now_msec);
+
+/** @return Whether zoomed, or animating towards a zoom. */
+bool wlmbe_magnifier_active(wlmbe_magnifier_t *magnifier_ptr);
+
+/** @return Whether zoom or focus are still animating. */
+bool wlmbe_magnifier_animating(wlmbe_magnifier_t *magnifier_ptr);
+
+/**
+ * Returns the swapchain to render the scene into, while magnifying. It is
+ * (re-)created to match the output's size and format.
+ *
+ * @param magnifier_ptr
+ * @param wlr_output_ptr
+ *
+ * @return The swapchain, or NULL if not magnifying or on error.
+ */
+struct wlr_swapchain *wlmbe_magnifier_swapchain(
+    wlmbe_magnifier_t *magnifier_ptr,
+    struct wlr_output *wlr_output_ptr);
+
+/**
+ * Renders the viewport of the scene's buffer in `state_ptr` into a buffer
+ * of the output's swapchain, scaled to cover the output, and replaces the
+ * state's buffer with that. Without a buffer in `state_ptr` (no damage),
+ * the previous scene's buffer is used.
+ *
+ * @param magnifier_ptr
+ * @param wlr_output_ptr
+ * @param state_ptr
+ *
+ * @return true on success.
+ */
+bool wlmbe_magnifier_render(
+    wlmbe_magnifier_t *magnifier_ptr,
+    struct wlr_output *wlr_output_ptr,
+    struct wlr_output_state *state_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmbe_magnifier_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMBE_MAGNIFIER_H__ */
+/* == End of magnifier.h =================================================== */
@@ -21,13 +21,58 @@
 #define __WLMBE_OUTPUT_H__
 
 #include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <toolkit/toolkit.h>
 
 #include "output_config.h"
 
 /** Handle for an output device. */
 typedef struct _wlmbe_output_t wlmbe_output_t;
 
+struct wlr_content_type_manager_v1;
+struct wlr_tearing_control_manager_v1;
+
+/** Frame timing statistics of an output. Cumulative. */
+typedef struct {
+    /** Number of commits. */
+    uint64_t                  commits;
+    /** Sum of the commit durations, in nanoseconds. */
+    uint64_t                  commit_nsec_sum;
+    /** Longest commit duration, in nanoseconds. */
+    uint64_t                  commit_nsec_max;
+    /** Vertical blanks that passed after a commit, without presenting it. */
+    uint64_t                  missed_vblanks;
+    /** Number of intervals between consecutive presentations sampled. */
+    uint64_t                  jitter_samples;
+    /** Sum of deviations from the expected interval, in nanoseconds. */
+    uint64_t                  jitter_nsec_sum;
+    /** Largest deviation from the expected interval, in nanoseconds. */
+    uint64_t                  jitter_nsec_max;
+    /** Sum of the buffers shown on the output, over all commits. */
+    uint64_t                  buffers_sum;
+    /** Largest number of buffers shown in a commit. */
+    uint64_t                  buffers_max;
+    /** Sum of damaged pixels, over all commits. */
+    uint64_t                  damage_px_sum;
+    /** Largest area damaged in a commit, in pixels. */
+    uint64_t                  damage_px_max;
+    /** Commits that scanned out a client buffer directly. */
+    uint64_t                  scanout_hits;
+    /** Commits that were composited. */
+    uint64_t                  scanout_misses;
+    /** Sum of occluded windows, over all commits. */
+    uint64_t                  occluded_sum;
+    /** Largest number of occluded windows in a commit. */
+    uint64_t                  occluded_max;
+    /** Commits that showed the cursor on the hardware cursor plane. */
+    uint64_t                  cursor_hardware;
+    /** Commits that composited the cursor into the frame (software). */
+    uint64_t                  cursor_software;
+} wlmbe_output_stats_t;
+
 struct wlr_output;
+struct wlr_output_state;
 struct wlr_allocator;
 struct wlr_renderer;
 struct wlr_scene;
@@ -39,13 +84,15 @@ extern "C" {
 /**
  * Creates an output device from `wlr_output_ptr`.
  *
+ * Initializes rendering for the output, but does not commit: The initial
+ * configuration is obtained from @ref wlmbe_output_build_state, and may be
+ * committed jointly with other outputs.
+ *
  * @param wlr_output_ptr
  * @param wlr_allocator_ptr
  * @param wlr_renderer_ptr
  * @param wlr_scene_ptr
  * @param config_ptr
- * @param width
- * @param height
  *
  * @return The output device handle or NULL on error.
  */
@@ -54,7 +101,19 @@ wlmbe_output_t *wlmbe_output_create(
     struct wlr_allocator *wlr_allocator_ptr,
     struct wlr_renderer *wlr_renderer_ptr,
     struct wlr_scene *wlr_scene_ptr,
-    wlmbe_output_config_t *config_ptr,
+    wlmbe_output_config_t *config_ptr);
+
+/**
+ * Builds the initial state of the output from its configured attributes.
+ *
+ * @param output_ptr
+ * @param state_ptr           An initialized `struct wlr_output_state`.
+ * @param width               Desired width for windowed mode, or 0.
+ * @param height              Desired height for windowed mode, or 0.
+ */
+void wlmbe_output_build_state(
+    wlmbe_output_t *output_ptr,
+    struct wlr_output_state *state_ptr,
     int width,
     int height);
 
@@ -65,6 +124,109 @@ wlmbe_output_t *wlmbe_output_create(
  */
 void wlmbe_output_destroy(wlmbe_output_t *output_ptr);
 
+/**
+ * Logs the frame timing statistics of the output: Commit duration, missed
+ * vertical blanks, jitter of the presentation interval, and the number of
+ * buffers and damaged area per frame.
+ *
+ * @param output_ptr
+ * @param severity
+ */
+void wlmbe_output_log_stats(
+    wlmbe_output_t *output_ptr,
+    bs_log_severity_t severity);
+
+/** @return Pointer to the frame timing statistics of the output. */
+const wlmbe_output_stats_t *wlmbe_output_get_stats(wlmbe_output_t *output_ptr);
+
+/**
+ * Sets the toolkit root. Used to find fullscreen windows shown on this
+ * output, for @ref WLMBE_ADAPTIVE_SYNC_FULLSCREEN.
+ *
+ * @param output_ptr
+ * @param root_ptr            May be NULL.
+ */
+void wlmbe_output_set_root(wlmbe_output_t *output_ptr, wlmtk_root_t *root_ptr);
+
+/**
+ * Sets the managers for the presentation hints of client surfaces. The
+ * hints of a fullscreen surface select async page flips (tearing) and, for
+ * @ref WLMBE_ADAPTIVE_SYNC_CONTENT, adaptive sync.
+ *
+ * @param output_ptr
+ * @param wlr_tearing_control_manager_v1_ptr May be NULL.
+ * @param wlr_content_type_manager_v1_ptr May be NULL.
+ */
+void wlmbe_output_set_hint_managers(
+    wlmbe_output_t *output_ptr,
+    struct wlr_tearing_control_manager_v1 *wlr_tearing_control_manager_v1_ptr,
+    struct wlr_content_type_manager_v1 *wlr_content_type_manager_v1_ptr);
+
+/**
+ * Powers the output on or off, eg. for display power management. This
+ * disables the `wlr_output`, but keeps the output's configuration: The
+ * output remains in the layout, and is restored when powered on.
+ *
+ * While powered off, the output does not raise `frame` events, and it does
+ * not commit. Surfaces shown only on this output leave it, and do not get
+ * frame callbacks from it.
+ *
+ * @param output_ptr
+ * @param powered             Whether to power the output on.
+ *
+ * @return true on success, or if already in the requested state. False if
+ *     the commit failed, or the output is disabled by configuration.
+ */
+bool wlmbe_output_set_powered(wlmbe_output_t *output_ptr, bool powered);
+
+/** @return Whether the output is powered, see @ref wlmbe_output_set_powered */
+bool wlmbe_output_powered(wlmbe_output_t *output_ptr);
+
+/**
+ * Holds back the output's frames, eg. while a consumer of its buffers is
+ * busy. A held output neither commits nor sends frame callbacks, as if
+ * powered off. Its damage accumulates, for the first frame once released.
+ *
+ * @param output_ptr
+ * @param held
+ */
+void wlmbe_output_set_held(wlmbe_output_t *output_ptr, bool held);
+
+/**
+ * Sets the output that `output_ptr` mirrors: Each buffer committed to
+ * `source_ptr` is then shown on `output_ptr` as well. It is scanned out
+ * directly if the mirror accepts it, or blitted once, scaled to fit. The
+ * scene is not rendered for the mirror.
+ *
+ * @param output_ptr
+ * @param source_ptr          The output to mirror, or NULL to stop.
+ */
+void wlmbe_output_set_mirror_source(
+    wlmbe_output_t *output_ptr,
+    wlmbe_output_t *source_ptr);
+
+/**
+ * @return Whether the output is configured as mirror, see
+ *     @ref wlmbe_output_config_attributes_t::mirror.
+ */
+bool wlmbe_output_is_mirror(wlmbe_output_t *output_ptr);
+
+/**
+ * Magnifies the output: Scales up a viewport of the scene, such that the
+ * point at the focus stays in place. Zoom and focus animate towards the
+ * values set here, on the output's frames. Mirrors are not magnified.
+ *
+ * @param output_ptr
+ * @param zoom                Magnification. 1.0 (or less) to stop.
+ * @param x                   Focus, horizontal, in buffer pixels.
+ * @param y                   Focus, vertical, in buffer pixels.
+ */
+void wlmbe_output_set_magnification(
+    wlmbe_output_t *output_ptr,
+    double zoom,
+    double x,
+    double y);
+
 /** @return A long description string, @see wlmbe_output_t::description_ptr. */
 const char *wlmbe_output_description(wlmbe_output_t *output_ptr);
 
@@ -32,6 +32,9 @@ typedef struct _wlmbe_output_config_t wlmbe_output_config_t;
 struct wlr_output;
 struct wlr_output_layout;
 
+/** Size of @ref wlmbe_output_config_attributes_t::mirror, including NUL. */
+#define WLMBE_OUTPUT_MIRROR_SIZE 32
+
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
@@ -54,6 +57,18 @@ typedef struct {
     int32_t                   refresh;
 } wlmbe_output_config_mode_t;
 
+/** Whether and when to enable adaptive sync (variable refresh rate). */
+typedef enum {
+    /** Adaptive sync is always disabled. */
+    WLMBE_ADAPTIVE_SYNC_DISABLED,
+    /** Adaptive sync is always enabled, if the output supports it. */
+    WLMBE_ADAPTIVE_SYNC_ENABLED,
+    /** Enabled only while a fullscreen window is shown on the output. */
+    WLMBE_ADAPTIVE_SYNC_FULLSCREEN,
+    /** Enabled only while a fullscreen window shows video or game content. */
+    WLMBE_ADAPTIVE_SYNC_CONTENT
+} wlmbe_output_adaptive_sync_t;
+
 /** Description of an output, useful to identify an output. */
 typedef struct {
     /** Name of this output. */
@@ -73,6 +88,14 @@ typedef struct {
     char                      *serial_ptr;
     /** Whether the 'Serial' entry was present. */
     bool                      has_serial;
+
+    /**
+     * Bitmask of the fields (Name, Manufacturer, Model, Serial; from LSB)
+     * that hold no glob characters. These are matched through strcmp(),
+     * rather than fnmatch(). Set by
+     * @ref wlmbe_output_description_init_from_plist.
+     */
+    unsigned                  literal_fields;
 } wlmbe_output_description_t;
 
 /** Attributes of the output. */
@@ -94,6 +117,24 @@ typedef struct {
     wlmbe_output_config_mode_t mode;
     /** Whether the 'Mode' field was present. */
     bool                      has_mode;
+
+    /**
+     * Time reserved for rendering before the next vertical blank, in
+     * milliseconds. If non-zero, the commit is delayed to that deadline (or
+     * earlier, if the measured render time is longer), so that late input
+     * and client commits still make it into the frame. 0 commits right away.
+     */
+    uint64_t                  render_deadline_msec;
+
+    /** Adaptive sync (variable refresh rate) policy for this output. */
+    wlmbe_output_adaptive_sync_t adaptive_sync;
+
+    /**
+     * Name of the output to mirror, eg. "eDP-1". Empty to not mirror. A
+     * mirror shows the buffers rendered for that output, rather than the
+     * scene. It is not part of the output layout.
+     */
+    char                      mirror[WLMBE_OUTPUT_MIRROR_SIZE];
 } wlmbe_output_config_attributes_t;
 
 /** Returns the base pointer from the  @ref wlmbe_output_config_t::dlnode. */
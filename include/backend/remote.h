@@ -0,0 +1,154 @@
+/* ========================================================================= */
+/**
+ * @file remote.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMBE_REMOTE_H__
+#define __WLMBE_REMOTE_H__
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "output.h"
+
+/** Forward declaration: A remote output, streaming its frames. */
+typedef struct _wlmbe_remote_t wlmbe_remote_t;
+/** Forward declaration: A frame of the remote output. */
+typedef struct _wlmbe_remote_frame_t wlmbe_remote_frame_t;
+
+struct pixman_box32;
+struct wlr_buffer;
+struct wlr_dmabuf_attributes;
+struct wlr_output;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Callback for each frame committed to the remote output.
+ *
+ * The frame remains valid until passed to @ref wlmbe_remote_frame_release.
+ * That may happen right from the callback, or later. While the consumer
+ * holds too many frames, the output stops rendering.
+ *
+ * @param frame_ptr
+ * @param ud_ptr
+ */
+typedef void (*wlmbe_remote_frame_callback_t)(
+    wlmbe_remote_frame_t *frame_ptr,
+    void *ud_ptr);
+
+/**
+ * Creates a remote output for `output_ptr`, a virtual (headless) output.
+ *
+ * Without a consumer, the output renders as every other. Once a consumer
+ * is set, each committed frame is handed over, with the damage since the
+ * previous frame.
+ *
+ * @param output_ptr
+ *
+ * @return The remote output, or NULL on error. Must be destroyed by
+ *     calling @ref wlmbe_remote_destroy.
+ */
+wlmbe_remote_t *wlmbe_remote_create(wlmbe_output_t *output_ptr);
+
+/**
+ * Destroys the remote output. Frames not yet released remain valid, and
+ * must still be released.
+ *
+ * @param remote_ptr
+ */
+void wlmbe_remote_destroy(wlmbe_remote_t *remote_ptr);
+
+/**
+ * Sets the consumer of the remote output's frames. Its first frame is
+ * reported as entirely damaged.
+ *
+ * @param remote_ptr
+ * @param callback            Called for each frame. NULL to stop.
+ * @param ud_ptr              Passed to `callback`.
+ * @param max_fps             At most this many frames per second, or 0 for
+ *                            the output's refresh rate.
+ * @param max_frames_in_flight Frames the consumer may hold, not yet
+ *                            released. Rendering pauses once reached, and
+ *                            damage accumulates. At least 1.
+ */
+void wlmbe_remote_set_consumer(
+    wlmbe_remote_t *remote_ptr,
+    wlmbe_remote_frame_callback_t callback,
+    void *ud_ptr,
+    unsigned max_fps,
+    unsigned max_frames_in_flight);
+
+/** @return The `struct wlr_output` of the remote, or NULL if destroyed. */
+struct wlr_output *wlmbe_remote_wlr_output(wlmbe_remote_t *remote_ptr);
+
+/**
+ * Releases the frame. Resumes rendering, if the consumer held too many.
+ *
+ * @param frame_ptr
+ */
+void wlmbe_remote_frame_release(wlmbe_remote_frame_t *frame_ptr);
+
+/** @return The frame's buffer. Locked until the frame is released. */
+struct wlr_buffer *wlmbe_remote_frame_buffer(wlmbe_remote_frame_t *frame_ptr);
+
+/**
+ * Retrieves the DMA-BUF attributes of the frame's buffer: File descriptors,
+ * offsets and strides of its planes. They remain owned by the buffer.
+ *
+ * @param frame_ptr
+ * @param attributes_ptr
+ *
+ * @return false if the buffer is not a DMA-BUF, eg. with a pixman renderer.
+ */
+bool wlmbe_remote_frame_dmabuf(
+    wlmbe_remote_frame_t *frame_ptr,
+    struct wlr_dmabuf_attributes *attributes_ptr);
+
+/**
+ * Returns the rectangles that changed since the previous frame.
+ *
+ * @param frame_ptr
+ * @param rects_ptr           Set to the number of rectangles.
+ *
+ * @return The rectangles, in buffer coordinates.
+ */
+const struct pixman_box32 *wlmbe_remote_frame_damage(
+    wlmbe_remote_frame_t *frame_ptr,
+    int *rects_ptr);
+
+/** @return Sequence number of the frame, counting from 1. */
+uint64_t wlmbe_remote_frame_sequence(wlmbe_remote_frame_t *frame_ptr);
+
+/** Returns the base pointer from @ref wlmbe_remote_t::dlnode. */
+wlmbe_remote_t *wlmbe_remote_from_dlnode(bs_dllist_node_t *dlnode_ptr);
+
+/** Returns a pointer to @ref wlmbe_remote_t::dlnode. */
+bs_dllist_node_t *wlmbe_dlnode_from_remote(wlmbe_remote_t *remote_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmbe_remote_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMBE_REMOTE_H__ */
+/* == End of remote.h ====================================================== */
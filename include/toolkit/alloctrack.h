@@ -0,0 +1,137 @@
+/* ========================================================================= */
+/**
+ * @file alloctrack.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_ALLOCTRACK_H__
+#define __WLMTK_ALLOCTRACK_H__
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/** Live allocations of one call site. See @ref wlmtk_alloctrack_get_sites. */
+typedef struct {
+    /** Name of the allocator: `heap`, or the name of the pool. */
+    const char                *name_ptr;
+    /** Return address of the allocating call. */
+    const void                *site_ptr;
+    /** Number of live allocations. */
+    size_t                    allocations;
+    /** Sum of the live allocations' sizes, in bytes. */
+    size_t                    bytes;
+} wlmtk_alloctrack_site_t;
+
+#if defined(WLMTK_ALLOC_TRACK)
+
+/**
+ * Records that `_ptr` holds `_size` bytes, allocated by `_name` on behalf
+ * of the caller of the enclosing function.
+ *
+ * Expands to nothing, unless `WLMTK_ALLOC_TRACK` is defined.
+ */
+#define WLMTK_ALLOCTRACK_RECORD(_ptr, _size, _name)                     \
+    wlmtk_alloctrack_record((_ptr), (_size), (_name),                   \
+                            __builtin_return_address(0))
+
+/** Records that `_ptr` was released. See @ref WLMTK_ALLOCTRACK_RECORD. */
+#define WLMTK_ALLOCTRACK_RELEASE(_ptr) wlmtk_alloctrack_release(_ptr)
+
+#else  // defined(WLMTK_ALLOC_TRACK)
+
+/** Allocation tracking is compiled out: Expands to nothing. */
+#define WLMTK_ALLOCTRACK_RECORD(_ptr, _size, _name)
+/** Allocation tracking is compiled out: Expands to nothing. */
+#define WLMTK_ALLOCTRACK_RELEASE(_ptr)
+
+#endif  // defined(WLMTK_ALLOC_TRACK)
+
+/**
+ * Records a live allocation. Prefer @ref WLMTK_ALLOCTRACK_RECORD.
+ *
+ * With `WLMTK_ALLOC_TRACK` defined, `malloc`, `calloc`, `realloc` and
+ * `free` are wrapped at link time, and record all heap allocations made
+ * from code linked with the toolkit. Allocations made inside shared
+ * libraries are not seen.
+ *
+ * Thread-safe.
+ *
+ * @param ptr                 Address of the allocation.
+ * @param size                Size of the allocation, in bytes.
+ * @param name_ptr            Name of the allocator. Must outlive the
+ *                            tracker; a string literal.
+ * @param site_ptr            Address identifying the call site.
+ */
+void wlmtk_alloctrack_record(
+    const void *ptr,
+    size_t size,
+    const char *name_ptr,
+    const void *site_ptr);
+
+/**
+ * Records that the allocation at `ptr` was released. Does nothing if `ptr`
+ * was not recorded.
+ *
+ * @param ptr
+ */
+void wlmtk_alloctrack_release(const void *ptr);
+
+/**
+ * Returns the total of all live recorded allocations.
+ *
+ * @param allocations_ptr
+ * @param bytes_ptr
+ */
+void wlmtk_alloctrack_get_totals(size_t *allocations_ptr, size_t *bytes_ptr);
+
+/**
+ * Retrieves the call sites with live allocations, largest first.
+ *
+ * @param sites_ptr           Array to store the sites in.
+ * @param max_sites           Size of the array at `sites_ptr`.
+ *
+ * @return Number of call sites with live allocations. Only the first
+ *     `max_sites` of these are stored.
+ */
+size_t wlmtk_alloctrack_get_sites(
+    wlmtk_alloctrack_site_t *sites_ptr,
+    size_t max_sites);
+
+/**
+ * Writes the live allocations grouped by call site, largest first. Sites
+ * are symbolized where possible, as `file(symbol+offset)`.
+ *
+ * @param file_ptr
+ *
+ * @return true on success.
+ */
+bool wlmtk_alloctrack_write(FILE *file_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_alloctrack_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_ALLOCTRACK_H__ */
+/* == End of alloctrack.h ================================================== */
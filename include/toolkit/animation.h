@@ -0,0 +1,139 @@
+/* ========================================================================= */
+/**
+ * @file animation.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_ANIMATION_H__
+#define __WLMTK_ANIMATION_H__
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "element.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/** Properties of an animated snapshot, at the start or end. */
+typedef struct {
+    /** Horizontal offset from the element's position. */
+    int                       x;
+    /** Vertical offset from the element's position. */
+    int                       y;
+    /** Scale of the snapshot, around its top-left corner. */
+    double                    scale;
+    /** Opacity, from 0 (transparent) to 1 (opaque). */
+    float                     opacity;
+    /** Fraction of the snapshot's height that remains visible, from top. */
+    double                    clip;
+} wlmtk_animation_props_t;
+
+/** Properties of the snapshot as-is: Unmoved, unscaled, opaque, unclipped. */
+extern const wlmtk_animation_props_t wlmtk_animation_props_identity;
+
+/**
+ * Enables or disables animations. Disabling finishes all running
+ * animations. Animations are disabled by default.
+ *
+ * @param enabled
+ */
+void wlmtk_animation_set_enabled(bool enabled);
+
+/**
+ * Animates a snapshot of `element_ptr`.
+ *
+ * The snapshot references the element's current buffers, in new scene
+ * buffers stacked right above the element. Only the snapshot's scene nodes
+ * are changed while animating: Clients are not re-configured. The snapshot
+ * is destroyed once the animation completes.
+ *
+ * The animation starts at the next @ref wlmtk_animation_tick. Typically, the
+ * caller applies the element's final state right after this call, for it
+ * to be revealed once the snapshot is gone.
+ *
+ * @param element_ptr
+ * @param from_ptr
+ * @param to_ptr
+ * @param duration_msec
+ *
+ * @return false if animations are disabled, the element is not in a scene,
+ *     or on error. Nothing is animated then.
+ */
+bool wlmtk_animation_snapshot(
+    wlmtk_element_t *element_ptr,
+    const wlmtk_animation_props_t *from_ptr,
+    const wlmtk_animation_props_t *to_ptr,
+    uint64_t duration_msec);
+
+/**
+ * Slides `element_ptr`'s own scene node from an offset of `from_x`, `from_y`
+ * to the element's position.
+ *
+ * Unlike @ref wlmtk_animation_snapshot, the live node is moved: Its contents
+ * keep updating while it slides. Only the node's position is changed, the
+ * element's position and its container's layout remain as they are. Replaces
+ * a translation of the element that is still running.
+ *
+ * @param element_ptr
+ * @param from_x
+ * @param from_y
+ * @param duration_msec
+ *
+ * @return false if animations are disabled, or on error. The node is then
+ *     placed at the element's position right away.
+ */
+bool wlmtk_animation_translate(
+    wlmtk_element_t *element_ptr,
+    int from_x,
+    int from_y,
+    uint64_t duration_msec);
+
+/**
+ * Finishes a running translation of `element_ptr`, if any: Its node is
+ * returned to the element's position.
+ *
+ * @param element_ptr
+ */
+void wlmtk_animation_cancel(wlmtk_element_t *element_ptr);
+
+/**
+ * Advances all animations to `now_msec`. Meant to be called once per output
+ * frame, before the frame is rendered. Calls at the same time are
+ * idempotent, so this is safe for multiple outputs.
+ *
+ * If the frame budget was exceeded, running animations are finished, and
+ * new animations are skipped for a short while.
+ *
+ * @param now_msec            Monotonic time, in milliseconds.
+ * @param over_budget         Whether rendering exceeds the frame budget.
+ */
+void wlmtk_animation_tick(uint64_t now_msec, bool over_budget);
+
+/** @return Whether any animation is running. */
+bool wlmtk_animation_active(void);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_animation_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_ANIMATION_H__ */
+/* == End of animation.h =================================================== */
@@ -0,0 +1,94 @@
+/* ========================================================================= */
+/**
+ * @file arena.h
+ *
+ * @copyright
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_ARENA_H__
+#define __WLMTK_ARENA_H__
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/** Statistics of the locked arena. */
+typedef struct {
+    /** Bytes of the arena, locked in memory. 0 if not enabled. */
+    size_t                    locked_bytes;
+    /** Bytes of the arena handed out so far, including freed blocks. */
+    size_t                    used_bytes;
+    /** Number of blocks currently allocated from the arena. */
+    size_t                    blocks;
+    /** Number of allocations that did not fit, and went to the heap. */
+    size_t                    fallbacks;
+} wlmtk_arena_stats_t;
+
+/**
+ * Enables the locked arena, for hot structures that must not page-fault:
+ * Slabs of @ref wlmtk_pool_t, and whatever else allocates through
+ * @ref wlmtk_arena_calloc.
+ *
+ * The arena is mapped, pre-faulted and locked in memory. It does not grow:
+ * Allocations beyond its size are served from the heap. Call this before
+ * any allocation through @ref wlmtk_arena_calloc, and only once.
+ *
+ * @param bytes               Size of the arena. Rounded up to pages.
+ *
+ * @return true on success. false if the arena could not be mapped or
+ *     locked, eg. exceeding `RLIMIT_MEMLOCK`. Allocations then go to the
+ *     heap.
+ */
+bool wlmtk_arena_lock(size_t bytes);
+
+/**
+ * Allocates zero-initialized memory. From the locked arena if enabled and
+ * it has space, otherwise from the heap. Only use from the main thread.
+ *
+ * @param size
+ *
+ * @return Pointer to the memory, or NULL on error. Must be released with
+ *     @ref wlmtk_arena_free.
+ */
+void *wlmtk_arena_calloc(size_t size);
+
+/**
+ * Releases memory from @ref wlmtk_arena_calloc. Freed blocks of the arena
+ * are kept for re-use by allocations of the same size.
+ *
+ * @param ptr                 May be NULL.
+ */
+void wlmtk_arena_free(void *ptr);
+
+/**
+ * Retrieves statistics of the arena.
+ *
+ * @param stats_ptr
+ */
+void wlmtk_arena_get_stats(wlmtk_arena_stats_t *stats_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_arena_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_ARENA_H__ */
+/* == End of arena.h ======================================================= */
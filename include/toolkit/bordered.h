@@ -26,9 +26,11 @@
 
 #include "element.h"
 #include "container.h"
-#include "rectangle.h"
 #include "style.h"
 
+/** Forward declaration. */
+struct wlr_scene_rect;
+
 struct _wlmtk_bordered_t;
 /** Forward declaration: Bordered container state. */
 typedef struct _wlmtk_bordered_t wlmtk_bordered_t;
@@ -43,27 +45,38 @@ struct _wlmtk_bordered_t {
     wlmtk_container_t         super_container;
     /** Virtual method table of the super container before extending it. */
     wlmtk_container_vmt_t     orig_super_container_vmt;
+    /** Virtual method table of the super element before extending it. */
+    wlmtk_element_vmt_t       orig_super_element_vmt;
 
     /** Points to the element that will be enclosed by the border. */
     wlmtk_element_t           *element_ptr;
     /** Style of the border. */
     wlmtk_margin_style_t      style;
 
-    /** Border element at the northern side. Includes east + west corners. */
-    wlmtk_rectangle_t         *northern_border_rectangle_ptr;
-    /** Border element at the eastern side. */
-    wlmtk_rectangle_t         *eastern_border_rectangle_ptr;
-    /** Border element at the southern side. Includes east + west corners. */
-    wlmtk_rectangle_t         *southern_border_rectangle_ptr;
-    /** Border element at the western side. */
-    wlmtk_rectangle_t         *western_border_rectangle_ptr;
+    /** Width of @ref wlmtk_bordered_t::element_ptr, at the last layout. */
+    int                       width;
+    /** Height of @ref wlmtk_bordered_t::element_ptr, at the last layout. */
+    int                       height;
+
+    /** Border at the northern side. Includes east + west corners. */
+    struct wlr_scene_rect     *northern_wlr_scene_rect_ptr;
+    /** Border at the eastern side. */
+    struct wlr_scene_rect     *eastern_wlr_scene_rect_ptr;
+    /** Border at the southern side. Includes east + west corners. */
+    struct wlr_scene_rect     *southern_wlr_scene_rect_ptr;
+    /** Border at the western side. */
+    struct wlr_scene_rect     *western_wlr_scene_rect_ptr;
+    /** Listener for when the container's scene tree is destroyed. */
+    struct wl_listener        wlr_scene_tree_destroy_listener;
 };
 
 /**
  * Initializes the bordered element.
  *
  * The bordered element positions the element within such that north-western
- * corner is at (0, 0).
+ * corner is at (0, 0). The border is drawn as four `struct wlr_scene_rect`
+ * in the container's scene tree. These are not elements, but the border
+ * counts for the dimensions and the pointer area of the bordered element.
  *
  * @param bordered_ptr
  * @param element_ptr
@@ -21,6 +21,8 @@
 #define __WLMTK_BOX_H__
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include "libbase/libbase.h"
 
@@ -31,6 +33,7 @@
 struct _wlmtk_box_t;
 /** Forward declaration: Box. */
 typedef struct _wlmtk_box_t wlmtk_box_t;
+struct wlr_scene_rect;
 
 #ifdef __cplusplus
 extern "C" {
@@ -44,22 +47,85 @@ typedef enum {
     WLMTK_BOX_VERTICAL,
 } wlmtk_box_orientation_t;
 
+/** Layout of an element in the box, as of the most recent layout. */
+typedef struct {
+    /** The element. */
+    wlmtk_element_t           *element_ptr;
+    /** The element's @ref wlmtk_element_t::extents_serial, back then. */
+    uint64_t                  extents_serial;
+    /** Whether the element was visible. */
+    bool                      visible;
+    /** Leftmost position of the element's dimensions. If visible. */
+    int                       left;
+    /** Topmost position of the element's dimensions. If visible. */
+    int                       top;
+    /** Rightmost position of the element's dimensions. If visible. */
+    int                       right;
+    /** Bottommost position of the element's dimensions. If visible. */
+    int                       bottom;
+    /**
+     * Prefix sum of the extents and margins of the elements before: Where
+     * this element starts, in the box's orientation.
+     */
+    int                       position;
+    /** Number of visible elements before this one. */
+    size_t                    visible_before;
+} wlmtk_box_slot_t;
+
+/** A margin between two visible elements of the box. */
+typedef struct {
+    /** Position of the margin, relative to the box. */
+    int                       x;
+    /** Position of the margin, relative to the box. */
+    int                       y;
+    /** Width of the margin. */
+    int                       width;
+    /** Height of the margin. */
+    int                       height;
+    /** Scene rect showing the margin. NULL while the box isn't mapped. */
+    struct wlr_scene_rect     *wlr_scene_rect_ptr;
+} wlmtk_box_margin_t;
+
 /** State of the box. */
 struct _wlmtk_box_t {
-    /** Super class of the box. */
+    /**
+     * Super class of the box. Holds the box's elements directly, in a single
+     * scene tree.
+     */
     wlmtk_container_t         super_container;
     /** Virtual method table of the superclass' container. */
     wlmtk_container_vmt_t     orig_super_container_vmt;
+    /** Virtual method table of the superclass' element. */
+    wlmtk_element_vmt_t       orig_super_element_vmt;
     /** Orientation of the box. */
     wlmtk_box_orientation_t   orientation;
 
-    /** Container for the box's elements. */
-    wlmtk_container_t         element_container;
-    /** Container for margin elements. */
-    wlmtk_container_t         margin_container;
+    /**
+     * The margins, in order. Not elements: Their scene rects are at the
+     * bottom of the super container's tree, and skip pointer traversal.
+     */
+    wlmtk_box_margin_t        *margins_ptr;
+    /** Number of margins in @ref wlmtk_box_t::margins_ptr. */
+    size_t                    margins;
+    /** Allocated size of `margins_ptr`. */
+    size_t                    margins_capacity;
+    /** Listener for the `destroy` signal of the super container's tree. */
+    struct wl_listener        wlr_scene_tree_destroy_listener;
 
     /** Margin style. */
     wlmtk_margin_style_t      style;
+
+    /**
+     * Layout of the elements, in order of @ref wlmtk_box_t::super_container.
+     * Elements before the first one that changed keep their position.
+     */
+    wlmtk_box_slot_t          *slots_ptr;
+    /** Number of elements in @ref wlmtk_box_t::slots_ptr. */
+    size_t                    slots;
+    /** Allocated size of `slots_ptr` and `scratch_ptr`. */
+    size_t                    slots_capacity;
+    /** Scratch space for re-aligning the slots during layout. */
+    wlmtk_box_slot_t          *scratch_ptr;
 };
 
 /**
@@ -109,6 +175,33 @@ void wlmtk_box_add_element_back(wlmtk_box_t *box_ptr, wlmtk_element_t *element_p
  */
 void wlmtk_box_remove_element(wlmtk_box_t *box_ptr, wlmtk_element_t *element_ptr);
 
+/**
+ * Moves `element_ptr` to just before `before_element_ptr`, or to the back.
+ *
+ * Re-links the element in place, keeping its scene node: Buffers keep their
+ * textures. The layout update is incremental, from the first element that
+ * changed position.
+ *
+ * @param box_ptr
+ * @param element_ptr         Must be an element of the box.
+ * @param before_element_ptr  An element of the box, or NULL for the back.
+ */
+void wlmtk_box_move_element_before(
+    wlmtk_box_t *box_ptr,
+    wlmtk_element_t *element_ptr,
+    wlmtk_element_t *before_element_ptr);
+
+/**
+ * Sets the margin style. All elements get re-positioned with the next
+ * layout update, which is up to the caller.
+ *
+ * @param box_ptr
+ * @param style_ptr
+ */
+void wlmtk_box_set_style(
+    wlmtk_box_t *box_ptr,
+    const wlmtk_margin_style_t *style_ptr);
+
 /** @return Pointer to the superclass' @ref wlmtk_element_t of `box_ptr`. */
 wlmtk_element_t *wlmtk_box_element(wlmtk_box_t *box_ptr);
 
@@ -20,6 +20,7 @@
 #ifndef __WLMTK_BUFFER_H__
 #define __WLMTK_BUFFER_H__
 
+#include <libbase/libbase.h>
 #include <stdbool.h>
 #include <wayland-server-core.h>
 
@@ -37,23 +38,46 @@ struct wlr_buffer;
 extern "C" {
 #endif  // __cplusplus
 
+/** Virtual method table of the buffer. */
+typedef struct {
+    /**
+     * Optional: Called when the scale of the output that shows most of the
+     * buffer has changed. Permits re-rendering the contents at that scale,
+     * and setting them through @ref wlmtk_buffer_set_scaled.
+     */
+    void (*output_scale_changed)(wlmtk_buffer_t *buffer_ptr, double scale);
+} wlmtk_buffer_vmt_t;
+
 /** State of a texture-backed buffer. */
 struct _wlmtk_buffer_t {
     /** Super class of the buffer: An element. */
     wlmtk_element_t           super_element;
     /** Virtual method table of the super element before extending it. */
     wlmtk_element_vmt_t       orig_super_element_vmt;
+    /** The virtual method table. */
+    wlmtk_buffer_vmt_t        vmt;
     /** Cursor to set when we have pointer focus. */
     wlmtk_pointer_cursor_t    pointer_cursor;
 
     /** WLR buffer holding the contents. */
     struct wlr_buffer        *wlr_buffer_ptr;
+    /** Scale of `wlr_buffer_ptr`: Buffer pixels per logical pixel. */
+    double                    scale;
+    /** Scale of the output showing most of the buffer. 1.0 if none. */
+    double                    output_scale;
+    /** Logical width the contents are stretched to. 0 if not stretched. */
+    int                       stretch_width;
+    /** Logical height the contents are stretched to. 0 if not stretched. */
+    int                       stretch_height;
     /** Scene graph API node. Only set after calling `create_scene_node`. */
     struct wlr_scene_buffer  *wlr_scene_buffer_ptr;
 
     /** Listener for the `destroy` signal of `wlr_scene_buffer_ptr->node`. */
     struct wl_listener        wlr_scene_buffer_node_destroy_listener;
-
+    /** Listener for `output_enter` of `wlr_scene_buffer_ptr`. */
+    struct wl_listener        output_enter_listener;
+    /** Listener for `output_leave` of `wlr_scene_buffer_ptr`. */
+    struct wl_listener        output_leave_listener;
 };
 
 /**
@@ -65,6 +89,18 @@ struct _wlmtk_buffer_t {
  */
 bool wlmtk_buffer_init(wlmtk_buffer_t *buffer_ptr);
 
+/**
+ * Extends the buffer's virtual methods.
+ *
+ * @param buffer_ptr
+ * @param buffer_vmt_ptr
+ *
+ * @return The original virtual method table.
+ */
+wlmtk_buffer_vmt_t wlmtk_buffer_extend(
+    wlmtk_buffer_t *buffer_ptr,
+    const wlmtk_buffer_vmt_t *buffer_vmt_ptr);
+
 /**
  * Cleans up the buffer.
  *
@@ -84,9 +120,53 @@ void wlmtk_buffer_set(
     wlmtk_buffer_t *buffer_ptr,
     struct wlr_buffer *wlr_buffer_ptr);
 
+/**
+ * Sets (or updates) buffer contents rendered at `scale`. The element's
+ * dimensions are the buffer's dimensions divided by `scale`, rounded, and
+ * the scene graph presents it at that logical size.
+ *
+ * If the logical size is unchanged, the extents are not invalidated: The
+ * parent containers need no layout update.
+ *
+ * @param buffer_ptr
+ * @param wlr_buffer_ptr      See @ref wlmtk_buffer_set.
+ * @param scale               Buffer pixels per logical pixel. Must be > 0.
+ */
+void wlmtk_buffer_set_scaled(
+    wlmtk_buffer_t *buffer_ptr,
+    struct wlr_buffer *wlr_buffer_ptr,
+    double scale);
+
+/**
+ * Stretches the current contents to `width` x `height` logical pixels, until
+ * the next @ref wlmtk_buffer_set_scaled. Permits to show stale contents at
+ * the new dimensions, while the new contents are being rendered.
+ *
+ * @param buffer_ptr
+ * @param width
+ * @param height
+ */
+void wlmtk_buffer_set_stretched(
+    wlmtk_buffer_t *buffer_ptr,
+    int width,
+    int height);
+
+/**
+ * Sets the output scale of the buffer, and calls
+ * @ref wlmtk_buffer_vmt_t::output_scale_changed if it changed. Called when
+ * the buffer's scene node enters or leaves outputs.
+ *
+ * @param buffer_ptr
+ * @param scale
+ */
+void wlmtk_buffer_set_output_scale(wlmtk_buffer_t *buffer_ptr, double scale);
+
 /** @return the superclass' @ref wlmtk_element_t of `buffer_ptr`. */
 wlmtk_element_t *wlmtk_buffer_element(wlmtk_buffer_t *buffer_ptr);
 
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_buffer_test_cases[];
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
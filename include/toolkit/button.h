@@ -55,6 +55,8 @@ struct _wlmtk_button_t {
     struct wlr_buffer         *released_wlr_buffer_ptr;
     /** WLR buffer holding the button in pressed state. */
     struct wlr_buffer         *pressed_wlr_buffer_ptr;
+    /** Buffer pixels per logical pixel, of both buffers. */
+    double                    scale;
 
     /** Listens to when we obtain pointer focus. */
     struct wl_listener        pointer_enter_listener;
@@ -105,6 +107,21 @@ void wlmtk_button_set(
     struct wlr_buffer *released_wlr_buffer_ptr,
     struct wlr_buffer *pressed_wlr_buffer_ptr);
 
+/**
+ * Like @ref wlmtk_button_set, for textures rendered at `scale`. See
+ * @ref wlmtk_buffer_set_scaled.
+ *
+ * @param button_ptr
+ * @param released_wlr_buffer_ptr
+ * @param pressed_wlr_buffer_ptr
+ * @param scale               Buffer pixels per logical pixel. Must be > 0.
+ */
+void wlmtk_button_set_scaled(
+    wlmtk_button_t *button_ptr,
+    struct wlr_buffer *released_wlr_buffer_ptr,
+    struct wlr_buffer *pressed_wlr_buffer_ptr,
+    double scale);
+
 /** Unit test cases. */
 extern const bs_test_case_t wlmtk_button_test_cases[];
 
@@ -0,0 +1,89 @@
+/* ========================================================================= */
+/**
+ * @file cache.h
+ *
+ * @copyright
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_CACHE_H__
+#define __WLMTK_CACHE_H__
+
+#include <libbase/libbase.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Evicts entries from a cache, least recently used first.
+ *
+ * @param percent             Share of the cache's content to evict, from 0
+ *                            to 100. 100 drops everything not in use.
+ * @param userdata_ptr
+ *
+ * @return Number of bytes freed. May be an estimate.
+ */
+typedef size_t (*wlmtk_cache_evict_t)(unsigned percent, void *userdata_ptr);
+
+/**
+ * A cache, registered for eviction under memory pressure. Owned by the
+ * caller, and must stay valid until @ref wlmtk_cache_unregister.
+ */
+typedef struct {
+    /** Name, for logging. */
+    const char                *name_ptr;
+    /** Evicts entries. See @ref wlmtk_cache_evict_t. */
+    wlmtk_cache_evict_t       evict;
+    /** Argument to `evict`. */
+    void                      *userdata_ptr;
+    /** Node of the registry. Internal. */
+    bs_dllist_node_t          dlnode;
+} wlmtk_cache_t;
+
+/**
+ * Registers `cache_ptr` for @ref wlmtk_cache_evict. The toolkit's own caches
+ * of images, text and pixel storage are always registered.
+ *
+ * @param cache_ptr
+ */
+void wlmtk_cache_register(wlmtk_cache_t *cache_ptr);
+
+/**
+ * Unregisters `cache_ptr`. Safe to call if not registered.
+ *
+ * @param cache_ptr
+ */
+void wlmtk_cache_unregister(wlmtk_cache_t *cache_ptr);
+
+/**
+ * Evicts `percent` of the content of all caches, and logs the number of
+ * bytes freed by each. Must be called from the main thread.
+ *
+ * @param percent
+ *
+ * @return Total number of bytes freed.
+ */
+size_t wlmtk_cache_evict(unsigned percent);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_cache_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_CACHE_H__ */
+/* == End of cache.h ======================================================= */
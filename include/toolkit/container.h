@@ -21,6 +21,8 @@
 #define __WLMTK_CONTAINER_H__
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <wayland-server-core.h>
 
 #include "libbase/libbase.h"
@@ -28,6 +30,7 @@
 struct _wlmtk_container_t;
 struct _wlmtk_container_vmt_t;
 struct wlr_scene_tree;
+struct wl_event_loop;
 /** Forward declaration: Container. */
 typedef struct _wlmtk_container_t wlmtk_container_t;
 /** Forward declaration: Container virtual method table. */
@@ -56,6 +59,91 @@ struct _wlmtk_container_vmt_t {
     void (*update_layout)(wlmtk_container_t *container_ptr);
 };
 
+/**
+ * Optional spatial index over the pointer areas of the container's elements.
+ *
+ * A uniform grid spanning the union of all elements' pointer areas. Each cell
+ * lists the elements whose pointer area overlaps the cell, in stacking order.
+ * The index is rebuilt lazily on the first lookup after being invalidated.
+ * Stored in compressed form: The elements of cell `i` are at `entries_ptr`,
+ * from `cell_offsets_ptr[i]` up to `cell_offsets_ptr[i + 1]`.
+ */
+typedef struct {
+    /** Desired edge length of a cell, in pixels. 0 if disabled. */
+    int                       cell_size;
+    /** Whether the index needs to be rebuilt before the next lookup. */
+    bool                      dirty;
+    /** Incremented on each invalidation. To detect re-entrant changes. */
+    uint64_t                  generation;
+
+    /** Left-most position of the grid, in container coordinates. */
+    int                       x;
+    /** Top-most position of the grid, in container coordinates. */
+    int                       y;
+    /** Effective width of a cell. May exceed `cell_size` for large areas. */
+    int                       cell_width;
+    /** Effective height of a cell. */
+    int                       cell_height;
+    /** Number of columns of the grid. */
+    int                       columns;
+    /** Number of rows of the grid. */
+    int                       rows;
+
+    /** Offsets into `entries_ptr`, for each cell. Has `columns * rows + 1`. */
+    size_t                    *cell_offsets_ptr;
+    /** Allocated size of `cell_offsets_ptr`, in number of elements. */
+    size_t                    cell_offsets_capacity;
+    /** The elements overlapping each of the cells. */
+    wlmtk_element_t           **entries_ptr;
+    /** Allocated size of `entries_ptr`, in number of elements. */
+    size_t                    entries_capacity;
+} wlmtk_container_spatial_index_t;
+
+/**
+ * Optional contiguous copy of the container's visible elements.
+ *
+ * Holds the elements in stacking order (topmost first), along with their
+ * pointer areas in container coordinates. These are kept as separate arrays,
+ * so that hit tests and unions scan linear memory. @ref
+ * wlmtk_container_t::elements remains authoritative: The array is rebuilt
+ * lazily once the container's generation changed. Raising or lowering an
+ * element is hence not more expensive than before.
+ */
+typedef struct {
+    /** Whether the array is enabled. */
+    bool                      enabled;
+    /** Whether the arrays reflect `generation`. */
+    bool                      valid;
+    /** Value of `spatial_index.generation` when the array was built. */
+    uint64_t                  generation;
+
+    /** Number of elements stored. */
+    size_t                    count;
+    /** Allocated size of each of the arrays, in number of elements. */
+    size_t                    capacity;
+    /** The visible elements, topmost first. */
+    wlmtk_element_t           **elements_ptr;
+    /** Leftmost positions of each element's pointer area. */
+    int32_t                   *x1_ptr;
+    /** Topmost positions of each element's pointer area. */
+    int32_t                   *y1_ptr;
+    /** Rightmost positions (exclusive) of each element's pointer area. */
+    int32_t                   *x2_ptr;
+    /** Bottommost positions (exclusive) of each element's pointer area. */
+    int32_t                   *y2_ptr;
+
+    /**
+     * Stride of the elements, if they form a uniform stack, or 0. That is
+     * the case if each element's pointer area starts `stride` pixels after
+     * the preceding one's, and does not extend into the next. As with the
+     * items of a menu. The element at a position is then computed, rather
+     * than searched.
+     */
+    int32_t                   stride;
+    /** Whether the uniform stack is vertical. Otherwise, it's horizontal. */
+    bool                      stride_vertical;
+} wlmtk_container_child_array_t;
+
 /** State of the container. */
 struct _wlmtk_container_t {
     /** Super class of the container. */
@@ -87,6 +175,49 @@ struct _wlmtk_container_t {
     wlmtk_element_t           *left_button_element_ptr;
     /** Stores the element with current keyboard focus. May be NULL. */
     wlmtk_element_t           *keyboard_focus_element_ptr;
+    /**
+     * Cached leaf of the keyboard focus chain: The first element down from
+     * @ref wlmtk_container_t::keyboard_focus_element_ptr that is not a plain
+     * container. Valid while `keyboard_focus_leaf_serial` is current.
+     */
+    wlmtk_element_t           *keyboard_focus_leaf_ptr;
+    /** Focus serial that @ref wlmtk_container_t::keyboard_focus_leaf_ptr
+     * was computed for. */
+    uint64_t                  keyboard_focus_leaf_serial;
+    /**
+     * Whether this container is blurring its keyboard-focussed element. The
+     * element's request to clear focus then ends here, rather than being
+     * propagated up the focus chain and back.
+     */
+    bool                      keyboard_blurring;
+
+    /** Spatial index for pointer focus lookups. Disabled by default. */
+    wlmtk_container_spatial_index_t spatial_index;
+    /**
+     * Value of `spatial_index.generation` when the pointer focus element was
+     * last determined. While unchanged, and if the pointer focus element is
+     * not obstructed, the pointer focus can be kept without a full lookup.
+     */
+    uint64_t                  pointer_focus_generation;
+    /** Whether no element above the pointer focus element overlaps it. */
+    bool                      pointer_focus_unobstructed;
+    /** Contiguous array of elements for hit tests. Disabled by default. */
+    wlmtk_container_child_array_t child_array;
+    /**
+     * Whether the layout is independent of the stacking order. If set,
+     * @ref wlmtk_container_raise_element_to_top re-orders the element without
+     * a layout update, and updates the pointer focus locally.
+     */
+    bool                      order_independent_layout;
+
+    /** Whether a deferred layout update is pending for this container. */
+    bool                      layout_pending;
+    /** Node in the queue of containers pending a deferred layout update. */
+    bs_dllist_node_t          layout_dlnode;
+    /** The list holding `layout_dlnode`: The queue, or a depth bucket. */
+    bs_dllist_t               *layout_list_ptr;
+    /** Depth in the tree, computed by @ref wlmtk_container_flush_layout. */
+    int                       layout_depth;
 };
 
 /**
@@ -173,10 +304,28 @@ void wlmtk_container_remove_element(
     wlmtk_container_t *container_ptr,
     wlmtk_element_t *element_ptr);
 
+/**
+ * Moves `element_ptr` from its parent container into `container_ptr`, atop.
+ *
+ * Same as @ref wlmtk_container_remove_element followed by
+ * @ref wlmtk_container_add_element, but keeps the element's scene nodes: If
+ * both containers are attached to the scene graph, the node is re-parented.
+ * Buffers hence keep their textures.
+ *
+ * @param container_ptr
+ * @param element_ptr         Must have a parent container.
+ */
+void wlmtk_container_move_element(
+    wlmtk_container_t *container_ptr,
+    wlmtk_element_t *element_ptr);
+
 /**
  * Places `element_ptr` at the top (head) of the container.
  *
- * Expects that `container_ptr` is `element_ptr`'s parent container.
+ * Expects that `container_ptr` is `element_ptr`'s parent container. If the
+ * container has @ref wlmtk_container_t::order_independent_layout set, the
+ * spatial index, child array and pointer focus are updated in place, and no
+ * layout update is triggered.
  *
  * @param container_ptr
  * @param element_ptr
@@ -185,6 +334,26 @@ void wlmtk_container_raise_element_to_top(
     wlmtk_container_t *container_ptr,
     wlmtk_element_t *element_ptr);
 
+/**
+ * Moves `element_ptr` to (`x`, `y`), as a pure translation.
+ *
+ * Updates the scene node, the spatial index and the child array in place,
+ * where possible, and invalidates the container's cached extents. Skips the
+ * layout update and the pointer focus update: Pointer focus is determined
+ * again on the next pointer motion. Meant for interactive moves, where that
+ * motion follows right away.
+ *
+ * @param container_ptr       Must be the parent container of `element_ptr`.
+ * @param element_ptr
+ * @param x
+ * @param y
+ */
+void wlmtk_container_translate_element(
+    wlmtk_container_t *container_ptr,
+    wlmtk_element_t *element_ptr,
+    int x,
+    int y);
+
 /**
  * Updates pointer focus of the container.
  *
@@ -225,7 +394,13 @@ void wlmtk_container_pointer_grab_release(
 /**
  * Reports `element_ptr` as having keyboard focus, and registers it as such in
  * this container. Will propagate @ref wlmtk_container_t::super_element to
- * this container's parent as element having keyboard focus.
+ * this container's parent as element having keyboard focus. Propagation
+ * stops at the first ancestor that already has focus on this path, so only
+ * the changed part of the focus chain is blurred and updated.
+ *
+ * Clearing focus (`element_ptr` NULL) while this container is blurring the
+ * focussed element clears it locally only: The blurring caller updates the
+ * chain above.
  *
  * @param container_ptr
  * @param element_ptr
@@ -235,16 +410,79 @@ void wlmtk_container_set_keyboard_focus_element(
     wlmtk_element_t *element_ptr);
 
 /**
- * Updates the layout of the container.
+ * Enables (or disables) the contiguous child array for hit tests.
  *
- * @param container_ptr       Container to update. NULL implies a no-op.
+ * Recommended for containers with many flat, small elements, eg. menu items
+ * or dock tiles. When the spatial index is enabled, it takes precedence.
+ *
+ * @param container_ptr
+ * @param enabled             Whether to enable the array. Disabling will
+ *                            release the resources.
+ */
+void wlmtk_container_set_child_array(
+    wlmtk_container_t *container_ptr,
+    bool enabled);
+
+/**
+ * Enables (or disables) the spatial index for pointer focus lookups.
+ *
+ * Recommended for containers holding many elements, eg. the window layer of
+ * a workspace. Stacking order is respected when multiple elements overlap.
+ * An element changing its pointer area must report the change through
+ * @ref wlmtk_container_update_layout, or through
+ * @ref wlmtk_container_invalidate_spatial_index.
+ *
+ * @param container_ptr
+ * @param cell_size           Edge length of a grid cell, in pixels. A value
+ *                            of 0 disables the index and releases resources.
+ */
+void wlmtk_container_set_spatial_index(
+    wlmtk_container_t *container_ptr,
+    int cell_size);
+
+/**
+ * Marks the spatial index of `container_ptr` to be rebuilt on next lookup.
+ *
+ * @param container_ptr
  */
-static inline void wlmtk_container_update_layout(
+static inline void wlmtk_container_invalidate_spatial_index(
     wlmtk_container_t *container_ptr)
 {
-    container_ptr->vmt.update_layout(container_ptr);
+    container_ptr->spatial_index.dirty = true;
+    ++container_ptr->spatial_index.generation;
 }
 
+/**
+ * Updates the layout of the container.
+ *
+ * If layout updates are deferred (see @ref wlmtk_container_defer_layout),
+ * this only marks the container as pending, and the update will run in the
+ * next @ref wlmtk_container_flush_layout.
+ *
+ * @param container_ptr       Container to update. NULL implies a no-op.
+ */
+void wlmtk_container_update_layout(wlmtk_container_t *container_ptr);
+
+/**
+ * Enables or disables deferred layout updates.
+ *
+ * With deferred updates, @ref wlmtk_container_update_layout only enqueues
+ * the container. Pending containers are laid out once, deepest first, by
+ * @ref wlmtk_container_flush_layout. That is invoked from an idle callback
+ * on `wl_event_loop_ptr`, and should also be called before committing a
+ * frame. Disabling will flush all pending updates.
+ *
+ * @param wl_event_loop_ptr   Event loop for scheduling flushes, or NULL to
+ *                            disable deferred layout updates.
+ */
+void wlmtk_container_defer_layout(struct wl_event_loop *wl_event_loop_ptr);
+
+/**
+ * Runs all pending deferred layout updates. Each pending container is laid
+ * out once, children before their parents.
+ */
+void wlmtk_container_flush_layout(void);
+
 /**
  * Returns the wlroots scene graph tree for this node.
  *
@@ -257,6 +495,21 @@ static inline void wlmtk_container_update_layout(
 struct wlr_scene_tree *wlmtk_container_wlr_scene_tree(
     wlmtk_container_t *container_ptr);
 
+/**
+ * Returns the container of which `element_ptr` is the super element. For
+ * walking the element tree.
+ *
+ * @param element_ptr
+ *
+ * @return Pointer to the container, or NULL if `element_ptr` is not one.
+ */
+static inline wlmtk_container_t *wlmtk_container_from_element(
+    wlmtk_element_t *element_ptr)
+{
+    if (!element_ptr->is_container) return NULL;
+    return BS_CONTAINER_OF(element_ptr, wlmtk_container_t, super_element);
+}
+
 /** Unit tests for the container. */
 extern const bs_test_case_t wlmtk_container_test_cases[];
 
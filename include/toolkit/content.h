@@ -157,6 +157,19 @@ struct _wlmtk_content_t {
     int                       committed_width;
     /** Committed height of the content. See @ref wlmtk_content_commit. */
     int                       committed_height;
+    /** Committed serial of the content. See @ref wlmtk_content_commit. */
+    uint32_t                  committed_serial;
+    /** Whether @ref wlmtk_content_commit was called since setting window. */
+    bool                      has_committed;
+
+    /** Commits that repeated size and serial: Only marked as damaged. */
+    uint64_t                  unchanged_commits;
+    /** Commits at an unchanged size, of a new serial or updates pending. */
+    uint64_t                  serial_commits;
+    /** Commits of a new size. */
+    uint64_t                  resized_commits;
+    /** Whether the committed content is fully opaque. */
+    bool                      opaque;
 
     /** Set of registered popup contents. See @ref wlmtk_content_add_popup. */
     bs_dllist_t               popups;
@@ -263,13 +276,28 @@ void wlmtk_content_get_size(
     int *width_ptr,
     int *height_ptr);
 
-/** Commits size and serial: Calls into @ref wlmtk_window_serial. */
+/**
+ * Commits size and serial: Calls into @ref wlmtk_window_serial.
+ *
+ * A commit repeating the last size and serial, while the window has no
+ * pending updates, only marks the window's thumbnail as stale. That is the
+ * common case of a client redrawing its buffer.
+ */
 void wlmtk_content_commit(
     wlmtk_content_t *content_ptr,
     int width,
     int height,
     uint32_t serial);
 
+/**
+ * Sets whether the content is fully opaque. To be called on commit, by
+ * contents that can tell. Lets windows below get occluded.
+ *
+ * @param content_ptr
+ * @param opaque
+ */
+void wlmtk_content_set_opaque(wlmtk_content_t *content_ptr, bool opaque);
+
 /** Returns the superclass' instance of @ref wlmtk_element_t. */
 wlmtk_element_t *wlmtk_content_element(wlmtk_content_t *content_ptr);
 
@@ -21,6 +21,8 @@
 #define __WLMTK_DOCK_H__
 
 #include <libbase/libbase.h>
+#include <stddef.h>
+#include <wayland-server-core.h>
 #define WLR_USE_UNSTABLE
 #include <wlr/util/edges.h>
 #undef WLR_USE_UNSTABLE
@@ -45,10 +47,31 @@ typedef struct {
     enum wlr_edges            anchor;
 } wlmtk_dock_positioning_t;
 
+/** Argument to @ref wlmtk_dock_events_t::tile_moved. */
+typedef struct {
+    /** The tile that was moved. */
+    wlmtk_tile_t              *tile_ptr;
+    /** Former position of the tile, counted from the front of the box. */
+    size_t                    from;
+    /** New position of the tile, counted from the front of the box. */
+    size_t                    to;
+} wlmtk_dock_tile_moved_event_t;
+
+/** Signals available for the @ref wlmtk_dock_t class. */
+typedef struct {
+    /**
+     * Signal: Raised when a tile was dragged to a new position.
+     * Data: Pointer to @ref wlmtk_dock_tile_moved_event_t.
+     */
+    struct wl_signal          tile_moved;
+} wlmtk_dock_events_t;
+
 /**
  * Creates a dock. A dock contains icons, launchers and the likes.
  *
- * The dock is an implementation of a @ref wlmtk_panel_t.
+ * The dock is an implementation of a @ref wlmtk_panel_t. Tiles can be
+ * re-ordered by dragging them with the left button, which raises
+ * @ref wlmtk_dock_events_t::tile_moved.
  *
  * @param dock_positioning_ptr
  * @param style_ptr
@@ -87,6 +110,15 @@ void wlmtk_dock_remove_tile(
     wlmtk_dock_t *dock_ptr,
     wlmtk_tile_t *tile_ptr);
 
+/**
+ * Gets the set of events available in the dock. To bind listeners to.
+ *
+ * @param dock_ptr
+ *
+ * @return Pointer to @ref wlmtk_dock_t::events.
+ */
+wlmtk_dock_events_t *wlmtk_dock_events(wlmtk_dock_t *dock_ptr);
+
 /** @return Pointer to the superclass @ref wlmtk_panel_t of `dock_ptr`. */
 wlmtk_panel_t *wlmtk_dock_panel(wlmtk_dock_t *dock_ptr);
 
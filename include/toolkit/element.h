@@ -171,6 +171,40 @@ struct _wlmtk_element_vmt_t {
         uint32_t modifiers);
 };
 
+/** Cached extents of an element, relative to the element's position. */
+typedef struct {
+    /** Leftmost position. */
+    int                       left;
+    /** Topmost position. */
+    int                       top;
+    /** Rightmost position. */
+    int                       right;
+    /** Bottommost position. */
+    int                       bottom;
+    /** Whether the values above are current. */
+    bool                      valid;
+} wlmtk_element_extents_cache_t;
+
+/**
+ * Type tag of an element, for the leaf types that dominate the tree.
+ *
+ * Tagged elements have dimensions (0, 0, leaf_width, leaf_height), which
+ * @ref wlmtk_element_get_dimensions reads inline, without dispatching
+ * through the vmt. For buffers and rectangles, the pointer area is the same.
+ * @ref wlmtk_element_extend resets the tag to @ref WLMTK_ELEMENT_GENERIC
+ * when one of these methods is overridden.
+ */
+typedef enum {
+    /** Not tagged: Dispatches through the vmt. */
+    WLMTK_ELEMENT_GENERIC = 0,
+    /** A @ref wlmtk_buffer_t. */
+    WLMTK_ELEMENT_BUFFER,
+    /** A @ref wlmtk_rectangle_t. */
+    WLMTK_ELEMENT_RECTANGLE,
+    /** A @ref wlmtk_surface_t. The pointer area includes subsurfaces. */
+    WLMTK_ELEMENT_SURFACE
+} wlmtk_element_type_t;
+
 /** State of an element. */
 struct _wlmtk_element_t {
     /**
@@ -190,11 +224,24 @@ struct _wlmtk_element_t {
 
     /** The container this element belongs to, if any. */
     wlmtk_container_t         *parent_container_ptr;
+    /** Whether this is the super element of a @ref wlmtk_container_t. */
+    bool                      is_container;
     /** The node of elements. */
     bs_dllist_node_t          dlnode;
 
     /** Virtual method table for the element. */
     wlmtk_element_vmt_t       vmt;
+    /** Type tag. Set by the leaf implementation, after extending the vmt. */
+    wlmtk_element_type_t      type;
+    /** Width of a tagged element. Maintained by the leaf implementation. */
+    int                       leaf_width;
+    /** Height of a tagged element. Maintained by the leaf implementation. */
+    int                       leaf_height;
+    /**
+     * Number of times the element's contents were replaced. Maintained by
+     * @ref wlmtk_buffer_t, for the debug overlay. 0 for other elements.
+     */
+    uint64_t                  redraws;
     /** Events available from the element. */
     wlmtk_element_events_t    events;
 
@@ -203,6 +250,13 @@ struct _wlmtk_element_t {
 
     /** Whether the element is visible (drawn, when part of a scene graph). */
     bool                      visible;
+    /** Whether the element is occluded. Not drawn, but remains visible. */
+    bool                      occluded;
+    /**
+     * Whether the element is skipped in pointer traversal. It neither gets
+     * pointer focus, nor adds to the parent's pointer area.
+     */
+    bool                      input_transparent;
 
     /** Listener for the `destroy` signal of `wlr_scene_node_ptr`. */
     struct wl_listener        wlr_scene_node_destroy_listener;
@@ -212,6 +266,22 @@ struct _wlmtk_element_t {
 
     /** Whether the pointer is currently within the element's bounds. */
     bool                      pointer_inside;
+
+    /**
+     * Cached result of @ref wlmtk_element_vmt_t::get_dimensions. Only
+     * maintained by implementations that opt in (eg. @ref wlmtk_container_t),
+     * and cleared by @ref wlmtk_element_invalidate_extents.
+     */
+    wlmtk_element_extents_cache_t dimensions_cache;
+    /** Cached result of @ref wlmtk_element_vmt_t::get_pointer_area. */
+    wlmtk_element_extents_cache_t pointer_area_cache;
+    /**
+     * Incremented when the element's extents or visibility change, by
+     * @ref wlmtk_element_invalidate_extents and
+     * @ref wlmtk_element_set_visible. Lets a container tell which of its
+     * elements changed since its last layout.
+     */
+    uint64_t                  extents_serial;
 };
 
 /**
@@ -294,6 +364,29 @@ void wlmtk_element_attach_to_scene_graph(
  */
 void wlmtk_element_set_visible(wlmtk_element_t *element_ptr, bool visible);
 
+/**
+ * Sets whether the element is occluded, eg. when covered by a fullscreen
+ * window. An occluded element is not drawn, but keeps it's visibility for
+ * layout purposes. This lets the scene output skip it entirely.
+ *
+ * @param element_ptr
+ * @param occluded
+ */
+void wlmtk_element_set_occluded(wlmtk_element_t *element_ptr, bool occluded);
+
+/**
+ * Sets whether the element is input transparent: For decorative elements
+ * that never accept pointer input. Hit testing skips them entirely, without
+ * calling @ref wlmtk_element_vmt_t::get_pointer_area or
+ * @ref wlmtk_element_vmt_t::pointer_motion.
+ *
+ * @param element_ptr
+ * @param input_transparent
+ */
+void wlmtk_element_set_input_transparent(
+    wlmtk_element_t *element_ptr,
+    bool input_transparent);
+
 /**
  * Returns the position of the element.
  *
@@ -318,6 +411,18 @@ void wlmtk_element_set_position(
     int x,
     int y);
 
+/**
+ * Invalidates cached dimensions and pointer area of the element, and of all
+ * it's parent containers.
+ *
+ * Must be called by elements whose extents change through other means than
+ * @ref wlmtk_element_set_position, @ref wlmtk_element_set_visible or
+ * @ref wlmtk_container_update_layout.
+ *
+ * @param element_ptr
+ */
+void wlmtk_element_invalidate_extents(wlmtk_element_t *element_ptr);
+
 /**
  * Gets the area that the element on which the element accepts pointer events.
  *
@@ -338,6 +443,14 @@ static inline void wlmtk_element_get_pointer_area(
     int *x2_ptr,
     int *y2_ptr)
 {
+    if (WLMTK_ELEMENT_BUFFER == element_ptr->type ||
+        WLMTK_ELEMENT_RECTANGLE == element_ptr->type) {
+        if (NULL != x1_ptr) *x1_ptr = 0;
+        if (NULL != y1_ptr) *y1_ptr = 0;
+        if (NULL != x2_ptr) *x2_ptr = element_ptr->leaf_width;
+        if (NULL != y2_ptr) *y2_ptr = element_ptr->leaf_height;
+        return;
+    }
     element_ptr->vmt.get_pointer_area(
         element_ptr, x1_ptr, y1_ptr, x2_ptr, y2_ptr);
 }
@@ -358,6 +471,13 @@ static inline void wlmtk_element_get_dimensions(
     int *right_ptr,
     int *bottom_ptr)
 {
+    if (WLMTK_ELEMENT_GENERIC != element_ptr->type) {
+        if (NULL != left_ptr) *left_ptr = 0;
+        if (NULL != top_ptr) *top_ptr = 0;
+        if (NULL != right_ptr) *right_ptr = element_ptr->leaf_width;
+        if (NULL != bottom_ptr) *bottom_ptr = element_ptr->leaf_height;
+        return;
+    }
     element_ptr->vmt.get_dimensions(
         element_ptr, left_ptr, top_ptr, right_ptr, bottom_ptr);
 }
@@ -374,7 +494,7 @@ static inline struct wlr_box wlmtk_element_get_dimensions_box(
     wlmtk_element_t *element_ptr)
 {
     struct wlr_box box;
-    element_ptr->vmt.get_dimensions(
+    wlmtk_element_get_dimensions(
         element_ptr, &box.x, &box.y, &box.width, &box.height);
     box.width += box.x;
     box.height += box.y;
@@ -24,6 +24,7 @@
 #include <libbase/libbase.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 struct _wlmtk_fsm_t;
 
@@ -46,12 +47,49 @@ typedef struct {
     bool                      (*handler)(wlmtk_fsm_t *fsm_ptr, void *ud_ptr);
 } wlmtk_fsm_transition_t;
 
+/** Number of states covered by the compiled lookup table. */
+#define WLMTK_FSM_TABLE_STATES 16
+/** Number of events covered by the compiled lookup table. */
+#define WLMTK_FSM_TABLE_EVENTS 16
+
+/**
+ * Lookup table, compiled from a transitions array on first use. Meant as
+ * `static` next to the transitions, and shared by all state machines using
+ * them. See @ref WLMTK_FSM_TABLE_INITIALIZER.
+ */
+typedef struct {
+    /** The transitions to compile. */
+    const wlmtk_fsm_transition_t *transitions;
+    /** Whether compilation was attempted. */
+    bool                      initialized;
+    /**
+     * Whether `table` covers all of `transitions`. If not, (eg. states or
+     * events spanning a range beyond the table's bounds),
+     * @ref wlmtk_fsm_event falls back to searching `transitions`.
+     */
+    bool                      compiled;
+    /** Smallest state in `transitions`. Row 0 of `table`. */
+    int                       state_base;
+    /** Smallest event in `transitions`. Column 0 of `table`. */
+    int                       event_base;
+    /** Holds the index into `transitions` plus 1, or 0 if there's none. */
+    uint8_t                   table[WLMTK_FSM_TABLE_STATES][
+        WLMTK_FSM_TABLE_EVENTS];
+} wlmtk_fsm_table_t;
+
+/** Initializer for a @ref wlmtk_fsm_table_t of `_transitions`. */
+#define WLMTK_FSM_TABLE_INITIALIZER(_transitions) {     \
+        .transitions = (_transitions),                  \
+    }
+
 /** Finite state machine. State. */
 struct _wlmtk_fsm_t {
     /** The transitions table. */
     const wlmtk_fsm_transition_t *transitions;
     /** Current state. */
     int                       state;
+    /** Compiled lookup table, shared. NULL to search `transitions`. */
+    const wlmtk_fsm_table_t   *table_ptr;
 };
 
 /** Sentinel element for state transition table. */
@@ -74,10 +112,27 @@ void wlmtk_fsm_init(
     const wlmtk_fsm_transition_t *transitions,
     int initial_state);
 
+/**
+ * Initializes the finite-state machine, with a compiled lookup table.
+ *
+ * Compiles `table_ptr` on first use, so that @ref wlmtk_fsm_event does not
+ * need to search. As with the search, the first of several transitions for
+ * the same (state, event) takes precedence.
+ *
+ * @param fsm_ptr
+ * @param table_ptr           Shared among state machines, and must outlive
+ *                            them.
+ * @param initial_state
+ */
+void wlmtk_fsm_init_table(
+    wlmtk_fsm_t *fsm_ptr,
+    wlmtk_fsm_table_t *table_ptr,
+    int initial_state);
+
 /**
  * Handles an event for the finite-state machine.
  *
- * Will search for the transition matching (current state, event) and call the
+ * Will look up the transition matching (current state, event) and call the
  * associate handler.
  *
  * @param fsm_ptr
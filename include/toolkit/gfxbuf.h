@@ -22,10 +22,13 @@
 
 #include <cairo.h>
 #include <libbase/libbase.h>
+#include <stddef.h>
 #define WLR_USE_UNSTABLE
 #include <wlr/types/wlr_buffer.h>
 #undef WLR_USE_UNSTABLE
 
+#include "memstat.h"
+
 struct wlr_buffer;
 
 #ifdef __cplusplus
@@ -36,6 +39,8 @@ extern "C" {
  * Creates a wlroots buffer tied to a libbase graphics buffer.
  *
  * This creates a libbase graphics buffer, and wraps it as `struct wlr_buffer`.
+ * The pixel storage is taken from a pool, and returned to it once the buffer
+ * is destroyed. Pixels are cleared.
  *
  * @param width
  * @param height
@@ -46,6 +51,66 @@ struct wlr_buffer *bs_gfxbuf_create_wlr_buffer(
     unsigned width,
     unsigned height);
 
+/**
+ * Like @ref bs_gfxbuf_create_wlr_buffer, but does not clear re-used pixel
+ * storage. For callers that overwrite all pixels.
+ *
+ * @param width
+ * @param height
+ *
+ * @return A struct wlr_buffer. Must be released using wlr_buffer_drop().
+ */
+struct wlr_buffer *bs_gfxbuf_create_wlr_buffer_uncleared(
+    unsigned width,
+    unsigned height);
+
+/** Statistics of the pixel storage pool. */
+typedef struct {
+    /** Number of buffers currently in use. */
+    size_t                    in_use_buffers;
+    /** Number of free storages held for re-use. */
+    size_t                    cached_buffers;
+    /** Bytes held by the free storages. */
+    size_t                    cached_bytes;
+    /** Number of buffers created with re-used storage. */
+    size_t                    hits;
+    /** Number of buffers created with newly allocated storage. */
+    size_t                    misses;
+    /** Number of storages freed instead of kept, or trimmed later. */
+    size_t                    trimmed;
+} wlmtk_gfxbuf_pool_stats_t;
+
+/** Default limit of bytes held by free storages in the pool. */
+#define WLMTK_GFXBUF_POOL_MAX_CACHED_BYTES (32 * 1024 * 1024)
+
+/**
+ * Sets the limit of bytes held by free storages in the pool, and trims the
+ * pool to it. The least recently released storages are freed first.
+ *
+ * @param max_cached_bytes
+ */
+void wlmtk_gfxbuf_pool_set_max_cached_bytes(size_t max_cached_bytes);
+
+/** Frees all storages held in the pool. Buffers in use are not affected. */
+void wlmtk_gfxbuf_pool_trim(void);
+
+/**
+ * Frees storages held in the pool, least recently used first, until at most
+ * `100 - percent` percent of its bytes remain.
+ *
+ * @param percent
+ *
+ * @return Number of bytes freed.
+ */
+size_t wlmtk_gfxbuf_pool_evict(unsigned percent);
+
+/**
+ * Retrieves statistics of the pool.
+ *
+ * @param stats_ptr
+ */
+void wlmtk_gfxbuf_pool_get_stats(wlmtk_gfxbuf_pool_stats_t *stats_ptr);
+
 /**
  * Drops a WLR buffer, and sets the pointer to NULL.
  *
@@ -55,6 +120,29 @@ struct wlr_buffer *bs_gfxbuf_create_wlr_buffer(
  */
 void wlr_buffer_drop_nullify(struct wlr_buffer **wlr_buffer_ptr_ptr);
 
+/**
+ * Returns the number of bytes held by the pixels of a WLR buffer, assuming
+ * 32 bits per pixel.
+ *
+ * @param wlr_buffer_ptr      May be NULL.
+ *
+ * @return Number of bytes, or 0 if `wlr_buffer_ptr` is NULL.
+ */
+size_t wlmtk_gfxbuf_wlr_buffer_bytes(const struct wlr_buffer *wlr_buffer_ptr);
+
+/**
+ * Accounts the buffer's pixels to `subsystem`, see @ref wlmtk_memstat_add.
+ * Buffers are accounted as @ref WLMTK_MEMSTAT_UNTAGGED until tagged.
+ *
+ * @param wlr_buffer_ptr      Must be created by
+ *                            @ref bs_gfxbuf_create_wlr_buffer or
+ *                            @ref bs_gfxbuf_create_wlr_buffer_uncleared.
+ * @param subsystem
+ */
+void wlmtk_gfxbuf_set_memstat_subsystem(
+    struct wlr_buffer *wlr_buffer_ptr,
+    wlmtk_memstat_subsystem_t subsystem);
+
 /**
  * Returns the libbase graphics buffer for the `struct wlr_buffer`.
  *
@@ -79,6 +167,9 @@ bs_gfxbuf_t *bs_gfxbuf_from_wlr_buffer(struct wlr_buffer *wlr_buffer_ptr);
  */
 cairo_t *cairo_create_from_wlr_buffer(struct wlr_buffer *wlr_buffer_ptr);
 
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_gfxbuf_test_cases[];
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -21,9 +21,12 @@
 #define __WLMTK_IMAGE_H__
 
 #include <libbase/libbase.h>
+#include <stdbool.h>
 
 #include "element.h"
 
+struct wl_event_loop;
+
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
@@ -55,6 +58,26 @@ wlmtk_image_t *wlmtk_image_create_scaled(
     int width,
     int height);
 
+/**
+ * Creates a toolkit image, scaled and rendered at the given output scale.
+ *
+ * The image is decoded at `width` x `height` times `scale` pixels, and
+ * presented at the logical size. Images of the same file at the same
+ * pixel size share the buffer holding the decoded pixels.
+ *
+ * @param image_path_ptr
+ * @param width               Logical width. 0 for the image's native width.
+ * @param height              Logical height. 0 for the image's native height.
+ * @param scale               Buffer pixels per logical pixel. Must be > 0.
+ *
+ * @return Pointer to the toolkit image or NULL on error.
+ */
+wlmtk_image_t *wlmtk_image_create_scaled_at(
+    const char *image_path_ptr,
+    int width,
+    int height,
+    double scale);
+
 /**
  * Destroys the toolkit image.
  *
@@ -65,6 +88,50 @@ void wlmtk_image_destroy(wlmtk_image_t *image_ptr);
 /** @return the parent @ref wlmtk_element_t of `image_ptr`. */
 wlmtk_element_t *wlmtk_image_element(wlmtk_image_t *image_ptr);
 
+/**
+ * Enables or disables decoding images on decoder threads.
+ *
+ * When enabled, @ref wlmtk_image_create_scaled with a given size returns
+ * right away, showing a transparent placeholder. The decoded image is
+ * swapped in from a callback on `wl_event_loop_ptr` once ready. Disabling
+ * stops the threads, and decodes all outstanding images right away.
+ *
+ * Either way, decoded images are kept in a cache keyed by path, file
+ * modification time and size.
+ *
+ * @param wl_event_loop_ptr   Event loop for completion callbacks, or NULL to
+ *                            decode synchronously.
+ *
+ * @return true on success.
+ */
+bool wlmtk_image_defer_decode(struct wl_event_loop *wl_event_loop_ptr);
+
+/**
+ * Sets the directory for the on-disk cache of decoded images.
+ *
+ * Decoded and scaled images are stored there as ARGB8888 pixels, and get
+ * memory-mapped on the next load. A file is used only if the source file's
+ * modification time and size, and the requested size all match.
+ *
+ * @param dir_ptr             Existing directory, or NULL to disable.
+ *
+ * @return true on success.
+ */
+bool wlmtk_image_set_cache_dir(const char *dir_ptr);
+
+/** Drops all decoded images from the cache. */
+void wlmtk_image_cache_flush(void);
+
+/**
+ * Evicts decoded images from the cache, least recently used first, until at
+ * most `100 - percent` percent of its bytes remain.
+ *
+ * @param percent
+ *
+ * @return Number of bytes freed.
+ */
+size_t wlmtk_image_cache_evict(unsigned percent);
+
 /** Unit test cases. */
 extern const bs_test_case_t wlmtk_image_test_cases[];
 
@@ -24,6 +24,8 @@
 
 struct _wlmtk_button_event_t;
 struct wlr_cursor;
+struct wlr_pointer_axis_event;
+struct wlr_surface;
 struct wlr_xcursor_manager;
 
 #ifdef __cplusplus
@@ -101,12 +103,58 @@ wlmtk_pointer_t *wlmtk_pointer_create(
 void wlmtk_pointer_destroy(wlmtk_pointer_t *pointer_ptr);
 
 /**
- * Sets the cursor for the pointer.
+ * Sets the cursor for the pointer. Does nothing if `cursor` is already set.
+ * The xcursor's animation, if any, is driven by `wlr_cursor`.
  */
 void wlmtk_pointer_set_cursor(
     wlmtk_pointer_t *pointer_ptr,
     wlmtk_pointer_cursor_t cursor);
 
+/**
+ * Sets the cursor for the pointer by its xcursor name, eg. as obtained from
+ * `wlr_cursor_shape_v1_name`. Does nothing if that cursor is already set.
+ *
+ * @param pointer_ptr
+ * @param name_ptr            Name of the cursor in the xcursor theme. Is
+ *                            stored, so it must be a static string.
+ */
+void wlmtk_pointer_set_xcursor(
+    wlmtk_pointer_t *pointer_ptr,
+    const char *name_ptr);
+
+/**
+ * Sets a client-provided surface as cursor image. Use this instead of
+ * `wlr_cursor_set_surface`, so that the next @ref wlmtk_pointer_set_cursor
+ * (or @ref wlmtk_pointer_set_xcursor) restores the xcursor.
+ *
+ * @param pointer_ptr
+ * @param wlr_surface_ptr     The surface, or NULL to hide the cursor.
+ * @param hotspot_x
+ * @param hotspot_y
+ */
+void wlmtk_pointer_set_surface(
+    wlmtk_pointer_t *pointer_ptr,
+    struct wlr_surface *wlr_surface_ptr,
+    int32_t hotspot_x,
+    int32_t hotspot_y);
+
+/**
+ * Returns the number of discrete steps (wheel detents) of the axis event.
+ *
+ * For the toolkit's own elements, which act once per step. Events with
+ * discrete values (`delta_discrete`, in 1/120 of a detent) count as steps
+ * only if they are a whole multiple of a detent: The cursor accumulates the
+ * finer values of high-resolution wheels into these. Events without a
+ * discrete value, eg. from a touchpad, count as one step in the direction of
+ * their `delta`.
+ *
+ * @param wlr_pointer_axis_event_ptr
+ *
+ * @return The number of steps. Negative for scrolling up, resp. left.
+ */
+int wlmtk_pointer_axis_steps(
+    const struct wlr_pointer_axis_event *wlr_pointer_axis_event_ptr);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
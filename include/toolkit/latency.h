@@ -0,0 +1,164 @@
+/* ========================================================================= */
+/**
+ * @file latency.h
+ *
+ * @copyright
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_LATENCY_H__
+#define __WLMTK_LATENCY_H__
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/** Forward declaration: Input latency tracker. */
+typedef struct _wlmtk_latency_t wlmtk_latency_t;
+
+/** Number of histogram buckets, 1ms each. The last one holds the overflow. */
+#define WLMTK_LATENCY_BUCKETS 128
+
+/**
+ * Tracks latency from input events until a frame reflecting them was
+ * committed, respectively presented. Meant to be held by each output.
+ *
+ * Input events are reported through @ref wlmtk_latency_input and apply to
+ * all registered trackers. Only the oldest input that was not yet committed
+ * is considered, so a burst of input is accounted for as one sample.
+ */
+struct _wlmtk_latency_t {
+    /** Name of the tracker, for reporting. Must outlive the tracker. */
+    const char                *name_ptr;
+    /** Node in the list of registered trackers. */
+    bs_dllist_node_t          dlnode;
+
+    /** Whether there is input that was not yet committed. */
+    bool                      has_pending;
+    /** Timestamp of the oldest input that was not yet committed. */
+    uint32_t                  pending_msec;
+    /** Whether there is committed input that was not yet presented. */
+    bool                      has_committed;
+    /** Timestamp of the oldest input of the committed frame. */
+    uint32_t                  committed_msec;
+
+    /** Histogram of input-to-commit latencies. */
+    uint64_t                  commit_histogram[WLMTK_LATENCY_BUCKETS];
+    /** Histogram of input-to-presentation latencies. */
+    uint64_t                  present_histogram[WLMTK_LATENCY_BUCKETS];
+};
+
+/** Latency statistics of a tracker. All latencies in milliseconds. */
+typedef struct {
+    /** Name of the tracker. */
+    const char                *name_ptr;
+    /** Number of input-to-commit samples. */
+    uint64_t                  commit_samples;
+    /** Median input-to-commit latency. */
+    unsigned                  commit_p50_msec;
+    /** 99th percentile input-to-commit latency. */
+    unsigned                  commit_p99_msec;
+    /** Number of input-to-presentation samples. */
+    uint64_t                  present_samples;
+    /** Median input-to-presentation latency. */
+    unsigned                  present_p50_msec;
+    /** 99th percentile input-to-presentation latency. */
+    unsigned                  present_p99_msec;
+} wlmtk_latency_stats_t;
+
+/**
+ * Initializes the tracker and registers it for input events.
+ *
+ * @param latency_ptr
+ * @param name_ptr            Must outlive the tracker.
+ */
+void wlmtk_latency_init(wlmtk_latency_t *latency_ptr, const char *name_ptr);
+
+/**
+ * Unregisters the tracker.
+ *
+ * @param latency_ptr
+ */
+void wlmtk_latency_fini(wlmtk_latency_t *latency_ptr);
+
+/**
+ * Reports an input event to all registered trackers.
+ *
+ * @param time_msec           Timestamp of the input event, as found in the
+ *                            `time_msec` field of the wlroots input events.
+ */
+void wlmtk_latency_input(uint32_t time_msec);
+
+/**
+ * Reports that a frame got committed. Pending input is accounted as
+ * committed with this frame. Committed input that was never presented is
+ * dropped, since that frame did not have any visible change.
+ *
+ * @param latency_ptr
+ * @param now_msec            Current time, same clock as the input events.
+ */
+void wlmtk_latency_committed(wlmtk_latency_t *latency_ptr, uint32_t now_msec);
+
+/**
+ * Reports the presentation feedback of the most recent committed frame.
+ *
+ * @param latency_ptr
+ * @param presented           Whether the frame was presented.
+ * @param when_msec           Time of presentation, same clock as the input.
+ */
+void wlmtk_latency_presented(
+    wlmtk_latency_t *latency_ptr,
+    bool presented,
+    uint32_t when_msec);
+
+/**
+ * Retrieves latency statistics of the tracker.
+ *
+ * @param latency_ptr
+ * @param stats_ptr
+ */
+void wlmtk_latency_get_stats(
+    wlmtk_latency_t *latency_ptr,
+    wlmtk_latency_stats_t *stats_ptr);
+
+/**
+ * Calls `func` for each registered tracker.
+ *
+ * @param func
+ * @param ud_ptr
+ */
+void wlmtk_latency_for_each(
+    void (*func)(wlmtk_latency_t *latency_ptr, void *ud_ptr),
+    void *ud_ptr);
+
+/**
+ * Logs the statistics of all registered trackers.
+ *
+ * @param severity
+ */
+void wlmtk_latency_log_stats(bs_log_severity_t severity);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_latency_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_LATENCY_H__ */
+/* == End of latency.h ===================================================== */
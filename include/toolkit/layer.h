@@ -109,6 +109,43 @@ void wlmtk_layer_reconfigure(wlmtk_layer_t *layer_ptr);
  */
 void wlmtk_layer_output_reconfigure(wlmtk_layer_output_t *layer_output_ptr);
 
+/**
+ * @return The area of the layer output that remains usable after subtracting
+ * the exclusive zones of the visible panels. As of the last call to
+ * @ref wlmtk_layer_output_reconfigure.
+ */
+struct wlr_box wlmtk_layer_output_get_usable_area(
+    wlmtk_layer_output_t *layer_output_ptr);
+
+/** @return Extents and position of the layer output, in the layout. */
+struct wlr_box wlmtk_layer_output_get_extents(
+    wlmtk_layer_output_t *layer_output_ptr);
+
+/**
+ * Sets whether the panels on `wlr_output_ptr` are occluded, eg. by a
+ * fullscreen window. See @ref wlmtk_element_set_occluded.
+ * @param layer_ptr
+ * @param wlr_output_ptr
+ * @param occluded
+ */
+void wlmtk_layer_set_output_occluded(
+    wlmtk_layer_t *layer_ptr,
+    struct wlr_output *wlr_output_ptr,
+    bool occluded);
+
+/**
+ * Calls `func` for each visible panel of the layer.
+ *
+ * @param layer_ptr
+ * @param func                Receives the panel's box, in layout
+ *                            coordinates.
+ * @param ud_ptr
+ */
+void wlmtk_layer_for_each_panel_box(
+    wlmtk_layer_t *layer_ptr,
+    void (*func)(const struct wlr_box *box_ptr, void *ud_ptr),
+    void *ud_ptr);
+
 /**
  * Sets the parent workspace for the layer.
  *
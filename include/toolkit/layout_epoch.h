@@ -0,0 +1,130 @@
+/* ========================================================================= */
+/**
+ * @file layout_epoch.h
+ *
+ * @copyright
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_LAYOUT_EPOCH_H__
+#define __WLMTK_LAYOUT_EPOCH_H__
+
+#include <libbase/libbase.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <wayland-server-core.h>
+
+struct wlr_output;
+struct wlr_output_layout;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Stages of a layout epoch. Subscribers are notified stage by stage, so that
+ * each stage sees the results of the ones before.
+ */
+typedef enum {
+    /** Output-wide state: Root extents, backgrounds, hot corners, locks. */
+    WLMTK_LAYOUT_EPOCH_STAGE_OUTPUTS,
+    /** Panels picking their output, before the layers drop stale ones. */
+    WLMTK_LAYOUT_EPOCH_STAGE_PANELS,
+    /** Layers: Arrange panels per output, and compute the usable area. */
+    WLMTK_LAYOUT_EPOCH_STAGE_LAYERS,
+    /** Workspaces: Re-position windows within the usable area. */
+    WLMTK_LAYOUT_EPOCH_STAGE_WORKSPACES,
+    /** Number of stages. */
+    WLMTK_LAYOUT_EPOCH_STAGE_MAX
+} wlmtk_layout_epoch_stage_t;
+
+/**
+ * What changed in the output layout since the previous epoch.
+ *
+ * Removed outputs may already be destroyed. Their pointers must only be
+ * compared, never dereferenced.
+ */
+typedef struct {
+    /** Counter, incremented with each epoch. */
+    uint64_t                  epoch;
+    /** Outputs that were added to the layout. */
+    struct wlr_output         **added_wlr_output_ptrs;
+    /** Number of elements at `added_wlr_output_ptrs`. */
+    size_t                    added_size;
+    /** Outputs that were removed from the layout. */
+    struct wlr_output         **removed_wlr_output_ptrs;
+    /** Number of elements at `removed_wlr_output_ptrs`. */
+    size_t                    removed_size;
+    /** Outputs that remained, but have a different position or size. */
+    struct wlr_output         **changed_wlr_output_ptrs;
+    /** Number of elements at `changed_wlr_output_ptrs`. */
+    size_t                    changed_size;
+} wlmtk_layout_epoch_diff_t;
+
+/**
+ * Subscribes `listener_ptr` to layout epochs of `wlr_output_layout_ptr`.
+ *
+ * Use this instead of listening to `wlr_output_layout::events::change`.
+ * The notify function receives the `struct wlr_output_layout` as data, and
+ * may query @ref wlmtk_layout_epoch_diff. Disconnect through
+ * @ref wlmtk_util_disconnect_listener.
+ *
+ * @param wlr_output_layout_ptr
+ * @param stage
+ * @param listener_ptr
+ * @param notifier_func
+ */
+void wlmtk_layout_epoch_connect(
+    struct wlr_output_layout *wlr_output_layout_ptr,
+    wlmtk_layout_epoch_stage_t stage,
+    struct wl_listener *listener_ptr,
+    wl_notify_func_t notifier_func);
+
+/**
+ * Returns the diff of the most recent epoch of `wlr_output_layout_ptr`.
+ *
+ * @param wlr_output_layout_ptr
+ *
+ * @return Pointer to the diff, valid until the next epoch. NULL if there are
+ *     no subscribers for `wlr_output_layout_ptr`.
+ */
+const wlmtk_layout_epoch_diff_t *wlmtk_layout_epoch_diff(
+    struct wlr_output_layout *wlr_output_layout_ptr);
+
+/**
+ * Enables or disables deferred layout epochs.
+ *
+ * Without deferral, each `change` of the output layout immediately runs an
+ * epoch. With deferral, changes are collapsed and run as one epoch from an
+ * idle callback on `wl_event_loop_ptr`. Removing an output still runs the
+ * epoch right away: Subscribers may hold on to the output, which is about to
+ * be destroyed. Disabling will flush all pending epochs.
+ *
+ * @param wl_event_loop_ptr   Event loop for scheduling epochs, or NULL to
+ *                            disable deferral.
+ */
+void wlmtk_layout_epoch_defer(struct wl_event_loop *wl_event_loop_ptr);
+
+/** Runs all pending deferred epochs. */
+void wlmtk_layout_epoch_flush(void);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_layout_epoch_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_LAYOUT_EPOCH_H__ */
+/* == End of layout_epoch.h ================================================ */
@@ -0,0 +1,81 @@
+/* ========================================================================= */
+/**
+ * @file log.h
+ *
+ * @copyright
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_LOG_H__
+#define __WLMTK_LOG_H__
+
+#include <libbase/libbase.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Minimum severity that is compiled in: 0 for DEBUG, 1 for INFO, 2 for
+ * WARNING and 3 for ERROR. Set through the `config_LOG_MIN_LEVEL` CMake
+ * option. Applies only to the macros below, not to `bs_log` itself.
+ */
+#if !defined(WLMTK_LOG_MIN_LEVEL)
+#define WLMTK_LOG_MIN_LEVEL 0
+#endif  // !defined(WLMTK_LOG_MIN_LEVEL)
+
+/** Whether @ref WLMTK_LOG_DEBUG and friends are compiled in. */
+#define WLMTK_LOG_DEBUG_ENABLED (0 >= WLMTK_LOG_MIN_LEVEL)
+
+/**
+ * Logs at BS_DEBUG, like `bs_log(BS_DEBUG, ...)`, for use in hot paths.
+ *
+ * If @ref WLMTK_LOG_DEBUG_ENABLED is false, this is a no-op without any
+ * runtime check: The arguments are type-checked, but not evaluated.
+ */
+#define WLMTK_LOG_DEBUG(...)                                            \
+    do {                                                                \
+        if (WLMTK_LOG_DEBUG_ENABLED) bs_log(BS_DEBUG, __VA_ARGS__);     \
+    } while (0)
+
+/**
+ * Logs the first, and then every `_n`-th call of this call site, like
+ * `bs_log(_severity, ...)`. For events that may fire at high frequency,
+ * eg. per frame or per input event. Not thread-safe: Use from the event
+ * loop only.
+ *
+ * The arguments are evaluated only for the calls that get logged.
+ */
+#define WLMTK_LOG_SAMPLED(_severity, _n, ...)                           \
+    do {                                                                \
+        static unsigned _wlmtk_log_calls = 0;                           \
+        if (0 == _wlmtk_log_calls++ % (_n)) {                           \
+            bs_log(_severity, __VA_ARGS__);                             \
+        }                                                               \
+    } while (0)
+
+/** Like @ref WLMTK_LOG_SAMPLED at BS_DEBUG, and compiled out likewise. */
+#define WLMTK_LOG_DEBUG_SAMPLED(_n, ...)                                \
+    do {                                                                \
+        if (WLMTK_LOG_DEBUG_ENABLED) {                                  \
+            WLMTK_LOG_SAMPLED(BS_DEBUG, _n, __VA_ARGS__);               \
+        }                                                               \
+    } while (0)
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_LOG_H__ */
+/* == End of log.h ========================================================= */
@@ -0,0 +1,191 @@
+/* ========================================================================= */
+/**
+ * @file memstat.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_MEMSTAT_H__
+#define __WLMTK_MEMSTAT_H__
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "util.h"
+
+struct wlr_scene_node;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/** Subsystems that memory is accounted to. */
+typedef enum {
+    WLMTK_MEMSTAT_UNTAGGED,
+    WLMTK_MEMSTAT_DECORATIONS,
+    WLMTK_MEMSTAT_MENUS,
+    WLMTK_MEMSTAT_IMAGES,
+    WLMTK_MEMSTAT_TILES,
+    WLMTK_MEMSTAT_ICONS,
+    WLMTK_MEMSTAT_SUBSYSTEMS  // Number of subsystems. Keep last.
+} wlmtk_memstat_subsystem_t;
+
+/** Memory statistics of a subsystem. */
+typedef struct {
+    /** Bytes currently accounted. */
+    size_t                    bytes;
+    /** Largest value of `bytes` seen so far. */
+    size_t                    peak_bytes;
+    /** Number of allocations currently accounted. */
+    size_t                    allocations;
+} wlmtk_memstat_stats_t;
+
+/**
+ * Memory footprint of a toolkit object, eg. of a window through
+ * @ref wlmtk_window_get_footprint. Summed up by walking the object, rather
+ * than accounted on allocation.
+ */
+typedef struct {
+    /** Number of toolkit structs, eg. elements. */
+    size_t                    structs;
+    /** Bytes of the toolkit structs, including the strings they own. */
+    size_t                    struct_bytes;
+    /** Number of scene nodes. */
+    size_t                    scene_nodes;
+    /** Bytes of the scene nodes. */
+    size_t                    scene_node_bytes;
+    /** Number of buffers held, including buffers that are not shown. */
+    size_t                    buffers;
+    /** Bytes of the pixels of these buffers. */
+    size_t                    buffer_bytes;
+    /** Number of buffers held, that may be shared with other objects. */
+    size_t                    shared_buffers;
+    /** Bytes of the pixels of the shared buffers. */
+    size_t                    shared_buffer_bytes;
+} wlmtk_memstat_footprint_t;
+
+/**
+ * Accounts an allocation of `bytes` to the subsystem, and to the client.
+ *
+ * @param subsystem
+ * @param client_ptr          The client causing the allocation, or NULL.
+ * @param bytes
+ */
+void wlmtk_memstat_add(
+    wlmtk_memstat_subsystem_t subsystem,
+    const wlmtk_util_client_t *client_ptr,
+    size_t bytes);
+
+/**
+ * Removes an allocation accounted by @ref wlmtk_memstat_add. Arguments must
+ * match the call to @ref wlmtk_memstat_add.
+ *
+ * @param subsystem
+ * @param client_ptr
+ * @param bytes
+ */
+void wlmtk_memstat_remove(
+    wlmtk_memstat_subsystem_t subsystem,
+    const wlmtk_util_client_t *client_ptr,
+    size_t bytes);
+
+/**
+ * Retrieves statistics of the subsystem.
+ *
+ * @param subsystem
+ * @param stats_ptr
+ */
+void wlmtk_memstat_get_stats(
+    wlmtk_memstat_subsystem_t subsystem,
+    wlmtk_memstat_stats_t *stats_ptr);
+
+/** @return Name of the subsystem, for reporting. */
+const char *wlmtk_memstat_subsystem_name(wlmtk_memstat_subsystem_t subsystem);
+
+/** @return Bytes currently accounted to the client with process ID `pid`. */
+size_t wlmtk_memstat_client_bytes(pid_t pid);
+
+/**
+ * Logs the statistics of all subsystems, and the bytes of each client.
+ *
+ * @param severity
+ */
+void wlmtk_memstat_log_stats(bs_log_severity_t severity);
+
+/**
+ * Adds a toolkit struct of `bytes` to the footprint.
+ *
+ * @param footprint_ptr
+ * @param bytes
+ */
+void wlmtk_memstat_footprint_add_struct(
+    wlmtk_memstat_footprint_t *footprint_ptr,
+    size_t bytes);
+
+/**
+ * Adds a buffer of `bytes` to the footprint. Does nothing for 0 bytes, ie.
+ * for a buffer that is not present.
+ *
+ * @param footprint_ptr
+ * @param bytes               Bytes of the buffer's pixels.
+ * @param shared              Whether the buffer may be shared, eg. from a
+ *                            cache. Then accounted separately.
+ */
+void wlmtk_memstat_footprint_add_buffer(
+    wlmtk_memstat_footprint_t *footprint_ptr,
+    size_t bytes,
+    bool shared);
+
+/**
+ * Adds the scene node and all its descendants to the footprint. Just their
+ * structs: Buffers are accounted by @ref wlmtk_memstat_footprint_add_buffer.
+ *
+ * @param footprint_ptr
+ * @param wlr_scene_node_ptr  May be NULL.
+ * @param skip_wlr_scene_node_ptr A descendant to not add, along with its
+ *                            descendants, or NULL. Eg. the client's surface.
+ */
+void wlmtk_memstat_footprint_add_scene_node(
+    wlmtk_memstat_footprint_t *footprint_ptr,
+    struct wlr_scene_node *wlr_scene_node_ptr,
+    struct wlr_scene_node *skip_wlr_scene_node_ptr);
+
+/** @return Total bytes of the footprint, including shared buffers. */
+size_t wlmtk_memstat_footprint_bytes(
+    const wlmtk_memstat_footprint_t *footprint_ptr);
+
+/**
+ * Logs the footprint.
+ *
+ * @param footprint_ptr
+ * @param severity
+ * @param name_ptr            Name of the object the footprint is of.
+ */
+void wlmtk_memstat_footprint_log(
+    const wlmtk_memstat_footprint_t *footprint_ptr,
+    bs_log_severity_t severity,
+    const char *name_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_memstat_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_MEMSTAT_H__ */
+/* == End of memstat.h ===================================================== */
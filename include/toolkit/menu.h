@@ -25,6 +25,7 @@ typedef struct _wlmtk_menu_t wlmtk_menu_t;
 
 #include <libbase/libbase.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <wayland-server-core.h>
 
 #include "box.h"  // IWYU pragma: keep
@@ -45,6 +46,11 @@ typedef struct  {
     wlmtk_margin_style_t      border;
     /** Item's style. */
     wlmtk_menu_item_style_t   item;
+    /**
+     * Maximum number of items shown at once. Menus with more items scroll,
+     * and park the items not shown. 0 for no limit.
+     */
+    uint64_t                  max_items;
 } wlmtk_menu_style_t;
 
 /** Modes of the menu. */
@@ -129,7 +135,8 @@ void wlmtk_menu_add_item(wlmtk_menu_t *menu_ptr,
                          wlmtk_menu_item_t *menu_item_ptr);
 
 /**
- * Removes a menu item from the menu.
+ * Removes a menu item from the menu. An item that the menu did not show
+ * remains parked, see @ref wlmtk_menu_item_set_parked.
  *
  * @param menu_ptr
  * @param menu_item_ptr
@@ -48,6 +48,12 @@ typedef enum {
 typedef struct {
     /** The menu item was triggered, by a click or key action. */
     struct wl_signal          triggered;
+    /**
+     * The item was highlighted, but has no submenu. Listeners may create
+     * the submenu now, through @ref wlmtk_menu_item_set_submenu, and it
+     * will open right away. Permits constructing submenus on first use.
+     */
+    struct wl_signal          submenu_request;
     /** The menu item is being destroyed. */
     struct wl_signal          destroy;
 } wlmtk_menu_item_events_t;
@@ -155,6 +161,20 @@ bool wlmtk_menu_item_set_highlighted(
     wlmtk_menu_item_t *menu_item_ptr,
     bool highlighted);
 
+/**
+ * Parks the menu item, or unparks it. A parked item releases its buffers,
+ * and does not draw any until unparked. Used for items that a scrolling menu
+ * does not show.
+ *
+ * @param menu_item_ptr
+ * @param parked
+ *
+ * @return false if drawing the item after unparking failed.
+ */
+bool wlmtk_menu_item_set_parked(
+    wlmtk_menu_item_t *menu_item_ptr,
+    bool parked);
+
 /** Returns pointer to @ref wlmtk_menu_item_t::dlnode. */
 bs_dllist_node_t *wlmtk_dlnode_from_menu_item(
     wlmtk_menu_item_t *menu_item_ptr);
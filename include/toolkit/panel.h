@@ -110,6 +110,11 @@ struct _wlmtk_panel_t {
 
     /** Positioning parameters. */
     wlmtk_panel_positioning_t positioning;
+
+    /** Whether `dimensions` holds what was last requested and positioned. */
+    bool                      has_dimensions;
+    /** Position and size the panel was last configured to, by the layer. */
+    struct wlr_box            dimensions;
 };
 
 /**
@@ -0,0 +1,136 @@
+/* ========================================================================= */
+/**
+ * @file placement.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_PLACEMENT_H__
+#define __WLMTK_PLACEMENT_H__
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stddef.h>
+#define WLR_USE_UNSTABLE
+#include <wlr/util/box.h>
+#undef WLR_USE_UNSTABLE
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/** Forward declaration: Placement of new windows. */
+typedef struct _wlmtk_placement_t wlmtk_placement_t;
+
+/** Policies for placing new windows, after Window Maker's. */
+typedef enum {
+    /** Top-most, then left-most free space the window fits into. */
+    WLMTK_PLACEMENT_SMART,
+    /** Diagonally offset from the formerly cascaded window. */
+    WLMTK_PLACEMENT_CASCADE,
+    /** Centered below the pointer. */
+    WLMTK_PLACEMENT_UNDER_POINTER,
+} wlmtk_placement_policy_t;
+
+/**
+ * Creates the placement index: Tracks the boxes of windows ("obstacles")
+ * within an area, and maintains the maximal empty rectangles of that area.
+ *
+ * Adding an obstacle splits the empty rectangles it intersects. Moving or
+ * removing an obstacle invalidates the index, it is rebuilt on the next
+ * placement.
+ *
+ * @return Pointer to the placement index, or NULL on error. Must be
+ *     destroyed by calling @ref wlmtk_placement_destroy.
+ */
+wlmtk_placement_t *wlmtk_placement_create(void);
+
+/**
+ * Destroys the placement index.
+ *
+ * @param placement_ptr
+ */
+void wlmtk_placement_destroy(wlmtk_placement_t *placement_ptr);
+
+/**
+ * Sets the area that windows get placed in. A no-op if unchanged.
+ *
+ * @param placement_ptr
+ * @param area
+ */
+void wlmtk_placement_set_area(
+    wlmtk_placement_t *placement_ptr,
+    struct wlr_box area);
+
+/**
+ * Adds or updates the obstacle for `key_ptr`. A no-op if `box` is unchanged.
+ *
+ * @param placement_ptr
+ * @param key_ptr             Identifies the obstacle, eg. its window.
+ * @param box
+ *
+ * @return false on error.
+ */
+bool wlmtk_placement_update(
+    wlmtk_placement_t *placement_ptr,
+    const void *key_ptr,
+    struct wlr_box box);
+
+/**
+ * Removes the obstacle for `key_ptr`. A no-op if there is none.
+ *
+ * @param placement_ptr
+ * @param key_ptr
+ */
+void wlmtk_placement_remove(
+    wlmtk_placement_t *placement_ptr,
+    const void *key_ptr);
+
+/**
+ * Computes the position for a window of `width` x `height`.
+ *
+ * The window is kept within the area, if it fits. @ref WLMTK_PLACEMENT_SMART
+ * falls back to @ref WLMTK_PLACEMENT_CASCADE if no free space fits it.
+ *
+ * @param placement_ptr
+ * @param policy
+ * @param width
+ * @param height
+ * @param pointer_x           Pointer position, for
+ *                            @ref WLMTK_PLACEMENT_UNDER_POINTER.
+ * @param pointer_y
+ *
+ * @return The box for the window.
+ */
+struct wlr_box wlmtk_placement_place(
+    wlmtk_placement_t *placement_ptr,
+    wlmtk_placement_policy_t policy,
+    int width,
+    int height,
+    int pointer_x,
+    int pointer_y);
+
+/** @return Number of maximal empty rectangles. Rebuilds, if needed. */
+size_t wlmtk_placement_free_rectangles(wlmtk_placement_t *placement_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_placement_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_PLACEMENT_H__ */
+/* == End of placement.h =================================================== */
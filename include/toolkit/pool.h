@@ -0,0 +1,164 @@
+/* ========================================================================= */
+/**
+ * @file pool.h
+ *
+ * @copyright
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_POOL_H__
+#define __WLMTK_POOL_H__
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/** Forward declaration: Pool of fixed-size objects. */
+typedef struct _wlmtk_pool_t wlmtk_pool_t;
+
+/**
+ * A pool for objects of a fixed size.
+ *
+ * Objects are carved out of slabs that each hold a fixed number of objects.
+ * Freed objects are kept for re-use. A slab is returned to the heap once all
+ * of its objects are freed, unless it is the last slab with free space.
+ *
+ * Pools are meant to be defined statically per type, using
+ * @ref WLMTK_POOL_INITIALIZER, and register on first use.
+ */
+struct _wlmtk_pool_t {
+    /** Name of the pool, for reporting. Must outlive the pool. */
+    const char                *name_ptr;
+    /** Size of each object, in bytes. */
+    size_t                    object_size;
+    /** Number of objects per slab. */
+    size_t                    objects_per_slab;
+
+    /** Slabs that have at least one free object. */
+    bs_dllist_t               partial_slabs;
+    /** Slabs where all objects are in use. */
+    bs_dllist_t               full_slabs;
+    /** Node in the list of registered pools. */
+    bs_dllist_node_t          dlnode;
+    /** Whether this pool is registered, ie. `dlnode` is in use. */
+    bool                      registered;
+
+    /** Number of objects currently allocated from this pool. */
+    size_t                    in_use;
+    /** Largest value of `in_use` seen so far. */
+    size_t                    peak_in_use;
+    /** Total number of allocations served from this pool. */
+    size_t                    allocations;
+};
+
+/** Occupancy statistics of a pool. */
+typedef struct {
+    /** Name of the pool. */
+    const char                *name_ptr;
+    /** Size of each object, in bytes. */
+    size_t                    object_size;
+    /** Number of slabs currently held. */
+    size_t                    slabs;
+    /** Number of objects that fit into the slabs currently held. */
+    size_t                    capacity;
+    /** Number of objects currently allocated. */
+    size_t                    in_use;
+    /** Largest number of objects allocated at the same time. */
+    size_t                    peak_in_use;
+    /** Total number of allocations served. */
+    size_t                    allocations;
+} wlmtk_pool_stats_t;
+
+/** Default number of objects per slab. */
+#define WLMTK_POOL_OBJECTS_PER_SLAB 16
+
+/**
+ * Static initializer for a @ref wlmtk_pool_t holding objects of `_type`.
+ *
+ * @param _name               Name of the pool, a string literal.
+ * @param _type               Type of the objects held.
+ */
+#define WLMTK_POOL_INITIALIZER(_name, _type) {                          \
+        .name_ptr = (_name),                                            \
+        .object_size = sizeof(_type),                                   \
+        .objects_per_slab = WLMTK_POOL_OBJECTS_PER_SLAB                 \
+    }
+
+/**
+ * Allocates one zero-initialized object from the pool.
+ *
+ * @param pool_ptr
+ *
+ * @return Pointer to the object, or NULL on error. Must be released by
+ *     @ref wlmtk_pool_free using the same `pool_ptr`.
+ */
+void *wlmtk_pool_alloc(wlmtk_pool_t *pool_ptr);
+
+/**
+ * Returns an object to the pool.
+ *
+ * @param pool_ptr
+ * @param object_ptr          Object obtained by @ref wlmtk_pool_alloc from
+ *                            `pool_ptr`. May be NULL.
+ */
+void wlmtk_pool_free(wlmtk_pool_t *pool_ptr, void *object_ptr);
+
+/**
+ * Releases all slabs of the pool and unregisters it. Expects that all
+ * objects of the pool were freed.
+ *
+ * @param pool_ptr
+ */
+void wlmtk_pool_fini(wlmtk_pool_t *pool_ptr);
+
+/**
+ * Retrieves occupancy statistics of the pool.
+ *
+ * @param pool_ptr
+ * @param stats_ptr
+ */
+void wlmtk_pool_get_stats(
+    wlmtk_pool_t *pool_ptr,
+    wlmtk_pool_stats_t *stats_ptr);
+
+/**
+ * Calls `func` with the statistics of each registered pool.
+ *
+ * @param func
+ * @param ud_ptr
+ */
+void wlmtk_pool_for_each_stats(
+    void (*func)(const wlmtk_pool_stats_t *stats_ptr, void *ud_ptr),
+    void *ud_ptr);
+
+/**
+ * Logs statistics of all registered pools.
+ *
+ * @param severity
+ */
+void wlmtk_pool_log_stats(bs_log_severity_t severity);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_pool_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_POOL_H__ */
+/* == End of pool.h ======================================================== */
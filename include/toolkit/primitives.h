@@ -59,6 +59,49 @@ void wlmaker_primitives_cairo_fill_at(
     unsigned height,
     const wlmtk_style_fill_t *fill_ptr);
 
+/**
+ * Completely fills the graphics buffer with the specified style, replacing
+ * its contents.
+ *
+ * Opaque solid fills and horizontal or vertical gradients are written
+ * directly into the buffer, with the same rounding as cairo. Other fills are
+ * drawn using cairo.
+ *
+ * @param gfxbuf_ptr
+ * @param fill_ptr
+ *
+ * @return true on success.
+ */
+bool wlmaker_primitives_gfxbuf_fill(
+    bs_gfxbuf_t *gfxbuf_ptr,
+    const wlmtk_style_fill_t *fill_ptr);
+
+/**
+ * Acquires a buffer of `width` x `height`, filled with the specified style.
+ *
+ * Buffers are shared across all callers requesting the same fill and
+ * dimensions, and must not be modified. They are filled using
+ * @ref wlmaker_primitives_gfxbuf_fill.
+ *
+ * @param fill_ptr
+ * @param width
+ * @param height
+ *
+ * @return Pointer to the buffer, or NULL on error. Must be released by
+ *     calling @ref wlmaker_primitives_fill_gfxbuf_release.
+ */
+bs_gfxbuf_t *wlmaker_primitives_fill_gfxbuf_acquire(
+    const wlmtk_style_fill_t *fill_ptr,
+    unsigned width,
+    unsigned height);
+
+/**
+ * Releases a buffer acquired by @ref wlmaker_primitives_fill_gfxbuf_acquire.
+ *
+ * @param gfxbuf_ptr
+ */
+void wlmaker_primitives_fill_gfxbuf_release(bs_gfxbuf_t *gfxbuf_ptr);
+
 /**
  * Sets the bezel color.
  *
@@ -109,6 +152,45 @@ void wlmaker_primitives_draw_bezel_at(
     double bezel_width,
     bool raised);
 
+/**
+ * Draws a bezel into the graphics buffer, at specified position and
+ * width/height. Looks the same as @ref wlmaker_primitives_draw_bezel_at.
+ *
+ * The bezel's coverage is rasterized once per `bezel_width`, for the corners
+ * and a cross-section of the edges. Drawing blends only the edge pixels.
+ * Falls back to cairo if the rectangle is smaller than two corners, or does
+ * not fit into the buffer.
+ *
+ * @param gfxbuf_ptr
+ * @param x
+ * @param y
+ * @param width
+ * @param height
+ * @param bezel_width
+ * @param raised              Whether the bezel is to highlight a raised (true)
+ *                            or pressed (false) state.
+ *
+ * @return true on success.
+ */
+bool wlmaker_primitives_gfxbuf_draw_bezel_at(
+    bs_gfxbuf_t *gfxbuf_ptr,
+    int x,
+    int y,
+    unsigned width,
+    unsigned height,
+    double bezel_width,
+    bool raised);
+
+/**
+ * Evicts cached bezel templates, least recently used first, until at most
+ * `100 - percent` percent of them remain. Covered by @ref wlmtk_cache_evict.
+ *
+ * @param percent
+ *
+ * @return Number of bytes freed.
+ */
+size_t wlmaker_primitives_bezel_cache_evict(unsigned percent);
+
 /**
  * Draws the "minimize" icon, as used in the title bar.
  *
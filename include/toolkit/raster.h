@@ -0,0 +1,124 @@
+/* ========================================================================= */
+/**
+ * @file raster.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_RASTER_H__
+#define __WLMTK_RASTER_H__
+
+#include <cairo.h>
+#include <libbase/libbase.h>
+#include <stdbool.h>
+
+/** Forward declaration: A rasterization job. */
+typedef struct _wlmtk_raster_job_t wlmtk_raster_job_t;
+
+struct wl_event_loop;
+struct wlr_buffer;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Draws the contents of a job. Called on a rasterizer thread, or on the
+ * main thread when rasterizing synchronously.
+ *
+ * Must only use `arg_ptr` and thread-safe functions: Toolkit elements and
+ * the graphics buffer pool are off limits.
+ *
+ * @param cairo_ptr           Cairo for the job's buffer. Pixels are cleared.
+ * @param arg_ptr             The job's argument.
+ *
+ * @return true on success.
+ */
+typedef bool (*wlmtk_raster_draw_t)(cairo_t *cairo_ptr, void *arg_ptr);
+
+/**
+ * Completes a job. Called on the main thread, unless the job was cancelled.
+ *
+ * @param wlr_buffer_ptr      The drawn buffer, or NULL if drawing failed.
+ *                            Owned by the job: Lock it, to keep it beyond
+ *                            the callback.
+ * @param ud_ptr
+ */
+typedef void (*wlmtk_raster_done_t)(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr);
+
+/**
+ * Enables or disables rasterizing on rasterizer threads.
+ *
+ * When enabled, @ref wlmtk_raster_submit returns right away, and the job's
+ * completion is called from `wl_event_loop_ptr` once drawn. Disabling stops
+ * the threads, and draws and completes all outstanding jobs right away.
+ *
+ * @param wl_event_loop_ptr   Event loop for completion callbacks, or NULL to
+ *                            rasterize synchronously.
+ *
+ * @return true on success.
+ */
+bool wlmtk_raster_defer(struct wl_event_loop *wl_event_loop_ptr);
+
+/**
+ * Submits a job: Draws a buffer of `width` x `height` pixels using `draw`,
+ * then calls `done` on the main thread.
+ *
+ * The buffer is allocated right away, on the calling thread, and kept
+ * locked by the job until `done` returned. `done` is called exactly once,
+ * unless the job gets cancelled by @ref wlmtk_raster_cancel before.
+ *
+ * @param width
+ * @param height
+ * @param draw
+ * @param arg_ptr             Argument to `draw`. Must remain valid until
+ *                            the job completes or is cancelled.
+ * @param arg_destroy         Optional: Destroys `arg_ptr`, on the main
+ *                            thread, once the job completed or cancelled.
+ * @param done
+ * @param ud_ptr              Passed to `done`.
+ *
+ * @return A handle to the job, for @ref wlmtk_raster_cancel. NULL if the
+ *     job was completed already: When rasterizing synchronously, or when
+ *     failing to submit it.
+ */
+wlmtk_raster_job_t *wlmtk_raster_submit(
+    unsigned width,
+    unsigned height,
+    wlmtk_raster_draw_t draw,
+    void *arg_ptr,
+    void (*arg_destroy)(void *arg_ptr),
+    wlmtk_raster_done_t done,
+    void *ud_ptr);
+
+/**
+ * Cancels the job: `done` will not be called, and the buffer is dropped.
+ * A job that is being drawn is discarded when finished.
+ *
+ * @param job_ptr             May be NULL. Must not have completed yet.
+ */
+void wlmtk_raster_cancel(wlmtk_raster_job_t *job_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_raster_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_RASTER_H__ */
+/* == End of raster.h ====================================================== */
@@ -25,8 +25,10 @@ typedef struct _wlmtk_resizebar_t wlmtk_resizebar_t;
 
 #include <libbase/libbase.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #include "element.h"
+#include "memstat.h"
 #include "style.h"
 
 #include "window.h"  // IWYU pragma: keep
@@ -66,6 +68,48 @@ bool wlmtk_resizebar_set_width(
     wlmtk_resizebar_t * resizebar_ptr,
     unsigned width);
 
+/**
+ * Sets the scale of the resize bar's textures, eg. the fractional scale of
+ * the output that shows it. Redraws at that scale, keeping the logical size.
+ *
+ * @param resizebar_ptr
+ * @param scale               Buffer pixels per logical pixel. Must be >= 1.
+ *
+ * @return true on success.
+ */
+bool wlmtk_resizebar_set_scale(wlmtk_resizebar_t *resizebar_ptr, double scale);
+
+/**
+ * Hibernates the resize bar: Releases all textures. The width is still
+ * tracked, but not drawn until @ref wlmtk_resizebar_wake.
+ *
+ * @param resizebar_ptr
+ *
+ * @return Number of bytes held by the released textures. The shared
+ *     background is released, but not counted.
+ */
+size_t wlmtk_resizebar_hibernate(wlmtk_resizebar_t *resizebar_ptr);
+
+/**
+ * Adds the resize bar, along with its areas, to the footprint. The
+ * background is added as shared buffer.
+ *
+ * @param resizebar_ptr
+ * @param footprint_ptr
+ */
+void wlmtk_resizebar_add_footprint(
+    wlmtk_resizebar_t *resizebar_ptr,
+    wlmtk_memstat_footprint_t *footprint_ptr);
+
+/**
+ * Wakes the resize bar from hibernation: Redraws all textures.
+ *
+ * @param resizebar_ptr
+ *
+ * @return true on success.
+ */
+bool wlmtk_resizebar_wake(wlmtk_resizebar_t *resizebar_ptr);
+
 /**
  * Returns the super Element of the resizebar.
  *
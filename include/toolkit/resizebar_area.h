@@ -22,12 +22,14 @@
 
 #include <libbase/libbase.h>
 #include <stdbool.h>          // for bool
+#include <stddef.h>           // for size_t
 #include <stdint.h>           // for uint32_t
 
 /** Forward declaration: Element of the resizebar. */
 typedef struct _wlmtk_resizebar_area_t wlmtk_resizebar_area_t ;
 
 #include "element.h"
+#include "memstat.h"
 #include "style.h"
 #include "window.h"
 
@@ -59,9 +61,10 @@ void wlmtk_resizebar_area_destroy(
  * Redraws the element, with updated position and width.
  *
  * @param resizebar_area_ptr
- * @param gfxbuf_ptr
- * @param position
- * @param width
+ * @param gfxbuf_ptr          Resizebar background. In buffer pixels, see
+ *                            @ref wlmtk_resizebar_area_set_scale.
+ * @param position            Logical position within the resizebar.
+ * @param width               Logical width.
  * @param style_ptr
  *
  * @return true on success.
@@ -73,6 +76,39 @@ bool wlmtk_resizebar_area_redraw(
     unsigned width,
     const wlmtk_resizebar_style_t *style_ptr);
 
+/**
+ * Sets the scale for the next @ref wlmtk_resizebar_area_redraw: Buffer
+ * pixels per logical pixel.
+ *
+ * @param resizebar_area_ptr
+ * @param scale               Must be >= 1, for the logical width to be
+ *                            preserved when rounding.
+ */
+void wlmtk_resizebar_area_set_scale(
+    wlmtk_resizebar_area_t *resizebar_area_ptr,
+    double scale);
+
+/**
+ * Releases the area's textures. The area shows nothing, until the next call
+ * to @ref wlmtk_resizebar_area_redraw.
+ *
+ * @param resizebar_area_ptr
+ *
+ * @return Number of bytes held by the released textures.
+ */
+size_t wlmtk_resizebar_area_release_buffers(
+    wlmtk_resizebar_area_t *resizebar_area_ptr);
+
+/**
+ * Adds the area's struct and textures to the footprint.
+ *
+ * @param resizebar_area_ptr
+ * @param footprint_ptr
+ */
+void wlmtk_resizebar_area_add_footprint(
+    wlmtk_resizebar_area_t *resizebar_area_ptr,
+    wlmtk_memstat_footprint_t *footprint_ptr);
+
 /** Returns the button's super_buffer.super_element address. */
 wlmtk_element_t *wlmtk_resizebar_area_element(
     wlmtk_resizebar_area_t *resizebar_area_ptr);
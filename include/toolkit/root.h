@@ -26,15 +26,20 @@ typedef struct _wlmtk_root_t wlmtk_root_t;
 
 #include <libbase/libbase.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include <sys/types.h>
 #include <wayland-server-core.h>
 
 #include "element.h"
 #include "input.h"
 #include "surface.h"  // IWYU pragma: keep
+#include "window.h"  // IWYU pragma: keep
 #include "workspace.h"  // IWYU pragma: keep
 
 struct wlr_output_layout;
+/** Forward declaration: wlr output. */
+struct wlr_output;
 /** Forward declaration: Wlroots scene. */
 struct wlr_scene;
 
@@ -141,17 +146,20 @@ bool wlmtk_root_pointer_axis(
     struct wlr_pointer_axis_event *wlr_pointer_axis_event_ptr);
 
 /**
- * Adds a workspace.
+ * Adds a workspace, at the end. Its index (see
+ * @ref wlmtk_workspace_get_details) will be the number of workspaces.
  *
  * @param root_ptr
  * @param workspace_ptr
+ *
+ * @return true on success.
  */
-void wlmtk_root_add_workspace(
+bool wlmtk_root_add_workspace(
     wlmtk_root_t *root_ptr,
     wlmtk_workspace_t *workspace_ptr);
 
 /**
- * Removes the workspace.
+ * Removes the workspace. Renumbers the workspaces after it.
  *
  * @param root_ptr
  * @param workspace_ptr
@@ -160,6 +168,33 @@ void wlmtk_root_remove_workspace(
     wlmtk_root_t *root_ptr,
     wlmtk_workspace_t *workspace_ptr);
 
+/** @return The number of workspaces. */
+size_t wlmtk_root_get_workspaces_size(wlmtk_root_t *root_ptr);
+
+/**
+ * Returns the workspace at `position`. Constant time.
+ *
+ * @param root_ptr
+ * @param position            Position of the workspace, starting at 0. This
+ *                            is the workspace's index minus 1.
+ *
+ * @return Pointer to the workspace, or NULL if `position` is out of range.
+ */
+wlmtk_workspace_t *wlmtk_root_get_workspace(
+    wlmtk_root_t *root_ptr,
+    size_t position);
+
+/**
+ * Switches to the workspace at `position`. Does nothing if `position` is
+ * out of range.
+ *
+ * @param root_ptr
+ * @param position            See @ref wlmtk_root_get_workspace.
+ */
+void wlmtk_root_switch_to_workspace(
+    wlmtk_root_t *root_ptr,
+    size_t position);
+
 /**
  * Returns a pointer to the currently-active workspace.
  *
@@ -167,6 +202,141 @@ void wlmtk_root_remove_workspace(
  */
 wlmtk_workspace_t *wlmtk_root_get_current_workspace(wlmtk_root_t *root_ptr);
 
+/**
+ * Sets whether workspaces other than the current one are hibernated. See
+ * @ref wlmtk_workspace_hibernate. A workspace gets woken up when switching
+ * to it, and hibernated when switching away.
+ *
+ * @param root_ptr
+ * @param hibernate
+ */
+void wlmtk_root_set_hibernate_inactive_workspaces(
+    wlmtk_root_t *root_ptr,
+    bool hibernate);
+
+/**
+ * Sets whether each output shows a workspace of its own.
+ *
+ * When enabled, the output under the pointer is the active output, and its
+ * workspace is the current workspace. Switching workspaces only changes the
+ * workspace of the active output; if the target was shown on another output,
+ * the two outputs swap. Windows are shown on the output where their center
+ * is.
+ *
+ * @param root_ptr
+ * @param per_output
+ */
+void wlmtk_root_set_per_output_workspaces(
+    wlmtk_root_t *root_ptr,
+    bool per_output);
+
+/** @return Whether each output shows a workspace of its own. */
+bool wlmtk_root_per_output_workspaces(wlmtk_root_t *root_ptr);
+
+/**
+ * Returns whether `workspace_ptr` is shown on `wlr_output_ptr`. Always true,
+ * unless per-output workspaces are enabled.
+ *
+ * @param root_ptr
+ * @param workspace_ptr
+ * @param wlr_output_ptr
+ */
+bool wlmtk_root_workspace_shown_on_output(
+    wlmtk_root_t *root_ptr,
+    wlmtk_workspace_t *workspace_ptr,
+    struct wlr_output *wlr_output_ptr);
+
+/**
+ * Updates occlusion of all shown workspaces. See
+ * @ref wlmtk_workspace_update_occlusion.
+ *
+ * @param root_ptr
+ *
+ * @return Number of windows and layer outputs occluded.
+ */
+size_t wlmtk_root_update_occlusion(wlmtk_root_t *root_ptr);
+
+/**
+ * Pre-warms `workspace_ptr` ahead of a likely switch to it: Wakes it from
+ * hibernation, so that the switch does not have to redraw the textures. The
+ * workspace gets hibernated again with the next switch, unless it is the one
+ * switched to.
+ *
+ * A no-op if inactive workspaces are not hibernated, or for the current
+ * workspace.
+ *
+ * @param root_ptr
+ * @param workspace_ptr       May be NULL.
+ * @param wl_event_loop_ptr   If not NULL, the workspace is woken from an
+ *                            idle callback on this event loop. Otherwise,
+ *                            right away.
+ */
+void wlmtk_root_prewarm_workspace(
+    wlmtk_root_t *root_ptr,
+    wlmtk_workspace_t *workspace_ptr,
+    struct wl_event_loop *wl_event_loop_ptr);
+
+/**
+ * Returns the workspace that @ref wlmtk_root_switch_to_next_workspace would
+ * switch to.
+ *
+ * @param root_ptr
+ *
+ * @return Pointer to the workspace, or NULL if there is no current one.
+ */
+wlmtk_workspace_t *wlmtk_root_get_next_workspace(wlmtk_root_t *root_ptr);
+
+/**
+ * Returns the workspace that @ref wlmtk_root_switch_to_previous_workspace
+ * would switch to.
+ *
+ * @param root_ptr
+ *
+ * @return Pointer to the workspace, or NULL if there is no current one.
+ */
+wlmtk_workspace_t *wlmtk_root_get_previous_workspace(wlmtk_root_t *root_ptr);
+
+/**
+ * Begins swiping between workspaces, eg. for a touchpad gesture.
+ *
+ * While swiping, the current workspace and its neighbour follow the motion
+ * 1:1, side by side. Only their scene nodes are moved: Windows keep their
+ * positions, and nothing is re-laid out. Ignored while locked. Per-output
+ * workspaces do not follow the motion, but get switched at the end.
+ *
+ * @param root_ptr
+ * @param time_msec
+ */
+void wlmtk_root_swipe_begin(wlmtk_root_t *root_ptr, uint32_t time_msec);
+
+/**
+ * Updates the swipe with horizontal motion. Moving left reveals the next
+ * workspace, moving right the previous one.
+ *
+ * @param root_ptr
+ * @param dx                  Motion since the last update.
+ * @param time_msec
+ */
+void wlmtk_root_swipe_update(
+    wlmtk_root_t *root_ptr,
+    double dx,
+    uint32_t time_msec);
+
+/**
+ * Ends the swipe. Switches to the neighbour if the motion, projected ahead
+ * with its velocity, covers more than half the width. The workspaces then
+ * settle at the swipe's speed, through @ref wlmtk_animation_translate.
+ *
+ * @param root_ptr
+ * @param time_msec
+ * @param cancelled           Whether the swipe was cancelled. Then, the
+ *                            workspaces return without switching.
+ */
+void wlmtk_root_swipe_end(
+    wlmtk_root_t *root_ptr,
+    uint32_t time_msec,
+    bool cancelled);
+
 /**
  * Switches to the next workspace.
  *
@@ -227,6 +397,20 @@ bool wlmtk_root_unlock(
 /** @return Whether root is locked. */
 bool wlmtk_root_locked(wlmtk_root_t *root_ptr);
 
+/**
+ * Draws the curtain ahead of locking, or lifts it again.
+ *
+ * Permits to hide the desktop in the same frame a lock is requested, until
+ * the locker has committed surfaces for all outputs. While pre-locked, the
+ * current workspace is hidden and disabled, and input is not passed on. A
+ * subsequent @ref wlmtk_root_lock takes over from the pre-lock.
+ *
+ * @param root_ptr
+ * @param prelocked           Whether to draw the curtain. When lifting, this
+ *                            has no effect if the root got locked meanwhile.
+ */
+void wlmtk_root_prelock(wlmtk_root_t *root_ptr, bool prelocked);
+
 /**
  * Releases the lock reference, but keeps the root locked.
  *
@@ -247,6 +431,65 @@ void wlmtk_root_lock_unreference(
 /** @returns pointer to the root's @ref wlmtk_element_t. (Temporary) */
 wlmtk_element_t *wlmtk_root_element(wlmtk_root_t *root_ptr);
 
+/**
+ * Adds the window to the group of its client's windows. Creates the group,
+ * if it is the client's first mapped window. Windows without a client
+ * process are not grouped.
+ *
+ * Protected method, to be called only from @ref wlmtk_workspace_t, when the
+ * window is mapped.
+ *
+ * @param root_ptr
+ * @param window_ptr
+ */
+void wlmtk_root_add_to_window_group(
+    wlmtk_root_t *root_ptr,
+    wlmtk_window_t *window_ptr);
+
+/**
+ * Removes the window from its group. Destroys the group, once empty.
+ *
+ * Protected method, to be called only from @ref wlmtk_workspace_t, when the
+ * window is unmapped.
+ *
+ * @param root_ptr
+ * @param window_ptr
+ */
+void wlmtk_root_remove_from_window_group(
+    wlmtk_root_t *root_ptr,
+    wlmtk_window_t *window_ptr);
+
+/**
+ * Looks up the group of mapped windows of client `pid`, across all
+ * workspaces. Group-wide operations then take time in the group's size,
+ * not in the number of windows overall.
+ *
+ * @param root_ptr
+ * @param pid
+ *
+ * @return The group, or NULL if the client has no mapped windows. The group
+ *     is destroyed once its last window is unmapped.
+ */
+wlmtk_window_group_t *wlmtk_root_get_window_group(
+    wlmtk_root_t *root_ptr,
+    pid_t pid);
+
+/** @return Number of windows in the group. */
+size_t wlmtk_window_group_size(wlmtk_window_group_t *group_ptr);
+
+/**
+ * Calls `func` for each window of the group. `func` may unmap the window,
+ * but must not map windows of the group.
+ *
+ * @param group_ptr
+ * @param func
+ * @param ud_ptr
+ */
+void wlmtk_window_group_for_each(
+    wlmtk_window_group_t *group_ptr,
+    void (*func)(wlmtk_window_t *window_ptr, void *ud_ptr),
+    void *ud_ptr);
+
 /** Unit test cases. */
 extern const bs_test_case_t wlmtk_root_test_cases[];
 
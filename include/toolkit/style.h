@@ -22,6 +22,8 @@
 
 #include <cairo.h>
 #include <inttypes.h>
+#include <libbase/libbase.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -192,6 +194,36 @@ typedef struct {
 cairo_font_weight_t wlmtk_style_font_weight_cairo_from_wlmtk(
     wlmtk_style_font_weight_t weight);
 
+/**
+ * Interns a style: Returns an immutable copy of `style_ptr`, shared by all
+ * callers that intern a style of identical contents.
+ *
+ * Elements with identical style thus hold the same pointer, and may compare
+ * styles by pointer. Interned styles are reference-counted, and must only be
+ * used from the main thread.
+ *
+ * @param style_ptr
+ * @param size                Size of the style struct, in bytes.
+ *
+ * @return Pointer to the interned style, or NULL on error. Must be released
+ *     by calling @ref wlmtk_style_release.
+ */
+const void *wlmtk_style_intern(const void *style_ptr, size_t size);
+
+/**
+ * Releases a reference to a style returned by @ref wlmtk_style_intern.
+ *
+ * @param interned_ptr
+ */
+void wlmtk_style_release(const void *interned_ptr);
+
+/** Interns the style pointed to by `_style_ptr`. */
+#define WLMTK_STYLE_INTERN(_style_ptr) \
+    wlmtk_style_intern((_style_ptr), sizeof(*(_style_ptr)))
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_style_test_cases[];
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
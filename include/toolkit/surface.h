@@ -126,6 +126,16 @@ void wlmtk_surface_get_size(
     int *width_ptr,
     int *height_ptr);
 
+/**
+ * Returns whether the surface is fully opaque, ie. it's opaque region covers
+ * all of the currently committed buffer.
+ *
+ * @param surface_ptr
+ *
+ * @return true if opaque. false if there's no `wlr_surface`.
+ */
+bool wlmtk_surface_is_opaque(wlmtk_surface_t *surface_ptr);
+
 /**
  * Activates the surface.
  *
@@ -0,0 +1,123 @@
+/* ========================================================================= */
+/**
+ * @file text.h
+ *
+ * @copyright
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_TEXT_H__
+#define __WLMTK_TEXT_H__
+
+#include <cairo.h>
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "style.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/** Statistics of the text cache. */
+typedef struct {
+    /** Number of fonts currently held. */
+    size_t                    fonts;
+    /** Number of shaped runs currently held. */
+    size_t                    runs;
+    /** Number of lookups served from a cached run. */
+    size_t                    hits;
+    /** Number of lookups that required shaping. */
+    size_t                    misses;
+    /** Number of runs evicted to stay within the limits. */
+    size_t                    evictions;
+} wlmtk_text_stats_t;
+
+/** Maximum number of fonts held in the cache. */
+#define WLMTK_TEXT_MAX_FONTS 16
+/** Maximum number of shaped runs held in the cache. */
+#define WLMTK_TEXT_MAX_RUNS 256
+
+/**
+ * Draws `text_ptr` with the font described by `font_style_ptr`.
+ *
+ * The font is resolved once per @ref wlmtk_style_font_t, and the glyphs of
+ * each string are shaped once, then kept in a least-recently-used cache.
+ * Expects `cairo_ptr` to not have a scaling or rotating transformation.
+ * Thread-safe: May be called from rasterizer threads.
+ *
+ * @param cairo_ptr
+ * @param x                   Position of the text's origin (left of the
+ *                            baseline).
+ * @param y
+ * @param font_style_ptr
+ * @param color               As an ARGB 8888 value.
+ * @param text_ptr            UTF-8 string to draw.
+ *
+ * @return true on success.
+ */
+bool wlmtk_text_draw(
+    cairo_t *cairo_ptr,
+    double x,
+    double y,
+    const wlmtk_style_font_t *font_style_ptr,
+    uint32_t color,
+    const char *text_ptr);
+
+/**
+ * Retrieves the extents of `text_ptr`, as it would be drawn by
+ * @ref wlmtk_text_draw. Uses, and populates, the same cache.
+ *
+ * @param font_style_ptr
+ * @param text_ptr
+ * @param extents_ptr
+ *
+ * @return true on success.
+ */
+bool wlmtk_text_extents(
+    const wlmtk_style_font_t *font_style_ptr,
+    const char *text_ptr,
+    cairo_text_extents_t *extents_ptr);
+
+/** Releases all fonts and runs held in the cache. */
+void wlmtk_text_flush(void);
+
+/**
+ * Evicts `percent` of the runs held in the cache, least recently used
+ * first. Fonts are kept.
+ *
+ * @param percent
+ *
+ * @return Estimated number of bytes freed.
+ */
+size_t wlmtk_text_evict(unsigned percent);
+
+/**
+ * Retrieves statistics of the cache.
+ *
+ * @param stats_ptr
+ */
+void wlmtk_text_get_stats(wlmtk_text_stats_t *stats_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_text_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_TEXT_H__ */
+/* == End of text.h ======================================================== */
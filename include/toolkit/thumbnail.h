@@ -0,0 +1,108 @@
+/* ========================================================================= */
+/**
+ * @file thumbnail.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_THUMBNAIL_H__
+#define __WLMTK_THUMBNAIL_H__
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+
+#include "element.h"
+
+/** Forward declaration: A downscaled capture of an element's scene. */
+typedef struct _wlmtk_thumbnail_t wlmtk_thumbnail_t;
+
+struct wlr_allocator;
+struct wlr_buffer;
+struct wlr_renderer;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Sets the renderer and allocator for capturing thumbnails. Without, no
+ * thumbnails are captured.
+ *
+ * @param wlr_renderer_ptr
+ * @param wlr_allocator_ptr   Must outlive all thumbnails captured with it.
+ */
+void wlmtk_thumbnail_set_renderer(
+    struct wlr_renderer *wlr_renderer_ptr,
+    struct wlr_allocator *wlr_allocator_ptr);
+
+/**
+ * Creates a thumbnail of `element_ptr`. Nothing is captured until
+ * @ref wlmtk_thumbnail_capture.
+ *
+ * @param element_ptr         Must outlive the thumbnail.
+ * @param max_width           Maximum width of the capture.
+ * @param max_height          Maximum height of the capture.
+ *
+ * @return Pointer to the thumbnail, or NULL on error.
+ */
+wlmtk_thumbnail_t *wlmtk_thumbnail_create(
+    wlmtk_element_t *element_ptr,
+    int max_width,
+    int max_height);
+
+/** Destroys the thumbnail. Drops the captured buffer. */
+void wlmtk_thumbnail_destroy(wlmtk_thumbnail_t *thumbnail_ptr);
+
+/**
+ * Marks the captured buffer as stale, eg. when the element's content
+ * committed. The buffer is kept, until the next capture replaces it.
+ *
+ * @param thumbnail_ptr
+ */
+void wlmtk_thumbnail_invalidate(wlmtk_thumbnail_t *thumbnail_ptr);
+
+/**
+ * Captures the element's scene subtree, if the captured buffer is stale.
+ *
+ * Renders all enabled buffers of the element's scene node into a single
+ * buffer, downscaled to fit the maximum dimensions. The capture does not
+ * keep references on the element's buffers.
+ *
+ * @param thumbnail_ptr
+ *
+ * @return true if the thumbnail holds a current capture.
+ */
+bool wlmtk_thumbnail_capture(wlmtk_thumbnail_t *thumbnail_ptr);
+
+/**
+ * Returns the captured buffer. May be stale, see
+ * @ref wlmtk_thumbnail_invalidate.
+ *
+ * @param thumbnail_ptr
+ *
+ * @return The buffer, or NULL if nothing was captured. Remains valid until
+ *     the next capture or destroying the thumbnail; lock it for longer.
+ */
+struct wlr_buffer *wlmtk_thumbnail_buffer(wlmtk_thumbnail_t *thumbnail_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_thumbnail_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_THUMBNAIL_H__ */
+/* == End of thumbnail.h =================================================== */
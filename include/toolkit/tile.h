@@ -49,6 +49,17 @@ typedef struct {
     uint64_t                  bezel_width;
 } wlmtk_tile_style_t;
 
+/** Number of output scales to keep rendered tile backgrounds for. */
+#define WLMTK_TILE_SCALED_BACKGROUNDS 4
+
+/** A tile background, rendered for an output scale. */
+typedef struct {
+    /** The output's scale. 0 if the entry is unused. */
+    double                    scale;
+    /** The background, rendered at `scale`. */
+    struct wlr_buffer         *wlr_buffer_ptr;
+} wlmtk_tile_scaled_background_t;
+
 /** State of a tile. */
 struct _wlmtk_tile_t {
     /** A tile is a container. Holds a background and contents. */
@@ -58,12 +69,24 @@ struct _wlmtk_tile_t {
 
     /** The tile background is modelled as @ref wlmtk_buffer_t. */
     wlmtk_buffer_t            buffer;
+    /** Virtual method table of @ref wlmtk_tile_t::buffer. */
+    wlmtk_buffer_vmt_t        orig_buffer_vmt;
 
     /** Style to be used for this tile. */
     wlmtk_tile_style_t        style;
 
     /** Holds the tile's background, used in @ref wlmtk_tile_t::buffer. */
     struct wlr_buffer         *background_wlr_buffer_ptr;
+    /** Whether the background is from @ref wlmtk_tile_set_background_buffer. */
+    bool                      custom_background;
+    /**
+     * Default backgrounds rendered at other output scales. Kept, so that
+     * moving the tile between outputs does not re-render.
+     */
+    wlmtk_tile_scaled_background_t scaled_backgrounds[
+        WLMTK_TILE_SCALED_BACKGROUNDS];
+    /** Index of the entry in `scaled_backgrounds` to replace next. */
+    size_t                    next_scaled_background;
 
     /** References the content element from @ref wlmtk_tile_set_content. */
     wlmtk_element_t           *content_element_ptr;
@@ -22,12 +22,14 @@
 
 #include <libbase/libbase.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 /** Forward declaration: Title bar. */
 typedef struct _wlmtk_titlebar_t wlmtk_titlebar_t;
 
 #include "element.h"
+#include "memstat.h"
 #include "style.h"
 #include "window.h"  // IWYU pragma: keep
 
@@ -110,6 +112,48 @@ void wlmtk_titlebar_set_title(
     wlmtk_titlebar_t *titlebar_ptr,
     const char *title_ptr);
 
+/**
+ * Sets the scale of the titlebar's textures, eg. the fractional scale of the
+ * output that shows it. Redraws at that scale, keeping the logical size.
+ *
+ * @param titlebar_ptr
+ * @param scale               Buffer pixels per logical pixel. Must be >= 1.
+ *
+ * @return true on success.
+ */
+bool wlmtk_titlebar_set_scale(wlmtk_titlebar_t *titlebar_ptr, double scale);
+
+/**
+ * Hibernates the titlebar: Releases all textures. Width, title and
+ * properties are still tracked, but not drawn until @ref wlmtk_titlebar_wake.
+ *
+ * @param titlebar_ptr
+ *
+ * @return Number of bytes held by the released textures. Backgrounds that are
+ *     shared with other titlebars are released, but not counted.
+ */
+size_t wlmtk_titlebar_hibernate(wlmtk_titlebar_t *titlebar_ptr);
+
+/**
+ * Adds the titlebar, along with title and buttons, to the footprint. The
+ * backgrounds are added as shared buffers.
+ *
+ * @param titlebar_ptr
+ * @param footprint_ptr
+ */
+void wlmtk_titlebar_add_footprint(
+    wlmtk_titlebar_t *titlebar_ptr,
+    wlmtk_memstat_footprint_t *footprint_ptr);
+
+/**
+ * Wakes the titlebar from hibernation: Redraws all textures.
+ *
+ * @param titlebar_ptr
+ *
+ * @return true on success.
+ */
+bool wlmtk_titlebar_wake(wlmtk_titlebar_t *titlebar_ptr);
+
 /**
  * Returns the super Element of the titlebar.
  *
@@ -23,9 +23,11 @@
 #include <cairo.h>
 #include <libbase/libbase.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "element.h"
+#include "memstat.h"
 #include "style.h"
 #include "window.h"
 
@@ -72,13 +74,45 @@ void wlmtk_titlebar_button_set_activated(
     wlmtk_titlebar_button_t *titlebar_button_ptr,
     bool activated);
 
+/**
+ * Releases the button's textures. The button shows nothing, until the next
+ * call to @ref wlmtk_titlebar_button_redraw.
+ *
+ * @param titlebar_button_ptr
+ *
+ * @return Number of bytes held by the released textures.
+ */
+size_t wlmtk_titlebar_button_release_buffers(
+    wlmtk_titlebar_button_t *titlebar_button_ptr);
+
+/**
+ * Adds the button's struct and textures to the footprint.
+ *
+ * @param titlebar_button_ptr
+ * @param footprint_ptr
+ */
+void wlmtk_titlebar_button_add_footprint(
+    wlmtk_titlebar_button_t *titlebar_button_ptr,
+    wlmtk_memstat_footprint_t *footprint_ptr);
+
+/**
+ * Sets the scale for the next @ref wlmtk_titlebar_button_redraw: Buffer
+ * pixels per logical pixel.
+ *
+ * @param titlebar_button_ptr
+ * @param scale               Must be >= 1.
+ */
+void wlmtk_titlebar_button_set_scale(
+    wlmtk_titlebar_button_t *titlebar_button_ptr,
+    double scale);
+
 /**
  * Redraws the titlebar button for given textures, position and style.
  *
  * @param titlebar_button_ptr
- * @param focussed_gfxbuf_ptr
+ * @param focussed_gfxbuf_ptr In buffer pixels, at the button's scale.
  * @param blurred_gfxbuf_ptr
- * @param position
+ * @param position            Logical position within the titlebar.
  * @param style_ptr
  *
  * @return true on success.
@@ -24,9 +24,11 @@
 typedef struct _wlmtk_titlebar_title_t wlmtk_titlebar_title_t;
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <libbase/libbase.h>
 
 #include "element.h"
+#include "memstat.h"
 #include "style.h"
 #include "window.h"
 
@@ -56,7 +58,8 @@ void wlmtk_titlebar_title_destroy(
  * Redraws the title section of the title bar.
  *
  * @param titlebar_title_ptr
- * @param focussed_gfxbuf_ptr Titlebar background when focussed.
+ * @param focussed_gfxbuf_ptr Titlebar background when focussed. In buffer
+ *                            pixels, see @ref wlmtk_titlebar_title_set_scale.
  * @param blurred_gfxbuf_ptr  Titlebar background when blurred.
  * @param position            Position of title telative to titlebar.
  * @param width               Width of title.
@@ -76,6 +79,39 @@ bool wlmtk_titlebar_title_redraw(
     const char *title_ptr,
     const wlmtk_titlebar_style_t *style_ptr);
 
+/**
+ * Releases the title's textures and the rasterized text. The title shows
+ * nothing, until the next call to @ref wlmtk_titlebar_title_redraw.
+ *
+ * @param titlebar_title_ptr
+ *
+ * @return Number of bytes held by the released textures.
+ */
+size_t wlmtk_titlebar_title_release_buffers(
+    wlmtk_titlebar_title_t *titlebar_title_ptr);
+
+/**
+ * Adds the title's struct and textures to the footprint.
+ *
+ * @param titlebar_title_ptr
+ * @param footprint_ptr
+ */
+void wlmtk_titlebar_title_add_footprint(
+    wlmtk_titlebar_title_t *titlebar_title_ptr,
+    wlmtk_memstat_footprint_t *footprint_ptr);
+
+/**
+ * Sets the scale for the next @ref wlmtk_titlebar_title_redraw: Buffer
+ * pixels per logical pixel.
+ *
+ * @param titlebar_title_ptr
+ * @param scale               Must be >= 1, for the logical width to be
+ *                            preserved when rounding.
+ */
+void wlmtk_titlebar_title_set_scale(
+    wlmtk_titlebar_title_t *titlebar_title_ptr,
+    double scale);
+
 /**
  * Sets activation status of the titlebar's title.
  *
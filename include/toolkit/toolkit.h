@@ -23,10 +23,14 @@
 #define __WLMTK_TOOLKIT_H__
 
 // IWYU pragma: begin_exports
+#include "alloctrack.h"
+#include "animation.h"
+#include "arena.h"
 #include "bordered.h"
 #include "box.h"
 #include "buffer.h"
 #include "button.h"
+#include "cache.h"
 #include "container.h"
 #include "content.h"
 #include "dock.h"
@@ -35,13 +39,20 @@
 #include "gfxbuf.h"
 #include "image.h"
 #include "input.h"
+#include "latency.h"
 #include "layer.h"
+#include "layout_epoch.h"
+#include "log.h"
+#include "memstat.h"
 #include "menu.h"
 #include "menu_item.h"
 #include "pane.h"
 #include "panel.h"
+#include "placement.h"
+#include "pool.h"
 #include "popup.h"
 #include "primitives.h"
+#include "raster.h"
 #include "rectangle.h"
 #include "resizebar.h"
 #include "resizebar_area.h"
@@ -49,10 +60,14 @@
 #include "style.h"
 #include "surface.h"
 #include "test.h"
+#include "text.h"
+#include "thumbnail.h"
 #include "tile.h"
 #include "titlebar.h"
 #include "titlebar_button.h"
 #include "titlebar_title.h"
+#include "trace.h"
+#include "transaction.h"
 #include "util.h"
 #include "window.h"
 #include "workspace.h"
@@ -0,0 +1,134 @@
+/* ========================================================================= */
+/**
+ * @file trace.h
+ *
+ * @copyright
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_TRACE_H__
+#define __WLMTK_TRACE_H__
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/** Number of spans each thread's ring holds. Older spans are overwritten. */
+#define WLMTK_TRACE_EVENTS 8192
+
+/** A span, as it is begun. Ended by @ref wlmtk_trace_span_end. */
+typedef struct {
+    /** Name of the span. Must be a literal: Is not escaped on output. */
+    const char                *name_ptr;
+    /** Begin, on CLOCK_MONOTONIC, in nanoseconds. */
+    uint64_t                  begin_nsec;
+} wlmtk_trace_span_t;
+
+/** Spans of one name, aggregated by @ref wlmtk_trace_get_hotspots. */
+typedef struct {
+    /** Name of the spans. */
+    const char                *name_ptr;
+    /** Number of spans. */
+    uint64_t                  count;
+    /** Sum of the spans' durations, in nanoseconds. */
+    uint64_t                  total_nsec;
+    /** Longest of the spans' durations, in nanoseconds. */
+    uint64_t                  max_nsec;
+} wlmtk_trace_hotspot_t;
+
+#if defined(WLMTK_TRACE_DISABLED)
+
+/** Tracing is compiled out: Spans expand to nothing. */
+#define WLMTK_TRACE_SPAN(_name)
+
+#else  // defined(WLMTK_TRACE_DISABLED)
+
+/**
+ * Traces the enclosing scope as a span named `_name`. The span ends when
+ * the scope is left, including through any `return`. Use at most once per
+ * scope.
+ *
+ * Compiled out when `WLMTK_TRACE_DISABLED` is defined.
+ */
+#define WLMTK_TRACE_SPAN(_name)                                         \
+    __attribute__((cleanup(wlmtk_trace_span_end), unused))              \
+    wlmtk_trace_span_t _wlmtk_trace_span = wlmtk_trace_span_begin(_name)
+
+#endif  // defined(WLMTK_TRACE_DISABLED)
+
+/**
+ * Begins a span. Prefer @ref WLMTK_TRACE_SPAN.
+ *
+ * @param name_ptr            Name of the span. Must be a string literal.
+ *
+ * @return The span, to pass to @ref wlmtk_trace_span_end.
+ */
+wlmtk_trace_span_t wlmtk_trace_span_begin(const char *name_ptr);
+
+/**
+ * Ends the span and records it into the calling thread's ring buffer.
+ *
+ * Recording does not take a lock: Each thread writes only into its own
+ * ring. The ring is allocated on the thread's first span; if that fails,
+ * the thread's spans are dropped.
+ *
+ * @param span_ptr
+ */
+void wlmtk_trace_span_end(wlmtk_trace_span_t *span_ptr);
+
+/**
+ * Writes the spans of all threads as JSON in the Chrome trace event format,
+ * to be viewed in chrome://tracing or Perfetto.
+ *
+ * The buffers are not cleared. Spans that get overwritten while writing
+ * are skipped.
+ *
+ * @param file_ptr
+ *
+ * @return true on success.
+ */
+bool wlmtk_trace_write(FILE *file_ptr);
+
+/**
+ * Aggregates the recorded spans of all threads by name, and retrieves the
+ * names that took the longest total time. Spans are grouped by the name's
+ * pointer, which is fine since names are literals.
+ *
+ * @param since_nsec          Only spans that ended at or after this time,
+ *                            on CLOCK_MONOTONIC, are considered.
+ * @param hotspots_ptr        Array of at least `max_hotspots` elements.
+ * @param max_hotspots
+ *
+ * @return Number of hotspots stored at `hotspots_ptr`, by descending
+ *     @ref wlmtk_trace_hotspot_t::total_nsec.
+ */
+size_t wlmtk_trace_get_hotspots(
+    uint64_t since_nsec,
+    wlmtk_trace_hotspot_t *hotspots_ptr,
+    size_t max_hotspots);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_trace_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_TRACE_H__ */
+/* == End of trace.h ======================================================= */
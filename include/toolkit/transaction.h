@@ -0,0 +1,109 @@
+/* ========================================================================= */
+/**
+ * @file transaction.h
+ *
+ * @copyright
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_TRANSACTION_H__
+#define __WLMTK_TRANSACTION_H__
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <wayland-server-core.h>
+
+/** Forward declaration: A transaction of window configures. */
+typedef struct _wlmtk_transaction_t wlmtk_transaction_t;
+
+#include "window.h"  // IWYU pragma: keep
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * How long a committed transaction waits for clients to acknowledge, in
+ * milliseconds. Frames are held meanwhile.
+ */
+#define WLMTK_TRANSACTION_TIMEOUT_MSEC 100
+
+/**
+ * Enables or disables transactions.
+ *
+ * With transactions enabled, changes to several windows can be presented
+ * in the same output frame: Output frames are held while a committed
+ * transaction waits for its windows to commit the requested configures,
+ * up to @ref WLMTK_TRANSACTION_TIMEOUT_MSEC.
+ *
+ * @param wl_event_loop_ptr   The event loop for the timeout. NULL to disable
+ *                            transactions. Disabling completes all pending
+ *                            transactions.
+ */
+void wlmtk_transaction_enable(struct wl_event_loop *wl_event_loop_ptr);
+
+/**
+ * Creates a transaction.
+ *
+ * @return Pointer to the transaction, or NULL if transactions are not enabled
+ *     or on error. Expects a call to @ref wlmtk_transaction_commit, which
+ *     will also free the transaction.
+ */
+wlmtk_transaction_t *wlmtk_transaction_create(void);
+
+/**
+ * Adds `window_ptr` to the transaction. To be called after requesting the
+ * window's new position or size. Windows without pending updates are
+ * ignored, as are windows already in another transaction.
+ *
+ * @param transaction_ptr     May be NULL, then this is a no-op.
+ * @param window_ptr
+ *
+ * @return false on error.
+ */
+bool wlmtk_transaction_add_window(
+    wlmtk_transaction_t *transaction_ptr,
+    wlmtk_window_t *window_ptr);
+
+/**
+ * Commits the transaction: Holds frames until all of its windows have
+ * committed, or the timeout fires. The transaction is free'd then.
+ *
+ * @param transaction_ptr     May be NULL, then this is a no-op.
+ */
+void wlmtk_transaction_commit(wlmtk_transaction_t *transaction_ptr);
+
+/**
+ * Reports that `window_ptr` has no more pending updates, or got destroyed.
+ * Called by @ref wlmtk_window_t.
+ *
+ * @param transaction_ptr
+ * @param window_ptr
+ */
+void wlmtk_transaction_window_done(
+    wlmtk_transaction_t *transaction_ptr,
+    wlmtk_window_t *window_ptr);
+
+/** @return whether output frames are to be held. */
+bool wlmtk_transaction_frames_held(void);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_transaction_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_TRANSACTION_H__ */
+/* == End of transaction.h ================================================= */
@@ -27,10 +27,21 @@
 
 struct wl_list;
 
+#if defined(__x86_64__) || defined(__i386__)
+/** Built for x86: SSE2 and AVX2 kernels are available, if the CPU has them. */
+#define WLMTK_UTIL_SIMD_X86
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+/** Built for AArch64 with NEON: NEON kernels are always available. */
+#define WLMTK_UTIL_SIMD_NEON
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
 
+/** Bytes kept of a client's command line, including the terminating NUL. */
+#define WLMTK_UTIL_CLIENT_CMDLINE_SIZE 128
+
 /** Information regarding a client. Drawn from `struct wl_client`. */
 typedef struct {
     /** Process ID. */
@@ -39,8 +50,25 @@ typedef struct {
     uid_t                     uid;
     /** Group ID. */
     gid_t                     gid;
+    /**
+     * First argument of the process' command line, from `/proc`. Resolved
+     * once, through @ref wlmtk_util_client_resolve. Empty if not known.
+     */
+    char                      cmdline[WLMTK_UTIL_CLIENT_CMDLINE_SIZE];
 } wlmtk_util_client_t;
 
+/**
+ * SIMD instruction sets that kernels may be written for. Ordered by
+ * preference, within each architecture.
+ */
+typedef enum {
+    WLMTK_UTIL_SIMD_NONE,             /*!< Scalar code only. */
+    WLMTK_UTIL_SIMD_SSE2,             /*!< x86 SSE2. */
+    WLMTK_UTIL_SIMD_AVX2,             /*!< x86 AVX2. */
+    WLMTK_UTIL_SIMD_AARCH64_NEON,     /*!< AArch64 NEON. */
+    WLMTK_UTIL_SIMD_MAX               /*!< Number of values. */
+} wlmtk_util_simd_t;
+
 /** Record for recording a signal, suitable for unit testing. */
 typedef struct {
     /** Listener that will get connected to the signal. */
@@ -64,6 +92,29 @@ bool wlmtk_util_wl_list_for_each(
     bool (*func)(struct wl_list *link_ptr, void *ud_ptr),
     void *ud_ptr);
 
+/**
+ * Resolves the process metadata of the client, from `/proc/<pid>`.
+ *
+ * Reads files synchronously, so is meant to be called once, when the client
+ * is created. Users such as the task list then read the cached values.
+ *
+ * @param client_ptr          With @ref wlmtk_util_client_t::pid set. If the
+ *                            PID is 0, or the process is gone, the metadata
+ *                            is left empty.
+ */
+void wlmtk_util_client_resolve(wlmtk_util_client_t *client_ptr);
+
+/**
+ * Returns the name of the client's executable: The basename of the command
+ * line's first argument.
+ *
+ * @param client_ptr
+ *
+ * @return Pointer into @ref wlmtk_util_client_t::cmdline. Empty if not known.
+ */
+const char *wlmtk_util_client_executable(
+    const wlmtk_util_client_t *client_ptr);
+
 /**
  * Sets |notifier_func| as the notifier for |listener_ptr|, and registers it
  * with |signal_ptr|.
@@ -120,6 +171,19 @@ void wlmtk_util_disconnect_test_listener(
 void wlmtk_util_clear_test_listener(
     wlmtk_util_test_listener_t *test_listener_ptr);
 
+/**
+ * Returns whether the CPU supports `simd`, and this build can use it. Shared
+ * by all modules that select kernels at runtime, so they agree.
+ *
+ * @param simd
+ *
+ * @return true for @ref WLMTK_UTIL_SIMD_NONE.
+ */
+bool wlmtk_util_simd_supported(wlmtk_util_simd_t simd);
+
+/** @return The preferred SIMD instruction set that is supported. */
+wlmtk_util_simd_t wlmtk_util_simd_best(void);
+
 /** Unit test cases. */
 extern const bs_test_case_t wlmtk_util_test_cases[];
 
@@ -25,19 +25,33 @@
 #include <stdint.h>
 #include <wayland-server-core.h>
 
+/**
+ * How long a paced request may remain in flight before the next request is
+ * sent regardless, in milliseconds. Three frames at 60 Hz.
+ */
+#define WLMTK_WINDOW_PACED_DEADLINE_MSEC 50
+
 /** Forward declaration: Window. */
 typedef struct _wlmtk_window_t wlmtk_window_t;
+/** Forward declaration: Group of windows, see @ref wlmtk_root_t. */
+typedef struct _wlmtk_window_group_t wlmtk_window_group_t;
 
 #include "content.h"  // IWYU pragma: keep
 #include "element.h"
+#include "memstat.h"
 #include "menu.h"
 #include "style.h"
+#include "transaction.h"  // IWYU pragma: keep
 #include "util.h"
 #include "workspace.h"  // IWYU pragma: keep
 
+struct wlr_buffer;
 struct wlr_output;
 struct wlr_seat;
 
+/** Maximum width and height of a window's thumbnail. */
+#define WLMTK_WINDOW_THUMBNAIL_SIZE 256
+
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
@@ -74,7 +88,9 @@ typedef enum {
      * The window's element must pointer_grab.
      * TODO(kaeser@gubbe.ch): This should be... better.
      */
-    WLMTK_WINDOW_PROPERTY_RIGHTCLICK = UINT32_C(1) << 3
+    WLMTK_WINDOW_PROPERTY_RIGHTCLICK = UINT32_C(1) << 3,
+    /** Not shown in the task list. */
+    WLMTK_WINDOW_PROPERTY_SKIP_TASK_LIST = UINT32_C(1) << 4
 } wlmtk_window_property_t;
 
 /**
@@ -182,6 +198,22 @@ void wlmtk_window_set_server_side_decorated(
     wlmtk_window_t *window_ptr,
     bool decorated);
 
+/**
+ * Updates the window's style.
+ *
+ * Compares `style_ptr` against the window's current style, and only
+ * re-creates the decoration elements whose style changed. The border and
+ * margin are updated in place.
+ *
+ * @param window_ptr
+ * @param style_ptr
+ *
+ * @return true if the style differed and was applied.
+ */
+bool wlmtk_window_set_style(
+    wlmtk_window_t *window_ptr,
+    const wlmtk_window_style_t *style_ptr);
+
 /**
  * Sets the window's properties.
  *
@@ -192,6 +224,9 @@ void wlmtk_window_set_properties(
     wlmtk_window_t *window_ptr,
     uint32_t properties);
 
+/** @return The window's properties. See @ref wlmtk_window_property_t. */
+uint32_t wlmtk_window_get_properties(wlmtk_window_t *window_ptr);
+
 /**
  * Sets the title for the window.
  *
@@ -204,6 +239,20 @@ void wlmtk_window_set_title(
     wlmtk_window_t *window_ptr,
     const char *title_ptr);
 
+/**
+ * Enables or disables deferred title redraws.
+ *
+ * With deferred redraws, @ref wlmtk_window_set_title updates the title right
+ * away, but the titlebar is redrawn by a timer on `wl_event_loop_ptr`: At
+ * most once per frame interval, showing the latest title. Windows that are
+ * not on a workspace are redrawn once back on one. Disabling will redraw all
+ * pending titles.
+ *
+ * @param wl_event_loop_ptr   Event loop for the timer, or NULL to disable
+ *                            deferred title redraws.
+ */
+void wlmtk_window_defer_titles(struct wl_event_loop *wl_event_loop_ptr);
+
 /**
  * Returns the title of the window.
  *
@@ -261,6 +310,82 @@ void wlmtk_window_request_resize(wlmtk_window_t *window_ptr,
  */
 void wlmtk_window_set_position(wlmtk_window_t *window_ptr, int x, int y);
 
+/**
+ * Like @ref wlmtk_window_set_position, but as a pure translation: Does not
+ * update layout, nor pointer focus. For interactive moves, where pointer
+ * focus gets updated with the next motion.
+ *
+ * @see wlmtk_container_translate_element.
+ *
+ * @param window_ptr
+ * @param x
+ * @param y
+ */
+void wlmtk_window_translate(wlmtk_window_t *window_ptr, int x, int y);
+
+/**
+ * Hibernates the window: Releases the textures of title bar and resize bar.
+ * These remain in the layout, but are not drawn until
+ * @ref wlmtk_window_wake. For windows that are not shown, eg. on an inactive
+ * workspace.
+ *
+ * @param window_ptr
+ *
+ * @return Number of bytes held by the released textures.
+ */
+size_t wlmtk_window_hibernate(wlmtk_window_t *window_ptr);
+
+/**
+ * Wakes the window from hibernation: Redraws title bar and resize bar.
+ *
+ * @param window_ptr
+ */
+void wlmtk_window_wake(wlmtk_window_t *window_ptr);
+
+/**
+ * Gets the memory footprint of the window: Its toolkit structs, the scene
+ * nodes and the textures of its decorations. The content's surface, and the
+ * client's buffers, are not included.
+ *
+ * @param window_ptr
+ * @param footprint_ptr       Will be overwritten.
+ */
+void wlmtk_window_get_footprint(
+    wlmtk_window_t *window_ptr,
+    wlmtk_memstat_footprint_t *footprint_ptr);
+
+/**
+ * Returns a thumbnail of the window: Its scene, downscaled to fit
+ * @ref WLMTK_WINDOW_THUMBNAIL_SIZE. Captures, if it was invalidated since
+ * the last capture.
+ *
+ * @param window_ptr
+ *
+ * @return The buffer, or NULL if never captured. It may be stale, if the
+ *     capture failed. Remains valid until the next capture; lock it to keep
+ *     it for longer.
+ */
+struct wlr_buffer *wlmtk_window_thumbnail(wlmtk_window_t *window_ptr);
+
+/**
+ * Marks the window's thumbnail as stale. To be called when the window's
+ * content committed.
+ *
+ * @param window_ptr
+ */
+void wlmtk_window_invalidate_thumbnail(wlmtk_window_t *window_ptr);
+
+/**
+ * Sets the scale that server-side decorations are rendered at. Called when
+ * the titlebar moves to an output of a different (fractional) scale. Scales
+ * below 1 are treated as 1.
+ *
+ * @param window_ptr
+ * @param scale
+ */
+void wlmtk_window_set_decoration_scale(wlmtk_window_t *window_ptr,
+                                       double scale);
+
 /**
  * Obtains the size of the window, including potential decorations.
  *
@@ -410,6 +535,21 @@ wlmtk_menu_t *wlmtk_window_menu(wlmtk_window_t *window_ptr);
 struct wlr_box wlmtk_window_get_position_and_size(
     wlmtk_window_t *window_ptr);
 
+/**
+ * Gets the area that the window covers with opaque content. That is the
+ * content's committed size, without decorations. There is none for windows
+ * that are invisible, shaded, or have content that is not fully opaque.
+ *
+ * @param window_ptr
+ * @param box_ptr             Set to the opaque box, in the window's parent
+ *                            coordinates. Only set when returning true.
+ *
+ * @return true if the window has an opaque area.
+ */
+bool wlmtk_window_get_opaque_box(
+    wlmtk_window_t *window_ptr,
+    struct wlr_box *box_ptr);
+
 /**
  * Requests an updated position and size for the window, including potential
  * decorations.
@@ -432,6 +572,37 @@ void wlmtk_window_request_position_and_size(
     int width,
     int height);
 
+/**
+ * Like @ref wlmtk_window_request_position_and_size, but paced for interactive
+ * resizing: At most one request is in flight. While the client has not yet
+ * committed it, newer requests are coalesced, and sent once the client
+ * catches up (see @ref wlmtk_window_serial), or once the request in flight
+ * is older than @ref WLMTK_WINDOW_PACED_DEADLINE_MSEC.
+ *
+ * @param window_ptr
+ * @param x
+ * @param y
+ * @param width
+ * @param height
+ * @param time_msec           Time of the triggering event, in milliseconds.
+ */
+void wlmtk_window_request_position_and_size_paced(
+    wlmtk_window_t *window_ptr,
+    int x,
+    int y,
+    int width,
+    int height,
+    uint32_t time_msec);
+
+/**
+ * Sends the most recent coalesced request from
+ * @ref wlmtk_window_request_position_and_size_paced, if any. For example when
+ * the interactive resize ends.
+ *
+ * @param window_ptr
+ */
+void wlmtk_window_flush_paced(wlmtk_window_t *window_ptr);
+
 /**
  * Updates the window state to what was requested at the `serial`.
  *
@@ -452,6 +623,33 @@ void wlmtk_window_request_position_and_size(
  */
 void wlmtk_window_serial(wlmtk_window_t *window_ptr, uint32_t serial);
 
+/**
+ * Returns whether the window has positional updates pending a commit.
+ *
+ * @param window_ptr
+ *
+ * @return true if @ref wlmtk_window_serial has updates left to apply.
+ */
+bool wlmtk_window_has_pending_updates(wlmtk_window_t *window_ptr);
+
+/**
+ * Sets the transaction to report to, once the window has no more pending
+ * updates. See @ref wlmtk_transaction_window_done.
+ *
+ * Protected method, to be called only from @ref wlmtk_transaction_t.
+ *
+ * @param window_ptr
+ * @param transaction_ptr     May be NULL, to clear.
+ *
+ * @return false if setting a transaction, but there are no pending updates.
+ */
+bool wlmtk_window_set_transaction(
+    wlmtk_window_t *window_ptr,
+    wlmtk_transaction_t *transaction_ptr);
+
+/** @return the transaction `window_ptr` reports to, or NULL. */
+wlmtk_transaction_t *wlmtk_window_get_transaction(wlmtk_window_t *window_ptr);
+
 /**
  * Sets @ref wlmtk_window_t::workspace_ptr.
  *
@@ -467,6 +665,26 @@ void wlmtk_window_set_workspace(
 /** @return The value of @ref wlmtk_window_t::workspace_ptr. */
 wlmtk_workspace_t *wlmtk_window_get_workspace(wlmtk_window_t *window_ptr);
 
+/**
+ * Sets @ref wlmtk_window_t::group_ptr.
+ *
+ * Protected method, to be called only from @ref wlmtk_root_t.
+ *
+ * @param window_ptr
+ * @param group_ptr
+ */
+void wlmtk_window_set_group(
+    wlmtk_window_t *window_ptr,
+    wlmtk_window_group_t *group_ptr);
+
+/** @return The value of @ref wlmtk_window_t::group_ptr. NULL if none. */
+wlmtk_window_group_t *wlmtk_window_get_group(wlmtk_window_t *window_ptr);
+
+/** Returns @ref wlmtk_window_t for the `dlnode_ptr` of its group. */
+wlmtk_window_t *wlmtk_window_from_group_dlnode(bs_dllist_node_t *dlnode_ptr);
+/** Accessor: Returns pointer to @ref wlmtk_window_t::group_dlnode. */
+bs_dllist_node_t *wlmtk_group_dlnode_from_window(wlmtk_window_t *window_ptr);
+
 /** @return Pointer to @ref wlmtk_content_t::client for `content_ptr`. */
 const wlmtk_util_client_t *wlmtk_window_get_client_ptr(
     wlmtk_window_t *window_ptr);
@@ -30,6 +30,7 @@ typedef struct _wlmtk_workspace_t wlmtk_workspace_t;
 
 #include "element.h"
 #include "layer.h"  // IWYU pragma: keep
+#include "placement.h"
 #include "root.h"  // IWYU pragma: keep
 #include "tile.h"
 #include "window.h"  // IWYU pragma: keep
@@ -55,6 +56,17 @@ typedef enum {
     WLMTK_WORKSPACE_LAYER_OVERLAY = 4,
 } wlmtk_workspace_layer_t;
 
+/** How a window is presented while interactively moved or resized. */
+typedef enum {
+    /** The window moves, resp. the client resizes, along with the pointer. */
+    WLMTK_WORKSPACE_DRAG_OPAQUE,
+    /**
+     * Only an outline follows the pointer. The window gets moved, resp. the
+     * client configured, just once, when the button is released.
+     */
+    WLMTK_WORKSPACE_DRAG_OUTLINE
+} wlmtk_workspace_drag_mode_t;
+
 /**
  * Creates a workspace.
  *
@@ -156,8 +168,30 @@ void wlmtk_workspace_enable(wlmtk_workspace_t *workspace_ptr, bool enabled);
 /** @return whether this workspace is enabled. */
 bool wlmtk_workspace_enabled(wlmtk_workspace_t *workspace_ptr);
 
+/**
+ * Hibernates the workspace: Hibernates all its windows, and all windows
+ * mapped later, until @ref wlmtk_workspace_wake. See
+ * @ref wlmtk_window_hibernate.
+ *
+ * @param workspace_ptr
+ *
+ * @return Number of bytes reclaimed from the windows.
+ */
+size_t wlmtk_workspace_hibernate(wlmtk_workspace_t *workspace_ptr);
+
+/** @return whether this workspace is hibernated. */
+bool wlmtk_workspace_hibernated(wlmtk_workspace_t *workspace_ptr);
+
+/**
+ * Wakes the workspace and all its windows from hibernation.
+ *
+ * @param workspace_ptr
+ */
+void wlmtk_workspace_wake(wlmtk_workspace_t *workspace_ptr);
+
 /**
  * Maps the window: Adds it to the workspace container and makes it visible.
+ * A window parked through @ref wlmtk_workspace_park_window is moved over.
  *
  * @param workspace_ptr
  * @param window_ptr
@@ -174,6 +208,81 @@ void wlmtk_workspace_map_window(wlmtk_workspace_t *workspace_ptr,
 void wlmtk_workspace_unmap_window(wlmtk_workspace_t *workspace_ptr,
                                   wlmtk_window_t *window_ptr);
 
+/**
+ * Unmaps the window, but parks it in `container_ptr` instead of removing it:
+ * The window keeps its scene nodes, and buffers their textures. A later
+ * @ref wlmtk_workspace_map_window moves it from there.
+ *
+ * Suitable for a window such as the root menu, which is opened frequently
+ * and should show without delay.
+ *
+ * @param workspace_ptr
+ * @param window_ptr
+ * @param container_ptr       Container to park in. Should be attached to
+ *                            the scene graph, for keeping the nodes.
+ */
+void wlmtk_workspace_park_window(wlmtk_workspace_t *workspace_ptr,
+                                 wlmtk_window_t *window_ptr,
+                                 wlmtk_container_t *container_ptr);
+
+/**
+ * Begins a transaction of window changes on the workspace.
+ *
+ * Changes enqueued through @ref wlmtk_workspace_enqueue_position_and_size
+ * and @ref wlmtk_workspace_enqueue_move_to_workspace are held until the
+ * outermost @ref wlmtk_workspace_commit_transaction. Then, windows change
+ * workspace without re-activating after each, all configures go out in one
+ * burst, and the (deferred) layout runs just once. Transactions may nest.
+ *
+ * @param workspace_ptr
+ */
+void wlmtk_workspace_begin_transaction(wlmtk_workspace_t *workspace_ptr);
+
+/**
+ * Enqueues a position and size change of `window_ptr`. Applies it right
+ * away, if there is no ongoing transaction. A later change of the same
+ * window replaces the earlier one.
+ *
+ * @param workspace_ptr
+ * @param window_ptr          Must be mapped to `workspace_ptr`.
+ * @param x
+ * @param y
+ * @param width
+ * @param height
+ *
+ * @return true on success.
+ */
+bool wlmtk_workspace_enqueue_position_and_size(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_window_t *window_ptr,
+    int x,
+    int y,
+    int width,
+    int height);
+
+/**
+ * Enqueues moving `window_ptr` to `target_workspace_ptr`. Applies it right
+ * away, if there is no ongoing transaction. Position and size changes of the
+ * same window get applied after the move.
+ *
+ * @param workspace_ptr
+ * @param window_ptr          Must be mapped to `workspace_ptr`.
+ * @param target_workspace_ptr
+ *
+ * @return true on success.
+ */
+bool wlmtk_workspace_enqueue_move_to_workspace(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_window_t *window_ptr,
+    wlmtk_workspace_t *target_workspace_ptr);
+
+/**
+ * Commits the transaction begun by @ref wlmtk_workspace_begin_transaction.
+ *
+ * @param workspace_ptr
+ */
+void wlmtk_workspace_commit_transaction(wlmtk_workspace_t *workspace_ptr);
+
 /**
  * Returns pointer to the @ref wlmtk_layer_t handle serving `layer`.
  *
@@ -213,6 +322,33 @@ void wlmtk_workspace_window_to_fullscreen(
     wlmtk_window_t *window_ptr,
     bool fullscreen);
 
+/**
+ * Returns whether a fullscreen window is shown on `wlr_output_ptr`. A
+ * window is considered on the output that holds the window's center.
+ *
+ * @param workspace_ptr
+ * @param wlr_output_ptr
+ *
+ * @return true if at least one fullscreen window is on that output.
+ */
+bool wlmtk_workspace_has_fullscreen_window(
+    wlmtk_workspace_t *workspace_ptr,
+    struct wlr_output *wlr_output_ptr);
+
+/**
+ * Updates occlusion of the workspace's windows: A window that is fully
+ * covered by the opaque areas of windows above it gets occluded, see
+ * @ref wlmtk_element_set_occluded. Occluded windows are not drawn, and
+ * their clients do not receive frame callbacks.
+ *
+ * To be called before rendering a frame.
+ *
+ * @param workspace_ptr
+ *
+ * @return The number of occluded windows.
+ */
+size_t wlmtk_workspace_update_occlusion(wlmtk_workspace_t *workspace_ptr);
+
 /**
  * Initiates a 'move' for the window.
  *
@@ -235,6 +371,72 @@ void wlmtk_workspace_begin_window_resize(
     wlmtk_window_t *window_ptr,
     uint32_t edges);
 
+/**
+ * Sets how windows are presented during interactive move or resize. Takes
+ * effect at the next move or resize.
+ *
+ * @param workspace_ptr
+ * @param drag_mode
+ */
+void wlmtk_workspace_set_drag_mode(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_workspace_drag_mode_t drag_mode);
+
+/**
+ * Sets the distance at which moved windows snap to the edges of outputs,
+ * layer panels and other windows. Takes effect at the next move.
+ *
+ * @param workspace_ptr
+ * @param distance            In pixels. 0 disables snapping.
+ */
+void wlmtk_workspace_set_snap_distance(
+    wlmtk_workspace_t *workspace_ptr,
+    int distance);
+
+/**
+ * Sets how @ref wlmtk_workspace_place_window places new windows. Defaults to
+ * @ref WLMTK_PLACEMENT_SMART.
+ *
+ * @param workspace_ptr
+ * @param policy
+ */
+void wlmtk_workspace_set_placement_policy(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_placement_policy_t policy);
+
+/**
+ * Positions a newly-mapped window, as per the workspace's placement policy.
+ * Considers the other windows of the workspace, on the output under the
+ * pointer. A no-op for fullscreen or maximized windows.
+ *
+ * @param workspace_ptr
+ * @param window_ptr          Must be mapped to `workspace_ptr`.
+ * @param pointer_x
+ * @param pointer_y
+ */
+void wlmtk_workspace_place_window(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_window_t *window_ptr,
+    int pointer_x,
+    int pointer_y);
+
+/**
+ * Like @ref wlmtk_workspace_place_window, but with `policy` instead of the
+ * workspace's placement policy.
+ *
+ * @param workspace_ptr
+ * @param window_ptr          Must be mapped to `workspace_ptr`.
+ * @param policy
+ * @param pointer_x
+ * @param pointer_y
+ */
+void wlmtk_workspace_place_window_with_policy(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_window_t *window_ptr,
+    wlmtk_placement_policy_t policy,
+    int pointer_x,
+    int pointer_y);
+
 /** Acticates `window_ptr`. Will de-activate an earlier window. */
 void wlmtk_workspace_activate_window(
     wlmtk_workspace_t *workspace_ptr,
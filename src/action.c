@@ -22,10 +22,13 @@
 
 #include <libbase/libbase.h>
 #include <libbase/plist.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 #include <wayland-server-core.h>
 #include <xkbcommon/xkbcommon-keysyms.h>
@@ -42,6 +45,7 @@
 #include "keyboard.h"
 #include "root_menu.h"
 #include "server.h"
+#include "subprocess_monitor.h"
 #include "toolkit/toolkit.h"
 
 /* == Declarations ========================================================= */
@@ -81,11 +85,59 @@ static bool _wlmaker_keybindings_bind_item(
 static bool _wlmaker_action_bound_callback(
     const wlmaker_key_combo_t *binding_ptr);
 
+static void _wlmaker_action_execute(
+    wlmaker_server_t *server_ptr,
+    const char *cmdline_ptr);
+static void _wlmaker_action_handle_terminated(
+    void *userdata_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    int exit_status,
+    int signal_number);
+static FILE *_wlmaker_action_fopen_dump(
+    const char *kind_ptr,
+    const char *extension_ptr,
+    char *path_ptr,
+    size_t path_size);
+static void _wlmaker_action_dump_trace(void);
+static void _wlmaker_action_dump_allocations(void);
+static void _wlmaker_action_cascade(wlmtk_workspace_t *workspace_ptr);
+static void _wlmaker_action_tile(wlmtk_workspace_t *workspace_ptr);
+static bool _wlmaker_action_arrangeable(wlmtk_window_t *window_ptr);
+static void _wlmaker_action_magnify(
+    wlmaker_server_t *server_ptr,
+    double factor);
+static wlmtk_window_group_t *_wlmaker_action_activated_group(
+    wlmaker_server_t *server_ptr);
+static void _wlmaker_action_group_to_workspace(
+    wlmaker_server_t *server_ptr,
+    wlmtk_window_group_t *group_ptr,
+    wlmtk_workspace_t *target_workspace_ptr);
+static void _wlmaker_action_close_window(
+    wlmtk_window_t *window_ptr,
+    void *ud_ptr);
+static void _wlmaker_action_enqueue_move(
+    wlmtk_window_t *window_ptr,
+    void *ud_ptr);
+static void _wlmaker_action_begin_transaction(
+    bs_dllist_node_t *dlnode_ptr,
+    void *ud_ptr);
+static void _wlmaker_action_commit_transaction(
+    bs_dllist_node_t *dlnode_ptr,
+    void *ud_ptr);
+
 /* == Data ================================================================= */
 
 /** Key to lookup the dict from the config dictionary. */
 const char *wlmaker_action_config_dict_key = "KeyBindings";
 
+/** Offset between cascaded windows, in pixels. */
+static const int _wlmaker_action_cascade_step = 32;
+
+/** Factor of each magnifier zoom step. */
+static const double _wlmaker_action_magnify_step = 1.5;
+/** Maximum zoom of the magnifier. */
+static const double _wlmaker_action_magnify_max = 16.0;
+
 /** Supported modifiers for key bindings. */
 static const bspl_enum_desc_t _wlmaker_keybindings_modifiers[] = {
     BSPL_ENUM("Shift", WLR_MODIFIER_SHIFT),
@@ -108,9 +160,30 @@ const bspl_enum_desc_t wlmaker_action_desc[] = {
     BSPL_ENUM("InhibitLockEnd", WLMAKER_ACTION_LOCK_INHIBIT_END),
     BSPL_ENUM("LaunchTerminal", WLMAKER_ACTION_LAUNCH_TERMINAL),
     BSPL_ENUM("ShellExecute", WLMAKER_ACTION_SHELL_EXECUTE),
+    BSPL_ENUM("Execute", WLMAKER_ACTION_EXECUTE),
+    BSPL_ENUM("LogStatistics", WLMAKER_ACTION_LOG_STATISTICS),
+    BSPL_ENUM("DumpTrace", WLMAKER_ACTION_DUMP_TRACE),
+    BSPL_ENUM("DumpAllocations", WLMAKER_ACTION_DUMP_ALLOCATIONS),
+    BSPL_ENUM("ToggleDebugOverlay", WLMAKER_ACTION_TOGGLE_DEBUG_OVERLAY),
+    BSPL_ENUM("MagnifierZoomIn", WLMAKER_ACTION_MAGNIFIER_ZOOM_IN),
+    BSPL_ENUM("MagnifierZoomOut", WLMAKER_ACTION_MAGNIFIER_ZOOM_OUT),
+    BSPL_ENUM("Reload", WLMAKER_ACTION_RELOAD),
 
     BSPL_ENUM("WorkspacePrevious", WLMAKER_ACTION_WORKSPACE_TO_PREVIOUS),
     BSPL_ENUM("WorkspaceNext", WLMAKER_ACTION_WORKSPACE_TO_NEXT),
+    BSPL_ENUM("WorkspaceCascade", WLMAKER_ACTION_WORKSPACE_CASCADE),
+    BSPL_ENUM("WorkspaceTile", WLMAKER_ACTION_WORKSPACE_TILE),
+
+    BSPL_ENUM("SwitchToWorkspace1", WLMAKER_ACTION_SWITCH_TO_WORKSPACE1),
+    BSPL_ENUM("SwitchToWorkspace2", WLMAKER_ACTION_SWITCH_TO_WORKSPACE2),
+    BSPL_ENUM("SwitchToWorkspace3", WLMAKER_ACTION_SWITCH_TO_WORKSPACE3),
+    BSPL_ENUM("SwitchToWorkspace4", WLMAKER_ACTION_SWITCH_TO_WORKSPACE4),
+    BSPL_ENUM("SwitchToWorkspace5", WLMAKER_ACTION_SWITCH_TO_WORKSPACE5),
+    BSPL_ENUM("SwitchToWorkspace6", WLMAKER_ACTION_SWITCH_TO_WORKSPACE6),
+    BSPL_ENUM("SwitchToWorkspace7", WLMAKER_ACTION_SWITCH_TO_WORKSPACE7),
+    BSPL_ENUM("SwitchToWorkspace8", WLMAKER_ACTION_SWITCH_TO_WORKSPACE8),
+    BSPL_ENUM("SwitchToWorkspace9", WLMAKER_ACTION_SWITCH_TO_WORKSPACE9),
+    BSPL_ENUM("SwitchToWorkspace10", WLMAKER_ACTION_SWITCH_TO_WORKSPACE10),
 
     BSPL_ENUM("TaskPrevious", WLMAKER_ACTION_TASK_TO_PREVIOUS),
     BSPL_ENUM("TaskNext", WLMAKER_ACTION_TASK_TO_NEXT),
@@ -126,6 +199,11 @@ const bspl_enum_desc_t wlmaker_action_desc[] = {
     BSPL_ENUM("WindowShade", WLMAKER_ACTION_WINDOW_SHADE),
     BSPL_ENUM("WindowUnshade", WLMAKER_ACTION_WINDOW_UNSHADE),
 
+    BSPL_ENUM("AppClose", WLMAKER_ACTION_APP_CLOSE),
+    BSPL_ENUM("AppToNextWorkspace", WLMAKER_ACTION_APP_TO_NEXT_WORKSPACE),
+    BSPL_ENUM("AppToPreviousWorkspace",
+              WLMAKER_ACTION_APP_TO_PREVIOUS_WORKSPACE),
+
     BSPL_ENUM("RootMenu", WLMAKER_ACTION_ROOT_MENU),
 
     BSPL_ENUM("SwitchToVT1", WLMAKER_ACTION_SWITCH_TO_VT1),
@@ -184,12 +262,51 @@ void wlmaker_action_unbind_keys(wlmaker_action_handle_t *handle_ptr)
     free(handle_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+bool wlmaker_action_decode_binding(
+    const char *key_ptr,
+    bspl_object_t *object_ptr,
+    wlmaker_key_combo_t *key_combo_ptr,
+    wlmaker_action_t *action_ptr)
+{
+    bspl_string_t *string_ptr = bspl_string_from_object(object_ptr);
+    if (NULL == string_ptr) {
+        bs_log(BS_WARNING, "Action must be a string for key binding \"%s\"",
+               key_ptr);
+        return false;
+    }
+
+    uint32_t modifiers;
+    xkb_keysym_t keysym;
+    if (!_wlmaker_keybindings_parse(key_ptr, &modifiers, &keysym)) {
+        bs_log(BS_WARNING,
+               "Failed to parse binding '%s' for keybinding action '%s'",
+               key_ptr, bspl_string_value(string_ptr));
+        return false;
+    }
+
+    int action;
+    if (!bspl_enum_name_to_value(
+            wlmaker_action_desc, bspl_string_value(string_ptr), &action)) {
+        bs_log(BS_WARNING, "Not a valid keybinding action: '%s'",
+               bspl_string_value(string_ptr));
+        return false;
+    }
+
+    key_combo_ptr->modifiers = modifiers;
+    key_combo_ptr->keysym = keysym;
+    *action_ptr = action;
+    return true;
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmaker_action_execute(wlmaker_server_t *server_ptr,
                             wlmaker_action_t action,
                             void *arg_ptr)
 {
+    WLMTK_TRACE_SPAN("action_execute");
     wlmtk_workspace_t *workspace_ptr, *next_workspace_ptr;
+    wlmtk_window_group_t *group_ptr;
     wlmtk_window_t *window_ptr;
 
     switch (action) {
@@ -214,6 +331,46 @@ void wlmaker_action_execute(wlmaker_server_t *server_ptr,
         wlmaker_idle_monitor_uninhibit(server_ptr->idle_monitor_ptr);
         break;
 
+    case WLMAKER_ACTION_LOG_STATISTICS:
+        wlmtk_latency_log_stats(BS_INFO);
+        wlmtk_pool_log_stats(BS_INFO);
+        wlmtk_memstat_log_stats(BS_INFO);
+        wlmbe_backend_log_stats(server_ptr->backend_ptr, BS_INFO);
+        window_ptr = wlmtk_workspace_get_activated_window(
+            wlmtk_root_get_current_workspace(server_ptr->root_ptr));
+        if (NULL != window_ptr) {
+            wlmtk_memstat_footprint_t footprint;
+            wlmtk_window_get_footprint(window_ptr, &footprint);
+            wlmtk_memstat_footprint_log(
+                &footprint, BS_INFO, wlmtk_window_get_title(window_ptr));
+        }
+        break;
+
+    case WLMAKER_ACTION_DUMP_TRACE:
+        _wlmaker_action_dump_trace();
+        break;
+
+    case WLMAKER_ACTION_DUMP_ALLOCATIONS:
+        _wlmaker_action_dump_allocations();
+        break;
+
+    case WLMAKER_ACTION_TOGGLE_DEBUG_OVERLAY:
+        wl_signal_emit(&server_ptr->debug_overlay_toggle_event, NULL);
+        break;
+
+    case WLMAKER_ACTION_MAGNIFIER_ZOOM_IN:
+        _wlmaker_action_magnify(server_ptr, _wlmaker_action_magnify_step);
+        break;
+
+    case WLMAKER_ACTION_MAGNIFIER_ZOOM_OUT:
+        _wlmaker_action_magnify(
+            server_ptr, 1.0 / _wlmaker_action_magnify_step);
+        break;
+
+    case WLMAKER_ACTION_RELOAD:
+        wl_signal_emit(&server_ptr->reload_event, NULL);
+        break;
+
     case WLMAKER_ACTION_LAUNCH_TERMINAL:
         if (0 == fork()) {
             execl("/bin/sh", "/bin/sh", "-c", "/usr/bin/foot", (void *)NULL);
@@ -228,6 +385,14 @@ void wlmaker_action_execute(wlmaker_server_t *server_ptr,
         }
         break;
 
+    case WLMAKER_ACTION_EXECUTE:
+        if (NULL == arg_ptr) {
+            bs_log(BS_ERROR, "Invalid argument NULL for 'Execute'.");
+        } else {
+            _wlmaker_action_execute(server_ptr, arg_ptr);
+        }
+        break;
+
     case WLMAKER_ACTION_WORKSPACE_TO_PREVIOUS:
         wlmtk_root_switch_to_previous_workspace(server_ptr->root_ptr);
         break;
@@ -236,6 +401,34 @@ void wlmaker_action_execute(wlmaker_server_t *server_ptr,
         wlmtk_root_switch_to_next_workspace(server_ptr->root_ptr);
         break;
 
+    case WLMAKER_ACTION_WORKSPACE_CASCADE:
+        workspace_ptr = wlmtk_root_get_current_workspace(
+            server_ptr->root_ptr);
+        if (NULL != workspace_ptr) _wlmaker_action_cascade(workspace_ptr);
+        break;
+
+    case WLMAKER_ACTION_WORKSPACE_TILE:
+        workspace_ptr = wlmtk_root_get_current_workspace(
+            server_ptr->root_ptr);
+        if (NULL != workspace_ptr) _wlmaker_action_tile(workspace_ptr);
+        break;
+
+    case WLMAKER_ACTION_SWITCH_TO_WORKSPACE1:
+    case WLMAKER_ACTION_SWITCH_TO_WORKSPACE2:
+    case WLMAKER_ACTION_SWITCH_TO_WORKSPACE3:
+    case WLMAKER_ACTION_SWITCH_TO_WORKSPACE4:
+    case WLMAKER_ACTION_SWITCH_TO_WORKSPACE5:
+    case WLMAKER_ACTION_SWITCH_TO_WORKSPACE6:
+    case WLMAKER_ACTION_SWITCH_TO_WORKSPACE7:
+    case WLMAKER_ACTION_SWITCH_TO_WORKSPACE8:
+    case WLMAKER_ACTION_SWITCH_TO_WORKSPACE9:
+    case WLMAKER_ACTION_SWITCH_TO_WORKSPACE10:
+        // Consecutive enums: The position follows from the action code.
+        wlmtk_root_switch_to_workspace(
+            server_ptr->root_ptr,
+            action - WLMAKER_ACTION_SWITCH_TO_WORKSPACE1);
+        break;
+
     case WLMAKER_ACTION_TASK_TO_PREVIOUS:
         wlmtk_workspace_activate_previous_window(
             wlmtk_root_get_current_workspace(server_ptr->root_ptr));
@@ -358,6 +551,36 @@ void wlmaker_action_execute(wlmaker_server_t *server_ptr,
         }
         break;
 
+    case WLMAKER_ACTION_APP_CLOSE:
+        group_ptr = _wlmaker_action_activated_group(server_ptr);
+        if (NULL != group_ptr) {
+            wlmtk_window_group_for_each(
+                group_ptr, _wlmaker_action_close_window, NULL);
+        }
+        break;
+
+    case WLMAKER_ACTION_APP_TO_NEXT_WORKSPACE:
+        group_ptr = _wlmaker_action_activated_group(server_ptr);
+        next_workspace_ptr = wlmtk_workspace_from_dlnode(
+            wlmtk_dlnode_from_workspace(wlmtk_root_get_current_workspace(
+                                            server_ptr->root_ptr))->next_ptr);
+        if (NULL != group_ptr && NULL != next_workspace_ptr) {
+            _wlmaker_action_group_to_workspace(
+                server_ptr, group_ptr, next_workspace_ptr);
+        }
+        break;
+
+    case WLMAKER_ACTION_APP_TO_PREVIOUS_WORKSPACE:
+        group_ptr = _wlmaker_action_activated_group(server_ptr);
+        next_workspace_ptr = wlmtk_workspace_from_dlnode(
+            wlmtk_dlnode_from_workspace(wlmtk_root_get_current_workspace(
+                                            server_ptr->root_ptr))->prev_ptr);
+        if (NULL != group_ptr && NULL != next_workspace_ptr) {
+            _wlmaker_action_group_to_workspace(
+                server_ptr, group_ptr, next_workspace_ptr);
+        }
+        break;
+
     case WLMAKER_ACTION_ROOT_MENU:
         // TODO(kaeser@gubbe.ch): Clean up.
         if (NULL != server_ptr->root_menu_ptr &&
@@ -426,38 +649,19 @@ bool _wlmaker_keybindings_bind_item(
     void *userdata_ptr)
 {
     wlmaker_action_handle_t *handle_ptr = userdata_ptr;
-    bspl_string_t *string_ptr = bspl_string_from_object(object_ptr);
-    if (NULL == string_ptr) {
-        bs_log(BS_WARNING, "Action must be a string for key binding \"%s\"",
-               key_ptr);
-        return false;
-    }
-
-    uint32_t modifiers;
-    xkb_keysym_t keysym;
-    if (!_wlmaker_keybindings_parse(key_ptr, &modifiers, &keysym)) {
-        bs_log(BS_WARNING,
-               "Failed to parse binding '%s' for keybinding action '%s'",
-               key_ptr, bspl_string_value(string_ptr));
-        return false;
-    }
-
-    int action;
-    if (!bspl_enum_name_to_value(
-            wlmaker_action_desc, bspl_string_value(string_ptr), &action)) {
-        bs_log(BS_WARNING, "Not a valid keybinding action: '%s'",
-               bspl_string_value(string_ptr));
-        return false;
-    }
+    wlmaker_key_combo_t key_combo = {};
+    wlmaker_action_t action;
+    if (!wlmaker_action_decode_binding(
+            key_ptr, object_ptr, &key_combo, &action)) return false;
 
     _wlmaker_action_binding_t *action_binding_ptr = logged_calloc(
         1, sizeof(_wlmaker_action_binding_t));
     if (NULL == action_binding_ptr) return false;
     action_binding_ptr->handle_ptr = handle_ptr;
     action_binding_ptr->action = action;
-    action_binding_ptr->key_combo.keysym = keysym;
+    action_binding_ptr->key_combo.keysym = key_combo.keysym;
     action_binding_ptr->key_combo.ignore_case = true;
-    action_binding_ptr->key_combo.modifiers = modifiers;
+    action_binding_ptr->key_combo.modifiers = key_combo.modifiers;
     action_binding_ptr->key_combo.modifiers_mask =
         wlmaker_modifier_default_mask;
     action_binding_ptr->key_binding_ptr = wlmaker_server_bind_key(
@@ -467,6 +671,11 @@ bool _wlmaker_keybindings_bind_item(
     if (NULL != action_binding_ptr->key_binding_ptr) {
         bs_dequeue_push_back(
             &handle_ptr->bindings, &action_binding_ptr->qnode);
+        if (WLMAKER_ACTION_WORKSPACE_TO_NEXT == action ||
+            WLMAKER_ACTION_WORKSPACE_TO_PREVIOUS == action) {
+            handle_ptr->server_ptr->workspace_switch_modifiers =
+                key_combo.modifiers;
+        }
         return true;
     }
 
@@ -545,14 +754,162 @@ bool _wlmaker_action_bound_callback(const wlmaker_key_combo_t *key_combo_ptr)
     return true;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Opens a file for writing a dump, named after the process and the current
+ * time, in `$XDG_RUNTIME_DIR` or `/tmp`.
+ *
+ * @param kind_ptr            Kind of the dump, eg. `trace`.
+ * @param extension_ptr       Extension of the file name, eg. `json`.
+ * @param path_ptr            Receives the path of the file.
+ * @param path_size           Size of the buffer at `path_ptr`.
+ *
+ * @return The opened file, or NULL on error.
+ */
+FILE *_wlmaker_action_fopen_dump(
+    const char *kind_ptr,
+    const char *extension_ptr,
+    char *path_ptr,
+    size_t path_size)
+{
+    const char *dir_ptr = getenv("XDG_RUNTIME_DIR");
+    if (NULL == dir_ptr || '\0' == *dir_ptr) dir_ptr = "/tmp";
+    snprintf(path_ptr, path_size, "%s/wlmaker-%s-%d-%jd.%s",
+             dir_ptr, kind_ptr, getpid(), (intmax_t)time(NULL),
+             extension_ptr);
+
+    FILE *file_ptr = fopen(path_ptr, "w");
+    if (NULL == file_ptr) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed fopen(%s, \"w\")", path_ptr);
+    }
+    return file_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Writes the recorded trace spans as Chrome trace JSON, into a dump file. */
+void _wlmaker_action_dump_trace(void)
+{
+    char path[PATH_MAX];
+    FILE *file_ptr = _wlmaker_action_fopen_dump(
+        "trace", "json", path, sizeof(path));
+    if (NULL == file_ptr) return;
+    if (wlmtk_trace_write(file_ptr)) {
+        bs_log(BS_INFO, "Wrote trace to %s", path);
+    } else {
+        bs_log(BS_WARNING, "Failed to write trace to %s", path);
+    }
+    fclose(file_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Writes the live allocations, grouped by call site, into a dump file. Only
+ * available when built with `config_ALLOC_TRACK`.
+ */
+void _wlmaker_action_dump_allocations(void)
+{
+#if defined(WLMTK_ALLOC_TRACK)
+    char path[PATH_MAX];
+    FILE *file_ptr = _wlmaker_action_fopen_dump(
+        "allocations", "tsv", path, sizeof(path));
+    if (NULL == file_ptr) return;
+    size_t allocations, bytes;
+    wlmtk_alloctrack_get_totals(&allocations, &bytes);
+    if (wlmtk_alloctrack_write(file_ptr)) {
+        bs_log(BS_INFO, "Wrote %zu live allocations (%zu bytes) to %s",
+               allocations, bytes, path);
+    } else {
+        bs_log(BS_WARNING, "Failed to write allocations to %s", path);
+    }
+    fclose(file_ptr);
+#else  // defined(WLMTK_ALLOC_TRACK)
+    bs_log(BS_WARNING, "Allocations are not tracked. Configure with "
+           "-Dconfig_ALLOC_TRACK=ON to enable.");
+#endif  // defined(WLMTK_ALLOC_TRACK)
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Starts `cmdline_ptr` as a subprocess, without a shell. The subprocess is
+ * entrusted to @ref wlmaker_server_t::monitor_ptr, so its windows are
+ * associated, and its termination is logged.
+ *
+ * @param server_ptr
+ * @param cmdline_ptr
+ */
+void _wlmaker_action_execute(
+    wlmaker_server_t *server_ptr,
+    const char *cmdline_ptr)
+{
+    if (NULL == server_ptr->monitor_ptr) {
+        bs_log(BS_ERROR, "No subprocess monitor, not executing '%s'.",
+               cmdline_ptr);
+        return;
+    }
+
+    bs_subprocess_t *subprocess_ptr = bs_subprocess_create_cmdline(
+        cmdline_ptr);
+    if (NULL == subprocess_ptr) {
+        bs_log(BS_ERROR, "Failed bs_subprocess_create_cmdline(%s)",
+               cmdline_ptr);
+        return;
+    }
+    if (!bs_subprocess_start(subprocess_ptr)) {
+        bs_log(BS_ERROR, "Failed bs_subprocess_start for %s", cmdline_ptr);
+        bs_subprocess_destroy(subprocess_ptr);
+        return;
+    }
+
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr =
+        wlmaker_subprocess_monitor_entrust(
+            server_ptr->monitor_ptr,
+            subprocess_ptr,
+            _wlmaker_action_handle_terminated,
+            server_ptr->monitor_ptr,
+            NULL, NULL, NULL, NULL);
+    if (NULL == subprocess_handle_ptr) {
+        bs_log(BS_WARNING, "Failed wlmaker_subprocess_monitor_entrust(%p, "
+               "%p, ...) for '%s'", server_ptr->monitor_ptr, subprocess_ptr,
+               cmdline_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Callback for when a subprocess started by 'Execute' terminates. Logs, and
+ * releases the handle.
+ *
+ * @param userdata_ptr        Points to the @ref wlmaker_subprocess_monitor_t.
+ * @param subprocess_handle_ptr
+ * @param exit_status
+ * @param signal_number
+ */
+void _wlmaker_action_handle_terminated(
+    void *userdata_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    int exit_status,
+    int signal_number)
+{
+    if (0 == signal_number) {
+        bs_log(BS_INFO, "Subprocess %p terminated, status code %d.",
+               subprocess_handle_ptr, exit_status);
+    } else {
+        bs_log(BS_INFO, "Subprocess %p killed by signal %d.",
+               subprocess_handle_ptr, signal_number);
+    }
+    wlmaker_subprocess_monitor_cede(userdata_ptr, subprocess_handle_ptr);
+}
+
 /* == Unit tests =========================================================== */
 
 static void test_keybindings_parse(bs_test_t *test_ptr);
 static void test_default_keybindings(bs_test_t *test_ptr);
+static void test_decode_binding(bs_test_t *test_ptr);
 
 /** Test cases for key bindings. */
 const bs_test_case_t          wlmaker_action_test_cases[] = {
     { 1, "parse", test_keybindings_parse },
+    { 1, "decode_binding", test_decode_binding },
     { 1, "default_keybindings", test_default_keybindings },
     { 0, NULL, NULL }
 };
@@ -595,6 +952,32 @@ void test_keybindings_parse(bs_test_t *test_ptr)
         test_ptr, _wlmaker_keybindings_parse("Shift+Ctrl", &m, &ks));
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests @ref wlmaker_action_decode_binding. */
+void test_decode_binding(bs_test_t *test_ptr)
+{
+    wlmaker_key_combo_t kc = {};
+    wlmaker_action_t action;
+
+    bspl_object_t *o = bspl_object_from_string(bspl_string_create("Quit"));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmaker_action_decode_binding("Ctrl+Q", o, &kc, &action));
+    BS_TEST_VERIFY_EQ(test_ptr, WLR_MODIFIER_CTRL, kc.modifiers);
+    BS_TEST_VERIFY_EQ(test_ptr, XKB_KEY_Q, kc.keysym);
+    BS_TEST_VERIFY_EQ(test_ptr, WLMAKER_ACTION_QUIT, action);
+    BS_TEST_VERIFY_FALSE(
+        test_ptr,
+        wlmaker_action_decode_binding("Ctrl", o, &kc, &action));
+    bspl_object_unref(o);
+
+    o = bspl_object_from_string(bspl_string_create("NotAnAction"));
+    BS_TEST_VERIFY_FALSE(
+        test_ptr,
+        wlmaker_action_decode_binding("Ctrl+Q", o, &kc, &action));
+    bspl_object_unref(o);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Tests the default configuration's 'KeyBindings' section. */
 void test_default_keybindings(bs_test_t *test_ptr)
@@ -616,4 +999,194 @@ void test_default_keybindings(bs_test_t *test_ptr)
     wlmaker_action_unbind_keys(handle_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Cascades the windows of `workspace_ptr`, from the top-left of the usable
+ * area. Windows keep their size, unless they would not fit.
+ *
+ * @param workspace_ptr
+ */
+void _wlmaker_action_cascade(wlmtk_workspace_t *workspace_ptr)
+{
+    struct wlr_box extents = wlmtk_workspace_get_maximize_extents(
+        workspace_ptr, NULL);
+    int offset = 0;
+
+    wlmtk_workspace_begin_transaction(workspace_ptr);
+    // Walks from the bottom-most window, so the top one ends up in front.
+    for (bs_dllist_node_t *dlnode_ptr =
+             wlmtk_workspace_get_windows_dllist(workspace_ptr)->tail_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->prev_ptr) {
+        wlmtk_window_t *window_ptr = wlmtk_window_from_dlnode(dlnode_ptr);
+        if (!_wlmaker_action_arrangeable(window_ptr)) continue;
+
+        struct wlr_box box = wlmtk_window_get_position_and_size(window_ptr);
+        if (offset + box.width > extents.width ||
+            offset + box.height > extents.height) offset = 0;
+        box.width = BS_MIN(box.width, extents.width - offset);
+        box.height = BS_MIN(box.height, extents.height - offset);
+        wlmtk_workspace_enqueue_position_and_size(
+            workspace_ptr, window_ptr,
+            extents.x + offset, extents.y + offset, box.width, box.height);
+        offset += _wlmaker_action_cascade_step;
+    }
+    wlmtk_workspace_commit_transaction(workspace_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Tiles the windows of `workspace_ptr` on a grid covering the usable area.
+ *
+ * @param workspace_ptr
+ */
+void _wlmaker_action_tile(wlmtk_workspace_t *workspace_ptr)
+{
+    struct wlr_box extents = wlmtk_workspace_get_maximize_extents(
+        workspace_ptr, NULL);
+    bs_dllist_t *windows_ptr = wlmtk_workspace_get_windows_dllist(
+        workspace_ptr);
+
+    int windows = 0;
+    for (bs_dllist_node_t *dlnode_ptr = windows_ptr->head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        if (_wlmaker_action_arrangeable(
+                wlmtk_window_from_dlnode(dlnode_ptr))) ++windows;
+    }
+    if (0 == windows) return;
+
+    int columns = 1;
+    while (columns * columns < windows) ++columns;
+    int rows = (windows + columns - 1) / columns;
+
+    wlmtk_workspace_begin_transaction(workspace_ptr);
+    int idx = 0;
+    for (bs_dllist_node_t *dlnode_ptr = windows_ptr->head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_window_t *window_ptr = wlmtk_window_from_dlnode(dlnode_ptr);
+        if (!_wlmaker_action_arrangeable(window_ptr)) continue;
+
+        int column = idx % columns, row = idx / columns;
+        int x1 = extents.x + column * extents.width / columns;
+        int x2 = extents.x + (column + 1) * extents.width / columns;
+        int y1 = extents.y + row * extents.height / rows;
+        int y2 = extents.y + (row + 1) * extents.height / rows;
+        wlmtk_workspace_enqueue_position_and_size(
+            workspace_ptr, window_ptr, x1, y1, x2 - x1, y2 - y1);
+        ++idx;
+    }
+    wlmtk_workspace_commit_transaction(workspace_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Whether `window_ptr` is subject to cascading or tiling. */
+bool _wlmaker_action_arrangeable(wlmtk_window_t *window_ptr)
+{
+    return !wlmtk_window_is_fullscreen(window_ptr) &&
+        !wlmtk_window_is_maximized(window_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Multiplies the magnifier's zoom by `factor`, focussed at the cursor.
+ * Snaps back to no magnification, once close to it.
+ *
+ * @param server_ptr
+ * @param factor
+ */
+void _wlmaker_action_magnify(wlmaker_server_t *server_ptr, double factor)
+{
+    double zoom = factor * wlmbe_backend_magnification(server_ptr->backend_ptr);
+    if (1.05 > zoom) zoom = 1.0;
+    zoom = BS_MIN(zoom, _wlmaker_action_magnify_max);
+    wlmbe_backend_set_magnification(
+        server_ptr->backend_ptr,
+        zoom,
+        server_ptr->cursor_ptr->wlr_cursor_ptr->x,
+        server_ptr->cursor_ptr->wlr_cursor_ptr->y);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the group of the activated window: All mapped windows of its
+ * client, across workspaces.
+ *
+ * @param server_ptr
+ *
+ * @return The group, or NULL if there is no activated window, or if it is
+ *     not grouped.
+ */
+wlmtk_window_group_t *_wlmaker_action_activated_group(
+    wlmaker_server_t *server_ptr)
+{
+    wlmtk_window_t *window_ptr = wlmtk_workspace_get_activated_window(
+        wlmtk_root_get_current_workspace(server_ptr->root_ptr));
+    if (NULL == window_ptr) return NULL;
+    return wlmtk_window_get_group(window_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Moves all windows of the group to `target_workspace_ptr`. The moves are
+ * enqueued in a transaction on each workspace, so there is a single layout
+ * pass, and activation settles once.
+ *
+ * @param server_ptr
+ * @param group_ptr
+ * @param target_workspace_ptr
+ */
+void _wlmaker_action_group_to_workspace(
+    wlmaker_server_t *server_ptr,
+    wlmtk_window_group_t *group_ptr,
+    wlmtk_workspace_t *target_workspace_ptr)
+{
+    wlmtk_root_for_each_workspace(
+        server_ptr->root_ptr, _wlmaker_action_begin_transaction, NULL);
+    wlmtk_window_group_for_each(
+        group_ptr, _wlmaker_action_enqueue_move, target_workspace_ptr);
+    wlmtk_root_for_each_workspace(
+        server_ptr->root_ptr, _wlmaker_action_commit_transaction, NULL);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Callback for @ref wlmtk_window_group_for_each: Requests to close. */
+void _wlmaker_action_close_window(
+    wlmtk_window_t *window_ptr,
+    __UNUSED__ void *ud_ptr)
+{
+    wlmtk_window_request_close(window_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Callback for @ref wlmtk_window_group_for_each: Enqueues moving the window
+ * to the workspace at `ud_ptr`.
+ */
+void _wlmaker_action_enqueue_move(wlmtk_window_t *window_ptr, void *ud_ptr)
+{
+    wlmtk_workspace_enqueue_move_to_workspace(
+        wlmtk_window_get_workspace(window_ptr), window_ptr, ud_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Callback for @ref wlmtk_root_for_each_workspace: Begins a transaction. */
+void _wlmaker_action_begin_transaction(
+    bs_dllist_node_t *dlnode_ptr,
+    __UNUSED__ void *ud_ptr)
+{
+    wlmtk_workspace_begin_transaction(wlmtk_workspace_from_dlnode(dlnode_ptr));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Callback for @ref wlmtk_root_for_each_workspace: Commits a transaction. */
+void _wlmaker_action_commit_transaction(
+    bs_dllist_node_t *dlnode_ptr,
+    __UNUSED__ void *ud_ptr)
+{
+    wlmtk_workspace_commit_transaction(
+        wlmtk_workspace_from_dlnode(dlnode_ptr));
+}
+
 /* == End of action.c ====================================================== */
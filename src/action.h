@@ -39,9 +39,31 @@ typedef enum {
     WLMAKER_ACTION_LOCK_INHIBIT_END,
     WLMAKER_ACTION_LAUNCH_TERMINAL,
     WLMAKER_ACTION_SHELL_EXECUTE,
+    WLMAKER_ACTION_EXECUTE,
+    WLMAKER_ACTION_LOG_STATISTICS,
+    WLMAKER_ACTION_DUMP_TRACE,
+    WLMAKER_ACTION_DUMP_ALLOCATIONS,
+    WLMAKER_ACTION_TOGGLE_DEBUG_OVERLAY,
+    WLMAKER_ACTION_MAGNIFIER_ZOOM_IN,
+    WLMAKER_ACTION_MAGNIFIER_ZOOM_OUT,
+    WLMAKER_ACTION_RELOAD,
 
     WLMAKER_ACTION_WORKSPACE_TO_PREVIOUS,
     WLMAKER_ACTION_WORKSPACE_TO_NEXT,
+    WLMAKER_ACTION_WORKSPACE_CASCADE,
+    WLMAKER_ACTION_WORKSPACE_TILE,
+
+    // Note: Keep these numbered consecutively.
+    WLMAKER_ACTION_SWITCH_TO_WORKSPACE1,
+    WLMAKER_ACTION_SWITCH_TO_WORKSPACE2,
+    WLMAKER_ACTION_SWITCH_TO_WORKSPACE3,
+    WLMAKER_ACTION_SWITCH_TO_WORKSPACE4,
+    WLMAKER_ACTION_SWITCH_TO_WORKSPACE5,
+    WLMAKER_ACTION_SWITCH_TO_WORKSPACE6,
+    WLMAKER_ACTION_SWITCH_TO_WORKSPACE7,
+    WLMAKER_ACTION_SWITCH_TO_WORKSPACE8,
+    WLMAKER_ACTION_SWITCH_TO_WORKSPACE9,
+    WLMAKER_ACTION_SWITCH_TO_WORKSPACE10,
 
     WLMAKER_ACTION_TASK_TO_PREVIOUS,
     WLMAKER_ACTION_TASK_TO_NEXT,
@@ -60,6 +82,10 @@ typedef enum {
     WLMAKER_ACTION_WINDOW_TO_NEXT_WORKSPACE,
     WLMAKER_ACTION_WINDOW_TO_PREVIOUS_WORKSPACE,
 
+    WLMAKER_ACTION_APP_CLOSE,
+    WLMAKER_ACTION_APP_TO_NEXT_WORKSPACE,
+    WLMAKER_ACTION_APP_TO_PREVIOUS_WORKSPACE,
+
     WLMAKER_ACTION_ROOT_MENU,
 
     // Note: Keep these numbered consecutively.
@@ -103,6 +129,24 @@ wlmaker_action_handle_t *wlmaker_action_bind_keys(
  */
 void wlmaker_action_unbind_keys(wlmaker_action_handle_t *handle_ptr);
 
+/**
+ * Decodes one key binding of the config: The key combination from `key_ptr`,
+ * and the action from `object_ptr`. Does not bind anything.
+ *
+ * @param key_ptr             Key combination, eg. "Ctrl+Alt+Logo+Q".
+ * @param object_ptr          The action's name, as plist string.
+ * @param key_combo_ptr       Receives the modifiers and keysym. Other fields
+ *                            are left unchanged.
+ * @param action_ptr
+ *
+ * @return true on success. Errors are logged.
+ */
+bool wlmaker_action_decode_binding(
+    const char *key_ptr,
+    bspl_object_t *object_ptr,
+    wlmaker_key_combo_t *key_combo_ptr,
+    wlmaker_action_t *action_ptr);
+
 /**
  * Executes the given action on wlmaker.
  *
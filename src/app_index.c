@@ -0,0 +1,1167 @@
+/* ========================================================================= */
+/**
+ * @file app_index.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "app_index.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <libbase/libbase.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <wayland-server-core.h>
+
+/* == Declarations ========================================================= */
+
+/** State of the application index. */
+struct _wlmaker_app_index_t {
+    /** Events. See @ref wlmaker_app_index_events. */
+    wlmaker_app_index_events_t events;
+
+    /** Entries, by @ref _wlmaker_app_index_key_t. Main thread only. */
+    bs_avltree_t              *tree_ptr;
+    /** All entries, as @ref _wlmaker_app_index_entry_t::dlnode. */
+    bs_dllist_t               entries;
+
+    /** The indexed directories, in order of priority. */
+    char                      **dir_ptrs;
+    /** Number of elements in @ref wlmaker_app_index_t::dir_ptrs. */
+    size_t                    num_dirs;
+    /** Inotify watch descriptor for each directory, or -1. */
+    int                       *wd_ptr;
+
+    /** File descriptor for inotify. */
+    int                       inotify_fd;
+    /** Event source for @ref wlmaker_app_index_t::inotify_fd. */
+    struct wl_event_source    *inotify_event_source_ptr;
+    /** Signalled by the worker thread when jobs are done. */
+    int                       event_fd;
+    /** Event source for @ref wlmaker_app_index_t::event_fd. */
+    struct wl_event_source    *event_source_ptr;
+
+    /** Guards `pending`, `done` and `shutdown`. */
+    pthread_mutex_t           mutex;
+    /** Signals the worker thread about new jobs, or shutdown. */
+    pthread_cond_t            cond;
+    /** The worker thread. */
+    pthread_t                 thread;
+    /** Whether @ref wlmaker_app_index_t::thread was started. */
+    bool                      thread_started;
+    /** Jobs to process, @ref _wlmaker_app_index_job_t::dlnode. */
+    bs_dllist_t               pending;
+    /** Results, @ref _wlmaker_app_index_result_t::dlnode. */
+    bs_dllist_t               done;
+    /** Tells the worker thread to exit. */
+    bool                      shutdown;
+};
+
+/** Key of an entry: The desktop file ID, and the directory it's from. */
+typedef struct {
+    /** Desktop file ID, eg. `org.example.App.desktop`. */
+    const char                *id_ptr;
+    /** Index into @ref wlmaker_app_index_t::dir_ptrs. */
+    size_t                    dir_index;
+} _wlmaker_app_index_key_t;
+
+/** An entry of the index. */
+typedef struct {
+    /** Node in @ref wlmaker_app_index_t::tree_ptr. */
+    bs_avltree_node_t         avlnode;
+    /** Node in @ref wlmaker_app_index_t::entries. */
+    bs_dllist_node_t          dlnode;
+    /** Key, with `id_ptr` owned by the entry. */
+    _wlmaker_app_index_key_t  key;
+    /** Whether to show the entry. False for `NoDisplay` or `Hidden`. */
+    bool                      visible;
+    /** `Name` of the entry. NULL if not visible. */
+    char                      *name_ptr;
+    /** `Exec` of the entry, with field codes removed. NULL if not visible. */
+    char                      *cmdline_ptr;
+} _wlmaker_app_index_entry_t;
+
+/** A job for the worker thread. */
+typedef struct {
+    /** Node in @ref wlmaker_app_index_t::pending. */
+    bs_dllist_node_t          dlnode;
+    /** Index into @ref wlmaker_app_index_t::dir_ptrs. */
+    size_t                    dir_index;
+    /** Desktop file ID to (re)parse. NULL to scan the whole directory. */
+    char                      *id_ptr;
+} _wlmaker_app_index_job_t;
+
+/** A result from the worker thread. */
+typedef struct {
+    /** Node in @ref wlmaker_app_index_t::done. */
+    bs_dllist_node_t          dlnode;
+    /** Key of the result. A NULL `id_ptr` removes all entries of the dir. */
+    _wlmaker_app_index_key_t  key;
+    /** Whether the file exists, and describes an application. */
+    bool                      present;
+    /** See @ref _wlmaker_app_index_entry_t::visible. */
+    bool                      visible;
+    /** See @ref _wlmaker_app_index_entry_t::name_ptr. */
+    char                      *name_ptr;
+    /** See @ref _wlmaker_app_index_entry_t::cmdline_ptr. */
+    char                      *cmdline_ptr;
+} _wlmaker_app_index_result_t;
+
+static bool _wlmaker_app_index_init_dirs(
+    wlmaker_app_index_t *app_index_ptr,
+    const char **dir_ptrs);
+static bool _wlmaker_app_index_add_dir(
+    wlmaker_app_index_t *app_index_ptr,
+    const char *dir_ptr);
+static void _wlmaker_app_index_enqueue(
+    wlmaker_app_index_t *app_index_ptr,
+    size_t dir_index,
+    const char *id_ptr);
+
+static void *_wlmaker_app_index_thread(void *arg_ptr);
+static void _wlmaker_app_index_scan(
+    const char *path_ptr,
+    const char *prefix_ptr,
+    size_t dir_index,
+    int depth,
+    bs_dllist_t *results_ptr);
+static _wlmaker_app_index_result_t *_wlmaker_app_index_result_create(
+    const char *path_ptr,
+    const char *id_ptr,
+    size_t dir_index);
+static void _wlmaker_app_index_result_destroy(
+    _wlmaker_app_index_result_t *result_ptr);
+static bool _wlmaker_app_index_parse(
+    FILE *file_ptr,
+    _wlmaker_app_index_result_t *result_ptr);
+static void _wlmaker_app_index_unescape(char *value_ptr);
+static void _wlmaker_app_index_strip_field_codes(char *cmdline_ptr);
+
+static int _wlmaker_app_index_handle_done(
+    int fd,
+    uint32_t mask,
+    void *data_ptr);
+static int _wlmaker_app_index_handle_inotify(
+    int fd,
+    uint32_t mask,
+    void *data_ptr);
+static bool _wlmaker_app_index_apply(
+    wlmaker_app_index_t *app_index_ptr,
+    _wlmaker_app_index_result_t *result_ptr);
+static void _wlmaker_app_index_entry_remove(
+    wlmaker_app_index_t *app_index_ptr,
+    _wlmaker_app_index_entry_t *entry_ptr);
+static int _wlmaker_app_index_entry_cmp(
+    const bs_avltree_node_t *avlnode_ptr,
+    const void *key_ptr);
+static int _wlmaker_app_index_entry_name_cmp(const void *a_ptr,
+                                             const void *b_ptr);
+
+/* == Data ================================================================= */
+
+/** Nesting depth of sub-directories to scan. */
+static const int _wlmaker_app_index_max_depth = 4;
+
+/** Events to watch for, on each directory. */
+static const uint32_t _wlmaker_app_index_inotify_mask =
+    IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmaker_app_index_t *wlmaker_app_index_create(
+    struct wl_event_loop *wl_event_loop_ptr,
+    const char **dir_ptrs)
+{
+    wlmaker_app_index_t *app_index_ptr = logged_calloc(
+        1, sizeof(wlmaker_app_index_t));
+    if (NULL == app_index_ptr) return NULL;
+    wl_signal_init(&app_index_ptr->events.changed);
+    pthread_mutex_init(&app_index_ptr->mutex, NULL);
+    pthread_cond_init(&app_index_ptr->cond, NULL);
+    app_index_ptr->inotify_fd = -1;
+    app_index_ptr->event_fd = -1;
+
+    app_index_ptr->tree_ptr = bs_avltree_create(
+        _wlmaker_app_index_entry_cmp, NULL);
+    if (NULL == app_index_ptr->tree_ptr) {
+        wlmaker_app_index_destroy(app_index_ptr);
+        return NULL;
+    }
+
+    app_index_ptr->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (0 > app_index_ptr->inotify_fd) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed inotify_init1(%d)",
+               IN_NONBLOCK | IN_CLOEXEC);
+        wlmaker_app_index_destroy(app_index_ptr);
+        return NULL;
+    }
+    if (!_wlmaker_app_index_init_dirs(app_index_ptr, dir_ptrs)) {
+        wlmaker_app_index_destroy(app_index_ptr);
+        return NULL;
+    }
+
+    app_index_ptr->inotify_event_source_ptr = wl_event_loop_add_fd(
+        wl_event_loop_ptr,
+        app_index_ptr->inotify_fd,
+        WL_EVENT_READABLE,
+        _wlmaker_app_index_handle_inotify,
+        app_index_ptr);
+    app_index_ptr->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (0 > app_index_ptr->event_fd) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed eventfd(0, %d)",
+               EFD_CLOEXEC | EFD_NONBLOCK);
+        wlmaker_app_index_destroy(app_index_ptr);
+        return NULL;
+    }
+    app_index_ptr->event_source_ptr = wl_event_loop_add_fd(
+        wl_event_loop_ptr,
+        app_index_ptr->event_fd,
+        WL_EVENT_READABLE,
+        _wlmaker_app_index_handle_done,
+        app_index_ptr);
+    if (NULL == app_index_ptr->inotify_event_source_ptr ||
+        NULL == app_index_ptr->event_source_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_fd(%p, ...)",
+               wl_event_loop_ptr);
+        wlmaker_app_index_destroy(app_index_ptr);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < app_index_ptr->num_dirs; ++i) {
+        _wlmaker_app_index_enqueue(app_index_ptr, i, NULL);
+    }
+    int rv = pthread_create(
+        &app_index_ptr->thread, NULL, _wlmaker_app_index_thread,
+        app_index_ptr);
+    if (0 != rv) {
+        errno = rv;
+        bs_log(BS_ERROR | BS_ERRNO, "Failed pthread_create()");
+        wlmaker_app_index_destroy(app_index_ptr);
+        return NULL;
+    }
+    app_index_ptr->thread_started = true;
+    return app_index_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_app_index_destroy(wlmaker_app_index_t *app_index_ptr)
+{
+    if (app_index_ptr->thread_started) {
+        pthread_mutex_lock(&app_index_ptr->mutex);
+        app_index_ptr->shutdown = true;
+        pthread_cond_broadcast(&app_index_ptr->cond);
+        pthread_mutex_unlock(&app_index_ptr->mutex);
+        pthread_join(app_index_ptr->thread, NULL);
+        app_index_ptr->thread_started = false;
+    }
+
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                        &app_index_ptr->pending))) {
+        _wlmaker_app_index_job_t *job_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, _wlmaker_app_index_job_t, dlnode);
+        if (NULL != job_ptr->id_ptr) free(job_ptr->id_ptr);
+        free(job_ptr);
+    }
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&app_index_ptr->done))) {
+        _wlmaker_app_index_result_destroy(BS_CONTAINER_OF(
+            dlnode_ptr, _wlmaker_app_index_result_t, dlnode));
+    }
+    while (NULL != app_index_ptr->entries.head_ptr) {
+        _wlmaker_app_index_entry_remove(
+            app_index_ptr,
+            BS_CONTAINER_OF(app_index_ptr->entries.head_ptr,
+                            _wlmaker_app_index_entry_t, dlnode));
+    }
+
+    if (NULL != app_index_ptr->event_source_ptr) {
+        wl_event_source_remove(app_index_ptr->event_source_ptr);
+        app_index_ptr->event_source_ptr = NULL;
+    }
+    if (0 <= app_index_ptr->event_fd) {
+        close(app_index_ptr->event_fd);
+        app_index_ptr->event_fd = -1;
+    }
+    if (NULL != app_index_ptr->inotify_event_source_ptr) {
+        wl_event_source_remove(app_index_ptr->inotify_event_source_ptr);
+        app_index_ptr->inotify_event_source_ptr = NULL;
+    }
+    if (0 <= app_index_ptr->inotify_fd) {
+        close(app_index_ptr->inotify_fd);
+        app_index_ptr->inotify_fd = -1;
+    }
+
+    if (NULL != app_index_ptr->dir_ptrs) {
+        for (size_t i = 0; i < app_index_ptr->num_dirs; ++i) {
+            free(app_index_ptr->dir_ptrs[i]);
+        }
+        free(app_index_ptr->dir_ptrs);
+        app_index_ptr->dir_ptrs = NULL;
+    }
+    if (NULL != app_index_ptr->wd_ptr) {
+        free(app_index_ptr->wd_ptr);
+        app_index_ptr->wd_ptr = NULL;
+    }
+    if (NULL != app_index_ptr->tree_ptr) {
+        bs_avltree_destroy(app_index_ptr->tree_ptr);
+        app_index_ptr->tree_ptr = NULL;
+    }
+    pthread_cond_destroy(&app_index_ptr->cond);
+    pthread_mutex_destroy(&app_index_ptr->mutex);
+    free(app_index_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+wlmaker_app_index_events_t *wlmaker_app_index_events(
+    wlmaker_app_index_t *app_index_ptr)
+{
+    return &app_index_ptr->events;
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmaker_app_index_for_each(
+    wlmaker_app_index_t *app_index_ptr,
+    wlmaker_app_index_callback_t callback,
+    void *userdata_ptr)
+{
+    size_t size = bs_avltree_size(app_index_ptr->tree_ptr);
+    if (0 == size) return 0;
+    _wlmaker_app_index_entry_t **entry_ptrs = logged_calloc(
+        size, sizeof(_wlmaker_app_index_entry_t*));
+    if (NULL == entry_ptrs) return 0;
+
+    size_t n = 0;
+    for (bs_dllist_node_t *dlnode_ptr = app_index_ptr->entries.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        _wlmaker_app_index_entry_t *entry_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, _wlmaker_app_index_entry_t, dlnode);
+        if (!entry_ptr->visible) continue;
+
+        // Masked by an entry of same ID in a directory of higher priority?
+        bool masked = false;
+        for (size_t i = 0; i < entry_ptr->key.dir_index && !masked; ++i) {
+            _wlmaker_app_index_key_t key = {
+                .id_ptr = entry_ptr->key.id_ptr, .dir_index = i };
+            masked = NULL != bs_avltree_lookup(app_index_ptr->tree_ptr, &key);
+        }
+        if (!masked) entry_ptrs[n++] = entry_ptr;
+    }
+
+    qsort(entry_ptrs, n, sizeof(_wlmaker_app_index_entry_t*),
+          _wlmaker_app_index_entry_name_cmp);
+    for (size_t i = 0; i < n; ++i) {
+        callback(entry_ptrs[i]->name_ptr, entry_ptrs[i]->cmdline_ptr,
+                 userdata_ptr);
+    }
+    free(entry_ptrs);
+    return n;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Sets up @ref wlmaker_app_index_t::dir_ptrs and the inotify watches.
+ *
+ * @param app_index_ptr
+ * @param dir_ptrs            See @ref wlmaker_app_index_create.
+ *
+ * @return true on success.
+ */
+bool _wlmaker_app_index_init_dirs(
+    wlmaker_app_index_t *app_index_ptr,
+    const char **dir_ptrs)
+{
+    if (NULL != dir_ptrs) {
+        for (; NULL != *dir_ptrs; ++dir_ptrs) {
+            if (!_wlmaker_app_index_add_dir(app_index_ptr, *dir_ptrs)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    char path[PATH_MAX];
+    const char *data_home_ptr = getenv("XDG_DATA_HOME");
+    if (NULL != data_home_ptr && '\0' != *data_home_ptr) {
+        snprintf(path, sizeof(path), "%s/applications", data_home_ptr);
+    } else {
+        const char *home_ptr = getenv("HOME");
+        snprintf(path, sizeof(path), "%s/.local/share/applications",
+                 NULL != home_ptr ? home_ptr : "");
+    }
+    if (!_wlmaker_app_index_add_dir(app_index_ptr, path)) return false;
+
+    const char *data_dirs_ptr = getenv("XDG_DATA_DIRS");
+    if (NULL == data_dirs_ptr || '\0' == *data_dirs_ptr) {
+        data_dirs_ptr = "/usr/local/share:/usr/share";
+    }
+    while ('\0' != *data_dirs_ptr) {
+        size_t len = strcspn(data_dirs_ptr, ":");
+        if (0 < len) {
+            snprintf(path, sizeof(path), "%.*s/applications",
+                     (int)len, data_dirs_ptr);
+            if (!_wlmaker_app_index_add_dir(app_index_ptr, path)) {
+                return false;
+            }
+        }
+        data_dirs_ptr += len;
+        if (':' == *data_dirs_ptr) ++data_dirs_ptr;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Adds `dir_ptr` to the list of directories, and watches it. Directories
+ * that do not exist (yet) are kept, but not watched.
+ *
+ * @param app_index_ptr
+ * @param dir_ptr
+ *
+ * @return true on success.
+ */
+bool _wlmaker_app_index_add_dir(
+    wlmaker_app_index_t *app_index_ptr,
+    const char *dir_ptr)
+{
+    size_t n = app_index_ptr->num_dirs + 1;
+    char **dir_ptrs = realloc(app_index_ptr->dir_ptrs, n * sizeof(char*));
+    if (NULL == dir_ptrs) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed realloc(%p, %zu)",
+               app_index_ptr->dir_ptrs, n * sizeof(char*));
+        return false;
+    }
+    app_index_ptr->dir_ptrs = dir_ptrs;
+    int *wd_ptr = realloc(app_index_ptr->wd_ptr, n * sizeof(int));
+    if (NULL == wd_ptr) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed realloc(%p, %zu)",
+               app_index_ptr->wd_ptr, n * sizeof(int));
+        return false;
+    }
+    app_index_ptr->wd_ptr = wd_ptr;
+
+    char *d_ptr = logged_strdup(dir_ptr);
+    if (NULL == d_ptr) return false;
+    app_index_ptr->dir_ptrs[n - 1] = d_ptr;
+    app_index_ptr->wd_ptr[n - 1] = inotify_add_watch(
+        app_index_ptr->inotify_fd, d_ptr, _wlmaker_app_index_inotify_mask);
+    if (0 > app_index_ptr->wd_ptr[n - 1] && ENOENT != errno) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed inotify_add_watch(%d, %s, ...)",
+               app_index_ptr->inotify_fd, d_ptr);
+    }
+    app_index_ptr->num_dirs = n;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Enqueues a job for the worker thread.
+ *
+ * @param app_index_ptr
+ * @param dir_index
+ * @param id_ptr              Desktop file ID to re-parse, or NULL to scan
+ *                            the whole directory.
+ */
+void _wlmaker_app_index_enqueue(
+    wlmaker_app_index_t *app_index_ptr,
+    size_t dir_index,
+    const char *id_ptr)
+{
+    _wlmaker_app_index_job_t *job_ptr = logged_calloc(
+        1, sizeof(_wlmaker_app_index_job_t));
+    if (NULL == job_ptr) return;
+    job_ptr->dir_index = dir_index;
+    if (NULL != id_ptr) {
+        job_ptr->id_ptr = logged_strdup(id_ptr);
+        if (NULL == job_ptr->id_ptr) {
+            free(job_ptr);
+            return;
+        }
+    }
+
+    pthread_mutex_lock(&app_index_ptr->mutex);
+    bs_dllist_push_back(&app_index_ptr->pending, &job_ptr->dlnode);
+    pthread_cond_signal(&app_index_ptr->cond);
+    pthread_mutex_unlock(&app_index_ptr->mutex);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Worker thread: Takes jobs from @ref wlmaker_app_index_t::pending, scans
+ * or parses, and passes the results on to `done`.
+ *
+ * @param arg_ptr             Points to @ref wlmaker_app_index_t.
+ *
+ * @return NULL.
+ */
+void *_wlmaker_app_index_thread(void *arg_ptr)
+{
+    wlmaker_app_index_t *app_index_ptr = arg_ptr;
+
+    pthread_mutex_lock(&app_index_ptr->mutex);
+    while (!app_index_ptr->shutdown) {
+        bs_dllist_node_t *dlnode_ptr = bs_dllist_pop_front(
+            &app_index_ptr->pending);
+        if (NULL == dlnode_ptr) {
+            pthread_cond_wait(&app_index_ptr->cond, &app_index_ptr->mutex);
+            continue;
+        }
+        // The directory paths are immutable while the thread runs.
+        _wlmaker_app_index_job_t *job_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, _wlmaker_app_index_job_t, dlnode);
+        const char *dir_ptr = app_index_ptr->dir_ptrs[job_ptr->dir_index];
+        pthread_mutex_unlock(&app_index_ptr->mutex);
+
+        bs_dllist_t results = {};
+        _wlmaker_app_index_result_t *result_ptr;
+        if (NULL == job_ptr->id_ptr) {
+            result_ptr = _wlmaker_app_index_result_create(
+                NULL, NULL, job_ptr->dir_index);
+            if (NULL != result_ptr) {
+                bs_dllist_push_back(&results, &result_ptr->dlnode);
+            }
+            _wlmaker_app_index_scan(dir_ptr, "", job_ptr->dir_index, 0,
+                                    &results);
+        } else {
+            char path[PATH_MAX];
+            snprintf(path, sizeof(path), "%s/%s", dir_ptr, job_ptr->id_ptr);
+            result_ptr = _wlmaker_app_index_result_create(
+                path, job_ptr->id_ptr, job_ptr->dir_index);
+            if (NULL != result_ptr) {
+                bs_dllist_push_back(&results, &result_ptr->dlnode);
+            }
+            free(job_ptr->id_ptr);
+        }
+        free(job_ptr);
+
+        pthread_mutex_lock(&app_index_ptr->mutex);
+        while (NULL != (dlnode_ptr = bs_dllist_pop_front(&results))) {
+            bs_dllist_push_back(&app_index_ptr->done, dlnode_ptr);
+        }
+        uint64_t value = 1;
+        if (sizeof(value) != write(app_index_ptr->event_fd, &value,
+                                   sizeof(value))) {
+            bs_log(BS_WARNING | BS_ERRNO, "Failed write(%d, ...)",
+                   app_index_ptr->event_fd);
+        }
+    }
+    pthread_mutex_unlock(&app_index_ptr->mutex);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Scans `path_ptr` for desktop files, recursing into sub-directories. The
+ * desktop file ID of files in sub-directories is prefixed by the
+ * sub-directory path, with '/' replaced by '-'.
+ *
+ * @param path_ptr
+ * @param prefix_ptr
+ * @param dir_index
+ * @param depth
+ * @param results_ptr         Results are appended here.
+ */
+void _wlmaker_app_index_scan(
+    const char *path_ptr,
+    const char *prefix_ptr,
+    size_t dir_index,
+    int depth,
+    bs_dllist_t *results_ptr)
+{
+    DIR *dir_ptr = opendir(path_ptr);
+    if (NULL == dir_ptr) {
+        if (ENOENT != errno) {
+            bs_log(BS_WARNING | BS_ERRNO, "Failed opendir(%s)", path_ptr);
+        }
+        return;
+    }
+
+    struct dirent *dirent_ptr;
+    while (NULL != (dirent_ptr = readdir(dir_ptr))) {
+        const char *name_ptr = dirent_ptr->d_name;
+        if ('.' == name_ptr[0]) continue;
+
+        char full_path[PATH_MAX], id[NAME_MAX + 1];
+        snprintf(full_path, sizeof(full_path), "%s/%s", path_ptr, name_ptr);
+        snprintf(id, sizeof(id), "%s%s", prefix_ptr, name_ptr);
+        struct stat st;
+        if (0 != stat(full_path, &st)) continue;
+
+        if (S_ISDIR(st.st_mode)) {
+            if (depth >= _wlmaker_app_index_max_depth) continue;
+            char prefix[NAME_MAX + 1];
+            snprintf(prefix, sizeof(prefix), "%s-", id);
+            _wlmaker_app_index_scan(
+                full_path, prefix, dir_index, depth + 1, results_ptr);
+            continue;
+        }
+
+        size_t len = strlen(name_ptr);
+        if (!S_ISREG(st.st_mode) ||
+            8 >= len || 0 != strcmp(name_ptr + len - 8, ".desktop")) continue;
+        _wlmaker_app_index_result_t *result_ptr =
+            _wlmaker_app_index_result_create(full_path, id, dir_index);
+        if (NULL == result_ptr) continue;
+        if (result_ptr->present) {
+            bs_dllist_push_back(results_ptr, &result_ptr->dlnode);
+        } else {
+            _wlmaker_app_index_result_destroy(result_ptr);
+        }
+    }
+    closedir(dir_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates a result by parsing the desktop file at `path_ptr`. A missing
+ * file, or one that is not an application, yields a result that is not
+ * `present`.
+ *
+ * @param path_ptr            Path to the file. NULL for a result that
+ *                            clears the directory.
+ * @param id_ptr
+ * @param dir_index
+ *
+ * @return The result, or NULL on error.
+ */
+_wlmaker_app_index_result_t *_wlmaker_app_index_result_create(
+    const char *path_ptr,
+    const char *id_ptr,
+    size_t dir_index)
+{
+    _wlmaker_app_index_result_t *result_ptr = logged_calloc(
+        1, sizeof(_wlmaker_app_index_result_t));
+    if (NULL == result_ptr) return NULL;
+    result_ptr->key.dir_index = dir_index;
+    if (NULL == id_ptr) return result_ptr;
+
+    result_ptr->key.id_ptr = logged_strdup(id_ptr);
+    if (NULL == result_ptr->key.id_ptr) {
+        _wlmaker_app_index_result_destroy(result_ptr);
+        return NULL;
+    }
+
+    FILE *file_ptr = fopen(path_ptr, "r");
+    if (NULL != file_ptr) {
+        result_ptr->present = _wlmaker_app_index_parse(file_ptr, result_ptr);
+        fclose(file_ptr);
+    }
+    return result_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the result, and what it still holds. */
+void _wlmaker_app_index_result_destroy(
+    _wlmaker_app_index_result_t *result_ptr)
+{
+    if (NULL != result_ptr->key.id_ptr) free((char*)result_ptr->key.id_ptr);
+    if (NULL != result_ptr->name_ptr) free(result_ptr->name_ptr);
+    if (NULL != result_ptr->cmdline_ptr) free(result_ptr->cmdline_ptr);
+    free(result_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Parses the `[Desktop Entry]` group of a desktop file. Localized keys are
+ * ignored. Only entries of `Type=Application` are considered.
+ *
+ * @param file_ptr
+ * @param result_ptr          Receives `visible`, `name_ptr` and
+ *                            `cmdline_ptr`.
+ *
+ * @return true if the file describes an application.
+ */
+bool _wlmaker_app_index_parse(
+    FILE *file_ptr,
+    _wlmaker_app_index_result_t *result_ptr)
+{
+    bool in_group = false, application = false, hidden = false;
+    char *line_ptr = NULL;
+    size_t line_size = 0;
+    ssize_t len;
+    while (0 <= (len = getline(&line_ptr, &line_size, file_ptr))) {
+        while (0 < len && ('\n' == line_ptr[len - 1] ||
+                           '\r' == line_ptr[len - 1])) {
+            line_ptr[--len] = '\0';
+        }
+        if ('#' == line_ptr[0] || '\0' == line_ptr[0]) continue;
+        if ('[' == line_ptr[0]) {
+            in_group = 0 == strcmp(line_ptr, "[Desktop Entry]");
+            continue;
+        }
+        if (!in_group) continue;
+
+        char *value_ptr = strchr(line_ptr, '=');
+        if (NULL == value_ptr) continue;
+        char *key_end_ptr = value_ptr;
+        *value_ptr++ = '\0';
+        while (key_end_ptr > line_ptr && ' ' == key_end_ptr[-1]) {
+            *--key_end_ptr = '\0';
+        }
+        while (' ' == *value_ptr) ++value_ptr;
+
+        char **dest_ptr_ptr = NULL;
+        if (0 == strcmp(line_ptr, "Type")) {
+            application = 0 == strcmp(value_ptr, "Application");
+        } else if (0 == strcmp(line_ptr, "NoDisplay") ||
+                   0 == strcmp(line_ptr, "Hidden")) {
+            hidden |= 0 == strcmp(value_ptr, "true");
+        } else if (0 == strcmp(line_ptr, "Name")) {
+            dest_ptr_ptr = &result_ptr->name_ptr;
+        } else if (0 == strcmp(line_ptr, "Exec")) {
+            dest_ptr_ptr = &result_ptr->cmdline_ptr;
+        }
+        if (NULL != dest_ptr_ptr) {
+            if (NULL != *dest_ptr_ptr) free(*dest_ptr_ptr);
+            *dest_ptr_ptr = logged_strdup(value_ptr);
+            if (NULL != *dest_ptr_ptr) _wlmaker_app_index_unescape(
+                    *dest_ptr_ptr);
+        }
+    }
+    if (NULL != line_ptr) free(line_ptr);
+
+    if (NULL != result_ptr->cmdline_ptr) {
+        _wlmaker_app_index_strip_field_codes(result_ptr->cmdline_ptr);
+    }
+    result_ptr->visible = (application && !hidden &&
+                           NULL != result_ptr->name_ptr &&
+                           NULL != result_ptr->cmdline_ptr &&
+                           '\0' != result_ptr->cmdline_ptr[0]);
+    if (!result_ptr->visible) {
+        if (NULL != result_ptr->name_ptr) free(result_ptr->name_ptr);
+        result_ptr->name_ptr = NULL;
+        if (NULL != result_ptr->cmdline_ptr) free(result_ptr->cmdline_ptr);
+        result_ptr->cmdline_ptr = NULL;
+    }
+    // A hidden entry still masks those of lower-priority directories.
+    return application || hidden;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Resolves the escape sequences of a string value, in place. */
+void _wlmaker_app_index_unescape(char *value_ptr)
+{
+    char *dest_ptr = value_ptr;
+    for (; '\0' != *value_ptr; ++value_ptr) {
+        if ('\\' != *value_ptr || '\0' == value_ptr[1]) {
+            *dest_ptr++ = *value_ptr;
+            continue;
+        }
+        switch (*++value_ptr) {
+        case 's': *dest_ptr++ = ' '; break;
+        case 'n': *dest_ptr++ = '\n'; break;
+        case 't': *dest_ptr++ = '\t'; break;
+        case 'r': *dest_ptr++ = '\r'; break;
+        default: *dest_ptr++ = *value_ptr; break;
+        }
+    }
+    *dest_ptr = '\0';
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Removes the field codes (`%f`, `%U`, ...) from the `Exec` value, in place.
+ * `%%` becomes `%`. Trailing whitespace is removed.
+ *
+ * @param cmdline_ptr
+ */
+void _wlmaker_app_index_strip_field_codes(char *cmdline_ptr)
+{
+    char *dest_ptr = cmdline_ptr;
+    for (const char *src_ptr = cmdline_ptr; '\0' != *src_ptr; ++src_ptr) {
+        if ('%' != *src_ptr) {
+            *dest_ptr++ = *src_ptr;
+        } else if ('%' == src_ptr[1]) {
+            *dest_ptr++ = '%';
+            ++src_ptr;
+        } else if ('\0' != src_ptr[1]) {
+            ++src_ptr;
+        }
+    }
+    while (dest_ptr > cmdline_ptr && ' ' == dest_ptr[-1]) --dest_ptr;
+    *dest_ptr = '\0';
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles the event fd: Applies all results, on the main thread. */
+int _wlmaker_app_index_handle_done(
+    int fd,
+    __UNUSED__ uint32_t mask,
+    void *data_ptr)
+{
+    wlmaker_app_index_t *app_index_ptr = data_ptr;
+    uint64_t value;
+    if (0 > read(fd, &value, sizeof(value)) && EAGAIN != errno) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed read(%d, ...)", fd);
+    }
+
+    pthread_mutex_lock(&app_index_ptr->mutex);
+    bs_dllist_t done = app_index_ptr->done;
+    app_index_ptr->done = (bs_dllist_t){};
+    pthread_mutex_unlock(&app_index_ptr->mutex);
+
+    bool changed = false;
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&done))) {
+        changed |= _wlmaker_app_index_apply(
+            app_index_ptr,
+            BS_CONTAINER_OF(dlnode_ptr, _wlmaker_app_index_result_t, dlnode));
+    }
+    if (changed) wl_signal_emit(&app_index_ptr->events.changed, NULL);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles inotify events: Enqueues a re-parse for each desktop file that
+ * changed, or a full re-scan if the event queue overflowed.
+ *
+ * Sub-directories are scanned initially, but not watched.
+ */
+int _wlmaker_app_index_handle_inotify(
+    int fd,
+    __UNUSED__ uint32_t mask,
+    void *data_ptr)
+{
+    wlmaker_app_index_t *app_index_ptr = data_ptr;
+    char buf[4096]
+        __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    ssize_t len;
+    while (0 < (len = read(fd, buf, sizeof(buf)))) {
+        char *ptr = buf;
+        while (ptr < buf + len) {
+            const struct inotify_event *event_ptr =
+                (const struct inotify_event*)ptr;
+            ptr += sizeof(struct inotify_event) + event_ptr->len;
+
+            if (event_ptr->mask & IN_Q_OVERFLOW) {
+                for (size_t i = 0; i < app_index_ptr->num_dirs; ++i) {
+                    _wlmaker_app_index_enqueue(app_index_ptr, i, NULL);
+                }
+                continue;
+            }
+            if (0 == event_ptr->len) continue;
+            size_t name_len = strlen(event_ptr->name);
+            if (8 >= name_len ||
+                0 != strcmp(event_ptr->name + name_len - 8, ".desktop")) {
+                continue;
+            }
+            for (size_t i = 0; i < app_index_ptr->num_dirs; ++i) {
+                if (app_index_ptr->wd_ptr[i] != event_ptr->wd) continue;
+                _wlmaker_app_index_enqueue(app_index_ptr, i, event_ptr->name);
+            }
+        }
+    }
+    if (0 > len && EAGAIN != errno) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed read(%d, ...)", fd);
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Applies a result to the index. Takes ownership of `result_ptr`.
+ *
+ * @param app_index_ptr
+ * @param result_ptr
+ *
+ * @return true if the index changed.
+ */
+bool _wlmaker_app_index_apply(
+    wlmaker_app_index_t *app_index_ptr,
+    _wlmaker_app_index_result_t *result_ptr)
+{
+    bool changed = false;
+    if (NULL == result_ptr->key.id_ptr) {
+        bs_dllist_node_t *dlnode_ptr = app_index_ptr->entries.head_ptr;
+        while (NULL != dlnode_ptr) {
+            _wlmaker_app_index_entry_t *entry_ptr = BS_CONTAINER_OF(
+                dlnode_ptr, _wlmaker_app_index_entry_t, dlnode);
+            dlnode_ptr = dlnode_ptr->next_ptr;
+            if (entry_ptr->key.dir_index != result_ptr->key.dir_index) {
+                continue;
+            }
+            _wlmaker_app_index_entry_remove(app_index_ptr, entry_ptr);
+            changed = true;
+        }
+        _wlmaker_app_index_result_destroy(result_ptr);
+        return changed;
+    }
+
+    bs_avltree_node_t *avlnode_ptr = bs_avltree_lookup(
+        app_index_ptr->tree_ptr, &result_ptr->key);
+    if (NULL != avlnode_ptr) {
+        _wlmaker_app_index_entry_remove(
+            app_index_ptr,
+            BS_CONTAINER_OF(avlnode_ptr, _wlmaker_app_index_entry_t,
+                            avlnode));
+        changed = true;
+    }
+
+    if (result_ptr->present) {
+        _wlmaker_app_index_entry_t *entry_ptr = logged_calloc(
+            1, sizeof(_wlmaker_app_index_entry_t));
+        if (NULL != entry_ptr) {
+            // Moves the strings from the result into the entry.
+            entry_ptr->key = result_ptr->key;
+            entry_ptr->visible = result_ptr->visible;
+            entry_ptr->name_ptr = result_ptr->name_ptr;
+            entry_ptr->cmdline_ptr = result_ptr->cmdline_ptr;
+            *result_ptr = (_wlmaker_app_index_result_t){};
+            BS_ASSERT(bs_avltree_insert(
+                          app_index_ptr->tree_ptr, &entry_ptr->key,
+                          &entry_ptr->avlnode, false));
+            bs_dllist_push_back(&app_index_ptr->entries, &entry_ptr->dlnode);
+            changed = true;
+        }
+    }
+    _wlmaker_app_index_result_destroy(result_ptr);
+    return changed;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Removes the entry from the index, and destroys it. */
+void _wlmaker_app_index_entry_remove(
+    wlmaker_app_index_t *app_index_ptr,
+    _wlmaker_app_index_entry_t *entry_ptr)
+{
+    bs_avltree_delete(app_index_ptr->tree_ptr, &entry_ptr->key);
+    bs_dllist_remove(&app_index_ptr->entries, &entry_ptr->dlnode);
+    free((char*)entry_ptr->key.id_ptr);
+    if (NULL != entry_ptr->name_ptr) free(entry_ptr->name_ptr);
+    if (NULL != entry_ptr->cmdline_ptr) free(entry_ptr->cmdline_ptr);
+    free(entry_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Compares @ref _wlmaker_app_index_entry_t::key with a key. */
+int _wlmaker_app_index_entry_cmp(
+    const bs_avltree_node_t *avlnode_ptr,
+    const void *key_ptr)
+{
+    const _wlmaker_app_index_key_t *k1_ptr = &BS_CONTAINER_OF(
+        avlnode_ptr, _wlmaker_app_index_entry_t, avlnode)->key;
+    const _wlmaker_app_index_key_t *k2_ptr = key_ptr;
+    int rv = strcmp(k1_ptr->id_ptr, k2_ptr->id_ptr);
+    if (0 != rv) return rv;
+    if (k1_ptr->dir_index < k2_ptr->dir_index) return -1;
+    return k1_ptr->dir_index > k2_ptr->dir_index ? 1 : 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** qsort comparator: Orders entries by name, then by desktop file ID. */
+int _wlmaker_app_index_entry_name_cmp(const void *a_ptr, const void *b_ptr)
+{
+    const _wlmaker_app_index_entry_t *e1_ptr =
+        *(_wlmaker_app_index_entry_t* const*)a_ptr;
+    const _wlmaker_app_index_entry_t *e2_ptr =
+        *(_wlmaker_app_index_entry_t* const*)b_ptr;
+    int rv = strcasecmp(e1_ptr->name_ptr, e2_ptr->name_ptr);
+    if (0 != rv) return rv;
+    return strcmp(e1_ptr->key.id_ptr, e2_ptr->key.id_ptr);
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlmaker_app_index_test_parse(bs_test_t *test_ptr);
+static void _wlmaker_app_index_test_index(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_app_index_test_cases[] = {
+    { 1, "parse", _wlmaker_app_index_test_parse },
+    { 1, "index", _wlmaker_app_index_test_index },
+    { 0, NULL, NULL }
+};
+
+/** Test helper: Collects the reported applications into a string. */
+typedef struct {
+    /** Concatenation of `name:cmdline;` of each application. */
+    char                      buf[256];
+} _wlmaker_app_index_test_collect_t;
+
+/* ------------------------------------------------------------------------- */
+/** Test helper: Implements @ref wlmaker_app_index_callback_t. */
+static void _wlmaker_app_index_test_collect(
+    const char *name_ptr,
+    const char *cmdline_ptr,
+    void *userdata_ptr)
+{
+    _wlmaker_app_index_test_collect_t *c_ptr = userdata_ptr;
+    size_t len = strlen(c_ptr->buf);
+    snprintf(c_ptr->buf + len, sizeof(c_ptr->buf) - len, "%s:%s;",
+             name_ptr, cmdline_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Test helper: Writes `data_ptr` into `dir_ptr`/`name_ptr`. */
+static bool _wlmaker_app_index_test_write(
+    const char *dir_ptr,
+    const char *name_ptr,
+    const char *data_ptr)
+{
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s", dir_ptr, name_ptr);
+    FILE *file_ptr = fopen(path, "w");
+    if (NULL == file_ptr) return false;
+    bool rv = 0 <= fputs(data_ptr, file_ptr);
+    return 0 == fclose(file_ptr) && rv;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Test helper: Dispatches `loop_ptr` until the index reports `n` apps. */
+static size_t _wlmaker_app_index_test_wait(
+    struct wl_event_loop *loop_ptr,
+    wlmaker_app_index_t *app_index_ptr,
+    size_t n,
+    _wlmaker_app_index_test_collect_t *c_ptr)
+{
+    size_t rv = 0;
+    for (int i = 0; i < 100; ++i) {
+        wl_event_loop_dispatch(loop_ptr, 10);
+        *c_ptr = (_wlmaker_app_index_test_collect_t){};
+        rv = wlmaker_app_index_for_each(
+            app_index_ptr, _wlmaker_app_index_test_collect, c_ptr);
+        if (rv == n) break;
+    }
+    return rv;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests parsing of desktop entries. */
+void _wlmaker_app_index_test_parse(bs_test_t *test_ptr)
+{
+    const char *d_ptr =
+        "# Comment\n"
+        "[Desktop Entry]\n"
+        "Type=Application\n"
+        "Name=Text\\sEditor\n"
+        "Name[de]=Texteditor\n"
+        "Exec = edit --new %U 100%%\n"
+        "\n"
+        "[Desktop Action Other]\n"
+        "Name=Other\n";
+    FILE *file_ptr = fmemopen((void*)d_ptr, strlen(d_ptr), "r");
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, file_ptr);
+    _wlmaker_app_index_result_t r = {};
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmaker_app_index_parse(file_ptr, &r));
+    fclose(file_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, r.visible);
+    BS_TEST_VERIFY_STREQ(test_ptr, "Text Editor", r.name_ptr);
+    BS_TEST_VERIFY_STREQ(test_ptr, "edit --new  100%", r.cmdline_ptr);
+    free(r.name_ptr);
+    free(r.cmdline_ptr);
+
+    // Hidden: Present, but not visible.
+    d_ptr = "[Desktop Entry]\nType=Application\nName=A\nExec=a\nHidden=true\n";
+    file_ptr = fmemopen((void*)d_ptr, strlen(d_ptr), "r");
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, file_ptr);
+    r = (_wlmaker_app_index_result_t){};
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmaker_app_index_parse(file_ptr, &r));
+    fclose(file_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, r.visible);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, r.name_ptr);
+
+    // Not an application.
+    d_ptr = "[Desktop Entry]\nType=Link\nName=A\nURL=http://example.com\n";
+    file_ptr = fmemopen((void*)d_ptr, strlen(d_ptr), "r");
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, file_ptr);
+    r = (_wlmaker_app_index_result_t){};
+    BS_TEST_VERIFY_FALSE(test_ptr, _wlmaker_app_index_parse(file_ptr, &r));
+    fclose(file_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests initial scan, masking, and incremental updates through inotify. */
+void _wlmaker_app_index_test_index(bs_test_t *test_ptr)
+{
+    char d1[] = "/tmp/wlmaker_app_index_test_XXXXXX";
+    char d2[] = "/tmp/wlmaker_app_index_test_XXXXXX";
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, mkdtemp(d1));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, mkdtemp(d2));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, _wlmaker_app_index_test_write(
+            d1, "b.desktop",
+            "[Desktop Entry]\nType=Application\nName=B\nExec=b1\n"));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, _wlmaker_app_index_test_write(
+            d2, "b.desktop",
+            "[Desktop Entry]\nType=Application\nName=B\nExec=b2\n"));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, _wlmaker_app_index_test_write(
+            d2, "c.desktop",
+            "[Desktop Entry]\nType=Application\nName=c\nExec=c %f\n"));
+
+    struct wl_event_loop *loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, loop_ptr);
+    const char *dir_ptrs[] = { d1, d2, NULL };
+    wlmaker_app_index_t *app_index_ptr = wlmaker_app_index_create(
+        loop_ptr, dir_ptrs);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, app_index_ptr);
+
+    // d1/b.desktop masks d2/b.desktop.
+    _wlmaker_app_index_test_collect_t c;
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 2,
+        _wlmaker_app_index_test_wait(loop_ptr, app_index_ptr, 2, &c));
+    BS_TEST_VERIFY_STREQ(test_ptr, "B:b1;c:c;", c.buf);
+
+    // Adding a file: Picked up through inotify.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, _wlmaker_app_index_test_write(
+            d2, "a.desktop",
+            "[Desktop Entry]\nType=Application\nName=A\nExec=a\n"));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 3,
+        _wlmaker_app_index_test_wait(loop_ptr, app_index_ptr, 3, &c));
+    BS_TEST_VERIFY_STREQ(test_ptr, "A:a;B:b1;c:c;", c.buf);
+
+    // Removing the masking file: d2/b.desktop shows.
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/b.desktop", d1);
+    unlink(path);
+    for (int i = 0; i < 100 && NULL == strstr(c.buf, "b2"); ++i) {
+        _wlmaker_app_index_test_wait(loop_ptr, app_index_ptr, 3, &c);
+    }
+    BS_TEST_VERIFY_STREQ(test_ptr, "A:a;B:b2;c:c;", c.buf);
+
+    wlmaker_app_index_destroy(app_index_ptr);
+    wl_event_loop_destroy(loop_ptr);
+
+    const char *names[] = { "a.desktop", "b.desktop", "c.desktop", NULL };
+    for (const char **n_ptr = names; NULL != *n_ptr; ++n_ptr) {
+        snprintf(path, sizeof(path), "%s/%s", d2, *n_ptr);
+        unlink(path);
+    }
+    rmdir(d1);
+    rmdir(d2);
+}
+
+/* == End of app_index.c =================================================== */
@@ -0,0 +1,110 @@
+/* ========================================================================= */
+/**
+ * @file app_index.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __APP_INDEX_H__
+#define __APP_INDEX_H__
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <wayland-server-core.h>
+
+/** Forward declaration: Index of installed applications. */
+typedef struct _wlmaker_app_index_t wlmaker_app_index_t;
+
+/** Events of the application index. */
+typedef struct {
+    /** Applications were added, removed or updated. */
+    struct wl_signal          changed;
+} wlmaker_app_index_events_t;
+
+/**
+ * Callback for @ref wlmaker_app_index_for_each.
+ *
+ * @param name_ptr            Name of the application, from `Name`.
+ * @param cmdline_ptr         Command line, from `Exec`, with field codes
+ *                            removed.
+ * @param userdata_ptr
+ */
+typedef void (*wlmaker_app_index_callback_t)(
+    const char *name_ptr,
+    const char *cmdline_ptr,
+    void *userdata_ptr);
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Creates the index of the applications installed as .desktop files.
+ *
+ * The directories are scanned on a worker thread, and then watched through
+ * inotify. Files added, modified or removed are re-parsed on the worker
+ * thread, and the index is updated incrementally. Scanning and parsing
+ * never happen on the event loop.
+ *
+ * @param wl_event_loop_ptr
+ * @param dir_ptrs            NULL-terminated array of the directories to
+ *                            index, in order of priority. If NULL, uses the
+ *                            `applications` directories of `$XDG_DATA_HOME`
+ *                            and `$XDG_DATA_DIRS`.
+ *
+ * @return A pointer to the index, or NULL on error.
+ */
+wlmaker_app_index_t *wlmaker_app_index_create(
+    struct wl_event_loop *wl_event_loop_ptr,
+    const char **dir_ptrs);
+
+/**
+ * Destroys the index. Stops the worker thread.
+ *
+ * @param app_index_ptr
+ */
+void wlmaker_app_index_destroy(wlmaker_app_index_t *app_index_ptr);
+
+/** @return Pointer to @ref wlmaker_app_index_events_t of the index. */
+wlmaker_app_index_events_t *wlmaker_app_index_events(
+    wlmaker_app_index_t *app_index_ptr);
+
+/**
+ * Calls `callback` for each application, in order of the name.
+ *
+ * Entries of the same desktop file ID in directories of lower priority are
+ * masked. Entries with `NoDisplay` or `Hidden` are not reported.
+ *
+ * @param app_index_ptr
+ * @param callback
+ * @param userdata_ptr
+ *
+ * @return Number of applications reported.
+ */
+size_t wlmaker_app_index_for_each(
+    wlmaker_app_index_t *app_index_ptr,
+    wlmaker_app_index_callback_t callback,
+    void *userdata_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_app_index_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __APP_INDEX_H__ */
+/* == End of app_index.h =================================================== */
@@ -0,0 +1,731 @@
+/* ========================================================================= */
+/**
+ * @file autostart.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "autostart.h"
+
+#include <libbase/libbase.h>
+#include <libbase/plist.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <wayland-server-core.h>
+
+/* == Declarations ========================================================= */
+
+/** State of an autostarted command. */
+typedef enum {
+    WLMAKER_AUTOSTART_PENDING,
+    WLMAKER_AUTOSTART_STARTED,
+    WLMAKER_AUTOSTART_READY
+} wlmaker_autostart_state_t;
+
+/** Forward declaration: An autostarted command. */
+typedef struct _wlmaker_autostart_entry_t wlmaker_autostart_entry_t;
+
+/** An autostarted command. */
+struct _wlmaker_autostart_entry_t {
+    /** Command line to start. */
+    char                      *command_ptr;
+    /** Name, for other commands to refer to in `After`. May be empty. */
+    char                      *name_ptr;
+    /** Priority. Commands with a higher priority are started first. */
+    uint64_t                  priority;
+    /** Name of the command this command is started after. May be empty. */
+    char                      *after_ptr;
+
+    /** Back-link to the scheduler. */
+    wlmaker_autostart_t       *autostart_ptr;
+    /** The command named by `after_ptr`, or NULL. */
+    wlmaker_autostart_entry_t *after_entry_ptr;
+    /** State of the command. */
+    wlmaker_autostart_state_t state;
+    /** When the command was started, in msec of CLOCK_MONOTONIC. */
+    uint64_t                  started_msec;
+    /** Handle of the started command, until it terminates. */
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr;
+};
+
+/** State of the autostart scheduler. */
+struct _wlmaker_autostart_t {
+    /** Subprocess monitor, to entrust the started commands to. */
+    wlmaker_subprocess_monitor_t *monitor_ptr;
+    /** The commands, in order of the configuration. */
+    wlmaker_autostart_entry_t *entries_ptr;
+    /** Number of elements in `entries_ptr`. */
+    size_t                    entries;
+
+    /** Commands started but not yet ready, at most. 0 for no limit. */
+    uint64_t                  concurrency;
+    /** Delay between starting two commands. */
+    uint64_t                  stagger_msec;
+    /** After which a started command counts as ready. 0 for never. */
+    uint64_t                  ready_timeout_msec;
+
+    /** Whether any command was started yet. */
+    bool                      started_any;
+    /** When the last command was started, in msec of CLOCK_MONOTONIC. */
+    uint64_t                  last_started_msec;
+
+    /** Idle event source, for starting the first commands. */
+    struct wl_event_source    *idle_event_source_ptr;
+    /** Timer, for staggering and the ready timeout. */
+    struct wl_event_source    *timer_event_source_ptr;
+};
+
+static bool _wlmaker_autostart_configure(
+    wlmaker_autostart_t *autostart_ptr,
+    bspl_array_t *array_ptr,
+    bspl_dict_t *schedule_dict_ptr);
+static void _wlmaker_autostart_unconfigure(
+    wlmaker_autostart_t *autostart_ptr);
+static bool _wlmaker_autostart_entry_init(
+    wlmaker_autostart_entry_t *entry_ptr,
+    bspl_object_t *object_ptr);
+static void _wlmaker_autostart_resolve(wlmaker_autostart_t *autostart_ptr);
+static wlmaker_autostart_entry_t *_wlmaker_autostart_next(
+    wlmaker_autostart_t *autostart_ptr,
+    uint64_t now_msec,
+    uint64_t *delay_msec_ptr);
+static void _wlmaker_autostart_mark_started(
+    wlmaker_autostart_entry_t *entry_ptr,
+    uint64_t now_msec);
+static void _wlmaker_autostart_run(wlmaker_autostart_t *autostart_ptr);
+static void _wlmaker_autostart_launch(
+    wlmaker_autostart_entry_t *entry_ptr,
+    uint64_t now_msec);
+static void _wlmaker_autostart_set_ready(
+    wlmaker_autostart_entry_t *entry_ptr);
+static uint64_t _wlmaker_autostart_now_msec(void);
+
+static void _wlmaker_autostart_handle_idle(void *data_ptr);
+static int _wlmaker_autostart_handle_timer(void *data_ptr);
+static void _wlmaker_autostart_handle_terminated(
+    void *userdata_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    int state,
+    int code);
+static void _wlmaker_autostart_handle_window_mapped(
+    void *userdata_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    wlmtk_window_t *window_ptr);
+
+/* == Data ================================================================= */
+
+/** Descriptor of an autostarted command, in the `Autostart` array. */
+static const bspl_desc_t _wlmaker_autostart_entry_desc[] = {
+    BSPL_DESC_STRING(
+        "Command", true, wlmaker_autostart_entry_t,
+        command_ptr, command_ptr, ""),
+    BSPL_DESC_STRING(
+        "Name", false, wlmaker_autostart_entry_t, name_ptr, name_ptr, ""),
+    BSPL_DESC_UINT64(
+        "Priority", false, wlmaker_autostart_entry_t,
+        priority, priority, 0),
+    BSPL_DESC_STRING(
+        "After", false, wlmaker_autostart_entry_t, after_ptr, after_ptr, ""),
+    BSPL_DESC_SENTINEL(),
+};
+
+/** Descriptor of the `AutostartSchedule` dict. */
+static const bspl_desc_t _wlmaker_autostart_schedule_desc[] = {
+    BSPL_DESC_UINT64(
+        "Concurrency", false, wlmaker_autostart_t,
+        concurrency, concurrency, 2),
+    BSPL_DESC_UINT64(
+        "StaggerMsec", false, wlmaker_autostart_t,
+        stagger_msec, stagger_msec, 100),
+    BSPL_DESC_UINT64(
+        "ReadyTimeoutMsec", false, wlmaker_autostart_t,
+        ready_timeout_msec, ready_timeout_msec, 5000),
+    BSPL_DESC_SENTINEL(),
+};
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmaker_autostart_t *wlmaker_autostart_create(
+    struct wl_event_loop *wl_event_loop_ptr,
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    bspl_array_t *array_ptr,
+    bspl_dict_t *schedule_dict_ptr)
+{
+    wlmaker_autostart_t *autostart_ptr = logged_calloc(
+        1, sizeof(wlmaker_autostart_t));
+    if (NULL == autostart_ptr) return NULL;
+    autostart_ptr->monitor_ptr = monitor_ptr;
+
+    if (!_wlmaker_autostart_configure(
+            autostart_ptr, array_ptr, schedule_dict_ptr)) {
+        wlmaker_autostart_destroy(autostart_ptr);
+        return NULL;
+    }
+
+    autostart_ptr->timer_event_source_ptr = wl_event_loop_add_timer(
+        wl_event_loop_ptr, _wlmaker_autostart_handle_timer, autostart_ptr);
+    if (NULL == autostart_ptr->timer_event_source_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_timer(%p, %p, %p)",
+               wl_event_loop_ptr, _wlmaker_autostart_handle_timer,
+               autostart_ptr);
+        wlmaker_autostart_destroy(autostart_ptr);
+        return NULL;
+    }
+    // Idle events run in order: Starts after the first frames are rendered.
+    autostart_ptr->idle_event_source_ptr = wl_event_loop_add_idle(
+        wl_event_loop_ptr, _wlmaker_autostart_handle_idle, autostart_ptr);
+    if (NULL == autostart_ptr->idle_event_source_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_idle(%p, %p, %p)",
+               wl_event_loop_ptr, _wlmaker_autostart_handle_idle,
+               autostart_ptr);
+        wlmaker_autostart_destroy(autostart_ptr);
+        return NULL;
+    }
+    return autostart_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_autostart_destroy(wlmaker_autostart_t *autostart_ptr)
+{
+    if (NULL != autostart_ptr->idle_event_source_ptr) {
+        wl_event_source_remove(autostart_ptr->idle_event_source_ptr);
+        autostart_ptr->idle_event_source_ptr = NULL;
+    }
+    if (NULL != autostart_ptr->timer_event_source_ptr) {
+        wl_event_source_remove(autostart_ptr->timer_event_source_ptr);
+        autostart_ptr->timer_event_source_ptr = NULL;
+    }
+
+    for (size_t i = 0; i < autostart_ptr->entries; ++i) {
+        wlmaker_autostart_entry_t *entry_ptr = &autostart_ptr->entries_ptr[i];
+        if (NULL == entry_ptr->subprocess_handle_ptr) continue;
+        wlmaker_subprocess_monitor_cede(
+            autostart_ptr->monitor_ptr, entry_ptr->subprocess_handle_ptr);
+        entry_ptr->subprocess_handle_ptr = NULL;
+    }
+    _wlmaker_autostart_unconfigure(autostart_ptr);
+    free(autostart_ptr);
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Decodes the commands and the schedule.
+ *
+ * @param autostart_ptr
+ * @param array_ptr
+ * @param schedule_dict_ptr   May be NULL.
+ *
+ * @return true on success.
+ */
+bool _wlmaker_autostart_configure(
+    wlmaker_autostart_t *autostart_ptr,
+    bspl_array_t *array_ptr,
+    bspl_dict_t *schedule_dict_ptr)
+{
+    // Decoding an empty dict applies the defaults.
+    bspl_dict_t *empty_dict_ptr = NULL;
+    if (NULL == schedule_dict_ptr) {
+        empty_dict_ptr = bspl_dict_create();
+        if (NULL == empty_dict_ptr) return false;
+        schedule_dict_ptr = empty_dict_ptr;
+    }
+    bool rv = bspl_decode_dict(
+        schedule_dict_ptr, _wlmaker_autostart_schedule_desc, autostart_ptr);
+    if (NULL != empty_dict_ptr) bspl_dict_unref(empty_dict_ptr);
+    if (!rv) {
+        bs_log(BS_ERROR, "Failed to decode 'AutostartSchedule' dict.");
+        return false;
+    }
+
+    size_t entries = bspl_array_size(array_ptr);
+    if (0 == entries) return true;
+    autostart_ptr->entries_ptr = logged_calloc(
+        entries, sizeof(wlmaker_autostart_entry_t));
+    if (NULL == autostart_ptr->entries_ptr) return false;
+    for (size_t i = 0; i < entries; ++i) {
+        // Counted before decoding: A partially decoded entry gets released.
+        wlmaker_autostart_entry_t *entry_ptr = &autostart_ptr->entries_ptr[i];
+        autostart_ptr->entries = i + 1;
+        entry_ptr->autostart_ptr = autostart_ptr;
+        if (!_wlmaker_autostart_entry_init(
+                entry_ptr, bspl_array_at(array_ptr, i))) {
+            bs_log(BS_ERROR, "Failed to decode element %zu of 'Autostart'.",
+                   i);
+            return false;
+        }
+    }
+    _wlmaker_autostart_resolve(autostart_ptr);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Releases the decoded commands. Inverse of `_configure`. */
+void _wlmaker_autostart_unconfigure(wlmaker_autostart_t *autostart_ptr)
+{
+    for (size_t i = 0; i < autostart_ptr->entries; ++i) {
+        bspl_decoded_destroy(_wlmaker_autostart_entry_desc,
+                             &autostart_ptr->entries_ptr[i]);
+    }
+    autostart_ptr->entries = 0;
+    if (NULL != autostart_ptr->entries_ptr) {
+        free(autostart_ptr->entries_ptr);
+        autostart_ptr->entries_ptr = NULL;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Decodes a command from the `Autostart` array: A plain string with the
+ * command line, or a dict.
+ *
+ * @param entry_ptr
+ * @param object_ptr
+ *
+ * @return true on success.
+ */
+bool _wlmaker_autostart_entry_init(
+    wlmaker_autostart_entry_t *entry_ptr,
+    bspl_object_t *object_ptr)
+{
+    bspl_string_t *string_ptr = bspl_string_from_object(object_ptr);
+    if (NULL != string_ptr) {
+        entry_ptr->command_ptr = logged_strdup(bspl_string_value(string_ptr));
+        entry_ptr->name_ptr = logged_strdup("");
+        entry_ptr->after_ptr = logged_strdup("");
+        return (NULL != entry_ptr->command_ptr &&
+                NULL != entry_ptr->name_ptr &&
+                NULL != entry_ptr->after_ptr);
+    }
+
+    bspl_dict_t *dict_ptr = bspl_dict_from_object(object_ptr);
+    if (NULL == dict_ptr) return false;
+    return bspl_decode_dict(
+        dict_ptr, _wlmaker_autostart_entry_desc, entry_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Resolves the `After` names of all commands. Unknown names, and
+ * dependencies that would form a cycle, are dropped with a warning.
+ *
+ * @param autostart_ptr
+ */
+void _wlmaker_autostart_resolve(wlmaker_autostart_t *autostart_ptr)
+{
+    for (size_t i = 0; i < autostart_ptr->entries; ++i) {
+        wlmaker_autostart_entry_t *entry_ptr = &autostart_ptr->entries_ptr[i];
+        if (0 == *entry_ptr->after_ptr) continue;
+
+        for (size_t j = 0; j < autostart_ptr->entries; ++j) {
+            wlmaker_autostart_entry_t *e_ptr = &autostart_ptr->entries_ptr[j];
+            if (0 == strcmp(entry_ptr->after_ptr, e_ptr->name_ptr)) {
+                entry_ptr->after_entry_ptr = e_ptr;
+                break;
+            }
+        }
+        if (NULL == entry_ptr->after_entry_ptr) {
+            bs_log(BS_WARNING, "Autostart \"%s\": No command named \"%s\", "
+                   "starting without.",
+                   entry_ptr->command_ptr, entry_ptr->after_ptr);
+            continue;
+        }
+
+        // Each command has at most one dependency: A cycle is found by
+        // following the chain for at most as many steps as there are.
+        wlmaker_autostart_entry_t *e_ptr = entry_ptr->after_entry_ptr;
+        for (size_t steps = 0;
+             NULL != e_ptr && steps < autostart_ptr->entries;
+             ++steps) {
+            if (e_ptr == entry_ptr) break;
+            e_ptr = e_ptr->after_entry_ptr;
+        }
+        if (e_ptr == entry_ptr) {
+            bs_log(BS_WARNING, "Autostart \"%s\": Dependency on \"%s\" is "
+                   "cyclic, starting without.",
+                   entry_ptr->command_ptr, entry_ptr->after_ptr);
+            entry_ptr->after_entry_ptr = NULL;
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Determines the command to start next.
+ *
+ * Started commands that exceeded the ready timeout are marked as ready.
+ * Of the pending commands whose dependency is ready, returns the one of
+ * the highest priority, and the first configured if several are on par.
+ * Provided the concurrency limit and the stagger permit it.
+ *
+ * @param autostart_ptr
+ * @param now_msec
+ * @param delay_msec_ptr      Set to the delay until the scheduler must be
+ *                            visited again, if NULL is returned. 0 if only
+ *                            a command getting ready may change the result.
+ *
+ * @return The command to start now, or NULL.
+ */
+wlmaker_autostart_entry_t *_wlmaker_autostart_next(
+    wlmaker_autostart_t *autostart_ptr,
+    uint64_t now_msec,
+    uint64_t *delay_msec_ptr)
+{
+    uint64_t deadline_msec = UINT64_MAX;
+    size_t started = 0;
+    wlmaker_autostart_entry_t *next_entry_ptr = NULL;
+    for (size_t i = 0; i < autostart_ptr->entries; ++i) {
+        wlmaker_autostart_entry_t *entry_ptr = &autostart_ptr->entries_ptr[i];
+        if (WLMAKER_AUTOSTART_STARTED == entry_ptr->state &&
+            0 < autostart_ptr->ready_timeout_msec) {
+            uint64_t ready_msec =
+                entry_ptr->started_msec + autostart_ptr->ready_timeout_msec;
+            if (ready_msec <= now_msec) {
+                bs_log(BS_DEBUG, "Autostart \"%s\": Considered ready after "
+                       "timeout.", entry_ptr->command_ptr);
+                entry_ptr->state = WLMAKER_AUTOSTART_READY;
+            } else {
+                deadline_msec = BS_MIN(deadline_msec, ready_msec);
+            }
+        }
+        if (WLMAKER_AUTOSTART_STARTED == entry_ptr->state) ++started;
+    }
+
+    for (size_t i = 0; i < autostart_ptr->entries; ++i) {
+        wlmaker_autostart_entry_t *entry_ptr = &autostart_ptr->entries_ptr[i];
+        if (WLMAKER_AUTOSTART_PENDING != entry_ptr->state) continue;
+        if (NULL != entry_ptr->after_entry_ptr &&
+            WLMAKER_AUTOSTART_READY != entry_ptr->after_entry_ptr->state) {
+            continue;
+        }
+        if (NULL == next_entry_ptr ||
+            entry_ptr->priority > next_entry_ptr->priority) {
+            next_entry_ptr = entry_ptr;
+        }
+    }
+
+    if (NULL != next_entry_ptr &&
+        (0 == autostart_ptr->concurrency ||
+         started < autostart_ptr->concurrency)) {
+        uint64_t start_msec =
+            autostart_ptr->last_started_msec + autostart_ptr->stagger_msec;
+        if (!autostart_ptr->started_any || start_msec <= now_msec) {
+            return next_entry_ptr;
+        }
+        deadline_msec = BS_MIN(deadline_msec, start_msec);
+    }
+
+    *delay_msec_ptr = 0;
+    if (UINT64_MAX != deadline_msec) {
+        *delay_msec_ptr = deadline_msec - now_msec;
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Marks the command as started at `now_msec`. */
+void _wlmaker_autostart_mark_started(
+    wlmaker_autostart_entry_t *entry_ptr,
+    uint64_t now_msec)
+{
+    wlmaker_autostart_t *autostart_ptr = entry_ptr->autostart_ptr;
+    entry_ptr->state = WLMAKER_AUTOSTART_STARTED;
+    entry_ptr->started_msec = now_msec;
+    autostart_ptr->started_any = true;
+    autostart_ptr->last_started_msec = now_msec;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Starts all commands that are due, and arms the timer for the next. */
+void _wlmaker_autostart_run(wlmaker_autostart_t *autostart_ptr)
+{
+    uint64_t delay_msec = 0;
+    wlmaker_autostart_entry_t *entry_ptr;
+    for (;;) {
+        uint64_t now_msec = _wlmaker_autostart_now_msec();
+        entry_ptr = _wlmaker_autostart_next(
+            autostart_ptr, now_msec, &delay_msec);
+        if (NULL == entry_ptr) break;
+        _wlmaker_autostart_launch(entry_ptr, now_msec);
+    }
+    // A delay of 0 disarms the timer.
+    wl_event_source_timer_update(
+        autostart_ptr->timer_event_source_ptr,
+        (int)BS_MIN(delay_msec, (uint64_t)INT32_MAX));
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Starts the command and entrusts it to the monitor. A command that fails
+ * to start is considered ready, so that commands after it are not blocked.
+ *
+ * @param entry_ptr
+ * @param now_msec
+ */
+void _wlmaker_autostart_launch(
+    wlmaker_autostart_entry_t *entry_ptr,
+    uint64_t now_msec)
+{
+    wlmaker_autostart_t *autostart_ptr = entry_ptr->autostart_ptr;
+    _wlmaker_autostart_mark_started(entry_ptr, now_msec);
+
+    bs_subprocess_t *subprocess_ptr = bs_subprocess_create_cmdline(
+        entry_ptr->command_ptr);
+    if (NULL == subprocess_ptr) {
+        bs_log(BS_ERROR, "Failed bs_subprocess_create_cmdline(\"%s\")",
+               entry_ptr->command_ptr);
+        entry_ptr->state = WLMAKER_AUTOSTART_READY;
+        return;
+    }
+    if (!bs_subprocess_start(subprocess_ptr)) {
+        bs_log(BS_ERROR, "Failed bs_subprocess_start for \"%s\"",
+               entry_ptr->command_ptr);
+        bs_subprocess_destroy(subprocess_ptr);
+        entry_ptr->state = WLMAKER_AUTOSTART_READY;
+        return;
+    }
+
+    entry_ptr->subprocess_handle_ptr = wlmaker_subprocess_monitor_entrust(
+        autostart_ptr->monitor_ptr,
+        subprocess_ptr,
+        _wlmaker_autostart_handle_terminated,
+        entry_ptr,
+        NULL,
+        _wlmaker_autostart_handle_window_mapped,
+        NULL,
+        NULL);
+    if (NULL == entry_ptr->subprocess_handle_ptr) {
+        // Keeps running, untracked.
+        bs_log(BS_WARNING, "Failed wlmaker_subprocess_monitor_entrust for "
+               "\"%s\"", entry_ptr->command_ptr);
+        entry_ptr->state = WLMAKER_AUTOSTART_READY;
+        return;
+    }
+    bs_log(BS_INFO, "Autostart \"%s\": Started.", entry_ptr->command_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Marks a started command as ready, and re-visits the schedule from the
+ * event loop: Not from within the monitor's callbacks, since starting a
+ * command there would modify the monitor while it dispatches.
+ *
+ * @param entry_ptr
+ */
+void _wlmaker_autostart_set_ready(wlmaker_autostart_entry_t *entry_ptr)
+{
+    if (WLMAKER_AUTOSTART_STARTED != entry_ptr->state) return;
+    entry_ptr->state = WLMAKER_AUTOSTART_READY;
+    wl_event_source_timer_update(
+        entry_ptr->autostart_ptr->timer_event_source_ptr, 1);
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return The current time of CLOCK_MONOTONIC, in msec. */
+uint64_t _wlmaker_autostart_now_msec(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Starts the first commands. */
+void _wlmaker_autostart_handle_idle(void *data_ptr)
+{
+    wlmaker_autostart_t *autostart_ptr = data_ptr;
+    // Idle event sources are removed once dispatched.
+    autostart_ptr->idle_event_source_ptr = NULL;
+    _wlmaker_autostart_run(autostart_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Starts commands that are due after staggering, or a command got ready. */
+int _wlmaker_autostart_handle_timer(void *data_ptr)
+{
+    _wlmaker_autostart_run(data_ptr);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** A terminated command is ready. Its handle is destroyed after this. */
+void _wlmaker_autostart_handle_terminated(
+    void *userdata_ptr,
+    __UNUSED__ wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    int state,
+    int code)
+{
+    wlmaker_autostart_entry_t *entry_ptr = userdata_ptr;
+    bs_log(BS_DEBUG, "Autostart \"%s\": Terminated, status %d, signal %d.",
+           entry_ptr->command_ptr, state, code);
+    entry_ptr->subprocess_handle_ptr = NULL;
+    _wlmaker_autostart_set_ready(entry_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** A command that mapped its first window is ready. */
+void _wlmaker_autostart_handle_window_mapped(
+    void *userdata_ptr,
+    __UNUSED__ wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    __UNUSED__ wlmtk_window_t *window_ptr)
+{
+    _wlmaker_autostart_set_ready(userdata_ptr);
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlmaker_autostart_test_configure(bs_test_t *test_ptr);
+static void _wlmaker_autostart_test_schedule(bs_test_t *test_ptr);
+static void _wlmaker_autostart_test_cyclic(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_autostart_test_cases[] = {
+    { 1, "configure", _wlmaker_autostart_test_configure },
+    { 1, "schedule", _wlmaker_autostart_test_schedule },
+    { 1, "cyclic", _wlmaker_autostart_test_cyclic },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Decodes plain command lines and dicts, with the default schedule. */
+void _wlmaker_autostart_test_configure(bs_test_t *test_ptr)
+{
+    wlmaker_autostart_t autostart = {};
+    bspl_array_t *array_ptr = bspl_array_from_object(
+        bspl_create_object_from_plist_string(
+            "(a, {Command = b; Name = B; Priority = 5;}, "
+            "{Command = c; After = B;}, {Command = d; After = X;})"));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, array_ptr);
+    bool rv = _wlmaker_autostart_configure(&autostart, array_ptr, NULL);
+    bspl_array_unref(array_ptr);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, rv);
+
+    BS_TEST_VERIFY_EQ(test_ptr, 2, autostart.concurrency);
+    BS_TEST_VERIFY_EQ(test_ptr, 100, autostart.stagger_msec);
+    BS_TEST_VERIFY_EQ(test_ptr, 5000, autostart.ready_timeout_msec);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, 4 == autostart.entries);
+    wlmaker_autostart_entry_t *e_ptr = autostart.entries_ptr;
+    BS_TEST_VERIFY_STREQ(test_ptr, "a", e_ptr[0].command_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, e_ptr[0].priority);
+    BS_TEST_VERIFY_STREQ(test_ptr, "b", e_ptr[1].command_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 5, e_ptr[1].priority);
+    BS_TEST_VERIFY_EQ(test_ptr, &e_ptr[1], e_ptr[2].after_entry_ptr);
+    // An unknown dependency is dropped.
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, e_ptr[3].after_entry_ptr);
+    _wlmaker_autostart_unconfigure(&autostart);
+
+    // A dict without command fails.
+    array_ptr = bspl_array_from_object(
+        bspl_create_object_from_plist_string("({Name = B;})"));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, array_ptr);
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, _wlmaker_autostart_configure(&autostart, array_ptr, NULL));
+    bspl_array_unref(array_ptr);
+    _wlmaker_autostart_unconfigure(&autostart);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Orders by priority and dependency, and applies stagger & concurrency. */
+void _wlmaker_autostart_test_schedule(bs_test_t *test_ptr)
+{
+    wlmaker_autostart_t autostart = {};
+    bspl_array_t *array_ptr = bspl_array_from_object(
+        bspl_create_object_from_plist_string(
+            "(a, {Command = b; Name = B; Priority = 5;}, "
+            "{Command = c; After = B; Priority = 9;}, d)"));
+    bspl_dict_t *dict_ptr = bspl_dict_from_object(
+        bspl_create_object_from_plist_string(
+            "{Concurrency = 2; StaggerMsec = 100; ReadyTimeoutMsec = 1000;}"));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, array_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, dict_ptr);
+    bool rv = _wlmaker_autostart_configure(&autostart, array_ptr, dict_ptr);
+    bspl_dict_unref(dict_ptr);
+    bspl_array_unref(array_ptr);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, rv);
+    wlmaker_autostart_entry_t *e_ptr = autostart.entries_ptr;
+    wlmaker_autostart_entry_t *n_ptr;
+    uint64_t delay = 42;
+
+    // The first command starts right away. 'c' must wait for 'b'.
+    n_ptr = _wlmaker_autostart_next(&autostart, 1000, &delay);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, &e_ptr[1] == n_ptr);
+    _wlmaker_autostart_mark_started(n_ptr, 1000);
+
+    // Staggered: 'a' is next, in 100ms.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL, _wlmaker_autostart_next(&autostart, 1050, &delay));
+    BS_TEST_VERIFY_EQ(test_ptr, 50, delay);
+    n_ptr = _wlmaker_autostart_next(&autostart, 1100, &delay);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, &e_ptr[0] == n_ptr);
+    _wlmaker_autostart_mark_started(n_ptr, 1100);
+
+    // At the concurrency limit: Waits for the ready timeout of 'b'.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL, _wlmaker_autostart_next(&autostart, 1500, &delay));
+    BS_TEST_VERIFY_EQ(test_ptr, 500, delay);
+
+    // 'b' got ready: 'c' goes before 'd', by priority.
+    e_ptr[1].state = WLMAKER_AUTOSTART_READY;
+    n_ptr = _wlmaker_autostart_next(&autostart, 1500, &delay);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, &e_ptr[2] == n_ptr);
+    _wlmaker_autostart_mark_started(n_ptr, 1500);
+
+    // 'a' times out at 2100, permitting 'd'.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL, _wlmaker_autostart_next(&autostart, 1600, &delay));
+    BS_TEST_VERIFY_EQ(test_ptr, 500, delay);
+    n_ptr = _wlmaker_autostart_next(&autostart, 2100, &delay);
+    BS_TEST_VERIFY_EQ(test_ptr, WLMAKER_AUTOSTART_READY, e_ptr[0].state);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, &e_ptr[3] == n_ptr);
+    _wlmaker_autostart_mark_started(n_ptr, 2100);
+
+    // Nothing pending. Only 'c' and 'd' still have timeouts.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL, _wlmaker_autostart_next(&autostart, 3100, &delay));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, delay);
+
+    _wlmaker_autostart_unconfigure(&autostart);
+}
+
+/* ------------------------------------------------------------------------- */
+/** A cyclic dependency is broken up, rather than blocking both commands. */
+void _wlmaker_autostart_test_cyclic(bs_test_t *test_ptr)
+{
+    wlmaker_autostart_t autostart = {};
+    bspl_array_t *array_ptr = bspl_array_from_object(
+        bspl_create_object_from_plist_string(
+            "({Command = x; Name = X; After = Y;}, "
+            "{Command = y; Name = Y; After = X;})"));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, array_ptr);
+    bool rv = _wlmaker_autostart_configure(&autostart, array_ptr, NULL);
+    bspl_array_unref(array_ptr);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, rv);
+
+    wlmaker_autostart_entry_t *e_ptr = autostart.entries_ptr;
+    BS_TEST_VERIFY_EQ(test_ptr, &e_ptr[1], e_ptr[0].after_entry_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, e_ptr[1].after_entry_ptr);
+    uint64_t delay;
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &e_ptr[1], _wlmaker_autostart_next(&autostart, 0, &delay));
+
+    _wlmaker_autostart_unconfigure(&autostart);
+}
+
+/* == End of autostart.c =================================================== */
@@ -0,0 +1,81 @@
+/* ========================================================================= */
+/**
+ * @file autostart.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __AUTOSTART_H__
+#define __AUTOSTART_H__
+
+#include <libbase/libbase.h>
+#include <libbase/plist.h>
+#include <wayland-server-core.h>
+
+/** Forward declaration: Scheduler for the autostarted commands. */
+typedef struct _wlmaker_autostart_t wlmaker_autostart_t;
+
+#include "subprocess_monitor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Creates the scheduler for the commands of the `Autostart` config array.
+ *
+ * Each element is either a string with the command line, or a dict with a
+ * `Command`, and optionally a `Name`, a `Priority` and an `After`. Commands
+ * are started in order of decreasing priority, and a command with `After`
+ * only once the command of that name is ready: When it mapped its first
+ * window, terminated, or after the `ReadyTimeoutMsec` of the schedule.
+ *
+ * The first command is started from an idle callback, ie. after the first
+ * frames rendered. Further commands are staggered by `StaggerMsec`, and at
+ * most `Concurrency` of them are started but not yet ready.
+ *
+ * @param wl_event_loop_ptr
+ * @param monitor_ptr         Subprocess monitor, to entrust the started
+ *                            commands to.
+ * @param array_ptr           The `Autostart` array.
+ * @param schedule_dict_ptr   The `AutostartSchedule` dict, or NULL for the
+ *                            default schedule.
+ *
+ * @return Pointer to the scheduler, or NULL on error. Must be destroyed by
+ *     calling @ref wlmaker_autostart_destroy.
+ */
+wlmaker_autostart_t *wlmaker_autostart_create(
+    struct wl_event_loop *wl_event_loop_ptr,
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    bspl_array_t *array_ptr,
+    bspl_dict_t *schedule_dict_ptr);
+
+/**
+ * Destroys the scheduler. Commands not yet started will not be started, the
+ * started ones are kept running.
+ *
+ * @param autostart_ptr
+ */
+void wlmaker_autostart_destroy(wlmaker_autostart_t *autostart_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_autostart_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __AUTOSTART_H__ */
+/* == End of autostart.h =================================================== */
@@ -25,26 +25,49 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <toolkit/toolkit.h>
 #include <wayland-server-core.h>
 #include <wayland-util.h>
 #define WLR_USE_UNSTABLE
 #include <wlr/backend.h>
+#include <wlr/backend/headless.h>
+#include <wlr/backend/multi.h>
 #include <wlr/backend/session.h>
 #include <wlr/render/allocator.h>
 #include <wlr/render/wlr_renderer.h>
+#include <wlr/types/wlr_buffer.h>
 #include <wlr/types/wlr_compositor.h>
+#include <wlr/types/wlr_content_type_v1.h>
+#include <wlr/types/wlr_export_dmabuf_v1.h>
+#include <wlr/types/wlr_fractional_scale_v1.h>
+#include <wlr/types/wlr_linux_dmabuf_v1.h>
 #include <wlr/types/wlr_output.h>
 #include <wlr/types/wlr_output_layout.h>
+#include <wlr/types/wlr_output_power_management_v1.h>
+#include <wlr/types/wlr_presentation_time.h>
 #include <wlr/types/wlr_scene.h>
 #include <wlr/types/wlr_screencopy_v1.h>
+#include <wlr/types/wlr_single_pixel_buffer_v1.h>
 #include <wlr/types/wlr_subcompositor.h>
+#include <wlr/types/wlr_viewporter.h>
+#include <wlr/util/box.h>
 #include <wlr/version.h>
+#if WLR_VERSION_NUM >= (18 << 8)
+#include <wlr/types/wlr_linux_drm_syncobj_v1.h>
+#include <wlr/types/wlr_tearing_control_v1.h>
+#endif  // WLR_VERSION_NUM >= (18 << 8)
+#if WLR_VERSION_NUM >= (20 << 8)
+#include <wlr/types/wlr_commit_timing_v1.h>
+#include <wlr/types/wlr_fifo_v1.h>
+#endif  // WLR_VERSION_NUM >= (20 << 8)
 #undef WLR_USE_UNSTABLE
 
 #include "output.h"
 #include "output_config.h"
 #include "output_manager.h"
+#include "remote.h"
 
 /* == Declarations ========================================================= */
 
@@ -67,10 +90,42 @@ struct _wlmbe_backend_t {
      * surfaces.
      */
     struct wlr_subcompositor  *wlr_subcompositor_ptr;
+    /** Lets clients crop and scale surfaces, `wp_viewporter`. */
+    struct wlr_viewporter     *wlr_viewporter_ptr;
+    /** Solid-color buffers, `wp_single_pixel_buffer_manager_v1`. */
+    struct wlr_single_pixel_buffer_manager_v1 *wlr_spb_manager_v1_ptr;
+    /** Preferred fractional scales for surfaces, `wp_fractional_scale_v1`. */
+    struct wlr_fractional_scale_manager_v1 *wlr_fractional_scale_manager_ptr;
+    /** Buffer sharing with v4 feedback, `zwp_linux_dmabuf_v1`. May be NULL. */
+    struct wlr_linux_dmabuf_v1 *wlr_linux_dmabuf_v1_ptr;
+#if WLR_VERSION_NUM >= (18 << 8)
+    /** Explicit sync, `wp_linux_drm_syncobj_manager_v1`. May be NULL. */
+    struct wlr_linux_drm_syncobj_manager_v1 *wlr_syncobj_manager_v1_ptr;
+    /** Async presentation hints, `wp_tearing_control_v1`. */
+    struct wlr_tearing_control_manager_v1 *wlr_tearing_control_manager_v1_ptr;
+#endif  // WLR_VERSION_NUM >= (18 << 8)
+    /** Content type hints, `wp_content_type_v1`. */
+    struct wlr_content_type_manager_v1 *wlr_content_type_manager_v1_ptr;
     /** The screencopy manager. */
     struct wlr_screencopy_manager_v1 *wlr_screencopy_manager_v1_ptr;
+    /** Output frames as DMA-BUFs, without a copy, `zwlr_export_dmabuf`. */
+    struct wlr_export_dmabuf_manager_v1 *wlr_export_dmabuf_manager_v1_ptr;
+    /** Presentation-time feedback for clients, `wp_presentation`. */
+    struct wlr_presentation   *wlr_presentation_ptr;
+#if WLR_VERSION_NUM >= (20 << 8)
+    /** Commits applied once the prior one was presented, `wp_fifo_v1`. */
+    struct wlr_fifo_manager_v1 *wlr_fifo_manager_v1_ptr;
+    /** Commits applied at a target time, `wp_commit_timing_v1`. */
+    struct wlr_commit_timing_manager_v1 *wlr_commit_timing_manager_v1_ptr;
+#endif  // WLR_VERSION_NUM >= (20 << 8)
     /** The output manager(s). */
     wlmbe_output_manager_t    *output_manager_ptr;
+    /** Display power management, `zwlr_output_power_manager_v1`. */
+    struct wlr_output_power_manager_v1 *wlr_output_power_manager_v1_ptr;
+    /** Listener for `set_mode` of the output power manager. */
+    struct wl_listener        output_power_set_mode_listener;
+    /** Toolkit root, handed to each output. May be NULL. */
+    wlmtk_root_t              *root_ptr;
 
     /** Listener for wlr_backend::events::new_input. */
     struct wl_listener        new_output_listener;
@@ -88,6 +143,12 @@ struct _wlmbe_backend_t {
      * @ref wlmbe_output_config_fnmatches for configured attributes.
      */
     bs_dllist_t               output_configs;
+    /**
+     * Caches the results of matching output descriptions against
+     * @ref wlmbe_backend_t::output_configs. Holds
+     * @ref _wlmbe_backend_config_match_t, keyed by description.
+     */
+    bs_avltree_t              *config_match_tree_ptr;
     /**
      * Another list of @ref wlmbe_output_config_t items. This is
      * initialized from wlmaker's state file.
@@ -101,6 +162,39 @@ struct _wlmbe_backend_t {
 
     /** List of outputs. Connects @ref wlmbe_output_t::dlnode. */
     bs_dllist_t               outputs;
+    /**
+     * Outputs discovered, but not yet configured. Connects
+     * @ref wlmbe_output_t::dlnode. These are configured jointly, once
+     * @ref wlmbe_backend_t::hotplug_timer_ptr fires.
+     */
+    bs_dllist_t               pending_outputs;
+    /** Debounces hotplug events, to configure new outputs together. */
+    struct wl_event_source    *hotplug_timer_ptr;
+
+    /** Number of remote outputs to create, from the `Remote` dict. */
+    uint64_t                  remote_outputs;
+    /** Headless backend, for the remote outputs. NULL if there are none. */
+    struct wlr_backend        *wlr_headless_backend_ptr;
+    /** Remote outputs. Connects @ref wlmbe_remote_t::dlnode. */
+    bs_dllist_t               remotes;
+    /** Magnification, see @ref wlmbe_backend_set_magnification. */
+    double                    magnification;
+
+    /**
+     * Interval for sending frame callbacks to surfaces not shown on any
+     * output, in milliseconds. 0 to not send any.
+     */
+    uint64_t                  hidden_keepalive_msec;
+    /** Timer for the frame callbacks of hidden surfaces. */
+    struct wl_event_source    *keepalive_timer_ptr;
+    /** Whether the keepalive timer is paused, since all outputs are off. */
+    bool                      keepalive_paused;
+
+    /**
+     * DRM device(s) to use, the first one renders. Colon-separated, as for
+     * `WLR_DRM_DEVICES`. Empty string to let wlroots pick.
+     */
+    char                      *render_devices_ptr;
 
     // Elements below not owned by @ref wlmbe_backend_t.
     /** Back-link to the wlroots scene. */
@@ -109,6 +203,29 @@ struct _wlmbe_backend_t {
     struct wlr_output_layout  *wlr_output_layout_ptr;
 };
 
+/** A cached result of matching an output against the configured outputs. */
+typedef struct {
+    /** Node of @ref wlmbe_backend_t::config_match_tree_ptr. */
+    bs_avltree_node_t         avlnode;
+    /** Key: Name, manufacturer, model and serial of the output. */
+    char                      *key_ptr;
+    /** The first matching output configuration, or NULL for no match. */
+    wlmbe_output_config_t     *config_ptr;
+} _wlmbe_backend_config_match_t;
+
+static wlmbe_output_config_t *_wlmbe_backend_find_output_config(
+    wlmbe_backend_t *backend_ptr,
+    struct wlr_output *wlr_output_ptr);
+static int _wlmbe_backend_config_match_cmp(
+    const bs_avltree_node_t *avlnode_ptr,
+    const void *key_ptr);
+static void _wlmbe_backend_config_match_destroy(
+    bs_avltree_node_t *avlnode_ptr);
+
+static bool _wlmbe_backend_add_output(
+    wlmbe_backend_t *backend_ptr,
+    wlmbe_output_t *output_ptr);
+static void _wlmbe_backend_link_mirrors(wlmbe_backend_t *backend_ptr);
 static void _wlmbe_backend_handle_new_output(
     struct wl_listener *listener_ptr,
     void *data_ptr);
@@ -121,6 +238,26 @@ static void _wlmbe_backend_decode_fini(void *dest_ptr);
 static void _wlmbe_backend_config_dlnode_destroy(
     bs_dllist_node_t *dlnode_ptr,
     void *ud_ptr);
+static int _wlmbe_backend_handle_hotplug_timer(void *data_ptr);
+static bool _wlmbe_backend_commit_output_state(
+    struct wlr_backend_output_state *wlr_backend_output_state_ptr);
+static int _wlmbe_backend_handle_keepalive_timer(void *data_ptr);
+static bool _wlmbe_backend_any_output_powered(wlmbe_backend_t *backend_ptr);
+static void _wlmbe_backend_resume_keepalive(wlmbe_backend_t *backend_ptr);
+static void _wlmbe_backend_handle_output_power_set_mode(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static bool _wlmbe_backend_keepalive_node(
+    struct wl_list *link_ptr,
+    void *ud_ptr);
+
+/** Default for @ref wlmbe_backend_t::hidden_keepalive_msec. */
+static const uint64_t _wlmbe_backend_hidden_keepalive_msec = 1000;
+/**
+ * Delay for configuring newly discovered outputs, in milliseconds. Each
+ * further output discovered within that delay will re-arm the timer.
+ */
+static const int _wlmbe_backend_hotplug_debounce_msec = 250;
 
 /* == Data ================================================================= */
 
@@ -134,6 +271,31 @@ static const bspl_desc_t _wlmbe_output_configs_desc[] = {
     BSPL_DESC_SENTINEL(),
 };
 
+/** Descriptor for the "FrameCallbacks" dict of wlmaker.plist. */
+static const bspl_desc_t _wlmbe_frame_callbacks_desc[] = {
+    BSPL_DESC_UINT64(
+        "HiddenKeepalive", false, wlmbe_backend_t,
+        hidden_keepalive_msec, hidden_keepalive_msec,
+        _wlmbe_backend_hidden_keepalive_msec),
+    BSPL_DESC_SENTINEL(),
+};
+
+/** Descriptor for the "Rendering" dict of wlmaker.plist. */
+static const bspl_desc_t _wlmbe_rendering_desc[] = {
+    BSPL_DESC_STRING(
+        "Devices", false, wlmbe_backend_t,
+        render_devices_ptr, render_devices_ptr, ""),
+    BSPL_DESC_SENTINEL(),
+};
+
+/** Descriptor for the "Remote" dict of wlmaker.plist. */
+static const bspl_desc_t _wlmbe_remote_desc[] = {
+    BSPL_DESC_UINT64(
+        "Outputs", false, wlmbe_backend_t,
+        remote_outputs, remote_outputs, 1),
+    BSPL_DESC_SENTINEL(),
+};
+
 /** Descriptor for the output state, stored as plist. */
 static const bspl_desc_t _wlmbe_outputs_state_desc[] = {
     BSPL_DESC_ARRAY("Outputs", true, wlmbe_backend_t, ephemeral_output_configs,
@@ -161,6 +323,7 @@ wlmbe_backend_t *wlmbe_backend_create(
     backend_ptr->wlr_output_layout_ptr = wlr_output_layout_ptr;
     backend_ptr->width = width;
     backend_ptr->height = height;
+    backend_ptr->magnification = 1.0;
 
     if (!bspl_decode_dict(
             config_dict_ptr,
@@ -169,6 +332,48 @@ wlmbe_backend_t *wlmbe_backend_create(
         wlmbe_backend_destroy(backend_ptr);
         return NULL;
     }
+    backend_ptr->config_match_tree_ptr = bs_avltree_create(
+        _wlmbe_backend_config_match_cmp,
+        _wlmbe_backend_config_match_destroy);
+    if (NULL == backend_ptr->config_match_tree_ptr) {
+        bs_log(BS_ERROR, "Failed bs_avltree_create(%p, %p)",
+               _wlmbe_backend_config_match_cmp,
+               _wlmbe_backend_config_match_destroy);
+        wlmbe_backend_destroy(backend_ptr);
+        return NULL;
+    }
+    // Optional: Defaults to a keepalive once per second.
+    backend_ptr->hidden_keepalive_msec = _wlmbe_backend_hidden_keepalive_msec;
+    bspl_dict_t *dict_ptr = bspl_dict_get_dict(
+        config_dict_ptr, "FrameCallbacks");
+    if (NULL != dict_ptr &&
+        !bspl_decode_dict(
+            dict_ptr, _wlmbe_frame_callbacks_desc, backend_ptr)) {
+        bs_log(BS_ERROR, "Failed to decode \"FrameCallbacks\" dict");
+        wlmbe_backend_destroy(backend_ptr);
+        return NULL;
+    }
+
+    // Optional: The render device. wlroots renders all outputs on the
+    // first DRM device, and copies frames to outputs of the others.
+    dict_ptr = bspl_dict_get_dict(config_dict_ptr, "Rendering");
+    if (NULL != dict_ptr &&
+        !bspl_decode_dict(dict_ptr, _wlmbe_rendering_desc, backend_ptr)) {
+        bs_log(BS_ERROR, "Failed to decode \"Rendering\" dict");
+        wlmbe_backend_destroy(backend_ptr);
+        return NULL;
+    }
+    if (NULL != backend_ptr->render_devices_ptr &&
+        0 < strlen(backend_ptr->render_devices_ptr)) {
+        if (NULL != getenv("WLR_DRM_DEVICES")) {
+            bs_log(BS_WARNING, "WLR_DRM_DEVICES is set, ignoring \"%s\"",
+                   backend_ptr->render_devices_ptr);
+        } else {
+            bs_log(BS_INFO, "Using DRM devices \"%s\"",
+                   backend_ptr->render_devices_ptr);
+            setenv("WLR_DRM_DEVICES", backend_ptr->render_devices_ptr, 1);
+        }
+    }
 
     // Auto-create the wlroots backend. Can be X11 or direct.
     backend_ptr->wlr_backend_ptr = wlr_backend_autocreate(
@@ -192,12 +397,53 @@ wlmbe_backend_t *wlmbe_backend_create(
         wlmbe_backend_destroy(backend_ptr);
         return NULL;
     }
-    if (!wlr_renderer_init_wl_display(
+    if (!wlr_renderer_init_wl_shm(
             backend_ptr->wlr_renderer_ptr, wl_display_ptr)) {
-        bs_log(BS_ERROR, "Failed wlr_render_init_wl_display()");
+        bs_log(BS_ERROR, "Failed wlr_renderer_init_wl_shm()");
         wlmbe_backend_destroy(backend_ptr);
         return NULL;
     }
+    // Created explicitly, rather than through wlr_renderer_init_wl_display(),
+    // to have the scene send per-surface feedback: A surface that covers an
+    // output gets a tranche with that output's scanout formats, to permit
+    // direct scanout. Not all renderers support DMA-BUF.
+#if WLR_VERSION_NUM >= (18 << 8)
+    if (NULL != wlr_renderer_get_texture_formats(
+            backend_ptr->wlr_renderer_ptr, WLR_BUFFER_CAP_DMABUF)) {
+#else  // WLR_VERSION_NUM >= (18 << 8)
+    if (NULL != wlr_renderer_get_dmabuf_texture_formats(
+            backend_ptr->wlr_renderer_ptr)) {
+#endif  // WLR_VERSION_NUM >= (18 << 8)
+        backend_ptr->wlr_linux_dmabuf_v1_ptr =
+            wlr_linux_dmabuf_v1_create_with_renderer(
+                wl_display_ptr, 4, backend_ptr->wlr_renderer_ptr);
+        if (NULL == backend_ptr->wlr_linux_dmabuf_v1_ptr) {
+            bs_log(BS_ERROR,
+                   "Failed wlr_linux_dmabuf_v1_create_with_renderer()");
+            wlmbe_backend_destroy(backend_ptr);
+            return NULL;
+        }
+        wlr_scene_set_linux_dmabuf_v1(
+            wlr_scene_ptr, backend_ptr->wlr_linux_dmabuf_v1_ptr);
+    }
+
+#if WLR_VERSION_NUM >= (18 << 8)
+    // Explicit sync: The scene waits for the client's acquire point before
+    // presenting the buffer, and signals the release point once done. Needs
+    // timeline support from both renderer and backend: Just skip, otherwise.
+    int drm_fd = wlr_renderer_get_drm_fd(backend_ptr->wlr_renderer_ptr);
+    if (backend_ptr->wlr_renderer_ptr->features.timeline &&
+        backend_ptr->wlr_backend_ptr->features.timeline &&
+        0 <= drm_fd) {
+        backend_ptr->wlr_syncobj_manager_v1_ptr =
+            wlr_linux_drm_syncobj_manager_v1_create(wl_display_ptr, 1, drm_fd);
+        if (NULL == backend_ptr->wlr_syncobj_manager_v1_ptr) {
+            bs_log(BS_WARNING,
+                   "Failed wlr_linux_drm_syncobj_manager_v1_create(%p, 1, %d)",
+                   wl_display_ptr, drm_fd);
+        }
+    }
+#endif  // WLR_VERSION_NUM >= (18 << 8)
 
     backend_ptr->wlr_allocator_ptr = wlr_allocator_autocreate(
         backend_ptr->wlr_backend_ptr,
@@ -207,6 +453,9 @@ wlmbe_backend_t *wlmbe_backend_create(
         wlmbe_backend_destroy(backend_ptr);
         return NULL;
     }
+    // Window thumbnails: Rendered offscreen, in the same renderer.
+    wlmtk_thumbnail_set_renderer(
+        backend_ptr->wlr_renderer_ptr, backend_ptr->wlr_allocator_ptr);
 
     backend_ptr->wlr_scene_output_layout_ptr =
         wlr_scene_attach_output_layout(
@@ -233,6 +482,49 @@ wlmbe_backend_t *wlmbe_backend_create(
         return NULL;
     }
 
+    // Clients scale (eg. video) or fill (single pixel) surfaces through the
+    // scene, without allocating buffers of the full size.
+    backend_ptr->wlr_viewporter_ptr = wlr_viewporter_create(wl_display_ptr);
+    if (NULL == backend_ptr->wlr_viewporter_ptr) {
+        bs_log(BS_ERROR, "Failed wlr_viewporter_create()");
+        wlmbe_backend_destroy(backend_ptr);
+        return NULL;
+    }
+    backend_ptr->wlr_spb_manager_v1_ptr =
+        wlr_single_pixel_buffer_manager_v1_create(wl_display_ptr);
+    if (NULL == backend_ptr->wlr_spb_manager_v1_ptr) {
+        bs_log(BS_ERROR, "Failed wlr_single_pixel_buffer_manager_v1_create()");
+        wlmbe_backend_destroy(backend_ptr);
+        return NULL;
+    }
+
+    // The scene sends the preferred scale of each surface's primary output.
+    backend_ptr->wlr_fractional_scale_manager_ptr =
+        wlr_fractional_scale_manager_v1_create(wl_display_ptr, 1);
+    if (NULL == backend_ptr->wlr_fractional_scale_manager_ptr) {
+        bs_log(BS_ERROR, "Failed wlr_fractional_scale_manager_v1_create()");
+        wlmbe_backend_destroy(backend_ptr);
+        return NULL;
+    }
+
+    // Hints for the fullscreen surface on an output: Tearing, and VRR.
+    backend_ptr->wlr_content_type_manager_v1_ptr =
+        wlr_content_type_manager_v1_create(wl_display_ptr, 1);
+    if (NULL == backend_ptr->wlr_content_type_manager_v1_ptr) {
+        bs_log(BS_ERROR, "Failed wlr_content_type_manager_v1_create()");
+        wlmbe_backend_destroy(backend_ptr);
+        return NULL;
+    }
+#if WLR_VERSION_NUM >= (18 << 8)
+    backend_ptr->wlr_tearing_control_manager_v1_ptr =
+        wlr_tearing_control_manager_v1_create(wl_display_ptr, 1);
+    if (NULL == backend_ptr->wlr_tearing_control_manager_v1_ptr) {
+        bs_log(BS_ERROR, "Failed wlr_tearing_control_manager_v1_create()");
+        wlmbe_backend_destroy(backend_ptr);
+        return NULL;
+    }
+#endif  // WLR_VERSION_NUM >= (18 << 8)
+
     backend_ptr->wlr_screencopy_manager_v1_ptr =
         wlr_screencopy_manager_v1_create(wl_display_ptr);
     if (NULL == backend_ptr->wlr_screencopy_manager_v1_ptr) {
@@ -240,6 +532,55 @@ wlmbe_backend_t *wlmbe_backend_create(
         wlmbe_backend_destroy(backend_ptr);
         return NULL;
     }
+    // Hands clients the output's DMA-BUF as is: Capturing costs no copy.
+    backend_ptr->wlr_export_dmabuf_manager_v1_ptr =
+        wlr_export_dmabuf_manager_v1_create(wl_display_ptr);
+    if (NULL == backend_ptr->wlr_export_dmabuf_manager_v1_ptr) {
+        bs_log(BS_ERROR, "Failed wlr_export_dmabuf_manager_v1_create()");
+        wlmbe_backend_destroy(backend_ptr);
+        return NULL;
+    }
+
+    backend_ptr->wlr_presentation_ptr = wlr_presentation_create(
+        wl_display_ptr,
+        backend_ptr->wlr_backend_ptr
+#if WLR_VERSION_NUM >= (19 << 8)
+        , 2
+#endif  // WLR_VERSION_NUM >= (19 << 8)
+        );
+    if (NULL == backend_ptr->wlr_presentation_ptr) {
+        bs_log(BS_ERROR, "Failed wlr_presentation_create()");
+        wlmbe_backend_destroy(backend_ptr);
+        return NULL;
+    }
+#if WLR_VERSION_NUM < (19 << 8)
+    // The scene sends the feedback for surfaces it presents.
+    wlr_scene_set_presentation(
+        wlr_scene_ptr, backend_ptr->wlr_presentation_ptr);
+#endif  // WLR_VERSION_NUM < (19 << 8)
+
+#if WLR_VERSION_NUM >= (20 << 8)
+    // Lets clients queue frames, rather than waiting for frame callbacks:
+    // FIFO barriers clear when the output presents, and timed commits are
+    // applied for the refresh cycle of their target time.
+    //
+    // Forward-only: The build resolves wlroots 0.18, so this is compiled
+    // only once the build moves to wlroots 0.20. Untested until then.
+    backend_ptr->wlr_fifo_manager_v1_ptr = wlr_fifo_manager_v1_create(
+        wl_display_ptr, 1);
+    if (NULL == backend_ptr->wlr_fifo_manager_v1_ptr) {
+        bs_log(BS_ERROR, "Failed wlr_fifo_manager_v1_create()");
+        wlmbe_backend_destroy(backend_ptr);
+        return NULL;
+    }
+    backend_ptr->wlr_commit_timing_manager_v1_ptr =
+        wlr_commit_timing_manager_v1_create(wl_display_ptr, 1);
+    if (NULL == backend_ptr->wlr_commit_timing_manager_v1_ptr) {
+        bs_log(BS_ERROR, "Failed wlr_commit_timing_manager_v1_create()");
+        wlmbe_backend_destroy(backend_ptr);
+        return NULL;
+    }
+#endif  // WLR_VERSION_NUM >= (20 << 8)
 
     backend_ptr->output_manager_ptr = wlmbe_output_manager_create(
         wl_display_ptr,
@@ -251,18 +592,107 @@ wlmbe_backend_t *wlmbe_backend_create(
         return NULL;
     }
 
+    backend_ptr->wlr_output_power_manager_v1_ptr =
+        wlr_output_power_manager_v1_create(wl_display_ptr);
+    if (NULL == backend_ptr->wlr_output_power_manager_v1_ptr) {
+        bs_log(BS_ERROR, "Failed wlr_output_power_manager_v1_create()");
+        wlmbe_backend_destroy(backend_ptr);
+        return NULL;
+    }
+    wlmtk_util_connect_listener_signal(
+        &backend_ptr->wlr_output_power_manager_v1_ptr->events.set_mode,
+        &backend_ptr->output_power_set_mode_listener,
+        _wlmbe_backend_handle_output_power_set_mode);
+
     wlmtk_util_connect_listener_signal(
         &backend_ptr->wlr_backend_ptr->events.new_output,
         &backend_ptr->new_output_listener,
         _wlmbe_backend_handle_new_output);
 
+    // Optional: Remote outputs, on an additional headless backend. These
+    // are announced through `new_output` once the backend starts.
+    dict_ptr = bspl_dict_get_dict(config_dict_ptr, "Remote");
+    if (NULL != dict_ptr &&
+        !bspl_decode_dict(dict_ptr, _wlmbe_remote_desc, backend_ptr)) {
+        bs_log(BS_ERROR, "Failed to decode \"Remote\" dict");
+        wlmbe_backend_destroy(backend_ptr);
+        return NULL;
+    }
+    if (0 < backend_ptr->remote_outputs) {
+        backend_ptr->wlr_headless_backend_ptr = wlr_headless_backend_create(
+            wl_display_get_event_loop(wl_display_ptr));
+        if (NULL == backend_ptr->wlr_headless_backend_ptr ||
+            !wlr_multi_backend_add(
+                backend_ptr->wlr_backend_ptr,
+                backend_ptr->wlr_headless_backend_ptr)) {
+            bs_log(BS_ERROR, "Failed to add a headless backend");
+            wlmbe_backend_destroy(backend_ptr);
+            return NULL;
+        }
+        for (uint64_t i = 0; i < backend_ptr->remote_outputs; ++i) {
+            // Default size. An `Outputs` entry for `HEADLESS-<n>` may set
+            // a different `Mode`, its refresh rate paces the frames.
+            if (NULL == wlr_headless_add_output(
+                    backend_ptr->wlr_headless_backend_ptr, 1920, 1080)) {
+                bs_log(BS_ERROR, "Failed wlr_headless_add_output()");
+                wlmbe_backend_destroy(backend_ptr);
+                return NULL;
+            }
+        }
+    }
+
+    backend_ptr->hotplug_timer_ptr = wl_event_loop_add_timer(
+        wl_display_get_event_loop(wl_display_ptr),
+        _wlmbe_backend_handle_hotplug_timer,
+        backend_ptr);
+    if (NULL == backend_ptr->hotplug_timer_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_timer()");
+        wlmbe_backend_destroy(backend_ptr);
+        return NULL;
+    }
+
+    if (0 < backend_ptr->hidden_keepalive_msec) {
+        backend_ptr->keepalive_timer_ptr = wl_event_loop_add_timer(
+            wl_display_get_event_loop(wl_display_ptr),
+            _wlmbe_backend_handle_keepalive_timer,
+            backend_ptr);
+        if (NULL == backend_ptr->keepalive_timer_ptr) {
+            bs_log(BS_ERROR, "Failed wl_event_loop_add_timer()");
+            wlmbe_backend_destroy(backend_ptr);
+            return NULL;
+        }
+        wl_event_source_timer_update(
+            backend_ptr->keepalive_timer_ptr,
+            backend_ptr->hidden_keepalive_msec);
+    }
+
     return backend_ptr;
 }
 
 /* ------------------------------------------------------------------------- */
 void wlmbe_backend_destroy(wlmbe_backend_t *backend_ptr)
 {
+    if (NULL != backend_ptr->keepalive_timer_ptr) {
+        wl_event_source_remove(backend_ptr->keepalive_timer_ptr);
+        backend_ptr->keepalive_timer_ptr = NULL;
+    }
+    if (NULL != backend_ptr->hotplug_timer_ptr) {
+        wl_event_source_remove(backend_ptr->hotplug_timer_ptr);
+        backend_ptr->hotplug_timer_ptr = NULL;
+    }
     wlmtk_util_disconnect_listener(&backend_ptr->new_output_listener);
+    wlmtk_util_disconnect_listener(
+        &backend_ptr->output_power_set_mode_listener);
+
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                        &backend_ptr->remotes))) {
+        wlmbe_remote_destroy(wlmbe_remote_from_dlnode(dlnode_ptr));
+    }
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                        &backend_ptr->pending_outputs))) {
+        wlmbe_output_destroy(wlmbe_output_from_dlnode(dlnode_ptr));
+    }
 
     if (NULL != backend_ptr->output_manager_ptr) {
         wlmbe_output_manager_destroy(backend_ptr->output_manager_ptr);
@@ -275,10 +705,17 @@ void wlmbe_backend_destroy(wlmbe_backend_t *backend_ptr)
     }
 
      if (NULL != backend_ptr->wlr_allocator_ptr) {
+        wlmtk_thumbnail_set_renderer(NULL, NULL);
         wlr_allocator_destroy(backend_ptr->wlr_allocator_ptr);
         backend_ptr->wlr_allocator_ptr = NULL;
      }
 
+    if (NULL != backend_ptr->config_match_tree_ptr) {
+        bs_avltree_destroy(backend_ptr->config_match_tree_ptr);
+        backend_ptr->config_match_tree_ptr = NULL;
+    }
+    bspl_decoded_destroy(_wlmbe_remote_desc, backend_ptr);
+    bspl_decoded_destroy(_wlmbe_rendering_desc, backend_ptr);
     bspl_decoded_destroy(_wlmbe_outputs_state_desc, backend_ptr);
     bspl_decoded_destroy(_wlmbe_output_configs_desc, backend_ptr);
 
@@ -302,6 +739,184 @@ void wlmbe_backend_switch_to_vt(wlmbe_backend_t *backend_ptr, unsigned vt_num)
     }
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmbe_backend_set_root(
+    wlmbe_backend_t *backend_ptr,
+    wlmtk_root_t *root_ptr)
+{
+    backend_ptr->root_ptr = root_ptr;
+    for (bs_dllist_node_t *dlnode_ptr = backend_ptr->outputs.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmbe_output_set_root(wlmbe_output_from_dlnode(dlnode_ptr), root_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmbe_backend_configure_pending_outputs(wlmbe_backend_t *backend_ptr)
+{
+    if (NULL != backend_ptr->hotplug_timer_ptr) {
+        // Disarms the timer. It'll be re-armed on the next hotplug.
+        wl_event_source_timer_update(backend_ptr->hotplug_timer_ptr, 0);
+    }
+    if (bs_dllist_empty(&backend_ptr->pending_outputs)) return;
+
+    size_t max_states = bs_dllist_size(&backend_ptr->pending_outputs);
+    struct wlr_backend_output_state *states_ptr = logged_calloc(
+        max_states, sizeof(struct wlr_backend_output_state));
+    if (NULL == states_ptr) return;
+
+    // Stage 1: Build the state of each output. Skip those that were
+    // unplugged again before they got configured.
+    size_t states_len = 0;
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                        &backend_ptr->pending_outputs))) {
+        wlmbe_output_t *output_ptr = wlmbe_output_from_dlnode(dlnode_ptr);
+        struct wlr_output *wlrop = wlmbe_wlr_output_from_output(output_ptr);
+        if (NULL == wlrop) {
+            wlmbe_output_destroy(output_ptr);
+            continue;
+        }
+        struct wlr_backend_output_state *s_ptr = &states_ptr[states_len++];
+        s_ptr->output = wlrop;
+        wlr_output_state_init(&s_ptr->base);
+        wlmbe_output_build_state(
+            output_ptr, &s_ptr->base,
+            backend_ptr->width, backend_ptr->height);
+    }
+
+    // Stage 2: Test all outputs together, and commit them as a single
+    // transaction. Falls back to per-output commits if the backend rejects
+    // the combination, so that one failing output won't block the others.
+    bool committed = false;
+    if (0 < states_len &&
+        wlr_backend_test(backend_ptr->wlr_backend_ptr,
+                         states_ptr, states_len)) {
+        committed = wlr_backend_commit(
+            backend_ptr->wlr_backend_ptr, states_ptr, states_len);
+    }
+    if (!committed && 1 < states_len) {
+        bs_log(BS_WARNING, "Failed joint commit of %zu outputs, "
+               "committing separately.", states_len);
+    }
+
+    // Stage 3: Add the committed outputs to the layout.
+    for (size_t i = 0; i < states_len; ++i) {
+        struct wlr_output *wlrop = states_ptr[i].output;
+        if (!committed &&
+            !_wlmbe_backend_commit_output_state(&states_ptr[i])) {
+            wlr_output_state_finish(&states_ptr[i].base);
+            wlmbe_output_destroy(wlrop->data);
+            wlr_output_destroy(wlrop);
+            continue;
+        }
+        wlr_output_state_finish(&states_ptr[i].base);
+
+        wlmbe_output_t *output_ptr = wlrop->data;
+        if (_wlmbe_backend_add_output(backend_ptr, output_ptr)) continue;
+        wlmbe_output_destroy(output_ptr);
+        wlr_output_destroy(wlrop);
+    }
+    free(states_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmbe_backend_log_stats(
+    wlmbe_backend_t *backend_ptr,
+    bs_log_severity_t severity)
+{
+    for (bs_dllist_node_t *dlnode_ptr = backend_ptr->outputs.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmbe_output_log_stats(wlmbe_output_from_dlnode(dlnode_ptr), severity);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmbe_backend_set_outputs_powered(
+    wlmbe_backend_t *backend_ptr,
+    bool powered)
+{
+    for (bs_dllist_node_t *dlnode_ptr = backend_ptr->outputs.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmbe_output_set_powered(
+            wlmbe_output_from_dlnode(dlnode_ptr), powered);
+    }
+    if (powered) _wlmbe_backend_resume_keepalive(backend_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmbe_backend_for_each_output(
+    wlmbe_backend_t *backend_ptr,
+    void (*func)(wlmbe_output_t *output_ptr, void *ud_ptr),
+    void *ud_ptr)
+{
+    for (bs_dllist_node_t *dlnode_ptr = backend_ptr->outputs.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        func(wlmbe_output_from_dlnode(dlnode_ptr), ud_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmbe_backend_for_each_remote(
+    wlmbe_backend_t *backend_ptr,
+    void (*func)(wlmbe_remote_t *remote_ptr, void *ud_ptr),
+    void *ud_ptr)
+{
+    for (bs_dllist_node_t *dlnode_ptr = backend_ptr->remotes.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        func(wlmbe_remote_from_dlnode(dlnode_ptr), ud_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmbe_backend_set_magnification(
+    wlmbe_backend_t *backend_ptr,
+    double zoom,
+    double lx,
+    double ly)
+{
+    backend_ptr->magnification = BS_MAX(1.0, zoom);
+    for (bs_dllist_node_t *dlnode_ptr = backend_ptr->outputs.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmbe_output_t *output_ptr = wlmbe_output_from_dlnode(dlnode_ptr);
+        struct wlr_output *wlr_output_ptr = wlmbe_wlr_output_from_output(
+            output_ptr);
+        if (NULL == wlr_output_ptr) continue;
+        struct wlr_box box;
+        wlr_output_layout_get_box(
+            backend_ptr->wlr_output_layout_ptr, wlr_output_ptr, &box);
+        if (wlr_box_empty(&box)) continue;
+
+        // Focus in layout coordinates, to (transformed) buffer pixels.
+        int width, height;
+        wlr_output_transformed_resolution(wlr_output_ptr, &width, &height);
+        double x = BS_MIN(BS_MAX(0.0, lx - box.x), (double)box.width);
+        double y = BS_MIN(BS_MAX(0.0, ly - box.y), (double)box.height);
+        struct wlr_box focus = {
+            .x = x * wlr_output_ptr->scale,
+            .y = y * wlr_output_ptr->scale
+        };
+        wlr_box_transform(
+            &focus, &focus,
+            wlr_output_transform_invert(wlr_output_ptr->transform),
+            width, height);
+        wlmbe_output_set_magnification(
+            output_ptr, backend_ptr->magnification, focus.x, focus.y);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+double wlmbe_backend_magnification(wlmbe_backend_t *backend_ptr)
+{
+    return backend_ptr->magnification;
+}
+
 /* ------------------------------------------------------------------------- */
 struct wlr_backend *wlmbe_backend_wlr(wlmbe_backend_t *backend_ptr)
 {
@@ -353,6 +968,21 @@ bool _wlmbe_backend_add_output(
     BS_ASSERT(NULL != attr_ptr);
 
     struct wlr_output *wlrop = wlmbe_wlr_output_from_output(output_ptr);
+    if (wlmbe_output_is_mirror(output_ptr)) {
+        // Mirrors show the buffers of their source. Not in layout nor scene.
+        bs_dllist_push_back(
+            &backend_ptr->outputs,
+            wlmbe_dlnode_from_output(output_ptr));
+        bs_log(BS_INFO, "Created: Output <%s> %s to %dx%d@%.2f mirroring %s",
+               wlmbe_output_description(output_ptr),
+               wlrop->enabled ? "enabled" : "disabled",
+               wlrop->width, wlrop->height,
+               1e-3 * wlrop->refresh,
+               attr_ptr->mirror);
+        _wlmbe_backend_link_mirrors(backend_ptr);
+        return true;
+    }
+
     struct wlr_output_layout_output *wlr_output_layout_output_ptr = NULL;
     if (attr_ptr->has_position) {
         wlr_output_layout_output_ptr = wlr_output_layout_add(
@@ -393,9 +1023,54 @@ bool _wlmbe_backend_add_output(
            wlr_output_layout_output_ptr->x,
            wlr_output_layout_output_ptr->y,
            attr_ptr->has_position ? "explicit" : "auto");
+    _wlmbe_backend_link_mirrors(backend_ptr);
+
+    if (NULL != backend_ptr->wlr_headless_backend_ptr &&
+        wlrop->backend == backend_ptr->wlr_headless_backend_ptr) {
+        wlmbe_remote_t *remote_ptr = wlmbe_remote_create(output_ptr);
+        if (NULL != remote_ptr) {
+            bs_dllist_push_back(
+                &backend_ptr->remotes,
+                wlmbe_dlnode_from_remote(remote_ptr));
+        }
+    }
     return true;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Links each mirror among @ref wlmbe_backend_t::outputs to the output it is
+ * configured to mirror. That may be connected before or after the mirror.
+ * Mirrors of mirrors are not supported.
+ *
+ * @param backend_ptr
+ */
+void _wlmbe_backend_link_mirrors(wlmbe_backend_t *backend_ptr)
+{
+    for (bs_dllist_node_t *dlnode_ptr = backend_ptr->outputs.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmbe_output_t *output_ptr = wlmbe_output_from_dlnode(dlnode_ptr);
+        if (NULL == wlmbe_wlr_output_from_output(output_ptr) ||
+            !wlmbe_output_is_mirror(output_ptr)) continue;
+        const char *name_ptr = wlmbe_output_attributes(output_ptr)->mirror;
+
+        for (bs_dllist_node_t *src_dlnode_ptr = backend_ptr->outputs.head_ptr;
+             NULL != src_dlnode_ptr;
+             src_dlnode_ptr = src_dlnode_ptr->next_ptr) {
+            wlmbe_output_t *source_ptr = wlmbe_output_from_dlnode(
+                src_dlnode_ptr);
+            struct wlr_output *wlrop = wlmbe_wlr_output_from_output(
+                source_ptr);
+            if (NULL == wlrop ||
+                wlmbe_output_is_mirror(source_ptr) ||
+                0 != strcmp(wlrop->name, name_ptr)) continue;
+            wlmbe_output_set_mirror_source(output_ptr, source_ptr);
+            break;
+        }
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 /** Handles new output events: Creates @ref wlmbe_output_t and adds them.  */
 void _wlmbe_backend_handle_new_output(
@@ -429,11 +1104,7 @@ void _wlmbe_backend_handle_new_output(
     // See if we have a corresponding entry among configured outputs. If yes,
     // apply the attributes to our new config.
     wlmbe_output_config_t *outputs_config_ptr =
-        wlmbe_output_config_from_dlnode(
-            bs_dllist_find(
-                &backend_ptr->output_configs,
-                wlmbe_output_config_fnmatches,
-                wlr_output_ptr));
+        _wlmbe_backend_find_output_config(backend_ptr, wlr_output_ptr);
     if (NULL != outputs_config_ptr) {
         *wlmbe_output_config_attributes(config_ptr) =
             *wlmbe_output_config_attributes(outputs_config_ptr);
@@ -444,14 +1115,30 @@ void _wlmbe_backend_handle_new_output(
         backend_ptr->wlr_allocator_ptr,
         backend_ptr->wlr_renderer_ptr,
         backend_ptr->wlr_scene_ptr,
-        config_ptr,
-        backend_ptr->width,
-        backend_ptr->height);
-    if (NULL != output_ptr) {
-        if (_wlmbe_backend_add_output(backend_ptr, output_ptr)) return;
-        wlmbe_output_destroy(output_ptr);
+        config_ptr);
+    if (NULL == output_ptr) {
+        wlr_output_destroy(wlr_output_ptr);
+        return;
     }
-    wlr_output_destroy(wlr_output_ptr);
+    wlmbe_output_set_root(output_ptr, backend_ptr->root_ptr);
+    wlmbe_output_set_hint_managers(
+        output_ptr,
+#if WLR_VERSION_NUM >= (18 << 8)
+        backend_ptr->wlr_tearing_control_manager_v1_ptr,
+#else  // WLR_VERSION_NUM >= (18 << 8)
+        NULL,
+#endif  // WLR_VERSION_NUM >= (18 << 8)
+        backend_ptr->wlr_content_type_manager_v1_ptr);
+
+    // Configuration is deferred, and (re-)armed with each new output. A
+    // burst of hotplugs (eg. from a docking station) then gets configured
+    // in one transaction.
+    bs_dllist_push_back(
+        &backend_ptr->pending_outputs,
+        wlmbe_dlnode_from_output(output_ptr));
+    wl_event_source_timer_update(
+        backend_ptr->hotplug_timer_ptr,
+        _wlmbe_backend_hotplug_debounce_msec);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -505,12 +1192,253 @@ void _wlmbe_backend_config_dlnode_destroy(
     wlmbe_output_config_destroy(wlmbe_output_config_from_dlnode(dlnode_ptr));
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Finds the first of @ref wlmbe_backend_t::output_configs that matches
+ * `wlr_output_ptr`. Results are cached, since the configured outputs do not
+ * change during the backend's lifetime.
+ *
+ * @param backend_ptr
+ * @param wlr_output_ptr
+ *
+ * @return The output configuration, or NULL if none matched.
+ */
+wlmbe_output_config_t *_wlmbe_backend_find_output_config(
+    wlmbe_backend_t *backend_ptr,
+    struct wlr_output *wlr_output_ptr)
+{
+    // Absent fields are marked distinct from empty ones.
+    const char *f[4] = {
+        wlr_output_ptr->name, wlr_output_ptr->make,
+        wlr_output_ptr->model, wlr_output_ptr->serial
+    };
+    char *key_ptr = bs_strdupf(
+        "%s%s\n%s%s\n%s%s\n%s%s",
+        f[0] ? "+" : "-", f[0] ? f[0] : "",
+        f[1] ? "+" : "-", f[1] ? f[1] : "",
+        f[2] ? "+" : "-", f[2] ? f[2] : "",
+        f[3] ? "+" : "-", f[3] ? f[3] : "");
+    if (NULL == key_ptr) {
+        return wlmbe_output_config_from_dlnode(
+            bs_dllist_find(
+                &backend_ptr->output_configs,
+                wlmbe_output_config_fnmatches,
+                wlr_output_ptr));
+    }
+
+    bs_avltree_node_t *avlnode_ptr = bs_avltree_lookup(
+        backend_ptr->config_match_tree_ptr, key_ptr);
+    if (NULL != avlnode_ptr) {
+        free(key_ptr);
+        return BS_CONTAINER_OF(
+            avlnode_ptr, _wlmbe_backend_config_match_t, avlnode)->config_ptr;
+    }
+
+    wlmbe_output_config_t *config_ptr = wlmbe_output_config_from_dlnode(
+        bs_dllist_find(
+            &backend_ptr->output_configs,
+            wlmbe_output_config_fnmatches,
+            wlr_output_ptr));
+    _wlmbe_backend_config_match_t *match_ptr = logged_calloc(
+        1, sizeof(_wlmbe_backend_config_match_t));
+    if (NULL == match_ptr) {
+        free(key_ptr);
+        return config_ptr;
+    }
+    match_ptr->key_ptr = key_ptr;
+    match_ptr->config_ptr = config_ptr;
+    BS_ASSERT(bs_avltree_insert(
+                  backend_ptr->config_match_tree_ptr,
+                  match_ptr->key_ptr,
+                  &match_ptr->avlnode,
+                  false));
+    return config_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Comparator for @ref wlmbe_backend_t::config_match_tree_ptr. */
+int _wlmbe_backend_config_match_cmp(
+    const bs_avltree_node_t *avlnode_ptr,
+    const void *key_ptr)
+{
+    _wlmbe_backend_config_match_t *match_ptr = BS_CONTAINER_OF(
+        avlnode_ptr, _wlmbe_backend_config_match_t, avlnode);
+    return strcmp(match_ptr->key_ptr, key_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys a @ref _wlmbe_backend_config_match_t. */
+void _wlmbe_backend_config_match_destroy(bs_avltree_node_t *avlnode_ptr)
+{
+    _wlmbe_backend_config_match_t *match_ptr = BS_CONTAINER_OF(
+        avlnode_ptr, _wlmbe_backend_config_match_t, avlnode);
+    free(match_ptr->key_ptr);
+    free(match_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles the hotplug timer: Configures all pending outputs. */
+int _wlmbe_backend_handle_hotplug_timer(void *data_ptr)
+{
+    wlmbe_backend_configure_pending_outputs(data_ptr);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Tests and commits the state for a single output.
+ *
+ * @param wlr_backend_output_state_ptr
+ *
+ * @return true on success.
+ */
+bool _wlmbe_backend_commit_output_state(
+    struct wlr_backend_output_state *wlr_backend_output_state_ptr)
+{
+    struct wlr_output *wlrop = wlr_backend_output_state_ptr->output;
+    if (!wlr_output_test_state(wlrop, &wlr_backend_output_state_ptr->base)) {
+        bs_log(BS_ERROR, "Failed wlr_output_test_state() on %s",
+               wlrop->name);
+        return false;
+    }
+    if (!wlr_output_commit_state(wlrop, &wlr_backend_output_state_ptr->base)) {
+        bs_log(BS_ERROR, "Failed wlr_output_commit_state() on %s",
+               wlrop->name);
+        return false;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Sends frame callbacks to surfaces that are not shown on any output. These
+ * do not get any from rendering, but some clients stall without. Keeps them
+ * at a low rate, rather than the output's refresh rate.
+ *
+ * @param data_ptr            Points to the @ref wlmbe_backend_t.
+ *
+ * @return 0.
+ */
+int _wlmbe_backend_handle_keepalive_timer(void *data_ptr)
+{
+    wlmbe_backend_t *backend_ptr = data_ptr;
+
+    // No output is powered: Nothing to keep alive for. Pause, and let
+    // @ref _wlmbe_backend_resume_keepalive re-arm once one powers on.
+    if (!_wlmbe_backend_any_output_powered(backend_ptr)) {
+        backend_ptr->keepalive_paused = true;
+        return 0;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    wlmtk_util_wl_list_for_each(
+        &backend_ptr->wlr_scene_ptr->tree.children,
+        _wlmbe_backend_keepalive_node,
+        &now);
+
+    wl_event_source_timer_update(
+        backend_ptr->keepalive_timer_ptr,
+        backend_ptr->hidden_keepalive_msec);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Whether any of @ref wlmbe_backend_t::outputs is powered. */
+bool _wlmbe_backend_any_output_powered(wlmbe_backend_t *backend_ptr)
+{
+    for (bs_dllist_node_t *dlnode_ptr = backend_ptr->outputs.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        if (wlmbe_output_powered(wlmbe_output_from_dlnode(dlnode_ptr))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Re-arms @ref wlmbe_backend_t::keepalive_timer_ptr, if it was paused. */
+void _wlmbe_backend_resume_keepalive(wlmbe_backend_t *backend_ptr)
+{
+    if (!backend_ptr->keepalive_paused) return;
+    backend_ptr->keepalive_paused = false;
+    wl_event_source_timer_update(
+        backend_ptr->keepalive_timer_ptr,
+        backend_ptr->hidden_keepalive_msec);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for `set_mode` of the output power manager: Powers the output on
+ * or off, as requested by the client.
+ *
+ * @param listener_ptr
+ * @param data_ptr            Points to a
+ *                            `struct wlr_output_power_v1_set_mode_event`.
+ */
+void _wlmbe_backend_handle_output_power_set_mode(
+    struct wl_listener *listener_ptr,
+    void *data_ptr)
+{
+    wlmbe_backend_t *backend_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmbe_backend_t, output_power_set_mode_listener);
+    struct wlr_output_power_v1_set_mode_event *event_ptr = data_ptr;
+
+    wlmbe_output_t *output_ptr = event_ptr->output->data;
+    if (NULL == output_ptr) return;
+    bool powered = ZWLR_OUTPUT_POWER_V1_MODE_ON == event_ptr->mode;
+    wlmbe_output_set_powered(output_ptr, powered);
+    if (powered) _wlmbe_backend_resume_keepalive(backend_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Iterator callback: Sends a frame callback to the node's surface, if the
+ * node is not shown on any output. Recurses into trees, including disabled
+ * ones.
+ *
+ * @param link_ptr            To struct wlr_scene_node::link.
+ * @param ud_ptr              Points to the struct timespec to send.
+ *
+ * @return true.
+ */
+bool _wlmbe_backend_keepalive_node(
+    struct wl_list *link_ptr,
+    void *ud_ptr)
+{
+    struct wlr_scene_node *wlr_scene_node_ptr = BS_CONTAINER_OF(
+        link_ptr, struct wlr_scene_node, link);
+
+    if (WLR_SCENE_NODE_TREE == wlr_scene_node_ptr->type) {
+        return wlmtk_util_wl_list_for_each(
+            &wlr_scene_tree_from_node(wlr_scene_node_ptr)->children,
+            _wlmbe_backend_keepalive_node,
+            ud_ptr);
+    }
+    if (WLR_SCENE_NODE_BUFFER != wlr_scene_node_ptr->type) return true;
+
+    struct wlr_scene_buffer *wlr_scene_buffer_ptr =
+        wlr_scene_buffer_from_node(wlr_scene_node_ptr);
+    if (NULL != wlr_scene_buffer_ptr->primary_output) return true;
+    struct wlr_scene_surface *wlr_scene_surface_ptr =
+        wlr_scene_surface_try_from_buffer(wlr_scene_buffer_ptr);
+    if (NULL == wlr_scene_surface_ptr) return true;
+
+    wlr_surface_send_frame_done(wlr_scene_surface_ptr->surface, ud_ptr);
+    return true;
+}
+
 /* == Unit tests =========================================================== */
 
 static void _wlmbe_backend_test_find(bs_test_t *test_ptr);
+static void _wlmbe_backend_test_frame_callbacks(bs_test_t *test_ptr);
+static void _wlmbe_backend_test_rendering(bs_test_t *test_ptr);
 
 const bs_test_case_t          wlmbe_backend_test_cases[] = {
     { 1, "find", _wlmbe_backend_test_find },
+    { 1, "frame_callbacks", _wlmbe_backend_test_frame_callbacks },
+    { 1, "rendering", _wlmbe_backend_test_rendering },
     { 0, NULL, NULL }
 };
 
@@ -575,10 +1503,68 @@ void _wlmbe_backend_test_find(bs_test_t *test_ptr)
     BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, o);
     BS_TEST_VERIFY_EQ(test_ptr, 1.0, wlmbe_output_config_attributes(o)->scale);
 
+    // Same, through the cache. Repeated lookups hit the same entry.
+    be.config_match_tree_ptr = bs_avltree_create(
+        _wlmbe_backend_config_match_cmp,
+        _wlmbe_backend_config_match_destroy);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, be.config_match_tree_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, o, _wlmbe_backend_find_output_config(&be, &wlr_output));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, o, _wlmbe_backend_find_output_config(&be, &wlr_output));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, bs_avltree_size(be.config_match_tree_ptr));
+    wlr_output.name = "HDMI-1";
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL, _wlmbe_backend_find_output_config(&be, &wlr_output));
+    BS_TEST_VERIFY_EQ(test_ptr, 2, bs_avltree_size(be.config_match_tree_ptr));
+    bs_avltree_destroy(be.config_match_tree_ptr);
+
     bspl_decoded_destroy(_wlmbe_outputs_state_desc, &be);
     bspl_decoded_destroy(_wlmbe_output_configs_desc, &be);
     bspl_dict_unref(state_dict_ptr);
     bspl_dict_unref(config_dict_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests decoding the "FrameCallbacks" dict, and it's default. */
+void _wlmbe_backend_test_frame_callbacks(bs_test_t *test_ptr)
+{
+    wlmbe_backend_t be = {};
+    bspl_dict_t *dict_ptr = bspl_dict_from_object(
+        bspl_create_object_from_plist_string("{HiddenKeepalive = 250;}"));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, dict_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        bspl_decode_dict(dict_ptr, _wlmbe_frame_callbacks_desc, &be));
+    BS_TEST_VERIFY_EQ(test_ptr, 250, be.hidden_keepalive_msec);
+    bspl_dict_unref(dict_ptr);
+
+    dict_ptr = bspl_dict_from_object(
+        bspl_create_object_from_plist_string("{}"));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, dict_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        bspl_decode_dict(dict_ptr, _wlmbe_frame_callbacks_desc, &be));
+    BS_TEST_VERIFY_EQ(test_ptr, 1000, be.hidden_keepalive_msec);
+    bspl_dict_unref(dict_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests decoding the "Rendering" dict. */
+void _wlmbe_backend_test_rendering(bs_test_t *test_ptr)
+{
+    wlmbe_backend_t be = {};
+    bspl_dict_t *dict_ptr = bspl_dict_from_object(
+        bspl_create_object_from_plist_string(
+            "{Devices = \"/dev/dri/card1:/dev/dri/card0\";}"));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, dict_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        bspl_decode_dict(dict_ptr, _wlmbe_rendering_desc, &be));
+    BS_TEST_VERIFY_STREQ(
+        test_ptr, "/dev/dri/card1:/dev/dri/card0", be.render_devices_ptr);
+    bspl_decoded_destroy(_wlmbe_rendering_desc, &be);
+    bspl_dict_unref(dict_ptr);
+}
+
 /* == End of backend.c ===================================================== */
@@ -0,0 +1,419 @@
+/* ========================================================================= */
+/**
+ * @file magnifier.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "magnifier.h"
+
+#include <drm_fourcc.h>
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#define WLR_USE_UNSTABLE
+#include <wlr/render/allocator.h>
+#include <wlr/render/drm_format_set.h>
+#include <wlr/render/pass.h>
+#include <wlr/render/swapchain.h>
+#include <wlr/render/wlr_renderer.h>
+#include <wlr/render/wlr_texture.h>
+#include <wlr/types/wlr_buffer.h>
+#include <wlr/types/wlr_output.h>
+#include <wlr/util/box.h>
+#include <wlr/version.h>
+#undef WLR_USE_UNSTABLE
+
+/* == Declarations ========================================================= */
+
+/** State of the magnifier. */
+struct _wlmbe_magnifier_t {
+    /** Current zoom. */
+    double                    zoom;
+    /** Current focus, horizontal, in buffer pixels. */
+    double                    x;
+    /** Current focus, vertical, in buffer pixels. */
+    double                    y;
+    /** Zoom to animate towards. */
+    double                    target_zoom;
+    /** Focus to animate towards, horizontal. */
+    double                    target_x;
+    /** Focus to animate towards, vertical. */
+    double                    target_y;
+    /** Time of the previous step, in milliseconds. 0 for none. */
+    uint64_t                  step_msec;
+
+    /** Swapchain the scene gets rendered into. Created lazily. */
+    struct wlr_swapchain      *wlr_swapchain_ptr;
+    /** The scene's most recent buffer. Locked, or NULL. */
+    struct wlr_buffer         *wlr_buffer_ptr;
+};
+
+static double _wlmbe_magnifier_approach(
+    double value,
+    double target,
+    double snap,
+    uint64_t dt_msec);
+static void _wlmbe_magnifier_viewport(
+    double zoom,
+    double x,
+    double y,
+    int width,
+    int height,
+    struct wlr_fbox *fbox_ptr);
+static void _wlmbe_magnifier_release(wlmbe_magnifier_t *magnifier_ptr);
+
+/* == Data ================================================================= */
+
+/** Time for closing half the distance to the target, in milliseconds. */
+static const uint64_t _wlmbe_magnifier_half_msec = 60;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmbe_magnifier_t *wlmbe_magnifier_create(void)
+{
+    wlmbe_magnifier_t *magnifier_ptr = logged_calloc(
+        1, sizeof(wlmbe_magnifier_t));
+    if (NULL == magnifier_ptr) return NULL;
+    magnifier_ptr->zoom = 1.0;
+    magnifier_ptr->target_zoom = 1.0;
+    return magnifier_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmbe_magnifier_destroy(wlmbe_magnifier_t *magnifier_ptr)
+{
+    _wlmbe_magnifier_release(magnifier_ptr);
+    free(magnifier_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmbe_magnifier_set_target(
+    wlmbe_magnifier_t *magnifier_ptr,
+    double zoom,
+    double x,
+    double y)
+{
+    // Restarts the frame clock, if idle: No jump for the time spent idle.
+    if (!wlmbe_magnifier_animating(magnifier_ptr)) {
+        magnifier_ptr->step_msec = 0;
+    }
+    if (!wlmbe_magnifier_active(magnifier_ptr)) {
+        // Zooming in from none: Start right at the focus.
+        magnifier_ptr->x = x;
+        magnifier_ptr->y = y;
+    }
+    magnifier_ptr->target_zoom = BS_MAX(1.0, zoom);
+    magnifier_ptr->target_x = x;
+    magnifier_ptr->target_y = y;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmbe_magnifier_step(wlmbe_magnifier_t *magnifier_ptr, uint64_t now_msec)
+{
+    uint64_t dt_msec = 0;
+    if (0 != magnifier_ptr->step_msec && now_msec > magnifier_ptr->step_msec) {
+        dt_msec = now_msec - magnifier_ptr->step_msec;
+    }
+    magnifier_ptr->step_msec = now_msec;
+
+    double zoom = _wlmbe_magnifier_approach(
+        magnifier_ptr->zoom, magnifier_ptr->target_zoom, 1e-3, dt_msec);
+    double x = _wlmbe_magnifier_approach(
+        magnifier_ptr->x, magnifier_ptr->target_x, 0.25, dt_msec);
+    double y = _wlmbe_magnifier_approach(
+        magnifier_ptr->y, magnifier_ptr->target_y, 0.25, dt_msec);
+    bool changed = (zoom != magnifier_ptr->zoom ||
+                    x != magnifier_ptr->x ||
+                    y != magnifier_ptr->y);
+    magnifier_ptr->zoom = zoom;
+    magnifier_ptr->x = x;
+    magnifier_ptr->y = y;
+
+    // Done zooming out: The swapchain and buffer are no longer needed.
+    if (!wlmbe_magnifier_active(magnifier_ptr)) {
+        _wlmbe_magnifier_release(magnifier_ptr);
+    }
+    return changed;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmbe_magnifier_active(wlmbe_magnifier_t *magnifier_ptr)
+{
+    return 1.0 < magnifier_ptr->zoom || 1.0 < magnifier_ptr->target_zoom;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmbe_magnifier_animating(wlmbe_magnifier_t *magnifier_ptr)
+{
+    return (magnifier_ptr->zoom != magnifier_ptr->target_zoom ||
+            magnifier_ptr->x != magnifier_ptr->target_x ||
+            magnifier_ptr->y != magnifier_ptr->target_y);
+}
+
+/* ------------------------------------------------------------------------- */
+struct wlr_swapchain *wlmbe_magnifier_swapchain(
+    wlmbe_magnifier_t *magnifier_ptr,
+    struct wlr_output *wlr_output_ptr)
+{
+    if (!wlmbe_magnifier_active(magnifier_ptr)) return NULL;
+
+    struct wlr_swapchain *wlr_swapchain_ptr = magnifier_ptr->wlr_swapchain_ptr;
+    if (NULL != wlr_swapchain_ptr &&
+        wlr_swapchain_ptr->width == wlr_output_ptr->width &&
+        wlr_swapchain_ptr->height == wlr_output_ptr->height) {
+        return wlr_swapchain_ptr;
+    }
+    _wlmbe_magnifier_release(magnifier_ptr);
+
+    uint64_t modifier = DRM_FORMAT_MOD_INVALID;
+    struct wlr_drm_format format = {
+        .format = DRM_FORMAT_XRGB8888,
+        .len = 1,
+        .capacity = 1,
+        .modifiers = &modifier
+    };
+    if (0 != wlr_output_ptr->render_format) {
+        format.format = wlr_output_ptr->render_format;
+    }
+    magnifier_ptr->wlr_swapchain_ptr = wlr_swapchain_create(
+        wlr_output_ptr->allocator,
+        wlr_output_ptr->width, wlr_output_ptr->height,
+        &format);
+    if (NULL == magnifier_ptr->wlr_swapchain_ptr) {
+        bs_log(BS_WARNING, "Failed wlr_swapchain_create(%p, %d, %d) for %s",
+               wlr_output_ptr->allocator,
+               wlr_output_ptr->width, wlr_output_ptr->height,
+               wlr_output_ptr->name);
+    }
+    return magnifier_ptr->wlr_swapchain_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmbe_magnifier_render(
+    wlmbe_magnifier_t *magnifier_ptr,
+    struct wlr_output *wlr_output_ptr,
+    struct wlr_output_state *state_ptr)
+{
+    if ((state_ptr->committed & WLR_OUTPUT_STATE_BUFFER) &&
+        NULL != state_ptr->buffer) {
+        if (NULL != magnifier_ptr->wlr_buffer_ptr) {
+            wlr_buffer_unlock(magnifier_ptr->wlr_buffer_ptr);
+        }
+        magnifier_ptr->wlr_buffer_ptr = wlr_buffer_lock(state_ptr->buffer);
+    }
+    if (NULL == magnifier_ptr->wlr_buffer_ptr) return false;
+
+    struct wlr_texture *wlr_texture_ptr = wlr_texture_from_buffer(
+        wlr_output_ptr->renderer, magnifier_ptr->wlr_buffer_ptr);
+    if (NULL == wlr_texture_ptr) {
+        bs_log(BS_WARNING, "Failed wlr_texture_from_buffer(%p, %p) for %s",
+               wlr_output_ptr->renderer, magnifier_ptr->wlr_buffer_ptr,
+               wlr_output_ptr->name);
+        return false;
+    }
+    // Replaces the scene's buffer in `state_ptr` by one of the output.
+#if WLR_VERSION_NUM >= (19 << 8)
+    struct wlr_render_pass *wlr_render_pass_ptr =
+        wlr_output_begin_render_pass(wlr_output_ptr, state_ptr, NULL);
+#else  // WLR_VERSION_NUM >= (19 << 8)
+    struct wlr_render_pass *wlr_render_pass_ptr =
+        wlr_output_begin_render_pass(wlr_output_ptr, state_ptr, NULL, NULL);
+#endif  // WLR_VERSION_NUM >= (19 << 8)
+    if (NULL == wlr_render_pass_ptr) {
+        bs_log(BS_WARNING, "Failed wlr_output_begin_render_pass(%p)",
+               wlr_output_ptr);
+        wlr_texture_destroy(wlr_texture_ptr);
+        return false;
+    }
+
+    struct wlr_fbox src_box;
+    _wlmbe_magnifier_viewport(
+        magnifier_ptr->zoom, magnifier_ptr->x, magnifier_ptr->y,
+        wlr_texture_ptr->width, wlr_texture_ptr->height, &src_box);
+    wlr_render_pass_add_texture(
+        wlr_render_pass_ptr,
+        &(struct wlr_render_texture_options){
+            .texture = wlr_texture_ptr,
+            .src_box = src_box,
+            .dst_box = { .width = wlr_output_ptr->width,
+                         .height = wlr_output_ptr->height },
+            .filter_mode = WLR_SCALE_FILTER_BILINEAR,
+            .blend_mode = WLR_RENDER_BLEND_MODE_NONE });
+    bool rv = wlr_render_pass_submit(wlr_render_pass_ptr);
+    wlr_texture_destroy(wlr_texture_ptr);
+    if (!rv) {
+        bs_log(BS_WARNING, "Failed wlr_render_pass_submit() for %s",
+               wlr_output_ptr->name);
+        return false;
+    }
+    // The scene's damage does not apply to the scaled viewport.
+    state_ptr->committed &= ~WLR_OUTPUT_STATE_DAMAGE;
+    return true;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Moves `value` towards `target`, in a step for `dt_msec` elapsed. Closes
+ * half the distance within @ref _wlmbe_magnifier_half_msec.
+ *
+ * @param value
+ * @param target
+ * @param snap                Distance below which `target` is returned.
+ * @param dt_msec
+ *
+ * @return The new value.
+ */
+double _wlmbe_magnifier_approach(
+    double value,
+    double target,
+    double snap,
+    uint64_t dt_msec)
+{
+    double d = (target - value) * _wlmbe_magnifier_half_msec /
+        (double)(_wlmbe_magnifier_half_msec + dt_msec);
+    if (-snap < d && d < snap) return target;
+    return target - d;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes the viewport for `zoom` into a buffer of `width` x `height`. The
+ * point at the focus `x`, `y` remains in place.
+ *
+ * @param zoom
+ * @param x
+ * @param y
+ * @param width
+ * @param height
+ * @param fbox_ptr            Set to the viewport, in buffer pixels.
+ */
+void _wlmbe_magnifier_viewport(
+    double zoom,
+    double x,
+    double y,
+    int width,
+    int height,
+    struct wlr_fbox *fbox_ptr)
+{
+    zoom = BS_MAX(1.0, zoom);
+    x = BS_MIN(BS_MAX(0.0, x), (double)width);
+    y = BS_MIN(BS_MAX(0.0, y), (double)height);
+    fbox_ptr->width = width / zoom;
+    fbox_ptr->height = height / zoom;
+    fbox_ptr->x = x * (1.0 - 1.0 / zoom);
+    fbox_ptr->y = y * (1.0 - 1.0 / zoom);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Releases the swapchain and the scene's buffer. */
+void _wlmbe_magnifier_release(wlmbe_magnifier_t *magnifier_ptr)
+{
+    if (NULL != magnifier_ptr->wlr_buffer_ptr) {
+        wlr_buffer_unlock(magnifier_ptr->wlr_buffer_ptr);
+        magnifier_ptr->wlr_buffer_ptr = NULL;
+    }
+    if (NULL != magnifier_ptr->wlr_swapchain_ptr) {
+        wlr_swapchain_destroy(magnifier_ptr->wlr_swapchain_ptr);
+        magnifier_ptr->wlr_swapchain_ptr = NULL;
+    }
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlmbe_magnifier_test_step(bs_test_t *test_ptr);
+static void _wlmbe_magnifier_test_viewport(bs_test_t *test_ptr);
+
+const bs_test_case_t          wlmbe_magnifier_test_cases[] = {
+    { 1, "step", _wlmbe_magnifier_test_step },
+    { 1, "viewport", _wlmbe_magnifier_test_viewport },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Exercises the animation of zoom and focus, on the frame clock. */
+void _wlmbe_magnifier_test_step(bs_test_t *test_ptr)
+{
+    wlmbe_magnifier_t *m = wlmbe_magnifier_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, m);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmbe_magnifier_active(m));
+
+    // Zooming in: Starts at the focus. The first step starts the clock.
+    wlmbe_magnifier_set_target(m, 2.0, 100, 50);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmbe_magnifier_active(m));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmbe_magnifier_animating(m));
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmbe_magnifier_step(m, 1000));
+    BS_TEST_VERIFY_EQ(test_ptr, 1.0, m->zoom);
+    BS_TEST_VERIFY_EQ(test_ptr, 100, m->x);
+
+    // Half-way after the half time. Then approaches, and snaps.
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmbe_magnifier_step(m, 1060));
+    BS_TEST_VERIFY_EQ(test_ptr, 1.5, m->zoom);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmbe_magnifier_step(m, 1120));
+    BS_TEST_VERIFY_EQ(test_ptr, 1.75, m->zoom);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmbe_magnifier_step(m, 60000));
+    BS_TEST_VERIFY_EQ(test_ptr, 2.0, m->zoom);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmbe_magnifier_animating(m));
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmbe_magnifier_step(m, 60010));
+
+    // Idle for a while: The new target is approached gradually.
+    wlmbe_magnifier_set_target(m, 2.0, 200, 50);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmbe_magnifier_step(m, 90000));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmbe_magnifier_step(m, 90060));
+    BS_TEST_VERIFY_EQ(test_ptr, 150, m->x);
+
+    // Zooming out: Remains active until back at 1.0.
+    wlmbe_magnifier_set_target(m, 0.5, 200, 50);
+    BS_TEST_VERIFY_EQ(test_ptr, 1.0, m->target_zoom);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmbe_magnifier_step(m, 90120));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmbe_magnifier_active(m));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmbe_magnifier_step(m, 120000));
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmbe_magnifier_active(m));
+
+    wlmbe_magnifier_destroy(m);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies the viewport keeps the focus in place, and within bounds. */
+void _wlmbe_magnifier_test_viewport(bs_test_t *test_ptr)
+{
+    struct wlr_fbox b;
+    _wlmbe_magnifier_viewport(1.0, 100, 100, 800, 600, &b);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, b.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, b.y);
+    BS_TEST_VERIFY_EQ(test_ptr, 800, b.width);
+    BS_TEST_VERIFY_EQ(test_ptr, 600, b.height);
+
+    // Focus at the center: Viewport is centered. The focus maps to itself.
+    _wlmbe_magnifier_viewport(2.0, 400, 300, 800, 600, &b);
+    BS_TEST_VERIFY_EQ(test_ptr, 200, b.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 150, b.y);
+    BS_TEST_VERIFY_EQ(test_ptr, 400, b.width);
+    BS_TEST_VERIFY_EQ(test_ptr, 300, b.height);
+
+    // Focus at (or beyond) the bottom-right corner: Viewport stays inside.
+    _wlmbe_magnifier_viewport(4.0, 1000, 600, 800, 600, &b);
+    BS_TEST_VERIFY_EQ(test_ptr, 600, b.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 450, b.y);
+    BS_TEST_VERIFY_EQ(test_ptr, 200, b.width);
+    BS_TEST_VERIFY_EQ(test_ptr, 150, b.height);
+}
+
+/* == End of magnifier.c =================================================== */
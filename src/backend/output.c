@@ -20,8 +20,11 @@
 
 #include "output.h"
 
+#include "magnifier.h"
+
 #include <inttypes.h>
 #include <libbase/libbase.h>
+#include <pixman.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <time.h>
@@ -30,11 +33,23 @@
 #include <wayland-server-core.h>
 #include <wayland-util.h>
 #define WLR_USE_UNSTABLE
+#include <wlr/backend/drm.h>
 #include <wlr/backend/wayland.h>
 #include <wlr/backend/x11.h>
 #include <wlr/render/allocator.h>
+#include <wlr/render/pass.h>
+#include <wlr/render/swapchain.h>
+#include <wlr/render/wlr_renderer.h>
+#include <wlr/render/wlr_texture.h>
+#include <wlr/types/wlr_buffer.h>
+#include <wlr/types/wlr_compositor.h>
+#include <wlr/types/wlr_content_type_v1.h>
 #include <wlr/types/wlr_output.h>
 #include <wlr/types/wlr_scene.h>
+#include <wlr/version.h>
+#if WLR_VERSION_NUM >= (18 << 8)
+#include <wlr/types/wlr_tearing_control_v1.h>
+#endif  // WLR_VERSION_NUM >= (18 << 8)
 #undef WLR_USE_UNSTABLE
 
 /* == Declarations ========================================================= */
@@ -50,6 +65,45 @@ struct _wlmbe_output_t {
     struct wl_listener        output_frame_listener;
     /** Listener for `request_state` signals raised by `wlr_output`. */
     struct wl_listener        output_request_state_listener;
+    /** Listener for `present` signals raised by `wlr_output`. */
+    struct wl_listener        output_present_listener;
+    /** Listener for `commit` signals of the mirrored `wlr_output`. */
+    struct wl_listener        source_commit_listener;
+    /** Listener for `destroy` signals of the mirrored `wlr_output`. */
+    struct wl_listener        source_destroy_listener;
+
+    /** Tracks latency from input events to frames shown on this output. */
+    wlmtk_latency_t           latency;
+
+    /** Timer for committing late in the refresh period. Created lazily. */
+    struct wl_event_source    *latch_timer_ptr;
+    /** Running estimate of a commit's duration, in nanoseconds. */
+    uint64_t                  render_estimate_nsec;
+    /** Time of the most recent presentation, in nanoseconds. 0 if none. */
+    uint64_t                  presented_nsec;
+    /** Time of the most recent commit, not yet presented. 0 if none. */
+    uint64_t                  committed_nsec;
+    /** Frame timing statistics. */
+    wlmbe_output_stats_t      stats;
+    /** Adaptive sync state last requested, to not retry on each frame. */
+    bool                      adaptive_sync_requested;
+    /** Whether powered off, by @ref wlmbe_output_set_powered. */
+    bool                      powered_off;
+    /** Whether frames are held back, by @ref wlmbe_output_set_held. */
+    bool                      held;
+    /**
+     * Whether frames are rendered on another GPU than the one driving this
+     * output, and must be copied across devices for each frame.
+     */
+    bool                      cross_device_copy;
+    /** Buffer last committed to the mirrored output. Locked, or NULL. */
+    struct wlr_buffer         *mirror_wlr_buffer_ptr;
+    /** Whether @ref wlmbe_output_t::mirror_wlr_buffer_ptr is not shown yet. */
+    bool                      mirror_pending;
+    /** Magnifier, see @ref wlmbe_output_set_magnification. Created lazily. */
+    wlmbe_magnifier_t         *magnifier_ptr;
+    /** Whether the cursor was last composited, for logging a change. */
+    bool                      software_cursor;
 
     /** Descriptive name, showing manufacturer, model and serial. */
     char                      *description_ptr;
@@ -61,8 +115,26 @@ struct _wlmbe_output_t {
     struct wlr_scene          *wlr_scene_ptr;
     /** Attributes of the output configuration. */
     wlmbe_output_config_attributes_t *attributes_ptr;
+    /** Toolkit root, for looking up fullscreen windows. May be NULL. */
+    wlmtk_root_t              *root_ptr;
+    /** The mirrored output, see @ref wlmbe_output_set_mirror_source. */
+    struct wlr_output         *source_wlr_output_ptr;
+    /** Async presentation hints of surfaces. May be NULL. */
+    struct wlr_tearing_control_manager_v1 *wlr_tearing_control_manager_v1_ptr;
+    /** Content type hints of surfaces. May be NULL. */
+    struct wlr_content_type_manager_v1 *wlr_content_type_manager_v1_ptr;
 };
 
+/** Argument to @ref _wlmbe_output_find_covering_surface. */
+typedef struct {
+    /** Effective width of the output. */
+    int                       width;
+    /** Effective height of the output. */
+    int                       height;
+    /** The topmost surface covering all of the output, or NULL. */
+    struct wlr_surface        *wlr_surface_ptr;
+} _wlmbe_output_covering_surface_arg_t;
+
 static void _wlmbe_output_handle_destroy(
     struct wl_listener *listener_ptr,
     void *data_ptr);
@@ -72,6 +144,62 @@ static void _wlmbe_output_handle_frame(
 static void _wlmbe_output_handle_request_state(
     struct wl_listener *listener_ptr,
     void *data_ptr);
+static void _wlmbe_output_handle_present(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmbe_output_handle_source_commit(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmbe_output_handle_source_destroy(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmbe_output_commit_mirror(wlmbe_output_t *output_ptr);
+static bool _wlmbe_output_blit_mirror(
+    wlmbe_output_t *output_ptr,
+    struct wlr_output_state *state_ptr,
+    struct wlr_buffer *wlr_buffer_ptr,
+    enum wl_output_transform transform);
+static uint32_t _wlmbe_output_msec(const struct timespec *timespec_ptr);
+static uint64_t _wlmbe_output_nsec(const struct timespec *timespec_ptr);
+static void _wlmbe_output_commit(wlmbe_output_t *output_ptr);
+static void _wlmbe_output_tick_animations(wlmbe_output_t *output_ptr);
+static bool _wlmbe_output_step_magnifier(
+    wlmbe_output_t *output_ptr,
+    struct wlr_scene_output *wlr_scene_output_ptr);
+static void _wlmbe_output_damage_whole(
+    struct wlr_scene_output *wlr_scene_output_ptr);
+static void _wlmbe_output_commit_scene(
+    wlmbe_output_t *output_ptr,
+    struct wlr_scene_output *wlr_scene_output_ptr);
+static bool _wlmbe_output_adaptive_sync_wanted(
+    wlmbe_output_t *output_ptr,
+    struct wlr_surface *fullscreen_wlr_surface_ptr);
+static bool _wlmbe_output_tearing_wanted(
+    wlmbe_output_t *output_ptr,
+    struct wlr_surface *fullscreen_wlr_surface_ptr);
+static enum wp_content_type_v1_type _wlmbe_output_content_type(
+    wlmbe_output_t *output_ptr,
+    struct wlr_surface *wlr_surface_ptr);
+static struct wlr_surface *_wlmbe_output_fullscreen_surface(
+    wlmbe_output_t *output_ptr,
+    struct wlr_scene_output *wlr_scene_output_ptr);
+static void _wlmbe_output_find_covering_surface(
+    struct wlr_scene_buffer *wlr_scene_buffer_ptr,
+    int sx,
+    int sy,
+    void *ud_ptr);
+static uint64_t _wlmbe_output_latch_delay_msec(wlmbe_output_t *output_ptr);
+static int _wlmbe_output_handle_latch_timer(void *data_ptr);
+static void _wlmbe_output_stats_presented(
+    wlmbe_output_t *output_ptr,
+    uint64_t when_nsec,
+    uint64_t period_nsec);
+static void _wlmbe_output_count_buffer(
+    struct wlr_scene_buffer *wlr_scene_buffer_ptr,
+    int sx,
+    int sy,
+    void *ud_ptr);
+static void _wlmbe_output_stats_cursor(wlmbe_output_t *output_ptr);
 
 /* == Data ================================================================= */
 
@@ -83,11 +211,10 @@ wlmbe_output_t *wlmbe_output_create(
     struct wlr_allocator *wlr_allocator_ptr,
     struct wlr_renderer *wlr_renderer_ptr,
     struct wlr_scene *wlr_scene_ptr,
-    wlmbe_output_config_t *config_ptr,
-    int width,
-    int height)
+    wlmbe_output_config_t *config_ptr)
 {
-    wlmbe_output_t *output_ptr = logged_calloc(1, sizeof(wlmbe_output_t));
+    // From the locked arena, if enabled: Holds the frame statistics.
+    wlmbe_output_t *output_ptr = wlmtk_arena_calloc(sizeof(wlmbe_output_t));
     if (NULL == output_ptr) return NULL;
     output_ptr->wlr_output_ptr = wlr_output_ptr;
     output_ptr->wlr_scene_ptr = wlr_scene_ptr;
@@ -104,6 +231,7 @@ wlmbe_output_t *wlmbe_output_create(
         wlmbe_output_destroy(output_ptr);
         return NULL;
     }
+    wlmtk_latency_init(&output_ptr->latency, output_ptr->description_ptr);
 
     wlmtk_util_connect_listener_signal(
         &output_ptr->wlr_output_ptr->events.destroy,
@@ -117,6 +245,10 @@ wlmbe_output_t *wlmbe_output_create(
         &output_ptr->wlr_output_ptr->events.request_state,
         &output_ptr->output_request_state_listener,
         _wlmbe_output_handle_request_state);
+    wlmtk_util_connect_listener_signal(
+        &output_ptr->wlr_output_ptr->events.present,
+        &output_ptr->output_present_listener,
+        _wlmbe_output_handle_present);
 
     // From tinwywl: Configures the output created by the backend to use our
     // allocator and our renderer. Must be done once, before commiting the
@@ -131,10 +263,33 @@ wlmbe_output_t *wlmbe_output_create(
         return NULL;
     }
 
-    struct wlr_output_state state;
-    wlr_output_state_init(&state);
-    wlr_output_state_set_enabled(&state, output_ptr->attributes_ptr->enabled);
-    wlr_output_state_set_scale(&state, output_ptr->attributes_ptr->scale);
+    output_ptr->adaptive_sync_requested =
+        WLR_OUTPUT_ADAPTIVE_SYNC_ENABLED ==
+        wlr_output_ptr->adaptive_sync_status;
+
+    // wlroots renders on the primary GPU. Outputs of a secondary GPU's DRM
+    // backend get each frame copied over.
+    output_ptr->cross_device_copy =
+        wlr_output_is_drm(wlr_output_ptr) &&
+        NULL != wlr_drm_backend_get_parent(wlr_output_ptr->backend);
+    bs_log(BS_INFO, "Output %s: Rendering %s",
+           wlr_output_ptr->name,
+           output_ptr->cross_device_copy ?
+           "on primary GPU, with cross-device copy" : "copy-free");
+    return output_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmbe_output_build_state(
+    wlmbe_output_t *output_ptr,
+    struct wlr_output_state *state_ptr,
+    int width,
+    int height)
+{
+    struct wlr_output *wlr_output_ptr = output_ptr->wlr_output_ptr;
+    wlr_output_state_set_enabled(
+        state_ptr, output_ptr->attributes_ptr->enabled);
+    wlr_output_state_set_scale(state_ptr, output_ptr->attributes_ptr->scale);
 
     // Issue #97: Found that X11 and transformations do not translate
     // cursor coordinates well. Force it to 'Normal'.
@@ -145,12 +300,12 @@ wlmbe_output_t *wlmbe_output_create(
         bs_log(BS_WARNING, "X11 backend: Transformation changed to 'Normal'.");
         transformation = WL_OUTPUT_TRANSFORM_NORMAL;
     }
-    wlr_output_state_set_transform(&state, transformation);
+    wlr_output_state_set_transform(state_ptr, transformation);
 
     // Set modes for backends that have them.
     if (output_ptr->attributes_ptr->has_mode) {
         wlr_output_state_set_custom_mode(
-            &state,
+            state_ptr,
             output_ptr->attributes_ptr->mode.width,
             output_ptr->attributes_ptr->mode.height,
             output_ptr->attributes_ptr->mode.refresh);
@@ -160,7 +315,7 @@ wlmbe_output_t *wlmbe_output_create(
                 output_ptr->wlr_output_ptr);
             bs_log(BS_INFO, "Setting mode %dx%d @ %.2fHz",
                    mode_ptr->width, mode_ptr->height, 1e-3 * mode_ptr->refresh);
-            wlr_output_state_set_mode(&state, mode_ptr);
+            wlr_output_state_set_mode(state_ptr, mode_ptr);
         } else {
             bs_log(BS_INFO, "No modes available on %s",
                    output_ptr->wlr_output_ptr->name);
@@ -173,28 +328,8 @@ wlmbe_output_t *wlmbe_output_create(
         bs_log(BS_INFO, "Overriding output dimensions to %"PRIu32"x%"PRIu32,
                width, height);
         wlr_output_state_set_custom_mode(
-            &state, width, height, 0);
+            state_ptr, width, height, 0);
     }
-
-    if (!wlr_output_test_state(output_ptr->wlr_output_ptr, &state)) {
-        bs_log(BS_ERROR, "Failed wlr_output_test_state() on %s",
-               output_ptr->wlr_output_ptr->name);
-        wlmbe_output_destroy(output_ptr);
-        wlr_output_state_finish(&state);
-        return NULL;
-    }
-
-    // Enable the output and commit.
-    bool rv = wlr_output_commit_state(output_ptr->wlr_output_ptr, &state);
-    wlr_output_state_finish(&state);
-    if (!rv) {
-        bs_log(BS_ERROR, "Failed wlr_output_commit_state() on %s",
-               output_ptr->wlr_output_ptr->name);
-        wlmbe_output_destroy(output_ptr);
-        return NULL;
-    }
-
-    return output_ptr;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -206,11 +341,52 @@ void wlmbe_output_destroy(wlmbe_output_t *output_ptr)
 
     _wlmbe_output_handle_destroy(&output_ptr->output_destroy_listener, NULL);
 
+    if (NULL != output_ptr->magnifier_ptr) {
+        wlmbe_magnifier_destroy(output_ptr->magnifier_ptr);
+        output_ptr->magnifier_ptr = NULL;
+    }
     if (NULL != output_ptr->description_ptr) {
+        wlmtk_latency_fini(&output_ptr->latency);
         free(output_ptr->description_ptr);
         output_ptr->description_ptr = NULL;
     }
-    free(output_ptr);
+    wlmtk_arena_free(output_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmbe_output_log_stats(
+    wlmbe_output_t *output_ptr,
+    bs_log_severity_t severity)
+{
+    const wlmbe_output_stats_t *s = &output_ptr->stats;
+    uint64_t c = BS_MAX(s->commits, 1u);
+    uint64_t j = BS_MAX(s->jitter_samples, 1u);
+    bs_log(severity, "Output %s: %"PRIu64" commits, "
+           "commit %.3f ms avg %.3f ms max, "
+           "%"PRIu64" missed vblanks, "
+           "jitter %.3f ms avg %.3f ms max (%"PRIu64" intervals), "
+           "%.1f buffers avg %"PRIu64" max, "
+           "damage %.0f px avg %"PRIu64" px max, "
+           "scanout %"PRIu64" direct %"PRIu64" composited, "
+           "%.1f occluded windows avg %"PRIu64" max, "
+           "cursor %"PRIu64" hardware %"PRIu64" software, %s",
+           output_ptr->description_ptr, s->commits,
+           s->commit_nsec_sum / 1e6 / c, s->commit_nsec_max / 1e6,
+           s->missed_vblanks,
+           s->jitter_nsec_sum / 1e6 / j, s->jitter_nsec_max / 1e6,
+           s->jitter_samples,
+           (double)s->buffers_sum / c, s->buffers_max,
+           (double)s->damage_px_sum / c, s->damage_px_max,
+           s->scanout_hits, s->scanout_misses,
+           (double)s->occluded_sum / c, s->occluded_max,
+           s->cursor_hardware, s->cursor_software,
+           output_ptr->cross_device_copy ? "cross-device copy" : "copy-free");
+}
+
+/* ------------------------------------------------------------------------- */
+const wlmbe_output_stats_t *wlmbe_output_get_stats(wlmbe_output_t *output_ptr)
+{
+    return &output_ptr->stats;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -225,6 +401,142 @@ struct wlr_output *wlmbe_wlr_output_from_output(wlmbe_output_t *output_ptr)
     return output_ptr->wlr_output_ptr;
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmbe_output_set_root(wlmbe_output_t *output_ptr, wlmtk_root_t *root_ptr)
+{
+    output_ptr->root_ptr = root_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmbe_output_set_hint_managers(
+    wlmbe_output_t *output_ptr,
+    struct wlr_tearing_control_manager_v1 *wlr_tearing_control_manager_v1_ptr,
+    struct wlr_content_type_manager_v1 *wlr_content_type_manager_v1_ptr)
+{
+    output_ptr->wlr_tearing_control_manager_v1_ptr =
+        wlr_tearing_control_manager_v1_ptr;
+    output_ptr->wlr_content_type_manager_v1_ptr =
+        wlr_content_type_manager_v1_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmbe_output_set_powered(wlmbe_output_t *output_ptr, bool powered)
+{
+    struct wlr_output *wlr_output_ptr = output_ptr->wlr_output_ptr;
+    if (NULL == wlr_output_ptr || !output_ptr->attributes_ptr->enabled) {
+        return false;
+    }
+    if (output_ptr->powered_off != powered) return true;
+
+    struct wlr_output_state state;
+    wlr_output_state_init(&state);
+    wlr_output_state_set_enabled(&state, powered);
+    bool rv = wlr_output_commit_state(wlr_output_ptr, &state);
+    wlr_output_state_finish(&state);
+    if (!rv) {
+        bs_log(BS_WARNING, "Failed to power %s output %s",
+               powered ? "on" : "off", wlr_output_ptr->name);
+        return false;
+    }
+    output_ptr->powered_off = !powered;
+    bs_log(BS_INFO, "Powered %s output %s",
+           powered ? "on" : "off", wlr_output_ptr->name);
+
+    if (powered) {
+        // The scene damages all of the re-enabled output: Draw it.
+        output_ptr->mirror_pending = NULL != output_ptr->mirror_wlr_buffer_ptr;
+        wlr_output_schedule_frame(wlr_output_ptr);
+    } else if (NULL != output_ptr->latch_timer_ptr) {
+        // Disarms a pending late commit.
+        wl_event_source_timer_update(output_ptr->latch_timer_ptr, 0);
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmbe_output_powered(wlmbe_output_t *output_ptr)
+{
+    return !output_ptr->powered_off;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmbe_output_set_held(wlmbe_output_t *output_ptr, bool held)
+{
+    if (output_ptr->held == held) return;
+    output_ptr->held = held;
+    if (!held && NULL != output_ptr->wlr_output_ptr) {
+        // Frames were dropped while held: Commit the accumulated damage.
+        wlr_output_schedule_frame(output_ptr->wlr_output_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmbe_output_set_mirror_source(
+    wlmbe_output_t *output_ptr,
+    wlmbe_output_t *source_ptr)
+{
+    struct wlr_output *source_wlr_output_ptr = NULL;
+    if (NULL != source_ptr) source_wlr_output_ptr = source_ptr->wlr_output_ptr;
+    if (source_wlr_output_ptr == output_ptr->source_wlr_output_ptr) return;
+
+    if (NULL != output_ptr->source_wlr_output_ptr) {
+        _wlmbe_output_handle_source_destroy(
+            &output_ptr->source_destroy_listener, NULL);
+    }
+    if (NULL == source_wlr_output_ptr) return;
+
+    output_ptr->source_wlr_output_ptr = source_wlr_output_ptr;
+    wlmtk_util_connect_listener_signal(
+        &source_wlr_output_ptr->events.commit,
+        &output_ptr->source_commit_listener,
+        _wlmbe_output_handle_source_commit);
+    wlmtk_util_connect_listener_signal(
+        &source_wlr_output_ptr->events.destroy,
+        &output_ptr->source_destroy_listener,
+        _wlmbe_output_handle_source_destroy);
+    bs_log(BS_INFO, "Output %s: Mirroring %s",
+           output_ptr->wlr_output_ptr->name, source_wlr_output_ptr->name);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmbe_output_set_magnification(
+    wlmbe_output_t *output_ptr,
+    double zoom,
+    double x,
+    double y)
+{
+    // Mirrors show the source's frames: Magnify the source, instead.
+    if (wlmbe_output_is_mirror(output_ptr)) return;
+    if (NULL == output_ptr->magnifier_ptr) {
+        if (1.0 >= zoom) return;
+        output_ptr->magnifier_ptr = wlmbe_magnifier_create();
+        if (NULL == output_ptr->magnifier_ptr) return;
+    }
+    bool was_active = wlmbe_magnifier_active(output_ptr->magnifier_ptr);
+    wlmbe_magnifier_set_target(output_ptr->magnifier_ptr, zoom, x, y);
+    if (NULL == output_ptr->wlr_output_ptr) return;
+
+    if (!was_active && wlmbe_magnifier_active(output_ptr->magnifier_ptr)) {
+        // The magnifier scales the scene's buffer: Needs one, rendered in
+        // full into the magnifier's swapchain.
+        struct wlr_scene_output *wlr_scene_output_ptr =
+            wlr_scene_get_scene_output(
+                output_ptr->wlr_scene_ptr, output_ptr->wlr_output_ptr);
+        if (NULL != wlr_scene_output_ptr) {
+            _wlmbe_output_damage_whole(wlr_scene_output_ptr);
+        }
+    }
+    if (wlmbe_magnifier_animating(output_ptr->magnifier_ptr)) {
+        wlr_output_schedule_frame(output_ptr->wlr_output_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmbe_output_is_mirror(wlmbe_output_t *output_ptr)
+{
+    return '\0' != output_ptr->attributes_ptr->mirror[0];
+}
+
 /* ------------------------------------------------------------------------- */
 wlmbe_output_config_attributes_t *wlmbe_output_attributes(
     wlmbe_output_t *output_ptr)
@@ -261,16 +573,32 @@ void _wlmbe_output_handle_destroy(
     wlmbe_output_t *output_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmbe_output_t, output_destroy_listener);
 
+    wl_list_remove(&output_ptr->output_present_listener.link);
     wl_list_remove(&output_ptr->output_request_state_listener.link);
     wl_list_remove(&output_ptr->output_frame_listener.link);
     wl_list_remove(&output_ptr->output_destroy_listener.link);
+    if (NULL != output_ptr->source_wlr_output_ptr) {
+        _wlmbe_output_handle_source_destroy(
+            &output_ptr->source_destroy_listener, NULL);
+    }
     output_ptr->wlr_output_ptr = NULL;
+
+    if (NULL != output_ptr->latch_timer_ptr) {
+        wl_event_source_remove(output_ptr->latch_timer_ptr);
+        output_ptr->latch_timer_ptr = NULL;
+    }
 }
 
 /* ------------------------------------------------------------------------- */
 /**
  * Event handler for the `frame` signal raised by `wlr_output`.
  *
+ * Sends the client frame callbacks, and commits. With a configured
+ * @ref wlmbe_output_config_attributes_t::render_deadline_msec, the commit is
+ * delayed until just before the next vertical blank, see
+ * @ref _wlmbe_output_latch_delay_msec. Client frame callbacks are sent right
+ * away then, so clients can still commit for this refresh period.
+ *
  * @param listener_ptr
  * @param data_ptr
  */
@@ -278,19 +606,809 @@ void _wlmbe_output_handle_frame(
     struct wl_listener *listener_ptr,
     __UNUSED__ void *data_ptr)
 {
+    WLMTK_TRACE_SPAN("output_frame");
     wlmbe_output_t *output_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmbe_output_t, output_frame_listener);
+    // Nothing to show while powered off. Neither commit, nor frame callbacks.
+    if (output_ptr->powered_off || output_ptr->held) return;
+    // Mirrors show the source's buffer. Its frame callbacks are sent there.
+    if (wlmbe_output_is_mirror(output_ptr)) {
+        _wlmbe_output_commit_mirror(output_ptr);
+        return;
+    }
 
     struct wlr_scene_output *wlr_scene_output_ptr = wlr_scene_get_scene_output(
         output_ptr->wlr_scene_ptr,
         output_ptr->wlr_output_ptr);
-    wlr_scene_output_commit(wlr_scene_output_ptr, NULL);
+
+    uint64_t delay_msec = _wlmbe_output_latch_delay_msec(output_ptr);
+    if (0 < delay_msec && NULL == output_ptr->latch_timer_ptr) {
+        output_ptr->latch_timer_ptr = wl_event_loop_add_timer(
+            output_ptr->wlr_output_ptr->event_loop,
+            _wlmbe_output_handle_latch_timer,
+            output_ptr);
+        if (NULL == output_ptr->latch_timer_ptr) {
+            bs_log(BS_WARNING, "Failed wl_event_loop_add_timer() for %s",
+                   output_ptr->wlr_output_ptr->name);
+        }
+    }
+    if (0 < delay_msec && NULL != output_ptr->latch_timer_ptr &&
+        0 == wl_event_source_timer_update(
+            output_ptr->latch_timer_ptr, delay_msec)) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        wlr_scene_output_send_frame_done(wlr_scene_output_ptr, &now);
+        return;
+    }
+
+    _wlmbe_output_commit(output_ptr);
 
     struct timespec now;
     clock_gettime(CLOCK_MONOTONIC, &now);
     wlr_scene_output_send_frame_done(wlr_scene_output_ptr, &now);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Commits the scene to the output.
+ *
+ * Commits only if the scene has damage on this output. Without a commit,
+ * the output does not raise another `frame` until new damage schedules one,
+ * so an idle output stops waking up.
+ *
+ * @param output_ptr
+ */
+void _wlmbe_output_commit(wlmbe_output_t *output_ptr)
+{
+    struct wlr_scene_output *wlr_scene_output_ptr = wlr_scene_get_scene_output(
+        output_ptr->wlr_scene_ptr,
+        output_ptr->wlr_output_ptr);
+    // Apply pending layout updates, they must be reflected in this frame.
+    wlmtk_layout_epoch_flush();
+    wlmtk_container_flush_layout();
+    _wlmbe_output_tick_animations(output_ptr);
+    uint64_t occluded = 0;
+    if (NULL != output_ptr->root_ptr) {
+        occluded = wlmtk_root_update_occlusion(output_ptr->root_ptr);
+    }
+    bool magnified = _wlmbe_output_step_magnifier(
+        output_ptr, wlr_scene_output_ptr);
+    if (wlmtk_transaction_frames_held()) {
+        // Windows of a transaction are still committing: Keep showing the
+        // former frame, and check back on the next one.
+        wlr_output_schedule_frame(output_ptr->wlr_output_ptr);
+    } else if (wlr_scene_output_needs_frame(wlr_scene_output_ptr) ||
+               magnified) {
+        wlmbe_output_stats_t *stats_ptr = &output_ptr->stats;
+        int rects;
+        pixman_box32_t *box_ptr = pixman_region32_rectangles(
+            &wlr_scene_output_ptr->pending_commit_damage, &rects);
+        uint64_t damage_px = 0;
+        for (int i = 0; i < rects; ++i) {
+            damage_px += (uint64_t)(box_ptr[i].x2 - box_ptr[i].x1) *
+                (uint64_t)(box_ptr[i].y2 - box_ptr[i].y1);
+        }
+        stats_ptr->damage_px_sum += damage_px;
+        stats_ptr->damage_px_max = BS_MAX(stats_ptr->damage_px_max, damage_px);
+        uint64_t buffers = 0;
+        wlr_scene_output_for_each_buffer(
+            wlr_scene_output_ptr, _wlmbe_output_count_buffer, &buffers);
+        stats_ptr->buffers_sum += buffers;
+        stats_ptr->buffers_max = BS_MAX(stats_ptr->buffers_max, buffers);
+        stats_ptr->occluded_sum += occluded;
+        stats_ptr->occluded_max = BS_MAX(stats_ptr->occluded_max, occluded);
+
+        // Accounted before committing: Some backends present right away.
+        struct timespec t;
+        clock_gettime(CLOCK_MONOTONIC, &t);
+        wlmtk_latency_committed(&output_ptr->latency, _wlmbe_output_msec(&t));
+        output_ptr->committed_nsec = _wlmbe_output_nsec(&t);
+        _wlmbe_output_commit_scene(output_ptr, wlr_scene_output_ptr);
+        _wlmbe_output_stats_cursor(output_ptr);
+
+        // Running estimate of the render time: Follows increases right
+        // away, to not miss the next deadline. Decays slowly.
+        struct timespec done;
+        clock_gettime(CLOCK_MONOTONIC, &done);
+        uint64_t nsec = _wlmbe_output_nsec(&done) - _wlmbe_output_nsec(&t);
+        if (nsec >= output_ptr->render_estimate_nsec) {
+            output_ptr->render_estimate_nsec = nsec;
+        } else {
+            output_ptr->render_estimate_nsec -=
+                (output_ptr->render_estimate_nsec - nsec) / 16;
+        }
+        ++stats_ptr->commits;
+        stats_ptr->commit_nsec_sum += nsec;
+        stats_ptr->commit_nsec_max = BS_MAX(stats_ptr->commit_nsec_max, nsec);
+    } else {
+        // No damage: Input since the last frame had no visible effect here.
+        output_ptr->latency.has_pending = false;
+    }
+    if (wlmtk_animation_active() ||
+        (NULL != output_ptr->magnifier_ptr &&
+         wlmbe_magnifier_animating(output_ptr->magnifier_ptr))) {
+        wlr_output_schedule_frame(output_ptr->wlr_output_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Advances the animations to now. Reports the frame budget as exceeded, if
+ * the estimated render time exceeds this output's refresh period.
+ *
+ * @param output_ptr
+ */
+void _wlmbe_output_tick_animations(wlmbe_output_t *output_ptr)
+{
+    int32_t refresh_mhz = output_ptr->wlr_output_ptr->refresh;
+    uint64_t period_nsec = 1000000000000u / 60000u;
+    if (0 < refresh_mhz) period_nsec = 1000000000000u / (uint64_t)refresh_mhz;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    wlmtk_animation_tick(
+        _wlmbe_output_nsec(&now) / 1000000u,
+        output_ptr->render_estimate_nsec > period_nsec);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Advances the magnifier's zoom and focus to now.
+ *
+ * Once zoomed out, damages all of the scene output: The output's buffers
+ * still hold the magnified contents.
+ *
+ * @param output_ptr
+ * @param wlr_scene_output_ptr
+ *
+ * @return Whether the magnified viewport changed, and needs a commit.
+ */
+bool _wlmbe_output_step_magnifier(
+    wlmbe_output_t *output_ptr,
+    struct wlr_scene_output *wlr_scene_output_ptr)
+{
+    wlmbe_magnifier_t *magnifier_ptr = output_ptr->magnifier_ptr;
+    if (NULL == magnifier_ptr || !wlmbe_magnifier_active(magnifier_ptr)) {
+        return false;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    bool changed = wlmbe_magnifier_step(
+        magnifier_ptr, _wlmbe_output_nsec(&now) / 1000000u);
+    if (!wlmbe_magnifier_active(magnifier_ptr)) {
+        _wlmbe_output_damage_whole(wlr_scene_output_ptr);
+        return false;
+    }
+    return changed;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Damages all of the scene output. There is no call for that, but moving
+ * the scene output does: Moves it forth and back.
+ *
+ * @param wlr_scene_output_ptr
+ */
+void _wlmbe_output_damage_whole(struct wlr_scene_output *wlr_scene_output_ptr)
+{
+    int x = wlr_scene_output_ptr->x, y = wlr_scene_output_ptr->y;
+    wlr_scene_output_set_position(wlr_scene_output_ptr, x + 1, y);
+    wlr_scene_output_set_position(wlr_scene_output_ptr, x, y);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Commits the scene output. Adds a change of the adaptive sync state, if
+ * that differs from what was requested last. Requests an async page flip,
+ * if the fullscreen surface prefers tearing and the output permits it.
+ * Counts whether the frame was scanned out directly from a client buffer.
+ *
+ * While magnifying, the scene is rendered into the magnifier's swapchain,
+ * and its viewport then scaled into a buffer of the output's swapchain.
+ *
+ * @param output_ptr
+ * @param wlr_scene_output_ptr
+ */
+void _wlmbe_output_commit_scene(
+    wlmbe_output_t *output_ptr,
+    struct wlr_scene_output *wlr_scene_output_ptr)
+{
+    struct wlr_output *wlr_output_ptr = output_ptr->wlr_output_ptr;
+    struct wlr_output_state state;
+    wlr_output_state_init(&state);
+    struct wlr_scene_output_state_options options = {};
+    if (NULL != output_ptr->magnifier_ptr) {
+        options.swapchain = wlmbe_magnifier_swapchain(
+            output_ptr->magnifier_ptr, wlr_output_ptr);
+    }
+    if (!wlr_scene_output_build_state(wlr_scene_output_ptr, &state, &options)) {
+        wlr_output_state_finish(&state);
+        return;
+    }
+    // A buffer not from our swapchain is a client buffer: Direct scanout.
+    bool scanout = NULL != state.buffer &&
+        NULL != wlr_output_ptr->swapchain &&
+        !wlr_swapchain_has_buffer(wlr_output_ptr->swapchain, state.buffer);
+    if (NULL != options.swapchain) {
+        scanout = false;
+        if (!wlmbe_magnifier_render(
+                output_ptr->magnifier_ptr, wlr_output_ptr, &state)) {
+            wlr_output_state_finish(&state);
+            return;
+        }
+    }
+
+    struct wlr_surface *fullscreen_wlr_surface_ptr =
+        _wlmbe_output_fullscreen_surface(output_ptr, wlr_scene_output_ptr);
+    bool wanted = _wlmbe_output_adaptive_sync_wanted(
+        output_ptr, fullscreen_wlr_surface_ptr);
+    bool adaptive_sync_change = wanted != output_ptr->adaptive_sync_requested;
+    if (adaptive_sync_change) {
+        // Remember the attempt: Outputs without support will keep failing.
+        output_ptr->adaptive_sync_requested = wanted;
+        wlr_output_state_set_adaptive_sync_enabled(&state, wanted);
+    }
+#if WLR_VERSION_NUM >= (18 << 8)
+    if (_wlmbe_output_tearing_wanted(output_ptr, fullscreen_wlr_surface_ptr)) {
+        // Not all backends (and drivers) support async page flips. Test.
+        state.tearing_page_flip = true;
+        if (!wlr_output_test_state(wlr_output_ptr, &state)) {
+            state.tearing_page_flip = false;
+        }
+    }
+#endif  // WLR_VERSION_NUM >= (18 << 8)
+
+    bool rv = wlr_output_commit_state(wlr_output_ptr, &state);
+    if (adaptive_sync_change && rv) {
+        bs_log(BS_INFO, "Adaptive sync %s on %s",
+               wanted ? "enabled" : "disabled", output_ptr->description_ptr);
+    } else if (adaptive_sync_change) {
+        bs_log(BS_WARNING, "Failed to %s adaptive sync on %s",
+               wanted ? "enable" : "disable", output_ptr->description_ptr);
+        state.committed &= ~WLR_OUTPUT_STATE_ADAPTIVE_SYNC_ENABLED;
+        rv = wlr_output_commit_state(wlr_output_ptr, &state);
+    }
+    wlr_output_state_finish(&state);
+
+    if (!rv) return;
+    if (scanout) {
+        ++output_ptr->stats.scanout_hits;
+    } else {
+        ++output_ptr->stats.scanout_misses;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Event handler for the `commit` signal of the mirrored `wlr_output`: Holds
+ * on to the committed buffer, and schedules a frame on the mirror.
+ *
+ * @param listener_ptr
+ * @param data_ptr            Points to a `struct wlr_output_event_commit`.
+ */
+void _wlmbe_output_handle_source_commit(
+    struct wl_listener *listener_ptr,
+    void *data_ptr)
+{
+    wlmbe_output_t *output_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmbe_output_t, source_commit_listener);
+    const struct wlr_output_event_commit *event_ptr = data_ptr;
+    if (!(event_ptr->state->committed & WLR_OUTPUT_STATE_BUFFER) ||
+        NULL == event_ptr->state->buffer) return;
+
+    if (NULL != output_ptr->mirror_wlr_buffer_ptr) {
+        wlr_buffer_unlock(output_ptr->mirror_wlr_buffer_ptr);
+    }
+    output_ptr->mirror_wlr_buffer_ptr = wlr_buffer_lock(
+        event_ptr->state->buffer);
+    output_ptr->mirror_pending = true;
+    if (!output_ptr->powered_off) {
+        wlr_output_schedule_frame(output_ptr->wlr_output_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Event handler for the `destroy` signal of the mirrored `wlr_output`. Also
+ * used to stop mirroring. Releases the buffer held from the source.
+ *
+ * @param listener_ptr
+ * @param data_ptr
+ */
+void _wlmbe_output_handle_source_destroy(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmbe_output_t *output_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmbe_output_t, source_destroy_listener);
+
+    wlmtk_util_disconnect_listener(&output_ptr->source_destroy_listener);
+    wlmtk_util_disconnect_listener(&output_ptr->source_commit_listener);
+    output_ptr->source_wlr_output_ptr = NULL;
+    if (NULL != output_ptr->mirror_wlr_buffer_ptr) {
+        wlr_buffer_unlock(output_ptr->mirror_wlr_buffer_ptr);
+        output_ptr->mirror_wlr_buffer_ptr = NULL;
+    }
+    output_ptr->mirror_pending = false;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Commits the buffer last committed to the mirrored output, unless already
+ * shown. Scans it out directly if orientation and size match, and the
+ * output accepts it. Otherwise, blits it into the mirror's swapchain.
+ *
+ * @param output_ptr
+ */
+void _wlmbe_output_commit_mirror(wlmbe_output_t *output_ptr)
+{
+    struct wlr_buffer *wlr_buffer_ptr = output_ptr->mirror_wlr_buffer_ptr;
+    if (!output_ptr->mirror_pending || NULL == wlr_buffer_ptr) return;
+    output_ptr->mirror_pending = false;
+
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    struct wlr_output *wlr_output_ptr = output_ptr->wlr_output_ptr;
+    // The source's buffer is in that output's orientation. Undo that.
+    enum wl_output_transform transform = wlr_output_transform_compose(
+        wlr_output_transform_invert(
+            output_ptr->source_wlr_output_ptr->transform),
+        wlr_output_ptr->transform);
+
+    struct wlr_output_state state;
+    wlr_output_state_init(&state);
+    bool scanout = false;
+    if (WL_OUTPUT_TRANSFORM_NORMAL == transform &&
+        wlr_buffer_ptr->width == wlr_output_ptr->width &&
+        wlr_buffer_ptr->height == wlr_output_ptr->height) {
+        wlr_output_state_set_buffer(&state, wlr_buffer_ptr);
+        // Eg. a buffer of another GPU, a format or modifier not supported.
+        scanout = wlr_output_test_state(wlr_output_ptr, &state);
+        if (!scanout) {
+            wlr_output_state_finish(&state);
+            wlr_output_state_init(&state);
+        }
+    }
+    if (!scanout &&
+        !_wlmbe_output_blit_mirror(
+            output_ptr, &state, wlr_buffer_ptr, transform)) {
+        wlr_output_state_finish(&state);
+        return;
+    }
+    bool rv = wlr_output_commit_state(wlr_output_ptr, &state);
+    wlr_output_state_finish(&state);
+    if (!rv) {
+        bs_log(BS_WARNING, "Failed wlr_output_commit_state() for mirror %s",
+               output_ptr->description_ptr);
+        return;
+    }
+
+    struct timespec done;
+    clock_gettime(CLOCK_MONOTONIC, &done);
+    uint64_t nsec = _wlmbe_output_nsec(&done) - _wlmbe_output_nsec(&t);
+    wlmbe_output_stats_t *stats_ptr = &output_ptr->stats;
+    ++stats_ptr->commits;
+    stats_ptr->commit_nsec_sum += nsec;
+    stats_ptr->commit_nsec_max = BS_MAX(stats_ptr->commit_nsec_max, nsec);
+    if (scanout) {
+        ++stats_ptr->scanout_hits;
+    } else {
+        ++stats_ptr->scanout_misses;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Renders `wlr_buffer_ptr` into a buffer of the output's swapchain, and sets
+ * it to `state_ptr`. Scales to fit, keeping the aspect ratio. The borders
+ * remain black.
+ *
+ * @param output_ptr
+ * @param state_ptr
+ * @param wlr_buffer_ptr
+ * @param transform           Transformation to apply to `wlr_buffer_ptr`.
+ *
+ * @return true on success.
+ */
+bool _wlmbe_output_blit_mirror(
+    wlmbe_output_t *output_ptr,
+    struct wlr_output_state *state_ptr,
+    struct wlr_buffer *wlr_buffer_ptr,
+    enum wl_output_transform transform)
+{
+    struct wlr_output *wlr_output_ptr = output_ptr->wlr_output_ptr;
+    struct wlr_texture *wlr_texture_ptr = wlr_texture_from_buffer(
+        wlr_output_ptr->renderer, wlr_buffer_ptr);
+    if (NULL == wlr_texture_ptr) {
+        bs_log(BS_WARNING, "Failed wlr_texture_from_buffer(%p, %p) for %s",
+               wlr_output_ptr->renderer, wlr_buffer_ptr,
+               output_ptr->description_ptr);
+        return false;
+    }
+#if WLR_VERSION_NUM >= (19 << 8)
+    struct wlr_render_pass *wlr_render_pass_ptr =
+        wlr_output_begin_render_pass(wlr_output_ptr, state_ptr, NULL);
+#else  // WLR_VERSION_NUM >= (19 << 8)
+    struct wlr_render_pass *wlr_render_pass_ptr =
+        wlr_output_begin_render_pass(wlr_output_ptr, state_ptr, NULL, NULL);
+#endif  // WLR_VERSION_NUM >= (19 << 8)
+    if (NULL == wlr_render_pass_ptr) {
+        bs_log(BS_WARNING, "Failed wlr_output_begin_render_pass(%p) for %s",
+               wlr_output_ptr, output_ptr->description_ptr);
+        wlr_texture_destroy(wlr_texture_ptr);
+        return false;
+    }
+
+    int width = wlr_texture_ptr->width, height = wlr_texture_ptr->height;
+    if (transform & WL_OUTPUT_TRANSFORM_90) {
+        width = wlr_texture_ptr->height;
+        height = wlr_texture_ptr->width;
+    }
+    double scale = BS_MIN((double)wlr_output_ptr->width / width,
+                          (double)wlr_output_ptr->height / height);
+    width = BS_MAX(1, (int)(width * scale + 0.5));
+    height = BS_MAX(1, (int)(height * scale + 0.5));
+
+    wlr_render_pass_add_rect(
+        wlr_render_pass_ptr,
+        &(struct wlr_render_rect_options){
+            .box = { .width = wlr_output_ptr->width,
+                     .height = wlr_output_ptr->height },
+            .color = { .r = 0, .g = 0, .b = 0, .a = 1 },
+            .blend_mode = WLR_RENDER_BLEND_MODE_NONE });
+    wlr_render_pass_add_texture(
+        wlr_render_pass_ptr,
+        &(struct wlr_render_texture_options){
+            .texture = wlr_texture_ptr,
+            .dst_box = { .x = (wlr_output_ptr->width - width) / 2,
+                         .y = (wlr_output_ptr->height - height) / 2,
+                         .width = width, .height = height },
+            .transform = transform,
+            .filter_mode = WLR_SCALE_FILTER_BILINEAR,
+            .blend_mode = WLR_RENDER_BLEND_MODE_NONE });
+    bool rv = wlr_render_pass_submit(wlr_render_pass_ptr);
+    wlr_texture_destroy(wlr_texture_ptr);
+    if (!rv) {
+        bs_log(BS_WARNING, "Failed wlr_render_pass_submit() for mirror %s",
+               output_ptr->description_ptr);
+    }
+    return rv;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns whether adaptive sync should be on, as configured right now.
+ *
+ * @param output_ptr
+ * @param fullscreen_wlr_surface_ptr See @ref _wlmbe_output_fullscreen_surface.
+ */
+bool _wlmbe_output_adaptive_sync_wanted(
+    wlmbe_output_t *output_ptr,
+    struct wlr_surface *fullscreen_wlr_surface_ptr)
+{
+    wlmtk_workspace_t *workspace_ptr = NULL;
+    enum wp_content_type_v1_type content_type;
+    switch (output_ptr->attributes_ptr->adaptive_sync) {
+    case WLMBE_ADAPTIVE_SYNC_ENABLED:
+        return true;
+    case WLMBE_ADAPTIVE_SYNC_CONTENT:
+        content_type = _wlmbe_output_content_type(
+            output_ptr, fullscreen_wlr_surface_ptr);
+        return (WP_CONTENT_TYPE_V1_TYPE_VIDEO == content_type ||
+                WP_CONTENT_TYPE_V1_TYPE_GAME == content_type);
+    case WLMBE_ADAPTIVE_SYNC_FULLSCREEN:
+        if (NULL != output_ptr->root_ptr) {
+            workspace_ptr = wlmtk_root_get_current_workspace(
+                output_ptr->root_ptr);
+        }
+        if (NULL == workspace_ptr) return false;
+        return wlmtk_workspace_has_fullscreen_window(
+            workspace_ptr, output_ptr->wlr_output_ptr);
+    default:
+        return false;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns whether the frame should be presented with an async page flip:
+ * If the fullscreen surface asks for async presentation, or declares game
+ * content.
+ *
+ * @param output_ptr
+ * @param fullscreen_wlr_surface_ptr See @ref _wlmbe_output_fullscreen_surface.
+ */
+bool _wlmbe_output_tearing_wanted(
+    wlmbe_output_t *output_ptr,
+    struct wlr_surface *fullscreen_wlr_surface_ptr)
+{
+    if (NULL == fullscreen_wlr_surface_ptr) return false;
+#if WLR_VERSION_NUM >= (18 << 8)
+    if (NULL != output_ptr->wlr_tearing_control_manager_v1_ptr &&
+        WP_TEARING_CONTROL_V1_PRESENTATION_HINT_ASYNC ==
+        wlr_tearing_control_manager_v1_surface_hint_from_surface(
+            output_ptr->wlr_tearing_control_manager_v1_ptr,
+            fullscreen_wlr_surface_ptr)) return true;
+#endif  // WLR_VERSION_NUM >= (18 << 8)
+    return WP_CONTENT_TYPE_V1_TYPE_GAME == _wlmbe_output_content_type(
+        output_ptr, fullscreen_wlr_surface_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns the content type of `wlr_surface_ptr`. NONE if unknown or NULL. */
+enum wp_content_type_v1_type _wlmbe_output_content_type(
+    wlmbe_output_t *output_ptr,
+    struct wlr_surface *wlr_surface_ptr)
+{
+    if (NULL == output_ptr->wlr_content_type_manager_v1_ptr ||
+        NULL == wlr_surface_ptr) return WP_CONTENT_TYPE_V1_TYPE_NONE;
+    return wlr_surface_get_content_type_v1(
+        output_ptr->wlr_content_type_manager_v1_ptr, wlr_surface_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Finds the surface of the fullscreen window shown on the output: The
+ * topmost surface covering all of the output.
+ *
+ * @param output_ptr
+ * @param wlr_scene_output_ptr
+ *
+ * @return The surface, or NULL if there is no fullscreen window shown.
+ */
+struct wlr_surface *_wlmbe_output_fullscreen_surface(
+    wlmbe_output_t *output_ptr,
+    struct wlr_scene_output *wlr_scene_output_ptr)
+{
+    if (NULL == output_ptr->root_ptr) return NULL;
+    wlmtk_workspace_t *workspace_ptr = wlmtk_root_get_current_workspace(
+        output_ptr->root_ptr);
+    if (NULL == workspace_ptr ||
+        !wlmtk_workspace_has_fullscreen_window(
+            workspace_ptr, output_ptr->wlr_output_ptr)) return NULL;
+
+    _wlmbe_output_covering_surface_arg_t arg = {};
+    wlr_output_effective_resolution(
+        output_ptr->wlr_output_ptr, &arg.width, &arg.height);
+    wlr_scene_output_for_each_buffer(
+        wlr_scene_output_ptr, _wlmbe_output_find_covering_surface, &arg);
+    return arg.wlr_surface_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Callback for `wlr_scene_output_for_each_buffer`: Stores the buffer's
+ * surface, if it covers all of the output. Buffers are iterated bottom to
+ * top, so the topmost covering surface is stored last.
+ *
+ * @param wlr_scene_buffer_ptr
+ * @param sx                  Position of the buffer, relative to the output.
+ * @param sy
+ * @param ud_ptr              Points to a
+ *                            @ref _wlmbe_output_covering_surface_arg_t.
+ */
+void _wlmbe_output_find_covering_surface(
+    struct wlr_scene_buffer *wlr_scene_buffer_ptr,
+    int sx,
+    int sy,
+    void *ud_ptr)
+{
+    _wlmbe_output_covering_surface_arg_t *arg_ptr = ud_ptr;
+    struct wlr_scene_surface *wlr_scene_surface_ptr =
+        wlr_scene_surface_try_from_buffer(wlr_scene_buffer_ptr);
+    if (NULL == wlr_scene_surface_ptr || 0 < sx || 0 < sy) return;
+
+    struct wlr_surface *wlr_surface_ptr = wlr_scene_surface_ptr->surface;
+    if (sx + wlr_surface_ptr->current.width < arg_ptr->width ||
+        sy + wlr_surface_ptr->current.height < arg_ptr->height) return;
+    arg_ptr->wlr_surface_ptr = wlr_surface_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes how long to delay the commit, for latching it just before the
+ * next vertical blank: That is the time of the most recent presentation,
+ * advanced by refresh periods, minus the time reserved for rendering. The
+ * reservation is the configured deadline, or the estimated render time if
+ * that is longer.
+ *
+ * @param output_ptr
+ *
+ * @return The delay, in milliseconds. 0 if the commit should be done now:
+ *     If not configured, if there is no reliable presentation timing, or if
+ *     the deadline is already near.
+ */
+uint64_t _wlmbe_output_latch_delay_msec(wlmbe_output_t *output_ptr)
+{
+    uint64_t deadline_msec = output_ptr->attributes_ptr->render_deadline_msec;
+    int32_t refresh_mhz = output_ptr->wlr_output_ptr->refresh;
+    if (0 == deadline_msec ||
+        0 >= refresh_mhz ||
+        0 == output_ptr->presented_nsec) return 0;
+
+    uint64_t period_nsec = 1000000000000u / (uint64_t)refresh_mhz;
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    uint64_t now_nsec = _wlmbe_output_nsec(&t);
+    // Presentation timing is stale after a pause: Skip until re-synced.
+    if (output_ptr->presented_nsec > now_nsec ||
+        now_nsec - output_ptr->presented_nsec > 2 * period_nsec) return 0;
+
+    uint64_t vblank_nsec = output_ptr->presented_nsec + period_nsec;
+    while (vblank_nsec <= now_nsec) vblank_nsec += period_nsec;
+    uint64_t reserved_nsec = BS_MAX(deadline_msec * 1000000u,
+                                    output_ptr->render_estimate_nsec);
+    if (now_nsec + reserved_nsec >= vblank_nsec) return 0;
+    // Rounds down: The timer is in milliseconds; better early than late.
+    return (vblank_nsec - reserved_nsec - now_nsec) / 1000000u;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Callback for @ref wlmbe_output_t::latch_timer_ptr: Commits now. */
+int _wlmbe_output_handle_latch_timer(void *data_ptr)
+{
+    wlmbe_output_t *output_ptr = data_ptr;
+    if (NULL != output_ptr->wlr_output_ptr && !output_ptr->powered_off) {
+        _wlmbe_output_commit(output_ptr);
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Event handler for the `present` signal raised by `wlr_output`. Accounts
+ * the presentation for the input latency.
+ *
+ * @param listener_ptr
+ * @param data_ptr            Points to a `struct wlr_output_event_present`.
+ */
+void _wlmbe_output_handle_present(
+    struct wl_listener *listener_ptr,
+    void *data_ptr)
+{
+    wlmbe_output_t *output_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmbe_output_t, output_present_listener);
+    struct wlr_output_event_present *event_ptr = data_ptr;
+
+#if WLR_VERSION_NUM >= (19 << 8)
+    const struct timespec *when_ptr = &event_ptr->when;
+#else  // WLR_VERSION_NUM >= (19 << 8)
+    const struct timespec *when_ptr = event_ptr->when;
+#endif  // WLR_VERSION_NUM >= (19 << 8)
+    wlmtk_latency_presented(
+        &output_ptr->latency,
+        event_ptr->presented && NULL != when_ptr,
+        NULL != when_ptr ? _wlmbe_output_msec(when_ptr) : 0);
+    if (event_ptr->presented && NULL != when_ptr) {
+        int32_t refresh_mhz = output_ptr->wlr_output_ptr->refresh;
+        uint64_t period_nsec = 0;
+        if (0 < event_ptr->refresh) {
+            period_nsec = event_ptr->refresh;
+        } else if (0 < refresh_mhz) {
+            period_nsec = 1000000000000u / (uint64_t)refresh_mhz;
+        }
+        _wlmbe_output_stats_presented(
+            output_ptr, _wlmbe_output_nsec(when_ptr), period_nsec);
+        output_ptr->presented_nsec = _wlmbe_output_nsec(when_ptr);
+    }
+    output_ptr->committed_nsec = 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Accounts a presentation in the statistics.
+ *
+ * The commit was due for the first vertical blank after it. Each full
+ * refresh period passing beyond that counts as a missed vertical blank. If
+ * the commit was due right for the vertical blank following the former
+ * presentation, the interval between both presentations is sampled for the
+ * jitter: Its deviation from a whole number of refresh periods.
+ *
+ * @param output_ptr
+ * @param when_nsec           Time of this presentation.
+ * @param period_nsec         Refresh period. 0 if unknown.
+ */
+void _wlmbe_output_stats_presented(
+    wlmbe_output_t *output_ptr,
+    uint64_t when_nsec,
+    uint64_t period_nsec)
+{
+    wlmbe_output_stats_t *stats_ptr = &output_ptr->stats;
+    uint64_t prev_nsec = output_ptr->presented_nsec;
+    uint64_t committed_nsec = output_ptr->committed_nsec;
+    if (0 == period_nsec || 0 == prev_nsec || 0 == committed_nsec ||
+        prev_nsec > committed_nsec || committed_nsec > when_nsec) return;
+
+    // The first vertical blank after the commit.
+    uint64_t periods = (committed_nsec - prev_nsec) / period_nsec + 1;
+    uint64_t due_nsec = prev_nsec + periods * period_nsec;
+    uint64_t missed = 0;
+    if (when_nsec > due_nsec) {
+        missed = (when_nsec - due_nsec + period_nsec / 2) / period_nsec;
+    }
+    stats_ptr->missed_vblanks += missed;
+
+    if (1 == periods) {
+        uint64_t interval_nsec = when_nsec - prev_nsec;
+        uint64_t expected_nsec = (1 + missed) * period_nsec;
+        uint64_t jitter_nsec = interval_nsec > expected_nsec ?
+            interval_nsec - expected_nsec : expected_nsec - interval_nsec;
+        ++stats_ptr->jitter_samples;
+        stats_ptr->jitter_nsec_sum += jitter_nsec;
+        stats_ptr->jitter_nsec_max = BS_MAX(
+            stats_ptr->jitter_nsec_max, jitter_nsec);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Callback for `wlr_scene_output_for_each_buffer`: Counts in `ud_ptr`. */
+void _wlmbe_output_count_buffer(
+    __UNUSED__ struct wlr_scene_buffer *wlr_scene_buffer_ptr,
+    __UNUSED__ int sx,
+    __UNUSED__ int sy,
+    void *ud_ptr)
+{
+    uint64_t *count_ptr = ud_ptr;
+    ++(*count_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Accounts whether the output shows its cursor on the hardware cursor plane,
+ * or composites it into the frame. The latter happens when the plane rejects
+ * the cursor, eg. on some rotated outputs. It still damages only the areas
+ * the cursor moved from and to, not the whole output.
+ *
+ * Logs when the output changes between the two.
+ *
+ * @param output_ptr
+ */
+void _wlmbe_output_stats_cursor(wlmbe_output_t *output_ptr)
+{
+    struct wlr_output *wlr_output_ptr = output_ptr->wlr_output_ptr;
+    bool shown = false, software = false;
+    struct wlr_output_cursor *wlr_output_cursor_ptr;
+    wl_list_for_each(wlr_output_cursor_ptr, &wlr_output_ptr->cursors, link) {
+        if (!wlr_output_cursor_ptr->enabled ||
+            !wlr_output_cursor_ptr->visible) continue;
+        shown = true;
+        if (wlr_output_cursor_ptr != wlr_output_ptr->hardware_cursor) {
+            software = true;
+        }
+    }
+    if (!shown) return;
+
+    if (software) {
+        ++output_ptr->stats.cursor_software;
+    } else {
+        ++output_ptr->stats.cursor_hardware;
+    }
+    if (software == output_ptr->software_cursor) return;
+    output_ptr->software_cursor = software;
+    bs_log(BS_INFO, "Output %s: Cursor shown %s", output_ptr->description_ptr,
+           software ? "in software, composited" : "on the hardware plane");
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Converts a timestamp to milliseconds, on the same (wrapping) scale as the
+ * `time_msec` of wlroots input events.
+ */
+uint32_t _wlmbe_output_msec(const struct timespec *timespec_ptr)
+{
+    return (uint32_t)((uint64_t)timespec_ptr->tv_sec * 1000 +
+                      timespec_ptr->tv_nsec / 1000000);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Converts a timestamp to nanoseconds. */
+uint64_t _wlmbe_output_nsec(const struct timespec *timespec_ptr)
+{
+    return (uint64_t)timespec_ptr->tv_sec * 1000000000u +
+        (uint64_t)timespec_ptr->tv_nsec;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Event handler for the `request_state` signal raised by `wlr_output`.
@@ -63,6 +63,17 @@ static const bspl_enum_desc_t _wlmbe_output_transformation_desc[] = {
 };
 /** [OutputTransformation] */
 
+/** Descriptor for the adaptive sync policy. */
+/** [OutputAdaptiveSync] */
+static const bspl_enum_desc_t _wlmbe_output_adaptive_sync_desc[] = {
+    BSPL_ENUM("Disabled", WLMBE_ADAPTIVE_SYNC_DISABLED),
+    BSPL_ENUM("Enabled", WLMBE_ADAPTIVE_SYNC_ENABLED),
+    BSPL_ENUM("Fullscreen", WLMBE_ADAPTIVE_SYNC_FULLSCREEN),
+    BSPL_ENUM("Content", WLMBE_ADAPTIVE_SYNC_CONTENT),
+    BSPL_ENUM_SENTINEL(),
+};
+/** [OutputAdaptiveSync] */
+
 /** Plist descriptor for @ref wlmbe_output_description_t. */
 static const bspl_desc_t    _wlmbe_output_description_desc[] = {
     BSPL_DESC_STRING(
@@ -104,6 +115,16 @@ static const bspl_desc_t    _wlmbe_output_config_desc[] = {
         _wlmbe_output_mode_decode,
         _wlmbe_output_mode_decode_init,
         NULL),
+    BSPL_DESC_UINT64(
+        "RenderDeadline", false, wlmbe_output_config_t,
+        attributes.render_deadline_msec, attributes.render_deadline_msec, 0),
+    BSPL_DESC_ENUM(
+        "AdaptiveSync", false, wlmbe_output_config_t,
+        attributes.adaptive_sync, attributes.adaptive_sync,
+        WLMBE_ADAPTIVE_SYNC_FULLSCREEN, _wlmbe_output_adaptive_sync_desc),
+    BSPL_DESC_CHARBUF(
+        "Mirror", false, wlmbe_output_config_t,
+        attributes.mirror, attributes.mirror, WLMBE_OUTPUT_MIRROR_SIZE, ""),
     BSPL_DESC_SENTINEL()
 };
 
@@ -174,6 +195,8 @@ wlmbe_output_config_t *wlmbe_output_config_create_from_wlr(
     config_ptr->attributes.mode.refresh = wlr_output_ptr->refresh;
     config_ptr->attributes.has_mode = true;
 
+    config_ptr->attributes.render_deadline_msec = 0;
+    config_ptr->attributes.adaptive_sync = WLMBE_ADAPTIVE_SYNC_FULLSCREEN;
     return config_ptr;
 }
 
@@ -236,8 +259,23 @@ bool wlmbe_output_description_init_from_plist(
     wlmbe_output_description_t *desc_ptr,
     bspl_dict_t *dict_ptr)
 {
-    return bspl_decode_dict(
-        dict_ptr, _wlmbe_output_description_desc, desc_ptr);
+    if (!bspl_decode_dict(
+            dict_ptr, _wlmbe_output_description_desc, desc_ptr)) {
+        return false;
+    }
+
+    // Precompiles: Fields without glob characters get a plain strcmp().
+    const char *v[4] = {
+        desc_ptr->name_ptr, desc_ptr->manufacturer_ptr,
+        desc_ptr->model_ptr, desc_ptr->serial_ptr
+    };
+    desc_ptr->literal_fields = 0;
+    for (size_t i = 0; i < sizeof(v) / sizeof(const char*); ++i) {
+        if (NULL != v[i] && NULL == strpbrk(v[i], "*?[\\")) {
+            desc_ptr->literal_fields |= 1u << i;
+        }
+    }
+    return true;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -333,7 +371,11 @@ bool wlmbe_output_description_fnmatches(
     for (size_t i = 0; i < sizeof(f) / sizeof(struct fields); ++i) {
         if (!f[i].present) continue;
         if (NULL == f[i].cfg_val || NULL == f[i].o_val) return false;
-        if (0 != fnmatch(f[i].cfg_val, f[i].o_val, 0)) return false;
+        if (desc_ptr->literal_fields & (1u << i)) {
+            if (0 != strcmp(f[i].cfg_val, f[i].o_val)) return false;
+        } else if (0 != fnmatch(f[i].cfg_val, f[i].o_val, 0)) {
+            return false;
+        }
     }
     return true;
 }
@@ -486,17 +528,24 @@ void _wlmbe_output_test_config_parse(bs_test_t *test_ptr)
 {
     bspl_dict_t *dict_ptr = bspl_dict_from_object(
         bspl_create_object_from_plist_string(
-            "{Transformation=Flip;Scale=1;Name=X11}"));
+            "{Transformation=Flip;Scale=1;Name=X11;RenderDeadline=4;"
+            "AdaptiveSync=Enabled;Model=\"U2*\";Mirror=\"eDP-1\"}"));
     BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, dict_ptr);
 
     wlmbe_output_config_t *c = wlmbe_output_config_create_from_plist(dict_ptr);
     BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, c);
 
     BS_TEST_VERIFY_STREQ(test_ptr, "X11", c->description.name_ptr);
+    // Only the name is a literal, the model is a glob.
+    BS_TEST_VERIFY_EQ(test_ptr, 1u, c->description.literal_fields);
     BS_TEST_VERIFY_EQ(
         test_ptr, WL_OUTPUT_TRANSFORM_FLIPPED,
         c->attributes.transformation);
     BS_TEST_VERIFY_EQ(test_ptr, 1.0, c->attributes.scale);
+    BS_TEST_VERIFY_EQ(test_ptr, 4, c->attributes.render_deadline_msec);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMBE_ADAPTIVE_SYNC_ENABLED, c->attributes.adaptive_sync);
+    BS_TEST_VERIFY_STREQ(test_ptr, "eDP-1", c->attributes.mirror);
 
     wlmbe_output_config_destroy(c);
     bspl_dict_unref(dict_ptr);
@@ -72,17 +72,25 @@ struct _wlmbe_output_manager_t {
     struct wlr_backend        *wlr_backend_ptr;
 };
 
-/** Argument to @ref _wlmaker_output_manager_config_head_apply. */
+/**
+ * Argument to @ref _wlmaker_output_manager_config_head_prepare and
+ * @ref _wlmaker_output_manager_config_head_apply.
+ */
 typedef struct {
     /** Points to struct wlr_output_layout. */
     struct wlr_output_layout *wlr_output_layout_ptr;
-    /** Whether to test only, or to apply "really". */
-    bool really;
+    /** Adaptive sync status of each head's output, before the commit. */
+    bool                     *adaptive_sync_was_enabled_ptr;
+    /** Index of the head currently iterated over. */
+    size_t                   index;
 } _wlmaker_output_manager_config_head_apply_arg_t;
 
 static bool _wlmbe_output_manager_update_output_configuration(
     struct wl_list *link_ptr,
     void *ud_ptr);
+static bool _wlmaker_output_manager_config_head_prepare(
+    struct wl_list *link_ptr,
+    void *ud_ptr);
 static bool _wlmaker_output_manager_config_head_apply(
     struct wl_list *link_ptr,
     void *ud_ptr);
@@ -151,8 +159,9 @@ wlmbe_output_manager_t *wlmbe_output_manager_create(
         &wlr_output_layout_ptr->events.destroy,
         &output_manager_ptr->output_layout_destroy_listener,
         _wlmbe_output_manager_handle_output_layout_destroy);
-    wlmtk_util_connect_listener_signal(
-        &wlr_output_layout_ptr->events.change,
+    wlmtk_layout_epoch_connect(
+        wlr_output_layout_ptr,
+        WLMTK_LAYOUT_EPOCH_STAGE_OUTPUTS,
         &output_manager_ptr->output_layout_change_listener,
         _wlmbe_output_manager_handle_output_layout_change);
 
@@ -238,36 +247,58 @@ bool _wlmbe_output_manager_update_output_configuration(
 
 /* ------------------------------------------------------------------------- */
 /**
- * Applies the heads's output configuration.
+ * Verifies the head has an output, and records the output's adaptive sync
+ * status before the configuration gets committed.
  *
  * Callback for @ref wlmtk_util_wl_list_for_each.
  *
  * @param link_ptr
  * @param ud_ptr
  *
- * @return true if the tests & apply methods succeeded.
+ * @return true if the head has an output.
  */
-static bool _wlmaker_output_manager_config_head_apply(
+bool _wlmaker_output_manager_config_head_prepare(
     struct wl_list *link_ptr,
     void *ud_ptr)
 {
     struct wlr_output_configuration_head_v1 *head_v1_ptr  = BS_CONTAINER_OF(
         link_ptr, struct wlr_output_configuration_head_v1, link);
-    struct wlr_output_state state = {};
     _wlmaker_output_manager_config_head_apply_arg_t *arg_ptr = ud_ptr;
 
-    // Convenience pointers. Guard against accidental misses.
+    // Guard against accidental misses.
     struct wlr_output *wlr_output_ptr = head_v1_ptr->state.output;
     if (NULL == wlr_output_ptr) {
         bs_log(BS_ERROR, "Unexpected NULL output in head %p", head_v1_ptr);
         return false;
     }
 
-    wlr_output_head_v1_state_apply(&head_v1_ptr->state, &state);
-    if (!wlr_output_test_state(wlr_output_ptr, &state)) return false;
-    if (!arg_ptr->really) return true;
+    arg_ptr->adaptive_sync_was_enabled_ptr[arg_ptr->index++] =
+        WLR_OUTPUT_ADAPTIVE_SYNC_ENABLED ==
+        wlr_output_ptr->adaptive_sync_status;
+    return true;
+}
 
-    if (!wlr_output_commit_state(wlr_output_ptr, &state)) return false;
+/* ------------------------------------------------------------------------- */
+/**
+ * Updates layout and attributes from the heads's committed configuration.
+ *
+ * Callback for @ref wlmtk_util_wl_list_for_each.
+ *
+ * @param link_ptr
+ * @param ud_ptr
+ *
+ * @return true if the layout could be updated.
+ */
+static bool _wlmaker_output_manager_config_head_apply(
+    struct wl_list *link_ptr,
+    void *ud_ptr)
+{
+    struct wlr_output_configuration_head_v1 *head_v1_ptr  = BS_CONTAINER_OF(
+        link_ptr, struct wlr_output_configuration_head_v1, link);
+    _wlmaker_output_manager_config_head_apply_arg_t *arg_ptr = ud_ptr;
+    struct wlr_output *wlr_output_ptr = head_v1_ptr->state.output;
+    bool adaptive_sync_was_enabled =
+        arg_ptr->adaptive_sync_was_enabled_ptr[arg_ptr->index++];
 
     int x = head_v1_ptr->state.x, y = head_v1_ptr->state.y;
     struct wlr_output_layout *wlr_output_layout_ptr =
@@ -292,6 +323,13 @@ static bool _wlmaker_output_manager_config_head_apply(
     attr_ptr->mode.refresh = wlr_output_ptr->refresh;
     attr_ptr->has_mode = true;
 
+    // An explicit change by the client overrides the configured policy.
+    if (head_v1_ptr->state.adaptive_sync_enabled !=
+        adaptive_sync_was_enabled) {
+        attr_ptr->adaptive_sync = head_v1_ptr->state.adaptive_sync_enabled ?
+            WLMBE_ADAPTIVE_SYNC_ENABLED : WLMBE_ADAPTIVE_SYNC_DISABLED;
+    }
+
     struct wlr_output_layout_output *wlr_output_layout_output_ptr =
         wlr_output_layout_get(
             arg_ptr->wlr_output_layout_ptr,
@@ -327,14 +365,18 @@ bool _wlmbe_output_manager_apply(
     struct wlr_output_configuration_v1 *wlr_output_configuration_v1_ptr,
     bool really)
 {
+    int heads = wl_list_length(&wlr_output_configuration_v1_ptr->heads);
     _wlmaker_output_manager_config_head_apply_arg_t arg = {
         .wlr_output_layout_ptr = output_manager_ptr->wlr_output_layout_ptr,
-        .really = really
+        .adaptive_sync_was_enabled_ptr = logged_calloc(
+            BS_MAX(heads, 1), sizeof(bool))
     };
+    if (NULL == arg.adaptive_sync_was_enabled_ptr) return false;
     if (!wlmtk_util_wl_list_for_each(
             &wlr_output_configuration_v1_ptr->heads,
-            _wlmaker_output_manager_config_head_apply,
+            _wlmaker_output_manager_config_head_prepare,
             &arg)) {
+        free(arg.adaptive_sync_was_enabled_ptr);
         return false;
     }
 
@@ -346,9 +388,13 @@ bool _wlmbe_output_manager_apply(
         bs_log(BS_ERROR,
                "Failed wlr_output_configuration_v1_build_state(%p, %p)",
                wlr_output_configuration_v1_ptr, &states_len);
+        free(arg.adaptive_sync_was_enabled_ptr);
         return false;
     }
 
+    // All heads are tested together first, and committed together only
+    // if the full configuration passed. This does not leave some outputs
+    // re-configured, when another output's mode got rejected.
     bool rv = wlr_backend_test(
         output_manager_ptr->wlr_backend_ptr,
         wlr_backend_output_state_ptr,
@@ -359,8 +405,19 @@ bool _wlmbe_output_manager_apply(
             wlr_backend_output_state_ptr,
             states_len);
     }
+    for (size_t i = 0; i < states_len; ++i) {
+        wlr_output_state_finish(&wlr_backend_output_state_ptr[i].base);
+    }
     free(wlr_backend_output_state_ptr);
 
+    if (rv && really) {
+        arg.index = 0;
+        rv = wlmtk_util_wl_list_for_each(
+            &wlr_output_configuration_v1_ptr->heads,
+            _wlmaker_output_manager_config_head_apply,
+            &arg);
+    }
+    free(arg.adaptive_sync_was_enabled_ptr);
     return rv;
 }
 
@@ -0,0 +1,374 @@
+/* ========================================================================= */
+/**
+ * @file remote.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "remote.h"
+
+#include <libbase/libbase.h>
+#include <pixman.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <toolkit/toolkit.h>
+#include <wayland-server-core.h>
+#define WLR_USE_UNSTABLE
+#include <wlr/interfaces/wlr_output.h>
+#include <wlr/render/dmabuf.h>
+#include <wlr/types/wlr_buffer.h>
+#include <wlr/types/wlr_output.h>
+#undef WLR_USE_UNSTABLE
+
+/* == Declarations ========================================================= */
+
+/** State of a remote output. */
+struct _wlmbe_remote_t {
+    /** List node, element of @ref wlmbe_backend_t::remotes. */
+    bs_dllist_node_t          dlnode;
+
+    /** Listener for `commit` signals raised by `wlr_output`. */
+    struct wl_listener        output_commit_listener;
+    /** Listener for `destroy` signals raised by `wlr_output`. */
+    struct wl_listener        output_destroy_listener;
+
+    /** Consumer of the frames. NULL if none. */
+    wlmbe_remote_frame_callback_t callback;
+    /** Argument to @ref wlmbe_remote_t::callback. */
+    void                      *ud_ptr;
+    /** Frame rate cap, frames per second. 0 for none. */
+    unsigned                  max_fps;
+    /** Frames the consumer may hold, before rendering pauses. */
+    unsigned                  max_frames_in_flight;
+
+    /** Frames handed to the consumer, not released yet. */
+    bs_dllist_t               frames;
+    /** Sequence number of the most recent frame. */
+    uint64_t                  sequence;
+    /** Whether the next frame must report all of the buffer as damaged. */
+    bool                      damage_whole;
+    /** Holds frames back, to keep within @ref wlmbe_remote_t::max_fps. */
+    struct wl_event_source    *rate_timer_ptr;
+    /** Whether the frame rate cap holds frames back right now. */
+    bool                      rate_limited;
+
+    // Below: Not owned by @ref wlmbe_remote_t.
+    /** The output. */
+    wlmbe_output_t            *output_ptr;
+    /** The output's `wlr_output`. NULL once destroyed. */
+    struct wlr_output         *wlr_output_ptr;
+};
+
+/** A frame handed to the consumer. */
+struct _wlmbe_remote_frame_t {
+    /** List node, element of @ref wlmbe_remote_t::frames. */
+    bs_dllist_node_t          dlnode;
+    /** The remote this frame is from. NULL once that is destroyed. */
+    wlmbe_remote_t            *remote_ptr;
+    /** The buffer. Locked. */
+    struct wlr_buffer         *wlr_buffer_ptr;
+    /** Damage since the previous frame, in buffer coordinates. */
+    pixman_region32_t         damage;
+    /** Sequence number. */
+    uint64_t                  sequence;
+};
+
+static void _wlmbe_remote_handle_output_commit(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmbe_remote_handle_output_destroy(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static int _wlmbe_remote_handle_rate_timer(void *data_ptr);
+static void _wlmbe_remote_update_held(wlmbe_remote_t *remote_ptr);
+static uint64_t _wlmbe_remote_interval_msec(unsigned max_fps);
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmbe_remote_t *wlmbe_remote_create(wlmbe_output_t *output_ptr)
+{
+    wlmbe_remote_t *remote_ptr = logged_calloc(1, sizeof(wlmbe_remote_t));
+    if (NULL == remote_ptr) return NULL;
+    remote_ptr->output_ptr = output_ptr;
+    remote_ptr->wlr_output_ptr = wlmbe_wlr_output_from_output(output_ptr);
+    remote_ptr->max_frames_in_flight = 1;
+
+    remote_ptr->rate_timer_ptr = wl_event_loop_add_timer(
+        remote_ptr->wlr_output_ptr->event_loop,
+        _wlmbe_remote_handle_rate_timer,
+        remote_ptr);
+    if (NULL == remote_ptr->rate_timer_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_timer() for %s",
+               remote_ptr->wlr_output_ptr->name);
+        wlmbe_remote_destroy(remote_ptr);
+        return NULL;
+    }
+
+    wlmtk_util_connect_listener_signal(
+        &remote_ptr->wlr_output_ptr->events.commit,
+        &remote_ptr->output_commit_listener,
+        _wlmbe_remote_handle_output_commit);
+    wlmtk_util_connect_listener_signal(
+        &remote_ptr->wlr_output_ptr->events.destroy,
+        &remote_ptr->output_destroy_listener,
+        _wlmbe_remote_handle_output_destroy);
+    bs_log(BS_INFO, "Remote output %s", remote_ptr->wlr_output_ptr->name);
+    return remote_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmbe_remote_destroy(wlmbe_remote_t *remote_ptr)
+{
+    // Frames are released by the consumer, maybe later. Just detach them.
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&remote_ptr->frames))) {
+        BS_CONTAINER_OF(
+            dlnode_ptr, wlmbe_remote_frame_t, dlnode)->remote_ptr = NULL;
+    }
+
+    if (NULL != remote_ptr->wlr_output_ptr) {
+        _wlmbe_remote_handle_output_destroy(
+            &remote_ptr->output_destroy_listener, NULL);
+    }
+    if (NULL != remote_ptr->rate_timer_ptr) {
+        wl_event_source_remove(remote_ptr->rate_timer_ptr);
+        remote_ptr->rate_timer_ptr = NULL;
+    }
+    free(remote_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmbe_remote_set_consumer(
+    wlmbe_remote_t *remote_ptr,
+    wlmbe_remote_frame_callback_t callback,
+    void *ud_ptr,
+    unsigned max_fps,
+    unsigned max_frames_in_flight)
+{
+    remote_ptr->callback = callback;
+    remote_ptr->ud_ptr = ud_ptr;
+    remote_ptr->max_fps = max_fps;
+    remote_ptr->max_frames_in_flight = BS_MAX(1u, max_frames_in_flight);
+    remote_ptr->damage_whole = true;
+    remote_ptr->rate_limited = false;
+    wl_event_source_timer_update(remote_ptr->rate_timer_ptr, 0);
+    _wlmbe_remote_update_held(remote_ptr);
+
+    // A new consumer needs a first frame, even if nothing changes.
+    if (NULL != callback && NULL != remote_ptr->wlr_output_ptr) {
+        wlr_output_update_needs_frame(remote_ptr->wlr_output_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+struct wlr_output *wlmbe_remote_wlr_output(wlmbe_remote_t *remote_ptr)
+{
+    return remote_ptr->wlr_output_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmbe_remote_frame_release(wlmbe_remote_frame_t *frame_ptr)
+{
+    wlmbe_remote_t *remote_ptr = frame_ptr->remote_ptr;
+    if (NULL != remote_ptr) {
+        bs_dllist_remove(&remote_ptr->frames, &frame_ptr->dlnode);
+    }
+    wlr_buffer_unlock(frame_ptr->wlr_buffer_ptr);
+    pixman_region32_fini(&frame_ptr->damage);
+    free(frame_ptr);
+
+    if (NULL != remote_ptr) _wlmbe_remote_update_held(remote_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+struct wlr_buffer *wlmbe_remote_frame_buffer(wlmbe_remote_frame_t *frame_ptr)
+{
+    return frame_ptr->wlr_buffer_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmbe_remote_frame_dmabuf(
+    wlmbe_remote_frame_t *frame_ptr,
+    struct wlr_dmabuf_attributes *attributes_ptr)
+{
+    return wlr_buffer_get_dmabuf(frame_ptr->wlr_buffer_ptr, attributes_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+const pixman_box32_t *wlmbe_remote_frame_damage(
+    wlmbe_remote_frame_t *frame_ptr,
+    int *rects_ptr)
+{
+    return pixman_region32_rectangles(&frame_ptr->damage, rects_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+uint64_t wlmbe_remote_frame_sequence(wlmbe_remote_frame_t *frame_ptr)
+{
+    return frame_ptr->sequence;
+}
+
+/* ------------------------------------------------------------------------- */
+wlmbe_remote_t *wlmbe_remote_from_dlnode(bs_dllist_node_t *dlnode_ptr)
+{
+    if (NULL == dlnode_ptr) return NULL;
+    return BS_CONTAINER_OF(dlnode_ptr, wlmbe_remote_t, dlnode);
+}
+
+/* ------------------------------------------------------------------------- */
+bs_dllist_node_t *wlmbe_dlnode_from_remote(wlmbe_remote_t *remote_ptr)
+{
+    return &remote_ptr->dlnode;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Event handler for the `commit` signal raised by `wlr_output`: Hands the
+ * committed buffer and its damage to the consumer, if there is one.
+ *
+ * @param listener_ptr
+ * @param data_ptr            Points to a `struct wlr_output_event_commit`.
+ */
+void _wlmbe_remote_handle_output_commit(
+    struct wl_listener *listener_ptr,
+    void *data_ptr)
+{
+    wlmbe_remote_t *remote_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmbe_remote_t, output_commit_listener);
+    const struct wlr_output_event_commit *event_ptr = data_ptr;
+    const struct wlr_output_state *state_ptr = event_ptr->state;
+    if (NULL == remote_ptr->callback ||
+        !(state_ptr->committed & WLR_OUTPUT_STATE_BUFFER) ||
+        NULL == state_ptr->buffer) return;
+
+    wlmbe_remote_frame_t *frame_ptr = logged_calloc(
+        1, sizeof(wlmbe_remote_frame_t));
+    if (NULL == frame_ptr) return;
+    frame_ptr->remote_ptr = remote_ptr;
+    frame_ptr->wlr_buffer_ptr = wlr_buffer_lock(state_ptr->buffer);
+    frame_ptr->sequence = ++remote_ptr->sequence;
+    if (!remote_ptr->damage_whole &&
+        (state_ptr->committed & WLR_OUTPUT_STATE_DAMAGE)) {
+        pixman_region32_init(&frame_ptr->damage);
+        pixman_region32_copy(&frame_ptr->damage, &state_ptr->damage);
+    } else {
+        pixman_region32_init_rect(
+            &frame_ptr->damage, 0, 0,
+            state_ptr->buffer->width, state_ptr->buffer->height);
+    }
+    remote_ptr->damage_whole = false;
+    bs_dllist_push_back(&remote_ptr->frames, &frame_ptr->dlnode);
+
+    uint64_t interval_msec = _wlmbe_remote_interval_msec(remote_ptr->max_fps);
+    if (0 < interval_msec) {
+        remote_ptr->rate_limited = true;
+        wl_event_source_timer_update(
+            remote_ptr->rate_timer_ptr, interval_msec);
+    }
+    _wlmbe_remote_update_held(remote_ptr);
+
+    remote_ptr->callback(frame_ptr, remote_ptr->ud_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Event handler for the `destroy` signal raised by `wlr_output`.
+ *
+ * @param listener_ptr
+ * @param data_ptr
+ */
+void _wlmbe_remote_handle_output_destroy(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmbe_remote_t *remote_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmbe_remote_t, output_destroy_listener);
+
+    wlmtk_util_disconnect_listener(&remote_ptr->output_destroy_listener);
+    wlmtk_util_disconnect_listener(&remote_ptr->output_commit_listener);
+    remote_ptr->wlr_output_ptr = NULL;
+    remote_ptr->output_ptr = NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles the frame rate timer: Frames may be rendered again. */
+int _wlmbe_remote_handle_rate_timer(void *data_ptr)
+{
+    wlmbe_remote_t *remote_ptr = data_ptr;
+    remote_ptr->rate_limited = false;
+    _wlmbe_remote_update_held(remote_ptr);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Holds the output's frames while the frame rate cap applies, or while the
+ * consumer holds @ref wlmbe_remote_t::max_frames_in_flight frames.
+ *
+ * @param remote_ptr
+ */
+void _wlmbe_remote_update_held(wlmbe_remote_t *remote_ptr)
+{
+    if (NULL == remote_ptr->output_ptr) return;
+    wlmbe_output_set_held(
+        remote_ptr->output_ptr,
+        NULL != remote_ptr->callback &&
+        (remote_ptr->rate_limited ||
+         bs_dllist_size(&remote_ptr->frames) >=
+         remote_ptr->max_frames_in_flight));
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the minimum interval between frames, for a rate of at most
+ * `max_fps`. Rounded up, to not exceed the rate.
+ *
+ * @param max_fps
+ *
+ * @return The interval, in milliseconds. 0 if `max_fps` is 0.
+ */
+uint64_t _wlmbe_remote_interval_msec(unsigned max_fps)
+{
+    if (0 == max_fps) return 0;
+    return (1000u + max_fps - 1) / max_fps;
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlmbe_remote_test_interval(bs_test_t *test_ptr);
+
+const bs_test_case_t          wlmbe_remote_test_cases[] = {
+    { 1, "interval", _wlmbe_remote_test_interval },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Verifies the frame interval does not exceed the rate cap. */
+void _wlmbe_remote_test_interval(bs_test_t *test_ptr)
+{
+    BS_TEST_VERIFY_EQ(test_ptr, 0, _wlmbe_remote_interval_msec(0));
+    BS_TEST_VERIFY_EQ(test_ptr, 1000, _wlmbe_remote_interval_msec(1));
+    BS_TEST_VERIFY_EQ(test_ptr, 34, _wlmbe_remote_interval_msec(30));
+    BS_TEST_VERIFY_EQ(test_ptr, 17, _wlmbe_remote_interval_msec(60));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, _wlmbe_remote_interval_msec(1000));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, _wlmbe_remote_interval_msec(5000));
+}
+
+/* == End of remote.c ====================================================== */
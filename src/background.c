@@ -23,8 +23,10 @@
 #include <libbase/libbase.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 #include <wayland-server-core.h>
 #define WLR_USE_UNSTABLE
+#include <wlr/types/wlr_output.h>
 #include <wlr/types/wlr_output_layout.h>
 #include <wlr/util/edges.h>
 #undef WLR_USE_UNSTABLE
@@ -36,11 +38,24 @@ struct wlr_output;
 
 /** Background state. */
 struct _wlmaker_background_t {
-    /** Links to layer. */
-    wlmtk_layer_t              *layer_ptr;
+    /** Element of the list passed to @ref wlmaker_background_find. */
+    bs_dllist_node_t          dlnode;
+    /** Root, to look up which workspace is shown on each output. */
+    wlmtk_root_t              *root_ptr;
+    /**
+     * Workspaces sharing this background. Each output's panel is in the
+     * background layer of one of these; of the first one, initially.
+     */
+    wlmtk_workspace_t         **workspace_ptrs;
+    /** Number of elements in use at `workspace_ptrs`. */
+    size_t                    workspaces_size;
+    /** Allocated number of elements at `workspace_ptrs`. */
+    size_t                    workspaces_capacity;
 
     /** color of the background. */
     uint32_t                   color;
+    /** Path to the wallpaper image, or NULL for only the color. */
+    char                       *image_path_ptr;
 
     /** The output layout. */
     struct wlr_output_layout  *wlr_output_layout_ptr;
@@ -49,6 +64,8 @@ struct _wlmaker_background_t {
 
     /** Event: Output layout changed. Parameter: struct wlr_box*. */
     struct wl_listener        output_layout_change_listener;
+    /** Listener for @ref wlmtk_root_events_t::workspace_changed. */
+    struct wl_listener        workspace_changed_listener;
 };
 
 /** Background panel: The workspace's backgrund for the output. */
@@ -58,6 +75,14 @@ typedef struct  {
 
     /** Initial implementation: The background is a uni-color rectangle. */
     wlmtk_rectangle_t         *rectangle_ptr;
+    /** The wallpaper, atop the rectangle. NULL if there is no image. */
+    wlmtk_image_t             *image_ptr;
+    /** Logical width the wallpaper was created for. */
+    int                       image_width;
+    /** Logical height the wallpaper was created for. */
+    int                       image_height;
+    /** Output scale the wallpaper was created for. */
+    double                    image_scale;
 
     /** Tree node. Element of @ref wlmaker_background_t::output_tree_ptr. */
     bs_avltree_node_t         avlnode;
@@ -79,9 +104,19 @@ static void _wlmaker_background_handle_output_layout_change(
     struct wl_listener *listener_ptr,
     void *data_ptr);
 
+static void _wlmaker_background_handle_workspace_changed(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+
 static bool _wlmaker_background_update_output(
     struct wl_list *link_ptr,
     void *ud_ptr);
+static wlmtk_layer_t *_wlmaker_background_shown_layer(
+    wlmaker_background_t *background_ptr,
+    struct wlr_output *wlr_output_ptr);
+static bool _wlmaker_background_place_panel(
+    struct wl_list *link_ptr,
+    void *ud_ptr);
 
 static wlmaker_background_panel_t *_wlmaker_background_panel_create(
     wlmtk_layer_t *layer_ptr,
@@ -89,6 +124,12 @@ static wlmaker_background_panel_t *_wlmaker_background_panel_create(
     uint32_t color);
 static void _wlmaker_background_panel_destroy(
     wlmaker_background_panel_t *background_panel_ptr);
+static void _wlmaker_background_panel_update_image(
+    wlmaker_background_panel_t *background_panel_ptr,
+    int width,
+    int height);
+static void _wlmaker_background_panel_destroy_image(
+    wlmaker_background_panel_t *background_panel_ptr);
 static int _wlmaker_background_panel_node_cmp(
     const bs_avltree_node_t *avlnode_ptr,
     const void *key_ptr);
@@ -124,15 +165,27 @@ static const wlmtk_panel_positioning_t _wlmaker_background_panel_position = {
 
 /* ------------------------------------------------------------------------- */
 wlmaker_background_t *wlmaker_background_create(
+    wlmtk_root_t *root_ptr,
     wlmtk_workspace_t *workspace_ptr,
     struct wlr_output_layout *wlr_output_layout_ptr,
-    uint32_t color)
+    uint32_t color,
+    const char *image_path_ptr)
 {
     wlmaker_background_t *background_ptr = logged_calloc(
         1, sizeof(wlmaker_background_t));
     if (NULL == background_ptr) return NULL;
-    background_ptr->layer_ptr = wlmtk_workspace_get_layer(
-        workspace_ptr, WLMTK_WORKSPACE_LAYER_BACKGROUND),
+    if (NULL != image_path_ptr) {
+        background_ptr->image_path_ptr = logged_strdup(image_path_ptr);
+        if (NULL == background_ptr->image_path_ptr) {
+            wlmaker_background_destroy(background_ptr);
+            return NULL;
+        }
+    }
+    background_ptr->root_ptr = root_ptr;
+    if (!wlmaker_background_add_workspace(background_ptr, workspace_ptr)) {
+        wlmaker_background_destroy(background_ptr);
+        return NULL;
+    }
 
     background_ptr->wlr_output_layout_ptr = wlr_output_layout_ptr;
     background_ptr->color = color;
@@ -145,19 +198,27 @@ wlmaker_background_t *wlmaker_background_create(
         return NULL;
     }
 
-    wlmtk_util_connect_listener_signal(
-        &wlr_output_layout_ptr->events.change,
+    wlmtk_layout_epoch_connect(
+        wlr_output_layout_ptr,
+        WLMTK_LAYOUT_EPOCH_STAGE_OUTPUTS,
         &background_ptr->output_layout_change_listener,
         _wlmaker_background_handle_output_layout_change);
     _wlmaker_background_handle_output_layout_change(
         &background_ptr->output_layout_change_listener,
         NULL);
+
+    wlmtk_util_connect_listener_signal(
+        &wlmtk_root_events(root_ptr)->workspace_changed,
+        &background_ptr->workspace_changed_listener,
+        _wlmaker_background_handle_workspace_changed);
     return background_ptr;
 }
 
 /* ------------------------------------------------------------------------- */
 void wlmaker_background_destroy(wlmaker_background_t *background_ptr)
 {
+    wlmtk_util_disconnect_listener(
+        &background_ptr->workspace_changed_listener);
     wlmtk_util_disconnect_listener(
         &background_ptr->output_layout_change_listener);
 
@@ -165,9 +226,84 @@ void wlmaker_background_destroy(wlmaker_background_t *background_ptr)
         bs_avltree_destroy(background_ptr->output_tree_ptr);
         background_ptr->output_tree_ptr = NULL;
     }
+    if (NULL != background_ptr->workspace_ptrs) {
+        free(background_ptr->workspace_ptrs);
+    }
+    if (NULL != background_ptr->image_path_ptr) {
+        free(background_ptr->image_path_ptr);
+    }
     free(background_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+bool wlmaker_background_add_workspace(
+    wlmaker_background_t *background_ptr,
+    wlmtk_workspace_t *workspace_ptr)
+{
+    if (background_ptr->workspaces_size >=
+        background_ptr->workspaces_capacity) {
+        size_t capacity = BS_MAX(4U, 2 * background_ptr->workspaces_capacity);
+        wlmtk_workspace_t **workspace_ptrs = logged_calloc(
+            capacity, sizeof(wlmtk_workspace_t*));
+        if (NULL == workspace_ptrs) return false;
+        if (NULL != background_ptr->workspace_ptrs) {
+            memcpy(workspace_ptrs, background_ptr->workspace_ptrs,
+                   background_ptr->workspaces_size *
+                   sizeof(wlmtk_workspace_t*));
+            free(background_ptr->workspace_ptrs);
+        }
+        background_ptr->workspace_ptrs = workspace_ptrs;
+        background_ptr->workspaces_capacity = capacity;
+    }
+    background_ptr->workspace_ptrs[background_ptr->workspaces_size++] =
+        workspace_ptr;
+
+    // The panels may already belong to the newly added workspace.
+    if (NULL != background_ptr->wlr_output_layout_ptr) {
+        _wlmaker_background_handle_workspace_changed(
+            &background_ptr->workspace_changed_listener, NULL);
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+wlmaker_background_t *wlmaker_background_find(
+    bs_dllist_t *backgrounds_ptr,
+    uint32_t color,
+    const char *image_path_ptr)
+{
+    for (bs_dllist_node_t *dlnode_ptr = backgrounds_ptr->head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_background_t *background_ptr =
+            wlmaker_background_from_dlnode(dlnode_ptr);
+        if (color != background_ptr->color) continue;
+        if (NULL == image_path_ptr || NULL == background_ptr->image_path_ptr) {
+            if (image_path_ptr == background_ptr->image_path_ptr) {
+                return background_ptr;
+            }
+        } else if (0 == strcmp(image_path_ptr,
+                               background_ptr->image_path_ptr)) {
+            return background_ptr;
+        }
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+bs_dllist_node_t *wlmaker_dlnode_from_background(
+    wlmaker_background_t *background_ptr)
+{
+    return &background_ptr->dlnode;
+}
+
+/* ------------------------------------------------------------------------- */
+wlmaker_background_t *wlmaker_background_from_dlnode(
+    bs_dllist_node_t *dlnode_ptr)
+{
+    return BS_CONTAINER_OF(dlnode_ptr, wlmaker_background_t, dlnode);
+}
+
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -205,6 +341,26 @@ void _wlmaker_background_handle_output_layout_change(
     bs_avltree_destroy(arg.former_output_tree_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles @ref wlmtk_root_events_t::workspace_changed. Moves each output's
+ * panel to the workspace sharing this background, if one is shown there.
+ *
+ * @param listener_ptr
+ * @param data_ptr
+ */
+void _wlmaker_background_handle_workspace_changed(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmaker_background_t *background_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_background_t, workspace_changed_listener);
+    BS_ASSERT(wlmtk_util_wl_list_for_each(
+                  &background_ptr->wlr_output_layout_ptr->outputs,
+                  _wlmaker_background_place_panel,
+                  background_ptr));
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Updates the output.
@@ -230,8 +386,15 @@ bool _wlmaker_background_update_output(
         background_panel_ptr = BS_CONTAINER_OF(
             avlnode_ptr, wlmaker_background_panel_t, avlnode);
     } else {
+        wlmtk_layer_t *layer_ptr = _wlmaker_background_shown_layer(
+            arg_ptr->background_ptr, wlr_output_ptr);
+        if (NULL == layer_ptr) {
+            layer_ptr = wlmtk_workspace_get_layer(
+                arg_ptr->background_ptr->workspace_ptrs[0],
+                WLMTK_WORKSPACE_LAYER_BACKGROUND);
+        }
         background_panel_ptr = _wlmaker_background_panel_create(
-            arg_ptr->background_ptr->layer_ptr,
+            layer_ptr,
             wlr_output_ptr,
             arg_ptr->background_ptr->color);
         if (NULL == background_panel_ptr) return false;
@@ -245,6 +408,76 @@ bool _wlmaker_background_update_output(
         false);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the background layer of the workspace shown on `wlr_output_ptr`,
+ * if that workspace shares this background.
+ *
+ * @param background_ptr
+ * @param wlr_output_ptr
+ *
+ * @return Pointer to the layer, or NULL if none of the workspaces sharing
+ *     this background is shown on the output.
+ */
+wlmtk_layer_t *_wlmaker_background_shown_layer(
+    wlmaker_background_t *background_ptr,
+    struct wlr_output *wlr_output_ptr)
+{
+    wlmtk_root_t *root_ptr = background_ptr->root_ptr;
+    bool per_output = wlmtk_root_per_output_workspaces(root_ptr);
+    wlmtk_workspace_t *current_workspace_ptr =
+        wlmtk_root_get_current_workspace(root_ptr);
+
+    for (size_t i = 0; i < background_ptr->workspaces_size; ++i) {
+        wlmtk_workspace_t *workspace_ptr = background_ptr->workspace_ptrs[i];
+        if (per_output ?
+            wlmtk_root_workspace_shown_on_output(
+                root_ptr, workspace_ptr, wlr_output_ptr) :
+            workspace_ptr == current_workspace_ptr) {
+            return wlmtk_workspace_get_layer(
+                workspace_ptr, WLMTK_WORKSPACE_LAYER_BACKGROUND);
+        }
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Moves the output's panel to the layer of the sharing workspace shown on
+ * it. Leaves it in place if none is shown: It is hidden anyway.
+ *
+ * @param link_ptr            struct wlr_output_layout_output::link.
+ * @param ud_ptr              The @ref wlmaker_background_t.
+ *
+ * @return true on success, or false on error.
+ */
+bool _wlmaker_background_place_panel(
+    struct wl_list *link_ptr,
+    void *ud_ptr)
+{
+    struct wlr_output_layout_output *wlr_output_layout_output_ptr =
+        BS_CONTAINER_OF(link_ptr, struct wlr_output_layout_output, link);
+    struct wlr_output *wlr_output_ptr = wlr_output_layout_output_ptr->output;
+    wlmaker_background_t *background_ptr = ud_ptr;
+
+    bs_avltree_node_t *avlnode_ptr = bs_avltree_lookup(
+        background_ptr->output_tree_ptr, wlr_output_ptr);
+    if (NULL == avlnode_ptr) return true;
+    wlmaker_background_panel_t *background_panel_ptr = BS_CONTAINER_OF(
+        avlnode_ptr, wlmaker_background_panel_t, avlnode);
+    wlmtk_panel_t *panel_ptr = &background_panel_ptr->super_panel;
+
+    wlmtk_layer_t *layer_ptr = _wlmaker_background_shown_layer(
+        background_ptr, wlr_output_ptr);
+    wlmtk_layer_t *current_layer_ptr = wlmtk_panel_get_layer(panel_ptr);
+    if (NULL == layer_ptr || current_layer_ptr == layer_ptr) return true;
+
+    if (NULL != current_layer_ptr) {
+        wlmtk_layer_remove_panel(current_layer_ptr, panel_ptr);
+    }
+    return wlmtk_layer_add_panel(layer_ptr, panel_ptr, wlr_output_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Ctor. */
 wlmaker_background_panel_t *_wlmaker_background_panel_create(
@@ -306,6 +539,7 @@ void _wlmaker_background_panel_destroy(
             &background_panel_ptr->super_panel);
     }
 
+    _wlmaker_background_panel_destroy_image(background_panel_ptr);
     if (NULL != background_panel_ptr->rectangle_ptr) {
         wlmtk_container_remove_element(
             &background_panel_ptr->super_panel.super_container,
@@ -320,6 +554,70 @@ void _wlmaker_background_panel_destroy(
     free(background_panel_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * (Re)creates the wallpaper, if the panel's size or output scale changed.
+ *
+ * The image is decoded for the output's pixel size. Decoded images are
+ * shared: Panels of other workspaces on same-sized outputs use the same
+ * buffer, hence switching workspaces does not decode again.
+ *
+ * @param background_panel_ptr
+ * @param width
+ * @param height
+ */
+void _wlmaker_background_panel_update_image(
+    wlmaker_background_panel_t *background_panel_ptr,
+    int width,
+    int height)
+{
+    wlmaker_background_t *background_ptr =
+        background_panel_ptr->background_ptr;
+    if (NULL == background_ptr || NULL == background_ptr->image_path_ptr) {
+        return;
+    }
+
+    double scale = background_panel_ptr->wlr_output_ptr->scale;
+    if (0 >= scale) scale = 1.0;
+    if (NULL != background_panel_ptr->image_ptr &&
+        width == background_panel_ptr->image_width &&
+        height == background_panel_ptr->image_height &&
+        scale == background_panel_ptr->image_scale) return;
+
+    _wlmaker_background_panel_destroy_image(background_panel_ptr);
+    if (0 >= width || 0 >= height) return;
+
+    background_panel_ptr->image_ptr = wlmtk_image_create_scaled_at(
+        background_ptr->image_path_ptr, width, height, scale);
+    if (NULL == background_panel_ptr->image_ptr) {
+        bs_log(BS_WARNING, "Failed to load wallpaper \"%s\", using color.",
+               background_ptr->image_path_ptr);
+        return;
+    }
+    background_panel_ptr->image_width = width;
+    background_panel_ptr->image_height = height;
+    background_panel_ptr->image_scale = scale;
+    wlmtk_element_set_visible(
+        wlmtk_image_element(background_panel_ptr->image_ptr), true);
+    wlmtk_container_add_element_atop(
+        &background_panel_ptr->super_panel.super_container,
+        wlmtk_rectangle_element(background_panel_ptr->rectangle_ptr),
+        wlmtk_image_element(background_panel_ptr->image_ptr));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Removes and destroys the wallpaper of the panel, if any. */
+void _wlmaker_background_panel_destroy_image(
+    wlmaker_background_panel_t *background_panel_ptr)
+{
+    if (NULL == background_panel_ptr->image_ptr) return;
+    wlmtk_container_remove_element(
+        &background_panel_ptr->super_panel.super_container,
+        wlmtk_image_element(background_panel_ptr->image_ptr));
+    wlmtk_image_destroy(background_panel_ptr->image_ptr);
+    background_panel_ptr->image_ptr = NULL;
+}
+
 /* ------------------------------------------------------------------------- */
 /** Comparator for @ref wlmaker_background_t::output_tree_ptr. */
 int _wlmaker_background_panel_node_cmp(
@@ -371,6 +669,7 @@ uint32_t _wlmaker_background_panel_request_size(
         panel_ptr, wlmaker_background_panel_t, super_panel);
 
     wlmtk_rectangle_set_size(background_ptr->rectangle_ptr, width, height);
+    _wlmaker_background_panel_update_image(background_ptr, width, height);
 
     wlmtk_panel_commit(
         &background_ptr->super_panel, 0,
@@ -20,6 +20,8 @@
 #ifndef __BACKGROUND_H__
 #define __BACKGROUND_H__
 
+#include <libbase/libbase.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "toolkit/toolkit.h"
@@ -36,16 +38,26 @@ typedef struct _wlmaker_background_t wlmaker_background_t;
 /**
  * Creates a background, derived from a @ref wlmtk_panel_t.
  *
- * @param workspace_ptr
+ * The background holds one panel per output. Further workspaces of the same
+ * color and image share these panels, see
+ * @ref wlmaker_background_add_workspace.
+ *
+ * @param root_ptr            To look up which workspace is shown where.
+ * @param workspace_ptr       The first workspace showing this background.
  * @param wlr_output_layout_ptr
  * @param color
+ * @param image_path_ptr      Optional: Path to a wallpaper image, shown atop
+ *                            the color and scaled to each output. May be
+ *                            NULL.
  *
  * @return A handle for the background, or NULL on error.
  */
 wlmaker_background_t *wlmaker_background_create(
+    wlmtk_root_t *root_ptr,
     wlmtk_workspace_t *workspace_ptr,
     struct wlr_output_layout *wlr_output_layout_ptr,
-    uint32_t color);
+    uint32_t color,
+    const char *image_path_ptr);
 
 /**
  * Destroys the background.
@@ -54,6 +66,46 @@ wlmaker_background_t *wlmaker_background_create(
  */
 void wlmaker_background_destroy(wlmaker_background_t *background_ptr);
 
+/**
+ * Shares the background with another workspace.
+ *
+ * Each output's panel is moved to the layer of the workspace shown on that
+ * output, when the current workspace changes. Workspaces sharing the
+ * background hence do not hold panels, rectangles and wallpaper buffers of
+ * their own.
+ *
+ * @param background_ptr
+ * @param workspace_ptr
+ *
+ * @return true on success.
+ */
+bool wlmaker_background_add_workspace(
+    wlmaker_background_t *background_ptr,
+    wlmtk_workspace_t *workspace_ptr);
+
+/**
+ * Finds a background with the given color and image, to share.
+ *
+ * @param backgrounds_ptr     List of @ref wlmaker_background_t, linked
+ *                            through @ref wlmaker_dlnode_from_background.
+ * @param color
+ * @param image_path_ptr      Path to the wallpaper image, or NULL.
+ *
+ * @return The background, or NULL if there is none matching.
+ */
+wlmaker_background_t *wlmaker_background_find(
+    bs_dllist_t *backgrounds_ptr,
+    uint32_t color,
+    const char *image_path_ptr);
+
+/** @return Pointer to the list node of `background_ptr`. */
+bs_dllist_node_t *wlmaker_dlnode_from_background(
+    wlmaker_background_t *background_ptr);
+
+/** @return The @ref wlmaker_background_t holding `dlnode_ptr`. */
+wlmaker_background_t *wlmaker_background_from_dlnode(
+    bs_dllist_node_t *dlnode_ptr);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
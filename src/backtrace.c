@@ -21,10 +21,14 @@
 
 #include "backtrace.h"
 
+#include <errno.h>
 #include <inttypes.h>
 #include <libbase/libbase.h>
+#include <semaphore.h>
 #include <signal.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <time.h>
 
 #if defined(WLMAKER_HAVE_LIBBACKTRACE)
 #include <backtrace.h>
@@ -37,6 +41,20 @@
 /** State for libbacktrace. */
 static struct backtrace_state *_wlmaker_bt_state_ptr;
 
+/** Maximum number of frames captured by @ref wlmaker_backtrace_log_thread. */
+#define WLMAKER_BACKTRACE_THREAD_FRAMES 48
+
+/** Program counters, as captured by @ref _signal_capture. */
+static uintptr_t _wlmaker_bt_pcs[WLMAKER_BACKTRACE_THREAD_FRAMES];
+/** Number of valid entries in @ref _wlmaker_bt_pcs. */
+static volatile sig_atomic_t _wlmaker_bt_pcs_len;
+/** Posted by @ref _signal_capture, once the counters are recorded. */
+static sem_t                  _wlmaker_bt_captured;
+/** Serializes @ref wlmaker_backtrace_log_thread. */
+static pthread_mutex_t        _wlmaker_bt_mutex = PTHREAD_MUTEX_INITIALIZER;
+/** How long to wait for the signalled thread, in milliseconds. */
+static const long             _wlmaker_bt_capture_timeout_msec = 200;
+
 static void _backtrace_error_callback(
     __UNUSED__ void *data_ptr,
     const char *msg_ptr,
@@ -47,7 +65,19 @@ static int _backtrace_full_callback(
     const char *filename_ptr,
     int line_num,
     const char *function_ptr);
+static int _backtrace_pcinfo_callback(
+    void *data_ptr,
+    uintptr_t pc,
+    const char *filename_ptr,
+    int line_num,
+    const char *function_ptr);
+static int _backtrace_simple_callback(__UNUSED__ void *data_ptr, uintptr_t pc);
+static void _backtrace_silent_error_callback(
+    __UNUSED__ void *data_ptr,
+    __UNUSED__ const char *msg_ptr,
+    __UNUSED__ int errnum);
 static void _signal_backtrace(int signum);
+static void _signal_capture(int signum);
 
 #endif  // defined(WLMAKER_HAVE_LIBBACKTRACE)
 
@@ -58,12 +88,25 @@ bool wlmaker_backtrace_setup(const char *filename_ptr)
 {
 #if defined(WLMAKER_HAVE_LIBBACKTRACE)
 
+    // Threaded: Stall reports resolve frames on the watchdog thread.
     _wlmaker_bt_state_ptr = backtrace_create_state(
-        filename_ptr, 0, _backtrace_error_callback, NULL);
+        filename_ptr, 1, _backtrace_error_callback, NULL);
     if (NULL == _wlmaker_bt_state_ptr) {
         bs_log(BS_ERROR, "Failed backtrace_create_state()");
         return false;
     }
+    if (0 != sem_init(&_wlmaker_bt_captured, 0, 0)) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed sem_init(%p, 0, 0)",
+               &_wlmaker_bt_captured);
+        return false;
+    }
+    struct sigaction sa = { .sa_handler = _signal_capture };
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    if (0 != sigaction(SIGUSR2, &sa, NULL)) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed sigaction(SIGUSR2)");
+        return false;
+    }
     signal(SIGABRT, _signal_backtrace);
     signal(SIGBUS, _signal_backtrace);
     signal(SIGFPE, _signal_backtrace);
@@ -79,6 +122,59 @@ bool wlmaker_backtrace_setup(const char *filename_ptr)
     return true;
 }
 
+/* ------------------------------------------------------------------------- */
+bool wlmaker_backtrace_log_thread(
+    pthread_t thread,
+    bs_log_severity_t severity)
+{
+#if defined(WLMAKER_HAVE_LIBBACKTRACE)
+
+    if (NULL == _wlmaker_bt_state_ptr) return false;
+
+    pthread_mutex_lock(&_wlmaker_bt_mutex);
+    // Drain a post from an earlier capture that had timed out.
+    while (0 == sem_trywait(&_wlmaker_bt_captured)) {}
+
+    int rv = pthread_kill(thread, SIGUSR2);
+    if (0 != rv) {
+        errno = rv;
+        bs_log(BS_WARNING | BS_ERRNO, "Failed pthread_kill(%lu, SIGUSR2)",
+               (unsigned long)thread);
+        pthread_mutex_unlock(&_wlmaker_bt_mutex);
+        return false;
+    }
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += _wlmaker_bt_capture_timeout_msec * 1000000;
+    deadline.tv_sec += deadline.tv_nsec / 1000000000;
+    deadline.tv_nsec %= 1000000000;
+    while (0 != sem_timedwait(&_wlmaker_bt_captured, &deadline)) {
+        if (EINTR == errno) continue;
+        bs_log(BS_WARNING, "Thread %lu did not capture its backtrace.",
+               (unsigned long)thread);
+        pthread_mutex_unlock(&_wlmaker_bt_mutex);
+        return false;
+    }
+
+    for (sig_atomic_t i = 0; i < _wlmaker_bt_pcs_len; ++i) {
+        backtrace_pcinfo(
+            _wlmaker_bt_state_ptr, _wlmaker_bt_pcs[i],
+            _backtrace_pcinfo_callback, _backtrace_error_callback,
+            &severity);
+    }
+    pthread_mutex_unlock(&_wlmaker_bt_mutex);
+    return true;
+
+#else
+
+    bs_log(BS_DEBUG, "No libbacktrace, ignoring backtrace for thread %lu "
+           "at severity %d.", (unsigned long)thread, severity);
+    return false;
+
+#endif  // defined(WLMAKER_HAVE_LIBBACKTRACE)
+}
+
 /* == Local (static) methods =============================================== */
 
 #if defined(WLMAKER_HAVE_LIBBACKTRACE)
@@ -112,6 +208,42 @@ int _backtrace_full_callback(
     return 0;
 }
 
+/* ------------------------------------------------------------------------- */
+/** Callback for resolving a captured frame. Logs at `*data_ptr` severity. */
+int _backtrace_pcinfo_callback(
+    void *data_ptr,
+    uintptr_t program_counter,
+    const char *filename_ptr,
+    int line_num,
+    const char *function_ptr)
+{
+    bs_log_severity_t *severity_ptr = data_ptr;
+    bs_log(*severity_ptr, "%"PRIxPTR" in %s () at %s:%d",
+           program_counter,
+           function_ptr ? function_ptr : "(unknown)",
+           filename_ptr ? filename_ptr : "(unknown)",
+           line_num);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Callback for capturing a frame, from within @ref _signal_capture. */
+int _backtrace_simple_callback(__UNUSED__ void *data_ptr, uintptr_t pc)
+{
+    if (WLMAKER_BACKTRACE_THREAD_FRAMES <= _wlmaker_bt_pcs_len) return 1;
+    _wlmaker_bt_pcs[_wlmaker_bt_pcs_len++] = pc;
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Error callback within @ref _signal_capture: Logging is not safe there. */
+void _backtrace_silent_error_callback(
+    __UNUSED__ void *data_ptr,
+    __UNUSED__ const char *msg_ptr,
+    __UNUSED__ int errnum)
+{
+}
+
 /* ------------------------------------------------------------------------- */
 /** Signal handler: Prints a backtrace. */
 void _signal_backtrace(int signum)
@@ -125,6 +257,23 @@ void _signal_backtrace(int signum)
     abort();
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Signal handler for SIGUSR2: Records the program counters of the current
+ * thread, for @ref wlmaker_backtrace_log_thread. Does not log.
+ */
+void _signal_capture(__UNUSED__ int signum)
+{
+    int saved_errno = errno;
+    _wlmaker_bt_pcs_len = 0;
+    // Skip this handler's own frame.
+    backtrace_simple(
+        _wlmaker_bt_state_ptr, 1,
+        _backtrace_simple_callback, _backtrace_silent_error_callback, NULL);
+    sem_post(&_wlmaker_bt_captured);
+    errno = saved_errno;
+}
+
 #endif // defined(WLMAKER_HAVE_LIBBACKTRACE)
 
 /* == End of backtrace.c =================================================== */
@@ -20,6 +20,8 @@
 #ifndef __BACKTRACE_H__
 #define __BACKTRACE_H__
 
+#include <libbase/libbase.h>
+#include <pthread.h>
 #include <stdbool.h>
 
 #ifdef __cplusplus
@@ -38,6 +40,24 @@ extern "C" {
  */
 bool wlmaker_backtrace_setup(const char *filename_ptr);
 
+/**
+ * Logs a backtrace of another thread, while it keeps running.
+ *
+ * Signals `thread` with SIGUSR2. Its handler only records the program
+ * counters; they are resolved and logged on the calling thread. This keeps
+ * the handler clear of stdio and locks, which `thread` may be holding.
+ *
+ * Requires @ref wlmaker_backtrace_setup. Without libbacktrace, does nothing.
+ *
+ * @param thread              The thread to capture. Must not be the caller.
+ * @param severity
+ *
+ * @return true if the backtrace was captured and logged.
+ */
+bool wlmaker_backtrace_log_thread(
+    pthread_t thread,
+    bs_log_severity_t severity);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,412 @@
+/* ========================================================================= */
+/**
+ * @file cgroup.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/// mkdtemp() is a POSIX extension.
+#define _POSIX_C_SOURCE 200809L
+
+#include "cgroup.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <libbase/libbase.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* == Declarations ========================================================= */
+
+/** State of the control groups. */
+struct _wlmaker_cgroup_t {
+    /** Path of the cgroup holding the compositor's and the apps' cgroups. */
+    char                      path[PATH_MAX];
+};
+
+static bool _wlmaker_cgroup_own_path(char *path_ptr, size_t size);
+static bool _wlmaker_cgroup_path(
+    wlmaker_cgroup_t *cgroup_ptr,
+    const char *fname_ptr,
+    char *path_ptr);
+static bool _wlmaker_cgroup_app_path(
+    wlmaker_cgroup_t *cgroup_ptr,
+    pid_t pid,
+    const char *fname_ptr,
+    char *path_ptr);
+static bool _wlmaker_cgroup_write(const char *path_ptr, const char *value_ptr);
+
+/* == Data ================================================================= */
+
+/** Where the cgroup v2 hierarchy is mounted. */
+static const char *_wlmaker_cgroup_mount_ptr = "/sys/fs/cgroup";
+/** Prefix of the apps' cgroups. */
+static const char *_wlmaker_cgroup_app_prefix_ptr = "app-";
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmaker_cgroup_t *wlmaker_cgroup_create(const char *path_ptr)
+{
+    wlmaker_cgroup_t *cgroup_ptr = logged_calloc(1, sizeof(wlmaker_cgroup_t));
+    if (NULL == cgroup_ptr) return NULL;
+    if (NULL != path_ptr) {
+        snprintf(cgroup_ptr->path, sizeof(cgroup_ptr->path), "%s", path_ptr);
+    } else if (!_wlmaker_cgroup_own_path(cgroup_ptr->path,
+                                         sizeof(cgroup_ptr->path))) {
+        wlmaker_cgroup_destroy(cgroup_ptr);
+        return NULL;
+    }
+
+    // cgroup v2 keeps processes in leaves only: Moves the compositor into
+    // one, so that controllers can be enabled for the apps' cgroups.
+    char p[PATH_MAX], value[32];
+    if (!_wlmaker_cgroup_path(cgroup_ptr, "compositor", p)) {
+        wlmaker_cgroup_destroy(cgroup_ptr);
+        return NULL;
+    }
+    if (0 != mkdir(p, 0755) && EEXIST != errno) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed mkdir(%s, 0755). Is the "
+               "cgroup delegated?", p);
+        wlmaker_cgroup_destroy(cgroup_ptr);
+        return NULL;
+    }
+    snprintf(value, sizeof(value), "%"PRIdMAX, (intmax_t)getpid());
+    if (!_wlmaker_cgroup_path(cgroup_ptr, "compositor/cgroup.procs", p) ||
+        !_wlmaker_cgroup_write(p, value)) {
+        wlmaker_cgroup_destroy(cgroup_ptr);
+        return NULL;
+    }
+
+    // Without controllers, apps are still grouped. Just not weighted.
+    if (_wlmaker_cgroup_path(cgroup_ptr, "cgroup.subtree_control", p)) {
+        _wlmaker_cgroup_write(p, "+cpu");
+        _wlmaker_cgroup_write(p, "+memory");
+    }
+    bs_log(BS_INFO, "Placing applications in cgroups below %s",
+           cgroup_ptr->path);
+    return cgroup_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_cgroup_destroy(wlmaker_cgroup_t *cgroup_ptr)
+{
+    DIR *dir_ptr = NULL;
+    if (0 < strlen(cgroup_ptr->path)) dir_ptr = opendir(cgroup_ptr->path);
+    if (NULL != dir_ptr) {
+        struct dirent *dirent_ptr;
+        while (NULL != (dirent_ptr = readdir(dir_ptr))) {
+            if (0 != strncmp(dirent_ptr->d_name,
+                             _wlmaker_cgroup_app_prefix_ptr,
+                             strlen(_wlmaker_cgroup_app_prefix_ptr))) {
+                continue;
+            }
+            // Fails for cgroups of other compositors, or still populated.
+            char p[PATH_MAX];
+            if (_wlmaker_cgroup_path(cgroup_ptr, dirent_ptr->d_name, p)) {
+                rmdir(p);
+            }
+        }
+        closedir(dir_ptr);
+    }
+    free(cgroup_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmaker_cgroup_place(
+    wlmaker_cgroup_t *cgroup_ptr,
+    pid_t pid,
+    const wlmaker_cgroup_limits_t *limits_ptr)
+{
+    char p[PATH_MAX], value[32];
+    if (!_wlmaker_cgroup_app_path(cgroup_ptr, pid, NULL, p)) return false;
+    if (0 != mkdir(p, 0755) && EEXIST != errno) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed mkdir(%s, 0755)", p);
+        return false;
+    }
+    // Limits first: The process shall not run unconstrained in there.
+    wlmaker_cgroup_set_limits(cgroup_ptr, pid, limits_ptr);
+
+    if (!_wlmaker_cgroup_app_path(cgroup_ptr, pid, "cgroup.procs", p)) {
+        return false;
+    }
+    snprintf(value, sizeof(value), "%"PRIdMAX, (intmax_t)pid);
+    return _wlmaker_cgroup_write(p, value);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmaker_cgroup_set_limits(
+    wlmaker_cgroup_t *cgroup_ptr,
+    pid_t pid,
+    const wlmaker_cgroup_limits_t *limits_ptr)
+{
+    const struct {
+        const char            *fname_ptr;
+        uint64_t              value;
+        uint64_t              multiplier;
+    } limits[] = {
+        { "cpu.weight", limits_ptr->cpu_weight, 1 },
+        { "memory.high", limits_ptr->memory_high_mib, UINT64_C(1) << 20 },
+        { "memory.max", limits_ptr->memory_max_mib, UINT64_C(1) << 20 }
+    };
+
+    bool rv = true;
+    for (size_t i = 0; i < sizeof(limits) / sizeof(limits[0]); ++i) {
+        if (0 == limits[i].value) continue;
+        char p[PATH_MAX], value[32];
+        if (!_wlmaker_cgroup_app_path(
+                cgroup_ptr, pid, limits[i].fname_ptr, p)) return false;
+        snprintf(value, sizeof(value), "%"PRIu64,
+                 limits[i].value * limits[i].multiplier);
+        rv = _wlmaker_cgroup_write(p, value) && rv;
+    }
+    return rv;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_cgroup_release(wlmaker_cgroup_t *cgroup_ptr, pid_t pid)
+{
+    char p[PATH_MAX];
+    if (!_wlmaker_cgroup_app_path(cgroup_ptr, pid, NULL, p)) return;
+    if (0 != rmdir(p)) {
+        bs_log(BS_DEBUG | BS_ERRNO, "Failed rmdir(%s), keeping it.", p);
+    }
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Finds the path of the compositor's cgroup, from `/proc/self/cgroup`.
+ *
+ * @param path_ptr
+ * @param size
+ *
+ * @return true on success. false if there's no cgroup v2 entry.
+ */
+bool _wlmaker_cgroup_own_path(char *path_ptr, size_t size)
+{
+    FILE *file_ptr = fopen("/proc/self/cgroup", "r");
+    if (NULL == file_ptr) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed fopen(/proc/self/cgroup, r)");
+        return false;
+    }
+
+    bool found = false;
+    char line[PATH_MAX];
+    while (!found && NULL != fgets(line, sizeof(line), file_ptr)) {
+        // The unified hierarchy's entry is "0::<path>".
+        if (0 != strncmp(line, "0::", 3)) continue;
+        line[strcspn(line, "\n")] = '\0';
+        found = size > (size_t)snprintf(
+            path_ptr, size, "%s%s", _wlmaker_cgroup_mount_ptr, line + 3);
+    }
+    fclose(file_ptr);
+    if (!found) bs_log(BS_WARNING, "Not in a cgroup v2 hierarchy.");
+    return found;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Composes the path to `fname_ptr` below the cgroup of the compositor.
+ *
+ * @param cgroup_ptr
+ * @param fname_ptr
+ * @param path_ptr            Output, must hold PATH_MAX bytes.
+ *
+ * @return true on success.
+ */
+bool _wlmaker_cgroup_path(
+    wlmaker_cgroup_t *cgroup_ptr,
+    const char *fname_ptr,
+    char *path_ptr)
+{
+    size_t len = snprintf(
+        path_ptr, PATH_MAX, "%s/%s", cgroup_ptr->path, fname_ptr);
+    if (PATH_MAX <= len) {
+        bs_log(BS_WARNING, "Path too long for %s below %s",
+               fname_ptr, cgroup_ptr->path);
+        return false;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Composes the path to the cgroup of `pid`, or to a file within.
+ *
+ * @param cgroup_ptr
+ * @param pid
+ * @param fname_ptr           File within the cgroup, or NULL.
+ * @param path_ptr            Output, must hold PATH_MAX bytes.
+ *
+ * @return true on success.
+ */
+bool _wlmaker_cgroup_app_path(
+    wlmaker_cgroup_t *cgroup_ptr,
+    pid_t pid,
+    const char *fname_ptr,
+    char *path_ptr)
+{
+    size_t len = snprintf(
+        path_ptr, PATH_MAX, "%s/%s%"PRIdMAX"%s%s",
+        cgroup_ptr->path, _wlmaker_cgroup_app_prefix_ptr, (intmax_t)pid,
+        NULL != fname_ptr ? "/" : "",
+        NULL != fname_ptr ? fname_ptr : "");
+    if (PATH_MAX <= len) {
+        bs_log(BS_WARNING, "Path too long for cgroup of %"PRIdMAX" below %s",
+               (intmax_t)pid, cgroup_ptr->path);
+        return false;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Writes `value_ptr` to the cgroup interface file at `path_ptr`.
+ *
+ * @param path_ptr
+ * @param value_ptr
+ *
+ * @return true on success.
+ */
+bool _wlmaker_cgroup_write(const char *path_ptr, const char *value_ptr)
+{
+    int fd = open(path_ptr, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (0 > fd) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed open(%s, ...)", path_ptr);
+        return false;
+    }
+    size_t len = strlen(value_ptr);
+    ssize_t written = write(fd, value_ptr, len);
+    if (0 > written || len != (size_t)written) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed write(%d, \"%s\", %zu) to %s",
+               fd, value_ptr, len, path_ptr);
+        close(fd);
+        return false;
+    }
+    close(fd);
+    return true;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_place(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_cgroup_test_cases[] = {
+    { 1, "place", test_place },
+    { 0, NULL, NULL }
+};
+
+/** Reads the file at `dir_ptr`/`fname_ptr` into `buf_ptr`. */
+static const char *_wlmaker_cgroup_test_read(
+    const char *dir_ptr,
+    const char *fname_ptr,
+    char *buf_ptr,
+    size_t size)
+{
+    char p[PATH_MAX];
+    snprintf(p, sizeof(p), "%s/%s", dir_ptr, fname_ptr);
+    int fd = open(p, O_RDONLY);
+    if (0 > fd) return NULL;
+    ssize_t len = read(fd, buf_ptr, size - 1);
+    close(fd);
+    if (0 > len) return NULL;
+    buf_ptr[len] = '\0';
+    return buf_ptr;
+}
+
+/** Removes the file at `dir_ptr`/`fname_ptr`. */
+static void _wlmaker_cgroup_test_unlink(
+    const char *dir_ptr,
+    const char *fname_ptr)
+{
+    char p[PATH_MAX];
+    snprintf(p, sizeof(p), "%s/%s", dir_ptr, fname_ptr);
+    unlink(p);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Places a process, on a directory mocking the cgroup filesystem. */
+void test_place(bs_test_t *test_ptr)
+{
+    char dir[] = "/tmp/wlmaker_cgroup_test_XXXXXX";
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, mkdtemp(dir));
+    char buf[64], expected[32], p[PATH_MAX];
+
+    wlmaker_cgroup_t *cgroup_ptr = wlmaker_cgroup_create(dir);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, cgroup_ptr);
+    snprintf(expected, sizeof(expected), "%"PRIdMAX, (intmax_t)getpid());
+    BS_TEST_VERIFY_STREQ(
+        test_ptr, expected,
+        _wlmaker_cgroup_test_read(dir, "compositor/cgroup.procs",
+                                  buf, sizeof(buf)));
+    // Mocked: Not a cgroup file, keeps only the last write.
+    BS_TEST_VERIFY_STREQ(
+        test_ptr, "+memory",
+        _wlmaker_cgroup_test_read(dir, "cgroup.subtree_control",
+                                  buf, sizeof(buf)));
+
+    wlmaker_cgroup_limits_t limits = { .cpu_weight = 50 };
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmaker_cgroup_place(
+                            cgroup_ptr, 4242, &limits));
+    BS_TEST_VERIFY_STREQ(
+        test_ptr, "4242",
+        _wlmaker_cgroup_test_read(dir, "app-4242/cgroup.procs",
+                                  buf, sizeof(buf)));
+    BS_TEST_VERIFY_STREQ(
+        test_ptr, "50",
+        _wlmaker_cgroup_test_read(dir, "app-4242/cpu.weight",
+                                  buf, sizeof(buf)));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL,
+        _wlmaker_cgroup_test_read(dir, "app-4242/memory.high",
+                                  buf, sizeof(buf)));
+
+    limits = (wlmaker_cgroup_limits_t){ .memory_high_mib = 2 };
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmaker_cgroup_set_limits(
+                            cgroup_ptr, 4242, &limits));
+    BS_TEST_VERIFY_STREQ(
+        test_ptr, "2097152",
+        _wlmaker_cgroup_test_read(dir, "app-4242/memory.high",
+                                  buf, sizeof(buf)));
+
+    // A populated cgroup is kept. Mocked by the files within.
+    wlmaker_cgroup_release(cgroup_ptr, 4242);
+    snprintf(p, sizeof(p), "%s/app-4242", dir);
+    struct stat statbuf;
+    BS_TEST_VERIFY_EQ(test_ptr, 0, stat(p, &statbuf));
+    _wlmaker_cgroup_test_unlink(dir, "app-4242/cgroup.procs");
+    _wlmaker_cgroup_test_unlink(dir, "app-4242/cpu.weight");
+    _wlmaker_cgroup_test_unlink(dir, "app-4242/memory.high");
+    // Emptied: Removed on destroy.
+    wlmaker_cgroup_destroy(cgroup_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, 0, stat(p, &statbuf));
+
+    _wlmaker_cgroup_test_unlink(dir, "compositor/cgroup.procs");
+    _wlmaker_cgroup_test_unlink(dir, "cgroup.subtree_control");
+    snprintf(p, sizeof(p), "%s/compositor", dir);
+    rmdir(p);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, rmdir(dir));
+}
+
+/* == End of cgroup.c ====================================================== */
@@ -0,0 +1,121 @@
+/* ========================================================================= */
+/**
+ * @file cgroup.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __CGROUP_H__
+#define __CGROUP_H__
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+/** Forward declaration: Control groups for launched applications. */
+typedef struct _wlmaker_cgroup_t wlmaker_cgroup_t;
+
+/** Resource controls for an application's cgroup. 0 leaves it unset. */
+typedef struct {
+    /** Relative CPU weight, 1 to 10000. The kernel's default is 100. */
+    uint64_t                  cpu_weight;
+    /** Memory usage above which the application is throttled, in MiB. */
+    uint64_t                  memory_high_mib;
+    /** Hard limit of memory usage, in MiB. */
+    uint64_t                  memory_max_mib;
+} wlmaker_cgroup_limits_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Sets up control groups (cgroup v2) for isolating applications from the
+ * compositor, directly through the cgroup filesystem.
+ *
+ * Moves the compositor process into a `compositor` leaf of its cgroup, and
+ * enables the `cpu` and `memory` controllers for the cgroup's children. Each
+ * application is then placed in an `app-<pid>` sibling, see
+ * @ref wlmaker_cgroup_place. This requires the compositor's cgroup to be
+ * delegated, eg. by running it as a systemd user service with
+ * `Delegate=yes`.
+ *
+ * @param path_ptr            Path of the cgroup to use. If NULL, uses the
+ *                            compositor's cgroup, from `/proc/self/cgroup`.
+ *
+ * @return Pointer to the cgroups, or NULL if the cgroup is not writable.
+ */
+wlmaker_cgroup_t *wlmaker_cgroup_create(const char *path_ptr);
+
+/**
+ * Destroys the cgroups. Removes the cgroups of terminated applications.
+ *
+ * @param cgroup_ptr
+ */
+void wlmaker_cgroup_destroy(wlmaker_cgroup_t *cgroup_ptr);
+
+/**
+ * Creates a cgroup for process `pid`, applies `limits_ptr` and moves the
+ * process into it.
+ *
+ * Best called right after starting the process: Children spawned before
+ * remain in the compositor's cgroup.
+ *
+ * @param cgroup_ptr
+ * @param pid
+ * @param limits_ptr
+ *
+ * @return true on success.
+ */
+bool wlmaker_cgroup_place(
+    wlmaker_cgroup_t *cgroup_ptr,
+    pid_t pid,
+    const wlmaker_cgroup_limits_t *limits_ptr);
+
+/**
+ * Applies the limits that are set in `limits_ptr` to the cgroup of `pid`.
+ *
+ * @param cgroup_ptr
+ * @param pid                 Must have been placed by
+ *                            @ref wlmaker_cgroup_place.
+ * @param limits_ptr
+ *
+ * @return true on success.
+ */
+bool wlmaker_cgroup_set_limits(
+    wlmaker_cgroup_t *cgroup_ptr,
+    pid_t pid,
+    const wlmaker_cgroup_limits_t *limits_ptr);
+
+/**
+ * Removes the cgroup of `pid`, once the process terminated. Fails silently
+ * if descendants of the process are still running: The cgroup is then
+ * removed on @ref wlmaker_cgroup_destroy.
+ *
+ * @param cgroup_ptr
+ * @param pid
+ */
+void wlmaker_cgroup_release(wlmaker_cgroup_t *cgroup_ptr, pid_t pid);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_cgroup_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __CGROUP_H__ */
+/* == End of cgroup.h ====================================================== */
@@ -0,0 +1,582 @@
+/* ========================================================================= */
+/**
+ * @file client_quota.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "client_quota.h"
+
+#include <inttypes.h>
+#include <libbase/libbase.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <wayland-server-core.h>
+#include <wayland-util.h>
+#define WLR_USE_UNSTABLE
+#include <wlr/types/wlr_buffer.h>
+#include <wlr/types/wlr_compositor.h>
+#include <wlr/types/wlr_security_context_v1.h>
+#include <wlr/types/wlr_xdg_shell.h>
+#include <wlr/version.h>
+#undef WLR_USE_UNSTABLE
+
+#include "toolkit/toolkit.h"
+#include "xdg_shell.h"
+
+/* == Declarations ========================================================= */
+
+/** State of the per-client quotas. */
+struct _wlmaker_client_quota_t {
+    /** Limits for clients, indexed by @ref wlmaker_client_quota_resource_t. */
+    const uint64_t            *limits_ptr;
+    /** Limits for clients in a sandbox. */
+    const uint64_t            *sandboxed_limits_ptr;
+    /** Security contexts, to identify sandboxed clients. May be NULL. */
+    struct wlr_security_context_manager_v1 *wlr_security_context_ptr;
+    /** Tracked objects, as @ref wlmaker_client_quota_object_t. */
+    bs_dllist_t               objects;
+
+#if WLR_VERSION_NUM >= (18 << 8)
+    /** Listener for `new_toplevel` of `wlr_xdg_shell`. */
+    struct wl_listener        new_toplevel_listener;
+    /** Listener for `new_popup` of `wlr_xdg_shell`. */
+    struct wl_listener        new_popup_listener;
+#else  // WLR_VERSION_NUM >= (18 << 8)
+    /** Listener for `new_surface` of `wlr_xdg_shell`. */
+    struct wl_listener        new_xdg_surface_listener;
+#endif  // WLR_VERSION_NUM >= (18 << 8)
+    /** Listener for `new_surface` of `wlr_compositor`. */
+    struct wl_listener        new_surface_listener;
+};
+
+/** Resources accounted to one client. Lives until the client is destroyed. */
+typedef struct {
+    /** Listener for the client's `destroy`. Identifies the record. */
+    struct wl_listener        client_destroy_listener;
+    /** Limits applying to this client. */
+    const uint64_t            *limits_ptr;
+    /** Amounts in use, by @ref wlmaker_client_quota_resource_t. */
+    uint64_t                  used[WLMAKER_CLIENT_QUOTA_RESOURCES];
+} wlmaker_client_quota_client_t;
+
+/** A toplevel, popup or surface, accounted until it is destroyed. */
+typedef struct {
+    /** Element of @ref wlmaker_client_quota_t::objects. */
+    bs_dllist_node_t          dlnode;
+    /** Back-link to the quotas. */
+    wlmaker_client_quota_t    *client_quota_ptr;
+    /** The client owning the object. */
+    struct wl_client          *wl_client_ptr;
+    /** What the object is accounted as. */
+    wlmaker_client_quota_resource_t resource;
+    /** Amount currently accounted. */
+    uint64_t                  amount;
+    /** The surface, for @ref WLMAKER_CLIENT_QUOTA_BUFFER_BYTES. */
+    struct wlr_surface        *wlr_surface_ptr;
+    /** Listener for `destroy` of the object. */
+    struct wl_listener        destroy_listener;
+    /** Listener for `commit` of `wlr_surface_ptr`. */
+    struct wl_listener        commit_listener;
+} wlmaker_client_quota_object_t;
+
+static wlmaker_client_quota_client_t *_wlmaker_client_quota_client(
+    wlmaker_client_quota_t *client_quota_ptr,
+    struct wl_client *wl_client_ptr,
+    bool create);
+static void _wlmaker_client_quota_handle_client_destroy(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static wlmaker_client_quota_object_t *_wlmaker_client_quota_track(
+    wlmaker_client_quota_t *client_quota_ptr,
+    struct wl_client *wl_client_ptr,
+    wlmaker_client_quota_resource_t resource,
+    struct wl_signal *destroy_signal_ptr);
+static void _wlmaker_client_quota_object_destroy(
+    wlmaker_client_quota_object_t *object_ptr);
+static void _wlmaker_client_quota_handle_object_destroy(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmaker_client_quota_handle_surface_commit(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+#if WLR_VERSION_NUM >= (18 << 8)
+static void _wlmaker_client_quota_handle_new_toplevel(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmaker_client_quota_handle_new_popup(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+#else  // WLR_VERSION_NUM >= (18 << 8)
+static void _wlmaker_client_quota_handle_new_xdg_surface(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+#endif  // WLR_VERSION_NUM >= (18 << 8)
+static void _wlmaker_client_quota_handle_new_surface(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+
+/* == Data ================================================================= */
+
+/** Limits for regular clients. Generous: Only catches runaway clients. */
+static const uint64_t _wlmaker_client_quota_limits[] = {
+    [WLMAKER_CLIENT_QUOTA_TOPLEVELS] = 512,
+    [WLMAKER_CLIENT_QUOTA_POPUPS] = 1024,
+    [WLMAKER_CLIENT_QUOTA_ICONS] = 512,
+    [WLMAKER_CLIENT_QUOTA_BUFFER_BYTES] = UINT64_C(4) << 30,
+};
+
+/** Limits for clients in a sandbox (`wp_security_context_v1`). */
+static const uint64_t _wlmaker_client_quota_sandboxed_limits[] = {
+    [WLMAKER_CLIENT_QUOTA_TOPLEVELS] = 64,
+    [WLMAKER_CLIENT_QUOTA_POPUPS] = 128,
+    [WLMAKER_CLIENT_QUOTA_ICONS] = 16,
+    [WLMAKER_CLIENT_QUOTA_BUFFER_BYTES] = UINT64_C(1) << 30,
+};
+
+/** Names of the resources, for the error messages. */
+static const char *_wlmaker_client_quota_names[] = {
+    [WLMAKER_CLIENT_QUOTA_TOPLEVELS] = "toplevels",
+    [WLMAKER_CLIENT_QUOTA_POPUPS] = "popups",
+    [WLMAKER_CLIENT_QUOTA_ICONS] = "toplevel icons",
+    [WLMAKER_CLIENT_QUOTA_BUFFER_BYTES] = "buffer bytes",
+};
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmaker_client_quota_t *wlmaker_client_quota_create(
+    wlmaker_server_t *server_ptr)
+{
+    wlmaker_client_quota_t *client_quota_ptr = logged_calloc(
+        1, sizeof(wlmaker_client_quota_t));
+    if (NULL == client_quota_ptr) return NULL;
+    client_quota_ptr->limits_ptr = _wlmaker_client_quota_limits;
+    client_quota_ptr->sandboxed_limits_ptr =
+        _wlmaker_client_quota_sandboxed_limits;
+    client_quota_ptr->wlr_security_context_ptr =
+        server_ptr->wlr_security_context_manager_v1_ptr;
+
+    struct wlr_xdg_shell *wlr_xdg_shell_ptr =
+        server_ptr->xdg_shell_ptr->wlr_xdg_shell_ptr;
+#if WLR_VERSION_NUM >= (18 << 8)
+    wlmtk_util_connect_listener_signal(
+        &wlr_xdg_shell_ptr->events.new_toplevel,
+        &client_quota_ptr->new_toplevel_listener,
+        _wlmaker_client_quota_handle_new_toplevel);
+    wlmtk_util_connect_listener_signal(
+        &wlr_xdg_shell_ptr->events.new_popup,
+        &client_quota_ptr->new_popup_listener,
+        _wlmaker_client_quota_handle_new_popup);
+#else  // WLR_VERSION_NUM >= (18 << 8)
+    wlmtk_util_connect_listener_signal(
+        &wlr_xdg_shell_ptr->events.new_surface,
+        &client_quota_ptr->new_xdg_surface_listener,
+        _wlmaker_client_quota_handle_new_xdg_surface);
+#endif  // WLR_VERSION_NUM >= (18 << 8)
+    wlmtk_util_connect_listener_signal(
+        &wlmbe_backend_compositor(server_ptr->backend_ptr)->events.new_surface,
+        &client_quota_ptr->new_surface_listener,
+        _wlmaker_client_quota_handle_new_surface);
+    return client_quota_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_client_quota_destroy(wlmaker_client_quota_t *client_quota_ptr)
+{
+    wlmtk_util_disconnect_listener(&client_quota_ptr->new_surface_listener);
+#if WLR_VERSION_NUM >= (18 << 8)
+    wlmtk_util_disconnect_listener(&client_quota_ptr->new_popup_listener);
+    wlmtk_util_disconnect_listener(&client_quota_ptr->new_toplevel_listener);
+#else  // WLR_VERSION_NUM >= (18 << 8)
+    wlmtk_util_disconnect_listener(
+        &client_quota_ptr->new_xdg_surface_listener);
+#endif  // WLR_VERSION_NUM >= (18 << 8)
+
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = client_quota_ptr->objects.head_ptr)) {
+        _wlmaker_client_quota_object_destroy(BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_client_quota_object_t, dlnode));
+    }
+    free(client_quota_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmaker_client_quota_acquire(
+    wlmaker_client_quota_t *client_quota_ptr,
+    struct wl_client *wl_client_ptr,
+    wlmaker_client_quota_resource_t resource,
+    uint64_t amount)
+{
+    BS_ASSERT(resource < WLMAKER_CLIENT_QUOTA_RESOURCES);
+    wlmaker_client_quota_client_t *client_ptr = _wlmaker_client_quota_client(
+        client_quota_ptr, wl_client_ptr, true);
+    // Out of memory, or the client is being destroyed: Don't hold it up.
+    if (NULL == client_ptr) return true;
+
+    uint64_t limit = client_ptr->limits_ptr[resource];
+    if (client_ptr->used[resource] + amount <= limit) {
+        client_ptr->used[resource] += amount;
+        return true;
+    }
+
+    pid_t pid;
+    wl_client_get_credentials(wl_client_ptr, &pid, NULL, NULL);
+    bs_log(BS_WARNING, "Client %p (pid %"PRIdMAX") exceeds its limit of "
+           "%"PRIu64" %s. Disconnecting.", wl_client_ptr, (intmax_t)pid,
+           limit, _wlmaker_client_quota_names[resource]);
+    wl_client_post_implementation_error(
+        wl_client_ptr, "Exceeded limit of %"PRIu64" %s",
+        limit, _wlmaker_client_quota_names[resource]);
+    return false;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_client_quota_release(
+    wlmaker_client_quota_t *client_quota_ptr,
+    struct wl_client *wl_client_ptr,
+    wlmaker_client_quota_resource_t resource,
+    uint64_t amount)
+{
+    BS_ASSERT(resource < WLMAKER_CLIENT_QUOTA_RESOURCES);
+    wlmaker_client_quota_client_t *client_ptr = _wlmaker_client_quota_client(
+        client_quota_ptr, wl_client_ptr, false);
+    if (NULL == client_ptr) return;
+    BS_ASSERT(client_ptr->used[resource] >= amount);
+    client_ptr->used[resource] -= amount;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Looks up the record of `wl_client_ptr`: It is identified by the client's
+ * destroy listener, so no index is needed.
+ *
+ * @param client_quota_ptr
+ * @param wl_client_ptr
+ * @param create              Whether to create the record, if not found.
+ *
+ * @return The record, or NULL if not found or on error.
+ */
+wlmaker_client_quota_client_t *_wlmaker_client_quota_client(
+    wlmaker_client_quota_t *client_quota_ptr,
+    struct wl_client *wl_client_ptr,
+    bool create)
+{
+    struct wl_listener *listener_ptr = wl_client_get_destroy_listener(
+        wl_client_ptr, _wlmaker_client_quota_handle_client_destroy);
+    if (NULL != listener_ptr) {
+        return BS_CONTAINER_OF(listener_ptr, wlmaker_client_quota_client_t,
+                               client_destroy_listener);
+    }
+    if (!create) return NULL;
+
+    wlmaker_client_quota_client_t *client_ptr = logged_calloc(
+        1, sizeof(wlmaker_client_quota_client_t));
+    if (NULL == client_ptr) return NULL;
+    client_ptr->limits_ptr = client_quota_ptr->limits_ptr;
+    if (NULL != client_quota_ptr->wlr_security_context_ptr &&
+        NULL != wlr_security_context_manager_v1_lookup_client(
+            client_quota_ptr->wlr_security_context_ptr, wl_client_ptr)) {
+        client_ptr->limits_ptr = client_quota_ptr->sandboxed_limits_ptr;
+    }
+    client_ptr->client_destroy_listener.notify =
+        _wlmaker_client_quota_handle_client_destroy;
+    wl_client_add_destroy_listener(
+        wl_client_ptr, &client_ptr->client_destroy_listener);
+    return client_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles the client's `destroy`: Frees the record. */
+void _wlmaker_client_quota_handle_client_destroy(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmaker_client_quota_client_t *client_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_client_quota_client_t, client_destroy_listener);
+    wlmtk_util_disconnect_listener(&client_ptr->client_destroy_listener);
+    free(client_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Starts tracking an object of `wl_client_ptr`, until `destroy_signal_ptr`
+ * is raised.
+ *
+ * @param client_quota_ptr
+ * @param wl_client_ptr
+ * @param resource
+ * @param destroy_signal_ptr
+ *
+ * @return The tracked object, or NULL on error.
+ */
+wlmaker_client_quota_object_t *_wlmaker_client_quota_track(
+    wlmaker_client_quota_t *client_quota_ptr,
+    struct wl_client *wl_client_ptr,
+    wlmaker_client_quota_resource_t resource,
+    struct wl_signal *destroy_signal_ptr)
+{
+    wlmaker_client_quota_object_t *object_ptr = logged_calloc(
+        1, sizeof(wlmaker_client_quota_object_t));
+    if (NULL == object_ptr) return NULL;
+    object_ptr->client_quota_ptr = client_quota_ptr;
+    object_ptr->wl_client_ptr = wl_client_ptr;
+    object_ptr->resource = resource;
+    wlmtk_util_connect_listener_signal(
+        destroy_signal_ptr,
+        &object_ptr->destroy_listener,
+        _wlmaker_client_quota_handle_object_destroy);
+    bs_dllist_push_back(&client_quota_ptr->objects, &object_ptr->dlnode);
+    return object_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Stops tracking the object, and releases what it had acquired. */
+void _wlmaker_client_quota_object_destroy(
+    wlmaker_client_quota_object_t *object_ptr)
+{
+    wlmaker_client_quota_release(
+        object_ptr->client_quota_ptr,
+        object_ptr->wl_client_ptr,
+        object_ptr->resource,
+        object_ptr->amount);
+    bs_dllist_remove(&object_ptr->client_quota_ptr->objects,
+                     &object_ptr->dlnode);
+    wlmtk_util_disconnect_listener(&object_ptr->commit_listener);
+    wlmtk_util_disconnect_listener(&object_ptr->destroy_listener);
+    free(object_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles `destroy` of the tracked object. */
+void _wlmaker_client_quota_handle_object_destroy(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    _wlmaker_client_quota_object_destroy(BS_CONTAINER_OF(
+        listener_ptr, wlmaker_client_quota_object_t, destroy_listener));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles `commit` of a surface: Accounts the size of its buffer. */
+void _wlmaker_client_quota_handle_surface_commit(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmaker_client_quota_object_t *object_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_client_quota_object_t, commit_listener);
+    struct wlr_surface *wlr_surface_ptr = object_ptr->wlr_surface_ptr;
+
+    uint64_t bytes = 0;
+    if (NULL != wlr_surface_ptr->buffer) {
+        // Assumes 4 bytes per pixel. Good enough for a limit.
+        bytes = 4 * (uint64_t)wlr_surface_ptr->buffer->base.width *
+            (uint64_t)wlr_surface_ptr->buffer->base.height;
+    }
+    if (bytes > object_ptr->amount) {
+        if (wlmaker_client_quota_acquire(
+                object_ptr->client_quota_ptr,
+                object_ptr->wl_client_ptr,
+                object_ptr->resource,
+                bytes - object_ptr->amount)) {
+            object_ptr->amount = bytes;
+        }
+    } else if (bytes < object_ptr->amount) {
+        wlmaker_client_quota_release(
+            object_ptr->client_quota_ptr,
+            object_ptr->wl_client_ptr,
+            object_ptr->resource,
+            object_ptr->amount - bytes);
+        object_ptr->amount = bytes;
+    }
+}
+
+#if WLR_VERSION_NUM >= (18 << 8)
+/* ------------------------------------------------------------------------- */
+/** Handles `new_toplevel` of `wlr_xdg_shell`: Accounts the toplevel. */
+void _wlmaker_client_quota_handle_new_toplevel(
+    struct wl_listener *listener_ptr,
+    void *data_ptr)
+{
+    wlmaker_client_quota_t *client_quota_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_client_quota_t, new_toplevel_listener);
+    struct wlr_xdg_toplevel *wlr_xdg_toplevel_ptr = data_ptr;
+    struct wl_client *wl_client_ptr = wl_resource_get_client(
+        wlr_xdg_toplevel_ptr->resource);
+
+    if (!wlmaker_client_quota_acquire(
+            client_quota_ptr, wl_client_ptr,
+            WLMAKER_CLIENT_QUOTA_TOPLEVELS, 1)) return;
+    wlmaker_client_quota_object_t *object_ptr = _wlmaker_client_quota_track(
+        client_quota_ptr, wl_client_ptr, WLMAKER_CLIENT_QUOTA_TOPLEVELS,
+        &wlr_xdg_toplevel_ptr->events.destroy);
+    if (NULL == object_ptr) {
+        wlmaker_client_quota_release(
+            client_quota_ptr, wl_client_ptr,
+            WLMAKER_CLIENT_QUOTA_TOPLEVELS, 1);
+        return;
+    }
+    object_ptr->amount = 1;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles `new_popup` of `wlr_xdg_shell`: Accounts the popup. */
+void _wlmaker_client_quota_handle_new_popup(
+    struct wl_listener *listener_ptr,
+    void *data_ptr)
+{
+    wlmaker_client_quota_t *client_quota_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_client_quota_t, new_popup_listener);
+    struct wlr_xdg_popup *wlr_xdg_popup_ptr = data_ptr;
+    struct wl_client *wl_client_ptr = wl_resource_get_client(
+        wlr_xdg_popup_ptr->resource);
+
+    if (!wlmaker_client_quota_acquire(
+            client_quota_ptr, wl_client_ptr,
+            WLMAKER_CLIENT_QUOTA_POPUPS, 1)) return;
+    wlmaker_client_quota_object_t *object_ptr = _wlmaker_client_quota_track(
+        client_quota_ptr, wl_client_ptr, WLMAKER_CLIENT_QUOTA_POPUPS,
+        &wlr_xdg_popup_ptr->events.destroy);
+    if (NULL == object_ptr) {
+        wlmaker_client_quota_release(
+            client_quota_ptr, wl_client_ptr,
+            WLMAKER_CLIENT_QUOTA_POPUPS, 1);
+        return;
+    }
+    object_ptr->amount = 1;
+}
+
+#else  // WLR_VERSION_NUM >= (18 << 8)
+
+/* ------------------------------------------------------------------------- */
+/** Handles `new_surface` of `wlr_xdg_shell`: Accounts toplevels & popups. */
+void _wlmaker_client_quota_handle_new_xdg_surface(
+    struct wl_listener *listener_ptr,
+    void *data_ptr)
+{
+    wlmaker_client_quota_t *client_quota_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_client_quota_t, new_xdg_surface_listener);
+    struct wlr_xdg_surface *wlr_xdg_surface_ptr = data_ptr;
+    struct wl_client *wl_client_ptr = wl_resource_get_client(
+        wlr_xdg_surface_ptr->resource);
+
+    wlmaker_client_quota_resource_t resource;
+    switch (wlr_xdg_surface_ptr->role) {
+    case WLR_XDG_SURFACE_ROLE_TOPLEVEL:
+        resource = WLMAKER_CLIENT_QUOTA_TOPLEVELS;
+        break;
+    case WLR_XDG_SURFACE_ROLE_POPUP:
+        resource = WLMAKER_CLIENT_QUOTA_POPUPS;
+        break;
+    default:
+        return;
+    }
+
+    if (!wlmaker_client_quota_acquire(
+            client_quota_ptr, wl_client_ptr, resource, 1)) return;
+    wlmaker_client_quota_object_t *object_ptr = _wlmaker_client_quota_track(
+        client_quota_ptr, wl_client_ptr, resource,
+        &wlr_xdg_surface_ptr->events.destroy);
+    if (NULL == object_ptr) {
+        wlmaker_client_quota_release(
+            client_quota_ptr, wl_client_ptr, resource, 1);
+        return;
+    }
+    object_ptr->amount = 1;
+}
+#endif  // WLR_VERSION_NUM >= (18 << 8)
+
+/* ------------------------------------------------------------------------- */
+/** Handles `new_surface` of `wlr_compositor`: Tracks its buffer bytes. */
+void _wlmaker_client_quota_handle_new_surface(
+    struct wl_listener *listener_ptr,
+    void *data_ptr)
+{
+    wlmaker_client_quota_t *client_quota_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_client_quota_t, new_surface_listener);
+    struct wlr_surface *wlr_surface_ptr = data_ptr;
+
+    wlmaker_client_quota_object_t *object_ptr = _wlmaker_client_quota_track(
+        client_quota_ptr,
+        wl_resource_get_client(wlr_surface_ptr->resource),
+        WLMAKER_CLIENT_QUOTA_BUFFER_BYTES,
+        &wlr_surface_ptr->events.destroy);
+    if (NULL == object_ptr) return;
+    object_ptr->wlr_surface_ptr = wlr_surface_ptr;
+    wlmtk_util_connect_listener_signal(
+        &wlr_surface_ptr->events.commit,
+        &object_ptr->commit_listener,
+        _wlmaker_client_quota_handle_surface_commit);
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_acquire_release(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_client_quota_test_cases[] = {
+    { 1, "acquire_release", test_acquire_release },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Tests accounting against the limit, and the record's lifetime. */
+void test_acquire_release(bs_test_t *test_ptr)
+{
+    static const uint64_t limits[WLMAKER_CLIENT_QUOTA_RESOURCES] = {
+        [WLMAKER_CLIENT_QUOTA_TOPLEVELS] = 2
+    };
+    wlmaker_client_quota_t client_quota = { .limits_ptr = limits };
+    struct wl_display *wl_display_ptr = wl_display_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_display_ptr);
+    int fds[2];
+    BS_TEST_VERIFY_TRUE_OR_RETURN(
+        test_ptr, 0 == socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    struct wl_client *wl_client_ptr = wl_client_create(wl_display_ptr, fds[0]);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_client_ptr);
+
+    // No record, until something is acquired.
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, _wlmaker_client_quota_client(
+                          &client_quota, wl_client_ptr, false));
+    wlmaker_client_quota_t *q = &client_quota;
+    wlmaker_client_quota_resource_t r = WLMAKER_CLIENT_QUOTA_TOPLEVELS;
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmaker_client_quota_acquire(q, wl_client_ptr, r, 2));
+    wlmaker_client_quota_client_t *client_ptr = _wlmaker_client_quota_client(
+        q, wl_client_ptr, false);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, client_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, client_ptr->used[r]);
+
+    // Exceeding: Not accounted.
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlmaker_client_quota_acquire(q, wl_client_ptr, r, 1));
+    BS_TEST_VERIFY_EQ(test_ptr, 2, client_ptr->used[r]);
+
+    // Released: Permits acquiring again.
+    wlmaker_client_quota_release(q, wl_client_ptr, r, 1);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, client_ptr->used[r]);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmaker_client_quota_acquire(q, wl_client_ptr, r, 1));
+
+    // Destroying the client removes the record.
+    wl_client_destroy(wl_client_ptr);
+    close(fds[1]);
+    wl_display_destroy(wl_display_ptr);
+}
+
+/* == End of client_quota.c ================================================ */
@@ -0,0 +1,115 @@
+/* ========================================================================= */
+/**
+ * @file client_quota.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __CLIENT_QUOTA_H__
+#define __CLIENT_QUOTA_H__
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Forward declaration: Per-client resource quotas. */
+typedef struct _wlmaker_client_quota_t wlmaker_client_quota_t;
+
+struct wl_client;
+
+#include "server.h"  // IWYU pragma: keep
+
+/** Resources accounted per client. */
+typedef enum {
+    /** XDG toplevels, each backing a toolkit window with decorations. */
+    WLMAKER_CLIENT_QUOTA_TOPLEVELS,
+    /** XDG popups. */
+    WLMAKER_CLIENT_QUOTA_POPUPS,
+    /** Toplevel icon surfaces, see @ref wlmaker_icon_manager_t. */
+    WLMAKER_CLIENT_QUOTA_ICONS,
+    /** Bytes of the buffers currently attached to the client's surfaces. */
+    WLMAKER_CLIENT_QUOTA_BUFFER_BYTES,
+    /** Number of accounted resources. Not a resource. */
+    WLMAKER_CLIENT_QUOTA_RESOURCES
+} wlmaker_client_quota_resource_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Creates the per-client quotas. Accounts XDG toplevels and popups, and the
+ * buffer bytes of all surfaces, by listening to the XDG shell and the
+ * compositor. Toplevel icons are accounted by the icon manager.
+ *
+ * Clients in a sandbox, as reported through `wp_security_context_v1`, get
+ * stricter limits. A client exceeding a limit is disconnected with a
+ * protocol (implementation) error.
+ *
+ * @param server_ptr
+ *
+ * @return A pointer to the quotas, or NULL on error.
+ */
+wlmaker_client_quota_t *wlmaker_client_quota_create(
+    wlmaker_server_t *server_ptr);
+
+/**
+ * Destroys the quotas.
+ *
+ * @param client_quota_ptr
+ */
+void wlmaker_client_quota_destroy(wlmaker_client_quota_t *client_quota_ptr);
+
+/**
+ * Accounts `amount` of `resource` to `wl_client_ptr`.
+ *
+ * @param client_quota_ptr
+ * @param wl_client_ptr
+ * @param resource
+ * @param amount
+ *
+ * @return true if within the client's limit. Otherwise, nothing is
+ *     accounted, and an implementation error was posted to the client.
+ */
+bool wlmaker_client_quota_acquire(
+    wlmaker_client_quota_t *client_quota_ptr,
+    struct wl_client *wl_client_ptr,
+    wlmaker_client_quota_resource_t resource,
+    uint64_t amount);
+
+/**
+ * Releases `amount` of `resource` from what `wl_client_ptr` has acquired.
+ * A no-op once the client is being destroyed.
+ *
+ * @param client_quota_ptr
+ * @param wl_client_ptr
+ * @param resource
+ * @param amount
+ */
+void wlmaker_client_quota_release(
+    wlmaker_client_quota_t *client_quota_ptr,
+    struct wl_client *wl_client_ptr,
+    wlmaker_client_quota_resource_t resource,
+    uint64_t amount);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_client_quota_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __CLIENT_QUOTA_H__ */
+/* == End of client_quota.h ================================================ */
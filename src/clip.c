@@ -28,6 +28,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <wayland-server-core.h>
 #include <wayland-util.h>
 #define WLR_USE_UNSTABLE
@@ -42,6 +43,21 @@
 
 /* == Declarations ========================================================= */
 
+/** An overlay of the clip, drawn for one workspace. */
+typedef struct {
+    /** Node within @ref _wlmaker_clip_t::overlay_cache. */
+    bs_dllist_node_t          dlnode;
+    /** Name of the workspace. */
+    char                      *name_ptr;
+    /** Index of the workspace. */
+    int                       index;
+    /** The overlay buffer. */
+    struct wlr_buffer         *wlr_buffer_ptr;
+} wlmaker_clip_overlay_t;
+
+/** Number of workspace overlays to keep. */
+#define WLMAKER_CLIP_OVERLAY_CACHE_SIZE 16
+
 /** Clip handle. */
 struct _wlmaker_clip_t {
     /** The clip happens to be derived from a tile. */
@@ -61,9 +77,16 @@ struct _wlmaker_clip_t {
     struct wlr_buffer         *next_pressed_tile_buffer_ptr;
     /** The tile's texture buffer with the 'Previous' buttons pressed. */
     struct wlr_buffer         *prev_pressed_tile_buffer_ptr;
+    /** The tile's texture buffer currently set as background. */
+    struct wlr_buffer         *current_tile_buffer_ptr;
 
     /** Overlay buffer element: Contains the workspace's title and number. */
     wlmtk_buffer_t            overlay_buffer;
+    /**
+     * Overlays drawn for workspaces, most recently used first. See
+     * @ref wlmaker_clip_overlay_t::dlnode.
+     */
+    bs_dllist_t               overlay_cache;
     /** Clip image. */
     wlmtk_image_t             *image_ptr;
 
@@ -81,7 +104,7 @@ struct _wlmaker_clip_t {
 
     /** Listener for @ref wlmtk_root_events_t::workspace_changed. */
     struct wl_listener        workspace_changed_listener;
-    /** Listener for wlr_output_layout::events.change. */
+    /** Listener for layout epochs, see @ref wlmtk_layout_epoch_connect. */
     struct wl_listener        output_layout_change_listener;
     /** Listener for @ref wlmtk_element_events_t::pointer_leave. */
     struct wl_listener        pointer_leave_listener;
@@ -102,6 +125,11 @@ static bool _wlmaker_clip_pointer_motion(
 
 static void _wlmaker_clip_update_buttons(wlmaker_clip_t *clip_ptr);
 static void _wlmaker_clip_update_overlay(wlmaker_clip_t *clip_ptr);
+static struct wlr_buffer *_wlmaker_clip_create_overlay(
+    wlmaker_clip_t *clip_ptr,
+    const char *name_ptr,
+    int index);
+static void _wlmaker_clip_overlay_destroy(wlmaker_clip_overlay_t *overlay_ptr);
 static struct wlr_buffer *_wlmaker_clip_create_tile(
     const wlmtk_tile_style_t *style_ptr,
     bool prev_pressed,
@@ -232,6 +260,7 @@ wlmaker_clip_t *wlmaker_clip_create(
         wlmtk_tile_element(&clip_ptr->super_tile), true);
     wlmtk_tile_set_background_buffer(
         &clip_ptr->super_tile, clip_ptr->tile_buffer_ptr);
+    clip_ptr->current_tile_buffer_ptr = clip_ptr->tile_buffer_ptr;
     wlmtk_dock_add_tile(clip_ptr->wlmtk_dock_ptr, &clip_ptr->super_tile);
 
     if (!wlmtk_buffer_init(&clip_ptr->overlay_buffer)) {
@@ -240,6 +269,8 @@ wlmaker_clip_t *wlmaker_clip_create(
     }
     wlmtk_element_set_visible(
         wlmtk_buffer_element(&clip_ptr->overlay_buffer), true);
+    wlmtk_element_set_input_transparent(
+        wlmtk_buffer_element(&clip_ptr->overlay_buffer), true);
 
     struct wlr_output *wlr_output_ptr = wlmbe_output_description_first_fnmatch(
         &clip_ptr->output_description, server_ptr->wlr_output_layout_ptr);
@@ -279,6 +310,9 @@ wlmaker_clip_t *wlmaker_clip_create(
     }
     wlmtk_element_set_visible(
         wlmtk_image_element(clip_ptr->image_ptr), true);
+    // Decoration only: The tile's background takes the pointer input.
+    wlmtk_element_set_input_transparent(
+        wlmtk_image_element(clip_ptr->image_ptr), true);
     wlmtk_tile_set_content(
         &clip_ptr->super_tile,
         wlmtk_image_element(clip_ptr->image_ptr));
@@ -293,14 +327,13 @@ wlmaker_clip_t *wlmaker_clip_create(
         &clip_ptr->workspace_changed_listener,
         _wlmaker_clip_handle_workspace_changed);
 
-    // TODO(kaeser@gubbe.ch): This is a very hacky way of updating the output
-    // before the layer's handler removes all associated panels. Should be
-    // a native method of wlmtk_dock_t or wlmtk_panel_t.
-    clip_ptr->output_layout_change_listener.notify =
-        _wlmaker_clip_handle_output_layout_change;
-    wl_list_insert(
-        server_ptr->wlr_output_layout_ptr->events.change.listener_list.next,
-        &clip_ptr->output_layout_change_listener.link);
+    // Moves the panel to its new output before the layer's handler removes
+    // all panels associated with a removed output.
+    wlmtk_layout_epoch_connect(
+        server_ptr->wlr_output_layout_ptr,
+        WLMTK_LAYOUT_EPOCH_STAGE_PANELS,
+        &clip_ptr->output_layout_change_listener,
+        _wlmaker_clip_handle_output_layout_change);
 
     server_ptr->clip_dock_ptr = clip_ptr->wlmtk_dock_ptr;
     bs_log(BS_INFO, "Created clip %p", clip_ptr);
@@ -327,6 +360,12 @@ void wlmaker_clip_destroy(wlmaker_clip_t *clip_ptr)
     wlmtk_util_disconnect_listener(&clip_ptr->pointer_leave_listener);
     wlmtk_tile_fini(&clip_ptr->super_tile);
     wlmtk_buffer_fini(&clip_ptr->overlay_buffer);
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                        &clip_ptr->overlay_cache))) {
+        _wlmaker_clip_overlay_destroy(BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_clip_overlay_t, dlnode));
+    }
 
     if (NULL != clip_ptr->image_ptr) {
         wlmtk_image_destroy(clip_ptr->image_ptr);
@@ -368,7 +407,8 @@ void wlmaker_clip_destroy(wlmaker_clip_t *clip_ptr)
  * Implements @ref wlmtk_element_vmt_t::pointer_axis.
  *
  * Moves to the next or previous workspace, depending on the axis (scroll-
- * wheel) direction.
+ * wheel) direction. Once per event with whole steps, see
+ * @ref wlmtk_pointer_axis_steps.
  *
  * @param element_ptr
  * @param wlr_pointer_axis_event_ptr
@@ -383,10 +423,11 @@ bool _wlmaker_clip_pointer_axis(
         element_ptr, wlmaker_clip_t,
         super_tile.super_container.super_element);
 
-    if (0 > wlr_pointer_axis_event_ptr->delta) {
+    int steps = wlmtk_pointer_axis_steps(wlr_pointer_axis_event_ptr);
+    if (0 > steps) {
         // Scroll wheel "up" -> next.
         wlmtk_root_switch_to_next_workspace(clip_ptr->server_ptr->root_ptr);
-    } else if (0 < wlr_pointer_axis_event_ptr->delta) {
+    } else if (0 < steps) {
         // Scroll wheel "down" -> next.
         wlmtk_root_switch_to_previous_workspace(clip_ptr->server_ptr->root_ptr);
     }
@@ -472,6 +513,8 @@ bool _wlmaker_clip_pointer_motion(
         element_ptr, wlmaker_clip_t,
         super_tile.super_container.super_element);
 
+    bool was_inside_prev_button = clip_ptr->pointer_inside_prev_button;
+    bool was_inside_next_button = clip_ptr->pointer_inside_next_button;
     clip_ptr->pointer_inside_prev_button = false;
     clip_ptr->pointer_inside_next_button = false;
 
@@ -491,6 +534,23 @@ bool _wlmaker_clip_pointer_motion(
         clip_ptr->pointer_inside_prev_button = true;
     }
 
+    // Hovering a button hints at an upcoming switch: Pre-warm the target.
+    wlmtk_root_t *root_ptr = clip_ptr->server_ptr->root_ptr;
+    struct wl_event_loop *wl_event_loop_ptr = wl_display_get_event_loop(
+        clip_ptr->server_ptr->wl_display_ptr);
+    if (clip_ptr->pointer_inside_next_button && !was_inside_next_button) {
+        wlmtk_root_prewarm_workspace(
+            root_ptr,
+            wlmtk_root_get_next_workspace(root_ptr),
+            wl_event_loop_ptr);
+    } else if (clip_ptr->pointer_inside_prev_button &&
+               !was_inside_prev_button) {
+        wlmtk_root_prewarm_workspace(
+            root_ptr,
+            wlmtk_root_get_previous_workspace(root_ptr),
+            wl_event_loop_ptr);
+    }
+
     _wlmaker_clip_update_buttons(clip_ptr);
     return clip_ptr->orig_super_element_vmt.pointer_motion(
         element_ptr, motion_event_ptr);
@@ -508,54 +568,124 @@ static void _wlmaker_clip_update_buttons(wlmaker_clip_t *clip_ptr)
                clip_ptr->prev_button_pressed) {
         wlr_buffer_ptr = clip_ptr->prev_pressed_tile_buffer_ptr;
     }
+    // Called on each motion: Only switch if the state changed.
+    if (wlr_buffer_ptr == clip_ptr->current_tile_buffer_ptr) return;
     wlmtk_tile_set_background_buffer(&clip_ptr->super_tile, wlr_buffer_ptr);
+    clip_ptr->current_tile_buffer_ptr = wlr_buffer_ptr;
 }
 
 /* ------------------------------------------------------------------------- */
-/** Updates the overlay buffer's content with workspace name and index. */
+/**
+ * Updates the overlay buffer's content with workspace name and index.
+ *
+ * Overlays are kept per workspace name and index, so that switching back to
+ * a workspace does not draw again. The least recently used overlay is
+ * evicted once there are @ref WLMAKER_CLIP_OVERLAY_CACHE_SIZE of them.
+ */
 void _wlmaker_clip_update_overlay(wlmaker_clip_t *clip_ptr)
 {
-    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
-        clip_ptr->super_tile.style.size, clip_ptr->super_tile.style.size);
-    if (NULL == wlr_buffer_ptr) return;
-
     int index = 0;
     const char *name_ptr = NULL;
     wlmtk_workspace_get_details(
         wlmtk_root_get_current_workspace(clip_ptr->server_ptr->root_ptr),
         &name_ptr, &index);
+    if (NULL == name_ptr) name_ptr = "";
+
+    for (bs_dllist_node_t *dlnode_ptr = clip_ptr->overlay_cache.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_clip_overlay_t *overlay_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_clip_overlay_t, dlnode);
+        if (overlay_ptr->index == index &&
+            0 == strcmp(overlay_ptr->name_ptr, name_ptr)) {
+            bs_dllist_remove(&clip_ptr->overlay_cache, dlnode_ptr);
+            bs_dllist_push_front(&clip_ptr->overlay_cache, dlnode_ptr);
+            wlmtk_buffer_set(&clip_ptr->overlay_buffer,
+                             overlay_ptr->wlr_buffer_ptr);
+            return;
+        }
+    }
+
+    wlmaker_clip_overlay_t *overlay_ptr = logged_calloc(
+        1, sizeof(wlmaker_clip_overlay_t));
+    if (NULL == overlay_ptr) return;
+    overlay_ptr->index = index;
+    overlay_ptr->name_ptr = logged_strdup(name_ptr);
+    overlay_ptr->wlr_buffer_ptr = _wlmaker_clip_create_overlay(
+        clip_ptr, name_ptr, index);
+    if (NULL == overlay_ptr->name_ptr || NULL == overlay_ptr->wlr_buffer_ptr) {
+        _wlmaker_clip_overlay_destroy(overlay_ptr);
+        return;
+    }
+    wlmtk_buffer_set(&clip_ptr->overlay_buffer, overlay_ptr->wlr_buffer_ptr);
+
+    if (WLMAKER_CLIP_OVERLAY_CACHE_SIZE <=
+        bs_dllist_size(&clip_ptr->overlay_cache)) {
+        bs_dllist_node_t *dlnode_ptr = clip_ptr->overlay_cache.tail_ptr;
+        bs_dllist_remove(&clip_ptr->overlay_cache, dlnode_ptr);
+        _wlmaker_clip_overlay_destroy(BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_clip_overlay_t, dlnode));
+    }
+    bs_dllist_push_front(&clip_ptr->overlay_cache, &overlay_ptr->dlnode);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys a cached overlay. It must not be in the cache. */
+void _wlmaker_clip_overlay_destroy(wlmaker_clip_overlay_t *overlay_ptr)
+{
+    if (NULL != overlay_ptr->wlr_buffer_ptr) {
+        wlr_buffer_drop(overlay_ptr->wlr_buffer_ptr);
+    }
+    if (NULL != overlay_ptr->name_ptr) free(overlay_ptr->name_ptr);
+    free(overlay_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Draws the overlay with the workspace's name and index.
+ *
+ * @param clip_ptr
+ * @param name_ptr
+ * @param index
+ *
+ * @return A wlr buffer, or NULL on error.
+ */
+struct wlr_buffer *_wlmaker_clip_create_overlay(
+    wlmaker_clip_t *clip_ptr,
+    const char *name_ptr,
+    int index)
+{
+    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
+        clip_ptr->super_tile.style.size, clip_ptr->super_tile.style.size);
+    if (NULL == wlr_buffer_ptr) return NULL;
+    wlmtk_gfxbuf_set_memstat_subsystem(wlr_buffer_ptr, WLMTK_MEMSTAT_TILES);
 
     cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
     if (NULL == cairo_ptr) {
         wlr_buffer_drop(wlr_buffer_ptr);
-        return;
+        return NULL;
     }
 
-    cairo_select_font_face(
-        cairo_ptr,
-        clip_ptr->style.font.face,
-        CAIRO_FONT_SLANT_NORMAL,
-        wlmtk_style_font_weight_cairo_from_wlmtk(clip_ptr->style.font.weight));
-    cairo_set_font_size(cairo_ptr, clip_ptr->style.font.size);
-    cairo_set_source_argb8888(cairo_ptr, clip_ptr->style.text_color);
-    cairo_move_to(
+    wlmaker_primitives_draw_text(
         cairo_ptr,
         clip_ptr->style.font.size * 4 / 12,
-        clip_ptr->style.font.size * 2 / 12 + clip_ptr->style.font.size);
-    cairo_show_text(cairo_ptr, name_ptr);
+        clip_ptr->style.font.size * 2 / 12 + clip_ptr->style.font.size,
+        &clip_ptr->style.font,
+        clip_ptr->style.text_color,
+        name_ptr);
 
-    cairo_move_to(
-        cairo_ptr,
-        clip_ptr->super_tile.style.size - clip_ptr->style.font.size * 14 / 12,
-        clip_ptr->super_tile.style.size - clip_ptr->style.font.size * 8 / 12);
     char buf[10];
     snprintf(buf, sizeof(buf), "%d", index);
-    cairo_show_text(cairo_ptr, buf);
+    wlmaker_primitives_draw_text(
+        cairo_ptr,
+        clip_ptr->super_tile.style.size - clip_ptr->style.font.size * 14 / 12,
+        clip_ptr->super_tile.style.size - clip_ptr->style.font.size * 8 / 12,
+        &clip_ptr->style.font,
+        clip_ptr->style.text_color,
+        buf);
 
     cairo_destroy(cairo_ptr);
-
-    wlmtk_buffer_set(&clip_ptr->overlay_buffer, wlr_buffer_ptr);
-    wlr_buffer_drop(wlr_buffer_ptr);
+    return wlr_buffer_ptr;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -577,19 +707,23 @@ struct wlr_buffer *_wlmaker_clip_create_tile(
     struct wlr_buffer* wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
         style_ptr->size, style_ptr->size);
     if (NULL == wlr_buffer_ptr) return NULL;
+    wlmtk_gfxbuf_set_memstat_subsystem(wlr_buffer_ptr, WLMTK_MEMSTAT_TILES);
 
     double tsize = style_ptr->size;
     double bsize = 22.0 / 64.0 * style_ptr->size;
     double margin = style_ptr->bezel_width;
 
+    if (!wlmaker_primitives_gfxbuf_fill(
+            bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr), &style_ptr->fill)) {
+        wlr_buffer_drop(wlr_buffer_ptr);
+        return NULL;
+    }
     cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
     if (NULL == cairo_ptr) {
         wlr_buffer_drop(wlr_buffer_ptr);
         return NULL;
     }
 
-    wlmaker_primitives_cairo_fill(cairo_ptr, &style_ptr->fill);
-
     // Northern + Western sides. Drawn clock-wise.
     wlmaker_primitives_set_bezel_color(cairo_ptr, true);
     cairo_move_to(cairo_ptr, 0, 0);
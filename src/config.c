@@ -36,6 +36,7 @@
 #include "default_configuration.h"
 #include "default_state.h"
 #include "../etc/style.h"  // IWYU pragma: keep
+#include "plist_cache.h"
 
 /* == Declarations ========================================================= */
 
@@ -237,6 +238,8 @@ static const bspl_desc_t _wlmaker_config_menu_style_desc[] = {
     BSPL_DESC_DICT(
         "Border", true, wlmtk_menu_style_t, border, border,
         _wlmaker_config_margin_style_desc),
+    BSPL_DESC_UINT64(
+        "MaxItems", false, wlmtk_menu_style_t, max_items, max_items, 0),
     BSPL_DESC_SENTINEL()
 };
 
@@ -333,8 +336,7 @@ bspl_object_t *wlmaker_plist_load(
     if (NULL != fname_ptr) {
         bs_log(BS_INFO, "Loading %s plist from file \"%s\"",
                name_ptr, fname_ptr);
-        bspl_object_t *object_ptr = bspl_create_object_from_plist_file(
-            fname_ptr);
+        bspl_object_t *object_ptr = wlmaker_plist_cache_load(fname_ptr);
         if (NULL == object_ptr) {
             bs_log(BS_ERROR,
                    "Failed bspl_create_object_from_plist(%s) for %s",
@@ -359,7 +361,7 @@ bspl_object_t *wlmaker_plist_load(
             // fail here.
             bs_log(BS_INFO, "Loading %s plist from file \"%s\"",
                    name_ptr, path_ptr);
-            return bspl_create_object_from_plist_file(path_ptr);
+            return wlmaker_plist_cache_load(path_ptr);
         }
     }
 
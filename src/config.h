@@ -98,6 +98,9 @@ extern const float config_output_scale;
  * `fname_ptr`, (2) any of the files listed in `fname_defaults`, or (3)
  * an in-memory buffer, as a compiled-in fallback option.
  *
+ * Files are loaded through @ref wlmaker_plist_cache_load, to skip parsing
+ * when unchanged since the last load.
+ *
  * @param name_ptr            Name to use when logging about the plist.
  * @param fname_ptr           Explicit filename to use for loading the file,
  *                            eg. from the commandline. Or NULL.
@@ -30,6 +30,7 @@
 #include <wlr/types/wlr_cursor.h>
 #include <wlr/types/wlr_output.h>
 #include <wlr/types/wlr_output_layout.h>
+#include <wlr/util/box.h>
 #include <wlr/util/edges.h>
 #undef WLR_USE_UNSTABLE
 
@@ -39,6 +40,14 @@
 
 /* == Declarations ========================================================= */
 
+/** A region that triggers a hot corner. */
+typedef struct {
+    /** The region, in layout coordinates. */
+    struct wlr_box            box;
+    /** The corner, as a combination of `enum wlr_edges`. */
+    unsigned                  position;
+} wlmaker_corner_region_t;
+
 /**
  * State of the hot-corner handler.
  *
@@ -65,6 +74,19 @@ struct _wlmaker_corner_t {
 
     /** Current extents of the output, cached for convience. */
     struct wlr_box            extents;
+    /**
+     * Trigger regions, computed from `extents` on each layout change. All
+     * regions are on the bounding rectangle's edges, so a pointer that is
+     * not on both a vertical and a horizontal edge is quickly dismissed.
+     */
+    wlmaker_corner_region_t   regions[4];
+    /** Number of valid elements in `regions`. 0 for empty extents. */
+    size_t                    regions_count;
+    /**
+     * Whether any corner has an action configured. If not, the cursor's
+     * position is not tracked at all.
+     */
+    bool                      armed;
 
     /** Pointer X coordinate, rounded to pixel position. */
     int                       pointer_x;
@@ -112,6 +134,9 @@ static void _wlmaker_corner_update_layout(
     struct wlr_box *extents_ptr);
 static void _wlmaker_corner_evaluate(
     wlmaker_corner_t *corner_ptr);
+static void _wlmaker_corner_track_position(
+    wlmaker_corner_t *corner_ptr,
+    bool track);
 
 static int _wlmaker_corner_handle_timer(void *data_ptr);
 
@@ -201,20 +226,27 @@ wlmaker_corner_t *wlmaker_corner_create(
         return NULL;
     }
 
+    corner_ptr->armed = (
+        WLMAKER_ACTION_NONE != corner_ptr->top_left_enter_action ||
+        WLMAKER_ACTION_NONE != corner_ptr->top_left_leave_action ||
+        WLMAKER_ACTION_NONE != corner_ptr->top_right_enter_action ||
+        WLMAKER_ACTION_NONE != corner_ptr->top_right_leave_action ||
+        WLMAKER_ACTION_NONE != corner_ptr->bottom_left_enter_action ||
+        WLMAKER_ACTION_NONE != corner_ptr->bottom_left_leave_action ||
+        WLMAKER_ACTION_NONE != corner_ptr->bottom_right_enter_action ||
+        WLMAKER_ACTION_NONE != corner_ptr->bottom_right_leave_action);
+
     struct wlr_box extents;
     wlr_output_layout_get_box(wlr_output_layout_ptr, NULL, &extents);
     corner_ptr->pointer_x = cursor_ptr->wlr_cursor_ptr->x;
     corner_ptr->pointer_y = cursor_ptr->wlr_cursor_ptr->y;
     _wlmaker_corner_update_layout(corner_ptr, &extents);
 
-    wlmtk_util_connect_listener_signal(
-        &wlr_output_layout_ptr->events.change,
+    wlmtk_layout_epoch_connect(
+        wlr_output_layout_ptr,
+        WLMTK_LAYOUT_EPOCH_STAGE_OUTPUTS,
         &corner_ptr->output_layout_changed_listener,
         _wlmaker_corner_handle_output_layout_changed);
-    wlmtk_util_connect_listener_signal(
-        &cursor_ptr->position_updated,
-        &corner_ptr->cursor_position_updated_listener,
-        _wlmaker_corner_handle_position_updated);
 
     return corner_ptr;
 }
@@ -235,6 +267,16 @@ void wlmaker_corner_destroy(wlmaker_corner_t *corner_ptr)
     free(corner_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+bool wlmaker_corner_decode_config(bspl_dict_t *hot_corner_config_dict_ptr)
+{
+    wlmaker_corner_t corner = {};
+    bool rv = bspl_decode_dict(
+        hot_corner_config_dict_ptr, _wlmaker_corner_config_desc, &corner);
+    bspl_decoded_destroy(_wlmaker_corner_config_desc, &corner);
+    return rv;
+}
+
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -298,49 +340,100 @@ void _wlmaker_corner_occupy(
 }
 
 /* ------------------------------------------------------------------------- */
-/** Updates the output extents. Triggers a re-evaluation. */
+/**
+ * Updates the output extents and re-computes the trigger regions. Tracks
+ * the cursor position only while there are regions, and the corner is
+ * armed. Triggers a re-evaluation.
+ */
 void _wlmaker_corner_update_layout(
     wlmaker_corner_t *corner_ptr,
     struct wlr_box *extents_ptr)
 {
     corner_ptr->extents = *extents_ptr;
+    corner_ptr->regions_count = 0;
+
+    struct wlr_box *e_ptr = &corner_ptr->extents;
+    if (0 < e_ptr->width && 0 < e_ptr->height) {
+        int right = e_ptr->x + e_ptr->width - 1;
+        int bottom = e_ptr->y + e_ptr->height - 1;
+        const wlmaker_corner_region_t regions[4] = {
+            { { e_ptr->x, e_ptr->y, 1, 1 }, WLR_EDGE_TOP | WLR_EDGE_LEFT },
+            { { right, e_ptr->y, 1, 1 }, WLR_EDGE_TOP | WLR_EDGE_RIGHT },
+            { { e_ptr->x, bottom, 1, 1 }, WLR_EDGE_BOTTOM | WLR_EDGE_LEFT },
+            { { right, bottom, 1, 1 }, WLR_EDGE_BOTTOM | WLR_EDGE_RIGHT },
+        };
+        // A single row or column of pixels has coinciding corners.
+        for (size_t i = 0; i < 4; ++i) {
+            if ((regions[i].position & WLR_EDGE_RIGHT &&
+                 1 >= e_ptr->width) ||
+                (regions[i].position & WLR_EDGE_BOTTOM &&
+                 1 >= e_ptr->height)) continue;
+            corner_ptr->regions[corner_ptr->regions_count++] = regions[i];
+        }
+    }
+
+    _wlmaker_corner_track_position(
+        corner_ptr, corner_ptr->armed && 0 < corner_ptr->regions_count);
     _wlmaker_corner_evaluate(corner_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * (Dis)connects from @ref wlmaker_cursor_t::position_updated.
+ *
+ * @param corner_ptr
+ * @param track               Whether to track the position.
+ */
+void _wlmaker_corner_track_position(
+    wlmaker_corner_t *corner_ptr,
+    bool track)
+{
+    bool tracking =
+        NULL != corner_ptr->cursor_position_updated_listener.link.prev;
+    if (track == tracking) return;
+
+    if (!track) {
+        wlmtk_util_disconnect_listener(
+            &corner_ptr->cursor_position_updated_listener);
+        return;
+    }
+
+    // The position may have changed while not tracking.
+    corner_ptr->pointer_x = corner_ptr->cursor_ptr->wlr_cursor_ptr->x;
+    corner_ptr->pointer_y = corner_ptr->cursor_ptr->wlr_cursor_ptr->y;
+    wlmtk_util_connect_listener_signal(
+        &corner_ptr->cursor_ptr->position_updated,
+        &corner_ptr->cursor_position_updated_listener,
+        _wlmaker_corner_handle_position_updated);
+}
+
 /* ------------------------------------------------------------------------- */
 /** (Re)evaluates hot corner state from layout extents and pointer position. */
 void _wlmaker_corner_evaluate(
     wlmaker_corner_t *corner_ptr)
 {
-    if (0 >= corner_ptr->extents.width || 0>= corner_ptr->extents.height) {
-        bs_log(BS_INFO, "Zero extents found, clearing corner setup.");
-       _wlmaker_corner_clear(corner_ptr);
+    if (!corner_ptr->armed || 0 == corner_ptr->regions_count) {
+        _wlmaker_corner_clear(corner_ptr);
         return;
     }
 
+    // Quick exit for the common case: Not on a vertical & horizontal edge.
     struct wlr_box *e_ptr = &corner_ptr->extents;
-    unsigned position = WLR_EDGE_NONE;
-    if (corner_ptr->pointer_x == e_ptr->x) {
-        position |= WLR_EDGE_LEFT;
-    } else if (corner_ptr->pointer_x >= e_ptr->x + e_ptr->width - 1) {
-        position |= WLR_EDGE_RIGHT;
-    }
-    if (corner_ptr->pointer_y == e_ptr->y) {
-        position |= WLR_EDGE_TOP;
-    } else if (corner_ptr->pointer_y >= e_ptr->y + e_ptr->height - 1) {
-        position |= WLR_EDGE_BOTTOM;
+    int x = corner_ptr->pointer_x, y = corner_ptr->pointer_y;
+    if ((x > e_ptr->x && x < e_ptr->x + e_ptr->width - 1) ||
+        (y > e_ptr->y && y < e_ptr->y + e_ptr->height - 1)) {
+        _wlmaker_corner_clear(corner_ptr);
+        return;
     }
 
-    switch (position) {
-    case WLR_EDGE_TOP | WLR_EDGE_LEFT:
-    case WLR_EDGE_TOP | WLR_EDGE_RIGHT:
-    case WLR_EDGE_BOTTOM | WLR_EDGE_LEFT:
-    case WLR_EDGE_BOTTOM | WLR_EDGE_RIGHT:
-        _wlmaker_corner_occupy(corner_ptr, position);
-        break;
-    default:
-        _wlmaker_corner_clear(corner_ptr);
+    for (size_t i = 0; i < corner_ptr->regions_count; ++i) {
+        if (wlr_box_contains_point(&corner_ptr->regions[i].box, x, y)) {
+            _wlmaker_corner_occupy(corner_ptr,
+                                   corner_ptr->regions[i].position);
+            return;
+        }
     }
+    _wlmaker_corner_clear(corner_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -438,8 +531,11 @@ void _wlmaker_corner_test(bs_test_t *test_ptr)
     bspl_object_t *obj_ptr = bspl_create_object_from_plist_string(
         "{"
         "TriggerDelay = 500;"
+        "TopLeftEnter = Quit;"
         "}");
     BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, obj_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmaker_corner_decode_config(bspl_dict_from_object(obj_ptr)));
 
     struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
     BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
@@ -494,6 +590,29 @@ void _wlmaker_corner_test(bs_test_t *test_ptr)
     BS_TEST_VERIFY_FALSE(test_ptr, c_ptr->corner_triggered);
 
     wlmaker_corner_destroy(c_ptr);
+
+    // Without actions, the position is not tracked.
+    bspl_object_t *unarmed_obj_ptr = bspl_create_object_from_plist_string(
+        "{"
+        "TriggerDelay = 500;"
+        "}");
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, unarmed_obj_ptr);
+    c_ptr = wlmaker_corner_create(
+        bspl_dict_from_object(unarmed_obj_ptr),
+        wl_event_loop_ptr,
+        wlr_output_layout_ptr,
+        &cursor,
+        &server);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, c_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, c_ptr->armed);
+    BS_TEST_VERIFY_EQ(test_ptr, 4, c_ptr->regions_count);
+    wlr_cursor.x = 0;
+    wlr_cursor.y = 0;
+    wl_signal_emit(&cursor.position_updated, &wlr_cursor);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, c_ptr->current_corner);
+    wlmaker_corner_destroy(c_ptr);
+    bspl_object_unref(unarmed_obj_ptr);
+
     wl_display_destroy(wl_display_ptr);
     wl_event_loop_destroy(wl_event_loop_ptr);
     bspl_object_unref(obj_ptr);
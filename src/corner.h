@@ -25,6 +25,7 @@ typedef struct _wlmaker_corner_t wlmaker_corner_t;
 
 #include <libbase/libbase.h>
 #include <libbase/plist.h>
+#include <stdbool.h>
 
 #include "cursor.h"  // IWYU pragma: keep
 #include "server.h"  // IWYU pragma: keep
@@ -61,6 +62,16 @@ wlmaker_corner_t *wlmaker_corner_create(
  */
 void wlmaker_corner_destroy(wlmaker_corner_t *corner_ptr);
 
+/**
+ * Decodes the 'HotCorner' config dict, without creating a handler. For
+ * checking configurations, eg. from the config fuzzer.
+ *
+ * @param hot_corner_config_dict_ptr
+ *
+ * @return true if the dict decodes.
+ */
+bool wlmaker_corner_decode_config(bspl_dict_t *hot_corner_config_dict_ptr);
+
 /** Unit test cases. */
 extern const bs_test_case_t wlmaker_corner_test_cases[];
 
@@ -21,12 +21,21 @@
 #include "cursor.h"
 
 #include <libbase/libbase.h>
+#include <libbase/plist.h>
 #include <inttypes.h>
 #include <stdlib.h>
 #define WLR_USE_UNSTABLE
 #include <wlr/types/wlr_cursor.h>
+#include <wlr/types/wlr_cursor_shape_v1.h>
 #include <wlr/types/wlr_input_device.h>
+#include <wlr/types/wlr_output.h>
+#include <wlr/types/wlr_output_layout.h>
+#include <wlr/types/wlr_pointer.h>
+#include <wlr/types/wlr_pointer_constraints_v1.h>
+#include <wlr/types/wlr_pointer_gestures_v1.h>
+#include <wlr/types/wlr_relative_pointer_v1.h>
 #include <wlr/types/wlr_xcursor_manager.h>
+#include <wlr/util/region.h>
 #undef WLR_USE_UNSTABLE
 
 #include "config.h"
@@ -35,6 +44,16 @@
 
 /* == Declarations ========================================================= */
 
+/** Tracks a pointer constraint, for clearing it when destroyed. */
+typedef struct {
+    /** Back-link to the cursor. */
+    wlmaker_cursor_t          *cursor_ptr;
+    /** The constraint. */
+    struct wlr_pointer_constraint_v1 *wlr_pointer_constraint_ptr;
+    /** Listener for the `destroy` signal of the constraint. */
+    struct wl_listener        destroy_listener;
+} wlmaker_cursor_constraint_t;
+
 static void handle_motion(
     struct wl_listener *listener_ptr,
     void *data_ptr);
@@ -51,11 +70,81 @@ static void handle_frame(
     struct wl_listener *listener_ptr,
     void *data_ptr);
 
+static void handle_swipe_begin(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void handle_swipe_update(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void handle_swipe_end(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void handle_pinch_begin(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void handle_pinch_update(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void handle_pinch_end(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void handle_hold_begin(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void handle_hold_end(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+
+static void handle_output_layout_change(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
 static void handle_seat_request_set_cursor(
     struct wl_listener *listener_ptr,
     void *data_ptr);
+static void handle_seat_pointer_focus_change(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void handle_request_set_shape(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void handle_new_constraint(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void handle_constraint_destroy(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+
+static void set_constraint(
+    wlmaker_cursor_t *cursor_ptr,
+    struct wlr_pointer_constraint_v1 *wlr_pointer_constraint_ptr);
+static bool is_locked(wlmaker_cursor_t *cursor_ptr);
 
 static void process_motion(wlmaker_cursor_t *cursor_ptr, uint32_t time_msec);
+static void defer_motion(wlmaker_cursor_t *cursor_ptr, uint32_t time_msec);
+static void flush_motion(wlmaker_cursor_t *cursor_ptr);
+static void handle_flush_idle(void *data_ptr);
+static void accumulate_axis(
+    wlmaker_cursor_t *cursor_ptr,
+    struct wlr_pointer_axis_event *wlr_pointer_axis_event_ptr);
+static void flush_axis(wlmaker_cursor_t *cursor_ptr);
+static void dispatch_axis(
+    wlmaker_cursor_t *cursor_ptr,
+    wlmaker_cursor_axis_t *axis_ptr);
+
+/* == Data ================================================================= */
+
+/** Descriptor for the "Pointer" dict of wlmaker.plist. */
+static const bspl_desc_t wlmaker_cursor_config_desc[] = {
+    BSPL_DESC_BOOL(
+        "CoalesceMotion", false, wlmaker_cursor_t,
+        coalesce_motion, coalesce_motion, false),
+    BSPL_DESC_SENTINEL()
+};
+
+/** Swipes with at least that many fingers switch workspaces. */
+static const uint32_t _wlmaker_cursor_swipe_min_fingers = 3;
+/** Swipes with at most that many fingers switch workspaces. */
+static const uint32_t _wlmaker_cursor_swipe_max_fingers = 4;
 
 /* == Exported methods ===================================================== */
 
@@ -64,7 +153,9 @@ wlmaker_cursor_t *wlmaker_cursor_create(
     wlmaker_server_t *server_ptr,
     struct wlr_output_layout *wlr_output_layout_ptr)
 {
-    wlmaker_cursor_t *cursor_ptr = logged_calloc(1, sizeof(wlmaker_cursor_t));
+    // From the locked arena, if enabled: Motion is coalesced in here.
+    wlmaker_cursor_t *cursor_ptr = wlmtk_arena_calloc(
+        sizeof(wlmaker_cursor_t));
     if (NULL == cursor_ptr) return NULL;
     cursor_ptr->server_ptr = server_ptr;
 
@@ -106,9 +197,60 @@ wlmaker_cursor_t *wlmaker_cursor_create(
         wlmaker_cursor_destroy(cursor_ptr);
         return NULL;
     }
+    wlmtk_util_connect_listener_signal(
+        &wlr_output_layout_ptr->events.change,
+        &cursor_ptr->output_layout_change_listener,
+        handle_output_layout_change);
 
     wl_signal_init(&cursor_ptr->position_updated);
 
+    cursor_ptr->wlr_relative_pointer_manager_ptr =
+        wlr_relative_pointer_manager_v1_create(server_ptr->wl_display_ptr);
+    if (NULL == cursor_ptr->wlr_relative_pointer_manager_ptr) {
+        bs_log(BS_ERROR, "Failed wlr_relative_pointer_manager_v1_create()");
+        wlmaker_cursor_destroy(cursor_ptr);
+        return NULL;
+    }
+    cursor_ptr->wlr_pointer_constraints_ptr =
+        wlr_pointer_constraints_v1_create(server_ptr->wl_display_ptr);
+    if (NULL == cursor_ptr->wlr_pointer_constraints_ptr) {
+        bs_log(BS_ERROR, "Failed wlr_pointer_constraints_v1_create()");
+        wlmaker_cursor_destroy(cursor_ptr);
+        return NULL;
+    }
+    wlmtk_util_connect_listener_signal(
+        &cursor_ptr->wlr_pointer_constraints_ptr->events.new_constraint,
+        &cursor_ptr->new_constraint_listener,
+        handle_new_constraint);
+    cursor_ptr->wlr_cursor_shape_manager_ptr =
+        wlr_cursor_shape_manager_v1_create(server_ptr->wl_display_ptr, 1);
+    if (NULL == cursor_ptr->wlr_cursor_shape_manager_ptr) {
+        bs_log(BS_ERROR, "Failed wlr_cursor_shape_manager_v1_create()");
+        wlmaker_cursor_destroy(cursor_ptr);
+        return NULL;
+    }
+    wlmtk_util_connect_listener_signal(
+        &cursor_ptr->wlr_cursor_shape_manager_ptr->events.request_set_shape,
+        &cursor_ptr->request_set_shape_listener,
+        handle_request_set_shape);
+    cursor_ptr->wlr_pointer_gestures_ptr = wlr_pointer_gestures_v1_create(
+        server_ptr->wl_display_ptr);
+    if (NULL == cursor_ptr->wlr_pointer_gestures_ptr) {
+        bs_log(BS_ERROR, "Failed wlr_pointer_gestures_v1_create()");
+        wlmaker_cursor_destroy(cursor_ptr);
+        return NULL;
+    }
+
+    // Optional: Defaults to processing every motion event.
+    bspl_dict_t *dict_ptr = bspl_dict_get_dict(
+        server_ptr->config_dict_ptr, "Pointer");
+    if (NULL != dict_ptr &&
+        !bspl_decode_dict(dict_ptr, wlmaker_cursor_config_desc, cursor_ptr)) {
+        bs_log(BS_ERROR, "Failed to decode \"Pointer\" dict");
+        wlmaker_cursor_destroy(cursor_ptr);
+        return NULL;
+    }
+
     // tinywl: wlr_cursor *only* displays an image on screen. It does not move
     // around when the pointer moves. However, we can attach input devices to
     // it, and it will generate aggregate events for all of them. In these
@@ -138,11 +280,48 @@ wlmaker_cursor_t *wlmaker_cursor_create(
         &cursor_ptr->wlr_cursor_ptr->events.frame,
         &cursor_ptr->frame_listener,
         handle_frame);
+    wlmtk_util_connect_listener_signal(
+        &cursor_ptr->wlr_cursor_ptr->events.swipe_begin,
+        &cursor_ptr->swipe_begin_listener,
+        handle_swipe_begin);
+    wlmtk_util_connect_listener_signal(
+        &cursor_ptr->wlr_cursor_ptr->events.swipe_update,
+        &cursor_ptr->swipe_update_listener,
+        handle_swipe_update);
+    wlmtk_util_connect_listener_signal(
+        &cursor_ptr->wlr_cursor_ptr->events.swipe_end,
+        &cursor_ptr->swipe_end_listener,
+        handle_swipe_end);
+    wlmtk_util_connect_listener_signal(
+        &cursor_ptr->wlr_cursor_ptr->events.pinch_begin,
+        &cursor_ptr->pinch_begin_listener,
+        handle_pinch_begin);
+    wlmtk_util_connect_listener_signal(
+        &cursor_ptr->wlr_cursor_ptr->events.pinch_update,
+        &cursor_ptr->pinch_update_listener,
+        handle_pinch_update);
+    wlmtk_util_connect_listener_signal(
+        &cursor_ptr->wlr_cursor_ptr->events.pinch_end,
+        &cursor_ptr->pinch_end_listener,
+        handle_pinch_end);
+    wlmtk_util_connect_listener_signal(
+        &cursor_ptr->wlr_cursor_ptr->events.hold_begin,
+        &cursor_ptr->hold_begin_listener,
+        handle_hold_begin);
+    wlmtk_util_connect_listener_signal(
+        &cursor_ptr->wlr_cursor_ptr->events.hold_end,
+        &cursor_ptr->hold_end_listener,
+        handle_hold_end);
 
     wlmtk_util_connect_listener_signal(
         &cursor_ptr->server_ptr->wlr_seat_ptr->events.request_set_cursor,
         &cursor_ptr->seat_request_set_cursor_listener,
         handle_seat_request_set_cursor);
+    wlmtk_util_connect_listener_signal(
+        &cursor_ptr->server_ptr->wlr_seat_ptr->pointer_state.events
+        .focus_change,
+        &cursor_ptr->seat_pointer_focus_change_listener,
+        handle_seat_pointer_focus_change);
 
     return cursor_ptr;
 }
@@ -150,6 +329,20 @@ wlmaker_cursor_t *wlmaker_cursor_create(
 /* ------------------------------------------------------------------------- */
 void wlmaker_cursor_destroy(wlmaker_cursor_t *cursor_ptr)
 {
+    wlmtk_util_disconnect_listener(
+        &cursor_ptr->seat_pointer_focus_change_listener);
+    wlmtk_util_disconnect_listener(&cursor_ptr->request_set_shape_listener);
+    wlmtk_util_disconnect_listener(&cursor_ptr->new_constraint_listener);
+    wlmtk_util_disconnect_listener(
+        &cursor_ptr->output_layout_change_listener);
+    // Note: Relative pointer manager, pointer constraints, cursor shape
+    // manager and pointer gestures have no dtor.
+
+    if (NULL != cursor_ptr->flush_idle_ptr) {
+        wl_event_source_remove(cursor_ptr->flush_idle_ptr);
+        cursor_ptr->flush_idle_ptr = NULL;
+    }
+
     if (NULL != cursor_ptr->pointer_ptr) {
         wlmtk_pointer_destroy(cursor_ptr->pointer_ptr);
         cursor_ptr->pointer_ptr = NULL;
@@ -165,7 +358,7 @@ void wlmaker_cursor_destroy(wlmaker_cursor_t *cursor_ptr)
         cursor_ptr->wlr_cursor_ptr = NULL;
     }
 
-    free(cursor_ptr);
+    wlmtk_arena_free(cursor_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -204,14 +397,51 @@ void handle_motion(struct wl_listener *listener_ptr,
         listener_ptr, wlmaker_cursor_t, motion_listener);
     struct wlr_pointer_motion_event *wlr_pointer_motion_event_ptr = data_ptr;
 
-    wlmaker_idle_monitor_reset(cursor_ptr->server_ptr->idle_monitor_ptr);
+    wlr_relative_pointer_manager_v1_send_relative_motion(
+        cursor_ptr->wlr_relative_pointer_manager_ptr,
+        cursor_ptr->server_ptr->wlr_seat_ptr,
+        (uint64_t)wlr_pointer_motion_event_ptr->time_msec * 1000,
+        wlr_pointer_motion_event_ptr->delta_x,
+        wlr_pointer_motion_event_ptr->delta_y,
+        wlr_pointer_motion_event_ptr->unaccel_dx,
+        wlr_pointer_motion_event_ptr->unaccel_dy);
+
+    // A locked pointer does not move: The client only gets relative motion.
+    if (is_locked(cursor_ptr)) {
+        wlmaker_idle_monitor_reset(cursor_ptr->server_ptr->idle_monitor_ptr);
+        return;
+    }
+
+    // Accumulated axis motion goes to the pointer focus before the move.
+    flush_axis(cursor_ptr);
+
+    double dx = wlr_pointer_motion_event_ptr->delta_x;
+    double dy = wlr_pointer_motion_event_ptr->delta_y;
+    struct wlr_pointer_constraint_v1 *c_ptr =
+        cursor_ptr->active_constraint_ptr;
+    if (NULL != c_ptr) {
+        // Confined: Keep the motion within the region, surface-local. That
+        // needs the seat's surface-local position to be current.
+        flush_motion(cursor_ptr);
+        double sx = cursor_ptr->server_ptr->wlr_seat_ptr->pointer_state.sx;
+        double sy = cursor_ptr->server_ptr->wlr_seat_ptr->pointer_state.sy;
+        double confined_sx, confined_sy;
+        if (!wlr_region_confine(&c_ptr->region, sx, sy, sx + dx, sy + dy,
+                                &confined_sx, &confined_sy)) return;
+        dx = confined_sx - sx;
+        dy = confined_sy - sy;
+    }
 
     wlr_cursor_move(
         cursor_ptr->wlr_cursor_ptr,
         &wlr_pointer_motion_event_ptr->pointer->base,
-        wlr_pointer_motion_event_ptr->delta_x,
-        wlr_pointer_motion_event_ptr->delta_y);
+        dx, dy);
 
+    if (cursor_ptr->coalesce_motion) {
+        defer_motion(cursor_ptr, wlr_pointer_motion_event_ptr->time_msec);
+        return;
+    }
+    wlmaker_idle_monitor_reset(cursor_ptr->server_ptr->idle_monitor_ptr);
     process_motion(
         cursor_ptr,
         wlr_pointer_motion_event_ptr->time_msec);
@@ -232,14 +462,23 @@ void handle_motion_absolute(struct wl_listener *listener_ptr,
     struct wlr_pointer_motion_absolute_event
         *wlr_pointer_motion_absolute_event_ptr = data_ptr;
 
-    wlmaker_idle_monitor_reset(cursor_ptr->server_ptr->idle_monitor_ptr);
+    // Absolute motion has no deltas to report. Ignored while locked.
+    if (is_locked(cursor_ptr)) return;
 
+    flush_axis(cursor_ptr);
     wlr_cursor_warp_absolute(
         cursor_ptr->wlr_cursor_ptr,
         &wlr_pointer_motion_absolute_event_ptr->pointer->base,
         wlr_pointer_motion_absolute_event_ptr->x,
         wlr_pointer_motion_absolute_event_ptr->y);
 
+    if (cursor_ptr->coalesce_motion) {
+        defer_motion(
+            cursor_ptr,
+            wlr_pointer_motion_absolute_event_ptr->time_msec);
+        return;
+    }
+    wlmaker_idle_monitor_reset(cursor_ptr->server_ptr->idle_monitor_ptr);
     process_motion(
         cursor_ptr,
         wlr_pointer_motion_absolute_event_ptr->time_msec);
@@ -259,6 +498,9 @@ void handle_button(struct wl_listener *listener_ptr,
         listener_ptr, wlmaker_cursor_t, button_listener);
     struct wlr_pointer_button_event *wlr_pointer_button_event_ptr = data_ptr;
 
+    // Pointer focus must be current before the button is dispatched.
+    flush_axis(cursor_ptr);
+    flush_motion(cursor_ptr);
     wlmaker_idle_monitor_reset(cursor_ptr->server_ptr->idle_monitor_ptr);
 
     wlmtk_root_pointer_button(
@@ -268,7 +510,8 @@ void handle_button(struct wl_listener *listener_ptr,
 
 /* ------------------------------------------------------------------------- */
 /**
- * Handler for the `axis` event of `wlr_cursor`.
+ * Handler for the `axis` event of `wlr_cursor`. Accumulates the event, to
+ * be dispatched on the `frame` event, or before the next motion or button.
  *
  * @param listener_ptr
  * @param data_ptr Points to a `wlr_pointer_axis_event`.
@@ -280,11 +523,10 @@ void handle_axis(struct wl_listener *listener_ptr,
         listener_ptr, wlmaker_cursor_t, axis_listener);
     struct wlr_pointer_axis_event *wlr_pointer_axis_event_ptr = data_ptr;
 
+    flush_motion(cursor_ptr);
     wlmaker_idle_monitor_reset(cursor_ptr->server_ptr->idle_monitor_ptr);
 
-    wlmtk_root_pointer_axis(
-        cursor_ptr->server_ptr->root_ptr,
-        wlr_pointer_axis_event_ptr);
+    accumulate_axis(cursor_ptr, wlr_pointer_axis_event_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -300,10 +542,272 @@ void handle_frame(struct wl_listener *listener_ptr,
     wlmaker_cursor_t *cursor_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmaker_cursor_t, frame_listener);
 
+    flush_axis(cursor_ptr);
+
+    // The frame must follow the motion it terminates. Sent when flushing.
+    if (cursor_ptr->motion_pending) {
+        cursor_ptr->frame_pending = true;
+        return;
+    }
+
     /* Notify the client with pointer focus of the frame event. */
     wlr_seat_pointer_notify_frame(cursor_ptr->server_ptr->wlr_seat_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for the `swipe_begin` event of `wlr_cursor`. Swipes with 3 or 4
+ * fingers switch workspaces, by their horizontal motion. Other swipes go to
+ * the client.
+ *
+ * @param listener_ptr
+ * @param data_ptr Points to a `wlr_pointer_swipe_begin_event`.
+ */
+void handle_swipe_begin(struct wl_listener *listener_ptr,
+                        void *data_ptr)
+{
+    wlmaker_cursor_t *cursor_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_cursor_t, swipe_begin_listener);
+    struct wlr_pointer_swipe_begin_event *event_ptr = data_ptr;
+
+    flush_axis(cursor_ptr);
+    flush_motion(cursor_ptr);
+    wlmaker_idle_monitor_reset(cursor_ptr->server_ptr->idle_monitor_ptr);
+
+    cursor_ptr->swiping_workspaces =
+        _wlmaker_cursor_swipe_min_fingers <= event_ptr->fingers &&
+        _wlmaker_cursor_swipe_max_fingers >= event_ptr->fingers;
+    if (cursor_ptr->swiping_workspaces) {
+        wlmtk_root_swipe_begin(
+            cursor_ptr->server_ptr->root_ptr, event_ptr->time_msec);
+        return;
+    }
+    wlr_pointer_gestures_v1_send_swipe_begin(
+        cursor_ptr->wlr_pointer_gestures_ptr,
+        cursor_ptr->server_ptr->wlr_seat_ptr,
+        event_ptr->time_msec,
+        event_ptr->fingers);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for the `swipe_update` event of `wlr_cursor`. While switching
+ * workspaces, the current and the next workspace follow the fingers 1:1.
+ *
+ * @param listener_ptr
+ * @param data_ptr Points to a `wlr_pointer_swipe_update_event`.
+ */
+void handle_swipe_update(struct wl_listener *listener_ptr,
+                         void *data_ptr)
+{
+    wlmaker_cursor_t *cursor_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_cursor_t, swipe_update_listener);
+    struct wlr_pointer_swipe_update_event *event_ptr = data_ptr;
+
+    wlmaker_idle_monitor_reset(cursor_ptr->server_ptr->idle_monitor_ptr);
+    if (cursor_ptr->swiping_workspaces) {
+        wlmtk_root_swipe_update(
+            cursor_ptr->server_ptr->root_ptr,
+            event_ptr->dx,
+            event_ptr->time_msec);
+        return;
+    }
+    wlr_pointer_gestures_v1_send_swipe_update(
+        cursor_ptr->wlr_pointer_gestures_ptr,
+        cursor_ptr->server_ptr->wlr_seat_ptr,
+        event_ptr->time_msec,
+        event_ptr->dx,
+        event_ptr->dy);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for the `swipe_end` event of `wlr_cursor`. Commits or reverts the
+ * workspace switch, with the swipe's velocity.
+ *
+ * @param listener_ptr
+ * @param data_ptr Points to a `wlr_pointer_swipe_end_event`.
+ */
+void handle_swipe_end(struct wl_listener *listener_ptr,
+                      void *data_ptr)
+{
+    wlmaker_cursor_t *cursor_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_cursor_t, swipe_end_listener);
+    struct wlr_pointer_swipe_end_event *event_ptr = data_ptr;
+
+    wlmaker_idle_monitor_reset(cursor_ptr->server_ptr->idle_monitor_ptr);
+    if (cursor_ptr->swiping_workspaces) {
+        cursor_ptr->swiping_workspaces = false;
+        wlmtk_root_swipe_end(
+            cursor_ptr->server_ptr->root_ptr,
+            event_ptr->time_msec,
+            event_ptr->cancelled);
+        return;
+    }
+    wlr_pointer_gestures_v1_send_swipe_end(
+        cursor_ptr->wlr_pointer_gestures_ptr,
+        cursor_ptr->server_ptr->wlr_seat_ptr,
+        event_ptr->time_msec,
+        event_ptr->cancelled);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for the `pinch_begin` event of `wlr_cursor`: Sent to the client.
+ *
+ * @param listener_ptr
+ * @param data_ptr Points to a `wlr_pointer_pinch_begin_event`.
+ */
+void handle_pinch_begin(struct wl_listener *listener_ptr,
+                        void *data_ptr)
+{
+    wlmaker_cursor_t *cursor_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_cursor_t, pinch_begin_listener);
+    struct wlr_pointer_pinch_begin_event *event_ptr = data_ptr;
+
+    flush_axis(cursor_ptr);
+    flush_motion(cursor_ptr);
+    wlmaker_idle_monitor_reset(cursor_ptr->server_ptr->idle_monitor_ptr);
+    wlr_pointer_gestures_v1_send_pinch_begin(
+        cursor_ptr->wlr_pointer_gestures_ptr,
+        cursor_ptr->server_ptr->wlr_seat_ptr,
+        event_ptr->time_msec,
+        event_ptr->fingers);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for the `pinch_update` event of `wlr_cursor`: Sent to the client.
+ *
+ * @param listener_ptr
+ * @param data_ptr Points to a `wlr_pointer_pinch_update_event`.
+ */
+void handle_pinch_update(struct wl_listener *listener_ptr,
+                         void *data_ptr)
+{
+    wlmaker_cursor_t *cursor_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_cursor_t, pinch_update_listener);
+    struct wlr_pointer_pinch_update_event *event_ptr = data_ptr;
+
+    wlmaker_idle_monitor_reset(cursor_ptr->server_ptr->idle_monitor_ptr);
+    wlr_pointer_gestures_v1_send_pinch_update(
+        cursor_ptr->wlr_pointer_gestures_ptr,
+        cursor_ptr->server_ptr->wlr_seat_ptr,
+        event_ptr->time_msec,
+        event_ptr->dx,
+        event_ptr->dy,
+        event_ptr->scale,
+        event_ptr->rotation);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for the `pinch_end` event of `wlr_cursor`: Sent to the client.
+ *
+ * @param listener_ptr
+ * @param data_ptr Points to a `wlr_pointer_pinch_end_event`.
+ */
+void handle_pinch_end(struct wl_listener *listener_ptr,
+                      void *data_ptr)
+{
+    wlmaker_cursor_t *cursor_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_cursor_t, pinch_end_listener);
+    struct wlr_pointer_pinch_end_event *event_ptr = data_ptr;
+
+    wlmaker_idle_monitor_reset(cursor_ptr->server_ptr->idle_monitor_ptr);
+    wlr_pointer_gestures_v1_send_pinch_end(
+        cursor_ptr->wlr_pointer_gestures_ptr,
+        cursor_ptr->server_ptr->wlr_seat_ptr,
+        event_ptr->time_msec,
+        event_ptr->cancelled);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for the `hold_begin` event of `wlr_cursor`: Sent to the client.
+ *
+ * @param listener_ptr
+ * @param data_ptr Points to a `wlr_pointer_hold_begin_event`.
+ */
+void handle_hold_begin(struct wl_listener *listener_ptr,
+                       void *data_ptr)
+{
+    wlmaker_cursor_t *cursor_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_cursor_t, hold_begin_listener);
+    struct wlr_pointer_hold_begin_event *event_ptr = data_ptr;
+
+    flush_axis(cursor_ptr);
+    flush_motion(cursor_ptr);
+    wlmaker_idle_monitor_reset(cursor_ptr->server_ptr->idle_monitor_ptr);
+    wlr_pointer_gestures_v1_send_hold_begin(
+        cursor_ptr->wlr_pointer_gestures_ptr,
+        cursor_ptr->server_ptr->wlr_seat_ptr,
+        event_ptr->time_msec,
+        event_ptr->fingers);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for the `hold_end` event of `wlr_cursor`: Sent to the client.
+ *
+ * @param listener_ptr
+ * @param data_ptr Points to a `wlr_pointer_hold_end_event`.
+ */
+void handle_hold_end(struct wl_listener *listener_ptr,
+                     void *data_ptr)
+{
+    wlmaker_cursor_t *cursor_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_cursor_t, hold_end_listener);
+    struct wlr_pointer_hold_end_event *event_ptr = data_ptr;
+
+    wlr_pointer_gestures_v1_send_hold_end(
+        cursor_ptr->wlr_pointer_gestures_ptr,
+        cursor_ptr->server_ptr->wlr_seat_ptr,
+        event_ptr->time_msec,
+        event_ptr->cancelled);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for the `change` event of `wlr_output_layout`.
+ *
+ * Loads the xcursor theme at the scale of each output: `wlr_cursor` shows
+ * each output's cursor from the theme at that output's scale, and looks up
+ * images by name from the themes loaded. Loading here keeps reading and
+ * rasterizing the theme off the first motion onto a newly scaled output.
+ *
+ * @param listener_ptr
+ * @param data_ptr            Points to a `struct wlr_output_layout`.
+ */
+void handle_output_layout_change(
+    struct wl_listener *listener_ptr,
+    void *data_ptr)
+{
+    wlmaker_cursor_t *cursor_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_cursor_t, output_layout_change_listener);
+    struct wlr_output_layout *wlr_output_layout_ptr = data_ptr;
+
+    struct wlr_output_layout_output *wlr_output_layout_output_ptr;
+    wl_list_for_each(wlr_output_layout_output_ptr,
+                     &wlr_output_layout_ptr->outputs, link) {
+        float scale = wlr_output_layout_output_ptr->output->scale;
+        // Already loaded at that scale: The manager keeps all themes.
+        if (NULL != wlr_xcursor_manager_get_xcursor(
+                cursor_ptr->wlr_xcursor_manager_ptr, "default", scale)) {
+            continue;
+        }
+        if (!wlr_xcursor_manager_load(
+                cursor_ptr->wlr_xcursor_manager_ptr, scale)) {
+            bs_log(BS_WARNING, "Failed wlr_xcursor_manager_load() for %s, "
+                   "scale %.2f", cursor_ptr->server_ptr->style.cursor.name_ptr,
+                   scale);
+            continue;
+        }
+        bs_log(BS_INFO, "Loaded cursor theme %s at scale %.2f",
+               cursor_ptr->server_ptr->style.cursor.name_ptr, scale);
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Handler for the `request_set_cursor` event of `wlr_seat`.
@@ -327,15 +831,183 @@ void handle_seat_request_set_cursor(
         cursor_ptr->server_ptr->wlr_seat_ptr->pointer_state.focused_client;
     if (focused_wlr_seat_client_ptr ==
         wlr_seat_pointer_request_set_cursor_event_ptr->seat_client) {
-        wlr_cursor_set_surface(
-            cursor_ptr->wlr_cursor_ptr,
+        wlmtk_pointer_set_surface(
+            cursor_ptr->pointer_ptr,
             wlr_seat_pointer_request_set_cursor_event_ptr->surface,
             wlr_seat_pointer_request_set_cursor_event_ptr->hotspot_x,
             wlr_seat_pointer_request_set_cursor_event_ptr->hotspot_y);
 
     } else {
-        bs_log(BS_WARNING, "request_set_cursor called without pointer focus.");
+        WLMTK_LOG_SAMPLED(BS_WARNING, 100,
+                          "request_set_cursor called without pointer focus.");
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for `request_set_shape` of `wlr_cursor_shape_manager_v1`.
+ *
+ * Sets the named cursor from our xcursor theme, so the client does not need
+ * to provide a surface. Like @ref handle_seat_request_set_cursor, it is
+ * accepted only if the client has the pointer focus.
+ *
+ * @param listener_ptr
+ * @param data_ptr Points to a
+ *     `wlr_cursor_shape_manager_v1_request_set_shape_event`.
+ */
+void handle_request_set_shape(
+    struct wl_listener *listener_ptr,
+    void *data_ptr)
+{
+    wlmaker_cursor_t *cursor_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_cursor_t, request_set_shape_listener);
+    struct wlr_cursor_shape_manager_v1_request_set_shape_event
+        *event_ptr = data_ptr;
+
+    // Tablet tools have no cursor of their own here.
+    if (WLR_CURSOR_SHAPE_MANAGER_V1_DEVICE_TYPE_POINTER !=
+        event_ptr->device_type) return;
+
+    struct wlr_seat_client *focused_wlr_seat_client_ptr =
+        cursor_ptr->server_ptr->wlr_seat_ptr->pointer_state.focused_client;
+    if (focused_wlr_seat_client_ptr != event_ptr->seat_client) {
+        WLMTK_LOG_SAMPLED(BS_WARNING, 100,
+                          "request_set_shape called without pointer focus.");
+        return;
+    }
+
+    wlmtk_pointer_set_xcursor(
+        cursor_ptr->pointer_ptr,
+        wlr_cursor_shape_v1_name(event_ptr->shape));
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for `focus_change` of `wlr_seat::pointer_state`: Activates the
+ * constraint of the newly focussed surface, if any.
+ *
+ * @param listener_ptr
+ * @param data_ptr Points to a `wlr_seat_pointer_focus_change_event`.
+ */
+void handle_seat_pointer_focus_change(
+    struct wl_listener *listener_ptr,
+    void *data_ptr)
+{
+    wlmaker_cursor_t *cursor_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_cursor_t, seat_pointer_focus_change_listener);
+    struct wlr_seat_pointer_focus_change_event *event_ptr = data_ptr;
+
+    struct wlr_pointer_constraint_v1 *c_ptr = NULL;
+    if (NULL != event_ptr->new_surface) {
+        c_ptr = wlr_pointer_constraints_v1_constraint_for_surface(
+            cursor_ptr->wlr_pointer_constraints_ptr,
+            event_ptr->new_surface,
+            cursor_ptr->server_ptr->wlr_seat_ptr);
+    }
+    set_constraint(cursor_ptr, c_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for `new_constraint` of `wlr_pointer_constraints_v1`. Tracks the
+ * constraint, and activates it if the surface has pointer focus.
+ *
+ * @param listener_ptr
+ * @param data_ptr Points to a `wlr_pointer_constraint_v1`.
+ */
+void handle_new_constraint(
+    struct wl_listener *listener_ptr,
+    void *data_ptr)
+{
+    wlmaker_cursor_t *cursor_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_cursor_t, new_constraint_listener);
+    struct wlr_pointer_constraint_v1 *wlr_pointer_constraint_ptr = data_ptr;
+
+    wlmaker_cursor_constraint_t *constraint_ptr = logged_calloc(
+        1, sizeof(wlmaker_cursor_constraint_t));
+    if (NULL == constraint_ptr) return;
+    constraint_ptr->cursor_ptr = cursor_ptr;
+    constraint_ptr->wlr_pointer_constraint_ptr = wlr_pointer_constraint_ptr;
+    wlmtk_util_connect_listener_signal(
+        &wlr_pointer_constraint_ptr->events.destroy,
+        &constraint_ptr->destroy_listener,
+        handle_constraint_destroy);
+
+    if (cursor_ptr->server_ptr->wlr_seat_ptr->pointer_state.focused_surface ==
+        wlr_pointer_constraint_ptr->surface) {
+        set_constraint(cursor_ptr, wlr_pointer_constraint_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for `destroy` of `wlr_pointer_constraint_v1`.
+ *
+ * @param listener_ptr
+ * @param data_ptr
+ */
+void handle_constraint_destroy(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmaker_cursor_constraint_t *constraint_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_cursor_constraint_t, destroy_listener);
+    wlmaker_cursor_t *cursor_ptr = constraint_ptr->cursor_ptr;
+
+    // No more deactivation to send, the constraint is going away.
+    if (cursor_ptr->active_constraint_ptr ==
+        constraint_ptr->wlr_pointer_constraint_ptr) {
+        cursor_ptr->active_constraint_ptr = NULL;
     }
+    wlmtk_util_disconnect_listener(&constraint_ptr->destroy_listener);
+    free(constraint_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Sets the active constraint. Deactivates the former one, and warps the
+ * cursor to the position hinted by a formerly locking client.
+ *
+ * @param cursor_ptr
+ * @param wlr_pointer_constraint_ptr May be NULL.
+ */
+void set_constraint(
+    wlmaker_cursor_t *cursor_ptr,
+    struct wlr_pointer_constraint_v1 *wlr_pointer_constraint_ptr)
+{
+    struct wlr_pointer_constraint_v1 *old_ptr =
+        cursor_ptr->active_constraint_ptr;
+    if (old_ptr == wlr_pointer_constraint_ptr) return;
+
+    if (NULL != old_ptr) {
+        if (WLR_POINTER_CONSTRAINT_V1_LOCKED == old_ptr->type &&
+            old_ptr->current.cursor_hint.enabled) {
+            // Surface origin, from the surface-local position of the seat.
+            struct wlr_seat_pointer_state *ps_ptr =
+                &cursor_ptr->server_ptr->wlr_seat_ptr->pointer_state;
+            double x = cursor_ptr->wlr_cursor_ptr->x - ps_ptr->sx;
+            double y = cursor_ptr->wlr_cursor_ptr->y - ps_ptr->sy;
+            wlr_cursor_warp(
+                cursor_ptr->wlr_cursor_ptr, NULL,
+                x + old_ptr->current.cursor_hint.x,
+                y + old_ptr->current.cursor_hint.y);
+        }
+        wlr_pointer_constraint_v1_send_deactivated(old_ptr);
+    }
+
+    cursor_ptr->active_constraint_ptr = wlr_pointer_constraint_ptr;
+    if (NULL != wlr_pointer_constraint_ptr) {
+        wlr_pointer_constraint_v1_send_activated(wlr_pointer_constraint_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Whether the active constraint locks the pointer. */
+bool is_locked(wlmaker_cursor_t *cursor_ptr)
+{
+    return (NULL != cursor_ptr->active_constraint_ptr &&
+            WLR_POINTER_CONSTRAINT_V1_LOCKED ==
+            cursor_ptr->active_constraint_ptr->type);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -349,10 +1021,21 @@ void handle_seat_request_set_cursor(
  */
 void process_motion(wlmaker_cursor_t *cursor_ptr, uint32_t time_msec)
 {
+    WLMTK_TRACE_SPAN("process_motion");
     wl_signal_emit_mutable(
         &cursor_ptr->position_updated,
         cursor_ptr->wlr_cursor_ptr);
 
+    // The magnified viewport follows the cursor.
+    wlmbe_backend_t *backend_ptr = cursor_ptr->server_ptr->backend_ptr;
+    if (NULL != backend_ptr && 1.0 < wlmbe_backend_magnification(backend_ptr)) {
+        wlmbe_backend_set_magnification(
+            backend_ptr,
+            wlmbe_backend_magnification(backend_ptr),
+            cursor_ptr->wlr_cursor_ptr->x,
+            cursor_ptr->wlr_cursor_ptr->y);
+    }
+
     // TODO(kaeser@gubbe.ch): also make this an event-based callback.
     wlmtk_root_pointer_motion(
         cursor_ptr->server_ptr->root_ptr,
@@ -362,4 +1045,160 @@ void process_motion(wlmaker_cursor_t *cursor_ptr, uint32_t time_msec)
         cursor_ptr->pointer_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Records a motion for later processing, and schedules processing it once
+ * the event loop is idle.
+ *
+ * @param cursor_ptr
+ * @param time_msec
+ */
+void defer_motion(wlmaker_cursor_t *cursor_ptr, uint32_t time_msec)
+{
+    cursor_ptr->motion_pending = true;
+    cursor_ptr->pending_time_msec = time_msec;
+    if (NULL != cursor_ptr->flush_idle_ptr) return;
+
+    cursor_ptr->flush_idle_ptr = wl_event_loop_add_idle(
+        wl_display_get_event_loop(cursor_ptr->server_ptr->wl_display_ptr),
+        handle_flush_idle,
+        cursor_ptr);
+    if (NULL == cursor_ptr->flush_idle_ptr) {
+        bs_log(BS_WARNING, "Failed wl_event_loop_add_idle(), flushing now");
+        flush_motion(cursor_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Processes the pending motion, if any. Sends a `frame` to the client with
+ * pointer focus, if one was held back for the motion.
+ *
+ * @param cursor_ptr
+ */
+void flush_motion(wlmaker_cursor_t *cursor_ptr)
+{
+    if (NULL != cursor_ptr->flush_idle_ptr) {
+        wl_event_source_remove(cursor_ptr->flush_idle_ptr);
+        cursor_ptr->flush_idle_ptr = NULL;
+    }
+    if (!cursor_ptr->motion_pending) return;
+    cursor_ptr->motion_pending = false;
+
+    wlmaker_idle_monitor_reset(cursor_ptr->server_ptr->idle_monitor_ptr);
+    process_motion(cursor_ptr, cursor_ptr->pending_time_msec);
+
+    if (cursor_ptr->frame_pending) {
+        cursor_ptr->frame_pending = false;
+        wlr_seat_pointer_notify_frame(cursor_ptr->server_ptr->wlr_seat_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Idle callback: Processes the pending motion. */
+void handle_flush_idle(void *data_ptr)
+{
+    wlmaker_cursor_t *cursor_ptr = data_ptr;
+    // The idle source is destroyed after dispatching.
+    cursor_ptr->flush_idle_ptr = NULL;
+    flush_motion(cursor_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Adds the axis event to the accumulator of it's orientation. Dispatches
+ * what was accumulated first, if the event is from a different source.
+ *
+ * @param cursor_ptr
+ * @param wlr_pointer_axis_event_ptr
+ */
+void accumulate_axis(
+    wlmaker_cursor_t *cursor_ptr,
+    struct wlr_pointer_axis_event *wlr_pointer_axis_event_ptr)
+{
+    size_t o = wlr_pointer_axis_event_ptr->orientation;
+    if (o >= sizeof(cursor_ptr->axis) / sizeof(wlmaker_cursor_axis_t)) {
+        // Not expected. Pass it on unchanged.
+        wlmtk_root_pointer_axis(
+            cursor_ptr->server_ptr->root_ptr,
+            wlr_pointer_axis_event_ptr);
+        return;
+    }
+    wlmaker_cursor_axis_t *axis_ptr = &cursor_ptr->axis[o];
+
+    if (axis_ptr->pending &&
+        (axis_ptr->event.source != wlr_pointer_axis_event_ptr->source ||
+         axis_ptr->event.pointer != wlr_pointer_axis_event_ptr->pointer)) {
+        dispatch_axis(cursor_ptr, axis_ptr);
+    }
+
+    if (!axis_ptr->pending) {
+        axis_ptr->event = *wlr_pointer_axis_event_ptr;
+        axis_ptr->pending = true;
+        return;
+    }
+    axis_ptr->event.delta += wlr_pointer_axis_event_ptr->delta;
+    axis_ptr->event.delta_discrete +=
+        wlr_pointer_axis_event_ptr->delta_discrete;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Dispatches the accumulated axis events, for both orientations. */
+void flush_axis(wlmaker_cursor_t *cursor_ptr)
+{
+    for (size_t o = 0;
+         o < sizeof(cursor_ptr->axis) / sizeof(wlmaker_cursor_axis_t);
+         ++o) {
+        if (cursor_ptr->axis[o].pending) {
+            dispatch_axis(cursor_ptr, &cursor_ptr->axis[o]);
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Dispatches the accumulated axis event to the toolkit.
+ *
+ * If the discrete values, with what was carried over, complete one or more
+ * steps: Dispatches an event with exactly these steps, followed by one with
+ * the remainder. The remainder is never a whole step, so toolkit elements
+ * act on the first event only, but clients see the same sum of values as
+ * wlroots reported.
+ *
+ * @param cursor_ptr
+ * @param axis_ptr
+ */
+void dispatch_axis(
+    wlmaker_cursor_t *cursor_ptr,
+    wlmaker_cursor_axis_t *axis_ptr)
+{
+    struct wlr_pointer_axis_event event = axis_ptr->event;
+    axis_ptr->pending = false;
+
+    int32_t v120 = event.delta_discrete;
+    // A change of direction starts counting steps anew.
+    if (0 == v120 ||
+        (0 > v120) != (0 > axis_ptr->carry_v120)) axis_ptr->carry_v120 = 0;
+    int32_t total_v120 = axis_ptr->carry_v120 + v120;
+    int32_t steps_v120 = (total_v120 / WLR_POINTER_AXIS_DISCRETE_STEP) *
+        WLR_POINTER_AXIS_DISCRETE_STEP;
+    axis_ptr->carry_v120 = total_v120 - steps_v120;
+
+    if (0 == steps_v120) {
+        wlmtk_root_pointer_axis(cursor_ptr->server_ptr->root_ptr, &event);
+        return;
+    }
+
+    struct wlr_pointer_axis_event remainder = event;
+    event.delta_discrete = steps_v120;
+    event.delta = remainder.delta * steps_v120 / v120;
+    remainder.delta_discrete = v120 - steps_v120;
+    remainder.delta -= event.delta;
+    wlmtk_root_pointer_axis(cursor_ptr->server_ptr->root_ptr, &event);
+    if (0 != remainder.delta_discrete) {
+        wlmtk_root_pointer_axis(
+            cursor_ptr->server_ptr->root_ptr, &remainder);
+    }
+}
+
 /* == End of cursor.c ====================================================== */
@@ -30,13 +30,31 @@ typedef struct _wlmaker_cursor_t wlmaker_cursor_t;
 
 #include "server.h"  // IWYU pragma: keep
 
+struct wlr_cursor_shape_manager_v1;
 struct wlr_input_device;
 struct wlr_output_layout;
+struct wlr_pointer_constraint_v1;
+struct wlr_pointer_constraints_v1;
+struct wlr_pointer_gestures_v1;
+struct wlr_relative_pointer_manager_v1;
 
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
 
+/** Axis events of one orientation, accumulated until the `frame` event. */
+typedef struct {
+    /** Whether `event` holds axis motion not yet dispatched. */
+    bool                      pending;
+    /** The first event, with `delta` and `delta_discrete` summed up. */
+    struct wlr_pointer_axis_event event;
+    /**
+     * Discrete value (1/120 of a detent) already dispatched, but not yet
+     * adding up to a whole step. Has the sign of the recent direction.
+     */
+    int32_t                   carry_v120;
+} wlmaker_cursor_axis_t;
+
 /** State and tools for handling wlmaker cursors. */
 struct _wlmaker_cursor_t {
     /** Back-link to wlmaker_server_t. */
@@ -49,6 +67,8 @@ struct _wlmaker_cursor_t {
 
     /** The toolkit wrapper for above. */
     wlmtk_pointer_t           *pointer_ptr;
+    /** Listener for the `change` event of `wlr_output_layout`. */
+    struct wl_listener        output_layout_change_listener;
 
     /** Listener for the `motion` event of `wlr_cursor`. */
     struct wl_listener        motion_listener;
@@ -63,6 +83,45 @@ struct _wlmaker_cursor_t {
 
     /** Listener for the `request_set_cursor` event of `wlr_seat`. */
     struct wl_listener        seat_request_set_cursor_listener;
+    /** Listener for `focus_change` of `wlr_seat::pointer_state`. */
+    struct wl_listener        seat_pointer_focus_change_listener;
+
+    /** Relative pointer manager: Sends relative motion to clients. */
+    struct wlr_relative_pointer_manager_v1 *wlr_relative_pointer_manager_ptr;
+    /** Pointer constraints: Lets clients lock or confine the pointer. */
+    struct wlr_pointer_constraints_v1 *wlr_pointer_constraints_ptr;
+    /** Listener for `new_constraint` of `wlr_pointer_constraints_v1`. */
+    struct wl_listener        new_constraint_listener;
+    /** The constraint of the surface with pointer focus. May be NULL. */
+    struct wlr_pointer_constraint_v1 *active_constraint_ptr;
+    /** Cursor shape manager: Lets clients pick a cursor by name. */
+    struct wlr_cursor_shape_manager_v1 *wlr_cursor_shape_manager_ptr;
+    /** Listener for `request_set_shape` of `wlr_cursor_shape_manager_v1`. */
+    struct wl_listener        request_set_shape_listener;
+
+    /** Pointer gestures: Forwards the gestures not handled here to clients. */
+    struct wlr_pointer_gestures_v1 *wlr_pointer_gestures_ptr;
+    /** Listener for the `swipe_begin` event of `wlr_cursor`. */
+    struct wl_listener        swipe_begin_listener;
+    /** Listener for the `swipe_update` event of `wlr_cursor`. */
+    struct wl_listener        swipe_update_listener;
+    /** Listener for the `swipe_end` event of `wlr_cursor`. */
+    struct wl_listener        swipe_end_listener;
+    /** Listener for the `pinch_begin` event of `wlr_cursor`. */
+    struct wl_listener        pinch_begin_listener;
+    /** Listener for the `pinch_update` event of `wlr_cursor`. */
+    struct wl_listener        pinch_update_listener;
+    /** Listener for the `pinch_end` event of `wlr_cursor`. */
+    struct wl_listener        pinch_end_listener;
+    /** Listener for the `hold_begin` event of `wlr_cursor`. */
+    struct wl_listener        hold_begin_listener;
+    /** Listener for the `hold_end` event of `wlr_cursor`. */
+    struct wl_listener        hold_end_listener;
+    /**
+     * Whether the current swipe switches workspaces. It is then not sent to
+     * clients. See @ref wlmtk_root_swipe_begin.
+     */
+    bool                      swiping_workspaces;
 
     /**
      * Signals when the cursor's position is updated.
@@ -74,6 +133,32 @@ struct _wlmaker_cursor_t {
      * Offers struct wlr_cursor as argument.
      */
     struct wl_signal          position_updated;
+
+    /**
+     * Whether to coalesce motion events. If set, the cursor image is moved
+     * on each motion event, but the toolkit's motion handling (and the
+     * `position_updated` signal) is deferred until the event loop is idle,
+     * or until a button or axis event needs up-to-date pointer focus.
+     *
+     * Configured through `CoalesceMotion` in the "Pointer" dict.
+     */
+    bool                      coalesce_motion;
+    /** Whether there is motion not yet processed by the toolkit. */
+    bool                      motion_pending;
+    /** Time of the most recent not yet processed motion event. */
+    uint32_t                  pending_time_msec;
+    /** Whether a `frame` is waiting for the pending motion to be sent. */
+    bool                      frame_pending;
+    /** Idle event source for processing the pending motion. */
+    struct wl_event_source    *flush_idle_ptr;
+
+    /**
+     * Axis events, accumulated per orientation until the `frame` event. Then
+     * dispatched to the toolkit as whole steps, plus a remainder. That way,
+     * clients still get all of a high-resolution wheel's fine values, while
+     * toolkit elements act once per detent. See @ref wlmtk_pointer_axis_steps.
+     */
+    wlmaker_cursor_axis_t     axis[2];
 };
 
 /**
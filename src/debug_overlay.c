@@ -0,0 +1,703 @@
+/* ========================================================================= */
+/**
+ * @file debug_overlay.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "debug_overlay.h"
+
+#include <cairo.h>
+#include <inttypes.h>
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <wayland-server-core.h>
+/// Include unstable interfaces of wlroots.
+#define WLR_USE_UNSTABLE
+#include <wlr/interfaces/wlr_buffer.h>
+#include <wlr/types/wlr_output_layout.h>
+#include <wlr/types/wlr_scene.h>
+#include <wlr/util/edges.h>
+#undef WLR_USE_UNSTABLE
+
+#include "backend/backend.h"
+#include "config.h"
+#include "toolkit/toolkit.h"
+
+/* == Declarations ========================================================= */
+
+/** Number of hotspots to show. */
+#define WLMAKER_DEBUG_OVERLAY_HOTSPOTS 8
+
+/** Statistics of the element tree, gathered while drawing it. */
+typedef struct {
+    /** Number of visible elements. */
+    size_t                    elements;
+    /** Number of visible elements that had been drawn into, ie. buffers. */
+    size_t                    buffers;
+    /** Depth of the tree of visible elements. The root is at depth 1. */
+    size_t                    max_depth;
+    /** Sum of @ref wlmtk_element_t::redraws of the visible elements. */
+    uint64_t                  redraws;
+} wlmaker_debug_overlay_tree_stats_t;
+
+/** State of the debug overlay. */
+struct _wlmaker_debug_overlay_t {
+    /** Derived from a toolkit panel. */
+    wlmtk_panel_t             super_panel;
+    /** Original virtual method table of the buffer's super element. */
+    wlmtk_element_vmt_t       orig_buffer_element_vmt;
+    /** Buffer covering the panel. Re-rendered on each refresh. */
+    wlmtk_buffer_t            buffer;
+
+    /** Backlink to the server. */
+    wlmaker_server_t          *server_ptr;
+    /** Font for the overlay's texts. */
+    wlmtk_style_font_t        font;
+
+    /** Listener for `debug_overlay_toggle_event` of `wlmaker_server_t`. */
+    struct wl_listener        toggle_listener;
+    /** Timer for refreshing the overlay while enabled. */
+    struct wl_event_source    *timer_event_source_ptr;
+
+    /** Whether the debug overlay is currently enabled (mapped). */
+    bool                      enabled;
+    /** The output that the overlay was mapped on. */
+    struct wlr_output         *wlr_output_ptr;
+    /** Damage debugging option of the scene, before enabling the overlay. */
+    enum wlr_scene_debug_damage_option orig_debug_damage_option;
+    /** Width of the panel, as last configured through `request_size`. */
+    int                       width;
+    /** Height of the panel, as last configured through `request_size`. */
+    int                       height;
+
+    /** Time of the last refresh, on CLOCK_MONOTONIC, in nanoseconds. */
+    uint64_t                  last_refresh_nsec;
+    /** Output statistics at the last refresh. */
+    wlmbe_output_stats_t      last_output_stats;
+    /** Sum of the redraws at the last refresh. */
+    uint64_t                  last_redraws;
+};
+
+/** Arguments for @ref _wlmaker_debug_overlay_find_output. */
+typedef struct {
+    /** The output to look for. */
+    struct wlr_output         *wlr_output_ptr;
+    /** The backend output, if found. */
+    wlmbe_output_t            *output_ptr;
+} wlmaker_debug_overlay_find_output_arg_t;
+
+static void _wlmaker_debug_overlay_refresh(
+    wlmaker_debug_overlay_t *debug_overlay_ptr);
+static void _wlmaker_debug_overlay_draw_tree(
+    cairo_t *cairo_ptr,
+    const wlmtk_style_font_t *font_ptr,
+    wlmtk_element_t *element_ptr,
+    wlmtk_element_t *skip_element_ptr,
+    int x,
+    int y,
+    size_t depth,
+    wlmaker_debug_overlay_tree_stats_t *stats_ptr);
+static void _wlmaker_debug_overlay_draw_stats(
+    wlmaker_debug_overlay_t *debug_overlay_ptr,
+    cairo_t *cairo_ptr,
+    const wlmaker_debug_overlay_tree_stats_t *tree_stats_ptr,
+    uint64_t now_nsec);
+static const wlmbe_output_stats_t *_wlmaker_debug_overlay_output_stats(
+    wlmaker_debug_overlay_t *debug_overlay_ptr);
+static void _wlmaker_debug_overlay_find_output(
+    wlmbe_output_t *output_ptr,
+    void *ud_ptr);
+static void _wlmaker_debug_overlay_enable(
+    wlmaker_debug_overlay_t *debug_overlay_ptr);
+static void _wlmaker_debug_overlay_disable(
+    wlmaker_debug_overlay_t *debug_overlay_ptr);
+static uint64_t _wlmaker_debug_overlay_now_nsec(void);
+
+static uint32_t _wlmaker_debug_overlay_request_size(
+    wlmtk_panel_t *panel_ptr,
+    int width,
+    int height);
+static void _wlmaker_debug_overlay_buffer_get_pointer_area(
+    wlmtk_element_t *element_ptr,
+    int *left_ptr,
+    int *top_ptr,
+    int *right_ptr,
+    int *bottom_ptr);
+
+static void _wlmaker_debug_overlay_handle_toggle(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static int _wlmaker_debug_overlay_handle_timer(void *data_ptr);
+
+/* == Data ================================================================= */
+
+/** Debug overlay positioning: Covers the full output, ignores panels. */
+static const wlmtk_panel_positioning_t _wlmaker_debug_overlay_positioning = {
+    .anchor = WLR_EDGE_BOTTOM | WLR_EDGE_TOP | WLR_EDGE_LEFT | WLR_EDGE_RIGHT,
+    .exclusive_zone = -1
+};
+
+/** Virtual method table for the debug overlay. */
+static const wlmtk_panel_vmt_t _wlmaker_debug_overlay_vmt = {
+    .request_size = _wlmaker_debug_overlay_request_size
+};
+
+/** Extensions to the buffer's element: Does not take pointer input. */
+static const wlmtk_element_vmt_t _wlmaker_debug_overlay_buffer_element_vmt = {
+    .get_pointer_area = _wlmaker_debug_overlay_buffer_get_pointer_area
+};
+
+/** Interval between refreshes, in milliseconds. */
+static const int _wlmaker_debug_overlay_refresh_msec = 500;
+/** Size of the overlay's font. */
+static const uint64_t _wlmaker_debug_overlay_font_size = 11;
+/** Height of a line of the statistics text. */
+static const int _wlmaker_debug_overlay_line_height = 14;
+/** Width of the box behind the statistics text. */
+static const int _wlmaker_debug_overlay_stats_width = 420;
+
+/** Colors of the bounding boxes, by tree depth. ARGB 8888. */
+static const uint32_t _wlmaker_debug_overlay_colors[] = {
+    0xc0ff4040, 0xc040ff40, 0xc04080ff, 0xc0ffff40, 0xc0ff40ff, 0xc040ffff
+};
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmaker_debug_overlay_t *wlmaker_debug_overlay_create(
+    wlmaker_server_t *server_ptr,
+    const wlmaker_config_style_t *style_ptr)
+{
+    wlmaker_debug_overlay_t *debug_overlay_ptr = logged_calloc(
+        1, sizeof(wlmaker_debug_overlay_t));
+    if (NULL == debug_overlay_ptr) return NULL;
+    debug_overlay_ptr->server_ptr = server_ptr;
+    debug_overlay_ptr->font = style_ptr->task_list.font;
+    debug_overlay_ptr->font.weight = WLMTK_FONT_WEIGHT_NORMAL;
+    debug_overlay_ptr->font.size = _wlmaker_debug_overlay_font_size;
+
+    if (!wlmtk_panel_init(&debug_overlay_ptr->super_panel,
+                          &_wlmaker_debug_overlay_positioning)) {
+        wlmaker_debug_overlay_destroy(debug_overlay_ptr);
+        return NULL;
+    }
+    wlmtk_panel_extend(&debug_overlay_ptr->super_panel,
+                       &_wlmaker_debug_overlay_vmt);
+    wlmtk_element_set_visible(
+        wlmtk_panel_element(&debug_overlay_ptr->super_panel), true);
+
+    if (!wlmtk_buffer_init(&debug_overlay_ptr->buffer)) {
+        wlmaker_debug_overlay_destroy(debug_overlay_ptr);
+        return NULL;
+    }
+    debug_overlay_ptr->orig_buffer_element_vmt = wlmtk_element_extend(
+        wlmtk_buffer_element(&debug_overlay_ptr->buffer),
+        &_wlmaker_debug_overlay_buffer_element_vmt);
+    wlmtk_element_set_visible(
+        wlmtk_buffer_element(&debug_overlay_ptr->buffer), true);
+    wlmtk_container_add_element(
+        &debug_overlay_ptr->super_panel.super_container,
+        wlmtk_buffer_element(&debug_overlay_ptr->buffer));
+
+    debug_overlay_ptr->timer_event_source_ptr = wl_event_loop_add_timer(
+        wl_display_get_event_loop(server_ptr->wl_display_ptr),
+        _wlmaker_debug_overlay_handle_timer,
+        debug_overlay_ptr);
+    if (NULL == debug_overlay_ptr->timer_event_source_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_timer(%p, %p, %p)",
+               wl_display_get_event_loop(server_ptr->wl_display_ptr),
+               _wlmaker_debug_overlay_handle_timer,
+               debug_overlay_ptr);
+        wlmaker_debug_overlay_destroy(debug_overlay_ptr);
+        return NULL;
+    }
+
+    wlmtk_util_connect_listener_signal(
+        &server_ptr->debug_overlay_toggle_event,
+        &debug_overlay_ptr->toggle_listener,
+        _wlmaker_debug_overlay_handle_toggle);
+    return debug_overlay_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_debug_overlay_destroy(
+    wlmaker_debug_overlay_t *debug_overlay_ptr)
+{
+    wlmtk_util_disconnect_listener(&debug_overlay_ptr->toggle_listener);
+    if (debug_overlay_ptr->enabled) {
+        _wlmaker_debug_overlay_disable(debug_overlay_ptr);
+    }
+    if (NULL != debug_overlay_ptr->timer_event_source_ptr) {
+        wl_event_source_remove(debug_overlay_ptr->timer_event_source_ptr);
+        debug_overlay_ptr->timer_event_source_ptr = NULL;
+    }
+
+    wlmtk_element_t *element_ptr = wlmtk_buffer_element(
+        &debug_overlay_ptr->buffer);
+    if (NULL != element_ptr->parent_container_ptr) {
+        wlmtk_container_remove_element(
+            &debug_overlay_ptr->super_panel.super_container, element_ptr);
+    }
+    wlmtk_buffer_fini(&debug_overlay_ptr->buffer);
+    wlmtk_panel_fini(&debug_overlay_ptr->super_panel);
+
+    free(debug_overlay_ptr);
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Re-renders the overlay: Bounding boxes of the element tree, and the
+ * statistics text.
+ *
+ * @param debug_overlay_ptr
+ */
+void _wlmaker_debug_overlay_refresh(
+    wlmaker_debug_overlay_t *debug_overlay_ptr)
+{
+    if (0 >= debug_overlay_ptr->width || 0 >= debug_overlay_ptr->height) {
+        return;
+    }
+
+    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
+        debug_overlay_ptr->width, debug_overlay_ptr->height);
+    if (NULL == wlr_buffer_ptr) return;
+    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
+    if (NULL == cairo_ptr) {
+        wlr_buffer_drop(wlr_buffer_ptr);
+        return;
+    }
+
+    // Element positions are in layout coordinates. Draw relative to the
+    // output that the overlay covers.
+    struct wlr_box output_box = {};
+    wlr_output_layout_get_box(
+        debug_overlay_ptr->server_ptr->wlr_output_layout_ptr,
+        debug_overlay_ptr->wlr_output_ptr,
+        &output_box);
+
+    wlmaker_debug_overlay_tree_stats_t tree_stats = {};
+    cairo_set_line_width(cairo_ptr, 1.0);
+    _wlmaker_debug_overlay_draw_tree(
+        cairo_ptr,
+        &debug_overlay_ptr->font,
+        wlmtk_root_element(debug_overlay_ptr->server_ptr->root_ptr),
+        wlmtk_panel_element(&debug_overlay_ptr->super_panel),
+        -output_box.x, -output_box.y, 1, &tree_stats);
+
+    uint64_t now_nsec = _wlmaker_debug_overlay_now_nsec();
+    _wlmaker_debug_overlay_draw_stats(
+        debug_overlay_ptr, cairo_ptr, &tree_stats, now_nsec);
+    cairo_destroy(cairo_ptr);
+
+    wlmtk_buffer_set(&debug_overlay_ptr->buffer, wlr_buffer_ptr);
+    wlr_buffer_drop(wlr_buffer_ptr);
+    debug_overlay_ptr->last_refresh_nsec = now_nsec;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Draws the bounding boxes of `element_ptr` and its visible descendants,
+ * and gathers statistics over them.
+ *
+ * @param cairo_ptr           Cairo to draw into, or NULL to only gather the
+ *                            statistics.
+ * @param font_ptr
+ * @param element_ptr
+ * @param skip_element_ptr    An element to skip, along with descendants:
+ *                            The overlay itself.
+ * @param x                   Position of `element_ptr`'s parent, in the
+ *                            coordinates of `cairo_ptr`.
+ * @param y
+ * @param depth               Depth of `element_ptr`. The root is at 1.
+ * @param stats_ptr           Statistics to update.
+ */
+void _wlmaker_debug_overlay_draw_tree(
+    cairo_t *cairo_ptr,
+    const wlmtk_style_font_t *font_ptr,
+    wlmtk_element_t *element_ptr,
+    wlmtk_element_t *skip_element_ptr,
+    int x,
+    int y,
+    size_t depth,
+    wlmaker_debug_overlay_tree_stats_t *stats_ptr)
+{
+    if (element_ptr == skip_element_ptr || !element_ptr->visible) return;
+
+    int pos_x, pos_y;
+    wlmtk_element_get_position(element_ptr, &pos_x, &pos_y);
+    x += pos_x;
+    y += pos_y;
+
+    stats_ptr->elements++;
+    stats_ptr->max_depth = BS_MAX(stats_ptr->max_depth, depth);
+    if (0 < element_ptr->redraws) {
+        stats_ptr->buffers++;
+        stats_ptr->redraws += element_ptr->redraws;
+    }
+
+    if (NULL != cairo_ptr) {
+        struct wlr_box box = wlmtk_element_get_dimensions_box(element_ptr);
+        uint32_t color = _wlmaker_debug_overlay_colors[
+            (depth - 1) % (sizeof(_wlmaker_debug_overlay_colors) /
+                           sizeof(_wlmaker_debug_overlay_colors[0]))];
+        cairo_set_source_argb8888(cairo_ptr, color);
+        cairo_rectangle(cairo_ptr,
+                        x + box.x + 0.5, y + box.y + 0.5,
+                        BS_MAX(box.width - 1, 0),
+                        BS_MAX(box.height - 1, 0));
+        cairo_stroke(cairo_ptr);
+
+        if (0 < element_ptr->redraws &&
+            2 * _wlmaker_debug_overlay_line_height <= box.height) {
+            char label[24];
+            snprintf(label, sizeof(label), "%"PRIu64, element_ptr->redraws);
+            wlmaker_primitives_draw_text(
+                cairo_ptr, x + box.x + 2,
+                y + box.y + _wlmaker_debug_overlay_line_height - 3,
+                font_ptr, color | 0xff000000, label);
+        }
+    }
+
+    wlmtk_container_t *container_ptr = wlmtk_container_from_element(
+        element_ptr);
+    if (NULL == container_ptr) return;
+    for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        _wlmaker_debug_overlay_draw_tree(
+            cairo_ptr, font_ptr, wlmtk_element_from_dlnode(dlnode_ptr),
+            skip_element_ptr, x, y, depth + 1, stats_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Draws the statistics text into the top-left corner: Tree statistics,
+ * frame time of the output, and the trace hotspots since the last refresh.
+ *
+ * Updates @ref wlmaker_debug_overlay_t::last_output_stats and
+ * @ref wlmaker_debug_overlay_t::last_redraws.
+ *
+ * @param debug_overlay_ptr
+ * @param cairo_ptr
+ * @param tree_stats_ptr
+ * @param now_nsec
+ */
+void _wlmaker_debug_overlay_draw_stats(
+    wlmaker_debug_overlay_t *debug_overlay_ptr,
+    cairo_t *cairo_ptr,
+    const wlmaker_debug_overlay_tree_stats_t *tree_stats_ptr,
+    uint64_t now_nsec)
+{
+    char lines[4 + WLMAKER_DEBUG_OVERLAY_HOTSPOTS][128];
+    size_t n = 0;
+
+    snprintf(lines[n++], sizeof(lines[0]),
+             "Elements: %zu, buffers: %zu, depth: %zu, "
+             "redraws: %"PRIu64" (+%"PRIu64")",
+             tree_stats_ptr->elements, tree_stats_ptr->buffers,
+             tree_stats_ptr->max_depth, tree_stats_ptr->redraws,
+             tree_stats_ptr->redraws - BS_MIN(
+                 tree_stats_ptr->redraws, debug_overlay_ptr->last_redraws));
+    debug_overlay_ptr->last_redraws = tree_stats_ptr->redraws;
+
+    const wlmbe_output_stats_t *stats_ptr =
+        _wlmaker_debug_overlay_output_stats(debug_overlay_ptr);
+    if (NULL != stats_ptr) {
+        const wlmbe_output_stats_t *last_ptr =
+            &debug_overlay_ptr->last_output_stats;
+        uint64_t commits = stats_ptr->commits - last_ptr->commits;
+        uint64_t interval_nsec =
+            now_nsec - debug_overlay_ptr->last_refresh_nsec;
+        double fps = 0 < interval_nsec ? commits * 1e9 / interval_nsec : 0;
+        double commit_msec = 0 < commits ?
+            (stats_ptr->commit_nsec_sum - last_ptr->commit_nsec_sum) /
+            1e6 / commits : 0;
+        uint64_t damage_px = 0 < commits ?
+            (stats_ptr->damage_px_sum - last_ptr->damage_px_sum) /
+            commits : 0;
+        snprintf(lines[n++], sizeof(lines[0]),
+                 "Frame: %.1f fps, commit %.3f ms (max %.3f ms), "
+                 "damage %"PRIu64" px",
+                 fps, commit_msec, stats_ptr->commit_nsec_max / 1e6,
+                 damage_px);
+        debug_overlay_ptr->last_output_stats = *stats_ptr;
+    }
+
+    wlmtk_trace_hotspot_t hotspots[WLMAKER_DEBUG_OVERLAY_HOTSPOTS];
+    size_t hotspots_size = wlmtk_trace_get_hotspots(
+        debug_overlay_ptr->last_refresh_nsec,
+        hotspots, WLMAKER_DEBUG_OVERLAY_HOTSPOTS);
+    snprintf(lines[n++], sizeof(lines[0]), "Hotspots (%zu):", hotspots_size);
+    for (size_t i = 0; i < hotspots_size; ++i) {
+        snprintf(lines[n++], sizeof(lines[0]),
+                 "  %-32s %6"PRIu64"x %9.3f ms (max %.3f ms)",
+                 hotspots[i].name_ptr, hotspots[i].count,
+                 hotspots[i].total_nsec / 1e6, hotspots[i].max_nsec / 1e6);
+    }
+
+    cairo_set_source_argb8888(cairo_ptr, 0xc0000000);
+    cairo_rectangle(cairo_ptr, 0, 0, _wlmaker_debug_overlay_stats_width,
+                    (n + 1) * _wlmaker_debug_overlay_line_height);
+    cairo_fill(cairo_ptr);
+    for (size_t i = 0; i < n; ++i) {
+        wlmaker_primitives_draw_text(
+            cairo_ptr, 6, (i + 1) * _wlmaker_debug_overlay_line_height,
+            &debug_overlay_ptr->font, 0xffffffff, lines[i]);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Statistics of the overlay's output, or NULL if not found. */
+const wlmbe_output_stats_t *_wlmaker_debug_overlay_output_stats(
+    wlmaker_debug_overlay_t *debug_overlay_ptr)
+{
+    wlmaker_debug_overlay_find_output_arg_t arg = {
+        .wlr_output_ptr = debug_overlay_ptr->wlr_output_ptr
+    };
+    wlmbe_backend_for_each_output(
+        debug_overlay_ptr->server_ptr->backend_ptr,
+        _wlmaker_debug_overlay_find_output,
+        &arg);
+    if (NULL == arg.output_ptr) return NULL;
+    return wlmbe_output_get_stats(arg.output_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Callback for @ref wlmbe_backend_for_each_output: Matches the output. */
+void _wlmaker_debug_overlay_find_output(
+    wlmbe_output_t *output_ptr,
+    void *ud_ptr)
+{
+    wlmaker_debug_overlay_find_output_arg_t *arg_ptr = ud_ptr;
+    if (wlmbe_wlr_output_from_output(output_ptr) == arg_ptr->wlr_output_ptr) {
+        arg_ptr->output_ptr = output_ptr;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Enables the overlay: Maps it on the output at the cursor, turns on damage
+ * highlighting of the scene, and arms the refresh timer.
+ *
+ * @param debug_overlay_ptr
+ */
+void _wlmaker_debug_overlay_enable(
+    wlmaker_debug_overlay_t *debug_overlay_ptr)
+{
+    wlmaker_server_t *server_ptr = debug_overlay_ptr->server_ptr;
+    wlmtk_workspace_t *workspace_ptr =
+        wlmtk_root_get_current_workspace(server_ptr->root_ptr);
+    if (NULL == workspace_ptr) return;
+    debug_overlay_ptr->wlr_output_ptr =
+        wlmaker_server_get_output_at_cursor(server_ptr);
+    if (NULL == debug_overlay_ptr->wlr_output_ptr) return;
+
+    // Baseline for the per-refresh deltas.
+    const wlmbe_output_stats_t *stats_ptr =
+        _wlmaker_debug_overlay_output_stats(debug_overlay_ptr);
+    if (NULL != stats_ptr) debug_overlay_ptr->last_output_stats = *stats_ptr;
+    debug_overlay_ptr->last_refresh_nsec = _wlmaker_debug_overlay_now_nsec();
+    debug_overlay_ptr->last_redraws = 0;
+
+    if (!wlmtk_layer_add_panel(
+            wlmtk_workspace_get_layer(
+                workspace_ptr, WLMTK_WORKSPACE_LAYER_OVERLAY),
+            &debug_overlay_ptr->super_panel,
+            debug_overlay_ptr->wlr_output_ptr)) return;
+    debug_overlay_ptr->enabled = true;
+
+    debug_overlay_ptr->orig_debug_damage_option =
+        server_ptr->wlr_scene_ptr->debug_damage_option;
+    server_ptr->wlr_scene_ptr->debug_damage_option =
+        WLR_SCENE_DEBUG_DAMAGE_HIGHLIGHT;
+    wl_event_source_timer_update(
+        debug_overlay_ptr->timer_event_source_ptr,
+        _wlmaker_debug_overlay_refresh_msec);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Disables the overlay: Unmaps it, restores the scene's damage debugging
+ * option and disarms the timer.
+ *
+ * @param debug_overlay_ptr
+ */
+void _wlmaker_debug_overlay_disable(
+    wlmaker_debug_overlay_t *debug_overlay_ptr)
+{
+    wl_event_source_timer_update(debug_overlay_ptr->timer_event_source_ptr, 0);
+    debug_overlay_ptr->server_ptr->wlr_scene_ptr->debug_damage_option =
+        debug_overlay_ptr->orig_debug_damage_option;
+
+    wlmtk_layer_t *layer_ptr = wlmtk_panel_get_layer(
+        &debug_overlay_ptr->super_panel);
+    if (NULL != layer_ptr) {
+        wlmtk_layer_remove_panel(layer_ptr, &debug_overlay_ptr->super_panel);
+    }
+    debug_overlay_ptr->enabled = false;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return The current time of CLOCK_MONOTONIC, in nanoseconds. */
+uint64_t _wlmaker_debug_overlay_now_nsec(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + now.tv_nsec;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_panel_vmt_t::request_size. Accepts the size, and
+ * re-renders the overlay to cover it.
+ *
+ * @param panel_ptr
+ * @param width
+ * @param height
+ *
+ * @return 0 always.
+ */
+uint32_t _wlmaker_debug_overlay_request_size(
+    wlmtk_panel_t *panel_ptr,
+    int width,
+    int height)
+{
+    wlmaker_debug_overlay_t *debug_overlay_ptr = BS_CONTAINER_OF(
+        panel_ptr, wlmaker_debug_overlay_t, super_panel);
+    debug_overlay_ptr->width = width;
+    debug_overlay_ptr->height = height;
+    wlmtk_panel_commit(panel_ptr, 0, &_wlmaker_debug_overlay_positioning);
+    _wlmaker_debug_overlay_refresh(debug_overlay_ptr);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Extends @ref wlmtk_element_vmt_t::get_pointer_area of the buffer: Reports
+ * an empty area, so that pointer input passes through the overlay.
+ *
+ * @param element_ptr
+ * @param left_ptr
+ * @param top_ptr
+ * @param right_ptr
+ * @param bottom_ptr
+ */
+void _wlmaker_debug_overlay_buffer_get_pointer_area(
+    __UNUSED__ wlmtk_element_t *element_ptr,
+    int *left_ptr,
+    int *top_ptr,
+    int *right_ptr,
+    int *bottom_ptr)
+{
+    if (NULL != left_ptr) *left_ptr = 0;
+    if (NULL != top_ptr) *top_ptr = 0;
+    if (NULL != right_ptr) *right_ptr = 0;
+    if (NULL != bottom_ptr) *bottom_ptr = 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles `debug_overlay_toggle_event`: Enables or disables the overlay. */
+void _wlmaker_debug_overlay_handle_toggle(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmaker_debug_overlay_t *debug_overlay_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_debug_overlay_t, toggle_listener);
+    if (debug_overlay_ptr->enabled) {
+        _wlmaker_debug_overlay_disable(debug_overlay_ptr);
+    } else {
+        _wlmaker_debug_overlay_enable(debug_overlay_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Timer callback: Refreshes the overlay, and re-arms the timer. */
+int _wlmaker_debug_overlay_handle_timer(void *data_ptr)
+{
+    wlmaker_debug_overlay_t *debug_overlay_ptr = data_ptr;
+    if (!debug_overlay_ptr->enabled) return 0;
+
+    _wlmaker_debug_overlay_refresh(debug_overlay_ptr);
+    wl_event_source_timer_update(
+        debug_overlay_ptr->timer_event_source_ptr,
+        _wlmaker_debug_overlay_refresh_msec);
+    return 0;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_tree_stats(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_debug_overlay_test_cases[] = {
+    { 1, "tree_stats", test_tree_stats },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Tests the statistics gathered over an element tree. */
+void test_tree_stats(bs_test_t *test_ptr)
+{
+    wlmtk_container_t root, c;
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, wlmtk_container_init(&root));
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, wlmtk_container_init(&c));
+    wlmtk_element_set_visible(&root.super_element, true);
+    wlmtk_element_set_visible(&c.super_element, true);
+    wlmtk_container_add_element(&root, &c.super_element);
+
+    wlmtk_fake_element_t *fe1_ptr = wlmtk_fake_element_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fe1_ptr);
+    wlmtk_element_set_visible(&fe1_ptr->element, true);
+    fe1_ptr->element.redraws = 3;
+    wlmtk_container_add_element(&c, &fe1_ptr->element);
+    wlmtk_fake_element_t *fe2_ptr = wlmtk_fake_element_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fe2_ptr);
+    wlmtk_element_set_visible(&fe2_ptr->element, true);
+    wlmtk_container_add_element(&root, &fe2_ptr->element);
+
+    wlmaker_debug_overlay_tree_stats_t stats = {};
+    _wlmaker_debug_overlay_draw_tree(
+        NULL, NULL, &root.super_element, NULL, 0, 0, 1, &stats);
+    BS_TEST_VERIFY_EQ(test_ptr, 4, stats.elements);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats.buffers);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, stats.max_depth);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, stats.redraws);
+
+    // Skipped and invisible elements are not counted, nor are descendants.
+    wlmtk_element_set_visible(&fe2_ptr->element, false);
+    stats = (wlmaker_debug_overlay_tree_stats_t){};
+    _wlmaker_debug_overlay_draw_tree(
+        NULL, NULL, &root.super_element, &c.super_element, 0, 0, 1, &stats);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats.elements);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, stats.buffers);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats.max_depth);
+
+    wlmtk_container_remove_element(&root, &fe2_ptr->element);
+    wlmtk_element_destroy(&fe2_ptr->element);
+    wlmtk_container_remove_element(&c, &fe1_ptr->element);
+    wlmtk_element_destroy(&fe1_ptr->element);
+    wlmtk_container_remove_element(&root, &c.super_element);
+    wlmtk_container_fini(&c);
+    wlmtk_container_fini(&root);
+}
+
+/* == End of debug_overlay.c =============================================== */
@@ -0,0 +1,80 @@
+/* ========================================================================= */
+/**
+ * @file debug_overlay.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __DEBUG_OVERLAY_H__
+#define __DEBUG_OVERLAY_H__
+
+#include <libbase/libbase.h>
+
+/** Forward definition: Debug overlay handle. */
+typedef struct _wlmaker_debug_overlay_t wlmaker_debug_overlay_t;
+
+#include "config.h"
+#include "server.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Creates the debug overlay for the server.
+ *
+ * The overlay is toggled through `debug_overlay_toggle_event` of the
+ * `wlmaker_server_t`. While shown, it covers the output at the cursor, on
+ * the overlay layer, and is refreshed periodically. It draws:
+ *
+ * - the bounding box of each visible element, colored by tree depth, and
+ *   the redraw counter of each buffer;
+ * - the number of elements and buffers, and the depth of the element tree;
+ * - frame time and damaged area per frame, of the output;
+ * - the spans that took the longest total time since the last refresh,
+ *   as recorded through @ref WLMTK_TRACE_SPAN.
+ *
+ * Damaged regions are highlighted by the scene graph, per frame.
+ *
+ * The overlay does not take pointer input.
+ *
+ * @param server_ptr
+ * @param style_ptr
+ *
+ * @return The debug overlay handle or NULL on error. Must be released by
+ *     calling @ref wlmaker_debug_overlay_destroy.
+ */
+wlmaker_debug_overlay_t *wlmaker_debug_overlay_create(
+    wlmaker_server_t *server_ptr,
+    const wlmaker_config_style_t *style_ptr);
+
+/**
+ * Destroys the debug overlay, as created by
+ * @ref wlmaker_debug_overlay_create.
+ *
+ * @param debug_overlay_ptr
+ */
+void wlmaker_debug_overlay_destroy(
+    wlmaker_debug_overlay_t *debug_overlay_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_debug_overlay_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __DEBUG_OVERLAY_H__ */
+/* == End of debug_overlay.h =============================================== */
@@ -18,12 +18,19 @@
  * limitations under the License.
  */
 
+/// mkdtemp() is a POSIX extension.
+#define _POSIX_C_SOURCE 200809L
+
 #include "dock.h"
 
 #include <libbase/libbase.h>
 #include <libbase/plist.h>
+#include <limits.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include <wayland-server-core.h>
 #include <wayland-util.h>
 #define WLR_USE_UNSTABLE
@@ -38,6 +45,7 @@
 #include "config.h"
 #include "default_state.h"
 #include "launcher.h"
+#include "state_writer.h"
 #include "toolkit/toolkit.h"
 
 /* == Declarations ========================================================= */
@@ -55,10 +63,27 @@ struct _wlmaker_dock_t {
 
     /** Listener for @ref wlmtk_root_events_t::workspace_changed. */
     struct wl_listener        workspace_changed_listener;
-    /** Listener for wlr_output_layout::events.change. */
+    /** Listener for layout epochs, see @ref wlmtk_layout_epoch_connect. */
     struct wl_listener        output_layout_change_listener;
+    /** Listener for @ref wlmtk_dock_events_t::tile_moved. */
+    struct wl_listener        tile_moved_listener;
+
+    /** The state, as of the most recent re-ordering of the launchers. */
+    bspl_dict_t               *state_dict_ptr;
+    /** Plist dicts of the launchers, in the order of the state's array. */
+    bspl_array_t              *launchers_array_ptr;
+    /** Whether the tiles are in reverse order of the launchers array. */
+    bool                      reversed;
 };
 
+/** Argument to @ref _wlmaker_dock_copy_item. */
+typedef struct {
+    /** The dict to copy to. */
+    bspl_dict_t               *dict_ptr;
+    /** Key of the item to not copy. */
+    const char                *skip_key_ptr;
+} _wlmaker_dock_copy_arg_t;
+
 static bool _wlmaker_dock_decode_launchers(
     bspl_object_t *object_ptr,
     void *dest_ptr);
@@ -69,6 +94,18 @@ static void _wlmaker_dock_handle_workspace_changed(
 static void _wlmaker_dock_handle_output_layout_change(
     struct wl_listener *listener_ptr,
     void *data_ptr);
+static void _wlmaker_dock_handle_tile_moved(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+
+static bspl_dict_t *_wlmaker_dock_replace_item(
+    bspl_dict_t *dict_ptr,
+    const char *key_ptr,
+    bspl_object_t *object_ptr);
+static bool _wlmaker_dock_copy_item(
+    const char *key_ptr,
+    bspl_object_t *object_ptr,
+    void *userdata_ptr);
 
 /* == Data ================================================================= */
 
@@ -125,6 +162,10 @@ wlmaker_dock_t *wlmaker_dock_create(
         return NULL;
     }
     bspl_decode_dict(dict_ptr, _wlmaker_dock_desc, &args);
+    dock_ptr->launchers_array_ptr = args.launchers_array_ptr;
+    dock_ptr->state_dict_ptr = bspl_dict_ref(state_dict_ptr);
+    dock_ptr->reversed = WLR_EDGE_TOP != args.positioning.anchor &&
+        WLR_EDGE_LEFT != args.positioning.anchor;
     bspl_dict_t *output_dict_ptr = bspl_dict_get_dict(dict_ptr, "Output");
     if (NULL != output_dict_ptr) {
         if (!wlmbe_output_description_init_from_plist(
@@ -164,10 +205,10 @@ wlmaker_dock_t *wlmaker_dock_create(
     }
 
     for (size_t i = 0;
-         i < bspl_array_size(args.launchers_array_ptr);
+         i < bspl_array_size(dock_ptr->launchers_array_ptr);
          ++i) {
         bspl_dict_t *dict_ptr = bspl_dict_from_object(
-            bspl_array_at(args.launchers_array_ptr, i));
+            bspl_array_at(dock_ptr->launchers_array_ptr, i));
         if (NULL == dict_ptr) {
             bs_log(BS_ERROR, "Elements of 'Launchers' must be dicts.");
             wlmaker_dock_destroy(dock_ptr);
@@ -184,25 +225,23 @@ wlmaker_dock_t *wlmaker_dock_create(
             dock_ptr->wlmtk_dock_ptr,
             wlmaker_launcher_tile(launcher_ptr));
     }
-    // FIXME: This is leaky.
-    if (NULL != args.launchers_array_ptr) {
-        bspl_array_unref(args.launchers_array_ptr);
-        args.launchers_array_ptr = NULL;
-    }
 
     wlmtk_util_connect_listener_signal(
         &wlmtk_root_events(server_ptr->root_ptr)->workspace_changed,
         &dock_ptr->workspace_changed_listener,
         _wlmaker_dock_handle_workspace_changed);
 
-    // TODO(kaeser@gubbe.ch): This is a very hacky way of updating the output
-    // before the layer's handler removes all associated panels. Should be
-    // a native method of wlmtk_dock_t or wlmtk_panel_t.
-    dock_ptr->output_layout_change_listener.notify =
-        _wlmaker_dock_handle_output_layout_change;
-    wl_list_insert(
-        server_ptr->wlr_output_layout_ptr->events.change.listener_list.next,
-        &dock_ptr->output_layout_change_listener.link);
+    // Moves the panel to its new output before the layer's handler removes
+    // all panels associated with a removed output.
+    wlmtk_layout_epoch_connect(
+        server_ptr->wlr_output_layout_ptr,
+        WLMTK_LAYOUT_EPOCH_STAGE_PANELS,
+        &dock_ptr->output_layout_change_listener,
+        _wlmaker_dock_handle_output_layout_change);
+    wlmtk_util_connect_listener_signal(
+        &wlmtk_dock_events(dock_ptr->wlmtk_dock_ptr)->tile_moved,
+        &dock_ptr->tile_moved_listener,
+        _wlmaker_dock_handle_tile_moved);
 
     bs_log(BS_INFO, "Created dock %p", dock_ptr);
     return dock_ptr;
@@ -211,6 +250,7 @@ wlmaker_dock_t *wlmaker_dock_create(
 /* ------------------------------------------------------------------------- */
 void wlmaker_dock_destroy(wlmaker_dock_t *dock_ptr)
 {
+    wlmtk_util_disconnect_listener(&dock_ptr->tile_moved_listener);
     wlmtk_util_disconnect_listener(&dock_ptr->output_layout_change_listener);
     wlmtk_util_disconnect_listener(&dock_ptr->workspace_changed_listener);
 
@@ -226,6 +266,14 @@ void wlmaker_dock_destroy(wlmaker_dock_t *dock_ptr)
         dock_ptr->wlmtk_dock_ptr = NULL;
     }
 
+    if (NULL != dock_ptr->launchers_array_ptr) {
+        bspl_array_unref(dock_ptr->launchers_array_ptr);
+        dock_ptr->launchers_array_ptr = NULL;
+    }
+    if (NULL != dock_ptr->state_dict_ptr) {
+        bspl_dict_unref(dock_ptr->state_dict_ptr);
+        dock_ptr->state_dict_ptr = NULL;
+    }
     wlmbe_output_description_fini(&dock_ptr->output_description);
     free(dock_ptr);
 }
@@ -301,12 +349,139 @@ void _wlmaker_dock_handle_output_layout_change(
     }
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles @ref wlmtk_dock_events_t::tile_moved: Re-orders the launchers in
+ * the state, and has the state file updated.
+ *
+ * @param listener_ptr
+ * @param data_ptr            Points to @ref wlmtk_dock_tile_moved_event_t.
+ */
+void _wlmaker_dock_handle_tile_moved(
+    struct wl_listener *listener_ptr,
+    void *data_ptr)
+{
+    wlmaker_dock_t *dock_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_dock_t, tile_moved_listener);
+    wlmtk_dock_tile_moved_event_t *event_ptr = data_ptr;
+
+    size_t n = bspl_array_size(dock_ptr->launchers_array_ptr);
+    if (event_ptr->from >= n || event_ptr->to >= n) {
+        bs_log(BS_WARNING, "Dock %p: Tile moved from %zu to %zu, beyond the "
+               "%zu launchers.", dock_ptr, event_ptr->from, event_ptr->to, n);
+        return;
+    }
+    size_t from = event_ptr->from, to = event_ptr->to;
+    if (dock_ptr->reversed) {
+        from = n - 1 - from;
+        to = n - 1 - to;
+    }
+
+    bspl_array_t *array_ptr = bspl_array_create();
+    if (NULL == array_ptr) return;
+    for (size_t i = 0, src = 0; i < n; ++i) {
+        size_t index = from;
+        if (i != to) {
+            if (src == from) ++src;
+            index = src++;
+        }
+        if (!bspl_array_push_back(
+                array_ptr,
+                bspl_array_at(dock_ptr->launchers_array_ptr, index))) {
+            bspl_array_unref(array_ptr);
+            return;
+        }
+    }
+
+    bspl_dict_t *dict_ptr = _wlmaker_dock_replace_item(
+        bspl_dict_get_dict(dock_ptr->state_dict_ptr, "Dock"),
+        "Launchers",
+        bspl_object_from_array(array_ptr));
+    bspl_dict_t *state_dict_ptr = NULL;
+    if (NULL != dict_ptr) {
+        state_dict_ptr = _wlmaker_dock_replace_item(
+            dock_ptr->state_dict_ptr, "Dock", bspl_object_from_dict(dict_ptr));
+        bspl_dict_unref(dict_ptr);
+    }
+    if (NULL == state_dict_ptr) {
+        bs_log(BS_WARNING, "Dock %p: Failed to update the state.", dock_ptr);
+        bspl_array_unref(array_ptr);
+        return;
+    }
+
+    bspl_array_unref(dock_ptr->launchers_array_ptr);
+    dock_ptr->launchers_array_ptr = array_ptr;
+    bspl_dict_unref(dock_ptr->state_dict_ptr);
+    dock_ptr->state_dict_ptr = state_dict_ptr;
+
+    if (NULL != dock_ptr->server_ptr->state_writer_ptr) {
+        wlmaker_state_writer_update(
+            dock_ptr->server_ptr->state_writer_ptr, dock_ptr->state_dict_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates a copy of `dict_ptr`, with the item at `key_ptr` replaced by
+ * `object_ptr`. Items are shared with `dict_ptr`, not copied.
+ *
+ * @param dict_ptr
+ * @param key_ptr
+ * @param object_ptr          Gets referenced by the new dict.
+ *
+ * @return The new dict, or NULL on error. Must be released by calling
+ *     bspl_dict_unref.
+ */
+static bspl_dict_t *_wlmaker_dock_replace_item(
+    bspl_dict_t *dict_ptr,
+    const char *key_ptr,
+    bspl_object_t *object_ptr)
+{
+    if (NULL == dict_ptr) return NULL;
+    _wlmaker_dock_copy_arg_t arg = {
+        .dict_ptr = bspl_dict_create(),
+        .skip_key_ptr = key_ptr
+    };
+    if (NULL == arg.dict_ptr) return NULL;
+    if (!bspl_dict_foreach(dict_ptr, _wlmaker_dock_copy_item, &arg) ||
+        !bspl_dict_add(arg.dict_ptr, key_ptr, object_ptr)) {
+        bspl_dict_unref(arg.dict_ptr);
+        return NULL;
+    }
+    return arg.dict_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Callback for bspl_dict_foreach: Adds the item to the dict of `arg`,
+ * unless it is the item to skip.
+ *
+ * @param key_ptr
+ * @param object_ptr
+ * @param userdata_ptr        Points to @ref _wlmaker_dock_copy_arg_t.
+ *
+ * @return true on success.
+ */
+static bool _wlmaker_dock_copy_item(
+    const char *key_ptr,
+    bspl_object_t *object_ptr,
+    void *userdata_ptr)
+{
+    _wlmaker_dock_copy_arg_t *arg_ptr = userdata_ptr;
+    if (0 == strcmp(key_ptr, arg_ptr->skip_key_ptr)) return true;
+    return bspl_dict_add(arg_ptr->dict_ptr, key_ptr, object_ptr);
+}
+
 /* == Unit tests =========================================================== */
 
 static void test_create_destroy(bs_test_t *test_ptr);
+static void test_tile_moved(bs_test_t *test_ptr);
+static void test_tile_moved_state_file(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmaker_dock_test_cases[] = {
     { 1, "create_destroy", test_create_destroy },
+    { 1, "tile_moved", test_tile_moved },
+    { 1, "tile_moved_state_file", test_tile_moved_state_file },
     { 0, NULL, NULL }
 };
 
@@ -358,4 +533,185 @@ void test_create_destroy(bs_test_t *test_ptr)
     wlr_scene_node_destroy(&wlr_scene_ptr->tree.node);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests that moving a tile re-orders the launchers in the state. */
+void test_tile_moved(bs_test_t *test_ptr)
+{
+    struct wlr_scene *wlr_scene_ptr = wlr_scene_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_scene_ptr);
+    wlmaker_server_t server = {
+        .wlr_scene_ptr = wlr_scene_ptr,
+        .wl_display_ptr = wl_display_create(),
+    };
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, server.wl_display_ptr);
+    server.wlr_output_layout_ptr = wlr_output_layout_create(
+        server.wl_display_ptr);
+    struct wlr_output output = { .width = 1024, .height = 768, .scale = 1 };
+    wlmtk_test_wlr_output_init(&output);
+    wlr_output_layout_add_auto(server.wlr_output_layout_ptr, &output);
+    bspl_dict_t *dict_ptr = bspl_dict_from_object(
+        bspl_create_object_from_plist_data(
+            embedded_binary_default_state_data,
+            embedded_binary_default_state_size));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, dict_ptr);
+    server.root_ptr = wlmtk_root_create(
+        server.wlr_scene_ptr,
+        server.wlr_output_layout_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, server.root_ptr);
+    wlmtk_tile_style_t ts = {};
+    wlmtk_workspace_t *ws_ptr = wlmtk_workspace_create(
+        server.wlr_output_layout_ptr, "1", &ts);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws_ptr);
+    wlmtk_root_add_workspace(server.root_ptr, ws_ptr);
+    wlmaker_config_style_t style = {};
+    wlmaker_dock_t *dock_ptr = wlmaker_dock_create(&server, dict_ptr, &style);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, dock_ptr);
+
+    bspl_array_t *a_ptr = bspl_dict_get_array(
+        bspl_dict_get_dict(dict_ptr, "Dock"), "Launchers");
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, 3 == bspl_array_size(a_ptr));
+
+    // The default dock is anchored at the top: Same order as the launchers.
+    wlmtk_dock_tile_moved_event_t event = { .from = 0, .to = 2 };
+    wl_signal_emit(
+        &wlmtk_dock_events(dock_ptr->wlmtk_dock_ptr)->tile_moved, &event);
+    bspl_array_t *moved_a_ptr = bspl_dict_get_array(
+        bspl_dict_get_dict(dock_ptr->state_dict_ptr, "Dock"), "Launchers");
+    BS_TEST_VERIFY_TRUE_OR_RETURN(
+        test_ptr, 3 == bspl_array_size(moved_a_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, bspl_array_at(a_ptr, 1), bspl_array_at(moved_a_ptr, 0));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, bspl_array_at(a_ptr, 2), bspl_array_at(moved_a_ptr, 1));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, bspl_array_at(a_ptr, 0), bspl_array_at(moved_a_ptr, 2));
+    // Other items of the state are kept.
+    BS_TEST_VERIFY_EQ(
+        test_ptr,
+        bspl_dict_get_dict(dict_ptr, "Clip"),
+        bspl_dict_get_dict(dock_ptr->state_dict_ptr, "Clip"));
+
+    wlmaker_dock_destroy(dock_ptr);
+    bspl_dict_unref(dict_ptr);
+    wlmtk_root_remove_workspace(server.root_ptr, ws_ptr);
+    wlmtk_workspace_destroy(ws_ptr);
+    wlmtk_root_destroy(server.root_ptr);
+    wl_display_destroy(server.wl_display_ptr);
+    wlr_scene_node_destroy(&wlr_scene_ptr->tree.node);
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return The `CommandLine` of launcher `index` in the `Dock` of `d_ptr`. */
+static const char *_wlmaker_dock_test_cmdline(bspl_dict_t *d_ptr, size_t index)
+{
+    bspl_array_t *a_ptr = bspl_dict_get_array(
+        bspl_dict_get_dict(d_ptr, "Dock"), "Launchers");
+    if (NULL == a_ptr || index >= bspl_array_size(a_ptr)) return NULL;
+    return bspl_dict_get_string_value(
+        bspl_dict_from_object(bspl_array_at(a_ptr, index)), "CommandLine");
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests that a moved tile gets written to the state file, and reloads. */
+void test_tile_moved_state_file(bs_test_t *test_ptr)
+{
+    char dir[] = "/tmp/wlmaker_dock_test_XXXXXX";
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, mkdtemp(dir));
+    char fname[PATH_MAX];
+    snprintf(fname, sizeof(fname), "%s/state.plist", dir);
+
+    struct wlr_scene *wlr_scene_ptr = wlr_scene_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_scene_ptr);
+    wlmaker_server_t server = {
+        .wlr_scene_ptr = wlr_scene_ptr,
+        .wl_display_ptr = wl_display_create(),
+    };
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, server.wl_display_ptr);
+    struct wl_event_loop *loop_ptr = wl_display_get_event_loop(
+        server.wl_display_ptr);
+    server.state_writer_ptr = wlmaker_state_writer_create(
+        loop_ptr, fname, 1);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, server.state_writer_ptr);
+    server.wlr_output_layout_ptr = wlr_output_layout_create(
+        server.wl_display_ptr);
+    struct wlr_output output = { .width = 1024, .height = 768, .scale = 1 };
+    wlmtk_test_wlr_output_init(&output);
+    wlr_output_layout_add_auto(server.wlr_output_layout_ptr, &output);
+    bspl_dict_t *dict_ptr = bspl_dict_from_object(
+        bspl_create_object_from_plist_data(
+            embedded_binary_default_state_data,
+            embedded_binary_default_state_size));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, dict_ptr);
+    server.root_ptr = wlmtk_root_create(
+        server.wlr_scene_ptr,
+        server.wlr_output_layout_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, server.root_ptr);
+    wlmtk_tile_style_t ts = {};
+    wlmtk_workspace_t *ws_ptr = wlmtk_workspace_create(
+        server.wlr_output_layout_ptr, "1", &ts);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws_ptr);
+    wlmtk_root_add_workspace(server.root_ptr, ws_ptr);
+    wlmaker_config_style_t style = {};
+    wlmaker_dock_t *dock_ptr = wlmaker_dock_create(&server, dict_ptr, &style);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, dock_ptr);
+
+    // Drives the handler through the toolkit dock's signal, as a drop does.
+    wlmtk_dock_tile_moved_event_t event = { .from = 0, .to = 2 };
+    wl_signal_emit(
+        &wlmtk_dock_events(dock_ptr->wlmtk_dock_ptr)->tile_moved, &event);
+    for (int i = 0;
+         i < 100 && 0 == wlmaker_state_writer_writes(server.state_writer_ptr);
+         ++i) {
+        wl_event_loop_dispatch(loop_ptr, 10);
+    }
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 1, wlmaker_state_writer_writes(server.state_writer_ptr));
+
+    bspl_dict_t *d_ptr = bspl_dict_from_object(
+        bspl_create_object_from_plist_file(fname));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, d_ptr);
+    // The reloaded launchers are in their new order.
+    BS_TEST_VERIFY_STREQ(test_ptr, _wlmaker_dock_test_cmdline(dict_ptr, 1),
+                         _wlmaker_dock_test_cmdline(d_ptr, 0));
+    BS_TEST_VERIFY_STREQ(test_ptr, _wlmaker_dock_test_cmdline(dict_ptr, 2),
+                         _wlmaker_dock_test_cmdline(d_ptr, 1));
+    BS_TEST_VERIFY_STREQ(test_ptr, _wlmaker_dock_test_cmdline(dict_ptr, 0),
+                         _wlmaker_dock_test_cmdline(d_ptr, 2));
+    // The dock's other items, and the other top-level keys, are preserved.
+    BS_TEST_VERIFY_STREQ(
+        test_ptr,
+        bspl_dict_get_string_value(bspl_dict_get_dict(dict_ptr, "Dock"),
+                                   "Edge"),
+        bspl_dict_get_string_value(bspl_dict_get_dict(d_ptr, "Dock"),
+                                   "Edge"));
+    BS_TEST_VERIFY_STREQ(
+        test_ptr,
+        bspl_dict_get_string_value(bspl_dict_get_dict(dict_ptr, "Clip"),
+                                   "Edge"),
+        bspl_dict_get_string_value(bspl_dict_get_dict(d_ptr, "Clip"),
+                                   "Edge"));
+    BS_TEST_VERIFY_STREQ(
+        test_ptr,
+        bspl_dict_get_string_value(bspl_dict_get_dict(dict_ptr, "Clip"),
+                                   "Anchor"),
+        bspl_dict_get_string_value(bspl_dict_get_dict(d_ptr, "Clip"),
+                                   "Anchor"));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        bspl_array_size(bspl_dict_get_array(dict_ptr, "Workspaces")) ==
+        bspl_array_size(bspl_dict_get_array(d_ptr, "Workspaces")));
+    bspl_dict_unref(d_ptr);
+
+    wlmaker_dock_destroy(dock_ptr);
+    bspl_dict_unref(dict_ptr);
+    wlmtk_root_remove_workspace(server.root_ptr, ws_ptr);
+    wlmtk_workspace_destroy(ws_ptr);
+    wlmtk_root_destroy(server.root_ptr);
+    wlmaker_state_writer_destroy(server.state_writer_ptr);
+    wl_display_destroy(server.wl_display_ptr);
+    wlr_scene_node_destroy(&wlr_scene_ptr->tree.node);
+    unlink(fname);
+    rmdir(dir);
+}
+
 /* == End of dock.c ======================================================== */
@@ -30,6 +30,7 @@
 #include <wlr/types/wlr_xdg_shell.h>
 #undef WLR_USE_UNSTABLE
 
+#include "client_quota.h"
 #include "config.h"
 #include "toolkit/toolkit.h"
 #include "wlmaker-icon-unstable-v1-server-protocol.h"
@@ -40,6 +41,12 @@ struct wl_resource;
 
 /* == Declarations ========================================================= */
 
+/**
+ * Limit for the icon's buffer dimensions, as multiple of the configured tile
+ * size. Leaves room for HiDPI outputs, but not for arbitrary large buffers.
+ */
+#define WLMAKER_TOPLEVEL_ICON_MAX_BUFFER_SCALE 4
+
 /** State of the toplevel icon manager. */
 struct _wlmaker_icon_manager_t {
     /** Back-link to the server. */
@@ -60,6 +67,10 @@ struct _wlmaker_toplevel_icon_t {
 
     /** Back-link to the client requesting the toplevel. */
     struct wl_client          *wl_client_ptr;
+    /** Credentials of the client, for memory accounting. */
+    wlmtk_util_client_t       client;
+    /** Bytes of the icon's buffer, as accounted to the client. */
+    size_t                    accounted_bytes;
     /** Back-link to the icon manager. */
     wlmaker_icon_manager_t    *icon_manager_ptr;
     /** The provided ID. */
@@ -304,6 +315,14 @@ void handle_get_toplevel_icon(
     struct wlr_surface *wlr_surface_ptr =
         wlr_surface_from_resource(wl_surface_resource_ptr);
 
+    wlmaker_client_quota_t *client_quota_ptr =
+        icon_manager_ptr->server_ptr->client_quota_ptr;
+    if (NULL != client_quota_ptr &&
+        !wlmaker_client_quota_acquire(
+            client_quota_ptr, wl_client_ptr, WLMAKER_CLIENT_QUOTA_ICONS, 1)) {
+        return;
+    }
+
     wlmaker_toplevel_icon_t *toplevel_icon_ptr = wlmaker_toplevel_icon_create(
         wl_client_ptr,
         icon_manager_ptr,
@@ -312,6 +331,11 @@ void handle_get_toplevel_icon(
         wlr_xdg_toplevel_ptr,
         wlr_surface_ptr);
     if (NULL == toplevel_icon_ptr) {
+        if (NULL != client_quota_ptr) {
+            wlmaker_client_quota_release(
+                client_quota_ptr, wl_client_ptr,
+                WLMAKER_CLIENT_QUOTA_ICONS, 1);
+        }
         wl_client_post_no_memory(wl_client_ptr);
         return;
     }
@@ -344,6 +368,11 @@ wlmaker_toplevel_icon_t *wlmaker_toplevel_icon_create(
     if (NULL == toplevel_icon_ptr) return NULL;
 
     toplevel_icon_ptr->wl_client_ptr = wl_client_ptr;
+    wl_client_get_credentials(
+        wl_client_ptr,
+        &toplevel_icon_ptr->client.pid,
+        &toplevel_icon_ptr->client.uid,
+        &toplevel_icon_ptr->client.gid);
     toplevel_icon_ptr->icon_manager_ptr = icon_manager_ptr;
     toplevel_icon_ptr->id = id;
     toplevel_icon_ptr->wlr_xdg_toplevel_ptr = wlr_xdg_toplevel_ptr;
@@ -424,6 +453,18 @@ void wlmaker_toplevel_icon_destroy(
     wlmaker_toplevel_icon_t *toplevel_icon_ptr)
 {
     bs_log(BS_INFO, "Destroying toplevel icon %p", toplevel_icon_ptr);
+    wlmaker_client_quota_t *client_quota_ptr =
+        toplevel_icon_ptr->icon_manager_ptr->server_ptr->client_quota_ptr;
+    if (NULL != client_quota_ptr) {
+        wlmaker_client_quota_release(
+            client_quota_ptr, toplevel_icon_ptr->wl_client_ptr,
+            WLMAKER_CLIENT_QUOTA_ICONS, 1);
+    }
+    if (0 < toplevel_icon_ptr->accounted_bytes) {
+        wlmtk_memstat_remove(
+            WLMTK_MEMSTAT_ICONS, &toplevel_icon_ptr->client,
+            toplevel_icon_ptr->accounted_bytes);
+    }
 
     _wlmaker_toplevel_icon_element_destroy(
         wlmtk_tile_element(&toplevel_icon_ptr->super_tile));
@@ -480,6 +521,8 @@ void handle_icon_ack_configure(
  *
  * Only when the configuration was suggested and acknowledged a first time,
  * will we accept `commit` with attached buffers.
+ * Buffers larger than @ref WLMAKER_TOPLEVEL_ICON_MAX_BUFFER_SCALE times the
+ * suggested size are a protocol error.
  *
  * @param listener_ptr
  * @param data_ptr            Points to the `struct wlr_surface` of the icon.
@@ -488,6 +531,7 @@ void handle_surface_commit(
     struct wl_listener *listener_ptr,
     void *data_ptr)
 {
+    WLMTK_TRACE_SPAN("icon_commit");
     wlmaker_toplevel_icon_t *toplevel_icon_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmaker_toplevel_icon_t, surface_commit_listener);
     struct wlr_surface *wlr_surface_ptr = data_ptr;
@@ -515,9 +559,41 @@ void handle_surface_commit(
         return;
     }
 
-    wlmtk_tile_set_content(
-        &toplevel_icon_ptr->super_tile,
-        wlmtk_surface_element(toplevel_icon_ptr->content_surface_ptr));
+    uint64_t max_size = WLMAKER_TOPLEVEL_ICON_MAX_BUFFER_SCALE *
+        toplevel_icon_ptr->super_tile.style.size;
+    if ((uint64_t)wlr_surface_ptr->current.buffer_width > max_size ||
+        (uint64_t)wlr_surface_ptr->current.buffer_height > max_size) {
+        wl_resource_post_error(
+            toplevel_icon_ptr->wl_resource_ptr,
+            1,
+            "Commit buffer of %dx%d exceeds limit of %"PRIu64"x%"PRIu64".",
+            wlr_surface_ptr->current.buffer_width,
+            wlr_surface_ptr->current.buffer_height,
+            max_size, max_size);
+        return;
+    }
+
+    // The buffer is the client's, but shown by us: Account it to the client.
+    size_t bytes = (size_t)wlr_surface_ptr->current.buffer_width *
+        (size_t)wlr_surface_ptr->current.buffer_height * sizeof(uint32_t);
+    if (bytes != toplevel_icon_ptr->accounted_bytes) {
+        if (0 < toplevel_icon_ptr->accounted_bytes) {
+            wlmtk_memstat_remove(
+                WLMTK_MEMSTAT_ICONS, &toplevel_icon_ptr->client,
+                toplevel_icon_ptr->accounted_bytes);
+        }
+        wlmtk_memstat_add(
+            WLMTK_MEMSTAT_ICONS, &toplevel_icon_ptr->client, bytes);
+        toplevel_icon_ptr->accounted_bytes = bytes;
+    }
+
+    // Nothing else to do for further commits: The scene shows the surface.
+    wlmtk_element_t *element_ptr = wlmtk_surface_element(
+        toplevel_icon_ptr->content_surface_ptr);
+    if (toplevel_icon_ptr->super_tile.content_element_ptr == element_ptr) {
+        return;
+    }
+    wlmtk_tile_set_content(&toplevel_icon_ptr->super_tile, element_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
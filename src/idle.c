@@ -24,10 +24,12 @@
 #include <libbase/plist.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <time.h>
 #include <wayland-server-core.h>
 #include <wayland-server-protocol.h>
 #include <wayland-util.h>
 #define WLR_USE_UNSTABLE
+#include <wlr/types/wlr_compositor.h>
 #include <wlr/types/wlr_idle_inhibit_v1.h>
 #undef WLR_USE_UNSTABLE
 
@@ -55,6 +57,22 @@ struct _wlmaker_idle_monitor_t {
     struct wl_event_source    *timer_event_source_ptr;
     /** Whether the timer expired. Reset in @ref wlmaker_idle_monitor_reset. */
     bool                      timer_expired;
+    /** Whether the timer is armed. */
+    bool                      timer_armed;
+    /** Timer for powering off the outputs. */
+    struct wl_event_source    *outputs_off_timer_event_source_ptr;
+    /** Whether the outputs off timer expired. Reset on activity. */
+    bool                      outputs_off_timer_expired;
+    /** Whether the outputs off timer is armed. */
+    bool                      outputs_off_timer_armed;
+    /** Whether the outputs were powered off by the idle monitor. */
+    bool                      outputs_off;
+    /**
+     * Monotonic time of the most recent activity, in milliseconds. Updated
+     * by @ref wlmaker_idle_monitor_reset, without touching the timer: When
+     * the timer fires, it re-arms for the remainder of the timeout.
+     */
+    uint64_t                  last_activity_msec;
 
     /** Listener for `new_inhibitor` of wlr_idle_inhibit_manager_v1`. */
     struct wl_listener        new_inhibitor_listener;
@@ -62,18 +80,27 @@ struct _wlmaker_idle_monitor_t {
     bs_dllist_t               idle_inhibitors;
     /**
      * Counter for inhibits. Timer-triggered locks are taking effect only
-     * when inhibits == 0.
+     * when inhibits == 0, and none of @ref wlmaker_idle_monitor_t::
+     * idle_inhibitors is visible.
      */
     int                       inhibits;
 
     /** Listener for @ref wlmtk_root_events_t::unlock_event. */
     struct wl_listener        unlock_listener;
+    /** Listener for @ref wlmtk_root_events_t::workspace_changed. */
+    struct wl_listener        workspace_changed_listener;
+    /** Listener for @ref wlmtk_root_events_t::window_mapped. */
+    struct wl_listener        window_mapped_listener;
+    /** Listener for @ref wlmtk_root_events_t::window_unmapped. */
+    struct wl_listener        window_unmapped_listener;
 
     /** The wlroots idle inhibit manager. */
     struct wlr_idle_inhibit_manager_v1 *wlr_idle_inhibit_manager_v1_ptr;
 
     /** Whether the idle monitor is locked. Prevents timer registry. */
     bool                      locked;
+    /** Handle of the most recently started locker, until it terminates. */
+    wlmaker_subprocess_handle_t *locker_handle_ptr;
 };
 
 /** State of an idle inhibitor. */
@@ -88,25 +115,70 @@ struct _wlmaker_idle_inhibitor_t {
 
     /** Listener for the `destroy` signal of `wlr_idle_inhibitor_v1`. */
     struct wl_listener        destroy_listener;
+    /** Listener for the `commit` signal of the inhibitor's `wlr_surface`. */
+    struct wl_listener        surface_commit_listener;
+    /** Listener for the `unmap` signal of the inhibitor's `wlr_surface`. */
+    struct wl_listener        surface_unmap_listener;
 };
 
+static void _wlmaker_idle_monitor_consider(
+    wlmaker_idle_monitor_t *idle_monitor_ptr);
 static void _wlmaker_idle_monitor_consider_locking(
     wlmaker_idle_monitor_t *idle_monitor_ptr);
+static void _wlmaker_idle_monitor_consider_outputs_off(
+    wlmaker_idle_monitor_t *idle_monitor_ptr);
+static void _wlmaker_idle_monitor_outputs_on(
+    wlmaker_idle_monitor_t *idle_monitor_ptr);
+static bool _wlmaker_idle_monitor_inhibited(
+    wlmaker_idle_monitor_t *idle_monitor_ptr);
+static bool _wlmaker_idle_inhibitor_visible(
+    wlmaker_idle_inhibitor_t *idle_inhibitor_ptr);
+static void _wlmaker_idle_monitor_handle_locker_terminated(
+    void *userdata_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    int state,
+    int code);
 static int _wlmaker_idle_monitor_timer(void *data_ptr);
+static int _wlmaker_idle_monitor_outputs_off_timer(void *data_ptr);
 
 static int _wlmaker_idle_msec(wlmaker_idle_monitor_t *idle_monitor_ptr);
+static int _wlmaker_idle_config_msec(
+    wlmaker_idle_monitor_t *idle_monitor_ptr,
+    const char *key_ptr);
+static void _wlmaker_idle_monitor_arm_outputs_off(
+    wlmaker_idle_monitor_t *idle_monitor_ptr,
+    int msec);
+static void _wlmaker_idle_monitor_arm(
+    wlmaker_idle_monitor_t *idle_monitor_ptr,
+    int msec);
+static uint64_t _wlmaker_idle_now_msec(void);
 static bool _wlmaker_idle_monitor_add_inhibitor(
     wlmaker_idle_monitor_t *idle_monitor_ptr,
     struct wlr_idle_inhibitor_v1 *wlr_idle_inhibitor_v1_ptr);
 static void _wlmaker_idle_monitor_handle_destroy_inhibitor(
     struct wl_listener *listener_ptr,
     void *data_ptr);
+static void _wlmaker_idle_monitor_handle_surface_commit(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmaker_idle_monitor_handle_surface_unmap(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
 static void _wlmaker_idle_monitor_handle_new_inhibitor(
     struct wl_listener *listener_ptr,
     void *data_ptr);
 static void _wlmaker_idle_monitor_handle_unlock(
     struct wl_listener *listener_ptr,
     void *data_ptr);
+static void _wlmaker_idle_monitor_handle_workspace_changed(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmaker_idle_monitor_handle_window_mapped(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmaker_idle_monitor_handle_window_unmapped(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
 
 /* == Exported methods ===================================================== */
 
@@ -142,6 +214,22 @@ wlmaker_idle_monitor_t *wlmaker_idle_monitor_create(
         &monitor_ptr->new_inhibitor_listener,
         _wlmaker_idle_monitor_handle_new_inhibitor);
 
+    // Visibility of the inhibitors may change with these. Re-evaluate.
+    wlmtk_root_events_t *root_events_ptr = wlmtk_root_events(
+        server_ptr->root_ptr);
+    wlmtk_util_connect_listener_signal(
+        &root_events_ptr->workspace_changed,
+        &monitor_ptr->workspace_changed_listener,
+        _wlmaker_idle_monitor_handle_workspace_changed);
+    wlmtk_util_connect_listener_signal(
+        &root_events_ptr->window_mapped,
+        &monitor_ptr->window_mapped_listener,
+        _wlmaker_idle_monitor_handle_window_mapped);
+    wlmtk_util_connect_listener_signal(
+        &root_events_ptr->window_unmapped,
+        &monitor_ptr->window_unmapped_listener,
+        _wlmaker_idle_monitor_handle_window_unmapped);
+
     monitor_ptr->timer_event_source_ptr = wl_event_loop_add_timer(
         monitor_ptr->wl_event_loop_ptr,
         _wlmaker_idle_monitor_timer,
@@ -155,14 +243,32 @@ wlmaker_idle_monitor_t *wlmaker_idle_monitor_create(
         return NULL;
     }
 
+    monitor_ptr->last_activity_msec = _wlmaker_idle_now_msec();
+    int msec = _wlmaker_idle_msec(monitor_ptr);
     if (0 != wl_event_source_timer_update(
-            monitor_ptr->timer_event_source_ptr,
-            _wlmaker_idle_msec(monitor_ptr))) {
-        bs_log(BS_ERROR, "Failed wl_event_source_timer_update(%p, 1000)",
-               monitor_ptr->timer_event_source_ptr);
+            monitor_ptr->timer_event_source_ptr, msec)) {
+        bs_log(BS_ERROR, "Failed wl_event_source_timer_update(%p, %d)",
+               monitor_ptr->timer_event_source_ptr, msec);
         wlmaker_idle_monitor_destroy(monitor_ptr);
         return NULL;
     }
+    monitor_ptr->timer_armed = 0 < msec;
+
+    monitor_ptr->outputs_off_timer_event_source_ptr = wl_event_loop_add_timer(
+        monitor_ptr->wl_event_loop_ptr,
+        _wlmaker_idle_monitor_outputs_off_timer,
+        monitor_ptr);
+    if (NULL == monitor_ptr->outputs_off_timer_event_source_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_timer(%p, %p, %p)",
+               monitor_ptr->wl_event_loop_ptr,
+               _wlmaker_idle_monitor_outputs_off_timer,
+               monitor_ptr);
+        wlmaker_idle_monitor_destroy(monitor_ptr);
+        return NULL;
+    }
+    _wlmaker_idle_monitor_arm_outputs_off(
+        monitor_ptr,
+        _wlmaker_idle_config_msec(monitor_ptr, "OutputsOffSeconds"));
 
     return monitor_ptr;
 }
@@ -170,10 +276,30 @@ wlmaker_idle_monitor_t *wlmaker_idle_monitor_create(
 /* ------------------------------------------------------------------------- */
 void wlmaker_idle_monitor_destroy(wlmaker_idle_monitor_t *idle_monitor_ptr)
 {
+    // The subprocess monitor may be gone already, on shutdown.
+    if (NULL != idle_monitor_ptr->locker_handle_ptr &&
+        NULL != idle_monitor_ptr->server_ptr->monitor_ptr) {
+        wlmaker_subprocess_monitor_cede(
+            idle_monitor_ptr->server_ptr->monitor_ptr,
+            idle_monitor_ptr->locker_handle_ptr);
+    }
+    idle_monitor_ptr->locker_handle_ptr = NULL;
+
     if (NULL != idle_monitor_ptr->unlock_listener.link.prev) {
         wl_list_remove(&idle_monitor_ptr->unlock_listener.link);
     }
-
+    wlmtk_util_disconnect_listener(
+        &idle_monitor_ptr->window_unmapped_listener);
+    wlmtk_util_disconnect_listener(
+        &idle_monitor_ptr->window_mapped_listener);
+    wlmtk_util_disconnect_listener(
+        &idle_monitor_ptr->workspace_changed_listener);
+
+    if (NULL != idle_monitor_ptr->outputs_off_timer_event_source_ptr) {
+        wl_event_source_remove(
+            idle_monitor_ptr->outputs_off_timer_event_source_ptr);
+        idle_monitor_ptr->outputs_off_timer_event_source_ptr = NULL;
+    }
     if (NULL != idle_monitor_ptr->timer_event_source_ptr) {
         wl_event_source_remove(idle_monitor_ptr->timer_event_source_ptr);
         idle_monitor_ptr->timer_event_source_ptr = NULL;
@@ -192,13 +318,17 @@ void wlmaker_idle_monitor_destroy(wlmaker_idle_monitor_t *idle_monitor_ptr)
 /* ------------------------------------------------------------------------- */
 void wlmaker_idle_monitor_reset(wlmaker_idle_monitor_t *idle_monitor_ptr)
 {
+    // Activity wakes the outputs, also when locked: For the locker.
+    idle_monitor_ptr->last_activity_msec = _wlmaker_idle_now_msec();
+    _wlmaker_idle_monitor_outputs_on(idle_monitor_ptr);
     if (idle_monitor_ptr->locked) return;
 
-    int rv = wl_event_source_timer_update(
-        idle_monitor_ptr->timer_event_source_ptr,
-        _wlmaker_idle_msec(idle_monitor_ptr));
-    BS_ASSERT(0 == rv);
     idle_monitor_ptr->timer_expired = false;
+
+    // An armed timer will re-arm itself for the remainder when firing.
+    if (idle_monitor_ptr->timer_armed) return;
+    _wlmaker_idle_monitor_arm(
+        idle_monitor_ptr, _wlmaker_idle_msec(idle_monitor_ptr));
 }
 
 /* ------------------------------------------------------------------------- */
@@ -225,19 +355,27 @@ bool wlmaker_idle_monitor_lock(wlmaker_idle_monitor_t *idle_monitor_ptr)
         return false;
     }
 
-    wlmaker_subprocess_handle_t *handle_ptr =
+    // Only a single locker is tracked: Forget about a former one.
+    if (NULL != idle_monitor_ptr->locker_handle_ptr) {
+        wlmaker_subprocess_monitor_cede(
+            idle_monitor_ptr->server_ptr->monitor_ptr,
+            idle_monitor_ptr->locker_handle_ptr);
+    }
+    idle_monitor_ptr->locker_handle_ptr =
         wlmaker_subprocess_monitor_entrust(
             idle_monitor_ptr->server_ptr->monitor_ptr,
             subprocess_ptr,
-            NULL,
-            NULL,
+            _wlmaker_idle_monitor_handle_locker_terminated,
+            idle_monitor_ptr,
             NULL,
             NULL,
             NULL,
             NULL);
-    if (NULL != handle_ptr) {
-        wlmaker_subprocess_monitor_cede(
-            idle_monitor_ptr->server_ptr->monitor_ptr, handle_ptr);
+
+    // Hide the desktop right away, rather than once the locker committed
+    // its lock surfaces. Lifted if the locker terminates without locking.
+    if (NULL != idle_monitor_ptr->locker_handle_ptr) {
+        wlmtk_root_prelock(idle_monitor_ptr->server_ptr->root_ptr, true);
     }
     return true;
 }
@@ -253,19 +391,28 @@ void wlmaker_idle_monitor_uninhibit(wlmaker_idle_monitor_t *idle_monitor_ptr)
 {
     BS_ASSERT(0 < idle_monitor_ptr->inhibits);
     --idle_monitor_ptr->inhibits;
-    _wlmaker_idle_monitor_consider_locking(idle_monitor_ptr);
+    _wlmaker_idle_monitor_consider(idle_monitor_ptr);
 }
 
 /* == Local (static) methods =============================================== */
 
+/* ------------------------------------------------------------------------- */
+/** Re-considers the idle actions: Locking, and powering off the outputs. */
+void _wlmaker_idle_monitor_consider(wlmaker_idle_monitor_t *idle_monitor_ptr)
+{
+    _wlmaker_idle_monitor_consider_locking(idle_monitor_ptr);
+    _wlmaker_idle_monitor_consider_outputs_off(idle_monitor_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Executes a lock, if not inhibited & timer has indeed expired. */
 void _wlmaker_idle_monitor_consider_locking(
     wlmaker_idle_monitor_t *idle_monitor_ptr)
 {
     // No locking if there's inhibitors or no expired timer.
-    if (0 < idle_monitor_ptr->inhibits ||
-        !idle_monitor_ptr->timer_expired) return;
+    if (!idle_monitor_ptr->timer_expired ||
+        idle_monitor_ptr->locked ||
+        _wlmaker_idle_monitor_inhibited(idle_monitor_ptr)) return;
 
     // Lock. If there's a problem there => don't register for unlock.
     if (!wlmaker_idle_monitor_lock(idle_monitor_ptr)) return;
@@ -278,6 +425,114 @@ void _wlmaker_idle_monitor_consider_locking(
         _wlmaker_idle_monitor_handle_unlock);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Powers off the outputs, if not inhibited & the timer has expired. */
+void _wlmaker_idle_monitor_consider_outputs_off(
+    wlmaker_idle_monitor_t *idle_monitor_ptr)
+{
+    if (!idle_monitor_ptr->outputs_off_timer_expired ||
+        idle_monitor_ptr->outputs_off ||
+        NULL == idle_monitor_ptr->server_ptr->backend_ptr ||
+        _wlmaker_idle_monitor_inhibited(idle_monitor_ptr)) return;
+
+    wlmbe_backend_set_outputs_powered(
+        idle_monitor_ptr->server_ptr->backend_ptr, false);
+    idle_monitor_ptr->outputs_off = true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Powers the outputs back on, if they were powered off, and re-arms the
+ * timer for powering them off.
+ *
+ * @param idle_monitor_ptr
+ */
+void _wlmaker_idle_monitor_outputs_on(wlmaker_idle_monitor_t *idle_monitor_ptr)
+{
+    idle_monitor_ptr->outputs_off_timer_expired = false;
+    if (idle_monitor_ptr->outputs_off) {
+        wlmbe_backend_set_outputs_powered(
+            idle_monitor_ptr->server_ptr->backend_ptr, true);
+        idle_monitor_ptr->outputs_off = false;
+    }
+
+    // An armed timer will re-arm itself for the remainder when firing.
+    if (idle_monitor_ptr->outputs_off_timer_armed) return;
+    _wlmaker_idle_monitor_arm_outputs_off(
+        idle_monitor_ptr,
+        _wlmaker_idle_config_msec(idle_monitor_ptr, "OutputsOffSeconds"));
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns whether the monitor is inhibited: Through an explicit
+ * @ref wlmaker_idle_monitor_inhibit, or through any visible inhibitor.
+ *
+ * @param idle_monitor_ptr
+ *
+ * @return true if inhibited.
+ */
+bool _wlmaker_idle_monitor_inhibited(wlmaker_idle_monitor_t *idle_monitor_ptr)
+{
+    if (0 < idle_monitor_ptr->inhibits) return true;
+
+    for (bs_dllist_node_t *dlnode_ptr =
+             idle_monitor_ptr->idle_inhibitors.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_idle_inhibitor_t *idle_inhibitor_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_idle_inhibitor_t, dlnode);
+        if (_wlmaker_idle_inhibitor_visible(idle_inhibitor_ptr)) return true;
+    }
+    return false;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns whether the inhibitor's surface is visible to the user: Mapped,
+ * and shown on at least one output.
+ *
+ * The scene graph tracks the surface's outputs: A surface on a workspace
+ * that is not shown, on a disabled output, or of an occluded window is not
+ * on any output.
+ *
+ * @param idle_inhibitor_ptr
+ *
+ * @return true if visible.
+ */
+bool _wlmaker_idle_inhibitor_visible(
+    wlmaker_idle_inhibitor_t *idle_inhibitor_ptr)
+{
+    struct wlr_surface *wlr_surface_ptr =
+        idle_inhibitor_ptr->wlr_idle_inhibitor_v1_ptr->surface;
+    return (NULL != wlr_surface_ptr &&
+            wlr_surface_ptr->mapped &&
+            !wl_list_empty(&wlr_surface_ptr->current_outputs));
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Callback for when the locker terminated. Lifts the curtain of
+ * @ref wlmtk_root_prelock, unless the root got locked meanwhile.
+ *
+ * @param userdata_ptr        Untyped pointer to @ref wlmaker_idle_monitor_t.
+ * @param subprocess_handle_ptr
+ * @param state
+ * @param code
+ */
+void _wlmaker_idle_monitor_handle_locker_terminated(
+    void *userdata_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    __UNUSED__ int state,
+    __UNUSED__ int code)
+{
+    wlmaker_idle_monitor_t *idle_monitor_ptr = userdata_ptr;
+    if (subprocess_handle_ptr != idle_monitor_ptr->locker_handle_ptr) return;
+    idle_monitor_ptr->locker_handle_ptr = NULL;
+
+    wlmtk_root_prelock(idle_monitor_ptr->server_ptr->root_ptr, false);
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Timer function for the wayland event loop.
@@ -291,12 +546,99 @@ void _wlmaker_idle_monitor_consider_locking(
 int _wlmaker_idle_monitor_timer(void *data_ptr)
 {
     wlmaker_idle_monitor_t *idle_monitor_ptr = data_ptr;
+    idle_monitor_ptr->timer_armed = false;
+
+    // Activity since arming the timer? Then wait for the remainder.
+    int msec = _wlmaker_idle_msec(idle_monitor_ptr);
+    uint64_t elapsed_msec =
+        _wlmaker_idle_now_msec() - idle_monitor_ptr->last_activity_msec;
+    if (0 < msec && elapsed_msec < (uint64_t)msec) {
+        _wlmaker_idle_monitor_arm(idle_monitor_ptr, msec - elapsed_msec);
+        return 0;
+    }
 
     idle_monitor_ptr->timer_expired = true;
     _wlmaker_idle_monitor_consider_locking(idle_monitor_ptr);
     return 0;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Timer function for powering off the outputs. Like
+ * @ref _wlmaker_idle_monitor_timer, re-arms for the remainder if there was
+ * activity meanwhile.
+ *
+ * @param data_ptr            Untyped pointer to @ref wlmaker_idle_monitor_t.
+ *
+ * @return 0.
+ */
+int _wlmaker_idle_monitor_outputs_off_timer(void *data_ptr)
+{
+    wlmaker_idle_monitor_t *idle_monitor_ptr = data_ptr;
+    idle_monitor_ptr->outputs_off_timer_armed = false;
+
+    int msec = _wlmaker_idle_config_msec(
+        idle_monitor_ptr, "OutputsOffSeconds");
+    uint64_t elapsed_msec =
+        _wlmaker_idle_now_msec() - idle_monitor_ptr->last_activity_msec;
+    if (0 < msec && elapsed_msec < (uint64_t)msec) {
+        _wlmaker_idle_monitor_arm_outputs_off(
+            idle_monitor_ptr, msec - elapsed_msec);
+        return 0;
+    }
+
+    idle_monitor_ptr->outputs_off_timer_expired = true;
+    _wlmaker_idle_monitor_consider_outputs_off(idle_monitor_ptr);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Arms the timer to fire in `msec` milliseconds. A non-positive value
+ * leaves the timer disarmed.
+ *
+ * @param idle_monitor_ptr
+ * @param msec
+ */
+void _wlmaker_idle_monitor_arm(
+    wlmaker_idle_monitor_t *idle_monitor_ptr,
+    int msec)
+{
+    if (0 >= msec) return;
+    int rv = wl_event_source_timer_update(
+        idle_monitor_ptr->timer_event_source_ptr, msec);
+    BS_ASSERT(0 == rv);
+    idle_monitor_ptr->timer_armed = true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Arms the outputs off timer to fire in `msec` milliseconds. A non-positive
+ * value leaves the timer disarmed.
+ *
+ * @param idle_monitor_ptr
+ * @param msec
+ */
+void _wlmaker_idle_monitor_arm_outputs_off(
+    wlmaker_idle_monitor_t *idle_monitor_ptr,
+    int msec)
+{
+    if (0 >= msec) return;
+    int rv = wl_event_source_timer_update(
+        idle_monitor_ptr->outputs_off_timer_event_source_ptr, msec);
+    BS_ASSERT(0 == rv);
+    idle_monitor_ptr->outputs_off_timer_armed = true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return The monotonic clock's time, in milliseconds. */
+uint64_t _wlmaker_idle_now_msec(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Returns the idle timeout time in milliseconds.
@@ -308,16 +650,32 @@ int _wlmaker_idle_monitor_timer(void *data_ptr)
  *     to NOT be armed.
  */
 int _wlmaker_idle_msec(wlmaker_idle_monitor_t *idle_monitor_ptr)
+{
+    return _wlmaker_idle_config_msec(idle_monitor_ptr, "IdleSeconds");
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns a timeout from the 'ScreenLock' configuration, in milliseconds.
+ *
+ * @param idle_monitor_ptr
+ * @param key_ptr             Key of the value, in seconds.
+ *
+ * @return The timeout, or 0 if not or badly configured.
+ */
+int _wlmaker_idle_config_msec(
+    wlmaker_idle_monitor_t *idle_monitor_ptr,
+    const char *key_ptr)
 {
     const char *idle_seconds_ptr = bspl_dict_get_string_value(
-        idle_monitor_ptr->lock_config_dict_ptr, "IdleSeconds");
+        idle_monitor_ptr->lock_config_dict_ptr, key_ptr);
     if (NULL == idle_seconds_ptr) return 0;
 
     uint64_t seconds;
     if (!bs_strconvert_uint64(idle_seconds_ptr, &seconds, 10) ||
         seconds >= (INT32_MAX / 1000)) {
-        bs_log(BS_WARNING, "Bad value for 'IdleSeconds': %s",
-               idle_seconds_ptr);
+        bs_log(BS_WARNING, "Bad value for '%s': %s",
+               key_ptr, idle_seconds_ptr);
         return 0;
     }
 
@@ -348,10 +706,18 @@ bool _wlmaker_idle_monitor_add_inhibitor(
         &wlr_idle_inhibitor_v1_ptr->events.destroy,
         &idle_inhibitor_ptr->destroy_listener,
         _wlmaker_idle_monitor_handle_destroy_inhibitor);
+    wlmtk_util_connect_listener_signal(
+        &wlr_idle_inhibitor_v1_ptr->surface->events.commit,
+        &idle_inhibitor_ptr->surface_commit_listener,
+        _wlmaker_idle_monitor_handle_surface_commit);
+    wlmtk_util_connect_listener_signal(
+        &wlr_idle_inhibitor_v1_ptr->surface->events.unmap,
+        &idle_inhibitor_ptr->surface_unmap_listener,
+        _wlmaker_idle_monitor_handle_surface_unmap);
 
+    // Not counted in `inhibits`: Visibility is evaluated when locking.
     bs_dllist_push_back(&idle_monitor_ptr->idle_inhibitors,
                         &idle_inhibitor_ptr->dlnode);
-    wlmaker_idle_monitor_inhibit(idle_monitor_ptr);
 
     return true;
 }
@@ -370,13 +736,53 @@ void _wlmaker_idle_monitor_handle_destroy_inhibitor(
     wlmaker_idle_inhibitor_t *idle_inhibitor_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmaker_idle_inhibitor_t, destroy_listener);
 
-    wlmaker_idle_monitor_uninhibit(idle_inhibitor_ptr->idle_monitor_ptr);
-    bs_dllist_remove(
-        &idle_inhibitor_ptr->idle_monitor_ptr->idle_inhibitors,
-        &idle_inhibitor_ptr->dlnode);
+    wlmaker_idle_monitor_t *idle_monitor_ptr =
+        idle_inhibitor_ptr->idle_monitor_ptr;
+    bs_dllist_remove(&idle_monitor_ptr->idle_inhibitors,
+                     &idle_inhibitor_ptr->dlnode);
 
+    wlmtk_util_disconnect_listener(
+        &idle_inhibitor_ptr->surface_unmap_listener);
+    wlmtk_util_disconnect_listener(
+        &idle_inhibitor_ptr->surface_commit_listener);
     wl_list_remove(&idle_inhibitor_ptr->destroy_listener.link);
     free(idle_inhibitor_ptr);
+
+    _wlmaker_idle_monitor_consider(idle_monitor_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for `commit` of the inhibitor's surface: Its visibility may have
+ * changed, so re-considers the idle actions.
+ *
+ * @param listener_ptr
+ * @param data_ptr            unused.
+ */
+void _wlmaker_idle_monitor_handle_surface_commit(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmaker_idle_inhibitor_t *idle_inhibitor_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_idle_inhibitor_t, surface_commit_listener);
+    _wlmaker_idle_monitor_consider(idle_inhibitor_ptr->idle_monitor_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for `unmap` of the inhibitor's surface: It no longer inhibits,
+ * so re-considers the idle actions.
+ *
+ * @param listener_ptr
+ * @param data_ptr            unused.
+ */
+void _wlmaker_idle_monitor_handle_surface_unmap(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmaker_idle_inhibitor_t *idle_inhibitor_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_idle_inhibitor_t, surface_unmap_listener);
+    _wlmaker_idle_monitor_consider(idle_inhibitor_ptr->idle_monitor_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -427,4 +833,55 @@ void _wlmaker_idle_monitor_handle_unlock(
     wlmaker_idle_monitor_reset(idle_monitor_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for @ref wlmtk_root_events_t::workspace_changed: The visibility of
+ * inhibitors may have changed, so re-considers the idle actions.
+ *
+ * @param listener_ptr
+ * @param data_ptr            unused.
+ */
+void _wlmaker_idle_monitor_handle_workspace_changed(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmaker_idle_monitor_t *idle_monitor_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_idle_monitor_t, workspace_changed_listener);
+    _wlmaker_idle_monitor_consider(idle_monitor_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for @ref wlmtk_root_events_t::window_mapped: The visibility of
+ * inhibitors may have changed, so re-considers the idle actions.
+ *
+ * @param listener_ptr
+ * @param data_ptr            unused.
+ */
+void _wlmaker_idle_monitor_handle_window_mapped(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmaker_idle_monitor_t *idle_monitor_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_idle_monitor_t, window_mapped_listener);
+    _wlmaker_idle_monitor_consider(idle_monitor_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for @ref wlmtk_root_events_t::window_unmapped: The visibility of
+ * inhibitors may have changed, so re-considers the idle actions.
+ *
+ * @param listener_ptr
+ * @param data_ptr            unused.
+ */
+void _wlmaker_idle_monitor_handle_window_unmapped(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmaker_idle_monitor_t *idle_monitor_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_idle_monitor_t, window_unmapped_listener);
+    _wlmaker_idle_monitor_consider(idle_monitor_ptr);
+}
+
 /* == End of idle.c ======================================================== */
@@ -51,6 +51,9 @@ void wlmaker_idle_monitor_destroy(wlmaker_idle_monitor_t *idle_monitor_ptr);
 /**
  * Resets the idle monitor: For example, when a key is pressed.
  *
+ * Only records the time of activity, unless the timer needs arming. Cheap
+ * enough to call on every input event.
+ *
  * @param idle_monitor_ptr
  */
 void wlmaker_idle_monitor_reset(wlmaker_idle_monitor_t *idle_monitor_ptr);
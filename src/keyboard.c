@@ -25,6 +25,8 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <wayland-server-core.h>
 #include <wayland-server-protocol.h>
 #include <wayland-util.h>
@@ -39,6 +41,33 @@
 
 /* == Declarations ========================================================= */
 
+/** Number of names in `struct xkb_rule_names`. */
+#define WLMAKER_KEYBOARD_RULE_NAMES 5
+
+/**
+ * A compiled keymap, shared by the keyboards of the same rule names. Sharing
+ * the `struct xkb_keymap` also lets wlroots skip re-sending the keymap to
+ * clients when the seat's active keyboard changes.
+ */
+typedef struct {
+    /** Node in @ref wlmaker_keyboard_keymap_cache_t::keymaps. */
+    bs_dllist_node_t          dlnode;
+    /** Number of keyboards using the keymap. */
+    unsigned                  references;
+    /** The compiled keymap. */
+    struct xkb_keymap         *xkb_keymap_ptr;
+    /** Rules, model, layout, variant and options. NULL where unset. */
+    char                      *names[WLMAKER_KEYBOARD_RULE_NAMES];
+} wlmaker_keyboard_keymap_t;
+
+/** Cache of compiled keymaps. Compiling one takes milliseconds. */
+typedef struct {
+    /** The context all keymaps are compiled in. */
+    struct xkb_context        *xkb_context_ptr;
+    /** Keymaps, through @ref wlmaker_keyboard_keymap_t::dlnode. */
+    bs_dllist_t               keymaps;
+} wlmaker_keyboard_keymap_cache_t;
+
 /** Keyboard handle. */
 struct _wlmaker_keyboard_t {
     /** Configuration dictionnary, just the "Keyboard" section. */
@@ -49,13 +78,36 @@ struct _wlmaker_keyboard_t {
     struct wlr_keyboard       *wlr_keyboard_ptr;
     /** The wlroots seat. */
     struct wlr_seat           *wlr_seat_ptr;
+    /** The keymap, from @ref _wlmaker_keyboard_keymap_cache. */
+    wlmaker_keyboard_keymap_t *keymap_ptr;
 
     /** Listener for the `modifiers` signal of `wl_keyboard`. */
     struct wl_listener        modifiers_listener;
     /** Listener for the `key` signal of `wl_keyboard`. */
     struct wl_listener        key_listener;
+
+    /** Repeats per second, for compositor-side key repeat. 0 disables. */
+    int32_t                   repeat_rate;
+    /** Delay before the first repeat, in milliseconds. */
+    int32_t                   repeat_delay;
+    /** Timer for repeating the key that triggered a key binding. */
+    struct wl_event_source    *repeat_timer_ptr;
+    /** Whether a key is being repeated. */
+    bool                      repeating;
+    /** The xkbcommon keycode of the repeated key. */
+    uint32_t                  repeat_keycode;
+    /** The keysym of the repeated key. */
+    xkb_keysym_t              repeat_keysym;
+    /** Monotonic time when the next repeat is due, in milliseconds. */
+    uint64_t                  repeat_next_msec;
 };
 
+/**
+ * Maximum number of repeats emitted for one expiry of the repeat timer. If
+ * the event loop fell further behind, the excess repeats are dropped.
+ */
+static const unsigned _wlmaker_keyboard_repeat_max_batch = 8;
+
 static bool _wlmaker_keyboard_populate_rules(
     bspl_dict_t *dict_ptr,
     struct xkb_rule_names *rules_ptr);
@@ -63,11 +115,33 @@ static bool _wlmaker_keyboard_populate_repeat(
     bspl_dict_t *dict_ptr,
     int32_t *rate_ptr,
     int32_t *delay_ptr);
+static wlmaker_keyboard_keymap_t *_wlmaker_keyboard_keymap_acquire(
+    const struct xkb_rule_names *rules_ptr);
+static void _wlmaker_keyboard_keymap_release(
+    wlmaker_keyboard_keymap_t *keymap_ptr);
+static void _wlmaker_keyboard_keymap_destroy(
+    wlmaker_keyboard_keymap_t *keymap_ptr);
+static bool _wlmaker_keyboard_keymap_matches(
+    wlmaker_keyboard_keymap_t *keymap_ptr,
+    const char *names[WLMAKER_KEYBOARD_RULE_NAMES]);
+
+static void _wlmaker_keyboard_start_repeat(
+    wlmaker_keyboard_t *keyboard_ptr,
+    uint32_t keycode,
+    xkb_keysym_t keysym);
+static void _wlmaker_keyboard_stop_repeat(wlmaker_keyboard_t *keyboard_ptr);
+static int _wlmaker_keyboard_handle_repeat(void *data_ptr);
+static uint64_t _wlmaker_keyboard_now_msec(void);
 
 static void handle_key(struct wl_listener *listener_ptr, void *data_ptr);
 static void handle_modifiers(struct wl_listener *listener_ptr,
                              void *data_ptr);
 
+/* == Data ================================================================= */
+
+/** Keymaps shared by all keyboards. */
+static wlmaker_keyboard_keymap_cache_t _wlmaker_keyboard_keymap_cache;
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -103,25 +177,13 @@ wlmaker_keyboard_t *wlmaker_keyboard_create(
     }
 
     // Set keyboard layout.
-    struct xkb_context *xkb_context_ptr = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
-    struct xkb_keymap *xkb_keymap_ptr = xkb_keymap_new_from_names(
-        xkb_context_ptr, &xkb_rule, XKB_KEYMAP_COMPILE_NO_FLAGS);
-    if (NULL == xkb_keymap_ptr) {
-        bs_log(BS_ERROR, "Failed xkb_keymap_new_from_names(%p, { .rules = %s, "
-               ".model = %s, .layout = %s, variant = %s, .options = %s }, "
-               "XKB_KEYMAP_COMPILE_NO_NO_FLAGS)",
-               xkb_context_ptr,
-               xkb_rule.rules,
-               xkb_rule.model,
-               xkb_rule.layout,
-               xkb_rule.variant,
-               xkb_rule.options);
+    keyboard_ptr->keymap_ptr = _wlmaker_keyboard_keymap_acquire(&xkb_rule);
+    if (NULL == keyboard_ptr->keymap_ptr) {
         wlmaker_keyboard_destroy(keyboard_ptr);
         return NULL;
     }
-    wlr_keyboard_set_keymap(keyboard_ptr->wlr_keyboard_ptr, xkb_keymap_ptr);
-    xkb_keymap_unref(xkb_keymap_ptr);
-    xkb_context_unref(xkb_context_ptr);
+    wlr_keyboard_set_keymap(keyboard_ptr->wlr_keyboard_ptr,
+                            keyboard_ptr->keymap_ptr->xkb_keymap_ptr);
 
     // Repeat rate and delay.
     int32_t rate, delay;
@@ -132,6 +194,19 @@ wlmaker_keyboard_t *wlmaker_keyboard_create(
         return NULL;
     }
     wlr_keyboard_set_repeat_info(keyboard_ptr->wlr_keyboard_ptr, rate, delay);
+    keyboard_ptr->repeat_rate = rate;
+    keyboard_ptr->repeat_delay = delay;
+
+    // Clients repeat keys themselves. This repeats the key bindings.
+    keyboard_ptr->repeat_timer_ptr = wl_event_loop_add_timer(
+        wl_display_get_event_loop(server_ptr->wl_display_ptr),
+        _wlmaker_keyboard_handle_repeat,
+        keyboard_ptr);
+    if (NULL == keyboard_ptr->repeat_timer_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_timer()");
+        wlmaker_keyboard_destroy(keyboard_ptr);
+        return NULL;
+    }
 
     wlmtk_util_connect_listener_signal(
         &keyboard_ptr->wlr_keyboard_ptr->events.key,
@@ -149,9 +224,19 @@ wlmaker_keyboard_t *wlmaker_keyboard_create(
 /* ------------------------------------------------------------------------- */
 void wlmaker_keyboard_destroy(wlmaker_keyboard_t *keyboard_ptr)
 {
+    if (NULL != keyboard_ptr->repeat_timer_ptr) {
+        wl_event_source_remove(keyboard_ptr->repeat_timer_ptr);
+        keyboard_ptr->repeat_timer_ptr = NULL;
+    }
+
     wl_list_remove(&keyboard_ptr->key_listener.link);
     wl_list_remove(&keyboard_ptr->modifiers_listener.link);
 
+    if (NULL != keyboard_ptr->keymap_ptr) {
+        _wlmaker_keyboard_keymap_release(keyboard_ptr->keymap_ptr);
+        keyboard_ptr->keymap_ptr = NULL;
+    }
+
     if (NULL != keyboard_ptr->config_dict_ptr) {
         bspl_dict_unref(keyboard_ptr->config_dict_ptr);
         keyboard_ptr->config_dict_ptr = NULL;
@@ -235,6 +320,230 @@ bool _wlmaker_keyboard_populate_repeat(
     return true;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Acquires the keymap for `rules_ptr`: Re-uses a cached keymap of the same
+ * rule names, or compiles and caches it.
+ *
+ * @param rules_ptr
+ *
+ * @return The keymap, or NULL on error. Must be released through
+ *     @ref _wlmaker_keyboard_keymap_release.
+ */
+wlmaker_keyboard_keymap_t *_wlmaker_keyboard_keymap_acquire(
+    const struct xkb_rule_names *rules_ptr)
+{
+    wlmaker_keyboard_keymap_cache_t *cache_ptr =
+        &_wlmaker_keyboard_keymap_cache;
+    const char *names[WLMAKER_KEYBOARD_RULE_NAMES] = {
+        rules_ptr->rules, rules_ptr->model, rules_ptr->layout,
+        rules_ptr->variant, rules_ptr->options };
+
+    for (bs_dllist_node_t *dlnode_ptr = cache_ptr->keymaps.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_keyboard_keymap_t *keymap_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_keyboard_keymap_t, dlnode);
+        if (_wlmaker_keyboard_keymap_matches(keymap_ptr, names)) {
+            keymap_ptr->references++;
+            return keymap_ptr;
+        }
+    }
+
+    if (NULL == cache_ptr->xkb_context_ptr) {
+        cache_ptr->xkb_context_ptr = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+        if (NULL == cache_ptr->xkb_context_ptr) {
+            bs_log(BS_ERROR, "Failed xkb_context_new(XKB_CONTEXT_NO_FLAGS)");
+            return NULL;
+        }
+    }
+
+    wlmaker_keyboard_keymap_t *keymap_ptr = logged_calloc(
+        1, sizeof(wlmaker_keyboard_keymap_t));
+    if (NULL == keymap_ptr) return NULL;
+    for (int i = 0; i < WLMAKER_KEYBOARD_RULE_NAMES; ++i) {
+        if (NULL == names[i]) continue;
+        keymap_ptr->names[i] = logged_strdup(names[i]);
+        if (NULL == keymap_ptr->names[i]) {
+            _wlmaker_keyboard_keymap_destroy(keymap_ptr);
+            return NULL;
+        }
+    }
+
+    keymap_ptr->xkb_keymap_ptr = xkb_keymap_new_from_names(
+        cache_ptr->xkb_context_ptr, rules_ptr, XKB_KEYMAP_COMPILE_NO_FLAGS);
+    if (NULL == keymap_ptr->xkb_keymap_ptr) {
+        bs_log(BS_ERROR, "Failed xkb_keymap_new_from_names(%p, { .rules = %s, "
+               ".model = %s, .layout = %s, variant = %s, .options = %s }, "
+               "XKB_KEYMAP_COMPILE_NO_NO_FLAGS)",
+               cache_ptr->xkb_context_ptr,
+               rules_ptr->rules,
+               rules_ptr->model,
+               rules_ptr->layout,
+               rules_ptr->variant,
+               rules_ptr->options);
+        _wlmaker_keyboard_keymap_destroy(keymap_ptr);
+        return NULL;
+    }
+
+    keymap_ptr->references = 1;
+    bs_dllist_push_front(&cache_ptr->keymaps, &keymap_ptr->dlnode);
+    return keymap_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Releases a keymap acquired through @ref _wlmaker_keyboard_keymap_acquire.
+ *
+ * A keymap no longer used stays cached, for devices that re-appear, as
+ * on hotplug. Only the most recently released of these is kept.
+ *
+ * @param keymap_ptr
+ */
+void _wlmaker_keyboard_keymap_release(wlmaker_keyboard_keymap_t *keymap_ptr)
+{
+    wlmaker_keyboard_keymap_cache_t *cache_ptr =
+        &_wlmaker_keyboard_keymap_cache;
+    BS_ASSERT(0 < keymap_ptr->references);
+    if (0 < --keymap_ptr->references) return;
+
+    bs_dllist_node_t *dlnode_ptr = cache_ptr->keymaps.head_ptr;
+    while (NULL != dlnode_ptr) {
+        wlmaker_keyboard_keymap_t *k_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_keyboard_keymap_t, dlnode);
+        dlnode_ptr = dlnode_ptr->next_ptr;
+        if (k_ptr == keymap_ptr || 0 < k_ptr->references) continue;
+        bs_dllist_remove(&cache_ptr->keymaps, &k_ptr->dlnode);
+        _wlmaker_keyboard_keymap_destroy(k_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the keymap. It must not be in the cache's list. */
+void _wlmaker_keyboard_keymap_destroy(wlmaker_keyboard_keymap_t *keymap_ptr)
+{
+    if (NULL != keymap_ptr->xkb_keymap_ptr) {
+        xkb_keymap_unref(keymap_ptr->xkb_keymap_ptr);
+        keymap_ptr->xkb_keymap_ptr = NULL;
+    }
+    for (int i = 0; i < WLMAKER_KEYBOARD_RULE_NAMES; ++i) {
+        free(keymap_ptr->names[i]);
+    }
+    free(keymap_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Whether `keymap_ptr` was compiled from the rule names `names`. */
+bool _wlmaker_keyboard_keymap_matches(
+    wlmaker_keyboard_keymap_t *keymap_ptr,
+    const char *names[WLMAKER_KEYBOARD_RULE_NAMES])
+{
+    for (int i = 0; i < WLMAKER_KEYBOARD_RULE_NAMES; ++i) {
+        const char *name_ptr = keymap_ptr->names[i];
+        if (NULL == name_ptr || NULL == names[i]) {
+            if (name_ptr != names[i]) return false;
+        } else if (0 != strcmp(name_ptr, names[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Starts repeating the key binding of `keysym`, if configured and the key
+ * is one that repeats.
+ *
+ * @param keyboard_ptr
+ * @param keycode             The xkbcommon keycode.
+ * @param keysym
+ */
+void _wlmaker_keyboard_start_repeat(
+    wlmaker_keyboard_t *keyboard_ptr,
+    uint32_t keycode,
+    xkb_keysym_t keysym)
+{
+    if (0 >= keyboard_ptr->repeat_rate ||
+        !xkb_keymap_key_repeats(keyboard_ptr->wlr_keyboard_ptr->keymap,
+                                keycode)) return;
+
+    keyboard_ptr->repeating = true;
+    keyboard_ptr->repeat_keycode = keycode;
+    keyboard_ptr->repeat_keysym = keysym;
+    keyboard_ptr->repeat_next_msec =
+        _wlmaker_keyboard_now_msec() + keyboard_ptr->repeat_delay;
+    wl_event_source_timer_update(
+        keyboard_ptr->repeat_timer_ptr,
+        BS_MAX(1, keyboard_ptr->repeat_delay));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Stops repeating the key binding, if any. */
+void _wlmaker_keyboard_stop_repeat(wlmaker_keyboard_t *keyboard_ptr)
+{
+    if (!keyboard_ptr->repeating) return;
+    keyboard_ptr->repeating = false;
+    keyboard_ptr->repeat_keycode = 0;
+    wl_event_source_timer_update(keyboard_ptr->repeat_timer_ptr, 0);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Timer callback: Triggers the key binding for each repeat that is due.
+ *
+ * Repeats missed while the event loop was busy are emitted in one batch,
+ * up to @ref _wlmaker_keyboard_repeat_max_batch. The timer is re-armed
+ * relative to the schedule, so repeats do not drift.
+ *
+ * @param data_ptr            Untyped pointer to @ref wlmaker_keyboard_t.
+ *
+ * @return 0.
+ */
+int _wlmaker_keyboard_handle_repeat(void *data_ptr)
+{
+    wlmaker_keyboard_t *keyboard_ptr = data_ptr;
+    if (!keyboard_ptr->repeating) return 0;
+
+    uint64_t interval_msec = BS_MAX(1, 1000 / keyboard_ptr->repeat_rate);
+    uint64_t now_msec = _wlmaker_keyboard_now_msec();
+    unsigned repeats = 0;
+    if (now_msec >= keyboard_ptr->repeat_next_msec) {
+        uint64_t due = 1 + (now_msec - keyboard_ptr->repeat_next_msec) /
+            interval_msec;
+        keyboard_ptr->repeat_next_msec += due * interval_msec;
+        repeats = BS_MIN(due, _wlmaker_keyboard_repeat_max_batch);
+    }
+
+    for (unsigned i = 0; i < repeats; ++i) {
+        uint32_t modifiers = wlr_keyboard_get_modifiers(
+            keyboard_ptr->wlr_keyboard_ptr);
+        if (!wlmaker_keyboard_process_bindings(
+                keyboard_ptr->server_ptr,
+                keyboard_ptr->repeat_keysym,
+                modifiers)) {
+            // Modifiers changed, or the binding is gone: Stop repeating.
+            _wlmaker_keyboard_stop_repeat(keyboard_ptr);
+            return 0;
+        }
+        // The binding may have ended the repeat.
+        if (!keyboard_ptr->repeating) return 0;
+    }
+
+    wl_event_source_timer_update(
+        keyboard_ptr->repeat_timer_ptr,
+        BS_MAX(1, keyboard_ptr->repeat_next_msec - now_msec));
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return The monotonic clock's time, in milliseconds. */
+uint64_t _wlmaker_keyboard_now_msec(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Handles `key` signals, ie. key presses.
@@ -244,6 +553,7 @@ bool _wlmaker_keyboard_populate_repeat(
  */
 void handle_key(struct wl_listener *listener_ptr, void *data_ptr)
 {
+    WLMTK_TRACE_SPAN("handle_key");
     wlmaker_keyboard_t *keyboard_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmaker_keyboard_t, key_listener);
     struct wlr_keyboard_key_event *wlr_keyboard_key_event_ptr = data_ptr;
@@ -261,9 +571,33 @@ void handle_key(struct wl_listener *listener_ptr, void *data_ptr)
         wlmaker_server_deactivate_task_list(keyboard_ptr->server_ptr);
     }
 
+    // Holding the modifiers for switching workspaces hints at a switch.
+    wlmaker_server_t *server_ptr = keyboard_ptr->server_ptr;
+    if (0 != server_ptr->workspace_switch_modifiers &&
+        (modifiers & wlmaker_modifier_default_mask) ==
+        server_ptr->workspace_switch_modifiers) {
+        wlmtk_root_t *root_ptr = server_ptr->root_ptr;
+        struct wl_event_loop *wl_event_loop_ptr = wl_display_get_event_loop(
+            server_ptr->wl_display_ptr);
+        wlmtk_root_prewarm_workspace(
+            root_ptr,
+            wlmtk_root_get_next_workspace(root_ptr),
+            wl_event_loop_ptr);
+        wlmtk_root_prewarm_workspace(
+            root_ptr,
+            wlmtk_root_get_previous_workspace(root_ptr),
+            wl_event_loop_ptr);
+    }
+
     // Translates libinput keycode -> xkbcommon.
     uint32_t keycode = wlr_keyboard_key_event_ptr->keycode + 8;
 
+    // Any press ends the repeat, as does releasing the repeated key.
+    if (WL_KEYBOARD_KEY_STATE_PRESSED == wlr_keyboard_key_event_ptr->state ||
+        keycode == keyboard_ptr->repeat_keycode) {
+        _wlmaker_keyboard_stop_repeat(keyboard_ptr);
+    }
+
     // For key presses: Pass them on to the server, for potential key bindings.
     bool processed = false;
     const xkb_keysym_t *key_syms;
@@ -282,6 +616,7 @@ void handle_key(struct wl_listener *listener_ptr, void *data_ptr)
             wlmaker_keyboard_process_bindings(
                 keyboard_ptr->server_ptr, key_syms[i], modifiers)) {
             processed |= true;
+            _wlmaker_keyboard_start_repeat(keyboard_ptr, keycode, key_syms[i]);
         } else {
             // TODO(kaeser@gubbe.ch): Pass key_syms[i] keysym, modifier and
             // direction down to the element having keyboard focus.
@@ -18,20 +18,50 @@
  * limitations under the License.
  */
 
+/// mkdtemp() and setenv() are POSIX extensions.
+#define _POSIX_C_SOURCE 200809L
+
 #include "launcher.h"
 
 #include <cairo.h>
+#include <fcntl.h>
 #include <libbase/libbase.h>
 #include <libbase/plist.h>
 #include <limits.h>
 #include <linux/input-event-codes.h>
+#include <signal.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "toolkit/toolkit.h"
 
 /* == Declarations ========================================================= */
 
+/** Status shown on the launcher's overlay. */
+typedef enum {
+    WLMAKER_LAUNCHER_STATUS_NONE,
+    WLMAKER_LAUNCHER_STATUS_STARTED,
+    WLMAKER_LAUNCHER_STATUS_RUNNING
+} wlmaker_launcher_status_t;
+
+/** An overlay buffer, shared among launchers of equal size and status. */
+typedef struct {
+    /** Node within @ref _wlmaker_launcher_overlay_cache. */
+    bs_dllist_node_t          dlnode;
+    /** Size of the tile. */
+    int                       size;
+    /** Status drawn on the overlay. */
+    wlmaker_launcher_status_t status;
+    /** Number of launchers using this entry. */
+    int                       references;
+    /** The overlay buffer. The entry holds one reference. */
+    struct wlr_buffer         *wlr_buffer_ptr;
+} wlmaker_launcher_overlay_t;
+
 /** State of a launcher. */
 struct _wlmaker_launcher_t {
     /** The launcher is derived from a @ref wlmtk_tile_t. */
@@ -43,19 +73,36 @@ struct _wlmaker_launcher_t {
     wlmtk_image_t             *image_ptr;
     /** Overlay element. Atop on the tile. */
     wlmtk_buffer_t            overlay_buffer;
+    /** Shared overlay, currently shown in `overlay_buffer`. */
+    wlmaker_launcher_overlay_t *overlay_ptr;
 
     /** Subprocess monitor to register launched processes to. */
     wlmaker_subprocess_monitor_t *monitor_ptr;
 
     /** Commandline to launch the associated application. */
     char                      *cmdline_ptr;
+    /**
+     * Commandline with the executable resolved to its full path. NULL if it
+     * was not resolved. See @ref _wlmaker_launcher_cmdline.
+     */
+    char                      *resolved_cmdline_ptr;
+    /** $PATH that `resolved_cmdline_ptr` was resolved with. NULL if none. */
+    char                      *resolved_search_path_ptr;
     /** Path to the icon. */
     char                      *icon_path_ptr;
+    /** Whether to keep a hidden instance started, to map on click. */
+    bool                      prelaunch;
+    /** The hidden, pre-started instance. NULL if none. */
+    wlmaker_subprocess_handle_t *prelaunched_handle_ptr;
+    /** Resource limits for the application. 0 to keep the default. */
+    wlmaker_cgroup_limits_t   limits;
 
     /** Windows that are running from subprocesses of this App (launcher). */
     bs_ptr_set_t              *created_windows_ptr;
     /** Windows that are mapped from subprocesses of this App (launcher). */
     bs_ptr_set_t              *mapped_windows_ptr;
+    /** Windows that were hidden by clicking the launcher. */
+    bs_ptr_set_t              *hidden_windows_ptr;
     /** Subprocesses that were created by this launcher. */
     bs_ptr_set_t              *subprocesses_ptr;
 };
@@ -66,6 +113,17 @@ static const bspl_desc_t _wlmaker_launcher_plist_desc[] = {
         "CommandLine", true, wlmaker_launcher_t, cmdline_ptr, cmdline_ptr, ""),
     BSPL_DESC_STRING(
         "Icon", true, wlmaker_launcher_t, icon_path_ptr, icon_path_ptr, ""),
+    BSPL_DESC_BOOL(
+        "Prelaunch", false, wlmaker_launcher_t, prelaunch, prelaunch, false),
+    BSPL_DESC_UINT64(
+        "CpuWeight", false, wlmaker_launcher_t,
+        limits.cpu_weight, limits.cpu_weight, 0),
+    BSPL_DESC_UINT64(
+        "MemoryHighMiB", false, wlmaker_launcher_t,
+        limits.memory_high_mib, limits.memory_high_mib, 0),
+    BSPL_DESC_UINT64(
+        "MemoryMaxMiB", false, wlmaker_launcher_t,
+        limits.memory_max_mib, limits.memory_max_mib, 0),
     BSPL_DESC_SENTINEL(),
 };
 
@@ -83,8 +141,14 @@ static const char *lookup_paths[] = {
 };
 
 static void _wlmaker_launcher_update_overlay(wlmaker_launcher_t *launcher_ptr);
+static wlmaker_launcher_overlay_t *_wlmaker_launcher_overlay_acquire(
+    int size,
+    wlmaker_launcher_status_t status);
+static void _wlmaker_launcher_overlay_release(
+    wlmaker_launcher_overlay_t *overlay_ptr);
 static struct wlr_buffer *_wlmaker_launcher_create_overlay_buffer(
-    wlmaker_launcher_t *launcher_ptr);
+    int size,
+    wlmaker_launcher_status_t status);
 
 static void _wlmaker_launcher_element_destroy(
     wlmtk_element_t *element_ptr);
@@ -93,6 +157,17 @@ static bool _wlmaker_launcher_pointer_button(
     const wlmtk_button_event_t *button_event_ptr);
 
 static void _wlmaker_launcher_start(wlmaker_launcher_t *launcher_ptr);
+static bool _wlmaker_launcher_toggle(wlmaker_launcher_t *launcher_ptr);
+static void _wlmaker_launcher_prelaunch(wlmaker_launcher_t *launcher_ptr);
+static wlmaker_subprocess_handle_t *_wlmaker_launcher_spawn(
+    wlmaker_launcher_t *launcher_ptr);
+static const char *_wlmaker_launcher_cmdline(
+    wlmaker_launcher_t *launcher_ptr);
+static char *_wlmaker_launcher_resolve_cmdline(
+    const char *cmdline_ptr,
+    const char *search_path_ptr);
+static bool _wlmaker_launcher_executable_exists(
+    const char *resolved_cmdline_ptr);
 
 static void _wlmaker_launcher_handle_terminated(
     void *userdata_ptr,
@@ -118,6 +193,9 @@ static void _wlmaker_launcher_handle_window_destroyed(
 
 /* == Data ================================================================= */
 
+/** Overlay buffers, shared among all launchers. */
+static bs_dllist_t            _wlmaker_launcher_overlay_cache;
+
 /** The launcher's extension to @ref wlmtk_element_t virtual method table. */
 static const wlmtk_element_vmt_t _wlmaker_launcher_element_vmt = {
     .destroy = _wlmaker_launcher_element_destroy,
@@ -156,6 +234,11 @@ wlmaker_launcher_t *wlmaker_launcher_create_from_plist(
         wlmaker_launcher_destroy(launcher_ptr);
         return NULL;
     }
+    launcher_ptr->hidden_windows_ptr = bs_ptr_set_create();
+    if (NULL == launcher_ptr->hidden_windows_ptr) {
+        wlmaker_launcher_destroy(launcher_ptr);
+        return NULL;
+    }
     launcher_ptr->subprocesses_ptr = bs_ptr_set_create();
     if (NULL == launcher_ptr->subprocesses_ptr) {
         wlmaker_launcher_destroy(launcher_ptr);
@@ -168,6 +251,9 @@ wlmaker_launcher_t *wlmaker_launcher_create_from_plist(
     }
     wlmtk_element_set_visible(
         wlmtk_buffer_element(&launcher_ptr->overlay_buffer), true);
+    // Decoration only: The tile's background takes the pointer input.
+    wlmtk_element_set_input_transparent(
+        wlmtk_buffer_element(&launcher_ptr->overlay_buffer), true);
     _wlmaker_launcher_update_overlay(launcher_ptr);
     wlmtk_tile_set_overlay(
         &launcher_ptr->super_tile,
@@ -179,6 +265,7 @@ wlmaker_launcher_t *wlmaker_launcher_create_from_plist(
         wlmaker_launcher_destroy(launcher_ptr);
         return NULL;
     }
+    _wlmaker_launcher_cmdline(launcher_ptr);
 
     // Resolves to a full path, and verifies the icon file exists.
     char full_path[PATH_MAX];
@@ -202,16 +289,35 @@ wlmaker_launcher_t *wlmaker_launcher_create_from_plist(
     }
     wlmtk_element_set_visible(
         wlmtk_image_element(launcher_ptr->image_ptr), true);
+    wlmtk_element_set_input_transparent(
+        wlmtk_image_element(launcher_ptr->image_ptr), true);
     wlmtk_tile_set_content(
         &launcher_ptr->super_tile,
         wlmtk_image_element(launcher_ptr->image_ptr));
 
+    if (launcher_ptr->prelaunch && NULL != launcher_ptr->monitor_ptr) {
+        _wlmaker_launcher_prelaunch(launcher_ptr);
+    }
     return launcher_ptr;
 }
 
 /* ------------------------------------------------------------------------- */
 void wlmaker_launcher_destroy(wlmaker_launcher_t *launcher_ptr)
 {
+    // Windows hidden from the launcher would be unreachable otherwise. Shows
+    // them first: Mapping calls back into the launcher and its overlay.
+    if (NULL != launcher_ptr->hidden_windows_ptr) {
+        wlmtk_window_t *window_ptr;
+        while (NULL != (window_ptr = bs_ptr_set_any(
+                            launcher_ptr->hidden_windows_ptr))) {
+            bs_ptr_set_erase(launcher_ptr->hidden_windows_ptr, window_ptr);
+            wlmaker_subprocess_monitor_show_window(
+                launcher_ptr->monitor_ptr, window_ptr);
+        }
+        bs_ptr_set_destroy(launcher_ptr->hidden_windows_ptr);
+        launcher_ptr->hidden_windows_ptr = NULL;
+    }
+
     if (NULL != launcher_ptr->image_ptr) {
         wlmtk_tile_set_content(&launcher_ptr->super_tile, NULL);
         wlmtk_image_destroy(launcher_ptr->image_ptr);
@@ -220,6 +326,18 @@ void wlmaker_launcher_destroy(wlmaker_launcher_t *launcher_ptr)
 
     wlmtk_tile_set_overlay(&launcher_ptr->super_tile, NULL);
     wlmtk_buffer_fini(&launcher_ptr->overlay_buffer);
+    if (NULL != launcher_ptr->overlay_ptr) {
+        _wlmaker_launcher_overlay_release(launcher_ptr->overlay_ptr);
+        launcher_ptr->overlay_ptr = NULL;
+    }
+
+    // The pre-started instance was never shown: Don't leave it behind.
+    if (NULL != launcher_ptr->prelaunched_handle_ptr) {
+        kill(bs_subprocess_pid(wlmaker_subprocess_from_subprocess_handle(
+                                   launcher_ptr->prelaunched_handle_ptr)),
+             SIGTERM);
+        launcher_ptr->prelaunched_handle_ptr = NULL;
+    }
 
     if (NULL != launcher_ptr->subprocesses_ptr) {
         wlmaker_subprocess_handle_t *subprocess_handle_ptr;
@@ -244,6 +362,14 @@ void wlmaker_launcher_destroy(wlmaker_launcher_t *launcher_ptr)
         launcher_ptr->created_windows_ptr = NULL;
     }
 
+    if (NULL != launcher_ptr->resolved_search_path_ptr) {
+        free(launcher_ptr->resolved_search_path_ptr);
+        launcher_ptr->resolved_search_path_ptr = NULL;
+    }
+    if (NULL != launcher_ptr->resolved_cmdline_ptr) {
+        free(launcher_ptr->resolved_cmdline_ptr);
+        launcher_ptr->resolved_cmdline_ptr = NULL;
+    }
     if (NULL != launcher_ptr->cmdline_ptr) {
         free(launcher_ptr->cmdline_ptr);
         launcher_ptr->cmdline_ptr = NULL;
@@ -267,30 +393,103 @@ wlmtk_tile_t *wlmaker_launcher_tile(wlmaker_launcher_t *launcher_ptr)
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
-/** Redraws the overlay element. */
+/**
+ * Updates the overlay element to the launcher's status. Uses the shared
+ * overlay for the status, and only draws if there is none yet.
+ */
 void _wlmaker_launcher_update_overlay(wlmaker_launcher_t *launcher_ptr)
 {
-    struct wlr_buffer *wlr_buffer_ptr = _wlmaker_launcher_create_overlay_buffer(
-        launcher_ptr);
-    if (NULL == wlr_buffer_ptr) return;
-    wlmtk_buffer_set(&launcher_ptr->overlay_buffer, wlr_buffer_ptr);
-    wlr_buffer_drop(wlr_buffer_ptr);
+    wlmaker_launcher_status_t status = WLMAKER_LAUNCHER_STATUS_NONE;
+    if (!bs_ptr_set_empty(launcher_ptr->mapped_windows_ptr) ||
+        !bs_ptr_set_empty(launcher_ptr->hidden_windows_ptr)) {
+        status = WLMAKER_LAUNCHER_STATUS_RUNNING;
+    } else if (!bs_ptr_set_empty(launcher_ptr->created_windows_ptr)) {
+        status = WLMAKER_LAUNCHER_STATUS_STARTED;
+    }
+    if (NULL != launcher_ptr->overlay_ptr &&
+        launcher_ptr->overlay_ptr->status == status) return;
+
+    wlmaker_launcher_overlay_t *overlay_ptr =
+        _wlmaker_launcher_overlay_acquire(
+            launcher_ptr->super_tile.style.size, status);
+    if (NULL == overlay_ptr) return;
+    wlmtk_buffer_set(&launcher_ptr->overlay_buffer,
+                     overlay_ptr->wlr_buffer_ptr);
+    if (NULL != launcher_ptr->overlay_ptr) {
+        _wlmaker_launcher_overlay_release(launcher_ptr->overlay_ptr);
+    }
+    launcher_ptr->overlay_ptr = overlay_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the shared overlay for `size` and `status`, creating it if needed.
+ * Must be released by calling @ref _wlmaker_launcher_overlay_release.
+ *
+ * @param size
+ * @param status
+ *
+ * @return The overlay, or NULL on error.
+ */
+wlmaker_launcher_overlay_t *_wlmaker_launcher_overlay_acquire(
+    int size,
+    wlmaker_launcher_status_t status)
+{
+    for (bs_dllist_node_t *dlnode_ptr =
+             _wlmaker_launcher_overlay_cache.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_launcher_overlay_t *overlay_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_launcher_overlay_t, dlnode);
+        if (overlay_ptr->size == size && overlay_ptr->status == status) {
+            ++overlay_ptr->references;
+            return overlay_ptr;
+        }
+    }
+
+    wlmaker_launcher_overlay_t *overlay_ptr = logged_calloc(
+        1, sizeof(wlmaker_launcher_overlay_t));
+    if (NULL == overlay_ptr) return NULL;
+    overlay_ptr->wlr_buffer_ptr = _wlmaker_launcher_create_overlay_buffer(
+        size, status);
+    if (NULL == overlay_ptr->wlr_buffer_ptr) {
+        free(overlay_ptr);
+        return NULL;
+    }
+    overlay_ptr->size = size;
+    overlay_ptr->status = status;
+    overlay_ptr->references = 1;
+    bs_dllist_push_front(&_wlmaker_launcher_overlay_cache,
+                         &overlay_ptr->dlnode);
+    return overlay_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Releases a reference on the overlay. Destroys it if it was the last. */
+void _wlmaker_launcher_overlay_release(wlmaker_launcher_overlay_t *overlay_ptr)
+{
+    if (0 < --overlay_ptr->references) return;
+    bs_dllist_remove(&_wlmaker_launcher_overlay_cache, &overlay_ptr->dlnode);
+    wlr_buffer_drop(overlay_ptr->wlr_buffer_ptr);
+    free(overlay_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
 /** Creates an overlay wlr_buffer. */
 struct wlr_buffer *_wlmaker_launcher_create_overlay_buffer(
-    wlmaker_launcher_t *launcher_ptr)
+    int size,
+    wlmaker_launcher_status_t status)
 {
-    int s = launcher_ptr->super_tile.style.size;
+    int s = size;
     struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(s, s);
     if (NULL == wlr_buffer_ptr) return NULL;
+    wlmtk_gfxbuf_set_memstat_subsystem(wlr_buffer_ptr, WLMTK_MEMSTAT_TILES);
 
     const char *status_ptr = NULL;
-    if (!bs_ptr_set_empty(launcher_ptr->mapped_windows_ptr)) {
-        status_ptr = "Running";
-    } else if (!bs_ptr_set_empty(launcher_ptr->created_windows_ptr)) {
-        status_ptr = "Started";
+    switch (status) {
+    case WLMAKER_LAUNCHER_STATUS_RUNNING: status_ptr = "Running"; break;
+    case WLMAKER_LAUNCHER_STATUS_STARTED: status_ptr = "Started"; break;
+    default: break;
     }
     if (NULL == status_ptr) return wlr_buffer_ptr;
 
@@ -358,31 +557,121 @@ bool _wlmaker_launcher_pointer_button(
     if (BTN_LEFT != button_event_ptr->button) return true;
     if (WLMTK_BUTTON_CLICK != button_event_ptr->type) return true;
 
-    _wlmaker_launcher_start(launcher_ptr);
+    if (!_wlmaker_launcher_toggle(launcher_ptr)) {
+        _wlmaker_launcher_start(launcher_ptr);
+    }
     return true;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Hides or shows all windows of the application, when it is running: Shows
+ * the windows hidden by a previous click, or else hides all mapped windows.
+ *
+ * @param launcher_ptr
+ *
+ * @return false if there were no windows to hide or show.
+ */
+bool _wlmaker_launcher_toggle(wlmaker_launcher_t *launcher_ptr)
+{
+    if (NULL == launcher_ptr->monitor_ptr) return false;
+
+    wlmtk_window_t *window_ptr;
+    bool toggled = false;
+    if (!bs_ptr_set_empty(launcher_ptr->hidden_windows_ptr)) {
+        while (NULL != (window_ptr = bs_ptr_set_any(
+                            launcher_ptr->hidden_windows_ptr))) {
+            bs_ptr_set_erase(launcher_ptr->hidden_windows_ptr, window_ptr);
+            // False if the client unmapped the window while it was hidden.
+            toggled |= wlmaker_subprocess_monitor_show_window(
+                launcher_ptr->monitor_ptr, window_ptr);
+        }
+    } else {
+        while (NULL != (window_ptr = bs_ptr_set_any(
+                            launcher_ptr->mapped_windows_ptr))) {
+            bs_ptr_set_erase(launcher_ptr->mapped_windows_ptr, window_ptr);
+            if (!wlmaker_subprocess_monitor_hide_window(
+                    launcher_ptr->monitor_ptr, window_ptr)) continue;
+            if (!bs_ptr_set_insert(launcher_ptr->hidden_windows_ptr,
+                                   window_ptr)) {
+                bs_log(BS_ERROR, "Failed bs_ptr_set_insert(%p)", window_ptr);
+                wlmaker_subprocess_monitor_show_window(
+                    launcher_ptr->monitor_ptr, window_ptr);
+                continue;
+            }
+            toggled = true;
+        }
+    }
+    _wlmaker_launcher_update_overlay(launcher_ptr);
+    return toggled;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Starts the application, called when the launcher is clicked.
  *
+ * If there is a pre-started instance, maps its windows instead, and starts
+ * another instance to take its place.
+ *
  * @param launcher_ptr
  */
 void _wlmaker_launcher_start(wlmaker_launcher_t *launcher_ptr)
 {
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr =
+        launcher_ptr->prelaunched_handle_ptr;
+    if (NULL != subprocess_handle_ptr) {
+        launcher_ptr->prelaunched_handle_ptr = NULL;
+        // Windows not yet created will be mapped when the client is ready.
+        wlmaker_subprocess_monitor_map_held_windows(
+            launcher_ptr->monitor_ptr, subprocess_handle_ptr);
+        _wlmaker_launcher_prelaunch(launcher_ptr);
+        return;
+    }
+
+    _wlmaker_launcher_spawn(launcher_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Starts a hidden instance of the application, to be shown on click.
+ *
+ * @param launcher_ptr
+ */
+void _wlmaker_launcher_prelaunch(wlmaker_launcher_t *launcher_ptr)
+{
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr =
+        _wlmaker_launcher_spawn(launcher_ptr);
+    if (NULL == subprocess_handle_ptr) return;
+    wlmaker_subprocess_monitor_hold_windows(subprocess_handle_ptr, true);
+    launcher_ptr->prelaunched_handle_ptr = subprocess_handle_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Launches a subprocess of the application, and entrusts it to the monitor.
+ *
+ * @param launcher_ptr
+ *
+ * @return The subprocess handle, or NULL on error or if the handle is not
+ *     tracked by the launcher.
+ */
+wlmaker_subprocess_handle_t *_wlmaker_launcher_spawn(
+    wlmaker_launcher_t *launcher_ptr)
+{
+    const char *cmdline_ptr = _wlmaker_launcher_cmdline(launcher_ptr);
     bs_subprocess_t *subprocess_ptr = bs_subprocess_create_cmdline(
-        launcher_ptr->cmdline_ptr);
+        cmdline_ptr);
     if (NULL == subprocess_ptr) {
         bs_log(BS_ERROR, "Failed bs_subprocess_create_cmdline(%s)",
-               launcher_ptr->cmdline_ptr);
-        return;
+               cmdline_ptr);
+        return NULL;
     }
 
     if (!bs_subprocess_start(subprocess_ptr)) {
         bs_log(BS_ERROR, "Failed bs_subprocess_start for %s",
                launcher_ptr->cmdline_ptr);
         bs_subprocess_destroy(subprocess_ptr);
-        return;
+        return NULL;
     }
 
     wlmaker_subprocess_handle_t *subprocess_handle_ptr;
@@ -395,6 +684,15 @@ void _wlmaker_launcher_start(wlmaker_launcher_t *launcher_ptr)
         _wlmaker_launcher_handle_window_mapped,
         _wlmaker_launcher_handle_window_unmapped,
         _wlmaker_launcher_handle_window_destroyed);
+    const wlmaker_cgroup_limits_t *l_ptr = &launcher_ptr->limits;
+    if (NULL != subprocess_handle_ptr &&
+        (0 != l_ptr->cpu_weight ||
+         0 != l_ptr->memory_high_mib ||
+         0 != l_ptr->memory_max_mib)) {
+        // Not isolated: Runs without limits, just as a terminal would have.
+        wlmaker_subprocess_monitor_set_limits(
+            launcher_ptr->monitor_ptr, subprocess_handle_ptr, l_ptr);
+    }
 
     if (!bs_ptr_set_insert(launcher_ptr->subprocesses_ptr,
                            subprocess_handle_ptr)) {
@@ -405,7 +703,123 @@ void _wlmaker_launcher_start(wlmaker_launcher_t *launcher_ptr)
         wlmaker_subprocess_monitor_cede(
             launcher_ptr->monitor_ptr,
             subprocess_handle_ptr);
+        return NULL;
+    }
+    return subprocess_handle_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the commandline to launch: With the executable resolved to its full
+ * path, saving the search through $PATH on each launch.
+ *
+ * The resolution is kept only while $PATH is unchanged, and while the
+ * executable exists. Otherwise, the commandline is resolved again. Launches
+ * then start the same executable as a search through $PATH would.
+ *
+ * @param launcher_ptr
+ *
+ * @return The resolved commandline, or the configured one if not resolved.
+ */
+const char *_wlmaker_launcher_cmdline(wlmaker_launcher_t *launcher_ptr)
+{
+    const char *search_path_ptr = getenv("PATH");
+    if (NULL == search_path_ptr) search_path_ptr = "";
+    if (NULL == launcher_ptr->resolved_search_path_ptr ||
+        0 != strcmp(launcher_ptr->resolved_search_path_ptr,
+                    search_path_ptr) ||
+        (NULL != launcher_ptr->resolved_cmdline_ptr &&
+         !_wlmaker_launcher_executable_exists(
+             launcher_ptr->resolved_cmdline_ptr))) {
+        if (NULL != launcher_ptr->resolved_cmdline_ptr) {
+            free(launcher_ptr->resolved_cmdline_ptr);
+        }
+        if (NULL != launcher_ptr->resolved_search_path_ptr) {
+            free(launcher_ptr->resolved_search_path_ptr);
+        }
+        launcher_ptr->resolved_cmdline_ptr = _wlmaker_launcher_resolve_cmdline(
+            launcher_ptr->cmdline_ptr, search_path_ptr);
+        launcher_ptr->resolved_search_path_ptr = logged_strdup(
+            search_path_ptr);
     }
+
+    if (NULL != launcher_ptr->resolved_cmdline_ptr) {
+        return launcher_ptr->resolved_cmdline_ptr;
+    }
+    return launcher_ptr->cmdline_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Resolves the executable of the commandline to its full path, by searching
+ * the directories of `search_path_ptr`.
+ *
+ * Only a plain first word is resolved: Names containing a slash, quotes,
+ * escapes or expansions are left to the shell-like parsing at launch.
+ *
+ * @param cmdline_ptr
+ * @param search_path_ptr     Colon-separated list of directories, as $PATH.
+ *
+ * @return The commandline with the executable replaced by its full path, or
+ *     NULL if not resolved. Must be released by calling free().
+ */
+char *_wlmaker_launcher_resolve_cmdline(
+    const char *cmdline_ptr,
+    const char *search_path_ptr)
+{
+    const char *exec_ptr = cmdline_ptr + strspn(cmdline_ptr, " \t");
+    size_t exec_len = strcspn(exec_ptr, " \t");
+    if (0 == exec_len || NULL == search_path_ptr) return NULL;
+    if (strcspn(exec_ptr, "/\"'\\$~") < exec_len) return NULL;
+
+    const char *dir_ptr = search_path_ptr;
+    while (true) {
+        size_t dir_len = strcspn(dir_ptr, ":");
+        char path[PATH_MAX];
+        struct stat statbuf;
+        if (0 < dir_len && dir_len + 1 + exec_len < sizeof(path)) {
+            memcpy(path, dir_ptr, dir_len);
+            path[dir_len] = '/';
+            memcpy(path + dir_len + 1, exec_ptr, exec_len);
+            path[dir_len + 1 + exec_len] = '\0';
+            if (0 == stat(path, &statbuf) && S_ISREG(statbuf.st_mode) &&
+                0 == access(path, X_OK)) {
+                // A path that would need quoting is left to the search.
+                if (strcspn(path, " \t\"'\\") < strlen(path)) return NULL;
+                const char *args_ptr = exec_ptr + exec_len;
+                size_t len = strlen(path) + strlen(args_ptr) + 1;
+                char *resolved_ptr = logged_calloc(1, len);
+                if (NULL == resolved_ptr) return NULL;
+                snprintf(resolved_ptr, len, "%s%s", path, args_ptr);
+                return resolved_ptr;
+            }
+        }
+        if ('\0' == dir_ptr[dir_len]) return NULL;
+        dir_ptr += dir_len + 1;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns whether the executable of a commandline from
+ * @ref _wlmaker_launcher_resolve_cmdline (still) exists.
+ *
+ * @param resolved_cmdline_ptr Starts with the executable's full path, which
+ *                            does not contain blanks.
+ *
+ * @return true if the executable exists and may be executed.
+ */
+bool _wlmaker_launcher_executable_exists(const char *resolved_cmdline_ptr)
+{
+    char path[PATH_MAX];
+    size_t len = strcspn(resolved_cmdline_ptr, " \t");
+    if (len >= sizeof(path)) return false;
+    memcpy(path, resolved_cmdline_ptr, len);
+    path[len] = '\0';
+
+    struct stat statbuf;
+    return (0 == stat(path, &statbuf) && S_ISREG(statbuf.st_mode) &&
+            0 == access(path, X_OK));
 }
 
 /* ------------------------------------------------------------------------- */
@@ -427,6 +841,12 @@ void _wlmaker_launcher_handle_terminated(
     const char *format_ptr;
     int code;
 
+    // A pre-started instance that exits is not restarted: It would likely
+    // just fail again.
+    if (launcher_ptr->prelaunched_handle_ptr == subprocess_handle_ptr) {
+        launcher_ptr->prelaunched_handle_ptr = NULL;
+    }
+
     if (0 == signal_number) {
         format_ptr = "App '%s' (%p) terminated, status code %d.";
         code = exit_status;
@@ -453,7 +873,8 @@ void _wlmaker_launcher_handle_terminated(
  * Callback for then a window from the launched subprocess is created.
  *
  * Registers the windows as "created", and will then redraw the launcher tile
- * to reflect potential status changes.
+ * to reflect potential status changes. Windows of the pre-started instance
+ * are registered only once they are mapped.
  *
  * @param userdata_ptr        Points to the @ref wlmaker_launcher_t.
  * @param subprocess_handle_ptr
@@ -461,10 +882,11 @@ void _wlmaker_launcher_handle_terminated(
  */
 void _wlmaker_launcher_handle_window_created(
     void *userdata_ptr,
-    __UNUSED__ wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
     wlmtk_window_t *window_ptr)
 {
     wlmaker_launcher_t *launcher_ptr = userdata_ptr;
+    if (launcher_ptr->prelaunched_handle_ptr == subprocess_handle_ptr) return;
 
     bool rv = bs_ptr_set_insert(launcher_ptr->created_windows_ptr, window_ptr);
     if (!rv) bs_log(BS_ERROR, "Failed bs_ptr_set_insert(%p)", window_ptr);
@@ -493,7 +915,12 @@ void _wlmaker_launcher_handle_window_mapped(
     // TODO(kaeser@gubbe.ch): Appears we do encounter this scenario. File this
     // as a bug and fix it.
     // BS_ASSERT(bs_ptr_set_contains(launcher_ptr->created_windows_ptr, window_ptr));
+    if (!bs_ptr_set_contains(launcher_ptr->created_windows_ptr, window_ptr) &&
+        !bs_ptr_set_insert(launcher_ptr->created_windows_ptr, window_ptr)) {
+        bs_log(BS_ERROR, "Failed bs_ptr_set_insert(%p)", window_ptr);
+    }
 
+    bs_ptr_set_erase(launcher_ptr->hidden_windows_ptr, window_ptr);
     bool rv = bs_ptr_set_insert(launcher_ptr->mapped_windows_ptr, window_ptr);
     if (!rv) bs_log(BS_ERROR, "Failed bs_ptr_set_insert(%p)", window_ptr);
 
@@ -542,6 +969,7 @@ void _wlmaker_launcher_handle_window_destroyed(
     wlmaker_launcher_t *launcher_ptr = userdata_ptr;
 
     bs_ptr_set_erase(launcher_ptr->created_windows_ptr, window_ptr);
+    bs_ptr_set_erase(launcher_ptr->hidden_windows_ptr, window_ptr);
 
     _wlmaker_launcher_update_overlay(launcher_ptr);
 }
@@ -549,9 +977,15 @@ void _wlmaker_launcher_handle_window_destroyed(
 /* == Unit tests =========================================================== */
 
 static void test_create_from_plist(bs_test_t *test_ptr);
+static void test_resolve_cmdline(bs_test_t *test_ptr);
+static void test_cmdline(bs_test_t *test_ptr);
+static void test_overlay_cache(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmaker_launcher_test_cases[] = {
     { 1, "create_from_plist", test_create_from_plist },
+    { 1, "resolve_cmdline", test_resolve_cmdline },
+    { 1, "cmdline", test_cmdline },
+    { 1, "overlay_cache", test_overlay_cache },
     { 0, NULL, NULL }
 };
 
@@ -578,4 +1012,119 @@ void test_create_from_plist(bs_test_t *test_ptr)
     wlmaker_launcher_destroy(launcher_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests resolving the executable of a commandline. */
+void test_resolve_cmdline(bs_test_t *test_ptr)
+{
+    const char *search_path_ptr = "/nonexistent::/bin:/usr/bin";
+    char *r_ptr = _wlmaker_launcher_resolve_cmdline(
+        "  sh -c true", search_path_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, r_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, '/', r_ptr[0]);
+    size_t len = strlen(r_ptr);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, len > 12);
+    BS_TEST_VERIFY_STREQ(test_ptr, "/sh -c true", r_ptr + len - 11);
+    free(r_ptr);
+
+    // Paths, quotes and unknown executables are not resolved.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL,
+        _wlmaker_launcher_resolve_cmdline("/bin/sh -c true", search_path_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL,
+        _wlmaker_launcher_resolve_cmdline("\"sh\" -c true", search_path_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL,
+        _wlmaker_launcher_resolve_cmdline("wlmaker-nonexistent-command",
+                                          search_path_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL,
+        _wlmaker_launcher_resolve_cmdline("", search_path_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL, _wlmaker_launcher_resolve_cmdline("sh", NULL));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies overlays are shared by size and status, and released. */
+void test_overlay_cache(bs_test_t *test_ptr)
+{
+    wlmaker_launcher_overlay_t *o1_ptr = _wlmaker_launcher_overlay_acquire(
+        64, WLMAKER_LAUNCHER_STATUS_RUNNING);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, o1_ptr);
+    wlmaker_launcher_overlay_t *o2_ptr = _wlmaker_launcher_overlay_acquire(
+        64, WLMAKER_LAUNCHER_STATUS_RUNNING);
+    BS_TEST_VERIFY_EQ(test_ptr, o1_ptr, o2_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, o1_ptr->references);
+
+    // Other size or status: A different overlay.
+    wlmaker_launcher_overlay_t *o3_ptr = _wlmaker_launcher_overlay_acquire(
+        48, WLMAKER_LAUNCHER_STATUS_RUNNING);
+    BS_TEST_VERIFY_NEQ(test_ptr, o1_ptr, o3_ptr);
+    wlmaker_launcher_overlay_t *o4_ptr = _wlmaker_launcher_overlay_acquire(
+        64, WLMAKER_LAUNCHER_STATUS_STARTED);
+    BS_TEST_VERIFY_NEQ(test_ptr, o1_ptr, o4_ptr);
+
+    _wlmaker_launcher_overlay_release(o4_ptr);
+    _wlmaker_launcher_overlay_release(o3_ptr);
+    _wlmaker_launcher_overlay_release(o2_ptr);
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, bs_dllist_empty(&_wlmaker_launcher_overlay_cache));
+    _wlmaker_launcher_overlay_release(o1_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, bs_dllist_empty(&_wlmaker_launcher_overlay_cache));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests that the commandline is resolved again, if $PATH or files change. */
+void test_cmdline(bs_test_t *test_ptr)
+{
+    char dir[] = "/tmp/wlmaker-launcher-XXXXXX";
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, mkdtemp(dir));
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/wlmaker-test-app", dir);
+    int fd = open(path, O_WRONLY | O_CREAT | O_EXCL, 0755);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, 0 <= fd);
+    close(fd);
+    char expected[PATH_MAX + 8];
+    snprintf(expected, sizeof(expected), "%s --arg", path);
+
+    char *orig_search_path_ptr = NULL;
+    if (NULL != getenv("PATH")) {
+        orig_search_path_ptr = logged_strdup(getenv("PATH"));
+    }
+    char cmdline[] = "wlmaker-test-app --arg";
+    wlmaker_launcher_t launcher = { .cmdline_ptr = cmdline };
+
+    // Not found in $PATH: Uses the commandline as configured.
+    setenv("PATH", "/nonexistent", 1);
+    BS_TEST_VERIFY_STREQ(
+        test_ptr, cmdline, _wlmaker_launcher_cmdline(&launcher));
+
+    // $PATH changed: Resolves again, and now finds it.
+    setenv("PATH", dir, 1);
+    BS_TEST_VERIFY_STREQ(
+        test_ptr, expected, _wlmaker_launcher_cmdline(&launcher));
+    BS_TEST_VERIFY_STREQ(
+        test_ptr, expected, _wlmaker_launcher_cmdline(&launcher));
+
+    // The executable is gone: Falls back to the search at launch.
+    unlink(path);
+    BS_TEST_VERIFY_STREQ(
+        test_ptr, cmdline, _wlmaker_launcher_cmdline(&launcher));
+    rmdir(dir);
+
+    if (NULL != orig_search_path_ptr) {
+        setenv("PATH", orig_search_path_ptr, 1);
+        free(orig_search_path_ptr);
+    } else {
+        unsetenv("PATH");
+    }
+    if (NULL != launcher.resolved_cmdline_ptr) {
+        free(launcher.resolved_cmdline_ptr);
+    }
+    if (NULL != launcher.resolved_search_path_ptr) {
+        free(launcher.resolved_search_path_ptr);
+    }
+}
+
 /* == End of launcher.c ==================================================== */
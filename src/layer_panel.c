@@ -24,6 +24,7 @@
 #include <libbase/libbase.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 #include <wayland-server-core.h>
 #include <wayland-server-protocol.h>
 #define WLR_USE_UNSTABLE
@@ -57,6 +58,12 @@ struct _wlmaker_layer_panel_t {
 
     /** Listener for the `commit` signal raised by `wlr_surface`. */
     struct wl_listener        surface_commit_listener;
+    /** Whether the positioning of a commit was applied already. */
+    bool                      committed;
+    /** Keyboard interactivity of the last commit. Valid if `committed`. */
+    enum zwlr_layer_surface_v1_keyboard_interactivity keyboard_interactive;
+    /** Layer of the last commit. Valid if `committed`. */
+    enum zwlr_layer_shell_v1_layer layer;
 
     /** Listener for the `destroy` signal raised by `wlr_layer_surface_v1`. */
     struct wl_listener        destroy_listener;
@@ -417,6 +424,7 @@ void _wlmaker_layer_panel_handle_surface_commit(
     struct wl_listener *listener_ptr,
     __UNUSED__ void *data_ptr)
 {
+    WLMTK_TRACE_SPAN("layer_panel_commit");
     wlmaker_layer_panel_t *layer_panel_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmaker_layer_panel_t, surface_commit_listener);
 
@@ -435,11 +443,19 @@ void _wlmaker_layer_panel_handle_surface_commit(
 
         .exclusive_zone = state_ptr->exclusive_zone
     };
+    // Status bars commit frequently, but rarely change position: Skip the
+    // checks and the panel's commit if nothing positional changed.
+    bool positioning_changed =
+        !layer_panel_ptr->committed ||
+        0 != memcmp(&layer_panel_ptr->super_panel.positioning, &pos,
+                    sizeof(wlmtk_panel_positioning_t));
+
     // Sanity check position and anchor values.
-    if ((0 == pos.desired_width &&
-         0 == (pos.anchor & (WLR_EDGE_LEFT | WLR_EDGE_RIGHT))) ||
-        (0 == pos.desired_height &&
-         0 == (pos.anchor & (WLR_EDGE_TOP | WLR_EDGE_BOTTOM)))) {
+    if (positioning_changed &&
+        ((0 == pos.desired_width &&
+          0 == (pos.anchor & (WLR_EDGE_LEFT | WLR_EDGE_RIGHT))) ||
+         (0 == pos.desired_height &&
+          0 == (pos.anchor & (WLR_EDGE_TOP | WLR_EDGE_BOTTOM))))) {
         wl_resource_post_error(
             layer_panel_ptr->wlr_layer_surface_v1_ptr->resource,
             ZWLR_LAYER_SURFACE_V1_ERROR_INVALID_SIZE,
@@ -447,19 +463,35 @@ void _wlmaker_layer_panel_handle_surface_commit(
             pos.desired_width, pos.desired_height, pos.anchor);
     }
 
-    wlmtk_panel_commit(
-        &layer_panel_ptr->super_panel,
-        state_ptr->configure_serial,
-        &pos);
+    if (positioning_changed) {
+        wlmtk_panel_commit(
+            &layer_panel_ptr->super_panel,
+            state_ptr->configure_serial,
+            &pos);
+    }
 
-    // Updates keyboard and layer values. Ignore failures here.
+    // Updates keyboard and layer values. Ignore failures here. The layer
+    // is applied on each commit, as it follows the current workspace, but
+    // that returns early when unchanged. Exclusive keyboard interactivity
+    // is applied on each commit, to re-activate the surface.
     _wlmaker_layer_panel_apply_layer(
         layer_panel_ptr,
         state_ptr->layer);
-    _wlmaker_layer_panel_apply_keyboard(
-        layer_panel_ptr,
-        state_ptr->keyboard_interactive,
-        state_ptr->layer);
+    if (!layer_panel_ptr->committed ||
+        ZWLR_LAYER_SURFACE_V1_KEYBOARD_INTERACTIVITY_EXCLUSIVE ==
+        state_ptr->keyboard_interactive ||
+        layer_panel_ptr->keyboard_interactive !=
+        state_ptr->keyboard_interactive ||
+        layer_panel_ptr->layer != state_ptr->layer) {
+        _wlmaker_layer_panel_apply_keyboard(
+            layer_panel_ptr,
+            state_ptr->keyboard_interactive,
+            state_ptr->layer);
+    }
+
+    layer_panel_ptr->committed = true;
+    layer_panel_ptr->keyboard_interactive = state_ptr->keyboard_interactive;
+    layer_panel_ptr->layer = state_ptr->layer;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -351,8 +351,9 @@ wlmaker_lock_t *_wlmaker_lock_create(
         &lock_ptr->destroy_listener,
         _wlmaker_lock_handle_destroy);
 
-    wlmtk_util_connect_listener_signal(
-        &wlr_output_layout_ptr->events.change,
+    wlmtk_layout_epoch_connect(
+        wlr_output_layout_ptr,
+        WLMTK_LAYOUT_EPOCH_STAGE_OUTPUTS,
         &lock_ptr->output_layout_change_listener,
         _wlmaker_lock_handle_output_layout_change);
     _wlmaker_lock_handle_output_layout_change(
@@ -785,6 +786,7 @@ void _wlmaker_lock_surface_handle_surface_commit(
     struct wl_listener *listener_ptr,
     __UNUSED__ void *data_ptr)
 {
+    WLMTK_TRACE_SPAN("lock_surface_commit");
     wlmaker_lock_surface_t *lock_surface_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmaker_lock_surface_t, surface_commit_listener);
     struct wlr_session_lock_surface_v1 *wlr_session_lock_surface_v1_ptr =
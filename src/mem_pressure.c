@@ -0,0 +1,285 @@
+/* ========================================================================= */
+/**
+ * @file mem_pressure.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mem_pressure.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <wayland-server-core.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif  // defined(__GLIBC__)
+
+#include "toolkit/toolkit.h"
+
+/* == Declarations ========================================================= */
+
+/** A PSI trigger, and what to evict when it fires. */
+typedef struct {
+    /** Trigger to write to the PSI file: Kind, stall and window in usec. */
+    const char                *trigger_ptr;
+    /** Percentage to evict from the caches. */
+    unsigned                  percent;
+} wlmaker_mem_pressure_trigger_t;
+
+/** Number of triggers. */
+#define WLMAKER_MEM_PRESSURE_TRIGGERS 2
+
+/** State of the memory pressure monitor. */
+struct _wlmaker_mem_pressure_t {
+    /** One file descriptor of the PSI file per trigger, or -1. */
+    int                       psi_fds[WLMAKER_MEM_PRESSURE_TRIGGERS];
+    /**
+     * Epoll instance for the PSI file descriptors. PSI triggers signal
+     * `EPOLLPRI`, which the event loop does not watch for: The loop watches
+     * this instance instead, which gets readable with any event.
+     */
+    int                       epoll_fd;
+    /** Event source for `epoll_fd`. */
+    struct wl_event_source    *wl_event_source_ptr;
+};
+
+static bool _wlmaker_mem_pressure_add_trigger(
+    wlmaker_mem_pressure_t *mem_pressure_ptr,
+    const char *path_ptr,
+    size_t idx);
+static int _wlmaker_mem_pressure_handle_epoll(
+    int fd,
+    uint32_t mask,
+    void *data_ptr);
+
+/* == Data ================================================================= */
+
+/**
+ * The triggers. Windows are multiples of 2 seconds, as required for
+ * unprivileged processes.
+ */
+static const wlmaker_mem_pressure_trigger_t _wlmaker_mem_pressure_triggers[
+    WLMAKER_MEM_PRESSURE_TRIGGERS] = {
+    // Some tasks stalled for 10% of the window: Give back half.
+    { "some 200000 2000000", 50 },
+    // All tasks stalled for 5% of the window: Give back all we can.
+    { "full 100000 2000000", 100 },
+};
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmaker_mem_pressure_t *wlmaker_mem_pressure_create(
+    struct wl_event_loop *wl_event_loop_ptr,
+    const char *path_ptr)
+{
+    wlmaker_mem_pressure_t *mem_pressure_ptr = logged_calloc(
+        1, sizeof(wlmaker_mem_pressure_t));
+    if (NULL == mem_pressure_ptr) return NULL;
+    for (size_t i = 0; i < WLMAKER_MEM_PRESSURE_TRIGGERS; ++i) {
+        mem_pressure_ptr->psi_fds[i] = -1;
+    }
+    if (NULL == path_ptr) path_ptr = "/proc/pressure/memory";
+
+    mem_pressure_ptr->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (0 > mem_pressure_ptr->epoll_fd) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed epoll_create1(EPOLL_CLOEXEC)");
+        wlmaker_mem_pressure_destroy(mem_pressure_ptr);
+        return NULL;
+    }
+    for (size_t i = 0; i < WLMAKER_MEM_PRESSURE_TRIGGERS; ++i) {
+        if (!_wlmaker_mem_pressure_add_trigger(
+                mem_pressure_ptr, path_ptr, i)) {
+            wlmaker_mem_pressure_destroy(mem_pressure_ptr);
+            return NULL;
+        }
+    }
+
+    mem_pressure_ptr->wl_event_source_ptr = wl_event_loop_add_fd(
+        wl_event_loop_ptr,
+        mem_pressure_ptr->epoll_fd,
+        WL_EVENT_READABLE,
+        _wlmaker_mem_pressure_handle_epoll,
+        mem_pressure_ptr);
+    if (NULL == mem_pressure_ptr->wl_event_source_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_fd(%p, %d, ...)",
+               wl_event_loop_ptr, mem_pressure_ptr->epoll_fd);
+        wlmaker_mem_pressure_destroy(mem_pressure_ptr);
+        return NULL;
+    }
+    bs_log(BS_INFO, "Monitoring memory pressure at %s", path_ptr);
+    return mem_pressure_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_mem_pressure_destroy(wlmaker_mem_pressure_t *mem_pressure_ptr)
+{
+    if (NULL != mem_pressure_ptr->wl_event_source_ptr) {
+        wl_event_source_remove(mem_pressure_ptr->wl_event_source_ptr);
+        mem_pressure_ptr->wl_event_source_ptr = NULL;
+    }
+    for (size_t i = 0; i < WLMAKER_MEM_PRESSURE_TRIGGERS; ++i) {
+        if (0 > mem_pressure_ptr->psi_fds[i]) continue;
+        close(mem_pressure_ptr->psi_fds[i]);
+        mem_pressure_ptr->psi_fds[i] = -1;
+    }
+    if (0 <= mem_pressure_ptr->epoll_fd) {
+        close(mem_pressure_ptr->epoll_fd);
+        mem_pressure_ptr->epoll_fd = -1;
+    }
+    free(mem_pressure_ptr);
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Opens the PSI file, writes trigger `idx` and adds it to the epoll instance.
+ *
+ * @param mem_pressure_ptr
+ * @param path_ptr
+ * @param idx
+ *
+ * @return true on success.
+ */
+bool _wlmaker_mem_pressure_add_trigger(
+    wlmaker_mem_pressure_t *mem_pressure_ptr,
+    const char *path_ptr,
+    size_t idx)
+{
+    const wlmaker_mem_pressure_trigger_t *t_ptr =
+        &_wlmaker_mem_pressure_triggers[idx];
+    // Each file descriptor holds at most one trigger.
+    int fd = open(path_ptr, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (0 > fd) {
+        bs_log(BS_INFO | BS_ERRNO, "Failed open(%s, O_RDWR), not monitoring "
+               "memory pressure.", path_ptr);
+        return false;
+    }
+    mem_pressure_ptr->psi_fds[idx] = fd;
+
+    size_t len = strlen(t_ptr->trigger_ptr) + 1;
+    if (len != (size_t)write(fd, t_ptr->trigger_ptr, len)) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed write(%d, \"%s\") to %s",
+               fd, t_ptr->trigger_ptr, path_ptr);
+        return false;
+    }
+
+    struct epoll_event event = {
+        .events = EPOLLPRI,
+        .data = { .u32 = t_ptr->percent }
+    };
+    if (0 != epoll_ctl(mem_pressure_ptr->epoll_fd, EPOLL_CTL_ADD, fd,
+                       &event)) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed epoll_ctl(%d, EPOLL_CTL_ADD, "
+               "%d) for %s", mem_pressure_ptr->epoll_fd, fd, path_ptr);
+        return false;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles events of the epoll instance: A trigger fired. Evicts from the
+ * caches, by the largest percentage of the fired triggers.
+ *
+ * @param fd
+ * @param mask
+ * @param data_ptr
+ *
+ * @return 0.
+ */
+int _wlmaker_mem_pressure_handle_epoll(
+    int fd,
+    __UNUSED__ uint32_t mask,
+    void *data_ptr)
+{
+    wlmaker_mem_pressure_t *mem_pressure_ptr = data_ptr;
+    struct epoll_event events[WLMAKER_MEM_PRESSURE_TRIGGERS];
+    int n = epoll_wait(fd, events, WLMAKER_MEM_PRESSURE_TRIGGERS, 0);
+    if (0 > n) {
+        if (EINTR != errno) {
+            bs_log(BS_WARNING | BS_ERRNO, "Failed epoll_wait(%d, ...)", fd);
+        }
+        return 0;
+    }
+
+    unsigned percent = 0;
+    for (int i = 0; i < n; ++i) {
+        if (events[i].events & EPOLLERR) {
+            // The monitored resource is gone. Stop listening entirely.
+            bs_log(BS_WARNING, "PSI trigger failed, stopping to monitor "
+                   "memory pressure.");
+            wl_event_source_remove(mem_pressure_ptr->wl_event_source_ptr);
+            mem_pressure_ptr->wl_event_source_ptr = NULL;
+            return 0;
+        }
+        if (events[i].events & EPOLLPRI) {
+            percent = BS_MAX(percent, events[i].data.u32);
+        }
+    }
+    if (0 == percent) return 0;
+
+    bs_log(BS_WARNING, "Memory pressure: Evicting %u%% of caches.", percent);
+    wlmtk_cache_evict(percent);
+#if defined(__GLIBC__)
+    // Freed chunks may otherwise remain with the process.
+    malloc_trim(0);
+#endif  // defined(__GLIBC__)
+    return 0;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_unavailable(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_mem_pressure_test_cases[] = {
+    { 1, "unavailable", test_unavailable },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Without a PSI file, or with a file not supporting triggers: Fails. */
+void test_unavailable(bs_test_t *test_ptr)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL,
+        wlmaker_mem_pressure_create(wl_event_loop_ptr, "/nonexistent"));
+
+    // A regular file accepts the trigger, but doesn't support epoll.
+    char path[] = "/tmp/wlmaker_mem_pressure_test_XXXXXX";
+    int fd = mkstemp(path);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, -1, fd);
+    close(fd);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL,
+        wlmaker_mem_pressure_create(wl_event_loop_ptr, path));
+    unlink(path);
+
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
+/* == End of mem_pressure.c ================================================ */
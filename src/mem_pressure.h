@@ -0,0 +1,68 @@
+/* ========================================================================= */
+/**
+ * @file mem_pressure.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __MEM_PRESSURE_H__
+#define __MEM_PRESSURE_H__
+
+#include <libbase/libbase.h>
+#include <wayland-server-core.h>
+
+/** Forward declaration: Monitor of memory pressure. */
+typedef struct _wlmaker_mem_pressure_t wlmaker_mem_pressure_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Creates a monitor of the system's memory pressure, through PSI triggers.
+ *
+ * When tasks were stalled on memory for a while, half of the content of all
+ * caches registered with @ref wlmtk_cache_register is evicted. When all
+ * tasks were stalled, everything that is not in use gets evicted. Either
+ * way, hibernated workspaces drop their buffers, and the freed bytes are
+ * logged.
+ *
+ * @param wl_event_loop_ptr
+ * @param path_ptr            Path to the PSI file, or NULL for the system's
+ *                            `/proc/pressure/memory`.
+ *
+ * @return Pointer to the monitor, or NULL if PSI is not available. Must be
+ *     destroyed by @ref wlmaker_mem_pressure_destroy.
+ */
+wlmaker_mem_pressure_t *wlmaker_mem_pressure_create(
+    struct wl_event_loop *wl_event_loop_ptr,
+    const char *path_ptr);
+
+/**
+ * Destroys the monitor.
+ *
+ * @param mem_pressure_ptr
+ */
+void wlmaker_mem_pressure_destroy(wlmaker_mem_pressure_t *mem_pressure_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_mem_pressure_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __MEM_PRESSURE_H__ */
+/* == End of mem_pressure.h ================================================ */
@@ -0,0 +1,168 @@
+/* ========================================================================= */
+/**
+ * @file memlock.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/// dl_iterate_phdr() is a GNU extension.
+#define _GNU_SOURCE
+
+#include "memlock.h"
+
+#include <libbase/libbase.h>
+#include <link.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* == Declarations ========================================================= */
+
+/** Tally of @ref _wlmaker_memlock_object. */
+typedef struct {
+    /** Bytes locked. */
+    size_t                    bytes;
+    /** Whether all segments could be locked. */
+    bool                      success;
+} wlmaker_memlock_tally_t;
+
+static int _wlmaker_memlock_object(
+    struct dl_phdr_info *info_ptr,
+    size_t size,
+    void *data_ptr);
+static bool _wlmaker_memlock_is_hot(const char *name_ptr);
+
+/* == Data ================================================================= */
+
+/** Prefixes of the libraries' file names to lock. */
+static const char *_wlmaker_memlock_hot_libraries[] = {
+    "libc.so",
+    "libinput.so",
+    "libpixman-1.so",
+    "libwayland-server.so",
+    "libwlroots",
+    "libxkbcommon.so",
+    NULL
+};
+
+/** Bytes locked by @ref wlmaker_memlock_code. */
+static size_t _wlmaker_memlock_code_bytes;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+bool wlmaker_memlock_code(void)
+{
+    wlmaker_memlock_tally_t tally = { .success = true };
+    dl_iterate_phdr(_wlmaker_memlock_object, &tally);
+    _wlmaker_memlock_code_bytes += tally.bytes;
+    bs_log(BS_INFO, "Locked %zu bytes of code and data in memory.",
+           tally.bytes);
+    return tally.success;
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmaker_memlock_code_bytes(void)
+{
+    return _wlmaker_memlock_code_bytes;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Callback for dl_iterate_phdr(): Locks the loadable segments of the object,
+ * if it is the executable or a hot library.
+ *
+ * @param info_ptr
+ * @param size
+ * @param data_ptr            Points to a @ref wlmaker_memlock_tally_t.
+ *
+ * @return 0, to continue iterating.
+ */
+static int _wlmaker_memlock_object(
+    struct dl_phdr_info *info_ptr,
+    __UNUSED__ size_t size,
+    void *data_ptr)
+{
+    wlmaker_memlock_tally_t *tally_ptr = data_ptr;
+    // The executable is reported first, with an empty name.
+    const char *name_ptr = info_ptr->dlpi_name;
+    if (NULL != name_ptr && '\0' != *name_ptr &&
+        !_wlmaker_memlock_is_hot(name_ptr)) return 0;
+
+    uintptr_t page_size = sysconf(_SC_PAGESIZE);
+    for (ElfW(Half) i = 0; i < info_ptr->dlpi_phnum; ++i) {
+        const ElfW(Phdr) *phdr_ptr = &info_ptr->dlpi_phdr[i];
+        if (PT_LOAD != phdr_ptr->p_type || 0 == phdr_ptr->p_memsz) continue;
+
+        uintptr_t start = info_ptr->dlpi_addr + phdr_ptr->p_vaddr;
+        uintptr_t end = start + phdr_ptr->p_memsz;
+        start = start / page_size * page_size;
+        end = (end + page_size - 1) / page_size * page_size;
+        if (0 != mlock((void*)start, end - start)) {
+            bs_log(BS_WARNING | BS_ERRNO, "Failed mlock(%p, %zu) for %s. "
+                   "Check RLIMIT_MEMLOCK.", (void*)start,
+                   (size_t)(end - start),
+                   (NULL != name_ptr && '\0' != *name_ptr) ?
+                   name_ptr : "executable");
+            tally_ptr->success = false;
+            continue;
+        }
+        tally_ptr->bytes += end - start;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Whether the file name of `path_ptr` is a hot library. */
+static bool _wlmaker_memlock_is_hot(const char *path_ptr)
+{
+    const char *name_ptr = strrchr(path_ptr, '/');
+    name_ptr = NULL != name_ptr ? name_ptr + 1 : path_ptr;
+    for (const char **l_ptr = _wlmaker_memlock_hot_libraries;
+         NULL != *l_ptr;
+         ++l_ptr) {
+        if (0 == strncmp(name_ptr, *l_ptr, strlen(*l_ptr))) return true;
+    }
+    return false;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_is_hot(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_memlock_test_cases[] = {
+    { 1, "is_hot", test_is_hot },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Verifies which libraries are considered hot. */
+void test_is_hot(bs_test_t *test_ptr)
+{
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, _wlmaker_memlock_is_hot("/usr/lib/libwlroots-0.19.so"));
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmaker_memlock_is_hot("libc.so.6"));
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, _wlmaker_memlock_is_hot("/usr/lib/libcairo.so.2"));
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, _wlmaker_memlock_is_hot("/usr/lib/libLLVM.so.19"));
+}
+
+/* == End of memlock.c ===================================================== */
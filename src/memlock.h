@@ -0,0 +1,53 @@
+/* ========================================================================= */
+/**
+ * @file memlock.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __MEMLOCK_H__
+#define __MEMLOCK_H__
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Locks the loaded segments of the compositor's executable in memory, and
+ * those of the libraries on the input and frame paths: libc, wayland,
+ * wlroots, libinput, xkbcommon and pixman. Keeps the cursor and frames
+ * from stalling on page faults when the system swaps.
+ *
+ * @return true if all segments were locked. Logs a warning for segments
+ *     that could not be locked, eg. exceeding `RLIMIT_MEMLOCK`.
+ */
+bool wlmaker_memlock_code(void);
+
+/** @return Number of bytes locked by @ref wlmaker_memlock_code. */
+size_t wlmaker_memlock_code_bytes(void);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_memlock_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __MEMLOCK_H__ */
+/* == End of memlock.h ===================================================== */
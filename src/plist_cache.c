@@ -0,0 +1,617 @@
+/* ========================================================================= */
+/**
+ * @file plist_cache.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/// mkdtemp() and struct stat::st_mtim are POSIX extensions.
+#define _POSIX_C_SOURCE 200809L
+
+#include "plist_cache.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <libbase/libbase.h>
+#include <libbase/plist.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* == Declarations ========================================================= */
+
+/** Magic bytes at the start of each cache file. Last byte is the version. */
+static const char _wlmaker_plist_cache_magic[8] = "WLMPLC\0\1";
+
+/** Nesting depth beyond which a cache file is considered corrupt. */
+static const int _wlmaker_plist_cache_max_depth = 64;
+
+/**
+ * Header of a cache file. Followed by the source path (without terminating
+ * NUL), and then the serialized object.
+ *
+ * Objects are serialized as a type byte and a 32-bit count: For strings,
+ * the count of bytes that follow. For arrays, the count of objects that
+ * follow. For dicts, the count of items, each a 32-bit key length, the key
+ * bytes and the value object.
+ */
+typedef struct {
+    /** See @ref _wlmaker_plist_cache_magic. */
+    char                      magic[8];
+    /** Modification time of the source file, seconds. */
+    int64_t                   mtime_sec;
+    /** Modification time of the source file, nanoseconds. */
+    int64_t                   mtime_nsec;
+    /** Size of the source file, in bytes. */
+    uint64_t                  size;
+    /** Length of the source path following the header. */
+    uint64_t                  path_len;
+} wlmaker_plist_cache_header_t;
+
+/** Argument to @ref _wlmaker_plist_cache_write_item. */
+typedef struct {
+    /** File to write the items to. NULL to just count the items. */
+    FILE                      *file_ptr;
+    /** Number of items visited. */
+    size_t                    count;
+} wlmaker_plist_cache_item_arg_t;
+
+/** Reader state for de-serializing a cache file. */
+typedef struct {
+    /** Current position. */
+    const uint8_t             *pos_ptr;
+    /** End of the data. */
+    const uint8_t             *end_ptr;
+} wlmaker_plist_cache_reader_t;
+
+static bspl_object_t *_wlmaker_plist_cache_load(
+    const char *fname_ptr,
+    const char *cache_dir_ptr,
+    bool *hit_ptr);
+static bool _wlmaker_plist_cache_fname(
+    const char *cache_dir_ptr,
+    const char *fname_ptr,
+    char *buf_ptr,
+    size_t size);
+static bspl_object_t *_wlmaker_plist_cache_read(
+    const char *cache_fname_ptr,
+    const char *fname_ptr,
+    const struct stat *stat_ptr);
+static void _wlmaker_plist_cache_write(
+    const char *cache_fname_ptr,
+    const char *fname_ptr,
+    const struct stat *stat_ptr,
+    bspl_object_t *object_ptr);
+
+static bool _wlmaker_plist_cache_write_object(
+    FILE *file_ptr,
+    bspl_object_t *object_ptr);
+static bool _wlmaker_plist_cache_write_item(
+    const char *key_ptr,
+    bspl_object_t *object_ptr,
+    void *userdata_ptr);
+static bool _wlmaker_plist_cache_write_tag(
+    FILE *file_ptr,
+    uint8_t type,
+    size_t count);
+static bspl_object_t *_wlmaker_plist_cache_read_object(
+    wlmaker_plist_cache_reader_t *reader_ptr,
+    int depth);
+static bool _wlmaker_plist_cache_read_tag(
+    wlmaker_plist_cache_reader_t *reader_ptr,
+    uint8_t *type_ptr,
+    uint32_t *count_ptr);
+static char *_wlmaker_plist_cache_read_string(
+    wlmaker_plist_cache_reader_t *reader_ptr,
+    uint32_t len);
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+bspl_object_t *wlmaker_plist_cache_load(const char *fname_ptr)
+{
+    char cache_dir[PATH_MAX];
+    if (!wlmaker_plist_cache_dir(cache_dir, sizeof(cache_dir))) {
+        return bspl_create_object_from_plist_file(fname_ptr);
+    }
+    bool hit;
+    return _wlmaker_plist_cache_load(fname_ptr, cache_dir, &hit);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmaker_plist_cache_dir(char *buf_ptr, size_t size)
+{
+    const char *xdg_cache_home_ptr = getenv("XDG_CACHE_HOME");
+    const char *home_ptr = getenv("HOME");
+    char base[PATH_MAX];
+    int rv;
+    if (NULL != xdg_cache_home_ptr && '/' == *xdg_cache_home_ptr) {
+        rv = snprintf(base, sizeof(base), "%s", xdg_cache_home_ptr);
+    } else if (NULL != home_ptr && '\0' != *home_ptr) {
+        rv = snprintf(base, sizeof(base), "%s/.cache", home_ptr);
+    } else {
+        return false;
+    }
+    if (0 > rv || sizeof(base) <= (size_t)rv) return false;
+    rv = snprintf(buf_ptr, size, "%s/wlmaker", base);
+    if (0 > rv || size <= (size_t)rv) return false;
+
+    if ((0 != mkdir(base, 0700) && EEXIST != errno) ||
+        (0 != mkdir(buf_ptr, 0700) && EEXIST != errno)) {
+        bs_log(BS_DEBUG | BS_ERRNO, "Failed mkdir(%s)", buf_ptr);
+        return false;
+    }
+    return true;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Loads `fname_ptr` through a cache in `cache_dir_ptr`.
+ *
+ * @param fname_ptr
+ * @param cache_dir_ptr
+ * @param hit_ptr             Set to whether the object came from the cache.
+ *
+ * @return A bspl_object_t, or NULL on error.
+ */
+bspl_object_t *_wlmaker_plist_cache_load(
+    const char *fname_ptr,
+    const char *cache_dir_ptr,
+    bool *hit_ptr)
+{
+    *hit_ptr = false;
+    struct stat stat_buf;
+    char cache_fname[PATH_MAX];
+    if (0 != stat(fname_ptr, &stat_buf) ||
+        !_wlmaker_plist_cache_fname(
+            cache_dir_ptr, fname_ptr, cache_fname, sizeof(cache_fname))) {
+        return bspl_create_object_from_plist_file(fname_ptr);
+    }
+
+    bspl_object_t *object_ptr = _wlmaker_plist_cache_read(
+        cache_fname, fname_ptr, &stat_buf);
+    if (NULL != object_ptr) {
+        *hit_ptr = true;
+        return object_ptr;
+    }
+
+    object_ptr = bspl_create_object_from_plist_file(fname_ptr);
+    if (NULL != object_ptr) {
+        _wlmaker_plist_cache_write(
+            cache_fname, fname_ptr, &stat_buf, object_ptr);
+    }
+    return object_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Composes the name of the cache file for `fname_ptr`, from a FNV-1a hash
+ * of the path.
+ *
+ * @param cache_dir_ptr
+ * @param fname_ptr
+ * @param buf_ptr
+ * @param size
+ *
+ * @return true on success.
+ */
+bool _wlmaker_plist_cache_fname(
+    const char *cache_dir_ptr,
+    const char *fname_ptr,
+    char *buf_ptr,
+    size_t size)
+{
+    uint64_t hash = UINT64_C(14695981039346656037);
+    for (const char *c_ptr = fname_ptr; *c_ptr != '\0'; ++c_ptr) {
+        hash = (hash ^ (uint8_t)*c_ptr) * UINT64_C(1099511628211);
+    }
+    int rv = snprintf(buf_ptr, size, "%s/%016"PRIx64".plc",
+                      cache_dir_ptr, hash);
+    return 0 <= rv && (size_t)rv < size;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Reads the object from the cache file, if it is valid for `fname_ptr`.
+ *
+ * @param cache_fname_ptr
+ * @param fname_ptr
+ * @param stat_ptr            Status of `fname_ptr`.
+ *
+ * @return The object, or NULL if the cache was absent, stale or invalid.
+ */
+bspl_object_t *_wlmaker_plist_cache_read(
+    const char *cache_fname_ptr,
+    const char *fname_ptr,
+    const struct stat *stat_ptr)
+{
+    int fd = open(cache_fname_ptr, O_RDONLY | O_CLOEXEC);
+    if (0 > fd) return NULL;
+    struct stat cache_stat;
+    if (0 != fstat(fd, &cache_stat) ||
+        (size_t)cache_stat.st_size < sizeof(wlmaker_plist_cache_header_t)) {
+        close(fd);
+        return NULL;
+    }
+    size_t size = cache_stat.st_size;
+    const uint8_t *data_ptr = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == data_ptr) return NULL;
+
+    bspl_object_t *object_ptr = NULL;
+    wlmaker_plist_cache_header_t header;
+    memcpy(&header, data_ptr, sizeof(header));
+    size_t path_len = strlen(fname_ptr);
+    wlmaker_plist_cache_reader_t reader = {
+        .pos_ptr = data_ptr + sizeof(header) + path_len,
+        .end_ptr = data_ptr + size
+    };
+    if (0 == memcmp(header.magic, _wlmaker_plist_cache_magic,
+                    sizeof(header.magic)) &&
+        header.mtime_sec == (int64_t)stat_ptr->st_mtim.tv_sec &&
+        header.mtime_nsec == (int64_t)stat_ptr->st_mtim.tv_nsec &&
+        header.size == (uint64_t)stat_ptr->st_size &&
+        header.path_len == path_len &&
+        path_len <= size - sizeof(header) &&
+        0 == memcmp(data_ptr + sizeof(header), fname_ptr, path_len)) {
+        object_ptr = _wlmaker_plist_cache_read_object(&reader, 0);
+        if (NULL != object_ptr && reader.pos_ptr != reader.end_ptr) {
+            bspl_object_unref(object_ptr);
+            object_ptr = NULL;
+        }
+    }
+    munmap((void*)data_ptr, size);
+
+    if (NULL != object_ptr) {
+        bs_log(BS_DEBUG, "Loaded \"%s\" from cache \"%s\"",
+               fname_ptr, cache_fname_ptr);
+    }
+    return object_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Writes the object to the cache file. Writes to a temporary file first,
+ * then renames it, so that readers never see a partial cache file.
+ *
+ * @param cache_fname_ptr
+ * @param fname_ptr
+ * @param stat_ptr            Status of `fname_ptr`.
+ * @param object_ptr
+ */
+void _wlmaker_plist_cache_write(
+    const char *cache_fname_ptr,
+    const char *fname_ptr,
+    const struct stat *stat_ptr,
+    bspl_object_t *object_ptr)
+{
+    char tmp_fname[PATH_MAX];
+    int rv = snprintf(tmp_fname, sizeof(tmp_fname), "%s.%ld",
+                      cache_fname_ptr, (long)getpid());
+    if (0 > rv || sizeof(tmp_fname) <= (size_t)rv) return;
+    FILE *file_ptr = fopen(tmp_fname, "wb");
+    if (NULL == file_ptr) {
+        bs_log(BS_DEBUG | BS_ERRNO, "Failed fopen(%s, \"wb\")", tmp_fname);
+        return;
+    }
+
+    wlmaker_plist_cache_header_t header = {
+        .mtime_sec = stat_ptr->st_mtim.tv_sec,
+        .mtime_nsec = stat_ptr->st_mtim.tv_nsec,
+        .size = stat_ptr->st_size,
+        .path_len = strlen(fname_ptr)
+    };
+    memcpy(header.magic, _wlmaker_plist_cache_magic, sizeof(header.magic));
+    bool written =
+        1 == fwrite(&header, sizeof(header), 1, file_ptr) &&
+        header.path_len == fwrite(fname_ptr, 1, header.path_len, file_ptr) &&
+        _wlmaker_plist_cache_write_object(file_ptr, object_ptr);
+    if (0 != fclose(file_ptr)) written = false;
+
+    if (!written || 0 != rename(tmp_fname, cache_fname_ptr)) {
+        bs_log(BS_DEBUG | BS_ERRNO, "Failed to write cache \"%s\"",
+               cache_fname_ptr);
+        unlink(tmp_fname);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Serializes `object_ptr` into `file_ptr`. */
+bool _wlmaker_plist_cache_write_object(
+    FILE *file_ptr,
+    bspl_object_t *object_ptr)
+{
+    switch (bspl_object_type(object_ptr)) {
+    case BSPL_STRING: {
+        const char *value_ptr = bspl_string_value(
+            bspl_string_from_object(object_ptr));
+        size_t len = strlen(value_ptr);
+        return _wlmaker_plist_cache_write_tag(file_ptr, 'S', len) &&
+            len == fwrite(value_ptr, 1, len, file_ptr);
+    }
+    case BSPL_ARRAY: {
+        bspl_array_t *array_ptr = bspl_array_from_object(object_ptr);
+        size_t count = bspl_array_size(array_ptr);
+        if (!_wlmaker_plist_cache_write_tag(file_ptr, 'A', count)) {
+            return false;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (!_wlmaker_plist_cache_write_object(
+                    file_ptr, bspl_array_at(array_ptr, i))) return false;
+        }
+        return true;
+    }
+    case BSPL_DICT: {
+        // Counts the items first, the tag precedes them.
+        bspl_dict_t *dict_ptr = bspl_dict_from_object(object_ptr);
+        wlmaker_plist_cache_item_arg_t arg = {};
+        if (!bspl_dict_foreach(
+                dict_ptr, _wlmaker_plist_cache_write_item, &arg) ||
+            !_wlmaker_plist_cache_write_tag(file_ptr, 'D', arg.count)) {
+            return false;
+        }
+        arg.file_ptr = file_ptr;
+        return bspl_dict_foreach(
+            dict_ptr, _wlmaker_plist_cache_write_item, &arg);
+    }
+    default:
+        return false;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Callback for bspl_dict_foreach: Writes key length, key and value of an
+ * item of a dict. Or just counts it.
+ *
+ * @param key_ptr
+ * @param object_ptr
+ * @param userdata_ptr        Points to @ref wlmaker_plist_cache_item_arg_t.
+ *
+ * @return true on success.
+ */
+bool _wlmaker_plist_cache_write_item(
+    const char *key_ptr,
+    bspl_object_t *object_ptr,
+    void *userdata_ptr)
+{
+    wlmaker_plist_cache_item_arg_t *arg_ptr = userdata_ptr;
+    ++arg_ptr->count;
+    if (NULL == arg_ptr->file_ptr) return true;
+
+    size_t len = strlen(key_ptr);
+    if (UINT32_MAX < len) return false;
+    uint32_t l = len;
+    return 1 == fwrite(&l, sizeof(l), 1, arg_ptr->file_ptr) &&
+        len == fwrite(key_ptr, 1, len, arg_ptr->file_ptr) &&
+        _wlmaker_plist_cache_write_object(arg_ptr->file_ptr, object_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Writes type tag and a 32-bit count. */
+bool _wlmaker_plist_cache_write_tag(
+    FILE *file_ptr,
+    uint8_t type,
+    size_t count)
+{
+    if (UINT32_MAX < count) return false;
+    uint32_t c = count;
+    return 1 == fwrite(&type, 1, 1, file_ptr) &&
+        1 == fwrite(&c, sizeof(c), 1, file_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * De-serializes an object.
+ *
+ * @param reader_ptr
+ * @param depth               Current nesting depth.
+ *
+ * @return The object, or NULL if the data is invalid.
+ */
+bspl_object_t *_wlmaker_plist_cache_read_object(
+    wlmaker_plist_cache_reader_t *reader_ptr,
+    int depth)
+{
+    uint8_t type;
+    uint32_t count;
+    if (_wlmaker_plist_cache_max_depth < depth ||
+        !_wlmaker_plist_cache_read_tag(reader_ptr, &type, &count)) {
+        return NULL;
+    }
+
+    if ('S' == type) {
+        char *value_ptr = _wlmaker_plist_cache_read_string(reader_ptr, count);
+        if (NULL == value_ptr) return NULL;
+        bspl_string_t *string_ptr = bspl_string_create(value_ptr);
+        free(value_ptr);
+        return bspl_object_from_string(string_ptr);
+    }
+
+    if ('A' == type) {
+        bspl_array_t *array_ptr = bspl_array_create();
+        if (NULL == array_ptr) return NULL;
+        for (uint32_t i = 0; i < count; ++i) {
+            bspl_object_t *o = _wlmaker_plist_cache_read_object(
+                reader_ptr, depth + 1);
+            bool pushed = NULL != o && bspl_array_push_back(array_ptr, o);
+            if (NULL != o) bspl_object_unref(o);
+            if (!pushed) {
+                bspl_array_unref(array_ptr);
+                return NULL;
+            }
+        }
+        return bspl_object_from_array(array_ptr);
+    }
+
+    if ('D' == type) {
+        bspl_dict_t *dict_ptr = bspl_dict_create();
+        if (NULL == dict_ptr) return NULL;
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t len;
+            if (reader_ptr->end_ptr - reader_ptr->pos_ptr <
+                (ptrdiff_t)sizeof(len)) {
+                bspl_dict_unref(dict_ptr);
+                return NULL;
+            }
+            memcpy(&len, reader_ptr->pos_ptr, sizeof(len));
+            reader_ptr->pos_ptr += sizeof(len);
+            char *key_ptr = _wlmaker_plist_cache_read_string(reader_ptr, len);
+            bspl_object_t *o = NULL;
+            if (NULL != key_ptr) {
+                o = _wlmaker_plist_cache_read_object(reader_ptr, depth + 1);
+            }
+            bool added = NULL != o && bspl_dict_add(dict_ptr, key_ptr, o);
+            if (NULL != o) bspl_object_unref(o);
+            if (NULL != key_ptr) free(key_ptr);
+            if (!added) {
+                bspl_dict_unref(dict_ptr);
+                return NULL;
+            }
+        }
+        return bspl_object_from_dict(dict_ptr);
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Reads a type tag and a 32-bit count. */
+bool _wlmaker_plist_cache_read_tag(
+    wlmaker_plist_cache_reader_t *reader_ptr,
+    uint8_t *type_ptr,
+    uint32_t *count_ptr)
+{
+    if (reader_ptr->end_ptr - reader_ptr->pos_ptr <
+        (ptrdiff_t)(1 + sizeof(uint32_t))) return false;
+    *type_ptr = *reader_ptr->pos_ptr++;
+    memcpy(count_ptr, reader_ptr->pos_ptr, sizeof(uint32_t));
+    reader_ptr->pos_ptr += sizeof(uint32_t);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Reads `len` bytes into a newly allocated, NUL-terminated string. */
+char *_wlmaker_plist_cache_read_string(
+    wlmaker_plist_cache_reader_t *reader_ptr,
+    uint32_t len)
+{
+    if (reader_ptr->end_ptr - reader_ptr->pos_ptr < (ptrdiff_t)len) {
+        return NULL;
+    }
+    char *str_ptr = logged_calloc(1, (size_t)len + 1);
+    if (NULL == str_ptr) return NULL;
+    memcpy(str_ptr, reader_ptr->pos_ptr, len);
+    str_ptr[len] = '\0';
+    reader_ptr->pos_ptr += len;
+    return str_ptr;
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlmaker_plist_cache_test_load(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_plist_cache_test_cases[] = {
+    { 1, "load", _wlmaker_plist_cache_test_load },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Writes `data_ptr` into the file `fname_ptr`. */
+static bool _wlmaker_plist_cache_test_write(
+    const char *fname_ptr,
+    const char *data_ptr)
+{
+    FILE *file_ptr = fopen(fname_ptr, "w");
+    if (NULL == file_ptr) return false;
+    bool rv = 0 <= fputs(data_ptr, file_ptr);
+    return 0 == fclose(file_ptr) && rv;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Loads a plist through the cache: Miss, hit, and miss once modified. */
+void _wlmaker_plist_cache_test_load(bs_test_t *test_ptr)
+{
+    char dir[] = "/tmp/wlmaker_plist_cache_test_XXXXXX";
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, mkdtemp(dir));
+    char fname[PATH_MAX], cache_fname[PATH_MAX];
+    snprintf(fname, sizeof(fname), "%s/test.plist", dir);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(
+        test_ptr,
+        _wlmaker_plist_cache_fname(
+            dir, fname, cache_fname, sizeof(cache_fname)));
+
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        _wlmaker_plist_cache_test_write(
+            fname,
+            "{Key = Value; Array = (A, \"B C\", {}); Sub = {S = X;};}"));
+
+    for (int i = 0; i < 2; ++i) {
+        bool hit;
+        bspl_object_t *o = _wlmaker_plist_cache_load(fname, dir, &hit);
+        BS_TEST_VERIFY_EQ(test_ptr, 1 == i, hit);
+        bspl_dict_t *d = bspl_dict_from_object(o);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, d);
+        BS_TEST_VERIFY_STREQ(
+            test_ptr, "Value", bspl_dict_get_string_value(d, "Key"));
+        bspl_array_t *a = bspl_dict_get_array(d, "Array");
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, a);
+        BS_TEST_VERIFY_EQ(test_ptr, 3, bspl_array_size(a));
+        BS_TEST_VERIFY_STREQ(
+            test_ptr, "B C", bspl_array_string_value_at(a, 1));
+        BS_TEST_VERIFY_NEQ(
+            test_ptr, NULL, bspl_dict_from_object(bspl_array_at(a, 2)));
+        BS_TEST_VERIFY_STREQ(
+            test_ptr, "X", bspl_dict_get_string_value(
+                bspl_dict_get_dict(d, "Sub"), "S"));
+        bspl_object_unref(o);
+    }
+
+    // A modified file (here: of different size) invalidates the cache.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, _wlmaker_plist_cache_test_write(fname, "{Key = Other;}"));
+    bool hit;
+    bspl_object_t *o = _wlmaker_plist_cache_load(fname, dir, &hit);
+    BS_TEST_VERIFY_FALSE(test_ptr, hit);
+    BS_TEST_VERIFY_STREQ(
+        test_ptr, "Other",
+        bspl_dict_get_string_value(bspl_dict_from_object(o), "Key"));
+    bspl_object_unref(o);
+
+    // A corrupt cache file is ignored.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, _wlmaker_plist_cache_test_write(cache_fname, "garbage"));
+    o = _wlmaker_plist_cache_load(fname, dir, &hit);
+    BS_TEST_VERIFY_FALSE(test_ptr, hit);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, o);
+    bspl_object_unref(o);
+
+    unlink(cache_fname);
+    unlink(fname);
+    rmdir(dir);
+}
+
+/* == End of plist_cache.c ================================================= */
@@ -0,0 +1,70 @@
+/* ========================================================================= */
+/**
+ * @file plist_cache.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __PLIST_CACHE_H__
+#define __PLIST_CACHE_H__
+
+#include <libbase/libbase.h>
+#include <libbase/plist.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Loads a plist object from the file at `fname_ptr`, through a compiled
+ * cache.
+ *
+ * The cache holds a binary serialization of the parsed object. It is stored
+ * in `$XDG_CACHE_HOME/wlmaker` (or `~/.cache/wlmaker`), with a name derived
+ * from a hash of `fname_ptr`. It is used only if path, modification time and
+ * size of the file all match those recorded in the cache. Otherwise, the
+ * text plist is parsed, and the cache is re-written.
+ *
+ * Failures to read or write the cache are not errors. The text plist is
+ * parsed instead.
+ *
+ * @param fname_ptr
+ *
+ * @return A bspl_object_t, or NULL if the file failed to load or parse.
+ */
+bspl_object_t *wlmaker_plist_cache_load(const char *fname_ptr);
+
+/**
+ * Determines the cache directory, and creates it if needed. That is
+ * `$XDG_CACHE_HOME/wlmaker`, or `~/.cache/wlmaker`.
+ *
+ * @param buf_ptr
+ * @param size
+ *
+ * @return true if `buf_ptr` holds an existing directory.
+ */
+bool wlmaker_plist_cache_dir(char *buf_ptr, size_t size);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_plist_cache_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __PLIST_CACHE_H__ */
+/* == End of plist_cache.h ================================================= */
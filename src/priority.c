@@ -0,0 +1,155 @@
+/* ========================================================================= */
+/**
+ * @file priority.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/// SCHED_RESET_ON_FORK is a Linux extension.
+#define _GNU_SOURCE
+
+#include "priority.h"
+
+#include <errno.h>
+#include <libbase/libbase.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <sys/resource.h>
+
+/* == Declarations ========================================================= */
+
+static bool _wlmaker_priority_nice(void);
+static bool _wlmaker_priority_realtime(void);
+
+/* == Data ================================================================= */
+
+/** Nice value for @ref WLMAKER_PRIORITY_NICE. */
+static const int _wlmaker_priority_nice_value = -10;
+/**
+ * Static priority for @ref WLMAKER_PRIORITY_REALTIME. Low, but above all
+ * normally scheduled threads. Capped by `RLIMIT_RTPRIO`, if that's set.
+ */
+static const int _wlmaker_priority_rr_priority = 2;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+bool wlmaker_priority_raise(wlmaker_priority_t priority)
+{
+    switch (priority) {
+    case WLMAKER_PRIORITY_NORMAL:
+        return true;
+    case WLMAKER_PRIORITY_NICE:
+        return _wlmaker_priority_nice();
+    case WLMAKER_PRIORITY_REALTIME:
+        if (_wlmaker_priority_realtime()) return true;
+        bs_log(BS_WARNING, "Falling back to a raised nice value.");
+        _wlmaker_priority_nice();
+        return false;
+    default:
+        break;
+    }
+    bs_log(BS_ERROR, "Unknown priority %d", priority);
+    return false;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Raises the nice value of the calling thread. Sets `SCHED_RESET_ON_FORK`
+ * first, so that children get reset to nice 0.
+ *
+ * @return true on success.
+ */
+bool _wlmaker_priority_nice(void)
+{
+    struct sched_param param = {};
+    if (0 != sched_setscheduler(0, SCHED_OTHER | SCHED_RESET_ON_FORK,
+                                &param)) {
+        bs_log(BS_WARNING | BS_ERRNO,
+               "Failed sched_setscheduler(0, SCHED_OTHER | "
+               "SCHED_RESET_ON_FORK, {0})");
+        return false;
+    }
+
+    // On Linux, the nice value is per thread: `0` is the calling thread.
+    if (0 != setpriority(PRIO_PROCESS, 0, _wlmaker_priority_nice_value)) {
+        bs_log(BS_WARNING | BS_ERRNO,
+               "Failed setpriority(PRIO_PROCESS, 0, %d). Requires "
+               "CAP_SYS_NICE or RLIMIT_NICE.", _wlmaker_priority_nice_value);
+        return false;
+    }
+    bs_log(BS_INFO, "Running compositor thread at nice %d.",
+           _wlmaker_priority_nice_value);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Schedules the calling thread as `SCHED_RR`, with `SCHED_RESET_ON_FORK`.
+ *
+ * @return true on success.
+ */
+bool _wlmaker_priority_realtime(void)
+{
+    int prio = BS_MAX(_wlmaker_priority_rr_priority,
+                      sched_get_priority_min(SCHED_RR));
+    // Without CAP_SYS_NICE, the soft RLIMIT_RTPRIO is the permitted max.
+    struct rlimit rlimit;
+    if (0 == getrlimit(RLIMIT_RTPRIO, &rlimit) &&
+        RLIM_INFINITY != rlimit.rlim_cur &&
+        0 < rlimit.rlim_cur &&
+        (rlim_t)prio > rlimit.rlim_cur) {
+        prio = rlimit.rlim_cur;
+    }
+
+    struct sched_param param = { .sched_priority = prio };
+    if (0 != sched_setscheduler(0, SCHED_RR | SCHED_RESET_ON_FORK,
+                                &param)) {
+        bs_log(BS_WARNING | BS_ERRNO,
+               "Failed sched_setscheduler(0, SCHED_RR | "
+               "SCHED_RESET_ON_FORK, {%d}). Requires CAP_SYS_NICE or "
+               "RLIMIT_RTPRIO.", prio);
+        return false;
+    }
+    bs_log(BS_INFO, "Running compositor thread as SCHED_RR, priority %d.",
+           prio);
+    return true;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_normal(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_priority_test_cases[] = {
+    { 1, "normal", test_normal },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** NORMAL leaves scheduling as it is. */
+void test_normal(bs_test_t *test_ptr)
+{
+    int policy = sched_getscheduler(0);
+    int nice = getpriority(PRIO_PROCESS, 0);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmaker_priority_raise(
+                            WLMAKER_PRIORITY_NORMAL));
+    BS_TEST_VERIFY_EQ(test_ptr, policy, sched_getscheduler(0));
+    BS_TEST_VERIFY_EQ(test_ptr, nice, getpriority(PRIO_PROCESS, 0));
+}
+
+/* == End of priority.c ==================================================== */
@@ -0,0 +1,64 @@
+/* ========================================================================= */
+/**
+ * @file priority.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __PRIORITY_H__
+#define __PRIORITY_H__
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+
+/** How to prioritize the compositor thread. */
+typedef enum {
+    /** Leaves scheduling as inherited. */
+    WLMAKER_PRIORITY_NORMAL,
+    /** Raises the thread's nice value. */
+    WLMAKER_PRIORITY_NICE,
+    /** Schedules the thread `SCHED_RR`. Falls back to a raised nice value. */
+    WLMAKER_PRIORITY_REALTIME
+} wlmaker_priority_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Raises the scheduling priority of the calling thread, as set by `priority`.
+ *
+ * Requires `CAP_SYS_NICE`, or sufficient `RLIMIT_NICE` or `RLIMIT_RTPRIO`.
+ * Any raised priority is set with `SCHED_RESET_ON_FORK`: Threads and
+ * subprocesses created thereafter, eg. through
+ * `bs_subprocess_create_cmdline`, are scheduled normally.
+ *
+ * @param priority
+ *
+ * @return true if the priority was applied as requested, or NORMAL. false if
+ *     it was not, or only partially: The thread keeps running, at whatever
+ *     priority it got.
+ */
+bool wlmaker_priority_raise(wlmaker_priority_t priority);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_priority_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __PRIORITY_H__ */
+/* == End of priority.h ==================================================== */
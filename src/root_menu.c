@@ -25,10 +25,12 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <wayland-server-core.h>
 
 #include "action.h"
 #include "action_item.h"
+#include "app_index.h"
 
 /* == Declarations ========================================================= */
 
@@ -36,6 +38,11 @@
 struct _wlmaker_root_menu_t {
     /** Window. */
     wlmtk_window_t            *window_ptr;
+    /**
+     * Holds the window while the menu is closed. Keeps its scene nodes and
+     * textures, so that opening is a move to the workspace.
+     */
+    wlmtk_container_t         parking_container;
 
     /** The root menu's window content base instance. */
     wlmtk_content_t           content;
@@ -46,29 +53,107 @@ struct _wlmaker_root_menu_t {
 
     /** Back-link to the server. */
     wlmaker_server_t          *server_ptr;
+    /** Style of the menu, for creating submenus once they are needed. */
+    const wlmtk_menu_style_t  *menu_style_ptr;
+
+    /** Submenus created on demand, @ref wlmaker_root_menu_lazy_t::dlnode. */
+    bs_dllist_t               lazy_submenus;
+    /** Delay after closing the menu, before releasing the submenus. */
+    uint64_t                  release_delay_msec;
+    /** Timer for releasing the submenus. */
+    struct wl_event_source    *release_timer_event_source_ptr;
+
+    /** Installed applications, if the menu has an "ApplicationsMenu". */
+    wlmaker_app_index_t       *app_index_ptr;
+    /** Listener for @ref wlmaker_app_index_events_t::changed. */
+    struct wl_listener        app_index_changed_listener;
 };
 
+/** A submenu item, where the submenu is created when first highlighted. */
+typedef struct {
+    /** Element of @ref wlmaker_root_menu_t::lazy_submenus, if created. */
+    bs_dllist_node_t          dlnode;
+    /** Back-link to the root menu. */
+    wlmaker_root_menu_t       *root_menu_ptr;
+    /** The item holding the submenu. */
+    wlmtk_menu_item_t         *menu_item_ptr;
+    /** The submenu, once created. NULL otherwise. */
+    wlmtk_menu_t              *submenu_ptr;
+    /**
+     * Definition of the submenu. Owned by the server's root menu array.
+     * NULL for the submenu of installed applications.
+     */
+    bspl_array_t              *array_ptr;
+
+    /** Listener for @ref wlmtk_menu_item_events_t::submenu_request. */
+    struct wl_listener        submenu_request_listener;
+    /** Listener for @ref wlmtk_menu_item_events_t::destroy. */
+    struct wl_listener        destroy_listener;
+} wlmaker_root_menu_lazy_t;
+
 static void _wlmaker_root_menu_content_request_close(
     wlmtk_content_t *content_ptr);
 static void _wlmaker_root_menu_handle_menu_open_changed(
     struct wl_listener *listener_ptr,
     void *data_ptr);
+static int _wlmaker_root_menu_handle_release_timer(void *data_ptr);
+static bool _wlmaker_root_menu_has_applications(bspl_array_t *array_ptr);
+static void _wlmaker_root_menu_handle_app_index_changed(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static wlmtk_menu_t *_wlmaker_root_menu_create_applications_menu(
+    wlmaker_root_menu_t *root_menu_ptr);
+static void _wlmaker_root_menu_add_application(
+    const char *name_ptr,
+    const char *cmdline_ptr,
+    void *userdata_ptr);
+static void _wlmaker_root_menu_release_submenus(
+    wlmaker_root_menu_t *root_menu_ptr);
 static wlmaker_action_item_t *_wlmaker_root_menu_create_action_item_from_array(
     bspl_array_t *array_ptr,
-    const wlmtk_menu_style_t *menu_style_ptr,
-    wlmaker_server_t *server_ptr);
+    wlmaker_root_menu_t *root_menu_ptr);
 static wlmtk_menu_t *_wlmaker_root_menu_create_menu_from_array(
     bspl_array_t *array_ptr,
-    const wlmtk_menu_style_t *menu_style_ptr,
-    wlmaker_server_t *server_ptr);
+    wlmaker_root_menu_t *root_menu_ptr);
+static bool _wlmaker_root_menu_lazy_create(
+    wlmtk_menu_item_t *menu_item_ptr,
+    bspl_array_t *array_ptr,
+    wlmaker_root_menu_t *root_menu_ptr);
+static void _wlmaker_root_menu_lazy_destroy(
+    wlmaker_root_menu_lazy_t *lazy_ptr);
+static void _wlmaker_root_menu_lazy_handle_submenu_request(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmaker_root_menu_lazy_handle_destroy(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+
+/** Argument to @ref _wlmaker_root_menu_add_application. */
+typedef struct {
+    /** The root menu. */
+    wlmaker_root_menu_t       *root_menu_ptr;
+    /** The menu to add the application's items to. */
+    wlmtk_menu_t              *menu_ptr;
+} _wlmaker_root_menu_add_application_arg_t;
 
 /* == Data ================================================================= */
 
+/** Name of the pseudo-action to list installed applications in a submenu. */
+static const char *_wlmaker_root_menu_applications_name = "ApplicationsMenu";
+
 /** Virtual method of the root menu's window content. */
 static const wlmtk_content_vmt_t _wlmaker_root_menu_content_vmt = {
     .request_close = _wlmaker_root_menu_content_request_close
 };
 
+/** Descriptor for the optional "RootMenu" dict of the config file. */
+static const bspl_desc_t _wlmaker_root_menu_config_desc[] = {
+    BSPL_DESC_UINT64(
+        "ReleaseDelay", false, wlmaker_root_menu_t,
+        release_delay_msec, release_delay_msec, 60000),
+    BSPL_DESC_SENTINEL()
+};
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -92,11 +177,51 @@ wlmaker_root_menu_t *wlmaker_root_menu_create(
     if (NULL == root_menu_ptr) return NULL;
     root_menu_ptr->server_ptr = server_ptr;
     root_menu_ptr->server_ptr->root_menu_ptr = root_menu_ptr;
+    root_menu_ptr->menu_style_ptr = menu_style_ptr;
+
+    root_menu_ptr->release_delay_msec = 60000;
+    bspl_dict_t *config_dict_ptr = bspl_dict_get_dict(
+        server_ptr->config_dict_ptr, "RootMenu");
+    if (NULL != config_dict_ptr &&
+        !bspl_decode_dict(config_dict_ptr,
+                          _wlmaker_root_menu_config_desc,
+                          root_menu_ptr)) {
+        bs_log(BS_ERROR, "Failed to decode \"RootMenu\" dict");
+        wlmaker_root_menu_destroy(root_menu_ptr);
+        return NULL;
+    }
+
+    struct wl_event_loop *wl_event_loop_ptr = wl_display_get_event_loop(
+        server_ptr->wl_display_ptr);
+    root_menu_ptr->release_timer_event_source_ptr = wl_event_loop_add_timer(
+        wl_event_loop_ptr,
+        _wlmaker_root_menu_handle_release_timer,
+        root_menu_ptr);
+    if (NULL == root_menu_ptr->release_timer_event_source_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_timer(%p, %p, %p)",
+               wl_event_loop_ptr,
+               _wlmaker_root_menu_handle_release_timer,
+               root_menu_ptr);
+        wlmaker_root_menu_destroy(root_menu_ptr);
+        return NULL;
+    }
+
+    if (_wlmaker_root_menu_has_applications(server_ptr->root_menu_array_ptr)) {
+        root_menu_ptr->app_index_ptr = wlmaker_app_index_create(
+            wl_event_loop_ptr, NULL);
+        if (NULL == root_menu_ptr->app_index_ptr) {
+            wlmaker_root_menu_destroy(root_menu_ptr);
+            return NULL;
+        }
+        wlmtk_util_connect_listener_signal(
+            &wlmaker_app_index_events(root_menu_ptr->app_index_ptr)->changed,
+            &root_menu_ptr->app_index_changed_listener,
+            _wlmaker_root_menu_handle_app_index_changed);
+    }
 
     root_menu_ptr->menu_ptr = _wlmaker_root_menu_create_menu_from_array(
         server_ptr->root_menu_array_ptr,
-        menu_style_ptr,
-        server_ptr);
+        root_menu_ptr);
     if (NULL == root_menu_ptr->menu_ptr) {
         wlmaker_root_menu_destroy(root_menu_ptr);
         return NULL;
@@ -151,6 +276,19 @@ wlmaker_root_menu_t *wlmaker_root_menu_create(
         bspl_array_string_value_at(server_ptr->root_menu_array_ptr, 0));
     wlmtk_window_set_server_side_decorated(root_menu_ptr->window_ptr, true);
 
+    bool initialized = NULL != server_ptr->wlr_scene_ptr ?
+        wlmtk_container_init_attached(
+            &root_menu_ptr->parking_container,
+            &server_ptr->wlr_scene_ptr->tree) :
+        wlmtk_container_init(&root_menu_ptr->parking_container);
+    if (!initialized) {
+        wlmaker_root_menu_destroy(root_menu_ptr);
+        return NULL;
+    }
+    wlmtk_container_add_element(
+        &root_menu_ptr->parking_container,
+        wlmtk_window_element(root_menu_ptr->window_ptr));
+
     return root_menu_ptr;
 }
 
@@ -170,11 +308,18 @@ void wlmaker_root_menu_destroy(wlmaker_root_menu_t *root_menu_ptr)
         if (NULL != workspace_ptr) {
             wlmtk_workspace_unmap_window(workspace_ptr,
                                          root_menu_ptr->window_ptr);
+        } else if (&root_menu_ptr->parking_container ==
+                   wlmtk_window_element(
+                       root_menu_ptr->window_ptr)->parent_container_ptr) {
+            wlmtk_container_remove_element(
+                &root_menu_ptr->parking_container,
+                wlmtk_window_element(root_menu_ptr->window_ptr));
         }
 
         wlmtk_window_destroy(root_menu_ptr->window_ptr);
         root_menu_ptr->window_ptr = NULL;
     }
+    wlmtk_container_fini(&root_menu_ptr->parking_container);
 
     if (NULL != root_menu_ptr->menu_ptr) {
         wlmtk_content_set_element(&root_menu_ptr->content, NULL);
@@ -198,6 +343,20 @@ void wlmaker_root_menu_destroy(wlmaker_root_menu_t *root_menu_ptr)
         wlmtk_menu_destroy(root_menu_ptr->menu_ptr);
         root_menu_ptr->menu_ptr = NULL;
     }
+    // Destroying the menu has destroyed all items, and their submenus.
+    BS_ASSERT(bs_dllist_empty(&root_menu_ptr->lazy_submenus));
+
+    if (NULL != root_menu_ptr->app_index_ptr) {
+        wlmtk_util_disconnect_listener(
+            &root_menu_ptr->app_index_changed_listener);
+        wlmaker_app_index_destroy(root_menu_ptr->app_index_ptr);
+        root_menu_ptr->app_index_ptr = NULL;
+    }
+
+    if (NULL != root_menu_ptr->release_timer_event_source_ptr) {
+        wl_event_source_remove(root_menu_ptr->release_timer_event_source_ptr);
+        root_menu_ptr->release_timer_event_source_ptr = NULL;
+    }
     free(root_menu_ptr);
 }
 
@@ -227,18 +386,32 @@ void _wlmaker_root_menu_content_request_close(
 }
 
 /* ------------------------------------------------------------------------- */
-/** Handles @ref wlmtk_menu_events_t::open_changed. Unmaps window on close. */
+/**
+ * Handles @ref wlmtk_menu_events_t::open_changed. Parks window on close.
+ *
+ * Closing the menu also arms @ref wlmaker_root_menu_t::release_delay_msec,
+ * re-opening disarms it.
+ */
 void _wlmaker_root_menu_handle_menu_open_changed(
     struct wl_listener *listener_ptr,
     __UNUSED__ void *data_ptr)
 {
     wlmaker_root_menu_t *root_menu_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmaker_root_menu_t, menu_open_changed_listener);
+
+    int msec = 0;
+    if (!wlmtk_menu_is_open(root_menu_ptr->menu_ptr)) {
+        msec = BS_MIN(root_menu_ptr->release_delay_msec, (uint64_t)INT32_MAX);
+    }
+    wl_event_source_timer_update(
+        root_menu_ptr->release_timer_event_source_ptr, msec);
+
     if (!wlmtk_menu_is_open(root_menu_ptr->menu_ptr) &&
         NULL != wlmtk_window_get_workspace(root_menu_ptr->window_ptr)) {
-        wlmtk_workspace_unmap_window(
+        wlmtk_workspace_park_window(
             wlmtk_window_get_workspace(root_menu_ptr->window_ptr),
-            root_menu_ptr->window_ptr);
+            root_menu_ptr->window_ptr,
+            &root_menu_ptr->parking_container);
     } else {
 
         uint32_t properties = 0;
@@ -263,17 +436,20 @@ void _wlmaker_root_menu_handle_menu_open_changed(
 /**
  * Creates an action menu item from the plist array.
  *
+ * Items with a submenu get the submenu created on first use, see
+ * @ref wlmaker_root_menu_lazy_t. So do items of the "ApplicationsMenu"
+ * pseudo-action, which list the installed applications.
+ *
  * @param array_ptr
- * @param menu_style_ptr
- * @param server_ptr
+ * @param root_menu_ptr
  *
  * @return Pointer to the created @ref wlmaker_action_item_t or NULL on error.
  */
 wlmaker_action_item_t *_wlmaker_root_menu_create_action_item_from_array(
     bspl_array_t *array_ptr,
-    const wlmtk_menu_style_t *menu_style_ptr,
-    wlmaker_server_t *server_ptr)
+    wlmaker_root_menu_t *root_menu_ptr)
 {
+    wlmaker_server_t *server_ptr = root_menu_ptr->server_ptr;
     if (bspl_array_size(server_ptr->root_menu_array_ptr) <= 2) {
         bs_log(BS_ERROR, "Needs >= 2 array elements for item definition.");
         return NULL;
@@ -284,27 +460,13 @@ wlmaker_action_item_t *_wlmaker_root_menu_create_action_item_from_array(
         return NULL;
     }
 
-    wlmtk_menu_t *submenu_ptr = NULL;
+    bool has_submenu = false;
+    bspl_array_t *submenu_array_ptr = NULL;
     int action = WLMAKER_ACTION_NONE;
     bspl_object_t *obj_ptr = bspl_array_at(array_ptr, 1);
     if (BSPL_ARRAY == bspl_object_type(obj_ptr)) {
-
-#if 1
-        // TODO(kaeser@gubbe.ch): Re-enable, once submenu hierarchy fixed.
-        submenu_ptr = _wlmaker_root_menu_create_menu_from_array(
-            array_ptr,
-            menu_style_ptr,
-            server_ptr);
-        if (NULL == submenu_ptr) {
-            bs_log(BS_ERROR, "Failed to create submenu for item '%s'",
-                   name_ptr);
-            return NULL;
-        }
-#else
-        bs_log(BS_ERROR, "Submenu definition from plist yet unsupported.");
-        return NULL;
-#endif
-
+        has_submenu = true;
+        submenu_array_ptr = array_ptr;
     } else {
         const char *action_name_ptr = bspl_string_value(
             bspl_string_from_object(obj_ptr));
@@ -314,7 +476,10 @@ wlmaker_action_item_t *_wlmaker_root_menu_create_action_item_from_array(
             return NULL;
         }
 
-        if (!bspl_enum_name_to_value(
+        if (0 == strcmp(action_name_ptr,
+                        _wlmaker_root_menu_applications_name)) {
+            has_submenu = true;
+        } else if (!bspl_enum_name_to_value(
                 wlmaker_action_desc,
                 action_name_ptr,
                 &action)) {
@@ -331,18 +496,20 @@ wlmaker_action_item_t *_wlmaker_root_menu_create_action_item_from_array(
 
     wlmaker_action_item_t *action_item_ptr = wlmaker_action_item_create(
         name_ptr,
-        &menu_style_ptr->item,
+        &root_menu_ptr->menu_style_ptr->item,
         action,
         action_arg_ptr,
         server_ptr);
-    if (NULL == action_item_ptr) {
-        if (NULL == submenu_ptr) wlmtk_menu_destroy(submenu_ptr);
+    if (NULL == action_item_ptr) return NULL;
+
+    if (has_submenu &&
+        !_wlmaker_root_menu_lazy_create(
+            wlmaker_action_item_menu_item(action_item_ptr),
+            submenu_array_ptr,
+            root_menu_ptr)) {
+        wlmaker_action_item_destroy(action_item_ptr);
         return NULL;
     }
-
-    wlmtk_menu_item_set_submenu(
-        wlmaker_action_item_menu_item(action_item_ptr),
-        submenu_ptr);
     return action_item_ptr;
 }
 
@@ -351,16 +518,15 @@ wlmaker_action_item_t *_wlmaker_root_menu_create_action_item_from_array(
  * Creates a @ref wlmtk_menu_t from the plist array.
  *
  * @param array_ptr
- * @param menu_style_ptr
- * @param server_ptr
+ * @param root_menu_ptr
  *
  * @return A pointer to the created @ref wlmtk_menu_t or NULL on error.
  */
 wlmtk_menu_t *_wlmaker_root_menu_create_menu_from_array(
     bspl_array_t *array_ptr,
-    const wlmtk_menu_style_t *menu_style_ptr,
-    wlmaker_server_t *server_ptr)
+    wlmaker_root_menu_t *root_menu_ptr)
 {
+    wlmaker_server_t *server_ptr = root_menu_ptr->server_ptr;
     if (bspl_array_size(server_ptr->root_menu_array_ptr) <= 1) {
         bs_log(BS_ERROR, "Needs > 1 array element for menu definition.");
         return NULL;
@@ -371,7 +537,7 @@ wlmtk_menu_t *_wlmaker_root_menu_create_menu_from_array(
         return NULL;
     }
 
-    wlmtk_menu_t *menu_ptr = wlmtk_menu_create(menu_style_ptr);
+    wlmtk_menu_t *menu_ptr = wlmtk_menu_create(root_menu_ptr->menu_style_ptr);
     if (NULL == menu_ptr) return NULL;
 
     for (size_t i = 1; i < bspl_array_size(array_ptr); ++i) {
@@ -387,8 +553,7 @@ wlmtk_menu_t *_wlmaker_root_menu_create_menu_from_array(
         wlmaker_action_item_t *action_item_ptr =
             _wlmaker_root_menu_create_action_item_from_array(
                 item_array_ptr,
-                menu_style_ptr,
-                server_ptr);
+                root_menu_ptr);
         if (NULL == action_item_ptr) {
             bs_log(BS_ERROR, "Failed to create action item from element [%zu] "
                    "in '%s'", i, name_ptr);
@@ -403,4 +568,272 @@ wlmtk_menu_t *_wlmaker_root_menu_create_menu_from_array(
     return menu_ptr;
 }
 
+/* ------------------------------------------------------------------------- */
+/** Timer callback: Releases the submenus, if the root menu is still closed. */
+int _wlmaker_root_menu_handle_release_timer(void *data_ptr)
+{
+    wlmaker_root_menu_t *root_menu_ptr = data_ptr;
+    if (!wlmtk_menu_is_open(root_menu_ptr->menu_ptr)) {
+        _wlmaker_root_menu_release_submenus(root_menu_ptr);
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Destroys all submenus that were created on demand, including their items
+ * and buffers. They will be re-created when highlighted again.
+ *
+ * @param root_menu_ptr
+ */
+void _wlmaker_root_menu_release_submenus(wlmaker_root_menu_t *root_menu_ptr)
+{
+    bs_dllist_node_t *dlnode_ptr;
+    size_t released = 0;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                        &root_menu_ptr->lazy_submenus))) {
+        wlmaker_root_menu_lazy_t *lazy_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_root_menu_lazy_t, dlnode);
+        wlmtk_menu_t *submenu_ptr = lazy_ptr->submenu_ptr;
+        lazy_ptr->submenu_ptr = NULL;
+
+        // Nested submenus get un-linked as their items are destroyed.
+        wlmtk_menu_item_set_submenu(lazy_ptr->menu_item_ptr, NULL);
+        wlmtk_menu_destroy(submenu_ptr);
+        ++released;
+    }
+    if (0 < released) {
+        bs_log(BS_DEBUG, "Root menu %p: Released %zu submenus.",
+               root_menu_ptr, released);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return whether `array_ptr` has an "ApplicationsMenu" item, any depth. */
+bool _wlmaker_root_menu_has_applications(bspl_array_t *array_ptr)
+{
+    for (size_t i = 1; i < bspl_array_size(array_ptr); ++i) {
+        bspl_array_t *item_array_ptr = bspl_array_from_object(
+            bspl_array_at(array_ptr, i));
+        if (NULL == item_array_ptr) continue;
+
+        bspl_object_t *obj_ptr = bspl_array_at(item_array_ptr, 1);
+        if (BSPL_ARRAY == bspl_object_type(obj_ptr)) {
+            if (_wlmaker_root_menu_has_applications(item_array_ptr)) {
+                return true;
+            }
+            continue;
+        }
+        const char *action_name_ptr = bspl_string_value(
+            bspl_string_from_object(obj_ptr));
+        if (NULL != action_name_ptr &&
+            0 == strcmp(action_name_ptr,
+                        _wlmaker_root_menu_applications_name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles @ref wlmaker_app_index_events_t::changed: Releases the menus of
+ * installed applications that are closed, so they get re-created from the
+ * updated index when opened next. Open menus get updated once released by
+ * @ref wlmaker_root_menu_t::release_timer_event_source_ptr.
+ *
+ * @param listener_ptr
+ * @param data_ptr
+ */
+void _wlmaker_root_menu_handle_app_index_changed(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmaker_root_menu_t *root_menu_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_root_menu_t, app_index_changed_listener);
+
+    bs_dllist_node_t *dlnode_ptr = root_menu_ptr->lazy_submenus.head_ptr;
+    while (NULL != dlnode_ptr) {
+        wlmaker_root_menu_lazy_t *lazy_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_root_menu_lazy_t, dlnode);
+        dlnode_ptr = dlnode_ptr->next_ptr;
+        // Menus of applications do not hold nested lazy submenus.
+        if (NULL != lazy_ptr->array_ptr ||
+            wlmtk_menu_is_open(lazy_ptr->submenu_ptr)) continue;
+
+        wlmtk_menu_t *submenu_ptr = lazy_ptr->submenu_ptr;
+        bs_dllist_remove(&root_menu_ptr->lazy_submenus, &lazy_ptr->dlnode);
+        lazy_ptr->submenu_ptr = NULL;
+        wlmtk_menu_item_set_submenu(lazy_ptr->menu_item_ptr, NULL);
+        wlmtk_menu_destroy(submenu_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates a menu listing the installed applications, from
+ * @ref wlmaker_root_menu_t::app_index_ptr. Each item executes the
+ * application through the 'Execute' action.
+ *
+ * @param root_menu_ptr
+ *
+ * @return A pointer to the created @ref wlmtk_menu_t or NULL on error.
+ */
+wlmtk_menu_t *_wlmaker_root_menu_create_applications_menu(
+    wlmaker_root_menu_t *root_menu_ptr)
+{
+    wlmtk_menu_t *menu_ptr = wlmtk_menu_create(root_menu_ptr->menu_style_ptr);
+    if (NULL == menu_ptr) return NULL;
+
+    _wlmaker_root_menu_add_application_arg_t arg = {
+        .root_menu_ptr = root_menu_ptr,
+        .menu_ptr = menu_ptr
+    };
+    size_t n = 0;
+    if (NULL != root_menu_ptr->app_index_ptr) {
+        n = wlmaker_app_index_for_each(
+            root_menu_ptr->app_index_ptr,
+            _wlmaker_root_menu_add_application,
+            &arg);
+    }
+    if (0 == n) {
+        // An empty menu has no extents. Show a disabled placeholder.
+        wlmaker_action_item_t *action_item_ptr = wlmaker_action_item_create(
+            "(No applications)",
+            &root_menu_ptr->menu_style_ptr->item,
+            WLMAKER_ACTION_NONE,
+            NULL,
+            root_menu_ptr->server_ptr);
+        if (NULL == action_item_ptr) {
+            wlmtk_menu_destroy(menu_ptr);
+            return NULL;
+        }
+        wlmtk_menu_item_set_enabled(
+            wlmaker_action_item_menu_item(action_item_ptr), false);
+        wlmtk_menu_add_item(
+            menu_ptr, wlmaker_action_item_menu_item(action_item_ptr));
+    }
+    return menu_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Implements @ref wlmaker_app_index_callback_t: Adds an item to the menu. */
+void _wlmaker_root_menu_add_application(
+    const char *name_ptr,
+    const char *cmdline_ptr,
+    void *userdata_ptr)
+{
+    _wlmaker_root_menu_add_application_arg_t *arg_ptr = userdata_ptr;
+    wlmaker_action_item_t *action_item_ptr = wlmaker_action_item_create(
+        name_ptr,
+        &arg_ptr->root_menu_ptr->menu_style_ptr->item,
+        WLMAKER_ACTION_EXECUTE,
+        cmdline_ptr,
+        arg_ptr->root_menu_ptr->server_ptr);
+    if (NULL == action_item_ptr) {
+        bs_log(BS_WARNING, "Failed to create menu item for '%s'", name_ptr);
+        return;
+    }
+    wlmtk_menu_add_item(
+        arg_ptr->menu_ptr, wlmaker_action_item_menu_item(action_item_ptr));
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Sets up `menu_item_ptr` to create its submenu from `array_ptr` when first
+ * highlighted. The state is destroyed along with the item.
+ *
+ * @param menu_item_ptr
+ * @param array_ptr           Definition of the submenu, or NULL for the
+ *                            menu of installed applications.
+ * @param root_menu_ptr
+ *
+ * @return true on success.
+ */
+bool _wlmaker_root_menu_lazy_create(
+    wlmtk_menu_item_t *menu_item_ptr,
+    bspl_array_t *array_ptr,
+    wlmaker_root_menu_t *root_menu_ptr)
+{
+    wlmaker_root_menu_lazy_t *lazy_ptr = logged_calloc(
+        1, sizeof(wlmaker_root_menu_lazy_t));
+    if (NULL == lazy_ptr) return false;
+    lazy_ptr->root_menu_ptr = root_menu_ptr;
+    lazy_ptr->menu_item_ptr = menu_item_ptr;
+    lazy_ptr->array_ptr = array_ptr;
+
+    wlmtk_util_connect_listener_signal(
+        &wlmtk_menu_item_events(menu_item_ptr)->submenu_request,
+        &lazy_ptr->submenu_request_listener,
+        _wlmaker_root_menu_lazy_handle_submenu_request);
+    wlmtk_util_connect_listener_signal(
+        &wlmtk_menu_item_events(menu_item_ptr)->destroy,
+        &lazy_ptr->destroy_listener,
+        _wlmaker_root_menu_lazy_handle_destroy);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the lazy submenu state. Does not destroy the submenu itself. */
+void _wlmaker_root_menu_lazy_destroy(wlmaker_root_menu_lazy_t *lazy_ptr)
+{
+    if (NULL != lazy_ptr->submenu_ptr) {
+        bs_dllist_remove(&lazy_ptr->root_menu_ptr->lazy_submenus,
+                         &lazy_ptr->dlnode);
+        lazy_ptr->submenu_ptr = NULL;
+    }
+    wlmtk_util_disconnect_listener(&lazy_ptr->destroy_listener);
+    wlmtk_util_disconnect_listener(&lazy_ptr->submenu_request_listener);
+    free(lazy_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles @ref wlmtk_menu_item_events_t::submenu_request: Creates the submenu
+ * from the plist array. Errors in the definition are logged, and leave the
+ * item without submenu.
+ *
+ * @param listener_ptr
+ * @param data_ptr
+ */
+void _wlmaker_root_menu_lazy_handle_submenu_request(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmaker_root_menu_lazy_t *lazy_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_root_menu_lazy_t, submenu_request_listener);
+    if (NULL != lazy_ptr->submenu_ptr) return;
+
+    wlmtk_menu_t *submenu_ptr;
+    if (NULL == lazy_ptr->array_ptr) {
+        submenu_ptr = _wlmaker_root_menu_create_applications_menu(
+            lazy_ptr->root_menu_ptr);
+    } else {
+        submenu_ptr = _wlmaker_root_menu_create_menu_from_array(
+            lazy_ptr->array_ptr,
+            lazy_ptr->root_menu_ptr);
+    }
+    if (NULL == submenu_ptr) {
+        bs_log(BS_ERROR, "Failed to create submenu for lazy item %p",
+               lazy_ptr->menu_item_ptr);
+        return;
+    }
+
+    lazy_ptr->submenu_ptr = submenu_ptr;
+    bs_dllist_push_back(&lazy_ptr->root_menu_ptr->lazy_submenus,
+                        &lazy_ptr->dlnode);
+    wlmtk_menu_item_set_submenu(lazy_ptr->menu_item_ptr, submenu_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles @ref wlmtk_menu_item_events_t::destroy. Destroys the state. */
+void _wlmaker_root_menu_lazy_handle_destroy(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmaker_root_menu_lazy_t *lazy_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_root_menu_lazy_t, destroy_listener);
+    _wlmaker_root_menu_lazy_destroy(lazy_ptr);
+}
+
 /* == End of root_menu.c =================================================== */
@@ -23,8 +23,10 @@
 #include <inttypes.h>
 #include <libbase/libbase.h>
 #include <libbase/plist.h>
+#include <limits.h>
 #include <linux/input-event-codes.h>
 #include <stdlib.h>
+#include <string.h>
 #include <wayland-server-protocol.h>
 #include <wayland-util.h>
 #include <xkbcommon/xkbcommon-keysyms.h>
@@ -35,9 +37,11 @@
 #include <wlr/types/wlr_input_device.h>
 #include <wlr/types/wlr_output_layout.h>
 #include <wlr/types/wlr_scene.h>
+#include <wlr/types/wlr_security_context_v1.h>
 #undef WLR_USE_UNSTABLE
 
 #include "keyboard.h"
+#include "plist_cache.h"
 #include "toolkit/toolkit.h"
 
 /* == Declarations ========================================================= */
@@ -63,12 +67,30 @@ typedef struct {
 struct _wlmaker_key_binding_t {
     /** Node within @ref wlmaker_server_t::bindings. */
     bs_dllist_node_t          dlnode;
+    /** Node within the bucket of @ref wlmaker_server_t::binding_buckets. */
+    bs_dllist_node_t          bucket_dlnode;
+    /** The bucket this binding is in. */
+    bs_dllist_t               *bucket_ptr;
+    /** Registration order. Earlier bindings take precedence. */
+    uint64_t                  sequence;
     /** The key binding: Modifier and keysym to bind to. */
     const wlmaker_key_combo_t *key_combo_ptr;
     /** Callback for when this modifier + key is encountered. */
     wlmaker_keybinding_callback_t callback;
 };
 
+static bs_dllist_t *_wlmaker_server_binding_bucket(
+    wlmaker_server_t *server_ptr,
+    bool masked,
+    xkb_keysym_t keysym,
+    uint32_t modifiers);
+static wlmaker_key_binding_t *_wlmaker_server_binding_from_bucket_dlnode(
+    bs_dllist_node_t *dlnode_ptr);
+static bool _wlmaker_server_binding_matches(
+    const wlmaker_key_combo_t *key_combo_ptr,
+    xkb_keysym_t keysym,
+    uint32_t modifiers);
+
 static bool register_input_device(
     wlmaker_server_t *server_ptr,
     struct wlr_input_device *wlr_input_device_ptr,
@@ -84,6 +106,9 @@ static void handle_destroy_input_device(
 static void _wlmaker_server_unclaimed_button_event_handler(
     struct wl_listener *listener_ptr,
     void *data_ptr);
+static void _wlmaker_server_apply_window_style(
+    bs_dllist_node_t *dlnode_ptr,
+    void *ud_ptr);
 
 /* == Data ================================================================= */
 
@@ -116,9 +141,11 @@ wlmaker_server_t *wlmaker_server_create(
 
     wl_signal_init(&server_ptr->task_list_enabled_event);
     wl_signal_init(&server_ptr->task_list_disabled_event);
+    wl_signal_init(&server_ptr->debug_overlay_toggle_event);
 
     wl_signal_init(&server_ptr->window_created_event);
     wl_signal_init(&server_ptr->window_destroyed_event);
+    wl_signal_init(&server_ptr->reload_event);
 
     // Prepare display and socket.
     server_ptr->wl_display_ptr = wl_display_create();
@@ -196,6 +223,38 @@ wlmaker_server_t *wlmaker_server_create(
         wlmaker_server_destroy(server_ptr);
         return NULL;
     }
+    wlmbe_backend_set_root(server_ptr->backend_ptr, server_ptr->root_ptr);
+    // Coalesce layout updates: Run them once before the next frame.
+    wlmtk_container_defer_layout(
+        wl_display_get_event_loop(server_ptr->wl_display_ptr));
+    // Collapse the output layout's changes, eg. on hotplug, into one epoch.
+    wlmtk_layout_epoch_defer(
+        wl_display_get_event_loop(server_ptr->wl_display_ptr));
+    // Redraw titles at most once per frame, eg. for a ticking clock.
+    wlmtk_window_defer_titles(
+        wl_display_get_event_loop(server_ptr->wl_display_ptr));
+    // Animate scene snapshots, ticked by the outputs' frames.
+    wlmtk_animation_set_enabled(true);
+    // Decode icons off the main thread: File access may be slow.
+    if (!wlmtk_image_defer_decode(
+            wl_display_get_event_loop(server_ptr->wl_display_ptr))) {
+        bs_log(BS_WARNING, "Failed to start image decoder, decoding inline.");
+    }
+    // Rasterize decorations off the main thread: Text rendering is slow.
+    if (!wlmtk_raster_defer(
+            wl_display_get_event_loop(server_ptr->wl_display_ptr))) {
+        bs_log(BS_WARNING, "Failed to start rasterizer, drawing inline.");
+    }
+    // Keep scaled icons on disk, so they need no decoding at next startup.
+    char cache_dir[PATH_MAX];
+    if (wlmaker_plist_cache_dir(cache_dir, sizeof(cache_dir))) {
+        wlmtk_image_set_cache_dir(cache_dir);
+    }
+    // Present geometry changes of several windows in the same frame.
+    wlmtk_transaction_enable(
+        wl_display_get_event_loop(server_ptr->wl_display_ptr));
+    // Windows on other workspaces are not shown: Release their decorations.
+    wlmtk_root_set_hibernate_inactive_workspaces(server_ptr->root_ptr, true);
     wlmtk_util_connect_listener_signal(
         &wlmtk_root_events(server_ptr->root_ptr)->unclaimed_button_event,
         &server_ptr->unclaimed_button_event_listener,
@@ -226,6 +285,13 @@ wlmaker_server_t *wlmaker_server_create(
         wlmaker_server_destroy(server_ptr);
         return NULL;
     }
+    server_ptr->wlr_security_context_manager_v1_ptr =
+        wlr_security_context_manager_v1_create(server_ptr->wl_display_ptr);
+    if (NULL == server_ptr->wlr_security_context_manager_v1_ptr) {
+        bs_log(BS_ERROR, "Failed wlr_security_context_manager_v1_create()");
+        wlmaker_server_destroy(server_ptr);
+        return NULL;
+    }
 
     server_ptr->xdg_shell_ptr = wlmaker_xdg_shell_create(server_ptr);
     if (NULL == server_ptr->xdg_shell_ptr) {
@@ -234,6 +300,13 @@ wlmaker_server_t *wlmaker_server_create(
         return NULL;
     }
 
+    server_ptr->client_quota_ptr = wlmaker_client_quota_create(server_ptr);
+    if (NULL == server_ptr->client_quota_ptr) {
+        bs_log(BS_ERROR, "Failed wlmaker_client_quota_create()");
+        wlmaker_server_destroy(server_ptr);
+        return NULL;
+    }
+
     server_ptr->xdg_decoration_manager_ptr =
         wlmaker_xdg_decoration_manager_create(server_ptr);
     if (NULL == server_ptr->xdg_decoration_manager_ptr) {
@@ -271,6 +344,16 @@ wlmaker_server_t *wlmaker_server_create(
         return NULL;
     }
 
+    server_ptr->window_rules_ptr = wlmaker_window_rules_create(
+        bspl_dict_get_array(server_ptr->config_dict_ptr, "WindowRules"));
+    if (NULL == server_ptr->window_rules_ptr) {
+        bs_log(BS_ERROR, "Failed wlmaker_window_rules_create(%p)",
+               bspl_dict_get_array(server_ptr->config_dict_ptr,
+                                   "WindowRules"));
+        wlmaker_server_destroy(server_ptr);
+        return NULL;
+    }
+
     server_ptr->corner_ptr = wlmaker_corner_create(
         bspl_dict_get_dict(server_ptr->config_dict_ptr, "HotCorner"),
         wl_display_get_event_loop(server_ptr->wl_display_ptr),
@@ -291,9 +374,41 @@ wlmaker_server_t *wlmaker_server_create(
     return server_ptr;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Iterator for @ref wlmtk_root_for_each_workspace: Applies the window style
+ * to each window of the workspace.
+ *
+ * @param dlnode_ptr          To the workspace's dlnode.
+ * @param ud_ptr              Points to the @ref wlmtk_window_style_t.
+ */
+void _wlmaker_server_apply_window_style(
+    bs_dllist_node_t *dlnode_ptr,
+    void *ud_ptr)
+{
+    wlmtk_workspace_t *workspace_ptr = wlmtk_workspace_from_dlnode(
+        dlnode_ptr);
+    bs_dllist_t *windows_ptr = wlmtk_workspace_get_windows_dllist(
+        workspace_ptr);
+    for (bs_dllist_node_t *wdlnode_ptr = windows_ptr->head_ptr;
+         NULL != wdlnode_ptr;
+         wdlnode_ptr = wdlnode_ptr->next_ptr) {
+        wlmtk_window_set_style(wlmtk_window_from_dlnode(wdlnode_ptr), ud_ptr);
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmaker_server_destroy(wlmaker_server_t *server_ptr)
 {
+    wlmtk_animation_set_enabled(false);
+    wlmtk_layout_epoch_defer(NULL);
+    wlmtk_container_defer_layout(NULL);
+    wlmtk_window_defer_titles(NULL);
+    wlmtk_transaction_enable(NULL);
+    wlmtk_raster_defer(NULL);
+    wlmtk_image_defer_decode(NULL);
+    wlmtk_image_set_cache_dir(NULL);
+
     if (NULL != server_ptr->root_menu_ptr) {
         wlmaker_root_menu_destroy(server_ptr->root_menu_ptr);
         server_ptr->root_menu_ptr = NULL;
@@ -320,6 +435,11 @@ void wlmaker_server_destroy(wlmaker_server_t *server_ptr)
         server_ptr->corner_ptr = NULL;
     }
 
+    if (NULL != server_ptr->window_rules_ptr) {
+        wlmaker_window_rules_destroy(server_ptr->window_rules_ptr);
+        server_ptr->window_rules_ptr = NULL;
+    }
+
     if (NULL != server_ptr->monitor_ptr) {
         wlmaker_subprocess_monitor_destroy(server_ptr->monitor_ptr);
         server_ptr->monitor_ptr =NULL;
@@ -346,6 +466,11 @@ void wlmaker_server_destroy(wlmaker_server_t *server_ptr)
         server_ptr->xdg_decoration_manager_ptr = NULL;
     }
 
+    if (NULL != server_ptr->client_quota_ptr) {
+        wlmaker_client_quota_destroy(server_ptr->client_quota_ptr);
+        server_ptr->client_quota_ptr = NULL;
+    }
+
     if (NULL != server_ptr->xdg_shell_ptr) {
         wlmaker_xdg_shell_destroy(server_ptr->xdg_shell_ptr);
         server_ptr->xdg_shell_ptr = NULL;
@@ -369,6 +494,9 @@ void wlmaker_server_destroy(wlmaker_server_t *server_ptr)
     if (NULL != server_ptr->root_ptr) {
         wlmtk_util_disconnect_listener(
             &server_ptr->unclaimed_button_event_listener);
+        if (NULL != server_ptr->backend_ptr) {
+            wlmbe_backend_set_root(server_ptr->backend_ptr, NULL);
+        }
         wlmtk_root_destroy(server_ptr->root_ptr);
         server_ptr->root_ptr = NULL;
     }
@@ -420,6 +548,44 @@ void wlmaker_server_deactivate_task_list(wlmaker_server_t *server_ptr)
     }
 }
 
+/* ------------------------------------------------------------------------- */
+bool wlmaker_server_apply_style(
+    wlmaker_server_t *server_ptr,
+    const wlmaker_config_style_t *style_ptr)
+{
+    wlmaker_config_style_t *current_ptr = &server_ptr->style;
+
+    if ((NULL == current_ptr->cursor.name_ptr) !=
+        (NULL == style_ptr->cursor.name_ptr) ||
+        (NULL != style_ptr->cursor.name_ptr &&
+         0 != strcmp(current_ptr->cursor.name_ptr,
+                     style_ptr->cursor.name_ptr)) ||
+        current_ptr->cursor.size != style_ptr->cursor.size) {
+        bs_log(BS_WARNING, "Cursor style changes take effect on restart.");
+    }
+
+    // The cursor style holds an allocated name. Keep the current one.
+    wlmaker_config_style_t new_style = *style_ptr;
+    new_style.cursor = current_ptr->cursor;
+    if (0 == memcmp(current_ptr, &new_style, sizeof(new_style))) {
+        bs_log(BS_INFO, "Style unchanged.");
+        return false;
+    }
+
+    bool window_changed = 0 != memcmp(
+        &current_ptr->window, &new_style.window, sizeof(new_style.window));
+    *current_ptr = new_style;
+    if (window_changed) {
+        wlmtk_root_for_each_workspace(
+            server_ptr->root_ptr,
+            _wlmaker_server_apply_window_style,
+            &current_ptr->window);
+    }
+    bs_log(BS_INFO, "Applied style, window style %s.",
+           window_changed ? "changed" : "unchanged");
+    return true;
+}
+
 /* ------------------------------------------------------------------------- */
 struct wlr_output *wlmaker_server_get_output_at_cursor(
     wlmaker_server_t *server_ptr)
@@ -442,7 +608,17 @@ wlmaker_key_binding_t *wlmaker_server_bind_key(
 
     key_binding_ptr->key_combo_ptr = key_combo_ptr;
     key_binding_ptr->callback = callback;
+    key_binding_ptr->sequence = server_ptr->binding_sequence++;
     bs_dllist_push_back(&server_ptr->bindings, &key_binding_ptr->dlnode);
+
+    // Buckets remain in registration order, as bindings are appended.
+    key_binding_ptr->bucket_ptr = _wlmaker_server_binding_bucket(
+        server_ptr,
+        0 != key_combo_ptr->modifiers_mask,
+        key_combo_ptr->keysym,
+        key_combo_ptr->modifiers);
+    bs_dllist_push_back(key_binding_ptr->bucket_ptr,
+                        &key_binding_ptr->bucket_dlnode);
     return key_binding_ptr;
 }
 
@@ -451,6 +627,8 @@ void wlmaker_server_unbind_key(
     wlmaker_server_t *server_ptr,
     wlmaker_key_binding_t *key_binding_ptr)
 {
+    bs_dllist_remove(key_binding_ptr->bucket_ptr,
+                     &key_binding_ptr->bucket_dlnode);
     bs_dllist_remove(&server_ptr->bindings, &key_binding_ptr->dlnode);
     free(key_binding_ptr);
 }
@@ -461,32 +639,40 @@ bool wlmaker_keyboard_process_bindings(
     xkb_keysym_t keysym,
     uint32_t modifiers)
 {
-    if (bs_will_log(BS_DEBUG)) {
+    if (WLMTK_LOG_DEBUG_ENABLED && bs_will_log(BS_DEBUG)) {
         char keysym_name[128] = {};
         xkb_keysym_get_name(keysym, keysym_name, sizeof(keysym_name));
         bs_log(BS_DEBUG, "Process key '%s' (sym %d, modifiers %"PRIx32")",
                keysym_name, keysym, modifiers);
     }
 
-    for (bs_dllist_node_t *dlnode_ptr = server_ptr->bindings.head_ptr;
-         NULL != dlnode_ptr;
-         dlnode_ptr = dlnode_ptr->next_ptr) {
-        wlmaker_key_binding_t *key_binding_ptr = BS_CONTAINER_OF(
-            dlnode_ptr, wlmaker_key_binding_t, dlnode);
+    // Candidates are in the bucket for exact modifiers, and in the one for
+    // masked bindings. Walk both, merged by registration order.
+    bs_dllist_node_t *exact_dlnode_ptr = _wlmaker_server_binding_bucket(
+        server_ptr, false, keysym, modifiers)->head_ptr;
+    bs_dllist_node_t *masked_dlnode_ptr = _wlmaker_server_binding_bucket(
+        server_ptr, true, keysym, modifiers)->head_ptr;
+    while (NULL != exact_dlnode_ptr || NULL != masked_dlnode_ptr) {
+        wlmaker_key_binding_t *exact_ptr =
+            _wlmaker_server_binding_from_bucket_dlnode(exact_dlnode_ptr);
+        wlmaker_key_binding_t *masked_ptr =
+            _wlmaker_server_binding_from_bucket_dlnode(masked_dlnode_ptr);
+
+        wlmaker_key_binding_t *key_binding_ptr;
+        if (NULL == masked_ptr ||
+            (NULL != exact_ptr &&
+             exact_ptr->sequence < masked_ptr->sequence)) {
+            key_binding_ptr = exact_ptr;
+            exact_dlnode_ptr = exact_dlnode_ptr->next_ptr;
+        } else {
+            key_binding_ptr = masked_ptr;
+            masked_dlnode_ptr = masked_dlnode_ptr->next_ptr;
+        }
+
         const wlmaker_key_combo_t *key_combo_ptr =
             key_binding_ptr->key_combo_ptr;
-
-        uint32_t mask = key_combo_ptr->modifiers_mask;
-        if (!mask) mask = UINT32_MAX;
-        if ((modifiers & mask) != key_combo_ptr->modifiers) continue;
-
-        xkb_keysym_t bound_ks = key_combo_ptr->keysym;
-        if (!key_combo_ptr->ignore_case && keysym != bound_ks) continue;
-
-        if (key_combo_ptr->ignore_case &&
-            keysym != xkb_keysym_to_lower(bound_ks) &&
-            keysym != xkb_keysym_to_upper(bound_ks)) continue;
-
+        if (!_wlmaker_server_binding_matches(
+                key_combo_ptr, keysym, modifiers)) continue;
         if (key_binding_ptr->callback(key_combo_ptr)) return true;
     }
     return false;
@@ -494,6 +680,69 @@ bool wlmaker_keyboard_process_bindings(
 
 /* == Local (static) methods =============================================== */
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the bucket of @ref wlmaker_server_t::binding_buckets for the key.
+ *
+ * Keysyms are hashed in lower case, so that bindings ignoring the case share
+ * the bucket with either case of the key pressed.
+ *
+ * @param server_ptr
+ * @param masked              Whether to return the bucket of the bindings
+ *                            with a modifier mask. These are hashed by the
+ *                            keysym only.
+ * @param keysym
+ * @param modifiers
+ *
+ * @return Pointer to the bucket.
+ */
+bs_dllist_t *_wlmaker_server_binding_bucket(
+    wlmaker_server_t *server_ptr,
+    bool masked,
+    xkb_keysym_t keysym,
+    uint32_t modifiers)
+{
+    uint32_t hash = (uint32_t)xkb_keysym_to_lower(keysym) * 2654435761U;
+    if (!masked) hash ^= modifiers * 40503U;
+    hash ^= hash >> 16;
+    return &server_ptr->binding_buckets[masked ? 1 : 0][
+        hash & (WLMAKER_BINDING_BUCKETS - 1)];
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return The binding of the bucket's `dlnode_ptr`, or NULL. */
+wlmaker_key_binding_t *_wlmaker_server_binding_from_bucket_dlnode(
+    bs_dllist_node_t *dlnode_ptr)
+{
+    if (NULL == dlnode_ptr) return NULL;
+    return BS_CONTAINER_OF(dlnode_ptr, wlmaker_key_binding_t, bucket_dlnode);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns whether the key combo matches `keysym` and `modifiers`.
+ *
+ * @param key_combo_ptr
+ * @param keysym
+ * @param modifiers
+ *
+ * @return true if it matches.
+ */
+bool _wlmaker_server_binding_matches(
+    const wlmaker_key_combo_t *key_combo_ptr,
+    xkb_keysym_t keysym,
+    uint32_t modifiers)
+{
+    uint32_t mask = key_combo_ptr->modifiers_mask;
+    if (!mask) mask = UINT32_MAX;
+    if ((modifiers & mask) != key_combo_ptr->modifiers) return false;
+
+    xkb_keysym_t bound_ks = key_combo_ptr->keysym;
+    if (!key_combo_ptr->ignore_case) return keysym == bound_ks;
+    return (keysym == xkb_keysym_to_lower(bound_ks) ||
+            keysym == xkb_keysym_to_upper(bound_ks));
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Registers the input device at |handle_ptr| with |server_ptr|.
@@ -646,10 +895,12 @@ void _wlmaker_server_unclaimed_button_event_handler(
 /* == Unit tests =========================================================== */
 
 static void test_bind(bs_test_t *test_ptr);
+static void test_bind_order(bs_test_t *test_ptr);
 
 /** Test cases for the server. */
 const bs_test_case_t          wlmaker_server_test_cases[] = {
     { 1, "bind", test_bind },
+    { 1, "bind_order", test_bind_order },
     { 0, NULL, NULL }
 };
 
@@ -659,6 +910,15 @@ bool test_binding_callback(
     return true;
 }
 
+/** Test helper: Key combo last passed to @ref test_record_callback. */
+static const wlmaker_key_combo_t *test_recorded_combo_ptr;
+
+/** Test helper: Callback for a keybinding, records the combo. */
+bool test_record_callback(const wlmaker_key_combo_t *key_combo_ptr) {
+    test_recorded_combo_ptr = key_combo_ptr;
+    return true;
+}
+
 /* ------------------------------------------------------------------------- */
 /** Tests key bindings. */
 void test_bind(bs_test_t *test_ptr)
@@ -713,4 +973,60 @@ void test_bind(bs_test_t *test_ptr)
     wlmaker_server_unbind_key(&srv, kb1_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests that registration order decides among masked and exact bindings. */
+void test_bind_order(bs_test_t *test_ptr)
+{
+    wlmaker_server_t          srv = {};
+    wlmaker_key_combo_t      masked = {
+        .modifiers = WLR_MODIFIER_LOGO,
+        .modifiers_mask = WLR_MODIFIER_LOGO | WLR_MODIFIER_SHIFT,
+        .keysym = XKB_KEY_x,
+        .ignore_case = true
+    };
+    wlmaker_key_combo_t      exact = {
+        .modifiers = WLR_MODIFIER_LOGO,
+        .keysym = XKB_KEY_x
+    };
+
+    wlmaker_key_binding_t *kb1_ptr = wlmaker_server_bind_key(
+        &srv, &exact, test_record_callback);
+    wlmaker_key_binding_t *kb2_ptr = wlmaker_server_bind_key(
+        &srv, &masked, test_record_callback);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, kb1_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, kb2_ptr);
+
+    // Both match: The exact binding was registered first.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmaker_keyboard_process_bindings(&srv, XKB_KEY_x, WLR_MODIFIER_LOGO));
+    BS_TEST_VERIFY_EQ(test_ptr, &exact, test_recorded_combo_ptr);
+
+    // Only the masked binding ignores case and further modifiers.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmaker_keyboard_process_bindings(
+            &srv, XKB_KEY_X, WLR_MODIFIER_LOGO | WLR_MODIFIER_ALT));
+    BS_TEST_VERIFY_EQ(test_ptr, &masked, test_recorded_combo_ptr);
+
+    // Re-registering the exact binding puts it after the masked one.
+    wlmaker_server_unbind_key(&srv, kb1_ptr);
+    kb1_ptr = wlmaker_server_bind_key(&srv, &exact, test_record_callback);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmaker_keyboard_process_bindings(&srv, XKB_KEY_x, WLR_MODIFIER_LOGO));
+    BS_TEST_VERIFY_EQ(test_ptr, &masked, test_recorded_combo_ptr);
+
+    wlmaker_server_unbind_key(&srv, kb2_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmaker_keyboard_process_bindings(&srv, XKB_KEY_x, WLR_MODIFIER_LOGO));
+    BS_TEST_VERIFY_EQ(test_ptr, &exact, test_recorded_combo_ptr);
+    BS_TEST_VERIFY_FALSE(
+        test_ptr,
+        wlmaker_keyboard_process_bindings(&srv, XKB_KEY_X, WLR_MODIFIER_LOGO));
+
+    wlmaker_server_unbind_key(&srv, kb1_ptr);
+}
+
 /* == End of server.c ====================================================== */
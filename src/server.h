@@ -51,7 +51,11 @@ typedef struct _wlmaker_key_binding_t wlmaker_key_binding_t;
  */
 typedef bool (*wlmaker_keybinding_callback_t)(const wlmaker_key_combo_t *kc);
 
+/** Number of hash buckets for indexing key bindings. A power of 2. */
+#define WLMAKER_BINDING_BUCKETS 64
+
 #include "backend/backend.h"
+#include "client_quota.h"  // IWYU pragma: keep
 #include "config.h"
 #include "corner.h"  // IWYU pragma: keep
 #include "cursor.h"  // IWYU pragma: keep
@@ -60,8 +64,10 @@ typedef bool (*wlmaker_keybinding_callback_t)(const wlmaker_key_combo_t *kc);
 #include "layer_shell.h"  // IWYU pragma: keep
 #include "lock_mgr.h"  // IWYU pragma: keep
 #include "root_menu.h"  // IWYU pragma: keep
+#include "state_writer.h"  // IWYU pragma: keep
 #include "subprocess_monitor.h"  // IWYU pragma: keep
 #include "toolkit/toolkit.h"
+#include "window_rules.h"  // IWYU pragma: keep
 #include "xdg_decoration.h"  // IWYU pragma: keep
 #include "xdg_shell.h"  // IWYU pragma: keep
 #include "xwl.h"  // IWYU pragma: keep
@@ -111,6 +117,11 @@ struct _wlmaker_server_t {
 
     /** The data device manager handles the clipboard. */
     struct wlr_data_device_manager *wlr_data_device_manager_ptr;
+    /** Security contexts, `wp_security_context_v1`, to identify sandboxes. */
+    struct wlr_security_context_manager_v1
+        *wlr_security_context_manager_v1_ptr;
+    /** Per-client resource quotas. */
+    wlmaker_client_quota_t    *client_quota_ptr;
 
     /** The cursor handler. */
     wlmaker_cursor_t          *cursor_ptr;
@@ -142,9 +153,24 @@ struct _wlmaker_server_t {
     struct wl_signal          task_list_enabled_event;
     /** Signal: When the task list is disabled. (to be hidden) */
     struct wl_signal          task_list_disabled_event;
+    /** Signal: When the debug overlay is to be toggled. */
+    struct wl_signal          debug_overlay_toggle_event;
 
     /** List of all bound keys, see @ref wlmaker_key_binding_t::dlnode. */
     bs_dllist_t               bindings;
+    /**
+     * Index of the bound keys, by hash of the lower-case keysym and the
+     * modifiers. Bindings with a modifier mask are hashed by keysym only, and
+     * go into the second set. See @ref wlmaker_key_binding_t::bucket_dlnode.
+     */
+    bs_dllist_t               binding_buckets[2][WLMAKER_BINDING_BUCKETS];
+    /** Sequence number for the next binding. Keeps registration order. */
+    uint64_t                  binding_sequence;
+    /**
+     * Modifiers of the key bindings for switching workspaces. Holding them
+     * pre-warms the neighbour workspaces. 0 if there is no such binding.
+     */
+    uint32_t                  workspace_switch_modifiers;
 
     /** Clients for this server. */
     bs_dllist_t               clients;
@@ -152,6 +178,9 @@ struct _wlmaker_server_t {
     /** Subprocess monitoring. */
     wlmaker_subprocess_monitor_t *monitor_ptr;
 
+    /** Rules for new windows. From the `WindowRules` config array. */
+    wlmaker_window_rules_t    *window_rules_ptr;
+
     /** Montor & handler of 'hot corners'. */
     wlmaker_corner_t          *corner_ptr;
 
@@ -161,6 +190,11 @@ struct _wlmaker_server_t {
     struct wl_signal          window_created_event;
     /** Signal: Triggered whenever a window is destroyed. */
     struct wl_signal          window_destroyed_event;
+    /**
+     * Signal: Requests to reload configuration and style. Raised by
+     * @ref WLMAKER_ACTION_RELOAD.
+     */
+    struct wl_signal          reload_event;
 
     /** Temporary: Points to the @ref wlmtk_dock_t of the clip. */
     wlmtk_dock_t              *clip_dock_ptr;
@@ -169,6 +203,8 @@ struct _wlmaker_server_t {
     wlmaker_root_menu_t       *root_menu_ptr;
     /** Parsed contents of the root menu definition, from plist. */
     bspl_array_t            *root_menu_array_ptr;
+    /** Writer for the state file, eg. the dock's launchers. May be NULL. */
+    wlmaker_state_writer_t    *state_writer_ptr;
     /** Listener for `unclaimed_button_event` signal raised by `wlmtk_root`. */
     struct wl_listener        unclaimed_button_event_listener;
 
@@ -262,6 +298,23 @@ void wlmaker_server_activate_task_list(wlmaker_server_t *server_ptr);
  */
 void wlmaker_server_deactivate_task_list(wlmaker_server_t *server_ptr);
 
+/**
+ * Applies a re-loaded style to the server's existing windows.
+ *
+ * Compares `style_ptr` against @ref wlmaker_server_t::style, and updates only
+ * the windows if the window style differs. Other elements retain their style
+ * until re-created. The cursor style is not applied, as the cursor theme is
+ * only loaded at startup.
+ *
+ * @param server_ptr
+ * @param style_ptr
+ *
+ * @return true if the style differed from the current style.
+ */
+bool wlmaker_server_apply_style(
+    wlmaker_server_t *server_ptr,
+    const wlmaker_config_style_t *style_ptr);
+
 /**
  * Looks up which output serves the current cursor coordinates and returns that.
  *
@@ -0,0 +1,237 @@
+/* ========================================================================= */
+/**
+ * @file startup_profile.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/// open_memstream() is a POSIX extension.
+#define _POSIX_C_SOURCE 200809L
+
+#include "startup_profile.h"
+
+#include <inttypes.h>
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* == Declarations ========================================================= */
+
+/** Maximum number of phases recorded in a profile. */
+#define WLMAKER_STARTUP_PROFILE_MAX_PHASES 32
+
+/** A phase of the startup. */
+typedef struct {
+    /** Name of the phase. Not owned. */
+    const char                *name_ptr;
+    /** Start time, in nanoseconds since the profile's start. */
+    uint64_t                  begin_nsec;
+    /** End time, in nanoseconds since the profile's start. */
+    uint64_t                  end_nsec;
+} wlmaker_startup_phase_t;
+
+/** State of the startup profile. */
+struct _wlmaker_startup_profile_t {
+    /** Monotonic time of creating the profile, in nanoseconds. */
+    uint64_t                  start_nsec;
+    /** The phases recorded so far. */
+    wlmaker_startup_phase_t   phases[WLMAKER_STARTUP_PROFILE_MAX_PHASES];
+    /** Number of phases recorded in @ref wlmaker_startup_profile_t::phases. */
+    size_t                    phases_len;
+    /** Whether the last of the phases is still ongoing. */
+    bool                      in_phase;
+};
+
+static uint64_t _wlmaker_startup_profile_now_nsec(void);
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmaker_startup_profile_t *wlmaker_startup_profile_create(void)
+{
+    wlmaker_startup_profile_t *profile_ptr = logged_calloc(
+        1, sizeof(wlmaker_startup_profile_t));
+    if (NULL == profile_ptr) return NULL;
+    profile_ptr->start_nsec = _wlmaker_startup_profile_now_nsec();
+    return profile_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_startup_profile_destroy(wlmaker_startup_profile_t *profile_ptr)
+{
+    free(profile_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_startup_profile_phase(
+    wlmaker_startup_profile_t *profile_ptr,
+    const char *name_ptr)
+{
+    wlmaker_startup_profile_end(profile_ptr);
+    if (WLMAKER_STARTUP_PROFILE_MAX_PHASES <= profile_ptr->phases_len) return;
+
+    wlmaker_startup_phase_t *phase_ptr =
+        &profile_ptr->phases[profile_ptr->phases_len++];
+    phase_ptr->name_ptr = name_ptr;
+    phase_ptr->begin_nsec =
+        _wlmaker_startup_profile_now_nsec() - profile_ptr->start_nsec;
+    phase_ptr->end_nsec = phase_ptr->begin_nsec;
+    profile_ptr->in_phase = true;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_startup_profile_end(wlmaker_startup_profile_t *profile_ptr)
+{
+    if (!profile_ptr->in_phase) return;
+    profile_ptr->phases[profile_ptr->phases_len - 1].end_nsec =
+        _wlmaker_startup_profile_now_nsec() - profile_ptr->start_nsec;
+    profile_ptr->in_phase = false;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_startup_profile_log(
+    wlmaker_startup_profile_t *profile_ptr,
+    bs_log_severity_t severity)
+{
+    uint64_t total_nsec = 0;
+    for (size_t i = 0; i < profile_ptr->phases_len; ++i) {
+        wlmaker_startup_phase_t *phase_ptr = &profile_ptr->phases[i];
+        bs_log(severity, "Startup phase %-24s at %8.3f ms: %8.3f ms",
+               phase_ptr->name_ptr,
+               phase_ptr->begin_nsec / 1e6,
+               (phase_ptr->end_nsec - phase_ptr->begin_nsec) / 1e6);
+        total_nsec = phase_ptr->end_nsec;
+    }
+    bs_log(severity, "Startup total: %.3f ms in %zu phases",
+           total_nsec / 1e6, profile_ptr->phases_len);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmaker_startup_profile_write_trace(
+    wlmaker_startup_profile_t *profile_ptr,
+    FILE *file_ptr)
+{
+    int pid = getpid();
+    if (0 > fprintf(file_ptr, "{\"traceEvents\":[")) return false;
+    for (size_t i = 0; i < profile_ptr->phases_len; ++i) {
+        wlmaker_startup_phase_t *phase_ptr = &profile_ptr->phases[i];
+        // Complete events ("X"), with timestamps in microseconds. Phase names
+        // are literals from the source, so require no escaping.
+        if (0 > fprintf(
+                file_ptr,
+                "%s{\"name\":\"%s\",\"cat\":\"startup\",\"ph\":\"X\","
+                "\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d}",
+                0 < i ? "," : "",
+                phase_ptr->name_ptr,
+                phase_ptr->begin_nsec / 1e3,
+                (phase_ptr->end_nsec - phase_ptr->begin_nsec) / 1e3,
+                pid, pid)) {
+            return false;
+        }
+    }
+    if (0 > fprintf(file_ptr, "]}\n")) return false;
+    return 0 == fflush(file_ptr);
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** @return The current time of CLOCK_MONOTONIC, in nanoseconds. */
+uint64_t _wlmaker_startup_profile_now_nsec(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + now.tv_nsec;
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlmaker_startup_profile_test_phases(bs_test_t *test_ptr);
+static void _wlmaker_startup_profile_test_trace(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_startup_profile_test_cases[] = {
+    { 1, "phases", _wlmaker_startup_profile_test_phases },
+    { 1, "trace", _wlmaker_startup_profile_test_trace },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Tests that phases are recorded, in order and without overlap. */
+void _wlmaker_startup_profile_test_phases(bs_test_t *test_ptr)
+{
+    wlmaker_startup_profile_t *p = wlmaker_startup_profile_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, p);
+
+    wlmaker_startup_profile_phase(p, "first");
+    wlmaker_startup_profile_phase(p, "second");
+    wlmaker_startup_profile_end(p);
+    wlmaker_startup_profile_end(p);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, p->phases_len);
+    BS_TEST_VERIFY_STREQ(test_ptr, "first", p->phases[0].name_ptr);
+    BS_TEST_VERIFY_STREQ(test_ptr, "second", p->phases[1].name_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, p->phases[0].end_nsec <= p->phases[1].begin_nsec);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, p->phases[1].begin_nsec <= p->phases[1].end_nsec);
+
+    // Excess phases are ignored.
+    for (int i = 0; i < 2 * WLMAKER_STARTUP_PROFILE_MAX_PHASES; ++i) {
+        wlmaker_startup_profile_phase(p, "more");
+    }
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMAKER_STARTUP_PROFILE_MAX_PHASES, p->phases_len);
+    wlmaker_startup_profile_destroy(p);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests the Chrome trace JSON output. */
+void _wlmaker_startup_profile_test_trace(bs_test_t *test_ptr)
+{
+    wlmaker_startup_profile_t *p = wlmaker_startup_profile_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, p);
+    p->phases[0] = (wlmaker_startup_phase_t){
+        .name_ptr = "config", .begin_nsec = 1000, .end_nsec = 3500 };
+    p->phases[1] = (wlmaker_startup_phase_t){
+        .name_ptr = "server", .begin_nsec = 3500, .end_nsec = 10000 };
+    p->phases_len = 2;
+
+    char *buf_ptr = NULL;
+    size_t size;
+    FILE *file_ptr = open_memstream(&buf_ptr, &size);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, file_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmaker_startup_profile_write_trace(p, file_ptr));
+    fclose(file_ptr);
+
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL,
+        strstr(buf_ptr, "{\"name\":\"config\",\"cat\":\"startup\","
+               "\"ph\":\"X\",\"ts\":1.000,\"dur\":2.500,"));
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL,
+        strstr(buf_ptr, "},{\"name\":\"server\",\"cat\":\"startup\","
+               "\"ph\":\"X\",\"ts\":3.500,\"dur\":6.500,"));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, strncmp(buf_ptr, "{\"traceEvents\":[", 16));
+    free(buf_ptr);
+    wlmaker_startup_profile_destroy(p);
+}
+
+/* == End of startup_profile.c ============================================= */
@@ -0,0 +1,101 @@
+/* ========================================================================= */
+/**
+ * @file startup_profile.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __STARTUP_PROFILE_H__
+#define __STARTUP_PROFILE_H__
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+/** Forward declaration: Startup profile. */
+typedef struct _wlmaker_startup_profile_t wlmaker_startup_profile_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Creates a startup profile, and records the current time as its start.
+ *
+ * @return Pointer to the startup profile, or NULL on error. Must be destroyed
+ *     by @ref wlmaker_startup_profile_destroy.
+ */
+wlmaker_startup_profile_t *wlmaker_startup_profile_create(void);
+
+/**
+ * Destroys the startup profile.
+ *
+ * @param profile_ptr
+ */
+void wlmaker_startup_profile_destroy(wlmaker_startup_profile_t *profile_ptr);
+
+/**
+ * Begins a named phase, at the current monotonic time. Ends the phase that
+ * was begun before, if any.
+ *
+ * Phases beyond the profile's capacity are ignored.
+ *
+ * @param profile_ptr
+ * @param name_ptr            Name of the phase. Must outlive the profile,
+ *                            eg. a string literal.
+ */
+void wlmaker_startup_profile_phase(
+    wlmaker_startup_profile_t *profile_ptr,
+    const char *name_ptr);
+
+/**
+ * Ends the current phase, if any.
+ *
+ * @param profile_ptr
+ */
+void wlmaker_startup_profile_end(wlmaker_startup_profile_t *profile_ptr);
+
+/**
+ * Logs a summary of all phases: Duration of each, and the total.
+ *
+ * @param profile_ptr
+ * @param severity
+ */
+void wlmaker_startup_profile_log(
+    wlmaker_startup_profile_t *profile_ptr,
+    bs_log_severity_t severity);
+
+/**
+ * Writes the phases as JSON in the Chrome trace event format, to be viewed
+ * in chrome://tracing or Perfetto.
+ *
+ * @param profile_ptr
+ * @param file_ptr
+ *
+ * @return true on success.
+ */
+bool wlmaker_startup_profile_write_trace(
+    wlmaker_startup_profile_t *profile_ptr,
+    FILE *file_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_startup_profile_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __STARTUP_PROFILE_H__ */
+/* == End of startup_profile.h ============================================= */
@@ -0,0 +1,604 @@
+/* ========================================================================= */
+/**
+ * @file state_writer.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/// mkdtemp() and O_CLOEXEC are POSIX extensions.
+#define _POSIX_C_SOURCE 200809L
+
+#include "state_writer.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <libbase/libbase.h>
+#include <libbase/plist.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <wayland-server-core.h>
+
+/* == Declarations ========================================================= */
+
+/** A growing buffer, holding a serialized state. */
+typedef struct {
+    /** The data, NUL-terminated. NULL if nothing was appended yet. */
+    char                      *data_ptr;
+    /** Length of the data, excluding the terminating NUL. */
+    size_t                    length;
+    /** Allocated size of `data_ptr`. */
+    size_t                    capacity;
+} wlmaker_state_buffer_t;
+
+/** State of the state file writer. */
+struct _wlmaker_state_writer_t {
+    /** Path of the state file. */
+    char                      *fname_ptr;
+    /** Delay from the last update until writing. */
+    uint64_t                  debounce_msec;
+    /** Timer for debouncing. */
+    struct wl_event_source    *timer_event_source_ptr;
+    /** Serialized state, waiting for the debounce. Main thread only. */
+    wlmaker_state_buffer_t    staged;
+
+    /** Guards `pending`, `shutdown` and `writes`. */
+    pthread_mutex_t           mutex;
+    /** Signals the worker thread about a pending state, or shutdown. */
+    pthread_cond_t            cond;
+    /** The worker thread. */
+    pthread_t                 thread;
+    /** Whether @ref wlmaker_state_writer_t::thread was started. */
+    bool                      thread_started;
+    /** Serialized state, handed to the worker thread for writing. */
+    wlmaker_state_buffer_t    pending;
+    /** Tells the worker thread to write what is pending, and exit. */
+    bool                      shutdown;
+    /** Number of states written. */
+    size_t                    writes;
+};
+
+/** Argument to @ref _wlmaker_state_serialize_item. */
+typedef struct {
+    /** Buffer to serialize into. */
+    wlmaker_state_buffer_t    *buffer_ptr;
+    /** Nesting depth of the items. */
+    int                       depth;
+} wlmaker_state_item_arg_t;
+
+static bool _wlmaker_state_buffer_append(
+    wlmaker_state_buffer_t *buffer_ptr,
+    const char *data_ptr,
+    size_t length);
+static void _wlmaker_state_buffer_fini(wlmaker_state_buffer_t *buffer_ptr);
+static bool _wlmaker_state_serialize_object(
+    wlmaker_state_buffer_t *buffer_ptr,
+    bspl_object_t *object_ptr,
+    int depth);
+static bool _wlmaker_state_serialize_string(
+    wlmaker_state_buffer_t *buffer_ptr,
+    const char *value_ptr);
+static bool _wlmaker_state_serialize_item(
+    const char *key_ptr,
+    bspl_object_t *object_ptr,
+    void *userdata_ptr);
+static bool _wlmaker_state_serialize_indent(
+    wlmaker_state_buffer_t *buffer_ptr,
+    int depth);
+static bool _wlmaker_state_write_file(
+    const char *fname_ptr,
+    const char *data_ptr,
+    size_t length);
+
+static void *_wlmaker_state_writer_thread(void *arg_ptr);
+static int _wlmaker_state_writer_handle_timer(void *data_ptr);
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmaker_state_writer_t *wlmaker_state_writer_create(
+    struct wl_event_loop *wl_event_loop_ptr,
+    const char *fname_ptr,
+    uint64_t debounce_msec)
+{
+    wlmaker_state_writer_t *state_writer_ptr = logged_calloc(
+        1, sizeof(wlmaker_state_writer_t));
+    if (NULL == state_writer_ptr) return NULL;
+    // A delay of 0 would disarm the timer.
+    state_writer_ptr->debounce_msec = BS_MAX(1u, debounce_msec);
+    pthread_mutex_init(&state_writer_ptr->mutex, NULL);
+    pthread_cond_init(&state_writer_ptr->cond, NULL);
+
+    state_writer_ptr->fname_ptr = logged_strdup(fname_ptr);
+    if (NULL == state_writer_ptr->fname_ptr) {
+        wlmaker_state_writer_destroy(state_writer_ptr);
+        return NULL;
+    }
+
+    state_writer_ptr->timer_event_source_ptr = wl_event_loop_add_timer(
+        wl_event_loop_ptr,
+        _wlmaker_state_writer_handle_timer,
+        state_writer_ptr);
+    if (NULL == state_writer_ptr->timer_event_source_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_timer(%p, %p, %p)",
+               wl_event_loop_ptr, _wlmaker_state_writer_handle_timer,
+               state_writer_ptr);
+        wlmaker_state_writer_destroy(state_writer_ptr);
+        return NULL;
+    }
+
+    int rv = pthread_create(
+        &state_writer_ptr->thread, NULL, _wlmaker_state_writer_thread,
+        state_writer_ptr);
+    if (0 != rv) {
+        errno = rv;
+        bs_log(BS_ERROR | BS_ERRNO, "Failed pthread_create()");
+        wlmaker_state_writer_destroy(state_writer_ptr);
+        return NULL;
+    }
+    state_writer_ptr->thread_started = true;
+    return state_writer_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_state_writer_destroy(wlmaker_state_writer_t *state_writer_ptr)
+{
+    if (NULL != state_writer_ptr->timer_event_source_ptr) {
+        wl_event_source_remove(state_writer_ptr->timer_event_source_ptr);
+        state_writer_ptr->timer_event_source_ptr = NULL;
+    }
+
+    if (state_writer_ptr->thread_started) {
+        // Flushes what is still waiting for the debounce.
+        _wlmaker_state_writer_handle_timer(state_writer_ptr);
+        pthread_mutex_lock(&state_writer_ptr->mutex);
+        state_writer_ptr->shutdown = true;
+        pthread_cond_broadcast(&state_writer_ptr->cond);
+        pthread_mutex_unlock(&state_writer_ptr->mutex);
+        pthread_join(state_writer_ptr->thread, NULL);
+        state_writer_ptr->thread_started = false;
+    }
+
+    _wlmaker_state_buffer_fini(&state_writer_ptr->pending);
+    _wlmaker_state_buffer_fini(&state_writer_ptr->staged);
+    pthread_cond_destroy(&state_writer_ptr->cond);
+    pthread_mutex_destroy(&state_writer_ptr->mutex);
+    if (NULL != state_writer_ptr->fname_ptr) {
+        free(state_writer_ptr->fname_ptr);
+        state_writer_ptr->fname_ptr = NULL;
+    }
+    free(state_writer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmaker_state_writer_update(
+    wlmaker_state_writer_t *state_writer_ptr,
+    bspl_dict_t *state_dict_ptr)
+{
+    wlmaker_state_buffer_t buffer = {};
+    if (!_wlmaker_state_serialize_object(
+            &buffer, bspl_object_from_dict(state_dict_ptr), 0) ||
+        !_wlmaker_state_buffer_append(&buffer, "\n", 1)) {
+        bs_log(BS_ERROR, "Failed to serialize state for \"%s\"",
+               state_writer_ptr->fname_ptr);
+        _wlmaker_state_buffer_fini(&buffer);
+        return false;
+    }
+
+    // Replaces an update that is still waiting for the debounce.
+    _wlmaker_state_buffer_fini(&state_writer_ptr->staged);
+    state_writer_ptr->staged = buffer;
+    wl_event_source_timer_update(
+        state_writer_ptr->timer_event_source_ptr,
+        (int)BS_MIN(state_writer_ptr->debounce_msec, (uint64_t)INT32_MAX));
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmaker_state_writer_writes(wlmaker_state_writer_t *state_writer_ptr)
+{
+    pthread_mutex_lock(&state_writer_ptr->mutex);
+    size_t writes = state_writer_ptr->writes;
+    pthread_mutex_unlock(&state_writer_ptr->mutex);
+    return writes;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Appends `length` bytes at `data_ptr`, keeping the buffer NUL-terminated. */
+bool _wlmaker_state_buffer_append(
+    wlmaker_state_buffer_t *buffer_ptr,
+    const char *data_ptr,
+    size_t length)
+{
+    if (buffer_ptr->length + length + 1 > buffer_ptr->capacity) {
+        size_t capacity = BS_MAX((size_t)4096, buffer_ptr->capacity);
+        while (buffer_ptr->length + length + 1 > capacity) capacity *= 2;
+        char *new_data_ptr = realloc(buffer_ptr->data_ptr, capacity);
+        if (NULL == new_data_ptr) {
+            bs_log(BS_ERROR | BS_ERRNO, "Failed realloc(%p, %zu)",
+                   buffer_ptr->data_ptr, capacity);
+            return false;
+        }
+        buffer_ptr->data_ptr = new_data_ptr;
+        buffer_ptr->capacity = capacity;
+    }
+    memcpy(buffer_ptr->data_ptr + buffer_ptr->length, data_ptr, length);
+    buffer_ptr->length += length;
+    buffer_ptr->data_ptr[buffer_ptr->length] = '\0';
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Releases the buffer's data, and clears it. */
+void _wlmaker_state_buffer_fini(wlmaker_state_buffer_t *buffer_ptr)
+{
+    if (NULL != buffer_ptr->data_ptr) free(buffer_ptr->data_ptr);
+    *buffer_ptr = (wlmaker_state_buffer_t){};
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Serializes `object_ptr` in plist text format, as read by
+ * `bspl_create_object_from_plist_file`.
+ *
+ * @param buffer_ptr
+ * @param object_ptr
+ * @param depth               Nesting depth, for indenting.
+ *
+ * @return true on success.
+ */
+bool _wlmaker_state_serialize_object(
+    wlmaker_state_buffer_t *buffer_ptr,
+    bspl_object_t *object_ptr,
+    int depth)
+{
+    switch (bspl_object_type(object_ptr)) {
+    case BSPL_STRING:
+        return _wlmaker_state_serialize_string(
+            buffer_ptr,
+            bspl_string_value(bspl_string_from_object(object_ptr)));
+    case BSPL_ARRAY: {
+        bspl_array_t *array_ptr = bspl_array_from_object(object_ptr);
+        size_t count = bspl_array_size(array_ptr);
+        if (0 == count) {
+            return _wlmaker_state_buffer_append(buffer_ptr, "()", 2);
+        }
+        if (!_wlmaker_state_buffer_append(buffer_ptr, "(", 1)) return false;
+        for (size_t i = 0; i < count; ++i) {
+            // Separates from the previous element, if any.
+            if (!_wlmaker_state_buffer_append(
+                    buffer_ptr, 0 < i ? ",\n" : "\n", 0 < i ? 2 : 1) ||
+                !_wlmaker_state_serialize_indent(buffer_ptr, depth + 1) ||
+                !_wlmaker_state_serialize_object(
+                    buffer_ptr, bspl_array_at(array_ptr, i), depth + 1)) {
+                return false;
+            }
+        }
+        if (!_wlmaker_state_buffer_append(buffer_ptr, "\n", 1)) return false;
+        return _wlmaker_state_serialize_indent(buffer_ptr, depth) &&
+            _wlmaker_state_buffer_append(buffer_ptr, ")", 1);
+    }
+    case BSPL_DICT: {
+        wlmaker_state_item_arg_t arg = {
+            .buffer_ptr = buffer_ptr, .depth = depth + 1 };
+        return _wlmaker_state_buffer_append(buffer_ptr, "{\n", 2) &&
+            bspl_dict_foreach(
+                bspl_dict_from_object(object_ptr),
+                _wlmaker_state_serialize_item,
+                &arg) &&
+            _wlmaker_state_serialize_indent(buffer_ptr, depth) &&
+            _wlmaker_state_buffer_append(buffer_ptr, "}", 1);
+    }
+    default:
+        return false;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Serializes a string. Plain words are written unquoted. Anything else is
+ * quoted, with quotes and backslashes escaped.
+ *
+ * @param buffer_ptr
+ * @param value_ptr
+ *
+ * @return true on success.
+ */
+bool _wlmaker_state_serialize_string(
+    wlmaker_state_buffer_t *buffer_ptr,
+    const char *value_ptr)
+{
+    bool plain = 0 != *value_ptr;
+    for (const char *c_ptr = value_ptr; plain && 0 != *c_ptr; ++c_ptr) {
+        plain = isalnum((unsigned char)*c_ptr) || '_' == *c_ptr;
+    }
+    if (plain) {
+        return _wlmaker_state_buffer_append(
+            buffer_ptr, value_ptr, strlen(value_ptr));
+    }
+
+    if (!_wlmaker_state_buffer_append(buffer_ptr, "\"", 1)) return false;
+    const char *start_ptr = value_ptr;
+    for (const char *c_ptr = value_ptr; 0 != *c_ptr; ++c_ptr) {
+        if ('"' != *c_ptr && '\\' != *c_ptr) continue;
+        if (!_wlmaker_state_buffer_append(
+                buffer_ptr, start_ptr, c_ptr - start_ptr) ||
+            !_wlmaker_state_buffer_append(buffer_ptr, "\\", 1)) return false;
+        start_ptr = c_ptr;
+    }
+    return _wlmaker_state_buffer_append(
+        buffer_ptr, start_ptr, strlen(start_ptr)) &&
+        _wlmaker_state_buffer_append(buffer_ptr, "\"", 1);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Callback for bspl_dict_foreach: Serializes an item of a dict.
+ *
+ * @param key_ptr
+ * @param object_ptr
+ * @param userdata_ptr        Points to @ref wlmaker_state_item_arg_t.
+ *
+ * @return true on success.
+ */
+bool _wlmaker_state_serialize_item(
+    const char *key_ptr,
+    bspl_object_t *object_ptr,
+    void *userdata_ptr)
+{
+    wlmaker_state_item_arg_t *arg_ptr = userdata_ptr;
+    return _wlmaker_state_serialize_indent(
+        arg_ptr->buffer_ptr, arg_ptr->depth) &&
+        _wlmaker_state_serialize_string(arg_ptr->buffer_ptr, key_ptr) &&
+        _wlmaker_state_buffer_append(arg_ptr->buffer_ptr, " = ", 3) &&
+        _wlmaker_state_serialize_object(
+            arg_ptr->buffer_ptr, object_ptr, arg_ptr->depth) &&
+        _wlmaker_state_buffer_append(arg_ptr->buffer_ptr, ";\n", 2);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Indents by 4 spaces per level of `depth`. */
+bool _wlmaker_state_serialize_indent(
+    wlmaker_state_buffer_t *buffer_ptr,
+    int depth)
+{
+    for (int i = 0; i < depth; ++i) {
+        if (!_wlmaker_state_buffer_append(buffer_ptr, "    ", 4)) return false;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Writes the file atomically: Into a temporary file in the same directory,
+ * which is synced and then renamed over `fname_ptr`.
+ *
+ * @param fname_ptr
+ * @param data_ptr
+ * @param length
+ *
+ * @return true on success.
+ */
+bool _wlmaker_state_write_file(
+    const char *fname_ptr,
+    const char *data_ptr,
+    size_t length)
+{
+    char tmp_fname[PATH_MAX];
+    int rv = snprintf(tmp_fname, sizeof(tmp_fname), "%s.tmp", fname_ptr);
+    if (0 > rv || sizeof(tmp_fname) <= (size_t)rv) return false;
+
+    int fd = open(tmp_fname, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (0 > fd) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed open(%s, ...)", tmp_fname);
+        return false;
+    }
+    size_t written = 0;
+    while (written < length) {
+        ssize_t w = write(fd, data_ptr + written, length - written);
+        if (0 > w && EINTR == errno) continue;
+        if (0 >= w) break;
+        written += w;
+    }
+    bool ok = written == length;
+    if (!ok) bs_log(BS_WARNING | BS_ERRNO, "Failed write(%s)", tmp_fname);
+    if (ok && 0 != fsync(fd)) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed fsync(%s)", tmp_fname);
+        ok = false;
+    }
+    if (0 != close(fd)) ok = false;
+    if (ok && 0 != rename(tmp_fname, fname_ptr)) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed rename(%s, %s)",
+               tmp_fname, fname_ptr);
+        ok = false;
+    }
+    if (!ok) {
+        unlink(tmp_fname);
+        return false;
+    }
+
+    // Syncs the directory, for the rename to persist. Best effort.
+    char dir[PATH_MAX];
+    strcpy(dir, fname_ptr);
+    char *slash_ptr = strrchr(dir, '/');
+    if (NULL == slash_ptr) {
+        strcpy(dir, ".");
+    } else if (slash_ptr == dir) {
+        dir[1] = '\0';
+    } else {
+        *slash_ptr = '\0';
+    }
+    int dir_fd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (0 <= dir_fd) {
+        fsync(dir_fd);
+        close(dir_fd);
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Worker thread: Writes the pending states, until shutdown. */
+void *_wlmaker_state_writer_thread(void *arg_ptr)
+{
+    wlmaker_state_writer_t *state_writer_ptr = arg_ptr;
+    pthread_mutex_lock(&state_writer_ptr->mutex);
+    for (;;) {
+        while (NULL == state_writer_ptr->pending.data_ptr &&
+               !state_writer_ptr->shutdown) {
+            pthread_cond_wait(&state_writer_ptr->cond,
+                              &state_writer_ptr->mutex);
+        }
+        if (NULL == state_writer_ptr->pending.data_ptr) break;
+
+        // Writes without holding the lock: Updates may get handed over.
+        wlmaker_state_buffer_t buffer = state_writer_ptr->pending;
+        state_writer_ptr->pending = (wlmaker_state_buffer_t){};
+        pthread_mutex_unlock(&state_writer_ptr->mutex);
+        bool written = _wlmaker_state_write_file(
+            state_writer_ptr->fname_ptr, buffer.data_ptr, buffer.length);
+        _wlmaker_state_buffer_fini(&buffer);
+        pthread_mutex_lock(&state_writer_ptr->mutex);
+        if (written) ++state_writer_ptr->writes;
+    }
+    pthread_mutex_unlock(&state_writer_ptr->mutex);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Debounce expired: Hands the staged state over to the worker thread. */
+int _wlmaker_state_writer_handle_timer(void *data_ptr)
+{
+    wlmaker_state_writer_t *state_writer_ptr = data_ptr;
+    if (NULL == state_writer_ptr->staged.data_ptr) return 0;
+
+    pthread_mutex_lock(&state_writer_ptr->mutex);
+    // A state not yet picked up by the worker is superseded.
+    _wlmaker_state_buffer_fini(&state_writer_ptr->pending);
+    state_writer_ptr->pending = state_writer_ptr->staged;
+    pthread_cond_signal(&state_writer_ptr->cond);
+    pthread_mutex_unlock(&state_writer_ptr->mutex);
+    state_writer_ptr->staged = (wlmaker_state_buffer_t){};
+    return 0;
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlmaker_state_writer_test_serialize(bs_test_t *test_ptr);
+static void _wlmaker_state_writer_test_write(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_state_writer_test_cases[] = {
+    { 1, "serialize", _wlmaker_state_writer_test_serialize },
+    { 1, "write", _wlmaker_state_writer_test_write },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Serializes in plist format, and parses back to the same values. */
+void _wlmaker_state_writer_test_serialize(bs_test_t *test_ptr)
+{
+    wlmaker_state_buffer_t b = {};
+    bspl_object_t *o = bspl_create_object_from_plist_string(
+        "{A = (x, \"y z\", {}, ());}");
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, o);
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmaker_state_serialize_object(&b, o, 0));
+    bspl_object_unref(o);
+    BS_TEST_VERIFY_STREQ(
+        test_ptr,
+        "{\n    A = (\n        x,\n        \"y z\",\n        {\n        },\n"
+        "        ()\n    );\n}",
+        b.data_ptr);
+    _wlmaker_state_buffer_fini(&b);
+
+    o = bspl_create_object_from_plist_string(
+        "{Name = \"a \\\"b\\\" c\\\\\"; Empty = \"\"; "
+        "Sub = {Path = \"/x/y\";};}");
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, o);
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmaker_state_serialize_object(&b, o, 0));
+    bspl_object_unref(o);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, b.data_ptr);
+
+    bspl_dict_t *d = bspl_dict_from_object(
+        bspl_create_object_from_plist_string(b.data_ptr));
+    _wlmaker_state_buffer_fini(&b);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, d);
+    BS_TEST_VERIFY_STREQ(
+        test_ptr, "a \"b\" c\\", bspl_dict_get_string_value(d, "Name"));
+    BS_TEST_VERIFY_STREQ(
+        test_ptr, "", bspl_dict_get_string_value(d, "Empty"));
+    BS_TEST_VERIFY_STREQ(
+        test_ptr, "/x/y", bspl_dict_get_string_value(
+            bspl_dict_get_dict(d, "Sub"), "Path"));
+    bspl_dict_unref(d);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Coalesces updates, writes from the thread, and flushes on destroy. */
+void _wlmaker_state_writer_test_write(bs_test_t *test_ptr)
+{
+    char dir[] = "/tmp/wlmaker_state_writer_test_XXXXXX";
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, mkdtemp(dir));
+    char fname[PATH_MAX];
+    snprintf(fname, sizeof(fname), "%s/state.plist", dir);
+    struct wl_event_loop *loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, loop_ptr);
+    wlmaker_state_writer_t *sw_ptr = wlmaker_state_writer_create(
+        loop_ptr, fname, 1);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, sw_ptr);
+
+    bspl_dict_t *d1 = bspl_dict_from_object(
+        bspl_create_object_from_plist_string("{Key = One;}"));
+    bspl_dict_t *d2 = bspl_dict_from_object(
+        bspl_create_object_from_plist_string("{Key = Two;}"));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmaker_state_writer_update(sw_ptr, d1));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmaker_state_writer_update(sw_ptr, d2));
+    for (int i = 0; i < 100 && 0 == wlmaker_state_writer_writes(sw_ptr);
+         ++i) {
+        wl_event_loop_dispatch(loop_ptr, 10);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmaker_state_writer_writes(sw_ptr));
+
+    bspl_dict_t *d = bspl_dict_from_object(
+        bspl_create_object_from_plist_file(fname));
+    BS_TEST_VERIFY_STREQ(
+        test_ptr, "Two", bspl_dict_get_string_value(d, "Key"));
+    if (NULL != d) bspl_dict_unref(d);
+
+    // Pending within the debounce: Written on destroy.
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmaker_state_writer_update(sw_ptr, d1));
+    wlmaker_state_writer_destroy(sw_ptr);
+    d = bspl_dict_from_object(bspl_create_object_from_plist_file(fname));
+    BS_TEST_VERIFY_STREQ(
+        test_ptr, "One", bspl_dict_get_string_value(d, "Key"));
+    if (NULL != d) bspl_dict_unref(d);
+
+    bspl_dict_unref(d2);
+    bspl_dict_unref(d1);
+    wl_event_loop_destroy(loop_ptr);
+    unlink(fname);
+    rmdir(dir);
+}
+
+/* == End of state_writer.c ================================================ */
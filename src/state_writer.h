@@ -0,0 +1,92 @@
+/* ========================================================================= */
+/**
+ * @file state_writer.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __STATE_WRITER_H__
+#define __STATE_WRITER_H__
+
+#include <libbase/libbase.h>
+#include <libbase/plist.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <wayland-server-core.h>
+
+/** Forward declaration: Persists the state file. */
+typedef struct _wlmaker_state_writer_t wlmaker_state_writer_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Creates the writer for the state file, eg. `~/.wlmaker-state.plist`.
+ *
+ * Updates are debounced, and then written on a worker thread: To a
+ * temporary file next to `fname_ptr`, which is synced and then renamed.
+ * The event loop never waits for file I/O, and a crash mid-write leaves
+ * the previous state intact.
+ *
+ * @param wl_event_loop_ptr
+ * @param fname_ptr           Path of the state file.
+ * @param debounce_msec       Delay from the last update until writing.
+ *
+ * @return Pointer to the writer, or NULL on error. Must be destroyed by
+ *     calling @ref wlmaker_state_writer_destroy.
+ */
+wlmaker_state_writer_t *wlmaker_state_writer_create(
+    struct wl_event_loop *wl_event_loop_ptr,
+    const char *fname_ptr,
+    uint64_t debounce_msec);
+
+/**
+ * Destroys the writer. A pending update is written before returning: This
+ * waits on file I/O, and is meant for shutdown.
+ *
+ * @param state_writer_ptr
+ */
+void wlmaker_state_writer_destroy(wlmaker_state_writer_t *state_writer_ptr);
+
+/**
+ * Updates the state to write.
+ *
+ * Serializes `state_dict_ptr` right away, so the caller may keep modifying
+ * it. Updates arriving within the debounce delay are coalesced, and only
+ * the last one is written.
+ *
+ * @param state_writer_ptr
+ * @param state_dict_ptr
+ *
+ * @return true on success.
+ */
+bool wlmaker_state_writer_update(
+    wlmaker_state_writer_t *state_writer_ptr,
+    bspl_dict_t *state_dict_ptr);
+
+/** @return Number of updates the worker thread wrote, so far. */
+size_t wlmaker_state_writer_writes(wlmaker_state_writer_t *state_writer_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_state_writer_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __STATE_WRITER_H__ */
+/* == End of state_writer.h ================================================ */
@@ -0,0 +1,629 @@
+/* ========================================================================= */
+/**
+ * @file stats_socket.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stats_socket.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <libbase/libbase.h>
+#include <malloc.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <wayland-server-core.h>
+#define WLR_USE_UNSTABLE
+#include <wlr/types/wlr_output.h>
+#include <wlr/types/wlr_scene.h>
+#undef WLR_USE_UNSTABLE
+
+#include "backend/backend.h"
+#include "backend/output.h"
+#include "memlock.h"
+#include "subprocess_monitor.h"
+#include "toolkit/toolkit.h"
+
+/* == Declarations ========================================================= */
+
+/** State of the stats socket. */
+struct _wlmaker_stats_socket_t {
+    /** Back-link to the server. */
+    wlmaker_server_t          *server_ptr;
+    /** The watchdog to report, or NULL. */
+    wlmaker_watchdog_t        *watchdog_ptr;
+
+    /** Path of the socket. */
+    struct sockaddr_un        addr;
+    /** File descriptor of the listening socket. */
+    int                       fd;
+    /** Event source for @ref wlmaker_stats_socket_t::fd. */
+    struct wl_event_source    *event_source_ptr;
+
+    /** Buffer for the serialized snapshot. */
+    char                      *buf_ptr;
+};
+
+/** Appends to a fixed buffer. Truncates at the last complete line. */
+typedef struct {
+    /** The buffer. */
+    char                      *buf_ptr;
+    /** Size of the buffer, in bytes. */
+    size_t                    size;
+    /** Bytes written. */
+    size_t                    len;
+    /** Position following the last complete line written. */
+    size_t                    line_end;
+    /** Whether an append did not fit into the buffer. */
+    bool                      truncated;
+} _wlmaker_stats_writer_t;
+
+/** Describes a counter of @ref wlmbe_output_stats_t. */
+typedef struct {
+    /** Name of the counter. */
+    const char                *name_ptr;
+    /** Offset of the counter in @ref wlmbe_output_stats_t. */
+    size_t                    offset;
+} _wlmaker_stats_output_counter_t;
+
+static int _wlmaker_stats_socket_handle_accept(
+    int fd,
+    uint32_t mask,
+    void *data_ptr);
+static void _wlmaker_stats_printf(
+    _wlmaker_stats_writer_t *writer_ptr,
+    const char *fmt_ptr, ...) __attribute__((format(printf, 2, 3)));
+static void _wlmaker_stats_write_output(
+    wlmbe_output_t *output_ptr,
+    void *ud_ptr);
+static void _wlmaker_stats_write_latency(
+    wlmtk_latency_t *latency_ptr,
+    void *ud_ptr);
+static void _wlmaker_stats_write_histogram(
+    _wlmaker_stats_writer_t *writer_ptr,
+    const char *name_ptr,
+    const char *tracker_ptr,
+    const uint64_t *histogram_ptr);
+static void _wlmaker_stats_write_pool(
+    const wlmtk_pool_stats_t *stats_ptr,
+    void *ud_ptr);
+static void _wlmaker_stats_count_windows(
+    bs_dllist_node_t *dlnode_ptr,
+    void *ud_ptr);
+static bool _wlmaker_stats_count_scene_nodes(
+    struct wl_list *link_ptr,
+    void *ud_ptr);
+
+/* == Data ================================================================= */
+
+/** Counters of @ref wlmbe_output_stats_t, as reported. */
+static const _wlmaker_stats_output_counter_t
+_wlmaker_stats_output_counters[] = {
+    { "commits", offsetof(wlmbe_output_stats_t, commits) },
+    { "commit_nsec_sum", offsetof(wlmbe_output_stats_t, commit_nsec_sum) },
+    { "commit_nsec_max", offsetof(wlmbe_output_stats_t, commit_nsec_max) },
+    { "missed_vblanks", offsetof(wlmbe_output_stats_t, missed_vblanks) },
+    { "jitter_samples", offsetof(wlmbe_output_stats_t, jitter_samples) },
+    { "jitter_nsec_sum", offsetof(wlmbe_output_stats_t, jitter_nsec_sum) },
+    { "jitter_nsec_max", offsetof(wlmbe_output_stats_t, jitter_nsec_max) },
+    { "buffers_sum", offsetof(wlmbe_output_stats_t, buffers_sum) },
+    { "buffers_max", offsetof(wlmbe_output_stats_t, buffers_max) },
+    { "damage_px_sum", offsetof(wlmbe_output_stats_t, damage_px_sum) },
+    { "damage_px_max", offsetof(wlmbe_output_stats_t, damage_px_max) },
+    { "scanout_hits", offsetof(wlmbe_output_stats_t, scanout_hits) },
+    { "scanout_misses", offsetof(wlmbe_output_stats_t, scanout_misses) },
+    { "occluded_sum", offsetof(wlmbe_output_stats_t, occluded_sum) },
+    { "occluded_max", offsetof(wlmbe_output_stats_t, occluded_max) },
+    { "cursor_hardware", offsetof(wlmbe_output_stats_t, cursor_hardware) },
+    { "cursor_software", offsetof(wlmbe_output_stats_t, cursor_software) },
+};
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmaker_stats_socket_t *wlmaker_stats_socket_create(
+    wlmaker_server_t *server_ptr,
+    wlmaker_watchdog_t *watchdog_ptr)
+{
+    wlmaker_stats_socket_t *stats_socket_ptr = logged_calloc(
+        1, sizeof(wlmaker_stats_socket_t));
+    if (NULL == stats_socket_ptr) return NULL;
+    stats_socket_ptr->server_ptr = server_ptr;
+    stats_socket_ptr->watchdog_ptr = watchdog_ptr;
+    stats_socket_ptr->fd = -1;
+
+    stats_socket_ptr->buf_ptr = logged_calloc(
+        1, WLMAKER_STATS_SOCKET_BUFFER_SIZE);
+    if (NULL == stats_socket_ptr->buf_ptr) {
+        wlmaker_stats_socket_destroy(stats_socket_ptr);
+        return NULL;
+    }
+
+    const char *dir_ptr = getenv("XDG_RUNTIME_DIR");
+    if (NULL == dir_ptr) {
+        bs_log(BS_ERROR, "XDG_RUNTIME_DIR not set, no stats socket.");
+        wlmaker_stats_socket_destroy(stats_socket_ptr);
+        return NULL;
+    }
+    struct sockaddr_un *addr_ptr = &stats_socket_ptr->addr;
+    addr_ptr->sun_family = AF_UNIX;
+    int len = snprintf(
+        addr_ptr->sun_path, sizeof(addr_ptr->sun_path), "%s/%s.stats",
+        dir_ptr, server_ptr->wl_socket_name_ptr);
+    if (0 > len || (size_t)len >= sizeof(addr_ptr->sun_path)) {
+        bs_log(BS_ERROR, "Path too long for stats socket: %s/%s.stats",
+               dir_ptr, server_ptr->wl_socket_name_ptr);
+        addr_ptr->sun_path[0] = '\0';
+        wlmaker_stats_socket_destroy(stats_socket_ptr);
+        return NULL;
+    }
+
+    stats_socket_ptr->fd = socket(
+        AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (0 > stats_socket_ptr->fd) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed socket(AF_UNIX, ...)");
+        addr_ptr->sun_path[0] = '\0';
+        wlmaker_stats_socket_destroy(stats_socket_ptr);
+        return NULL;
+    }
+    // The path is ours, through the Wayland socket name. Remove stale ones.
+    unlink(addr_ptr->sun_path);
+    if (0 != bind(stats_socket_ptr->fd, (struct sockaddr*)addr_ptr,
+                  sizeof(struct sockaddr_un))) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed bind(%d, %s)",
+               stats_socket_ptr->fd, addr_ptr->sun_path);
+        addr_ptr->sun_path[0] = '\0';
+        wlmaker_stats_socket_destroy(stats_socket_ptr);
+        return NULL;
+    }
+    if (0 != chmod(addr_ptr->sun_path, S_IRUSR | S_IWUSR) ||
+        0 != listen(stats_socket_ptr->fd, 4)) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed chmod() or listen() on %s",
+               addr_ptr->sun_path);
+        wlmaker_stats_socket_destroy(stats_socket_ptr);
+        return NULL;
+    }
+
+    stats_socket_ptr->event_source_ptr = wl_event_loop_add_fd(
+        wl_display_get_event_loop(server_ptr->wl_display_ptr),
+        stats_socket_ptr->fd,
+        WL_EVENT_READABLE,
+        _wlmaker_stats_socket_handle_accept,
+        stats_socket_ptr);
+    if (NULL == stats_socket_ptr->event_source_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_fd(%p, %d, ...)",
+               wl_display_get_event_loop(server_ptr->wl_display_ptr),
+               stats_socket_ptr->fd);
+        wlmaker_stats_socket_destroy(stats_socket_ptr);
+        return NULL;
+    }
+
+    bs_log(BS_INFO, "Exporting statistics on %s", addr_ptr->sun_path);
+    return stats_socket_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_stats_socket_destroy(wlmaker_stats_socket_t *stats_socket_ptr)
+{
+    if (NULL != stats_socket_ptr->event_source_ptr) {
+        wl_event_source_remove(stats_socket_ptr->event_source_ptr);
+        stats_socket_ptr->event_source_ptr = NULL;
+    }
+    if (0 <= stats_socket_ptr->fd) {
+        close(stats_socket_ptr->fd);
+        stats_socket_ptr->fd = -1;
+    }
+    if ('\0' != stats_socket_ptr->addr.sun_path[0]) {
+        unlink(stats_socket_ptr->addr.sun_path);
+    }
+    if (NULL != stats_socket_ptr->buf_ptr) {
+        free(stats_socket_ptr->buf_ptr);
+        stats_socket_ptr->buf_ptr = NULL;
+    }
+    free(stats_socket_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmaker_stats_socket_serialize(
+    wlmaker_server_t *server_ptr,
+    wlmaker_watchdog_t *watchdog_ptr,
+    char *buf_ptr,
+    size_t size,
+    bool *truncated_ptr)
+{
+    _wlmaker_stats_writer_t w = { .buf_ptr = buf_ptr, .size = size };
+
+    if (NULL != server_ptr->backend_ptr) {
+        wlmbe_backend_for_each_output(
+            server_ptr->backend_ptr, _wlmaker_stats_write_output, &w);
+    }
+    wlmtk_latency_for_each(_wlmaker_stats_write_latency, &w);
+
+    if (NULL != server_ptr->root_ptr) {
+        size_t counts[2] = {};  // Workspaces, windows.
+        wlmtk_root_for_each_workspace(
+            server_ptr->root_ptr, _wlmaker_stats_count_windows, counts);
+        _wlmaker_stats_printf(&w, "wlmaker_workspaces %zu\n", counts[0]);
+        _wlmaker_stats_printf(&w, "wlmaker_windows %zu\n", counts[1]);
+    }
+    if (NULL != server_ptr->wlr_scene_ptr) {
+        size_t nodes = 1;  // The scene's root tree.
+        wlmtk_util_wl_list_for_each(
+            &server_ptr->wlr_scene_ptr->tree.children,
+            _wlmaker_stats_count_scene_nodes,
+            &nodes);
+        _wlmaker_stats_printf(&w, "wlmaker_scene_nodes %zu\n", nodes);
+    }
+
+    wlmtk_gfxbuf_pool_stats_t g;
+    wlmtk_gfxbuf_pool_get_stats(&g);
+    _wlmaker_stats_printf(&w, "wlmaker_gfxbuf_in_use_buffers %zu\n",
+                          g.in_use_buffers);
+    _wlmaker_stats_printf(&w, "wlmaker_gfxbuf_cached_buffers %zu\n",
+                          g.cached_buffers);
+    _wlmaker_stats_printf(&w, "wlmaker_gfxbuf_cached_bytes %zu\n",
+                          g.cached_bytes);
+    _wlmaker_stats_printf(&w, "wlmaker_gfxbuf_hits %zu\n", g.hits);
+    _wlmaker_stats_printf(&w, "wlmaker_gfxbuf_misses %zu\n", g.misses);
+    _wlmaker_stats_printf(&w, "wlmaker_gfxbuf_trimmed %zu\n", g.trimmed);
+
+    wlmtk_text_stats_t t;
+    wlmtk_text_get_stats(&t);
+    _wlmaker_stats_printf(&w, "wlmaker_text_fonts %zu\n", t.fonts);
+    _wlmaker_stats_printf(&w, "wlmaker_text_runs %zu\n", t.runs);
+    _wlmaker_stats_printf(&w, "wlmaker_text_hits %zu\n", t.hits);
+    _wlmaker_stats_printf(&w, "wlmaker_text_misses %zu\n", t.misses);
+    _wlmaker_stats_printf(&w, "wlmaker_text_evictions %zu\n", t.evictions);
+
+    wlmtk_arena_stats_t a;
+    wlmtk_arena_get_stats(&a);
+    _wlmaker_stats_printf(&w, "wlmaker_locked_code_bytes %zu\n",
+                          wlmaker_memlock_code_bytes());
+    _wlmaker_stats_printf(&w, "wlmaker_arena_locked_bytes %zu\n",
+                          a.locked_bytes);
+    _wlmaker_stats_printf(&w, "wlmaker_arena_used_bytes %zu\n", a.used_bytes);
+    _wlmaker_stats_printf(&w, "wlmaker_arena_blocks %zu\n", a.blocks);
+    _wlmaker_stats_printf(&w, "wlmaker_arena_fallbacks %zu\n", a.fallbacks);
+
+    for (int i = 0; i < WLMTK_MEMSTAT_SUBSYSTEMS; ++i) {
+        wlmtk_memstat_stats_t m;
+        wlmtk_memstat_get_stats(i, &m);
+        const char *name_ptr = wlmtk_memstat_subsystem_name(i);
+        _wlmaker_stats_printf(
+            &w, "wlmaker_memory_bytes{subsystem=\"%s\"} %zu\n",
+            name_ptr, m.bytes);
+        _wlmaker_stats_printf(
+            &w, "wlmaker_memory_peak_bytes{subsystem=\"%s\"} %zu\n",
+            name_ptr, m.peak_bytes);
+        _wlmaker_stats_printf(
+            &w, "wlmaker_memory_allocations{subsystem=\"%s\"} %zu\n",
+            name_ptr, m.allocations);
+    }
+    wlmtk_pool_for_each_stats(_wlmaker_stats_write_pool, &w);
+
+#if defined(__GLIBC__) && (2 < __GLIBC__ || 33 <= __GLIBC_MINOR__)
+    // Arena statistics: Free bytes held in many chunks are fragmentation.
+    struct mallinfo2 mi = mallinfo2();
+    _wlmaker_stats_printf(&w, "wlmaker_malloc_arena_bytes %zu\n", mi.arena);
+    _wlmaker_stats_printf(&w, "wlmaker_malloc_mmap_bytes %zu\n", mi.hblkhd);
+    _wlmaker_stats_printf(&w, "wlmaker_malloc_in_use_bytes %zu\n",
+                          mi.uordblks);
+    _wlmaker_stats_printf(&w, "wlmaker_malloc_free_bytes %zu\n",
+                          mi.fordblks);
+    _wlmaker_stats_printf(&w, "wlmaker_malloc_free_chunks %zu\n",
+                          mi.ordblks);
+    _wlmaker_stats_printf(&w, "wlmaker_malloc_releasable_bytes %zu\n",
+                          mi.keepcost);
+#endif  // defined(__GLIBC__) && (2 < __GLIBC__ || 33 <= __GLIBC_MINOR__)
+#if defined(WLMTK_ALLOC_TRACK)
+    size_t allocations, bytes;
+    wlmtk_alloctrack_get_totals(&allocations, &bytes);
+    _wlmaker_stats_printf(&w, "wlmaker_tracked_allocations %zu\n",
+                          allocations);
+    _wlmaker_stats_printf(&w, "wlmaker_tracked_bytes %zu\n", bytes);
+#endif  // defined(WLMTK_ALLOC_TRACK)
+
+    if (NULL != server_ptr->monitor_ptr) {
+        _wlmaker_stats_printf(
+            &w, "wlmaker_subprocesses %zu\n",
+            wlmaker_subprocess_monitor_size(server_ptr->monitor_ptr));
+    }
+
+    if (NULL != watchdog_ptr) {
+        wlmaker_watchdog_stats_t s;
+        wlmaker_watchdog_get_stats(watchdog_ptr, &s);
+        _wlmaker_stats_printf(&w, "wlmaker_loop_pings %"PRIu64"\n",
+                              s.pings);
+        _wlmaker_stats_printf(&w, "wlmaker_loop_stalls %"PRIu64"\n",
+                              s.stalls);
+        _wlmaker_stats_printf(&w, "wlmaker_loop_latency_nsec_sum %"PRIu64"\n",
+                              s.latency_nsec_sum);
+        _wlmaker_stats_printf(&w, "wlmaker_loop_latency_nsec_max %"PRIu64"\n",
+                              s.latency_nsec_max);
+    }
+
+    *truncated_ptr = w.truncated;
+    return w.line_end;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles connections: Sends a snapshot to each, then closes it.
+ *
+ * The snapshot is sent without blocking. A peer that does not read it in
+ * time gets a partial snapshot, and should re-connect.
+ *
+ * @param fd
+ * @param mask
+ * @param data_ptr            Points to the @ref wlmaker_stats_socket_t.
+ *
+ * @return 0.
+ */
+int _wlmaker_stats_socket_handle_accept(
+    int fd,
+    __UNUSED__ uint32_t mask,
+    void *data_ptr)
+{
+    wlmaker_stats_socket_t *stats_socket_ptr = data_ptr;
+
+    for (;;) {
+        int conn_fd = accept4(fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (0 > conn_fd) {
+            if (EAGAIN != errno && EWOULDBLOCK != errno && EINTR != errno) {
+                bs_log(BS_WARNING | BS_ERRNO, "Failed accept4(%d, ...)",
+                       fd);
+            }
+            return 0;
+        }
+
+        bool truncated;
+        size_t len = wlmaker_stats_socket_serialize(
+            stats_socket_ptr->server_ptr,
+            stats_socket_ptr->watchdog_ptr,
+            stats_socket_ptr->buf_ptr,
+            WLMAKER_STATS_SOCKET_BUFFER_SIZE,
+            &truncated);
+        if (truncated) {
+            bs_log(BS_WARNING, "Stats truncated at %zu bytes.", len);
+        }
+        ssize_t sent = send(conn_fd, stats_socket_ptr->buf_ptr, len,
+                            MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (0 > sent) {
+            bs_log(BS_DEBUG | BS_ERRNO, "Failed send(%d, %p, %zu, ...)",
+                   conn_fd, stats_socket_ptr->buf_ptr, len);
+        }
+        close(conn_fd);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Appends to the writer's buffer. If the text does not fit, the writer is
+ * marked as truncated, and nothing further is appended.
+ *
+ * @param writer_ptr
+ * @param fmt_ptr
+ */
+void _wlmaker_stats_printf(
+    _wlmaker_stats_writer_t *writer_ptr,
+    const char *fmt_ptr, ...)
+{
+    if (writer_ptr->truncated) return;
+
+    va_list ap;
+    va_start(ap, fmt_ptr);
+    size_t avail = writer_ptr->size - writer_ptr->len;
+    int rv = vsnprintf(writer_ptr->buf_ptr + writer_ptr->len, avail,
+                       fmt_ptr, ap);
+    va_end(ap);
+    // Keeps space for vsnprintf's terminating NUL.
+    if (0 > rv || (size_t)rv >= avail) {
+        writer_ptr->truncated = true;
+        return;
+    }
+    writer_ptr->len += rv;
+    if (0 < rv && '\n' == writer_ptr->buf_ptr[writer_ptr->len - 1]) {
+        writer_ptr->line_end = writer_ptr->len;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Writes the frame timing statistics of the output. */
+void _wlmaker_stats_write_output(wlmbe_output_t *output_ptr, void *ud_ptr)
+{
+    _wlmaker_stats_writer_t *writer_ptr = ud_ptr;
+    const char *name_ptr = wlmbe_wlr_output_from_output(output_ptr)->name;
+    const wlmbe_output_stats_t *stats_ptr = wlmbe_output_get_stats(
+        output_ptr);
+
+    for (size_t i = 0;
+         i < sizeof(_wlmaker_stats_output_counters) /
+             sizeof(_wlmaker_stats_output_counters[0]);
+         ++i) {
+        const _wlmaker_stats_output_counter_t *c_ptr =
+            &_wlmaker_stats_output_counters[i];
+        uint64_t value = *(const uint64_t*)(
+            (const uint8_t*)stats_ptr + c_ptr->offset);
+        _wlmaker_stats_printf(
+            writer_ptr, "wlmaker_output_%s{output=\"%s\"} %"PRIu64"\n",
+            c_ptr->name_ptr, name_ptr, value);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Writes percentiles and histograms of the latency tracker. */
+void _wlmaker_stats_write_latency(wlmtk_latency_t *latency_ptr, void *ud_ptr)
+{
+    _wlmaker_stats_writer_t *writer_ptr = ud_ptr;
+    wlmtk_latency_stats_t s;
+    wlmtk_latency_get_stats(latency_ptr, &s);
+
+    _wlmaker_stats_printf(
+        writer_ptr, "wlmaker_latency_commit_samples{tracker=\"%s\"} "
+        "%"PRIu64"\n", s.name_ptr, s.commit_samples);
+    _wlmaker_stats_printf(
+        writer_ptr, "wlmaker_latency_commit_p50_msec{tracker=\"%s\"} %u\n",
+        s.name_ptr, s.commit_p50_msec);
+    _wlmaker_stats_printf(
+        writer_ptr, "wlmaker_latency_commit_p99_msec{tracker=\"%s\"} %u\n",
+        s.name_ptr, s.commit_p99_msec);
+    _wlmaker_stats_printf(
+        writer_ptr, "wlmaker_latency_present_samples{tracker=\"%s\"} "
+        "%"PRIu64"\n", s.name_ptr, s.present_samples);
+    _wlmaker_stats_printf(
+        writer_ptr, "wlmaker_latency_present_p50_msec{tracker=\"%s\"} %u\n",
+        s.name_ptr, s.present_p50_msec);
+    _wlmaker_stats_printf(
+        writer_ptr, "wlmaker_latency_present_p99_msec{tracker=\"%s\"} %u\n",
+        s.name_ptr, s.present_p99_msec);
+
+    _wlmaker_stats_write_histogram(
+        writer_ptr, "commit", s.name_ptr, latency_ptr->commit_histogram);
+    _wlmaker_stats_write_histogram(
+        writer_ptr, "present", s.name_ptr, latency_ptr->present_histogram);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Writes the non-empty buckets of the histogram. */
+void _wlmaker_stats_write_histogram(
+    _wlmaker_stats_writer_t *writer_ptr,
+    const char *name_ptr,
+    const char *tracker_ptr,
+    const uint64_t *histogram_ptr)
+{
+    for (unsigned i = 0; i < WLMTK_LATENCY_BUCKETS; ++i) {
+        if (0 == histogram_ptr[i]) continue;
+        _wlmaker_stats_printf(
+            writer_ptr, "wlmaker_latency_%s_bucket{tracker=\"%s\",msec=\"%u\"}"
+            " %"PRIu64"\n", name_ptr, tracker_ptr, i, histogram_ptr[i]);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Writes the occupancy of the pool. */
+void _wlmaker_stats_write_pool(
+    const wlmtk_pool_stats_t *stats_ptr,
+    void *ud_ptr)
+{
+    _wlmaker_stats_writer_t *writer_ptr = ud_ptr;
+    _wlmaker_stats_printf(
+        writer_ptr, "wlmaker_pool_in_use{pool=\"%s\"} %zu\n",
+        stats_ptr->name_ptr, stats_ptr->in_use);
+    _wlmaker_stats_printf(
+        writer_ptr, "wlmaker_pool_peak_in_use{pool=\"%s\"} %zu\n",
+        stats_ptr->name_ptr, stats_ptr->peak_in_use);
+    _wlmaker_stats_printf(
+        writer_ptr, "wlmaker_pool_capacity{pool=\"%s\"} %zu\n",
+        stats_ptr->name_ptr, stats_ptr->capacity);
+    _wlmaker_stats_printf(
+        writer_ptr, "wlmaker_pool_allocations{pool=\"%s\"} %zu\n",
+        stats_ptr->name_ptr, stats_ptr->allocations);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Counts the workspace, and its windows, into `ud_ptr` (size_t[2]). */
+void _wlmaker_stats_count_windows(bs_dllist_node_t *dlnode_ptr, void *ud_ptr)
+{
+    size_t *counts_ptr = ud_ptr;
+    counts_ptr[0]++;
+    counts_ptr[1] += bs_dllist_size(wlmtk_workspace_get_windows_dllist(
+                                        wlmtk_workspace_from_dlnode(
+                                            dlnode_ptr)));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Counts the scene node and its descendants into `ud_ptr` (size_t). */
+bool _wlmaker_stats_count_scene_nodes(struct wl_list *link_ptr, void *ud_ptr)
+{
+    size_t *nodes_ptr = ud_ptr;
+    struct wlr_scene_node *wlr_scene_node_ptr = BS_CONTAINER_OF(
+        link_ptr, struct wlr_scene_node, link);
+    (*nodes_ptr)++;
+    if (WLR_SCENE_NODE_TREE == wlr_scene_node_ptr->type) {
+        wlmtk_util_wl_list_for_each(
+            &wlr_scene_tree_from_node(wlr_scene_node_ptr)->children,
+            _wlmaker_stats_count_scene_nodes,
+            ud_ptr);
+    }
+    return true;
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlmaker_stats_socket_test_serialize(bs_test_t *test_ptr);
+static void _wlmaker_stats_socket_test_truncate(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_stats_socket_test_cases[] = {
+    { 1, "serialize", _wlmaker_stats_socket_test_serialize },
+    { 1, "truncate", _wlmaker_stats_socket_test_truncate },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Serializes the toolkit counters, skipping what the server doesn't have. */
+void _wlmaker_stats_socket_test_serialize(bs_test_t *test_ptr)
+{
+    wlmaker_server_t server = {};
+    char buf[WLMAKER_STATS_SOCKET_BUFFER_SIZE];
+    bool truncated = true;
+
+    size_t len = wlmaker_stats_socket_serialize(
+        &server, NULL, buf, sizeof(buf), &truncated);
+    BS_TEST_VERIFY_FALSE(test_ptr, truncated);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, 0 < len && len < sizeof(buf));
+    BS_TEST_VERIFY_EQ(test_ptr, '\n', buf[len - 1]);
+    buf[len] = '\0';
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL, strstr(buf, "\nwlmaker_gfxbuf_hits "));
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, strstr(buf, "\nwlmaker_text_runs "));
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL,
+        strstr(buf, "wlmaker_memory_bytes{subsystem=\"decorations\"} "));
+#if defined(__GLIBC__) && (2 < __GLIBC__ || 33 <= __GLIBC_MINOR__)
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL, strstr(buf, "\nwlmaker_malloc_free_chunks "));
+#endif  // defined(__GLIBC__) && (2 < __GLIBC__ || 33 <= __GLIBC_MINOR__)
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, strstr(buf, "wlmaker_windows"));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, strstr(buf, "wlmaker_loop_pings"));
+}
+
+/* ------------------------------------------------------------------------- */
+/** A snapshot that does not fit is truncated at the last complete line. */
+void _wlmaker_stats_socket_test_truncate(bs_test_t *test_ptr)
+{
+    wlmaker_server_t server = {};
+    char buf[100];
+    bool truncated = false;
+
+    size_t len = wlmaker_stats_socket_serialize(
+        &server, NULL, buf, sizeof(buf), &truncated);
+    BS_TEST_VERIFY_TRUE(test_ptr, truncated);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, 0 < len && len < sizeof(buf));
+    BS_TEST_VERIFY_EQ(test_ptr, '\n', buf[len - 1]);
+}
+
+/* == End of stats_socket.c ================================================ */
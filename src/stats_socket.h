@@ -0,0 +1,97 @@
+/* ========================================================================= */
+/**
+ * @file stats_socket.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __STATS_SOCKET_H__
+#define __STATS_SOCKET_H__
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "server.h"
+#include "watchdog.h"
+
+/** Forward declaration: Socket exporting runtime statistics. */
+typedef struct _wlmaker_stats_socket_t wlmaker_stats_socket_t;
+
+/** Size of the buffer that a snapshot is serialized into. */
+#define WLMAKER_STATS_SOCKET_BUFFER_SIZE (128 * 1024)
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Creates a read-only Unix socket that exports runtime statistics.
+ *
+ * The socket is created at `$XDG_RUNTIME_DIR/<wayland socket>.stats`, and is
+ * accessible to the user only. Each connection receives one snapshot of
+ * the counters as text, one `name{labels} value` line per counter, and is
+ * then closed. Anything sent by the peer is ignored.
+ *
+ * The snapshot is serialized into a buffer that is allocated on creation,
+ * so serving a connection does not allocate.
+ *
+ * @param server_ptr
+ * @param watchdog_ptr        The watchdog to report, or NULL.
+ *
+ * @return Pointer to the stats socket, or NULL on error. Must be destroyed
+ *     by @ref wlmaker_stats_socket_destroy.
+ */
+wlmaker_stats_socket_t *wlmaker_stats_socket_create(
+    wlmaker_server_t *server_ptr,
+    wlmaker_watchdog_t *watchdog_ptr);
+
+/**
+ * Destroys the stats socket, and removes its path.
+ *
+ * @param stats_socket_ptr
+ */
+void wlmaker_stats_socket_destroy(wlmaker_stats_socket_t *stats_socket_ptr);
+
+/**
+ * Serializes a snapshot of the statistics into `buf_ptr`.
+ *
+ * Members of `server_ptr` that are NULL are skipped. Does not allocate.
+ *
+ * @param server_ptr
+ * @param watchdog_ptr        May be NULL.
+ * @param buf_ptr
+ * @param size                Size of `buf_ptr`, in bytes.
+ * @param truncated_ptr       Set to whether the snapshot did not fit, and
+ *                            was truncated at the end of a line.
+ *
+ * @return Number of bytes written to `buf_ptr`, without a terminating NUL.
+ */
+size_t wlmaker_stats_socket_serialize(
+    wlmaker_server_t *server_ptr,
+    wlmaker_watchdog_t *watchdog_ptr,
+    char *buf_ptr,
+    size_t size,
+    bool *truncated_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_stats_socket_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __STATS_SOCKET_H__ */
+/* == End of stats_socket.h ================================================ */
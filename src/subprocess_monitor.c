@@ -20,11 +20,19 @@
 
 #include "subprocess_monitor.h"
 
+#include <errno.h>
+#include <fcntl.h>
 #include <inttypes.h>
 #include <libbase/libbase.h>
+#include <limits.h>
 #include <signal.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <time.h>
 #include <unistd.h>
 #include <wayland-server-core.h>
 #include <wayland-util.h>
@@ -36,8 +44,15 @@ struct wl_event_source;
 
 /* == Declarations ========================================================= */
 
+/** Size of the line buffer of a subprocess' output stream. */
+#define WLMAKER_SUBPROCESS_LINE_SIZE 1024
+/** Size of the buffer for batching writes to the subprocess' log file. */
+#define WLMAKER_SUBPROCESS_LOG_BUFFER_SIZE 8192
+
 /** State of the subprocess monitor. */
 struct _wlmaker_subprocess_monitor_t {
+    /** Back-link to the server. */
+    wlmaker_server_t          *server_ptr;
     /** Reference to the event loop. */
     struct wl_event_loop      *wl_event_loop_ptr;
     /** Event source used for monitoring SIGCHLD. */
@@ -52,27 +67,89 @@ struct _wlmaker_subprocess_monitor_t {
     /** Listener: Receives a signal whenever a window is destroyed. */
     struct wl_listener        window_destroyed_listener;
 
-    /** Monitored subprocesses. */
+    /** Monitored subprocesses, by PID. */
+    bs_avltree_t              *subprocess_tree_ptr;
+    /**
+     * Monitored subprocesses without a pidfd. These are polled on each
+     * SIGCHLD.
+     */
     bs_dllist_t               subprocesses;
     /** Windows for monitored subprocesses. */
     bs_avltree_t              *window_tree_ptr;
+
+    /** Lines per second, per subprocess, to log at most. 0 for no limit. */
+    uint64_t                  log_rate_limit;
+    /** Directory for the subprocess' log files. Empty if not logging. */
+    char                      log_directory[PATH_MAX];
+
+    /** Whether to place each subprocess in a cgroup of its own. */
+    bool                      isolate;
+    /** Default resource limits of the subprocess' cgroups. */
+    wlmaker_cgroup_limits_t   limits;
+    /** The cgroups, if `isolate` is set and they are available. */
+    wlmaker_cgroup_t          *cgroup_ptr;
 };
 
+/** An output stream of a subprocess: Its stdout or stderr. */
+typedef struct {
+    /** Back-link to the subprocess handle. */
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr;
+    /** Name of the stream, for logging. */
+    const char                *name_ptr;
+    /** Severity to log the stream's lines with. */
+    bs_log_severity_t         severity;
+    /** File descriptor to read the stream from. */
+    int                       fd;
+    /** Event source for reading from `fd`. */
+    struct wl_event_source    *wl_event_source_ptr;
+    /** Output that is not yet terminated by a newline. */
+    char                      line[WLMAKER_SUBPROCESS_LINE_SIZE];
+    /** Number of bytes in `line`. */
+    size_t                    line_length;
+} wlmaker_subprocess_stream_t;
+
 /** A subprocess. */
 struct _wlmaker_subprocess_handle_t {
+    /** Node of @ref wlmaker_subprocess_monitor_t::subprocess_tree_ptr. */
+    bs_avltree_node_t         avlnode;
     /** Element of @ref wlmaker_subprocess_monitor_t `subprocesses`. */
     bs_dllist_node_t          dlnode;
+    /** Back-link to the monitor. */
+    wlmaker_subprocess_monitor_t *monitor_ptr;
     /** Points to the subprocess. */
     bs_subprocess_t           *subprocess_ptr;
-
-    /** File descriptor of the subprocess' stdout. */
-    int                       stdout_read_fd;
-    /** Event source corresponding to events related to reading stdout. */
-    struct wl_event_source    *stdout_wl_event_source_ptr;
-    /** File descriptor of the subprocess' strderr. */
-    int                       stderr_read_fd;
-    /** Event source corresponding to events related to reading stderr. */
-    struct wl_event_source    *stderr_wl_event_source_ptr;
+    /** PID of the subprocess. Also the tree lookup key. */
+    pid_t                     pid;
+    /** Whether the handle is in the monitor's `subprocess_tree_ptr`. */
+    bool                      indexed;
+    /** Whether the subprocess was placed in a cgroup of its own. */
+    bool                      isolated;
+
+    /** Process file descriptor of the subprocess, or -1. */
+    int                       pidfd;
+    /** Event source for the pidfd. Triggers once the subprocess exited. */
+    struct wl_event_source    *pidfd_wl_event_source_ptr;
+
+    /** The subprocess' stdout. Lines are logged as information. */
+    wlmaker_subprocess_stream_t stdout_stream;
+    /** The subprocess' stderr. Lines are logged as warnings. */
+    wlmaker_subprocess_stream_t stderr_stream;
+
+    /** Start of the current second for rate-limiting, in milliseconds. */
+    uint64_t                  rate_period_msec;
+    /** Number of lines logged within the current second. */
+    uint64_t                  rate_period_lines;
+    /** Number of lines not logged due to the rate limit, not yet reported. */
+    uint64_t                  dropped_lines;
+
+    /** File descriptor of the log file, or -1. */
+    int                       log_fd;
+    /** Output not yet written to the log file. */
+    char                      *log_buffer_ptr;
+    /** Number of bytes in `log_buffer_ptr`. */
+    size_t                    log_buffer_length;
+    /** Idle event source to write `log_buffer_ptr`, when pending. */
+    struct wl_event_source    *log_idle_event_source_ptr;
 
     /** Callback:  The subprocess was terminated. */
     wlmaker_subprocess_terminated_callback_t terminated_callback;
@@ -80,6 +157,8 @@ struct _wlmaker_subprocess_handle_t {
     void                      *userdata_ptr;
     /** Subprocess's windows. @ref wlmaker_subprocess_window_t::dlnode. */
     bs_dllist_t               windows;
+    /** Whether to hold back windows when they are ready to be mapped. */
+    bool                      hold_windows;
 
     /** Callback: A window was created from this subprocess. */
     wlmaker_subprocess_window_callback_t window_created_callback;
@@ -105,25 +184,53 @@ typedef struct {
 
     /** Whether the window was reported as mapped. */
     bool                      mapped;
+    /** Whether the window is ready to be mapped, but held back. */
+    bool                      held;
 } wlmaker_subprocess_window_t;
 
 static wlmaker_subprocess_handle_t *wlmaker_subprocess_handle_create(
     bs_subprocess_t *subprocess_ptr,
-    struct wl_event_loop *wl_event_loop_ptr);
+    wlmaker_subprocess_monitor_t *monitor_ptr);
 static void wlmaker_subprocess_handle_destroy(
     wlmaker_subprocess_handle_t *sp_handle_ptr);
-static int _wlmaker_subprocess_monitor_handle_read_stdout(
-    int fd, uint32_t mask, void *data_ptr);
-static int _wlmaker_subprocess_monitor_handle_read_stderr(
-    int fd, uint32_t mask, void *data_ptr);
-
-static int _wlmaker_subprocess_monitor_process_fd(
+static void _wlmaker_subprocess_handle_open_log(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr);
+static void _wlmaker_subprocess_handle_write_log(
     wlmaker_subprocess_handle_t *subprocess_handle_ptr,
-    struct wl_event_source **wl_event_source_ptr_ptr,
-    int fd,
-    uint32_t mask,
-    const char *fd_name_ptr);
+    const char *data_ptr,
+    size_t length);
+static void _wlmaker_subprocess_handle_flush_log(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr);
+static void _wlmaker_subprocess_handle_idle_flush_log(void *data_ptr);
+static void _wlmaker_subprocess_handle_report_dropped(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr);
 
+static void _wlmaker_subprocess_stream_init(
+    wlmaker_subprocess_stream_t *stream_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    const char *name_ptr,
+    bs_log_severity_t severity,
+    int fd);
+static void _wlmaker_subprocess_stream_fini(
+    wlmaker_subprocess_stream_t *stream_ptr);
+static int _wlmaker_subprocess_stream_handle_read(
+    int fd, uint32_t mask, void *data_ptr);
+static void _wlmaker_subprocess_stream_emit_lines(
+    wlmaker_subprocess_stream_t *stream_ptr,
+    bool flush);
+static void _wlmaker_subprocess_stream_emit_line(
+    wlmaker_subprocess_stream_t *stream_ptr,
+    const char *line_ptr,
+    size_t length);
+
+static void _wlmaker_subprocess_monitor_watch(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr);
+static void _wlmaker_subprocess_monitor_reap(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr);
+static int _wlmaker_subprocess_monitor_handle_pidfd(
+    int fd, uint32_t mask, void *data_ptr);
 static int _wlmaker_subprocess_monitor_handle_sigchld(int signum, void *data_ptr);
 
 static void _wlmaker_subprocess_monitor_handle_window_created(
@@ -139,6 +246,9 @@ static void _wlmaker_subprocess_monitor_handle_window_destroyed(
     struct wl_listener *listener_ptr,
     void *data_ptr);
 
+static wlmaker_subprocess_window_t *_wlmaker_subprocess_window_lookup(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmtk_window_t *window_ptr);
 static wlmaker_subprocess_handle_t *subprocess_handle_from_window(
     wlmaker_subprocess_monitor_t *monitor_ptr,
     wlmtk_window_t *window_ptr);
@@ -149,12 +259,40 @@ static wlmaker_subprocess_window_t *wlmaker_subprocess_window_create(
 static void wlmaker_subprocess_window_destroy(
     wlmaker_subprocess_window_t *ws_window_ptr);
 
+static int _wlmaker_subprocess_handle_node_cmp(
+    const bs_avltree_node_t *node_ptr,
+    const void *key_ptr);
 static int wlmaker_subprocess_window_node_cmp(
     const bs_avltree_node_t *node_ptr,
     const void *key_ptr);
 static void wlmaker_subprocess_window_node_destroy(
     bs_avltree_node_t *node_ptr);
 
+/* == Data ================================================================= */
+
+/** Descriptor for the optional "Subprocesses" dict of the config file. */
+static const bspl_desc_t _wlmaker_subprocess_monitor_config_desc[] = {
+    BSPL_DESC_UINT64(
+        "LogRateLimit", false, wlmaker_subprocess_monitor_t,
+        log_rate_limit, log_rate_limit, 20),
+    BSPL_DESC_CHARBUF(
+        "LogDirectory", false, wlmaker_subprocess_monitor_t,
+        log_directory, log_directory, PATH_MAX, ""),
+    BSPL_DESC_BOOL(
+        "Isolate", false, wlmaker_subprocess_monitor_t,
+        isolate, isolate, false),
+    BSPL_DESC_UINT64(
+        "CpuWeight", false, wlmaker_subprocess_monitor_t,
+        limits.cpu_weight, limits.cpu_weight, 0),
+    BSPL_DESC_UINT64(
+        "MemoryHighMiB", false, wlmaker_subprocess_monitor_t,
+        limits.memory_high_mib, limits.memory_high_mib, 0),
+    BSPL_DESC_UINT64(
+        "MemoryMaxMiB", false, wlmaker_subprocess_monitor_t,
+        limits.memory_max_mib, limits.memory_max_mib, 0),
+    BSPL_DESC_SENTINEL()
+};
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -164,6 +302,49 @@ wlmaker_subprocess_monitor_t* wlmaker_subprocess_monitor_create(
     wlmaker_subprocess_monitor_t *monitor_ptr = logged_calloc(
         1, sizeof(wlmaker_subprocess_monitor_t));
     if (NULL == monitor_ptr) return NULL;
+    monitor_ptr->server_ptr = server_ptr;
+
+    monitor_ptr->log_rate_limit = 20;
+    bspl_dict_t *config_dict_ptr = bspl_dict_get_dict(
+        server_ptr->config_dict_ptr, "Subprocesses");
+    if (NULL != config_dict_ptr &&
+        !bspl_decode_dict(config_dict_ptr,
+                          _wlmaker_subprocess_monitor_config_desc,
+                          monitor_ptr)) {
+        bs_log(BS_ERROR, "Failed to decode \"Subprocesses\" dict");
+        wlmaker_subprocess_monitor_destroy(monitor_ptr);
+        return NULL;
+    }
+    if (0 < strlen(monitor_ptr->log_directory)) {
+        char full_path[PATH_MAX];
+        const char *path_ptr = bs_file_resolve_path(
+            monitor_ptr->log_directory, full_path);
+        if (NULL == path_ptr) {
+            bs_log(BS_WARNING | BS_ERRNO,
+                   "Failed bs_file_resolve_path(%s, %p), not writing "
+                   "subprocess logs.", monitor_ptr->log_directory, full_path);
+            monitor_ptr->log_directory[0] = '\0';
+        } else {
+            snprintf(monitor_ptr->log_directory,
+                     sizeof(monitor_ptr->log_directory), "%s", path_ptr);
+        }
+    }
+
+    if (monitor_ptr->isolate) {
+        // Optional: Applications are just not isolated, without.
+        monitor_ptr->cgroup_ptr = wlmaker_cgroup_create(NULL);
+        if (NULL == monitor_ptr->cgroup_ptr) {
+            bs_log(BS_WARNING, "Failed wlmaker_cgroup_create(NULL), not "
+                   "isolating subprocesses.");
+        }
+    }
+
+    monitor_ptr->subprocess_tree_ptr = bs_avltree_create(
+        _wlmaker_subprocess_handle_node_cmp, NULL);
+    if (NULL == monitor_ptr->subprocess_tree_ptr) {
+        wlmaker_subprocess_monitor_destroy(monitor_ptr);
+        return NULL;
+    }
 
     monitor_ptr->window_tree_ptr = bs_avltree_create(
         wlmaker_subprocess_window_node_cmp,
@@ -228,11 +409,26 @@ void wlmaker_subprocess_monitor_destroy(
         bs_avltree_destroy(monitor_ptr->window_tree_ptr);
         monitor_ptr->window_tree_ptr = NULL;
     }
+    if (NULL != monitor_ptr->subprocess_tree_ptr) {
+        bs_avltree_destroy(monitor_ptr->subprocess_tree_ptr);
+        monitor_ptr->subprocess_tree_ptr = NULL;
+    }
+    if (NULL != monitor_ptr->cgroup_ptr) {
+        wlmaker_cgroup_destroy(monitor_ptr->cgroup_ptr);
+        monitor_ptr->cgroup_ptr = NULL;
+    }
 
     monitor_ptr->wl_event_loop_ptr = NULL;
     free(monitor_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+size_t wlmaker_subprocess_monitor_size(
+    wlmaker_subprocess_monitor_t *monitor_ptr)
+{
+    return bs_avltree_size(monitor_ptr->subprocess_tree_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 wlmaker_subprocess_handle_t *wlmaker_subprocess_monitor_entrust(
     wlmaker_subprocess_monitor_t *monitor_ptr,
@@ -245,11 +441,22 @@ wlmaker_subprocess_handle_t *wlmaker_subprocess_monitor_entrust(
     wlmaker_subprocess_window_callback_t window_destroyed_callback)
 {
     wlmaker_subprocess_handle_t *subprocess_handle_ptr =
-        wlmaker_subprocess_handle_create(
-            subprocess_ptr, monitor_ptr->wl_event_loop_ptr);
+        wlmaker_subprocess_handle_create(subprocess_ptr, monitor_ptr);
     if (NULL == subprocess_handle_ptr) return NULL;
-    bs_dllist_push_back(&monitor_ptr->subprocesses,
-                        &subprocess_handle_ptr->dlnode);
+    // PIDs of children are unique until they are reaped.
+    BS_ASSERT(bs_avltree_insert(
+                  monitor_ptr->subprocess_tree_ptr,
+                  &subprocess_handle_ptr->pid,
+                  &subprocess_handle_ptr->avlnode,
+                  false));
+    subprocess_handle_ptr->indexed = true;
+    _wlmaker_subprocess_monitor_watch(monitor_ptr, subprocess_handle_ptr);
+    if (NULL != monitor_ptr->cgroup_ptr) {
+        subprocess_handle_ptr->isolated = wlmaker_cgroup_place(
+            monitor_ptr->cgroup_ptr,
+            subprocess_handle_ptr->pid,
+            &monitor_ptr->limits);
+    }
 
     subprocess_handle_ptr->terminated_callback = terminated_callback;
     subprocess_handle_ptr->userdata_ptr = userdata_ptr;
@@ -264,9 +471,16 @@ wlmaker_subprocess_handle_t *wlmaker_subprocess_monitor_entrust(
 
 /* ------------------------------------------------------------------------- */
 void wlmaker_subprocess_monitor_cede(
-    __UNUSED__ wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmaker_subprocess_monitor_t *monitor_ptr,
     wlmaker_subprocess_handle_t *subprocess_handle_ptr)
 {
+    // Windows created from now on do not belong to the handle's owner.
+    if (subprocess_handle_ptr->indexed) {
+        bs_avltree_delete(monitor_ptr->subprocess_tree_ptr,
+                          &subprocess_handle_ptr->pid);
+        subprocess_handle_ptr->indexed = false;
+    }
+
     bs_dllist_node_t *dlnode_ptr;
     while (NULL != (dlnode_ptr = bs_dllist_pop_front(
                         &subprocess_handle_ptr->windows))) {
@@ -293,6 +507,111 @@ void wlmaker_subprocess_monitor_cede(
     }
 
     subprocess_handle_ptr->terminated_callback = NULL;
+    subprocess_handle_ptr->window_created_callback = NULL;
+    subprocess_handle_ptr->window_mapped_callback = NULL;
+    subprocess_handle_ptr->window_unmapped_callback = NULL;
+    subprocess_handle_ptr->window_destroyed_callback = NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmaker_subprocess_monitor_set_limits(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    const wlmaker_cgroup_limits_t *limits_ptr)
+{
+    if (!subprocess_handle_ptr->isolated) return false;
+    return wlmaker_cgroup_set_limits(
+        monitor_ptr->cgroup_ptr, subprocess_handle_ptr->pid, limits_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_subprocess_monitor_hold_windows(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    bool hold)
+{
+    subprocess_handle_ptr->hold_windows = hold;
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmaker_subprocess_monitor_map_held_windows(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr)
+{
+    subprocess_handle_ptr->hold_windows = false;
+
+    wlmtk_workspace_t *workspace_ptr = wlmtk_root_get_current_workspace(
+        monitor_ptr->server_ptr->root_ptr);
+    size_t mapped = 0;
+    for (bs_dllist_node_t *dlnode_ptr =
+             subprocess_handle_ptr->windows.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_subprocess_window_t *ws_window_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_subprocess_window_t, dlnode);
+        if (!ws_window_ptr->held) continue;
+        ws_window_ptr->held = false;
+        wlmtk_workspace_map_window(workspace_ptr, ws_window_ptr->window_ptr);
+        ++mapped;
+    }
+    return mapped;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmaker_subprocess_monitor_hold_window(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmtk_window_t *window_ptr)
+{
+    wlmaker_subprocess_window_t *ws_window_ptr =
+        _wlmaker_subprocess_window_lookup(monitor_ptr, window_ptr);
+    if (NULL == ws_window_ptr ||
+        NULL == ws_window_ptr->subprocess_handle_ptr ||
+        !ws_window_ptr->subprocess_handle_ptr->hold_windows) return false;
+    ws_window_ptr->held = true;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmaker_subprocess_monitor_unhold_window(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmtk_window_t *window_ptr)
+{
+    wlmaker_subprocess_window_t *ws_window_ptr =
+        _wlmaker_subprocess_window_lookup(monitor_ptr, window_ptr);
+    if (NULL == ws_window_ptr || !ws_window_ptr->held) return false;
+    ws_window_ptr->held = false;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmaker_subprocess_monitor_hide_window(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmtk_window_t *window_ptr)
+{
+    wlmaker_subprocess_window_t *ws_window_ptr =
+        _wlmaker_subprocess_window_lookup(monitor_ptr, window_ptr);
+    if (NULL == ws_window_ptr || ws_window_ptr->held) return false;
+    wlmtk_workspace_t *workspace_ptr = wlmtk_window_get_workspace(window_ptr);
+    if (NULL == workspace_ptr) return false;
+
+    wlmtk_workspace_unmap_window(workspace_ptr, window_ptr);
+    ws_window_ptr->held = true;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmaker_subprocess_monitor_show_window(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmtk_window_t *window_ptr)
+{
+    wlmaker_subprocess_window_t *ws_window_ptr =
+        _wlmaker_subprocess_window_lookup(monitor_ptr, window_ptr);
+    if (NULL == ws_window_ptr || !ws_window_ptr->held) return false;
+
+    ws_window_ptr->held = false;
+    wlmtk_workspace_map_window(
+        wlmtk_root_get_current_workspace(monitor_ptr->server_ptr->root_ptr),
+        window_ptr);
+    return true;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -309,39 +628,40 @@ bs_subprocess_t *wlmaker_subprocess_from_subprocess_handle(
  * Creates a @ref wlmaker_subprocess_handle_t and connects to subprocess_ptr.
  *
  * @param subprocess_ptr
- * @param wl_event_loop_ptr
+ * @param monitor_ptr
  *
  * @return The subprocess handle or NULL on error.
  */
 wlmaker_subprocess_handle_t *wlmaker_subprocess_handle_create(
     bs_subprocess_t *subprocess_ptr,
-    struct wl_event_loop *wl_event_loop_ptr)
+    wlmaker_subprocess_monitor_t *monitor_ptr)
 {
     wlmaker_subprocess_handle_t *subprocess_handle_ptr = logged_calloc(
         1, sizeof(wlmaker_subprocess_handle_t));
     if (NULL == subprocess_handle_ptr) return NULL;
 
+    subprocess_handle_ptr->monitor_ptr = monitor_ptr;
     subprocess_handle_ptr->subprocess_ptr = subprocess_ptr;
+    subprocess_handle_ptr->pid = bs_subprocess_pid(subprocess_ptr);
+    subprocess_handle_ptr->pidfd = -1;
+    subprocess_handle_ptr->log_fd = -1;
 
+    int stdout_read_fd, stderr_read_fd;
     bs_subprocess_get_fds(
         subprocess_ptr,
         NULL,  // no interest in stdin.
-        &subprocess_handle_ptr->stdout_read_fd,
-        &subprocess_handle_ptr->stderr_read_fd);
-
-    subprocess_handle_ptr->stdout_wl_event_source_ptr = wl_event_loop_add_fd(
-        wl_event_loop_ptr,
-        subprocess_handle_ptr->stdout_read_fd,
-        WL_EVENT_READABLE,
-        _wlmaker_subprocess_monitor_handle_read_stdout,
-        subprocess_handle_ptr);
-    subprocess_handle_ptr->stderr_wl_event_source_ptr = wl_event_loop_add_fd(
-        wl_event_loop_ptr,
-        subprocess_handle_ptr->stderr_read_fd,
-        WL_EVENT_READABLE,
-        _wlmaker_subprocess_monitor_handle_read_stderr,
-        subprocess_handle_ptr);
-
+        &stdout_read_fd,
+        &stderr_read_fd);
+    _wlmaker_subprocess_stream_init(
+        &subprocess_handle_ptr->stdout_stream, subprocess_handle_ptr,
+        "stdout", BS_INFO, stdout_read_fd);
+    _wlmaker_subprocess_stream_init(
+        &subprocess_handle_ptr->stderr_stream, subprocess_handle_ptr,
+        "stderr", BS_WARNING, stderr_read_fd);
+
+    if (0 < strlen(monitor_ptr->log_directory)) {
+        _wlmaker_subprocess_handle_open_log(subprocess_handle_ptr);
+    }
     return subprocess_handle_ptr;
 }
 
@@ -366,6 +686,11 @@ void wlmaker_subprocess_handle_destroy(
     bs_log(BS_DEBUG, "Terminated subprocess %p. Status %d, signal %d.",
            sp_handle_ptr->subprocess_ptr, exit_status, signal_number);
 
+    // Output still being assembled into lines is complete now.
+    _wlmaker_subprocess_stream_emit_lines(&sp_handle_ptr->stdout_stream, true);
+    _wlmaker_subprocess_stream_emit_lines(&sp_handle_ptr->stderr_stream, true);
+    _wlmaker_subprocess_handle_report_dropped(sp_handle_ptr);
+
     if (NULL != sp_handle_ptr->terminated_callback) {
         sp_handle_ptr->terminated_callback(
             sp_handle_ptr->userdata_ptr,
@@ -379,119 +704,436 @@ void wlmaker_subprocess_handle_destroy(
         bs_subprocess_destroy(sp_handle_ptr->subprocess_ptr);
         sp_handle_ptr->subprocess_ptr = NULL;
     }
+    if (sp_handle_ptr->isolated) {
+        wlmaker_cgroup_release(sp_handle_ptr->monitor_ptr->cgroup_ptr,
+                               sp_handle_ptr->pid);
+        sp_handle_ptr->isolated = false;
+    }
 
-    if (NULL != sp_handle_ptr->stdout_wl_event_source_ptr) {
-        wl_event_source_remove(sp_handle_ptr->stdout_wl_event_source_ptr);
-        sp_handle_ptr->stdout_wl_event_source_ptr = NULL;
+    if (NULL != sp_handle_ptr->pidfd_wl_event_source_ptr) {
+        wl_event_source_remove(sp_handle_ptr->pidfd_wl_event_source_ptr);
+        sp_handle_ptr->pidfd_wl_event_source_ptr = NULL;
+    }
+    if (0 <= sp_handle_ptr->pidfd) {
+        close(sp_handle_ptr->pidfd);
+        sp_handle_ptr->pidfd = -1;
+    }
+    _wlmaker_subprocess_stream_fini(&sp_handle_ptr->stdout_stream);
+    _wlmaker_subprocess_stream_fini(&sp_handle_ptr->stderr_stream);
+
+    _wlmaker_subprocess_handle_flush_log(sp_handle_ptr);
+    if (NULL != sp_handle_ptr->log_idle_event_source_ptr) {
+        wl_event_source_remove(sp_handle_ptr->log_idle_event_source_ptr);
+        sp_handle_ptr->log_idle_event_source_ptr = NULL;
+    }
+    if (0 <= sp_handle_ptr->log_fd) {
+        close(sp_handle_ptr->log_fd);
+        sp_handle_ptr->log_fd = -1;
     }
-    if (NULL != sp_handle_ptr->stderr_wl_event_source_ptr) {
-        wl_event_source_remove(sp_handle_ptr->stderr_wl_event_source_ptr);
-        sp_handle_ptr->stderr_wl_event_source_ptr = NULL;
+    if (NULL != sp_handle_ptr->log_buffer_ptr) {
+        free(sp_handle_ptr->log_buffer_ptr);
+        sp_handle_ptr->log_buffer_ptr = NULL;
     }
     free(sp_handle_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
 /**
- * Handler for activity on stdout file descriptor, as prescribed by
- * wl_event_loop_fd_func_t.
- *
- * @param fd
- * @param mask                A bitmask of WL_EVENT_READABLE, WL_EVENT_HANGUP
- *                            or WL_EVENT_ERROR.
- * @param data_ptr            Points ot a @ref wlmaker_subprocess_handle_t.
+ * Opens the subprocess' log file, in the configured log directory. Output is
+ * not written to a file, if that fails.
  *
- * @return 0.
+ * @param subprocess_handle_ptr
  */
-int _wlmaker_subprocess_monitor_handle_read_stdout(
-    int fd, uint32_t mask, void *data_ptr)
+void _wlmaker_subprocess_handle_open_log(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr)
 {
-    wlmaker_subprocess_handle_t *subprocess_handle_ptr = data_ptr;
-    BS_ASSERT(fd == subprocess_handle_ptr->stdout_read_fd);
-    return _wlmaker_subprocess_monitor_process_fd(
-        subprocess_handle_ptr,
-        &subprocess_handle_ptr->stdout_wl_event_source_ptr,
-        subprocess_handle_ptr->stdout_read_fd,
-        mask,
-        "stdout");
+    char path[PATH_MAX];
+    if ((int)sizeof(path) <= snprintf(
+            path, sizeof(path), "%s/subprocess-%"PRIdMAX".log",
+            subprocess_handle_ptr->monitor_ptr->log_directory,
+            (intmax_t)subprocess_handle_ptr->pid)) {
+        bs_log(BS_WARNING, "Path too long for log file in %s",
+               subprocess_handle_ptr->monitor_ptr->log_directory);
+        return;
+    }
+
+    subprocess_handle_ptr->log_buffer_ptr = logged_calloc(
+        1, WLMAKER_SUBPROCESS_LOG_BUFFER_SIZE);
+    if (NULL == subprocess_handle_ptr->log_buffer_ptr) return;
+    subprocess_handle_ptr->log_fd = open(
+        path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (0 > subprocess_handle_ptr->log_fd) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed open(%s, ...)", path);
+        free(subprocess_handle_ptr->log_buffer_ptr);
+        subprocess_handle_ptr->log_buffer_ptr = NULL;
+    }
 }
 
 /* ------------------------------------------------------------------------- */
 /**
- * Handler for activity on stderr file descriptor, as prescribed by
- * wl_event_loop_fd_func_t.
+ * Appends to the log file. Data is buffered, and written when the buffer is
+ * full, or once the event loop is idle.
  *
- * @param fd
- * @param mask                A bitmask of WL_EVENT_READABLE, WL_EVENT_HANGUP
- *                            or WL_EVENT_ERROR.
- * @param data_ptr            Points to a @ref wlmaker_subprocess_handle_t.
+ * @param subprocess_handle_ptr
+ * @param data_ptr
+ * @param length
+ */
+void _wlmaker_subprocess_handle_write_log(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    const char *data_ptr,
+    size_t length)
+{
+    if (0 > subprocess_handle_ptr->log_fd) return;
+
+    while (0 < length) {
+        if (WLMAKER_SUBPROCESS_LOG_BUFFER_SIZE <=
+            subprocess_handle_ptr->log_buffer_length) {
+            _wlmaker_subprocess_handle_flush_log(subprocess_handle_ptr);
+            if (0 > subprocess_handle_ptr->log_fd) return;
+        }
+        size_t chunk = BS_MIN(
+            length,
+            WLMAKER_SUBPROCESS_LOG_BUFFER_SIZE -
+            subprocess_handle_ptr->log_buffer_length);
+        memcpy(subprocess_handle_ptr->log_buffer_ptr +
+               subprocess_handle_ptr->log_buffer_length, data_ptr, chunk);
+        subprocess_handle_ptr->log_buffer_length += chunk;
+        data_ptr += chunk;
+        length -= chunk;
+    }
+
+    if (NULL == subprocess_handle_ptr->log_idle_event_source_ptr) {
+        subprocess_handle_ptr->log_idle_event_source_ptr =
+            wl_event_loop_add_idle(
+                subprocess_handle_ptr->monitor_ptr->wl_event_loop_ptr,
+                _wlmaker_subprocess_handle_idle_flush_log,
+                subprocess_handle_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Writes the buffered output to the log file. Closes the log file on error.
  *
- * @return 0.
+ * @param subprocess_handle_ptr
  */
-int _wlmaker_subprocess_monitor_handle_read_stderr(
-    int fd, uint32_t mask, void *data_ptr)
+void _wlmaker_subprocess_handle_flush_log(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr)
+{
+    size_t written = 0;
+    while (0 <= subprocess_handle_ptr->log_fd &&
+           written < subprocess_handle_ptr->log_buffer_length) {
+        ssize_t rv = write(
+            subprocess_handle_ptr->log_fd,
+            subprocess_handle_ptr->log_buffer_ptr + written,
+            subprocess_handle_ptr->log_buffer_length - written);
+        if (0 > rv) {
+            if (EINTR == errno) continue;
+            bs_log(BS_WARNING | BS_ERRNO,
+                   "subprocess %"PRIdMAX": Failed write(%d, ...), closing "
+                   "log file.", (intmax_t)subprocess_handle_ptr->pid,
+                   subprocess_handle_ptr->log_fd);
+            close(subprocess_handle_ptr->log_fd);
+            subprocess_handle_ptr->log_fd = -1;
+        } else {
+            written += rv;
+        }
+    }
+    subprocess_handle_ptr->log_buffer_length = 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Idle callback: Writes the buffered output to the log file. */
+void _wlmaker_subprocess_handle_idle_flush_log(void *data_ptr)
 {
     wlmaker_subprocess_handle_t *subprocess_handle_ptr = data_ptr;
-    BS_ASSERT(fd == subprocess_handle_ptr->stderr_read_fd);
-    return _wlmaker_subprocess_monitor_process_fd(
-        subprocess_handle_ptr,
-        &subprocess_handle_ptr->stderr_wl_event_source_ptr,
-        subprocess_handle_ptr->stderr_read_fd,
-        mask,
-        "stderr");
+    // Idle sources are removed after dispatch.
+    subprocess_handle_ptr->log_idle_event_source_ptr = NULL;
+    _wlmaker_subprocess_handle_flush_log(subprocess_handle_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Logs the number of lines dropped due to the rate limit, if any. */
+void _wlmaker_subprocess_handle_report_dropped(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr)
+{
+    if (0 == subprocess_handle_ptr->dropped_lines) return;
+    bs_log(BS_WARNING, "subprocess %"PRIdMAX": Rate limit exceeded, "
+           "dropped %"PRIu64" lines of output.",
+           (intmax_t)subprocess_handle_ptr->pid,
+           subprocess_handle_ptr->dropped_lines);
+    subprocess_handle_ptr->dropped_lines = 0;
 }
 
 /* ------------------------------------------------------------------------- */
 /**
- * Processes activity on a file descriptor, matches wl_event_loop_fd_func_t.
+ * Initializes the output stream and starts reading from `fd`.
  *
+ * @param stream_ptr
  * @param subprocess_handle_ptr
- * @param wl_event_source_ptr_ptr
+ * @param name_ptr
+ * @param severity
  * @param fd
- * @param mask
- * @param fd_name_ptr
+ */
+void _wlmaker_subprocess_stream_init(
+    wlmaker_subprocess_stream_t *stream_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    const char *name_ptr,
+    bs_log_severity_t severity,
+    int fd)
+{
+    stream_ptr->subprocess_handle_ptr = subprocess_handle_ptr;
+    stream_ptr->name_ptr = name_ptr;
+    stream_ptr->severity = severity;
+    stream_ptr->fd = fd;
+    stream_ptr->wl_event_source_ptr = wl_event_loop_add_fd(
+        subprocess_handle_ptr->monitor_ptr->wl_event_loop_ptr,
+        fd,
+        WL_EVENT_READABLE,
+        _wlmaker_subprocess_stream_handle_read,
+        stream_ptr);
+    if (NULL == stream_ptr->wl_event_source_ptr) {
+        bs_log(BS_WARNING, "subprocess %"PRIdMAX" %s: Failed "
+               "wl_event_loop_add_fd(%p, %d, ...)",
+               (intmax_t)subprocess_handle_ptr->pid, name_ptr,
+               subprocess_handle_ptr->monitor_ptr->wl_event_loop_ptr, fd);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Stops reading from the output stream. */
+void _wlmaker_subprocess_stream_fini(wlmaker_subprocess_stream_t *stream_ptr)
+{
+    if (NULL != stream_ptr->wl_event_source_ptr) {
+        wl_event_source_remove(stream_ptr->wl_event_source_ptr);
+        stream_ptr->wl_event_source_ptr = NULL;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handler for activity on the stream's file descriptor, as prescribed by
+ * wl_event_loop_fd_func_t.
+ *
+ * @param fd
+ * @param mask                A bitmask of WL_EVENT_READABLE, WL_EVENT_HANGUP
+ *                            or WL_EVENT_ERROR.
+ * @param data_ptr            Points to a @ref wlmaker_subprocess_stream_t.
  *
  * @return 0.
  */
-int _wlmaker_subprocess_monitor_process_fd(
-    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
-    struct wl_event_source **wl_event_source_ptr_ptr,
-    int fd,
-    uint32_t mask,
-    const char *fd_name_ptr)
+int _wlmaker_subprocess_stream_handle_read(
+    int fd, uint32_t mask, void *data_ptr)
 {
-    // Convenience copy.
-    intmax_t pid = bs_subprocess_pid(subprocess_handle_ptr->subprocess_ptr);
+    wlmaker_subprocess_stream_t *stream_ptr = data_ptr;
+    BS_ASSERT(fd == stream_ptr->fd);
+    intmax_t pid = stream_ptr->subprocess_handle_ptr->pid;
 
     if (mask & WL_EVENT_READABLE) {
-        ssize_t read_bytes;
-        char buf[1024];
-        read_bytes = read(fd, buf, sizeof(buf));
-        buf[BS_MIN(read_bytes, 1023)] = '\0';
+        ssize_t read_bytes = read(
+            fd,
+            stream_ptr->line + stream_ptr->line_length,
+            sizeof(stream_ptr->line) - stream_ptr->line_length);
         if (0 < read_bytes) {
-            // TODO(kaeser@gubbe.ch): Find a way to log this appropriately.
-            // We'd want to have STDERR logged as WARN, and STDOUT in INFO.
-            bs_log(BS_DEBUG, "subprocess %"PRIdMAX" %s: %s",
-                   pid, fd_name_ptr, buf);
-        } else if (0 > read_bytes) {
+            stream_ptr->line_length += read_bytes;
+            _wlmaker_subprocess_stream_emit_lines(stream_ptr, false);
+            return 0;
+        }
+        if (0 > read_bytes) {
+            if (EAGAIN == errno || EINTR == errno) return 0;
             bs_log(BS_WARNING | BS_ERRNO,
-                   "subprocess %"PRIdMAX" %s: Failed raad(%d, ...)",
-                   pid, fd_name_ptr, fd);
+                   "subprocess %"PRIdMAX" %s: Failed read(%d, ...)",
+                   pid, stream_ptr->name_ptr, fd);
         }
-        return 0;
+        // End of file, or an error: Stop reading.
+        mask |= WL_EVENT_HANGUP;
     }
 
     if (mask & (WL_EVENT_HANGUP | WL_EVENT_ERROR) &&
-        NULL != *wl_event_source_ptr_ptr) {
+        NULL != stream_ptr->wl_event_source_ptr) {
         bs_log(BS_DEBUG, "subprocess %"PRIdMAX" %s: Mask 0x%x, removing.",
-               pid, fd_name_ptr, mask);
-        wl_event_source_remove(*wl_event_source_ptr_ptr);
-        *wl_event_source_ptr_ptr = NULL;
+               pid, stream_ptr->name_ptr, mask);
+        _wlmaker_subprocess_stream_emit_lines(stream_ptr, true);
+        wl_event_source_remove(stream_ptr->wl_event_source_ptr);
+        stream_ptr->wl_event_source_ptr = NULL;
         return 0;
     }
 
     bs_log(BS_WARNING, "subprocess %"PRIdMAX" %s: Unexpected event, mask 0x%x",
-           pid, fd_name_ptr, mask);
+           pid, stream_ptr->name_ptr, mask);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Emits all complete lines from the stream's buffer.
+ *
+ * A line filling the entire buffer is emitted without its end, and continues
+ * as a new line.
+ *
+ * @param stream_ptr
+ * @param flush               Whether to also emit an incomplete line.
+ */
+void _wlmaker_subprocess_stream_emit_lines(
+    wlmaker_subprocess_stream_t *stream_ptr,
+    bool flush)
+{
+    char *start_ptr = stream_ptr->line;
+    char *end_ptr = stream_ptr->line + stream_ptr->line_length;
+    char *newline_ptr;
+    while (NULL != (newline_ptr = memchr(
+                        start_ptr, '\n', end_ptr - start_ptr))) {
+        _wlmaker_subprocess_stream_emit_line(
+            stream_ptr, start_ptr, newline_ptr - start_ptr);
+        start_ptr = newline_ptr + 1;
+    }
+
+    size_t remaining = end_ptr - start_ptr;
+    if (0 < remaining &&
+        (flush || sizeof(stream_ptr->line) <= remaining)) {
+        _wlmaker_subprocess_stream_emit_line(stream_ptr, start_ptr, remaining);
+        remaining = 0;
+    }
+    memmove(stream_ptr->line, start_ptr, remaining);
+    stream_ptr->line_length = remaining;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Emits a line of output: Writes it to the log file, if configured, and logs
+ * it, unless exceeding the rate limit.
+ *
+ * @param stream_ptr
+ * @param line_ptr            The line, without the newline.
+ * @param length
+ */
+void _wlmaker_subprocess_stream_emit_line(
+    wlmaker_subprocess_stream_t *stream_ptr,
+    const char *line_ptr,
+    size_t length)
+{
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr =
+        stream_ptr->subprocess_handle_ptr;
+    if (0 < length && '\r' == line_ptr[length - 1]) --length;
+
+    _wlmaker_subprocess_handle_write_log(
+        subprocess_handle_ptr, line_ptr, length);
+    _wlmaker_subprocess_handle_write_log(subprocess_handle_ptr, "\n", 1);
+
+    uint64_t limit = subprocess_handle_ptr->monitor_ptr->log_rate_limit;
+    if (0 < limit) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        uint64_t now_msec = now.tv_sec * 1000 + now.tv_nsec / 1000000;
+        if (subprocess_handle_ptr->rate_period_msec + 1000 <= now_msec) {
+            _wlmaker_subprocess_handle_report_dropped(subprocess_handle_ptr);
+            subprocess_handle_ptr->rate_period_msec = now_msec;
+            subprocess_handle_ptr->rate_period_lines = 0;
+        }
+        if (limit <= subprocess_handle_ptr->rate_period_lines) {
+            ++subprocess_handle_ptr->dropped_lines;
+            return;
+        }
+        ++subprocess_handle_ptr->rate_period_lines;
+    }
+
+    bs_log(stream_ptr->severity, "subprocess %"PRIdMAX" %s: %.*s",
+           (intmax_t)subprocess_handle_ptr->pid, stream_ptr->name_ptr,
+           (int)length, line_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Watches for termination of the subprocess.
+ *
+ * Uses a pidfd, which becomes readable once the subprocess exited. That way,
+ * only the exited subprocess is reaped. If pidfds are not supported, the
+ * subprocess is added to the list polled on each SIGCHLD.
+ *
+ * @param monitor_ptr
+ * @param subprocess_handle_ptr
+ */
+void _wlmaker_subprocess_monitor_watch(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr)
+{
+#if defined(SYS_pidfd_open)
+    subprocess_handle_ptr->pidfd = syscall(
+        SYS_pidfd_open, subprocess_handle_ptr->pid, 0);
+    if (0 > subprocess_handle_ptr->pidfd) {
+        if (ENOSYS != errno) {
+            bs_log(BS_WARNING | BS_ERRNO,
+                   "Failed pidfd_open(%"PRIdMAX", 0)",
+                   (intmax_t)subprocess_handle_ptr->pid);
+        }
+    } else {
+        subprocess_handle_ptr->pidfd_wl_event_source_ptr =
+            wl_event_loop_add_fd(
+                monitor_ptr->wl_event_loop_ptr,
+                subprocess_handle_ptr->pidfd,
+                WL_EVENT_READABLE,
+                _wlmaker_subprocess_monitor_handle_pidfd,
+                subprocess_handle_ptr);
+        if (NULL != subprocess_handle_ptr->pidfd_wl_event_source_ptr) return;
+        bs_log(BS_WARNING, "Failed wl_event_loop_add_fd(%p, %d, ...)",
+               monitor_ptr->wl_event_loop_ptr, subprocess_handle_ptr->pidfd);
+        close(subprocess_handle_ptr->pidfd);
+        subprocess_handle_ptr->pidfd = -1;
+    }
+#endif  // defined(SYS_pidfd_open)
+
+    bs_dllist_push_back(&monitor_ptr->subprocesses,
+                        &subprocess_handle_ptr->dlnode);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Removes a terminated subprocess from the monitor, and destroys the handle.
+ *
+ * @param monitor_ptr
+ * @param subprocess_handle_ptr
+ */
+void _wlmaker_subprocess_monitor_reap(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr)
+{
+    if (subprocess_handle_ptr->indexed) {
+        bs_avltree_delete(monitor_ptr->subprocess_tree_ptr,
+                          &subprocess_handle_ptr->pid);
+        subprocess_handle_ptr->indexed = false;
+    }
+    if (NULL == subprocess_handle_ptr->pidfd_wl_event_source_ptr) {
+        bs_dllist_remove(&monitor_ptr->subprocesses,
+                         &subprocess_handle_ptr->dlnode);
+    }
+    wlmaker_subprocess_handle_destroy(subprocess_handle_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles activity on the pidfd: The subprocess exited. Callback for the
+ * Wayland event loop, as prescribed by wl_event_loop_fd_func_t.
+ *
+ * @param fd
+ * @param mask
+ * @param data_ptr            Points to a @ref wlmaker_subprocess_handle_t.
+ *
+ * @return 0.
+ */
+int _wlmaker_subprocess_monitor_handle_pidfd(
+    int fd,
+    __UNUSED__ uint32_t mask,
+    void *data_ptr)
+{
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr = data_ptr;
+    BS_ASSERT(fd == subprocess_handle_ptr->pidfd);
+
+    int exit_status, signal_number;
+    if (bs_subprocess_terminated(subprocess_handle_ptr->subprocess_ptr,
+                                 &exit_status, &signal_number)) {
+        _wlmaker_subprocess_monitor_reap(
+            subprocess_handle_ptr->monitor_ptr, subprocess_handle_ptr);
+    }
     return 0;
 }
 
@@ -499,6 +1141,9 @@ int _wlmaker_subprocess_monitor_process_fd(
 /**
  * Handles SIGCHLD. Callback for Wayland event loop.
  *
+ * Only polls the subprocesses without a pidfd. Subprocesses with a pidfd are
+ * reaped from @ref _wlmaker_subprocess_monitor_handle_pidfd.
+ *
  * @param signum
  *
  * @param data_ptr            Points to @ref wlmaker_subprocess_monitor_t.
@@ -517,10 +1162,8 @@ int _wlmaker_subprocess_monitor_handle_sigchld(
         int exit_status, signal_number;
         if (bs_subprocess_terminated(subprocess_handle_ptr->subprocess_ptr,
                                      &exit_status, &signal_number)) {
-            bs_dllist_remove(
-                &monitor_ptr->subprocesses,
-                &subprocess_handle_ptr->dlnode);
-            wlmaker_subprocess_handle_destroy(subprocess_handle_ptr);
+            _wlmaker_subprocess_monitor_reap(
+                monitor_ptr, subprocess_handle_ptr);
         }
     }
 
@@ -656,6 +1299,18 @@ void _wlmaker_subprocess_monitor_handle_window_destroyed(
     wlmaker_subprocess_window_destroy(ws_window_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Returns the registry entry for `window_ptr`, or NULL. */
+wlmaker_subprocess_window_t *_wlmaker_subprocess_window_lookup(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmtk_window_t *window_ptr)
+{
+    bs_avltree_node_t *avlnode_ptr = bs_avltree_lookup(
+        monitor_ptr->window_tree_ptr, window_ptr);
+    if (NULL == avlnode_ptr) return NULL;
+    return BS_CONTAINER_OF(avlnode_ptr, wlmaker_subprocess_window_t, avlnode);
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Returns the subprocess matching the window's client, if any.
@@ -675,19 +1330,10 @@ wlmaker_subprocess_handle_t *subprocess_handle_from_window(
 {
     const wlmtk_util_client_t *client_ptr = wlmtk_window_get_client_ptr(
         window_ptr);
-    // TODO(kaeser@gubbe.ch): Should be a O(1) or O(log(n)) structure.
-    for (bs_dllist_node_t *dlnode_ptr = monitor_ptr->subprocesses.head_ptr;
-         NULL != dlnode_ptr;
-         dlnode_ptr = dlnode_ptr->next_ptr) {
-        wlmaker_subprocess_handle_t *subprocess_handle_ptr = BS_CONTAINER_OF(
-            dlnode_ptr, wlmaker_subprocess_handle_t, dlnode);
-        if (client_ptr->pid ==
-            bs_subprocess_pid(subprocess_handle_ptr->subprocess_ptr)) {
-            return subprocess_handle_ptr;
-        }
-    }
-
-    return NULL;
+    bs_avltree_node_t *avlnode_ptr = bs_avltree_lookup(
+        monitor_ptr->subprocess_tree_ptr, &client_ptr->pid);
+    if (NULL == avlnode_ptr) return NULL;
+    return BS_CONTAINER_OF(avlnode_ptr, wlmaker_subprocess_handle_t, avlnode);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -766,6 +1412,18 @@ void wlmaker_subprocess_window_destroy(
     free(ws_window_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Comparator for subprocess handle tree nodes, by PID. */
+int _wlmaker_subprocess_handle_node_cmp(const bs_avltree_node_t *node_ptr,
+                                        const void *key_ptr)
+{
+    pid_t pid = BS_CONTAINER_OF(
+        node_ptr, wlmaker_subprocess_handle_t, avlnode)->pid;
+    pid_t key_pid = *(const pid_t*)key_ptr;
+    if (pid < key_pid) return -1;
+    return pid > key_pid ? 1 : 0;
+}
+
 /* ------------------------------------------------------------------------- */
 /** Comparator for window registry tree nodes. */
 int wlmaker_subprocess_window_node_cmp(const bs_avltree_node_t *node_ptr,
@@ -785,4 +1443,119 @@ void wlmaker_subprocess_window_node_destroy(bs_avltree_node_t *node_ptr)
     wlmaker_subprocess_window_destroy(ws_window_ptr);
 }
 
+/* == Unit tests =========================================================== */
+
+static void _wlmaker_subprocess_monitor_test_window_callback(
+    void *userdata_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    wlmtk_window_t *window_ptr);
+static void test_cede(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_subprocess_monitor_test_cases[] = {
+    { 1, "cede", test_cede },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Test helper: Counts the window callback calls in `userdata_ptr`. */
+void _wlmaker_subprocess_monitor_test_window_callback(
+    void *userdata_ptr,
+    __UNUSED__ wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    __UNUSED__ wlmtk_window_t *window_ptr)
+{
+    int *calls_ptr = userdata_ptr;
+    ++(*calls_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies a ceded subprocess leaves the PID index, with its callbacks. */
+void test_cede(bs_test_t *test_ptr)
+{
+    wlmaker_subprocess_monitor_t monitor = {};
+    monitor.subprocess_tree_ptr = bs_avltree_create(
+        _wlmaker_subprocess_handle_node_cmp, NULL);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, monitor.subprocess_tree_ptr);
+    monitor.window_tree_ptr = bs_avltree_create(
+        wlmaker_subprocess_window_node_cmp,
+        wlmaker_subprocess_window_node_destroy);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, monitor.window_tree_ptr);
+
+    int calls = 0;
+    wlmaker_subprocess_handle_t handle = {
+        .monitor_ptr = &monitor,
+        .pid = 4242,
+        .pidfd = -1,
+        .log_fd = -1,
+        .userdata_ptr = &calls,
+        .window_created_callback =
+        _wlmaker_subprocess_monitor_test_window_callback,
+        .window_mapped_callback =
+        _wlmaker_subprocess_monitor_test_window_callback,
+        .window_destroyed_callback =
+        _wlmaker_subprocess_monitor_test_window_callback
+    };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        bs_avltree_insert(monitor.subprocess_tree_ptr, &handle.pid,
+                          &handle.avlnode, false));
+    handle.indexed = true;
+
+    wlmtk_fake_window_t *fw1_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fw1_ptr);
+    fw1_ptr->fake_content_ptr->content.client.pid = 4242;
+    wlmtk_fake_window_t *fw2_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fw2_ptr);
+    fw2_ptr->fake_content_ptr->content.client.pid = 4242;
+
+    // A window of the subprocess' PID gets matched, and reported.
+    _wlmaker_subprocess_monitor_handle_window_created(
+        &monitor.window_created_listener, fw1_ptr->window_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, calls);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &handle,
+        subprocess_handle_from_window(&monitor, fw1_ptr->window_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmaker_subprocess_monitor_size(&monitor));
+
+    // Ceding: Reports the window as destroyed, and leaves the index.
+    wlmaker_subprocess_monitor_cede(&monitor, &handle);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, calls);
+    BS_TEST_VERIFY_FALSE(test_ptr, handle.indexed);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmaker_subprocess_monitor_size(&monitor));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL,
+        bs_avltree_lookup(monitor.subprocess_tree_ptr, &handle.pid));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL,
+        subprocess_handle_from_window(&monitor, fw1_ptr->window_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, handle.window_created_callback);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, handle.window_mapped_callback);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, handle.window_destroyed_callback);
+    wlmaker_subprocess_window_t *ws_window_ptr =
+        _wlmaker_subprocess_window_lookup(&monitor, fw1_ptr->window_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws_window_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, ws_window_ptr->subprocess_handle_ptr);
+
+    // Windows created or mapped after ceding are not matched nor reported.
+    _wlmaker_subprocess_monitor_handle_window_created(
+        &monitor.window_created_listener, fw2_ptr->window_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL,
+        _wlmaker_subprocess_window_lookup(&monitor, fw2_ptr->window_ptr));
+    _wlmaker_subprocess_monitor_handle_window_mapped(
+        &monitor.window_mapped_listener, fw1_ptr->window_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, calls);
+
+    _wlmaker_subprocess_monitor_handle_window_destroyed(
+        &monitor.window_destroyed_listener, fw1_ptr->window_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, calls);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL,
+        _wlmaker_subprocess_window_lookup(&monitor, fw1_ptr->window_ptr));
+
+    wlmtk_fake_window_destroy(fw2_ptr);
+    wlmtk_fake_window_destroy(fw1_ptr);
+    bs_avltree_destroy(monitor.window_tree_ptr);
+    bs_avltree_destroy(monitor.subprocess_tree_ptr);
+}
+
 /* == End of subprocess_monitor.c ========================================== */
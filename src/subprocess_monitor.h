@@ -27,6 +27,7 @@ typedef struct _wlmaker_subprocess_monitor_t wlmaker_subprocess_monitor_t;
 /** Forward definition for a subprocess handle. */
 typedef struct _wlmaker_subprocess_handle_t wlmaker_subprocess_handle_t;
 
+#include "cgroup.h"
 #include "server.h"  // IWYU pragma: keep
 #include "toolkit/toolkit.h"
 
@@ -78,6 +79,10 @@ wlmaker_subprocess_monitor_t* wlmaker_subprocess_monitor_create(
 void wlmaker_subprocess_monitor_destroy(
     wlmaker_subprocess_monitor_t *monitor_ptr);
 
+/** @return Number of subprocesses currently held by `monitor_ptr`. */
+size_t wlmaker_subprocess_monitor_size(
+    wlmaker_subprocess_monitor_t *monitor_ptr);
+
 /**
  * Passes ownership of the started `subprocess_ptr` to `monitor_ptr`.
  *
@@ -110,6 +115,9 @@ wlmaker_subprocess_handle_t *wlmaker_subprocess_monitor_entrust(
  * Releases the reference held on `subprocess_handle_ptr`. Once the subprocess
  * terminates, all corresponding resources will be freed.
  *
+ * No further callbacks are invoked for the handle. Windows created after this
+ * call are not associated with the subprocess.
+ *
  * @param monitor_ptr
  * @param subprocess_handle_ptr
  */
@@ -117,10 +125,107 @@ void wlmaker_subprocess_monitor_cede(
     wlmaker_subprocess_monitor_t *monitor_ptr,
     wlmaker_subprocess_handle_t *subprocess_handle_ptr);
 
+/**
+ * Sets resource limits for the subprocess, overriding the defaults from the
+ * "Subprocesses" config dict. Only the non-zero limits are applied.
+ *
+ * @param monitor_ptr
+ * @param subprocess_handle_ptr
+ * @param limits_ptr
+ *
+ * @return true on success. false if the subprocess is not isolated in a
+ *     cgroup, or on error.
+ */
+bool wlmaker_subprocess_monitor_set_limits(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    const wlmaker_cgroup_limits_t *limits_ptr);
+
+/**
+ * Sets whether to hold back windows of the subprocess. A held window is not
+ * mapped when its client is ready to map it, until calling
+ * @ref wlmaker_subprocess_monitor_map_held_windows.
+ *
+ * @param subprocess_handle_ptr
+ * @param hold
+ */
+void wlmaker_subprocess_monitor_hold_windows(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    bool hold);
+
+/**
+ * Stops holding back windows of the subprocess, and maps the windows held
+ * so far on the current workspace.
+ *
+ * @param monitor_ptr
+ * @param subprocess_handle_ptr
+ *
+ * @return Number of windows that were mapped.
+ */
+size_t wlmaker_subprocess_monitor_map_held_windows(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr);
+
+/**
+ * Holds back the window if its subprocess holds windows. To be called when
+ * the window's client is ready to have it mapped.
+ *
+ * @param monitor_ptr
+ * @param window_ptr
+ *
+ * @return true if the window is held, and must not be mapped now.
+ */
+bool wlmaker_subprocess_monitor_hold_window(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmtk_window_t *window_ptr);
+
+/**
+ * Releases a held window without mapping it. To be called when the window's
+ * client unmaps it.
+ *
+ * @param monitor_ptr
+ * @param window_ptr
+ *
+ * @return true if the window was held, ie. is not mapped.
+ */
+bool wlmaker_subprocess_monitor_unhold_window(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmtk_window_t *window_ptr);
+
+/**
+ * Hides a mapped window of a subprocess: Unmaps it from its workspace, and
+ * holds it until @ref wlmaker_subprocess_monitor_show_window.
+ *
+ * @param monitor_ptr
+ * @param window_ptr
+ *
+ * @return true if the window was hidden.
+ */
+bool wlmaker_subprocess_monitor_hide_window(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmtk_window_t *window_ptr);
+
+/**
+ * Shows a window hidden by @ref wlmaker_subprocess_monitor_hide_window, by
+ * mapping it on the current workspace. Does nothing if the window's client
+ * has unmapped it in the meantime.
+ *
+ * @param monitor_ptr
+ * @param window_ptr
+ *
+ * @return true if the window was mapped.
+ */
+bool wlmaker_subprocess_monitor_show_window(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmtk_window_t *window_ptr);
+
 /** Returns the `bs_subprocess_t` from the @ref wlmaker_subprocess_handle_t. */
 bs_subprocess_t *wlmaker_subprocess_from_subprocess_handle(
     wlmaker_subprocess_handle_t *subprocess_handle_ptr);
 
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_subprocess_monitor_test_cases[];
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
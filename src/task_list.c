@@ -18,18 +18,14 @@
  * limitations under the License.
  */
 
-/// for PATH_MAX.
-#define _POSIX_C_SOURCE 1
-
 #include "task_list.h"
 
 #include <cairo.h>
 #include <inttypes.h>
 #include <libbase/libbase.h>
-#include <limits.h>
 #include <stdbool.h>
-#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <wayland-server-core.h>
 #include <wayland-util.h>
 /// Include unstable interfaces of wlroots.
@@ -43,13 +39,35 @@
 
 /* == Declarations ========================================================= */
 
+/** A row of the task list: The cached rendering of one window's name. */
+typedef struct {
+    /** Element of @ref wlmaker_task_list_t::rows. */
+    bs_dllist_node_t          dlnode;
+    /** The window this row represents. */
+    wlmtk_window_t            *window_ptr;
+    /** Buffer element showing the row, a child of the panel's container. */
+    wlmtk_buffer_t            buffer;
+    /** Title of the window at the time the row was rendered. */
+    char                      *title_ptr;
+    /** Rendered row, in normal (index 0) and active (index 1) style. */
+    struct wlr_buffer         *wlr_buffer_ptrs[2];
+    /** Whether the row is currently shown. */
+    bool                      shown;
+} wlmaker_task_list_row_t;
+
 /** State of the task list. */
 struct _wlmaker_task_list_t {
     /** Derived from a toolkit panel. */
     wlmtk_panel_t             super_panel;
 
-    /** Buffer that shows the tasklist's content. */
-    wlmtk_buffer_t            buffer;
+    /** Buffer that shows the tasklist's background. Rendered once. */
+    wlmtk_buffer_t            background_buffer;
+    /**
+     * Rows, as @ref wlmaker_task_list_row_t, most recently shown first. The
+     * shown rows are at the head. Holds at most
+     * @ref _wlmaker_task_list_max_rows rows.
+     */
+    bs_dllist_t               rows;
 
     /** Backlink to the server. */
     wlmaker_server_t          *server_ptr;
@@ -72,22 +90,27 @@ struct _wlmaker_task_list_t {
 
 static void _wlmaker_task_list_refresh(
     wlmaker_task_list_t *task_list_ptr);
-static struct wlr_buffer *create_wlr_buffer(
-    wlmtk_workspace_t *workspace_ptr,
+static struct wlr_buffer *_wlmaker_task_list_create_background(
     wlmaker_config_task_list_style_t *style_ptr);
-static void _wlmaker_task_list_draw_into_cairo(
-    cairo_t *cairo_ptr,
-    wlmaker_config_task_list_style_t *style_ptr,
-    wlmtk_workspace_t *workspace_ptr);
-static void _wlmaker_task_list_draw_window_into_cairo(
-    cairo_t *cairo_ptr,
-    wlmtk_style_font_t *font_style_ptr,
-    uint32_t color,
-    wlmtk_window_t *window_ptr,
+
+static wlmaker_task_list_row_t *_wlmaker_task_list_row_for_window(
+    wlmaker_task_list_t *task_list_ptr,
+    wlmtk_window_t *window_ptr);
+static void _wlmaker_task_list_row_destroy(
+    wlmaker_task_list_t *task_list_ptr,
+    wlmaker_task_list_row_t *row_ptr);
+static void _wlmaker_task_list_row_show(
+    wlmaker_task_list_t *task_list_ptr,
+    wlmaker_task_list_row_t *row_ptr,
     bool active,
     int pos_y);
+static struct wlr_buffer *_wlmaker_task_list_row_render(
+    wlmaker_config_task_list_style_t *style_ptr,
+    wlmtk_window_t *window_ptr,
+    bool active);
 static const char *_wlmaker_task_list_window_name(
     wlmtk_window_t *window_ptr);
+static bool _wlmaker_task_list_skips(wlmtk_window_t *window_ptr);
 
 static uint32_t _wlmaker_task_list_request_size(
     wlmtk_panel_t *panel_ptr,
@@ -121,6 +144,15 @@ static const wlmtk_panel_vmt_t _wlmaker_task_list_vmt = {
     .request_size = _wlmaker_task_list_request_size
 };
 
+/** Height of a row, and the distance between rows. */
+static const int _wlmaker_task_list_row_height = 26;
+/** Position of the text's baseline, within the row. */
+static const int _wlmaker_task_list_row_baseline = 18;
+/** Number of rows shown before and after the active row. */
+static const int _wlmaker_task_list_further_rows = 3;
+/** Number of rows kept cached, for windows that are not currently shown. */
+static const size_t _wlmaker_task_list_max_rows = 32;
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -143,15 +175,23 @@ wlmaker_task_list_t *wlmaker_task_list_create(
     wlmtk_element_set_visible(
         wlmtk_panel_element(&task_list_ptr->super_panel), true);
 
-    if (!wlmtk_buffer_init(&task_list_ptr->buffer)) {
+    if (!wlmtk_buffer_init(&task_list_ptr->background_buffer)) {
+        wlmaker_task_list_destroy(task_list_ptr);
+        return NULL;
+    }
+    struct wlr_buffer *wlr_buffer_ptr = _wlmaker_task_list_create_background(
+        &task_list_ptr->style);
+    if (NULL == wlr_buffer_ptr) {
         wlmaker_task_list_destroy(task_list_ptr);
         return NULL;
     }
+    wlmtk_buffer_set(&task_list_ptr->background_buffer, wlr_buffer_ptr);
+    wlr_buffer_drop(wlr_buffer_ptr);
     wlmtk_element_set_visible(
-        wlmtk_buffer_element(&task_list_ptr->buffer), true);
+        wlmtk_buffer_element(&task_list_ptr->background_buffer), true);
     wlmtk_container_add_element(
         &task_list_ptr->super_panel.super_container,
-        wlmtk_buffer_element(&task_list_ptr->buffer));
+        wlmtk_buffer_element(&task_list_ptr->background_buffer));
 
     wlmtk_util_connect_listener_signal(
         &server_ptr->task_list_enabled_event,
@@ -182,12 +222,20 @@ void wlmaker_task_list_destroy(wlmaker_task_list_t *task_list_ptr)
     wl_list_remove(&task_list_ptr->task_list_disabled_listener.link);
     wl_list_remove(&task_list_ptr->task_list_enabled_listener.link);
 
-    if (wlmtk_buffer_element(&task_list_ptr->buffer)->parent_container_ptr) {
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = task_list_ptr->rows.head_ptr)) {
+        _wlmaker_task_list_row_destroy(
+            task_list_ptr,
+            BS_CONTAINER_OF(dlnode_ptr, wlmaker_task_list_row_t, dlnode));
+    }
+
+    wlmtk_element_t *element_ptr = wlmtk_buffer_element(
+        &task_list_ptr->background_buffer);
+    if (NULL != element_ptr->parent_container_ptr) {
         wlmtk_container_remove_element(
-            &task_list_ptr->super_panel.super_container,
-            wlmtk_buffer_element(&task_list_ptr->buffer));
+            &task_list_ptr->super_panel.super_container, element_ptr);
     }
-    wlmtk_buffer_fini(&task_list_ptr->buffer);
+    wlmtk_buffer_fini(&task_list_ptr->background_buffer);
     wlmtk_panel_fini(&task_list_ptr->super_panel);
 
     free(task_list_ptr);
@@ -197,7 +245,14 @@ void wlmaker_task_list_destroy(wlmaker_task_list_t *task_list_ptr)
 
 /* ------------------------------------------------------------------------- */
 /**
- * Refreshes the task list. Should be done whenever a list is mapped/unmapped.
+ * Refreshes the task list. Should be done whenever a list is mapped/unmapped,
+ * or the activated window changes.
+ *
+ * Rows are only rendered when first shown, or when the window's title
+ * changed since. Otherwise, the refresh just re-positions the rows around
+ * the activated window, and switches the highlight (bold) rendering. Only
+ * the neighbours of the activated window are visited, so the cost does not
+ * depend on the number of windows.
  *
  * @param task_list_ptr
  */
@@ -206,24 +261,84 @@ void _wlmaker_task_list_refresh(wlmaker_task_list_t *task_list_ptr)
     wlmtk_workspace_t *workspace_ptr =
         wlmtk_root_get_current_workspace(task_list_ptr->server_ptr->root_ptr);
 
-    struct wlr_buffer *wlr_buffer_ptr = create_wlr_buffer(
-        workspace_ptr, &task_list_ptr->style);
-    wlmtk_buffer_set(&task_list_ptr->buffer, wlr_buffer_ptr);
-    wlr_buffer_drop(wlr_buffer_ptr);
+    // Hide the rows shown so far. These are at the head of the list.
+    for (bs_dllist_node_t *dlnode_ptr = task_list_ptr->rows.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_task_list_row_t *row_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_task_list_row_t, dlnode);
+        if (!row_ptr->shown) break;
+        wlmtk_element_set_visible(
+            wlmtk_buffer_element(&row_ptr->buffer), false);
+        row_ptr->shown = false;
+    }
+
+    // Not tied to a workspace? Or no windows at all? We're done, all set.
+    if (NULL == workspace_ptr) return;
+    const bs_dllist_t *windows_ptr = wlmtk_workspace_get_windows_dllist(
+        workspace_ptr);
+    if (bs_dllist_empty(windows_ptr)) return;
+
+    // The active window's node, for centering the task list.
+    bs_dllist_node_t *active_dlnode_ptr = NULL;
+    bs_dllist_node_t *centered_dlnode_ptr = windows_ptr->head_ptr;
+    wlmtk_window_t *activated_window_ptr =
+        wlmtk_workspace_get_activated_window(workspace_ptr);
+    if (NULL != activated_window_ptr) {
+        active_dlnode_ptr = wlmtk_dlnode_from_window(activated_window_ptr);
+        centered_dlnode_ptr = active_dlnode_ptr;
+    }
+
+    // Start at the furthest previous window that will be shown.
+    bs_dllist_node_t *dlnode_ptr = centered_dlnode_ptr;
+    int further_rows = 0;
+    int row = 0;
+    while (NULL != dlnode_ptr->prev_ptr &&
+           further_rows > -_wlmaker_task_list_further_rows) {
+        dlnode_ptr = dlnode_ptr->prev_ptr;
+        --further_rows;
+        if (!_wlmaker_task_list_skips(wlmtk_window_from_dlnode(dlnode_ptr))) {
+            --row;
+        }
+    }
+
+    // Windows skipping the task list leave no gap.
+    int pos_y = _wlmaker_task_list_positioning.desired_height / 2 + 10;
+    for (;
+         NULL != dlnode_ptr &&
+             further_rows <= _wlmaker_task_list_further_rows;
+         dlnode_ptr = dlnode_ptr->next_ptr, ++further_rows) {
+        wlmtk_window_t *window_ptr = wlmtk_window_from_dlnode(dlnode_ptr);
+        if (_wlmaker_task_list_skips(window_ptr)) continue;
+        wlmaker_task_list_row_t *row_ptr = _wlmaker_task_list_row_for_window(
+            task_list_ptr, window_ptr);
+        if (NULL == row_ptr) continue;
+        _wlmaker_task_list_row_show(
+            task_list_ptr,
+            row_ptr,
+            dlnode_ptr == active_dlnode_ptr,
+            pos_y + row++ * _wlmaker_task_list_row_height);
+    }
+
+    // Drop the least recently shown rows, if above the cache limit.
+    while (bs_dllist_size(&task_list_ptr->rows) >
+           _wlmaker_task_list_max_rows) {
+        _wlmaker_task_list_row_destroy(
+            task_list_ptr,
+            BS_CONTAINER_OF(task_list_ptr->rows.tail_ptr,
+                            wlmaker_task_list_row_t, dlnode));
+    }
 }
 
 /* ------------------------------------------------------------------------- */
 /**
- * Creates a `struct wlr_buffer` with windows of `workspace_ptr` drawn into.
+ * Creates a `struct wlr_buffer` with the task list's background.
  *
- * @param workspace_ptr
  * @param style_ptr
  *
- * @return A pointer to the `struct wlr_buffer` with the list of windows
- *     (tasks), or NULL on error.
+ * @return A pointer to the `struct wlr_buffer`, or NULL on error.
  */
-struct wlr_buffer *create_wlr_buffer(
-    wlmtk_workspace_t *workspace_ptr,
+struct wlr_buffer *_wlmaker_task_list_create_background(
     wlmaker_config_task_list_style_t *style_ptr)
 {
     struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
@@ -236,7 +351,7 @@ struct wlr_buffer *create_wlr_buffer(
         wlr_buffer_drop(wlr_buffer_ptr);
         return NULL;
     }
-    _wlmaker_task_list_draw_into_cairo(cairo_ptr, style_ptr, workspace_ptr);
+    wlmaker_primitives_cairo_fill(cairo_ptr, &style_ptr->fill);
     cairo_destroy(cairo_ptr);
 
     return wlr_buffer_ptr;
@@ -244,102 +359,152 @@ struct wlr_buffer *create_wlr_buffer(
 
 /* ------------------------------------------------------------------------- */
 /**
- * Draws all tasks of `workspace_ptr` into `cairo_ptr`.
+ * Finds the row for `window_ptr`, or creates one if there is none yet. The
+ * row is moved to the head of @ref wlmaker_task_list_t::rows.
  *
- * @param cairo_ptr
- * @param style_ptr
- * @param workspace_ptr
+ * The rows are looked up linearly, but there are at most
+ * @ref _wlmaker_task_list_max_rows of them, regardless of the number of
+ * windows.
+ *
+ * @param task_list_ptr
+ * @param window_ptr
+ *
+ * @return Pointer to the row, or NULL on error.
  */
-void _wlmaker_task_list_draw_into_cairo(
-    cairo_t *cairo_ptr,
-    wlmaker_config_task_list_style_t *style_ptr,
-    wlmtk_workspace_t *workspace_ptr)
+wlmaker_task_list_row_t *_wlmaker_task_list_row_for_window(
+    wlmaker_task_list_t *task_list_ptr,
+    wlmtk_window_t *window_ptr)
 {
-    wlmaker_primitives_cairo_fill(cairo_ptr, &style_ptr->fill);
+    for (bs_dllist_node_t *dlnode_ptr = task_list_ptr->rows.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_task_list_row_t *row_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_task_list_row_t, dlnode);
+        if (row_ptr->window_ptr == window_ptr) {
+            bs_dllist_remove(&task_list_ptr->rows, &row_ptr->dlnode);
+            bs_dllist_push_front(&task_list_ptr->rows, &row_ptr->dlnode);
+            return row_ptr;
+        }
+    }
 
-    // Not tied to a workspace? We're done, all set.
-    if (NULL == workspace_ptr) return;
+    wlmaker_task_list_row_t *row_ptr = logged_calloc(
+        1, sizeof(wlmaker_task_list_row_t));
+    if (NULL == row_ptr) return NULL;
+    if (!wlmtk_buffer_init(&row_ptr->buffer)) {
+        free(row_ptr);
+        return NULL;
+    }
+    row_ptr->window_ptr = window_ptr;
+    wlmtk_container_add_element(
+        &task_list_ptr->super_panel.super_container,
+        wlmtk_buffer_element(&row_ptr->buffer));
+    bs_dllist_push_front(&task_list_ptr->rows, &row_ptr->dlnode);
+    return row_ptr;
+}
 
-    const bs_dllist_t *windows_ptr = wlmtk_workspace_get_windows_dllist(
-        workspace_ptr);
-    // No windows at all? Done here.
-    if (bs_dllist_empty(windows_ptr)) return;
+/* ------------------------------------------------------------------------- */
+/**
+ * Destroys the row: Removes it from the task list and releases the buffers.
+ *
+ * @param task_list_ptr
+ * @param row_ptr
+ */
+void _wlmaker_task_list_row_destroy(
+    wlmaker_task_list_t *task_list_ptr,
+    wlmaker_task_list_row_t *row_ptr)
+{
+    bs_dllist_remove(&task_list_ptr->rows, &row_ptr->dlnode);
+    wlmtk_container_remove_element(
+        &task_list_ptr->super_panel.super_container,
+        wlmtk_buffer_element(&row_ptr->buffer));
+    wlmtk_buffer_fini(&row_ptr->buffer);
 
-    // Find node of the active window, for centering the task list.
-    bs_dllist_node_t *centered_dlnode_ptr = windows_ptr->head_ptr;
-    bs_dllist_node_t *active_dlnode_ptr = windows_ptr->head_ptr;
-    while (NULL != active_dlnode_ptr &&
-           wlmtk_workspace_get_activated_window(workspace_ptr) !=
-           wlmtk_window_from_dlnode(active_dlnode_ptr)) {
-        active_dlnode_ptr = active_dlnode_ptr->next_ptr;
+    for (size_t i = 0; i < 2; ++i) {
+        if (NULL == row_ptr->wlr_buffer_ptrs[i]) continue;
+        wlr_buffer_drop(row_ptr->wlr_buffer_ptrs[i]);
     }
-    if (NULL != active_dlnode_ptr) centered_dlnode_ptr = active_dlnode_ptr;
+    if (NULL != row_ptr->title_ptr) free(row_ptr->title_ptr);
+    free(row_ptr);
+}
 
-    int pos_y = _wlmaker_task_list_positioning.desired_height / 2 + 10;
-    _wlmaker_task_list_draw_window_into_cairo(
-        cairo_ptr,
-        &style_ptr->font,
-        style_ptr->text_color,
-        wlmtk_window_from_dlnode(centered_dlnode_ptr),
-        centered_dlnode_ptr == active_dlnode_ptr,
-        pos_y);
-
-    bs_dllist_node_t *dlnode_ptr = centered_dlnode_ptr->prev_ptr;
-    for (int further_windows = 1;
-         NULL != dlnode_ptr && further_windows <= 3;
-         dlnode_ptr = dlnode_ptr->prev_ptr, ++further_windows) {
-        _wlmaker_task_list_draw_window_into_cairo(
-            cairo_ptr,
-            &style_ptr->font,
-            style_ptr->text_color,
-            wlmtk_window_from_dlnode(dlnode_ptr),
-            false,
-            pos_y - further_windows * 26);
+/* ------------------------------------------------------------------------- */
+/**
+ * Shows the row at `pos_y`. Re-renders only if the title changed.
+ *
+ * @param task_list_ptr
+ * @param row_ptr
+ * @param active              Whether this window is currently active.
+ * @param pos_y               Y position of the text's baseline.
+ */
+void _wlmaker_task_list_row_show(
+    wlmaker_task_list_t *task_list_ptr,
+    wlmaker_task_list_row_t *row_ptr,
+    bool active,
+    int pos_y)
+{
+    const char *title_ptr = wlmtk_window_get_title(row_ptr->window_ptr);
+    if (NULL == row_ptr->title_ptr ||
+        0 != strcmp(row_ptr->title_ptr, title_ptr)) {
+        for (size_t i = 0; i < 2; ++i) {
+            if (NULL == row_ptr->wlr_buffer_ptrs[i]) continue;
+            wlr_buffer_drop(row_ptr->wlr_buffer_ptrs[i]);
+            row_ptr->wlr_buffer_ptrs[i] = NULL;
+        }
+        if (NULL != row_ptr->title_ptr) free(row_ptr->title_ptr);
+        row_ptr->title_ptr = logged_strdup(title_ptr);
     }
 
-    dlnode_ptr = centered_dlnode_ptr->next_ptr;
-    for (int further_windows = 1;
-         NULL != dlnode_ptr && further_windows <= 3;
-         dlnode_ptr = dlnode_ptr->next_ptr, ++further_windows) {
-        _wlmaker_task_list_draw_window_into_cairo(
-            cairo_ptr,
-            &style_ptr->font,
-            style_ptr->text_color,
-            wlmtk_window_from_dlnode(dlnode_ptr),
-            false,
-            pos_y + further_windows * 26);
+    struct wlr_buffer **wlr_buffer_ptr_ptr =
+        &row_ptr->wlr_buffer_ptrs[active ? 1 : 0];
+    if (NULL == *wlr_buffer_ptr_ptr) {
+        *wlr_buffer_ptr_ptr = _wlmaker_task_list_row_render(
+            &task_list_ptr->style, row_ptr->window_ptr, active);
     }
+    wlmtk_buffer_set(&row_ptr->buffer, *wlr_buffer_ptr_ptr);
+
+    wlmtk_element_set_position(
+        wlmtk_buffer_element(&row_ptr->buffer),
+        0, pos_y - _wlmaker_task_list_row_baseline);
+    wlmtk_element_set_visible(wlmtk_buffer_element(&row_ptr->buffer), true);
+    row_ptr->shown = true;
 }
 
 /* ------------------------------------------------------------------------- */
 /**
- * Draws one window (task) into `cairo_ptr`.
+ * Renders one window (task) into a new row buffer.
  *
- * @param cairo_ptr
- * @param font_style_ptr
- * @param color
+ * @param style_ptr
  * @param window_ptr
  * @param active              Whether this window is currently active.
- * @param pos_y               Y position within the `cairo_ptr`.
+ *
+ * @return A pointer to the `struct wlr_buffer`, or NULL on error.
  */
-void _wlmaker_task_list_draw_window_into_cairo(
-    cairo_t *cairo_ptr,
-    wlmtk_style_font_t *font_style_ptr,
-    uint32_t color,
+struct wlr_buffer *_wlmaker_task_list_row_render(
+    wlmaker_config_task_list_style_t *style_ptr,
     wlmtk_window_t *window_ptr,
-    bool active,
-    int pos_y)
+    bool active)
 {
-    cairo_set_source_argb8888(cairo_ptr, color);
-    cairo_set_font_size(cairo_ptr, font_style_ptr->size);
-    cairo_select_font_face(
-        cairo_ptr,
-        font_style_ptr->face,
-        CAIRO_FONT_SLANT_NORMAL,
-        active ? CAIRO_FONT_WEIGHT_BOLD : CAIRO_FONT_WEIGHT_NORMAL);
-    cairo_move_to(cairo_ptr, 10, pos_y);
-    cairo_show_text(cairo_ptr, _wlmaker_task_list_window_name(window_ptr));
- }
+    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
+        _wlmaker_task_list_positioning.desired_width,
+        _wlmaker_task_list_row_height);
+    if (NULL == wlr_buffer_ptr) return NULL;
+
+    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
+    if (NULL == cairo_ptr) {
+        wlr_buffer_drop(wlr_buffer_ptr);
+        return NULL;
+    }
+    wlmtk_style_font_t font_style = style_ptr->font;
+    font_style.weight = active ?
+        WLMTK_FONT_WEIGHT_BOLD : WLMTK_FONT_WEIGHT_NORMAL;
+    wlmaker_primitives_draw_text(
+        cairo_ptr, 10, _wlmaker_task_list_row_baseline,
+        &font_style, style_ptr->text_color,
+        _wlmaker_task_list_window_name(window_ptr));
+    cairo_destroy(cairo_ptr);
+
+    return wlr_buffer_ptr;
+}
 
 /* ------------------------------------------------------------------------- */
 /**
@@ -368,13 +533,9 @@ const char *_wlmaker_task_list_window_name(wlmtk_window_t *window_ptr)
         if (0 < pos) pos = bs_strappendf(name, sizeof(name), pos, " ");
         pos = bs_strappendf(name, sizeof(name), pos, "[%"PRIdMAX,
                             (intmax_t)client_ptr->pid);
-        char fname[PATH_MAX], cmdline[PATH_MAX];
-        snprintf(fname, sizeof(fname), "/proc/%"PRIdMAX"/cmdline",
-                 (intmax_t)client_ptr->pid);
-        ssize_t read_bytes = bs_file_read_buffer(
-            fname, cmdline, sizeof(cmdline));
-        if (0 < read_bytes) {
-            pos = bs_strappendf(name, sizeof(name), pos, ": %s", cmdline);
+        if ('\0' != client_ptr->cmdline[0]) {
+            pos = bs_strappendf(name, sizeof(name), pos, ": %s",
+                                client_ptr->cmdline);
         }
         pos = bs_strappendf(name, sizeof(name), pos, "]");
     }
@@ -384,6 +545,14 @@ const char *_wlmaker_task_list_window_name(wlmtk_window_t *window_ptr)
     return &name[0];
 }
 
+/* ------------------------------------------------------------------------- */
+/** @return Whether the window is omitted from the task list. */
+bool _wlmaker_task_list_skips(wlmtk_window_t *window_ptr)
+{
+    return (wlmtk_window_get_properties(window_ptr) &
+            WLMTK_WINDOW_PROPERTY_SKIP_TASK_LIST);
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Implements @ref wlmtk_panel_vmt_t::request_size.
@@ -479,17 +648,31 @@ void _wlmaker_task_list_handle_window_mapped(
 
 /* ------------------------------------------------------------------------- */
 /**
- * Handler for the `window_unmapped_listener`: Refreshes the list (if enabled).
+ * Handler for the `window_unmapped_listener`: Drops the window's row, and
+ * refreshes the list (if enabled).
  *
  * @param listener_ptr
- * @param data_ptr
+ * @param data_ptr            Points to the @ref wlmtk_window_t.
  */
 void _wlmaker_task_list_handle_window_unmapped(
     struct wl_listener *listener_ptr,
-    __UNUSED__ void *data_ptr)
+    void *data_ptr)
 {
     wlmaker_task_list_t *task_list_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmaker_task_list_t, window_unmapped_listener);
+    wlmtk_window_t *window_ptr = data_ptr;
+
+    for (bs_dllist_node_t *dlnode_ptr = task_list_ptr->rows.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_task_list_row_t *row_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_task_list_row_t, dlnode);
+        if (row_ptr->window_ptr == window_ptr) {
+            _wlmaker_task_list_row_destroy(task_list_ptr, row_ptr);
+            break;
+        }
+    }
+
     if (task_list_ptr->enabled) {
         _wlmaker_task_list_refresh(task_list_ptr);
     }
@@ -21,7 +21,9 @@
 #include "tl_menu.h"
 
 #include <libbase/libbase.h>
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <wayland-server-core.h>
 
@@ -48,6 +50,16 @@ struct _wlmaker_tl_menu_t {
 
     /** Listener for @ref wlmtk_window_events_t::state_changed. */
     struct wl_listener        window_state_changed_listener;
+    /** Listener for @ref wlmtk_menu_events_t::open_changed. */
+    struct wl_listener        menu_open_changed_listener;
+
+    /**
+     * Idle event source for releasing the items, once the menu closed.
+     *
+     * The items are only needed while the menu is open. Releasing them is
+     * deferred, since the menu may close from within an item's handler.
+     */
+    struct wl_event_source    *release_idle_ptr;
 
     /** Action item for 'Maximize'. */
     wlmaker_action_item_t     *maximize_ai_ptr;
@@ -73,6 +85,8 @@ typedef struct {
     /** Composed from a menu item. */
     wlmtk_menu_item_t         *menu_item_ptr;
 
+    /** Back-link to the toplevel's menu, holding `dlnode`. */
+    wlmaker_tl_menu_t         *tl_menu_ptr;
     /** Window to move. */
     wlmtk_window_t            *window_ptr;
     /** Workspace to move it to. */
@@ -85,6 +99,9 @@ typedef struct {
 
 } wlmaker_tl_menu_ws_item_t;
 
+static bool _wlmaker_tl_menu_populate(wlmaker_tl_menu_t *tl_menu_ptr);
+static void _wlmaker_tl_menu_release(wlmaker_tl_menu_t *tl_menu_ptr);
+static int _wlmaker_tl_menu_handle_release_idle(void *data_ptr);
 static void _wlmaker_tl_menu_workspace_iterator_create_item(
     bs_dllist_node_t *dlnode_ptr,
     void *ud_ptr);
@@ -94,6 +111,9 @@ static void _wlmaker_tl_menu_ws_items_iterator_enable_workspace(
 static void _wlmaker_tl_menu_handle_window_state_changed(
     struct wl_listener *listener_ptr,
     void *data_ptr);
+static void _wlmaker_tl_menu_handle_menu_open_changed(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
 
 static void _destroy(wlmaker_tl_menu_ws_item_t *ws_item_ptr);
 static void _item_handle_triggered(
@@ -169,6 +189,57 @@ wlmaker_tl_menu_t *wlmaker_tl_menu_create(
     tl_menu_ptr->menu_ptr = wlmtk_window_menu(window_ptr);
     tl_menu_ptr->window_ptr = window_ptr;
 
+    // The items are populated when the menu opens.
+    wlmtk_util_connect_listener_signal(
+        &wlmtk_menu_events(tl_menu_ptr->menu_ptr)->open_changed,
+        &tl_menu_ptr->menu_open_changed_listener,
+        _wlmaker_tl_menu_handle_menu_open_changed);
+    wlmtk_util_connect_listener_signal(
+        &wlmtk_window_events(window_ptr)->state_changed,
+        &tl_menu_ptr->window_state_changed_listener,
+        _wlmaker_tl_menu_handle_window_state_changed);
+
+    if (wlmtk_menu_is_open(tl_menu_ptr->menu_ptr) &&
+        !_wlmaker_tl_menu_populate(tl_menu_ptr)) {
+        wlmaker_tl_menu_destroy(tl_menu_ptr);
+        return NULL;
+    }
+    return tl_menu_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_tl_menu_destroy(wlmaker_tl_menu_t *tl_menu_ptr)
+{
+    if (NULL != tl_menu_ptr->release_idle_ptr) {
+        wl_event_source_remove(tl_menu_ptr->release_idle_ptr);
+        tl_menu_ptr->release_idle_ptr = NULL;
+    }
+
+    wlmtk_util_disconnect_listener(
+        &tl_menu_ptr->window_state_changed_listener);
+    wlmtk_util_disconnect_listener(
+        &tl_menu_ptr->menu_open_changed_listener);
+
+    _wlmaker_tl_menu_release(tl_menu_ptr);
+    free(tl_menu_ptr);
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates the menu items and the workspaces submenu, unless already present.
+ * Initializes their state from the window.
+ *
+ * @param tl_menu_ptr
+ *
+ * @return true on success.
+ */
+bool _wlmaker_tl_menu_populate(wlmaker_tl_menu_t *tl_menu_ptr)
+{
+    if (NULL != tl_menu_ptr->workspaces_submenu_ptr) return true;
+    wlmaker_server_t *server_ptr = tl_menu_ptr->server_ptr;
+
     for (const wlmaker_action_item_desc_t *desc_ptr = &_tl_menu_items[0];
          NULL != desc_ptr->text_ptr;
          ++desc_ptr) {
@@ -180,8 +251,8 @@ wlmaker_tl_menu_t *wlmaker_tl_menu_create(
             server_ptr);
         if (NULL == ai_ptr) {
             bs_log(BS_ERROR, "Failed wlmaker_action_item_create_from_desc()");
-            wlmaker_tl_menu_destroy(tl_menu_ptr);
-            return NULL;
+            _wlmaker_tl_menu_release(tl_menu_ptr);
+            return false;
         }
 
         wlmtk_menu_add_item(
@@ -192,8 +263,8 @@ wlmaker_tl_menu_t *wlmaker_tl_menu_create(
     tl_menu_ptr->workspaces_submenu_ptr = wlmtk_menu_create(
         &server_ptr->style.menu);
     if (NULL == tl_menu_ptr->workspaces_submenu_ptr) {
-        wlmaker_tl_menu_destroy(tl_menu_ptr);
-        return NULL;
+        _wlmaker_tl_menu_release(tl_menu_ptr);
+        return false;
     }
     wlmtk_menu_item_set_submenu(
         wlmaker_action_item_menu_item(tl_menu_ptr->move_to_ws_ai_ptr),
@@ -203,33 +274,56 @@ wlmaker_tl_menu_t *wlmaker_tl_menu_create(
         _wlmaker_tl_menu_workspace_iterator_create_item,
         tl_menu_ptr);
 
-    bs_dllist_for_each(
-        &tl_menu_ptr->submenu_items,
-        _wlmaker_tl_menu_ws_items_iterator_enable_workspace,
-        NULL);
-
-    // Connect state listener and initialize state.
-    wlmtk_util_connect_listener_signal(
-        &wlmtk_window_events(window_ptr)->state_changed,
-        &tl_menu_ptr->window_state_changed_listener,
-        _wlmaker_tl_menu_handle_window_state_changed);
     _wlmaker_tl_menu_handle_window_state_changed(
         &tl_menu_ptr->window_state_changed_listener,
-        window_ptr);
-
-    return tl_menu_ptr;
+        tl_menu_ptr->window_ptr);
+    return true;
 }
 
 /* ------------------------------------------------------------------------- */
-void wlmaker_tl_menu_destroy(wlmaker_tl_menu_t *tl_menu_ptr)
+/**
+ * Removes and destroys the menu items. The workspaces submenu and its items
+ * are destroyed along with the 'Move to workspace' item.
+ *
+ * @param tl_menu_ptr
+ */
+void _wlmaker_tl_menu_release(wlmaker_tl_menu_t *tl_menu_ptr)
 {
-    wlmtk_util_disconnect_listener(
-        &tl_menu_ptr->window_state_changed_listener);
+    for (const wlmaker_action_item_desc_t *desc_ptr = &_tl_menu_items[0];
+         NULL != desc_ptr->text_ptr;
+         ++desc_ptr) {
+        wlmaker_action_item_t **ai_ptr_ptr = (wlmaker_action_item_t**)(
+            (uint8_t*)tl_menu_ptr + desc_ptr->destination_ofs);
+        if (NULL == *ai_ptr_ptr) continue;
 
-    free(tl_menu_ptr);
+        wlmtk_menu_remove_item(
+            tl_menu_ptr->menu_ptr,
+            wlmaker_action_item_menu_item(*ai_ptr_ptr));
+        wlmaker_action_item_destroy(*ai_ptr_ptr);
+        *ai_ptr_ptr = NULL;
+    }
+    tl_menu_ptr->workspaces_submenu_ptr = NULL;
+    BS_ASSERT(bs_dllist_empty(&tl_menu_ptr->submenu_items));
 }
 
-/* == Local (static) methods =============================================== */
+/* ------------------------------------------------------------------------- */
+/**
+ * Idle handler: Releases the items, if the menu is still closed.
+ *
+ * @param data_ptr            Points to the @ref wlmaker_tl_menu_t.
+ *
+ * @return 0.
+ */
+int _wlmaker_tl_menu_handle_release_idle(void *data_ptr)
+{
+    wlmaker_tl_menu_t *tl_menu_ptr = data_ptr;
+    tl_menu_ptr->release_idle_ptr = NULL;
+
+    if (!wlmtk_menu_is_open(tl_menu_ptr->menu_ptr)) {
+        _wlmaker_tl_menu_release(tl_menu_ptr);
+    }
+    return 0;
+}
 
 /* ------------------------------------------------------------------------- */
 /** Handles state changes: Updates the menu items accordingly. */
@@ -241,6 +335,9 @@ void _wlmaker_tl_menu_handle_window_state_changed(
         listener_ptr, wlmaker_tl_menu_t, window_state_changed_listener);
     wlmtk_window_t *window_ptr = data_ptr;
 
+    // Nothing to update while the items are not populated.
+    if (NULL == tl_menu_ptr->workspaces_submenu_ptr) return;
+
     wlmtk_menu_item_set_enabled(
         wlmaker_action_item_menu_item(tl_menu_ptr->shade_ai_ptr),
         !wlmtk_window_is_shaded(window_ptr));
@@ -267,6 +364,38 @@ void _wlmaker_tl_menu_handle_window_state_changed(
 
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles @ref wlmtk_menu_events_t::open_changed: Populates the items when
+ * the menu opens, and schedules their release when it closes.
+ */
+void _wlmaker_tl_menu_handle_menu_open_changed(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmaker_tl_menu_t *tl_menu_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_tl_menu_t, menu_open_changed_listener);
+
+    if (wlmtk_menu_is_open(tl_menu_ptr->menu_ptr)) {
+        if (NULL != tl_menu_ptr->release_idle_ptr) {
+            wl_event_source_remove(tl_menu_ptr->release_idle_ptr);
+            tl_menu_ptr->release_idle_ptr = NULL;
+        }
+        _wlmaker_tl_menu_populate(tl_menu_ptr);
+        return;
+    }
+
+    if (NULL != tl_menu_ptr->release_idle_ptr ||
+        NULL == tl_menu_ptr->workspaces_submenu_ptr) return;
+    tl_menu_ptr->release_idle_ptr = wl_event_loop_add_idle(
+        wl_display_get_event_loop(tl_menu_ptr->server_ptr->wl_display_ptr),
+        _wlmaker_tl_menu_handle_release_idle,
+        tl_menu_ptr);
+    if (NULL == tl_menu_ptr->release_idle_ptr) {
+        bs_log(BS_WARNING, "Failed wl_event_loop_add_idle(), keeping items");
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 /** Destroys the item holder. */
 void _destroy(wlmaker_tl_menu_ws_item_t *ws_item_ptr)
@@ -294,6 +423,7 @@ void _wlmaker_tl_menu_workspace_iterator_create_item(
     wlmaker_tl_menu_ws_item_t *ws_item_ptr = logged_calloc(
         1, sizeof(wlmaker_tl_menu_ws_item_t));
     if (NULL == ws_item_ptr) return;
+    ws_item_ptr->tl_menu_ptr = tl_menu_ptr;
     ws_item_ptr->workspace_ptr = workspace_ptr;
     ws_item_ptr->window_ptr = tl_menu_ptr->window_ptr;
 
@@ -362,6 +492,8 @@ void _item_handle_destroy(
     wlmaker_tl_menu_ws_item_t *ws_item_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmaker_tl_menu_ws_item_t, destroy_listener);
 
+    bs_dllist_remove(&ws_item_ptr->tl_menu_ptr->submenu_items,
+                     &ws_item_ptr->dlnode);
     ws_item_ptr->menu_item_ptr = NULL;
     _destroy(ws_item_ptr);
 }
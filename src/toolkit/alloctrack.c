@@ -0,0 +1,591 @@
+/* ========================================================================= */
+/**
+ * @file alloctrack.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "alloctrack.h"
+
+#include <execinfo.h>
+#include <libbase/libbase.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* == Declarations ========================================================= */
+
+/** Capacity of the site table. Sites beyond 3/4 of it are merged. */
+#define WLMTK_ALLOCTRACK_SITES 4096
+
+/** Initial capacity of the allocation table, as a power of two. */
+#define WLMTK_ALLOCTRACK_INITIAL_BITS 12
+
+/** A recorded allocation. */
+typedef struct {
+    /** Address of the allocation. NULL if the slot is free. */
+    const void                *ptr;
+    /** Size of the allocation, in bytes. */
+    size_t                    size;
+    /** The site that made the allocation. */
+    wlmtk_alloctrack_site_t   *site_ptr;
+} wlmtk_alloctrack_entry_t;
+
+/** State of the tracker. */
+typedef struct {
+    /** Guards all of the below. Allocations may happen on any thread. */
+    pthread_mutex_t           mutex;
+
+    /** Open-addressed table of the live allocations, by address. */
+    wlmtk_alloctrack_entry_t  *entries_ptr;
+    /** Capacity of `entries_ptr`, as a power of two. */
+    unsigned                  entries_bits;
+    /** Number of live allocations in `entries_ptr`. */
+    size_t                    entries;
+    /** Sum of the live allocations' sizes, in bytes. */
+    size_t                    bytes;
+
+    /** Open-addressed table of the sites, by name and call site. */
+    wlmtk_alloctrack_site_t   *sites_ptr;
+    /** Number of slots used in `sites_ptr`. */
+    size_t                    sites;
+    /** Site for all allocations, once the site table is filled. */
+    wlmtk_alloctrack_site_t   overflow_site;
+} wlmtk_alloctrack_t;
+
+static void *_wlmtk_alloctrack_calloc(size_t nmemb, size_t size);
+static void _wlmtk_alloctrack_free(void *ptr);
+static size_t _wlmtk_alloctrack_hash(const void *ptr, unsigned bits);
+static wlmtk_alloctrack_site_t *_wlmtk_alloctrack_site(
+    wlmtk_alloctrack_t *tracker_ptr,
+    const char *name_ptr,
+    const void *site_ptr);
+static bool _wlmtk_alloctrack_grow(wlmtk_alloctrack_t *tracker_ptr);
+static void _wlmtk_alloctrack_insert(
+    wlmtk_alloctrack_entry_t *entries_ptr,
+    unsigned bits,
+    const wlmtk_alloctrack_entry_t *entry_ptr);
+static int _wlmtk_alloctrack_site_compare(
+    const void *a_ptr,
+    const void *b_ptr);
+
+#if defined(WLMTK_ALLOC_TRACK)
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+void *__wrap_malloc(size_t size);
+void *__wrap_calloc(size_t nmemb, size_t size);
+void *__wrap_realloc(void *ptr, size_t size);
+void __wrap_free(void *ptr);
+static void _wlmtk_alloctrack_register_atfork(void)
+    __attribute__((constructor));
+static void _wlmtk_alloctrack_lock(void);
+static void _wlmtk_alloctrack_unlock(void);
+#endif  // defined(WLMTK_ALLOC_TRACK)
+
+/* == Data ================================================================= */
+
+/** The tracker. */
+static wlmtk_alloctrack_t     _wlmtk_alloctrack = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .overflow_site = { .name_ptr = "overflow" }
+};
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_alloctrack_record(
+    const void *ptr,
+    size_t size,
+    const char *name_ptr,
+    const void *site_ptr)
+{
+    wlmtk_alloctrack_t *tracker_ptr = &_wlmtk_alloctrack;
+    if (NULL == ptr) return;
+
+    pthread_mutex_lock(&tracker_ptr->mutex);
+    wlmtk_alloctrack_site_t *s_ptr = _wlmtk_alloctrack_site(
+        tracker_ptr, name_ptr, site_ptr);
+    if (NULL != s_ptr && _wlmtk_alloctrack_grow(tracker_ptr)) {
+        wlmtk_alloctrack_entry_t entry = {
+            .ptr = ptr, .size = size, .site_ptr = s_ptr };
+        _wlmtk_alloctrack_insert(
+            tracker_ptr->entries_ptr, tracker_ptr->entries_bits, &entry);
+        tracker_ptr->entries++;
+        tracker_ptr->bytes += size;
+        s_ptr->allocations++;
+        s_ptr->bytes += size;
+    }
+    pthread_mutex_unlock(&tracker_ptr->mutex);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_alloctrack_release(const void *ptr)
+{
+    wlmtk_alloctrack_t *tracker_ptr = &_wlmtk_alloctrack;
+    if (NULL == ptr) return;
+
+    pthread_mutex_lock(&tracker_ptr->mutex);
+    if (NULL == tracker_ptr->entries_ptr) {
+        pthread_mutex_unlock(&tracker_ptr->mutex);
+        return;
+    }
+
+    wlmtk_alloctrack_entry_t *entries_ptr = tracker_ptr->entries_ptr;
+    size_t mask = ((size_t)1 << tracker_ptr->entries_bits) - 1;
+    size_t i = _wlmtk_alloctrack_hash(ptr, tracker_ptr->entries_bits);
+    for (; NULL != entries_ptr[i].ptr; i = (i + 1) & mask) {
+        if (ptr == entries_ptr[i].ptr) break;
+    }
+    if (NULL != entries_ptr[i].ptr) {
+        wlmtk_alloctrack_site_t *s_ptr = entries_ptr[i].site_ptr;
+        s_ptr->allocations--;
+        s_ptr->bytes -= entries_ptr[i].size;
+        tracker_ptr->entries--;
+        tracker_ptr->bytes -= entries_ptr[i].size;
+
+        // Backward-shift deletion: Moves up entries of the probe sequence,
+        // so that lookups never need to skip over tombstones.
+        for (size_t j = (i + 1) & mask;
+             NULL != entries_ptr[j].ptr;
+             j = (j + 1) & mask) {
+            size_t k = _wlmtk_alloctrack_hash(
+                entries_ptr[j].ptr, tracker_ptr->entries_bits);
+            bool in_place = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+            if (in_place) continue;
+            entries_ptr[i] = entries_ptr[j];
+            i = j;
+        }
+        entries_ptr[i] = (wlmtk_alloctrack_entry_t){};
+    }
+    pthread_mutex_unlock(&tracker_ptr->mutex);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_alloctrack_get_totals(size_t *allocations_ptr, size_t *bytes_ptr)
+{
+    wlmtk_alloctrack_t *tracker_ptr = &_wlmtk_alloctrack;
+    pthread_mutex_lock(&tracker_ptr->mutex);
+    *allocations_ptr = tracker_ptr->entries;
+    *bytes_ptr = tracker_ptr->bytes;
+    pthread_mutex_unlock(&tracker_ptr->mutex);
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_alloctrack_get_sites(
+    wlmtk_alloctrack_site_t *sites_ptr,
+    size_t max_sites)
+{
+    wlmtk_alloctrack_t *tracker_ptr = &_wlmtk_alloctrack;
+
+    // Copies the sites first: Sorting may allocate, and must not hold the
+    // lock for a wrapped allocation.
+    size_t all = 0;
+    wlmtk_alloctrack_site_t *all_ptr = _wlmtk_alloctrack_calloc(
+        WLMTK_ALLOCTRACK_SITES + 1, sizeof(wlmtk_alloctrack_site_t));
+    if (NULL == all_ptr) return 0;
+    pthread_mutex_lock(&tracker_ptr->mutex);
+    for (size_t i = 0;
+         NULL != tracker_ptr->sites_ptr && i < WLMTK_ALLOCTRACK_SITES;
+         ++i) {
+        if (0 < tracker_ptr->sites_ptr[i].allocations) {
+            all_ptr[all++] = tracker_ptr->sites_ptr[i];
+        }
+    }
+    if (0 < tracker_ptr->overflow_site.allocations) {
+        all_ptr[all++] = tracker_ptr->overflow_site;
+    }
+    pthread_mutex_unlock(&tracker_ptr->mutex);
+
+    qsort(all_ptr, all, sizeof(wlmtk_alloctrack_site_t),
+          _wlmtk_alloctrack_site_compare);
+    memcpy(sites_ptr, all_ptr,
+           BS_MIN(all, max_sites) * sizeof(wlmtk_alloctrack_site_t));
+    _wlmtk_alloctrack_free(all_ptr);
+    return all;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_alloctrack_write(FILE *file_ptr)
+{
+    wlmtk_alloctrack_site_t *sites_ptr = _wlmtk_alloctrack_calloc(
+        WLMTK_ALLOCTRACK_SITES + 1, sizeof(wlmtk_alloctrack_site_t));
+    if (NULL == sites_ptr) return false;
+    size_t sites = wlmtk_alloctrack_get_sites(
+        sites_ptr, WLMTK_ALLOCTRACK_SITES + 1);
+
+    size_t allocations, bytes;
+    wlmtk_alloctrack_get_totals(&allocations, &bytes);
+    fprintf(file_ptr, "# %zu bytes in %zu live allocations, %zu sites\n",
+            bytes, allocations, sites);
+
+    // Symbolized all at once, as backtrace_symbols() allocates the result.
+    void **addrs_ptr = _wlmtk_alloctrack_calloc(
+        BS_MAX(sites, 1), sizeof(void*));
+    char **symbols_ptr = NULL;
+    if (NULL != addrs_ptr) {
+        for (size_t i = 0; i < sites; ++i) {
+            addrs_ptr[i] = (void*)sites_ptr[i].site_ptr;
+        }
+        if (0 < sites) symbols_ptr = backtrace_symbols(addrs_ptr, sites);
+    }
+
+    for (size_t i = 0; i < sites; ++i) {
+        fprintf(file_ptr, "%zu\t%zu\t%s\t%s\n",
+                sites_ptr[i].bytes,
+                sites_ptr[i].allocations,
+                sites_ptr[i].name_ptr,
+                NULL != symbols_ptr ? symbols_ptr[i] : "?");
+    }
+    free(symbols_ptr);
+    _wlmtk_alloctrack_free(addrs_ptr);
+    _wlmtk_alloctrack_free(sites_ptr);
+    fflush(file_ptr);
+    return !ferror(file_ptr);
+}
+
+#if defined(WLMTK_ALLOC_TRACK)
+/* ------------------------------------------------------------------------- */
+/** Wraps `malloc`, see `-Wl,--wrap=malloc`. */
+void *__wrap_malloc(size_t size)
+{
+    void *ptr = __real_malloc(size);
+    wlmtk_alloctrack_record(ptr, size, "heap", __builtin_return_address(0));
+    return ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Wraps `calloc`, and thus `logged_calloc`. See `-Wl,--wrap=calloc`. */
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+    void *ptr = __real_calloc(nmemb, size);
+    wlmtk_alloctrack_record(
+        ptr, nmemb * size, "heap", __builtin_return_address(0));
+    return ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Wraps `realloc`, see `-Wl,--wrap=realloc`. */
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    // Released first: Once freed, another thread may be handed `ptr`.
+    wlmtk_alloctrack_release(ptr);
+    void *new_ptr = __real_realloc(ptr, size);
+    if (NULL == new_ptr && 0 < size) {
+        // Failed, `ptr` is still allocated: Re-recorded, size unknown.
+        wlmtk_alloctrack_record(
+            ptr, 0, "heap", __builtin_return_address(0));
+        return NULL;
+    }
+    wlmtk_alloctrack_record(
+        new_ptr, size, "heap", __builtin_return_address(0));
+    return new_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Wraps `free`, see `-Wl,--wrap=free`. */
+void __wrap_free(void *ptr)
+{
+    wlmtk_alloctrack_release(ptr);
+    __real_free(ptr);
+}
+#endif  // defined(WLMTK_ALLOC_TRACK)
+
+/* == Local (static) methods =============================================== */
+
+#if defined(WLMTK_ALLOC_TRACK)
+/* ------------------------------------------------------------------------- */
+/**
+ * Holds the lock across fork(), so a child allocating before exec() does
+ * not find it held by a thread that no longer exists.
+ */
+void _wlmtk_alloctrack_register_atfork(void)
+{
+    pthread_atfork(_wlmtk_alloctrack_lock,
+                   _wlmtk_alloctrack_unlock,
+                   _wlmtk_alloctrack_unlock);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Locks the tracker, before fork(). */
+void _wlmtk_alloctrack_lock(void)
+{
+    pthread_mutex_lock(&_wlmtk_alloctrack.mutex);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Unlocks the tracker, after fork(), in parent and child. */
+void _wlmtk_alloctrack_unlock(void)
+{
+    pthread_mutex_unlock(&_wlmtk_alloctrack.mutex);
+}
+#endif  // defined(WLMTK_ALLOC_TRACK)
+
+/* ------------------------------------------------------------------------- */
+/** Allocates the tracker's own memory. Bypasses the wrappers. */
+void *_wlmtk_alloctrack_calloc(size_t nmemb, size_t size)
+{
+#if defined(WLMTK_ALLOC_TRACK)
+    return __real_calloc(nmemb, size);
+#else  // defined(WLMTK_ALLOC_TRACK)
+    return calloc(nmemb, size);
+#endif  // defined(WLMTK_ALLOC_TRACK)
+}
+
+/* ------------------------------------------------------------------------- */
+/** Frees memory from @ref _wlmtk_alloctrack_calloc. */
+void _wlmtk_alloctrack_free(void *ptr)
+{
+#if defined(WLMTK_ALLOC_TRACK)
+    __real_free(ptr);
+#else  // defined(WLMTK_ALLOC_TRACK)
+    free(ptr);
+#endif  // defined(WLMTK_ALLOC_TRACK)
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Slot for `ptr` in a table of 2^`bits` slots. */
+size_t _wlmtk_alloctrack_hash(const void *ptr, unsigned bits)
+{
+    // Fibonacci hashing: Takes the well-mixed upper bits.
+    return (size_t)(((uint64_t)(uintptr_t)ptr * UINT64_C(0x9e3779b97f4a7c15))
+                    >> (64 - bits));
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Looks up the site for `name_ptr` and `site_ptr`, and adds it if not found.
+ * Once the table is filled to 3/4, new sites share the overflow site.
+ *
+ * @param tracker_ptr
+ * @param name_ptr
+ * @param site_ptr
+ *
+ * @return Pointer to the site, or NULL on error. Sites are never removed,
+ *     so the pointer remains valid.
+ */
+wlmtk_alloctrack_site_t *_wlmtk_alloctrack_site(
+    wlmtk_alloctrack_t *tracker_ptr,
+    const char *name_ptr,
+    const void *site_ptr)
+{
+    if (NULL == tracker_ptr->sites_ptr) {
+        tracker_ptr->sites_ptr = _wlmtk_alloctrack_calloc(
+            WLMTK_ALLOCTRACK_SITES, sizeof(wlmtk_alloctrack_site_t));
+        if (NULL == tracker_ptr->sites_ptr) return NULL;
+    }
+
+    size_t i = ((size_t)(uintptr_t)site_ptr ^ (size_t)(uintptr_t)name_ptr) %
+        WLMTK_ALLOCTRACK_SITES;
+    for (;; i = (i + 1) % WLMTK_ALLOCTRACK_SITES) {
+        wlmtk_alloctrack_site_t *s_ptr = &tracker_ptr->sites_ptr[i];
+        if (site_ptr == s_ptr->site_ptr && name_ptr == s_ptr->name_ptr) {
+            return s_ptr;
+        }
+        if (NULL != s_ptr->name_ptr) continue;
+
+        if (tracker_ptr->sites >= WLMTK_ALLOCTRACK_SITES * 3 / 4) {
+            return &tracker_ptr->overflow_site;
+        }
+        s_ptr->name_ptr = name_ptr;
+        s_ptr->site_ptr = site_ptr;
+        tracker_ptr->sites++;
+        return s_ptr;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Ensures the allocation table has room for one more entry, keeping the
+ * load at or below 1/2.
+ *
+ * @param tracker_ptr
+ *
+ * @return true if there is room.
+ */
+bool _wlmtk_alloctrack_grow(wlmtk_alloctrack_t *tracker_ptr)
+{
+    size_t capacity = (size_t)1 << tracker_ptr->entries_bits;
+    if (NULL != tracker_ptr->entries_ptr &&
+        (tracker_ptr->entries + 1) * 2 <= capacity) return true;
+
+    unsigned bits = BS_MAX((unsigned)WLMTK_ALLOCTRACK_INITIAL_BITS,
+                           tracker_ptr->entries_bits + 1);
+    wlmtk_alloctrack_entry_t *entries_ptr = _wlmtk_alloctrack_calloc(
+        (size_t)1 << bits, sizeof(wlmtk_alloctrack_entry_t));
+    if (NULL == entries_ptr) return false;
+
+    for (size_t i = 0;
+         NULL != tracker_ptr->entries_ptr && i < capacity;
+         ++i) {
+        if (NULL == tracker_ptr->entries_ptr[i].ptr) continue;
+        _wlmtk_alloctrack_insert(
+            entries_ptr, bits, &tracker_ptr->entries_ptr[i]);
+    }
+    _wlmtk_alloctrack_free(tracker_ptr->entries_ptr);
+    tracker_ptr->entries_ptr = entries_ptr;
+    tracker_ptr->entries_bits = bits;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Inserts `entry_ptr` into the table, which must have a free slot. */
+void _wlmtk_alloctrack_insert(
+    wlmtk_alloctrack_entry_t *entries_ptr,
+    unsigned bits,
+    const wlmtk_alloctrack_entry_t *entry_ptr)
+{
+    size_t mask = ((size_t)1 << bits) - 1;
+    size_t i = _wlmtk_alloctrack_hash(entry_ptr->ptr, bits);
+    while (NULL != entries_ptr[i].ptr) i = (i + 1) & mask;
+    entries_ptr[i] = *entry_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** qsort() comparator: Orders sites by decreasing bytes. */
+int _wlmtk_alloctrack_site_compare(
+    const void *a_ptr,
+    const void *b_ptr)
+{
+    const wlmtk_alloctrack_site_t *a = a_ptr, *b = b_ptr;
+    if (a->bytes != b->bytes) return a->bytes < b->bytes ? 1 : -1;
+    if (a->allocations != b->allocations) {
+        return a->allocations < b->allocations ? 1 : -1;
+    }
+    return 0;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_record_release(bs_test_t *test_ptr);
+static void test_grow(bs_test_t *test_ptr);
+static void test_write(bs_test_t *test_ptr);
+static size_t _wlmtk_alloctrack_test_find(
+    const wlmtk_alloctrack_site_t *sites_ptr,
+    size_t sites,
+    const void *site_ptr);
+
+const bs_test_case_t wlmtk_alloctrack_test_cases[] = {
+    { 1, "record_release", test_record_release },
+    { 1, "grow", test_grow },
+    { 1, "write", test_write },
+    { 0, NULL, NULL }
+};
+
+/** Storage providing distinct addresses for the tests' allocations. */
+static uint8_t                _wlmtk_alloctrack_test_storage[10000];
+
+/* ------------------------------------------------------------------------- */
+/** Returns the index of `site_ptr` in `sites_ptr`, or `sites`. */
+size_t _wlmtk_alloctrack_test_find(
+    const wlmtk_alloctrack_site_t *sites_ptr,
+    size_t sites,
+    const void *site_ptr)
+{
+    size_t i = 0;
+    while (i < sites && site_ptr != sites_ptr[i].site_ptr) ++i;
+    return i;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Allocations are grouped by site, and sites ordered by size. */
+void test_record_release(bs_test_t *test_ptr)
+{
+    uint8_t *s = _wlmtk_alloctrack_test_storage;
+    const void *site_a_ptr = &s[1], *site_b_ptr = &s[2];
+    static wlmtk_alloctrack_site_t sites[WLMTK_ALLOCTRACK_SITES + 1];
+    size_t max_sites = sizeof(sites) / sizeof(sites[0]);
+
+    wlmtk_alloctrack_record(&s[10], 100, "test", site_a_ptr);
+    wlmtk_alloctrack_record(&s[20], 50, "test", site_a_ptr);
+    wlmtk_alloctrack_record(&s[30], 500, "test", site_b_ptr);
+    wlmtk_alloctrack_release(&s[40]);
+    size_t n = wlmtk_alloctrack_get_sites(sites, max_sites);
+    size_t a = _wlmtk_alloctrack_test_find(sites, n, site_a_ptr);
+    size_t b = _wlmtk_alloctrack_test_find(sites, n, site_b_ptr);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, a < n && b < n);
+    BS_TEST_VERIFY_TRUE(test_ptr, b < a);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, sites[a].allocations);
+    BS_TEST_VERIFY_EQ(test_ptr, 150, sites[a].bytes);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, sites[b].allocations);
+    BS_TEST_VERIFY_EQ(test_ptr, 500, sites[b].bytes);
+
+    wlmtk_alloctrack_release(&s[30]);
+    wlmtk_alloctrack_release(&s[10]);
+    n = wlmtk_alloctrack_get_sites(sites, max_sites);
+    a = _wlmtk_alloctrack_test_find(sites, n, site_a_ptr);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, a < n);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, sites[a].allocations);
+    BS_TEST_VERIFY_EQ(test_ptr, 50, sites[a].bytes);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, n, _wlmtk_alloctrack_test_find(sites, n, site_b_ptr));
+
+    wlmtk_alloctrack_release(&s[20]);
+    n = wlmtk_alloctrack_get_sites(sites, max_sites);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, n, _wlmtk_alloctrack_test_find(sites, n, site_a_ptr));
+}
+
+/* ------------------------------------------------------------------------- */
+/** The table grows, and entries remain found after deletions. */
+void test_grow(bs_test_t *test_ptr)
+{
+    uint8_t *s = _wlmtk_alloctrack_test_storage;
+    size_t allocations, bytes;
+    wlmtk_alloctrack_get_totals(&allocations, &bytes);
+
+    for (size_t i = 0; i < sizeof(_wlmtk_alloctrack_test_storage); ++i) {
+        wlmtk_alloctrack_record(&s[i], 1, "test", &s[3]);
+    }
+    size_t live_allocations, live_bytes;
+    wlmtk_alloctrack_get_totals(&live_allocations, &live_bytes);
+    BS_TEST_VERIFY_TRUE(test_ptr, allocations + 10000 <= live_allocations);
+    for (size_t i = 0; i < sizeof(_wlmtk_alloctrack_test_storage); i += 2) {
+        wlmtk_alloctrack_release(&s[i]);
+    }
+    for (size_t i = 1; i < sizeof(_wlmtk_alloctrack_test_storage); i += 2) {
+        wlmtk_alloctrack_release(&s[i]);
+    }
+    wlmtk_alloctrack_get_totals(&live_allocations, &live_bytes);
+    BS_TEST_VERIFY_EQ(test_ptr, allocations, live_allocations);
+    BS_TEST_VERIFY_EQ(test_ptr, bytes, live_bytes);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Writes one line per site, with the allocator's name. */
+void test_write(bs_test_t *test_ptr)
+{
+    uint8_t *s = _wlmtk_alloctrack_test_storage;
+    wlmtk_alloctrack_record(&s[0], 4242, "test_write", &s[4]);
+
+    char *buf_ptr = NULL;
+    size_t size = 0;
+    FILE *file_ptr = open_memstream(&buf_ptr, &size);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, file_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_alloctrack_write(file_ptr));
+    fclose(file_ptr);
+    wlmtk_alloctrack_release(&s[0]);
+
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, buf_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, '#', buf_ptr[0]);
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL, strstr(buf_ptr, "\n4242\t1\ttest_write\t"));
+    free(buf_ptr);
+}
+
+/* == End of alloctrack.c ================================================== */
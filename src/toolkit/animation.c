@@ -0,0 +1,674 @@
+/* ========================================================================= */
+/**
+ * @file animation.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "animation.h"
+
+#include <libbase/libbase.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wayland-server-core.h>
+#define WLR_USE_UNSTABLE
+#include <wlr/types/wlr_buffer.h>
+#include <wlr/types/wlr_scene.h>
+#include <wlr/util/box.h>
+#undef WLR_USE_UNSTABLE
+
+#include "buffer.h"
+#include "container.h"
+#include "gfxbuf.h"
+#include "util.h"
+
+/* == Declarations ========================================================= */
+
+/** A buffer of the snapshot. */
+typedef struct {
+    /** The scene buffer, holding a lock on the snapshotted `wlr_buffer`. */
+    struct wlr_scene_buffer   *wlr_scene_buffer_ptr;
+    /** Position relative to the snapshotted element. */
+    int                       x;
+    /** Position relative to the snapshotted element. */
+    int                       y;
+    /** Width, as shown by the snapshotted scene buffer. */
+    int                       width;
+    /** Height, as shown by the snapshotted scene buffer. */
+    int                       height;
+    /** Source box, as of the snapshotted scene buffer. */
+    struct wlr_fbox           src_box;
+} wlmtk_animation_buffer_t;
+
+/** State of an animation. */
+typedef struct {
+    /** Node within @ref _wlmtk_animation_state_t::animations. */
+    bs_dllist_node_t          dlnode;
+    /** The tree holding the snapshot's buffers. NULL when translating. */
+    struct wlr_scene_tree     *wlr_scene_tree_ptr;
+    /** The element's own node, when translating it. Not owned. */
+    struct wlr_scene_node     *translated_node_ptr;
+    /** Listener for the `destroy` signal of the tree's or element's node. */
+    struct wl_listener        destroy_listener;
+
+    /**
+     * Position of the snapshotted element's node. When translating, the
+     * element's position, which the node is returned to at the end.
+     */
+    int                       x;
+    /** Vertical position, see @ref wlmtk_animation_t::x. */
+    int                       y;
+    /** Height of the snapshot: The lowest edge of any buffer. */
+    int                       height;
+    /** Buffers of the snapshot. */
+    wlmtk_animation_buffer_t  *buffers_ptr;
+    /** Number of buffers in @ref wlmtk_animation_t::buffers_ptr. */
+    size_t                    buffers;
+    /** Capacity of @ref wlmtk_animation_t::buffers_ptr. */
+    size_t                    capacity;
+
+    /** Properties at the start. */
+    wlmtk_animation_props_t   from;
+    /** Properties at the end. */
+    wlmtk_animation_props_t   to;
+    /** Duration of the animation. */
+    uint64_t                  duration_msec;
+    /** Time when the animation started. Set on the first tick. */
+    uint64_t                  start_msec;
+    /** Whether @ref wlmtk_animation_t::start_msec is set. */
+    bool                      started;
+} wlmtk_animation_t;
+
+/** Global state of animations. */
+typedef struct {
+    /** Whether animations are enabled. */
+    bool                      enabled;
+    /** Running animations, holding @ref wlmtk_animation_t::dlnode. */
+    bs_dllist_t               animations;
+    /** Time of the most recent tick. */
+    uint64_t                  last_tick_msec;
+    /** New animations are skipped until then, after exceeding the budget. */
+    uint64_t                  suspended_until_msec;
+} _wlmtk_animation_state_t;
+
+static void _wlmtk_animation_add_buffer(
+    struct wlr_scene_buffer *wlr_scene_buffer_ptr,
+    int sx,
+    int sy,
+    void *ud_ptr);
+static void _wlmtk_animation_destroy(wlmtk_animation_t *animation_ptr);
+static void _wlmtk_animation_handle_destroy(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmtk_animation_apply(
+    wlmtk_animation_t *animation_ptr,
+    double progress);
+static double _wlmtk_animation_progress(
+    wlmtk_animation_t *animation_ptr,
+    uint64_t now_msec);
+static void _wlmtk_animation_finish_all(void);
+
+/* == Data ================================================================= */
+
+const wlmtk_animation_props_t wlmtk_animation_props_identity = {
+    .x = 0, .y = 0, .scale = 1.0, .opacity = 1.0f, .clip = 1.0
+};
+
+/** Global state. */
+static _wlmtk_animation_state_t _wlmtk_animation_state;
+
+/** For how long new animations are skipped, after exceeding the budget. */
+static const uint64_t _wlmtk_animation_suspend_msec = 1000;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_animation_set_enabled(bool enabled)
+{
+    _wlmtk_animation_state.enabled = enabled;
+    if (!enabled) _wlmtk_animation_finish_all();
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_animation_snapshot(
+    wlmtk_element_t *element_ptr,
+    const wlmtk_animation_props_t *from_ptr,
+    const wlmtk_animation_props_t *to_ptr,
+    uint64_t duration_msec)
+{
+    _wlmtk_animation_state_t *state_ptr = &_wlmtk_animation_state;
+    if (!state_ptr->enabled ||
+        state_ptr->last_tick_msec < state_ptr->suspended_until_msec ||
+        0 == duration_msec) return false;
+    struct wlr_scene_node *wlr_scene_node_ptr =
+        element_ptr->wlr_scene_node_ptr;
+    if (NULL == wlr_scene_node_ptr ||
+        NULL == wlr_scene_node_ptr->parent ||
+        !wlr_scene_node_ptr->enabled) return false;
+
+    wlmtk_animation_t *animation_ptr = logged_calloc(
+        1, sizeof(wlmtk_animation_t));
+    if (NULL == animation_ptr) return false;
+    animation_ptr->x = wlr_scene_node_ptr->x;
+    animation_ptr->y = wlr_scene_node_ptr->y;
+    animation_ptr->from = *from_ptr;
+    animation_ptr->to = *to_ptr;
+    animation_ptr->duration_msec = duration_msec;
+
+    animation_ptr->wlr_scene_tree_ptr = wlr_scene_tree_create(
+        wlr_scene_node_ptr->parent);
+    if (NULL == animation_ptr->wlr_scene_tree_ptr) {
+        free(animation_ptr);
+        return false;
+    }
+    wlmtk_util_connect_listener_signal(
+        &animation_ptr->wlr_scene_tree_ptr->node.events.destroy,
+        &animation_ptr->destroy_listener,
+        _wlmtk_animation_handle_destroy);
+    bs_dllist_push_back(&state_ptr->animations, &animation_ptr->dlnode);
+
+    // Iterates the enabled buffers, at positions including the node's own.
+    wlr_scene_node_for_each_buffer(
+        wlr_scene_node_ptr, _wlmtk_animation_add_buffer, animation_ptr);
+    if (0 == animation_ptr->buffers) {
+        _wlmtk_animation_destroy(animation_ptr);
+        return false;
+    }
+    wlr_scene_node_place_above(
+        &animation_ptr->wlr_scene_tree_ptr->node, wlr_scene_node_ptr);
+    _wlmtk_animation_apply(animation_ptr, 0);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_animation_translate(
+    wlmtk_element_t *element_ptr,
+    int from_x,
+    int from_y,
+    uint64_t duration_msec)
+{
+    _wlmtk_animation_state_t *state_ptr = &_wlmtk_animation_state;
+    wlmtk_animation_cancel(element_ptr);
+    struct wlr_scene_node *wlr_scene_node_ptr =
+        element_ptr->wlr_scene_node_ptr;
+    if (NULL == wlr_scene_node_ptr) return false;
+    if (!state_ptr->enabled ||
+        state_ptr->last_tick_msec < state_ptr->suspended_until_msec ||
+        0 == duration_msec) {
+        wlr_scene_node_set_position(
+            wlr_scene_node_ptr, element_ptr->x, element_ptr->y);
+        return false;
+    }
+
+    wlmtk_animation_t *animation_ptr = logged_calloc(
+        1, sizeof(wlmtk_animation_t));
+    if (NULL == animation_ptr) {
+        wlr_scene_node_set_position(
+            wlr_scene_node_ptr, element_ptr->x, element_ptr->y);
+        return false;
+    }
+    animation_ptr->translated_node_ptr = wlr_scene_node_ptr;
+    animation_ptr->x = element_ptr->x;
+    animation_ptr->y = element_ptr->y;
+    animation_ptr->from = wlmtk_animation_props_identity;
+    animation_ptr->from.x = from_x;
+    animation_ptr->from.y = from_y;
+    animation_ptr->to = wlmtk_animation_props_identity;
+    animation_ptr->duration_msec = duration_msec;
+    wlmtk_util_connect_listener_signal(
+        &wlr_scene_node_ptr->events.destroy,
+        &animation_ptr->destroy_listener,
+        _wlmtk_animation_handle_destroy);
+    bs_dllist_push_back(&state_ptr->animations, &animation_ptr->dlnode);
+    _wlmtk_animation_apply(animation_ptr, 0);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_animation_cancel(wlmtk_element_t *element_ptr)
+{
+    if (NULL == element_ptr->wlr_scene_node_ptr) return;
+    bs_dllist_node_t *dlnode_ptr = _wlmtk_animation_state.animations.head_ptr;
+    while (NULL != dlnode_ptr) {
+        wlmtk_animation_t *animation_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_animation_t, dlnode);
+        dlnode_ptr = dlnode_ptr->next_ptr;
+        if (animation_ptr->translated_node_ptr ==
+            element_ptr->wlr_scene_node_ptr) {
+            _wlmtk_animation_destroy(animation_ptr);
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_animation_tick(uint64_t now_msec, bool over_budget)
+{
+    _wlmtk_animation_state_t *state_ptr = &_wlmtk_animation_state;
+    state_ptr->last_tick_msec = now_msec;
+    if (over_budget) {
+        if (!bs_dllist_empty(&state_ptr->animations)) {
+            bs_log(BS_INFO, "Frame budget exceeded, suspending animations.");
+        }
+        _wlmtk_animation_finish_all();
+        state_ptr->suspended_until_msec =
+            now_msec + _wlmtk_animation_suspend_msec;
+        return;
+    }
+
+    bs_dllist_node_t *dlnode_ptr = state_ptr->animations.head_ptr;
+    while (NULL != dlnode_ptr) {
+        wlmtk_animation_t *animation_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_animation_t, dlnode);
+        dlnode_ptr = dlnode_ptr->next_ptr;
+
+        double progress = _wlmtk_animation_progress(animation_ptr, now_msec);
+        if (1.0 <= progress) {
+            _wlmtk_animation_destroy(animation_ptr);
+            continue;
+        }
+        // Eases out: Fast at the start, slowing down towards the end.
+        double p = 1.0 - progress;
+        _wlmtk_animation_apply(animation_ptr, 1.0 - p * p * p);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_animation_active(void)
+{
+    return !bs_dllist_empty(&_wlmtk_animation_state.animations);
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Iterator for `wlr_scene_node_for_each_buffer`: Adds a scene buffer for
+ * `wlr_scene_buffer_ptr`'s buffer to the snapshot.
+ *
+ * @param wlr_scene_buffer_ptr
+ * @param sx                  Position including the snapshotted node's.
+ * @param sy                  Position including the snapshotted node's.
+ * @param ud_ptr              The @ref wlmtk_animation_t.
+ */
+void _wlmtk_animation_add_buffer(
+    struct wlr_scene_buffer *wlr_scene_buffer_ptr,
+    int sx,
+    int sy,
+    void *ud_ptr)
+{
+    wlmtk_animation_t *animation_ptr = ud_ptr;
+    struct wlr_buffer *wlr_buffer_ptr = wlr_scene_buffer_ptr->buffer;
+    if (NULL == wlr_buffer_ptr) return;
+
+    if (animation_ptr->buffers >= animation_ptr->capacity) {
+        size_t capacity = BS_MAX(8U, 2 * animation_ptr->capacity);
+        wlmtk_animation_buffer_t *buffers_ptr = logged_calloc(
+            capacity, sizeof(wlmtk_animation_buffer_t));
+        if (NULL == buffers_ptr) return;
+        if (0 < animation_ptr->buffers) {
+            memcpy(buffers_ptr, animation_ptr->buffers_ptr,
+                   animation_ptr->buffers * sizeof(wlmtk_animation_buffer_t));
+        }
+        free(animation_ptr->buffers_ptr);
+        animation_ptr->buffers_ptr = buffers_ptr;
+        animation_ptr->capacity = capacity;
+    }
+
+    wlmtk_animation_buffer_t *b_ptr =
+        &animation_ptr->buffers_ptr[animation_ptr->buffers];
+    b_ptr->wlr_scene_buffer_ptr = wlr_scene_buffer_create(
+        animation_ptr->wlr_scene_tree_ptr, wlr_buffer_ptr);
+    if (NULL == b_ptr->wlr_scene_buffer_ptr) return;
+    ++animation_ptr->buffers;
+
+    b_ptr->x = sx - animation_ptr->x;
+    b_ptr->y = sy - animation_ptr->y;
+    b_ptr->width = wlr_scene_buffer_ptr->dst_width;
+    b_ptr->height = wlr_scene_buffer_ptr->dst_height;
+    if (0 >= b_ptr->width || 0 >= b_ptr->height) {
+        b_ptr->width = wlr_buffer_ptr->width;
+        b_ptr->height = wlr_buffer_ptr->height;
+    }
+    b_ptr->src_box = wlr_scene_buffer_ptr->src_box;
+    if (wlr_fbox_empty(&b_ptr->src_box)) {
+        b_ptr->src_box = (struct wlr_fbox){
+            .width = wlr_buffer_ptr->width, .height = wlr_buffer_ptr->height };
+    }
+    wlr_scene_buffer_set_transform(
+        b_ptr->wlr_scene_buffer_ptr, wlr_scene_buffer_ptr->transform);
+    animation_ptr->height = BS_MAX(
+        animation_ptr->height, b_ptr->y + b_ptr->height);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Destroys the animation, and its snapshot. A translated node is returned
+ * to the element's position.
+ */
+void _wlmtk_animation_destroy(wlmtk_animation_t *animation_ptr)
+{
+    bs_dllist_remove(&_wlmtk_animation_state.animations,
+                     &animation_ptr->dlnode);
+    wlmtk_util_disconnect_listener(&animation_ptr->destroy_listener);
+    if (NULL != animation_ptr->translated_node_ptr) {
+        wlr_scene_node_set_position(
+            animation_ptr->translated_node_ptr,
+            animation_ptr->x, animation_ptr->y);
+        animation_ptr->translated_node_ptr = NULL;
+    }
+    if (NULL != animation_ptr->wlr_scene_tree_ptr) {
+        wlr_scene_node_destroy(&animation_ptr->wlr_scene_tree_ptr->node);
+        animation_ptr->wlr_scene_tree_ptr = NULL;
+    }
+    if (NULL != animation_ptr->buffers_ptr) free(animation_ptr->buffers_ptr);
+    free(animation_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles `destroy` of the snapshot's tree or the translated node, eg. when
+ * the scene goes away.
+ */
+void _wlmtk_animation_handle_destroy(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmtk_animation_t *animation_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmtk_animation_t, destroy_listener);
+    animation_ptr->wlr_scene_tree_ptr = NULL;
+    animation_ptr->translated_node_ptr = NULL;
+    _wlmtk_animation_destroy(animation_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Applies the properties, interpolated at `progress`, to the snapshot's
+ * scene nodes.
+ *
+ * @param animation_ptr
+ * @param progress            From 0 (@ref wlmtk_animation_t::from) to 1
+ *                            (@ref wlmtk_animation_t::to).
+ */
+void _wlmtk_animation_apply(
+    wlmtk_animation_t *animation_ptr,
+    double progress)
+{
+    const wlmtk_animation_props_t *f_ptr = &animation_ptr->from;
+    const wlmtk_animation_props_t *t_ptr = &animation_ptr->to;
+    double x = f_ptr->x + progress * (t_ptr->x - f_ptr->x);
+    double y = f_ptr->y + progress * (t_ptr->y - f_ptr->y);
+    if (NULL != animation_ptr->translated_node_ptr) {
+        // Translating moves the element's node only.
+        wlr_scene_node_set_position(
+            animation_ptr->translated_node_ptr,
+            animation_ptr->x + (int)floor(x + 0.5),
+            animation_ptr->y + (int)floor(y + 0.5));
+        return;
+    }
+    double scale = f_ptr->scale + progress * (t_ptr->scale - f_ptr->scale);
+    float opacity = f_ptr->opacity +
+        (float)progress * (t_ptr->opacity - f_ptr->opacity);
+    double clip = f_ptr->clip + progress * (t_ptr->clip - f_ptr->clip);
+    int visible_height = (int)(clip * animation_ptr->height + 0.5);
+
+    wlr_scene_node_set_position(
+        &animation_ptr->wlr_scene_tree_ptr->node,
+        animation_ptr->x + (int)(x + 0.5),
+        animation_ptr->y + (int)(y + 0.5));
+    for (size_t i = 0; i < animation_ptr->buffers; ++i) {
+        wlmtk_animation_buffer_t *b_ptr = &animation_ptr->buffers_ptr[i];
+        struct wlr_scene_buffer *wlr_scene_buffer_ptr =
+            b_ptr->wlr_scene_buffer_ptr;
+
+        // Clipping crops the buffer's bottom, and hides buffers below.
+        int height = BS_MIN(b_ptr->height, visible_height - b_ptr->y);
+        wlr_scene_node_set_enabled(&wlr_scene_buffer_ptr->node, 0 < height);
+        if (0 >= height) continue;
+        struct wlr_fbox src_box = b_ptr->src_box;
+        src_box.height = src_box.height * height / b_ptr->height;
+        wlr_scene_buffer_set_source_box(wlr_scene_buffer_ptr, &src_box);
+
+        wlr_scene_node_set_position(
+            &wlr_scene_buffer_ptr->node,
+            (int)(b_ptr->x * scale + 0.5),
+            (int)(b_ptr->y * scale + 0.5));
+        wlr_scene_buffer_set_dest_size(
+            wlr_scene_buffer_ptr,
+            BS_MAX(1, (int)(b_ptr->width * scale + 0.5)),
+            BS_MAX(1, (int)(height * scale + 0.5)));
+        wlr_scene_buffer_set_opacity(wlr_scene_buffer_ptr, opacity);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes the linear progress of the animation at `now_msec`. Starts the
+ * animation, if not started yet.
+ *
+ * @param animation_ptr
+ * @param now_msec
+ *
+ * @return Progress, from 0 to 1.
+ */
+double _wlmtk_animation_progress(
+    wlmtk_animation_t *animation_ptr,
+    uint64_t now_msec)
+{
+    if (!animation_ptr->started) {
+        animation_ptr->start_msec = now_msec;
+        animation_ptr->started = true;
+    }
+    if (now_msec <= animation_ptr->start_msec) return 0;
+    uint64_t elapsed_msec = now_msec - animation_ptr->start_msec;
+    if (elapsed_msec >= animation_ptr->duration_msec) return 1.0;
+    return (double)elapsed_msec / (double)animation_ptr->duration_msec;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Finishes all animations: Destroys them, revealing the final state. */
+void _wlmtk_animation_finish_all(void)
+{
+    while (NULL != _wlmtk_animation_state.animations.head_ptr) {
+        _wlmtk_animation_destroy(BS_CONTAINER_OF(
+            _wlmtk_animation_state.animations.head_ptr,
+            wlmtk_animation_t, dlnode));
+    }
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_snapshot(bs_test_t *test_ptr);
+static void test_budget(bs_test_t *test_ptr);
+static void test_translate(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_animation_test_cases[] = {
+    { 1, "snapshot", test_snapshot },
+    { 1, "budget", test_budget },
+    { 1, "translate", test_translate },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Fixture: A buffer element of 40x20, at 10, 5 in a fake parent. */
+static wlmtk_buffer_t *_wlmtk_animation_test_buffer(
+    bs_test_t *test_ptr,
+    wlmtk_container_t *fake_parent_ptr)
+{
+    static wlmtk_buffer_t buffer;
+    if (!wlmtk_buffer_init(&buffer)) return NULL;
+    wlmtk_container_add_element(fake_parent_ptr, &buffer.super_element);
+    wlmtk_element_set_visible(&buffer.super_element, true);
+    wlmtk_element_set_position(&buffer.super_element, 10, 5);
+    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(40, 20);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, wlr_buffer_ptr);
+    if (NULL == wlr_buffer_ptr) return &buffer;
+    wlmtk_buffer_set(&buffer, wlr_buffer_ptr);
+    wlr_buffer_drop(wlr_buffer_ptr);
+    return &buffer;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Fixture teardown. */
+static void _wlmtk_animation_test_buffer_fini(
+    wlmtk_container_t *fake_parent_ptr,
+    wlmtk_buffer_t *buffer_ptr)
+{
+    wlmtk_container_remove_element(
+        fake_parent_ptr, &buffer_ptr->super_element);
+    wlmtk_buffer_fini(buffer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Snapshots a buffer, and verifies clipping, fading and completion. */
+void test_snapshot(bs_test_t *test_ptr)
+{
+    wlmtk_container_t *fake_parent_ptr = wlmtk_container_create_fake_parent();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fake_parent_ptr);
+    wlmtk_buffer_t *buffer_ptr = _wlmtk_animation_test_buffer(
+        test_ptr, fake_parent_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, buffer_ptr);
+
+    wlmtk_animation_props_t from = wlmtk_animation_props_identity;
+    wlmtk_animation_props_t to = { .scale = 1.0, .opacity = 0, .clip = 0.5 };
+
+    // Disabled: Nothing is animated.
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlmtk_animation_snapshot(
+            &buffer_ptr->super_element, &from, &to, 100));
+
+    wlmtk_animation_set_enabled(true);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_animation_snapshot(
+            &buffer_ptr->super_element, &from, &to, 100));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_animation_active());
+    wlmtk_animation_t *a_ptr = BS_CONTAINER_OF(
+        _wlmtk_animation_state.animations.head_ptr, wlmtk_animation_t, dlnode);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, 1 == a_ptr->buffers);
+    struct wlr_scene_buffer *sb_ptr =
+        a_ptr->buffers_ptr[0].wlr_scene_buffer_ptr;
+    BS_TEST_VERIFY_EQ(test_ptr, buffer_ptr->wlr_buffer_ptr, sb_ptr->buffer);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, a_ptr->wlr_scene_tree_ptr->node.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 5, a_ptr->wlr_scene_tree_ptr->node.y);
+    BS_TEST_VERIFY_EQ(test_ptr, 20, sb_ptr->dst_height);
+
+    // The first tick starts it. Repeated ticks are idempotent.
+    wlmtk_animation_tick(1000, false);
+    wlmtk_animation_tick(1000, false);
+    BS_TEST_VERIFY_EQ(test_ptr, 20, sb_ptr->dst_height);
+    BS_TEST_VERIFY_EQ(test_ptr, 1.0f, sb_ptr->opacity);
+
+    // At half the time, eased out to 87.5%.
+    wlmtk_animation_tick(1050, false);
+    BS_TEST_VERIFY_EQ(test_ptr, 11, sb_ptr->dst_height);
+    BS_TEST_VERIFY_EQ(test_ptr, 11.0, sb_ptr->src_box.height);
+    BS_TEST_VERIFY_TRUE(test_ptr, 0.2f > sb_ptr->opacity);
+
+    // Completes: The snapshot is gone.
+    wlmtk_animation_tick(1100, false);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_animation_active());
+
+    wlmtk_animation_set_enabled(false);
+    _wlmtk_animation_state.suspended_until_msec = 0;
+    _wlmtk_animation_state.last_tick_msec = 0;
+    _wlmtk_animation_test_buffer_fini(fake_parent_ptr, buffer_ptr);
+    wlmtk_container_destroy_fake_parent(fake_parent_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Exceeding the frame budget finishes animations, and suspends new ones. */
+void test_budget(bs_test_t *test_ptr)
+{
+    wlmtk_container_t *fake_parent_ptr = wlmtk_container_create_fake_parent();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fake_parent_ptr);
+    wlmtk_buffer_t *buffer_ptr = _wlmtk_animation_test_buffer(
+        test_ptr, fake_parent_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, buffer_ptr);
+    const wlmtk_animation_props_t *p_ptr = &wlmtk_animation_props_identity;
+
+    wlmtk_animation_set_enabled(true);
+    wlmtk_animation_tick(1000, false);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_animation_snapshot(
+            &buffer_ptr->super_element, p_ptr, p_ptr, 100));
+    wlmtk_animation_tick(1016, true);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_animation_active());
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlmtk_animation_snapshot(
+            &buffer_ptr->super_element, p_ptr, p_ptr, 100));
+
+    // Resumes after the suspension.
+    wlmtk_animation_tick(2016, false);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_animation_snapshot(
+            &buffer_ptr->super_element, p_ptr, p_ptr, 100));
+
+    // Disabling finishes the running animations.
+    wlmtk_animation_set_enabled(false);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_animation_active());
+    _wlmtk_animation_state.suspended_until_msec = 0;
+    _wlmtk_animation_state.last_tick_msec = 0;
+    _wlmtk_animation_test_buffer_fini(fake_parent_ptr, buffer_ptr);
+    wlmtk_container_destroy_fake_parent(fake_parent_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Translates the element's own node, and returns it to its position. */
+void test_translate(bs_test_t *test_ptr)
+{
+    wlmtk_container_t *fake_parent_ptr = wlmtk_container_create_fake_parent();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fake_parent_ptr);
+    wlmtk_buffer_t *buffer_ptr = _wlmtk_animation_test_buffer(
+        test_ptr, fake_parent_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, buffer_ptr);
+    wlmtk_element_t *e_ptr = &buffer_ptr->super_element;
+
+    // Disabled: The node is placed at the element's position right away.
+    wlr_scene_node_set_position(e_ptr->wlr_scene_node_ptr, 110, 5);
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlmtk_animation_translate(e_ptr, 100, 0, 100));
+    BS_TEST_VERIFY_EQ(test_ptr, 10, e_ptr->wlr_scene_node_ptr->x);
+
+    wlmtk_animation_set_enabled(true);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_animation_translate(e_ptr, -100, 0, 100));
+    BS_TEST_VERIFY_EQ(test_ptr, -90, e_ptr->wlr_scene_node_ptr->x);
+    wlmtk_animation_tick(1000, false);
+    wlmtk_animation_tick(1050, false);
+    BS_TEST_VERIFY_EQ(test_ptr, -2, e_ptr->wlr_scene_node_ptr->x);
+    BS_TEST_VERIFY_EQ(test_ptr, 5, e_ptr->wlr_scene_node_ptr->y);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, e_ptr->x);
+    wlmtk_animation_tick(1100, false);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_animation_active());
+    BS_TEST_VERIFY_EQ(test_ptr, 10, e_ptr->wlr_scene_node_ptr->x);
+
+    // Cancelling returns the node as well.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_animation_translate(e_ptr, 0, 40, 100));
+    BS_TEST_VERIFY_EQ(test_ptr, 45, e_ptr->wlr_scene_node_ptr->y);
+    wlmtk_animation_cancel(e_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_animation_active());
+    BS_TEST_VERIFY_EQ(test_ptr, 5, e_ptr->wlr_scene_node_ptr->y);
+
+    wlmtk_animation_set_enabled(false);
+    _wlmtk_animation_state.last_tick_msec = 0;
+    _wlmtk_animation_test_buffer_fini(fake_parent_ptr, buffer_ptr);
+    wlmtk_container_destroy_fake_parent(fake_parent_ptr);
+}
+
+/* == End of animation.c =================================================== */
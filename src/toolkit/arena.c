@@ -0,0 +1,269 @@
+/* ========================================================================= */
+/**
+ * @file arena.c
+ *
+ * @copyright
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "arena.h"
+
+#include <libbase/libbase.h>
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* == Declarations ========================================================= */
+
+/** Header preceding each block of the arena. Keeps blocks aligned. */
+typedef union {
+    struct {
+        /** Size of the block, excluding this header. */
+        size_t                size;
+        /** Next free block, while the block is free. */
+        void                  *next_free_ptr;
+    } h;
+    /** For alignment. */
+    max_align_t               alignment;
+} wlmtk_arena_block_t;
+
+/** State of an arena. */
+typedef struct {
+    /** Start of the mapping. NULL if not enabled. */
+    uint8_t                   *base_ptr;
+    /** Size of the mapping. */
+    size_t                    size;
+    /** Offset of the first byte not yet handed out. */
+    size_t                    offset;
+    /** Freed blocks, for re-use. */
+    wlmtk_arena_block_t       *free_ptr;
+    /** Statistics. */
+    wlmtk_arena_stats_t       stats;
+} wlmtk_arena_t;
+
+static bool _wlmtk_arena_init(
+    wlmtk_arena_t *arena_ptr,
+    size_t bytes,
+    bool lock);
+static void _wlmtk_arena_fini(wlmtk_arena_t *arena_ptr);
+static void *_wlmtk_arena_calloc(wlmtk_arena_t *arena_ptr, size_t size);
+static void _wlmtk_arena_free(wlmtk_arena_t *arena_ptr, void *ptr);
+
+/* == Data ================================================================= */
+
+/** The arena. */
+static wlmtk_arena_t          _wlmtk_arena;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_arena_lock(size_t bytes)
+{
+    BS_ASSERT(NULL == _wlmtk_arena.base_ptr);
+    if (!_wlmtk_arena_init(&_wlmtk_arena, bytes, true)) return false;
+    bs_log(BS_INFO, "Locked arena of %zu bytes at %p",
+           _wlmtk_arena.size, _wlmtk_arena.base_ptr);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+void *wlmtk_arena_calloc(size_t size)
+{
+    return _wlmtk_arena_calloc(&_wlmtk_arena, size);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_arena_free(void *ptr)
+{
+    _wlmtk_arena_free(&_wlmtk_arena, ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_arena_get_stats(wlmtk_arena_stats_t *stats_ptr)
+{
+    *stats_ptr = _wlmtk_arena.stats;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Maps the arena, and pre-faults it.
+ *
+ * @param arena_ptr
+ * @param bytes
+ * @param lock                Whether to lock the mapping in memory.
+ *
+ * @return true on success.
+ */
+bool _wlmtk_arena_init(wlmtk_arena_t *arena_ptr, size_t bytes, bool lock)
+{
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    size_t size = (bytes + page_size - 1) / page_size * page_size;
+    void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (MAP_FAILED == ptr) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed mmap(NULL, %zu, ...)", size);
+        return false;
+    }
+    if (lock && 0 != mlock(ptr, size)) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed mlock(%p, %zu). Check "
+               "RLIMIT_MEMLOCK.", ptr, size);
+        munmap(ptr, size);
+        return false;
+    }
+    *arena_ptr = (wlmtk_arena_t){
+        .base_ptr = ptr,
+        .size = size,
+        .stats = { .locked_bytes = lock ? size : 0 }
+    };
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Unmaps the arena. Expects all blocks to be freed. */
+void _wlmtk_arena_fini(wlmtk_arena_t *arena_ptr)
+{
+    BS_ASSERT(0 == arena_ptr->stats.blocks);
+    if (NULL != arena_ptr->base_ptr) {
+        munmap(arena_ptr->base_ptr, arena_ptr->size);
+    }
+    *arena_ptr = (wlmtk_arena_t){};
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Allocates a block of `size` bytes, re-using a freed block of the same
+ * size if there is one.
+ *
+ * @param arena_ptr
+ * @param size
+ *
+ * @return Pointer to the zero-initialized block, or NULL on error.
+ */
+void *_wlmtk_arena_calloc(wlmtk_arena_t *arena_ptr, size_t size)
+{
+    if (NULL == arena_ptr->base_ptr) return logged_calloc(1, size);
+
+    const size_t a = alignof(max_align_t);
+    size = (BS_MAX(size, 1u) + a - 1) / a * a;
+    wlmtk_arena_block_t *block_ptr = NULL;
+    for (wlmtk_arena_block_t **b_ptr_ptr = &arena_ptr->free_ptr;
+         NULL != *b_ptr_ptr;
+         b_ptr_ptr = (wlmtk_arena_block_t**)&(*b_ptr_ptr)->h.next_free_ptr) {
+        if ((*b_ptr_ptr)->h.size != size) continue;
+        block_ptr = *b_ptr_ptr;
+        *b_ptr_ptr = block_ptr->h.next_free_ptr;
+        memset(block_ptr + 1, 0, size);
+        break;
+    }
+
+    if (NULL == block_ptr) {
+        if (arena_ptr->size - arena_ptr->offset <
+            sizeof(wlmtk_arena_block_t) + size) {
+            arena_ptr->stats.fallbacks++;
+            return logged_calloc(1, size);
+        }
+        // Fresh from the mapping: Is still zero.
+        block_ptr = (wlmtk_arena_block_t*)(
+            arena_ptr->base_ptr + arena_ptr->offset);
+        arena_ptr->offset += sizeof(wlmtk_arena_block_t) + size;
+        arena_ptr->stats.used_bytes = arena_ptr->offset;
+    }
+    block_ptr->h.size = size;
+    block_ptr->h.next_free_ptr = NULL;
+    arena_ptr->stats.blocks++;
+    return block_ptr + 1;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns `ptr` to the arena's free blocks, or to the heap. */
+void _wlmtk_arena_free(wlmtk_arena_t *arena_ptr, void *ptr)
+{
+    if (NULL == ptr) return;
+    uint8_t *p = ptr;
+    if (NULL == arena_ptr->base_ptr ||
+        p < arena_ptr->base_ptr ||
+        p >= arena_ptr->base_ptr + arena_ptr->size) {
+        free(ptr);
+        return;
+    }
+
+    wlmtk_arena_block_t *block_ptr = (wlmtk_arena_block_t*)ptr - 1;
+    block_ptr->h.next_free_ptr = arena_ptr->free_ptr;
+    arena_ptr->free_ptr = block_ptr;
+    arena_ptr->stats.blocks--;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_alloc_free(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_arena_test_cases[] = {
+    { 1, "alloc_free", test_alloc_free },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Allocates from an arena, re-uses freed blocks, and falls back. */
+void test_alloc_free(bs_test_t *test_ptr)
+{
+    wlmtk_arena_t arena = {};
+    // Not enabled: Served from the heap.
+    void *p = _wlmtk_arena_calloc(&arena, 100);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, p);
+    _wlmtk_arena_free(&arena, p);
+
+    // Not locking here: RLIMIT_MEMLOCK may be tiny in the test environment.
+    BS_TEST_VERIFY_TRUE_OR_RETURN(
+        test_ptr, _wlmtk_arena_init(&arena, 1, false));
+    size_t page_size = sysconf(_SC_PAGESIZE);
+    BS_TEST_VERIFY_EQ(test_ptr, page_size, arena.size);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, arena.stats.locked_bytes);
+
+    uint8_t *p1 = _wlmtk_arena_calloc(&arena, 100);
+    uint8_t *p2 = _wlmtk_arena_calloc(&arena, 200);
+    BS_TEST_VERIFY_TRUE(test_ptr, p1 >= arena.base_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, p2 > p1);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, (uintptr_t)p2 % alignof(max_align_t));
+    BS_TEST_VERIFY_EQ(test_ptr, 2, arena.stats.blocks);
+    memset(p1, 0xff, 100);
+
+    // A freed block is re-used for the same size, and cleared.
+    _wlmtk_arena_free(&arena, p1);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, arena.stats.blocks);
+    size_t used_bytes = arena.stats.used_bytes;
+    p = _wlmtk_arena_calloc(&arena, 100);
+    BS_TEST_VERIFY_EQ(test_ptr, p1, p);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, p1[99]);
+    BS_TEST_VERIFY_EQ(test_ptr, used_bytes, arena.stats.used_bytes);
+
+    // Does not fit: From the heap.
+    void *p3 = _wlmtk_arena_calloc(&arena, page_size);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, p3);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, arena.stats.fallbacks);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, arena.stats.blocks);
+    _wlmtk_arena_free(&arena, p3);
+
+    _wlmtk_arena_free(&arena, p2);
+    _wlmtk_arena_free(&arena, p1);
+    _wlmtk_arena_fini(&arena);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, arena.base_ptr);
+}
+
+/* == End of arena.c ======================================================= */
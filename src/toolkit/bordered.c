@@ -23,18 +23,54 @@
 #include <string.h>
 
 #include "libbase/libbase.h"
+#define WLR_USE_UNSTABLE
+#include <wlr/types/wlr_scene.h>
+#undef WLR_USE_UNSTABLE
+
+#include "util.h"
 
 /* == Declarations ========================================================= */
 
 static void _wlmtk_bordered_container_update_layout(
     wlmtk_container_t *container_ptr);
-
-static wlmtk_rectangle_t * _wlmtk_bordered_create_border_rectangle(
+static struct wlr_scene_node *_wlmtk_bordered_element_create_scene_node(
+    wlmtk_element_t *element_ptr,
+    struct wlr_scene_tree *wlr_scene_tree_ptr);
+static void _wlmtk_bordered_element_get_dimensions(
+    wlmtk_element_t *element_ptr,
+    int *x1_ptr,
+    int *y1_ptr,
+    int *x2_ptr,
+    int *y2_ptr);
+static void _wlmtk_bordered_element_get_pointer_area(
+    wlmtk_element_t *element_ptr,
+    int *x1_ptr,
+    int *y1_ptr,
+    int *x2_ptr,
+    int *y2_ptr);
+static bool _wlmtk_bordered_element_pointer_motion(
+    wlmtk_element_t *element_ptr,
+    wlmtk_pointer_motion_event_t *motion_event_ptr);
+
+static struct wlr_scene_rect *_wlmtk_bordered_create_border_rect(
     wlmtk_bordered_t *bordered_ptr);
-static void _wlmtk_bordered_destroy_border_rectangle(
+static void _wlmtk_bordered_handle_wlr_scene_tree_destroy(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmtk_bordered_cover_border(
     wlmtk_bordered_t *bordered_ptr,
-    wlmtk_rectangle_t **rectangle_ptr_ptr);
+    int *x1_ptr,
+    int *y1_ptr,
+    int *x2_ptr,
+    int *y2_ptr);
 static void _wlmtk_bordered_set_positions(wlmtk_bordered_t *bordered_ptr);
+static void _wlmtk_bordered_place_border_rects(wlmtk_bordered_t *bordered_ptr);
+static void _wlmtk_bordered_place_border_rect(
+    struct wlr_scene_rect *wlr_scene_rect_ptr,
+    int x,
+    int y,
+    int width,
+    int height);
 
 /* == Data ================================================================= */
 
@@ -43,6 +79,14 @@ static const wlmtk_container_vmt_t bordered_container_vmt = {
     .update_layout = _wlmtk_bordered_container_update_layout,
 };
 
+/** Virtual method table: @ref wlmtk_element_t at @ref wlmtk_bordered_t. */
+static const wlmtk_element_vmt_t bordered_element_vmt = {
+    .create_scene_node = _wlmtk_bordered_element_create_scene_node,
+    .get_dimensions = _wlmtk_bordered_element_get_dimensions,
+    .get_pointer_area = _wlmtk_bordered_element_get_pointer_area,
+    .pointer_motion = _wlmtk_bordered_element_pointer_motion,
+};
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -57,27 +101,13 @@ bool wlmtk_bordered_init(wlmtk_bordered_t *bordered_ptr,
     }
     bordered_ptr->orig_super_container_vmt = wlmtk_container_extend(
         &bordered_ptr->super_container, &bordered_container_vmt);
+    bordered_ptr->orig_super_element_vmt = wlmtk_element_extend(
+        &bordered_ptr->super_container.super_element, &bordered_element_vmt);
 
     bordered_ptr->element_ptr = element_ptr;
     wlmtk_container_add_element(&bordered_ptr->super_container,
                                 bordered_ptr->element_ptr);
 
-    bordered_ptr->northern_border_rectangle_ptr =
-        _wlmtk_bordered_create_border_rectangle(bordered_ptr);
-    bordered_ptr->eastern_border_rectangle_ptr =
-        _wlmtk_bordered_create_border_rectangle(bordered_ptr);
-    bordered_ptr->southern_border_rectangle_ptr =
-        _wlmtk_bordered_create_border_rectangle(bordered_ptr);
-    bordered_ptr->western_border_rectangle_ptr =
-        _wlmtk_bordered_create_border_rectangle(bordered_ptr);
-    if (NULL == bordered_ptr->northern_border_rectangle_ptr ||
-        NULL == bordered_ptr->eastern_border_rectangle_ptr ||
-        NULL == bordered_ptr->southern_border_rectangle_ptr ||
-        NULL == bordered_ptr->western_border_rectangle_ptr) {
-        wlmtk_bordered_fini(bordered_ptr);
-        return false;
-    }
-
     _wlmtk_bordered_set_positions(bordered_ptr);
     return true;
 }
@@ -85,18 +115,12 @@ bool wlmtk_bordered_init(wlmtk_bordered_t *bordered_ptr,
 /* ------------------------------------------------------------------------- */
 void wlmtk_bordered_fini(wlmtk_bordered_t *bordered_ptr)
 {
-    _wlmtk_bordered_destroy_border_rectangle(
-        bordered_ptr, &bordered_ptr->western_border_rectangle_ptr);
-    _wlmtk_bordered_destroy_border_rectangle(
-        bordered_ptr, &bordered_ptr->southern_border_rectangle_ptr);
-    _wlmtk_bordered_destroy_border_rectangle(
-        bordered_ptr, &bordered_ptr->eastern_border_rectangle_ptr);
-    _wlmtk_bordered_destroy_border_rectangle(
-        bordered_ptr, &bordered_ptr->northern_border_rectangle_ptr);
-
     wlmtk_container_remove_element(&bordered_ptr->super_container,
                                    bordered_ptr->element_ptr);
+    // Destroys the scene tree, if any. The border rects go along.
     wlmtk_container_fini(&bordered_ptr->super_container);
+    wlmtk_util_disconnect_listener(
+        &bordered_ptr->wlr_scene_tree_destroy_listener);
     *bordered_ptr = (wlmtk_bordered_t){};
 }
 
@@ -107,18 +131,20 @@ void wlmtk_bordered_set_style(wlmtk_bordered_t *bordered_ptr,
     bordered_ptr->style = *style_ptr;
 
     _wlmtk_bordered_container_update_layout(&bordered_ptr->super_container);
-
-    // Guard clause. Actually, if *any* of the rectangles was not created.
-    if (NULL == bordered_ptr->western_border_rectangle_ptr) return;
-
-    wlmtk_rectangle_set_color(
-        bordered_ptr->northern_border_rectangle_ptr, style_ptr->color);
-    wlmtk_rectangle_set_color(
-        bordered_ptr->eastern_border_rectangle_ptr, style_ptr->color);
-    wlmtk_rectangle_set_color(
-        bordered_ptr->southern_border_rectangle_ptr, style_ptr->color);
-    wlmtk_rectangle_set_color(
-        bordered_ptr->western_border_rectangle_ptr, style_ptr->color);
+    // The border width counts for the extents, see the element overrides.
+    wlmtk_element_invalidate_extents(
+        &bordered_ptr->super_container.super_element);
+
+    // Guard clause. Actually, if *any* of the rects was not created.
+    if (NULL == bordered_ptr->western_wlr_scene_rect_ptr) return;
+
+    float color[4];
+    bs_gfxbuf_argb8888_to_floats(
+        style_ptr->color, &color[0], &color[1], &color[2], &color[3]);
+    wlr_scene_rect_set_color(bordered_ptr->northern_wlr_scene_rect_ptr, color);
+    wlr_scene_rect_set_color(bordered_ptr->eastern_wlr_scene_rect_ptr, color);
+    wlr_scene_rect_set_color(bordered_ptr->southern_wlr_scene_rect_ptr, color);
+    wlr_scene_rect_set_color(bordered_ptr->western_wlr_scene_rect_ptr, color);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -147,91 +173,253 @@ void _wlmtk_bordered_container_update_layout(
 }
 
 /* ------------------------------------------------------------------------- */
-/** Creates a border rectangle and adds it to `bordered_ptr`. */
-wlmtk_rectangle_t * _wlmtk_bordered_create_border_rectangle(
-    wlmtk_bordered_t *bordered_ptr)
+/**
+ * Implements @ref wlmtk_element_vmt_t::create_scene_node. Extends the
+ * container's scene tree by a `struct wlr_scene_rect` for each side of the
+ * border.
+ *
+ * @param element_ptr
+ * @param wlr_scene_tree_ptr
+ */
+struct wlr_scene_node *_wlmtk_bordered_element_create_scene_node(
+    wlmtk_element_t *element_ptr,
+    struct wlr_scene_tree *wlr_scene_tree_ptr)
+{
+    wlmtk_bordered_t *bordered_ptr = BS_CONTAINER_OF(
+        element_ptr, wlmtk_bordered_t, super_container.super_element);
+
+    struct wlr_scene_node *wlr_scene_node_ptr =
+        bordered_ptr->orig_super_element_vmt.create_scene_node(
+            element_ptr, wlr_scene_tree_ptr);
+    if (NULL == bordered_ptr->super_container.wlr_scene_tree_ptr) {
+        return wlr_scene_node_ptr;
+    }
+    wlmtk_util_connect_listener_signal(
+        &bordered_ptr->super_container.wlr_scene_tree_ptr->node.events.destroy,
+        &bordered_ptr->wlr_scene_tree_destroy_listener,
+        _wlmtk_bordered_handle_wlr_scene_tree_destroy);
+
+    bordered_ptr->northern_wlr_scene_rect_ptr =
+        _wlmtk_bordered_create_border_rect(bordered_ptr);
+    bordered_ptr->eastern_wlr_scene_rect_ptr =
+        _wlmtk_bordered_create_border_rect(bordered_ptr);
+    bordered_ptr->southern_wlr_scene_rect_ptr =
+        _wlmtk_bordered_create_border_rect(bordered_ptr);
+    bordered_ptr->western_wlr_scene_rect_ptr =
+        _wlmtk_bordered_create_border_rect(bordered_ptr);
+    _wlmtk_bordered_place_border_rects(bordered_ptr);
+    return wlr_scene_node_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_element_vmt_t::get_dimensions. Covers the element's
+ * children, and the border around @ref wlmtk_bordered_t::element_ptr.
+ *
+ * @param element_ptr
+ * @param x1_ptr              Leftmost position. May be NULL.
+ * @param y1_ptr              Topmost position. May be NULL.
+ * @param x2_ptr              Rightmost position. May be NULL.
+ * @param y2_ptr              Bottommost position. May be NULL.
+ */
+void _wlmtk_bordered_element_get_dimensions(
+    wlmtk_element_t *element_ptr,
+    int *x1_ptr,
+    int *y1_ptr,
+    int *x2_ptr,
+    int *y2_ptr)
 {
-    wlmtk_rectangle_t *rectangle_ptr = wlmtk_rectangle_create(
-        0, 0, bordered_ptr->style.color);
-    if (NULL == rectangle_ptr) return NULL;
+    wlmtk_bordered_t *bordered_ptr = BS_CONTAINER_OF(
+        element_ptr, wlmtk_bordered_t, super_container.super_element);
+    int x1, y1, x2, y2;
+    bordered_ptr->orig_super_element_vmt.get_dimensions(
+        element_ptr, &x1, &y1, &x2, &y2);
 
-    wlmtk_element_set_visible(wlmtk_rectangle_element(rectangle_ptr), true);
-    wlmtk_container_add_element_atop(
-        &bordered_ptr->super_container,
-        NULL,
-        wlmtk_rectangle_element(rectangle_ptr));
+    _wlmtk_bordered_cover_border(bordered_ptr, &x1, &y1, &x2, &y2);
 
-    return rectangle_ptr;
+    if (NULL != x1_ptr) *x1_ptr = x1;
+    if (NULL != y1_ptr) *y1_ptr = y1;
+    if (NULL != x2_ptr) *x2_ptr = x2;
+    if (NULL != y2_ptr) *y2_ptr = y2;
 }
 
 /* ------------------------------------------------------------------------- */
-/** Removes the rectangle from `bordered_ptr`, destroys it and NULLs it. */
-void _wlmtk_bordered_destroy_border_rectangle(
-    wlmtk_bordered_t *bordered_ptr,
-    wlmtk_rectangle_t **rectangle_ptr_ptr)
+/**
+ * Implements @ref wlmtk_element_vmt_t::get_pointer_area. Covers the pointer
+ * area of the children, and the border. The border accepts pointer motion,
+ * see @ref _wlmtk_bordered_element_pointer_motion.
+ *
+ * @param element_ptr
+ * @param x1_ptr              Leftmost position. May be NULL.
+ * @param y1_ptr              Topmost position. May be NULL.
+ * @param x2_ptr              Rightmost position. May be NULL.
+ * @param y2_ptr              Bottommost position. May be NULL.
+ */
+void _wlmtk_bordered_element_get_pointer_area(
+    wlmtk_element_t *element_ptr,
+    int *x1_ptr,
+    int *y1_ptr,
+    int *x2_ptr,
+    int *y2_ptr)
+{
+    wlmtk_bordered_t *bordered_ptr = BS_CONTAINER_OF(
+        element_ptr, wlmtk_bordered_t, super_container.super_element);
+    int x1, y1, x2, y2;
+    bordered_ptr->orig_super_element_vmt.get_pointer_area(
+        element_ptr, &x1, &y1, &x2, &y2);
+
+    _wlmtk_bordered_cover_border(bordered_ptr, &x1, &y1, &x2, &y2);
+
+    if (NULL != x1_ptr) *x1_ptr = x1;
+    if (NULL != y1_ptr) *y1_ptr = y1;
+    if (NULL != x2_ptr) *x2_ptr = x2;
+    if (NULL != y2_ptr) *y2_ptr = y2;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_element_vmt_t::pointer_motion. Passes the motion to
+ * the children. If none takes it, but the pointer is on the border: Accepts
+ * the motion, and sets the default cursor.
+ *
+ * @param element_ptr
+ * @param motion_event_ptr
+ *
+ * @return Whether the motion is within the bordered element.
+ */
+bool _wlmtk_bordered_element_pointer_motion(
+    wlmtk_element_t *element_ptr,
+    wlmtk_pointer_motion_event_t *motion_event_ptr)
+{
+    wlmtk_bordered_t *bordered_ptr = BS_CONTAINER_OF(
+        element_ptr, wlmtk_bordered_t, super_container.super_element);
+    if (bordered_ptr->orig_super_element_vmt.pointer_motion(
+            element_ptr, motion_event_ptr)) return true;
+
+    int margin = bordered_ptr->style.width;
+    if (0 > motion_event_ptr->x ||
+        motion_event_ptr->x >= bordered_ptr->width + 2 * margin ||
+        0 > motion_event_ptr->y ||
+        motion_event_ptr->y >= bordered_ptr->height + 2 * margin) {
+        return false;
+    }
+    wlmtk_pointer_set_cursor(
+        motion_event_ptr->pointer_ptr, WLMTK_POINTER_CURSOR_DEFAULT);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Creates a border rect, at the bottom of the bordered element's tree. */
+struct wlr_scene_rect *_wlmtk_bordered_create_border_rect(
+    wlmtk_bordered_t *bordered_ptr)
+{
+    float color[4];
+    bs_gfxbuf_argb8888_to_floats(
+        bordered_ptr->style.color, &color[0], &color[1], &color[2], &color[3]);
+    struct wlr_scene_rect *wlr_scene_rect_ptr = wlr_scene_rect_create(
+        bordered_ptr->super_container.wlr_scene_tree_ptr, 0, 0, color);
+    if (NULL == wlr_scene_rect_ptr) {
+        bs_log(BS_WARNING, "Failed wlr_scene_rect_create(%p, 0, 0, %p)",
+               bordered_ptr->super_container.wlr_scene_tree_ptr, color);
+        return NULL;
+    }
+    wlr_scene_node_lower_to_bottom(&wlr_scene_rect_ptr->node);
+    return wlr_scene_rect_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Clears the references to the border rects, when the tree is destroyed. */
+void _wlmtk_bordered_handle_wlr_scene_tree_destroy(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
 {
-    if (NULL == *rectangle_ptr_ptr) return;
+    wlmtk_bordered_t *bordered_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmtk_bordered_t, wlr_scene_tree_destroy_listener);
+
+    // The rects are children of the tree, and get destroyed along.
+    bordered_ptr->northern_wlr_scene_rect_ptr = NULL;
+    bordered_ptr->eastern_wlr_scene_rect_ptr = NULL;
+    bordered_ptr->southern_wlr_scene_rect_ptr = NULL;
+    bordered_ptr->western_wlr_scene_rect_ptr = NULL;
+    wlmtk_util_disconnect_listener(
+        &bordered_ptr->wlr_scene_tree_destroy_listener);
+}
 
-    wlmtk_container_remove_element(
-        &bordered_ptr->super_container,
-        wlmtk_rectangle_element(*rectangle_ptr_ptr));
-    wlmtk_rectangle_destroy(*rectangle_ptr_ptr);
-    *rectangle_ptr_ptr = NULL;
+/* ------------------------------------------------------------------------- */
+/** Extends the extents at `x1_ptr`...`y2_ptr` to cover the border. */
+void _wlmtk_bordered_cover_border(
+    wlmtk_bordered_t *bordered_ptr,
+    int *x1_ptr,
+    int *y1_ptr,
+    int *x2_ptr,
+    int *y2_ptr)
+{
+    int margin = bordered_ptr->style.width;
+    *x1_ptr = BS_MIN(*x1_ptr, 0);
+    *y1_ptr = BS_MIN(*y1_ptr, 0);
+    *x2_ptr = BS_MAX(*x2_ptr, bordered_ptr->width + 2 * margin);
+    *y2_ptr = BS_MAX(*y2_ptr, bordered_ptr->height + 2 * margin);
 }
 
 /* ------------------------------------------------------------------------- */
 /**
- * Updates the position of all 4 border elements.
+ * Positions the element, and the border around it.
  *
  * Retrieves the position and dimensions of @ref wlmtk_bordered_t::element_ptr
- * and arranges the 4 border elements around it.
+ * and arranges the element such that the border's north-western corner is
+ * at (0, 0).
  *
  * @param bordered_ptr
  */
 void _wlmtk_bordered_set_positions(wlmtk_bordered_t *bordered_ptr)
 {
     int x1, y1, x2, y2;
-    int x_pos, y_pos;
-
-    if (NULL == bordered_ptr->western_border_rectangle_ptr) return;
-
     int margin = bordered_ptr->style.width;
 
     wlmtk_element_get_dimensions(
         bordered_ptr->element_ptr, &x1, &y1, &x2, &y2);
-    x_pos = -x1 + margin;
-    y_pos = -y1 + margin;
-    int width = x2 - x1;
-    int height = y2 - y1;
-    wlmtk_element_set_position(bordered_ptr->element_ptr, x_pos, y_pos);
-
     wlmtk_element_set_position(
-        wlmtk_rectangle_element(bordered_ptr->northern_border_rectangle_ptr),
-        x_pos - margin, y_pos - margin);
-    wlmtk_rectangle_set_size(
-        bordered_ptr->northern_border_rectangle_ptr,
-        width + 2 * margin, margin);
+        bordered_ptr->element_ptr, -x1 + margin, -y1 + margin);
+    bordered_ptr->width = x2 - x1;
+    bordered_ptr->height = y2 - y1;
 
-    wlmtk_element_set_position(
-        wlmtk_rectangle_element(bordered_ptr->eastern_border_rectangle_ptr),
-        x_pos + width, y_pos);
-    wlmtk_rectangle_set_size(
-        bordered_ptr->eastern_border_rectangle_ptr,
-        margin, height);
+    _wlmtk_bordered_place_border_rects(bordered_ptr);
+}
 
-    wlmtk_element_set_position(
-        wlmtk_rectangle_element(bordered_ptr->southern_border_rectangle_ptr),
-        x_pos - margin, y_pos + height);
-    wlmtk_rectangle_set_size(
-        bordered_ptr->southern_border_rectangle_ptr,
-        width + 2 * margin, margin);
+/* ------------------------------------------------------------------------- */
+/** Places the four border rects, from the last layout's width and height. */
+void _wlmtk_bordered_place_border_rects(wlmtk_bordered_t *bordered_ptr)
+{
+    int margin = bordered_ptr->style.width;
+    int width = bordered_ptr->width;
+    int height = bordered_ptr->height;
+
+    _wlmtk_bordered_place_border_rect(
+        bordered_ptr->northern_wlr_scene_rect_ptr,
+        0, 0, width + 2 * margin, margin);
+    _wlmtk_bordered_place_border_rect(
+        bordered_ptr->eastern_wlr_scene_rect_ptr,
+        margin + width, margin, margin, height);
+    _wlmtk_bordered_place_border_rect(
+        bordered_ptr->southern_wlr_scene_rect_ptr,
+        0, margin + height, width + 2 * margin, margin);
+    _wlmtk_bordered_place_border_rect(
+        bordered_ptr->western_wlr_scene_rect_ptr,
+        0, margin, margin, height);
+}
 
-    wlmtk_element_set_position(
-        wlmtk_rectangle_element(bordered_ptr->western_border_rectangle_ptr),
-        x_pos - margin, y_pos);
-    wlmtk_rectangle_set_size(
-        bordered_ptr->western_border_rectangle_ptr,
-        margin, height);
+/* ------------------------------------------------------------------------- */
+/** Sets position and size of `wlr_scene_rect_ptr`, if it exists. */
+void _wlmtk_bordered_place_border_rect(
+    struct wlr_scene_rect *wlr_scene_rect_ptr,
+    int x,
+    int y,
+    int width,
+    int height)
+{
+    if (NULL == wlr_scene_rect_ptr) return;
+    wlr_scene_node_set_position(&wlr_scene_rect_ptr->node, x, y);
+    wlr_scene_rect_set_size(wlr_scene_rect_ptr, width, height);
 }
 
 /* == Unit tests =========================================================== */
@@ -249,69 +437,79 @@ static const wlmtk_margin_style_t test_style = {
     .color = 0xff000000
 };
 
-/** Helper: Tests that the rectangle is positioned as specified. */
-void test_rectangle_pos(bs_test_t *test_ptr, wlmtk_rectangle_t *rect_ptr,
-                        int x, int y, int width, int height)
+/** Helper: Tests that the rect is positioned as specified. */
+void test_rect_pos(bs_test_t *test_ptr, struct wlr_scene_rect *rect_ptr,
+                   int x, int y, int width, int height)
 {
-    wlmtk_element_t *elem_ptr = wlmtk_rectangle_element(rect_ptr);
-    BS_TEST_VERIFY_EQ(test_ptr, x, elem_ptr->x);
-    BS_TEST_VERIFY_EQ(test_ptr, y, elem_ptr->y);
-
-    int x1, y1, x2, y2;
-    wlmtk_element_get_dimensions(elem_ptr, &x1, &y1, &x2, &y2);
-    BS_TEST_VERIFY_EQ(test_ptr, 0, x1);
-    BS_TEST_VERIFY_EQ(test_ptr, 0, y1);
-    BS_TEST_VERIFY_EQ(test_ptr, width, x2 - x1);
-    BS_TEST_VERIFY_EQ(test_ptr, height, y2 - y1);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, rect_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, x, rect_ptr->node.x);
+    BS_TEST_VERIFY_EQ(test_ptr, y, rect_ptr->node.y);
+    BS_TEST_VERIFY_EQ(test_ptr, width, rect_ptr->width);
+    BS_TEST_VERIFY_EQ(test_ptr, height, rect_ptr->height);
 }
 
 /* ------------------------------------------------------------------------- */
 /** Exercises setup and teardown. */
 void test_init_fini(bs_test_t *test_ptr)
 {
+    wlmtk_container_t *fake_parent_ptr = wlmtk_container_create_fake_parent();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fake_parent_ptr);
     wlmtk_fake_element_t *fe_ptr = wlmtk_fake_element_create();
     fe_ptr->dimensions.width = 100;
     fe_ptr->dimensions.height = 20;
     wlmtk_element_set_position(&fe_ptr->element, -10, -4);
+    wlmtk_element_set_visible(&fe_ptr->element, true);
 
     wlmtk_bordered_t bordered;
     BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_bordered_init(
                             &bordered, &fe_ptr->element, &test_style));
-
-    // Positions of border elements.
-    test_rectangle_pos(
-        test_ptr, bordered.northern_border_rectangle_ptr,
-        0, 0, 104, 2);
-    test_rectangle_pos(
-        test_ptr, bordered.eastern_border_rectangle_ptr,
-        102, 2, 2, 20);
-    test_rectangle_pos(
-        test_ptr, bordered.southern_border_rectangle_ptr,
-        0, 22, 104, 2);
-    test_rectangle_pos(
-        test_ptr, bordered.western_border_rectangle_ptr,
-        0, 2, 2, 20);
+    wlmtk_element_t *e_ptr = wlmtk_bordered_element(&bordered);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, fe_ptr->element.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, fe_ptr->element.y);
+    struct wlr_box box = wlmtk_element_get_dimensions_box(e_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 104, box.width);
+    BS_TEST_VERIFY_EQ(test_ptr, 24, box.height);
+
+    // Positions of border rects, created with the scene tree.
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, bordered.northern_wlr_scene_rect_ptr);
+    wlmtk_container_add_element(fake_parent_ptr, e_ptr);
+    test_rect_pos(test_ptr, bordered.northern_wlr_scene_rect_ptr,
+                  0, 0, 104, 2);
+    test_rect_pos(test_ptr, bordered.eastern_wlr_scene_rect_ptr,
+                  102, 2, 2, 20);
+    test_rect_pos(test_ptr, bordered.southern_wlr_scene_rect_ptr,
+                  0, 22, 104, 2);
+    test_rect_pos(test_ptr, bordered.western_wlr_scene_rect_ptr,
+                  0, 2, 2, 20);
 
     // Update layout, test updated positions.
     fe_ptr->dimensions.width = 200;
     fe_ptr->dimensions.height = 120;
     wlmtk_container_update_layout(&bordered.super_container);
-    test_rectangle_pos(
-        test_ptr, bordered.northern_border_rectangle_ptr,
-        0, 0, 204, 2);
-    test_rectangle_pos(
-        test_ptr, bordered.eastern_border_rectangle_ptr,
-        202, 2, 2, 120);
-    test_rectangle_pos(
-        test_ptr, bordered.southern_border_rectangle_ptr,
-        0, 122, 204, 2);
-    test_rectangle_pos(
-        test_ptr, bordered.western_border_rectangle_ptr,
-        0, 2, 2, 120);
+    test_rect_pos(test_ptr, bordered.northern_wlr_scene_rect_ptr,
+                  0, 0, 204, 2);
+    test_rect_pos(test_ptr, bordered.eastern_wlr_scene_rect_ptr,
+                  202, 2, 2, 120);
+    test_rect_pos(test_ptr, bordered.southern_wlr_scene_rect_ptr,
+                  0, 122, 204, 2);
+    test_rect_pos(test_ptr, bordered.western_wlr_scene_rect_ptr,
+                  0, 2, 2, 120);
+
+    // The border is not an element, but accepts the pointer.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 1, bs_dllist_size(&bordered.super_container.elements));
+    wlmtk_pointer_motion_event_t e = { .x = 0, .y = 123 };
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_element_pointer_motion(e_ptr, &e));
+    e = (wlmtk_pointer_motion_event_t){ .x = 210, .y = 1 };
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_element_pointer_motion(e_ptr, &e));
+
+    // Unmapping clears the rects.
+    wlmtk_container_remove_element(fake_parent_ptr, e_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, bordered.western_wlr_scene_rect_ptr);
 
     wlmtk_bordered_fini(&bordered);
-
     wlmtk_element_destroy(&fe_ptr->element);
+    wlmtk_container_destroy_fake_parent(fake_parent_ptr);
 }
 
 /* == End of bordered.c ==================================================== */
@@ -20,16 +20,49 @@
 
 #include "box.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "libbase/libbase.h"
-#include "rectangle.h"
+#define WLR_USE_UNSTABLE
+#include <wlr/types/wlr_scene.h>
+#undef WLR_USE_UNSTABLE
+
+#include "util.h"
 
 /* == Declarations ========================================================= */
 
 static void _wlmtk_box_container_update_layout(
     wlmtk_container_t *container_ptr);
-static bs_dllist_node_t *create_margin(wlmtk_box_t *box_ptr);
+static void _wlmtk_box_layout_from(
+    wlmtk_box_t *box_ptr,
+    size_t first,
+    bs_dllist_node_t *dlnode_ptr);
+static void _wlmtk_box_align_slots(
+    wlmtk_box_t *box_ptr,
+    size_t first,
+    size_t count,
+    bs_dllist_node_t *dlnode_ptr);
+static void _wlmtk_box_reserve_slots(wlmtk_box_t *box_ptr, size_t count);
+static int _wlmtk_box_slot_extent(
+    wlmtk_box_t *box_ptr,
+    const wlmtk_box_slot_t *slot_ptr);
+static void _wlmtk_box_place_margin(
+    wlmtk_box_t *box_ptr,
+    size_t index,
+    const wlmtk_box_slot_t *before_slot_ptr,
+    int position);
+static void _wlmtk_box_truncate_margins(wlmtk_box_t *box_ptr, size_t count);
+static void _wlmtk_box_create_margin_rect(
+    wlmtk_box_t *box_ptr,
+    wlmtk_box_margin_t *margin_ptr);
+
+static struct wlr_scene_node *_wlmtk_box_element_create_scene_node(
+    wlmtk_element_t *element_ptr,
+    struct wlr_scene_tree *wlr_scene_tree_ptr);
+static void _wlmtk_box_handle_wlr_scene_tree_destroy(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
 
 /* == Data ================================================================= */
 
@@ -38,6 +71,11 @@ static const wlmtk_container_vmt_t box_container_vmt = {
     .update_layout = _wlmtk_box_container_update_layout,
 };
 
+/** Virtual method table: @ref wlmtk_element_t at @ref wlmtk_box_t level. */
+static const wlmtk_element_vmt_t box_element_vmt = {
+    .create_scene_node = _wlmtk_box_element_create_scene_node,
+};
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -53,24 +91,10 @@ bool wlmtk_box_init(
     }
     box_ptr->orig_super_container_vmt = wlmtk_container_extend(
         &box_ptr->super_container, &box_container_vmt);
-
-    if (!wlmtk_container_init(&box_ptr->element_container)) {
-        wlmtk_box_fini(box_ptr);
-        return false;
-    }
-    wlmtk_element_set_visible(&box_ptr->element_container.super_element, true);
-    wlmtk_container_add_element(&box_ptr->super_container,
-                                &box_ptr->element_container.super_element);
-    if (!wlmtk_container_init(&box_ptr->margin_container)) {
-        wlmtk_box_fini(box_ptr);
-        return false;
-    }
-    wlmtk_element_set_visible(&box_ptr->margin_container.super_element, true);
-    // Keep margins behind the box's elements.
-    wlmtk_container_add_element_atop(
-        &box_ptr->super_container,
-        NULL,
-        &box_ptr->margin_container.super_element);
+    box_ptr->orig_super_element_vmt = wlmtk_element_extend(
+        &box_ptr->super_container.super_element, &box_element_vmt);
+    // Boxes hold flat rows of elements (menu items, tiles): Scan an array.
+    wlmtk_container_set_child_array(&box_ptr->super_container, true);
 
     box_ptr->orientation = orientation;
     return true;
@@ -79,20 +103,10 @@ bool wlmtk_box_init(
 /* ------------------------------------------------------------------------- */
 void wlmtk_box_fini(wlmtk_box_t *box_ptr)
 {
-    if (NULL != box_ptr->element_container.super_element.parent_container_ptr) {
-        wlmtk_container_remove_element(
-            &box_ptr->super_container,
-            &box_ptr->element_container.super_element);
-        wlmtk_container_fini(&box_ptr->element_container);
-    }
-    if (NULL != box_ptr->margin_container.super_element.parent_container_ptr) {
-        wlmtk_container_remove_element(
-            &box_ptr->super_container,
-            &box_ptr->margin_container.super_element);
-        wlmtk_container_fini(&box_ptr->margin_container);
-    }
-
     wlmtk_container_fini(&box_ptr->super_container);
+    if (NULL != box_ptr->slots_ptr) free(box_ptr->slots_ptr);
+    if (NULL != box_ptr->scratch_ptr) free(box_ptr->scratch_ptr);
+    if (NULL != box_ptr->margins_ptr) free(box_ptr->margins_ptr);
     *box_ptr = (wlmtk_box_t){};
 }
 
@@ -101,7 +115,7 @@ void wlmtk_box_add_element_front(
     wlmtk_box_t *box_ptr,
     wlmtk_element_t *element_ptr)
 {
-    wlmtk_container_add_element(&box_ptr->element_container, element_ptr);
+    wlmtk_container_add_element(&box_ptr->super_container, element_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -110,13 +124,63 @@ void wlmtk_box_add_element_back(
     wlmtk_element_t *element_ptr)
 {
     wlmtk_container_add_element_atop(
-        &box_ptr->element_container, NULL, element_ptr);
+        &box_ptr->super_container, NULL, element_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
 void wlmtk_box_remove_element(wlmtk_box_t *box_ptr, wlmtk_element_t *element_ptr)
 {
-    wlmtk_container_remove_element(&box_ptr->element_container, element_ptr);
+    wlmtk_container_remove_element(&box_ptr->super_container, element_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_box_move_element_before(
+    wlmtk_box_t *box_ptr,
+    wlmtk_element_t *element_ptr,
+    wlmtk_element_t *before_element_ptr)
+{
+    wlmtk_container_t *container_ptr = &box_ptr->super_container;
+    BS_ASSERT(element_ptr->parent_container_ptr == container_ptr);
+    BS_ASSERT(NULL == before_element_ptr ||
+              before_element_ptr->parent_container_ptr == container_ptr);
+
+    bs_dllist_node_t *dlnode_ptr = wlmtk_dlnode_from_element(element_ptr);
+    bs_dllist_node_t *before_dlnode_ptr = NULL;
+    if (NULL != before_element_ptr) {
+        before_dlnode_ptr = wlmtk_dlnode_from_element(before_element_ptr);
+    }
+    // Already in place?
+    if (dlnode_ptr == before_dlnode_ptr ||
+        dlnode_ptr->next_ptr == before_dlnode_ptr) return;
+
+    bs_dllist_remove(&container_ptr->elements, dlnode_ptr);
+    if (NULL == before_dlnode_ptr) {
+        bs_dllist_push_back(&container_ptr->elements, dlnode_ptr);
+    } else {
+        bs_dllist_insert_node_before(
+            &container_ptr->elements, before_dlnode_ptr, dlnode_ptr);
+    }
+    // Scene nodes stay in their stacking order: The box' elements are laid
+    // out side by side, and do not overlap.
+    wlmtk_container_update_layout(container_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_box_set_style(
+    wlmtk_box_t *box_ptr,
+    const wlmtk_margin_style_t *style_ptr)
+{
+    box_ptr->style = *style_ptr;
+    float color[4];
+    bs_gfxbuf_argb8888_to_floats(
+        box_ptr->style.color, &color[0], &color[1], &color[2], &color[3]);
+    for (size_t i = 0; i < box_ptr->margins; ++i) {
+        wlmtk_box_margin_t *margin_ptr = &box_ptr->margins_ptr[i];
+        if (NULL == margin_ptr->wlr_scene_rect_ptr) continue;
+        wlr_scene_rect_set_color(margin_ptr->wlr_scene_rect_ptr, color);
+    }
+    // All positions depend on the margin's width.
+    box_ptr->slots = 0;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -131,8 +195,14 @@ wlmtk_element_t *wlmtk_box_element(wlmtk_box_t *box_ptr)
 /**
  * Updates the layout of the box.
  *
- * Steps through all visible elements, and sets their position to be
- * left-to-right. Also updates and repositions all margin elements.
+ * Positions the visible elements left-to-right (or top-to-bottom), with
+ * margins in between. Invisible elements are skipped, and not
+ * otherwise accessed.
+ *
+ * Incremental: Elements are skipped up to the first one that was added,
+ * removed, resized or changed visibility since the last layout, as told by
+ * @ref wlmtk_element_t::extents_serial. Those keep their position, and the
+ * margins between them are left alone.
  *
  * @param container_ptr
  */
@@ -141,107 +211,369 @@ void _wlmtk_box_container_update_layout(
 {
     wlmtk_box_t *box_ptr = BS_CONTAINER_OF(
         container_ptr, wlmtk_box_t, super_container);
-    wlmtk_element_t *margin_element_ptr = NULL;
-
-    int margin_x = 0;
-    int margin_y = 0;
-    int margin_width = box_ptr->style.width;
-    int margin_height = box_ptr->style.width;
 
-    size_t visible_elements = 0;
-    for (bs_dllist_node_t *dlnode_ptr = box_ptr->element_container.elements.head_ptr;
-         dlnode_ptr != NULL;
-         dlnode_ptr = dlnode_ptr->next_ptr) {
+    size_t first = 0;
+    bs_dllist_node_t *dlnode_ptr =
+        box_ptr->super_container.elements.head_ptr;
+    for (; NULL != dlnode_ptr && first < box_ptr->slots;
+         dlnode_ptr = dlnode_ptr->next_ptr, ++first) {
         wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
-        if (element_ptr->visible) visible_elements++;
+        const wlmtk_box_slot_t *slot_ptr = &box_ptr->slots_ptr[first];
+        if (slot_ptr->element_ptr != element_ptr ||
+            slot_ptr->extents_serial != element_ptr->extents_serial) break;
+    }
+    if (NULL != dlnode_ptr || first < box_ptr->slots) {
+        _wlmtk_box_layout_from(box_ptr, first, dlnode_ptr);
     }
 
+    // Run the base class' update layout; may update pointer focus.
+    // We do this only after having updated the position of the elements.
+    box_ptr->orig_super_container_vmt.update_layout(container_ptr);
+
+    // configure parent container.
+    if (NULL != container_ptr->super_element.parent_container_ptr) {
+        wlmtk_container_update_layout(
+            container_ptr->super_element.parent_container_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Lays out the elements from position `first` on. The slots before `first`
+ * are current, and provide the prefix sum to continue from.
+ *
+ * @param box_ptr
+ * @param first               Index of the first element that changed.
+ * @param dlnode_ptr          The dlnode of the element at `first`. May be
+ *                            NULL, if the elements from `first` were removed.
+ */
+void _wlmtk_box_layout_from(
+    wlmtk_box_t *box_ptr,
+    size_t first,
+    bs_dllist_node_t *dlnode_ptr)
+{
+    size_t count = first;
+    for (bs_dllist_node_t *d_ptr = dlnode_ptr;
+         NULL != d_ptr;
+         d_ptr = d_ptr->next_ptr) ++count;
+    _wlmtk_box_reserve_slots(box_ptr, count);
+    _wlmtk_box_align_slots(box_ptr, first, count, dlnode_ptr);
+
+    // Continues from the prefix: Position, and the last visible element for
+    // sizing the next margin.
     int position = 0;
-    bs_dllist_node_t *margin_dlnode_ptr = box_ptr->margin_container.elements.head_ptr;
-    for (bs_dllist_node_t *dlnode_ptr = box_ptr->element_container.elements.head_ptr;
-         dlnode_ptr != NULL;
-         dlnode_ptr = dlnode_ptr->next_ptr) {
-        wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
-        if (!element_ptr->visible) continue;
+    size_t visible_before = 0;
+    const wlmtk_box_slot_t *before_slot_ptr = NULL;
+    if (0 < first) {
+        const wlmtk_box_slot_t *slot_ptr = &box_ptr->slots_ptr[first - 1];
+        position = slot_ptr->position;
+        visible_before = slot_ptr->visible_before;
+        if (slot_ptr->visible) {
+            position += _wlmtk_box_slot_extent(box_ptr, slot_ptr) +
+                box_ptr->style.width;
+            ++visible_before;
+        }
+        for (size_t i = first; 0 < i && NULL == before_slot_ptr; --i) {
+            if (box_ptr->slots_ptr[i - 1].visible) {
+                before_slot_ptr = &box_ptr->slots_ptr[i - 1];
+            }
+        }
+    }
 
-        int left, top, right, bottom;
-        wlmtk_element_get_dimensions(element_ptr, &left, &top, &right, &bottom);
-        int x, y;
-        wlmtk_element_get_position(element_ptr, &x, &y);
+    // The margin after the last visible element of the prefix.
+    size_t margin = 0 < visible_before ? visible_before - 1 : 0;
+
+    for (size_t i = first; i < count; ++i) {
+        wlmtk_box_slot_t *slot_ptr = &box_ptr->slots_ptr[i];
+        slot_ptr->position = position;
+        slot_ptr->visible_before = visible_before;
+        if (!slot_ptr->visible) continue;
+
+        // A margin goes between the previous and this element. Placed here,
+        // so there's no need to look ahead for further visible elements.
+        if (NULL != before_slot_ptr) {
+            _wlmtk_box_place_margin(
+                box_ptr,
+                margin++,
+                before_slot_ptr,
+                position - (int)box_ptr->style.width);
+        }
 
+        int x, y;
+        wlmtk_element_get_position(slot_ptr->element_ptr, &x, &y);
         switch (box_ptr->orientation) {
         case WLMTK_BOX_HORIZONTAL:
-            x = position - left;
-            margin_x = position + right - left;
-            margin_height = bottom - top;
-            position = margin_x + box_ptr->style.width;
+            x = position - slot_ptr->left;
             break;
-
         case WLMTK_BOX_VERTICAL:
-            y = position - top;
-            margin_y = position + bottom - top;
-            margin_width = right - left;
-            position = margin_y + box_ptr->style.width;
+            y = position - slot_ptr->top;
             break;
-
         default:
             bs_log(BS_FATAL, "Weird orientation %d.", box_ptr->orientation);
         }
-        wlmtk_element_set_position(element_ptr, x, y);
-        visible_elements--;
+        // Elements that only moved along keep their dimensions.
+        if (x != slot_ptr->element_ptr->x || y != slot_ptr->element_ptr->y) {
+            wlmtk_element_set_position(slot_ptr->element_ptr, x, y);
+        }
 
-        // Early exit: No margin needed, if there's no next element.
-        if (NULL == dlnode_ptr->next_ptr || 0 >= visible_elements) break;
+        position += _wlmtk_box_slot_extent(box_ptr, slot_ptr) +
+            box_ptr->style.width;
+        ++visible_before;
+        before_slot_ptr = slot_ptr;
+    }
 
-        // If required: Create new margin, then position the margin element.
-        if (NULL == margin_dlnode_ptr) {
-            margin_dlnode_ptr = create_margin(box_ptr);
+    _wlmtk_box_truncate_margins(box_ptr, margin);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Updates the slots from `first` on to hold the elements from `dlnode_ptr`.
+ *
+ * Elements that were just shifted by one insertion or removal, or that are
+ * at the same index, keep their former slot if their extents serial is
+ * unchanged: Their dimensions are not queried again.
+ *
+ * @param box_ptr
+ * @param first
+ * @param count               Total number of elements.
+ * @param dlnode_ptr          The dlnode of the element at `first`.
+ */
+void _wlmtk_box_align_slots(
+    wlmtk_box_t *box_ptr,
+    size_t first,
+    size_t count,
+    bs_dllist_node_t *dlnode_ptr)
+{
+    size_t j = first;
+    for (size_t i = first; i < count; ++i, dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
+        wlmtk_box_slot_t *slot_ptr = &box_ptr->scratch_ptr[i];
+
+        const wlmtk_box_slot_t *former_ptr = NULL;
+        if (j < box_ptr->slots &&
+            box_ptr->slots_ptr[j].element_ptr == element_ptr) {
+            former_ptr = &box_ptr->slots_ptr[j++];
+        } else if (j + 1 < box_ptr->slots &&
+                   box_ptr->slots_ptr[j + 1].element_ptr == element_ptr) {
+            former_ptr = &box_ptr->slots_ptr[j + 1];
+            j += 2;
         }
-        margin_element_ptr = wlmtk_element_from_dlnode(margin_dlnode_ptr);
-        wlmtk_element_set_position(margin_element_ptr, margin_x, margin_y);
-        wlmtk_rectangle_set_size(
-            wlmtk_rectangle_from_element(margin_element_ptr),
-            margin_width, margin_height);
 
-        margin_dlnode_ptr = margin_dlnode_ptr->next_ptr;
+        if (NULL != former_ptr &&
+            former_ptr->extents_serial == element_ptr->extents_serial) {
+            *slot_ptr = *former_ptr;
+            continue;
+        }
+        *slot_ptr = (wlmtk_box_slot_t){
+            .element_ptr = element_ptr,
+            .extents_serial = element_ptr->extents_serial,
+            .visible = element_ptr->visible
+        };
+        if (!slot_ptr->visible) continue;
+        wlmtk_element_get_dimensions(
+            element_ptr,
+            &slot_ptr->left, &slot_ptr->top,
+            &slot_ptr->right, &slot_ptr->bottom);
     }
 
-    // Remove excess margin nodes.
-    while (NULL != margin_dlnode_ptr) {
-        margin_element_ptr = wlmtk_element_from_dlnode(margin_dlnode_ptr);
-        margin_dlnode_ptr = margin_dlnode_ptr->next_ptr;
-        wlmtk_container_remove_element(
-            &box_ptr->margin_container, margin_element_ptr);
-        wlmtk_element_destroy(margin_element_ptr);
+    if (first < count) {
+        memcpy(&box_ptr->slots_ptr[first], &box_ptr->scratch_ptr[first],
+               (count - first) * sizeof(wlmtk_box_slot_t));
     }
+    box_ptr->slots = count;
+}
 
-    // Run the base class' update layout; may update pointer focus.
-    // We do this only after having updated the position of the elements.
-    box_ptr->orig_super_container_vmt.update_layout(container_ptr);
+/* ------------------------------------------------------------------------- */
+/** Grows @ref wlmtk_box_t::slots_ptr to hold at least `count` elements. */
+void _wlmtk_box_reserve_slots(wlmtk_box_t *box_ptr, size_t count)
+{
+    if (count <= box_ptr->slots_capacity) return;
+
+    size_t capacity = BS_MAX((size_t)8, 2 * box_ptr->slots_capacity);
+    while (capacity < count) capacity *= 2;
+    wlmtk_box_slot_t *slots_ptr = logged_calloc(
+        capacity, sizeof(wlmtk_box_slot_t));
+    BS_ASSERT(NULL != slots_ptr);
+    wlmtk_box_slot_t *scratch_ptr = logged_calloc(
+        capacity, sizeof(wlmtk_box_slot_t));
+    BS_ASSERT(NULL != scratch_ptr);
+
+    if (0 < box_ptr->slots) {
+        memcpy(slots_ptr, box_ptr->slots_ptr,
+               box_ptr->slots * sizeof(wlmtk_box_slot_t));
+    }
+    if (NULL != box_ptr->slots_ptr) free(box_ptr->slots_ptr);
+    if (NULL != box_ptr->scratch_ptr) free(box_ptr->scratch_ptr);
+    box_ptr->slots_ptr = slots_ptr;
+    box_ptr->scratch_ptr = scratch_ptr;
+    box_ptr->slots_capacity = capacity;
+}
 
-    // configure parent container.
-    if (NULL != container_ptr->super_element.parent_container_ptr) {
-        wlmtk_container_update_layout(
-            container_ptr->super_element.parent_container_ptr);
+/* ------------------------------------------------------------------------- */
+/** @return The extent of the slot's element in the box's orientation. */
+int _wlmtk_box_slot_extent(
+    wlmtk_box_t *box_ptr,
+    const wlmtk_box_slot_t *slot_ptr)
+{
+    if (WLMTK_BOX_HORIZONTAL == box_ptr->orientation) {
+        return slot_ptr->right - slot_ptr->left;
     }
+    return slot_ptr->bottom - slot_ptr->top;
 }
 
 /* ------------------------------------------------------------------------- */
-/** Creates a new margin element, and returns the dlnode. */
-bs_dllist_node_t *create_margin(wlmtk_box_t *box_ptr)
+/**
+ * Places the margin at `position`, sized across to match the element before.
+ * Leaves the margin alone if unchanged.
+ *
+ * @param box_ptr
+ * @param index               Index of the margin. Up to the number of
+ *                            margins: Then, a margin is appended.
+ * @param before_slot_ptr     Slot of the visible element before the margin.
+ * @param position            Position of the margin, in the orientation.
+ */
+void _wlmtk_box_place_margin(
+    wlmtk_box_t *box_ptr,
+    size_t index,
+    const wlmtk_box_slot_t *before_slot_ptr,
+    int position)
 {
-    wlmtk_rectangle_t *rect_ptr = wlmtk_rectangle_create(
-        0, 0, box_ptr->style.color);
-    BS_ASSERT(NULL != rect_ptr);
+    wlmtk_box_margin_t m = {
+        .width = (int)box_ptr->style.width,
+        .height = (int)box_ptr->style.width };
+    if (WLMTK_BOX_HORIZONTAL == box_ptr->orientation) {
+        m.x = position;
+        m.height = before_slot_ptr->bottom - before_slot_ptr->top;
+    } else {
+        m.y = position;
+        m.width = before_slot_ptr->right - before_slot_ptr->left;
+    }
 
-    wlmtk_container_add_element_atop(
-        &box_ptr->margin_container,
-        NULL,
-        wlmtk_rectangle_element(rect_ptr));
-    wlmtk_element_set_visible(
-        wlmtk_rectangle_element(rect_ptr), true);
+    BS_ASSERT(index <= box_ptr->margins);
+    if (index == box_ptr->margins) {
+        if (box_ptr->margins == box_ptr->margins_capacity) {
+            size_t capacity = BS_MAX((size_t)8, 2 * box_ptr->margins_capacity);
+            wlmtk_box_margin_t *margins_ptr = logged_calloc(
+                capacity, sizeof(wlmtk_box_margin_t));
+            BS_ASSERT(NULL != margins_ptr);
+            if (0 < box_ptr->margins) {
+                memcpy(margins_ptr, box_ptr->margins_ptr,
+                       box_ptr->margins * sizeof(wlmtk_box_margin_t));
+            }
+            if (NULL != box_ptr->margins_ptr) free(box_ptr->margins_ptr);
+            box_ptr->margins_ptr = margins_ptr;
+            box_ptr->margins_capacity = capacity;
+        }
+        box_ptr->margins_ptr[box_ptr->margins++] = m;
+        if (NULL != box_ptr->super_container.wlr_scene_tree_ptr) {
+            _wlmtk_box_create_margin_rect(
+                box_ptr, &box_ptr->margins_ptr[index]);
+        }
+        return;
+    }
 
-    return wlmtk_dlnode_from_element(wlmtk_rectangle_element(rect_ptr));
+    wlmtk_box_margin_t *margin_ptr = &box_ptr->margins_ptr[index];
+    if (m.x == margin_ptr->x && m.y == margin_ptr->y &&
+        m.width == margin_ptr->width && m.height == margin_ptr->height) {
+        return;
+    }
+    m.wlr_scene_rect_ptr = margin_ptr->wlr_scene_rect_ptr;
+    *margin_ptr = m;
+    if (NULL != margin_ptr->wlr_scene_rect_ptr) {
+        wlr_scene_node_set_position(
+            &margin_ptr->wlr_scene_rect_ptr->node, m.x, m.y);
+        wlr_scene_rect_set_size(
+            margin_ptr->wlr_scene_rect_ptr, m.width, m.height);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Removes the margins beyond `count`. */
+void _wlmtk_box_truncate_margins(wlmtk_box_t *box_ptr, size_t count)
+{
+    if (count >= box_ptr->margins) return;
+    for (size_t i = count; i < box_ptr->margins; ++i) {
+        wlmtk_box_margin_t *margin_ptr = &box_ptr->margins_ptr[i];
+        if (NULL == margin_ptr->wlr_scene_rect_ptr) continue;
+        wlr_scene_node_destroy(&margin_ptr->wlr_scene_rect_ptr->node);
+        margin_ptr->wlr_scene_rect_ptr = NULL;
+    }
+    box_ptr->margins = count;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Creates the scene rect of `margin_ptr`, at the bottom of the box' tree. */
+void _wlmtk_box_create_margin_rect(
+    wlmtk_box_t *box_ptr,
+    wlmtk_box_margin_t *margin_ptr)
+{
+    float color[4];
+    bs_gfxbuf_argb8888_to_floats(
+        box_ptr->style.color, &color[0], &color[1], &color[2], &color[3]);
+    margin_ptr->wlr_scene_rect_ptr = wlr_scene_rect_create(
+        box_ptr->super_container.wlr_scene_tree_ptr,
+        margin_ptr->width,
+        margin_ptr->height,
+        color);
+    if (NULL == margin_ptr->wlr_scene_rect_ptr) {
+        bs_log(BS_WARNING, "Failed wlr_scene_rect_create(%p, %d, %d, %p)",
+               box_ptr->super_container.wlr_scene_tree_ptr,
+               margin_ptr->width, margin_ptr->height, color);
+        return;
+    }
+    wlr_scene_node_set_position(
+        &margin_ptr->wlr_scene_rect_ptr->node, margin_ptr->x, margin_ptr->y);
+    wlr_scene_node_lower_to_bottom(&margin_ptr->wlr_scene_rect_ptr->node);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_element_vmt_t::create_scene_node. Extends the
+ * container's scene tree by a `struct wlr_scene_rect` for each margin, at
+ * the bottom of the tree. The margins are not elements: They show in the
+ * gaps between elements, and are never looked at for pointer input.
+ *
+ * @param element_ptr
+ * @param wlr_scene_tree_ptr
+ */
+struct wlr_scene_node *_wlmtk_box_element_create_scene_node(
+    wlmtk_element_t *element_ptr,
+    struct wlr_scene_tree *wlr_scene_tree_ptr)
+{
+    wlmtk_box_t *box_ptr = BS_CONTAINER_OF(
+        element_ptr, wlmtk_box_t, super_container.super_element);
+
+    struct wlr_scene_node *wlr_scene_node_ptr =
+        box_ptr->orig_super_element_vmt.create_scene_node(
+            element_ptr, wlr_scene_tree_ptr);
+    if (NULL == box_ptr->super_container.wlr_scene_tree_ptr) {
+        return wlr_scene_node_ptr;
+    }
+    wlmtk_util_connect_listener_signal(
+        &box_ptr->super_container.wlr_scene_tree_ptr->node.events.destroy,
+        &box_ptr->wlr_scene_tree_destroy_listener,
+        _wlmtk_box_handle_wlr_scene_tree_destroy);
+
+    for (size_t i = 0; i < box_ptr->margins; ++i) {
+        _wlmtk_box_create_margin_rect(box_ptr, &box_ptr->margins_ptr[i]);
+    }
+    return wlr_scene_node_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Clears the references to the margin rects, when the tree is destroyed. */
+void _wlmtk_box_handle_wlr_scene_tree_destroy(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmtk_box_t *box_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmtk_box_t, wlr_scene_tree_destroy_listener);
+
+    // The rects are children of the tree, and get destroyed along.
+    for (size_t i = 0; i < box_ptr->margins; ++i) {
+        box_ptr->margins_ptr[i].wlr_scene_rect_ptr = NULL;
+    }
+    wlmtk_util_disconnect_listener(&box_ptr->wlr_scene_tree_destroy_listener);
 }
 
 /* == Unit tests =========================================================== */
@@ -249,11 +581,17 @@ bs_dllist_node_t *create_margin(wlmtk_box_t *box_ptr)
 static void test_init_fini(bs_test_t *test_ptr);
 static void test_layout_horizontal(bs_test_t *test_ptr);
 static void test_layout_vertical(bs_test_t *test_ptr);
+static void test_incremental(bs_test_t *test_ptr);
+static void test_margins(bs_test_t *test_ptr);
+static void test_move(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_box_test_cases[] = {
     { 1, "init_fini", test_init_fini },
     { 1, "layout_horizontal", test_layout_horizontal },
     { 1, "layout_vertical", test_layout_vertical },
+    { 1, "incremental", test_incremental },
+    { 1, "margins", test_margins },
+    { 1, "move", test_move },
     { 0, NULL, NULL }
 };
 
@@ -301,11 +639,11 @@ void test_layout_horizontal(bs_test_t *test_ptr)
 
     // Note: Elements are added "in front" == left.
     wlmtk_box_add_element_front(&box, &e1_ptr->element);
-    BS_TEST_VERIFY_EQ(test_ptr, 0, bs_dllist_size(&box.margin_container.elements));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, box.margins);
     wlmtk_box_add_element_front(&box, &e2_ptr->element);
-    BS_TEST_VERIFY_EQ(test_ptr, 0, bs_dllist_size(&box.margin_container.elements));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, box.margins);
     wlmtk_box_add_element_front(&box, &e3_ptr->element);
-    BS_TEST_VERIFY_EQ(test_ptr, 1, bs_dllist_size(&box.margin_container.elements));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, box.margins);
 
     // Layout: e3 | e1 (e2 is invisible).
     BS_TEST_VERIFY_EQ(test_ptr, 42, e1_ptr->element.x);
@@ -320,20 +658,20 @@ void test_layout_horizontal(bs_test_t *test_ptr)
     BS_TEST_VERIFY_EQ(test_ptr, 64, e1_ptr->element.x);
     BS_TEST_VERIFY_EQ(test_ptr, 42, e2_ptr->element.x);
     BS_TEST_VERIFY_EQ(test_ptr, 0, e3_ptr->element.x);
-    BS_TEST_VERIFY_EQ(test_ptr, 2, bs_dllist_size(&box.margin_container.elements));
+    BS_TEST_VERIFY_EQ(test_ptr, 2, box.margins);
 
     wlmtk_element_set_visible(&e1_ptr->element, false);
-    BS_TEST_VERIFY_EQ(test_ptr, 1, bs_dllist_size(&box.margin_container.elements));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, box.margins);
     wlmtk_element_set_visible(&e1_ptr->element, true);
 
     // Remove elements. Must update each.
     wlmtk_box_remove_element(&box, &e3_ptr->element);
     BS_TEST_VERIFY_EQ(test_ptr, 22, e1_ptr->element.x);
     BS_TEST_VERIFY_EQ(test_ptr, 0, e2_ptr->element.x);
-    BS_TEST_VERIFY_EQ(test_ptr, 1, bs_dllist_size(&box.margin_container.elements));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, box.margins);
     wlmtk_box_remove_element(&box, &e2_ptr->element);
     BS_TEST_VERIFY_EQ(test_ptr, 0, e1_ptr->element.x);
-    BS_TEST_VERIFY_EQ(test_ptr, 0, bs_dllist_size(&box.margin_container.elements));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, box.margins);
     wlmtk_box_remove_element(&box, &e1_ptr->element);
 
     wlmtk_element_destroy(&e3_ptr->element);
@@ -378,4 +716,169 @@ void test_layout_vertical(bs_test_t *test_ptr)
     wlmtk_box_fini(&box);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests that only elements from the first changed one are re-laid out. */
+void test_incremental(bs_test_t *test_ptr)
+{
+    wlmtk_box_t box;
+    wlmtk_box_init(&box, WLMTK_BOX_HORIZONTAL, &test_style);
+
+    wlmtk_fake_element_t *e1_ptr = wlmtk_fake_element_create();
+    wlmtk_element_set_visible(&e1_ptr->element, true);
+    e1_ptr->dimensions.width = 10;
+    e1_ptr->dimensions.height = 1;
+    wlmtk_fake_element_t *e2_ptr = wlmtk_fake_element_create();
+    wlmtk_element_set_visible(&e2_ptr->element, true);
+    e2_ptr->dimensions.width = 20;
+    e2_ptr->dimensions.height = 2;
+    wlmtk_fake_element_t *e3_ptr = wlmtk_fake_element_create();
+    wlmtk_element_set_visible(&e3_ptr->element, true);
+    e3_ptr->dimensions.width = 40;
+    e3_ptr->dimensions.height = 4;
+
+    wlmtk_box_add_element_back(&box, &e1_ptr->element);
+    wlmtk_box_add_element_back(&box, &e2_ptr->element);
+    wlmtk_box_add_element_back(&box, &e3_ptr->element);
+
+    // Layout: e1 | e2 | e3.
+    BS_TEST_VERIFY_EQ(test_ptr, 0, e1_ptr->element.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 12, e2_ptr->element.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 34, e3_ptr->element.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, box.slots);
+
+    // Not reported: e1 keeps its cached width. Only e2 changed, so it and
+    // e3 are re-positioned.
+    e1_ptr->dimensions.width = 100;
+    e2_ptr->dimensions.width = 30;
+    wlmtk_element_invalidate_extents(&e2_ptr->element);
+    wlmtk_container_update_layout(&box.super_container);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, e1_ptr->element.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 12, e2_ptr->element.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 44, e3_ptr->element.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, box.margins_ptr[0].x);
+    BS_TEST_VERIFY_EQ(test_ptr, 42, box.margins_ptr[1].x);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, box.margins_ptr[1].height);
+
+    // A new style forces a full layout.
+    wlmtk_margin_style_t style = { .width = 1, .color = 0xff000000 };
+    wlmtk_box_set_style(&box, &style);
+    wlmtk_container_update_layout(&box.super_container);
+    BS_TEST_VERIFY_EQ(test_ptr, 101, e2_ptr->element.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 132, e3_ptr->element.x);
+
+    wlmtk_box_remove_element(&box, &e3_ptr->element);
+    wlmtk_box_remove_element(&box, &e2_ptr->element);
+    wlmtk_box_remove_element(&box, &e1_ptr->element);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, box.slots);
+
+    wlmtk_element_destroy(&e3_ptr->element);
+    wlmtk_element_destroy(&e2_ptr->element);
+    wlmtk_element_destroy(&e1_ptr->element);
+    wlmtk_box_fini(&box);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests moving elements within the box. */
+void test_move(bs_test_t *test_ptr)
+{
+    wlmtk_box_t box;
+    wlmtk_box_init(&box, WLMTK_BOX_HORIZONTAL, &test_style);
+
+    wlmtk_fake_element_t *e_ptrs[3];
+    int widths[3] = { 10, 20, 40 };
+    for (size_t i = 0; i < 3; ++i) {
+        e_ptrs[i] = wlmtk_fake_element_create();
+        wlmtk_element_set_visible(&e_ptrs[i]->element, true);
+        e_ptrs[i]->dimensions.width = widths[i];
+        e_ptrs[i]->dimensions.height = 1;
+        wlmtk_box_add_element_back(&box, &e_ptrs[i]->element);
+    }
+
+    // Layout: e3 | e1 | e2.
+    wlmtk_box_move_element_before(
+        &box, &e_ptrs[2]->element, &e_ptrs[0]->element);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, e_ptrs[2]->element.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 42, e_ptrs[0]->element.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 54, e_ptrs[1]->element.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 40, box.margins_ptr[0].x);
+
+    // Moving in place does nothing. To the back: e1 | e2 | e3 again.
+    wlmtk_box_move_element_before(
+        &box, &e_ptrs[0]->element, &e_ptrs[1]->element);
+    BS_TEST_VERIFY_EQ(test_ptr, 42, e_ptrs[0]->element.x);
+    wlmtk_box_move_element_before(&box, &e_ptrs[2]->element, NULL);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, e_ptrs[0]->element.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 12, e_ptrs[1]->element.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 34, e_ptrs[2]->element.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, box.slots);
+
+    for (size_t i = 0; i < 3; ++i) {
+        wlmtk_box_remove_element(&box, &e_ptrs[i]->element);
+        wlmtk_element_destroy(&e_ptrs[i]->element);
+    }
+    wlmtk_box_fini(&box);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests that margins are scene rects at the bottom of the box' tree. */
+void test_margins(bs_test_t *test_ptr)
+{
+    wlmtk_container_t *fake_parent_ptr = wlmtk_container_create_fake_parent();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fake_parent_ptr);
+    wlmtk_box_t box;
+    wlmtk_box_init(&box, WLMTK_BOX_VERTICAL, &test_style);
+    wlmtk_element_set_visible(wlmtk_box_element(&box), true);
+
+    wlmtk_fake_element_t *e1_ptr = wlmtk_fake_element_create();
+    wlmtk_element_set_visible(&e1_ptr->element, true);
+    e1_ptr->dimensions.width = 100;
+    e1_ptr->dimensions.height = 10;
+    wlmtk_fake_element_t *e2_ptr = wlmtk_fake_element_create();
+    wlmtk_element_set_visible(&e2_ptr->element, true);
+    e2_ptr->dimensions.width = 100;
+    e2_ptr->dimensions.height = 20;
+    wlmtk_box_add_element_back(&box, &e1_ptr->element);
+    wlmtk_box_add_element_back(&box, &e2_ptr->element);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, box.margins);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &box.super_container, e1_ptr->element.parent_container_ptr);
+
+    // Mapping creates the rect of the existing margin, in the same tree as
+    // the elements. At the bottom.
+    wlmtk_container_add_element(fake_parent_ptr, wlmtk_box_element(&box));
+    struct wlr_scene_tree *tree_ptr = box.super_container.wlr_scene_tree_ptr;
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, tree_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, wl_list_length(&tree_ptr->children));
+    struct wlr_scene_rect *rect_ptr = box.margins_ptr[0].wlr_scene_rect_ptr;
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, rect_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, tree_ptr->children.next, &rect_ptr->node.link);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, rect_ptr->node.y);
+    BS_TEST_VERIFY_EQ(test_ptr, 100, rect_ptr->width);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, rect_ptr->height);
+
+    // Resizing e1 moves the rect. Removing e2 removes it.
+    e1_ptr->dimensions.height = 30;
+    wlmtk_element_invalidate_extents(&e1_ptr->element);
+    wlmtk_container_update_layout(&box.super_container);
+    BS_TEST_VERIFY_EQ(test_ptr, 30, rect_ptr->node.y);
+    wlmtk_box_remove_element(&box, &e2_ptr->element);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, box.margins);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wl_list_length(&tree_ptr->children));
+
+    // Unmapping, then mapping again, re-creates the rects.
+    wlmtk_box_add_element_back(&box, &e2_ptr->element);
+    wlmtk_container_remove_element(fake_parent_ptr, wlmtk_box_element(&box));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, box.margins_ptr[0].wlr_scene_rect_ptr);
+    wlmtk_container_add_element(fake_parent_ptr, wlmtk_box_element(&box));
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, box.margins_ptr[0].wlr_scene_rect_ptr);
+    wlmtk_container_remove_element(fake_parent_ptr, wlmtk_box_element(&box));
+
+    wlmtk_box_remove_element(&box, &e2_ptr->element);
+    wlmtk_box_remove_element(&box, &e1_ptr->element);
+    wlmtk_element_destroy(&e2_ptr->element);
+    wlmtk_element_destroy(&e1_ptr->element);
+    wlmtk_box_fini(&box);
+    wlmtk_container_destroy_fake_parent(fake_parent_ptr);
+}
+
 /* == End of box.c ========================================================= */
@@ -26,8 +26,11 @@
 #define WLR_USE_UNSTABLE
 #include <wlr/types/wlr_buffer.h>
 #include <wlr/types/wlr_scene.h>
+#include <wlr/util/box.h>
 #undef WLR_USE_UNSTABLE
 
+#include "container.h"
+#include "gfxbuf.h"
 #include "input.h"
 #include "libbase/libbase.h"
 #include "util.h"
@@ -49,6 +52,18 @@ static bool _wlmtk_buffer_element_pointer_motion(
 static void handle_wlr_scene_buffer_node_destroy(
     struct wl_listener *listener_ptr,
     void *data_ptr);
+static void handle_output_enter(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void handle_output_leave(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmtk_buffer_update_output_scale(wlmtk_buffer_t *buffer_ptr);
+static void _wlmtk_buffer_logical_size(
+    wlmtk_buffer_t *buffer_ptr,
+    int *width_ptr,
+    int *height_ptr);
+static void _wlmtk_buffer_apply_dest_size(wlmtk_buffer_t *buffer_ptr);
 
 /* == Data ================================================================= */
 
@@ -65,16 +80,32 @@ static const wlmtk_element_vmt_t buffer_element_vmt = {
 bool wlmtk_buffer_init(wlmtk_buffer_t *buffer_ptr)
 {
     BS_ASSERT(NULL != buffer_ptr);
-    *buffer_ptr = (wlmtk_buffer_t){};
+    *buffer_ptr = (wlmtk_buffer_t){ .scale = 1.0, .output_scale = 1.0 };
 
     if (!wlmtk_element_init(&buffer_ptr->super_element)) {
         return false;
     }
     buffer_ptr->orig_super_element_vmt = wlmtk_element_extend(
         &buffer_ptr->super_element, &buffer_element_vmt);
+    buffer_ptr->super_element.type = WLMTK_ELEMENT_BUFFER;
     return true;
 }
 
+/* ------------------------------------------------------------------------- */
+wlmtk_buffer_vmt_t wlmtk_buffer_extend(
+    wlmtk_buffer_t *buffer_ptr,
+    const wlmtk_buffer_vmt_t *buffer_vmt_ptr)
+{
+    wlmtk_buffer_vmt_t orig_vmt = buffer_ptr->vmt;
+
+    if (NULL != buffer_vmt_ptr->output_scale_changed) {
+        buffer_ptr->vmt.output_scale_changed =
+            buffer_vmt_ptr->output_scale_changed;
+    }
+
+    return orig_vmt;
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmtk_buffer_fini(wlmtk_buffer_t *buffer_ptr)
 {
@@ -96,22 +127,76 @@ void wlmtk_buffer_set(
     wlmtk_buffer_t *buffer_ptr,
     struct wlr_buffer *wlr_buffer_ptr)
 {
-    if (wlr_buffer_ptr == buffer_ptr->wlr_buffer_ptr) return;
-
-    if (NULL != buffer_ptr->wlr_buffer_ptr) {
-        wlr_buffer_unlock(buffer_ptr->wlr_buffer_ptr);
-    }
+    wlmtk_buffer_set_scaled(buffer_ptr, wlr_buffer_ptr, 1.0);
+}
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_buffer_set_scaled(
+    wlmtk_buffer_t *buffer_ptr,
+    struct wlr_buffer *wlr_buffer_ptr,
+    double scale)
+{
+    BS_ASSERT(0 < scale);
+    if (wlr_buffer_ptr == buffer_ptr->wlr_buffer_ptr &&
+        scale == buffer_ptr->scale &&
+        0 == buffer_ptr->stretch_width) return;
+    buffer_ptr->scale = scale;
+    buffer_ptr->stretch_width = 0;
+    buffer_ptr->stretch_height = 0;
+
+    // Lock first: `wlr_buffer_ptr` may be the current buffer, at new scale.
+    struct wlr_buffer *old_wlr_buffer_ptr = buffer_ptr->wlr_buffer_ptr;
     if (NULL != wlr_buffer_ptr) {
         buffer_ptr->wlr_buffer_ptr = wlr_buffer_lock(wlr_buffer_ptr);
     } else {
         buffer_ptr->wlr_buffer_ptr = NULL;
     }
+    if (NULL != old_wlr_buffer_ptr) wlr_buffer_unlock(old_wlr_buffer_ptr);
+    buffer_ptr->super_element.redraws++;
+    int width = buffer_ptr->super_element.leaf_width;
+    int height = buffer_ptr->super_element.leaf_height;
+    _wlmtk_buffer_logical_size(
+        buffer_ptr,
+        &buffer_ptr->super_element.leaf_width,
+        &buffer_ptr->super_element.leaf_height);
 
     if (NULL != buffer_ptr->wlr_scene_buffer_ptr) {
         wlr_scene_buffer_set_buffer(
             buffer_ptr->wlr_scene_buffer_ptr,
             buffer_ptr->wlr_buffer_ptr);
+        _wlmtk_buffer_apply_dest_size(buffer_ptr);
+    }
+    // Same size, eg. a highlight: The scene damages it, no layout needed.
+    if (width == buffer_ptr->super_element.leaf_width &&
+        height == buffer_ptr->super_element.leaf_height) return;
+    wlmtk_element_invalidate_extents(&buffer_ptr->super_element);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_buffer_set_stretched(
+    wlmtk_buffer_t *buffer_ptr,
+    int width,
+    int height)
+{
+    if (NULL == buffer_ptr->wlr_buffer_ptr) return;
+    BS_ASSERT(0 < width && 0 < height);
+    if (width == buffer_ptr->stretch_width &&
+        height == buffer_ptr->stretch_height) return;
+    buffer_ptr->stretch_width = width;
+    buffer_ptr->stretch_height = height;
+    buffer_ptr->super_element.leaf_width = width;
+    buffer_ptr->super_element.leaf_height = height;
+    _wlmtk_buffer_apply_dest_size(buffer_ptr);
+    wlmtk_element_invalidate_extents(&buffer_ptr->super_element);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_buffer_set_output_scale(wlmtk_buffer_t *buffer_ptr, double scale)
+{
+    if (scale == buffer_ptr->output_scale) return;
+    buffer_ptr->output_scale = scale;
+    if (NULL != buffer_ptr->vmt.output_scale_changed) {
+        buffer_ptr->vmt.output_scale_changed(buffer_ptr, scale);
     }
 }
 
@@ -145,10 +230,20 @@ struct wlr_scene_node *_wlmtk_buffer_element_create_scene_node(
         buffer_ptr->wlr_buffer_ptr);
     BS_ASSERT(NULL != buffer_ptr->wlr_scene_buffer_ptr);
 
+    _wlmtk_buffer_apply_dest_size(buffer_ptr);
+
     wlmtk_util_connect_listener_signal(
         &buffer_ptr->wlr_scene_buffer_ptr->node.events.destroy,
         &buffer_ptr->wlr_scene_buffer_node_destroy_listener,
         handle_wlr_scene_buffer_node_destroy);
+    wlmtk_util_connect_listener_signal(
+        &buffer_ptr->wlr_scene_buffer_ptr->events.output_enter,
+        &buffer_ptr->output_enter_listener,
+        handle_output_enter);
+    wlmtk_util_connect_listener_signal(
+        &buffer_ptr->wlr_scene_buffer_ptr->events.output_leave,
+        &buffer_ptr->output_leave_listener,
+        handle_output_leave);
     return &buffer_ptr->wlr_scene_buffer_ptr->node;
 }
 
@@ -175,14 +270,10 @@ void _wlmtk_buffer_element_get_dimensions(
     if (NULL != left_ptr) *left_ptr = 0;
     if (NULL != top_ptr) *top_ptr = 0;
 
-    if (NULL == buffer_ptr->wlr_buffer_ptr) {
-        if (NULL != right_ptr) *right_ptr = 0;
-        if (NULL != bottom_ptr) *bottom_ptr = 0;
-        return;
-    }
-
-    if (NULL != right_ptr) *right_ptr = buffer_ptr->wlr_buffer_ptr->width;
-    if (NULL != bottom_ptr) *bottom_ptr = buffer_ptr->wlr_buffer_ptr->height;
+    int width, height;
+    _wlmtk_buffer_logical_size(buffer_ptr, &width, &height);
+    if (NULL != right_ptr) *right_ptr = width;
+    if (NULL != bottom_ptr) *bottom_ptr = height;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -203,11 +294,13 @@ bool _wlmtk_buffer_element_pointer_motion(
     wlmtk_buffer_t *buffer_ptr = BS_CONTAINER_OF(
         element_ptr, wlmtk_buffer_t, super_element);
 
+    int width, height;
+    _wlmtk_buffer_logical_size(buffer_ptr, &width, &height);
     wlmtk_pointer_motion_event_t event_copy = *motion_event_ptr;
     if (motion_event_ptr->x < 0 ||
-        motion_event_ptr->x >= buffer_ptr->wlr_buffer_ptr->width ||
+        motion_event_ptr->x >= width ||
         motion_event_ptr->y < 0 ||
-        motion_event_ptr->y >= buffer_ptr->wlr_buffer_ptr->height) {
+        motion_event_ptr->y >= height) {
         event_copy.x = NAN;
         event_copy.y = NAN;
     }
@@ -241,6 +334,172 @@ void handle_wlr_scene_buffer_node_destroy(
 
     buffer_ptr->wlr_scene_buffer_ptr = NULL;
     wl_list_remove(&buffer_ptr->wlr_scene_buffer_node_destroy_listener.link);
+    wlmtk_util_disconnect_listener(&buffer_ptr->output_enter_listener);
+    wlmtk_util_disconnect_listener(&buffer_ptr->output_leave_listener);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles `output_enter` of the scene buffer: Updates the output scale. */
+void handle_output_enter(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmtk_buffer_t *buffer_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmtk_buffer_t, output_enter_listener);
+    _wlmtk_buffer_update_output_scale(buffer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles `output_leave` of the scene buffer: Updates the output scale. */
+void handle_output_leave(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmtk_buffer_t *buffer_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmtk_buffer_t, output_leave_listener);
+    _wlmtk_buffer_update_output_scale(buffer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Sets the output scale from the scene buffer's primary output, ie. the
+ * output showing most of it. Keeps the current scale if there is none, so
+ * that a buffer moved off-screen does not get re-rendered.
+ *
+ * @param buffer_ptr
+ */
+void _wlmtk_buffer_update_output_scale(wlmtk_buffer_t *buffer_ptr)
+{
+    struct wlr_scene_output *wlr_scene_output_ptr =
+        buffer_ptr->wlr_scene_buffer_ptr->primary_output;
+    if (NULL == wlr_scene_output_ptr) return;
+    wlmtk_buffer_set_output_scale(
+        buffer_ptr, wlr_scene_output_ptr->output->scale);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Computes the buffer's size in logical pixels. 0 if there's no buffer. */
+void _wlmtk_buffer_logical_size(
+    wlmtk_buffer_t *buffer_ptr,
+    int *width_ptr,
+    int *height_ptr)
+{
+    *width_ptr = 0;
+    *height_ptr = 0;
+    if (NULL == buffer_ptr->wlr_buffer_ptr) return;
+    if (0 < buffer_ptr->stretch_width) {
+        *width_ptr = buffer_ptr->stretch_width;
+        *height_ptr = buffer_ptr->stretch_height;
+        return;
+    }
+    *width_ptr = lround(buffer_ptr->wlr_buffer_ptr->width / buffer_ptr->scale);
+    *height_ptr = lround(
+        buffer_ptr->wlr_buffer_ptr->height / buffer_ptr->scale);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Sets the scene buffer to present the contents at their logical size. */
+void _wlmtk_buffer_apply_dest_size(wlmtk_buffer_t *buffer_ptr)
+{
+    if (NULL == buffer_ptr->wlr_scene_buffer_ptr) return;
+    if (1.0 == buffer_ptr->scale && 0 == buffer_ptr->stretch_width) {
+        // Zero: Use the buffer's size.
+        wlr_scene_buffer_set_dest_size(buffer_ptr->wlr_scene_buffer_ptr, 0, 0);
+        return;
+    }
+    int width, height;
+    _wlmtk_buffer_logical_size(buffer_ptr, &width, &height);
+    wlr_scene_buffer_set_dest_size(
+        buffer_ptr->wlr_scene_buffer_ptr, width, height);
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_scaled(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_buffer_test_cases[] = {
+    { 1, "scaled", test_scaled },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Scale passed to the last call of the test's output_scale_changed. */
+static double _wlmtk_buffer_test_scale;
+
+/** Records the scale passed to output_scale_changed. */
+static void _wlmtk_buffer_test_output_scale_changed(
+    __UNUSED__ wlmtk_buffer_t *buffer_ptr,
+    double scale)
+{
+    _wlmtk_buffer_test_scale = scale;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Exercises @ref wlmtk_buffer_set_scaled and output scale notifications. */
+void test_scaled(bs_test_t *test_ptr)
+{
+    wlmtk_container_t *fake_parent_ptr = wlmtk_container_create_fake_parent();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fake_parent_ptr);
+    wlmtk_buffer_t buffer;
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, wlmtk_buffer_init(&buffer));
+    _wlmtk_buffer_test_scale = 0;
+    static const wlmtk_buffer_vmt_t vmt = {
+        .output_scale_changed = _wlmtk_buffer_test_output_scale_changed
+    };
+    wlmtk_buffer_extend(&buffer, &vmt);
+    wlmtk_container_add_element(fake_parent_ptr, &buffer.super_element);
+
+    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(30, 20);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_buffer_ptr);
+    wlmtk_buffer_set_scaled(&buffer, wlr_buffer_ptr, 2.0);
+    wlr_buffer_drop(wlr_buffer_ptr);
+
+    struct wlr_box box = wlmtk_element_get_dimensions_box(
+        &buffer.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 15, box.width);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, box.height);
+    BS_TEST_VERIFY_EQ(test_ptr, 15, buffer.wlr_scene_buffer_ptr->dst_width);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, buffer.wlr_scene_buffer_ptr->dst_height);
+
+    // Same buffer, at 1x.
+    wlmtk_buffer_set(&buffer, buffer.wlr_buffer_ptr);
+    box = wlmtk_element_get_dimensions_box(&buffer.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 30, box.width);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, buffer.wlr_scene_buffer_ptr->dst_width);
+
+    // Stretched: Presents the contents at the given size, until set again.
+    wlmtk_buffer_set_stretched(&buffer, 40, 20);
+    box = wlmtk_element_get_dimensions_box(&buffer.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 40, box.width);
+    BS_TEST_VERIFY_EQ(test_ptr, 40, buffer.wlr_scene_buffer_ptr->dst_width);
+    wlmtk_buffer_set(&buffer, buffer.wlr_buffer_ptr);
+    box = wlmtk_element_get_dimensions_box(&buffer.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 30, box.width);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, buffer.wlr_scene_buffer_ptr->dst_width);
+
+    // Other contents of the same size: Shown, but extents are unchanged.
+    uint64_t extents_serial = buffer.super_element.extents_serial;
+    wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(30, 20);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_buffer_ptr);
+    wlmtk_buffer_set(&buffer, wlr_buffer_ptr);
+    wlr_buffer_drop(wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, wlr_buffer_ptr, buffer.wlr_scene_buffer_ptr->buffer);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, extents_serial, buffer.super_element.extents_serial);
+    wlmtk_buffer_set_scaled(&buffer, buffer.wlr_buffer_ptr, 2.0);
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, extents_serial, buffer.super_element.extents_serial);
+
+    // Notifies only on change.
+    wlmtk_buffer_set_output_scale(&buffer, 1.0);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, _wlmtk_buffer_test_scale);
+    wlmtk_buffer_set_output_scale(&buffer, 1.5);
+    BS_TEST_VERIFY_EQ(test_ptr, 1.5, _wlmtk_buffer_test_scale);
+
+    wlmtk_container_remove_element(fake_parent_ptr, &buffer.super_element);
+    wlmtk_buffer_fini(&buffer);
+    wlmtk_container_destroy_fake_parent(fake_parent_ptr);
 }
 
 /* == End of buffer.c ====================================================== */
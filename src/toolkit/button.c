@@ -67,7 +67,7 @@ static const wlmtk_button_vmt_t button_vmt = {
 bool wlmtk_button_init(wlmtk_button_t *button_ptr)
 {
     BS_ASSERT(NULL != button_ptr);
-    *button_ptr = (wlmtk_button_t){ .vmt = button_vmt };
+    *button_ptr = (wlmtk_button_t){ .vmt = button_vmt, .scale = 1.0 };
 
     if (!wlmtk_buffer_init(&button_ptr->super_buffer)) {
         wlmtk_button_fini(button_ptr);
@@ -127,6 +127,19 @@ void wlmtk_button_set(
     struct wlr_buffer *released_wlr_buffer_ptr,
     struct wlr_buffer *pressed_wlr_buffer_ptr )
 {
+    wlmtk_button_set_scaled(
+        button_ptr, released_wlr_buffer_ptr, pressed_wlr_buffer_ptr, 1.0);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_button_set_scaled(
+    wlmtk_button_t *button_ptr,
+    struct wlr_buffer *released_wlr_buffer_ptr,
+    struct wlr_buffer *pressed_wlr_buffer_ptr,
+    double scale)
+{
+    BS_ASSERT(0 < scale);
+    button_ptr->scale = scale;
     if (NULL == released_wlr_buffer_ptr) {
         BS_ASSERT(NULL == pressed_wlr_buffer_ptr);
     } else {
@@ -139,14 +152,20 @@ void wlmtk_button_set(
     if (NULL != button_ptr->released_wlr_buffer_ptr) {
         wlr_buffer_unlock(button_ptr->released_wlr_buffer_ptr);
     }
-    button_ptr->released_wlr_buffer_ptr = wlr_buffer_lock(
-        released_wlr_buffer_ptr);
+    button_ptr->released_wlr_buffer_ptr = NULL;
+    if (NULL != released_wlr_buffer_ptr) {
+        button_ptr->released_wlr_buffer_ptr = wlr_buffer_lock(
+            released_wlr_buffer_ptr);
+    }
 
     if (NULL != button_ptr->pressed_wlr_buffer_ptr) {
         wlr_buffer_unlock(button_ptr->pressed_wlr_buffer_ptr);
     }
-    button_ptr->pressed_wlr_buffer_ptr = wlr_buffer_lock(
-        pressed_wlr_buffer_ptr);
+    button_ptr->pressed_wlr_buffer_ptr = NULL;
+    if (NULL != pressed_wlr_buffer_ptr) {
+        button_ptr->pressed_wlr_buffer_ptr = wlr_buffer_lock(
+            pressed_wlr_buffer_ptr);
+    }
 
     apply_state(button_ptr);
 }
@@ -223,13 +242,15 @@ void apply_state(wlmtk_button_t *button_ptr)
 {
     if (button_ptr->super_buffer.super_element.pointer_inside &&
         button_ptr->pressed) {
-        wlmtk_buffer_set(
+        wlmtk_buffer_set_scaled(
             &button_ptr->super_buffer,
-            button_ptr->pressed_wlr_buffer_ptr);
+            button_ptr->pressed_wlr_buffer_ptr,
+            button_ptr->scale);
     } else {
-        wlmtk_buffer_set(
+        wlmtk_buffer_set_scaled(
             &button_ptr->super_buffer,
-            button_ptr->released_wlr_buffer_ptr);
+            button_ptr->released_wlr_buffer_ptr,
+            button_ptr->scale);
     }
 }
 
@@ -0,0 +1,196 @@
+/* ========================================================================= */
+/**
+ * @file cache.c
+ *
+ * @copyright
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cache.h"
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+
+#include "gfxbuf.h"
+#include "image.h"
+#include "primitives.h"
+#include "text.h"
+
+/* == Declarations ========================================================= */
+
+static size_t _wlmtk_cache_evict_images(unsigned percent, void *ud_ptr);
+static size_t _wlmtk_cache_evict_text(unsigned percent, void *ud_ptr);
+static size_t _wlmtk_cache_evict_bezels(unsigned percent, void *ud_ptr);
+static size_t _wlmtk_cache_evict_gfxbuf_pool(unsigned percent, void *ud_ptr);
+
+/* == Data ================================================================= */
+
+/** The toolkit's own caches. Evicted after the registered ones. */
+static wlmtk_cache_t          _wlmtk_cache_builtins[] = {
+    { .name_ptr = "images", .evict = _wlmtk_cache_evict_images },
+    { .name_ptr = "text", .evict = _wlmtk_cache_evict_text },
+    { .name_ptr = "bezels", .evict = _wlmtk_cache_evict_bezels },
+    // Last: Buffers dropped by the other caches return their storage here.
+    { .name_ptr = "pixel storage", .evict = _wlmtk_cache_evict_gfxbuf_pool }
+};
+
+/** Registered caches, see @ref wlmtk_cache_register. */
+static bs_dllist_t            _wlmtk_cache_registry;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_cache_register(wlmtk_cache_t *cache_ptr)
+{
+    wlmtk_cache_unregister(cache_ptr);
+    bs_dllist_push_back(&_wlmtk_cache_registry, &cache_ptr->dlnode);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_cache_unregister(wlmtk_cache_t *cache_ptr)
+{
+    for (bs_dllist_node_t *dlnode_ptr = _wlmtk_cache_registry.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        if (dlnode_ptr != &cache_ptr->dlnode) continue;
+        bs_dllist_remove(&_wlmtk_cache_registry, dlnode_ptr);
+        return;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_cache_evict(unsigned percent)
+{
+    percent = BS_MIN(percent, 100u);
+    size_t total_bytes = 0;
+
+    // Registered caches hold buffers, which may return to the builtins.
+    bs_dllist_node_t *dlnode_ptr = _wlmtk_cache_registry.head_ptr;
+    while (NULL != dlnode_ptr) {
+        wlmtk_cache_t *cache_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_cache_t, dlnode);
+        // The callback may unregister the cache.
+        dlnode_ptr = dlnode_ptr->next_ptr;
+        size_t bytes = cache_ptr->evict(percent, cache_ptr->userdata_ptr);
+        bs_log(BS_INFO, "Evicted %u%% of %s: %zu bytes.",
+               percent, cache_ptr->name_ptr, bytes);
+        total_bytes += bytes;
+    }
+    for (size_t i = 0;
+         i < sizeof(_wlmtk_cache_builtins) / sizeof(wlmtk_cache_t);
+         ++i) {
+        wlmtk_cache_t *cache_ptr = &_wlmtk_cache_builtins[i];
+        size_t bytes = cache_ptr->evict(percent, cache_ptr->userdata_ptr);
+        bs_log(BS_INFO, "Evicted %u%% of %s: %zu bytes.",
+               percent, cache_ptr->name_ptr, bytes);
+        total_bytes += bytes;
+    }
+    bs_log(BS_INFO, "Evicted %zu bytes from caches.", total_bytes);
+    return total_bytes;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Evicts decoded images. See @ref wlmtk_image_cache_evict. */
+size_t _wlmtk_cache_evict_images(unsigned percent, __UNUSED__ void *ud_ptr)
+{
+    return wlmtk_image_cache_evict(percent);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Evicts shaped text. See @ref wlmtk_text_evict. */
+size_t _wlmtk_cache_evict_text(unsigned percent, __UNUSED__ void *ud_ptr)
+{
+    return wlmtk_text_evict(percent);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Evicts bezel templates. See @ref wlmaker_primitives_bezel_cache_evict. */
+size_t _wlmtk_cache_evict_bezels(unsigned percent, __UNUSED__ void *ud_ptr)
+{
+    return wlmaker_primitives_bezel_cache_evict(percent);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Evicts free pixel storage. See @ref wlmtk_gfxbuf_pool_evict. */
+size_t _wlmtk_cache_evict_gfxbuf_pool(
+    unsigned percent,
+    __UNUSED__ void *ud_ptr)
+{
+    return wlmtk_gfxbuf_pool_evict(percent);
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_evict(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_cache_test_cases[] = {
+    { 1, "evict", test_evict },
+    { 0, NULL, NULL }
+};
+
+/** Test cache: Holds `bytes`, and records the requested percentage. */
+typedef struct {
+    /** The cache. */
+    wlmtk_cache_t             cache;
+    /** Bytes held. */
+    size_t                    bytes;
+    /** Percentage of the most recent eviction. */
+    unsigned                  percent;
+} _wlmtk_cache_test_t;
+
+/** Evicts from @ref _wlmtk_cache_test_t. */
+static size_t _wlmtk_cache_test_evict(unsigned percent, void *ud_ptr)
+{
+    _wlmtk_cache_test_t *test_cache_ptr = ud_ptr;
+    test_cache_ptr->percent = percent;
+    size_t bytes = test_cache_ptr->bytes * percent / 100;
+    test_cache_ptr->bytes -= bytes;
+    return bytes;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Exercises registering and evicting caches. */
+void test_evict(bs_test_t *test_ptr)
+{
+    _wlmtk_cache_test_t t1 = { .bytes = 1000 }, t2 = { .bytes = 300 };
+    t1.cache = (wlmtk_cache_t){
+        .name_ptr = "t1", .evict = _wlmtk_cache_test_evict,
+        .userdata_ptr = &t1 };
+    t2.cache = (wlmtk_cache_t){
+        .name_ptr = "t2", .evict = _wlmtk_cache_test_evict,
+        .userdata_ptr = &t2 };
+    wlmtk_cache_register(&t1.cache);
+    wlmtk_cache_register(&t2.cache);
+    // Registering twice has no effect.
+    wlmtk_cache_register(&t2.cache);
+
+    BS_TEST_VERIFY_TRUE(test_ptr, 650 <= wlmtk_cache_evict(50));
+    BS_TEST_VERIFY_EQ(test_ptr, 50, t1.percent);
+    BS_TEST_VERIFY_EQ(test_ptr, 500, t1.bytes);
+    BS_TEST_VERIFY_EQ(test_ptr, 150, t2.bytes);
+
+    // Clamped to 100 percent. Only registered caches get evicted.
+    wlmtk_cache_unregister(&t1.cache);
+    wlmtk_cache_unregister(&t1.cache);
+    BS_TEST_VERIFY_TRUE(test_ptr, 150 <= wlmtk_cache_evict(200));
+    BS_TEST_VERIFY_EQ(test_ptr, 500, t1.bytes);
+    BS_TEST_VERIFY_EQ(test_ptr, 100, t2.percent);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, t2.bytes);
+    wlmtk_cache_unregister(&t2.cache);
+}
+
+/* == End of cache.c ======================================================= */
@@ -24,15 +24,24 @@
 #include <math.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <toolkit/util.h>
 #include <wayland-util.h>
 #define WLR_USE_UNSTABLE
 #include <wlr/types/wlr_keyboard.h>
 #include <wlr/types/wlr_scene.h>
+#include <wlr/util/box.h>
 #undef WLR_USE_UNSTABLE
 #include <xkbcommon/xkbcommon.h>
 
+#if defined(WLMTK_UTIL_SIMD_X86)
+#include <immintrin.h>
+#elif defined(WLMTK_UTIL_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "input.h"
+#include "trace.h"
 
 /* == Declarations ========================================================= */
 
@@ -53,6 +62,10 @@ static void _wlmtk_container_element_get_pointer_area(
     int *top_ptr,
     int *right_ptr,
     int *bottom_ptr);
+static void _wlmtk_container_compute_extents(
+    wlmtk_container_t *container_ptr,
+    bool pointer_area,
+    wlmtk_element_extents_cache_t *cache_ptr);
 static bool _wlmtk_container_element_pointer_motion(
     wlmtk_element_t *element_ptr,
     wlmtk_pointer_motion_event_t *motion_event_ptr);
@@ -83,6 +96,125 @@ static bool update_pointer_focus_at(
     uint32_t time_msec,
     wlmtk_pointer_t *pointer_ptr);
 static void _wlmtk_container_update_layout(wlmtk_container_t *container_ptr);
+static bool _wlmtk_container_pointer_motion_at_element(
+    wlmtk_container_t *container_ptr,
+    wlmtk_element_t *element_ptr,
+    double x,
+    double y,
+    wlmtk_pointer_motion_event_t *motion_event_ptr);
+static void _wlmtk_container_cache_pointer_focus(
+    wlmtk_container_t *container_ptr);
+
+static void _wlmtk_container_spatial_index_fini(
+    wlmtk_container_spatial_index_t *spatial_index_ptr);
+static bool _wlmtk_container_spatial_index_update(
+    wlmtk_container_t *container_ptr);
+static wlmtk_element_t **_wlmtk_container_spatial_index_lookup(
+    wlmtk_container_spatial_index_t *spatial_index_ptr,
+    double x,
+    double y,
+    size_t *count_ptr);
+static bool _wlmtk_container_element_pointer_box(
+    wlmtk_element_t *element_ptr,
+    struct wlr_box *box_ptr);
+static void _wlmtk_container_child_array_fini(
+    wlmtk_container_child_array_t *child_array_ptr);
+static bool _wlmtk_container_child_array_update(
+    wlmtk_container_t *container_ptr);
+static int32_t _wlmtk_container_child_array_stride(
+    const int32_t *p1_ptr,
+    const int32_t *p2_ptr,
+    size_t count);
+static size_t _wlmtk_container_child_array_find(
+    const wlmtk_container_child_array_t *child_array_ptr,
+    int32_t x,
+    int32_t y,
+    size_t start);
+
+/**
+ * Kernel for hit-testing rectangles: Returns the first index `i` at or after
+ * `start`, where `x1[i] <= x < x2[i]` and `y1[i] <= y < y2[i]`, or `count`.
+ */
+typedef size_t (*_wlmtk_container_hit_kernel_t)(
+    const int32_t *x1_ptr,
+    const int32_t *y1_ptr,
+    const int32_t *x2_ptr,
+    const int32_t *y2_ptr,
+    size_t count,
+    int32_t x,
+    int32_t y,
+    size_t start);
+static _wlmtk_container_hit_kernel_t _wlmtk_container_hit_kernel_for(
+    wlmtk_util_simd_t simd);
+static size_t _wlmtk_container_hit_scalar(
+    const int32_t *x1_ptr, const int32_t *y1_ptr,
+    const int32_t *x2_ptr, const int32_t *y2_ptr,
+    size_t count, int32_t x, int32_t y, size_t start);
+#if defined(WLMTK_UTIL_SIMD_X86)
+static size_t _wlmtk_container_hit_sse2(
+    const int32_t *x1_ptr, const int32_t *y1_ptr,
+    const int32_t *x2_ptr, const int32_t *y2_ptr,
+    size_t count, int32_t x, int32_t y, size_t start);
+static size_t _wlmtk_container_hit_avx2(
+    const int32_t *x1_ptr, const int32_t *y1_ptr,
+    const int32_t *x2_ptr, const int32_t *y2_ptr,
+    size_t count, int32_t x, int32_t y, size_t start);
+#elif defined(WLMTK_UTIL_SIMD_NEON)
+static size_t _wlmtk_container_hit_neon(
+    const int32_t *x1_ptr, const int32_t *y1_ptr,
+    const int32_t *x2_ptr, const int32_t *y2_ptr,
+    size_t count, int32_t x, int32_t y, size_t start);
+#endif
+static void _wlmtk_container_restack_to_top(
+    wlmtk_container_t *container_ptr,
+    wlmtk_element_t *element_ptr);
+static void _wlmtk_container_spatial_index_raise(
+    wlmtk_container_spatial_index_t *spatial_index_ptr,
+    wlmtk_element_t *element_ptr);
+static void _wlmtk_container_child_array_raise(
+    wlmtk_container_child_array_t *child_array_ptr,
+    wlmtk_element_t *element_ptr);
+static void _wlmtk_container_spatial_index_translate(
+    wlmtk_container_spatial_index_t *spatial_index_ptr,
+    wlmtk_element_t *element_ptr,
+    const struct wlr_box *old_box_ptr);
+static void _wlmtk_container_child_array_translate(
+    wlmtk_container_child_array_t *child_array_ptr,
+    wlmtk_element_t *element_ptr,
+    int dx,
+    int dy);
+static int _wlmtk_container_depth(wlmtk_container_t *container_ptr);
+static void _wlmtk_container_run_layout(wlmtk_container_t *container_ptr);
+static void _wlmtk_container_handle_layout_idle(void *data_ptr);
+static wlmtk_element_t *_wlmtk_container_keyboard_focus_leaf(
+    wlmtk_container_t *container_ptr);
+static void _wlmtk_container_blur_keyboard_focus(
+    wlmtk_container_t *container_ptr);
+static void _wlmtk_container_unlink_element(
+    wlmtk_container_t *container_ptr,
+    wlmtk_element_t *element_ptr);
+
+/** Upper bound for columns, respectively rows of the spatial index. */
+static const int _wlmtk_container_spatial_index_max_cells = 64;
+
+/** Event loop for deferred layout updates. NULL if updates are immediate. */
+static struct wl_event_loop *_wlmtk_container_layout_event_loop_ptr = NULL;
+/** Idle source for flushing deferred layout updates, if scheduled. */
+static struct wl_event_source *_wlmtk_container_layout_idle_ptr = NULL;
+/** Containers with a pending deferred layout update. */
+static bs_dllist_t _wlmtk_container_layout_queue = {};
+/** Whether @ref wlmtk_container_flush_layout is currently running. */
+static bool _wlmtk_container_layout_flushing = false;
+
+/**
+ * Serial of keyboard focus changes, across all containers. Increased on each
+ * change, to invalidate @ref wlmtk_container_t::keyboard_focus_leaf_ptr.
+ * Starts at 1, so that zero-initialized caches are invalid.
+ */
+static uint64_t _wlmtk_container_keyboard_focus_serial = 1;
+
+/** Hit test kernel for the child array. Selected on first use. */
+static _wlmtk_container_hit_kernel_t _wlmtk_container_hit_kernel = NULL;
 
 /** Virtual method table for the container's super class: Element. */
 static const wlmtk_element_vmt_t container_element_vmt = {
@@ -115,10 +247,61 @@ bool wlmtk_container_init(wlmtk_container_t *container_ptr)
     }
     container_ptr->orig_super_element_vmt = wlmtk_element_extend(
         &container_ptr->super_element, &container_element_vmt);
+    container_ptr->super_element.is_container = true;
 
     return true;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the leaf of the keyboard focus chain below `container_ptr`:
+ * Descends through plain containers, ie. those that do not override the
+ * `keyboard_event` method. The result is cached until focus changes.
+ *
+ * @param container_ptr
+ *
+ * @return The element to receive keyboard events, or NULL.
+ */
+wlmtk_element_t *_wlmtk_container_keyboard_focus_leaf(
+    wlmtk_container_t *container_ptr)
+{
+    if (container_ptr->keyboard_focus_leaf_serial ==
+        _wlmtk_container_keyboard_focus_serial) {
+        return container_ptr->keyboard_focus_leaf_ptr;
+    }
+
+    wlmtk_element_t *element_ptr = container_ptr->keyboard_focus_element_ptr;
+    while (NULL != element_ptr &&
+           element_ptr->vmt.keyboard_event ==
+           _wlmtk_container_element_keyboard_event) {
+        element_ptr = BS_CONTAINER_OF(
+            element_ptr, wlmtk_container_t, super_element
+            )->keyboard_focus_element_ptr;
+    }
+    container_ptr->keyboard_focus_leaf_ptr = element_ptr;
+    container_ptr->keyboard_focus_leaf_serial =
+        _wlmtk_container_keyboard_focus_serial;
+    return element_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Blurs the keyboard-focussed element of `container_ptr`, if any. Marks the
+ * container as blurring meanwhile, so that the element clearing its focus
+ * (as surfaces do, when de-activated) doesn't walk up the chain and back.
+ *
+ * @param container_ptr
+ */
+void _wlmtk_container_blur_keyboard_focus(wlmtk_container_t *container_ptr)
+{
+    if (NULL == container_ptr->keyboard_focus_element_ptr) return;
+
+    bool blurring = container_ptr->keyboard_blurring;
+    container_ptr->keyboard_blurring = true;
+    wlmtk_element_keyboard_blur(container_ptr->keyboard_focus_element_ptr);
+    container_ptr->keyboard_blurring = blurring;
+}
+
 /* ------------------------------------------------------------------------- */
 bool wlmtk_container_init_attached(
     wlmtk_container_t *container_ptr,
@@ -168,6 +351,15 @@ void wlmtk_container_fini(wlmtk_container_t *container_ptr)
         container_ptr->super_element.wlr_scene_node_ptr = NULL;
     }
 
+    if (container_ptr->layout_pending) {
+        bs_dllist_remove(container_ptr->layout_list_ptr,
+                         &container_ptr->layout_dlnode);
+        container_ptr->layout_list_ptr = NULL;
+        container_ptr->layout_pending = false;
+    }
+
+    _wlmtk_container_child_array_fini(&container_ptr->child_array);
+    _wlmtk_container_spatial_index_fini(&container_ptr->spatial_index);
     wlmtk_element_fini(&container_ptr->super_element);
     *container_ptr = (wlmtk_container_t){};
 }
@@ -186,6 +378,7 @@ void wlmtk_container_add_element(
     bs_dllist_push_front(
         &container_ptr->elements,
         wlmtk_dlnode_from_element(element_ptr));
+    wlmtk_container_invalidate_spatial_index(container_ptr);
     wlmtk_element_set_parent_container(element_ptr, container_ptr);
 
     wlmtk_container_update_layout(container_ptr);
@@ -213,6 +406,7 @@ void wlmtk_container_add_element_atop(
             wlmtk_dlnode_from_element(reference_element_ptr),
             wlmtk_dlnode_from_element(element_ptr));
     }
+    wlmtk_container_invalidate_spatial_index(container_ptr);
 
     wlmtk_element_set_parent_container(element_ptr, container_ptr);
     if (NULL != element_ptr->wlr_scene_node_ptr) {
@@ -237,30 +431,33 @@ void wlmtk_container_remove_element(
     BS_ASSERT(element_ptr->parent_container_ptr == container_ptr);
 
     wlmtk_element_set_parent_container(element_ptr, NULL);
-    bs_dllist_remove(
+    _wlmtk_container_unlink_element(container_ptr, element_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_container_move_element(
+    wlmtk_container_t *container_ptr,
+    wlmtk_element_t *element_ptr)
+{
+    wlmtk_container_t *former_container_ptr = BS_ASSERT_NOTNULL(
+        element_ptr->parent_container_ptr);
+    if (former_container_ptr == container_ptr) return;
+
+    // Keeps the parent until linked into the new container: Setting the
+    // new parent then re-parents the scene node, instead of destroying it.
+    _wlmtk_container_unlink_element(former_container_ptr, element_ptr);
+    wlmtk_element_pointer_grab_cancel(element_ptr);
+
+    bs_dllist_push_front(
         &container_ptr->elements,
         wlmtk_dlnode_from_element(element_ptr));
-
-    if (container_ptr->pointer_grab_element_ptr == element_ptr) {
-        _wlmtk_container_element_pointer_grab_cancel(
-            &container_ptr->super_element);
-        if (NULL != container_ptr->super_element.parent_container_ptr) {
-            wlmtk_container_pointer_grab_release(
-                container_ptr->super_element.parent_container_ptr,
-                &container_ptr->super_element);
-        }
-    }
-    if (container_ptr->left_button_element_ptr == element_ptr) {
-        container_ptr->left_button_element_ptr = NULL;
-    }
-    if (container_ptr->keyboard_focus_element_ptr == element_ptr) {
-        wlmtk_container_set_keyboard_focus_element(container_ptr, NULL);
+    wlmtk_container_invalidate_spatial_index(container_ptr);
+    wlmtk_element_set_parent_container(element_ptr, container_ptr);
+    if (NULL != element_ptr->wlr_scene_node_ptr) {
+        wlr_scene_node_raise_to_top(element_ptr->wlr_scene_node_ptr);
     }
 
     wlmtk_container_update_layout(container_ptr);
-    wlmtk_container_update_pointer_focus(container_ptr);
-    BS_ASSERT(element_ptr != container_ptr->pointer_focus_element_ptr);
-    BS_ASSERT(element_ptr != container_ptr->keyboard_focus_element_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -280,17 +477,165 @@ void wlmtk_container_raise_element_to_top(
     bs_dllist_push_front(
         &container_ptr->elements,
         wlmtk_dlnode_from_element(element_ptr));
+    if (!container_ptr->order_independent_layout) {
+        wlmtk_container_invalidate_spatial_index(container_ptr);
+    }
 
     if (NULL != element_ptr->wlr_scene_node_ptr) {
         wlr_scene_node_raise_to_top(element_ptr->wlr_scene_node_ptr);
     }
 
+    if (container_ptr->order_independent_layout) {
+        _wlmtk_container_restack_to_top(container_ptr, element_ptr);
+        return;
+    }
     wlmtk_container_update_layout(container_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_container_update_layout(wlmtk_container_t *container_ptr)
+{
+    WLMTK_TRACE_SPAN("container_update_layout");
+    wlmtk_container_invalidate_spatial_index(container_ptr);
+    wlmtk_element_invalidate_extents(&container_ptr->super_element);
+
+    if (NULL == _wlmtk_container_layout_event_loop_ptr) {
+        container_ptr->vmt.update_layout(container_ptr);
+        return;
+    }
+
+    if (!container_ptr->layout_pending) {
+        container_ptr->layout_pending = true;
+        container_ptr->layout_list_ptr = &_wlmtk_container_layout_queue;
+        bs_dllist_push_back(&_wlmtk_container_layout_queue,
+                            &container_ptr->layout_dlnode);
+    }
+    if (NULL == _wlmtk_container_layout_idle_ptr &&
+        !_wlmtk_container_layout_flushing) {
+        _wlmtk_container_layout_idle_ptr = wl_event_loop_add_idle(
+            _wlmtk_container_layout_event_loop_ptr,
+            _wlmtk_container_handle_layout_idle,
+            NULL);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_container_defer_layout(struct wl_event_loop *wl_event_loop_ptr)
+{
+    _wlmtk_container_layout_event_loop_ptr = wl_event_loop_ptr;
+    if (NULL != wl_event_loop_ptr) return;
+
+    if (NULL != _wlmtk_container_layout_idle_ptr) {
+        wl_event_source_remove(_wlmtk_container_layout_idle_ptr);
+        _wlmtk_container_layout_idle_ptr = NULL;
+    }
+    wlmtk_container_flush_layout();
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_container_flush_layout(void)
+{
+    WLMTK_TRACE_SPAN("container_flush_layout");
+    // A layout may end up requesting a flush (eg. via a scene commit).
+    if (_wlmtk_container_layout_flushing) return;
+    _wlmtk_container_layout_flushing = true;
+
+    // Layouts propagate to the parent, which then must run only after all
+    // it's children: Buckets the pending containers by depth, and runs the
+    // deepest first. Containers stay pending while bucketed, so propagating
+    // to them is a no-op. Those enqueued while running get the next round.
+    while (NULL != _wlmtk_container_layout_queue.head_ptr) {
+        int max_depth = 0;
+        for (bs_dllist_node_t *dlnode_ptr =
+                 _wlmtk_container_layout_queue.head_ptr;
+             dlnode_ptr != NULL;
+             dlnode_ptr = dlnode_ptr->next_ptr) {
+            wlmtk_container_t *c_ptr = BS_CONTAINER_OF(
+                dlnode_ptr, wlmtk_container_t, layout_dlnode);
+            c_ptr->layout_depth = _wlmtk_container_depth(c_ptr);
+            max_depth = BS_MAX(max_depth, c_ptr->layout_depth);
+        }
+
+        bs_dllist_t *buckets_ptr = logged_calloc(
+            max_depth + 1, sizeof(bs_dllist_t));
+        if (NULL == buckets_ptr) {
+            // Out of memory: Runs in the order queued. Still converges, as
+            // each layout propagates to the parent.
+            _wlmtk_container_run_layout(
+                BS_CONTAINER_OF(
+                    bs_dllist_pop_front(&_wlmtk_container_layout_queue),
+                    wlmtk_container_t, layout_dlnode));
+            continue;
+        }
+
+        bs_dllist_node_t *dlnode_ptr;
+        while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                            &_wlmtk_container_layout_queue))) {
+            wlmtk_container_t *c_ptr = BS_CONTAINER_OF(
+                dlnode_ptr, wlmtk_container_t, layout_dlnode);
+            c_ptr->layout_list_ptr = &buckets_ptr[c_ptr->layout_depth];
+            bs_dllist_push_back(c_ptr->layout_list_ptr, dlnode_ptr);
+        }
+        for (int depth = max_depth; depth >= 0; --depth) {
+            while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                                &buckets_ptr[depth]))) {
+                _wlmtk_container_run_layout(BS_CONTAINER_OF(
+                    dlnode_ptr, wlmtk_container_t, layout_dlnode));
+            }
+        }
+        free(buckets_ptr);
+    }
+
+    _wlmtk_container_layout_flushing = false;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_container_translate_element(
+    wlmtk_container_t *container_ptr,
+    wlmtk_element_t *element_ptr,
+    int x,
+    int y)
+{
+    BS_ASSERT(element_ptr->parent_container_ptr == container_ptr);
+
+    int old_x, old_y;
+    wlmtk_element_get_position(element_ptr, &old_x, &old_y);
+    if (old_x == x && old_y == y) return;
+
+    wlmtk_container_spatial_index_t *si_ptr = &container_ptr->spatial_index;
+    wlmtk_container_child_array_t *ca_ptr = &container_ptr->child_array;
+    bool array_current =
+        ca_ptr->valid && ca_ptr->generation == si_ptr->generation;
+    struct wlr_box old_box;
+    bool had_box = _wlmtk_container_element_pointer_box(element_ptr, &old_box);
+
+    if (NULL != element_ptr->wlr_scene_node_ptr) {
+        wlr_scene_node_set_position(element_ptr->wlr_scene_node_ptr, x, y);
+    }
+    element_ptr->x = x;
+    element_ptr->y = y;
+
+    // The element's own extents are in its coordinates, and remain. Only the
+    // container's (and it's ancestors') cached extents need an update.
+    _wlmtk_container_spatial_index_translate(
+        si_ptr, element_ptr, had_box ? &old_box : NULL);
+    if (array_current) {
+        _wlmtk_container_child_array_translate(
+            ca_ptr, element_ptr, x - old_x, y - old_y);
+    }
+    // Bump generation, so that pointer focus gets looked up again on the
+    // next motion. But keep what we updated explicitly.
+    ++si_ptr->generation;
+    if (array_current) ca_ptr->generation = si_ptr->generation;
+
+    wlmtk_element_invalidate_extents(&container_ptr->super_element);
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmtk_container_update_pointer_focus(wlmtk_container_t *container_ptr)
 {
+    // Called when elements moved, so the pointer areas may have changed.
+    wlmtk_container_invalidate_spatial_index(container_ptr);
     if (NULL != container_ptr->super_element.parent_container_ptr) {
         wlmtk_container_update_pointer_focus(
             container_ptr->super_element.parent_container_ptr);
@@ -366,11 +711,17 @@ void wlmtk_container_set_keyboard_focus_element(
         BS_ASSERT(element_ptr->parent_container_ptr == container_ptr);
     }
     if (container_ptr->keyboard_focus_element_ptr == element_ptr) return;
-
-    if (NULL != container_ptr->keyboard_focus_element_ptr) {
-        wlmtk_element_keyboard_blur(container_ptr->keyboard_focus_element_ptr);
+    if (NULL == element_ptr && container_ptr->keyboard_blurring) {
+        // Cleared by the element being blurred: The blurring caller updates
+        // the chain above, no need to walk it up here.
+        container_ptr->keyboard_focus_element_ptr = NULL;
+        ++_wlmtk_container_keyboard_focus_serial;
+        return;
     }
+
+    _wlmtk_container_blur_keyboard_focus(container_ptr);
     container_ptr->keyboard_focus_element_ptr = element_ptr;
+    ++_wlmtk_container_keyboard_focus_serial;
 
     if (NULL != container_ptr->super_element.parent_container_ptr) {
         if (NULL != element_ptr) {
@@ -381,6 +732,33 @@ void wlmtk_container_set_keyboard_focus_element(
     }
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_container_set_spatial_index(
+    wlmtk_container_t *container_ptr,
+    int cell_size)
+{
+    BS_ASSERT(0 <= cell_size);
+    if (0 == cell_size) {
+        _wlmtk_container_spatial_index_fini(&container_ptr->spatial_index);
+        return;
+    }
+    container_ptr->spatial_index.cell_size = cell_size;
+    wlmtk_container_invalidate_spatial_index(container_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_container_set_child_array(
+    wlmtk_container_t *container_ptr,
+    bool enabled)
+{
+    if (!enabled) {
+        _wlmtk_container_child_array_fini(&container_ptr->child_array);
+        return;
+    }
+    container_ptr->child_array.enabled = true;
+    container_ptr->child_array.valid = false;
+}
+
 /* ------------------------------------------------------------------------- */
 struct wlr_scene_tree *wlmtk_container_wlr_scene_tree(
     wlmtk_container_t *container_ptr)
@@ -447,6 +825,9 @@ struct wlr_scene_node *_wlmtk_container_element_create_scene_node(
 /**
  * Implementation of the element's get_dimensions method: Return dimensions.
  *
+ * The result is cached in @ref wlmtk_element_t::dimensions_cache until
+ * invalidated by @ref wlmtk_element_invalidate_extents.
+ *
  * @param element_ptr
  * @param left_ptr            Leftmost position. May be NULL.
  * @param top_ptr             Topmost position. May be NULL.
@@ -462,38 +843,25 @@ void _wlmtk_container_element_get_dimensions(
 {
     wlmtk_container_t *container_ptr = BS_CONTAINER_OF(
         element_ptr, wlmtk_container_t, super_element);
+    wlmtk_element_extents_cache_t *cache_ptr = &element_ptr->dimensions_cache;
 
-    int left = INT32_MAX, top = INT32_MAX;
-    int right = INT32_MIN, bottom = INT32_MIN;
-    for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
-         dlnode_ptr != NULL;
-         dlnode_ptr = dlnode_ptr->next_ptr) {
-        wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
-        if (!element_ptr->visible) continue;
-
-        int x_pos, y_pos;
-        wlmtk_element_get_position(element_ptr, &x_pos, &y_pos);
-        int x1, y1, x2, y2;
-        wlmtk_element_get_dimensions(element_ptr, &x1, &y1, &x2, &y2);
-        left = BS_MIN(left, x_pos + x1);
-        top = BS_MIN(top, y_pos + y1);
-        right = BS_MAX(right, x_pos + x2);
-        bottom = BS_MAX(bottom, y_pos + y2);
+    if (!cache_ptr->valid) {
+        _wlmtk_container_compute_extents(container_ptr, false, cache_ptr);
     }
 
-    if (left >= right) { left = 0; right = 0; }
-    if (top >= bottom) { top = 0; bottom = 0; }
-
-    if (NULL != left_ptr) *left_ptr = left;
-    if (NULL != top_ptr) *top_ptr = top;
-    if (NULL != right_ptr) *right_ptr = right;
-    if (NULL != bottom_ptr) *bottom_ptr = bottom;
+    if (NULL != left_ptr) *left_ptr = cache_ptr->left;
+    if (NULL != top_ptr) *top_ptr = cache_ptr->top;
+    if (NULL != right_ptr) *right_ptr = cache_ptr->right;
+    if (NULL != bottom_ptr) *bottom_ptr = cache_ptr->bottom;
 }
 
 /* ------------------------------------------------------------------------- */
 /**
  * Returns the minimal rectangle covering all element's pointer areas.
  *
+ * Cached in @ref wlmtk_element_t::pointer_area_cache, same as for
+ * @ref _wlmtk_container_element_get_dimensions.
+ *
  * @param element_ptr
  * @param left_ptr            Leftmost position. May be NULL.
  * @param top_ptr             Topmost position. May be NULL.
@@ -509,19 +877,63 @@ void _wlmtk_container_element_get_pointer_area(
 {
     wlmtk_container_t *container_ptr = BS_CONTAINER_OF(
         element_ptr, wlmtk_container_t, super_element);
+    wlmtk_element_extents_cache_t *cache_ptr = &element_ptr->pointer_area_cache;
+
+    if (!cache_ptr->valid) {
+        _wlmtk_container_compute_extents(container_ptr, true, cache_ptr);
+    }
+
+    if (NULL != left_ptr) *left_ptr = cache_ptr->left;
+    if (NULL != top_ptr) *top_ptr = cache_ptr->top;
+    if (NULL != right_ptr) *right_ptr = cache_ptr->right;
+    if (NULL != bottom_ptr) *bottom_ptr = cache_ptr->bottom;
+}
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes the minimal rectangle covering all visible elements' dimensions,
+ * respectively pointer areas, and stores it into `cache_ptr`.
+ *
+ * @param container_ptr
+ * @param pointer_area        Whether to cover the pointer areas, instead of
+ *                            the dimensions.
+ * @param cache_ptr
+ */
+void _wlmtk_container_compute_extents(
+    wlmtk_container_t *container_ptr,
+    bool pointer_area,
+    wlmtk_element_extents_cache_t *cache_ptr)
+{
     int left = INT32_MAX, top = INT32_MAX;
     int right = INT32_MIN, bottom = INT32_MIN;
+    bool use_list = true;
+    if (pointer_area && _wlmtk_container_child_array_update(container_ptr)) {
+        const wlmtk_container_child_array_t *ca_ptr =
+            &container_ptr->child_array;
+        for (size_t i = 0; i < ca_ptr->count; ++i) {
+            left = BS_MIN(left, ca_ptr->x1_ptr[i]);
+            top = BS_MIN(top, ca_ptr->y1_ptr[i]);
+            right = BS_MAX(right, ca_ptr->x2_ptr[i]);
+            bottom = BS_MAX(bottom, ca_ptr->y2_ptr[i]);
+        }
+        use_list = false;
+    }
+
     for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
-         dlnode_ptr != NULL;
+         use_list && dlnode_ptr != NULL;
          dlnode_ptr = dlnode_ptr->next_ptr) {
         wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
         if (!element_ptr->visible) continue;
+        if (pointer_area && element_ptr->input_transparent) continue;
 
         int x_pos, y_pos;
         wlmtk_element_get_position(element_ptr, &x_pos, &y_pos);
         int x1, y1, x2, y2;
-        wlmtk_element_get_pointer_area(element_ptr, &x1, &y1, &x2, &y2);
+        if (pointer_area) {
+            wlmtk_element_get_pointer_area(element_ptr, &x1, &y1, &x2, &y2);
+        } else {
+            wlmtk_element_get_dimensions(element_ptr, &x1, &y1, &x2, &y2);
+        }
         left = BS_MIN(left, x_pos + x1);
         top = BS_MIN(top, y_pos + y1);
         right = BS_MAX(right, x_pos + x2);
@@ -531,10 +943,11 @@ void _wlmtk_container_element_get_pointer_area(
     if (left >= right) { left = 0; right = 0; }
     if (top >= bottom) { top = 0; bottom = 0; }
 
-    if (NULL != left_ptr) *left_ptr = left;
-    if (NULL != top_ptr) *top_ptr = top;
-    if (NULL != right_ptr) *right_ptr = right;
-    if (NULL != bottom_ptr) *bottom_ptr = bottom;
+    cache_ptr->left = left;
+    cache_ptr->top = top;
+    cache_ptr->right = right;
+    cache_ptr->bottom = bottom;
+    cache_ptr->valid = true;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -705,12 +1118,21 @@ void _wlmtk_container_element_keyboard_blur(wlmtk_element_t *element_ptr)
     // Guard clause: No elements having keyboard focus, return right away.
     if (NULL == container_ptr->keyboard_focus_element_ptr) return;
 
-    wlmtk_element_keyboard_blur(container_ptr->keyboard_focus_element_ptr);
+    _wlmtk_container_blur_keyboard_focus(container_ptr);
+    // The element may have cleared it already, when blurred.
+    if (NULL == container_ptr->keyboard_focus_element_ptr) return;
     container_ptr->keyboard_focus_element_ptr = NULL;
+    ++_wlmtk_container_keyboard_focus_serial;
 }
 
 /* ------------------------------------------------------------------------- */
-/** Handler for keyboard events: Pass to keyboard-focussed element, if any. */
+/**
+ * Handler for keyboard events: Pass to keyboard-focussed element, if any.
+ *
+ * Plain containers along the focus chain would just forward the event, so
+ * it goes straight to the chain's leaf, as cached by
+ * @ref _wlmtk_container_keyboard_focus_leaf.
+ */
 bool _wlmtk_container_element_keyboard_event(
     wlmtk_element_t *element_ptr,
     struct wlr_keyboard_key_event *wlr_keyboard_key_event_ptr,
@@ -720,11 +1142,13 @@ bool _wlmtk_container_element_keyboard_event(
 {
     wlmtk_container_t *container_ptr = BS_CONTAINER_OF(
         element_ptr, wlmtk_container_t, super_element);
+    wlmtk_element_t *leaf_element_ptr =
+        _wlmtk_container_keyboard_focus_leaf(container_ptr);
     // Guard clause: No focus here, return right away.
-    if (NULL == container_ptr->keyboard_focus_element_ptr) return false;
+    if (NULL == leaf_element_ptr) return false;
 
     return wlmtk_element_keyboard_event(
-        container_ptr->keyboard_focus_element_ptr,
+        leaf_element_ptr,
         wlr_keyboard_key_event_ptr,
         key_syms,
         key_syms_count,
@@ -797,35 +1221,61 @@ bool update_pointer_focus_at(
         return true;
     }
 
-    for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
-         dlnode_ptr != NULL;
-         dlnode_ptr = dlnode_ptr->next_ptr) {
-        wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
-
-        if (!element_ptr->visible) continue;
-
-        int x_pos, y_pos;
-        wlmtk_element_get_position(element_ptr, &x_pos, &y_pos);
-        int x1, y1, x2, y2;
-        wlmtk_element_get_pointer_area(element_ptr, &x1, &y1, &x2, &y2);
-        if (x_pos + x1 <= x && x < x_pos + x2 &&
-            y_pos + y1 <= y && y < y_pos + y2) {
-            e.x = x - x_pos;
-            e.y = y - y_pos;
-            if (!wlmtk_element_pointer_motion(element_ptr, &e)) {
-                continue;
+    // Fast path: The pointer focus is retained, if the pointer is still
+    // within it's area and nothing could have moved above it.
+    if (NULL != container_ptr->pointer_focus_element_ptr &&
+        container_ptr->pointer_focus_unobstructed &&
+        container_ptr->pointer_focus_generation ==
+        container_ptr->spatial_index.generation &&
+        _wlmtk_container_pointer_motion_at_element(
+            container_ptr, container_ptr->pointer_focus_element_ptr,
+            x, y, &e)) return true;
+
+    bool use_list = true;
+    if (_wlmtk_container_spatial_index_update(container_ptr)) {
+        wlmtk_container_spatial_index_t *si_ptr = &container_ptr->spatial_index;
+        uint64_t generation = si_ptr->generation;
+        size_t count;
+        wlmtk_element_t **element_ptrs = _wlmtk_container_spatial_index_lookup(
+            si_ptr, x, y, &count);
+        for (size_t i = 0; i < count; ++i) {
+            if (_wlmtk_container_pointer_motion_at_element(
+                    container_ptr, element_ptrs[i], x, y, &e)) {
+                _wlmtk_container_cache_pointer_focus(container_ptr);
+                return true;
             }
-
-            // There is a focus change. Invalidate coordinates in old element.
-            if (container_ptr->pointer_focus_element_ptr != element_ptr &&
-                NULL != container_ptr->pointer_focus_element_ptr) {
-                e.x = NAN;
-                e.y = NAN;
-                wlmtk_element_pointer_motion(
-                    container_ptr->pointer_focus_element_ptr, &e);
-
+            // The motion handler modified the container. Index is stale.
+            if (generation != si_ptr->generation) break;
+        }
+        use_list = (generation != si_ptr->generation);
+    } else if (_wlmtk_container_child_array_update(container_ptr) &&
+               -INT32_MAX < x && x < INT32_MAX &&
+               -INT32_MAX < y && y < INT32_MAX) {
+        // Note: The comparisons above also rule out NAN.
+        wlmtk_container_child_array_t *ca_ptr = &container_ptr->child_array;
+        uint64_t generation = container_ptr->spatial_index.generation;
+        int32_t ix = floor(x), iy = floor(y);
+        for (size_t i = _wlmtk_container_child_array_find(ca_ptr, ix, iy, 0);
+             i < ca_ptr->count;
+             i = _wlmtk_container_child_array_find(ca_ptr, ix, iy, i + 1)) {
+            if (_wlmtk_container_pointer_motion_at_element(
+                    container_ptr, ca_ptr->elements_ptr[i], x, y, &e)) {
+                _wlmtk_container_cache_pointer_focus(container_ptr);
+                return true;
             }
-            container_ptr->pointer_focus_element_ptr = element_ptr;
+            if (generation != container_ptr->spatial_index.generation) break;
+        }
+        use_list = (generation != container_ptr->spatial_index.generation);
+    }
+
+    for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
+         use_list && dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        if (_wlmtk_container_pointer_motion_at_element(
+                container_ptr,
+                wlmtk_element_from_dlnode(dlnode_ptr),
+                x, y, &e)) {
+            _wlmtk_container_cache_pointer_focus(container_ptr);
             return true;
         }
     }
@@ -845,38 +1295,833 @@ bool update_pointer_focus_at(
 
 /* ------------------------------------------------------------------------- */
 /**
- * Base implementation of wlmtk_container_vmt_t::update_layout. If there's
- * a parent, will call @ref wlmtk_container_update_layout. Otherwise, will
- * update the pointer focus.
+ * Passes the motion to `element_ptr`, if (x, y) is within it's pointer area.
+ *
+ * If the element accepts the motion, it becomes the container's pointer focus
+ * element. A former pointer focus element will receive a motion event with
+ * NAN coordinates.
  *
  * @param container_ptr
+ * @param element_ptr
+ * @param x
+ * @param y
+ * @param motion_event_ptr    Motion event, with `time_msec` and
+ *                            `pointer_ptr` filled in. `x` and `y` will be
+ *                            overwritten.
+ *
+ * @return Whether `element_ptr` accepted the motion.
  */
-void _wlmtk_container_update_layout(wlmtk_container_t *container_ptr)
+bool _wlmtk_container_pointer_motion_at_element(
+    wlmtk_container_t *container_ptr,
+    wlmtk_element_t *element_ptr,
+    double x,
+    double y,
+    wlmtk_pointer_motion_event_t *motion_event_ptr)
 {
-    if (NULL != container_ptr->super_element.parent_container_ptr) {
-        wlmtk_container_update_layout(
-            container_ptr->super_element.parent_container_ptr);
-    } else {
-        wlmtk_container_update_pointer_focus(container_ptr);
+    if (!element_ptr->visible || element_ptr->input_transparent) return false;
+
+    int x_pos, y_pos;
+    wlmtk_element_get_position(element_ptr, &x_pos, &y_pos);
+    int x1, y1, x2, y2;
+    wlmtk_element_get_pointer_area(element_ptr, &x1, &y1, &x2, &y2);
+    if (!(x_pos + x1 <= x && x < x_pos + x2 &&
+          y_pos + y1 <= y && y < y_pos + y2)) return false;
+
+    motion_event_ptr->x = x - x_pos;
+    motion_event_ptr->y = y - y_pos;
+    if (!wlmtk_element_pointer_motion(element_ptr, motion_event_ptr)) {
+        return false;
     }
-}
 
-/* == Helper for unit tests: A fake container with a tree, as parent ======= */
+    // There is a focus change. Invalidate coordinates in old element.
+    if (container_ptr->pointer_focus_element_ptr != element_ptr &&
+        NULL != container_ptr->pointer_focus_element_ptr) {
+        motion_event_ptr->x = NAN;
+        motion_event_ptr->y = NAN;
+        wlmtk_element_pointer_motion(
+            container_ptr->pointer_focus_element_ptr, motion_event_ptr);
+    }
+    container_ptr->pointer_focus_element_ptr = element_ptr;
+    return true;
+}
 
-/** State of the "fake" parent container. Refers to a scene graph. */
-typedef struct {
-    /** The actual container */
-    wlmtk_container_t         container;
-    /** A scene graph. Not attached to any output, */
-    struct wlr_scene          *wlr_scene_ptr;
-} fake_parent_container_t;
+/* ------------------------------------------------------------------------- */
+/**
+ * Records the generation for the current pointer focus element, and whether
+ * any visible element stacked above overlaps it's pointer area. Enables the
+ * fast path in @ref update_pointer_focus_at.
+ *
+ * @param container_ptr
+ */
+void _wlmtk_container_cache_pointer_focus(wlmtk_container_t *container_ptr)
+{
+    wlmtk_element_t *focus_ptr = container_ptr->pointer_focus_element_ptr;
+    container_ptr->pointer_focus_generation =
+        container_ptr->spatial_index.generation;
+    container_ptr->pointer_focus_unobstructed = false;
+
+    // The motion handler may have removed the element again.
+    struct wlr_box focus_box;
+    if (NULL == focus_ptr ||
+        !_wlmtk_container_element_pointer_box(focus_ptr, &focus_box)) return;
+    for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
+         dlnode_ptr != &focus_ptr->dlnode;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        struct wlr_box box, intersection;
+        if (_wlmtk_container_element_pointer_box(
+                wlmtk_element_from_dlnode(dlnode_ptr), &box) &&
+            wlr_box_intersection(&intersection, &box, &focus_box)) return;
+    }
+    container_ptr->pointer_focus_unobstructed = true;
+}
 
 /* ------------------------------------------------------------------------- */
-wlmtk_container_t *wlmtk_container_create_fake_parent(void)
+/** Releases resources of the spatial index and disables it. */
+void _wlmtk_container_spatial_index_fini(
+    wlmtk_container_spatial_index_t *spatial_index_ptr)
 {
-    fake_parent_container_t *fake_parent_container_ptr = logged_calloc(
-        1, sizeof(fake_parent_container_t));
-    if (NULL == fake_parent_container_ptr) return NULL;
+    if (NULL != spatial_index_ptr->cell_offsets_ptr) {
+        free(spatial_index_ptr->cell_offsets_ptr);
+    }
+    if (NULL != spatial_index_ptr->entries_ptr) {
+        free(spatial_index_ptr->entries_ptr);
+    }
+    uint64_t generation = spatial_index_ptr->generation;
+    *spatial_index_ptr = (wlmtk_container_spatial_index_t){
+        .generation = generation + 1 };
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes the pointer area of `element_ptr`, in the parent's coordinates.
+ *
+ * @param element_ptr
+ * @param box_ptr
+ *
+ * @return true if the element is visible, not input transparent and has a
+ *     non-empty pointer area.
+ */
+bool _wlmtk_container_element_pointer_box(
+    wlmtk_element_t *element_ptr,
+    struct wlr_box *box_ptr)
+{
+    if (!element_ptr->visible || element_ptr->input_transparent) return false;
+
+    int x_pos, y_pos;
+    wlmtk_element_get_position(element_ptr, &x_pos, &y_pos);
+    int x1, y1, x2, y2;
+    wlmtk_element_get_pointer_area(element_ptr, &x1, &y1, &x2, &y2);
+    *box_ptr = (struct wlr_box){
+        .x = x_pos + x1, .y = y_pos + y1, .width = x2 - x1, .height = y2 - y1
+    };
+    return 0 < box_ptr->width && 0 < box_ptr->height;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Rebuilds the spatial index of `container_ptr`, if it is enabled and dirty.
+ *
+ * @param container_ptr
+ *
+ * @return true if the index is enabled and up-to-date. false if the index is
+ *     not enabled, or failed to rebuild. The caller must then fall back to
+ *     iterating over @ref wlmtk_container_t::elements.
+ */
+bool _wlmtk_container_spatial_index_update(wlmtk_container_t *container_ptr)
+{
+    wlmtk_container_spatial_index_t *si_ptr = &container_ptr->spatial_index;
+    if (0 >= si_ptr->cell_size) return false;
+    if (!si_ptr->dirty) return true;
+
+    // First pass: Bounding box of all pointer areas.
+    int left = INT32_MAX, top = INT32_MAX;
+    int right = INT32_MIN, bottom = INT32_MIN;
+    for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        struct wlr_box box;
+        if (!_wlmtk_container_element_pointer_box(
+                wlmtk_element_from_dlnode(dlnode_ptr), &box)) continue;
+        left = BS_MIN(left, box.x);
+        top = BS_MIN(top, box.y);
+        right = BS_MAX(right, box.x + box.width);
+        bottom = BS_MAX(bottom, box.y + box.height);
+    }
+    si_ptr->columns = 0;
+    si_ptr->rows = 0;
+    if (left >= right || top >= bottom) {
+        si_ptr->dirty = false;
+        return true;
+    }
+
+    // Grid dimensions. Larger cells, if the area were to exceed the limit.
+    int max_cells = _wlmtk_container_spatial_index_max_cells;
+    si_ptr->x = left;
+    si_ptr->y = top;
+    si_ptr->cell_width = BS_MAX(
+        si_ptr->cell_size, (right - left + max_cells - 1) / max_cells);
+    si_ptr->cell_height = BS_MAX(
+        si_ptr->cell_size, (bottom - top + max_cells - 1) / max_cells);
+    int columns = (right - left + si_ptr->cell_width - 1) / si_ptr->cell_width;
+    int rows = (bottom - top + si_ptr->cell_height - 1) / si_ptr->cell_height;
+    size_t cells = (size_t)columns * (size_t)rows;
+
+    if (si_ptr->cell_offsets_capacity < cells + 1) {
+        if (NULL != si_ptr->cell_offsets_ptr) free(si_ptr->cell_offsets_ptr);
+        si_ptr->cell_offsets_capacity = 0;
+        si_ptr->cell_offsets_ptr = logged_calloc(cells + 1, sizeof(size_t));
+        if (NULL == si_ptr->cell_offsets_ptr) return false;
+        si_ptr->cell_offsets_capacity = cells + 1;
+    }
+    size_t *offsets_ptr = si_ptr->cell_offsets_ptr;
+    for (size_t i = 0; i <= cells; ++i) offsets_ptr[i] = 0;
+
+    // Second pass: Count number of elements in each of the cells.
+    for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        struct wlr_box box;
+        if (!_wlmtk_container_element_pointer_box(
+                wlmtk_element_from_dlnode(dlnode_ptr), &box)) continue;
+        int c1 = (box.x - left) / si_ptr->cell_width;
+        int c2 = (box.x + box.width - 1 - left) / si_ptr->cell_width;
+        int r1 = (box.y - top) / si_ptr->cell_height;
+        int r2 = (box.y + box.height - 1 - top) / si_ptr->cell_height;
+        for (int r = r1; r <= r2; ++r) {
+            for (int c = c1; c <= c2; ++c) ++offsets_ptr[r * columns + c];
+        }
+    }
+
+    // Turn counts into (exclusive) prefix sums: Offsets to each cell.
+    size_t total = 0;
+    for (size_t i = 0; i < cells; ++i) {
+        size_t count = offsets_ptr[i];
+        offsets_ptr[i] = total;
+        total += count;
+    }
+    offsets_ptr[cells] = total;
+
+    if (si_ptr->entries_capacity < total) {
+        if (NULL != si_ptr->entries_ptr) free(si_ptr->entries_ptr);
+        si_ptr->entries_capacity = 0;
+        si_ptr->entries_ptr = logged_calloc(total, sizeof(wlmtk_element_t*));
+        if (NULL == si_ptr->entries_ptr) return false;
+        si_ptr->entries_capacity = total;
+    }
+
+    // Third pass: Store elements, top to bottom. Advances each offset to the
+    // end of it's cell, so these get shifted back afterwards.
+    for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
+        struct wlr_box box;
+        if (!_wlmtk_container_element_pointer_box(element_ptr, &box)) continue;
+        int c1 = (box.x - left) / si_ptr->cell_width;
+        int c2 = (box.x + box.width - 1 - left) / si_ptr->cell_width;
+        int r1 = (box.y - top) / si_ptr->cell_height;
+        int r2 = (box.y + box.height - 1 - top) / si_ptr->cell_height;
+        for (int r = r1; r <= r2; ++r) {
+            for (int c = c1; c <= c2; ++c) {
+                si_ptr->entries_ptr[offsets_ptr[r * columns + c]++] =
+                    element_ptr;
+            }
+        }
+    }
+    for (size_t i = cells; i > 0; --i) offsets_ptr[i] = offsets_ptr[i - 1];
+    offsets_ptr[0] = 0;
+
+    si_ptr->columns = columns;
+    si_ptr->rows = rows;
+    si_ptr->dirty = false;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Looks up the elements whose pointer area may include (x, y).
+ *
+ * @param spatial_index_ptr   Must be up-to-date.
+ * @param x
+ * @param y
+ * @param count_ptr           Number of elements returned.
+ *
+ * @return Pointer to an array of `*count_ptr` elements, in stacking order.
+ *     The array remains valid until the index is rebuilt.
+ */
+wlmtk_element_t **_wlmtk_container_spatial_index_lookup(
+    wlmtk_container_spatial_index_t *spatial_index_ptr,
+    double x,
+    double y,
+    size_t *count_ptr)
+{
+    *count_ptr = 0;
+    if (isnan(x) || isnan(y)) return NULL;
+
+    double column = floor((x - spatial_index_ptr->x) /
+                          spatial_index_ptr->cell_width);
+    double row = floor((y - spatial_index_ptr->y) /
+                       spatial_index_ptr->cell_height);
+    if (0 > column || column >= spatial_index_ptr->columns ||
+        0 > row || row >= spatial_index_ptr->rows) return NULL;
+
+    size_t cell = (size_t)row * spatial_index_ptr->columns + (size_t)column;
+    size_t offset = spatial_index_ptr->cell_offsets_ptr[cell];
+    *count_ptr = spatial_index_ptr->cell_offsets_ptr[cell + 1] - offset;
+    return &spatial_index_ptr->entries_ptr[offset];
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Base implementation of wlmtk_container_vmt_t::update_layout. If there's
+ * a parent, will call @ref wlmtk_container_update_layout. Otherwise, will
+ * update the pointer focus.
+ *
+ * @param container_ptr
+ */
+void _wlmtk_container_update_layout(wlmtk_container_t *container_ptr)
+{
+    if (NULL != container_ptr->super_element.parent_container_ptr) {
+        wlmtk_container_update_layout(
+            container_ptr->super_element.parent_container_ptr);
+    } else {
+        wlmtk_container_update_pointer_focus(container_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Updates spatial index, child array and pointer focus after `element_ptr`
+ * was moved to the top of `container_ptr`. Neither dimensions nor pointer
+ * area of the container change, so there's no need for a layout update.
+ *
+ * Pointer focus can only change towards `element_ptr`, and only if it covers
+ * the most recent pointer position. Otherwise, it remains as is.
+ *
+ * @param container_ptr
+ * @param element_ptr
+ */
+void _wlmtk_container_restack_to_top(
+    wlmtk_container_t *container_ptr,
+    wlmtk_element_t *element_ptr)
+{
+    wlmtk_container_spatial_index_t *si_ptr = &container_ptr->spatial_index;
+    wlmtk_container_child_array_t *ca_ptr = &container_ptr->child_array;
+    bool focus_current =
+        container_ptr->pointer_focus_generation == si_ptr->generation;
+    bool array_current =
+        ca_ptr->valid && ca_ptr->generation == si_ptr->generation;
+
+    _wlmtk_container_spatial_index_raise(si_ptr, element_ptr);
+    if (array_current) _wlmtk_container_child_array_raise(ca_ptr, element_ptr);
+
+    // Bump generation, for detecting re-entrant changes. But keep what we
+    // updated explicitly.
+    ++si_ptr->generation;
+    if (array_current) ca_ptr->generation = si_ptr->generation;
+
+    wlmtk_element_t *focus_ptr = container_ptr->pointer_focus_element_ptr;
+    if (focus_ptr == element_ptr) {
+        if (focus_current) {
+            container_ptr->pointer_focus_generation = si_ptr->generation;
+            container_ptr->pointer_focus_unobstructed = true;
+        }
+        return;
+    }
+
+    const wlmtk_pointer_motion_event_t *e_ptr =
+        &container_ptr->super_element.last_pointer_motion_event;
+    struct wlr_box box;
+    bool has_box = _wlmtk_container_element_pointer_box(element_ptr, &box);
+    if (has_box && wlr_box_contains_point(&box, e_ptr->x, e_ptr->y)) {
+        update_pointer_focus_at(
+            container_ptr, e_ptr->x, e_ptr->y,
+            e_ptr->time_msec, e_ptr->pointer_ptr);
+        return;
+    }
+
+    if (NULL != focus_ptr && focus_current) {
+        container_ptr->pointer_focus_generation = si_ptr->generation;
+        struct wlr_box focus_box, intersection;
+        if (has_box &&
+            _wlmtk_container_element_pointer_box(focus_ptr, &focus_box) &&
+            wlr_box_intersection(&intersection, &box, &focus_box)) {
+            container_ptr->pointer_focus_unobstructed = false;
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Moves `element_ptr` to the front of each cell it overlaps. Marks the index
+ * as dirty, if it cannot be updated in place.
+ *
+ * @param spatial_index_ptr
+ * @param element_ptr
+ */
+void _wlmtk_container_spatial_index_raise(
+    wlmtk_container_spatial_index_t *spatial_index_ptr,
+    wlmtk_element_t *element_ptr)
+{
+    wlmtk_container_spatial_index_t *si_ptr = spatial_index_ptr;
+    if (0 >= si_ptr->cell_size || si_ptr->dirty) return;
+
+    struct wlr_box box;
+    if (!_wlmtk_container_element_pointer_box(element_ptr, &box)) return;
+    int c1 = (box.x - si_ptr->x) / si_ptr->cell_width;
+    int c2 = (box.x + box.width - 1 - si_ptr->x) / si_ptr->cell_width;
+    int r1 = (box.y - si_ptr->y) / si_ptr->cell_height;
+    int r2 = (box.y + box.height - 1 - si_ptr->y) / si_ptr->cell_height;
+    if (box.x < si_ptr->x || box.y < si_ptr->y ||
+        c2 >= si_ptr->columns || r2 >= si_ptr->rows) {
+        si_ptr->dirty = true;
+        return;
+    }
+
+    for (int r = r1; r <= r2; ++r) {
+        for (int c = c1; c <= c2; ++c) {
+            size_t cell = (size_t)r * si_ptr->columns + (size_t)c;
+            size_t begin = si_ptr->cell_offsets_ptr[cell];
+            size_t end = si_ptr->cell_offsets_ptr[cell + 1];
+            size_t i = begin;
+            while (i < end && si_ptr->entries_ptr[i] != element_ptr) ++i;
+            if (i >= end) {
+                si_ptr->dirty = true;
+                return;
+            }
+            memmove(&si_ptr->entries_ptr[begin + 1],
+                    &si_ptr->entries_ptr[begin],
+                    (i - begin) * sizeof(wlmtk_element_t*));
+            si_ptr->entries_ptr[begin] = element_ptr;
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Moves `element_ptr` to the front of the child array, if it's stored. */
+void _wlmtk_container_child_array_raise(
+    wlmtk_container_child_array_t *child_array_ptr,
+    wlmtk_element_t *element_ptr)
+{
+    wlmtk_container_child_array_t *ca_ptr = child_array_ptr;
+    size_t i = 0;
+    while (i < ca_ptr->count && ca_ptr->elements_ptr[i] != element_ptr) ++i;
+    if (i >= ca_ptr->count) return;
+
+    int32_t x1 = ca_ptr->x1_ptr[i], y1 = ca_ptr->y1_ptr[i];
+    int32_t x2 = ca_ptr->x2_ptr[i], y2 = ca_ptr->y2_ptr[i];
+    memmove(&ca_ptr->elements_ptr[1], &ca_ptr->elements_ptr[0],
+            i * sizeof(wlmtk_element_t*));
+    memmove(&ca_ptr->x1_ptr[1], &ca_ptr->x1_ptr[0], i * sizeof(int32_t));
+    memmove(&ca_ptr->y1_ptr[1], &ca_ptr->y1_ptr[0], i * sizeof(int32_t));
+    memmove(&ca_ptr->x2_ptr[1], &ca_ptr->x2_ptr[0], i * sizeof(int32_t));
+    memmove(&ca_ptr->y2_ptr[1], &ca_ptr->y2_ptr[0], i * sizeof(int32_t));
+    ca_ptr->elements_ptr[0] = element_ptr;
+    ca_ptr->x1_ptr[0] = x1;
+    ca_ptr->y1_ptr[0] = y1;
+    ca_ptr->x2_ptr[0] = x2;
+    ca_ptr->y2_ptr[0] = y2;
+    // Re-ordered: No longer a uniform stack, until rebuilt.
+    ca_ptr->stride = 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Keeps the index in place after `element_ptr` was translated, if the element
+ * still overlaps the same cells. Marks the index as dirty otherwise.
+ *
+ * @param spatial_index_ptr
+ * @param element_ptr
+ * @param old_box_ptr         Pointer area before the translation, or NULL if
+ *                            the element had none.
+ */
+void _wlmtk_container_spatial_index_translate(
+    wlmtk_container_spatial_index_t *spatial_index_ptr,
+    wlmtk_element_t *element_ptr,
+    const struct wlr_box *old_box_ptr)
+{
+    wlmtk_container_spatial_index_t *si_ptr = spatial_index_ptr;
+    if (0 >= si_ptr->cell_size || si_ptr->dirty) return;
+
+    struct wlr_box box;
+    bool has_box = _wlmtk_container_element_pointer_box(element_ptr, &box);
+    if (NULL == old_box_ptr && !has_box) return;
+    if (NULL == old_box_ptr || !has_box ||
+        box.x < si_ptr->x || box.y < si_ptr->y ||
+        old_box_ptr->x < si_ptr->x || old_box_ptr->y < si_ptr->y) {
+        si_ptr->dirty = true;
+        return;
+    }
+
+    int c1 = (box.x - si_ptr->x) / si_ptr->cell_width;
+    int c2 = (box.x + box.width - 1 - si_ptr->x) / si_ptr->cell_width;
+    int r1 = (box.y - si_ptr->y) / si_ptr->cell_height;
+    int r2 = (box.y + box.height - 1 - si_ptr->y) / si_ptr->cell_height;
+    const struct wlr_box *o_ptr = old_box_ptr;
+    int oc1 = (o_ptr->x - si_ptr->x) / si_ptr->cell_width;
+    int oc2 = (o_ptr->x + o_ptr->width - 1 - si_ptr->x) / si_ptr->cell_width;
+    int or1 = (o_ptr->y - si_ptr->y) / si_ptr->cell_height;
+    int or2 = (o_ptr->y + o_ptr->height - 1 - si_ptr->y) / si_ptr->cell_height;
+    if (c1 != oc1 || c2 != oc2 || r1 != or1 || r2 != or2 ||
+        c2 >= si_ptr->columns || r2 >= si_ptr->rows) {
+        si_ptr->dirty = true;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Shifts the stored pointer area of `element_ptr` by `dx`, `dy`. Invalidates
+ * the child array if the element isn't stored.
+ *
+ * @param child_array_ptr
+ * @param element_ptr
+ * @param dx
+ * @param dy
+ */
+void _wlmtk_container_child_array_translate(
+    wlmtk_container_child_array_t *child_array_ptr,
+    wlmtk_element_t *element_ptr,
+    int dx,
+    int dy)
+{
+    wlmtk_container_child_array_t *ca_ptr = child_array_ptr;
+    size_t i = 0;
+    while (i < ca_ptr->count && ca_ptr->elements_ptr[i] != element_ptr) ++i;
+    if (i >= ca_ptr->count) {
+        if (element_ptr->visible && !element_ptr->input_transparent) {
+            ca_ptr->valid = false;
+        }
+        return;
+    }
+    ca_ptr->x1_ptr[i] += dx;
+    ca_ptr->y1_ptr[i] += dy;
+    ca_ptr->x2_ptr[i] += dx;
+    ca_ptr->y2_ptr[i] += dy;
+    ca_ptr->stride = 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Releases resources of the child array and disables it. */
+void _wlmtk_container_child_array_fini(
+    wlmtk_container_child_array_t *child_array_ptr)
+{
+    if (NULL != child_array_ptr->elements_ptr) {
+        free(child_array_ptr->elements_ptr);
+    }
+    if (NULL != child_array_ptr->x1_ptr) free(child_array_ptr->x1_ptr);
+    if (NULL != child_array_ptr->y1_ptr) free(child_array_ptr->y1_ptr);
+    if (NULL != child_array_ptr->x2_ptr) free(child_array_ptr->x2_ptr);
+    if (NULL != child_array_ptr->y2_ptr) free(child_array_ptr->y2_ptr);
+    *child_array_ptr = (wlmtk_container_child_array_t){};
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Rebuilds the child array of `container_ptr`, if enabled and outdated.
+ *
+ * @param container_ptr
+ *
+ * @return true if the array is enabled and up-to-date. false if the array is
+ *     disabled, or on allocation failure. Then, the list must be used.
+ */
+bool _wlmtk_container_child_array_update(wlmtk_container_t *container_ptr)
+{
+    wlmtk_container_child_array_t *ca_ptr = &container_ptr->child_array;
+    if (!ca_ptr->enabled) return false;
+    if (ca_ptr->valid &&
+        ca_ptr->generation == container_ptr->spatial_index.generation) {
+        return true;
+    }
+
+    size_t size = bs_dllist_size(&container_ptr->elements);
+    if (ca_ptr->capacity < size) {
+        _wlmtk_container_child_array_fini(ca_ptr);
+        ca_ptr->enabled = true;
+        ca_ptr->elements_ptr = logged_calloc(size, sizeof(wlmtk_element_t*));
+        ca_ptr->x1_ptr = logged_calloc(size, sizeof(int32_t));
+        ca_ptr->y1_ptr = logged_calloc(size, sizeof(int32_t));
+        ca_ptr->x2_ptr = logged_calloc(size, sizeof(int32_t));
+        ca_ptr->y2_ptr = logged_calloc(size, sizeof(int32_t));
+        if (NULL == ca_ptr->elements_ptr ||
+            NULL == ca_ptr->x1_ptr || NULL == ca_ptr->y1_ptr ||
+            NULL == ca_ptr->x2_ptr || NULL == ca_ptr->y2_ptr) {
+            _wlmtk_container_child_array_fini(ca_ptr);
+            ca_ptr->enabled = true;
+            return false;
+        }
+        ca_ptr->capacity = size;
+    }
+
+    size_t i = 0;
+    for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
+        if (!element_ptr->visible || element_ptr->input_transparent) continue;
+
+        int x_pos, y_pos;
+        wlmtk_element_get_position(element_ptr, &x_pos, &y_pos);
+        int x1, y1, x2, y2;
+        wlmtk_element_get_pointer_area(element_ptr, &x1, &y1, &x2, &y2);
+        ca_ptr->elements_ptr[i] = element_ptr;
+        ca_ptr->x1_ptr[i] = x_pos + x1;
+        ca_ptr->y1_ptr[i] = y_pos + y1;
+        ca_ptr->x2_ptr[i] = x_pos + x2;
+        ca_ptr->y2_ptr[i] = y_pos + y2;
+        ++i;
+    }
+    ca_ptr->count = i;
+    ca_ptr->generation = container_ptr->spatial_index.generation;
+    ca_ptr->valid = true;
+
+    ca_ptr->stride_vertical = true;
+    ca_ptr->stride = _wlmtk_container_child_array_stride(
+        ca_ptr->y1_ptr, ca_ptr->y2_ptr, ca_ptr->count);
+    if (0 == ca_ptr->stride) {
+        ca_ptr->stride_vertical = false;
+        ca_ptr->stride = _wlmtk_container_child_array_stride(
+            ca_ptr->x1_ptr, ca_ptr->x2_ptr, ca_ptr->count);
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes the stride of a uniform stack, along one axis.
+ *
+ * @param p1_ptr              Start positions of the pointer areas.
+ * @param p2_ptr              End positions (exclusive) of the pointer areas.
+ * @param count
+ *
+ * @return The stride, if each area starts `stride` after the preceding one,
+ *     and none extends beyond its stride. Otherwise, or for less than two
+ *     elements, 0.
+ */
+int32_t _wlmtk_container_child_array_stride(
+    const int32_t *p1_ptr,
+    const int32_t *p2_ptr,
+    size_t count)
+{
+    if (2 > count) return 0;
+    int64_t stride = (int64_t)p1_ptr[1] - p1_ptr[0];
+    if (0 >= stride || INT32_MAX < stride) return 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        if ((int64_t)p1_ptr[i] != p1_ptr[0] + (int64_t)i * stride ||
+            (int64_t)p2_ptr[i] - p1_ptr[i] > stride) return 0;
+    }
+    return stride;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Finds the first element in the child array containing (x, y).
+ *
+ * @param child_array_ptr
+ * @param x
+ * @param y
+ * @param start               Index to start the search from.
+ *
+ * @return Index of the first element at or after `start` whose pointer area
+ *     contains (x, y), or `count` if there is none.
+ */
+size_t _wlmtk_container_child_array_find(
+    const wlmtk_container_child_array_t *child_array_ptr,
+    int32_t x,
+    int32_t y,
+    size_t start)
+{
+    // A uniform stack: Only the element in the pointer's slot can contain it.
+    if (0 < child_array_ptr->stride) {
+        const int32_t *p1_ptr = child_array_ptr->stride_vertical ?
+            child_array_ptr->y1_ptr : child_array_ptr->x1_ptr;
+        int64_t p = child_array_ptr->stride_vertical ? y : x;
+        if (p < p1_ptr[0]) return child_array_ptr->count;
+        size_t i = (p - p1_ptr[0]) / child_array_ptr->stride;
+        if (i < start || i >= child_array_ptr->count ||
+            !(child_array_ptr->x1_ptr[i] <= x &&
+              x < child_array_ptr->x2_ptr[i] &&
+              child_array_ptr->y1_ptr[i] <= y &&
+              y < child_array_ptr->y2_ptr[i])) {
+            return child_array_ptr->count;
+        }
+        return i;
+    }
+
+    if (NULL == _wlmtk_container_hit_kernel) {
+        _wlmtk_container_hit_kernel = _wlmtk_container_hit_kernel_for(
+            wlmtk_util_simd_best());
+    }
+    return _wlmtk_container_hit_kernel(
+        child_array_ptr->x1_ptr, child_array_ptr->y1_ptr,
+        child_array_ptr->x2_ptr, child_array_ptr->y2_ptr,
+        child_array_ptr->count, x, y, start);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the hit test kernel for `simd`. Falls back to the scalar kernel, if
+ * there is none for `simd`. Support by the CPU is not checked.
+ */
+_wlmtk_container_hit_kernel_t _wlmtk_container_hit_kernel_for(
+    wlmtk_util_simd_t simd)
+{
+    switch (simd) {
+#if defined(WLMTK_UTIL_SIMD_X86)
+    case WLMTK_UTIL_SIMD_AVX2: return _wlmtk_container_hit_avx2;
+    case WLMTK_UTIL_SIMD_SSE2: return _wlmtk_container_hit_sse2;
+#elif defined(WLMTK_UTIL_SIMD_NEON)
+    case WLMTK_UTIL_SIMD_AARCH64_NEON: return _wlmtk_container_hit_neon;
+#endif
+    default: return _wlmtk_container_hit_scalar;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Scalar hit test kernel. Also handles the tails for the vector kernels. */
+size_t _wlmtk_container_hit_scalar(
+    const int32_t *x1_ptr, const int32_t *y1_ptr,
+    const int32_t *x2_ptr, const int32_t *y2_ptr,
+    size_t count, int32_t x, int32_t y, size_t start)
+{
+    for (size_t i = start; i < count; ++i) {
+        if (x1_ptr[i] <= x && x < x2_ptr[i] &&
+            y1_ptr[i] <= y && y < y2_ptr[i]) return i;
+    }
+    return count;
+}
+
+#if defined(WLMTK_UTIL_SIMD_X86)
+/* ------------------------------------------------------------------------- */
+/** SSE2 hit test kernel: Tests 4 rectangles at a time. */
+__attribute__((target("sse2")))
+size_t _wlmtk_container_hit_sse2(
+    const int32_t *x1_ptr, const int32_t *y1_ptr,
+    const int32_t *x2_ptr, const int32_t *y2_ptr,
+    size_t count, int32_t x, int32_t y, size_t start)
+{
+    const __m128i vx = _mm_set1_epi32(x);
+    const __m128i vy = _mm_set1_epi32(y);
+    size_t i = start;
+    for (; i + 4 <= count; i += 4) {
+        // Inside, if neither `x1 > x` nor `y1 > y`, and both `x2 > x` and
+        // `y2 > y`.
+        __m128i outside = _mm_or_si128(
+            _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i*)&x1_ptr[i]), vx),
+            _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i*)&y1_ptr[i]), vy));
+        __m128i inside = _mm_and_si128(
+            _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i*)&x2_ptr[i]), vx),
+            _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i*)&y2_ptr[i]), vy));
+        int mask = _mm_movemask_ps(
+            _mm_castsi128_ps(_mm_andnot_si128(outside, inside)));
+        if (0 != mask) return i + __builtin_ctz(mask);
+    }
+    return _wlmtk_container_hit_scalar(
+        x1_ptr, y1_ptr, x2_ptr, y2_ptr, count, x, y, i);
+}
+
+/* ------------------------------------------------------------------------- */
+/** AVX2 hit test kernel: Tests 8 rectangles at a time. */
+__attribute__((target("avx2")))
+size_t _wlmtk_container_hit_avx2(
+    const int32_t *x1_ptr, const int32_t *y1_ptr,
+    const int32_t *x2_ptr, const int32_t *y2_ptr,
+    size_t count, int32_t x, int32_t y, size_t start)
+{
+    const __m256i vx = _mm256_set1_epi32(x);
+    const __m256i vy = _mm256_set1_epi32(y);
+    size_t i = start;
+    for (; i + 8 <= count; i += 8) {
+        __m256i outside = _mm256_or_si256(
+            _mm256_cmpgt_epi32(
+                _mm256_loadu_si256((const __m256i*)&x1_ptr[i]), vx),
+            _mm256_cmpgt_epi32(
+                _mm256_loadu_si256((const __m256i*)&y1_ptr[i]), vy));
+        __m256i inside = _mm256_and_si256(
+            _mm256_cmpgt_epi32(
+                _mm256_loadu_si256((const __m256i*)&x2_ptr[i]), vx),
+            _mm256_cmpgt_epi32(
+                _mm256_loadu_si256((const __m256i*)&y2_ptr[i]), vy));
+        int mask = _mm256_movemask_ps(
+            _mm256_castsi256_ps(_mm256_andnot_si256(outside, inside)));
+        if (0 != mask) return i + __builtin_ctz(mask);
+    }
+    return _wlmtk_container_hit_sse2(
+        x1_ptr, y1_ptr, x2_ptr, y2_ptr, count, x, y, i);
+}
+
+#elif defined(WLMTK_UTIL_SIMD_NEON)
+/* ------------------------------------------------------------------------- */
+/** NEON hit test kernel: Tests 4 rectangles at a time. */
+size_t _wlmtk_container_hit_neon(
+    const int32_t *x1_ptr, const int32_t *y1_ptr,
+    const int32_t *x2_ptr, const int32_t *y2_ptr,
+    size_t count, int32_t x, int32_t y, size_t start)
+{
+    const int32x4_t vx = vdupq_n_s32(x);
+    const int32x4_t vy = vdupq_n_s32(y);
+    size_t i = start;
+    for (; i + 4 <= count; i += 4) {
+        uint32x4_t inside = vandq_u32(
+            vandq_u32(vcleq_s32(vld1q_s32(&x1_ptr[i]), vx),
+                      vcgtq_s32(vld1q_s32(&x2_ptr[i]), vx)),
+            vandq_u32(vcleq_s32(vld1q_s32(&y1_ptr[i]), vy),
+                      vcgtq_s32(vld1q_s32(&y2_ptr[i]), vy)));
+        if (0 != vmaxvq_u32(inside)) {
+            return _wlmtk_container_hit_scalar(
+                x1_ptr, y1_ptr, x2_ptr, y2_ptr, i + 4, x, y, i);
+        }
+    }
+    return _wlmtk_container_hit_scalar(
+        x1_ptr, y1_ptr, x2_ptr, y2_ptr, count, x, y, i);
+}
+#endif
+
+/* ------------------------------------------------------------------------- */
+/** Returns the number of ancestors of `container_ptr`. */
+int _wlmtk_container_depth(wlmtk_container_t *container_ptr)
+{
+    int depth = 0;
+    wlmtk_container_t *c_ptr = container_ptr->super_element.parent_container_ptr;
+    for (; c_ptr != NULL; c_ptr = c_ptr->super_element.parent_container_ptr) {
+        ++depth;
+    }
+    return depth;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Runs the pending layout update of `container_ptr`, taken off the queue. */
+void _wlmtk_container_run_layout(wlmtk_container_t *container_ptr)
+{
+    container_ptr->layout_list_ptr = NULL;
+    container_ptr->layout_pending = false;
+    container_ptr->vmt.update_layout(container_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Idle callback of the event loop: Flushes deferred layout updates. */
+void _wlmtk_container_handle_layout_idle(__UNUSED__ void *data_ptr)
+{
+    _wlmtk_container_layout_idle_ptr = NULL;
+    wlmtk_container_flush_layout();
+}
+
+/* == Helper for unit tests: A fake container with a tree, as parent ======= */
+
+/** State of the "fake" parent container. Refers to a scene graph. */
+typedef struct {
+    /** The actual container */
+    wlmtk_container_t         container;
+    /** A scene graph. Not attached to any output, */
+    struct wlr_scene          *wlr_scene_ptr;
+} fake_parent_container_t;
+
+/* ------------------------------------------------------------------------- */
+wlmtk_container_t *wlmtk_container_create_fake_parent(void)
+{
+    fake_parent_container_t *fake_parent_container_ptr = logged_calloc(
+        1, sizeof(fake_parent_container_t));
+    if (NULL == fake_parent_container_ptr) return NULL;
 
     fake_parent_container_ptr->wlr_scene_ptr = wlr_scene_create();
     if (NULL == fake_parent_container_ptr->wlr_scene_ptr) {
@@ -913,12 +2158,54 @@ void wlmtk_container_destroy_fake_parent(wlmtk_container_t *container_ptr)
     free(fake_parent_container_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Unlinks `element_ptr` from the container's elements, and clears the
+ * container's focus and grabs on it. Leaves the element's parent pointer, so
+ * the caller decides over the scene node.
+ *
+ * @param container_ptr
+ * @param element_ptr
+ */
+void _wlmtk_container_unlink_element(
+    wlmtk_container_t *container_ptr,
+    wlmtk_element_t *element_ptr)
+{
+    bs_dllist_remove(
+        &container_ptr->elements,
+        wlmtk_dlnode_from_element(element_ptr));
+    wlmtk_container_invalidate_spatial_index(container_ptr);
+
+    if (container_ptr->pointer_grab_element_ptr == element_ptr) {
+
+        _wlmtk_container_element_pointer_grab_cancel(
+            &container_ptr->super_element);
+        if (NULL != container_ptr->super_element.parent_container_ptr) {
+            wlmtk_container_pointer_grab_release(
+                container_ptr->super_element.parent_container_ptr,
+                &container_ptr->super_element);
+        }
+    }
+    if (container_ptr->left_button_element_ptr == element_ptr) {
+        container_ptr->left_button_element_ptr = NULL;
+    }
+    if (container_ptr->keyboard_focus_element_ptr == element_ptr) {
+        wlmtk_container_set_keyboard_focus_element(container_ptr, NULL);
+    }
+
+    wlmtk_container_update_layout(container_ptr);
+    wlmtk_container_update_pointer_focus(container_ptr);
+    BS_ASSERT(element_ptr != container_ptr->pointer_focus_element_ptr);
+    BS_ASSERT(element_ptr != container_ptr->keyboard_focus_element_ptr);
+}
+
 /* == Unit tests =========================================================== */
 
 static void test_init_fini(bs_test_t *test_ptr);
 static void test_add_remove(bs_test_t *test_ptr);
 static void test_add_remove_with_scene_graph(bs_test_t *test_ptr);
 static void test_add_with_raise(bs_test_t *test_ptr);
+static void test_move(bs_test_t *test_ptr);
 static void test_pointer_motion(bs_test_t *test_ptr);
 static void test_pointer_focus(bs_test_t *test_ptr);
 static void test_pointer_focus_move(bs_test_t *test_ptr);
@@ -929,12 +2216,26 @@ static void test_pointer_grab(bs_test_t *test_ptr);
 static void test_pointer_grab_events(bs_test_t *test_ptr);
 static void test_keyboard_event(bs_test_t *test_ptr);
 static void test_keyboard_focus(bs_test_t *test_ptr);
+static void test_keyboard_focus_leaf(bs_test_t *test_ptr);
+static void test_keyboard_focus_switch(bs_test_t *test_ptr);
+static void test_spatial_index(bs_test_t *test_ptr);
+static void test_extents_cache(bs_test_t *test_ptr);
+static void test_deferred_layout(bs_test_t *test_ptr);
+static void test_deferred_layout_nested(bs_test_t *test_ptr);
+static void test_pointer_focus_cached(bs_test_t *test_ptr);
+static void test_child_array(bs_test_t *test_ptr);
+static void test_uniform_stack(bs_test_t *test_ptr);
+static void test_hit_kernels(bs_test_t *test_ptr);
+static void test_raise_incremental(bs_test_t *test_ptr);
+static void test_translate(bs_test_t *test_ptr);
+static void test_input_transparent(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_container_test_cases[] = {
     { 1, "init_fini", test_init_fini },
     { 1, "add_remove", test_add_remove },
     { 1, "add_remove_with_scene_graph", test_add_remove_with_scene_graph },
     { 1, "add_with_raise", test_add_with_raise },
+    { 1, "move", test_move },
     { 1, "pointer_motion", test_pointer_motion },
     { 1, "pointer_focus", test_pointer_focus },
     { 1, "pointer_focus_move", test_pointer_focus_move },
@@ -945,6 +2246,19 @@ const bs_test_case_t wlmtk_container_test_cases[] = {
     { 1, "pointer_grab_events", test_pointer_grab_events },
     { 1, "keyboard_event", test_keyboard_event },
     { 1, "keyboard_focus", test_keyboard_focus },
+    { 1, "keyboard_focus_leaf", test_keyboard_focus_leaf },
+    { 1, "keyboard_focus_switch", test_keyboard_focus_switch },
+    { 1, "spatial_index", test_spatial_index },
+    { 1, "extents_cache", test_extents_cache },
+    { 1, "deferred_layout", test_deferred_layout },
+    { 1, "deferred_layout_nested", test_deferred_layout_nested },
+    { 1, "pointer_focus_cached", test_pointer_focus_cached },
+    { 1, "child_array", test_child_array },
+    { 1, "uniform_stack", test_uniform_stack },
+    { 1, "hit_kernels", test_hit_kernels },
+    { 1, "raise_incremental", test_raise_incremental },
+    { 1, "translate", test_translate },
+    { 1, "input_transparent", test_input_transparent },
     { 0, NULL, NULL }
 };
 
@@ -957,6 +2271,9 @@ void test_init_fini(bs_test_t *test_ptr)
     // Also expect the super element to be initialized.
     BS_TEST_VERIFY_NEQ(
         test_ptr, NULL, container.super_element.vmt.pointer_motion);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &container,
+        wlmtk_container_from_element(&container.super_element));
 
     wlmtk_container_fini(&container);
     // Also expect the super element to be un-initialized.
@@ -964,6 +2281,53 @@ void test_init_fini(bs_test_t *test_ptr)
         test_ptr, NULL, container.super_element.vmt.pointer_motion);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests that keyboard events go to the cached leaf, and follow focus. */
+void test_keyboard_focus_leaf(bs_test_t *test_ptr)
+{
+    wlmtk_container_t c, p;
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, wlmtk_container_init(&c));
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, wlmtk_container_init(&p));
+    wlmtk_container_add_element(&p, &c.super_element);
+    wlmtk_fake_element_t *fe1_ptr = wlmtk_fake_element_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fe1_ptr);
+    wlmtk_container_add_element(&c, &fe1_ptr->element);
+    wlmtk_fake_element_t *fe2_ptr = wlmtk_fake_element_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fe2_ptr);
+    wlmtk_container_add_element(&c, &fe2_ptr->element);
+    struct wlr_keyboard_key_event event = {};
+
+    // The leaf skips the intermediate container.
+    wlmtk_fake_element_grab_keyboard(fe1_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_element_keyboard_event(&p.super_element, &event, NULL, 0, 0));
+    BS_TEST_VERIFY_TRUE(test_ptr, fe1_ptr->keyboard_event_called);
+    BS_TEST_VERIFY_EQ(test_ptr, &fe1_ptr->element, p.keyboard_focus_leaf_ptr);
+
+    // A focus change invalidates the cached leaf.
+    fe1_ptr->keyboard_event_called = false;
+    wlmtk_fake_element_grab_keyboard(fe2_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_element_keyboard_event(&p.super_element, &event, NULL, 0, 0));
+    BS_TEST_VERIFY_FALSE(test_ptr, fe1_ptr->keyboard_event_called);
+    BS_TEST_VERIFY_TRUE(test_ptr, fe2_ptr->keyboard_event_called);
+
+    // So does removing the focussed element.
+    wlmtk_container_remove_element(&c, &fe2_ptr->element);
+    wlmtk_element_destroy(&fe2_ptr->element);
+    BS_TEST_VERIFY_FALSE(
+        test_ptr,
+        wlmtk_element_keyboard_event(&p.super_element, &event, NULL, 0, 0));
+
+    wlmtk_container_remove_element(&c, &fe1_ptr->element);
+    wlmtk_element_destroy(&fe1_ptr->element);
+    wlmtk_container_remove_element(&p, &c.super_element);
+    wlmtk_container_fini(&c);
+    wlmtk_container_fini(&p);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Exercises adding and removing elements, verifies destruction on fini. */
 void test_add_remove(bs_test_t *test_ptr)
@@ -1125,6 +2489,55 @@ void test_add_remove_with_scene_graph(bs_test_t *test_ptr)
     wlmtk_container_destroy_fake_parent(fake_parent_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Moving an element between containers keeps its scene node. */
+void test_move(bs_test_t *test_ptr)
+{
+    wlmtk_container_t *fake_parent_ptr = wlmtk_container_create_fake_parent();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fake_parent_ptr);
+    wlmtk_container_t c1, c2, detached;
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_container_init(&c1));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_container_init(&c2));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_container_init(&detached));
+    wlmtk_container_add_element(fake_parent_ptr, &c1.super_element);
+    wlmtk_container_add_element(fake_parent_ptr, &c2.super_element);
+
+    wlmtk_fake_element_t *fe1_ptr = wlmtk_fake_element_create();
+    wlmtk_container_add_element(&c2, &fe1_ptr->element);
+    wlmtk_fake_element_t *fe2_ptr = wlmtk_fake_element_create();
+    wlmtk_container_add_element(&c1, &fe2_ptr->element);
+    struct wlr_scene_node *node_ptr = fe2_ptr->element.wlr_scene_node_ptr;
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, node_ptr);
+
+    // Same node, now in c2's tree. And atop of fe1.
+    wlmtk_container_move_element(&c2, &fe2_ptr->element);
+    BS_TEST_VERIFY_EQ(test_ptr, &c2, fe2_ptr->element.parent_container_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, node_ptr, fe2_ptr->element.wlr_scene_node_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, c2.wlr_scene_tree_ptr, node_ptr->parent);
+    BS_TEST_VERIFY_TRUE(test_ptr, bs_dllist_empty(&c1.elements));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &fe2_ptr->element.dlnode, c2.elements.head_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &node_ptr->link, c2.wlr_scene_tree_ptr->children.prev);
+
+    // Into a container without scene graph: Drops the node.
+    wlmtk_container_move_element(&detached, &fe2_ptr->element);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, fe2_ptr->element.wlr_scene_node_ptr);
+    wlmtk_container_move_element(&c1, &fe2_ptr->element);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, fe2_ptr->element.wlr_scene_node_ptr);
+
+    wlmtk_container_remove_element(&c1, &fe2_ptr->element);
+    wlmtk_element_destroy(&fe2_ptr->element);
+    wlmtk_container_remove_element(&c2, &fe1_ptr->element);
+    wlmtk_element_destroy(&fe1_ptr->element);
+    wlmtk_container_remove_element(fake_parent_ptr, &c2.super_element);
+    wlmtk_container_remove_element(fake_parent_ptr, &c1.super_element);
+    wlmtk_container_fini(&detached);
+    wlmtk_container_fini(&c2);
+    wlmtk_container_fini(&c1);
+    wlmtk_container_destroy_fake_parent(fake_parent_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Tests that elements inserted at position are also placed in scene graph. */
 void test_add_with_raise(bs_test_t *test_ptr)
@@ -1987,4 +3400,717 @@ void test_keyboard_focus(bs_test_t *test_ptr)
     wlmtk_container_fini(&p);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests that pointer focus is kept when using the spatial index. */
+void test_spatial_index(bs_test_t *test_ptr)
+{
+    wlmtk_container_t c;
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, wlmtk_container_init(&c));
+    wlmtk_container_set_spatial_index(&c, 16);
+
+    // Note: pointer area extends by (-1, -2, 3, 4) on each fake element.
+    wlmtk_fake_element_t *fe1_ptr = wlmtk_fake_element_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fe1_ptr);
+    fe1_ptr->dimensions.width = 100;
+    fe1_ptr->dimensions.height = 100;
+    wlmtk_element_set_visible(&fe1_ptr->element, true);
+    wlmtk_container_add_element(&c, &fe1_ptr->element);
+
+    wlmtk_fake_element_t *fe2_ptr = wlmtk_fake_element_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fe2_ptr);
+    fe2_ptr->dimensions.width = 10;
+    fe2_ptr->dimensions.height = 10;
+    wlmtk_element_set_position(&fe2_ptr->element, 50, 50);
+    wlmtk_element_set_visible(&fe2_ptr->element, true);
+    wlmtk_container_add_element(&c, &fe2_ptr->element);
+
+    // (20, 20) is only covered by fe1.
+    wlmtk_pointer_motion_event_t e = { .x = 20, .y = 20 };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    BS_TEST_VERIFY_EQ(test_ptr, &fe1_ptr->element, c.pointer_focus_element_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, c.spatial_index.dirty);
+    BS_TEST_VERIFY_NEQ(test_ptr, 0, c.spatial_index.columns);
+
+    // (55, 55) is covered by both. fe2 is on top.
+    e = (wlmtk_pointer_motion_event_t){ .x = 55, .y = 55 };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    BS_TEST_VERIFY_EQ(test_ptr, &fe2_ptr->element, c.pointer_focus_element_ptr);
+
+    // Raise fe1: Takes precedence now.
+    wlmtk_container_raise_element_to_top(&c, &fe1_ptr->element);
+    BS_TEST_VERIFY_EQ(test_ptr, &fe1_ptr->element, c.pointer_focus_element_ptr);
+
+    // Move fe2 outside of fe1. The index must follow.
+    wlmtk_element_set_position(&fe2_ptr->element, 200, 200);
+    e = (wlmtk_pointer_motion_event_t){ .x = 205, .y = 205 };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    BS_TEST_VERIFY_EQ(test_ptr, &fe2_ptr->element, c.pointer_focus_element_ptr);
+
+    // Far away: Cells grow, so the grid remains bounded.
+    wlmtk_element_set_position(&fe2_ptr->element, 10000, 10000);
+    e = (wlmtk_pointer_motion_event_t){ .x = 10005, .y = 10005 };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    BS_TEST_VERIFY_EQ(test_ptr, &fe2_ptr->element, c.pointer_focus_element_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, 64 >= c.spatial_index.columns);
+    BS_TEST_VERIFY_TRUE(test_ptr, 64 >= c.spatial_index.rows);
+
+    // Invisible elements are not found.
+    wlmtk_element_set_visible(&fe2_ptr->element, false);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, c.pointer_focus_element_ptr);
+
+    // Outside of the grid.
+    e = (wlmtk_pointer_motion_event_t){ .x = -50, .y = -50 };
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+
+    // Disabling the index releases the resources, and keeps working.
+    wlmtk_container_set_spatial_index(&c, 0);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, c.spatial_index.entries_ptr);
+    e = (wlmtk_pointer_motion_event_t){ .x = 20, .y = 20 };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    BS_TEST_VERIFY_EQ(test_ptr, &fe1_ptr->element, c.pointer_focus_element_ptr);
+
+    // Will destroy contained elements.
+    wlmtk_container_fini(&c);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies dimensions are cached, and invalidated on changes. */
+void test_extents_cache(bs_test_t *test_ptr)
+{
+    wlmtk_container_t parent, child;
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, wlmtk_container_init(&parent));
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, wlmtk_container_init(&child));
+    wlmtk_element_set_visible(&child.super_element, true);
+    wlmtk_container_add_element(&parent, &child.super_element);
+
+    wlmtk_fake_element_t *fe_ptr = wlmtk_fake_element_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fe_ptr);
+    fe_ptr->dimensions.width = 10;
+    fe_ptr->dimensions.height = 20;
+    wlmtk_element_set_visible(&fe_ptr->element, true);
+    wlmtk_container_add_element(&child, &fe_ptr->element);
+
+    struct wlr_box box = wlmtk_element_get_dimensions_box(
+        &parent.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, box.width);
+    BS_TEST_VERIFY_TRUE(test_ptr, parent.super_element.dimensions_cache.valid);
+    BS_TEST_VERIFY_TRUE(test_ptr, child.super_element.dimensions_cache.valid);
+
+    // Changes not notified are not reflected...
+    fe_ptr->dimensions.width = 30;
+    box = wlmtk_element_get_dimensions_box(&parent.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, box.width);
+
+    // ... until invalidated. Must propagate to the parent.
+    wlmtk_element_invalidate_extents(&fe_ptr->element);
+    BS_TEST_VERIFY_FALSE(test_ptr, parent.super_element.dimensions_cache.valid);
+    box = wlmtk_element_get_dimensions_box(&parent.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 30, box.width);
+
+    // Moving the element invalidates, too.
+    wlmtk_element_set_position(&fe_ptr->element, 5, 7);
+    box = wlmtk_element_get_dimensions_box(&parent.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 5, box.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 7, box.y);
+
+    // And so does hiding it.
+    wlmtk_element_set_visible(&fe_ptr->element, false);
+    box = wlmtk_element_get_dimensions_box(&parent.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, box.width);
+
+    wlmtk_container_remove_element(&child, &fe_ptr->element);
+    wlmtk_element_destroy(&fe_ptr->element);
+    wlmtk_container_remove_element(&parent, &child.super_element);
+    wlmtk_container_fini(&child);
+    wlmtk_container_fini(&parent);
+}
+
+/* ------------------------------------------------------------------------- */
+/** A container that records calls to update_layout. */
+typedef struct {
+    /** Superclass. */
+    wlmtk_container_t         container;
+    /** Original virtual method table. */
+    wlmtk_container_vmt_t     orig_vmt;
+    /** Number of calls to update_layout. */
+    int                       calls;
+    /** Sequence number of the last call to update_layout. */
+    int                       sequence;
+} test_layout_container_t;
+
+/** Sequence counter for @ref test_layout_container_t::sequence. */
+static int test_layout_sequence;
+
+/** Records the call, and forwards to the original update_layout. */
+static void test_layout_container_update_layout(
+    wlmtk_container_t *container_ptr)
+{
+    test_layout_container_t *tlc_ptr = BS_CONTAINER_OF(
+        container_ptr, test_layout_container_t, container);
+    tlc_ptr->calls++;
+    tlc_ptr->sequence = ++test_layout_sequence;
+    tlc_ptr->orig_vmt.update_layout(container_ptr);
+}
+
+/** Virtual method table for @ref test_layout_container_t. */
+static const wlmtk_container_vmt_t test_layout_container_vmt = {
+    .update_layout = test_layout_container_update_layout,
+};
+
+/* ------------------------------------------------------------------------- */
+/** Verifies deferred layout updates are coalesced, and run children-first. */
+void test_deferred_layout(bs_test_t *test_ptr)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    test_layout_container_t parent = {}, child = {};
+    BS_TEST_VERIFY_TRUE_OR_RETURN(
+        test_ptr, wlmtk_container_init(&parent.container));
+    parent.orig_vmt = wlmtk_container_extend(
+        &parent.container, &test_layout_container_vmt);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(
+        test_ptr, wlmtk_container_init(&child.container));
+    child.orig_vmt = wlmtk_container_extend(
+        &child.container, &test_layout_container_vmt);
+    wlmtk_container_add_element(
+        &parent.container, &child.container.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, parent.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, child.calls);
+
+    wlmtk_container_defer_layout(wl_event_loop_ptr);
+    wlmtk_container_update_layout(&parent.container);
+    wlmtk_container_update_layout(&child.container);
+    wlmtk_container_update_layout(&child.container);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, parent.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, child.calls);
+    BS_TEST_VERIFY_TRUE(test_ptr, child.container.layout_pending);
+
+    // The idle callback flushes: Each once, child before the parent.
+    wl_event_loop_dispatch_idle(wl_event_loop_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, parent.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, child.calls);
+    BS_TEST_VERIFY_TRUE(test_ptr, child.sequence < parent.sequence);
+    BS_TEST_VERIFY_FALSE(test_ptr, parent.container.layout_pending);
+
+    // Disabling flushes all that is pending.
+    wlmtk_container_update_layout(&child.container);
+    wlmtk_container_defer_layout(NULL);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, parent.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, child.calls);
+
+    wlmtk_container_remove_element(
+        &parent.container, &child.container.super_element);
+    wlmtk_container_fini(&child.container);
+    wlmtk_container_fini(&parent.container);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Verifies a deferred flush across nested containers: Enqueued in arbitrary
+ * order, each runs once and after all of its pending descendants.
+ */
+void test_deferred_layout_nested(bs_test_t *test_ptr)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+
+    // c[0] is the root, c[1] to c[3] a chain below. c[4] is beside c[1].
+    test_layout_container_t c[5] = {};
+    for (size_t i = 0; i < 5; ++i) {
+        BS_TEST_VERIFY_TRUE_OR_RETURN(
+            test_ptr, wlmtk_container_init(&c[i].container));
+        c[i].orig_vmt = wlmtk_container_extend(
+            &c[i].container, &test_layout_container_vmt);
+    }
+    wlmtk_container_add_element(
+        &c[0].container, &c[1].container.super_element);
+    wlmtk_container_add_element(
+        &c[1].container, &c[2].container.super_element);
+    wlmtk_container_add_element(
+        &c[2].container, &c[3].container.super_element);
+    wlmtk_container_add_element(
+        &c[0].container, &c[4].container.super_element);
+    for (size_t i = 0; i < 5; ++i) c[i].calls = 0;
+
+    wlmtk_container_defer_layout(wl_event_loop_ptr);
+    wlmtk_container_update_layout(&c[0].container);
+    wlmtk_container_update_layout(&c[2].container);
+    wlmtk_container_update_layout(&c[4].container);
+    wlmtk_container_update_layout(&c[3].container);
+    wlmtk_container_update_layout(&c[1].container);
+    wlmtk_container_update_layout(&c[3].container);
+    wlmtk_container_flush_layout();
+
+    for (size_t i = 0; i < 5; ++i) {
+        BS_TEST_VERIFY_EQ(test_ptr, 1, c[i].calls);
+        BS_TEST_VERIFY_FALSE(test_ptr, c[i].container.layout_pending);
+    }
+    BS_TEST_VERIFY_TRUE(test_ptr, c[3].sequence < c[2].sequence);
+    BS_TEST_VERIFY_TRUE(test_ptr, c[2].sequence < c[1].sequence);
+    BS_TEST_VERIFY_TRUE(test_ptr, c[1].sequence < c[0].sequence);
+    BS_TEST_VERIFY_TRUE(test_ptr, c[4].sequence < c[0].sequence);
+
+    // Only the deepest is pending: Propagates up, once per ancestor.
+    wlmtk_container_update_layout(&c[3].container);
+    wlmtk_container_flush_layout();
+    BS_TEST_VERIFY_EQ(test_ptr, 2, c[0].calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, c[1].calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, c[3].calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, c[4].calls);
+
+    // A destroyed container leaves the queue.
+    wlmtk_container_update_layout(&c[4].container);
+    wlmtk_container_remove_element(
+        &c[0].container, &c[4].container.super_element);
+    wlmtk_container_fini(&c[4].container);
+    wlmtk_container_defer_layout(NULL);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, c[4].calls);
+
+    for (size_t i = 3; i > 0; --i) {
+        wlmtk_container_remove_element(
+            &c[i - 1].container, &c[i].container.super_element);
+        wlmtk_container_fini(&c[i].container);
+    }
+    wlmtk_container_fini(&c[0].container);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies the pointer focus fast path is dropped when things change. */
+void test_pointer_focus_cached(bs_test_t *test_ptr)
+{
+    wlmtk_container_t c;
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, wlmtk_container_init(&c));
+
+    // Note: pointer area extends by (-1, -2, 3, 4) on each fake element.
+    wlmtk_fake_element_t *fe1_ptr = wlmtk_fake_element_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fe1_ptr);
+    fe1_ptr->dimensions.width = 10;
+    fe1_ptr->dimensions.height = 10;
+    wlmtk_element_set_visible(&fe1_ptr->element, true);
+    wlmtk_container_add_element(&c, &fe1_ptr->element);
+
+    wlmtk_fake_element_t *fe2_ptr = wlmtk_fake_element_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fe2_ptr);
+    fe2_ptr->dimensions.width = 4;
+    fe2_ptr->dimensions.height = 10;
+    wlmtk_element_set_position(&fe2_ptr->element, 0, -20);
+    wlmtk_element_set_visible(&fe2_ptr->element, true);
+    wlmtk_container_add_element(&c, &fe2_ptr->element);
+
+    wlmtk_pointer_motion_event_t e = { .x = 5, .y = 5 };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    BS_TEST_VERIFY_EQ(test_ptr, &fe1_ptr->element, c.pointer_focus_element_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, c.pointer_focus_unobstructed);
+
+    // Moving within the element: Keeps focus, receives the motion.
+    fe1_ptr->pointer_motion_called = false;
+    e = (wlmtk_pointer_motion_event_t){ .x = 6, .y = 7 };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    BS_TEST_VERIFY_EQ(test_ptr, &fe1_ptr->element, c.pointer_focus_element_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, fe1_ptr->pointer_motion_called);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 6, fe1_ptr->element.last_pointer_motion_event.x);
+
+    // fe2 grows to cover fe1, without a layout update. Must take focus.
+    fe2_ptr->dimensions.height = 30;
+    wlmtk_element_invalidate_extents(&fe2_ptr->element);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    BS_TEST_VERIFY_EQ(test_ptr, &fe2_ptr->element, c.pointer_focus_element_ptr);
+
+    // Outside fe2, only on fe1: fe1 has focus, but is obstructed.
+    e = (wlmtk_pointer_motion_event_t){ .x = 10, .y = 7 };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    BS_TEST_VERIFY_EQ(test_ptr, &fe1_ptr->element, c.pointer_focus_element_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, c.pointer_focus_unobstructed);
+    e = (wlmtk_pointer_motion_event_t){ .x = 6, .y = 7 };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    BS_TEST_VERIFY_EQ(test_ptr, &fe2_ptr->element, c.pointer_focus_element_ptr);
+
+    // Raising fe1 on top: fe1 takes focus, and is no longer obstructed.
+    wlmtk_container_raise_element_to_top(&c, &fe1_ptr->element);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    BS_TEST_VERIFY_EQ(test_ptr, &fe1_ptr->element, c.pointer_focus_element_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, c.pointer_focus_unobstructed);
+
+    wlmtk_container_remove_element(&c, &fe2_ptr->element);
+    wlmtk_element_destroy(&fe2_ptr->element);
+    wlmtk_container_remove_element(&c, &fe1_ptr->element);
+    wlmtk_element_destroy(&fe1_ptr->element);
+    wlmtk_container_fini(&c);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Exercises the contiguous child array: Hit tests and pointer area. */
+void test_child_array(bs_test_t *test_ptr)
+{
+    wlmtk_container_t c;
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, wlmtk_container_init(&c));
+    wlmtk_container_set_child_array(&c, true);
+
+    // Note: pointer area extends by (-1, -2, 3, 4) on each fake element.
+    wlmtk_fake_element_t *fe_ptrs[3];
+    for (int i = 0; i < 3; ++i) {
+        fe_ptrs[i] = wlmtk_fake_element_create();
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fe_ptrs[i]);
+        fe_ptrs[i]->dimensions.width = 10;
+        fe_ptrs[i]->dimensions.height = 10;
+        wlmtk_element_set_position(&fe_ptrs[i]->element, 20 * i, 0);
+        wlmtk_element_set_visible(&fe_ptrs[i]->element, i != 2);
+        wlmtk_container_add_element(&c, &fe_ptrs[i]->element);
+    }
+
+    int x1, y1, x2, y2;
+    wlmtk_element_get_pointer_area(&c.super_element, &x1, &y1, &x2, &y2);
+    BS_TEST_VERIFY_TRUE(test_ptr, c.child_array.valid);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, c.child_array.count);
+    BS_TEST_VERIFY_EQ(test_ptr, -1, x1);
+    BS_TEST_VERIFY_EQ(test_ptr, -2, y1);
+    BS_TEST_VERIFY_EQ(test_ptr, 33, x2);
+    BS_TEST_VERIFY_EQ(test_ptr, 14, y2);
+
+    wlmtk_pointer_motion_event_t e = { .x = 25, .y = 5 };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &fe_ptrs[1]->element, c.pointer_focus_element_ptr);
+
+    // Invisible elements are not hit. Making it visible rebuilds the array.
+    e = (wlmtk_pointer_motion_event_t){ .x = 45, .y = 5 };
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    wlmtk_element_set_visible(&fe_ptrs[2]->element, true);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &fe_ptrs[2]->element, c.pointer_focus_element_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, c.child_array.count);
+
+    // Overlap: The topmost one wins. Then, raise the other one.
+    wlmtk_element_set_position(&fe_ptrs[0]->element, 15, 0);
+    e = (wlmtk_pointer_motion_event_t){ .x = 22, .y = 5 };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &fe_ptrs[1]->element, c.pointer_focus_element_ptr);
+    wlmtk_container_raise_element_to_top(&c, &fe_ptrs[0]->element);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &fe_ptrs[0]->element, c.pointer_focus_element_ptr);
+
+    // NAN and far-away coordinates are handled gracefully.
+    e = (wlmtk_pointer_motion_event_t){ .x = NAN, .y = 5 };
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    e = (wlmtk_pointer_motion_event_t){ .x = 1e20, .y = 5 };
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+
+    wlmtk_container_set_child_array(&c, false);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, c.child_array.elements_ptr);
+
+    for (int i = 0; i < 3; ++i) {
+        wlmtk_container_remove_element(&c, &fe_ptrs[i]->element);
+        wlmtk_element_destroy(&fe_ptrs[i]->element);
+    }
+    wlmtk_container_fini(&c);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies hit tests on a uniform stack compute the element's index. */
+void test_uniform_stack(bs_test_t *test_ptr)
+{
+    wlmtk_container_t c;
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, wlmtk_container_init(&c));
+    wlmtk_container_set_child_array(&c, true);
+
+    // Pointer areas span 16 pixels vertically, at a stride of 20.
+    wlmtk_fake_element_t *fe_ptrs[4];
+    for (int i = 0; i < 4; ++i) {
+        fe_ptrs[i] = wlmtk_fake_element_create();
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fe_ptrs[i]);
+        fe_ptrs[i]->dimensions.width = 10;
+        fe_ptrs[i]->dimensions.height = 10;
+        wlmtk_element_set_position(&fe_ptrs[i]->element, 0, 20 * (3 - i));
+        wlmtk_element_set_visible(&fe_ptrs[i]->element, true);
+        wlmtk_container_add_element(&c, &fe_ptrs[i]->element);
+    }
+
+    wlmtk_pointer_motion_event_t e = { .x = 5, .y = 45 };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &fe_ptrs[1]->element, c.pointer_focus_element_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 20, c.child_array.stride);
+    BS_TEST_VERIFY_TRUE(test_ptr, c.child_array.stride_vertical);
+
+    // Between the areas, left of them, and above them: No hit.
+    e = (wlmtk_pointer_motion_event_t){ .x = 5, .y = 35 };
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    e = (wlmtk_pointer_motion_event_t){ .x = -5, .y = 45 };
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    e = (wlmtk_pointer_motion_event_t){ .x = 5, .y = -5 };
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    e = (wlmtk_pointer_motion_event_t){ .x = 5, .y = 65 };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &fe_ptrs[0]->element, c.pointer_focus_element_ptr);
+
+    // Moving one element breaks the stack. Hit tests then search.
+    wlmtk_element_set_position(&fe_ptrs[2]->element, 0, 21);
+    e = (wlmtk_pointer_motion_event_t){ .x = 5, .y = 30 };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c.super_element, &e));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &fe_ptrs[2]->element, c.pointer_focus_element_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, c.child_array.stride);
+
+    for (int i = 0; i < 4; ++i) {
+        wlmtk_container_remove_element(&c, &fe_ptrs[i]->element);
+        wlmtk_element_destroy(&fe_ptrs[i]->element);
+    }
+    wlmtk_container_fini(&c);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies each hit test kernel supported by the CPU matches scalar. */
+void test_hit_kernels(bs_test_t *test_ptr)
+{
+    // 19 rectangles: Covers full vectors of 4 and 8, plus a tail.
+    int32_t x1[19], y1[19], x2[19], y2[19];
+    for (int i = 0; i < 19; ++i) {
+        x1[i] = (i * 7) % 13 - 3;
+        y1[i] = (i * 5) % 11 - 2;
+        x2[i] = x1[i] + (i % 4) * 3;
+        y2[i] = y1[i] + (i % 3) * 4;
+    }
+
+    for (int simd = 0; simd < WLMTK_UTIL_SIMD_MAX; ++simd) {
+        if (!wlmtk_util_simd_supported(simd)) continue;
+        _wlmtk_container_hit_kernel_t kernel =
+            _wlmtk_container_hit_kernel_for(simd);
+        for (int y = -5; y < 20; ++y) {
+            for (int x = -5; x < 20; ++x) {
+                for (size_t start = 0; start <= 19; start += 3) {
+                    size_t expected = _wlmtk_container_hit_scalar(
+                        x1, y1, x2, y2, 19, x, y, start);
+                    size_t actual = kernel(x1, y1, x2, y2, 19, x, y, start);
+                    BS_TEST_VERIFY_TRUE_OR_RETURN(
+                        test_ptr, expected == actual);
+                }
+            }
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies raising in an order-independent container updates in place. */
+void test_raise_incremental(bs_test_t *test_ptr)
+{
+    test_layout_container_t tlc = {};
+    wlmtk_container_t *c_ptr = &tlc.container;
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, wlmtk_container_init(c_ptr));
+    tlc.orig_vmt = wlmtk_container_extend(c_ptr, &test_layout_container_vmt);
+    wlmtk_container_set_spatial_index(c_ptr, 8);
+    wlmtk_container_set_child_array(c_ptr, true);
+    c_ptr->order_independent_layout = true;
+
+    // Note: pointer area extends by (-1, -2, 3, 4) on each fake element.
+    wlmtk_fake_element_t *fe_ptrs[2];
+    for (int i = 0; i < 2; ++i) {
+        fe_ptrs[i] = wlmtk_fake_element_create();
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fe_ptrs[i]);
+        fe_ptrs[i]->dimensions.width = 10;
+        fe_ptrs[i]->dimensions.height = 10;
+        wlmtk_element_set_position(&fe_ptrs[i]->element, 5 * i, 0);
+        wlmtk_element_set_visible(&fe_ptrs[i]->element, true);
+        wlmtk_container_add_element(c_ptr, &fe_ptrs[i]->element);
+    }
+    int x1, y1, x2, y2;
+    wlmtk_element_get_pointer_area(&c_ptr->super_element, &x1, &y1, &x2, &y2);
+    BS_TEST_VERIFY_TRUE(test_ptr, c_ptr->child_array.valid);
+
+    // Pointer in the overlap: The top element, fe1, has focus.
+    wlmtk_pointer_motion_event_t e = { .x = 7, .y = 5 };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c_ptr->super_element, &e));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &fe_ptrs[1]->element, c_ptr->pointer_focus_element_ptr);
+    int calls = tlc.calls;
+
+    // Raising fe0 moves the focus. No layout, and caches are kept up-to-date.
+    wlmtk_container_raise_element_to_top(c_ptr, &fe_ptrs[0]->element);
+    BS_TEST_VERIFY_EQ(test_ptr, calls, tlc.calls);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &fe_ptrs[0]->element, c_ptr->pointer_focus_element_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, c_ptr->spatial_index.dirty);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, c_ptr->spatial_index.generation,
+        c_ptr->child_array.generation);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &fe_ptrs[0]->element, c_ptr->child_array.elements_ptr[0]);
+    size_t count;
+    wlmtk_element_t **element_ptrs = _wlmtk_container_spatial_index_lookup(
+        &c_ptr->spatial_index, 7, 5, &count);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, 2 == count);
+    BS_TEST_VERIFY_EQ(test_ptr, &fe_ptrs[0]->element, element_ptrs[0]);
+    BS_TEST_VERIFY_EQ(test_ptr, &fe_ptrs[1]->element, element_ptrs[1]);
+
+    // Pointer only on fe0. Raising fe1 keeps focus, but it gets obstructed.
+    e = (wlmtk_pointer_motion_event_t){ .x = 2, .y = 5 };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c_ptr->super_element, &e));
+    BS_TEST_VERIFY_TRUE(test_ptr, c_ptr->pointer_focus_unobstructed);
+    wlmtk_container_raise_element_to_top(c_ptr, &fe_ptrs[1]->element);
+    BS_TEST_VERIFY_EQ(test_ptr, calls, tlc.calls);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &fe_ptrs[0]->element, c_ptr->pointer_focus_element_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, c_ptr->pointer_focus_unobstructed);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &fe_ptrs[1]->element, c_ptr->child_array.elements_ptr[0]);
+
+    for (int i = 0; i < 2; ++i) {
+        wlmtk_container_remove_element(c_ptr, &fe_ptrs[i]->element);
+        wlmtk_element_destroy(&fe_ptrs[i]->element);
+    }
+    wlmtk_container_fini(c_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests @ref wlmtk_container_translate_element keeps caches in place. */
+void test_translate(bs_test_t *test_ptr)
+{
+    test_layout_container_t tlc = {};
+    wlmtk_container_t *c_ptr = &tlc.container;
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, wlmtk_container_init(c_ptr));
+    tlc.orig_vmt = wlmtk_container_extend(c_ptr, &test_layout_container_vmt);
+    wlmtk_container_set_spatial_index(c_ptr, 8);
+    wlmtk_container_set_child_array(c_ptr, true);
+
+    // Note: pointer area extends by (-1, -2, 3, 4) on each fake element.
+    wlmtk_fake_element_t *fe_ptrs[2];
+    for (int i = 0; i < 2; ++i) {
+        fe_ptrs[i] = wlmtk_fake_element_create();
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fe_ptrs[i]);
+        fe_ptrs[i]->dimensions.width = 10;
+        fe_ptrs[i]->dimensions.height = 10;
+        wlmtk_element_set_position(&fe_ptrs[i]->element, 5 * i, 0);
+        wlmtk_element_set_visible(&fe_ptrs[i]->element, true);
+        wlmtk_container_add_element(c_ptr, &fe_ptrs[i]->element);
+    }
+    int x1, y1, x2, y2;
+    wlmtk_element_get_pointer_area(&c_ptr->super_element, &x1, &y1, &x2, &y2);
+    BS_TEST_VERIFY_TRUE(test_ptr, c_ptr->child_array.valid);
+    wlmtk_pointer_motion_event_t e = { .x = 7, .y = 5 };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c_ptr->super_element, &e));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &fe_ptrs[1]->element, c_ptr->pointer_focus_element_ptr);
+    int calls = tlc.calls;
+
+    // Small translation: Same cells. No layout, and caches stay current.
+    wlmtk_container_translate_element(c_ptr, &fe_ptrs[0]->element, 1, 0);
+    BS_TEST_VERIFY_EQ(test_ptr, calls, tlc.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, fe_ptrs[0]->element.x);
+    BS_TEST_VERIFY_FALSE(test_ptr, c_ptr->spatial_index.dirty);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, c_ptr->spatial_index.generation,
+        c_ptr->child_array.generation);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &fe_ptrs[0]->element, c_ptr->child_array.elements_ptr[1]);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, c_ptr->child_array.x1_ptr[1]);
+    BS_TEST_VERIFY_FALSE(test_ptr, c_ptr->super_element.dimensions_cache.valid);
+
+    // Focus is found on the next motion.
+    e = (wlmtk_pointer_motion_event_t){ .x = 0, .y = 5 };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c_ptr->super_element, &e));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &fe_ptrs[0]->element, c_ptr->pointer_focus_element_ptr);
+
+    // Translation beyond the grid: Index gets rebuilt, still no layout.
+    wlmtk_container_translate_element(c_ptr, &fe_ptrs[0]->element, 30, 0);
+    BS_TEST_VERIFY_EQ(test_ptr, calls, tlc.calls);
+    BS_TEST_VERIFY_TRUE(test_ptr, c_ptr->spatial_index.dirty);
+    e = (wlmtk_pointer_motion_event_t){ .x = 31, .y = 5 };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_motion(&c_ptr->super_element, &e));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &fe_ptrs[0]->element, c_ptr->pointer_focus_element_ptr);
+
+    for (int i = 0; i < 2; ++i) {
+        wlmtk_container_remove_element(c_ptr, &fe_ptrs[i]->element);
+        wlmtk_element_destroy(&fe_ptrs[i]->element);
+    }
+    wlmtk_container_fini(c_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies input transparent elements are skipped in pointer traversal. */
+void test_input_transparent(bs_test_t *test_ptr)
+{
+    wlmtk_container_t container;
+    BS_ASSERT(wlmtk_container_init(&container));
+    wlmtk_fake_element_t *fe1_ptr = wlmtk_fake_element_create();
+    fe1_ptr->dimensions.width = 10;
+    fe1_ptr->dimensions.height = 10;
+    wlmtk_element_set_visible(&fe1_ptr->element, true);
+    wlmtk_container_add_element(&container, &fe1_ptr->element);
+    wlmtk_fake_element_t *fe2_ptr = wlmtk_fake_element_create();
+    fe2_ptr->dimensions.width = 20;
+    fe2_ptr->dimensions.height = 20;
+    wlmtk_element_set_visible(&fe2_ptr->element, true);
+    wlmtk_container_add_element(&container, &fe2_ptr->element);
+
+    wlmtk_pointer_motion_event_t e = { .x = 5, .y = 5 };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_element_pointer_motion(&container.super_element, &e));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &fe2_ptr->element, container.pointer_focus_element_ptr);
+
+    // fe2 is on top, but transparent: fe1 gets focus. fe2 isn't consulted.
+    wlmtk_element_set_input_transparent(&fe2_ptr->element, true);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &fe1_ptr->element, container.pointer_focus_element_ptr);
+    fe2_ptr->pointer_motion_called = false;
+    e = (wlmtk_pointer_motion_event_t){ .x = 15, .y = 15 };
+    BS_TEST_VERIFY_FALSE(
+        test_ptr,
+        wlmtk_element_pointer_motion(&container.super_element, &e));
+    BS_TEST_VERIFY_FALSE(test_ptr, fe2_ptr->pointer_motion_called);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, container.pointer_focus_element_ptr);
+
+    // Nor does it count for the container's pointer area.
+    int x1, y1, x2, y2;
+    wlmtk_element_get_pointer_area(
+        &container.super_element, &x1, &y1, &x2, &y2);
+    BS_TEST_VERIFY_EQ(test_ptr, 13, x2);
+    BS_TEST_VERIFY_EQ(test_ptr, 14, y2);
+
+    wlmtk_container_remove_element(&container, &fe2_ptr->element);
+    wlmtk_element_destroy(&fe2_ptr->element);
+    wlmtk_container_remove_element(&container, &fe1_ptr->element);
+    wlmtk_element_destroy(&fe1_ptr->element);
+    wlmtk_container_fini(&container);
+}
+
 /* == End of container.c =================================================== */
@@ -185,11 +185,37 @@ void wlmtk_content_commit(
     int height,
     uint32_t serial)
 {
+    bool resized = (content_ptr->committed_width != width ||
+                    content_ptr->committed_height != height);
+    bool unchanged = (content_ptr->has_committed &&
+                      !resized &&
+                      content_ptr->committed_serial == serial);
     content_ptr->committed_width = width;
     content_ptr->committed_height = height;
-    if (NULL != content_ptr->window_ptr) {
-        wlmtk_window_serial(content_ptr->window_ptr, serial);
+    content_ptr->committed_serial = serial;
+    if (NULL == content_ptr->window_ptr) return;
+    content_ptr->has_committed = true;
+
+    if (unchanged &&
+        !wlmtk_window_has_pending_updates(content_ptr->window_ptr)) {
+        // Nothing to apply: Only the buffer changed.
+        ++content_ptr->unchanged_commits;
+        wlmtk_window_invalidate_thumbnail(content_ptr->window_ptr);
+        return;
+    }
+
+    if (resized) {
+        ++content_ptr->resized_commits;
+    } else {
+        ++content_ptr->serial_commits;
     }
+    wlmtk_window_serial(content_ptr->window_ptr, serial);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_content_set_opaque(wlmtk_content_t *content_ptr, bool opaque)
+{
+    content_ptr->opaque = opaque;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -198,6 +224,7 @@ void wlmtk_content_set_window(
     wlmtk_window_t *window_ptr)
 {
     content_ptr->window_ptr = window_ptr;
+    content_ptr->has_committed = false;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -23,11 +23,20 @@
 
 #include <inttypes.h>
 #include <libbase/libbase.h>
+#include <linux/input-event-codes.h>
+#include <math.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <toolkit/util.h>
+#define WLR_USE_UNSTABLE
+#include <wlr/types/wlr_scene.h>
+#undef WLR_USE_UNSTABLE
 
+#include "animation.h"
 #include "box.h"
 #include "container.h"
+#include "input.h"
+#include "layer.h"
 
 /* == Declarations ========================================================= */
 
@@ -45,6 +54,33 @@ struct _wlmtk_dock_t {
 
     /** Principal element of the dock is a box, holding tiles. */
     wlmtk_box_t               tile_box;
+
+    /** Original virtual method table of the panel's element. */
+    wlmtk_element_vmt_t       orig_super_element_vmt;
+    /**
+     * Number of tiles that fit on the output, or 0 if not known. Tiles
+     * beyond are hidden, and can be scrolled into view.
+     */
+    size_t                    max_visible_tiles;
+    /** Index of the first tile shown. */
+    size_t                    first_visible_tile;
+
+    /** Events of the dock. */
+    wlmtk_dock_events_t       events;
+    /** Element of the tile that the left button was pressed on, or NULL. */
+    wlmtk_element_t           *pressed_element_ptr;
+    /** Pointer position when pressed, relative to the dock. */
+    double                    pressed_x;
+    /** Pointer position when pressed, relative to the dock. */
+    double                    pressed_y;
+    /** Most recent pointer position while dragging, relative to the dock. */
+    double                    drag_x;
+    /** Most recent pointer position while dragging, relative to the dock. */
+    double                    drag_y;
+    /** Whether @ref wlmtk_dock_t::pressed_element_ptr is being dragged. */
+    bool                      dragging;
+    /** Set when a tile was dropped, to swallow the click that follows. */
+    bool                      dropped;
 };
 
 static uint32_t _wlmtk_dock_panel_request_size(
@@ -52,6 +88,28 @@ static uint32_t _wlmtk_dock_panel_request_size(
     int width,
     int height);
 
+static bool _wlmtk_dock_element_pointer_motion(
+    wlmtk_element_t *element_ptr,
+    wlmtk_pointer_motion_event_t *motion_event_ptr);
+static bool _wlmtk_dock_element_pointer_button(
+    wlmtk_element_t *element_ptr,
+    const wlmtk_button_event_t *button_event_ptr);
+static bool _wlmtk_dock_element_pointer_axis(
+    wlmtk_element_t *element_ptr,
+    struct wlr_pointer_axis_event *wlr_pointer_axis_event_ptr);
+static void _wlmtk_dock_element_pointer_grab_cancel(
+    wlmtk_element_t *element_ptr);
+
+static void _wlmtk_dock_drag_start(wlmtk_dock_t *dock_ptr);
+static void _wlmtk_dock_drag_place(wlmtk_dock_t *dock_ptr);
+static void _wlmtk_dock_drag_abort(wlmtk_dock_t *dock_ptr);
+static void _wlmtk_dock_drop(wlmtk_dock_t *dock_ptr);
+static size_t _wlmtk_dock_tile_index(
+    wlmtk_dock_t *dock_ptr,
+    wlmtk_element_t *element_ptr);
+
+static void _wlmtk_dock_update_max_visible_tiles(wlmtk_dock_t *dock_ptr);
+static void _wlmtk_dock_update_visible_tiles(wlmtk_dock_t *dock_ptr);
 static wlmtk_box_orientation_t _wlmtk_dock_orientation(wlmtk_dock_t *dock_ptr);
 static bool _wlmtk_dock_positioning(
     wlmtk_dock_t *dock_ptr,
@@ -64,6 +122,19 @@ static const wlmtk_panel_vmt_t _wlmtk_dock_panel_vmt = {
     .request_size = _wlmtk_dock_panel_request_size
 };
 
+/** The dock's extension to @ref wlmtk_element_t virtual method table. */
+static const wlmtk_element_vmt_t _wlmtk_dock_element_vmt = {
+    .pointer_motion = _wlmtk_dock_element_pointer_motion,
+    .pointer_button = _wlmtk_dock_element_pointer_button,
+    .pointer_axis = _wlmtk_dock_element_pointer_axis,
+    .pointer_grab_cancel = _wlmtk_dock_element_pointer_grab_cancel,
+};
+
+/** Distance the pointer must move while pressed, to start dragging a tile. */
+static const double _wlmtk_dock_drag_threshold = 8.0;
+/** Duration for tiles to slide into their place, after a drop. */
+static const uint64_t _wlmtk_dock_drop_msec = 150;
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -75,6 +146,7 @@ wlmtk_dock_t *wlmtk_dock_create(
     if (NULL == dock_ptr) return NULL;
     dock_ptr->dock_positioning = *dock_positioning_ptr;
     dock_ptr->dock_style = *style_ptr;
+    wl_signal_init(&dock_ptr->events.tile_moved);
 
     if (!wlmtk_box_init(
             &dock_ptr->tile_box,
@@ -100,6 +172,9 @@ wlmtk_dock_t *wlmtk_dock_create(
         return NULL;
     }
     wlmtk_panel_extend(&dock_ptr->super_panel, &_wlmtk_dock_panel_vmt);
+    dock_ptr->orig_super_element_vmt = wlmtk_element_extend(
+        wlmtk_panel_element(&dock_ptr->super_panel),
+        &_wlmtk_dock_element_vmt);
 
     wlmtk_container_add_element(
         &dock_ptr->super_panel.super_container,
@@ -138,6 +213,7 @@ void wlmtk_dock_add_tile(
             &dock_ptr->tile_box,
             wlmtk_tile_element(tile_ptr));
     }
+    _wlmtk_dock_update_visible_tiles(dock_ptr);
 
     wlmtk_panel_t *panel_ptr = wlmtk_dock_panel(dock_ptr);
     struct wlr_box box = wlmtk_element_get_dimensions_box(
@@ -151,11 +227,21 @@ void wlmtk_dock_remove_tile(
     wlmtk_tile_t *tile_ptr)
 {
     BS_ASSERT(
-        &dock_ptr->tile_box.element_container ==
+        &dock_ptr->tile_box.super_container ==
         wlmtk_tile_element(tile_ptr)->parent_container_ptr);
+    if (wlmtk_tile_element(tile_ptr) == dock_ptr->pressed_element_ptr) {
+        bool dragging = dock_ptr->dragging;
+        _wlmtk_dock_drag_abort(dock_ptr);
+        if (dragging) {
+            wlmtk_container_pointer_grab_release(
+                &dock_ptr->super_panel.super_container,
+                wlmtk_box_element(&dock_ptr->tile_box));
+        }
+    }
     wlmtk_box_remove_element(
         &dock_ptr->tile_box,
         wlmtk_tile_element(tile_ptr));
+    _wlmtk_dock_update_visible_tiles(dock_ptr);
 
     wlmtk_panel_t *panel_ptr = wlmtk_dock_panel(dock_ptr);
     struct wlr_box box = wlmtk_element_get_dimensions_box(
@@ -163,6 +249,12 @@ void wlmtk_dock_remove_tile(
     wlmtk_panel_request_size(panel_ptr, box.width, box.height);
 }
 
+/* ------------------------------------------------------------------------- */
+wlmtk_dock_events_t *wlmtk_dock_events(wlmtk_dock_t *dock_ptr)
+{
+    return &dock_ptr->events;
+}
+
 /* ------------------------------------------------------------------------- */
 wlmtk_panel_t *wlmtk_dock_panel(wlmtk_dock_t *dock_ptr)
 {
@@ -177,6 +269,347 @@ wlmtk_element_t *wlmtk_dock_element(wlmtk_dock_t *dock_ptr)
 
 /* == Local (static) methods =============================================== */
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_element_vmt_t::pointer_motion.
+ *
+ * Starts dragging the pressed tile once the pointer moved beyond
+ * @ref _wlmtk_dock_drag_threshold. While dragging, the tile's scene node
+ * follows the pointer along the dock, and the motion is not forwarded.
+ *
+ * @param element_ptr
+ * @param motion_event_ptr
+ *
+ * @return Whether the motion is within the dock's pointer area.
+ */
+bool _wlmtk_dock_element_pointer_motion(
+    wlmtk_element_t *element_ptr,
+    wlmtk_pointer_motion_event_t *motion_event_ptr)
+{
+    wlmtk_dock_t *dock_ptr = BS_CONTAINER_OF(
+        element_ptr, wlmtk_dock_t, super_panel.super_container.super_element);
+
+    if (dock_ptr->dragging) {
+        if (isnan(motion_event_ptr->x) || isnan(motion_event_ptr->y)) {
+            return false;
+        }
+        dock_ptr->drag_x = motion_event_ptr->x;
+        dock_ptr->drag_y = motion_event_ptr->y;
+        _wlmtk_dock_drag_place(dock_ptr);
+        return true;
+    }
+
+    bool rv = dock_ptr->orig_super_element_vmt.pointer_motion(
+        element_ptr, motion_event_ptr);
+    if (NULL != dock_ptr->pressed_element_ptr &&
+        !isnan(motion_event_ptr->x) && !isnan(motion_event_ptr->y) &&
+        _wlmtk_dock_drag_threshold <= hypot(
+            motion_event_ptr->x - dock_ptr->pressed_x,
+            motion_event_ptr->y - dock_ptr->pressed_y)) {
+        dock_ptr->drag_x = motion_event_ptr->x;
+        dock_ptr->drag_y = motion_event_ptr->y;
+        _wlmtk_dock_drag_start(dock_ptr);
+        _wlmtk_dock_drag_place(dock_ptr);
+    }
+    return rv;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_element_vmt_t::pointer_button.
+ *
+ * Remembers the tile that the left button is pressed on, and drops the
+ * tile when released while dragging. The click following a drop is not
+ * forwarded, so the tile does not get activated.
+ *
+ * @param element_ptr
+ * @param button_event_ptr
+ *
+ * @return true if the button event was consumed.
+ */
+bool _wlmtk_dock_element_pointer_button(
+    wlmtk_element_t *element_ptr,
+    const wlmtk_button_event_t *button_event_ptr)
+{
+    wlmtk_dock_t *dock_ptr = BS_CONTAINER_OF(
+        element_ptr, wlmtk_dock_t, super_panel.super_container.super_element);
+
+    if (BTN_LEFT != button_event_ptr->button) {
+        return dock_ptr->orig_super_element_vmt.pointer_button(
+            element_ptr, button_event_ptr);
+    }
+
+    bool rv;
+    switch (button_event_ptr->type) {
+    case WLMTK_BUTTON_DOWN:
+        dock_ptr->dropped = false;
+        rv = dock_ptr->orig_super_element_vmt.pointer_button(
+            element_ptr, button_event_ptr);
+        if (dock_ptr->dragging) return rv;
+        dock_ptr->pressed_element_ptr =
+            dock_ptr->tile_box.super_container.pointer_focus_element_ptr;
+        dock_ptr->pressed_x = element_ptr->last_pointer_motion_event.x;
+        dock_ptr->pressed_y = element_ptr->last_pointer_motion_event.y;
+        // Claim the press, for getting the release even if not accepted.
+        return rv || NULL != dock_ptr->pressed_element_ptr;
+
+    case WLMTK_BUTTON_UP:
+        rv = dock_ptr->orig_super_element_vmt.pointer_button(
+            element_ptr, button_event_ptr);
+        if (dock_ptr->dragging) {
+            _wlmtk_dock_drop(dock_ptr);
+            return true;
+        }
+        dock_ptr->pressed_element_ptr = NULL;
+        return rv;
+
+    case WLMTK_BUTTON_CLICK:
+    case WLMTK_BUTTON_DOUBLE_CLICK:
+        if (dock_ptr->dropped) {
+            dock_ptr->dropped = false;
+            return true;
+        }
+        break;
+
+    default:
+        break;
+    }
+    return dock_ptr->orig_super_element_vmt.pointer_button(
+        element_ptr, button_event_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_element_vmt_t::pointer_axis.
+ *
+ * Scrolls through the tiles, if there are more than fit the output. Axis
+ * events handled by the tile below the pointer take precedence.
+ *
+ * @param element_ptr
+ * @param wlr_pointer_axis_event_ptr
+ *
+ * @return true if the axis event was handled.
+ */
+bool _wlmtk_dock_element_pointer_axis(
+    wlmtk_element_t *element_ptr,
+    struct wlr_pointer_axis_event *wlr_pointer_axis_event_ptr)
+{
+    wlmtk_dock_t *dock_ptr = BS_CONTAINER_OF(
+        element_ptr, wlmtk_dock_t, super_panel.super_container.super_element);
+
+    if (dock_ptr->orig_super_element_vmt.pointer_axis(
+            element_ptr, wlr_pointer_axis_event_ptr)) return true;
+
+    size_t tiles = bs_dllist_size(
+        &dock_ptr->tile_box.super_container.elements);
+    if (0 == dock_ptr->max_visible_tiles ||
+        tiles <= dock_ptr->max_visible_tiles) return false;
+
+    int steps = wlmtk_pointer_axis_steps(wlr_pointer_axis_event_ptr);
+    if (0 > steps && (size_t)-steps > dock_ptr->first_visible_tile) {
+        dock_ptr->first_visible_tile = 0;
+    } else {
+        dock_ptr->first_visible_tile += steps;
+    }
+    _wlmtk_dock_update_visible_tiles(dock_ptr);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_element_vmt_t::pointer_grab_cancel. Puts a dragged
+ * tile back into its place.
+ *
+ * @param element_ptr
+ */
+void _wlmtk_dock_element_pointer_grab_cancel(wlmtk_element_t *element_ptr)
+{
+    wlmtk_dock_t *dock_ptr = BS_CONTAINER_OF(
+        element_ptr, wlmtk_dock_t, super_panel.super_container.super_element);
+    _wlmtk_dock_drag_abort(dock_ptr);
+    dock_ptr->orig_super_element_vmt.pointer_grab_cancel(element_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Starts dragging @ref wlmtk_dock_t::pressed_element_ptr: The tile loses
+ * pointer focus, is raised above the other tiles, and the dock grabs the
+ * pointer until the tile is dropped.
+ *
+ * @param dock_ptr
+ */
+void _wlmtk_dock_drag_start(wlmtk_dock_t *dock_ptr)
+{
+    wlmtk_element_t *element_ptr = dock_ptr->pressed_element_ptr;
+    wlmtk_pointer_motion_event_t e = { .x = NAN, .y = NAN };
+    wlmtk_element_pointer_motion(element_ptr, &e);
+
+    dock_ptr->dragging = true;
+    if (NULL != element_ptr->wlr_scene_node_ptr) {
+        wlmtk_animation_cancel(element_ptr);
+        wlr_scene_node_raise_to_top(element_ptr->wlr_scene_node_ptr);
+    }
+    wlmtk_container_pointer_grab(
+        &dock_ptr->super_panel.super_container,
+        wlmtk_box_element(&dock_ptr->tile_box));
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Places the dragged tile's scene node at the pointer, along the dock. The
+ * element's position remains, so the box' layout is not touched.
+ *
+ * @param dock_ptr
+ */
+void _wlmtk_dock_drag_place(wlmtk_dock_t *dock_ptr)
+{
+    wlmtk_element_t *element_ptr = dock_ptr->pressed_element_ptr;
+    if (NULL == element_ptr->wlr_scene_node_ptr) return;
+
+    int x, y;
+    wlmtk_element_get_position(element_ptr, &x, &y);
+    if (WLMTK_BOX_VERTICAL == dock_ptr->tile_box.orientation) {
+        y += (int)(dock_ptr->drag_y - dock_ptr->pressed_y);
+    } else {
+        x += (int)(dock_ptr->drag_x - dock_ptr->pressed_x);
+    }
+    wlr_scene_node_set_position(element_ptr->wlr_scene_node_ptr, x, y);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Ends a press or drag without a drop: A dragged tile is put back in place.
+ * Does not release the pointer grab, that is up to the caller.
+ *
+ * @param dock_ptr
+ */
+void _wlmtk_dock_drag_abort(wlmtk_dock_t *dock_ptr)
+{
+    wlmtk_element_t *element_ptr = dock_ptr->pressed_element_ptr;
+    if (dock_ptr->dragging && NULL != element_ptr->wlr_scene_node_ptr) {
+        int x, y;
+        wlmtk_element_get_position(element_ptr, &x, &y);
+        wlr_scene_node_set_position(element_ptr->wlr_scene_node_ptr, x, y);
+    }
+    dock_ptr->pressed_element_ptr = NULL;
+    dock_ptr->dragging = false;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Drops the dragged tile: Moves it before the first visible tile whose
+ * center is beyond the pointer, or after the last visible tile. Tiles that
+ * changed their place slide there, and @ref wlmtk_dock_events_t::tile_moved
+ * is raised if the order changed.
+ *
+ * @param dock_ptr
+ */
+void _wlmtk_dock_drop(wlmtk_dock_t *dock_ptr)
+{
+    wlmtk_element_t *element_ptr = dock_ptr->pressed_element_ptr;
+    bool vertical = WLMTK_BOX_VERTICAL == dock_ptr->tile_box.orientation;
+    int x, y;
+    wlmtk_element_get_position(
+        wlmtk_box_element(&dock_ptr->tile_box), &x, &y);
+    double pos = vertical ? dock_ptr->drag_y - y : dock_ptr->drag_x - x;
+
+    // Hidden tiles only qualify after the visible ones: Dropping beyond the
+    // last visible tile keeps the hidden tiles in their place.
+    wlmtk_element_t *before_element_ptr = NULL;
+    bool seen_visible = false;
+    for (bs_dllist_node_t *dlnode_ptr =
+             dock_ptr->tile_box.super_container.elements.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_element_t *e_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
+        if (e_ptr == element_ptr) continue;
+        if (!e_ptr->visible) {
+            if (!seen_visible) continue;
+            before_element_ptr = e_ptr;
+            break;
+        }
+        seen_visible = true;
+        wlmtk_element_get_position(e_ptr, &x, &y);
+        struct wlr_box box = wlmtk_element_get_dimensions_box(e_ptr);
+        double center = vertical ?
+            y + box.y + box.height / 2.0 : x + box.x + box.width / 2.0;
+        if (center > pos) {
+            before_element_ptr = e_ptr;
+            break;
+        }
+    }
+
+    int node_x = 0, node_y = 0;
+    if (NULL != element_ptr->wlr_scene_node_ptr) {
+        node_x = element_ptr->wlr_scene_node_ptr->x;
+        node_y = element_ptr->wlr_scene_node_ptr->y;
+    }
+    size_t from = _wlmtk_dock_tile_index(dock_ptr, element_ptr);
+    wlmtk_box_move_element_before(
+        &dock_ptr->tile_box, element_ptr, before_element_ptr);
+    size_t to = _wlmtk_dock_tile_index(dock_ptr, element_ptr);
+    _wlmtk_dock_update_visible_tiles(dock_ptr);
+    // Animations start from the new positions.
+    wlmtk_container_flush_layout();
+
+    wlmtk_element_get_position(element_ptr, &x, &y);
+    if (NULL != element_ptr->wlr_scene_node_ptr) {
+        wlmtk_animation_translate(
+            element_ptr, node_x - x, node_y - y, _wlmtk_dock_drop_msec);
+    }
+
+    // The tiles in between shifted by one slot, towards the former place.
+    struct wlr_box box = wlmtk_element_get_dimensions_box(element_ptr);
+    int shift = (vertical ? box.height : box.width) +
+        dock_ptr->dock_style.margin.width;
+    if (from > to) shift = -shift;
+    size_t index = 0;
+    for (bs_dllist_node_t *dlnode_ptr =
+             dock_ptr->tile_box.super_container.elements.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr, ++index) {
+        if (index < BS_MIN(from, to) || index > BS_MAX(from, to) ||
+            index == to) continue;
+        wlmtk_element_t *e_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
+        if (!e_ptr->visible) continue;
+        wlmtk_animation_translate(
+            e_ptr, vertical ? 0 : shift, vertical ? shift : 0,
+            _wlmtk_dock_drop_msec);
+    }
+
+    dock_ptr->pressed_element_ptr = NULL;
+    dock_ptr->dragging = false;
+    dock_ptr->dropped = true;
+    wlmtk_container_pointer_grab_release(
+        &dock_ptr->super_panel.super_container,
+        wlmtk_box_element(&dock_ptr->tile_box));
+
+    if (from == to) return;
+    wlmtk_dock_tile_moved_event_t event = {
+        .tile_ptr = BS_CONTAINER_OF(
+            element_ptr, wlmtk_tile_t, super_container.super_element),
+        .from = from,
+        .to = to
+    };
+    wl_signal_emit(&dock_ptr->events.tile_moved, &event);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns the position of `element_ptr` in the dock's box, from the front. */
+size_t _wlmtk_dock_tile_index(
+    wlmtk_dock_t *dock_ptr,
+    wlmtk_element_t *element_ptr)
+{
+    bs_dllist_node_t *element_dlnode_ptr = wlmtk_dlnode_from_element(
+        element_ptr);
+    size_t index = 0;
+    for (bs_dllist_node_t *dlnode_ptr =
+             dock_ptr->tile_box.super_container.elements.head_ptr;
+         element_dlnode_ptr != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) ++index;
+    return index;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Returns the panel to change to the specified size.
@@ -194,6 +627,7 @@ uint32_t _wlmtk_dock_panel_request_size(
 {
     wlmtk_dock_t *dock_ptr = BS_CONTAINER_OF(
         panel_ptr, wlmtk_dock_t, super_panel);
+    _wlmtk_dock_update_max_visible_tiles(dock_ptr);
 
     wlmtk_panel_positioning_t panel_positioning = {};
     if (!_wlmtk_dock_positioning(dock_ptr, &panel_positioning)) {
@@ -205,6 +639,73 @@ uint32_t _wlmtk_dock_panel_request_size(
     return 0;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes how many tiles fit along the output's edge, and updates which
+ * tiles are shown if that changed. Assumes all tiles are of the same size.
+ *
+ * @param dock_ptr
+ */
+void _wlmtk_dock_update_max_visible_tiles(wlmtk_dock_t *dock_ptr)
+{
+    wlmtk_layer_output_t *layer_output_ptr = wlmtk_panel_get_layer_output(
+        &dock_ptr->super_panel);
+    bs_dllist_node_t *dlnode_ptr =
+        dock_ptr->tile_box.super_container.elements.head_ptr;
+    size_t max_visible_tiles = 0;
+    if (NULL != layer_output_ptr && NULL != dlnode_ptr) {
+        struct wlr_box extents = wlmtk_layer_output_get_extents(
+            layer_output_ptr);
+        struct wlr_box tile_box = wlmtk_element_get_dimensions_box(
+            wlmtk_element_from_dlnode(dlnode_ptr));
+        int margin = dock_ptr->dock_style.margin.width;
+        int available = extents.width, tile_size = tile_box.width;
+        if (WLMTK_BOX_VERTICAL == dock_ptr->tile_box.orientation) {
+            available = extents.height;
+            tile_size = tile_box.height;
+        }
+        if (0 < tile_size && 0 < available) {
+            max_visible_tiles = BS_MAX(
+                1, (available + margin) / (tile_size + margin));
+        }
+    }
+
+    if (max_visible_tiles == dock_ptr->max_visible_tiles) return;
+    dock_ptr->max_visible_tiles = max_visible_tiles;
+    _wlmtk_dock_update_visible_tiles(dock_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Shows the tiles from @ref wlmtk_dock_t::first_visible_tile, as many as fit
+ * the output, and hides all others. Hidden tiles have their scene nodes
+ * disabled, and are skipped by the box' layout.
+ *
+ * @param dock_ptr
+ */
+void _wlmtk_dock_update_visible_tiles(wlmtk_dock_t *dock_ptr)
+{
+    size_t tiles = bs_dllist_size(
+        &dock_ptr->tile_box.super_container.elements);
+    size_t visible_tiles = tiles;
+    if (0 < dock_ptr->max_visible_tiles) {
+        visible_tiles = BS_MIN(tiles, dock_ptr->max_visible_tiles);
+    }
+    dock_ptr->first_visible_tile = BS_MIN(
+        dock_ptr->first_visible_tile, tiles - visible_tiles);
+
+    size_t index = 0;
+    for (bs_dllist_node_t *dlnode_ptr =
+             dock_ptr->tile_box.super_container.elements.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr, ++index) {
+        wlmtk_element_set_visible(
+            wlmtk_element_from_dlnode(dlnode_ptr),
+            index >= dock_ptr->first_visible_tile &&
+            index < dock_ptr->first_visible_tile + visible_tiles);
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 /** Derives the box' orientation for the dock. */
 wlmtk_box_orientation_t _wlmtk_dock_orientation(wlmtk_dock_t *dock_ptr)
@@ -289,9 +790,13 @@ bool _wlmtk_dock_positioning(
 /* == Unit tests =========================================================== */
 
 static void test_create_destroy(bs_test_t *test_ptr);
+static void test_visible_tiles(bs_test_t *test_ptr);
+static void test_drag(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_dock_test_cases[] = {
     { 1, "create_destroy", test_create_destroy },
+    { 1, "visible_tiles", test_visible_tiles },
+    { 1, "drag", test_drag },
     { 0, NULL, NULL }
 };
 
@@ -326,4 +831,126 @@ const bs_test_case_t wlmtk_dock_test_cases[] = {
     wlmtk_dock_destroy(dock_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Verifies only tiles within the visible range are shown. */
+void test_visible_tiles(bs_test_t *test_ptr)
+{
+    wlmtk_dock_positioning_t pos = {
+        .edge = WLR_EDGE_LEFT,
+        .anchor = WLR_EDGE_TOP,
+    };
+    wlmtk_dock_style_t style = {};
+    wlmtk_tile_style_t tile_style = { .size = 64, .content_size = 48 };
+    wlmtk_dock_t *dock_ptr = wlmtk_dock_create(&pos, &style);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, dock_ptr);
+
+    wlmtk_tile_t tiles[3];
+    for (size_t i = 0; i < 3; ++i) {
+        BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_tile_init(&tiles[i], &tile_style));
+        wlmtk_element_set_visible(wlmtk_tile_element(&tiles[i]), true);
+        wlmtk_dock_add_tile(dock_ptr, &tiles[i]);
+    }
+    // Not on an output: All tiles are shown.
+    for (size_t i = 0; i < 3; ++i) {
+        BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_tile_element(&tiles[i])->visible);
+    }
+
+    bs_dllist_t *elements_ptr = &dock_ptr->tile_box.super_container.elements;
+    dock_ptr->max_visible_tiles = 2;
+    _wlmtk_dock_update_visible_tiles(dock_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_from_dlnode(elements_ptr->head_ptr)->visible);
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlmtk_element_from_dlnode(elements_ptr->tail_ptr)->visible);
+
+    // Scrolling beyond the last tile is clamped.
+    dock_ptr->first_visible_tile = 5;
+    _wlmtk_dock_update_visible_tiles(dock_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, dock_ptr->first_visible_tile);
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlmtk_element_from_dlnode(elements_ptr->head_ptr)->visible);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_from_dlnode(elements_ptr->tail_ptr)->visible);
+
+    for (size_t i = 0; i < 3; ++i) {
+        wlmtk_dock_remove_tile(dock_ptr, &tiles[i]);
+        wlmtk_tile_fini(&tiles[i]);
+    }
+    wlmtk_dock_destroy(dock_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies tiles get re-ordered by dragging them. */
+void test_drag(bs_test_t *test_ptr)
+{
+    wlmtk_dock_positioning_t pos = {
+        .edge = WLR_EDGE_LEFT,
+        .anchor = WLR_EDGE_TOP,
+    };
+    wlmtk_dock_style_t style = {};
+    wlmtk_tile_style_t tile_style = { .size = 64, .content_size = 48 };
+    wlmtk_dock_t *dock_ptr = wlmtk_dock_create(&pos, &style);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, dock_ptr);
+    wlmtk_element_t *element_ptr = wlmtk_dock_element(dock_ptr);
+    wlmtk_util_test_listener_t moved = {};
+    wlmtk_util_connect_test_listener(
+        &wlmtk_dock_events(dock_ptr)->tile_moved, &moved);
+
+    wlmtk_tile_t tiles[3];
+    for (size_t i = 0; i < 3; ++i) {
+        BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_tile_init(&tiles[i], &tile_style));
+        wlmtk_element_set_visible(wlmtk_tile_element(&tiles[i]), true);
+        wlmtk_dock_add_tile(dock_ptr, &tiles[i]);
+    }
+
+    // Press on the first tile: Not yet dragging.
+    wlmtk_pointer_motion_event_t m = { .x = 32, .y = 32 };
+    wlmtk_element_pointer_motion(element_ptr, &m);
+    wlmtk_button_event_t b = { .button = BTN_LEFT, .type = WLMTK_BUTTON_DOWN };
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_button(element_ptr, &b));
+    BS_TEST_VERIFY_EQ(
+        test_ptr,
+        wlmtk_tile_element(&tiles[0]),
+        dock_ptr->pressed_element_ptr);
+    m.y = 36;
+    wlmtk_element_pointer_motion(element_ptr, &m);
+    BS_TEST_VERIFY_FALSE(test_ptr, dock_ptr->dragging);
+
+    // Drag it beyond the center of the second tile, and drop it there.
+    m.y = 150;
+    wlmtk_element_pointer_motion(element_ptr, &m);
+    BS_TEST_VERIFY_TRUE(test_ptr, dock_ptr->dragging);
+    b.type = WLMTK_BUTTON_UP;
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_button(element_ptr, &b));
+    BS_TEST_VERIFY_FALSE(test_ptr, dock_ptr->dragging);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, moved.calls);
+    // The click following the drop is swallowed.
+    b.type = WLMTK_BUTTON_CLICK;
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_element_pointer_button(element_ptr, &b));
+    BS_TEST_VERIFY_FALSE(test_ptr, dock_ptr->dropped);
+
+    bs_dllist_t *elements_ptr = &dock_ptr->tile_box.super_container.elements;
+    BS_TEST_VERIFY_EQ(
+        test_ptr,
+        wlmtk_tile_element(&tiles[1]),
+        wlmtk_element_from_dlnode(elements_ptr->head_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr,
+        wlmtk_tile_element(&tiles[2]),
+        wlmtk_element_from_dlnode(elements_ptr->tail_ptr));
+    int x, y;
+    wlmtk_element_get_position(wlmtk_tile_element(&tiles[0]), &x, &y);
+    BS_TEST_VERIFY_EQ(test_ptr, 64, y);
+
+    wlmtk_util_disconnect_test_listener(&moved);
+    for (size_t i = 0; i < 3; ++i) {
+        wlmtk_dock_remove_tile(dock_ptr, &tiles[i]);
+        wlmtk_tile_fini(&tiles[i]);
+    }
+    wlmtk_dock_destroy(dock_ptr);
+}
+
 /* == End of dock.c ======================================================== */
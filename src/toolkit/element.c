@@ -106,9 +106,11 @@ wlmtk_element_vmt_t wlmtk_element_extend(
     }
     if (NULL != element_vmt_ptr->get_dimensions) {
         element_ptr->vmt.get_dimensions = element_vmt_ptr->get_dimensions;
+        element_ptr->type = WLMTK_ELEMENT_GENERIC;
     }
     if (NULL != element_vmt_ptr->get_pointer_area) {
         element_ptr->vmt.get_pointer_area = element_vmt_ptr->get_pointer_area;
+        element_ptr->type = WLMTK_ELEMENT_GENERIC;
     }
     if (NULL != element_vmt_ptr->pointer_motion) {
         element_ptr->vmt.pointer_motion = element_vmt_ptr->pointer_motion;
@@ -194,8 +196,9 @@ void wlmtk_element_attach_to_scene_graph(
             &element_ptr->wlr_scene_node_ptr->events.destroy,
             &element_ptr->wlr_scene_node_destroy_listener,
             handle_wlr_scene_node_destroy);
-        wlr_scene_node_set_enabled(element_ptr->wlr_scene_node_ptr,
-                                   element_ptr->visible);
+        wlr_scene_node_set_enabled(
+            element_ptr->wlr_scene_node_ptr,
+            element_ptr->visible && !element_ptr->occluded);
         wlr_scene_node_set_position(element_ptr->wlr_scene_node_ptr,
                                     element_ptr->x,
                                     element_ptr->y);
@@ -219,8 +222,11 @@ void wlmtk_element_set_visible(wlmtk_element_t *element_ptr, bool visible)
     if (element_ptr->visible == visible) return;
 
     element_ptr->visible = visible;
+    ++element_ptr->extents_serial;
     if (NULL != element_ptr->wlr_scene_node_ptr) {
-        wlr_scene_node_set_enabled(element_ptr->wlr_scene_node_ptr, visible);
+        wlr_scene_node_set_enabled(
+            element_ptr->wlr_scene_node_ptr,
+            visible && !element_ptr->occluded);
     }
 
     if (NULL != element_ptr->parent_container_ptr) {
@@ -228,6 +234,50 @@ void wlmtk_element_set_visible(wlmtk_element_t *element_ptr, bool visible)
     }
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_element_set_occluded(wlmtk_element_t *element_ptr, bool occluded)
+{
+    if (element_ptr->occluded == occluded) return;
+
+    element_ptr->occluded = occluded;
+    if (NULL != element_ptr->wlr_scene_node_ptr) {
+        wlr_scene_node_set_enabled(
+            element_ptr->wlr_scene_node_ptr,
+            element_ptr->visible && !occluded);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_element_set_input_transparent(
+    wlmtk_element_t *element_ptr,
+    bool input_transparent)
+{
+    if (element_ptr->input_transparent == input_transparent) return;
+
+    element_ptr->input_transparent = input_transparent;
+    // The parent's pointer area, its index, and maybe pointer focus change.
+    if (NULL != element_ptr->parent_container_ptr) {
+        wlmtk_container_update_layout(element_ptr->parent_container_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_element_invalidate_extents(wlmtk_element_t *element_ptr)
+{
+    // Walks all the way up: An invisible child may have left an ancestor
+    // with a still-valid cache, so we cannot stop at the first invalid one.
+    while (NULL != element_ptr) {
+        element_ptr->dimensions_cache.valid = false;
+        element_ptr->pointer_area_cache.valid = false;
+        ++element_ptr->extents_serial;
+        if (NULL == element_ptr->parent_container_ptr) return;
+        // The parent's spatial index holds this element's pointer area.
+        wlmtk_container_invalidate_spatial_index(
+            element_ptr->parent_container_ptr);
+        element_ptr = &element_ptr->parent_container_ptr->super_element;
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmtk_element_get_position(
     wlmtk_element_t *element_ptr,
@@ -260,6 +310,8 @@ void wlmtk_element_set_position(
     element_ptr->y = y;
 
     if (NULL != element_ptr->parent_container_ptr) {
+        wlmtk_element_invalidate_extents(
+            &element_ptr->parent_container_ptr->super_element);
         wlmtk_container_update_pointer_focus(
             element_ptr->parent_container_ptr);
     }
@@ -595,6 +647,7 @@ static void test_set_parent_container(bs_test_t *test_ptr);
 static void test_set_get_position(bs_test_t *test_ptr);
 static void test_get_dimensions(bs_test_t *test_ptr);
 static void test_get_pointer_area(bs_test_t *test_ptr);
+static void test_type_tag(bs_test_t *test_ptr);
 static void test_pointer_motion_leave(bs_test_t *test_ptr);
 static void test_pointer_button(bs_test_t *test_ptr);
 static void test_pointer_axis(bs_test_t *test_ptr);
@@ -607,6 +660,7 @@ const bs_test_case_t wlmtk_element_test_cases[] = {
     { 1, "set_get_position", test_set_get_position },
     { 1, "get_dimensions", test_get_dimensions },
     { 1, "get_pointer_area", test_get_pointer_area },
+    { 1, "type_tag", test_type_tag },
     { 1, "pointer_motion_leave", test_pointer_motion_leave },
     { 1, "pointer_button", test_pointer_button },
     { 1, "pointer_axis", test_pointer_axis },
@@ -750,6 +804,41 @@ void test_get_dimensions(bs_test_t *test_ptr)
     wlmtk_element_destroy(&fake_element_ptr->element);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tagged elements are read inline, until the vmt overrides the methods. */
+void test_type_tag(bs_test_t *test_ptr)
+{
+    wlmtk_element_t element;
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, wlmtk_element_init(&element));
+    BS_TEST_VERIFY_EQ(test_ptr, WLMTK_ELEMENT_GENERIC, element.type);
+
+    element.type = WLMTK_ELEMENT_RECTANGLE;
+    element.leaf_width = 42;
+    element.leaf_height = 21;
+    struct wlr_box box = wlmtk_element_get_dimensions_box(&element);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, box.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 42, box.width);
+    BS_TEST_VERIFY_EQ(test_ptr, 21, box.height);
+    int x1, y1, x2, y2;
+    wlmtk_element_get_pointer_area(&element, &x1, &y1, &x2, &y2);
+    BS_TEST_VERIFY_EQ(test_ptr, 42, x2);
+    BS_TEST_VERIFY_EQ(test_ptr, 21, y2);
+
+    // Surfaces: Only the dimensions are inline.
+    element.type = WLMTK_ELEMENT_SURFACE;
+    wlmtk_element_get_dimensions(&element, NULL, NULL, &x2, &y2);
+    BS_TEST_VERIFY_EQ(test_ptr, 42, x2);
+
+    // A subclass' override disables the inline path.
+    element.type = WLMTK_ELEMENT_BUFFER;
+    wlmtk_element_vmt_t vmt = {
+        .get_pointer_area = fake_get_pointer_area };
+    wlmtk_element_extend(&element, &vmt);
+    BS_TEST_VERIFY_EQ(test_ptr, WLMTK_ELEMENT_GENERIC, element.type);
+
+    wlmtk_element_fini(&element);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Tests get_dimensions. */
 void test_get_pointer_area(bs_test_t *test_ptr)
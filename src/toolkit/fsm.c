@@ -22,6 +22,15 @@
 #include "fsm.h"
 
 #include <libbase/libbase.h>
+#include <stdint.h>
+#include <string.h>
+
+/* == Declarations ========================================================= */
+
+static void _wlmtk_fsm_compile(wlmtk_fsm_table_t *table_ptr);
+static const wlmtk_fsm_transition_t *_wlmtk_fsm_find(
+    wlmtk_fsm_t *fsm_ptr,
+    int event);
 
 /* == Exported methods ===================================================== */
 
@@ -33,6 +42,18 @@ void wlmtk_fsm_init(
 {
     fsm_ptr->transitions = transitions;
     fsm_ptr->state = initial_state;
+    fsm_ptr->table_ptr = NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_fsm_init_table(
+    wlmtk_fsm_t *fsm_ptr,
+    wlmtk_fsm_table_t *table_ptr,
+    int initial_state)
+{
+    if (!table_ptr->initialized) _wlmtk_fsm_compile(table_ptr);
+    wlmtk_fsm_init(fsm_ptr, table_ptr->transitions, initial_state);
+    if (table_ptr->compiled) fsm_ptr->table_ptr = table_ptr;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -40,29 +61,97 @@ bool wlmtk_fsm_event(
     wlmtk_fsm_t *fsm_ptr,
     int event,
     void *ud_ptr)
+{
+    const wlmtk_fsm_transition_t *transition_ptr = NULL;
+    const wlmtk_fsm_table_t *table_ptr = fsm_ptr->table_ptr;
+    if (NULL != table_ptr) {
+        // Anything outside the table has no transition. Unsigned arithmetic
+        // also takes care of values below the base.
+        unsigned s =
+            (unsigned)fsm_ptr->state - (unsigned)table_ptr->state_base;
+        unsigned e = (unsigned)event - (unsigned)table_ptr->event_base;
+        if (s < WLMTK_FSM_TABLE_STATES && e < WLMTK_FSM_TABLE_EVENTS) {
+            uint8_t idx = table_ptr->table[s][e];
+            if (0 < idx) transition_ptr = &fsm_ptr->transitions[idx - 1];
+        }
+    } else {
+        transition_ptr = _wlmtk_fsm_find(fsm_ptr, event);
+    }
+    if (NULL == transition_ptr) return false;
+
+    bool rv = true;
+    if (NULL != transition_ptr->handler) {
+        rv = transition_ptr->handler(fsm_ptr, ud_ptr);
+    }
+    fsm_ptr->state = transition_ptr->to_state;
+    return rv;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Builds @ref wlmtk_fsm_table_t::table from its transitions. Leaves
+ * @ref wlmtk_fsm_table_t::compiled false if a transition does not fit.
+ *
+ * @param table_ptr
+ */
+void _wlmtk_fsm_compile(wlmtk_fsm_table_t *table_ptr)
+{
+    memset(table_ptr->table, 0, sizeof(table_ptr->table));
+    table_ptr->initialized = true;
+    table_ptr->compiled = false;
+    table_ptr->state_base = INT32_MAX;
+    table_ptr->event_base = INT32_MAX;
+
+    // First pass: Determine the base of states and events.
+    for (const wlmtk_fsm_transition_t *transition_ptr = table_ptr->transitions;
+         0 <= transition_ptr->state;
+         ++transition_ptr) {
+        table_ptr->state_base = BS_MIN(table_ptr->state_base,
+                                       transition_ptr->state);
+        table_ptr->event_base = BS_MIN(table_ptr->event_base,
+                                       transition_ptr->event);
+    }
+
+    // Second pass: Fill the table, unless anything is beyond bounds.
+    size_t idx = 0;
+    for (const wlmtk_fsm_transition_t *transition_ptr = table_ptr->transitions;
+         0 <= transition_ptr->state;
+         ++transition_ptr, ++idx) {
+        int64_t s = (int64_t)transition_ptr->state - table_ptr->state_base;
+        int64_t e = (int64_t)transition_ptr->event - table_ptr->event_base;
+        if (s >= WLMTK_FSM_TABLE_STATES || e >= WLMTK_FSM_TABLE_EVENTS ||
+            idx >= UINT8_MAX) return;
+        uint8_t *entry_ptr = &table_ptr->table[s][e];
+        if (0 == *entry_ptr) *entry_ptr = idx + 1;
+    }
+    table_ptr->compiled = true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Searches `transitions` for the first matching (state, event). */
+const wlmtk_fsm_transition_t *_wlmtk_fsm_find(
+    wlmtk_fsm_t *fsm_ptr,
+    int event)
 {
     for (const wlmtk_fsm_transition_t *transition_ptr = fsm_ptr->transitions;
          0 <= transition_ptr->state;
          ++transition_ptr) {
         if (transition_ptr->state == fsm_ptr->state &&
-            transition_ptr->event == event) {
-            bool rv = true;
-            if (NULL != transition_ptr->handler) {
-                rv = transition_ptr->handler(fsm_ptr, ud_ptr);
-            }
-            fsm_ptr->state = transition_ptr->to_state;
-            return rv;
-        }
+            transition_ptr->event == event) return transition_ptr;
     }
-    return false;
+    return NULL;
 }
 
 /* == Unit tests =========================================================== */
 
 static void test_event(bs_test_t *test_ptr);
+static void test_uncompiled(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_fsm_test_cases[] = {
     { 1, "event", test_event },
+    { 1, "uncompiled", test_uncompiled },
     { 0, NULL, NULL }
 };
 
@@ -75,8 +164,23 @@ static bool test_fsm_handler(__UNUSED__ wlmtk_fsm_t *fsm_ptr, void *ud_ptr) {
 static const wlmtk_fsm_transition_t test_transitions[] = {
     { 1, 100, 2, test_fsm_handler },
     { 2, 101, 3, NULL },
+    { 2, 101, 1, NULL },
+    WLMTK_FSM_TRANSITION_SENTINEL
+};
+
+/** Lookup table for @ref test_transitions. */
+static wlmtk_fsm_table_t test_table = WLMTK_FSM_TABLE_INITIALIZER(
+    test_transitions);
+
+/** Transition table with states spanning beyond the compiled table. */
+static const wlmtk_fsm_transition_t test_large_transitions[] = {
+    { 1, 100, 200, test_fsm_handler },
+    { 200, 101, 3, NULL },
     WLMTK_FSM_TRANSITION_SENTINEL
 };
+/** Lookup table for @ref test_large_transitions. Won't compile. */
+static wlmtk_fsm_table_t test_large_table = WLMTK_FSM_TABLE_INITIALIZER(
+    test_large_transitions);
 
 /* ------------------------------------------------------------------------- */
 /** Tests FSM. */
@@ -85,8 +189,9 @@ void test_event(bs_test_t *test_ptr)
     wlmtk_fsm_t fsm;
     bool called = false;
 
-    wlmtk_fsm_init(&fsm, test_transitions, 1);
+    wlmtk_fsm_init_table(&fsm, &test_table, 1);
     BS_TEST_VERIFY_EQ(test_ptr, 1, fsm.state);
+    BS_TEST_VERIFY_EQ(test_ptr, &test_table, fsm.table_ptr);
 
     // (1, 100) should trigger call to handler and move to (2).
     BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_fsm_event(&fsm, 100, &called));
@@ -101,6 +206,50 @@ void test_event(bs_test_t *test_ptr)
     BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_fsm_event(&fsm, 101, &called));
     BS_TEST_VERIFY_EQ(test_ptr, 3, fsm.state);
     BS_TEST_VERIFY_FALSE(test_ptr, called);
+
+    // Events outside of the table's bounds are not defined.
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_fsm_event(&fsm, -1, &called));
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_fsm_event(&fsm, 99, &called));
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_fsm_event(&fsm, 1000, &called));
+
+    // For duplicate transitions, the first one applies.
+    fsm.state = 2;
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_fsm_event(&fsm, 101, &called));
+    BS_TEST_VERIFY_EQ(test_ptr, 3, fsm.state);
+
+    // Another state machine shares the table, and has it's own state.
+    wlmtk_fsm_t other_fsm;
+    wlmtk_fsm_init_table(&other_fsm, &test_table, 2);
+    BS_TEST_VERIFY_EQ(test_ptr, &test_table, other_fsm.table_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_fsm_event(&other_fsm, 101, &called));
+    BS_TEST_VERIFY_EQ(test_ptr, 3, other_fsm.state);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, fsm.state);
+
+    // Without table, the transitions are searched. Same result.
+    wlmtk_fsm_init(&fsm, test_transitions, 2);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, fsm.table_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_fsm_event(&fsm, 100, &called));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_fsm_event(&fsm, 101, &called));
+    BS_TEST_VERIFY_EQ(test_ptr, 3, fsm.state);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests FSM with transitions that don't fit the compiled table. */
+void test_uncompiled(bs_test_t *test_ptr)
+{
+    wlmtk_fsm_t fsm;
+    bool called = false;
+
+    wlmtk_fsm_init_table(&fsm, &test_large_table, 1);
+    BS_TEST_VERIFY_FALSE(test_ptr, test_large_table.compiled);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, fsm.table_ptr);
+
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_fsm_event(&fsm, 100, &called));
+    BS_TEST_VERIFY_EQ(test_ptr, 200, fsm.state);
+    BS_TEST_VERIFY_TRUE(test_ptr, called);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_fsm_event(&fsm, 100, &called));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_fsm_event(&fsm, 101, &called));
+    BS_TEST_VERIFY_EQ(test_ptr, 3, fsm.state);
 }
 
 /* == End of fsm.c ========================================================= */
@@ -31,8 +31,44 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "alloctrack.h"
+
 /* == Declarations ========================================================= */
 
+/** Number of size buckets in the buffer pool. */
+#define WLMTK_GFXBUF_POOL_BUCKETS 80
+
+/**
+ * Pixel storage of a graphics buffer, recycled through the pool.
+ *
+ * Capacities are quantized: Each power of two is split into 4 buckets, so
+ * a storage is at most 25% larger than requested.
+ */
+typedef struct {
+    /** Node in the pool's bucket list, while the storage is free. */
+    bs_dllist_node_t          bucket_dlnode;
+    /** Node in the pool's least-recently-released list, while free. */
+    bs_dllist_node_t          lru_dlnode;
+    /** Bucket index. @ref WLMTK_GFXBUF_POOL_BUCKETS if not pooled. */
+    size_t                    bucket;
+    /** Capacity, in pixels. */
+    size_t                    capacity;
+    /** The pixels. */
+    uint32_t                  data[];
+} wlmaker_gfxbuf_storage_t;
+
+/** State of the buffer pool. */
+typedef struct {
+    /** Free storages, per bucket. Most recently released first. */
+    bs_dllist_t               buckets[WLMTK_GFXBUF_POOL_BUCKETS];
+    /** All free storages, least recently released first. */
+    bs_dllist_t               lru;
+    /** Limit for @ref wlmtk_gfxbuf_pool_stats_t::cached_bytes. */
+    size_t                    max_cached_bytes;
+    /** Statistics. */
+    wlmtk_gfxbuf_pool_stats_t stats;
+} wlmaker_gfxbuf_pool_t;
+
 /** State of the wrapped graphics buffer. */
 typedef struct {
     /** The wlroots buffer. */
@@ -40,8 +76,28 @@ typedef struct {
 
     /** The actual graphics buffer. */
     bs_gfxbuf_t               *gfxbuf_ptr;
+    /** Storage backing `gfxbuf_ptr`. */
+    wlmaker_gfxbuf_storage_t  *storage_ptr;
+
+    /** Whether the pixels are accounted, see @ref wlmtk_memstat_add. */
+    bool                      accounted;
+    /** Subsystem the pixels are accounted to. */
+    wlmtk_memstat_subsystem_t subsystem;
 } wlmaker_gfxbuf_t;
 
+static struct wlr_buffer *_wlmaker_gfxbuf_create(
+    unsigned width,
+    unsigned height,
+    bool clear);
+static size_t _wlmaker_gfxbuf_pool_bucket_capacity(size_t bucket);
+static size_t _wlmaker_gfxbuf_pool_bucket(size_t pixels);
+static wlmaker_gfxbuf_storage_t *_wlmaker_gfxbuf_pool_acquire(
+    size_t pixels,
+    bool *reused_ptr);
+static void _wlmaker_gfxbuf_pool_release(
+    wlmaker_gfxbuf_storage_t *storage_ptr);
+static void _wlmaker_gfxbuf_pool_trim(size_t max_cached_bytes);
+
 static wlmaker_gfxbuf_t *wlmaker_gfxbuf_from_wlr_buffer(
     struct wlr_buffer *wlr_buffer_ptr);
 
@@ -63,6 +119,11 @@ static const struct wlr_buffer_impl wlmaker_gfxbuf_impl = {
     .end_data_ptr_access = wlmaker_gfxbuf_impl_end_data_ptr_access
 };
 
+/** The buffer pool. */
+static wlmaker_gfxbuf_pool_t _wlmaker_gfxbuf_pool = {
+    .max_cached_bytes = WLMTK_GFXBUF_POOL_MAX_CACHED_BYTES
+};
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -70,22 +131,51 @@ struct wlr_buffer *bs_gfxbuf_create_wlr_buffer(
     unsigned width,
     unsigned height)
 {
-    wlmaker_gfxbuf_t *gfxbuf_ptr = logged_calloc(1, sizeof(wlmaker_gfxbuf_t));
-    if (NULL == gfxbuf_ptr) return NULL;
+    struct wlr_buffer *wlr_buffer_ptr = _wlmaker_gfxbuf_create(
+        width, height, true);
+    WLMTK_ALLOCTRACK_RECORD(
+        wlr_buffer_ptr, (size_t)width * height * sizeof(uint32_t), "gfxbuf");
+    return wlr_buffer_ptr;
+}
 
-    wlr_buffer_init(
-        &gfxbuf_ptr->wlr_buffer,
-        &wlmaker_gfxbuf_impl,
-        width,
-        height);
+/* ------------------------------------------------------------------------- */
+struct wlr_buffer *bs_gfxbuf_create_wlr_buffer_uncleared(
+    unsigned width,
+    unsigned height)
+{
+    struct wlr_buffer *wlr_buffer_ptr = _wlmaker_gfxbuf_create(
+        width, height, false);
+    WLMTK_ALLOCTRACK_RECORD(
+        wlr_buffer_ptr, (size_t)width * height * sizeof(uint32_t), "gfxbuf");
+    return wlr_buffer_ptr;
+}
 
-    gfxbuf_ptr->gfxbuf_ptr = bs_gfxbuf_create(width, height);
-    if (NULL == gfxbuf_ptr->gfxbuf_ptr) {
-        wlmaker_gfxbuf_impl_destroy(&gfxbuf_ptr->wlr_buffer);
-        return NULL;
-    }
+/* ------------------------------------------------------------------------- */
+void wlmtk_gfxbuf_pool_set_max_cached_bytes(size_t max_cached_bytes)
+{
+    _wlmaker_gfxbuf_pool.max_cached_bytes = max_cached_bytes;
+    _wlmaker_gfxbuf_pool_trim(max_cached_bytes);
+}
 
-    return &gfxbuf_ptr->wlr_buffer;
+/* ------------------------------------------------------------------------- */
+void wlmtk_gfxbuf_pool_trim(void)
+{
+    _wlmaker_gfxbuf_pool_trim(0);
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_gfxbuf_pool_evict(unsigned percent)
+{
+    size_t initial_bytes = _wlmaker_gfxbuf_pool.stats.cached_bytes;
+    _wlmaker_gfxbuf_pool_trim(
+        initial_bytes / 100 * (100 - BS_MIN(percent, 100u)));
+    return initial_bytes - _wlmaker_gfxbuf_pool.stats.cached_bytes;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_gfxbuf_pool_get_stats(wlmtk_gfxbuf_pool_stats_t *stats_ptr)
+{
+    *stats_ptr = _wlmaker_gfxbuf_pool.stats;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -96,6 +186,29 @@ void wlr_buffer_drop_nullify(struct wlr_buffer **wlr_buffer_ptr_ptr)
     *wlr_buffer_ptr_ptr = NULL;
 }
 
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_gfxbuf_wlr_buffer_bytes(const struct wlr_buffer *wlr_buffer_ptr)
+{
+    if (NULL == wlr_buffer_ptr) return 0;
+    return (size_t)wlr_buffer_ptr->width * (size_t)wlr_buffer_ptr->height *
+        sizeof(uint32_t);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_gfxbuf_set_memstat_subsystem(
+    struct wlr_buffer *wlr_buffer_ptr,
+    wlmtk_memstat_subsystem_t subsystem)
+{
+    wlmaker_gfxbuf_t *gfxbuf_ptr = wlmaker_gfxbuf_from_wlr_buffer(
+        wlr_buffer_ptr);
+    if (!gfxbuf_ptr->accounted || gfxbuf_ptr->subsystem == subsystem) return;
+
+    size_t bytes = wlmtk_gfxbuf_wlr_buffer_bytes(wlr_buffer_ptr);
+    wlmtk_memstat_remove(gfxbuf_ptr->subsystem, NULL, bytes);
+    gfxbuf_ptr->subsystem = subsystem;
+    wlmtk_memstat_add(gfxbuf_ptr->subsystem, NULL, bytes);
+}
+
 /* ------------------------------------------------------------------------- */
 bs_gfxbuf_t *bs_gfxbuf_from_wlr_buffer(
     struct wlr_buffer *wlr_buffer_ptr)
@@ -114,6 +227,178 @@ cairo_t *cairo_create_from_wlr_buffer(struct wlr_buffer *wlr_buffer_ptr)
 
 /* == Local (static) methods =============================================== */
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates a wlroots buffer backed by a graphics buffer with storage from the
+ * pool.
+ *
+ * @param width
+ * @param height
+ * @param clear               Whether to clear the pixels, if the storage is
+ *                            re-used. Fresh storage is always cleared.
+ *
+ * @return A struct wlr_buffer, or NULL on error.
+ */
+struct wlr_buffer *_wlmaker_gfxbuf_create(
+    unsigned width,
+    unsigned height,
+    bool clear)
+{
+    wlmaker_gfxbuf_t *gfxbuf_ptr = logged_calloc(1, sizeof(wlmaker_gfxbuf_t));
+    if (NULL == gfxbuf_ptr) return NULL;
+
+    wlr_buffer_init(
+        &gfxbuf_ptr->wlr_buffer,
+        &wlmaker_gfxbuf_impl,
+        width,
+        height);
+
+    size_t pixels = (size_t)width * (size_t)height;
+    bool reused = false;
+    gfxbuf_ptr->storage_ptr = _wlmaker_gfxbuf_pool_acquire(pixels, &reused);
+    if (NULL == gfxbuf_ptr->storage_ptr) {
+        wlmaker_gfxbuf_impl_destroy(&gfxbuf_ptr->wlr_buffer);
+        return NULL;
+    }
+    if (reused && clear) {
+        memset(gfxbuf_ptr->storage_ptr->data, 0, pixels * sizeof(uint32_t));
+    }
+
+    gfxbuf_ptr->gfxbuf_ptr = bs_gfxbuf_create_unmanaged(
+        width, height, width, gfxbuf_ptr->storage_ptr->data);
+    if (NULL == gfxbuf_ptr->gfxbuf_ptr) {
+        wlmaker_gfxbuf_impl_destroy(&gfxbuf_ptr->wlr_buffer);
+        return NULL;
+    }
+
+    gfxbuf_ptr->accounted = true;
+    wlmtk_memstat_add(
+        gfxbuf_ptr->subsystem, NULL,
+        wlmtk_gfxbuf_wlr_buffer_bytes(&gfxbuf_ptr->wlr_buffer));
+    return &gfxbuf_ptr->wlr_buffer;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return the capacity of `bucket`, in pixels. Starts at 1024 pixels. */
+size_t _wlmaker_gfxbuf_pool_bucket_capacity(size_t bucket)
+{
+    return (size_t)(4 + bucket % 4) << (bucket / 4 + 8);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * @return The smallest bucket holding `pixels`, or
+ *     @ref WLMTK_GFXBUF_POOL_BUCKETS if the size is not pooled.
+ */
+size_t _wlmaker_gfxbuf_pool_bucket(size_t pixels)
+{
+    for (size_t bucket = 0; bucket < WLMTK_GFXBUF_POOL_BUCKETS; ++bucket) {
+        if (pixels <= _wlmaker_gfxbuf_pool_bucket_capacity(bucket)) {
+            return bucket;
+        }
+    }
+    return WLMTK_GFXBUF_POOL_BUCKETS;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Acquires storage for at least `pixels` pixels: Re-uses a free storage of
+ * the matching bucket, or allocates a cleared one.
+ *
+ * @param pixels
+ * @param reused_ptr          Set to whether the storage was re-used, ie. it
+ *                            may hold stale pixels.
+ *
+ * @return Pointer to the storage, or NULL on error.
+ */
+wlmaker_gfxbuf_storage_t *_wlmaker_gfxbuf_pool_acquire(
+    size_t pixels,
+    bool *reused_ptr)
+{
+    wlmaker_gfxbuf_pool_t *pool_ptr = &_wlmaker_gfxbuf_pool;
+    size_t bucket = _wlmaker_gfxbuf_pool_bucket(pixels);
+
+    if (WLMTK_GFXBUF_POOL_BUCKETS > bucket) {
+        bs_dllist_node_t *dlnode_ptr = bs_dllist_pop_front(
+            &pool_ptr->buckets[bucket]);
+        if (NULL != dlnode_ptr) {
+            wlmaker_gfxbuf_storage_t *storage_ptr = BS_CONTAINER_OF(
+                dlnode_ptr, wlmaker_gfxbuf_storage_t, bucket_dlnode);
+            bs_dllist_remove(&pool_ptr->lru, &storage_ptr->lru_dlnode);
+            pool_ptr->stats.cached_buffers--;
+            pool_ptr->stats.cached_bytes -=
+                storage_ptr->capacity * sizeof(uint32_t);
+            pool_ptr->stats.in_use_buffers++;
+            pool_ptr->stats.hits++;
+            *reused_ptr = true;
+            return storage_ptr;
+        }
+        pixels = _wlmaker_gfxbuf_pool_bucket_capacity(bucket);
+    }
+
+    wlmaker_gfxbuf_storage_t *storage_ptr = logged_calloc(
+        1, sizeof(wlmaker_gfxbuf_storage_t) + pixels * sizeof(uint32_t));
+    if (NULL == storage_ptr) return NULL;
+    storage_ptr->bucket = bucket;
+    storage_ptr->capacity = pixels;
+    pool_ptr->stats.in_use_buffers++;
+    pool_ptr->stats.misses++;
+    *reused_ptr = false;
+    return storage_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the storage to the pool, and trims the pool to its limit.
+ *
+ * @param storage_ptr
+ */
+void _wlmaker_gfxbuf_pool_release(wlmaker_gfxbuf_storage_t *storage_ptr)
+{
+    wlmaker_gfxbuf_pool_t *pool_ptr = &_wlmaker_gfxbuf_pool;
+    pool_ptr->stats.in_use_buffers--;
+
+    size_t bytes = storage_ptr->capacity * sizeof(uint32_t);
+    if (WLMTK_GFXBUF_POOL_BUCKETS <= storage_ptr->bucket ||
+        bytes > pool_ptr->max_cached_bytes) {
+        pool_ptr->stats.trimmed++;
+        free(storage_ptr);
+        return;
+    }
+
+    bs_dllist_push_front(&pool_ptr->buckets[storage_ptr->bucket],
+                         &storage_ptr->bucket_dlnode);
+    bs_dllist_push_back(&pool_ptr->lru, &storage_ptr->lru_dlnode);
+    pool_ptr->stats.cached_buffers++;
+    pool_ptr->stats.cached_bytes += bytes;
+    _wlmaker_gfxbuf_pool_trim(pool_ptr->max_cached_bytes);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Frees the least recently released storages, until the pool caches no more
+ * than `max_cached_bytes`.
+ *
+ * @param max_cached_bytes
+ */
+void _wlmaker_gfxbuf_pool_trim(size_t max_cached_bytes)
+{
+    wlmaker_gfxbuf_pool_t *pool_ptr = &_wlmaker_gfxbuf_pool;
+    while (pool_ptr->stats.cached_bytes > max_cached_bytes) {
+        bs_dllist_node_t *dlnode_ptr = bs_dllist_pop_front(&pool_ptr->lru);
+        BS_ASSERT(NULL != dlnode_ptr);
+        wlmaker_gfxbuf_storage_t *storage_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_gfxbuf_storage_t, lru_dlnode);
+        bs_dllist_remove(&pool_ptr->buckets[storage_ptr->bucket],
+                         &storage_ptr->bucket_dlnode);
+        pool_ptr->stats.cached_buffers--;
+        pool_ptr->stats.cached_bytes -=
+            storage_ptr->capacity * sizeof(uint32_t);
+        pool_ptr->stats.trimmed++;
+        free(storage_ptr);
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Returns the @ref wlmaker_gfxbuf_t for `wlr_buffer_ptr`.
@@ -138,7 +423,8 @@ wlmaker_gfxbuf_t *wlmaker_gfxbuf_from_wlr_buffer(
 
 /* ------------------------------------------------------------------------- */
 /**
- * `struct wlr_buffer_impl` callback: Destroys the graphics buffer.
+ * `struct wlr_buffer_impl` callback: Destroys the graphics buffer, and
+ * returns the storage to the pool.
  *
  * This function Will be called only once producer and all consumers of the
  * corresponding wlr_buffer have lifted their locks (references).
@@ -151,10 +437,21 @@ void wlmaker_gfxbuf_impl_destroy(
     wlmaker_gfxbuf_t *gfxbuf_ptr = wlmaker_gfxbuf_from_wlr_buffer(
         wlr_buffer_ptr);
 
+    WLMTK_ALLOCTRACK_RELEASE(wlr_buffer_ptr);
+    if (gfxbuf_ptr->accounted) {
+        wlmtk_memstat_remove(
+            gfxbuf_ptr->subsystem, NULL,
+            wlmtk_gfxbuf_wlr_buffer_bytes(wlr_buffer_ptr));
+        gfxbuf_ptr->accounted = false;
+    }
     if (NULL != gfxbuf_ptr->gfxbuf_ptr) {
         bs_gfxbuf_destroy(gfxbuf_ptr->gfxbuf_ptr);
         gfxbuf_ptr->gfxbuf_ptr = NULL;
     }
+    if (NULL != gfxbuf_ptr->storage_ptr) {
+        _wlmaker_gfxbuf_pool_release(gfxbuf_ptr->storage_ptr);
+        gfxbuf_ptr->storage_ptr = NULL;
+    }
 
     free(gfxbuf_ptr);
 }
@@ -192,4 +489,136 @@ void wlmaker_gfxbuf_impl_end_data_ptr_access(
     // Nothing to do.
 }
 
+/* == Unit tests =========================================================== */
+
+static void test_pool(bs_test_t *test_ptr);
+static void test_pool_trim(bs_test_t *test_ptr);
+static void test_memstat(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_gfxbuf_test_cases[] = {
+    { 1, "pool", test_pool },
+    { 1, "pool_trim", test_pool_trim },
+    { 1, "memstat", test_memstat },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Verifies storage gets re-used within a bucket, and cleared on request. */
+void test_pool(bs_test_t *test_ptr)
+{
+    BS_TEST_VERIFY_EQ(test_ptr, 0, _wlmaker_gfxbuf_pool_bucket(1));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, _wlmaker_gfxbuf_pool_bucket(1024));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, _wlmaker_gfxbuf_pool_bucket(1025));
+    BS_TEST_VERIFY_EQ(test_ptr, 1280, _wlmaker_gfxbuf_pool_bucket_capacity(1));
+    BS_TEST_VERIFY_EQ(test_ptr, 2048, _wlmaker_gfxbuf_pool_bucket_capacity(4));
+
+    wlmtk_gfxbuf_pool_trim();
+    wlmtk_gfxbuf_pool_stats_t stats0, stats;
+    wlmtk_gfxbuf_pool_get_stats(&stats0);
+
+    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(30, 40);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_buffer_ptr);
+    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 30, gfxbuf_ptr->width);
+    BS_TEST_VERIFY_EQ(test_ptr, 40, gfxbuf_ptr->height);
+    bs_gfxbuf_clear(gfxbuf_ptr, 0xff102030);
+    uint32_t *data_ptr = gfxbuf_ptr->data_ptr;
+    wlr_buffer_drop(wlr_buffer_ptr);
+    wlmtk_gfxbuf_pool_get_stats(&stats);
+    BS_TEST_VERIFY_EQ(test_ptr, stats0.cached_buffers + 1,
+                      stats.cached_buffers);
+
+    // Different dimensions, same bucket: Re-used, and not cleared.
+    wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer_uncleared(40, 30);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_buffer_ptr);
+    gfxbuf_ptr = bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, data_ptr, gfxbuf_ptr->data_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 40, gfxbuf_ptr->pixels_per_line);
+    BS_TEST_VERIFY_EQ(test_ptr, 0xff102030, gfxbuf_ptr->data_ptr[0]);
+    wlr_buffer_drop(wlr_buffer_ptr);
+
+    // Re-used, and cleared.
+    wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(40, 30);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_buffer_ptr);
+    gfxbuf_ptr = bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, data_ptr, gfxbuf_ptr->data_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, gfxbuf_ptr->data_ptr[0]);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, gfxbuf_ptr->data_ptr[40 * 30 - 1]);
+    wlr_buffer_drop(wlr_buffer_ptr);
+
+    wlmtk_gfxbuf_pool_get_stats(&stats);
+    BS_TEST_VERIFY_EQ(test_ptr, stats0.hits + 2, stats.hits);
+    BS_TEST_VERIFY_EQ(test_ptr, stats0.misses + 1, stats.misses);
+    BS_TEST_VERIFY_EQ(test_ptr, stats0.in_use_buffers, stats.in_use_buffers);
+    wlmtk_gfxbuf_pool_trim();
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies the pool is trimmed to its limit, oldest storage first. */
+void test_pool_trim(bs_test_t *test_ptr)
+{
+    wlmtk_gfxbuf_pool_trim();
+    wlmtk_gfxbuf_pool_set_max_cached_bytes(5 * 1024 * sizeof(uint32_t));
+
+    struct wlr_buffer *b1_ptr = bs_gfxbuf_create_wlr_buffer(32, 32);
+    struct wlr_buffer *b2_ptr = bs_gfxbuf_create_wlr_buffer(64, 64);
+    struct wlr_buffer *b3_ptr = bs_gfxbuf_create_wlr_buffer(32, 32);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, b1_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, b2_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, b3_ptr);
+
+    wlmtk_gfxbuf_pool_stats_t stats;
+    wlr_buffer_drop(b1_ptr);
+    wlr_buffer_drop(b2_ptr);
+    wlmtk_gfxbuf_pool_get_stats(&stats);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, stats.cached_buffers);
+    BS_TEST_VERIFY_EQ(test_ptr, 5 * 1024 * sizeof(uint32_t),
+                      stats.cached_bytes);
+
+    // Exceeds the limit: b1 was released first, and gets trimmed.
+    wlr_buffer_drop(b3_ptr);
+    wlmtk_gfxbuf_pool_get_stats(&stats);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, stats.cached_buffers);
+    BS_TEST_VERIFY_EQ(test_ptr, 5 * 1024 * sizeof(uint32_t),
+                      stats.cached_bytes);
+
+    // Evicting half: b2 is the oldest, and frees more than half.
+    BS_TEST_VERIFY_EQ(test_ptr, 4 * 1024 * sizeof(uint32_t),
+                      wlmtk_gfxbuf_pool_evict(50));
+    wlmtk_gfxbuf_pool_get_stats(&stats);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats.cached_buffers);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_gfxbuf_pool_evict(0));
+
+    wlmtk_gfxbuf_pool_trim();
+    wlmtk_gfxbuf_pool_get_stats(&stats);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, stats.cached_buffers);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, stats.cached_bytes);
+    wlmtk_gfxbuf_pool_set_max_cached_bytes(
+        WLMTK_GFXBUF_POOL_MAX_CACHED_BYTES);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies buffers are accounted, and moved to the tagged subsystem. */
+void test_memstat(bs_test_t *test_ptr)
+{
+    wlmtk_memstat_stats_t u, m, initial_u, initial_m;
+    wlmtk_memstat_get_stats(WLMTK_MEMSTAT_UNTAGGED, &initial_u);
+    wlmtk_memstat_get_stats(WLMTK_MEMSTAT_MENUS, &initial_m);
+
+    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(4, 2);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_buffer_ptr);
+    wlmtk_memstat_get_stats(WLMTK_MEMSTAT_UNTAGGED, &u);
+    BS_TEST_VERIFY_EQ(test_ptr, initial_u.bytes + 32, u.bytes);
+
+    wlmtk_gfxbuf_set_memstat_subsystem(wlr_buffer_ptr, WLMTK_MEMSTAT_MENUS);
+    wlmtk_memstat_get_stats(WLMTK_MEMSTAT_UNTAGGED, &u);
+    BS_TEST_VERIFY_EQ(test_ptr, initial_u.bytes, u.bytes);
+    wlmtk_memstat_get_stats(WLMTK_MEMSTAT_MENUS, &m);
+    BS_TEST_VERIFY_EQ(test_ptr, initial_m.bytes + 32, m.bytes);
+
+    wlr_buffer_drop(wlr_buffer_ptr);
+    wlmtk_memstat_get_stats(WLMTK_MEMSTAT_MENUS, &m);
+    BS_TEST_VERIFY_EQ(test_ptr, initial_m.bytes, m.bytes);
+}
+
 /* == End of gfxbuf.c ====================================================== */
@@ -21,27 +21,236 @@
 #include "image.h"
 
 #include <cairo.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
 #include <libbase/libbase.h>
+#include <limits.h>
+#include <pthread.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <wayland-server-core.h>
 
 #include "buffer.h"
 #include "gfxbuf.h"  // IWYU pragma: keep
 
 /* == Declarations ========================================================= */
 
+typedef struct _wlmtk_image_job_t wlmtk_image_job_t;
+typedef struct _wlmtk_image_shared_t _wlmtk_image_shared_t;
+
 /** State of the image. */
 struct _wlmtk_image_t {
     /** The image's superclass: A buffer. */
     wlmtk_buffer_t            super_buffer;
     /** The superclass' virtual method table. */
     wlmtk_element_vmt_t       orig_element_vmt;
+    /** Pending decode job, while the image shows the placeholder. */
+    wlmtk_image_job_t         *job_ptr;
+    /** Buffer pixels per logical pixel. */
+    double                    scale;
+    /** The shared buffer currently shown. */
+    _wlmtk_image_shared_t     *shared_ptr;
+};
+
+/** A decode job, for a decoder thread. */
+struct _wlmtk_image_job_t {
+    /** Element of @ref _wlmtk_image_decoder_t::pending or `done`. */
+    bs_dllist_node_t          dlnode;
+    /** Path of the image file. */
+    char                      *path_ptr;
+    /** Desired width. */
+    int                       width;
+    /** Desired height. */
+    int                       height;
+    /** Result of the decoder thread. NULL on error. */
+    cairo_surface_t           *surface_ptr;
+    /** Modification time of the file, as decoded by the decoder thread. */
+    struct timespec           mtime;
+    /** The image to update. Only on the main thread, NULL if destroyed. */
+    wlmtk_image_t             *image_ptr;
+};
+
+/** Key of a cache entry: Images are identified by file version and size. */
+typedef struct {
+    /** Path of the image file. */
+    const char                *path_ptr;
+    /** Modification time of the file, as of decoding. */
+    struct timespec           mtime;
+    /** Desired width. */
+    int                       width;
+    /** Desired height. */
+    int                       height;
+} _wlmtk_image_cache_key_t;
+
+/** An entry of the decoded-image cache. */
+typedef struct {
+    /** Node of @ref _wlmtk_image_cache_t::tree_ptr. */
+    bs_avltree_node_t         avlnode;
+    /** Node of @ref _wlmtk_image_cache_t::lru, least recently used first. */
+    bs_dllist_node_t          dlnode;
+    /** The key. Holds a copy of the path. */
+    _wlmtk_image_cache_key_t  key;
+    /** The decoded and scaled image. */
+    cairo_surface_t           *surface_ptr;
+} _wlmtk_image_cache_entry_t;
+
+/**
+ * A buffer with decoded contents, shared by all images of the same key.
+ * Only used on the main thread.
+ */
+struct _wlmtk_image_shared_t {
+    /** Node of @ref _wlmtk_image_shared_tree_ptr. */
+    bs_avltree_node_t         avlnode;
+    /** The key. Holds a copy of the path. An empty path for placeholders. */
+    _wlmtk_image_cache_key_t  key;
+    /** The buffer. */
+    struct wlr_buffer         *wlr_buffer_ptr;
+    /** Number of images using this buffer. */
+    int                       references;
 };
 
-struct wlr_buffer *_wlmtk_image_create_wlr_buffer_from_image(
+/** Cache of decoded & scaled images, shared by the main & decoder threads. */
+typedef struct {
+    /** Guards all members. */
+    pthread_mutex_t           mutex;
+    /** The entries, by @ref _wlmtk_image_cache_key_t. */
+    bs_avltree_t              *tree_ptr;
+    /** The entries, in order of use. Evicted from the head. */
+    bs_dllist_t               lru;
+    /** Total bytes of the entries' pixels. */
+    size_t                    bytes;
+    /** Directory of the on-disk cache. NULL if disabled. */
+    char                      *dir_ptr;
+    /** Number of images loaded from the on-disk cache. */
+    size_t                    disk_hits;
+} _wlmtk_image_cache_t;
+
+/**
+ * Header of an on-disk cache file. Followed by the source path (without
+ * terminating NUL), padding up to @ref _wlmtk_image_disk_alignment, and the
+ * ARGB8888 pixels, in the same layout as a `bs_gfxbuf_t`.
+ */
+typedef struct {
+    /** See @ref _wlmtk_image_disk_magic. */
+    char                      magic[8];
+    /** Modification time of the source file, seconds. */
+    int64_t                   mtime_sec;
+    /** Modification time of the source file, nanoseconds. */
+    int64_t                   mtime_nsec;
+    /** Size of the source file, in bytes. */
+    uint64_t                  size;
+    /** Width, as requested to @ref wlmtk_image_create_scaled. */
+    int32_t                   requested_width;
+    /** Height, as requested to @ref wlmtk_image_create_scaled. */
+    int32_t                   requested_height;
+    /** Width of the pixels. */
+    int32_t                   width;
+    /** Height of the pixels. */
+    int32_t                   height;
+    /** Bytes per line of pixels. */
+    uint32_t                  stride;
+    /** Length of the source path following the header. */
+    uint32_t                  path_len;
+} _wlmtk_image_disk_header_t;
+
+/** A memory-mapped cache file, for releasing along with the surface. */
+typedef struct {
+    /** Start of the mapping. */
+    void                      *data_ptr;
+    /** Size of the mapping. */
+    size_t                    size;
+} _wlmtk_image_disk_mapping_t;
+
+/** Decoder threads, and the queues for their jobs. */
+typedef struct {
+    /** Guards `pending`, `done` and `shutdown`. */
+    pthread_mutex_t           mutex;
+    /** Signals that `pending` has jobs, or `shutdown` was set. */
+    pthread_cond_t            cond;
+    /** Jobs waiting for a decoder thread. */
+    bs_dllist_t               pending;
+    /** Jobs decoded, waiting to be applied on the main thread. */
+    bs_dllist_t               done;
+    /** Tells the decoder threads to exit. */
+    bool                      shutdown;
+    /** The decoder threads. */
+    pthread_t                 threads[2];
+    /** Number of threads that were started. */
+    size_t                    num_threads;
+    /** Event file descriptor, signalled when jobs are done. */
+    int                       event_fd;
+    /** Event source for `event_fd`. */
+    struct wl_event_source    *event_source_ptr;
+} _wlmtk_image_decoder_t;
+
+static cairo_surface_t *_wlmtk_image_load(
+    const char *path_ptr,
+    int width,
+    int height,
+    struct timespec *mtime_ptr);
+static cairo_surface_t *_wlmtk_image_decode(
+    const char *path_ptr,
+    int width,
+    int height);
+static bool _wlmtk_image_disk_fname(
+    const char *dir_ptr,
     const char *path_ptr,
     int width,
+    int height,
+    char *buf_ptr,
+    size_t size);
+static cairo_surface_t *_wlmtk_image_disk_read(
+    const char *fname_ptr,
+    const char *path_ptr,
+    const struct stat *stat_ptr,
+    int width,
     int height);
+static void _wlmtk_image_disk_write(
+    const char *fname_ptr,
+    const char *path_ptr,
+    const struct stat *stat_ptr,
+    int width,
+    int height,
+    cairo_surface_t *surface_ptr);
+static void _wlmtk_image_disk_unmap(void *data_ptr);
+struct wlr_buffer *_wlmtk_image_create_wlr_buffer_from_surface(
+    cairo_surface_t *surface_ptr);
+
+static _wlmtk_image_shared_t *_wlmtk_image_shared_acquire(
+    const _wlmtk_image_cache_key_t *key_ptr,
+    cairo_surface_t *surface_ptr);
+static void _wlmtk_image_shared_release(_wlmtk_image_shared_t *shared_ptr);
+static void _wlmtk_image_set_shared(
+    wlmtk_image_t *image_ptr,
+    _wlmtk_image_shared_t *shared_ptr);
+static int _wlmtk_image_shared_cmp(
+    const bs_avltree_node_t *avlnode_ptr,
+    const void *key_ptr);
+
+static int _wlmtk_image_key_cmp(
+    const _wlmtk_image_cache_key_t *k1_ptr,
+    const _wlmtk_image_cache_key_t *k2_ptr);
+static int _wlmtk_image_cache_cmp(
+    const bs_avltree_node_t *avlnode_ptr,
+    const void *key_ptr);
+static void _wlmtk_image_cache_entry_destroy(bs_avltree_node_t *avlnode_ptr);
+static size_t _wlmtk_image_surface_bytes(cairo_surface_t *surface_ptr);
+
+static void *_wlmtk_image_decoder_thread(void *arg_ptr);
+static int _wlmtk_image_decoder_handle_event(
+    int fd,
+    uint32_t mask,
+    void *data_ptr);
+static void _wlmtk_image_decoder_stop(void);
+static void _wlmtk_image_job_apply(wlmtk_image_job_t *job_ptr);
 
 static void _wlmtk_image_element_destroy(wlmtk_element_t *element_ptr);
 
@@ -52,6 +261,35 @@ static const wlmtk_element_vmt_t _wlmtk_image_element_vmt = {
     .destroy = _wlmtk_image_element_destroy,
 };
 
+/** Magic bytes of an on-disk cache file. Last byte is the version. */
+static const char _wlmtk_image_disk_magic[8] = "WLMICO\0\1";
+
+/** Alignment of the pixels within an on-disk cache file. */
+static const size_t _wlmtk_image_disk_alignment = 16;
+
+/** Key for attaching the @ref _wlmtk_image_disk_mapping_t to a surface. */
+static const cairo_user_data_key_t _wlmtk_image_disk_mapping_key;
+
+/** Maximum number of decoded images to keep in the cache. */
+static const size_t _wlmtk_image_cache_max_entries = 128;
+/** Maximum total bytes of decoded images to keep in the cache. */
+static const size_t _wlmtk_image_cache_max_bytes = 64 << 20;
+
+/** Tree of @ref _wlmtk_image_shared_t. Created on first use. */
+static bs_avltree_t *_wlmtk_image_shared_tree_ptr = NULL;
+
+/** The cache of decoded images. */
+static _wlmtk_image_cache_t _wlmtk_image_cache = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER
+};
+
+/** The decoder. Has no threads, unless @ref wlmtk_image_defer_decode. */
+static _wlmtk_image_decoder_t _wlmtk_image_decoder = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+    .event_fd = -1
+};
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -66,8 +304,20 @@ wlmtk_image_t *wlmtk_image_create_scaled(
     int width,
     int height)
 {
+    return wlmtk_image_create_scaled_at(image_path_ptr, width, height, 1.0);
+}
+
+/* ------------------------------------------------------------------------- */
+wlmtk_image_t *wlmtk_image_create_scaled_at(
+    const char *image_path_ptr,
+    int width,
+    int height,
+    double scale)
+{
+    BS_ASSERT(0 < scale);
     wlmtk_image_t *image_ptr = logged_calloc(1, sizeof(wlmtk_image_t));
     if (NULL == image_ptr) return NULL;
+    image_ptr->scale = scale;
 
     if (!wlmtk_buffer_init(&image_ptr->super_buffer)) {
         wlmtk_image_destroy(image_ptr);
@@ -77,23 +327,70 @@ wlmtk_image_t *wlmtk_image_create_scaled(
         wlmtk_image_element(image_ptr),
         &_wlmtk_image_element_vmt);
 
-    struct wlr_buffer *wlr_buffer_ptr =
-        _wlmtk_image_create_wlr_buffer_from_image(
-            image_path_ptr, width, height);
-    if (NULL == wlr_buffer_ptr) {
+    _wlmtk_image_cache_key_t key = { .path_ptr = "" };
+    if (0 < width) key.width = width * scale + 0.5;
+    if (0 < height) key.height = height * scale + 0.5;
+
+    // With decoder threads, show a placeholder until the image is decoded.
+    // That requires knowing the size upfront.
+    cairo_surface_t *surface_ptr = NULL;
+    if (0 < _wlmtk_image_decoder.num_threads &&
+        0 < key.width && 0 < key.height) {
+        wlmtk_image_job_t *job_ptr = logged_calloc(
+            1, sizeof(wlmtk_image_job_t));
+        if (NULL == job_ptr) {
+            wlmtk_image_destroy(image_ptr);
+            return NULL;
+        }
+        job_ptr->path_ptr = logged_strdup(image_path_ptr);
+        if (NULL == job_ptr->path_ptr) {
+            free(job_ptr);
+            wlmtk_image_destroy(image_ptr);
+            return NULL;
+        }
+        job_ptr->width = key.width;
+        job_ptr->height = key.height;
+        job_ptr->image_ptr = image_ptr;
+        image_ptr->job_ptr = job_ptr;
+
+        pthread_mutex_lock(&_wlmtk_image_decoder.mutex);
+        bs_dllist_push_back(&_wlmtk_image_decoder.pending, &job_ptr->dlnode);
+        pthread_cond_signal(&_wlmtk_image_decoder.cond);
+        pthread_mutex_unlock(&_wlmtk_image_decoder.mutex);
+    } else {
+        surface_ptr = _wlmtk_image_load(
+            image_path_ptr, key.width, key.height, &key.mtime);
+        if (NULL == surface_ptr) {
+            wlmtk_image_destroy(image_ptr);
+            return NULL;
+        }
+        key.path_ptr = image_path_ptr;
+    }
+
+    _wlmtk_image_shared_t *shared_ptr = _wlmtk_image_shared_acquire(
+        &key, surface_ptr);
+    if (NULL != surface_ptr) cairo_surface_destroy(surface_ptr);
+    if (NULL == shared_ptr) {
         wlmtk_image_destroy(image_ptr);
         return NULL;
     }
-    wlmtk_buffer_set(&image_ptr->super_buffer, wlr_buffer_ptr);
-    wlr_buffer_drop(wlr_buffer_ptr);
-
+    _wlmtk_image_set_shared(image_ptr, shared_ptr);
     return image_ptr;
 }
 
 /* ------------------------------------------------------------------------- */
 void wlmtk_image_destroy(wlmtk_image_t *image_ptr)
 {
+    // The job is owned by the decoder. It'll be discarded once done.
+    if (NULL != image_ptr->job_ptr) {
+        image_ptr->job_ptr->image_ptr = NULL;
+        image_ptr->job_ptr = NULL;
+    }
     wlmtk_buffer_fini(&image_ptr->super_buffer);
+    if (NULL != image_ptr->shared_ptr) {
+        _wlmtk_image_shared_release(image_ptr->shared_ptr);
+        image_ptr->shared_ptr = NULL;
+    }
     free(image_ptr);
 }
 
@@ -103,12 +400,416 @@ wlmtk_element_t *wlmtk_image_element(wlmtk_image_t *image_ptr)
     return wlmtk_buffer_element(&image_ptr->super_buffer);
 }
 
+/* ------------------------------------------------------------------------- */
+bool wlmtk_image_defer_decode(struct wl_event_loop *wl_event_loop_ptr)
+{
+    _wlmtk_image_decoder_t *decoder_ptr = &_wlmtk_image_decoder;
+    _wlmtk_image_decoder_stop();
+    if (NULL == wl_event_loop_ptr) return true;
+
+    decoder_ptr->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (0 > decoder_ptr->event_fd) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed eventfd(0, %d)",
+               EFD_CLOEXEC | EFD_NONBLOCK);
+        return false;
+    }
+    decoder_ptr->event_source_ptr = wl_event_loop_add_fd(
+        wl_event_loop_ptr,
+        decoder_ptr->event_fd,
+        WL_EVENT_READABLE,
+        _wlmtk_image_decoder_handle_event,
+        NULL);
+    if (NULL == decoder_ptr->event_source_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_fd(%p, %d, ...)",
+               wl_event_loop_ptr, decoder_ptr->event_fd);
+        _wlmtk_image_decoder_stop();
+        return false;
+    }
+
+    decoder_ptr->shutdown = false;
+    for (size_t i = 0;
+         i < sizeof(decoder_ptr->threads) / sizeof(pthread_t);
+         ++i) {
+        int rv = pthread_create(
+            &decoder_ptr->threads[i], NULL, _wlmtk_image_decoder_thread,
+            decoder_ptr);
+        if (0 != rv) {
+            errno = rv;
+            bs_log(BS_ERROR | BS_ERRNO, "Failed pthread_create()");
+            _wlmtk_image_decoder_stop();
+            return false;
+        }
+        ++decoder_ptr->num_threads;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_image_set_cache_dir(const char *dir_ptr)
+{
+    char *new_dir_ptr = NULL;
+    if (NULL != dir_ptr) {
+        new_dir_ptr = logged_strdup(dir_ptr);
+        if (NULL == new_dir_ptr) return false;
+    }
+
+    pthread_mutex_lock(&_wlmtk_image_cache.mutex);
+    if (NULL != _wlmtk_image_cache.dir_ptr) free(_wlmtk_image_cache.dir_ptr);
+    _wlmtk_image_cache.dir_ptr = new_dir_ptr;
+    pthread_mutex_unlock(&_wlmtk_image_cache.mutex);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_image_cache_flush(void)
+{
+    pthread_mutex_lock(&_wlmtk_image_cache.mutex);
+    if (NULL != _wlmtk_image_cache.tree_ptr) {
+        bs_avltree_destroy(_wlmtk_image_cache.tree_ptr);
+        _wlmtk_image_cache.tree_ptr = NULL;
+    }
+    _wlmtk_image_cache.lru = (bs_dllist_t){};
+    _wlmtk_image_cache.bytes = 0;
+    pthread_mutex_unlock(&_wlmtk_image_cache.mutex);
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_image_cache_evict(unsigned percent)
+{
+    _wlmtk_image_cache_t *cache_ptr = &_wlmtk_image_cache;
+    pthread_mutex_lock(&cache_ptr->mutex);
+    size_t initial_bytes = cache_ptr->bytes;
+    size_t max_bytes = initial_bytes / 100 * (100 - BS_MIN(percent, 100u));
+    while (cache_ptr->bytes > max_bytes &&
+           0 < bs_dllist_size(&cache_ptr->lru)) {
+        _wlmtk_image_cache_entry_t *lru_entry_ptr = BS_CONTAINER_OF(
+            bs_dllist_pop_front(&cache_ptr->lru),
+            _wlmtk_image_cache_entry_t, dlnode);
+        bs_avltree_delete(cache_ptr->tree_ptr, &lru_entry_ptr->key);
+        cache_ptr->bytes -= _wlmtk_image_surface_bytes(
+            lru_entry_ptr->surface_ptr);
+        _wlmtk_image_cache_entry_destroy(&lru_entry_ptr->avlnode);
+    }
+    size_t bytes = initial_bytes - cache_ptr->bytes;
+    pthread_mutex_unlock(&cache_ptr->mutex);
+    return bytes;
+}
+
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
 /**
- * Creates a wlr_buffer that holds the image loaded from path, at that image's
- * size.
+ * Loads the image at `path_ptr`, from the cache if it holds a decoded image
+ * of the same file version and size. Safe to call from any thread.
+ *
+ * @param path_ptr
+ * @param width
+ * @param height
+ *
+ * @return A reference to the cairo image surface, or NULL on error. Must be
+ *     released by calling cairo_surface_destroy().
+ */
+cairo_surface_t *_wlmtk_image_load(
+    const char *path_ptr,
+    int width,
+    int height,
+    struct timespec *mtime_ptr)
+{
+    _wlmtk_image_cache_t *cache_ptr = &_wlmtk_image_cache;
+    struct stat statbuf;
+    if (0 != stat(path_ptr, &statbuf)) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed stat(%s, %p)", path_ptr, &statbuf);
+        return NULL;
+    }
+    _wlmtk_image_cache_key_t key = {
+        .path_ptr = path_ptr,
+        .mtime = statbuf.st_mtim,
+        .width = width,
+        .height = height
+    };
+    *mtime_ptr = statbuf.st_mtim;
+
+    pthread_mutex_lock(&cache_ptr->mutex);
+    cairo_surface_t *surface_ptr = NULL;
+    bs_avltree_node_t *avlnode_ptr = NULL;
+    if (NULL != cache_ptr->tree_ptr) {
+        avlnode_ptr = bs_avltree_lookup(cache_ptr->tree_ptr, &key);
+    }
+    if (NULL != avlnode_ptr) {
+        _wlmtk_image_cache_entry_t *entry_ptr = BS_CONTAINER_OF(
+            avlnode_ptr, _wlmtk_image_cache_entry_t, avlnode);
+        bs_dllist_remove(&cache_ptr->lru, &entry_ptr->dlnode);
+        bs_dllist_push_back(&cache_ptr->lru, &entry_ptr->dlnode);
+        surface_ptr = cairo_surface_reference(entry_ptr->surface_ptr);
+    }
+    char fname[PATH_MAX];
+    bool disk = NULL != cache_ptr->dir_ptr && _wlmtk_image_disk_fname(
+        cache_ptr->dir_ptr, path_ptr, width, height, fname, sizeof(fname));
+    pthread_mutex_unlock(&cache_ptr->mutex);
+    if (NULL != surface_ptr) return surface_ptr;
+
+    // Read or decode without holding the lock. Concurrent loads of the same
+    // image may both decode it, only the first one will be kept.
+    if (disk) {
+        surface_ptr = _wlmtk_image_disk_read(
+            fname, path_ptr, &statbuf, width, height);
+    }
+    if (NULL == surface_ptr) {
+        surface_ptr = _wlmtk_image_decode(path_ptr, width, height);
+        if (NULL == surface_ptr) return NULL;
+        if (disk) {
+            _wlmtk_image_disk_write(
+                fname, path_ptr, &statbuf, width, height, surface_ptr);
+        }
+    } else {
+        pthread_mutex_lock(&cache_ptr->mutex);
+        ++cache_ptr->disk_hits;
+        pthread_mutex_unlock(&cache_ptr->mutex);
+    }
+
+    _wlmtk_image_cache_entry_t *entry_ptr = logged_calloc(
+        1, sizeof(_wlmtk_image_cache_entry_t));
+    if (NULL == entry_ptr) return surface_ptr;
+    entry_ptr->key = key;
+    entry_ptr->key.path_ptr = logged_strdup(path_ptr);
+    if (NULL == entry_ptr->key.path_ptr) {
+        free(entry_ptr);
+        return surface_ptr;
+    }
+    entry_ptr->surface_ptr = cairo_surface_reference(surface_ptr);
+
+    pthread_mutex_lock(&cache_ptr->mutex);
+    if (NULL == cache_ptr->tree_ptr) {
+        cache_ptr->tree_ptr = bs_avltree_create(
+            _wlmtk_image_cache_cmp, _wlmtk_image_cache_entry_destroy);
+    }
+    if (NULL != cache_ptr->tree_ptr &&
+        bs_avltree_insert(cache_ptr->tree_ptr, &entry_ptr->key,
+                          &entry_ptr->avlnode, false)) {
+        bs_dllist_push_back(&cache_ptr->lru, &entry_ptr->dlnode);
+        cache_ptr->bytes += _wlmtk_image_surface_bytes(surface_ptr);
+        entry_ptr = NULL;
+        // Evicts, but always keeps the entry just added.
+        while (bs_dllist_size(&cache_ptr->lru) > 1 &&
+               (bs_dllist_size(&cache_ptr->lru) >
+                _wlmtk_image_cache_max_entries ||
+                cache_ptr->bytes > _wlmtk_image_cache_max_bytes)) {
+            _wlmtk_image_cache_entry_t *lru_entry_ptr = BS_CONTAINER_OF(
+                bs_dllist_pop_front(&cache_ptr->lru),
+                _wlmtk_image_cache_entry_t, dlnode);
+            bs_avltree_delete(cache_ptr->tree_ptr, &lru_entry_ptr->key);
+            cache_ptr->bytes -= _wlmtk_image_surface_bytes(
+                lru_entry_ptr->surface_ptr);
+            _wlmtk_image_cache_entry_destroy(&lru_entry_ptr->avlnode);
+        }
+    }
+    pthread_mutex_unlock(&cache_ptr->mutex);
+    if (NULL != entry_ptr) {
+        _wlmtk_image_cache_entry_destroy(&entry_ptr->avlnode);
+    }
+    return surface_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Composes the name of the on-disk cache file, from a FNV-1a hash of path
+ * and requested size.
+ *
+ * @param dir_ptr
+ * @param path_ptr
+ * @param width
+ * @param height
+ * @param buf_ptr
+ * @param size
+ *
+ * @return true on success.
+ */
+bool _wlmtk_image_disk_fname(
+    const char *dir_ptr,
+    const char *path_ptr,
+    int width,
+    int height,
+    char *buf_ptr,
+    size_t size)
+{
+    uint64_t hash = UINT64_C(14695981039346656037);
+    for (const char *c_ptr = path_ptr; *c_ptr != '\0'; ++c_ptr) {
+        hash = (hash ^ (uint8_t)*c_ptr) * UINT64_C(1099511628211);
+    }
+    int rv = snprintf(buf_ptr, size, "%s/%016"PRIx64"-%dx%d.icon",
+                      dir_ptr, hash, width, height);
+    return 0 <= rv && (size_t)rv < size;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Maps the pixels of an on-disk cache file into a cairo image surface, if
+ * the file is valid for `path_ptr` at the requested size.
+ *
+ * @param fname_ptr
+ * @param path_ptr
+ * @param stat_ptr            Status of `path_ptr`.
+ * @param width
+ * @param height
+ *
+ * @return A cairo image surface, backed by the mapped file. NULL if the file
+ *     was absent, stale or invalid.
+ */
+cairo_surface_t *_wlmtk_image_disk_read(
+    const char *fname_ptr,
+    const char *path_ptr,
+    const struct stat *stat_ptr,
+    int width,
+    int height)
+{
+    int fd = open(fname_ptr, O_RDONLY | O_CLOEXEC);
+    if (0 > fd) return NULL;
+    struct stat cache_stat;
+    if (0 != fstat(fd, &cache_stat) ||
+        (size_t)cache_stat.st_size < sizeof(_wlmtk_image_disk_header_t)) {
+        close(fd);
+        return NULL;
+    }
+    size_t size = cache_stat.st_size;
+    uint8_t *data_ptr = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == data_ptr) return NULL;
+
+    _wlmtk_image_disk_header_t header;
+    memcpy(&header, data_ptr, sizeof(header));
+    size_t path_len = strlen(path_ptr);
+    size_t offset = sizeof(header) + path_len;
+    offset = (offset + _wlmtk_image_disk_alignment - 1) &
+        ~(_wlmtk_image_disk_alignment - 1);
+    if (0 != memcmp(header.magic, _wlmtk_image_disk_magic,
+                    sizeof(header.magic)) ||
+        header.mtime_sec != (int64_t)stat_ptr->st_mtim.tv_sec ||
+        header.mtime_nsec != (int64_t)stat_ptr->st_mtim.tv_nsec ||
+        header.size != (uint64_t)stat_ptr->st_size ||
+        header.requested_width != width ||
+        header.requested_height != height ||
+        0 >= header.width || 0 >= header.height ||
+        header.stride != (uint32_t)cairo_format_stride_for_width(
+            CAIRO_FORMAT_ARGB32, header.width) ||
+        header.path_len != path_len ||
+        offset > size ||
+        (size - offset) / header.stride != (size_t)header.height ||
+        0 != memcmp(data_ptr + sizeof(header), path_ptr, path_len)) {
+        munmap(data_ptr, size);
+        return NULL;
+    }
+
+    _wlmtk_image_disk_mapping_t *mapping_ptr = logged_calloc(
+        1, sizeof(_wlmtk_image_disk_mapping_t));
+    if (NULL == mapping_ptr) {
+        munmap(data_ptr, size);
+        return NULL;
+    }
+    mapping_ptr->data_ptr = data_ptr;
+    mapping_ptr->size = size;
+
+    // The surface is only ever used as a source. A private, read-only
+    // mapping is fine for that.
+    cairo_surface_t *surface_ptr = cairo_image_surface_create_for_data(
+        data_ptr + offset, CAIRO_FORMAT_ARGB32,
+        header.width, header.height, header.stride);
+    if (CAIRO_STATUS_SUCCESS != cairo_surface_status(surface_ptr) ||
+        CAIRO_STATUS_SUCCESS != cairo_surface_set_user_data(
+            surface_ptr, &_wlmtk_image_disk_mapping_key,
+            mapping_ptr, _wlmtk_image_disk_unmap)) {
+        cairo_surface_destroy(surface_ptr);
+        _wlmtk_image_disk_unmap(mapping_ptr);
+        return NULL;
+    }
+    bs_log(BS_DEBUG, "Loaded \"%s\" from cache \"%s\"", path_ptr, fname_ptr);
+    return surface_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Writes the pixels of `surface_ptr` to the on-disk cache file. Writes a
+ * temporary file first, then renames it, so readers never see a partial
+ * file. Failures are not errors, the image will just be decoded again.
+ *
+ * @param fname_ptr
+ * @param path_ptr
+ * @param stat_ptr            Status of `path_ptr`.
+ * @param width
+ * @param height
+ * @param surface_ptr
+ */
+void _wlmtk_image_disk_write(
+    const char *fname_ptr,
+    const char *path_ptr,
+    const struct stat *stat_ptr,
+    int width,
+    int height,
+    cairo_surface_t *surface_ptr)
+{
+    char tmp_fname[PATH_MAX];
+    int rv = snprintf(tmp_fname, sizeof(tmp_fname), "%s.XXXXXX", fname_ptr);
+    if (0 > rv || sizeof(tmp_fname) <= (size_t)rv) return;
+    int fd = mkstemp(tmp_fname);
+    if (0 > fd) {
+        bs_log(BS_DEBUG | BS_ERRNO, "Failed mkstemp(%s)", tmp_fname);
+        return;
+    }
+    FILE *file_ptr = fdopen(fd, "wb");
+    if (NULL == file_ptr) {
+        close(fd);
+        unlink(tmp_fname);
+        return;
+    }
+
+    _wlmtk_image_disk_header_t header = {
+        .mtime_sec = stat_ptr->st_mtim.tv_sec,
+        .mtime_nsec = stat_ptr->st_mtim.tv_nsec,
+        .size = stat_ptr->st_size,
+        .requested_width = width,
+        .requested_height = height,
+        .width = cairo_image_surface_get_width(surface_ptr),
+        .height = cairo_image_surface_get_height(surface_ptr),
+        .stride = cairo_image_surface_get_stride(surface_ptr),
+        .path_len = strlen(path_ptr)
+    };
+    memcpy(header.magic, _wlmtk_image_disk_magic, sizeof(header.magic));
+    size_t offset = sizeof(header) + header.path_len;
+    size_t padding = ((offset + _wlmtk_image_disk_alignment - 1) &
+                      ~(_wlmtk_image_disk_alignment - 1)) - offset;
+    static const uint8_t zeroes[16] = {};
+
+    cairo_surface_flush(surface_ptr);
+    const uint8_t *pixels_ptr = cairo_image_surface_get_data(surface_ptr);
+    bool written =
+        NULL != pixels_ptr &&
+        CAIRO_FORMAT_ARGB32 == cairo_image_surface_get_format(surface_ptr) &&
+        1 == fwrite(&header, sizeof(header), 1, file_ptr) &&
+        header.path_len == fwrite(path_ptr, 1, header.path_len, file_ptr) &&
+        padding == fwrite(zeroes, 1, padding, file_ptr) &&
+        (size_t)header.height == fwrite(
+            pixels_ptr, header.stride, header.height, file_ptr);
+    if (0 != fclose(file_ptr)) written = false;
+
+    if (!written || 0 != rename(tmp_fname, fname_ptr)) {
+        bs_log(BS_DEBUG | BS_ERRNO, "Failed to write cache \"%s\"",
+               fname_ptr);
+        unlink(tmp_fname);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Unmaps and frees the @ref _wlmtk_image_disk_mapping_t. */
+void _wlmtk_image_disk_unmap(void *data_ptr)
+{
+    _wlmtk_image_disk_mapping_t *mapping_ptr = data_ptr;
+    munmap(mapping_ptr->data_ptr, mapping_ptr->size);
+    free(mapping_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Decodes the image from path into a cairo image surface, scaled to the
+ * desired size. Only uses an image surface, hence safe on any thread.
  *
  * @param path_ptr
  * @param width               Desired width of the image. 0 0r negative to use
@@ -116,9 +817,9 @@ wlmtk_element_t *wlmtk_image_element(wlmtk_image_t *image_ptr)
  * @param height              Desired height of the image. 0 0r negative to use
  *                            the image's native height.
  *
- * @return the wlr_buffer or NULL on error.
+ * @return the cairo surface, or NULL on error.
  */
-struct wlr_buffer *_wlmtk_image_create_wlr_buffer_from_image(
+cairo_surface_t *_wlmtk_image_decode(
     const char *path_ptr,
     int width,
     int height)
@@ -128,7 +829,7 @@ struct wlr_buffer *_wlmtk_image_create_wlr_buffer_from_image(
     if (NULL == icon_surface_ptr) {
         bs_log(BS_ERROR, "Failed cairo_image_surface_create_from_png(%s).",
                path_ptr);
-        return false;
+        return NULL;
     }
     if (CAIRO_STATUS_SUCCESS != cairo_surface_status(icon_surface_ptr)) {
         bs_log(BS_ERROR,
@@ -148,17 +849,17 @@ struct wlr_buffer *_wlmtk_image_create_wlr_buffer_from_image(
         h = cairo_image_surface_get_height(icon_surface_ptr);
     }
 
-    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(w, h);
-    if (NULL == wlr_buffer_ptr) {
-        cairo_surface_destroy(icon_surface_ptr);
-        return NULL;
-    }
-    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
-    if (NULL == cairo_ptr) {
-        wlr_buffer_drop(wlr_buffer_ptr);
+    cairo_surface_t *surface_ptr = cairo_image_surface_create(
+        CAIRO_FORMAT_ARGB32, w, h);
+    if (CAIRO_STATUS_SUCCESS != cairo_surface_status(surface_ptr)) {
+        bs_log(BS_ERROR, "Failed cairo_image_surface_create(%d, %d): %s",
+               w, h,
+               cairo_status_to_string(cairo_surface_status(surface_ptr)));
+        cairo_surface_destroy(surface_ptr);
         cairo_surface_destroy(icon_surface_ptr);
         return NULL;
     }
+    cairo_t *cairo_ptr = cairo_create(surface_ptr);
 
     cairo_surface_set_device_scale(
         icon_surface_ptr,
@@ -172,9 +873,339 @@ struct wlr_buffer *_wlmtk_image_create_wlr_buffer_from_image(
 
     cairo_destroy(cairo_ptr);
     cairo_surface_destroy(icon_surface_ptr);
+    cairo_surface_flush(surface_ptr);
+    return surface_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates a wlr_buffer holding a copy of the cairo image surface.
+ *
+ * @param surface_ptr
+ *
+ * @return the wlr_buffer or NULL on error.
+ */
+struct wlr_buffer *_wlmtk_image_create_wlr_buffer_from_surface(
+    cairo_surface_t *surface_ptr)
+{
+    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
+        cairo_image_surface_get_width(surface_ptr),
+        cairo_image_surface_get_height(surface_ptr));
+    if (NULL == wlr_buffer_ptr) return NULL;
+    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
+    if (NULL == cairo_ptr) {
+        wlr_buffer_drop(wlr_buffer_ptr);
+        return NULL;
+    }
+    cairo_set_operator(cairo_ptr, CAIRO_OPERATOR_SOURCE);
+    cairo_set_source_surface(cairo_ptr, surface_ptr, 0, 0);
+    cairo_paint(cairo_ptr);
+    cairo_destroy(cairo_ptr);
     return wlr_buffer_ptr;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Acquires a reference to the shared buffer for `key_ptr`, and creates it if
+ * there is none yet.
+ *
+ * @param key_ptr
+ * @param surface_ptr         Contents for the buffer when creating it. NULL
+ *                            for a transparent placeholder.
+ *
+ * @return The shared buffer, or NULL on error. Must be released by calling
+ *     @ref _wlmtk_image_shared_release.
+ */
+_wlmtk_image_shared_t *_wlmtk_image_shared_acquire(
+    const _wlmtk_image_cache_key_t *key_ptr,
+    cairo_surface_t *surface_ptr)
+{
+    if (NULL == _wlmtk_image_shared_tree_ptr) {
+        _wlmtk_image_shared_tree_ptr = bs_avltree_create(
+            _wlmtk_image_shared_cmp, NULL);
+        if (NULL == _wlmtk_image_shared_tree_ptr) return NULL;
+    }
+
+    bs_avltree_node_t *avlnode_ptr = bs_avltree_lookup(
+        _wlmtk_image_shared_tree_ptr, key_ptr);
+    if (NULL != avlnode_ptr) {
+        _wlmtk_image_shared_t *shared_ptr = BS_CONTAINER_OF(
+            avlnode_ptr, _wlmtk_image_shared_t, avlnode);
+        ++shared_ptr->references;
+        return shared_ptr;
+    }
+
+    _wlmtk_image_shared_t *shared_ptr = logged_calloc(
+        1, sizeof(_wlmtk_image_shared_t));
+    if (NULL == shared_ptr) return NULL;
+    shared_ptr->key = *key_ptr;
+    shared_ptr->key.path_ptr = logged_strdup(key_ptr->path_ptr);
+    if (NULL != surface_ptr) {
+        shared_ptr->wlr_buffer_ptr =
+            _wlmtk_image_create_wlr_buffer_from_surface(surface_ptr);
+    } else {
+        shared_ptr->wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
+            key_ptr->width, key_ptr->height);
+    }
+    if (NULL == shared_ptr->key.path_ptr ||
+        NULL == shared_ptr->wlr_buffer_ptr) {
+        if (NULL != shared_ptr->wlr_buffer_ptr) {
+            wlr_buffer_drop(shared_ptr->wlr_buffer_ptr);
+        }
+        if (NULL != shared_ptr->key.path_ptr) {
+            free((char*)shared_ptr->key.path_ptr);
+        }
+        free(shared_ptr);
+        return NULL;
+    }
+    wlmtk_gfxbuf_set_memstat_subsystem(
+        shared_ptr->wlr_buffer_ptr, WLMTK_MEMSTAT_IMAGES);
+    shared_ptr->references = 1;
+    BS_ASSERT(bs_avltree_insert(
+                  _wlmtk_image_shared_tree_ptr, &shared_ptr->key,
+                  &shared_ptr->avlnode, false));
+    return shared_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Releases a reference. Destroys the shared buffer when unreferenced. */
+void _wlmtk_image_shared_release(_wlmtk_image_shared_t *shared_ptr)
+{
+    if (0 < --shared_ptr->references) return;
+
+    bs_avltree_delete(_wlmtk_image_shared_tree_ptr, &shared_ptr->key);
+    wlr_buffer_drop(shared_ptr->wlr_buffer_ptr);
+    free((char*)shared_ptr->key.path_ptr);
+    free(shared_ptr);
+
+    if (0 == bs_avltree_size(_wlmtk_image_shared_tree_ptr)) {
+        bs_avltree_destroy(_wlmtk_image_shared_tree_ptr);
+        _wlmtk_image_shared_tree_ptr = NULL;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Shows the shared buffer in `image_ptr`, taking over the reference. */
+void _wlmtk_image_set_shared(
+    wlmtk_image_t *image_ptr,
+    _wlmtk_image_shared_t *shared_ptr)
+{
+    wlmtk_buffer_set_scaled(
+        &image_ptr->super_buffer, shared_ptr->wlr_buffer_ptr,
+        image_ptr->scale);
+    if (NULL != image_ptr->shared_ptr) {
+        _wlmtk_image_shared_release(image_ptr->shared_ptr);
+    }
+    image_ptr->shared_ptr = shared_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Compares @ref _wlmtk_image_shared_t against a key. */
+int _wlmtk_image_shared_cmp(
+    const bs_avltree_node_t *avlnode_ptr,
+    const void *key_ptr)
+{
+    return _wlmtk_image_key_cmp(
+        &BS_CONTAINER_OF(avlnode_ptr, _wlmtk_image_shared_t, avlnode)->key,
+        key_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Compares two @ref _wlmtk_image_cache_key_t. */
+int _wlmtk_image_key_cmp(
+    const _wlmtk_image_cache_key_t *k1_ptr,
+    const _wlmtk_image_cache_key_t *k2_ptr)
+{
+    int rv = strcmp(k1_ptr->path_ptr, k2_ptr->path_ptr);
+    if (0 != rv) return rv;
+    if (k1_ptr->mtime.tv_sec != k2_ptr->mtime.tv_sec) {
+        return k1_ptr->mtime.tv_sec < k2_ptr->mtime.tv_sec ? -1 : 1;
+    }
+    if (k1_ptr->mtime.tv_nsec != k2_ptr->mtime.tv_nsec) {
+        return k1_ptr->mtime.tv_nsec < k2_ptr->mtime.tv_nsec ? -1 : 1;
+    }
+    if (k1_ptr->width != k2_ptr->width) {
+        return k1_ptr->width < k2_ptr->width ? -1 : 1;
+    }
+    if (k1_ptr->height != k2_ptr->height) {
+        return k1_ptr->height < k2_ptr->height ? -1 : 1;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Compares @ref _wlmtk_image_cache_entry_t against a key. */
+int _wlmtk_image_cache_cmp(
+    const bs_avltree_node_t *avlnode_ptr,
+    const void *key_ptr)
+{
+    return _wlmtk_image_key_cmp(
+        &BS_CONTAINER_OF(
+            avlnode_ptr, _wlmtk_image_cache_entry_t, avlnode)->key,
+        key_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the @ref _wlmtk_image_cache_entry_t at `avlnode_ptr`. */
+void _wlmtk_image_cache_entry_destroy(bs_avltree_node_t *avlnode_ptr)
+{
+    _wlmtk_image_cache_entry_t *entry_ptr = BS_CONTAINER_OF(
+        avlnode_ptr, _wlmtk_image_cache_entry_t, avlnode);
+    cairo_surface_destroy(entry_ptr->surface_ptr);
+    free((char*)entry_ptr->key.path_ptr);
+    free(entry_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Number of bytes held by the pixels of `surface_ptr`. */
+size_t _wlmtk_image_surface_bytes(cairo_surface_t *surface_ptr)
+{
+    return (size_t)cairo_image_surface_get_stride(surface_ptr) *
+        cairo_image_surface_get_height(surface_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Decoder thread: Takes jobs from @ref _wlmtk_image_decoder_t::pending,
+ * loads the image and passes the job on to `done`.
+ *
+ * @param arg_ptr             Points to @ref _wlmtk_image_decoder_t.
+ *
+ * @return NULL.
+ */
+void *_wlmtk_image_decoder_thread(void *arg_ptr)
+{
+    _wlmtk_image_decoder_t *decoder_ptr = arg_ptr;
+
+    pthread_mutex_lock(&decoder_ptr->mutex);
+    while (!decoder_ptr->shutdown) {
+        bs_dllist_node_t *dlnode_ptr = bs_dllist_pop_front(
+            &decoder_ptr->pending);
+        if (NULL == dlnode_ptr) {
+            pthread_cond_wait(&decoder_ptr->cond, &decoder_ptr->mutex);
+            continue;
+        }
+        pthread_mutex_unlock(&decoder_ptr->mutex);
+
+        wlmtk_image_job_t *job_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_image_job_t, dlnode);
+        job_ptr->surface_ptr = _wlmtk_image_load(
+            job_ptr->path_ptr, job_ptr->width, job_ptr->height,
+            &job_ptr->mtime);
+
+        pthread_mutex_lock(&decoder_ptr->mutex);
+        bs_dllist_push_back(&decoder_ptr->done, &job_ptr->dlnode);
+        uint64_t value = 1;
+        if (sizeof(value) != write(decoder_ptr->event_fd, &value,
+                                   sizeof(value))) {
+            bs_log(BS_WARNING | BS_ERRNO, "Failed write(%d, ...)",
+                   decoder_ptr->event_fd);
+        }
+    }
+    pthread_mutex_unlock(&decoder_ptr->mutex);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles the event fd: Applies all decoded jobs, on the main thread. */
+int _wlmtk_image_decoder_handle_event(
+    int fd,
+    __UNUSED__ uint32_t mask,
+    __UNUSED__ void *data_ptr)
+{
+    uint64_t value;
+    if (0 > read(fd, &value, sizeof(value)) && EAGAIN != errno) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed read(%d, ...)", fd);
+    }
+
+    pthread_mutex_lock(&_wlmtk_image_decoder.mutex);
+    bs_dllist_t done = _wlmtk_image_decoder.done;
+    _wlmtk_image_decoder.done = (bs_dllist_t){};
+    pthread_mutex_unlock(&_wlmtk_image_decoder.mutex);
+
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&done))) {
+        _wlmtk_image_job_apply(BS_CONTAINER_OF(
+                                   dlnode_ptr, wlmtk_image_job_t, dlnode));
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Stops and joins the decoder threads. Then applies all pending and done
+ * jobs synchronously, so that no image stays a placeholder.
+ */
+void _wlmtk_image_decoder_stop(void)
+{
+    _wlmtk_image_decoder_t *decoder_ptr = &_wlmtk_image_decoder;
+
+    pthread_mutex_lock(&decoder_ptr->mutex);
+    decoder_ptr->shutdown = true;
+    pthread_cond_broadcast(&decoder_ptr->cond);
+    pthread_mutex_unlock(&decoder_ptr->mutex);
+    for (size_t i = 0; i < decoder_ptr->num_threads; ++i) {
+        pthread_join(decoder_ptr->threads[i], NULL);
+    }
+    decoder_ptr->num_threads = 0;
+
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&decoder_ptr->done))) {
+        _wlmtk_image_job_apply(BS_CONTAINER_OF(
+                                   dlnode_ptr, wlmtk_image_job_t, dlnode));
+    }
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&decoder_ptr->pending))) {
+        wlmtk_image_job_t *job_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_image_job_t, dlnode);
+        if (NULL != job_ptr->image_ptr) {
+            job_ptr->surface_ptr = _wlmtk_image_load(
+                job_ptr->path_ptr, job_ptr->width, job_ptr->height,
+                &job_ptr->mtime);
+        }
+        _wlmtk_image_job_apply(job_ptr);
+    }
+
+    if (NULL != decoder_ptr->event_source_ptr) {
+        wl_event_source_remove(decoder_ptr->event_source_ptr);
+        decoder_ptr->event_source_ptr = NULL;
+    }
+    if (0 <= decoder_ptr->event_fd) {
+        close(decoder_ptr->event_fd);
+        decoder_ptr->event_fd = -1;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Swaps the decoded image in for the placeholder, if the image still exists.
+ * Then destroys the job.
+ *
+ * @param job_ptr
+ */
+void _wlmtk_image_job_apply(wlmtk_image_job_t *job_ptr)
+{
+    if (NULL != job_ptr->image_ptr && NULL != job_ptr->surface_ptr) {
+        _wlmtk_image_cache_key_t key = {
+            .path_ptr = job_ptr->path_ptr,
+            .mtime = job_ptr->mtime,
+            .width = job_ptr->width,
+            .height = job_ptr->height
+        };
+        _wlmtk_image_shared_t *shared_ptr = _wlmtk_image_shared_acquire(
+            &key, job_ptr->surface_ptr);
+        if (NULL != shared_ptr) {
+            _wlmtk_image_set_shared(job_ptr->image_ptr, shared_ptr);
+        }
+    }
+    if (NULL != job_ptr->image_ptr) job_ptr->image_ptr->job_ptr = NULL;
+
+    if (NULL != job_ptr->surface_ptr) {
+        cairo_surface_destroy(job_ptr->surface_ptr);
+    }
+    free(job_ptr->path_ptr);
+    free(job_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Implements @ref wlmtk_element_vmt_t::destroy -- virtual dtor. */
 void _wlmtk_image_element_destroy(wlmtk_element_t *element_ptr)
@@ -186,9 +1217,15 @@ void _wlmtk_image_element_destroy(wlmtk_element_t *element_ptr)
 
 /* == Unit tests =========================================================== */
 static void test_create_destroy(bs_test_t *test_ptr);
+static void test_cache(bs_test_t *test_ptr);
+static void test_deferred(bs_test_t *test_ptr);
+static void test_disk_cache(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_image_test_cases[] = {
     { 1, "create_destroy", test_create_destroy },
+    { 1, "cache", test_cache },
+    { 1, "deferred", test_deferred },
+    { 1, "disk_cache", test_disk_cache },
     { 0, NULL, NULL }
 };
 
@@ -213,4 +1250,147 @@ void test_create_destroy(bs_test_t *test_ptr)
     wlmtk_image_destroy(image_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Verifies that decoded images are cached, by file and size. */
+void test_cache(bs_test_t *test_ptr)
+{
+    wlmtk_image_cache_flush();
+    const char *path_ptr = bs_test_resolve_path("toolkit/test_icon.png");
+
+    wlmtk_image_t *i1_ptr = wlmtk_image_create(path_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, i1_ptr);
+    wlmtk_image_t *i2_ptr = wlmtk_image_create(path_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, i2_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, bs_dllist_size(&_wlmtk_image_cache.lru));
+    // Both images show the same buffer.
+    BS_TEST_VERIFY_EQ(test_ptr, i1_ptr->shared_ptr, i2_ptr->shared_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr,
+        i1_ptr->super_buffer.wlr_buffer_ptr,
+        i2_ptr->super_buffer.wlr_buffer_ptr);
+    BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
+        test_ptr,
+        bs_gfxbuf_from_wlr_buffer(i2_ptr->super_buffer.wlr_buffer_ptr),
+        "toolkit/test_icon.png");
+
+    // Another size is another entry.
+    wlmtk_image_t *i3_ptr = wlmtk_image_create_scaled(path_ptr, 16, 16);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, i3_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, bs_dllist_size(&_wlmtk_image_cache.lru));
+
+    // At scale 2, the buffer has twice the pixels. Same as 16x16 at scale 1.
+    wlmtk_image_t *i4_ptr = wlmtk_image_create_scaled_at(path_ptr, 8, 8, 2.0);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, i4_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, i3_ptr->shared_ptr, i4_ptr->shared_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2.0, i4_ptr->super_buffer.scale);
+    wlmtk_image_destroy(i4_ptr);
+
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, wlmtk_image_create("/does/not/exist"));
+
+    wlmtk_image_destroy(i3_ptr);
+    wlmtk_image_destroy(i2_ptr);
+    wlmtk_image_destroy(i1_ptr);
+    wlmtk_image_cache_flush();
+    BS_TEST_VERIFY_EQ(test_ptr, 0, bs_dllist_size(&_wlmtk_image_cache.lru));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Exercises decoding on the decoder threads, with placeholder. */
+void test_deferred(bs_test_t *test_ptr)
+{
+    wlmtk_image_cache_flush();
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(
+        test_ptr, wlmtk_image_defer_decode(wl_event_loop_ptr));
+    const char *path_ptr = bs_test_resolve_path("toolkit/test_icon.png");
+
+    // Native size is not known upfront: Decodes immediately.
+    wlmtk_image_t *i1_ptr = wlmtk_image_create(path_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, i1_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, i1_ptr->job_ptr);
+    int w = i1_ptr->super_buffer.wlr_buffer_ptr->width;
+    int h = i1_ptr->super_buffer.wlr_buffer_ptr->height;
+
+    // Sized: Shows a placeholder, until the job is done.
+    wlmtk_image_t *i2_ptr = wlmtk_image_create_scaled(path_ptr, w, h);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, i2_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, i2_ptr->job_ptr);
+    // One job, which gets destroyed before the decoder is done.
+    wlmtk_image_t *i3_ptr = wlmtk_image_create_scaled(path_ptr, w, h);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, i3_ptr);
+    wlmtk_image_destroy(i3_ptr);
+
+    for (int i = 0; i < 100 && NULL != i2_ptr->job_ptr; ++i) {
+        wl_event_loop_dispatch(wl_event_loop_ptr, 10);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, i2_ptr->job_ptr);
+    BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
+        test_ptr,
+        bs_gfxbuf_from_wlr_buffer(i2_ptr->super_buffer.wlr_buffer_ptr),
+        "toolkit/test_icon.png");
+
+    // Stopping the decoder applies all remaining jobs.
+    wlmtk_image_t *i4_ptr = wlmtk_image_create_scaled(path_ptr, 8, 8);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, i4_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_image_defer_decode(NULL));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, i4_ptr->job_ptr);
+
+    wlmtk_image_destroy(i4_ptr);
+    wlmtk_image_destroy(i2_ptr);
+    wlmtk_image_destroy(i1_ptr);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+    wlmtk_image_cache_flush();
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies images are stored to and loaded from the on-disk cache. */
+void test_disk_cache(bs_test_t *test_ptr)
+{
+    char dir[] = "/tmp/wlmtk_image_test_XXXXXX";
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, mkdtemp(dir));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_image_set_cache_dir(dir));
+    wlmtk_image_cache_flush();
+    const char *path_ptr = bs_test_resolve_path("toolkit/test_icon.png");
+    size_t hits = _wlmtk_image_cache.disk_hits;
+
+    // Miss: Decodes, and writes the cache file.
+    wlmtk_image_t *image_ptr = wlmtk_image_create(path_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, image_ptr);
+    wlmtk_image_destroy(image_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, hits, _wlmtk_image_cache.disk_hits);
+    char fname[PATH_MAX];
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        _wlmtk_image_disk_fname(dir, path_ptr, 0, 0, fname, sizeof(fname)));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, access(fname, R_OK));
+
+    // Hit: Same pixels, mapped from the cache file.
+    wlmtk_image_cache_flush();
+    image_ptr = wlmtk_image_create(path_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, image_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, hits + 1, _wlmtk_image_cache.disk_hits);
+    BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
+        test_ptr,
+        bs_gfxbuf_from_wlr_buffer(image_ptr->super_buffer.wlr_buffer_ptr),
+        "toolkit/test_icon.png");
+    wlmtk_image_destroy(image_ptr);
+
+    // A corrupt cache file is ignored, and re-written.
+    FILE *file_ptr = fopen(fname, "r+b");
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, file_ptr);
+    fputs("garbage", file_ptr);
+    fclose(file_ptr);
+    wlmtk_image_cache_flush();
+    image_ptr = wlmtk_image_create(path_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, image_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, hits + 1, _wlmtk_image_cache.disk_hits);
+    wlmtk_image_destroy(image_ptr);
+
+    wlmtk_image_set_cache_dir(NULL);
+    wlmtk_image_cache_flush();
+    unlink(fname);
+    rmdir(dir);
+}
+
 /* == End of image.c ======================================================= */
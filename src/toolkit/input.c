@@ -22,8 +22,10 @@
 
 #include <libbase/libbase.h>
 #include <stdlib.h>
+#include <string.h>
 #define WLR_USE_UNSTABLE
 #include <wlr/types/wlr_cursor.h>
+#include <wlr/types/wlr_pointer.h>
 #undef WLR_USE_UNSTABLE
 
 /* == Declarations ========================================================= */
@@ -34,6 +36,11 @@ struct _wlmtk_pointer_t {
     struct wlr_cursor         *wlr_cursor_ptr;
     /** Points to a `wlr_xcursor_manager`. */
     struct wlr_xcursor_manager *wlr_xcursor_manager_ptr;
+    /**
+     * Name of the xcursor currently applied to `wlr_cursor_ptr`, or NULL if
+     * the image is a client surface.
+     */
+    const char                *applied_name_ptr;
 };
 
 /** Lookup table for XCursor names. */
@@ -79,10 +86,56 @@ void wlmtk_pointer_set_cursor(
         NULL == pointer_ptr->wlr_xcursor_manager_ptr) return;
     if (cursor < 0 || cursor >= WLMTK_POINTER_CURSOR_MAX) return;
 
+    wlmtk_pointer_set_xcursor(
+        pointer_ptr, _wlmtk_pointer_cursor_names[cursor]);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_pointer_set_xcursor(
+    wlmtk_pointer_t *pointer_ptr,
+    const char *name_ptr)
+{
+    if (NULL == pointer_ptr ||
+        NULL == pointer_ptr->wlr_cursor_ptr ||
+        NULL == pointer_ptr->wlr_xcursor_manager_ptr ||
+        NULL == name_ptr) return;
+
+    // Elements request the cursor on each motion. Re-setting it would look
+    // up the image again, and restart an animated cursor.
+    if (NULL != pointer_ptr->applied_name_ptr &&
+        (pointer_ptr->applied_name_ptr == name_ptr ||
+         0 == strcmp(pointer_ptr->applied_name_ptr, name_ptr))) return;
     wlr_cursor_set_xcursor(
         pointer_ptr->wlr_cursor_ptr,
         pointer_ptr->wlr_xcursor_manager_ptr,
-        _wlmtk_pointer_cursor_names[cursor]);
+        name_ptr);
+    pointer_ptr->applied_name_ptr = name_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_pointer_set_surface(
+    wlmtk_pointer_t *pointer_ptr,
+    struct wlr_surface *wlr_surface_ptr,
+    int32_t hotspot_x,
+    int32_t hotspot_y)
+{
+    wlr_cursor_set_surface(
+        pointer_ptr->wlr_cursor_ptr, wlr_surface_ptr, hotspot_x, hotspot_y);
+    pointer_ptr->applied_name_ptr = NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+int wlmtk_pointer_axis_steps(
+    const struct wlr_pointer_axis_event *wlr_pointer_axis_event_ptr)
+{
+    int32_t v120 = wlr_pointer_axis_event_ptr->delta_discrete;
+    if (0 != v120) {
+        if (0 != v120 % WLR_POINTER_AXIS_DISCRETE_STEP) return 0;
+        return v120 / WLR_POINTER_AXIS_DISCRETE_STEP;
+    }
+    if (0 > wlr_pointer_axis_event_ptr->delta) return -1;
+    if (0 < wlr_pointer_axis_event_ptr->delta) return 1;
+    return 0;
 }
 
 /* == Local (static) methods =============================================== */
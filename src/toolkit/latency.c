@@ -0,0 +1,275 @@
+/* ========================================================================= */
+/**
+ * @file latency.c
+ *
+ * @copyright
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "latency.h"
+
+#include <libbase/libbase.h>
+#include <inttypes.h>
+#include <stddef.h>
+
+/* == Declarations ========================================================= */
+
+static void _wlmtk_latency_record(uint64_t *histogram_ptr, uint32_t msec);
+static unsigned _wlmtk_latency_percentile(
+    const uint64_t *histogram_ptr,
+    uint64_t samples,
+    unsigned percent);
+static uint64_t _wlmtk_latency_samples(const uint64_t *histogram_ptr);
+
+/* == Data ================================================================= */
+
+/** Registered trackers, linked through @ref wlmtk_latency_t::dlnode. */
+static bs_dllist_t            _wlmtk_latencies;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_latency_init(wlmtk_latency_t *latency_ptr, const char *name_ptr)
+{
+    *latency_ptr = (wlmtk_latency_t){ .name_ptr = name_ptr };
+    bs_dllist_push_back(&_wlmtk_latencies, &latency_ptr->dlnode);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_latency_fini(wlmtk_latency_t *latency_ptr)
+{
+    bs_dllist_remove(&_wlmtk_latencies, &latency_ptr->dlnode);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_latency_input(uint32_t time_msec)
+{
+    for (bs_dllist_node_t *dlnode_ptr = _wlmtk_latencies.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_latency_t *latency_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_latency_t, dlnode);
+        if (latency_ptr->has_pending) continue;
+        latency_ptr->has_pending = true;
+        latency_ptr->pending_msec = time_msec;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_latency_committed(wlmtk_latency_t *latency_ptr, uint32_t now_msec)
+{
+    latency_ptr->has_committed = false;
+    if (!latency_ptr->has_pending) return;
+
+    // Unsigned arithmetic handles the wrap-around of the timestamps.
+    _wlmtk_latency_record(latency_ptr->commit_histogram,
+                          now_msec - latency_ptr->pending_msec);
+    latency_ptr->has_committed = true;
+    latency_ptr->committed_msec = latency_ptr->pending_msec;
+    latency_ptr->has_pending = false;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_latency_presented(
+    wlmtk_latency_t *latency_ptr,
+    bool presented,
+    uint32_t when_msec)
+{
+    if (!latency_ptr->has_committed) return;
+    latency_ptr->has_committed = false;
+    if (!presented) return;
+
+    _wlmtk_latency_record(latency_ptr->present_histogram,
+                          when_msec - latency_ptr->committed_msec);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_latency_get_stats(
+    wlmtk_latency_t *latency_ptr,
+    wlmtk_latency_stats_t *stats_ptr)
+{
+    const uint64_t *c_ptr = latency_ptr->commit_histogram;
+    const uint64_t *p_ptr = latency_ptr->present_histogram;
+    *stats_ptr = (wlmtk_latency_stats_t){
+        .name_ptr = latency_ptr->name_ptr,
+        .commit_samples = _wlmtk_latency_samples(c_ptr),
+        .present_samples = _wlmtk_latency_samples(p_ptr),
+    };
+    stats_ptr->commit_p50_msec = _wlmtk_latency_percentile(
+        c_ptr, stats_ptr->commit_samples, 50);
+    stats_ptr->commit_p99_msec = _wlmtk_latency_percentile(
+        c_ptr, stats_ptr->commit_samples, 99);
+    stats_ptr->present_p50_msec = _wlmtk_latency_percentile(
+        p_ptr, stats_ptr->present_samples, 50);
+    stats_ptr->present_p99_msec = _wlmtk_latency_percentile(
+        p_ptr, stats_ptr->present_samples, 99);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_latency_for_each(
+    void (*func)(wlmtk_latency_t *latency_ptr, void *ud_ptr),
+    void *ud_ptr)
+{
+    for (bs_dllist_node_t *dlnode_ptr = _wlmtk_latencies.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        func(BS_CONTAINER_OF(dlnode_ptr, wlmtk_latency_t, dlnode), ud_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_latency_log_stats(bs_log_severity_t severity)
+{
+    for (bs_dllist_node_t *dlnode_ptr = _wlmtk_latencies.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_latency_stats_t s;
+        wlmtk_latency_get_stats(
+            BS_CONTAINER_OF(dlnode_ptr, wlmtk_latency_t, dlnode), &s);
+        bs_log(severity, "Latency %s: Commit p50 %ums, p99 %ums "
+               "(%"PRIu64" samples), presentation p50 %ums, p99 %ums "
+               "(%"PRIu64" samples)",
+               s.name_ptr, s.commit_p50_msec, s.commit_p99_msec,
+               s.commit_samples, s.present_p50_msec, s.present_p99_msec,
+               s.present_samples);
+    }
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Adds a sample of `msec` to the histogram. */
+void _wlmtk_latency_record(uint64_t *histogram_ptr, uint32_t msec)
+{
+    histogram_ptr[BS_MIN(msec, (uint32_t)WLMTK_LATENCY_BUCKETS - 1)]++;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return The total number of samples in the histogram. */
+uint64_t _wlmtk_latency_samples(const uint64_t *histogram_ptr)
+{
+    uint64_t samples = 0;
+    for (size_t i = 0; i < WLMTK_LATENCY_BUCKETS; ++i) {
+        samples += histogram_ptr[i];
+    }
+    return samples;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes a percentile from the histogram.
+ *
+ * @param histogram_ptr
+ * @param samples             Total number of samples in the histogram.
+ * @param percent
+ *
+ * @return The smallest latency, in milliseconds, that at least `percent`
+ *     of the samples do not exceed. 0 if there are no samples.
+ */
+unsigned _wlmtk_latency_percentile(
+    const uint64_t *histogram_ptr,
+    uint64_t samples,
+    unsigned percent)
+{
+    if (0 == samples) return 0;
+    uint64_t threshold = (samples * percent + 99) / 100;
+    uint64_t count = 0;
+    for (unsigned i = 0; i < WLMTK_LATENCY_BUCKETS; ++i) {
+        count += histogram_ptr[i];
+        if (count >= threshold) return i;
+    }
+    return WLMTK_LATENCY_BUCKETS - 1;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_latency(bs_test_t *test_ptr);
+static void test_percentiles(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_latency_test_cases[] = {
+    { 1, "latency", test_latency },
+    { 1, "percentiles", test_percentiles },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Follows input through commit and presentation. */
+void test_latency(bs_test_t *test_ptr)
+{
+    wlmtk_latency_t l;
+    wlmtk_latency_init(&l, "test");
+    wlmtk_latency_stats_t s;
+
+    // Only the oldest input is accounted for.
+    wlmtk_latency_input(100);
+    wlmtk_latency_input(103);
+    wlmtk_latency_committed(&l, 105);
+    wlmtk_latency_presented(&l, true, 112);
+    wlmtk_latency_get_stats(&l, &s);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, s.commit_samples);
+    BS_TEST_VERIFY_EQ(test_ptr, 5, s.commit_p50_msec);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, s.present_samples);
+    BS_TEST_VERIFY_EQ(test_ptr, 12, s.present_p50_msec);
+
+    // A commit without input, or a presentation without commit: No sample.
+    wlmtk_latency_committed(&l, 120);
+    wlmtk_latency_presented(&l, true, 130);
+    wlmtk_latency_get_stats(&l, &s);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, s.commit_samples);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, s.present_samples);
+
+    // A commit that was not presented drops the sample. Timestamps wrap.
+    wlmtk_latency_input(UINT32_MAX - 1);
+    wlmtk_latency_committed(&l, 2);
+    wlmtk_latency_presented(&l, false, 3);
+    wlmtk_latency_get_stats(&l, &s);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, s.commit_samples);
+    BS_TEST_VERIFY_EQ(test_ptr, 5, s.commit_p99_msec);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, s.present_samples);
+
+    // Unregistered trackers do not see input.
+    wlmtk_latency_fini(&l);
+    wlmtk_latency_input(200);
+    BS_TEST_VERIFY_FALSE(test_ptr, l.has_pending);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies percentiles, including overflowing latencies. */
+void test_percentiles(bs_test_t *test_ptr)
+{
+    wlmtk_latency_t l;
+    wlmtk_latency_init(&l, "test");
+    for (uint32_t i = 0; i < 100; ++i) {
+        wlmtk_latency_input(1000);
+        wlmtk_latency_committed(&l, 1000 + (i < 99 ? i : 1000));
+    }
+    wlmtk_latency_stats_t s;
+    wlmtk_latency_get_stats(&l, &s);
+    BS_TEST_VERIFY_EQ(test_ptr, 100, s.commit_samples);
+    BS_TEST_VERIFY_EQ(test_ptr, 49, s.commit_p50_msec);
+    BS_TEST_VERIFY_EQ(test_ptr, 98, s.commit_p99_msec);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, s.present_samples);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, s.present_p50_msec);
+
+    // The overflow is reported as the largest bucket.
+    wlmtk_latency_input(1000);
+    wlmtk_latency_committed(&l, 2000);
+    wlmtk_latency_get_stats(&l, &s);
+    BS_TEST_VERIFY_EQ(test_ptr, WLMTK_LATENCY_BUCKETS - 1,
+                      s.commit_p99_msec);
+    wlmtk_latency_fini(&l);
+}
+
+/* == End of latency.c ===================================================== */
@@ -31,6 +31,7 @@
 #undef WLR_USE_UNSTABLE
 
 #include "container.h"
+#include "layout_epoch.h"
 #include "panel.h"
 #include "test.h"  // IWYU pragma: keep
 #include "tile.h"
@@ -50,7 +51,7 @@ struct _wlmtk_layer_t {
     /** Holds outputs and panels. */
     bs_avltree_t              *output_tree_ptr;
 
-    /** Listener for wlr_output_layout::events.change. */
+    /** Listener for layout epochs, see @ref wlmtk_layout_epoch_connect. */
     struct wl_listener        output_layout_change_listener;
 
     // Elements below not owned by wlmtk_layer_t.
@@ -67,8 +68,12 @@ struct _wlmtk_layer_output_t {
     struct wlr_output         *wlr_output_ptr;
     /** Extents and position of the output in the layout. */
     struct wlr_box            extents;
+    /** Usable area: `extents`, without the panels' exclusive zones. */
+    struct wlr_box            usable_area;
     /** Panels. Holds nodes at @ref wlmtk_panel_t::dlnode. */
     bs_dllist_t               panels;
+    /** Whether the panels on this output are occluded. */
+    bool                      occluded;
 };
 
 /** Argument to @ref _wlmtk_layer_output_update. */
@@ -130,8 +135,9 @@ wlmtk_layer_t *wlmtk_layer_create(
         return NULL;
     }
 
-    wlmtk_util_connect_listener_signal(
-        &layer_ptr->wlr_output_layout_ptr->events.change,
+    wlmtk_layout_epoch_connect(
+        layer_ptr->wlr_output_layout_ptr,
+        WLMTK_LAYOUT_EPOCH_STAGE_LAYERS,
         &layer_ptr->output_layout_change_listener,
         _wlmtk_layer_handle_output_layout_change);
     _wlmtk_layer_handle_output_layout_change(
@@ -208,6 +214,20 @@ void wlmtk_layer_remove_panel(wlmtk_layer_t *layer_ptr,
     wlmtk_layer_output_reconfigure(layer_output_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+struct wlr_box wlmtk_layer_output_get_usable_area(
+    wlmtk_layer_output_t *layer_output_ptr)
+{
+    return layer_output_ptr->usable_area;
+}
+
+/* ------------------------------------------------------------------------- */
+struct wlr_box wlmtk_layer_output_get_extents(
+    wlmtk_layer_output_t *layer_output_ptr)
+{
+    return layer_output_ptr->extents;
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmtk_layer_output_reconfigure(
     wlmtk_layer_output_t *layer_output_ptr)
@@ -227,6 +247,15 @@ void wlmtk_layer_output_reconfigure(
             usable_area = new_usable_area;
         }
 
+        // Panels not affected by the change keep their dimensions: Skip
+        // the configure, so their clients won't have to re-render.
+        if (panel_ptr->has_dimensions &&
+            wlr_box_equal(&panel_ptr->dimensions, &panel_dimensions)) {
+            continue;
+        }
+        panel_ptr->has_dimensions = true;
+        panel_ptr->dimensions = panel_dimensions;
+
         wlmtk_panel_request_size(
             panel_ptr,
             panel_dimensions.width,
@@ -236,6 +265,56 @@ void wlmtk_layer_output_reconfigure(
             panel_dimensions.x,
             panel_dimensions.y);
     }
+
+    if (!wlr_box_equal(&usable_area, &layer_output_ptr->usable_area)) {
+        layer_output_ptr->usable_area = usable_area;
+        bs_log(BS_DEBUG, "Layer output %p usable area: %d, %d, %d x %d",
+               layer_output_ptr, usable_area.x, usable_area.y,
+               usable_area.width, usable_area.height);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_layer_set_output_occluded(
+    wlmtk_layer_t *layer_ptr,
+    struct wlr_output *wlr_output_ptr,
+    bool occluded)
+{
+    bs_avltree_node_t *avlnode_ptr = bs_avltree_lookup(
+        layer_ptr->output_tree_ptr,
+        wlr_output_ptr);
+    if (NULL == avlnode_ptr) return;
+    wlmtk_layer_output_t *layer_output_ptr = BS_CONTAINER_OF(
+        avlnode_ptr, wlmtk_layer_output_t, avlnode);
+    if (layer_output_ptr->occluded == occluded) return;
+
+    layer_output_ptr->occluded = occluded;
+    for (bs_dllist_node_t *dlnode_ptr = layer_output_ptr->panels.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_element_set_occluded(
+            wlmtk_panel_element(wlmtk_panel_from_dlnode(dlnode_ptr)),
+            occluded);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_layer_for_each_panel_box(
+    wlmtk_layer_t *layer_ptr,
+    void (*func)(const struct wlr_box *box_ptr, void *ud_ptr),
+    void *ud_ptr)
+{
+    for (bs_dllist_node_t *dlnode_ptr =
+             layer_ptr->super_container.elements.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
+        if (!element_ptr->visible) continue;
+        struct wlr_box box = wlmtk_element_get_dimensions_box(element_ptr);
+        box.x += element_ptr->x;
+        box.y += element_ptr->y;
+        func(&box, ud_ptr);
+    }
 }
 
 /* ------------------------------------------------------------------------- */
@@ -360,9 +439,14 @@ void _wlmtk_layer_output_add_panel(
     wlmtk_panel_t *panel_ptr)
 {
     wlmtk_panel_set_layer_output(panel_ptr, layer_output_ptr);
+    // A newly added panel always gets configured.
+    panel_ptr->has_dimensions = false;
     bs_dllist_push_back(
         &layer_output_ptr->panels,
         wlmtk_dlnode_from_panel(panel_ptr));
+    wlmtk_element_set_occluded(
+        wlmtk_panel_element(panel_ptr),
+        layer_output_ptr->occluded);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -376,6 +460,7 @@ void _wlmtk_layer_output_remove_panel(
         &layer_output_ptr->panels,
         wlmtk_dlnode_from_panel(panel_ptr));
     wlmtk_panel_set_layer_output(panel_ptr, NULL);
+    wlmtk_element_set_occluded(wlmtk_panel_element(panel_ptr), false);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -409,10 +494,12 @@ void _wlmtk_layer_handle_output_layout_change(
 
 static void test_multi_output(bs_test_t *test_ptr);
 static void test_layout(bs_test_t *test_ptr);
+static void test_occluded(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_layer_test_cases[] = {
     { 1, "multi_output", test_multi_output },
     { 1, "layout", test_layout },
+    { 1, "occluded", test_occluded },
     { 0, NULL, NULL }
 };
 
@@ -561,6 +648,26 @@ void test_layout(bs_test_t *test_ptr)
     BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_panel_element(&fp3_ptr->panel)->y);
     BS_TEST_VERIFY_EQ(test_ptr, 100, fp3_ptr->requested_width);
     BS_TEST_VERIFY_EQ(test_ptr, 768, fp3_ptr->requested_height);
+    struct wlr_box expected_usable = { .x = 80, .width = 944, .height = 768 };
+    struct wlr_box usable = wlmtk_layer_output_get_usable_area(
+        wlmtk_panel_get_layer_output(&fp1_ptr->panel));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlr_box_equal(&expected_usable, &usable));
+
+    // Reconfiguring does not configure panels of unchanged dimensions.
+    fp1_ptr->requested_width = 0;
+    fp3_ptr->requested_width = 0;
+    wlmtk_layer_output_reconfigure(
+        wlmtk_panel_get_layer_output(&fp1_ptr->panel));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, fp1_ptr->requested_width);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, fp3_ptr->requested_width);
+
+    // A change in the first panel's exclusive zone re-configures the others.
+    pos = fp1_ptr->panel.positioning;
+    pos.exclusive_zone = 30;
+    wlmtk_panel_commit(&fp1_ptr->panel, 0, &pos);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, fp1_ptr->requested_width);
+    BS_TEST_VERIFY_EQ(test_ptr, 100, fp3_ptr->requested_width);
+    BS_TEST_VERIFY_EQ(test_ptr, 30, wlmtk_panel_element(&fp3_ptr->panel)->x);
 
     wlmtk_layer_remove_panel(layer_ptr, &fp3_ptr->panel);
     wlmtk_fake_panel_destroy(fp3_ptr);
@@ -580,4 +687,58 @@ void test_layout(bs_test_t *test_ptr)
     wl_display_destroy(display_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests that occluding an output applies to it's panels, and only these. */
+void test_occluded(bs_test_t *test_ptr)
+{
+    struct wl_display *display_ptr = wl_display_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, display_ptr);
+    struct wlr_output_layout *wlr_output_layout_ptr =
+        wlr_output_layout_create(display_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_output_layout_ptr);
+    struct wlr_output o1 = { .width = 1024, .height = 768, .scale = 1 };
+    wlmtk_test_wlr_output_init(&o1);
+    wlr_output_layout_add(wlr_output_layout_ptr, &o1, 0, 0);
+    struct wlr_output o2 = { .width = 640, .height = 480, .scale = 1 };
+    wlmtk_test_wlr_output_init(&o2);
+    wlr_output_layout_add(wlr_output_layout_ptr, &o2, 1024, 0);
+
+    wlmtk_layer_t *layer_ptr = wlmtk_layer_create(wlr_output_layout_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, layer_ptr);
+
+    wlmtk_panel_positioning_t p = {
+        .desired_width = 100, .desired_height = 50 };
+    wlmtk_fake_panel_t *fp1_ptr = wlmtk_fake_panel_create(&p);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fp1_ptr);
+    wlmtk_layer_add_panel(layer_ptr, &fp1_ptr->panel, &o1);
+    wlmtk_fake_panel_t *fp2_ptr = wlmtk_fake_panel_create(&p);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fp2_ptr);
+    wlmtk_layer_add_panel(layer_ptr, &fp2_ptr->panel, &o2);
+    wlmtk_element_t *e1_ptr = wlmtk_panel_element(&fp1_ptr->panel);
+    wlmtk_element_t *e2_ptr = wlmtk_panel_element(&fp2_ptr->panel);
+
+    wlmtk_layer_set_output_occluded(layer_ptr, &o1, true);
+    BS_TEST_VERIFY_TRUE(test_ptr, e1_ptr->occluded);
+    BS_TEST_VERIFY_FALSE(test_ptr, e2_ptr->occluded);
+
+    // A panel added to the occluded output gets occluded, too.
+    wlmtk_layer_remove_panel(layer_ptr, &fp2_ptr->panel);
+    wlmtk_layer_add_panel(layer_ptr, &fp2_ptr->panel, &o1);
+    BS_TEST_VERIFY_TRUE(test_ptr, e2_ptr->occluded);
+
+    // ... and is no longer, once removed.
+    wlmtk_layer_remove_panel(layer_ptr, &fp2_ptr->panel);
+    BS_TEST_VERIFY_FALSE(test_ptr, e2_ptr->occluded);
+    wlmtk_fake_panel_destroy(fp2_ptr);
+
+    wlmtk_layer_set_output_occluded(layer_ptr, &o1, false);
+    BS_TEST_VERIFY_FALSE(test_ptr, e1_ptr->occluded);
+
+    wlmtk_layer_remove_panel(layer_ptr, &fp1_ptr->panel);
+    wlmtk_fake_panel_destroy(fp1_ptr);
+    wlmtk_layer_destroy(layer_ptr);
+    wlr_output_layout_destroy(wlr_output_layout_ptr);
+    wl_display_destroy(display_ptr);
+}
+
 /* == End of layer.c ======================================================= */
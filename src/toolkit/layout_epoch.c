@@ -0,0 +1,637 @@
+/* ========================================================================= */
+/**
+ * @file layout_epoch.c
+ *
+ * @copyright
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "layout_epoch.h"
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wayland-server-core.h>
+#include <wayland-util.h>
+#define WLR_USE_UNSTABLE
+#include <wlr/types/wlr_output.h>
+#include <wlr/types/wlr_output_layout.h>
+#include <wlr/util/box.h>
+#undef WLR_USE_UNSTABLE
+
+#include "test.h"
+#include "trace.h"
+#include "util.h"
+
+/* == Declarations ========================================================= */
+
+/** An output's position and size, as seen at the most recent epoch. */
+typedef struct {
+    /** The output. May be destroyed, if no longer in the layout. */
+    struct wlr_output         *wlr_output_ptr;
+    /** Its box in layout coordinates. */
+    struct wlr_box            box;
+} wlmtk_layout_epoch_output_t;
+
+/** Dispatches the epochs of one output layout. */
+typedef struct {
+    /** Node within @ref _wlmtk_layout_epoch_dispatchers. */
+    bs_dllist_node_t          dlnode;
+    /** The output layout. */
+    struct wlr_output_layout  *wlr_output_layout_ptr;
+    /** One signal per @ref wlmtk_layout_epoch_stage_t. */
+    struct wl_signal          stages[WLMTK_LAYOUT_EPOCH_STAGE_MAX];
+
+    /** Outputs at the most recent epoch. */
+    wlmtk_layout_epoch_output_t *outputs;
+    /** Number of elements at `outputs`. */
+    size_t                    outputs_size;
+    /** Storage for the output pointers referenced by `diff`. */
+    struct wlr_output         **diff_wlr_output_ptrs;
+    /** Diff of the most recent epoch. */
+    wlmtk_layout_epoch_diff_t diff;
+
+    /** Whether changes are waiting for the next epoch. */
+    bool                      pending;
+    /** Whether the stages are being notified right now. */
+    bool                      dispatching;
+
+    /** Listener for `change` of `wlr_output_layout`. */
+    struct wl_listener        change_listener;
+    /** Listener for `destroy` of `wlr_output_layout`. */
+    struct wl_listener        destroy_listener;
+} wlmtk_layout_epoch_dispatcher_t;
+
+static wlmtk_layout_epoch_dispatcher_t *_wlmtk_layout_epoch_dispatcher(
+    struct wlr_output_layout *wlr_output_layout_ptr,
+    bool create);
+static void _wlmtk_layout_epoch_dispatcher_destroy(
+    wlmtk_layout_epoch_dispatcher_t *dispatcher_ptr);
+static bool _wlmtk_layout_epoch_snapshot(
+    wlmtk_layout_epoch_dispatcher_t *dispatcher_ptr,
+    wlmtk_layout_epoch_output_t **outputs_ptr,
+    size_t *outputs_size_ptr);
+static bool _wlmtk_layout_epoch_has_removals(
+    wlmtk_layout_epoch_dispatcher_t *dispatcher_ptr);
+static void _wlmtk_layout_epoch_dispatch(
+    wlmtk_layout_epoch_dispatcher_t *dispatcher_ptr);
+static void _wlmtk_layout_epoch_update_diff(
+    wlmtk_layout_epoch_dispatcher_t *dispatcher_ptr);
+static const wlmtk_layout_epoch_output_t *_wlmtk_layout_epoch_find(
+    const wlmtk_layout_epoch_output_t *outputs,
+    size_t outputs_size,
+    struct wlr_output *wlr_output_ptr);
+
+static void _wlmtk_layout_epoch_handle_change(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmtk_layout_epoch_handle_destroy(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmtk_layout_epoch_handle_idle(void *data_ptr);
+
+/* == Data ================================================================= */
+
+/** All dispatchers. There is one per output layout with subscribers. */
+static bs_dllist_t _wlmtk_layout_epoch_dispatchers = {};
+/** Event loop for deferred epochs. NULL if epochs run immediately. */
+static struct wl_event_loop *_wlmtk_layout_epoch_event_loop_ptr = NULL;
+/** Idle source for running deferred epochs, if scheduled. */
+static struct wl_event_source *_wlmtk_layout_epoch_idle_ptr = NULL;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_layout_epoch_connect(
+    struct wlr_output_layout *wlr_output_layout_ptr,
+    wlmtk_layout_epoch_stage_t stage,
+    struct wl_listener *listener_ptr,
+    wl_notify_func_t notifier_func)
+{
+    BS_ASSERT(0 <= stage && stage < WLMTK_LAYOUT_EPOCH_STAGE_MAX);
+    wlmtk_layout_epoch_dispatcher_t *dispatcher_ptr =
+        _wlmtk_layout_epoch_dispatcher(wlr_output_layout_ptr, true);
+    if (NULL == dispatcher_ptr) {
+        // Fall back to the layout's own signal, without ordering.
+        wlmtk_util_connect_listener_signal(
+            &wlr_output_layout_ptr->events.change,
+            listener_ptr,
+            notifier_func);
+        return;
+    }
+    wlmtk_util_connect_listener_signal(
+        &dispatcher_ptr->stages[stage],
+        listener_ptr,
+        notifier_func);
+}
+
+/* ------------------------------------------------------------------------- */
+const wlmtk_layout_epoch_diff_t *wlmtk_layout_epoch_diff(
+    struct wlr_output_layout *wlr_output_layout_ptr)
+{
+    wlmtk_layout_epoch_dispatcher_t *dispatcher_ptr =
+        _wlmtk_layout_epoch_dispatcher(wlr_output_layout_ptr, false);
+    if (NULL == dispatcher_ptr) return NULL;
+    return &dispatcher_ptr->diff;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_layout_epoch_defer(struct wl_event_loop *wl_event_loop_ptr)
+{
+    _wlmtk_layout_epoch_event_loop_ptr = wl_event_loop_ptr;
+    if (NULL != wl_event_loop_ptr) return;
+
+    if (NULL != _wlmtk_layout_epoch_idle_ptr) {
+        wl_event_source_remove(_wlmtk_layout_epoch_idle_ptr);
+        _wlmtk_layout_epoch_idle_ptr = NULL;
+    }
+    wlmtk_layout_epoch_flush();
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_layout_epoch_flush(void)
+{
+    bs_dllist_node_t *next_dlnode_ptr;
+    for (bs_dllist_node_t *dlnode_ptr =
+             _wlmtk_layout_epoch_dispatchers.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = next_dlnode_ptr) {
+        next_dlnode_ptr = dlnode_ptr->next_ptr;
+        wlmtk_layout_epoch_dispatcher_t *dispatcher_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_layout_epoch_dispatcher_t, dlnode);
+        if (dispatcher_ptr->pending) {
+            _wlmtk_layout_epoch_dispatch(dispatcher_ptr);
+        }
+    }
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the dispatcher for `wlr_output_layout_ptr`.
+ *
+ * @param wlr_output_layout_ptr
+ * @param create              Whether to create the dispatcher if there is
+ *                            none yet.
+ *
+ * @return Pointer to the dispatcher, or NULL if not found or on error.
+ */
+wlmtk_layout_epoch_dispatcher_t *_wlmtk_layout_epoch_dispatcher(
+    struct wlr_output_layout *wlr_output_layout_ptr,
+    bool create)
+{
+    for (bs_dllist_node_t *dlnode_ptr =
+             _wlmtk_layout_epoch_dispatchers.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_layout_epoch_dispatcher_t *dispatcher_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_layout_epoch_dispatcher_t, dlnode);
+        if (dispatcher_ptr->wlr_output_layout_ptr == wlr_output_layout_ptr) {
+            return dispatcher_ptr;
+        }
+    }
+    if (!create) return NULL;
+
+    wlmtk_layout_epoch_dispatcher_t *dispatcher_ptr = logged_calloc(
+        1, sizeof(wlmtk_layout_epoch_dispatcher_t));
+    if (NULL == dispatcher_ptr) return NULL;
+    dispatcher_ptr->wlr_output_layout_ptr = wlr_output_layout_ptr;
+    for (int i = 0; i < WLMTK_LAYOUT_EPOCH_STAGE_MAX; ++i) {
+        wl_signal_init(&dispatcher_ptr->stages[i]);
+    }
+
+    // Diffs are relative to the layout as found by the first subscriber.
+    if (!_wlmtk_layout_epoch_snapshot(
+            dispatcher_ptr,
+            &dispatcher_ptr->outputs,
+            &dispatcher_ptr->outputs_size)) {
+        free(dispatcher_ptr);
+        return NULL;
+    }
+
+    wlmtk_util_connect_listener_signal(
+        &wlr_output_layout_ptr->events.change,
+        &dispatcher_ptr->change_listener,
+        _wlmtk_layout_epoch_handle_change);
+    wlmtk_util_connect_listener_signal(
+        &wlr_output_layout_ptr->events.destroy,
+        &dispatcher_ptr->destroy_listener,
+        _wlmtk_layout_epoch_handle_destroy);
+    bs_dllist_push_back(
+        &_wlmtk_layout_epoch_dispatchers,
+        &dispatcher_ptr->dlnode);
+    return dispatcher_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Destroys the dispatcher. Remaining subscribers are detached, so that their
+ * later @ref wlmtk_util_disconnect_listener is a no-op.
+ *
+ * @param dispatcher_ptr
+ */
+void _wlmtk_layout_epoch_dispatcher_destroy(
+    wlmtk_layout_epoch_dispatcher_t *dispatcher_ptr)
+{
+    for (int i = 0; i < WLMTK_LAYOUT_EPOCH_STAGE_MAX; ++i) {
+        struct wl_list *list_ptr = &dispatcher_ptr->stages[i].listener_list;
+        while (!wl_list_empty(list_ptr)) wl_list_remove(list_ptr->next);
+    }
+    wlmtk_util_disconnect_listener(&dispatcher_ptr->destroy_listener);
+    wlmtk_util_disconnect_listener(&dispatcher_ptr->change_listener);
+    bs_dllist_remove(
+        &_wlmtk_layout_epoch_dispatchers,
+        &dispatcher_ptr->dlnode);
+
+    if (NULL != dispatcher_ptr->diff_wlr_output_ptrs) {
+        free(dispatcher_ptr->diff_wlr_output_ptrs);
+        dispatcher_ptr->diff_wlr_output_ptrs = NULL;
+    }
+    if (NULL != dispatcher_ptr->outputs) {
+        free(dispatcher_ptr->outputs);
+        dispatcher_ptr->outputs = NULL;
+    }
+    free(dispatcher_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Takes a snapshot of the outputs currently in the layout.
+ *
+ * @param dispatcher_ptr
+ * @param outputs_ptr         Set to a newly allocated array, or NULL if the
+ *                            layout is empty. To be released by free().
+ * @param outputs_size_ptr    Set to the number of elements.
+ *
+ * @return true on success.
+ */
+bool _wlmtk_layout_epoch_snapshot(
+    wlmtk_layout_epoch_dispatcher_t *dispatcher_ptr,
+    wlmtk_layout_epoch_output_t **outputs_ptr,
+    size_t *outputs_size_ptr)
+{
+    struct wlr_output_layout *wlr_output_layout_ptr =
+        dispatcher_ptr->wlr_output_layout_ptr;
+    *outputs_ptr = NULL;
+    *outputs_size_ptr = wl_list_length(&wlr_output_layout_ptr->outputs);
+    if (0 == *outputs_size_ptr) return true;
+
+    *outputs_ptr = logged_calloc(
+        *outputs_size_ptr, sizeof(wlmtk_layout_epoch_output_t));
+    if (NULL == *outputs_ptr) return false;
+
+    size_t i = 0;
+    struct wlr_output_layout_output *wlr_output_layout_output_ptr;
+    wl_list_for_each(wlr_output_layout_output_ptr,
+                     &wlr_output_layout_ptr->outputs,
+                     link) {
+        wlmtk_layout_epoch_output_t *o_ptr = &(*outputs_ptr)[i++];
+        o_ptr->wlr_output_ptr = wlr_output_layout_output_ptr->output;
+        wlr_output_layout_get_box(
+            wlr_output_layout_ptr, o_ptr->wlr_output_ptr, &o_ptr->box);
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Whether an output of the most recent epoch left the layout. */
+bool _wlmtk_layout_epoch_has_removals(
+    wlmtk_layout_epoch_dispatcher_t *dispatcher_ptr)
+{
+    for (size_t i = 0; i < dispatcher_ptr->outputs_size; ++i) {
+        // wlr_output_layout_get() only compares the pointer.
+        if (NULL == wlr_output_layout_get(
+                dispatcher_ptr->wlr_output_layout_ptr,
+                dispatcher_ptr->outputs[i].wlr_output_ptr)) return true;
+    }
+    return false;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Runs an epoch: Updates the diff, and notifies the stages in order.
+ *
+ * Changes to the layout raised by a subscriber are picked up by another
+ * epoch, once all stages of the current one are through.
+ *
+ * @param dispatcher_ptr
+ */
+void _wlmtk_layout_epoch_dispatch(
+    wlmtk_layout_epoch_dispatcher_t *dispatcher_ptr)
+{
+    dispatcher_ptr->pending = true;
+    if (dispatcher_ptr->dispatching) return;
+
+    dispatcher_ptr->dispatching = true;
+    while (dispatcher_ptr->pending) {
+        dispatcher_ptr->pending = false;
+        _wlmtk_layout_epoch_update_diff(dispatcher_ptr);
+        WLMTK_TRACE_SPAN("layout_epoch");
+        for (int i = 0; i < WLMTK_LAYOUT_EPOCH_STAGE_MAX; ++i) {
+            wl_signal_emit(&dispatcher_ptr->stages[i],
+                           dispatcher_ptr->wlr_output_layout_ptr);
+        }
+    }
+    dispatcher_ptr->dispatching = false;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Takes a new snapshot, and computes the diff to the former one. Keeps the
+ * former snapshot and reports an empty diff, if out of memory.
+ *
+ * @param dispatcher_ptr
+ */
+void _wlmtk_layout_epoch_update_diff(
+    wlmtk_layout_epoch_dispatcher_t *dispatcher_ptr)
+{
+    wlmtk_layout_epoch_diff_t *diff_ptr = &dispatcher_ptr->diff;
+    ++diff_ptr->epoch;
+    diff_ptr->added_size = 0;
+    diff_ptr->removed_size = 0;
+    diff_ptr->changed_size = 0;
+
+    wlmtk_layout_epoch_output_t *outputs;
+    size_t outputs_size;
+    if (!_wlmtk_layout_epoch_snapshot(
+            dispatcher_ptr, &outputs, &outputs_size)) return;
+
+    // Each output is either added, removed or changed: Has room for all.
+    size_t max_size = outputs_size + dispatcher_ptr->outputs_size;
+    struct wlr_output **wlr_output_ptrs = NULL;
+    if (0 < max_size) {
+        wlr_output_ptrs = logged_calloc(max_size, sizeof(struct wlr_output*));
+        if (NULL == wlr_output_ptrs) {
+            free(outputs);
+            return;
+        }
+    }
+    if (NULL != dispatcher_ptr->diff_wlr_output_ptrs) {
+        free(dispatcher_ptr->diff_wlr_output_ptrs);
+    }
+    dispatcher_ptr->diff_wlr_output_ptrs = wlr_output_ptrs;
+
+    // Added outputs are stored from the front, removed ones from the back.
+    diff_ptr->added_wlr_output_ptrs = wlr_output_ptrs;
+    for (size_t i = 0; i < outputs_size; ++i) {
+        const wlmtk_layout_epoch_output_t *former_ptr =
+            _wlmtk_layout_epoch_find(
+                dispatcher_ptr->outputs,
+                dispatcher_ptr->outputs_size,
+                outputs[i].wlr_output_ptr);
+        if (NULL == former_ptr) {
+            wlr_output_ptrs[diff_ptr->added_size++] =
+                outputs[i].wlr_output_ptr;
+        }
+    }
+    diff_ptr->changed_wlr_output_ptrs =
+        wlr_output_ptrs + diff_ptr->added_size;
+    for (size_t i = 0; i < outputs_size; ++i) {
+        const wlmtk_layout_epoch_output_t *former_ptr =
+            _wlmtk_layout_epoch_find(
+                dispatcher_ptr->outputs,
+                dispatcher_ptr->outputs_size,
+                outputs[i].wlr_output_ptr);
+        if (NULL != former_ptr &&
+            !wlr_box_equal(&former_ptr->box, &outputs[i].box)) {
+            diff_ptr->changed_wlr_output_ptrs[diff_ptr->changed_size++] =
+                outputs[i].wlr_output_ptr;
+        }
+    }
+    diff_ptr->removed_wlr_output_ptrs =
+        diff_ptr->changed_wlr_output_ptrs + diff_ptr->changed_size;
+    for (size_t i = 0; i < dispatcher_ptr->outputs_size; ++i) {
+        struct wlr_output *wlr_output_ptr =
+            dispatcher_ptr->outputs[i].wlr_output_ptr;
+        if (NULL == _wlmtk_layout_epoch_find(
+                outputs, outputs_size, wlr_output_ptr)) {
+            diff_ptr->removed_wlr_output_ptrs[diff_ptr->removed_size++] =
+                wlr_output_ptr;
+        }
+    }
+
+    if (NULL != dispatcher_ptr->outputs) free(dispatcher_ptr->outputs);
+    dispatcher_ptr->outputs = outputs;
+    dispatcher_ptr->outputs_size = outputs_size;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return The element of `outputs` for `wlr_output_ptr`, or NULL. */
+const wlmtk_layout_epoch_output_t *_wlmtk_layout_epoch_find(
+    const wlmtk_layout_epoch_output_t *outputs,
+    size_t outputs_size,
+    struct wlr_output *wlr_output_ptr)
+{
+    for (size_t i = 0; i < outputs_size; ++i) {
+        if (outputs[i].wlr_output_ptr == wlr_output_ptr) return &outputs[i];
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles `change` of `wlr_output_layout`: Runs an epoch right away, or
+ * schedules one if deferred.
+ *
+ * @param listener_ptr
+ * @param data_ptr
+ */
+void _wlmtk_layout_epoch_handle_change(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmtk_layout_epoch_dispatcher_t *dispatcher_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmtk_layout_epoch_dispatcher_t, change_listener);
+
+    if (NULL == _wlmtk_layout_epoch_event_loop_ptr ||
+        _wlmtk_layout_epoch_has_removals(dispatcher_ptr)) {
+        _wlmtk_layout_epoch_dispatch(dispatcher_ptr);
+        return;
+    }
+
+    dispatcher_ptr->pending = true;
+    if (NULL == _wlmtk_layout_epoch_idle_ptr) {
+        _wlmtk_layout_epoch_idle_ptr = wl_event_loop_add_idle(
+            _wlmtk_layout_epoch_event_loop_ptr,
+            _wlmtk_layout_epoch_handle_idle,
+            NULL);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles `destroy` of `wlr_output_layout`: Destroys the dispatcher. */
+void _wlmtk_layout_epoch_handle_destroy(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmtk_layout_epoch_dispatcher_t *dispatcher_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmtk_layout_epoch_dispatcher_t, destroy_listener);
+    _wlmtk_layout_epoch_dispatcher_destroy(dispatcher_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Idle callback of the event loop: Runs deferred epochs. */
+void _wlmtk_layout_epoch_handle_idle(__UNUSED__ void *data_ptr)
+{
+    _wlmtk_layout_epoch_idle_ptr = NULL;
+    wlmtk_layout_epoch_flush();
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_order_diff(bs_test_t *test_ptr);
+static void test_deferred(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_layout_epoch_test_cases[] = {
+    { 1, "order_diff", test_order_diff },
+    { 1, "deferred", test_deferred },
+    { 0, NULL, NULL }
+};
+
+/** A subscriber for tests: Records when it was notified. */
+typedef struct {
+    /** Listener. */
+    struct wl_listener        listener;
+    /** Number of notifications. */
+    int                       calls;
+    /** Value of @ref test_sequence at the most recent notification. */
+    int                       sequence;
+} test_subscriber_t;
+
+/** Sequence counter, to verify the order of notifications. */
+static int test_sequence;
+
+/* ------------------------------------------------------------------------- */
+/** Notifier for @ref test_subscriber_t. */
+static void test_handle_epoch(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    test_subscriber_t *s_ptr = BS_CONTAINER_OF(
+        listener_ptr, test_subscriber_t, listener);
+    ++s_ptr->calls;
+    s_ptr->sequence = ++test_sequence;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies stages are notified in order, and the diff is computed. */
+void test_order_diff(bs_test_t *test_ptr)
+{
+    struct wl_display *display_ptr = wl_display_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, display_ptr);
+    struct wlr_output_layout *wlr_output_layout_ptr =
+        wlr_output_layout_create(display_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_output_layout_ptr);
+
+    // Subscribe in reverse order, notification follows the stages.
+    test_subscriber_t workspaces = {}, outputs = {};
+    wlmtk_layout_epoch_connect(
+        wlr_output_layout_ptr, WLMTK_LAYOUT_EPOCH_STAGE_WORKSPACES,
+        &workspaces.listener, test_handle_epoch);
+    wlmtk_layout_epoch_connect(
+        wlr_output_layout_ptr, WLMTK_LAYOUT_EPOCH_STAGE_OUTPUTS,
+        &outputs.listener, test_handle_epoch);
+    const wlmtk_layout_epoch_diff_t *diff_ptr = wlmtk_layout_epoch_diff(
+        wlr_output_layout_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, diff_ptr);
+
+    struct wlr_output o1 = { .width = 1024, .height = 768, .scale = 1 };
+    wlmtk_test_wlr_output_init(&o1);
+    wlr_output_layout_add(wlr_output_layout_ptr, &o1, 0, 0);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, outputs.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, workspaces.calls);
+    BS_TEST_VERIFY_TRUE(test_ptr, outputs.sequence < workspaces.sequence);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, diff_ptr->added_size);
+    BS_TEST_VERIFY_EQ(test_ptr, &o1, diff_ptr->added_wlr_output_ptrs[0]);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, diff_ptr->removed_size);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, diff_ptr->changed_size);
+
+    // Moving the output reports it as changed.
+    wlr_output_layout_add(wlr_output_layout_ptr, &o1, 100, 0);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, outputs.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, diff_ptr->added_size);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, diff_ptr->changed_size);
+    BS_TEST_VERIFY_EQ(test_ptr, &o1, diff_ptr->changed_wlr_output_ptrs[0]);
+
+    wlr_output_layout_remove(wlr_output_layout_ptr, &o1);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, outputs.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, diff_ptr->removed_size);
+    BS_TEST_VERIFY_EQ(test_ptr, &o1, diff_ptr->removed_wlr_output_ptrs[0]);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, diff_ptr->epoch);
+
+    wlmtk_util_disconnect_listener(&outputs.listener);
+    // Destroying the layout detaches remaining subscribers.
+    wlr_output_layout_destroy(wlr_output_layout_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, workspaces.listener.link.prev);
+    wlmtk_util_disconnect_listener(&workspaces.listener);
+    wl_display_destroy(display_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies deferred changes are collapsed, except for removals. */
+void test_deferred(bs_test_t *test_ptr)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    struct wl_display *display_ptr = wl_display_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, display_ptr);
+    struct wlr_output_layout *wlr_output_layout_ptr =
+        wlr_output_layout_create(display_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_output_layout_ptr);
+
+    test_subscriber_t s = {};
+    wlmtk_layout_epoch_connect(
+        wlr_output_layout_ptr, WLMTK_LAYOUT_EPOCH_STAGE_LAYERS,
+        &s.listener, test_handle_epoch);
+    const wlmtk_layout_epoch_diff_t *diff_ptr = wlmtk_layout_epoch_diff(
+        wlr_output_layout_ptr);
+    wlmtk_layout_epoch_defer(wl_event_loop_ptr);
+
+    // Two outputs added, and one moved: A single epoch, from the idle.
+    struct wlr_output o1 = { .width = 1024, .height = 768, .scale = 1 };
+    wlmtk_test_wlr_output_init(&o1);
+    struct wlr_output o2 = { .width = 640, .height = 480, .scale = 1 };
+    wlmtk_test_wlr_output_init(&o2);
+    wlr_output_layout_add(wlr_output_layout_ptr, &o1, 0, 0);
+    wlr_output_layout_add(wlr_output_layout_ptr, &o2, 1024, 0);
+    wlr_output_layout_add(wlr_output_layout_ptr, &o1, 0, 100);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, s.calls);
+    wl_event_loop_dispatch_idle(wl_event_loop_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, s.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, diff_ptr->added_size);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, diff_ptr->changed_size);
+
+    // Removal runs the pending changes right away.
+    wlr_output_layout_add(wlr_output_layout_ptr, &o1, 0, 0);
+    wlr_output_layout_remove(wlr_output_layout_ptr, &o2);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, s.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, diff_ptr->changed_size);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, diff_ptr->removed_size);
+
+    // Disabling flushes.
+    wlr_output_layout_add(wlr_output_layout_ptr, &o1, 0, 10);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, s.calls);
+    wlmtk_layout_epoch_defer(NULL);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, s.calls);
+
+    wlmtk_util_disconnect_listener(&s.listener);
+    wlr_output_layout_destroy(wlr_output_layout_ptr);
+    wl_display_destroy(display_ptr);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
+/* == End of layout_epoch.c ================================================ */
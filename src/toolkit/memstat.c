@@ -0,0 +1,350 @@
+/* ========================================================================= */
+/**
+ * @file memstat.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "memstat.h"
+
+#include <inttypes.h>
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <wayland-util.h>
+#define WLR_USE_UNSTABLE
+#include <wlr/types/wlr_scene.h>
+#undef WLR_USE_UNSTABLE
+
+/* == Declarations ========================================================= */
+
+/** Memory accounted to a client. */
+typedef struct {
+    /** Node within @ref _wlmtk_memstat_clients. */
+    bs_dllist_node_t          dlnode;
+    /** The client. */
+    wlmtk_util_client_t       client;
+    /** Bytes accounted, per subsystem. */
+    size_t                    bytes[WLMTK_MEMSTAT_SUBSYSTEMS];
+} wlmtk_memstat_client_t;
+
+static wlmtk_memstat_client_t *_wlmtk_memstat_client(pid_t pid, bool create);
+
+/* == Data ================================================================= */
+
+/** Statistics, per subsystem. */
+static wlmtk_memstat_stats_t  _wlmtk_memstat_stats[WLMTK_MEMSTAT_SUBSYSTEMS];
+
+/**
+ * Clients that have memory accounted. Records are removed once no memory is
+ * accounted to them. See @ref wlmtk_memstat_client_t::dlnode.
+ */
+static bs_dllist_t            _wlmtk_memstat_clients;
+
+/** Names of the subsystems, for reporting. */
+static const char *_wlmtk_memstat_names[WLMTK_MEMSTAT_SUBSYSTEMS] = {
+    [WLMTK_MEMSTAT_UNTAGGED] = "untagged",
+    [WLMTK_MEMSTAT_DECORATIONS] = "decorations",
+    [WLMTK_MEMSTAT_MENUS] = "menus",
+    [WLMTK_MEMSTAT_IMAGES] = "images",
+    [WLMTK_MEMSTAT_TILES] = "tiles",
+    [WLMTK_MEMSTAT_ICONS] = "icons",
+};
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_memstat_add(
+    wlmtk_memstat_subsystem_t subsystem,
+    const wlmtk_util_client_t *client_ptr,
+    size_t bytes)
+{
+    BS_ASSERT(subsystem < WLMTK_MEMSTAT_SUBSYSTEMS);
+    wlmtk_memstat_stats_t *stats_ptr = &_wlmtk_memstat_stats[subsystem];
+    stats_ptr->bytes += bytes;
+    stats_ptr->peak_bytes = BS_MAX(stats_ptr->peak_bytes, stats_ptr->bytes);
+    stats_ptr->allocations++;
+
+    if (NULL == client_ptr) return;
+    wlmtk_memstat_client_t *c_ptr = _wlmtk_memstat_client(
+        client_ptr->pid, true);
+    if (NULL == c_ptr) return;
+    c_ptr->client = *client_ptr;
+    c_ptr->bytes[subsystem] += bytes;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_memstat_remove(
+    wlmtk_memstat_subsystem_t subsystem,
+    const wlmtk_util_client_t *client_ptr,
+    size_t bytes)
+{
+    BS_ASSERT(subsystem < WLMTK_MEMSTAT_SUBSYSTEMS);
+    wlmtk_memstat_stats_t *stats_ptr = &_wlmtk_memstat_stats[subsystem];
+    stats_ptr->bytes -= BS_MIN(stats_ptr->bytes, bytes);
+    if (0 < stats_ptr->allocations) stats_ptr->allocations--;
+
+    if (NULL == client_ptr) return;
+    wlmtk_memstat_client_t *c_ptr = _wlmtk_memstat_client(
+        client_ptr->pid, false);
+    if (NULL == c_ptr) return;
+    c_ptr->bytes[subsystem] -= BS_MIN(c_ptr->bytes[subsystem], bytes);
+    for (size_t i = 0; i < WLMTK_MEMSTAT_SUBSYSTEMS; ++i) {
+        if (0 < c_ptr->bytes[i]) return;
+    }
+    bs_dllist_remove(&_wlmtk_memstat_clients, &c_ptr->dlnode);
+    free(c_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_memstat_get_stats(
+    wlmtk_memstat_subsystem_t subsystem,
+    wlmtk_memstat_stats_t *stats_ptr)
+{
+    BS_ASSERT(subsystem < WLMTK_MEMSTAT_SUBSYSTEMS);
+    *stats_ptr = _wlmtk_memstat_stats[subsystem];
+}
+
+/* ------------------------------------------------------------------------- */
+const char *wlmtk_memstat_subsystem_name(wlmtk_memstat_subsystem_t subsystem)
+{
+    BS_ASSERT(subsystem < WLMTK_MEMSTAT_SUBSYSTEMS);
+    return _wlmtk_memstat_names[subsystem];
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_memstat_client_bytes(pid_t pid)
+{
+    wlmtk_memstat_client_t *c_ptr = _wlmtk_memstat_client(pid, false);
+    if (NULL == c_ptr) return 0;
+    size_t bytes = 0;
+    for (size_t i = 0; i < WLMTK_MEMSTAT_SUBSYSTEMS; ++i) {
+        bytes += c_ptr->bytes[i];
+    }
+    return bytes;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_memstat_log_stats(bs_log_severity_t severity)
+{
+    for (size_t i = 0; i < WLMTK_MEMSTAT_SUBSYSTEMS; ++i) {
+        const wlmtk_memstat_stats_t *s_ptr = &_wlmtk_memstat_stats[i];
+        bs_log(severity, "Memory %s: %zu bytes in %zu allocations "
+               "(peak %zu bytes)",
+               _wlmtk_memstat_names[i], s_ptr->bytes, s_ptr->allocations,
+               s_ptr->peak_bytes);
+    }
+    for (bs_dllist_node_t *dlnode_ptr = _wlmtk_memstat_clients.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_memstat_client_t *c_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_memstat_client_t, dlnode);
+        bs_log(severity, "Memory of client PID %"PRIdMAX" (UID %"PRIdMAX"): "
+               "%zu bytes",
+               (intmax_t)c_ptr->client.pid, (intmax_t)c_ptr->client.uid,
+               wlmtk_memstat_client_bytes(c_ptr->client.pid));
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_memstat_footprint_add_struct(
+    wlmtk_memstat_footprint_t *footprint_ptr,
+    size_t bytes)
+{
+    footprint_ptr->structs++;
+    footprint_ptr->struct_bytes += bytes;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_memstat_footprint_add_buffer(
+    wlmtk_memstat_footprint_t *footprint_ptr,
+    size_t bytes,
+    bool shared)
+{
+    if (0 == bytes) return;
+    if (shared) {
+        footprint_ptr->shared_buffers++;
+        footprint_ptr->shared_buffer_bytes += bytes;
+    } else {
+        footprint_ptr->buffers++;
+        footprint_ptr->buffer_bytes += bytes;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_memstat_footprint_add_scene_node(
+    wlmtk_memstat_footprint_t *footprint_ptr,
+    struct wlr_scene_node *wlr_scene_node_ptr,
+    struct wlr_scene_node *skip_wlr_scene_node_ptr)
+{
+    if (NULL == wlr_scene_node_ptr ||
+        skip_wlr_scene_node_ptr == wlr_scene_node_ptr) return;
+
+    footprint_ptr->scene_nodes++;
+    switch (wlr_scene_node_ptr->type) {
+    case WLR_SCENE_NODE_TREE: {
+        struct wlr_scene_tree *wlr_scene_tree_ptr = wlr_scene_tree_from_node(
+            wlr_scene_node_ptr);
+        footprint_ptr->scene_node_bytes += sizeof(struct wlr_scene_tree);
+        struct wlr_scene_node *child_ptr;
+        wl_list_for_each(child_ptr, &wlr_scene_tree_ptr->children, link) {
+            wlmtk_memstat_footprint_add_scene_node(
+                footprint_ptr, child_ptr, skip_wlr_scene_node_ptr);
+        }
+        break;
+    }
+    case WLR_SCENE_NODE_RECT:
+        footprint_ptr->scene_node_bytes += sizeof(struct wlr_scene_rect);
+        break;
+    case WLR_SCENE_NODE_BUFFER:
+        footprint_ptr->scene_node_bytes += sizeof(struct wlr_scene_buffer);
+        break;
+    default:
+        footprint_ptr->scene_node_bytes += sizeof(struct wlr_scene_node);
+        break;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_memstat_footprint_bytes(
+    const wlmtk_memstat_footprint_t *footprint_ptr)
+{
+    return footprint_ptr->struct_bytes + footprint_ptr->scene_node_bytes +
+        footprint_ptr->buffer_bytes + footprint_ptr->shared_buffer_bytes;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_memstat_footprint_log(
+    const wlmtk_memstat_footprint_t *footprint_ptr,
+    bs_log_severity_t severity,
+    const char *name_ptr)
+{
+    bs_log(severity, "Footprint of %s: %zu bytes. %zu structs with %zu "
+           "bytes, %zu scene nodes with %zu bytes, %zu buffers with %zu "
+           "bytes, %zu shared buffers with %zu bytes",
+           name_ptr, wlmtk_memstat_footprint_bytes(footprint_ptr),
+           footprint_ptr->structs, footprint_ptr->struct_bytes,
+           footprint_ptr->scene_nodes, footprint_ptr->scene_node_bytes,
+           footprint_ptr->buffers, footprint_ptr->buffer_bytes,
+           footprint_ptr->shared_buffers, footprint_ptr->shared_buffer_bytes);
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Finds the record of the client with process ID `pid`.
+ *
+ * @param pid
+ * @param create              Whether to create the record if not found.
+ *
+ * @return The record, or NULL if not found or on error.
+ */
+wlmtk_memstat_client_t *_wlmtk_memstat_client(pid_t pid, bool create)
+{
+    for (bs_dllist_node_t *dlnode_ptr = _wlmtk_memstat_clients.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_memstat_client_t *c_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_memstat_client_t, dlnode);
+        if (c_ptr->client.pid == pid) return c_ptr;
+    }
+    if (!create) return NULL;
+
+    wlmtk_memstat_client_t *c_ptr = logged_calloc(
+        1, sizeof(wlmtk_memstat_client_t));
+    if (NULL == c_ptr) return NULL;
+    c_ptr->client.pid = pid;
+    bs_dllist_push_back(&_wlmtk_memstat_clients, &c_ptr->dlnode);
+    return c_ptr;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_account(bs_test_t *test_ptr);
+static void test_footprint(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_memstat_test_cases[] = {
+    { 1, "account", test_account },
+    { 1, "footprint", test_footprint },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Exercises accounting per subsystem and per client. */
+void test_account(bs_test_t *test_ptr)
+{
+    wlmtk_util_client_t client = { .pid = 42, .uid = 1000 };
+    wlmtk_memstat_stats_t s, initial;
+    wlmtk_memstat_get_stats(WLMTK_MEMSTAT_MENUS, &initial);
+
+    wlmtk_memstat_add(WLMTK_MEMSTAT_MENUS, NULL, 100);
+    wlmtk_memstat_add(WLMTK_MEMSTAT_MENUS, &client, 50);
+    wlmtk_memstat_add(WLMTK_MEMSTAT_ICONS, &client, 10);
+    wlmtk_memstat_get_stats(WLMTK_MEMSTAT_MENUS, &s);
+    BS_TEST_VERIFY_EQ(test_ptr, initial.bytes + 150, s.bytes);
+    BS_TEST_VERIFY_EQ(test_ptr, initial.allocations + 2, s.allocations);
+    BS_TEST_VERIFY_EQ(test_ptr, 60, wlmtk_memstat_client_bytes(42));
+
+    wlmtk_memstat_remove(WLMTK_MEMSTAT_MENUS, &client, 50);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, wlmtk_memstat_client_bytes(42));
+    wlmtk_memstat_remove(WLMTK_MEMSTAT_ICONS, &client, 10);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_memstat_client_bytes(42));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, _wlmtk_memstat_client(42, false));
+
+    wlmtk_memstat_remove(WLMTK_MEMSTAT_MENUS, NULL, 100);
+    wlmtk_memstat_get_stats(WLMTK_MEMSTAT_MENUS, &s);
+    BS_TEST_VERIFY_EQ(test_ptr, initial.bytes, s.bytes);
+    BS_TEST_VERIFY_TRUE(test_ptr, initial.bytes + 150 <= s.peak_bytes);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Exercises summing up a footprint, from structs, buffers and nodes. */
+void test_footprint(bs_test_t *test_ptr)
+{
+    wlmtk_memstat_footprint_t fp = {};
+    wlmtk_memstat_footprint_add_struct(&fp, 100);
+    wlmtk_memstat_footprint_add_buffer(&fp, 40, false);
+    wlmtk_memstat_footprint_add_buffer(&fp, 0, false);
+    wlmtk_memstat_footprint_add_buffer(&fp, 20, true);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, fp.buffers);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, fp.shared_buffers);
+    BS_TEST_VERIFY_EQ(test_ptr, 160, wlmtk_memstat_footprint_bytes(&fp));
+
+    // A tree with a rect, and a skipped subtree.
+    struct wlr_scene *wlr_scene_ptr = wlr_scene_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_scene_ptr);
+    struct wlr_scene_tree *tree_ptr = wlr_scene_tree_create(
+        &wlr_scene_ptr->tree);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, tree_ptr);
+    float color[4] = {};
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL, wlr_scene_rect_create(tree_ptr, 1, 1, color));
+    struct wlr_scene_tree *skip_tree_ptr = wlr_scene_tree_create(tree_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, skip_tree_ptr);
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL, wlr_scene_rect_create(skip_tree_ptr, 1, 1, color));
+    wlmtk_memstat_footprint_add_scene_node(
+        &fp, &tree_ptr->node, &skip_tree_ptr->node);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, fp.scene_nodes);
+    BS_TEST_VERIFY_EQ(
+        test_ptr,
+        sizeof(struct wlr_scene_tree) + sizeof(struct wlr_scene_rect),
+        fp.scene_node_bytes);
+    wlr_scene_node_destroy(&wlr_scene_ptr->tree.node);
+}
+
+/* == End of memstat.c ===================================================== */
@@ -23,6 +23,11 @@
 #include <libbase/libbase.h>
 #include <linux/input-event-codes.h>
 #include <stdlib.h>
+#include <wayland-server-protocol.h>
+#define WLR_USE_UNSTABLE
+#include <wlr/types/wlr_pointer.h>
+#include <wlr/version.h>
+#undef WLR_USE_UNSTABLE
 
 #include "input.h"
 
@@ -47,29 +52,55 @@ struct _wlmtk_menu_t {
     bs_dllist_t               items;
     /** The currently-highlighted menu item, or NULL if none. */
     wlmtk_menu_item_t         *highlighted_menu_item_ptr;
+    /** First of the items shown in @ref wlmtk_menu_t::box. NULL if none. */
+    bs_dllist_node_t          *first_dlnode_ptr;
+    /** Last of the items shown in @ref wlmtk_menu_t::box. NULL if none. */
+    bs_dllist_node_t          *last_dlnode_ptr;
+    /** Number of items shown in @ref wlmtk_menu_t::box. */
+    size_t                    shown_items;
     /** Current mode of the menu. */
     enum wlmtk_menu_mode      mode;
 };
 
+static void _wlmtk_menu_detach_item(
+    wlmtk_menu_t *menu_ptr,
+    wlmtk_menu_item_t *menu_item_ptr);
 static void _wlmtk_menu_eliminate_item(
     bs_dllist_node_t *dlnode_ptr,
     void *ud_ptr);
 static void _wlmtk_menu_set_item_mode(
     bs_dllist_node_t *dlnode_ptr,
     void *ud_ptr);
+static bool _wlmtk_menu_full(wlmtk_menu_t *menu_ptr);
+static void _wlmtk_menu_show_item(
+    wlmtk_menu_t *menu_ptr,
+    bs_dllist_node_t *dlnode_ptr,
+    bool front);
+static void _wlmtk_menu_hide_item(
+    wlmtk_menu_t *menu_ptr,
+    bs_dllist_node_t *dlnode_ptr);
+static void _wlmtk_menu_park_item(
+    wlmtk_menu_t *menu_ptr,
+    bs_dllist_node_t *dlnode_ptr);
+static void _wlmtk_menu_fill(wlmtk_menu_t *menu_ptr);
+static void _wlmtk_menu_scroll(wlmtk_menu_t *menu_ptr, int steps);
 
 static void _wlmtk_menu_element_destroy(
     wlmtk_element_t *element_ptr);
 static bool _wlmtk_menu_element_pointer_button(
     wlmtk_element_t *element_ptr,
     const wlmtk_button_event_t *button_event_ptr);
+static bool _wlmtk_menu_element_pointer_axis(
+    wlmtk_element_t *element_ptr,
+    struct wlr_pointer_axis_event *wlr_pointer_axis_event_ptr);
 
 /* == Data ================================================================= */
 
 /** The superclass' element virtual method table. */
 static const wlmtk_element_vmt_t _wlmtk_menu_element_vmt = {
     .destroy = _wlmtk_menu_element_destroy,
-    .pointer_button = _wlmtk_menu_element_pointer_button
+    .pointer_button = _wlmtk_menu_element_pointer_button,
+    .pointer_axis = _wlmtk_menu_element_pointer_axis
 };
 
 /* == Exported methods ===================================================== */
@@ -180,12 +211,14 @@ enum wlmtk_menu_mode wlmtk_menu_get_mode(wlmtk_menu_t *menu_ptr)
 void wlmtk_menu_add_item(wlmtk_menu_t *menu_ptr,
                          wlmtk_menu_item_t *menu_item_ptr)
 {
-    bs_dllist_push_back(
-        &menu_ptr->items,
-        wlmtk_dlnode_from_menu_item(menu_item_ptr));
-    wlmtk_box_add_element_back(
-        &menu_ptr->box,
-        wlmtk_menu_item_element(menu_item_ptr));
+    bs_dllist_node_t *dlnode_ptr = wlmtk_dlnode_from_menu_item(menu_item_ptr);
+    bs_dllist_push_back(&menu_ptr->items, dlnode_ptr);
+    // All items are shown, unless the menu is full: This one is at the back.
+    if (_wlmtk_menu_full(menu_ptr)) {
+        wlmtk_menu_item_set_parked(menu_item_ptr, true);
+    } else {
+        _wlmtk_menu_show_item(menu_ptr, dlnode_ptr, false);
+    }
     wlmtk_menu_item_set_mode(menu_item_ptr, menu_ptr->mode);
     wlmtk_menu_item_set_parent_menu(menu_item_ptr, menu_ptr);
 }
@@ -194,16 +227,8 @@ void wlmtk_menu_add_item(wlmtk_menu_t *menu_ptr,
 void wlmtk_menu_remove_item(wlmtk_menu_t *menu_ptr,
                             wlmtk_menu_item_t *menu_item_ptr)
 {
-    if (menu_ptr->highlighted_menu_item_ptr == menu_item_ptr) {
-        menu_ptr->highlighted_menu_item_ptr = NULL;
-    }
-    wlmtk_menu_item_set_parent_menu(menu_item_ptr, NULL);
-    wlmtk_box_remove_element(
-        &menu_ptr->box,
-        wlmtk_menu_item_element(menu_item_ptr));
-    bs_dllist_remove(
-        &menu_ptr->items,
-        wlmtk_dlnode_from_menu_item(menu_item_ptr));
+    _wlmtk_menu_detach_item(menu_ptr, menu_item_ptr);
+    _wlmtk_menu_fill(menu_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -227,6 +252,23 @@ void wlmtk_menu_request_item_highlight(
 
 /* == Local (static) methods =============================================== */
 
+/* ------------------------------------------------------------------------- */
+/** Removes the item from the menu, without showing further items. */
+void _wlmtk_menu_detach_item(
+    wlmtk_menu_t *menu_ptr,
+    wlmtk_menu_item_t *menu_item_ptr)
+{
+    if (menu_ptr->highlighted_menu_item_ptr == menu_item_ptr) {
+        menu_ptr->highlighted_menu_item_ptr = NULL;
+    }
+    wlmtk_menu_item_set_parent_menu(menu_item_ptr, NULL);
+    bs_dllist_node_t *dlnode_ptr = wlmtk_dlnode_from_menu_item(menu_item_ptr);
+    if (NULL != wlmtk_menu_item_element(menu_item_ptr)->parent_container_ptr) {
+        _wlmtk_menu_hide_item(menu_ptr, dlnode_ptr);
+    }
+    bs_dllist_remove(&menu_ptr->items, dlnode_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Callback for bs_dllist_for_each: Removes item from items, destroys it. */
 void _wlmtk_menu_eliminate_item(bs_dllist_node_t *dlnode_ptr, void *ud_ptr)
@@ -234,7 +276,7 @@ void _wlmtk_menu_eliminate_item(bs_dllist_node_t *dlnode_ptr, void *ud_ptr)
     wlmtk_menu_item_t *item_ptr = wlmtk_menu_item_from_dlnode(dlnode_ptr);
     wlmtk_menu_t *menu_ptr = ud_ptr;
 
-    wlmtk_menu_remove_item(menu_ptr, item_ptr);
+    _wlmtk_menu_detach_item(menu_ptr, item_ptr);
     wlmtk_element_destroy(wlmtk_menu_item_element(item_ptr));
 }
 
@@ -252,6 +294,139 @@ void _wlmtk_menu_set_item_mode(bs_dllist_node_t *dlnode_ptr, void *ud_ptr)
         ((wlmtk_menu_t*)ud_ptr)->mode);
 }
 
+/* ------------------------------------------------------------------------- */
+/** @return whether the menu shows @ref wlmtk_menu_style_t::max_items. */
+bool _wlmtk_menu_full(wlmtk_menu_t *menu_ptr)
+{
+    return (0 < menu_ptr->style.max_items &&
+            menu_ptr->shown_items >= menu_ptr->style.max_items);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Shows the item, by adding it to the box. Must be adjacent to the items
+ * already shown.
+ *
+ * @param menu_ptr
+ * @param dlnode_ptr
+ * @param front               Whether to add the item before the first item
+ *                            shown. Otherwise, adds it after the last.
+ */
+void _wlmtk_menu_show_item(
+    wlmtk_menu_t *menu_ptr,
+    bs_dllist_node_t *dlnode_ptr,
+    bool front)
+{
+    wlmtk_menu_item_t *item_ptr = wlmtk_menu_item_from_dlnode(dlnode_ptr);
+    wlmtk_menu_item_set_parked(item_ptr, false);
+
+    if (front) {
+        wlmtk_box_add_element_front(
+            &menu_ptr->box, wlmtk_menu_item_element(item_ptr));
+        menu_ptr->first_dlnode_ptr = dlnode_ptr;
+        if (NULL == menu_ptr->last_dlnode_ptr) {
+            menu_ptr->last_dlnode_ptr = dlnode_ptr;
+        }
+    } else {
+        wlmtk_box_add_element_back(
+            &menu_ptr->box, wlmtk_menu_item_element(item_ptr));
+        menu_ptr->last_dlnode_ptr = dlnode_ptr;
+        if (NULL == menu_ptr->first_dlnode_ptr) {
+            menu_ptr->first_dlnode_ptr = dlnode_ptr;
+        }
+    }
+    menu_ptr->shown_items++;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Removes the shown item from the box. */
+void _wlmtk_menu_hide_item(
+    wlmtk_menu_t *menu_ptr,
+    bs_dllist_node_t *dlnode_ptr)
+{
+    if (1 >= menu_ptr->shown_items) {
+        menu_ptr->first_dlnode_ptr = NULL;
+        menu_ptr->last_dlnode_ptr = NULL;
+    } else if (dlnode_ptr == menu_ptr->first_dlnode_ptr) {
+        menu_ptr->first_dlnode_ptr = dlnode_ptr->next_ptr;
+    } else if (dlnode_ptr == menu_ptr->last_dlnode_ptr) {
+        menu_ptr->last_dlnode_ptr = dlnode_ptr->prev_ptr;
+    }
+
+    wlmtk_box_remove_element(
+        &menu_ptr->box,
+        wlmtk_menu_item_element(wlmtk_menu_item_from_dlnode(dlnode_ptr)));
+    menu_ptr->shown_items--;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Hides the item and parks it. Ends a highlight it may have. */
+void _wlmtk_menu_park_item(
+    wlmtk_menu_t *menu_ptr,
+    bs_dllist_node_t *dlnode_ptr)
+{
+    wlmtk_menu_item_t *item_ptr = wlmtk_menu_item_from_dlnode(dlnode_ptr);
+    if (menu_ptr->highlighted_menu_item_ptr == item_ptr) {
+        wlmtk_menu_request_item_highlight(menu_ptr, NULL);
+    }
+    _wlmtk_menu_hide_item(menu_ptr, dlnode_ptr);
+    wlmtk_menu_item_set_parked(item_ptr, true);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Shows further items adjacent to those shown, until the menu is full or
+ * all items are shown. Prefers items after the last shown.
+ *
+ * @param menu_ptr
+ */
+void _wlmtk_menu_fill(wlmtk_menu_t *menu_ptr)
+{
+    while (!_wlmtk_menu_full(menu_ptr)) {
+        if (NULL == menu_ptr->last_dlnode_ptr) {
+            if (NULL == menu_ptr->items.head_ptr) return;
+            _wlmtk_menu_show_item(menu_ptr, menu_ptr->items.head_ptr, false);
+        } else if (NULL != menu_ptr->last_dlnode_ptr->next_ptr) {
+            _wlmtk_menu_show_item(
+                menu_ptr, menu_ptr->last_dlnode_ptr->next_ptr, false);
+        } else if (NULL != menu_ptr->first_dlnode_ptr->prev_ptr) {
+            _wlmtk_menu_show_item(
+                menu_ptr, menu_ptr->first_dlnode_ptr->prev_ptr, true);
+        } else {
+            return;
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Scrolls the items shown by `steps` items, as far as there are items. Each
+ * step shows one item at one end and parks the item at the other end, so
+ * the cost does not depend on the number of items in the menu.
+ *
+ * @param menu_ptr
+ * @param steps               Positive values scroll towards the last item.
+ */
+void _wlmtk_menu_scroll(wlmtk_menu_t *menu_ptr, int steps)
+{
+    for (; 0 < steps &&
+             NULL != menu_ptr->last_dlnode_ptr &&
+             NULL != menu_ptr->last_dlnode_ptr->next_ptr; --steps) {
+        bs_dllist_node_t *dlnode_ptr = menu_ptr->first_dlnode_ptr;
+        _wlmtk_menu_show_item(
+            menu_ptr, menu_ptr->last_dlnode_ptr->next_ptr, false);
+        _wlmtk_menu_park_item(menu_ptr, dlnode_ptr);
+    }
+    for (; 0 > steps &&
+             NULL != menu_ptr->first_dlnode_ptr &&
+             NULL != menu_ptr->first_dlnode_ptr->prev_ptr; ++steps) {
+        bs_dllist_node_t *dlnode_ptr = menu_ptr->last_dlnode_ptr;
+        _wlmtk_menu_show_item(
+            menu_ptr, menu_ptr->first_dlnode_ptr->prev_ptr, true);
+        _wlmtk_menu_park_item(menu_ptr, dlnode_ptr);
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 /** Wraps to dtor. Implements @ref wlmtk_element_vmt_t::destroy. */
 void _wlmtk_menu_element_destroy(
@@ -294,14 +469,55 @@ bool _wlmtk_menu_element_pointer_button(
     return rv;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Scrolls the menu on vertical wheel moves, if it has more items than it
+ * shows. Acts on whole steps only, see @ref wlmtk_pointer_axis_steps.
+ *
+ * Implementation of @ref wlmtk_element_vmt_t::pointer_axis.
+ *
+ * @param element_ptr
+ * @param wlr_pointer_axis_event_ptr
+ *
+ * @return whether the axis event was claimed.
+ */
+bool _wlmtk_menu_element_pointer_axis(
+    wlmtk_element_t *element_ptr,
+    struct wlr_pointer_axis_event *wlr_pointer_axis_event_ptr)
+{
+    wlmtk_menu_t *menu_ptr = BS_CONTAINER_OF(
+        element_ptr, wlmtk_menu_t, super_pane.super_container.super_element);
+
+    if (menu_ptr->orig_element_vmt.pointer_axis(
+            element_ptr, wlr_pointer_axis_event_ptr)) return true;
+
+    if (0 == menu_ptr->style.max_items ||
+#if WLR_VERSION_NUM >= (18 << 8)
+        WL_POINTER_AXIS_VERTICAL_SCROLL !=
+        wlr_pointer_axis_event_ptr->orientation
+#else // WLR_VERSION_NUM >= (18 << 8)
+        WLR_AXIS_ORIENTATION_VERTICAL !=
+        wlr_pointer_axis_event_ptr->orientation
+#endif // WLR_VERSION_NUM >= (18 << 8)
+        ) {
+        return false;
+    }
+
+    _wlmtk_menu_scroll(
+        menu_ptr, wlmtk_pointer_axis_steps(wlr_pointer_axis_event_ptr));
+    return true;
+}
+
 /* == Unit tests =========================================================== */
 
 static void test_pointer_highlight(bs_test_t *test_ptr);
 static void test_set_mode(bs_test_t *test_ptr);
+static void test_scroll(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_menu_test_cases[] = {
     { 1, "pointer_highlight", test_pointer_highlight },
     { 1, "set_mode", test_set_mode },
+    { 1, "scroll", test_scroll },
     { 0, NULL, NULL }
 };
 
@@ -426,4 +642,75 @@ void test_set_mode(bs_test_t *test_ptr)
     wlmtk_menu_destroy(menu_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests that a menu shows up to `max_items`, and scrolls through the rest. */
+void test_scroll(bs_test_t *test_ptr)
+{
+    wlmtk_menu_style_t style = _test_style;
+    style.max_items = 2;
+    wlmtk_menu_t *menu_ptr = wlmtk_menu_create(&style);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, menu_ptr);
+    wlmtk_element_t *me = wlmtk_menu_element(menu_ptr);
+
+    wlmtk_menu_item_t *i[4];
+    wlmtk_element_t *e[4];
+    for (size_t n = 0; n < 4; ++n) {
+        i[n] = wlmtk_menu_item_create(&_test_style.item);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, i[n]);
+        wlmtk_menu_add_item(menu_ptr, i[n]);
+        e[n] = wlmtk_menu_item_element(i[n]);
+    }
+
+    // Shows only the first two items.
+    BS_TEST_VERIFY_EQ(test_ptr, 2, menu_ptr->shown_items);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, e[0]->parent_container_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, e[1]->parent_container_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, e[2]->parent_container_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, e[3]->parent_container_ptr);
+
+    struct wlr_pointer_axis_event axis_event = {
+#if WLR_VERSION_NUM >= (18 << 8)
+        .source = WL_POINTER_AXIS_SOURCE_WHEEL,
+        .orientation = WL_POINTER_AXIS_VERTICAL_SCROLL,
+#else // WLR_VERSION_NUM >= (18 << 8)
+        .source = WLR_AXIS_SOURCE_WHEEL,
+        .orientation = WLR_AXIS_ORIENTATION_VERTICAL,
+#endif // WLR_VERSION_NUM >= (18 << 8)
+        .delta = 0.01
+    };
+
+    // Highlight the first item, then scroll down: Ends highlight.
+    wlmtk_menu_request_item_highlight(menu_ptr, i[0]);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_element_pointer_axis(me, &axis_event));
+    BS_TEST_VERIFY_EQ(test_ptr, 2, menu_ptr->shown_items);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, e[0]->parent_container_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, e[2]->parent_container_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, menu_ptr->highlighted_menu_item_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMTK_MENU_ITEM_ENABLED, wlmtk_menu_item_get_state(i[0]));
+
+    // Scroll further down. And then beyond the end, which has no effect.
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_element_pointer_axis(me, &axis_event));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_element_pointer_axis(me, &axis_event));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, e[1]->parent_container_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, e[2]->parent_container_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, e[3]->parent_container_ptr);
+
+    // Removing a shown item: Shows the adjacent one.
+    wlmtk_menu_remove_item(menu_ptr, i[3]);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, menu_ptr->shown_items);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, e[1]->parent_container_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, e[2]->parent_container_ptr);
+    wlmtk_menu_item_destroy(i[3]);
+
+    // Scroll up.
+    axis_event.delta = -0.01;
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_element_pointer_axis(me, &axis_event));
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, e[0]->parent_container_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, e[1]->parent_container_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, e[2]->parent_container_ptr);
+
+    wlmtk_menu_destroy(menu_ptr);
+}
+
 /* == End of menu.c ======================================================== */
@@ -31,6 +31,7 @@
 #include "input.h"
 #include "pane.h"
 #include "primitives.h"
+#include "trace.h"
 #include "util.h"
 
 /* == Declarations ========================================================= */
@@ -68,21 +69,27 @@ struct _wlmtk_menu_item_t {
     /** Mode of the menu (and the item). */
     enum wlmtk_menu_mode      mode;
 
-    /** Texture buffer holding the item in enabled state. */
+    /** Texture buffer holding the item in enabled state. Drawn lazily. */
     struct wlr_buffer         *enabled_wlr_buffer_ptr;
-    /** Texture buffer holding the item in highlighted state. */
+    /** Texture buffer holding the item in highlighted state. Drawn lazily. */
     struct wlr_buffer         *highlighted_wlr_buffer_ptr;
-    /** Texture buffer holding the item in disabled state. */
+    /** Texture buffer holding the item in disabled state. Drawn lazily. */
     struct wlr_buffer         *disabled_wlr_buffer_ptr;
+    /** Background for enabled & disabled state. From the fill cache. */
+    bs_gfxbuf_t               *fill_gfxbuf_ptr;
+    /** Background for highlighted state. From the fill cache. */
+    bs_gfxbuf_t               *highlighted_fill_gfxbuf_ptr;
 
     /** Whether the item is enabled. */
     bool                      enabled;
+    /** Whether the item is parked: It holds no buffers. */
+    bool                      parked;
 
     /** State of the menu item. */
     wlmtk_menu_item_state_t   state;
 
-    /** Style of the menu item. */
-    wlmtk_menu_item_style_t   style;
+    /** Style of the menu item. Interned, see @ref wlmtk_style_intern. */
+    const wlmtk_menu_item_style_t *style_ptr;
 };
 
 static bool _wlmtk_menu_item_redraw(
@@ -90,7 +97,9 @@ static bool _wlmtk_menu_item_redraw(
 static void _wlmtk_menu_item_set_state(
     wlmtk_menu_item_t *menu_item_ptr,
     wlmtk_menu_item_state_t state);
-static void _wlmtk_menu_item_draw_state(wlmtk_menu_item_t *menu_item_ptr);
+static bool _wlmtk_menu_item_draw_state(wlmtk_menu_item_t *menu_item_ptr);
+static void _wlmtk_menu_item_release_buffers(
+    wlmtk_menu_item_t *menu_item_ptr);
 static struct wlr_buffer *_wlmtk_menu_item_create_buffer(
     wlmtk_menu_item_t *menu_item_ptr,
     wlmtk_menu_item_state_t state);
@@ -153,8 +162,15 @@ wlmtk_menu_item_t *wlmtk_menu_item_create(
         1, sizeof(wlmtk_menu_item_t));
     if (NULL == menu_item_ptr) return NULL;
     wl_signal_init(&menu_item_ptr->events.triggered);
+    wl_signal_init(&menu_item_ptr->events.submenu_request);
     wl_signal_init(&menu_item_ptr->events.destroy);
 
+    menu_item_ptr->style_ptr = WLMTK_STYLE_INTERN(style_ptr);
+    if (NULL == menu_item_ptr->style_ptr) {
+        wlmtk_menu_item_destroy(menu_item_ptr);
+        return NULL;
+    }
+
     if (!wlmtk_buffer_init(&menu_item_ptr->super_buffer)) {
         wlmtk_menu_item_destroy(menu_item_ptr);
         return NULL;
@@ -172,7 +188,6 @@ wlmtk_menu_item_t *wlmtk_menu_item_create(
         &menu_item_ptr->pointer_leave_listener,
         _wlmtk_menu_item_handle_pointer_leave);
 
-    menu_item_ptr->style = *style_ptr;
     // TODO(kaeser@gubbe.ch): Should not be required!
     menu_item_ptr->width = style_ptr->width;
     menu_item_ptr->enabled = true;
@@ -210,11 +225,13 @@ void wlmtk_menu_item_destroy(wlmtk_menu_item_t *menu_item_ptr)
         menu_item_ptr->text_ptr = NULL;
     }
 
-    wlr_buffer_drop_nullify(&menu_item_ptr->enabled_wlr_buffer_ptr);
-    wlr_buffer_drop_nullify(&menu_item_ptr->highlighted_wlr_buffer_ptr);
-    wlr_buffer_drop_nullify(&menu_item_ptr->disabled_wlr_buffer_ptr);
+    _wlmtk_menu_item_release_buffers(menu_item_ptr);
 
     wlmtk_buffer_fini(&menu_item_ptr->super_buffer);
+    if (NULL != menu_item_ptr->style_ptr) {
+        wlmtk_style_release(menu_item_ptr->style_ptr);
+        menu_item_ptr->style_ptr = NULL;
+    }
     free(menu_item_ptr);
 }
 
@@ -364,6 +381,16 @@ bool wlmtk_menu_item_set_highlighted(
     return true;
 }
 
+/* -------------------------------------------------------------------------*/
+bool wlmtk_menu_item_set_parked(
+    wlmtk_menu_item_t *menu_item_ptr,
+    bool parked)
+{
+    if (menu_item_ptr->parked == parked) return true;
+    menu_item_ptr->parked = parked;
+    return _wlmtk_menu_item_redraw(menu_item_ptr);
+}
+
 /* -------------------------------------------------------------------------*/
 bs_dllist_node_t *wlmtk_dlnode_from_menu_item(
     wlmtk_menu_item_t *menu_item_ptr)
@@ -386,34 +413,23 @@ wlmtk_element_t *wlmtk_menu_item_element(wlmtk_menu_item_t *menu_item_ptr)
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
-/** Redraws the buffers for the menu item. Also updates the buffer state. */
+/**
+ * Redraws the menu item: Drops the buffers of all states, and draws the
+ * buffer for the current state. Buffers for the other states are drawn once
+ * the item enters that state. A parked item is left without buffer.
+ *
+ * @param menu_item_ptr
+ *
+ * @return true on success.
+ */
 bool _wlmtk_menu_item_redraw(wlmtk_menu_item_t *menu_item_ptr)
 {
-    struct wlr_buffer *e, *h, *d;
-
-    e = _wlmtk_menu_item_create_buffer(
-        menu_item_ptr, WLMTK_MENU_ITEM_ENABLED);
-    h = _wlmtk_menu_item_create_buffer(
-        menu_item_ptr, WLMTK_MENU_ITEM_HIGHLIGHTED);
-    d = _wlmtk_menu_item_create_buffer(
-        menu_item_ptr, WLMTK_MENU_ITEM_DISABLED);
-
-    if (NULL == e || NULL == d || NULL == h) {
-        wlr_buffer_drop_nullify(&e);
-        wlr_buffer_drop_nullify(&h);
-        wlr_buffer_drop_nullify(&d);
-        return false;
+    _wlmtk_menu_item_release_buffers(menu_item_ptr);
+    if (menu_item_ptr->parked) {
+        wlmtk_buffer_set(&menu_item_ptr->super_buffer, NULL);
+        return true;
     }
-
-    wlr_buffer_drop_nullify(&menu_item_ptr->enabled_wlr_buffer_ptr);
-    menu_item_ptr->enabled_wlr_buffer_ptr = e;
-    wlr_buffer_drop_nullify(&menu_item_ptr->highlighted_wlr_buffer_ptr);
-    menu_item_ptr->highlighted_wlr_buffer_ptr = h;
-    wlr_buffer_drop_nullify(&menu_item_ptr->disabled_wlr_buffer_ptr);
-    menu_item_ptr->disabled_wlr_buffer_ptr = d;
-
-    _wlmtk_menu_item_draw_state(menu_item_ptr);
-    return true;
+    return _wlmtk_menu_item_draw_state(menu_item_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -426,6 +442,11 @@ void _wlmtk_menu_item_set_state(
     menu_item_ptr->state = state;
     _wlmtk_menu_item_draw_state(menu_item_ptr);
 
+    if (WLMTK_MENU_ITEM_HIGHLIGHTED == menu_item_ptr->state &&
+        NULL == menu_item_ptr->submenu_ptr) {
+        wl_signal_emit(&menu_item_ptr->events.submenu_request, menu_item_ptr);
+    }
+
     if (NULL != menu_item_ptr->submenu_ptr) {
         wlmtk_element_t *e = wlmtk_menu_element(menu_item_ptr->submenu_ptr);
 
@@ -444,27 +465,63 @@ void _wlmtk_menu_item_set_state(
 }
 
 /* ------------------------------------------------------------------------- */
-/** Applies the state: Sets the parent buffer's content accordingly. */
-void _wlmtk_menu_item_draw_state(wlmtk_menu_item_t *menu_item_ptr)
+/**
+ * Applies the state: Sets the parent buffer's content accordingly. Draws the
+ * buffer for the state, if not done yet. Does nothing for a parked item.
+ *
+ * @param menu_item_ptr
+ *
+ * @return true on success.
+ */
+bool _wlmtk_menu_item_draw_state(wlmtk_menu_item_t *menu_item_ptr)
 {
+    WLMTK_TRACE_SPAN("menu_item_draw");
+    if (menu_item_ptr->parked) return true;
+
+    struct wlr_buffer **wlr_buffer_ptr_ptr;
     switch (menu_item_ptr->state) {
     case WLMTK_MENU_ITEM_ENABLED:
-        wlmtk_buffer_set(&menu_item_ptr->super_buffer,
-                         menu_item_ptr->enabled_wlr_buffer_ptr);
+        wlr_buffer_ptr_ptr = &menu_item_ptr->enabled_wlr_buffer_ptr;
         break;
 
     case WLMTK_MENU_ITEM_HIGHLIGHTED:
-        wlmtk_buffer_set(&menu_item_ptr->super_buffer,
-                         menu_item_ptr->highlighted_wlr_buffer_ptr);
+        wlr_buffer_ptr_ptr = &menu_item_ptr->highlighted_wlr_buffer_ptr;
         break;
 
     case WLMTK_MENU_ITEM_DISABLED:
-        wlmtk_buffer_set(&menu_item_ptr->super_buffer,
-                         menu_item_ptr->disabled_wlr_buffer_ptr);
+        wlr_buffer_ptr_ptr = &menu_item_ptr->disabled_wlr_buffer_ptr;
         break;
 
     default:
         bs_log(BS_FATAL, "Unhandled state %d", menu_item_ptr->state);
+        return false;
+    }
+
+    if (NULL == *wlr_buffer_ptr_ptr) {
+        *wlr_buffer_ptr_ptr = _wlmtk_menu_item_create_buffer(
+            menu_item_ptr, menu_item_ptr->state);
+        if (NULL == *wlr_buffer_ptr_ptr) return false;
+    }
+    wlmtk_buffer_set(&menu_item_ptr->super_buffer, *wlr_buffer_ptr_ptr);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Drops the buffers of all states, and releases the backgrounds. */
+void _wlmtk_menu_item_release_buffers(wlmtk_menu_item_t *menu_item_ptr)
+{
+    wlr_buffer_drop_nullify(&menu_item_ptr->enabled_wlr_buffer_ptr);
+    wlr_buffer_drop_nullify(&menu_item_ptr->highlighted_wlr_buffer_ptr);
+    wlr_buffer_drop_nullify(&menu_item_ptr->disabled_wlr_buffer_ptr);
+
+    if (NULL != menu_item_ptr->fill_gfxbuf_ptr) {
+        wlmaker_primitives_fill_gfxbuf_release(menu_item_ptr->fill_gfxbuf_ptr);
+        menu_item_ptr->fill_gfxbuf_ptr = NULL;
+    }
+    if (NULL != menu_item_ptr->highlighted_fill_gfxbuf_ptr) {
+        wlmaker_primitives_fill_gfxbuf_release(
+            menu_item_ptr->highlighted_fill_gfxbuf_ptr);
+        menu_item_ptr->highlighted_fill_gfxbuf_ptr = NULL;
     }
 }
 
@@ -472,6 +529,10 @@ void _wlmtk_menu_item_draw_state(wlmtk_menu_item_t *menu_item_ptr)
 /**
  * Creates a wlr_buffer with the menu item drawn for the given state.
  *
+ * The background is copied from the fill cache, and thus shared between the
+ * enabled and disabled states, and with all items of the same dimensions.
+ * Only the bezel and the text are drawn per buffer.
+ *
  * @param menu_item_ptr
  * @param state
  *
@@ -481,14 +542,53 @@ struct wlr_buffer *_wlmtk_menu_item_create_buffer(
     wlmtk_menu_item_t *menu_item_ptr,
     wlmtk_menu_item_state_t state)
 {
-    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
-        menu_item_ptr->width, menu_item_ptr->style.height);
+    const char *text_ptr = "";
+    if (NULL != menu_item_ptr->text_ptr) text_ptr = menu_item_ptr->text_ptr;
+
+    const wlmtk_style_fill_t *fill_ptr = &menu_item_ptr->style_ptr->fill;
+    bs_gfxbuf_t **fill_gfxbuf_ptr_ptr = &menu_item_ptr->fill_gfxbuf_ptr;
+    uint32_t color = menu_item_ptr->style_ptr->enabled_text_color;
+
+    if (WLMTK_MENU_ITEM_HIGHLIGHTED == state) {
+        fill_ptr = &menu_item_ptr->style_ptr->highlighted_fill;
+        fill_gfxbuf_ptr_ptr = &menu_item_ptr->highlighted_fill_gfxbuf_ptr;
+        color = menu_item_ptr->style_ptr->highlighted_text_color;
+    } else if (WLMTK_MENU_ITEM_DISABLED == state) {
+        color = menu_item_ptr->style_ptr->disabled_text_color;
+    }
+
+    if (NULL == *fill_gfxbuf_ptr_ptr) {
+        *fill_gfxbuf_ptr_ptr = wlmaker_primitives_fill_gfxbuf_acquire(
+            fill_ptr, menu_item_ptr->width, menu_item_ptr->style_ptr->height);
+        if (NULL == *fill_gfxbuf_ptr_ptr) {
+            bs_log(BS_ERROR, "Failed wlmaker_primitives_fill_gfxbuf_acquire("
+                   "%p, %d, %"PRIu64")", fill_ptr, menu_item_ptr->width,
+                   menu_item_ptr->style_ptr->height);
+            return NULL;
+        }
+    }
+
+    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer_uncleared(
+        menu_item_ptr->width, menu_item_ptr->style_ptr->height);
     if (NULL == wlr_buffer_ptr) {
-        bs_log(BS_ERROR, "Failed bs_gfxbuf_create_wlr_buffer(%d, %"PRIu64")",
-               menu_item_ptr->width, menu_item_ptr->style.height);
+        bs_log(BS_ERROR, "Failed bs_gfxbuf_create_wlr_buffer_uncleared("
+               "%d, %"PRIu64")",
+               menu_item_ptr->width, menu_item_ptr->style_ptr->height);
+        return NULL;
+    }
+    wlmtk_gfxbuf_set_memstat_subsystem(wlr_buffer_ptr, WLMTK_MEMSTAT_MENUS);
+
+    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr);
+    bs_gfxbuf_copy_area(
+        gfxbuf_ptr, 0, 0,
+        *fill_gfxbuf_ptr_ptr, 0, 0, gfxbuf_ptr->width, gfxbuf_ptr->height);
+    if (!wlmaker_primitives_gfxbuf_draw_bezel_at(
+            gfxbuf_ptr, 0, 0, gfxbuf_ptr->width, gfxbuf_ptr->height,
+            menu_item_ptr->style_ptr->bezel_width, true)) {
+        bs_log(BS_ERROR, "Failed wlmaker_primitives_gfxbuf_draw_bezel_at()");
+        wlr_buffer_drop(wlr_buffer_ptr);
         return NULL;
     }
-
     cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
     if (NULL == cairo_ptr) {
         bs_log(BS_ERROR, "Failed cairo_create_from_wlr_buffer(%p)",
@@ -497,26 +597,10 @@ struct wlr_buffer *_wlmtk_menu_item_create_buffer(
         return NULL;
     }
 
-    const char *text_ptr = "";
-    if (NULL != menu_item_ptr->text_ptr) text_ptr = menu_item_ptr->text_ptr;
-
-    wlmtk_style_fill_t *fill_ptr = &menu_item_ptr->style.fill;
-    uint32_t color = menu_item_ptr->style.enabled_text_color;
-
-    if (WLMTK_MENU_ITEM_HIGHLIGHTED == state) {
-        fill_ptr = &menu_item_ptr->style.highlighted_fill;
-        color = menu_item_ptr->style.highlighted_text_color;
-    } else if (WLMTK_MENU_ITEM_DISABLED == state) {
-        color = menu_item_ptr->style.disabled_text_color;
-    }
-
-    wlmaker_primitives_cairo_fill(cairo_ptr, fill_ptr);
-    wlmaker_primitives_draw_bezel(
-        cairo_ptr, menu_item_ptr->style.bezel_width, true);
     wlmaker_primitives_draw_text(
         cairo_ptr,
-        6, 2 + menu_item_ptr->style.font.size,
-        &menu_item_ptr->style.font,
+        6, 2 + menu_item_ptr->style_ptr->font.size,
+        &menu_item_ptr->style_ptr->font,
         color,
         text_ptr);
 
@@ -651,20 +735,24 @@ void _wlmtk_menu_item_handle_open_changed(
 
 static void test_create_destroy(bs_test_t *test_ptr);
 static void test_buffers(bs_test_t *test_ptr);
+static void test_lazy_buffers(bs_test_t *test_ptr);
 static void test_pointer(bs_test_t *test_ptr);
 static void test_triggered(bs_test_t *test_ptr);
 static void test_right_click(bs_test_t *test_ptr);
 static void test_submenu_highlight(bs_test_t *test_ptr);
+static void test_submenu_request(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_menu_item_test_cases[] = {
     { 1, "create_destroy", test_create_destroy },
     // TODO(kaeser@gubbe.ch): Re-enable, once figuring out why these fail on
     // Trixie when running as a github action.
     { 0, "buffers", test_buffers },
+    { 1, "lazy_buffers", test_lazy_buffers },
     { 1, "pointer", test_pointer },
     { 1, "triggered", test_triggered },
     { 1, "right_click", test_right_click },
     { 1, "submenu_highlight", test_submenu_highlight },
+    { 1, "submenu_request", test_submenu_request },
     { 0, NULL, NULL }
 };
 
@@ -710,10 +798,12 @@ void test_buffers(bs_test_t *test_ptr)
     BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
         test_ptr, g, "toolkit/menu_item_enabled.png");
 
+    wlmtk_menu_item_set_highlighted(item_ptr, true);
     g = bs_gfxbuf_from_wlr_buffer(item_ptr->highlighted_wlr_buffer_ptr);
     BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
         test_ptr, g, "toolkit/menu_item_highlighted.png");
 
+    wlmtk_menu_item_set_enabled(item_ptr, false);
     g = bs_gfxbuf_from_wlr_buffer(item_ptr->disabled_wlr_buffer_ptr);
     BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
         test_ptr, g, "toolkit/menu_item_disabled.png");
@@ -721,6 +811,54 @@ void test_buffers(bs_test_t *test_ptr)
     wlmtk_menu_item_destroy(item_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Verifies state buffers are drawn on first use, and backgrounds shared. */
+void test_lazy_buffers(bs_test_t *test_ptr)
+{
+    wlmtk_menu_item_t *i1 = wlmtk_menu_item_create(&_item_test_style);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, i1);
+    wlmtk_menu_item_t *i2 = wlmtk_menu_item_create(&_item_test_style);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, i2);
+
+    // Only the enabled state is drawn. Same dimensions share a background.
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, i1->enabled_wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, i1->highlighted_wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, i1->disabled_wlr_buffer_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, i1->fill_gfxbuf_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, i1->fill_gfxbuf_ptr, i2->fill_gfxbuf_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, i1->highlighted_fill_gfxbuf_ptr);
+
+    // Highlighting draws the highlighted buffer, and keeps the enabled one.
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_menu_item_set_highlighted(i1, true));
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, i1->highlighted_wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr,
+        i1->highlighted_wlr_buffer_ptr,
+        i1->super_buffer.wlr_buffer_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, i1->enabled_wlr_buffer_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, i1->highlighted_fill_gfxbuf_ptr);
+
+    // Disabling re-uses the enabled background.
+    bs_gfxbuf_t *fill_gfxbuf_ptr = i1->fill_gfxbuf_ptr;
+    wlmtk_menu_item_set_enabled(i1, false);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, i1->disabled_wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, fill_gfxbuf_ptr, i1->fill_gfxbuf_ptr);
+
+    // A redraw drops all, and only draws the current state.
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_menu_item_set_text(i1, "Text"));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, i1->enabled_wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, i1->highlighted_wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, i1->highlighted_fill_gfxbuf_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, i1->disabled_wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr,
+        i1->disabled_wlr_buffer_ptr,
+        i1->super_buffer.wlr_buffer_ptr);
+
+    wlmtk_menu_item_destroy(i2);
+    wlmtk_menu_item_destroy(i1);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Tests pointer entering & leaving. */
 void test_pointer(bs_test_t *test_ptr)
@@ -737,7 +875,6 @@ void test_pointer(bs_test_t *test_ptr)
     wlmtk_button_event_t lbtn_ev = {
         .button = BTN_LEFT, .type = WLMTK_BUTTON_CLICK };
 
-    item_ptr->style = _item_test_style;
     item_ptr->width = 80;
     wlmtk_menu_item_set_text(item_ptr, "Menu item");
 
@@ -1027,4 +1164,49 @@ void test_submenu_highlight(bs_test_t *test_ptr)
     wlmtk_menu_destroy(menu_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Test helper: Handles @ref wlmtk_menu_item_events_t::submenu_request. */
+static void _test_submenu_request_handler(
+    __UNUSED__ struct wl_listener *listener_ptr,
+    void *data_ptr)
+{
+    static const wlmtk_menu_style_t s = { .item = _item_test_style };
+    wlmtk_menu_item_t *menu_item_ptr = data_ptr;
+    wlmtk_menu_t *submenu_ptr = wlmtk_menu_create(&s);
+    if (NULL == submenu_ptr) return;
+    wlmtk_menu_item_set_submenu(menu_item_ptr, submenu_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests that a submenu can be created when the item is first highlighted. */
+void test_submenu_request(bs_test_t *test_ptr)
+{
+    wlmtk_menu_style_t s = { .item = _item_test_style };
+    wlmtk_menu_t *menu_ptr = wlmtk_menu_create(&s);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, menu_ptr);
+    wlmtk_menu_item_t *i1 = wlmtk_menu_item_create(&_item_test_style);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, i1);
+    wlmtk_menu_add_item(menu_ptr, i1);
+
+    struct wl_listener listener = {};
+    wlmtk_util_connect_listener_signal(
+        &wlmtk_menu_item_events(i1)->submenu_request,
+        &listener,
+        _test_submenu_request_handler);
+
+    // Highlighting the item creates the submenu, and opens it.
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, i1->submenu_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_menu_item_set_highlighted(i1, true));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, i1->submenu_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_menu_is_open(i1->submenu_ptr));
+
+    // Ending highlight closes it, but keeps it around.
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_menu_item_set_highlighted(i1, false));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, i1->submenu_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_menu_is_open(i1->submenu_ptr));
+
+    wlmtk_util_disconnect_listener(&listener);
+    wlmtk_menu_destroy(menu_ptr);
+}
+
 /* == End of menu_item.c =================================================== */
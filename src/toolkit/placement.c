@@ -0,0 +1,605 @@
+/* ========================================================================= */
+/**
+ * @file placement.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "placement.h"
+
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#define WLR_USE_UNSTABLE
+#include <wlr/util/box.h>
+#undef WLR_USE_UNSTABLE
+
+/* == Declarations ========================================================= */
+
+/** An obstacle: The box of a window. */
+typedef struct {
+    /** Node within @ref wlmtk_placement_t::obstacle_tree_ptr. */
+    bs_avltree_node_t         avlnode;
+    /** Node within @ref wlmtk_placement_t::obstacles. */
+    bs_dllist_node_t          dlnode;
+    /** Key of the obstacle. */
+    const void                *key_ptr;
+    /** Its box. */
+    struct wlr_box            box;
+} wlmtk_placement_obstacle_t;
+
+/** State of the placement index. */
+struct _wlmtk_placement_t {
+    /** Area that windows get placed in. */
+    struct wlr_box            area;
+    /** Obstacles, by @ref wlmtk_placement_obstacle_t::key_ptr. */
+    bs_avltree_t              *obstacle_tree_ptr;
+    /** Obstacles, for iterating. */
+    bs_dllist_t               obstacles;
+
+    /** Maximal empty rectangles within `area`. */
+    struct wlr_box            *free_boxes;
+    /** Number of elements at `free_boxes`. */
+    size_t                    free_size;
+    /** Allocated number of elements at `free_boxes`. */
+    size_t                    free_capacity;
+    /** Whether `free_boxes` must be rebuilt from the obstacles. */
+    bool                      dirty;
+
+    /** Number of windows cascaded since wrapping around. */
+    int                       cascade_step;
+};
+
+static int _wlmtk_placement_obstacle_cmp(
+    const bs_avltree_node_t *avlnode_ptr,
+    const void *key_ptr);
+static void _wlmtk_placement_obstacle_destroy(bs_avltree_node_t *avlnode_ptr);
+static bool _wlmtk_placement_rebuild(wlmtk_placement_t *placement_ptr);
+static bool _wlmtk_placement_split(
+    wlmtk_placement_t *placement_ptr,
+    const struct wlr_box *obstacle_ptr);
+static bool _wlmtk_placement_add_free(
+    wlmtk_placement_t *placement_ptr,
+    size_t first,
+    const struct wlr_box *box_ptr);
+static bool _wlmtk_placement_contains(
+    const struct wlr_box *outer_ptr,
+    const struct wlr_box *inner_ptr);
+static bool _wlmtk_placement_smart(
+    wlmtk_placement_t *placement_ptr,
+    struct wlr_box *box_ptr);
+static struct wlr_box _wlmtk_placement_cascade(
+    wlmtk_placement_t *placement_ptr,
+    int width,
+    int height);
+static struct wlr_box _wlmtk_placement_confine(
+    const struct wlr_box *area_ptr,
+    struct wlr_box box);
+
+/* == Data ================================================================= */
+
+/** Offset between cascaded windows, in pixels. */
+static const int _wlmtk_placement_cascade_offset = 32;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmtk_placement_t *wlmtk_placement_create(void)
+{
+    wlmtk_placement_t *placement_ptr = logged_calloc(
+        1, sizeof(wlmtk_placement_t));
+    if (NULL == placement_ptr) return NULL;
+
+    placement_ptr->obstacle_tree_ptr = bs_avltree_create(
+        _wlmtk_placement_obstacle_cmp,
+        _wlmtk_placement_obstacle_destroy);
+    if (NULL == placement_ptr->obstacle_tree_ptr) {
+        bs_log(BS_ERROR, "Failed bs_avltree_create(%p, %p)",
+               _wlmtk_placement_obstacle_cmp,
+               _wlmtk_placement_obstacle_destroy);
+        wlmtk_placement_destroy(placement_ptr);
+        return NULL;
+    }
+    return placement_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_placement_destroy(wlmtk_placement_t *placement_ptr)
+{
+    if (NULL != placement_ptr->obstacle_tree_ptr) {
+        bs_avltree_destroy(placement_ptr->obstacle_tree_ptr);
+        placement_ptr->obstacle_tree_ptr = NULL;
+    }
+    if (NULL != placement_ptr->free_boxes) {
+        free(placement_ptr->free_boxes);
+        placement_ptr->free_boxes = NULL;
+    }
+    free(placement_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_placement_set_area(
+    wlmtk_placement_t *placement_ptr,
+    struct wlr_box area)
+{
+    if (wlr_box_equal(&placement_ptr->area, &area)) return;
+    placement_ptr->area = area;
+    placement_ptr->cascade_step = 0;
+    placement_ptr->dirty = true;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_placement_update(
+    wlmtk_placement_t *placement_ptr,
+    const void *key_ptr,
+    struct wlr_box box)
+{
+    bs_avltree_node_t *avlnode_ptr = bs_avltree_lookup(
+        placement_ptr->obstacle_tree_ptr, key_ptr);
+    if (NULL != avlnode_ptr) {
+        wlmtk_placement_obstacle_t *obstacle_ptr = BS_CONTAINER_OF(
+            avlnode_ptr, wlmtk_placement_obstacle_t, avlnode);
+        if (wlr_box_equal(&obstacle_ptr->box, &box)) return true;
+        // The space it frees may merge with others: Rebuild.
+        obstacle_ptr->box = box;
+        placement_ptr->dirty = true;
+        return true;
+    }
+
+    wlmtk_placement_obstacle_t *obstacle_ptr = logged_calloc(
+        1, sizeof(wlmtk_placement_obstacle_t));
+    if (NULL == obstacle_ptr) return false;
+    obstacle_ptr->key_ptr = key_ptr;
+    obstacle_ptr->box = box;
+    BS_ASSERT(bs_avltree_insert(
+                  placement_ptr->obstacle_tree_ptr,
+                  key_ptr,
+                  &obstacle_ptr->avlnode,
+                  false));
+    bs_dllist_push_back(&placement_ptr->obstacles, &obstacle_ptr->dlnode);
+
+    if (!placement_ptr->dirty &&
+        !_wlmtk_placement_split(placement_ptr, &box)) {
+        placement_ptr->dirty = true;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_placement_remove(
+    wlmtk_placement_t *placement_ptr,
+    const void *key_ptr)
+{
+    bs_avltree_node_t *avlnode_ptr = bs_avltree_lookup(
+        placement_ptr->obstacle_tree_ptr, key_ptr);
+    if (NULL == avlnode_ptr) return;
+    wlmtk_placement_obstacle_t *obstacle_ptr = BS_CONTAINER_OF(
+        avlnode_ptr, wlmtk_placement_obstacle_t, avlnode);
+    bs_avltree_delete(placement_ptr->obstacle_tree_ptr, key_ptr);
+    bs_dllist_remove(&placement_ptr->obstacles, &obstacle_ptr->dlnode);
+    _wlmtk_placement_obstacle_destroy(&obstacle_ptr->avlnode);
+    placement_ptr->dirty = true;
+}
+
+/* ------------------------------------------------------------------------- */
+struct wlr_box wlmtk_placement_place(
+    wlmtk_placement_t *placement_ptr,
+    wlmtk_placement_policy_t policy,
+    int width,
+    int height,
+    int pointer_x,
+    int pointer_y)
+{
+    struct wlr_box box = { .width = width, .height = height };
+    switch (policy) {
+    case WLMTK_PLACEMENT_SMART:
+        if (_wlmtk_placement_smart(placement_ptr, &box)) return box;
+        return _wlmtk_placement_cascade(placement_ptr, width, height);
+
+    case WLMTK_PLACEMENT_CASCADE:
+        return _wlmtk_placement_cascade(placement_ptr, width, height);
+
+    case WLMTK_PLACEMENT_UNDER_POINTER:
+        box.x = pointer_x - width / 2;
+        box.y = pointer_y - height / 2;
+        return _wlmtk_placement_confine(&placement_ptr->area, box);
+
+    default:
+        bs_log(BS_WARNING, "Unhandled placement policy %d", policy);
+        break;
+    }
+    return _wlmtk_placement_confine(&placement_ptr->area, box);
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_placement_free_rectangles(wlmtk_placement_t *placement_ptr)
+{
+    if (placement_ptr->dirty) _wlmtk_placement_rebuild(placement_ptr);
+    return placement_ptr->free_size;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Compares @ref wlmtk_placement_obstacle_t::key_ptr. */
+int _wlmtk_placement_obstacle_cmp(
+    const bs_avltree_node_t *avlnode_ptr,
+    const void *key_ptr)
+{
+    wlmtk_placement_obstacle_t *obstacle_ptr = BS_CONTAINER_OF(
+        avlnode_ptr, wlmtk_placement_obstacle_t, avlnode);
+    return bs_avltree_cmp_ptr(obstacle_ptr->key_ptr, key_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the obstacle. Expects it to be removed from the list. */
+void _wlmtk_placement_obstacle_destroy(bs_avltree_node_t *avlnode_ptr)
+{
+    free(BS_CONTAINER_OF(avlnode_ptr, wlmtk_placement_obstacle_t, avlnode));
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Rebuilds the maximal empty rectangles from the area and all obstacles.
+ *
+ * @param placement_ptr
+ *
+ * @return false on error. The index remains dirty then.
+ */
+bool _wlmtk_placement_rebuild(wlmtk_placement_t *placement_ptr)
+{
+    placement_ptr->free_size = 0;
+    placement_ptr->dirty = false;
+    if (wlr_box_empty(&placement_ptr->area)) return true;
+    if (!_wlmtk_placement_add_free(placement_ptr, 0, &placement_ptr->area)) {
+        placement_ptr->dirty = true;
+        return false;
+    }
+
+    for (bs_dllist_node_t *dlnode_ptr = placement_ptr->obstacles.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_placement_obstacle_t *obstacle_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_placement_obstacle_t, dlnode);
+        if (!_wlmtk_placement_split(placement_ptr, &obstacle_ptr->box)) {
+            placement_ptr->dirty = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Splits the empty rectangles intersecting `obstacle_ptr` into the up to
+ * four rectangles left, right, above and below of it. Drops the pieces that
+ * are contained in another empty rectangle, so all remain maximal.
+ *
+ * @param placement_ptr
+ * @param obstacle_ptr
+ *
+ * @return false on error.
+ */
+bool _wlmtk_placement_split(
+    wlmtk_placement_t *placement_ptr,
+    const struct wlr_box *obstacle_ptr)
+{
+    if (wlr_box_empty(obstacle_ptr)) return true;
+    int ox2 = obstacle_ptr->x + obstacle_ptr->width;
+    int oy2 = obstacle_ptr->y + obstacle_ptr->height;
+
+    size_t intersecting = 0;
+    for (size_t i = 0; i < placement_ptr->free_size; ++i) {
+        struct wlr_box dest;
+        if (wlr_box_intersection(
+                &dest, &placement_ptr->free_boxes[i], obstacle_ptr)) {
+            ++intersecting;
+        }
+    }
+    if (0 == intersecting) return true;
+
+    struct wlr_box *pieces = logged_calloc(
+        4 * intersecting, sizeof(struct wlr_box));
+    if (NULL == pieces) return false;
+    size_t pieces_size = 0;
+    for (size_t i = 0; i < placement_ptr->free_size;) {
+        struct wlr_box r = placement_ptr->free_boxes[i], dest;
+        if (!wlr_box_intersection(&dest, &r, obstacle_ptr)) {
+            ++i;
+            continue;
+        }
+        int rx2 = r.x + r.width, ry2 = r.y + r.height;
+        if (obstacle_ptr->x > r.x) {
+            pieces[pieces_size++] = (struct wlr_box){
+                r.x, r.y, obstacle_ptr->x - r.x, r.height };
+        }
+        if (ox2 < rx2) {
+            pieces[pieces_size++] = (struct wlr_box){
+                ox2, r.y, rx2 - ox2, r.height };
+        }
+        if (obstacle_ptr->y > r.y) {
+            pieces[pieces_size++] = (struct wlr_box){
+                r.x, r.y, r.width, obstacle_ptr->y - r.y };
+        }
+        if (oy2 < ry2) {
+            pieces[pieces_size++] = (struct wlr_box){
+                r.x, oy2, r.width, ry2 - oy2 };
+        }
+        // Order does not matter: Move the last one here.
+        placement_ptr->free_boxes[i] =
+            placement_ptr->free_boxes[--placement_ptr->free_size];
+    }
+
+    size_t first = placement_ptr->free_size;
+    bool rv = true;
+    for (size_t i = 0; rv && i < pieces_size; ++i) {
+        rv = _wlmtk_placement_add_free(placement_ptr, first, &pieces[i]);
+    }
+    free(pieces);
+    return rv;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Adds `box_ptr` to the empty rectangles, unless it is contained in one.
+ * Removes the rectangles from index `first` on that it contains.
+ *
+ * @param placement_ptr
+ * @param first
+ * @param box_ptr
+ *
+ * @return false on error.
+ */
+bool _wlmtk_placement_add_free(
+    wlmtk_placement_t *placement_ptr,
+    size_t first,
+    const struct wlr_box *box_ptr)
+{
+    for (size_t i = 0; i < placement_ptr->free_size; ++i) {
+        if (_wlmtk_placement_contains(
+                &placement_ptr->free_boxes[i], box_ptr)) return true;
+    }
+    for (size_t i = first; i < placement_ptr->free_size;) {
+        if (_wlmtk_placement_contains(
+                box_ptr, &placement_ptr->free_boxes[i])) {
+            placement_ptr->free_boxes[i] =
+                placement_ptr->free_boxes[--placement_ptr->free_size];
+        } else {
+            ++i;
+        }
+    }
+
+    if (placement_ptr->free_size >= placement_ptr->free_capacity) {
+        size_t new_capacity = BS_MAX(8U, 2 * placement_ptr->free_capacity);
+        struct wlr_box *new_boxes = logged_calloc(
+            new_capacity, sizeof(struct wlr_box));
+        if (NULL == new_boxes) return false;
+        if (0 < placement_ptr->free_size) {
+            memcpy(new_boxes, placement_ptr->free_boxes,
+                   placement_ptr->free_size * sizeof(struct wlr_box));
+        }
+        if (NULL != placement_ptr->free_boxes) {
+            free(placement_ptr->free_boxes);
+        }
+        placement_ptr->free_boxes = new_boxes;
+        placement_ptr->free_capacity = new_capacity;
+    }
+    placement_ptr->free_boxes[placement_ptr->free_size++] = *box_ptr;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Whether `outer_ptr` contains `inner_ptr`. */
+bool _wlmtk_placement_contains(
+    const struct wlr_box *outer_ptr,
+    const struct wlr_box *inner_ptr)
+{
+    return (outer_ptr->x <= inner_ptr->x &&
+            outer_ptr->y <= inner_ptr->y &&
+            outer_ptr->x + outer_ptr->width >=
+            inner_ptr->x + inner_ptr->width &&
+            outer_ptr->y + outer_ptr->height >=
+            inner_ptr->y + inner_ptr->height);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Finds the top-most, then left-most empty rectangle that `box_ptr` fits in,
+ * and moves `box_ptr` to its top-left corner.
+ *
+ * @param placement_ptr
+ * @param box_ptr
+ *
+ * @return Whether `box_ptr` fits an empty rectangle.
+ */
+bool _wlmtk_placement_smart(
+    wlmtk_placement_t *placement_ptr,
+    struct wlr_box *box_ptr)
+{
+    if (placement_ptr->dirty) _wlmtk_placement_rebuild(placement_ptr);
+
+    const struct wlr_box *best_ptr = NULL;
+    for (size_t i = 0; i < placement_ptr->free_size; ++i) {
+        const struct wlr_box *free_ptr = &placement_ptr->free_boxes[i];
+        if (free_ptr->width < box_ptr->width ||
+            free_ptr->height < box_ptr->height) continue;
+        if (NULL == best_ptr ||
+            free_ptr->y < best_ptr->y ||
+            (free_ptr->y == best_ptr->y && free_ptr->x < best_ptr->x)) {
+            best_ptr = free_ptr;
+        }
+    }
+    if (NULL == best_ptr) return false;
+    box_ptr->x = best_ptr->x;
+    box_ptr->y = best_ptr->y;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Places the window offset from the formerly cascaded one. Wraps around to
+ * the area's top-left once the window no longer fits.
+ *
+ * @param placement_ptr
+ * @param width
+ * @param height
+ *
+ * @return The box for the window.
+ */
+struct wlr_box _wlmtk_placement_cascade(
+    wlmtk_placement_t *placement_ptr,
+    int width,
+    int height)
+{
+    int offset = placement_ptr->cascade_step *
+        _wlmtk_placement_cascade_offset;
+    struct wlr_box box = {
+        .x = placement_ptr->area.x + offset,
+        .y = placement_ptr->area.y + offset,
+        .width = width,
+        .height = height };
+    const struct wlr_box *area_ptr = &placement_ptr->area;
+    if (0 < placement_ptr->cascade_step &&
+        (box.x + width > area_ptr->x + area_ptr->width ||
+         box.y + height > area_ptr->y + area_ptr->height)) {
+        placement_ptr->cascade_step = 0;
+        box.x = placement_ptr->area.x;
+        box.y = placement_ptr->area.y;
+    }
+    placement_ptr->cascade_step++;
+    return _wlmtk_placement_confine(&placement_ptr->area, box);
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return `box`, moved to be within `area_ptr`, as far as it fits. */
+struct wlr_box _wlmtk_placement_confine(
+    const struct wlr_box *area_ptr,
+    struct wlr_box box)
+{
+    if (box.x + box.width > area_ptr->x + area_ptr->width) {
+        box.x = area_ptr->x + area_ptr->width - box.width;
+    }
+    if (box.x < area_ptr->x) box.x = area_ptr->x;
+    if (box.y + box.height > area_ptr->y + area_ptr->height) {
+        box.y = area_ptr->y + area_ptr->height - box.height;
+    }
+    if (box.y < area_ptr->y) box.y = area_ptr->y;
+    return box;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_free_rectangles(bs_test_t *test_ptr);
+static void test_place(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_placement_test_cases[] = {
+    { 1, "free_rectangles", test_free_rectangles },
+    { 1, "place", test_place },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Verifies the maximal empty rectangles, when adding and moving obstacles. */
+void test_free_rectangles(bs_test_t *test_ptr)
+{
+    wlmtk_placement_t *p_ptr = wlmtk_placement_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, p_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_placement_free_rectangles(p_ptr));
+
+    wlmtk_placement_set_area(p_ptr, (struct wlr_box){ 0, 0, 100, 100 });
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmtk_placement_free_rectangles(p_ptr));
+
+    // An obstacle in the center: Left, right, above and below of it.
+    int a, b;
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_placement_update(p_ptr, &a, (struct wlr_box){ 40, 40, 20, 20 }));
+    BS_TEST_VERIFY_FALSE(test_ptr, p_ptr->dirty);
+    BS_TEST_VERIFY_EQ(test_ptr, 4, wlmtk_placement_free_rectangles(p_ptr));
+
+    // A second one at the top-left corner. Splits the left and top ones.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_placement_update(p_ptr, &b, (struct wlr_box){ 0, 0, 10, 10 }));
+    BS_TEST_VERIFY_FALSE(test_ptr, p_ptr->dirty);
+    BS_TEST_VERIFY_EQ(test_ptr, 6, wlmtk_placement_free_rectangles(p_ptr));
+
+    // Moving the first to the right edge invalidates. Rebuilt when needed.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_placement_update(p_ptr, &a, (struct wlr_box){ 90, 0, 10, 100 }));
+    BS_TEST_VERIFY_TRUE(test_ptr, p_ptr->dirty);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, wlmtk_placement_free_rectangles(p_ptr));
+    BS_TEST_VERIFY_FALSE(test_ptr, p_ptr->dirty);
+
+    wlmtk_placement_remove(p_ptr, &b);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmtk_placement_free_rectangles(p_ptr));
+    wlmtk_placement_remove(p_ptr, &a);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmtk_placement_free_rectangles(p_ptr));
+
+    wlmtk_placement_destroy(p_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Exercises the placement policies. */
+void test_place(bs_test_t *test_ptr)
+{
+    wlmtk_placement_t *p_ptr = wlmtk_placement_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, p_ptr);
+    wlmtk_placement_set_area(p_ptr, (struct wlr_box){ 10, 20, 200, 100 });
+
+    // Smart: Top-left, then besides, then below the windows.
+    struct wlr_box b;
+    int w1, w2;
+    b = wlmtk_placement_place(p_ptr, WLMTK_PLACEMENT_SMART, 120, 50, 0, 0);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, b.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 20, b.y);
+    wlmtk_placement_update(p_ptr, &w1, b);
+    b = wlmtk_placement_place(p_ptr, WLMTK_PLACEMENT_SMART, 80, 50, 0, 0);
+    BS_TEST_VERIFY_EQ(test_ptr, 130, b.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 20, b.y);
+    wlmtk_placement_update(p_ptr, &w2, b);
+    b = wlmtk_placement_place(p_ptr, WLMTK_PLACEMENT_SMART, 150, 40, 0, 0);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, b.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 70, b.y);
+
+    // Smart, when nothing fits: Cascades.
+    b = wlmtk_placement_place(p_ptr, WLMTK_PLACEMENT_SMART, 150, 60, 0, 0);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, b.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 20, b.y);
+    b = wlmtk_placement_place(p_ptr, WLMTK_PLACEMENT_CASCADE, 150, 60, 0, 0);
+    BS_TEST_VERIFY_EQ(test_ptr, 42, b.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 52, b.y);
+    // The third would exceed the area: Wraps around.
+    b = wlmtk_placement_place(p_ptr, WLMTK_PLACEMENT_CASCADE, 150, 60, 0, 0);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, b.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 20, b.y);
+
+    // Under the pointer: Centered, and confined to the area.
+    b = wlmtk_placement_place(
+        p_ptr, WLMTK_PLACEMENT_UNDER_POINTER, 40, 20, 100, 60);
+    BS_TEST_VERIFY_EQ(test_ptr, 80, b.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 50, b.y);
+    b = wlmtk_placement_place(
+        p_ptr, WLMTK_PLACEMENT_UNDER_POINTER, 40, 20, 205, 0);
+    BS_TEST_VERIFY_EQ(test_ptr, 170, b.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 20, b.y);
+
+    wlmtk_placement_destroy(p_ptr);
+}
+
+/* == End of placement.c =================================================== */
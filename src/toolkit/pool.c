@@ -0,0 +1,367 @@
+/* ========================================================================= */
+/**
+ * @file pool.c
+ *
+ * @copyright
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pool.h"
+
+#include <libbase/libbase.h>
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "alloctrack.h"
+#include "arena.h"
+
+/* == Declarations ========================================================= */
+
+/** A slab: Header, followed by `objects_per_slab` slots. */
+typedef struct {
+    /** Node within @ref wlmtk_pool_t::partial_slabs or `full_slabs`. */
+    bs_dllist_node_t          dlnode;
+    /** Back-link to the pool. */
+    wlmtk_pool_t              *pool_ptr;
+    /** Number of objects of this slab currently in use. */
+    size_t                    used;
+    /** Number of slots handed out at least once. Slots beyond are fresh. */
+    size_t                    initialized;
+    /** Singly-linked list of freed objects, linked through their storage. */
+    void                      *free_list_ptr;
+} wlmtk_pool_slab_t;
+
+/** Header preceding each object within the slab. Keeps objects aligned. */
+typedef union {
+    /** The slab this object belongs to. */
+    wlmtk_pool_slab_t         *slab_ptr;
+    /** For alignment. */
+    max_align_t               alignment;
+} wlmtk_pool_slot_t;
+
+static void _wlmtk_pool_register(wlmtk_pool_t *pool_ptr);
+static size_t _wlmtk_pool_align(size_t size);
+static size_t _wlmtk_pool_stride(wlmtk_pool_t *pool_ptr);
+static wlmtk_pool_slab_t *_wlmtk_pool_slab_create(wlmtk_pool_t *pool_ptr);
+static void _wlmtk_pool_slabs_free(bs_dllist_t *slabs_ptr);
+
+/* == Data ================================================================= */
+
+/** List of registered pools, through @ref wlmtk_pool_t::dlnode. */
+static bs_dllist_t            _wlmtk_pools;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+void *wlmtk_pool_alloc(wlmtk_pool_t *pool_ptr)
+{
+    BS_ASSERT(0 < pool_ptr->objects_per_slab);
+    _wlmtk_pool_register(pool_ptr);
+
+    wlmtk_pool_slab_t *slab_ptr;
+    if (NULL == pool_ptr->partial_slabs.head_ptr) {
+        slab_ptr = _wlmtk_pool_slab_create(pool_ptr);
+        if (NULL == slab_ptr) return NULL;
+        bs_dllist_push_front(&pool_ptr->partial_slabs, &slab_ptr->dlnode);
+    } else {
+        slab_ptr = BS_CONTAINER_OF(
+            pool_ptr->partial_slabs.head_ptr, wlmtk_pool_slab_t, dlnode);
+    }
+
+    uint8_t *object_ptr = slab_ptr->free_list_ptr;
+    if (NULL != object_ptr) {
+        slab_ptr->free_list_ptr = *(void**)object_ptr;
+    } else {
+        BS_ASSERT(slab_ptr->initialized < pool_ptr->objects_per_slab);
+        object_ptr = (uint8_t*)slab_ptr +
+            _wlmtk_pool_align(sizeof(wlmtk_pool_slab_t)) +
+            slab_ptr->initialized * _wlmtk_pool_stride(pool_ptr) +
+            sizeof(wlmtk_pool_slot_t);
+        slab_ptr->initialized++;
+    }
+    ((wlmtk_pool_slot_t*)object_ptr - 1)->slab_ptr = slab_ptr;
+
+    if (++slab_ptr->used >= pool_ptr->objects_per_slab) {
+        bs_dllist_remove(&pool_ptr->partial_slabs, &slab_ptr->dlnode);
+        bs_dllist_push_back(&pool_ptr->full_slabs, &slab_ptr->dlnode);
+    }
+    pool_ptr->in_use++;
+    pool_ptr->peak_in_use = BS_MAX(pool_ptr->peak_in_use, pool_ptr->in_use);
+    pool_ptr->allocations++;
+
+    memset(object_ptr, 0, pool_ptr->object_size);
+    WLMTK_ALLOCTRACK_RECORD(
+        object_ptr, pool_ptr->object_size, pool_ptr->name_ptr);
+    return object_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_pool_free(wlmtk_pool_t *pool_ptr, void *object_ptr)
+{
+    if (NULL == object_ptr) return;
+    WLMTK_ALLOCTRACK_RELEASE(object_ptr);
+
+    wlmtk_pool_slab_t *slab_ptr =
+        ((wlmtk_pool_slot_t*)object_ptr - 1)->slab_ptr;
+    BS_ASSERT(slab_ptr->pool_ptr == pool_ptr);
+    BS_ASSERT(0 < slab_ptr->used);
+
+    if (slab_ptr->used >= pool_ptr->objects_per_slab) {
+        bs_dllist_remove(&pool_ptr->full_slabs, &slab_ptr->dlnode);
+        bs_dllist_push_front(&pool_ptr->partial_slabs, &slab_ptr->dlnode);
+    }
+    *(void**)object_ptr = slab_ptr->free_list_ptr;
+    slab_ptr->free_list_ptr = object_ptr;
+    slab_ptr->used--;
+    pool_ptr->in_use--;
+
+    // Keep one slab with free space around, to absorb alloc/free churn.
+    if (0 == slab_ptr->used &&
+        1 < bs_dllist_size(&pool_ptr->partial_slabs)) {
+        bs_dllist_remove(&pool_ptr->partial_slabs, &slab_ptr->dlnode);
+        wlmtk_arena_free(slab_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_pool_fini(wlmtk_pool_t *pool_ptr)
+{
+    BS_ASSERT(0 == pool_ptr->in_use);
+    _wlmtk_pool_slabs_free(&pool_ptr->partial_slabs);
+    _wlmtk_pool_slabs_free(&pool_ptr->full_slabs);
+    if (pool_ptr->registered) {
+        bs_dllist_remove(&_wlmtk_pools, &pool_ptr->dlnode);
+        pool_ptr->registered = false;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_pool_get_stats(
+    wlmtk_pool_t *pool_ptr,
+    wlmtk_pool_stats_t *stats_ptr)
+{
+    size_t slabs = bs_dllist_size(&pool_ptr->partial_slabs) +
+        bs_dllist_size(&pool_ptr->full_slabs);
+    *stats_ptr = (wlmtk_pool_stats_t){
+        .name_ptr = pool_ptr->name_ptr,
+        .object_size = pool_ptr->object_size,
+        .slabs = slabs,
+        .capacity = slabs * pool_ptr->objects_per_slab,
+        .in_use = pool_ptr->in_use,
+        .peak_in_use = pool_ptr->peak_in_use,
+        .allocations = pool_ptr->allocations
+    };
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_pool_for_each_stats(
+    void (*func)(const wlmtk_pool_stats_t *stats_ptr, void *ud_ptr),
+    void *ud_ptr)
+{
+    for (bs_dllist_node_t *dlnode_ptr = _wlmtk_pools.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_pool_stats_t stats;
+        wlmtk_pool_get_stats(
+            BS_CONTAINER_OF(dlnode_ptr, wlmtk_pool_t, dlnode), &stats);
+        func(&stats, ud_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_pool_log_stats(bs_log_severity_t severity)
+{
+    for (bs_dllist_node_t *dlnode_ptr = _wlmtk_pools.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_pool_stats_t s;
+        wlmtk_pool_get_stats(
+            BS_CONTAINER_OF(dlnode_ptr, wlmtk_pool_t, dlnode), &s);
+        bs_log(severity, "Pool %s: %zu of %zu in use (peak %zu), "
+               "%zu slabs, %zu bytes each, %zu allocations",
+               s.name_ptr, s.in_use, s.capacity, s.peak_in_use,
+               s.slabs, s.object_size, s.allocations);
+    }
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Adds the pool to @ref _wlmtk_pools, unless already registered. */
+void _wlmtk_pool_register(wlmtk_pool_t *pool_ptr)
+{
+    if (pool_ptr->registered) return;
+    bs_dllist_push_back(&_wlmtk_pools, &pool_ptr->dlnode);
+    pool_ptr->registered = true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Rounds `size` up to the next multiple of the maximum alignment. */
+size_t _wlmtk_pool_align(size_t size)
+{
+    const size_t a = alignof(max_align_t);
+    return (size + a - 1) / a * a;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns the distance between two slots of the slab, in bytes. */
+size_t _wlmtk_pool_stride(wlmtk_pool_t *pool_ptr)
+{
+    // The free list is linked through the object's storage.
+    return sizeof(wlmtk_pool_slot_t) +
+        _wlmtk_pool_align(BS_MAX(pool_ptr->object_size, sizeof(void*)));
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Allocates a slab for `pool_ptr`, from the locked arena if enabled. Slots
+ * are initialized on first use.
+ */
+wlmtk_pool_slab_t *_wlmtk_pool_slab_create(wlmtk_pool_t *pool_ptr)
+{
+    wlmtk_pool_slab_t *slab_ptr = wlmtk_arena_calloc(
+        _wlmtk_pool_align(sizeof(wlmtk_pool_slab_t)) +
+        pool_ptr->objects_per_slab * _wlmtk_pool_stride(pool_ptr));
+    if (NULL == slab_ptr) return NULL;
+    slab_ptr->pool_ptr = pool_ptr;
+    return slab_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Frees all slabs in `slabs_ptr`. */
+void _wlmtk_pool_slabs_free(bs_dllist_t *slabs_ptr)
+{
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(slabs_ptr))) {
+        wlmtk_arena_free(
+            BS_CONTAINER_OF(dlnode_ptr, wlmtk_pool_slab_t, dlnode));
+    }
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_alloc_free(bs_test_t *test_ptr);
+static void test_slabs(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_pool_test_cases[] = {
+    { 1, "alloc_free", test_alloc_free },
+    { 1, "slabs", test_slabs },
+    { 0, NULL, NULL }
+};
+
+/** Test object: Odd-sized, to exercise alignment. */
+typedef struct {
+    /** Some value. */
+    uint64_t                  value;
+    /** Some more bytes. */
+    char                      bytes[5];
+} test_object_t;
+
+/** Records pool statistics for @ref test_slabs. */
+static void test_record_stats(const wlmtk_pool_stats_t *stats_ptr,
+                              void *ud_ptr)
+{
+    wlmtk_pool_stats_t *recorded_stats_ptr = ud_ptr;
+    if (0 == strcmp(stats_ptr->name_ptr, "test")) {
+        *recorded_stats_ptr = *stats_ptr;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Allocates, frees and re-uses objects. */
+void test_alloc_free(bs_test_t *test_ptr)
+{
+    wlmtk_pool_t pool = WLMTK_POOL_INITIALIZER("test", test_object_t);
+
+    test_object_t *o1_ptr = wlmtk_pool_alloc(&pool);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, o1_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, (uintptr_t)o1_ptr % alignof(max_align_t));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, o1_ptr->value);
+    o1_ptr->value = 42;
+    test_object_t *o2_ptr = wlmtk_pool_alloc(&pool);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, o2_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, (uintptr_t)o2_ptr % alignof(max_align_t));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        (uint8_t*)o2_ptr >= (uint8_t*)(o1_ptr + 1) ||
+        (uint8_t*)o1_ptr >= (uint8_t*)(o2_ptr + 1));
+
+    wlmtk_pool_stats_t stats;
+    wlmtk_pool_get_stats(&pool, &stats);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, stats.in_use);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats.slabs);
+    BS_TEST_VERIFY_EQ(test_ptr, WLMTK_POOL_OBJECTS_PER_SLAB, stats.capacity);
+
+    // A freed object is re-used, and handed out zeroed.
+    wlmtk_pool_free(&pool, o1_ptr);
+    test_object_t *o3_ptr = wlmtk_pool_alloc(&pool);
+    BS_TEST_VERIFY_EQ(test_ptr, o1_ptr, o3_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, o3_ptr->value);
+
+    wlmtk_pool_free(&pool, o3_ptr);
+    wlmtk_pool_free(&pool, o2_ptr);
+    wlmtk_pool_free(&pool, NULL);
+    wlmtk_pool_get_stats(&pool, &stats);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, stats.in_use);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, stats.peak_in_use);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, stats.allocations);
+    wlmtk_pool_fini(&pool);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Grows beyond a slab, and releases the slabs once unused. */
+void test_slabs(bs_test_t *test_ptr)
+{
+    wlmtk_pool_t pool = WLMTK_POOL_INITIALIZER("test", test_object_t);
+    pool.objects_per_slab = 2;
+
+    test_object_t *o_ptrs[5];
+    for (int i = 0; i < 5; ++i) {
+        o_ptrs[i] = wlmtk_pool_alloc(&pool);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, o_ptrs[i]);
+        o_ptrs[i]->value = i;
+    }
+    for (int i = 0; i < 5; ++i) {
+        BS_TEST_VERIFY_EQ(test_ptr, (uint64_t)i, o_ptrs[i]->value);
+    }
+
+    wlmtk_pool_stats_t stats = {};
+    wlmtk_pool_for_each_stats(test_record_stats, &stats);
+    BS_TEST_VERIFY_EQ(test_ptr, 5, stats.in_use);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, stats.slabs);
+    BS_TEST_VERIFY_EQ(test_ptr, 6, stats.capacity);
+
+    // Unused slabs are released, as long as another one has space.
+    for (int i = 0; i < 4; ++i) wlmtk_pool_free(&pool, o_ptrs[i]);
+    wlmtk_pool_get_stats(&pool, &stats);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats.in_use);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats.slabs);
+
+    // The last slab is kept, even if unused.
+    wlmtk_pool_free(&pool, o_ptrs[4]);
+    wlmtk_pool_get_stats(&pool, &stats);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats.slabs);
+
+    // Once finalized, it is no longer reported.
+    wlmtk_pool_fini(&pool);
+    stats = (wlmtk_pool_stats_t){};
+    wlmtk_pool_for_each_stats(test_record_stats, &stats);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, stats.name_ptr);
+}
+
+/* == End of pool.c ======================================================== */
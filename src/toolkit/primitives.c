@@ -19,9 +19,132 @@
  */
 
 #include "primitives.h"
+#include "memstat.h"
+#include "text.h"
+#include "util.h"
 
 #include <libbase/libbase.h>
+#include <math.h>
 #include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(WLMTK_UTIL_SIMD_X86)
+#include <immintrin.h>
+#elif defined(WLMTK_UTIL_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+/* == Declarations ========================================================= */
+
+/** An entry of the fill cache. */
+typedef struct {
+    /** Node within @ref _wlmaker_primitives_fill_cache. */
+    bs_dllist_node_t          dlnode;
+    /** The fill style. Interned, see @ref _wlmaker_primitives_fill_intern. */
+    const wlmtk_style_fill_t  *fill_ptr;
+    /** Width of the buffer. */
+    unsigned                  width;
+    /** Height of the buffer. */
+    unsigned                  height;
+    /** Number of references held on `gfxbuf_ptr`. */
+    int                       references;
+    /** The filled buffer. */
+    bs_gfxbuf_t               *gfxbuf_ptr;
+} wlmaker_primitives_fill_entry_t;
+
+/**
+ * Coverage of the bezel, rasterized for its corners and edges.
+ *
+ * The template is a square of `2 * edge + 1` pixels. Its corners are the
+ * bezel's corners, and its middle row and column are the cross-section of
+ * the bezel's straight edges.
+ */
+typedef struct {
+    /** Node within @ref _wlmaker_primitives_bezel_cache. */
+    bs_dllist_node_t          dlnode;
+    /** Width of the bezel. */
+    double                    bezel_width;
+    /** Width of the corners and edges, in pixels: ceil(bezel_width). */
+    unsigned                  edge;
+    /** Side length of the template: `2 * edge + 1`. */
+    unsigned                  size;
+    /** Coverage of the northwestern, then the southeastern polygon. */
+    uint8_t                   masks[];
+} wlmaker_primitives_bezel_t;
+
+/** Number of bezel templates to keep. */
+#define WLMAKER_PRIMITIVES_BEZEL_CACHE_SIZE 8
+/** Widest bezel to use templates for. */
+#define WLMAKER_PRIMITIVES_BEZEL_MAX_EDGE 32
+
+static void _wlmaker_primitives_bezel_path_nw(
+    cairo_t *cairo_ptr,
+    int x,
+    int y,
+    unsigned width,
+    unsigned height,
+    double bezel_width);
+static void _wlmaker_primitives_bezel_path_se(
+    cairo_t *cairo_ptr,
+    int x,
+    int y,
+    unsigned width,
+    unsigned height,
+    double bezel_width);
+static const wlmaker_primitives_bezel_t *_wlmaker_primitives_bezel_get(
+    double bezel_width);
+static wlmaker_primitives_bezel_t *_wlmaker_primitives_bezel_create(
+    double bezel_width);
+static void _wlmaker_primitives_bezel_blend(
+    uint32_t *pixel_ptr,
+    uint32_t color,
+    uint8_t coverage);
+
+static const wlmtk_style_fill_t *_wlmaker_primitives_fill_intern(
+    const wlmtk_style_fill_t *fill_ptr);
+static bs_gfxbuf_t *_wlmaker_primitives_fill_gfxbuf_create(
+    const wlmtk_style_fill_t *fill_ptr,
+    unsigned width,
+    unsigned height);
+static bool _wlmaker_primitives_gfxbuf_fill_native(
+    bs_gfxbuf_t *gfxbuf_ptr,
+    const wlmtk_style_fill_t *fill_ptr);
+static uint32_t _wlmaker_primitives_gradient_color(
+    uint32_t from,
+    uint32_t to,
+    uint64_t num,
+    uint64_t den);
+
+/** Kernel for filling a span of `count` pixels with `color`. */
+typedef void (*_wlmaker_primitives_span_kernel_t)(
+    uint32_t *dest_ptr,
+    uint32_t color,
+    size_t count);
+static _wlmaker_primitives_span_kernel_t _wlmaker_primitives_span_for(
+    wlmtk_util_simd_t simd);
+static void _wlmaker_primitives_span_scalar(
+    uint32_t *dest_ptr, uint32_t color, size_t count);
+#if defined(WLMTK_UTIL_SIMD_X86)
+static void _wlmaker_primitives_span_sse2(
+    uint32_t *dest_ptr, uint32_t color, size_t count);
+static void _wlmaker_primitives_span_avx2(
+    uint32_t *dest_ptr, uint32_t color, size_t count);
+#elif defined(WLMTK_UTIL_SIMD_NEON)
+static void _wlmaker_primitives_span_neon(
+    uint32_t *dest_ptr, uint32_t color, size_t count);
+#endif
+
+/* == Data ================================================================= */
+
+/** Filled buffers, shared among all users. */
+static bs_dllist_t            _wlmaker_primitives_fill_cache;
+
+/** Bezel templates, most recently used first. */
+static bs_dllist_t            _wlmaker_primitives_bezel_cache;
+
+/** Span fill kernel. Selected on first use. */
+static _wlmaker_primitives_span_kernel_t _wlmaker_primitives_span = NULL;
 
 /* == Exported methods ===================================================== */
 
@@ -125,6 +248,97 @@ void wlmaker_primitives_cairo_fill_at(
     cairo_restore(cairo_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+bool wlmaker_primitives_gfxbuf_fill(
+    bs_gfxbuf_t *gfxbuf_ptr,
+    const wlmtk_style_fill_t *fill_ptr)
+{
+    if (_wlmaker_primitives_gfxbuf_fill_native(gfxbuf_ptr, fill_ptr)) {
+        return true;
+    }
+
+    cairo_t *cairo_ptr = cairo_create_from_bs_gfxbuf(gfxbuf_ptr);
+    if (NULL == cairo_ptr) return false;
+    cairo_set_operator(cairo_ptr, CAIRO_OPERATOR_SOURCE);
+    wlmaker_primitives_cairo_fill(cairo_ptr, fill_ptr);
+    cairo_destroy(cairo_ptr);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+bs_gfxbuf_t *wlmaker_primitives_fill_gfxbuf_acquire(
+    const wlmtk_style_fill_t *fill_ptr,
+    unsigned width,
+    unsigned height)
+{
+    // Equal fills intern to the same pointer, so entries compare by pointer.
+    const wlmtk_style_fill_t *interned_fill_ptr =
+        _wlmaker_primitives_fill_intern(fill_ptr);
+    if (NULL == interned_fill_ptr) return NULL;
+
+    for (bs_dllist_node_t *dlnode_ptr =
+             _wlmaker_primitives_fill_cache.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_primitives_fill_entry_t *entry_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_primitives_fill_entry_t, dlnode);
+        if (entry_ptr->width == width && entry_ptr->height == height &&
+            entry_ptr->fill_ptr == interned_fill_ptr) {
+            wlmtk_style_release(interned_fill_ptr);
+            entry_ptr->references++;
+            return entry_ptr->gfxbuf_ptr;
+        }
+    }
+
+    wlmaker_primitives_fill_entry_t *entry_ptr = logged_calloc(
+        1, sizeof(wlmaker_primitives_fill_entry_t));
+    if (NULL == entry_ptr) {
+        wlmtk_style_release(interned_fill_ptr);
+        return NULL;
+    }
+    entry_ptr->gfxbuf_ptr = _wlmaker_primitives_fill_gfxbuf_create(
+        interned_fill_ptr, width, height);
+    if (NULL == entry_ptr->gfxbuf_ptr) {
+        wlmtk_style_release(interned_fill_ptr);
+        free(entry_ptr);
+        return NULL;
+    }
+    entry_ptr->fill_ptr = interned_fill_ptr;
+    entry_ptr->width = width;
+    entry_ptr->height = height;
+    entry_ptr->references = 1;
+    bs_dllist_push_front(&_wlmaker_primitives_fill_cache, &entry_ptr->dlnode);
+    // Filled buffers back the titlebar, resizebar and menu items.
+    wlmtk_memstat_add(WLMTK_MEMSTAT_DECORATIONS, NULL,
+                      (size_t)width * height * sizeof(uint32_t));
+    return entry_ptr->gfxbuf_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_primitives_fill_gfxbuf_release(bs_gfxbuf_t *gfxbuf_ptr)
+{
+    for (bs_dllist_node_t *dlnode_ptr =
+             _wlmaker_primitives_fill_cache.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_primitives_fill_entry_t *entry_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_primitives_fill_entry_t, dlnode);
+        if (entry_ptr->gfxbuf_ptr != gfxbuf_ptr) continue;
+
+        if (0 < --entry_ptr->references) return;
+        bs_dllist_remove(&_wlmaker_primitives_fill_cache, &entry_ptr->dlnode);
+        wlmtk_memstat_remove(
+            WLMTK_MEMSTAT_DECORATIONS, NULL,
+            (size_t)entry_ptr->width * entry_ptr->height * sizeof(uint32_t));
+        bs_gfxbuf_destroy(entry_ptr->gfxbuf_ptr);
+        wlmtk_style_release(entry_ptr->fill_ptr);
+        free(entry_ptr);
+        return;
+    }
+    bs_log(BS_FATAL, "Buffer %p not found in fill cache.", gfxbuf_ptr);
+    BS_ABORT();
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmaker_primitives_set_bezel_color(
     cairo_t *cairo_ptr,
@@ -164,29 +378,81 @@ void wlmaker_primitives_draw_bezel_at(
 
     // Northwestern corner is illuminted when raised.
     wlmaker_primitives_set_bezel_color(cairo_ptr, raised);
-    cairo_move_to(cairo_ptr, x, y);
-    cairo_line_to(cairo_ptr, x + width, y + 0);
-    cairo_line_to(cairo_ptr, x + width - bezel_width, y + bezel_width);
-    cairo_line_to(cairo_ptr, x + bezel_width, y + bezel_width);
-    cairo_line_to(cairo_ptr, x + bezel_width, y + height - bezel_width);
-    cairo_line_to(cairo_ptr, x + 0, y + height);
-    cairo_line_to(cairo_ptr, x + 0, y + 0);
+    _wlmaker_primitives_bezel_path_nw(
+        cairo_ptr, x, y, width, height, bezel_width);
     cairo_fill(cairo_ptr);
 
     // Southeastern corner is illuminated when sunken.
     wlmaker_primitives_set_bezel_color(cairo_ptr, !raised);
-    cairo_move_to(cairo_ptr, x + width, y + height);
-    cairo_line_to(cairo_ptr, x + 0, y + height);
-    cairo_line_to(cairo_ptr, x + bezel_width, y + height - bezel_width);
-    cairo_line_to(cairo_ptr, x + width - bezel_width, y + height - bezel_width);
-    cairo_line_to(cairo_ptr, x + width - bezel_width, y + bezel_width);
-    cairo_line_to(cairo_ptr, x + width, y + 0);
-    cairo_line_to(cairo_ptr, x + width, y + height);
+    _wlmaker_primitives_bezel_path_se(
+        cairo_ptr, x, y, width, height, bezel_width);
     cairo_fill(cairo_ptr);
 
     cairo_restore(cairo_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+bool wlmaker_primitives_gfxbuf_draw_bezel_at(
+    bs_gfxbuf_t *gfxbuf_ptr,
+    int x,
+    int y,
+    unsigned width,
+    unsigned height,
+    double bezel_width,
+    bool raised)
+{
+    const wlmaker_primitives_bezel_t *bezel_ptr = NULL;
+    if (0 <= x && 0 <= y &&
+        x + width <= gfxbuf_ptr->width && y + height <= gfxbuf_ptr->height) {
+        bezel_ptr = _wlmaker_primitives_bezel_get(bezel_width);
+    }
+    if (NULL == bezel_ptr ||
+        width < bezel_ptr->size || height < bezel_ptr->size) {
+        cairo_t *cairo_ptr = cairo_create_from_bs_gfxbuf(gfxbuf_ptr);
+        if (NULL == cairo_ptr) return false;
+        wlmaker_primitives_draw_bezel_at(
+            cairo_ptr, x, y, width, height, bezel_width, raised);
+        cairo_destroy(cairo_ptr);
+        return true;
+    }
+
+    // Same as wlmaker_primitives_set_bezel_color(), premultiplied.
+    uint32_t nw_color = raised ? 0x99999999 : 0x66000000;
+    uint32_t se_color = raised ? 0x66000000 : 0x99999999;
+    unsigned edge = bezel_ptr->edge;
+    unsigned size = bezel_ptr->size;
+    const uint8_t *nw_mask_ptr = &bezel_ptr->masks[0];
+    const uint8_t *se_mask_ptr = &bezel_ptr->masks[size * size];
+
+    for (unsigned py = 0; py < height; ++py) {
+        unsigned ty = edge;
+        if (py < edge) {
+            ty = py;
+        } else if (py >= height - edge) {
+            ty = py - (height - size);
+        }
+        uint32_t *line_ptr =
+            gfxbuf_ptr->data_ptr + (y + py) * gfxbuf_ptr->pixels_per_line + x;
+        for (unsigned px = 0; px < width; ++px) {
+            unsigned tx = edge;
+            if (px < edge) {
+                tx = px;
+            } else if (px >= width - edge) {
+                tx = px - (width - size);
+            } else if (ty == edge) {
+                // Inside the bezel: Skip to the eastern edge.
+                px = width - edge - 1;
+                continue;
+            }
+            _wlmaker_primitives_bezel_blend(
+                &line_ptr[px], nw_color, nw_mask_ptr[ty * size + tx]);
+            _wlmaker_primitives_bezel_blend(
+                &line_ptr[px], se_color, se_mask_ptr[ty * size + tx]);
+        }
+    }
+    return true;
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmaker_primitives_draw_minimize_icon(
     cairo_t *cairo_ptr,
@@ -256,6 +522,9 @@ void wlmaker_primitives_draw_text(
     uint32_t color,
     const char *text_ptr)
 {
+    if (wlmtk_text_draw(
+            cairo_ptr, x, y, font_style_ptr, color, text_ptr)) return;
+
     cairo_save(cairo_ptr);
     cairo_select_font_face(
         cairo_ptr,
@@ -271,9 +540,405 @@ void wlmaker_primitives_draw_text(
     cairo_restore(cairo_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+size_t wlmaker_primitives_bezel_cache_evict(unsigned percent)
+{
+    size_t entries = bs_dllist_size(&_wlmaker_primitives_bezel_cache);
+    size_t keep = entries - entries * BS_MIN(percent, 100u) / 100;
+    size_t bytes = 0;
+    while (bs_dllist_size(&_wlmaker_primitives_bezel_cache) > keep) {
+        wlmaker_primitives_bezel_t *bezel_ptr = BS_CONTAINER_OF(
+            _wlmaker_primitives_bezel_cache.tail_ptr,
+            wlmaker_primitives_bezel_t, dlnode);
+        bs_dllist_remove(&_wlmaker_primitives_bezel_cache, &bezel_ptr->dlnode);
+        bytes += sizeof(wlmaker_primitives_bezel_t) +
+            2 * bezel_ptr->size * bezel_ptr->size;
+        free(bezel_ptr);
+    }
+    return bytes;
+}
+
 /* == Local (static) methods =============================================== */
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Interns the fill, with only the parameters used by its type. Fills of same
+ * type and same parameters thus intern to the same pointer.
+ *
+ * @param fill_ptr
+ *
+ * @return The interned fill, or NULL on error. Must be released by calling
+ *     @ref wlmtk_style_release.
+ */
+const wlmtk_style_fill_t *_wlmaker_primitives_fill_intern(
+    const wlmtk_style_fill_t *fill_ptr)
+{
+    wlmtk_style_fill_t fill;
+    memset(&fill, 0, sizeof(fill));
+    fill.type = fill_ptr->type;
+    if (WLMTK_STYLE_COLOR_SOLID == fill_ptr->type) {
+        fill.param.solid.color = fill_ptr->param.solid.color;
+    } else {
+        // All gradients share the same layout.
+        fill.param.hgradient = fill_ptr->param.hgradient;
+    }
+    return WLMTK_STYLE_INTERN(&fill);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Adds the path of the bezel's northwestern polygon. */
+void _wlmaker_primitives_bezel_path_nw(
+    cairo_t *cairo_ptr,
+    int x,
+    int y,
+    unsigned width,
+    unsigned height,
+    double bezel_width)
+{
+    cairo_move_to(cairo_ptr, x, y);
+    cairo_line_to(cairo_ptr, x + width, y + 0);
+    cairo_line_to(cairo_ptr, x + width - bezel_width, y + bezel_width);
+    cairo_line_to(cairo_ptr, x + bezel_width, y + bezel_width);
+    cairo_line_to(cairo_ptr, x + bezel_width, y + height - bezel_width);
+    cairo_line_to(cairo_ptr, x + 0, y + height);
+    cairo_line_to(cairo_ptr, x + 0, y + 0);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Adds the path of the bezel's southeastern polygon. */
+void _wlmaker_primitives_bezel_path_se(
+    cairo_t *cairo_ptr,
+    int x,
+    int y,
+    unsigned width,
+    unsigned height,
+    double bezel_width)
+{
+    cairo_move_to(cairo_ptr, x + width, y + height);
+    cairo_line_to(cairo_ptr, x + 0, y + height);
+    cairo_line_to(cairo_ptr, x + bezel_width, y + height - bezel_width);
+    cairo_line_to(cairo_ptr,
+                  x + width - bezel_width, y + height - bezel_width);
+    cairo_line_to(cairo_ptr, x + width - bezel_width, y + bezel_width);
+    cairo_line_to(cairo_ptr, x + width, y + 0);
+    cairo_line_to(cairo_ptr, x + width, y + height);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the bezel template for `bezel_width` from the cache, creating it
+ * if needed. Evicts the least recently used template when the cache is full.
+ *
+ * @param bezel_width
+ *
+ * @return The template, or NULL if the bezel is too wide or on error.
+ */
+const wlmaker_primitives_bezel_t *_wlmaker_primitives_bezel_get(
+    double bezel_width)
+{
+    for (bs_dllist_node_t *dlnode_ptr =
+             _wlmaker_primitives_bezel_cache.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_primitives_bezel_t *bezel_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_primitives_bezel_t, dlnode);
+        if (bezel_ptr->bezel_width == bezel_width) {
+            bs_dllist_remove(&_wlmaker_primitives_bezel_cache, dlnode_ptr);
+            bs_dllist_push_front(&_wlmaker_primitives_bezel_cache, dlnode_ptr);
+            return bezel_ptr;
+        }
+    }
+
+    wlmaker_primitives_bezel_t *bezel_ptr = _wlmaker_primitives_bezel_create(
+        bezel_width);
+    if (NULL == bezel_ptr) return NULL;
+    if (WLMAKER_PRIMITIVES_BEZEL_CACHE_SIZE <=
+        bs_dllist_size(&_wlmaker_primitives_bezel_cache)) {
+        bs_dllist_node_t *dlnode_ptr =
+            _wlmaker_primitives_bezel_cache.tail_ptr;
+        bs_dllist_remove(&_wlmaker_primitives_bezel_cache, dlnode_ptr);
+        free(BS_CONTAINER_OF(dlnode_ptr, wlmaker_primitives_bezel_t, dlnode));
+    }
+    bs_dllist_push_front(&_wlmaker_primitives_bezel_cache, &bezel_ptr->dlnode);
+    return bezel_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Rasterizes a bezel template: Draws the two polygons at the template's size
+ * with cairo, each into an A8 surface, and keeps the coverage.
+ *
+ * @param bezel_width
+ *
+ * @return The template, or NULL if the bezel is too wide or on error.
+ */
+wlmaker_primitives_bezel_t *_wlmaker_primitives_bezel_create(
+    double bezel_width)
+{
+    if (!(0 <= bezel_width &&
+          WLMAKER_PRIMITIVES_BEZEL_MAX_EDGE >= bezel_width)) return NULL;
+    unsigned edge = ceil(bezel_width);
+    unsigned size = 2 * edge + 1;
+
+    wlmaker_primitives_bezel_t *bezel_ptr = logged_calloc(
+        1, sizeof(wlmaker_primitives_bezel_t) + 2 * size * size);
+    if (NULL == bezel_ptr) return NULL;
+    bezel_ptr->bezel_width = bezel_width;
+    bezel_ptr->edge = edge;
+    bezel_ptr->size = size;
+
+    for (int i = 0; i < 2; ++i) {
+        cairo_surface_t *surface_ptr = cairo_image_surface_create(
+            CAIRO_FORMAT_A8, size, size);
+        cairo_t *cairo_ptr = cairo_create(surface_ptr);
+        cairo_surface_destroy(surface_ptr);
+        if (CAIRO_STATUS_SUCCESS != cairo_status(cairo_ptr)) {
+            cairo_destroy(cairo_ptr);
+            free(bezel_ptr);
+            return NULL;
+        }
+        cairo_set_line_width(cairo_ptr, 0);
+        cairo_set_source_rgba(cairo_ptr, 0.0, 0.0, 0.0, 1.0);
+        if (0 == i) {
+            _wlmaker_primitives_bezel_path_nw(
+                cairo_ptr, 0, 0, size, size, bezel_width);
+        } else {
+            _wlmaker_primitives_bezel_path_se(
+                cairo_ptr, 0, 0, size, size, bezel_width);
+        }
+        cairo_fill(cairo_ptr);
+
+        surface_ptr = cairo_get_target(cairo_ptr);
+        cairo_surface_flush(surface_ptr);
+        const uint8_t *data_ptr = cairo_image_surface_get_data(surface_ptr);
+        int stride = cairo_image_surface_get_stride(surface_ptr);
+        for (unsigned y = 0; y < size; ++y) {
+            memcpy(&bezel_ptr->masks[(i * size + y) * size],
+                   data_ptr + y * stride, size);
+        }
+        cairo_destroy(cairo_ptr);
+    }
+    return bezel_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Blends the premultiplied `color` at `coverage` over the pixel. Uses the
+ * same rounding as pixman's OVER operator with a solid source and A8 mask.
+ *
+ * @param pixel_ptr
+ * @param color
+ * @param coverage
+ */
+void _wlmaker_primitives_bezel_blend(
+    uint32_t *pixel_ptr,
+    uint32_t color,
+    uint8_t coverage)
+{
+    if (0 == coverage) return;
+
+    uint32_t src[4], dst[4];
+    for (int c = 0; c < 4; ++c) {
+        uint32_t t = ((color >> (8 * c)) & 0xff) * coverage + 0x80;
+        src[c] = (t + (t >> 8)) >> 8;
+        dst[c] = (*pixel_ptr >> (8 * c)) & 0xff;
+    }
+    uint32_t inverse_alpha = 0xff - src[3];
+    uint32_t pixel = 0;
+    for (int c = 0; c < 4; ++c) {
+        uint32_t t = dst[c] * inverse_alpha + 0x80;
+        pixel |= BS_MIN(0xffu, src[c] + ((t + (t >> 8)) >> 8)) << (8 * c);
+    }
+    *pixel_ptr = pixel;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Creates a buffer of given dimensions, filled as specified. */
+bs_gfxbuf_t *_wlmaker_primitives_fill_gfxbuf_create(
+    const wlmtk_style_fill_t *fill_ptr,
+    unsigned width,
+    unsigned height)
+{
+    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_create(width, height);
+    if (NULL == gfxbuf_ptr) return NULL;
+    if (!wlmaker_primitives_gfxbuf_fill(gfxbuf_ptr, fill_ptr)) {
+        bs_gfxbuf_destroy(gfxbuf_ptr);
+        return NULL;
+    }
+    return gfxbuf_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Fills `gfxbuf_ptr` without cairo, if the fill permits it: Opaque solid
+ * colors, and horizontal or vertical gradients between opaque colors.
+ *
+ * Gradient colors are sampled at pixel centers, and rounded half-up. That
+ * matches cairo (pixman) for 2-stop linear gradients.
+ *
+ * @param gfxbuf_ptr
+ * @param fill_ptr
+ *
+ * @return true if the buffer was filled, false if the fill isn't supported.
+ */
+bool _wlmaker_primitives_gfxbuf_fill_native(
+    bs_gfxbuf_t *gfxbuf_ptr,
+    const wlmtk_style_fill_t *fill_ptr)
+{
+    uint32_t from, to;
+    switch (fill_ptr->type) {
+    case WLMTK_STYLE_COLOR_SOLID:
+        from = to = fill_ptr->param.solid.color;
+        break;
+    case WLMTK_STYLE_COLOR_HGRADIENT:
+        from = fill_ptr->param.hgradient.from;
+        to = fill_ptr->param.hgradient.to;
+        break;
+    case WLMTK_STYLE_COLOR_VGRADIENT:
+        from = fill_ptr->param.vgradient.from;
+        to = fill_ptr->param.vgradient.to;
+        break;
+    default:
+        return false;
+    }
+    // Translucent colors would need premultiplied interpolation.
+    if (0xff000000 != (from & to & 0xff000000)) return false;
+
+    if (NULL == _wlmaker_primitives_span) {
+        _wlmaker_primitives_span = _wlmaker_primitives_span_for(
+            wlmtk_util_simd_best());
+    }
+
+    unsigned width = gfxbuf_ptr->width;
+    unsigned height = gfxbuf_ptr->height;
+    if (0 == width || 0 == height) return true;
+    uint32_t *data_ptr = gfxbuf_ptr->data_ptr;
+    size_t ppl = gfxbuf_ptr->pixels_per_line;
+
+    if (WLMTK_STYLE_COLOR_HGRADIENT != fill_ptr->type) {
+        for (unsigned y = 0; y < height; ++y) {
+            uint32_t color = _wlmaker_primitives_gradient_color(
+                from, to, 2 * y + 1, 2 * height);
+            _wlmaker_primitives_span(data_ptr + y * ppl, color, width);
+        }
+        return true;
+    }
+
+    // Horizontal gradient: Compute the first line, and replicate it.
+    for (unsigned x = 0; x < width; ++x) {
+        data_ptr[x] = _wlmaker_primitives_gradient_color(
+            from, to, 2 * x + 1, 2 * width);
+    }
+    for (unsigned y = 1; y < height; ++y) {
+        memcpy(data_ptr + y * ppl, data_ptr, width * sizeof(uint32_t));
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Interpolates each channel between `from` and `to` at `num / den`, rounding
+ * half-up.
+ *
+ * @param from
+ * @param to
+ * @param num
+ * @param den                 Must be greater than 0, and not less than `num`.
+ *
+ * @return The interpolated color.
+ */
+uint32_t _wlmaker_primitives_gradient_color(
+    uint32_t from,
+    uint32_t to,
+    uint64_t num,
+    uint64_t den)
+{
+    uint32_t color = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        int64_t f = (from >> shift) & 0xff;
+        int64_t t = (to >> shift) & 0xff;
+        // Numerator stays non-negative, since the result is within [f, t].
+        int64_t v = (2 * f * (int64_t)den + 2 * (t - f) * (int64_t)num +
+                     (int64_t)den) / (2 * (int64_t)den);
+        color |= (uint32_t)v << shift;
+    }
+    return color;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the span fill kernel for `simd`. Falls back to the scalar kernel,
+ * if there is none for `simd`. Support by the CPU is not checked.
+ */
+_wlmaker_primitives_span_kernel_t _wlmaker_primitives_span_for(
+    wlmtk_util_simd_t simd)
+{
+    switch (simd) {
+#if defined(WLMTK_UTIL_SIMD_X86)
+    case WLMTK_UTIL_SIMD_AVX2: return _wlmaker_primitives_span_avx2;
+    case WLMTK_UTIL_SIMD_SSE2: return _wlmaker_primitives_span_sse2;
+#elif defined(WLMTK_UTIL_SIMD_NEON)
+    case WLMTK_UTIL_SIMD_AARCH64_NEON: return _wlmaker_primitives_span_neon;
+#endif
+    default: return _wlmaker_primitives_span_scalar;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Scalar span fill kernel. Also handles the tails for the vector kernels. */
+void _wlmaker_primitives_span_scalar(
+    uint32_t *dest_ptr, uint32_t color, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) dest_ptr[i] = color;
+}
+
+#if defined(WLMTK_UTIL_SIMD_X86)
+/* ------------------------------------------------------------------------- */
+/** SSE2 span fill kernel: Writes 4 pixels at a time. */
+__attribute__((target("sse2")))
+void _wlmaker_primitives_span_sse2(
+    uint32_t *dest_ptr, uint32_t color, size_t count)
+{
+    const __m128i vcolor = _mm_set1_epi32((int32_t)color);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128((__m128i*)(dest_ptr + i), vcolor);
+    }
+    _wlmaker_primitives_span_scalar(dest_ptr + i, color, count - i);
+}
+
+/* ------------------------------------------------------------------------- */
+/** AVX2 span fill kernel: Writes 8 pixels at a time. */
+__attribute__((target("avx2")))
+void _wlmaker_primitives_span_avx2(
+    uint32_t *dest_ptr, uint32_t color, size_t count)
+{
+    const __m256i vcolor = _mm256_set1_epi32((int32_t)color);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_si256((__m256i*)(dest_ptr + i), vcolor);
+    }
+    _wlmaker_primitives_span_scalar(dest_ptr + i, color, count - i);
+}
+#elif defined(WLMTK_UTIL_SIMD_NEON)
+/* ------------------------------------------------------------------------- */
+/** NEON span fill kernel: Writes 4 pixels at a time. */
+void _wlmaker_primitives_span_neon(
+    uint32_t *dest_ptr, uint32_t color, size_t count)
+{
+    const uint32x4_t vcolor = vdupq_n_u32(color);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) vst1q_u32(dest_ptr + i, vcolor);
+    _wlmaker_primitives_span_scalar(dest_ptr + i, color, count - i);
+}
+#endif
+
+/* == Unit tests =========================================================== */
+
 static void test_fill(bs_test_t *test_ptr);
+static void test_fill_cache(bs_test_t *test_ptr);
+static void test_gfxbuf_fill(bs_test_t *test_ptr);
+static void test_gfxbuf_bezel(bs_test_t *test_ptr);
 static void test_close(bs_test_t *test_ptr);
 static void test_close_large(bs_test_t *test_ptr);
 static void test_minimize(bs_test_t *test_ptr);
@@ -284,6 +949,9 @@ static void test_window_title(bs_test_t *test_ptr);
 /** Unit tests. */
 const bs_test_case_t   wlmaker_primitives_test_cases[] = {
     { 1, "fill", test_fill },
+    { 1, "fill_cache", test_fill_cache },
+    { 1, "gfxbuf_fill", test_gfxbuf_fill },
+    { 1, "gfxbuf_bezel", test_gfxbuf_bezel },
     { 1, "close", test_close },
     { 1, "close_large", test_close_large },
     { 1, "minimize", test_minimize },
@@ -351,6 +1019,199 @@ void test_fill(bs_test_t *test_ptr)
     bs_gfxbuf_destroy(gfxbuf_ptr);
 }
 
+/** Verifies filled buffers are shared, and look the same as drawn. */
+void test_fill_cache(bs_test_t *test_ptr)
+{
+    wlmtk_style_fill_t fill_vgradient = {
+        .type = WLMTK_STYLE_COLOR_VGRADIENT,
+        .param = { .vgradient = { .from = 0xff102040, .to = 0xff4080ff }}
+    };
+    bs_gfxbuf_t *v1_ptr = wlmaker_primitives_fill_gfxbuf_acquire(
+        &fill_vgradient, 16, 8);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, v1_ptr);
+    BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
+        test_ptr, v1_ptr, "toolkit/primitive_fill_vgradient.png");
+    bs_gfxbuf_t *v2_ptr = wlmaker_primitives_fill_gfxbuf_acquire(
+        &fill_vgradient, 16, 8);
+    BS_TEST_VERIFY_EQ(test_ptr, v1_ptr, v2_ptr);
+
+    // Different geometry or style: A different buffer.
+    bs_gfxbuf_t *v3_ptr = wlmaker_primitives_fill_gfxbuf_acquire(
+        &fill_vgradient, 15, 8);
+    BS_TEST_VERIFY_NEQ(test_ptr, v1_ptr, v3_ptr);
+    wlmtk_style_fill_t fill_hgradient = {
+        .type = WLMTK_STYLE_COLOR_HGRADIENT,
+        .param = { .hgradient = { .from = 0xff102040, .to = 0xff4080ff }}
+    };
+    bs_gfxbuf_t *h_ptr = wlmaker_primitives_fill_gfxbuf_acquire(
+        &fill_hgradient, 16, 8);
+    BS_TEST_VERIFY_NEQ(test_ptr, v1_ptr, h_ptr);
+    BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
+        test_ptr, h_ptr, "toolkit/primitive_fill_hgradient.png");
+
+    // Parameters not used by the type do not matter.
+    wlmtk_style_fill_t fill_solid1 = {
+        .type = WLMTK_STYLE_COLOR_SOLID,
+        .param = { .hgradient = { .from = 0xff204080, .to = 0xff000000 }}
+    };
+    wlmtk_style_fill_t fill_solid2 = {
+        .type = WLMTK_STYLE_COLOR_SOLID,
+        .param = { .hgradient = { .from = 0xff204080, .to = 0xffffffff }}
+    };
+    bs_gfxbuf_t *s1_ptr = wlmaker_primitives_fill_gfxbuf_acquire(
+        &fill_solid1, 16, 8);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, s1_ptr);
+    bs_gfxbuf_t *s2_ptr = wlmaker_primitives_fill_gfxbuf_acquire(
+        &fill_solid2, 16, 8);
+    BS_TEST_VERIFY_EQ(test_ptr, s1_ptr, s2_ptr);
+    wlmaker_primitives_fill_gfxbuf_release(s2_ptr);
+    wlmaker_primitives_fill_gfxbuf_release(s1_ptr);
+
+    wlmaker_primitives_fill_gfxbuf_release(h_ptr);
+    wlmaker_primitives_fill_gfxbuf_release(v3_ptr);
+    wlmaker_primitives_fill_gfxbuf_release(v2_ptr);
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, bs_dllist_empty(&_wlmaker_primitives_fill_cache));
+    wlmaker_primitives_fill_gfxbuf_release(v1_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, bs_dllist_empty(&_wlmaker_primitives_fill_cache));
+}
+
+/** Verifies native fills look the same as drawn by cairo. */
+void test_gfxbuf_fill(bs_test_t *test_ptr)
+{
+    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_create(16, 8);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, gfxbuf_ptr);
+
+    wlmtk_style_fill_t fill = {
+        .type = WLMTK_STYLE_COLOR_SOLID,
+        .param = { .solid = { .color = 0xff4080c0} }
+    };
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmaker_primitives_gfxbuf_fill_native(
+                            gfxbuf_ptr, &fill));
+    BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
+        test_ptr, gfxbuf_ptr, "toolkit/primitive_fill_solid.png");
+
+    fill = (wlmtk_style_fill_t){
+        .type = WLMTK_STYLE_COLOR_HGRADIENT,
+        .param = { .hgradient = { .from = 0xff102040, .to = 0xff4080ff }}
+    };
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmaker_primitives_gfxbuf_fill_native(
+                            gfxbuf_ptr, &fill));
+    BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
+        test_ptr, gfxbuf_ptr, "toolkit/primitive_fill_hgradient.png");
+
+    fill = (wlmtk_style_fill_t){
+        .type = WLMTK_STYLE_COLOR_VGRADIENT,
+        .param = { .vgradient = { .from = 0xff102040, .to = 0xff4080ff }}
+    };
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmaker_primitives_gfxbuf_fill_native(
+                            gfxbuf_ptr, &fill));
+    BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
+        test_ptr, gfxbuf_ptr, "toolkit/primitive_fill_vgradient.png");
+
+    // Diagonal and translucent fills are left to cairo.
+    fill = (wlmtk_style_fill_t){
+        .type = WLMTK_STYLE_COLOR_DGRADIENT,
+        .param = { .dgradient = { .from = 0xff102040, .to = 0xff4080ff }}
+    };
+    BS_TEST_VERIFY_FALSE(test_ptr, _wlmaker_primitives_gfxbuf_fill_native(
+                             gfxbuf_ptr, &fill));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmaker_primitives_gfxbuf_fill(
+                            gfxbuf_ptr, &fill));
+    BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
+        test_ptr, gfxbuf_ptr, "toolkit/primitive_fill_dgradient.png");
+    fill = (wlmtk_style_fill_t){
+        .type = WLMTK_STYLE_COLOR_SOLID,
+        .param = { .solid = { .color = 0x80402010} }
+    };
+    BS_TEST_VERIFY_FALSE(test_ptr, _wlmaker_primitives_gfxbuf_fill_native(
+                             gfxbuf_ptr, &fill));
+
+    // Each supported span kernel agrees with the scalar one, incl. tails.
+    uint32_t span[2][19];
+    for (int simd = 0; simd < WLMTK_UTIL_SIMD_MAX; ++simd) {
+        if (!wlmtk_util_simd_supported(simd)) continue;
+        _wlmaker_primitives_span_kernel_t kernel =
+            _wlmaker_primitives_span_for(simd);
+        for (size_t count = 0; count <= 19; ++count) {
+            memset(span, 0, sizeof(span));
+            kernel(span[0], 0xff123456, count);
+            _wlmaker_primitives_span_scalar(span[1], 0xff123456, count);
+            BS_TEST_VERIFY_EQ(test_ptr, 0, memcmp(span[0], span[1],
+                                                  sizeof(span[0])));
+        }
+    }
+
+    bs_gfxbuf_destroy(gfxbuf_ptr);
+}
+
+/** Verifies bezels from templates look the same as drawn by cairo. */
+void test_gfxbuf_bezel(bs_test_t *test_ptr)
+{
+    static const struct {
+        unsigned width, height;
+        double bezel_width;
+        bool raised;
+    } cases[] = {
+        { 40, 22, 1.0, true },
+        { 40, 22, 1.0, false },
+        { 23, 17, 2.0, true },
+        { 64, 64, 1.5, false },
+        { 3, 3, 1.0, true },   // Smaller than the template: Uses cairo.
+    };
+    wlmtk_style_fill_t fill = {
+        .type = WLMTK_STYLE_COLOR_HGRADIENT,
+        .param = { .hgradient = { .from = 0xff102040, .to = 0xff4080ff }}
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        bs_gfxbuf_t *c_ptr = bs_gfxbuf_create(cases[i].width + 4,
+                                              cases[i].height + 2);
+        bs_gfxbuf_t *n_ptr = bs_gfxbuf_create(cases[i].width + 4,
+                                              cases[i].height + 2);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, c_ptr);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, n_ptr);
+        wlmaker_primitives_gfxbuf_fill(c_ptr, &fill);
+        wlmaker_primitives_gfxbuf_fill(n_ptr, &fill);
+
+        cairo_t *cairo_ptr = cairo_create_from_bs_gfxbuf(c_ptr);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, cairo_ptr);
+        wlmaker_primitives_draw_bezel_at(
+            cairo_ptr, 3, 1, cases[i].width, cases[i].height,
+            cases[i].bezel_width, cases[i].raised);
+        cairo_destroy(cairo_ptr);
+        BS_TEST_VERIFY_TRUE(
+            test_ptr, wlmaker_primitives_gfxbuf_draw_bezel_at(
+                n_ptr, 3, 1, cases[i].width, cases[i].height,
+                cases[i].bezel_width, cases[i].raised));
+
+        // Permit rounding differences between cairo's blending paths.
+        int max_diff = 0;
+        for (unsigned y = 0; y < c_ptr->height; ++y) {
+            for (unsigned x = 0; x < c_ptr->width; ++x) {
+                uint32_t c = c_ptr->data_ptr[y * c_ptr->pixels_per_line + x];
+                uint32_t n = n_ptr->data_ptr[y * n_ptr->pixels_per_line + x];
+                for (int s = 0; s < 32; s += 8) {
+                    int d = (int)((c >> s) & 0xff) - (int)((n >> s) & 0xff);
+                    max_diff = BS_MAX(max_diff, abs(d));
+                }
+            }
+        }
+        BS_TEST_VERIFY_TRUE(test_ptr, 1 >= max_diff);
+        bs_gfxbuf_destroy(n_ptr);
+        bs_gfxbuf_destroy(c_ptr);
+    }
+
+    // The templates are cached, until evicted.
+    BS_TEST_VERIFY_NEQ(test_ptr, 0, bs_dllist_size(
+                           &_wlmaker_primitives_bezel_cache));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmaker_primitives_bezel_cache_evict(0));
+    BS_TEST_VERIFY_NEQ(test_ptr, 0, wlmaker_primitives_bezel_cache_evict(100));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, bs_dllist_size(
+                          &_wlmaker_primitives_bezel_cache));
+}
+
 /** Verifies the looks of the "close" icon. */
 void test_close(bs_test_t *test_ptr)
 {
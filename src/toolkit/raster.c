@@ -0,0 +1,469 @@
+/* ========================================================================= */
+/**
+ * @file raster.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "raster.h"
+
+#include <cairo.h>
+#include <errno.h>
+#include <libbase/libbase.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <wayland-server-core.h>
+
+#define WLR_USE_UNSTABLE
+#include <wlr/types/wlr_buffer.h>
+#undef WLR_USE_UNSTABLE
+
+#include "gfxbuf.h"
+
+/* == Declarations ========================================================= */
+
+/** State of a rasterization job. */
+typedef enum {
+    WLMTK_RASTER_JOB_PENDING,
+    WLMTK_RASTER_JOB_RUNNING,
+    WLMTK_RASTER_JOB_DONE
+} wlmtk_raster_job_state_t;
+
+/** A rasterization job. */
+struct _wlmtk_raster_job_t {
+    /** Element of @ref _wlmtk_raster_t::pending or `done`. */
+    bs_dllist_node_t          dlnode;
+    /** State. Guarded by @ref _wlmtk_raster_t::mutex. */
+    wlmtk_raster_job_state_t  state;
+    /** Whether the job was cancelled. Main thread only. */
+    bool                      cancelled;
+
+    /** Buffer to draw into. Locked by the job. */
+    struct wlr_buffer         *wlr_buffer_ptr;
+    /** Whether `draw` succeeded. */
+    bool                      drawn;
+
+    /** Draws the buffer. */
+    wlmtk_raster_draw_t       draw;
+    /** Argument to `draw`. */
+    void                      *arg_ptr;
+    /** Destroys `arg_ptr`. May be NULL. */
+    void                      (*arg_destroy)(void *arg_ptr);
+    /** Completion callback. */
+    wlmtk_raster_done_t       done;
+    /** Argument to `done`. */
+    void                      *ud_ptr;
+};
+
+/** Rasterizer threads, and the queues for their jobs. */
+typedef struct {
+    /** Guards `pending`, `done`, `shutdown` and the jobs' `state`. */
+    pthread_mutex_t           mutex;
+    /** Signals that `pending` has jobs, or `shutdown` was set. */
+    pthread_cond_t            cond;
+    /** Jobs waiting for a rasterizer thread. */
+    bs_dllist_t               pending;
+    /** Jobs drawn, waiting to be completed on the main thread. */
+    bs_dllist_t               done;
+    /** Tells the rasterizer threads to exit. */
+    bool                      shutdown;
+    /** The rasterizer threads. */
+    pthread_t                 threads[2];
+    /** Number of threads that were started. */
+    size_t                    num_threads;
+    /** Event file descriptor, signalled when jobs are done. */
+    int                       event_fd;
+    /** Event source for `event_fd`. */
+    struct wl_event_source    *event_source_ptr;
+} _wlmtk_raster_t;
+
+static bool _wlmtk_raster_job_draw(wlmtk_raster_job_t *job_ptr);
+static void _wlmtk_raster_job_complete(wlmtk_raster_job_t *job_ptr);
+static void *_wlmtk_raster_thread(void *arg_ptr);
+static int _wlmtk_raster_handle_event(
+    int fd,
+    uint32_t mask,
+    void *data_ptr);
+static void _wlmtk_raster_stop(void);
+
+/* == Data ================================================================= */
+
+/** The rasterizer. Has no threads, unless @ref wlmtk_raster_defer. */
+static _wlmtk_raster_t _wlmtk_raster = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+    .event_fd = -1
+};
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_raster_defer(struct wl_event_loop *wl_event_loop_ptr)
+{
+    _wlmtk_raster_t *raster_ptr = &_wlmtk_raster;
+    _wlmtk_raster_stop();
+    if (NULL == wl_event_loop_ptr) return true;
+
+    raster_ptr->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (0 > raster_ptr->event_fd) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed eventfd(0, %d)",
+               EFD_CLOEXEC | EFD_NONBLOCK);
+        return false;
+    }
+    raster_ptr->event_source_ptr = wl_event_loop_add_fd(
+        wl_event_loop_ptr,
+        raster_ptr->event_fd,
+        WL_EVENT_READABLE,
+        _wlmtk_raster_handle_event,
+        NULL);
+    if (NULL == raster_ptr->event_source_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_fd(%p, %d, ...)",
+               wl_event_loop_ptr, raster_ptr->event_fd);
+        _wlmtk_raster_stop();
+        return false;
+    }
+
+    raster_ptr->shutdown = false;
+    for (size_t i = 0;
+         i < sizeof(raster_ptr->threads) / sizeof(pthread_t);
+         ++i) {
+        int rv = pthread_create(
+            &raster_ptr->threads[i], NULL, _wlmtk_raster_thread,
+            raster_ptr);
+        if (0 != rv) {
+            errno = rv;
+            bs_log(BS_ERROR | BS_ERRNO, "Failed pthread_create()");
+            _wlmtk_raster_stop();
+            return false;
+        }
+        ++raster_ptr->num_threads;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+wlmtk_raster_job_t *wlmtk_raster_submit(
+    unsigned width,
+    unsigned height,
+    wlmtk_raster_draw_t draw,
+    void *arg_ptr,
+    void (*arg_destroy)(void *arg_ptr),
+    wlmtk_raster_done_t done,
+    void *ud_ptr)
+{
+    wlmtk_raster_job_t *job_ptr = logged_calloc(
+        1, sizeof(wlmtk_raster_job_t));
+    if (NULL == job_ptr) {
+        if (NULL != arg_destroy) arg_destroy(arg_ptr);
+        done(NULL, ud_ptr);
+        return NULL;
+    }
+    job_ptr->draw = draw;
+    job_ptr->arg_ptr = arg_ptr;
+    job_ptr->arg_destroy = arg_destroy;
+    job_ptr->done = done;
+    job_ptr->ud_ptr = ud_ptr;
+
+    // Allocate here: The buffer pool is not thread-safe.
+    job_ptr->wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(width, height);
+    if (NULL == job_ptr->wlr_buffer_ptr ||
+        0 == _wlmtk_raster.num_threads) {
+        if (NULL != job_ptr->wlr_buffer_ptr) {
+            job_ptr->drawn = _wlmtk_raster_job_draw(job_ptr);
+        }
+        _wlmtk_raster_job_complete(job_ptr);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&_wlmtk_raster.mutex);
+    job_ptr->state = WLMTK_RASTER_JOB_PENDING;
+    bs_dllist_push_back(&_wlmtk_raster.pending, &job_ptr->dlnode);
+    pthread_cond_signal(&_wlmtk_raster.cond);
+    pthread_mutex_unlock(&_wlmtk_raster.mutex);
+    return job_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_raster_cancel(wlmtk_raster_job_t *job_ptr)
+{
+    if (NULL == job_ptr) return;
+
+    pthread_mutex_lock(&_wlmtk_raster.mutex);
+    bool pending = WLMTK_RASTER_JOB_PENDING == job_ptr->state;
+    if (pending) bs_dllist_remove(&_wlmtk_raster.pending, &job_ptr->dlnode);
+    pthread_mutex_unlock(&_wlmtk_raster.mutex);
+
+    // Running or done jobs are owned by the rasterizer, until completed.
+    job_ptr->cancelled = true;
+    if (pending) _wlmtk_raster_job_complete(job_ptr);
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Draws the job's buffer. Called on any thread. */
+bool _wlmtk_raster_job_draw(wlmtk_raster_job_t *job_ptr)
+{
+    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(job_ptr->wlr_buffer_ptr);
+    if (NULL == cairo_ptr) return false;
+    bool rv = job_ptr->draw(cairo_ptr, job_ptr->arg_ptr);
+    cairo_destroy(cairo_ptr);
+    return rv;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Completes the job on the main thread: Calls `done`, unless cancelled.
+ * Then releases the buffer and destroys the job.
+ *
+ * @param job_ptr
+ */
+void _wlmtk_raster_job_complete(wlmtk_raster_job_t *job_ptr)
+{
+    if (!job_ptr->cancelled) {
+        job_ptr->done(job_ptr->drawn ? job_ptr->wlr_buffer_ptr : NULL,
+                      job_ptr->ud_ptr);
+    }
+    if (NULL != job_ptr->wlr_buffer_ptr) {
+        wlr_buffer_drop(job_ptr->wlr_buffer_ptr);
+    }
+    if (NULL != job_ptr->arg_destroy) job_ptr->arg_destroy(job_ptr->arg_ptr);
+    free(job_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Rasterizer thread: Takes jobs from @ref _wlmtk_raster_t::pending, draws
+ * them and passes the job on to `done`.
+ *
+ * @param arg_ptr             Points to @ref _wlmtk_raster_t.
+ *
+ * @return NULL.
+ */
+void *_wlmtk_raster_thread(void *arg_ptr)
+{
+    _wlmtk_raster_t *raster_ptr = arg_ptr;
+
+    pthread_mutex_lock(&raster_ptr->mutex);
+    while (!raster_ptr->shutdown) {
+        bs_dllist_node_t *dlnode_ptr = bs_dllist_pop_front(
+            &raster_ptr->pending);
+        if (NULL == dlnode_ptr) {
+            pthread_cond_wait(&raster_ptr->cond, &raster_ptr->mutex);
+            continue;
+        }
+        wlmtk_raster_job_t *job_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_raster_job_t, dlnode);
+        job_ptr->state = WLMTK_RASTER_JOB_RUNNING;
+        pthread_mutex_unlock(&raster_ptr->mutex);
+
+        job_ptr->drawn = _wlmtk_raster_job_draw(job_ptr);
+
+        pthread_mutex_lock(&raster_ptr->mutex);
+        job_ptr->state = WLMTK_RASTER_JOB_DONE;
+        bs_dllist_push_back(&raster_ptr->done, &job_ptr->dlnode);
+        uint64_t value = 1;
+        if (sizeof(value) != write(raster_ptr->event_fd, &value,
+                                   sizeof(value))) {
+            bs_log(BS_WARNING | BS_ERRNO, "Failed write(%d, ...)",
+                   raster_ptr->event_fd);
+        }
+    }
+    pthread_mutex_unlock(&raster_ptr->mutex);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles the event fd: Completes all drawn jobs, on the main thread. */
+int _wlmtk_raster_handle_event(
+    int fd,
+    __UNUSED__ uint32_t mask,
+    __UNUSED__ void *data_ptr)
+{
+    uint64_t value;
+    if (0 > read(fd, &value, sizeof(value)) && EAGAIN != errno) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed read(%d, ...)", fd);
+    }
+
+    pthread_mutex_lock(&_wlmtk_raster.mutex);
+    bs_dllist_t done = _wlmtk_raster.done;
+    _wlmtk_raster.done = (bs_dllist_t){};
+    pthread_mutex_unlock(&_wlmtk_raster.mutex);
+
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&done))) {
+        _wlmtk_raster_job_complete(BS_CONTAINER_OF(
+                                       dlnode_ptr, wlmtk_raster_job_t,
+                                       dlnode));
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Stops and joins the rasterizer threads. Then draws and completes all
+ * outstanding jobs synchronously.
+ */
+void _wlmtk_raster_stop(void)
+{
+    _wlmtk_raster_t *raster_ptr = &_wlmtk_raster;
+
+    pthread_mutex_lock(&raster_ptr->mutex);
+    raster_ptr->shutdown = true;
+    pthread_cond_broadcast(&raster_ptr->cond);
+    pthread_mutex_unlock(&raster_ptr->mutex);
+    for (size_t i = 0; i < raster_ptr->num_threads; ++i) {
+        pthread_join(raster_ptr->threads[i], NULL);
+    }
+    raster_ptr->num_threads = 0;
+
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&raster_ptr->done))) {
+        _wlmtk_raster_job_complete(BS_CONTAINER_OF(
+                                       dlnode_ptr, wlmtk_raster_job_t,
+                                       dlnode));
+    }
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&raster_ptr->pending))) {
+        wlmtk_raster_job_t *job_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_raster_job_t, dlnode);
+        job_ptr->state = WLMTK_RASTER_JOB_DONE;
+        job_ptr->drawn = _wlmtk_raster_job_draw(job_ptr);
+        _wlmtk_raster_job_complete(job_ptr);
+    }
+
+    if (NULL != raster_ptr->event_source_ptr) {
+        wl_event_source_remove(raster_ptr->event_source_ptr);
+        raster_ptr->event_source_ptr = NULL;
+    }
+    if (0 <= raster_ptr->event_fd) {
+        close(raster_ptr->event_fd);
+        raster_ptr->event_fd = -1;
+    }
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_sync(bs_test_t *test_ptr);
+static void test_deferred(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_raster_test_cases[] = {
+    { 1, "sync", test_sync },
+    { 1, "deferred", test_deferred },
+    { 0, NULL, NULL }
+};
+
+/** Test argument: Counts completions, and keeps the last buffer. */
+typedef struct {
+    /** Number of calls to @ref _wlmtk_raster_test_done. */
+    int                       calls;
+    /** Last buffer passed to @ref _wlmtk_raster_test_done. Locked. */
+    struct wlr_buffer         *wlr_buffer_ptr;
+} _wlmtk_raster_test_t;
+
+/** Test drawing: Fills with the color pointed to by `arg_ptr`. */
+static bool _wlmtk_raster_test_draw(cairo_t *cairo_ptr, void *arg_ptr)
+{
+    uint32_t *argb32_ptr = arg_ptr;
+    cairo_set_source_rgba(
+        cairo_ptr,
+        ((*argb32_ptr >> 16) & 0xff) / 255.0,
+        ((*argb32_ptr >> 8) & 0xff) / 255.0,
+        (*argb32_ptr & 0xff) / 255.0,
+        (*argb32_ptr >> 24) / 255.0);
+    cairo_paint(cairo_ptr);
+    return true;
+}
+
+/** Test completion: Keeps the buffer in @ref _wlmtk_raster_test_t. */
+static void _wlmtk_raster_test_done(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr)
+{
+    _wlmtk_raster_test_t *t_ptr = ud_ptr;
+    ++t_ptr->calls;
+    if (NULL != t_ptr->wlr_buffer_ptr) {
+        wlr_buffer_unlock(t_ptr->wlr_buffer_ptr);
+    }
+    t_ptr->wlr_buffer_ptr = wlr_buffer_lock(wlr_buffer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Without rasterizer threads, jobs complete right away. */
+void test_sync(bs_test_t *test_ptr)
+{
+    uint32_t argb32 = 0xff2040c0;
+    _wlmtk_raster_test_t t = {};
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL,
+        wlmtk_raster_submit(4, 2, _wlmtk_raster_test_draw, &argb32, NULL,
+                            _wlmtk_raster_test_done, &t));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, t.calls);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, t.wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 4, t.wlr_buffer_ptr->width);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0xff2040c0,
+        bs_gfxbuf_from_wlr_buffer(t.wlr_buffer_ptr)->data_ptr[1 * 4 + 3]);
+    wlr_buffer_unlock(t.wlr_buffer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** With rasterizer threads: Completes from the event loop, and cancels. */
+void test_deferred(bs_test_t *test_ptr)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(
+        test_ptr, wlmtk_raster_defer(wl_event_loop_ptr));
+
+    uint32_t argb32 = 0xff102030;
+    _wlmtk_raster_test_t t1 = {}, t2 = {}, t3 = {};
+    wlmtk_raster_job_t *j1_ptr = wlmtk_raster_submit(
+        4, 2, _wlmtk_raster_test_draw, &argb32, NULL,
+        _wlmtk_raster_test_done, &t1);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, j1_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, t1.calls);
+
+    // A cancelled job never completes, wherever it was.
+    wlmtk_raster_cancel(wlmtk_raster_submit(
+                            4, 2, _wlmtk_raster_test_draw, &argb32, NULL,
+                            _wlmtk_raster_test_done, &t2));
+
+    for (int i = 0; i < 100 && 0 == t1.calls; ++i) {
+        wl_event_loop_dispatch(wl_event_loop_ptr, 10);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 1, t1.calls);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, t1.wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0xff102030,
+        bs_gfxbuf_from_wlr_buffer(t1.wlr_buffer_ptr)->data_ptr[0]);
+
+    // Stopping the threads completes all outstanding jobs.
+    wlmtk_raster_submit(4, 2, _wlmtk_raster_test_draw, &argb32, NULL,
+                        _wlmtk_raster_test_done, &t3);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_raster_defer(NULL));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, t3.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, t2.calls);
+
+    wlr_buffer_unlock(t3.wlr_buffer_ptr);
+    wlr_buffer_unlock(t1.wlr_buffer_ptr);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
+/* == End of raster.c ====================================================== */
@@ -31,6 +31,7 @@
 
 #include "container.h"
 #include "input.h"
+#include "pool.h"
 #include "util.h"
 
 /* == Declarations ========================================================= */
@@ -74,6 +75,10 @@ static void handle_wlr_scene_rect_node_destroy(
 
 /* == Data ================================================================= */
 
+/** Pool for rectangles. */
+static wlmtk_pool_t _wlmtk_rectangle_pool = WLMTK_POOL_INITIALIZER(
+    "rectangle", wlmtk_rectangle_t);
+
 /** Virtual method table of the rectangle, extending the element. */
 static const wlmtk_element_vmt_t _wlmtk_rectangle_element_vmt = {
     .destroy = _wlmtk_rectangle_element_destroy,
@@ -90,8 +95,8 @@ wlmtk_rectangle_t *wlmtk_rectangle_create(
     int height,
     uint32_t color)
 {
-    wlmtk_rectangle_t *rectangle_ptr = logged_calloc(
-        1, sizeof(wlmtk_rectangle_t));
+    wlmtk_rectangle_t *rectangle_ptr = wlmtk_pool_alloc(
+        &_wlmtk_rectangle_pool);
     if (NULL == rectangle_ptr) return NULL;
     rectangle_ptr->width = width;
     rectangle_ptr->height = height;
@@ -104,6 +109,9 @@ wlmtk_rectangle_t *wlmtk_rectangle_create(
     rectangle_ptr->orig_super_element_vmt = wlmtk_element_extend(
         &rectangle_ptr->super_element,
         &_wlmtk_rectangle_element_vmt);
+    rectangle_ptr->super_element.type = WLMTK_ELEMENT_RECTANGLE;
+    rectangle_ptr->super_element.leaf_width = width;
+    rectangle_ptr->super_element.leaf_height = height;
 
     return rectangle_ptr;
 }
@@ -117,7 +125,7 @@ void wlmtk_rectangle_destroy(wlmtk_rectangle_t *rectangle_ptr)
     }
 
     wlmtk_element_fini(&rectangle_ptr->super_element);
-    free(rectangle_ptr);
+    wlmtk_pool_free(&_wlmtk_rectangle_pool, rectangle_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -128,6 +136,8 @@ void wlmtk_rectangle_set_size(
 {
     rectangle_ptr->width = width;
     rectangle_ptr->height = height;
+    rectangle_ptr->super_element.leaf_width = width;
+    rectangle_ptr->super_element.leaf_height = height;
 
     if (NULL != rectangle_ptr->wlr_scene_rect_ptr) {
         wlr_scene_rect_set_size(
@@ -135,6 +145,7 @@ void wlmtk_rectangle_set_size(
             rectangle_ptr->width,
             rectangle_ptr->height);
     }
+    wlmtk_element_invalidate_extents(&rectangle_ptr->super_element);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -22,6 +22,8 @@
 
 #include <cairo.h>
 #include <libbase/libbase.h>
+#include <math.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <toolkit/box.h>
 #include <toolkit/primitives.h>
@@ -32,6 +34,7 @@
 #undef WLR_USE_UNSTABLE
 
 #include "container.h"
+#include "pool.h"
 
 /* == Declarations ========================================================= */
 
@@ -42,11 +45,15 @@ struct _wlmtk_resizebar_t {
 
     /** Current width of the resize bar. */
     unsigned                  width;
-    /** Style of the resize bar. */
-    wlmtk_resizebar_style_t   style;
+    /** Style of the resize bar. Interned, see @ref wlmtk_style_intern. */
+    const wlmtk_resizebar_style_t *style_ptr;
 
     /** Background. */
     bs_gfxbuf_t               *gfxbuf_ptr;
+    /** Whether the resize bar is hibernated, ie. has no textures. */
+    bool                      hibernated;
+    /** Buffer pixels per logical pixel. See @ref wlmtk_resizebar_set_scale. */
+    double                    scale;
 
     /** Left element of the resizebar. */
     wlmtk_resizebar_area_t    *left_area_ptr;
@@ -61,6 +68,10 @@ static bool redraw_buffers(wlmtk_resizebar_t *resizebar_ptr, unsigned width);
 
 /* == Data ================================================================= */
 
+/** Pool for resize bars. */
+static wlmtk_pool_t _wlmtk_resizebar_pool = WLMTK_POOL_INITIALIZER(
+    "resizebar", wlmtk_resizebar_t);
+
 /** Virtual method table extension for the resizebar's element superclass. */
 static const wlmtk_element_vmt_t resizebar_element_vmt = {
     .destroy = _wlmtk_resizebar_element_destroy,
@@ -74,10 +85,15 @@ wlmtk_resizebar_t *wlmtk_resizebar_create(
     const wlmtk_resizebar_style_t *style_ptr)
 {
     static const wlmtk_margin_style_t empty_margin_style = {};
-    wlmtk_resizebar_t *resizebar_ptr = logged_calloc(
-        1, sizeof(wlmtk_resizebar_t));
+    wlmtk_resizebar_t *resizebar_ptr = wlmtk_pool_alloc(
+        &_wlmtk_resizebar_pool);
     if (NULL == resizebar_ptr) return NULL;
-    resizebar_ptr->style = *style_ptr;
+    resizebar_ptr->scale = 1.0;
+    resizebar_ptr->style_ptr = WLMTK_STYLE_INTERN(style_ptr);
+    if (NULL == resizebar_ptr->style_ptr) {
+        wlmtk_pool_free(&_wlmtk_resizebar_pool, resizebar_ptr);
+        return NULL;
+    }
 
     if (!wlmtk_box_init(&resizebar_ptr->super_box,
                         WLMTK_BOX_HORIZONTAL,
@@ -149,12 +165,13 @@ void wlmtk_resizebar_destroy(wlmtk_resizebar_t *resizebar_ptr)
     }
 
     if (NULL != resizebar_ptr->gfxbuf_ptr) {
-        bs_gfxbuf_destroy(resizebar_ptr->gfxbuf_ptr);
+        wlmaker_primitives_fill_gfxbuf_release(resizebar_ptr->gfxbuf_ptr);
         resizebar_ptr->gfxbuf_ptr = NULL;
     }
 
     wlmtk_box_fini(&resizebar_ptr->super_box);
-    free(resizebar_ptr);
+    wlmtk_style_release(resizebar_ptr->style_ptr);
+    wlmtk_pool_free(&_wlmtk_resizebar_pool, resizebar_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -163,15 +180,20 @@ bool wlmtk_resizebar_set_width(
     unsigned width)
 {
     if (resizebar_ptr->width == width) return true;
+    if (resizebar_ptr->hibernated) {
+        resizebar_ptr->width = width;
+        return true;
+    }
     if (!redraw_buffers(resizebar_ptr, width)) return false;
     BS_ASSERT(width == resizebar_ptr->width);
-    BS_ASSERT(width == resizebar_ptr->gfxbuf_ptr->width);
+    BS_ASSERT(lround(width * resizebar_ptr->scale) ==
+              (long)resizebar_ptr->gfxbuf_ptr->width);
 
     int right_corner_width = BS_MIN(
-        (int)width, (int)resizebar_ptr->style.corner_width);
+        (int)width, (int)resizebar_ptr->style_ptr->corner_width);
     int left_corner_width = BS_MAX(
         0, BS_MIN((int)width - right_corner_width,
-                  (int)resizebar_ptr->style.corner_width));
+                  (int)resizebar_ptr->style_ptr->corner_width));
     int center_width = BS_MAX(
         0, (int)width - right_corner_width - left_corner_width);
 
@@ -189,21 +211,21 @@ bool wlmtk_resizebar_set_width(
             resizebar_ptr->left_area_ptr,
             resizebar_ptr->gfxbuf_ptr,
             0, left_corner_width,
-            &resizebar_ptr->style)) {
+            resizebar_ptr->style_ptr)) {
         return false;
     }
     if (!wlmtk_resizebar_area_redraw(
             resizebar_ptr->center_area_ptr,
             resizebar_ptr->gfxbuf_ptr,
             left_corner_width, center_width,
-            &resizebar_ptr->style)) {
+            resizebar_ptr->style_ptr)) {
         return false;
     }
     if (!wlmtk_resizebar_area_redraw(
             resizebar_ptr->right_area_ptr,
             resizebar_ptr->gfxbuf_ptr,
             left_corner_width + center_width, right_corner_width,
-            &resizebar_ptr->style)) {
+            resizebar_ptr->style_ptr)) {
         return false;
     }
 
@@ -211,6 +233,77 @@ bool wlmtk_resizebar_set_width(
     return true;
 }
 
+/* ------------------------------------------------------------------------- */
+bool wlmtk_resizebar_set_scale(wlmtk_resizebar_t *resizebar_ptr, double scale)
+{
+    BS_ASSERT(1.0 <= scale);
+    if (resizebar_ptr->scale == scale) return true;
+    resizebar_ptr->scale = scale;
+    wlmtk_resizebar_area_set_scale(resizebar_ptr->left_area_ptr, scale);
+    wlmtk_resizebar_area_set_scale(resizebar_ptr->center_area_ptr, scale);
+    wlmtk_resizebar_area_set_scale(resizebar_ptr->right_area_ptr, scale);
+    if (0 >= resizebar_ptr->width || resizebar_ptr->hibernated) return true;
+
+    // Forces a redraw at the tracked width.
+    unsigned width = resizebar_ptr->width;
+    resizebar_ptr->width = 0;
+    return wlmtk_resizebar_set_width(resizebar_ptr, width);
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_resizebar_hibernate(wlmtk_resizebar_t *resizebar_ptr)
+{
+    if (resizebar_ptr->hibernated) return 0;
+    resizebar_ptr->hibernated = true;
+
+    size_t bytes = wlmtk_resizebar_area_release_buffers(
+        resizebar_ptr->left_area_ptr);
+    bytes += wlmtk_resizebar_area_release_buffers(
+        resizebar_ptr->center_area_ptr);
+    bytes += wlmtk_resizebar_area_release_buffers(
+        resizebar_ptr->right_area_ptr);
+
+    if (NULL != resizebar_ptr->gfxbuf_ptr) {
+        wlmaker_primitives_fill_gfxbuf_release(resizebar_ptr->gfxbuf_ptr);
+        resizebar_ptr->gfxbuf_ptr = NULL;
+    }
+    return bytes;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_resizebar_add_footprint(
+    wlmtk_resizebar_t *resizebar_ptr,
+    wlmtk_memstat_footprint_t *footprint_ptr)
+{
+    wlmtk_memstat_footprint_add_struct(
+        footprint_ptr, sizeof(wlmtk_resizebar_t));
+    if (NULL != resizebar_ptr->gfxbuf_ptr) {
+        wlmtk_memstat_footprint_add_buffer(
+            footprint_ptr,
+            (size_t)resizebar_ptr->gfxbuf_ptr->pixels_per_line *
+            resizebar_ptr->gfxbuf_ptr->height * sizeof(uint32_t),
+            true);
+    }
+    wlmtk_resizebar_area_add_footprint(
+        resizebar_ptr->left_area_ptr, footprint_ptr);
+    wlmtk_resizebar_area_add_footprint(
+        resizebar_ptr->center_area_ptr, footprint_ptr);
+    wlmtk_resizebar_area_add_footprint(
+        resizebar_ptr->right_area_ptr, footprint_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_resizebar_wake(wlmtk_resizebar_t *resizebar_ptr)
+{
+    if (!resizebar_ptr->hibernated) return true;
+    resizebar_ptr->hibernated = false;
+
+    // Forces a redraw at the tracked width.
+    unsigned width = resizebar_ptr->width;
+    resizebar_ptr->width = 0;
+    return wlmtk_resizebar_set_width(resizebar_ptr, width);
+}
+
 /* ------------------------------------------------------------------------- */
 wlmtk_element_t *wlmtk_resizebar_element(wlmtk_resizebar_t *resizebar_ptr)
 {
@@ -230,24 +323,17 @@ void _wlmtk_resizebar_element_destroy(wlmtk_element_t *element_ptr)
 }
 
 /* ------------------------------------------------------------------------- */
-/** Redraws the resizebar's background in appropriate size. */
+/** Redraws the resizebar's background in appropriate size, at the scale. */
 bool redraw_buffers(wlmtk_resizebar_t *resizebar_ptr, unsigned width)
 {
-    cairo_t *cairo_ptr;
-
-    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_create(
-        width, resizebar_ptr->style.height);
+    bs_gfxbuf_t *gfxbuf_ptr = wlmaker_primitives_fill_gfxbuf_acquire(
+        &resizebar_ptr->style_ptr->fill,
+        lround(width * resizebar_ptr->scale),
+        lround(resizebar_ptr->style_ptr->height * resizebar_ptr->scale));
     if (NULL == gfxbuf_ptr) return false;
-    cairo_ptr = cairo_create_from_bs_gfxbuf(gfxbuf_ptr);
-    if (NULL == cairo_ptr) {
-        bs_gfxbuf_destroy(gfxbuf_ptr);
-        return false;
-    }
-    wlmaker_primitives_cairo_fill(cairo_ptr, &resizebar_ptr->style.fill);
-    cairo_destroy(cairo_ptr);
 
     if (NULL != resizebar_ptr->gfxbuf_ptr) {
-        bs_gfxbuf_destroy(resizebar_ptr->gfxbuf_ptr);
+        wlmaker_primitives_fill_gfxbuf_release(resizebar_ptr->gfxbuf_ptr);
     }
     resizebar_ptr->gfxbuf_ptr = gfxbuf_ptr;
     resizebar_ptr->width = width;
@@ -258,10 +344,12 @@ bool redraw_buffers(wlmtk_resizebar_t *resizebar_ptr, unsigned width)
 
 static void test_create_destroy(bs_test_t *test_ptr);
 static void test_variable_width(bs_test_t *test_ptr);
+static void test_scale(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_resizebar_test_cases[] = {
     { 1, "create_destroy", test_create_destroy },
     { 1, "variable_width", test_variable_width },
+    { 1, "scale", test_scale },
     { 0, NULL, NULL }
 };
 
@@ -331,4 +419,44 @@ void test_variable_width(bs_test_t *test_ptr)
     wlmtk_fake_window_destroy(fake_window_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests that scaling redraws at pixel size, and keeps the logical layout. */
+void test_scale(bs_test_t *test_ptr)
+{
+    wlmtk_fake_window_t *fake_window_ptr = wlmtk_fake_window_create();
+    wlmtk_resizebar_style_t style = { .height = 7, .corner_width = 16 };
+    wlmtk_resizebar_t *resizebar_ptr = wlmtk_resizebar_create(
+        fake_window_ptr->window_ptr, &style);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, resizebar_ptr);
+    wlmtk_element_t *center_elem_ptr = wlmtk_resizebar_area_element(
+        resizebar_ptr->center_area_ptr);
+    wlmtk_element_t *right_elem_ptr = wlmtk_resizebar_area_element(
+        resizebar_ptr->right_area_ptr);
+    int width;
+
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_resizebar_set_width(resizebar_ptr, 33));
+    BS_TEST_VERIFY_EQ(test_ptr, 33, resizebar_ptr->gfxbuf_ptr->width);
+
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_resizebar_set_scale(resizebar_ptr, 1.5));
+    BS_TEST_VERIFY_EQ(test_ptr, 50, resizebar_ptr->gfxbuf_ptr->width);
+    BS_TEST_VERIFY_EQ(test_ptr, 11, resizebar_ptr->gfxbuf_ptr->height);
+    BS_TEST_VERIFY_EQ(test_ptr, 16, center_elem_ptr->x);
+    BS_TEST_VERIFY_EQ(test_ptr, 17, right_elem_ptr->x);
+    wlmtk_element_get_dimensions(right_elem_ptr, NULL, NULL, &width, NULL);
+    BS_TEST_VERIFY_EQ(test_ptr, 16, width);
+
+    // Hibernated: Tracks the scale, applies it on wake.
+    wlmtk_resizebar_hibernate(resizebar_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_resizebar_set_scale(resizebar_ptr, 2.0));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, resizebar_ptr->gfxbuf_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_resizebar_wake(resizebar_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 66, resizebar_ptr->gfxbuf_ptr->width);
+
+    wlmtk_element_destroy(wlmtk_resizebar_element(resizebar_ptr));
+    wlmtk_fake_window_destroy(fake_window_ptr);
+}
+
 /* == End of resizebar.c =================================================== */
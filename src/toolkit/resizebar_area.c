@@ -24,6 +24,7 @@
 #include <inttypes.h>
 #include <libbase/libbase.h>
 #include <linux/input-event-codes.h>
+#include <math.h>
 #include <stdlib.h>
 #define WLR_USE_UNSTABLE
 #include <wlr/interfaces/wlr_buffer.h>
@@ -34,6 +35,7 @@
 #include "buffer.h"
 #include "gfxbuf.h"  // IWYU pragma: keep
 #include "input.h"
+#include "pool.h"
 #include "primitives.h"
 #include "window.h"
 
@@ -58,6 +60,8 @@ struct _wlmtk_resizebar_area_t {
     wlmtk_window_t            *window_ptr;
     /** Edges that the resizebar area controls. */
     uint32_t                  edges;
+    /** Scale to draw at. See @ref wlmtk_resizebar_area_set_scale. */
+    double                    scale;
 };
 
 static void _wlmtk_resizebar_area_element_destroy(
@@ -72,10 +76,15 @@ static struct wlr_buffer *create_buffer(
     unsigned position,
     unsigned width,
     const wlmtk_resizebar_style_t *style_ptr,
-    bool pressed);
+    bool pressed,
+    double scale);
 
 /* ========================================================================= */
 
+/** Pool for resize bar areas. */
+static wlmtk_pool_t _wlmtk_resizebar_area_pool = WLMTK_POOL_INITIALIZER(
+    "resizebar_area", wlmtk_resizebar_area_t);
+
 /** Buffer implementation for title of the title bar. */
 static const wlmtk_element_vmt_t resizebar_area_element_vmt = {
     .destroy = _wlmtk_resizebar_area_element_destroy,
@@ -89,12 +98,13 @@ wlmtk_resizebar_area_t *wlmtk_resizebar_area_create(
     wlmtk_window_t *window_ptr,
     uint32_t edges)
 {
-    wlmtk_resizebar_area_t *resizebar_area_ptr = logged_calloc(
-        1, sizeof(wlmtk_resizebar_area_t));
+    wlmtk_resizebar_area_t *resizebar_area_ptr = wlmtk_pool_alloc(
+        &_wlmtk_resizebar_area_pool);
     if (NULL == resizebar_area_ptr) return NULL;
     BS_ASSERT(NULL != window_ptr);
     resizebar_area_ptr->window_ptr = window_ptr;
     resizebar_area_ptr->edges = edges;
+    resizebar_area_ptr->scale = 1.0;
 
     wlmtk_pointer_cursor_t cursor = WLMTK_POINTER_CURSOR_DEFAULT;
     switch (resizebar_area_ptr->edges) {
@@ -134,7 +144,7 @@ void wlmtk_resizebar_area_destroy(
         &resizebar_area_ptr->pressed_wlr_buffer_ptr);
 
     wlmtk_buffer_fini(&resizebar_area_ptr->super_buffer);
-    free(resizebar_area_ptr);
+    wlmtk_pool_free(&_wlmtk_resizebar_area_pool, resizebar_area_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -145,10 +155,18 @@ bool wlmtk_resizebar_area_redraw(
     unsigned width,
     const wlmtk_resizebar_style_t *style_ptr)
 {
+    // The background is in buffer pixels, at the scale. Rounding the width
+    // keeps the logical width: Shifts the position, as for the title.
+    double scale = resizebar_area_ptr->scale;
+    width = lround(width * scale);
+    position = BS_MIN(lround(position * scale),
+                      BS_MAX(0, (int)gfxbuf_ptr->width - (int)width));
+    BS_ASSERT(position + width <= gfxbuf_ptr->width);
+
     struct wlr_buffer *released_wlr_buffer_ptr = create_buffer(
-        gfxbuf_ptr, position, width, style_ptr, false);
+        gfxbuf_ptr, position, width, style_ptr, false, scale);
     struct wlr_buffer *pressed_wlr_buffer_ptr = create_buffer(
-        gfxbuf_ptr, position, width, style_ptr, true);
+        gfxbuf_ptr, position, width, style_ptr, true, scale);
 
     if (NULL == released_wlr_buffer_ptr ||
         NULL == pressed_wlr_buffer_ptr) {
@@ -168,6 +186,50 @@ bool wlmtk_resizebar_area_redraw(
     return true;
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_resizebar_area_set_scale(
+    wlmtk_resizebar_area_t *resizebar_area_ptr,
+    double scale)
+{
+    BS_ASSERT(0 < scale);
+    resizebar_area_ptr->scale = scale;
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_resizebar_area_release_buffers(
+    wlmtk_resizebar_area_t *resizebar_area_ptr)
+{
+    size_t bytes =
+        wlmtk_gfxbuf_wlr_buffer_bytes(
+            resizebar_area_ptr->released_wlr_buffer_ptr) +
+        wlmtk_gfxbuf_wlr_buffer_bytes(
+            resizebar_area_ptr->pressed_wlr_buffer_ptr);
+
+    wlmtk_buffer_set(&resizebar_area_ptr->super_buffer, NULL);
+    wlr_buffer_drop_nullify(&resizebar_area_ptr->released_wlr_buffer_ptr);
+    wlr_buffer_drop_nullify(&resizebar_area_ptr->pressed_wlr_buffer_ptr);
+    return bytes;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_resizebar_area_add_footprint(
+    wlmtk_resizebar_area_t *resizebar_area_ptr,
+    wlmtk_memstat_footprint_t *footprint_ptr)
+{
+    wlmtk_memstat_footprint_add_struct(
+        footprint_ptr, sizeof(wlmtk_resizebar_area_t));
+    wlmtk_memstat_footprint_add_buffer(
+        footprint_ptr,
+        wlmtk_gfxbuf_wlr_buffer_bytes(
+            resizebar_area_ptr->released_wlr_buffer_ptr),
+        false);
+    wlmtk_memstat_footprint_add_buffer(
+        footprint_ptr,
+        wlmtk_gfxbuf_wlr_buffer_bytes(
+            resizebar_area_ptr->pressed_wlr_buffer_ptr),
+        false);
+}
+
 /* ------------------------------------------------------------------------- */
 wlmtk_element_t *wlmtk_resizebar_area_element(
     wlmtk_resizebar_area_t *resizebar_area_ptr)
@@ -228,13 +290,15 @@ bool _wlmtk_resizebar_area_element_pointer_button(
 void draw_state(wlmtk_resizebar_area_t *resizebar_area_ptr)
 {
     if (!resizebar_area_ptr->pressed) {
-        wlmtk_buffer_set(
+        wlmtk_buffer_set_scaled(
             &resizebar_area_ptr->super_buffer,
-            resizebar_area_ptr->released_wlr_buffer_ptr);
+            resizebar_area_ptr->released_wlr_buffer_ptr,
+            resizebar_area_ptr->scale);
     } else {
-        wlmtk_buffer_set(
+        wlmtk_buffer_set_scaled(
             &resizebar_area_ptr->super_buffer,
-            resizebar_area_ptr->pressed_wlr_buffer_ptr);
+            resizebar_area_ptr->pressed_wlr_buffer_ptr,
+            resizebar_area_ptr->scale);
     }
 }
 
@@ -242,11 +306,12 @@ void draw_state(wlmtk_resizebar_area_t *resizebar_area_ptr)
 /**
  * Creates a resizebar area texture.
  *
- * @param gfxbuf_ptr
- * @param position
- * @param width
+ * @param gfxbuf_ptr          Background, in buffer pixels.
+ * @param position            In buffer pixels.
+ * @param width               In buffer pixels.
  * @param style_ptr
  * @param pressed
+ * @param scale               Buffer pixels per logical pixel.
  *
  * @return A pointer to a newly allocated `struct wlr_buffer`.
  */
@@ -255,25 +320,26 @@ struct wlr_buffer *create_buffer(
     unsigned position,
     unsigned width,
     const wlmtk_resizebar_style_t *style_ptr,
-    bool pressed)
+    bool pressed,
+    double scale)
 {
-    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
-        width, style_ptr->height);
+    unsigned height = gfxbuf_ptr->height;
+    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer_uncleared(
+        width, height);
     if (NULL == wlr_buffer_ptr) return NULL;
+    wlmtk_gfxbuf_set_memstat_subsystem(
+        wlr_buffer_ptr, WLMTK_MEMSTAT_DECORATIONS);
 
     bs_gfxbuf_copy_area(
         bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr), 0, 0,
-        gfxbuf_ptr, position, 0, width, style_ptr->height);
+        gfxbuf_ptr, position, 0, width, height);
 
-    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
-    if (NULL == cairo_ptr) {
+    if (!wlmaker_primitives_gfxbuf_draw_bezel_at(
+            bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr), 0, 0, width,
+            height, style_ptr->bezel_width * scale, !pressed)) {
         wlr_buffer_drop(wlr_buffer_ptr);
-        return false;
+        return NULL;
     }
-    wlmaker_primitives_draw_bezel_at(
-        cairo_ptr, 0, 0, width,
-        style_ptr->height, style_ptr->bezel_width, !pressed);
-    cairo_destroy(cairo_ptr);
 
     return wlr_buffer_ptr;
 }
@@ -281,9 +347,11 @@ struct wlr_buffer *create_buffer(
 /* == Unit tests =========================================================== */
 
 static void test_area(bs_test_t *test_ptr);
+static void test_scale(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_resizebar_area_test_cases[] = {
     { 1, "area", test_area },
+    { 1, "scale", test_scale },
     { 0, NULL, NULL }
 };
 
@@ -340,4 +408,36 @@ void test_area(bs_test_t *test_ptr)
     wlmtk_fake_window_destroy(fake_window_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests that the area draws in buffer pixels, at the logical size. */
+void test_scale(bs_test_t *test_ptr)
+{
+    wlmtk_fake_window_t *fake_window_ptr = wlmtk_fake_window_create();
+    wlmtk_resizebar_area_t *area_ptr = wlmtk_resizebar_area_create(
+        fake_window_ptr->window_ptr, WLR_EDGE_BOTTOM);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, area_ptr);
+    wlmtk_element_t *element_ptr = wlmtk_resizebar_area_element(area_ptr);
+
+    wlmtk_resizebar_style_t style = { .height = 7, .bezel_width = 1.0 };
+    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_create(45, 11);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, gfxbuf_ptr);
+    wlmtk_resizebar_area_set_scale(area_ptr, 1.5);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_resizebar_area_redraw(area_ptr, gfxbuf_ptr, 10, 13, &style));
+    bs_gfxbuf_destroy(gfxbuf_ptr);
+
+    struct wlr_buffer *wlr_buffer_ptr =
+        area_ptr->super_buffer.wlr_buffer_ptr;
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 20, wlr_buffer_ptr->width);
+    BS_TEST_VERIFY_EQ(test_ptr, 11, wlr_buffer_ptr->height);
+    struct wlr_box box = wlmtk_element_get_dimensions_box(element_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 13, box.width);
+    BS_TEST_VERIFY_EQ(test_ptr, 7, box.height);
+
+    wlmtk_element_destroy(element_ptr);
+    wlmtk_fake_window_destroy(fake_window_ptr);
+}
+
 /* == End of resizebar_area.c ============================================== */
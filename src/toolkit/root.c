@@ -21,7 +21,9 @@
 #include "root.h"
 
 #include <libbase/libbase.h>
+#include <math.h>
 #include <stdlib.h>
+#include <string.h>
 #include <wayland-server-protocol.h>
 #define WLR_USE_UNSTABLE
 #include <wlr/types/wlr_output_layout.h>
@@ -30,17 +32,59 @@
 #undef WLR_USE_UNSTABLE
 #include <xkbcommon/xkbcommon.h>
 
+#include "animation.h"
+#include "cache.h"
 #include "container.h"
 #include "input.h"
+#include "latency.h"
+#include "layout_epoch.h"
 #include "rectangle.h"
+#include "test.h"  // IWYU pragma: keep
 #include "tile.h"
 #include "util.h"
+#include "window.h"
 #include "workspace.h"
 
 struct wlr_keyboard_key_event;
 
 /* == Declarations ========================================================= */
 
+/** Per-output workspaces: The workspace shown on an output. */
+typedef struct {
+    /** The output. */
+    struct wlr_output         *wlr_output_ptr;
+    /** The workspace shown on it. May be NULL, if there are none. */
+    wlmtk_workspace_t         *workspace_ptr;
+} wlmtk_root_output_t;
+
+/** State of a workspace swipe. See @ref wlmtk_root_swipe_begin. */
+typedef struct {
+    /** Whether a swipe is in progress. */
+    bool                      active;
+    /** Set while the swipe commits: The former workspace slides out. */
+    bool                      settling;
+    /** Horizontal motion since the swipe began. */
+    double                    offset;
+    /** Velocity of the motion, in pixels per millisecond. Smoothed. */
+    double                    velocity;
+    /** Time of the most recent update. */
+    uint32_t                  time_msec;
+    /** The workspace sliding in. NULL if there is none. */
+    wlmtk_workspace_t         *neighbour_ptr;
+    /** 1 if the neighbour is the next workspace, -1 for the previous. */
+    int                       direction;
+} wlmtk_root_swipe_t;
+
+/** The mapped windows of one client. See @ref wlmtk_root_get_window_group. */
+struct _wlmtk_window_group_t {
+    /** Node of @ref wlmtk_root_t::window_groups_ptr. */
+    bs_avltree_node_t         avlnode;
+    /** Process ID of the client. Also the tree lookup key. */
+    pid_t                     pid;
+    /** The windows. Connects @ref wlmtk_group_dlnode_from_window. */
+    bs_dllist_t               windows;
+};
+
 /** State of the root element. */
 struct _wlmtk_root_t {
     /** The root's container: Holds workspaces and the curtain. */
@@ -55,6 +99,8 @@ struct _wlmtk_root_t {
 
     /** Whether the root is currently locked. */
     bool                      locked;
+    /** Whether the curtain is drawn ahead of locking. */
+    bool                      prelocked;
     /**
      * The lock's element. Shown on top of
      * @ref wlmtk_root_t::curtain_rectangle_ptr.
@@ -66,10 +112,46 @@ struct _wlmtk_root_t {
 
     /** List of workspaces attached to root. @see wlmtk_workspace_t::dlnode. */
     bs_dllist_t               workspaces;
+    /**
+     * Workspaces by position, in order of @ref wlmtk_root_t::workspaces.
+     * The workspace's index (see @ref wlmtk_workspace_get_details) is its
+     * position + 1.
+     */
+    wlmtk_workspace_t         **workspace_ptrs;
+    /** Number of elements in use at `workspace_ptrs`. */
+    size_t                    workspaces_size;
+    /** Allocated number of elements at `workspace_ptrs`. */
+    size_t                    workspaces_capacity;
     /** Currently-active workspace. */
     wlmtk_workspace_t         *current_workspace_ptr;
+    /** Whether to hibernate workspaces other than the current one. */
+    bool                      hibernate_inactive_workspaces;
+    /** Idle source for waking @ref wlmtk_root_t::prewarm_workspace_ptrs. */
+    struct wl_event_source    *prewarm_idle_ptr;
+    /** Workspaces to pre-warm. Typically the next and previous ones. */
+    wlmtk_workspace_t         *prewarm_workspace_ptrs[2];
+    /** Registers awake workspaces that are not shown, for eviction. */
+    wlmtk_cache_t             cache;
+
+    /**
+     * Whether each output shows a workspace of its own. The current
+     * workspace is then the one of @ref wlmtk_root_t::active_wlr_output_ptr.
+     */
+    bool                      per_output_workspaces;
+    /** Per-output workspaces: The workspace of each output in the layout. */
+    wlmtk_root_output_t       *outputs;
+    /** Number of elements at `outputs`. */
+    size_t                    outputs_size;
+    /** Per-output workspaces: The output that has the pointer. */
+    struct wlr_output         *active_wlr_output_ptr;
+
+    /** The workspace swipe, if any. */
+    wlmtk_root_swipe_t        swipe;
 
-    /** Listener for wlr_output_layout::events.change. */
+    /** Mapped windows, grouped by client. Holds @ref wlmtk_window_group_t. */
+    bs_avltree_t              *window_groups_ptr;
+
+    /** Listener for layout epochs, see @ref wlmtk_layout_epoch_connect. */
     struct wl_listener        output_layout_change_listener;
 
     // Elements below not owned by wlmtk_root_t.
@@ -80,12 +162,39 @@ struct _wlmtk_root_t {
 static void _wlmtk_root_switch_to_workspace(
     wlmtk_root_t *root_ptr,
     wlmtk_workspace_t *workspace_ptr);
-static void _wlmtk_root_enumerate_workspaces(
-    bs_dllist_node_t *dlnode_ptr,
-    void *ud_ptr);
+static size_t _wlmtk_root_workspace_position(
+    wlmtk_root_t *root_ptr,
+    wlmtk_workspace_t *workspace_ptr);
 static void _wlmtk_root_destroy_workspace(
     bs_dllist_node_t *dlnode_ptr,
     void *ud_ptr);
+static size_t _wlmtk_root_hibernate_workspace(
+    wlmtk_workspace_t *workspace_ptr);
+static size_t _wlmtk_root_evict(unsigned percent, void *ud_ptr);
+static void _wlmtk_root_capture_thumbnails(wlmtk_workspace_t *workspace_ptr);
+static void _wlmtk_root_cancel_prewarm(wlmtk_root_t *root_ptr);
+static void _wlmtk_root_set_covered(wlmtk_root_t *root_ptr, bool covered);
+static void _wlmtk_root_handle_prewarm_idle(void *data_ptr);
+static wlmtk_root_output_t *_wlmtk_root_find_output(
+    wlmtk_root_t *root_ptr,
+    struct wlr_output *wlr_output_ptr);
+static bool _wlmtk_root_workspace_shown(
+    wlmtk_root_t *root_ptr,
+    wlmtk_workspace_t *workspace_ptr);
+static void _wlmtk_root_update_outputs(wlmtk_root_t *root_ptr);
+static void _wlmtk_root_show_workspaces(wlmtk_root_t *root_ptr);
+static void _wlmtk_root_activate_output(
+    wlmtk_root_t *root_ptr,
+    struct wlr_output *wlr_output_ptr);
+static void _wlmtk_root_swipe_reset(wlmtk_root_t *root_ptr);
+static void _wlmtk_root_swipe_hide_neighbour(wlmtk_root_t *root_ptr);
+static void _wlmtk_root_swipe_place(
+    wlmtk_workspace_t *workspace_ptr,
+    int offset);
+static int _wlmtk_window_group_cmp(
+    const bs_avltree_node_t *avlnode_ptr,
+    const void *key_ptr);
+static void _wlmtk_window_group_destroy(bs_avltree_node_t *avlnode_ptr);
 
 static bool _wlmtk_root_element_pointer_motion(
     wlmtk_element_t *element_ptr,
@@ -115,6 +224,13 @@ static const wlmtk_element_vmt_t _wlmtk_root_element_vmt = {
     .keyboard_event = _wlmtk_root_element_keyboard_event,
 };
 
+/** Duration of the cross-fade when switching workspaces. */
+static const uint64_t _wlmtk_root_switch_msec = 200;
+/** How far ahead a swipe's motion is projected, to tell whether to switch. */
+static const double _wlmtk_root_swipe_project_msec = 150;
+/** A swipe ending without motion for that long has no velocity. */
+static const uint32_t _wlmtk_root_swipe_stale_msec = 50;
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -140,6 +256,12 @@ wlmtk_root_t *wlmtk_root_create(
         }
     }
     wlmtk_element_set_visible(&root_ptr->container.super_element, true);
+    root_ptr->window_groups_ptr = bs_avltree_create(
+        _wlmtk_window_group_cmp, _wlmtk_window_group_destroy);
+    if (NULL == root_ptr->window_groups_ptr) {
+        wlmtk_root_destroy(root_ptr);
+        return NULL;
+    }
     root_ptr->orig_super_element_vmt = wlmtk_element_extend(
         &root_ptr->container.super_element,
         &_wlmtk_root_element_vmt);
@@ -154,8 +276,9 @@ wlmtk_root_t *wlmtk_root_create(
         &root_ptr->container,
         wlmtk_rectangle_element(root_ptr->curtain_rectangle_ptr));
 
-    wlmtk_util_connect_listener_signal(
-        &wlr_output_layout_ptr->events.change,
+    wlmtk_layout_epoch_connect(
+        wlr_output_layout_ptr,
+        WLMTK_LAYOUT_EPOCH_STAGE_OUTPUTS,
         &root_ptr->output_layout_change_listener,
         _wlmtk_root_handle_output_layout_change);
     _wlmtk_root_handle_output_layout_change(
@@ -167,15 +290,28 @@ wlmtk_root_t *wlmtk_root_create(
     wl_signal_init(&root_ptr->events.window_mapped);
     wl_signal_init(&root_ptr->events.window_unmapped);
     wl_signal_init(&root_ptr->events.unclaimed_button_event);
+
+    root_ptr->cache = (wlmtk_cache_t){
+        .name_ptr = "workspaces",
+        .evict = _wlmtk_root_evict,
+        .userdata_ptr = root_ptr
+    };
+    wlmtk_cache_register(&root_ptr->cache);
     return root_ptr;
 }
 
 /* ------------------------------------------------------------------------- */
 void wlmtk_root_destroy(wlmtk_root_t *root_ptr)
 {
+    wlmtk_cache_unregister(&root_ptr->cache);
     wlmtk_util_disconnect_listener(
         &root_ptr->output_layout_change_listener);
+    _wlmtk_root_cancel_prewarm(root_ptr);
 
+    if (NULL != root_ptr->window_groups_ptr) {
+        bs_avltree_destroy(root_ptr->window_groups_ptr);
+        root_ptr->window_groups_ptr = NULL;
+    }
     bs_dllist_for_each(
         &root_ptr->workspaces,
         _wlmtk_root_destroy_workspace,
@@ -192,6 +328,14 @@ void wlmtk_root_destroy(wlmtk_root_t *root_ptr)
 
     wlmtk_container_fini(&root_ptr->container);
 
+    if (NULL != root_ptr->outputs) {
+        free(root_ptr->outputs);
+        root_ptr->outputs = NULL;
+    }
+    if (NULL != root_ptr->workspace_ptrs) {
+        free(root_ptr->workspace_ptrs);
+        root_ptr->workspace_ptrs = NULL;
+    }
     free(root_ptr);
 }
 
@@ -226,6 +370,8 @@ bool wlmtk_root_pointer_button(
     wlmtk_button_event_t event;
     bool rv;
 
+    wlmtk_latency_input(event_ptr->time_msec);
+
     // Guard clause: nothing to pass on if no element has the focus.
     event.button = event_ptr->button;
     event.time_msec = event_ptr->time_msec;
@@ -271,18 +417,34 @@ bool wlmtk_root_pointer_axis(
     wlmtk_root_t *root_ptr,
     struct wlr_pointer_axis_event *wlr_pointer_axis_event_ptr)
 {
+    wlmtk_latency_input(wlr_pointer_axis_event_ptr->time_msec);
     return wlmtk_element_pointer_axis(
         &root_ptr->container.super_element,
         wlr_pointer_axis_event_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
-void wlmtk_root_add_workspace(
+bool wlmtk_root_add_workspace(
     wlmtk_root_t *root_ptr,
     wlmtk_workspace_t *workspace_ptr)
 {
     BS_ASSERT(NULL == wlmtk_workspace_get_root(workspace_ptr));
 
+    if (root_ptr->workspaces_size >= root_ptr->workspaces_capacity) {
+        size_t capacity = BS_MAX(8U, 2 * root_ptr->workspaces_capacity);
+        wlmtk_workspace_t **workspace_ptrs = logged_calloc(
+            capacity, sizeof(wlmtk_workspace_t*));
+        if (NULL == workspace_ptrs) return false;
+        if (NULL != root_ptr->workspace_ptrs) {
+            memcpy(workspace_ptrs, root_ptr->workspace_ptrs,
+                   root_ptr->workspaces_size * sizeof(wlmtk_workspace_t*));
+            free(root_ptr->workspace_ptrs);
+        }
+        root_ptr->workspace_ptrs = workspace_ptrs;
+        root_ptr->workspaces_capacity = capacity;
+    }
+    root_ptr->workspace_ptrs[root_ptr->workspaces_size++] = workspace_ptr;
+
     wlmtk_container_add_element(
         &root_ptr->container,
         wlmtk_workspace_element(workspace_ptr));
@@ -295,13 +457,20 @@ void wlmtk_root_add_workspace(
     bs_dllist_push_back(
         &root_ptr->workspaces,
         wlmtk_dlnode_from_workspace(workspace_ptr));
-    wlmtk_workspace_set_details(
-        workspace_ptr, bs_dllist_size(&root_ptr->workspaces));
+    wlmtk_workspace_set_details(workspace_ptr, root_ptr->workspaces_size);
     wlmtk_workspace_set_root(workspace_ptr, root_ptr);
 
     if (NULL == root_ptr->current_workspace_ptr) {
         _wlmtk_root_switch_to_workspace(root_ptr, workspace_ptr);
+    } else if (root_ptr->per_output_workspaces) {
+        // May fill an output that had no workspace of its own.
+        _wlmtk_root_update_outputs(root_ptr);
+    }
+    if (!_wlmtk_root_workspace_shown(root_ptr, workspace_ptr) &&
+        root_ptr->hibernate_inactive_workspaces) {
+        _wlmtk_root_hibernate_workspace(workspace_ptr);
     }
+    return true;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -310,27 +479,71 @@ void wlmtk_root_remove_workspace(
     wlmtk_workspace_t *workspace_ptr)
 {
     BS_ASSERT(root_ptr == wlmtk_workspace_get_root(workspace_ptr));
+    if (root_ptr->swipe.neighbour_ptr == workspace_ptr ||
+        root_ptr->current_workspace_ptr == workspace_ptr) {
+        _wlmtk_root_swipe_reset(root_ptr);
+    }
+    wlmtk_animation_cancel(wlmtk_workspace_element(workspace_ptr));
+    size_t position = _wlmtk_root_workspace_position(root_ptr, workspace_ptr);
     wlmtk_workspace_set_root(workspace_ptr, NULL);
+    for (size_t i = 0; i < 2; ++i) {
+        if (root_ptr->prewarm_workspace_ptrs[i] == workspace_ptr) {
+            root_ptr->prewarm_workspace_ptrs[i] = NULL;
+        }
+    }
     bs_dllist_remove(
         &root_ptr->workspaces,
         wlmtk_dlnode_from_workspace(workspace_ptr));
+    // Only the workspaces after the removed one need renumbering.
+    root_ptr->workspaces_size--;
+    for (size_t i = position; i < root_ptr->workspaces_size; ++i) {
+        root_ptr->workspace_ptrs[i] = root_ptr->workspace_ptrs[i + 1];
+        wlmtk_workspace_set_details(root_ptr->workspace_ptrs[i], i + 1);
+    }
     wlmtk_container_remove_element(
         &root_ptr->container,
         wlmtk_workspace_element(workspace_ptr));
     wlmtk_element_set_visible(
         wlmtk_workspace_element(workspace_ptr), false);
 
+    for (size_t i = 0; i < root_ptr->outputs_size; ++i) {
+        if (root_ptr->outputs[i].workspace_ptr == workspace_ptr) {
+            root_ptr->outputs[i].workspace_ptr = NULL;
+        }
+    }
     if (root_ptr->current_workspace_ptr == workspace_ptr) {
         _wlmtk_root_switch_to_workspace(
             root_ptr,
-            wlmtk_workspace_from_dlnode(root_ptr->workspaces.head_ptr));
+            wlmtk_root_get_workspace(root_ptr, 0));
     }
+    if (root_ptr->per_output_workspaces) _wlmtk_root_update_outputs(root_ptr);
+}
 
-    int index = 0;
-    bs_dllist_for_each(
-        &root_ptr->workspaces,
-        _wlmtk_root_enumerate_workspaces,
-        &index);
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_root_get_workspaces_size(wlmtk_root_t *root_ptr)
+{
+    return root_ptr->workspaces_size;
+}
+
+/* ------------------------------------------------------------------------- */
+wlmtk_workspace_t *wlmtk_root_get_workspace(
+    wlmtk_root_t *root_ptr,
+    size_t position)
+{
+    if (position >= root_ptr->workspaces_size) return NULL;
+    return root_ptr->workspace_ptrs[position];
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_root_switch_to_workspace(
+    wlmtk_root_t *root_ptr,
+    size_t position)
+{
+    wlmtk_workspace_t *workspace_ptr = wlmtk_root_get_workspace(
+        root_ptr, position);
+    if (NULL == workspace_ptr ||
+        root_ptr->current_workspace_ptr == workspace_ptr) return;
+    _wlmtk_root_switch_to_workspace(root_ptr, workspace_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -340,36 +553,297 @@ wlmtk_workspace_t *wlmtk_root_get_current_workspace(wlmtk_root_t *root_ptr)
 }
 
 /* ------------------------------------------------------------------------- */
-void wlmtk_root_switch_to_next_workspace(wlmtk_root_t *root_ptr)
+void wlmtk_root_set_hibernate_inactive_workspaces(
+    wlmtk_root_t *root_ptr,
+    bool hibernate)
 {
-    if (NULL == root_ptr->current_workspace_ptr) return;
+    if (root_ptr->hibernate_inactive_workspaces == hibernate) return;
+    root_ptr->hibernate_inactive_workspaces = hibernate;
+
+    for (bs_dllist_node_t *dlnode_ptr = root_ptr->workspaces.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_workspace_t *workspace_ptr = wlmtk_workspace_from_dlnode(
+            dlnode_ptr);
+        if (!hibernate) {
+            wlmtk_workspace_wake(workspace_ptr);
+        } else if (!_wlmtk_root_workspace_shown(root_ptr, workspace_ptr)) {
+            _wlmtk_root_hibernate_workspace(workspace_ptr);
+        }
+    }
+}
 
-    bs_dllist_node_t *dlnode_ptr = wlmtk_dlnode_from_workspace(
-        root_ptr->current_workspace_ptr);
-    if (NULL == dlnode_ptr->next_ptr) {
-        dlnode_ptr = root_ptr->workspaces.head_ptr;
-    } else {
-        dlnode_ptr = dlnode_ptr->next_ptr;
+/* ------------------------------------------------------------------------- */
+void wlmtk_root_set_per_output_workspaces(
+    wlmtk_root_t *root_ptr,
+    bool per_output)
+{
+    if (root_ptr->per_output_workspaces == per_output) return;
+    root_ptr->per_output_workspaces = per_output;
+
+    if (per_output) {
+        _wlmtk_root_update_outputs(root_ptr);
+        return;
     }
-    wlmtk_workspace_t *workspace_ptr = wlmtk_workspace_from_dlnode(dlnode_ptr);
 
-    _wlmtk_root_switch_to_workspace(root_ptr, workspace_ptr);
+    // Back to a single workspace: Only the current one remains shown.
+    if (NULL != root_ptr->outputs) {
+        free(root_ptr->outputs);
+        root_ptr->outputs = NULL;
+    }
+    root_ptr->outputs_size = 0;
+    root_ptr->active_wlr_output_ptr = NULL;
+    _wlmtk_root_show_workspaces(root_ptr);
+    for (size_t i = 0; i < root_ptr->workspaces_size; ++i) {
+        wlmtk_workspace_update_occlusion(root_ptr->workspace_ptrs[i]);
+        if (root_ptr->hibernate_inactive_workspaces &&
+            root_ptr->workspace_ptrs[i] != root_ptr->current_workspace_ptr) {
+            _wlmtk_root_hibernate_workspace(root_ptr->workspace_ptrs[i]);
+        }
+    }
 }
 
 /* ------------------------------------------------------------------------- */
-void wlmtk_root_switch_to_previous_workspace(wlmtk_root_t *root_ptr)
+bool wlmtk_root_per_output_workspaces(wlmtk_root_t *root_ptr)
 {
-    if (NULL == root_ptr->current_workspace_ptr) return;
-    bs_dllist_node_t *dlnode_ptr = wlmtk_dlnode_from_workspace(
-        root_ptr->current_workspace_ptr);
-    if (NULL == dlnode_ptr->prev_ptr) {
-        dlnode_ptr = root_ptr->workspaces.tail_ptr;
+    return root_ptr->per_output_workspaces;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_root_workspace_shown_on_output(
+    wlmtk_root_t *root_ptr,
+    wlmtk_workspace_t *workspace_ptr,
+    struct wlr_output *wlr_output_ptr)
+{
+    if (!root_ptr->per_output_workspaces) return true;
+    wlmtk_root_output_t *output_ptr = _wlmtk_root_find_output(
+        root_ptr, wlr_output_ptr);
+    return NULL != output_ptr && output_ptr->workspace_ptr == workspace_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_root_update_occlusion(wlmtk_root_t *root_ptr)
+{
+    if (!root_ptr->per_output_workspaces) {
+        if (NULL == root_ptr->current_workspace_ptr) return 0;
+        return wlmtk_workspace_update_occlusion(
+            root_ptr->current_workspace_ptr);
+    }
+
+    size_t occluded = 0;
+    for (size_t i = 0; i < root_ptr->workspaces_size; ++i) {
+        wlmtk_workspace_t *workspace_ptr = root_ptr->workspace_ptrs[i];
+        if (!_wlmtk_root_workspace_shown(root_ptr, workspace_ptr)) continue;
+        occluded += wlmtk_workspace_update_occlusion(workspace_ptr);
+    }
+    return occluded;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_root_prewarm_workspace(
+    wlmtk_root_t *root_ptr,
+    wlmtk_workspace_t *workspace_ptr,
+    struct wl_event_loop *wl_event_loop_ptr)
+{
+    if (!root_ptr->hibernate_inactive_workspaces ||
+        NULL == workspace_ptr ||
+        root_ptr->current_workspace_ptr == workspace_ptr ||
+        !wlmtk_workspace_hibernated(workspace_ptr)) return;
+
+    if (NULL == wl_event_loop_ptr) {
+        wlmtk_workspace_wake(workspace_ptr);
+        return;
+    }
+
+    if (root_ptr->prewarm_workspace_ptrs[0] != workspace_ptr &&
+        root_ptr->prewarm_workspace_ptrs[1] != workspace_ptr) {
+        // Keeps the most recent request, replacing the older one.
+        root_ptr->prewarm_workspace_ptrs[1] =
+            root_ptr->prewarm_workspace_ptrs[0];
+        root_ptr->prewarm_workspace_ptrs[0] = workspace_ptr;
+    }
+    if (NULL == root_ptr->prewarm_idle_ptr) {
+        root_ptr->prewarm_idle_ptr = wl_event_loop_add_idle(
+            wl_event_loop_ptr, _wlmtk_root_handle_prewarm_idle, root_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+wlmtk_workspace_t *wlmtk_root_get_next_workspace(wlmtk_root_t *root_ptr)
+{
+    if (NULL == root_ptr->current_workspace_ptr) return NULL;
+
+    size_t position = _wlmtk_root_workspace_position(
+        root_ptr, root_ptr->current_workspace_ptr);
+    return root_ptr->workspace_ptrs[
+        (position + 1) % root_ptr->workspaces_size];
+}
+
+/* ------------------------------------------------------------------------- */
+wlmtk_workspace_t *wlmtk_root_get_previous_workspace(wlmtk_root_t *root_ptr)
+{
+    if (NULL == root_ptr->current_workspace_ptr) return NULL;
+
+    size_t position = _wlmtk_root_workspace_position(
+        root_ptr, root_ptr->current_workspace_ptr);
+    return root_ptr->workspace_ptrs[
+        (position + root_ptr->workspaces_size - 1) %
+        root_ptr->workspaces_size];
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_root_swipe_begin(wlmtk_root_t *root_ptr, uint32_t time_msec)
+{
+    _wlmtk_root_swipe_reset(root_ptr);
+    if (root_ptr->locked || root_ptr->prelocked ||
+        NULL == root_ptr->current_workspace_ptr ||
+        0 >= root_ptr->extents.width) return;
+
+    // Catches the workspace, if it is still sliding from a former swipe.
+    wlmtk_animation_cancel(
+        wlmtk_workspace_element(root_ptr->current_workspace_ptr));
+    root_ptr->swipe = (wlmtk_root_swipe_t){
+        .active = true,
+        .time_msec = time_msec
+    };
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_root_swipe_update(
+    wlmtk_root_t *root_ptr,
+    double dx,
+    uint32_t time_msec)
+{
+    wlmtk_root_swipe_t *swipe_ptr = &root_ptr->swipe;
+    if (!swipe_ptr->active || root_ptr->locked || root_ptr->prelocked) return;
+
+    if (time_msec > swipe_ptr->time_msec) {
+        double velocity = dx / (double)(time_msec - swipe_ptr->time_msec);
+        swipe_ptr->velocity = 0.5 * (swipe_ptr->velocity + velocity);
+    }
+    swipe_ptr->time_msec = time_msec;
+    double width = root_ptr->extents.width;
+    swipe_ptr->offset = BS_MAX(-width, BS_MIN(width, swipe_ptr->offset + dx));
+    // Per-output workspaces do not slide: They get switched at the end.
+    if (root_ptr->per_output_workspaces) return;
+
+    // Moving left reveals the next workspace, from the right.
+    int direction = 0 > swipe_ptr->offset ? 1 : -1;
+    if (direction != swipe_ptr->direction) {
+        _wlmtk_root_swipe_hide_neighbour(root_ptr);
+        swipe_ptr->direction = direction;
+        wlmtk_workspace_t *workspace_ptr = 0 < direction ?
+            wlmtk_root_get_next_workspace(root_ptr) :
+            wlmtk_root_get_previous_workspace(root_ptr);
+        if (workspace_ptr != root_ptr->current_workspace_ptr) {
+            swipe_ptr->neighbour_ptr = workspace_ptr;
+            wlmtk_animation_cancel(wlmtk_workspace_element(workspace_ptr));
+            wlmtk_root_prewarm_workspace(root_ptr, workspace_ptr, NULL);
+            wlmtk_element_set_visible(
+                wlmtk_workspace_element(workspace_ptr), true);
+        }
+    }
+
+    // Only the scene nodes move. The windows keep their positions.
+    int offset = (int)swipe_ptr->offset;
+    _wlmtk_root_swipe_place(root_ptr->current_workspace_ptr, offset);
+    if (NULL != swipe_ptr->neighbour_ptr) {
+        _wlmtk_root_swipe_place(
+            swipe_ptr->neighbour_ptr,
+            offset + direction * root_ptr->extents.width);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_root_swipe_end(
+    wlmtk_root_t *root_ptr,
+    uint32_t time_msec,
+    bool cancelled)
+{
+    wlmtk_root_swipe_t *swipe_ptr = &root_ptr->swipe;
+    if (!swipe_ptr->active) return;
+    if (root_ptr->locked || root_ptr->prelocked) {
+        _wlmtk_root_swipe_reset(root_ptr);
+        return;
+    }
+
+    if (time_msec > swipe_ptr->time_msec + _wlmtk_root_swipe_stale_msec) {
+        swipe_ptr->velocity = 0;
+    }
+    // Projects the motion ahead: A quick flick switches, too.
+    int width = root_ptr->extents.width;
+    double projected = swipe_ptr->offset +
+        swipe_ptr->velocity * _wlmtk_root_swipe_project_msec;
+    bool commit = !cancelled &&
+        0 < projected * swipe_ptr->offset &&
+        width < 2 * fabs(projected);
+
+    if (root_ptr->per_output_workspaces) {
+        _wlmtk_root_swipe_reset(root_ptr);
+        if (!commit) return;
+        _wlmtk_root_switch_to_workspace(
+            root_ptr,
+            0 > projected ?
+            wlmtk_root_get_next_workspace(root_ptr) :
+            wlmtk_root_get_previous_workspace(root_ptr));
+        return;
+    }
+    wlmtk_workspace_t *neighbour_ptr = swipe_ptr->neighbour_ptr;
+    if (NULL == neighbour_ptr) {
+        _wlmtk_root_swipe_reset(root_ptr);
+        return;
+    }
+
+    // Settles at the finger's speed, if faster than a regular switch.
+    int offset = (int)swipe_ptr->offset;
+    int direction = swipe_ptr->direction;
+    double distance = commit ? width - fabs(offset) : fabs(offset);
+    double speed = BS_MAX(fabs(swipe_ptr->velocity),
+                          width / (double)_wlmtk_root_switch_msec);
+    uint64_t msec = BS_MAX(UINT64_C(1), BS_MIN(_wlmtk_root_switch_msec,
+                                     (uint64_t)(distance / speed)));
+    wlmtk_animation_props_t to = wlmtk_animation_props_identity;
+    if (commit) {
+        // A snapshot of the former workspace slides out, and the neighbour
+        // slides in live.
+        to.x = -direction * width - offset;
+        wlmtk_animation_snapshot(
+            wlmtk_workspace_element(root_ptr->current_workspace_ptr),
+            &wlmtk_animation_props_identity, &to, msec);
+        _wlmtk_root_swipe_place(root_ptr->current_workspace_ptr, 0);
+        swipe_ptr->settling = true;
+        _wlmtk_root_switch_to_workspace(root_ptr, neighbour_ptr);
+        wlmtk_animation_translate(
+            wlmtk_workspace_element(neighbour_ptr),
+            offset + direction * width, 0, msec);
     } else {
-        dlnode_ptr = dlnode_ptr->prev_ptr;
+        // The other way round: The neighbour is snapshotted to slide out.
+        to.x = -offset;
+        wlmtk_animation_snapshot(
+            wlmtk_workspace_element(neighbour_ptr),
+            &wlmtk_animation_props_identity, &to, msec);
+        _wlmtk_root_swipe_hide_neighbour(root_ptr);
+        wlmtk_animation_translate(
+            wlmtk_workspace_element(root_ptr->current_workspace_ptr),
+            offset, 0, msec);
     }
-    wlmtk_workspace_t *workspace_ptr = wlmtk_workspace_from_dlnode(dlnode_ptr);
+    *swipe_ptr = (wlmtk_root_swipe_t){};
+}
 
-    _wlmtk_root_switch_to_workspace(root_ptr, workspace_ptr);
+/* ------------------------------------------------------------------------- */
+void wlmtk_root_switch_to_next_workspace(wlmtk_root_t *root_ptr)
+{
+    if (NULL == root_ptr->current_workspace_ptr) return;
+    _wlmtk_root_switch_to_workspace(
+        root_ptr, wlmtk_root_get_next_workspace(root_ptr));
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_root_switch_to_previous_workspace(wlmtk_root_t *root_ptr)
+{
+    if (NULL == root_ptr->current_workspace_ptr) return;
+    _wlmtk_root_switch_to_workspace(
+        root_ptr, wlmtk_root_get_previous_workspace(root_ptr));
 }
 
 /* ------------------------------------------------------------------------- */
@@ -393,14 +867,9 @@ bool wlmtk_root_lock(
     }
     root_ptr->lock_element_ptr = element_ptr;
 
-    wlmtk_workspace_enable(root_ptr->current_workspace_ptr, false);
-
-    wlmtk_rectangle_set_size(
-        root_ptr->curtain_rectangle_ptr,
-        root_ptr->extents.width, root_ptr->extents.height);
-    wlmtk_element_set_visible(
-        wlmtk_rectangle_element(root_ptr->curtain_rectangle_ptr),
-        true);
+    // Already covered, if pre-locked. The lock takes over from there.
+    if (!root_ptr->prelocked) _wlmtk_root_set_covered(root_ptr, true);
+    root_ptr->prelocked = false;
 
     wlmtk_container_add_element(
         &root_ptr->container,
@@ -426,16 +895,22 @@ bool wlmtk_root_unlock(
     wlmtk_root_lock_unreference(root_ptr, element_ptr);
     root_ptr->locked = false;
 
-    wlmtk_element_set_visible(
-        wlmtk_rectangle_element(root_ptr->curtain_rectangle_ptr),
-        false);
-
     wl_signal_emit(&root_ptr->events.unlock_event, NULL);
 
-    wlmtk_workspace_enable(root_ptr->current_workspace_ptr, true);
+    _wlmtk_root_set_covered(root_ptr, false);
     return true;
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_root_prelock(wlmtk_root_t *root_ptr, bool prelocked)
+{
+    if (root_ptr->prelocked == prelocked) return;
+    if (prelocked && root_ptr->locked) return;
+
+    root_ptr->prelocked = prelocked;
+    _wlmtk_root_set_covered(root_ptr, prelocked);
+}
+
 /* ------------------------------------------------------------------------- */
 bool wlmtk_root_locked(wlmtk_root_t *root_ptr)
 {
@@ -461,8 +936,116 @@ wlmtk_element_t *wlmtk_root_element(wlmtk_root_t *root_ptr)
     return &root_ptr->container.super_element;
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_root_add_to_window_group(
+    wlmtk_root_t *root_ptr,
+    wlmtk_window_t *window_ptr)
+{
+    BS_ASSERT(NULL == wlmtk_window_get_group(window_ptr));
+    const wlmtk_util_client_t *client_ptr = wlmtk_window_get_client_ptr(
+        window_ptr);
+    // Windows of the toolkit itself, such as the root menu: No group.
+    if (NULL == client_ptr || 0 == client_ptr->pid) return;
+
+    wlmtk_window_group_t *group_ptr = wlmtk_root_get_window_group(
+        root_ptr, client_ptr->pid);
+    if (NULL == group_ptr) {
+        group_ptr = logged_calloc(1, sizeof(wlmtk_window_group_t));
+        if (NULL == group_ptr) return;
+        group_ptr->pid = client_ptr->pid;
+        bs_avltree_insert(
+            root_ptr->window_groups_ptr, &group_ptr->pid,
+            &group_ptr->avlnode, false);
+    }
+    bs_dllist_push_back(
+        &group_ptr->windows, wlmtk_group_dlnode_from_window(window_ptr));
+    wlmtk_window_set_group(window_ptr, group_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_root_remove_from_window_group(
+    wlmtk_root_t *root_ptr,
+    wlmtk_window_t *window_ptr)
+{
+    wlmtk_window_group_t *group_ptr = wlmtk_window_get_group(window_ptr);
+    if (NULL == group_ptr) return;
+
+    bs_dllist_remove(
+        &group_ptr->windows, wlmtk_group_dlnode_from_window(window_ptr));
+    wlmtk_window_set_group(window_ptr, NULL);
+    if (bs_dllist_empty(&group_ptr->windows)) {
+        bs_avltree_delete(root_ptr->window_groups_ptr, &group_ptr->pid);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+wlmtk_window_group_t *wlmtk_root_get_window_group(
+    wlmtk_root_t *root_ptr,
+    pid_t pid)
+{
+    bs_avltree_node_t *avlnode_ptr = bs_avltree_lookup(
+        root_ptr->window_groups_ptr, &pid);
+    if (NULL == avlnode_ptr) return NULL;
+    return BS_CONTAINER_OF(avlnode_ptr, wlmtk_window_group_t, avlnode);
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_window_group_size(wlmtk_window_group_t *group_ptr)
+{
+    return bs_dllist_size(&group_ptr->windows);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_window_group_for_each(
+    wlmtk_window_group_t *group_ptr,
+    void (*func)(wlmtk_window_t *window_ptr, void *ud_ptr),
+    void *ud_ptr)
+{
+    // Fetches the next node first: `func` may unmap the window.
+    bs_dllist_node_t *next_dlnode_ptr;
+    for (bs_dllist_node_t *dlnode_ptr = group_ptr->windows.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = next_dlnode_ptr) {
+        next_dlnode_ptr = dlnode_ptr->next_ptr;
+        func(wlmtk_window_from_group_dlnode(dlnode_ptr), ud_ptr);
+    }
+}
+
 /* == Local (static) methods =============================================== */
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Covers the desktop with the curtain, or uncovers it.
+ *
+ * Covering hides the workspace, including its layers with dock, clip and
+ * panels. That takes it out of the scene graph's rendering: Surfaces are
+ * left to the (throttled) frame callbacks of hidden surfaces, and the lock
+ * surfaces may get scanned out directly.
+ *
+ * @param root_ptr
+ * @param covered
+ */
+void _wlmtk_root_set_covered(wlmtk_root_t *root_ptr, bool covered)
+{
+    if (covered) {
+        wlmtk_rectangle_set_size(
+            root_ptr->curtain_rectangle_ptr,
+            root_ptr->extents.width, root_ptr->extents.height);
+    }
+    wlmtk_element_set_visible(
+        wlmtk_rectangle_element(root_ptr->curtain_rectangle_ptr),
+        covered);
+
+    if (root_ptr->per_output_workspaces) {
+        _wlmtk_root_show_workspaces(root_ptr);
+        return;
+    }
+    if (NULL == root_ptr->current_workspace_ptr) return;
+    wlmtk_element_set_visible(
+        wlmtk_workspace_element(root_ptr->current_workspace_ptr), !covered);
+    wlmtk_workspace_enable(root_ptr->current_workspace_ptr, !covered);
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Switches to `workspace_ptr` as the current workspace.
@@ -475,22 +1058,88 @@ void _wlmtk_root_switch_to_workspace(
     wlmtk_workspace_t *workspace_ptr)
 {
     if (root_ptr->current_workspace_ptr == workspace_ptr) return;
+    // A switch from elsewhere ends the swipe.
+    if (!root_ptr->swipe.settling) _wlmtk_root_swipe_reset(root_ptr);
 
     if (NULL == workspace_ptr) {
         root_ptr->current_workspace_ptr = NULL;
+    } else if (root_ptr->per_output_workspaces) {
+        BS_ASSERT(root_ptr == wlmtk_workspace_get_root(workspace_ptr));
+
+        // Shows it on the active output. If another output showed it, that
+        // one gets the active output's former workspace: They swap.
+        wlmtk_root_output_t *active_ptr = _wlmtk_root_find_output(
+            root_ptr, root_ptr->active_wlr_output_ptr);
+        if (NULL != active_ptr) {
+            if (NULL != active_ptr->workspace_ptr) {
+                _wlmtk_root_capture_thumbnails(active_ptr->workspace_ptr);
+            }
+            for (size_t i = 0; i < root_ptr->outputs_size; ++i) {
+                wlmtk_root_output_t *o_ptr = &root_ptr->outputs[i];
+                if (o_ptr == active_ptr ||
+                    o_ptr->workspace_ptr != workspace_ptr) continue;
+                o_ptr->workspace_ptr = active_ptr->workspace_ptr;
+            }
+            active_ptr->workspace_ptr = workspace_ptr;
+        }
+        root_ptr->current_workspace_ptr = workspace_ptr;
+        wlmtk_workspace_wake(workspace_ptr);
+
+        _wlmtk_root_cancel_prewarm(root_ptr);
+        for (size_t i = 0; i < root_ptr->workspaces_size; ++i) {
+            wlmtk_workspace_t *ws_ptr = root_ptr->workspace_ptrs[i];
+            if (_wlmtk_root_workspace_shown(root_ptr, ws_ptr)) {
+                wlmtk_workspace_wake(ws_ptr);
+            } else if (root_ptr->hibernate_inactive_workspaces) {
+                _wlmtk_root_hibernate_workspace(ws_ptr);
+            }
+        }
+        // Only the active output's workspace changes: The scene damages
+        // just that output.
+        _wlmtk_root_show_workspaces(root_ptr);
     } else {
-        BS_ASSERT(root_ptr = wlmtk_workspace_get_root(workspace_ptr));
+        BS_ASSERT(root_ptr == wlmtk_workspace_get_root(workspace_ptr));
 
         if (NULL != root_ptr->current_workspace_ptr) {
+            _wlmtk_root_capture_thumbnails(root_ptr->current_workspace_ptr);
+            // Cross-fades: A snapshot of the former workspace fades out.
+            // Unless it already slides out, when settling a swipe.
+            wlmtk_animation_props_t to = wlmtk_animation_props_identity;
+            to.opacity = 0;
+            if (!root_ptr->swipe.settling) {
+                wlmtk_animation_snapshot(
+                    wlmtk_workspace_element(root_ptr->current_workspace_ptr),
+                    &wlmtk_animation_props_identity, &to,
+                    _wlmtk_root_switch_msec);
+            }
             wlmtk_element_set_visible(
                 wlmtk_workspace_element(root_ptr->current_workspace_ptr),
                 false);
             wlmtk_workspace_enable(root_ptr->current_workspace_ptr, false);
         }
         root_ptr->current_workspace_ptr = workspace_ptr;
-        wlmtk_element_set_visible(
-            wlmtk_workspace_element(root_ptr->current_workspace_ptr), true);
-        wlmtk_workspace_enable(root_ptr->current_workspace_ptr, true);
+        // Wakes (redraws) before showing the workspace.
+        wlmtk_workspace_wake(root_ptr->current_workspace_ptr);
+
+        // Hibernates the former and all pre-warmed workspaces.
+        _wlmtk_root_cancel_prewarm(root_ptr);
+        if (root_ptr->hibernate_inactive_workspaces) {
+            for (bs_dllist_node_t *dlnode_ptr = root_ptr->workspaces.head_ptr;
+                 NULL != dlnode_ptr;
+                 dlnode_ptr = dlnode_ptr->next_ptr) {
+                wlmtk_workspace_t *ws_ptr = wlmtk_workspace_from_dlnode(
+                    dlnode_ptr);
+                if (ws_ptr == workspace_ptr) continue;
+                _wlmtk_root_hibernate_workspace(ws_ptr);
+            }
+        }
+        // While (pre)locked, the workspace stays hidden until unlocking.
+        if (!root_ptr->locked && !root_ptr->prelocked) {
+            wlmtk_element_set_visible(
+                wlmtk_workspace_element(root_ptr->current_workspace_ptr),
+                true);
+            wlmtk_workspace_enable(root_ptr->current_workspace_ptr, true);
+        }
     }
 
     wl_signal_emit(
@@ -499,58 +1148,364 @@ void _wlmtk_root_switch_to_workspace(
 }
 
 /* ------------------------------------------------------------------------- */
-/** Callback for bs_dllist_for_each: Destroys the workspace. */
-void _wlmtk_root_destroy_workspace(bs_dllist_node_t *dlnode_ptr, void *ud_ptr)
+/** @return Element of @ref wlmtk_root_t::outputs for the output, or NULL. */
+wlmtk_root_output_t *_wlmtk_root_find_output(
+    wlmtk_root_t *root_ptr,
+    struct wlr_output *wlr_output_ptr)
 {
-    wlmtk_workspace_t *workspace_ptr = wlmtk_workspace_from_dlnode(dlnode_ptr);
-    wlmtk_root_remove_workspace(ud_ptr, workspace_ptr);
-    wlmtk_workspace_destroy(workspace_ptr);
+    if (NULL == wlr_output_ptr) return NULL;
+    for (size_t i = 0; i < root_ptr->outputs_size; ++i) {
+        if (root_ptr->outputs[i].wlr_output_ptr == wlr_output_ptr) {
+            return &root_ptr->outputs[i];
+        }
+    }
+    return NULL;
 }
 
 /* ------------------------------------------------------------------------- */
-/** Callback for bs_dllist_for_each: Enumerates the workspace. */
-void _wlmtk_root_enumerate_workspaces(
-    bs_dllist_node_t *dlnode_ptr,
-    void *ud_ptr)
+/** @return Whether `workspace_ptr` is shown, on any output. */
+bool _wlmtk_root_workspace_shown(
+    wlmtk_root_t *root_ptr,
+    wlmtk_workspace_t *workspace_ptr)
 {
-    int *index_ptr = ud_ptr;
-    wlmtk_workspace_set_details(
-        wlmtk_workspace_from_dlnode(dlnode_ptr),
-        *index_ptr);
-    *index_ptr += 1;
+    if (workspace_ptr == root_ptr->current_workspace_ptr) return true;
+    if (!root_ptr->per_output_workspaces) return false;
+    for (size_t i = 0; i < root_ptr->outputs_size; ++i) {
+        if (root_ptr->outputs[i].workspace_ptr == workspace_ptr) return true;
+    }
+    return false;
 }
 
 /* ------------------------------------------------------------------------- */
 /**
- * Implements @ref wlmtk_element_vmt_t::pointer_motion. Handle pointer moves.
+ * Per-output workspaces: Updates @ref wlmtk_root_t::outputs from the output
+ * layout. Outputs keep their workspace. A new output gets the current
+ * workspace if no other output shows it, or else the first workspace not
+ * shown elsewhere.
  *
- * When locked, the root container will forward the events strictly only to
- * the lock container.
- *
- * @param element_ptr
- * @param motion_event_ptr
- *
- * @return Whether the move was accepted.
+ * @param root_ptr
  */
-bool _wlmtk_root_element_pointer_motion(
-    wlmtk_element_t *element_ptr,
-    wlmtk_pointer_motion_event_t *motion_event_ptr)
+void _wlmtk_root_update_outputs(wlmtk_root_t *root_ptr)
 {
-    wlmtk_root_t *root_ptr = BS_CONTAINER_OF(
-        element_ptr, wlmtk_root_t, container.super_element);
-
-    if (!root_ptr->locked) {
-        // TODO(kaeser@gubbe.ch): We'll want to pass this on to the non-curtain
-        // elements only.
-        return root_ptr->orig_super_element_vmt.pointer_motion(
-            element_ptr, motion_event_ptr);
-    } else if (NULL != root_ptr->lock_element_ptr) {
-        return wlmtk_element_pointer_motion(
-            root_ptr->lock_element_ptr,
-            motion_event_ptr);
+    if (!root_ptr->per_output_workspaces) return;
+
+    size_t outputs_size = wl_list_length(
+        &root_ptr->wlr_output_layout_ptr->outputs);
+    wlmtk_root_output_t *outputs = NULL;
+    if (0 < outputs_size) {
+        outputs = logged_calloc(outputs_size, sizeof(wlmtk_root_output_t));
+        if (NULL == outputs) return;
     }
-
-    // Fall-through.
+    size_t i = 0;
+    struct wlr_output_layout_output *wlr_output_layout_output_ptr;
+    wl_list_for_each(wlr_output_layout_output_ptr,
+                     &root_ptr->wlr_output_layout_ptr->outputs,
+                     link) {
+        wlmtk_root_output_t *former_ptr = _wlmtk_root_find_output(
+            root_ptr, wlr_output_layout_output_ptr->output);
+        outputs[i].wlr_output_ptr = wlr_output_layout_output_ptr->output;
+        if (NULL != former_ptr) {
+            outputs[i].workspace_ptr = former_ptr->workspace_ptr;
+        }
+        ++i;
+    }
+    if (NULL != root_ptr->outputs) free(root_ptr->outputs);
+    root_ptr->outputs = outputs;
+    root_ptr->outputs_size = outputs_size;
+
+    for (i = 0; i < root_ptr->outputs_size; ++i) {
+        if (NULL != root_ptr->outputs[i].workspace_ptr) continue;
+        bool current_mapped = false;
+        for (size_t o = 0; o < root_ptr->outputs_size; ++o) {
+            current_mapped |= root_ptr->outputs[o].workspace_ptr ==
+                root_ptr->current_workspace_ptr;
+        }
+        if (!current_mapped) {
+            root_ptr->outputs[i].workspace_ptr =
+                root_ptr->current_workspace_ptr;
+            continue;
+        }
+        for (size_t w = 0; w < root_ptr->workspaces_size; ++w) {
+            wlmtk_workspace_t *ws_ptr = root_ptr->workspace_ptrs[w];
+            if (_wlmtk_root_workspace_shown(root_ptr, ws_ptr)) continue;
+            root_ptr->outputs[i].workspace_ptr = ws_ptr;
+            break;
+        }
+        if (NULL == root_ptr->outputs[i].workspace_ptr) {
+            root_ptr->outputs[i].workspace_ptr =
+                root_ptr->current_workspace_ptr;
+        }
+        if (NULL != root_ptr->outputs[i].workspace_ptr) {
+            wlmtk_workspace_wake(root_ptr->outputs[i].workspace_ptr);
+        }
+    }
+
+    // The active output may have gone. Then pick the first.
+    struct wlr_output *active_wlr_output_ptr =
+        root_ptr->active_wlr_output_ptr;
+    if (NULL == _wlmtk_root_find_output(root_ptr, active_wlr_output_ptr)) {
+        active_wlr_output_ptr = 0 < root_ptr->outputs_size ?
+            root_ptr->outputs[0].wlr_output_ptr : NULL;
+    }
+    root_ptr->active_wlr_output_ptr = NULL;
+    _wlmtk_root_activate_output(root_ptr, active_wlr_output_ptr);
+    _wlmtk_root_show_workspaces(root_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Shows the workspaces that are current, or shown on an output, and hides
+ * all others. Only the current workspace is enabled. While covered, all are
+ * hidden.
+ *
+ * @param root_ptr
+ */
+void _wlmtk_root_show_workspaces(wlmtk_root_t *root_ptr)
+{
+    bool covered = root_ptr->locked || root_ptr->prelocked;
+    for (size_t i = 0; i < root_ptr->workspaces_size; ++i) {
+        wlmtk_workspace_t *workspace_ptr = root_ptr->workspace_ptrs[i];
+        bool shown = _wlmtk_root_workspace_shown(root_ptr, workspace_ptr);
+        // Hides its windows on other outputs, before it gets drawn.
+        if (shown && !covered) wlmtk_workspace_update_occlusion(workspace_ptr);
+        wlmtk_element_set_visible(
+            wlmtk_workspace_element(workspace_ptr), shown && !covered);
+        wlmtk_workspace_enable(
+            workspace_ptr,
+            !covered && workspace_ptr == root_ptr->current_workspace_ptr);
+    }
+
+    // The current workspace is stacked on top, for it to receive pointer
+    // events first. Keeps the curtain above.
+    if (!root_ptr->per_output_workspaces ||
+        covered ||
+        NULL != root_ptr->lock_element_ptr ||
+        NULL == root_ptr->current_workspace_ptr) return;
+    wlmtk_container_raise_element_to_top(
+        &root_ptr->container,
+        wlmtk_workspace_element(root_ptr->current_workspace_ptr));
+    wlmtk_container_raise_element_to_top(
+        &root_ptr->container,
+        wlmtk_rectangle_element(root_ptr->curtain_rectangle_ptr));
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Per-output workspaces: Makes `wlr_output_ptr` the active output, and its
+ * workspace the current one.
+ *
+ * @param root_ptr
+ * @param wlr_output_ptr      May be NULL, which is ignored.
+ */
+void _wlmtk_root_activate_output(
+    wlmtk_root_t *root_ptr,
+    struct wlr_output *wlr_output_ptr)
+{
+    if (NULL == wlr_output_ptr ||
+        wlr_output_ptr == root_ptr->active_wlr_output_ptr) return;
+    root_ptr->active_wlr_output_ptr = wlr_output_ptr;
+
+    wlmtk_root_output_t *output_ptr = _wlmtk_root_find_output(
+        root_ptr, wlr_output_ptr);
+    if (NULL == output_ptr ||
+        NULL == output_ptr->workspace_ptr ||
+        output_ptr->workspace_ptr == root_ptr->current_workspace_ptr) return;
+
+    root_ptr->current_workspace_ptr = output_ptr->workspace_ptr;
+    _wlmtk_root_show_workspaces(root_ptr);
+    wl_signal_emit(
+        &root_ptr->events.workspace_changed,
+        root_ptr->current_workspace_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Compares the PID of the @ref wlmtk_window_group_t with `key_ptr`. */
+int _wlmtk_window_group_cmp(
+    const bs_avltree_node_t *avlnode_ptr,
+    const void *key_ptr)
+{
+    pid_t pid = BS_CONTAINER_OF(
+        avlnode_ptr, wlmtk_window_group_t, avlnode)->pid;
+    pid_t key = *(const pid_t*)key_ptr;
+    if (pid == key) return 0;
+    return pid < key ? -1 : 1;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the @ref wlmtk_window_group_t. Windows still in it leave. */
+void _wlmtk_window_group_destroy(bs_avltree_node_t *avlnode_ptr)
+{
+    wlmtk_window_group_t *group_ptr = BS_CONTAINER_OF(
+        avlnode_ptr, wlmtk_window_group_t, avlnode);
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&group_ptr->windows))) {
+        wlmtk_window_set_group(wlmtk_window_from_group_dlnode(dlnode_ptr),
+                               NULL);
+    }
+    free(group_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Callback for bs_dllist_for_each: Destroys the workspace. */
+void _wlmtk_root_destroy_workspace(bs_dllist_node_t *dlnode_ptr, void *ud_ptr)
+{
+    wlmtk_workspace_t *workspace_ptr = wlmtk_workspace_from_dlnode(dlnode_ptr);
+    wlmtk_root_remove_workspace(ud_ptr, workspace_ptr);
+    wlmtk_workspace_destroy(workspace_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Hibernates the workspace, and reports the reclaimed memory.
+ *
+ * @param workspace_ptr
+ *
+ * @return Number of bytes reclaimed.
+ */
+size_t _wlmtk_root_hibernate_workspace(wlmtk_workspace_t *workspace_ptr)
+{
+    if (wlmtk_workspace_hibernated(workspace_ptr)) return 0;
+    size_t bytes = wlmtk_workspace_hibernate(workspace_ptr);
+
+    const char *name_ptr;
+    int index;
+    wlmtk_workspace_get_details(workspace_ptr, &name_ptr, &index);
+    bs_log(BS_INFO, "Hibernated workspace %d (\"%s\"): Reclaimed %zu bytes.",
+           index, name_ptr, bytes);
+    return bytes;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_cache_evict_t: Hibernates all workspaces that are
+ * not shown, also the pre-warmed ones, and drops pending pre-warm requests.
+ * They get woken up when switched to. All or nothing, ignores `percent`.
+ *
+ * @param percent
+ * @param ud_ptr
+ *
+ * @return Number of bytes reclaimed.
+ */
+size_t _wlmtk_root_evict(__UNUSED__ unsigned percent, void *ud_ptr)
+{
+    wlmtk_root_t *root_ptr = ud_ptr;
+    _wlmtk_root_cancel_prewarm(root_ptr);
+
+    size_t bytes = 0;
+    for (size_t i = 0; i < root_ptr->workspaces_size; ++i) {
+        wlmtk_workspace_t *workspace_ptr = root_ptr->workspace_ptrs[i];
+        if (_wlmtk_root_workspace_shown(root_ptr, workspace_ptr)) continue;
+        bytes += _wlmtk_root_hibernate_workspace(workspace_ptr);
+    }
+    return bytes;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Captures thumbnails of the workspace's windows, while they are still shown.
+ * For previews of the windows, once the workspace is switched away from.
+ *
+ * @param workspace_ptr
+ */
+void _wlmtk_root_capture_thumbnails(wlmtk_workspace_t *workspace_ptr)
+{
+    for (bs_dllist_node_t *dlnode_ptr =
+             wlmtk_workspace_get_windows_dllist(workspace_ptr)->head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_window_thumbnail(wlmtk_window_from_dlnode(dlnode_ptr));
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Drops pending pre-warm requests. */
+void _wlmtk_root_cancel_prewarm(wlmtk_root_t *root_ptr)
+{
+    if (NULL != root_ptr->prewarm_idle_ptr) {
+        wl_event_source_remove(root_ptr->prewarm_idle_ptr);
+        root_ptr->prewarm_idle_ptr = NULL;
+    }
+    root_ptr->prewarm_workspace_ptrs[0] = NULL;
+    root_ptr->prewarm_workspace_ptrs[1] = NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Idle callback: Wakes the workspaces requested for pre-warming. */
+void _wlmtk_root_handle_prewarm_idle(void *data_ptr)
+{
+    wlmtk_root_t *root_ptr = data_ptr;
+    root_ptr->prewarm_idle_ptr = NULL;
+
+    for (size_t i = 0; i < 2; ++i) {
+        wlmtk_workspace_t *workspace_ptr = root_ptr->prewarm_workspace_ptrs[i];
+        root_ptr->prewarm_workspace_ptrs[i] = NULL;
+        if (NULL == workspace_ptr) continue;
+        wlmtk_workspace_wake(workspace_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the position of `workspace_ptr` in
+ * @ref wlmtk_root_t::workspace_ptrs. Constant time: Derived from the
+ * workspace's index.
+ *
+ * @param root_ptr
+ * @param workspace_ptr       Must be a workspace of `root_ptr`.
+ *
+ * @return The position.
+ */
+size_t _wlmtk_root_workspace_position(
+    wlmtk_root_t *root_ptr,
+    wlmtk_workspace_t *workspace_ptr)
+{
+    const char *name_ptr;
+    int index;
+    wlmtk_workspace_get_details(workspace_ptr, &name_ptr, &index);
+    BS_ASSERT(0 < index && (size_t)index <= root_ptr->workspaces_size);
+    BS_ASSERT(root_ptr->workspace_ptrs[index - 1] == workspace_ptr);
+    return index - 1;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_element_vmt_t::pointer_motion. Handle pointer moves.
+ *
+ * When locked, the root container will forward the events strictly only to
+ * the lock container.
+ *
+ * @param element_ptr
+ * @param motion_event_ptr
+ *
+ * @return Whether the move was accepted.
+ */
+bool _wlmtk_root_element_pointer_motion(
+    wlmtk_element_t *element_ptr,
+    wlmtk_pointer_motion_event_t *motion_event_ptr)
+{
+    wlmtk_root_t *root_ptr = BS_CONTAINER_OF(
+        element_ptr, wlmtk_root_t, container.super_element);
+
+    if (!root_ptr->locked && !root_ptr->prelocked) {
+        if (root_ptr->per_output_workspaces) {
+            _wlmtk_root_activate_output(
+                root_ptr,
+                wlr_output_layout_output_at(
+                    root_ptr->wlr_output_layout_ptr,
+                    motion_event_ptr->x,
+                    motion_event_ptr->y));
+        }
+        // TODO(kaeser@gubbe.ch): We'll want to pass this on to the non-curtain
+        // elements only.
+        return root_ptr->orig_super_element_vmt.pointer_motion(
+            element_ptr, motion_event_ptr);
+    } else if (NULL != root_ptr->lock_element_ptr) {
+        return wlmtk_element_pointer_motion(
+            root_ptr->lock_element_ptr,
+            motion_event_ptr);
+    }
+
+    // Fall-through.
     return false;
 }
 
@@ -573,7 +1528,7 @@ bool _wlmtk_root_element_pointer_button(
     wlmtk_root_t *root_ptr = BS_CONTAINER_OF(
         element_ptr, wlmtk_root_t, container.super_element);
 
-    if (!root_ptr->locked) {
+    if (!root_ptr->locked && !root_ptr->prelocked) {
         // TODO(kaeser@gubbe.ch): We'll want to pass this on to the non-curtain
         // elements only.
         return root_ptr->orig_super_element_vmt.pointer_button(
@@ -607,7 +1562,7 @@ bool _wlmtk_root_element_pointer_axis(
     wlmtk_root_t *root_ptr = BS_CONTAINER_OF(
         element_ptr, wlmtk_root_t, container.super_element);
 
-    if (!root_ptr->locked) {
+    if (!root_ptr->locked && !root_ptr->prelocked) {
         // TODO(kaeser@gubbe.ch): We'll want to pass this on to the non-curtain
         // elements only.
         return root_ptr->orig_super_element_vmt.pointer_axis(
@@ -647,7 +1602,8 @@ bool _wlmtk_root_element_keyboard_event(
     wlmtk_root_t *root_ptr = BS_CONTAINER_OF(
         element_ptr, wlmtk_root_t, container.super_element);
 
-    if (!root_ptr->locked) {
+    wlmtk_latency_input(wlr_keyboard_key_event_ptr->time_msec);
+    if (!root_ptr->locked && !root_ptr->prelocked) {
         // TODO(kaeser@gubbe.ch): We'll want to pass this on to the non-curtain
         // elements only.
         return root_ptr->orig_super_element_vmt.keyboard_event(
@@ -692,18 +1648,85 @@ void _wlmtk_root_handle_output_layout_change(
         wlmtk_rectangle_element(root_ptr->curtain_rectangle_ptr),
         root_ptr->extents.x,
         root_ptr->extents.y);
+    _wlmtk_root_update_outputs(root_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Ends a swipe right away: Returns the workspaces to their positions, and
+ * hides the neighbour.
+ *
+ * @param root_ptr
+ */
+void _wlmtk_root_swipe_reset(wlmtk_root_t *root_ptr)
+{
+    if (!root_ptr->swipe.active) return;
+    if (NULL != root_ptr->current_workspace_ptr) {
+        _wlmtk_root_swipe_place(root_ptr->current_workspace_ptr, 0);
+    }
+    _wlmtk_root_swipe_hide_neighbour(root_ptr);
+    root_ptr->swipe = (wlmtk_root_swipe_t){};
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the swipe's neighbour to its position, and hides it. It stays
+ * awake, like a pre-warmed workspace.
+ *
+ * @param root_ptr
+ */
+void _wlmtk_root_swipe_hide_neighbour(wlmtk_root_t *root_ptr)
+{
+    wlmtk_workspace_t *workspace_ptr = root_ptr->swipe.neighbour_ptr;
+    if (NULL == workspace_ptr) return;
+    root_ptr->swipe.neighbour_ptr = NULL;
+    root_ptr->swipe.direction = 0;
+
+    _wlmtk_root_swipe_place(workspace_ptr, 0);
+    if (_wlmtk_root_workspace_shown(root_ptr, workspace_ptr)) return;
+    wlmtk_element_set_visible(wlmtk_workspace_element(workspace_ptr), false);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Moves the workspace's scene node by `offset`, leaving the element's
+ * position as-is: Neither the windows nor the layout are updated.
+ *
+ * @param workspace_ptr
+ * @param offset              Horizontal offset from the element's position.
+ */
+void _wlmtk_root_swipe_place(wlmtk_workspace_t *workspace_ptr, int offset)
+{
+    wlmtk_element_t *element_ptr = wlmtk_workspace_element(workspace_ptr);
+    if (NULL == element_ptr->wlr_scene_node_ptr) return;
+    wlr_scene_node_set_position(
+        element_ptr->wlr_scene_node_ptr,
+        element_ptr->x + offset,
+        element_ptr->y);
 }
 
 /* == Unit tests =========================================================== */
 
 static void test_create_destroy(bs_test_t *test_ptr);
 static void test_workspaces(bs_test_t *test_ptr);
+static void test_workspace_positions(bs_test_t *test_ptr);
+static void test_per_output_workspaces(bs_test_t *test_ptr);
 static void test_pointer_button(bs_test_t *test_ptr);
+static void test_prewarm(bs_test_t *test_ptr);
+static void test_lock(bs_test_t *test_ptr);
+static void test_swipe(bs_test_t *test_ptr);
+static void test_window_groups(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_root_test_cases[] = {
     { 1, "create_destroy", test_create_destroy },
     { 1, "workspaces", test_workspaces },
+    { 1, "workspace_positions", test_workspace_positions },
+    { 1, "per_output_workspaces", test_per_output_workspaces },
     { 1, "pointer_button", test_pointer_button },
+    { 1, "prewarm", test_prewarm },
+    { 1, "lock", test_lock },
+    { 1, "swipe", test_swipe },
+    { 1, "window_groups", test_window_groups },
     { 0, NULL, NULL }
 };
 
@@ -800,6 +1823,156 @@ void test_workspaces(bs_test_t *test_ptr)
     wlr_scene_node_destroy(&wlr_scene_ptr->tree.node);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests direct access by position, and renumbering on removal. */
+void test_workspace_positions(bs_test_t *test_ptr)
+{
+    struct wl_display *wl_display_ptr = wl_display_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_display_ptr);
+    struct wlr_output_layout *wlr_output_layout_ptr =
+        wlr_output_layout_create(wl_display_ptr);
+    wlmtk_root_t *root_ptr = wlmtk_root_create(NULL, wlr_output_layout_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, root_ptr);
+
+    // More than the initial capacity, to verify growing.
+    static const wlmtk_tile_style_t tstyle = {};
+    wlmtk_workspace_t *ws_ptrs[10];
+    for (size_t i = 0; i < 10; ++i) {
+        ws_ptrs[i] = wlmtk_workspace_create(
+            wlr_output_layout_ptr, "w", &tstyle);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws_ptrs[i]);
+        BS_TEST_VERIFY_TRUE(
+            test_ptr, wlmtk_root_add_workspace(root_ptr, ws_ptrs[i]));
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 10, wlmtk_root_get_workspaces_size(root_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, ws_ptrs[9],
+                      wlmtk_root_get_workspace(root_ptr, 9));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, wlmtk_root_get_workspace(root_ptr, 10));
+
+    // Switch by position, and wrap around from the last one.
+    wlmtk_root_switch_to_workspace(root_ptr, 9);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, ws_ptrs[9], wlmtk_root_get_current_workspace(root_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, ws_ptrs[0], wlmtk_root_get_next_workspace(root_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, ws_ptrs[8], wlmtk_root_get_previous_workspace(root_ptr));
+    wlmtk_root_switch_to_workspace(root_ptr, 42);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, ws_ptrs[9], wlmtk_root_get_current_workspace(root_ptr));
+
+    // Removing the 3rd renumbers the ones after it.
+    wlmtk_root_remove_workspace(root_ptr, ws_ptrs[2]);
+    wlmtk_workspace_destroy(ws_ptrs[2]);
+    BS_TEST_VERIFY_EQ(test_ptr, 9, wlmtk_root_get_workspaces_size(root_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, ws_ptrs[3],
+                      wlmtk_root_get_workspace(root_ptr, 2));
+    const char *name_ptr;
+    int index;
+    wlmtk_workspace_get_details(ws_ptrs[9], &name_ptr, &index);
+    BS_TEST_VERIFY_EQ(test_ptr, 9, index);
+    wlmtk_workspace_get_details(ws_ptrs[1], &name_ptr, &index);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, index);
+
+    wlmtk_root_destroy(root_ptr);
+    wlr_output_layout_destroy(wlr_output_layout_ptr);
+    wl_display_destroy(wl_display_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests per-output workspaces: Mapping, switching and the active output. */
+void test_per_output_workspaces(bs_test_t *test_ptr)
+{
+    struct wl_display *wl_display_ptr = wl_display_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_display_ptr);
+    struct wlr_output_layout *wlr_output_layout_ptr =
+        wlr_output_layout_create(wl_display_ptr);
+    wlmtk_root_t *root_ptr = wlmtk_root_create(NULL, wlr_output_layout_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, root_ptr);
+
+    struct wlr_output o1 = { .width = 1024, .height = 768, .scale = 1 };
+    wlmtk_test_wlr_output_init(&o1);
+    wlr_output_layout_add(wlr_output_layout_ptr, &o1, 0, 0);
+    struct wlr_output o2 = { .width = 1024, .height = 768, .scale = 1 };
+    wlmtk_test_wlr_output_init(&o2);
+    wlr_output_layout_add(wlr_output_layout_ptr, &o2, 1024, 0);
+
+    static const wlmtk_tile_style_t tstyle = {};
+    wlmtk_workspace_t *ws_ptrs[3];
+    for (size_t i = 0; i < 3; ++i) {
+        ws_ptrs[i] = wlmtk_workspace_create(
+            wlr_output_layout_ptr, "w", &tstyle);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws_ptrs[i]);
+        BS_TEST_VERIFY_TRUE(
+            test_ptr, wlmtk_root_add_workspace(root_ptr, ws_ptrs[i]));
+    }
+
+    // Not per-output: The current workspace is shown everywhere.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_root_workspace_shown_on_output(root_ptr, ws_ptrs[1], &o2));
+
+    // The current workspace stays on the first output, the next gets shown
+    // on the second one.
+    wlmtk_root_set_per_output_workspaces(root_ptr, true);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_root_per_output_workspaces(root_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, ws_ptrs[0], wlmtk_root_get_current_workspace(root_ptr));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_root_workspace_shown_on_output(root_ptr, ws_ptrs[0], &o1));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_root_workspace_shown_on_output(root_ptr, ws_ptrs[1], &o2));
+    BS_TEST_VERIFY_FALSE(
+        test_ptr,
+        wlmtk_root_workspace_shown_on_output(root_ptr, ws_ptrs[0], &o2));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_workspace_element(ws_ptrs[1])->visible);
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlmtk_workspace_element(ws_ptrs[2])->visible);
+
+    // Switching only changes the active output.
+    wlmtk_root_switch_to_workspace(root_ptr, 2);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_root_workspace_shown_on_output(root_ptr, ws_ptrs[2], &o1));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_root_workspace_shown_on_output(root_ptr, ws_ptrs[1], &o2));
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlmtk_workspace_element(ws_ptrs[0])->visible);
+
+    // Switching to the workspace of the other output swaps them.
+    wlmtk_root_switch_to_workspace(root_ptr, 1);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_root_workspace_shown_on_output(root_ptr, ws_ptrs[1], &o1));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_root_workspace_shown_on_output(root_ptr, ws_ptrs[2], &o2));
+
+    // Moving the pointer to the second output makes its workspace current.
+    wlmtk_root_pointer_motion(root_ptr, 1500, 300, 0, NULL);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, ws_ptrs[2], wlmtk_root_get_current_workspace(root_ptr));
+
+    // Back to a single workspace: Only the current one is shown.
+    wlmtk_root_set_per_output_workspaces(root_ptr, false);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_workspace_element(ws_ptrs[2])->visible);
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlmtk_workspace_element(ws_ptrs[1])->visible);
+
+    for (size_t i = 0; i < 3; ++i) {
+        wlmtk_root_remove_workspace(root_ptr, ws_ptrs[i]);
+        wlmtk_workspace_destroy(ws_ptrs[i]);
+    }
+    wlmtk_root_destroy(root_ptr);
+    wlr_output_layout_destroy(wlr_output_layout_ptr);
+    wl_display_destroy(wl_display_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Tests wlmtk_root_pointer_button. */
 void test_pointer_button(bs_test_t *test_ptr)
@@ -876,4 +2049,327 @@ void test_pointer_button(bs_test_t *test_ptr)
     wlr_scene_node_destroy(&wlr_scene_ptr->tree.node);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests pre-warming of hibernated workspaces, and neighbour lookup. */
+void test_prewarm(bs_test_t *test_ptr)
+{
+    struct wlr_scene *wlr_scene_ptr = wlr_scene_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_scene_ptr);
+    struct wl_display *wl_display_ptr = wl_display_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_display_ptr);
+    struct wlr_output_layout *wlr_output_layout_ptr =
+        wlr_output_layout_create(wl_display_ptr);
+    wlmtk_root_t *root_ptr = wlmtk_root_create(
+        wlr_scene_ptr, wlr_output_layout_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, root_ptr);
+    wlmtk_root_set_hibernate_inactive_workspaces(root_ptr, true);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, wlmtk_root_get_next_workspace(root_ptr));
+
+    static const wlmtk_tile_style_t tstyle = {};
+    wlmtk_workspace_t *ws1_ptr = wlmtk_workspace_create(
+        wlr_output_layout_ptr, "1", &tstyle);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws1_ptr);
+    wlmtk_root_add_workspace(root_ptr, ws1_ptr);
+    wlmtk_workspace_t *ws2_ptr = wlmtk_workspace_create(
+        wlr_output_layout_ptr, "2", &tstyle);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws2_ptr);
+    wlmtk_root_add_workspace(root_ptr, ws2_ptr);
+    wlmtk_workspace_t *ws3_ptr = wlmtk_workspace_create(
+        wlr_output_layout_ptr, "3", &tstyle);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws3_ptr);
+    wlmtk_root_add_workspace(root_ptr, ws3_ptr);
+
+    // Neighbours wrap around.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, ws2_ptr, wlmtk_root_get_next_workspace(root_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, ws3_ptr, wlmtk_root_get_previous_workspace(root_ptr));
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_workspace_hibernated(ws1_ptr));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_workspace_hibernated(ws2_ptr));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_workspace_hibernated(ws3_ptr));
+
+    // Pre-warm from the idle callback.
+    struct wl_event_loop *wl_event_loop_ptr = wl_display_get_event_loop(
+        wl_display_ptr);
+    wlmtk_root_prewarm_workspace(root_ptr, ws2_ptr, wl_event_loop_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_workspace_hibernated(ws2_ptr));
+    wl_event_loop_dispatch_idle(wl_event_loop_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_workspace_hibernated(ws2_ptr));
+
+    // Pre-warm right away. Switching hibernates all but the new current.
+    wlmtk_root_prewarm_workspace(root_ptr, ws3_ptr, NULL);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_workspace_hibernated(ws3_ptr));
+
+    // Memory pressure: Pre-warmed workspaces, and requests, are dropped.
+    wlmtk_root_prewarm_workspace(root_ptr, ws2_ptr, wl_event_loop_ptr);
+    wlmtk_cache_evict(50);
+    wl_event_loop_dispatch_idle(wl_event_loop_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_workspace_hibernated(ws1_ptr));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_workspace_hibernated(ws2_ptr));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_workspace_hibernated(ws3_ptr));
+    wlmtk_root_switch_to_next_workspace(root_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, ws2_ptr, wlmtk_root_get_current_workspace(root_ptr));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_workspace_hibernated(ws1_ptr));
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_workspace_hibernated(ws2_ptr));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_workspace_hibernated(ws3_ptr));
+
+    // A pending request is dropped when the workspace goes away.
+    wlmtk_root_prewarm_workspace(root_ptr, ws3_ptr, wl_event_loop_ptr);
+    wlmtk_root_remove_workspace(root_ptr, ws3_ptr);
+    wlmtk_workspace_destroy(ws3_ptr);
+    wl_event_loop_dispatch_idle(wl_event_loop_ptr);
+
+    wlmtk_root_remove_workspace(root_ptr, ws2_ptr);
+    wlmtk_workspace_destroy(ws2_ptr);
+    wlmtk_root_remove_workspace(root_ptr, ws1_ptr);
+    wlmtk_workspace_destroy(ws1_ptr);
+    wlmtk_root_destroy(root_ptr);
+    wlr_output_layout_destroy(wlr_output_layout_ptr);
+    wl_display_destroy(wl_display_ptr);
+    wlr_scene_node_destroy(&wlr_scene_ptr->tree.node);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests that (pre)locking hides the workspace, also when switching. */
+void test_lock(bs_test_t *test_ptr)
+{
+    struct wlr_scene *wlr_scene_ptr = wlr_scene_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_scene_ptr);
+    struct wl_display *wl_display_ptr = wl_display_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_display_ptr);
+    struct wlr_output_layout *wlr_output_layout_ptr =
+        wlr_output_layout_create(wl_display_ptr);
+    wlmtk_root_t *root_ptr = wlmtk_root_create(
+        wlr_scene_ptr, wlr_output_layout_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, root_ptr);
+
+    static const wlmtk_tile_style_t tstyle = {};
+    wlmtk_workspace_t *ws1_ptr = wlmtk_workspace_create(
+        wlr_output_layout_ptr, "1", &tstyle);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws1_ptr);
+    wlmtk_root_add_workspace(root_ptr, ws1_ptr);
+    wlmtk_workspace_t *ws2_ptr = wlmtk_workspace_create(
+        wlr_output_layout_ptr, "2", &tstyle);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws2_ptr);
+    wlmtk_root_add_workspace(root_ptr, ws2_ptr);
+
+    // Pre-locking hides the workspace, and lifting it shows it again.
+    wlmtk_root_prelock(root_ptr, true);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_workspace_element(ws1_ptr)->visible);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_rectangle_element(root_ptr->curtain_rectangle_ptr)->visible);
+    wlmtk_root_prelock(root_ptr, false);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_workspace_element(ws1_ptr)->visible);
+    BS_TEST_VERIFY_FALSE(
+        test_ptr,
+        wlmtk_rectangle_element(root_ptr->curtain_rectangle_ptr)->visible);
+
+    // The lock takes over from the pre-lock: Lifting has no effect.
+    wlmtk_root_prelock(root_ptr, true);
+    wlmtk_fake_element_t *fe_ptr = wlmtk_fake_element_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fe_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_root_lock(root_ptr, &fe_ptr->element));
+    wlmtk_root_prelock(root_ptr, false);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_rectangle_element(root_ptr->curtain_rectangle_ptr)->visible);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_workspace_element(ws1_ptr)->visible);
+
+    // Switching workspaces while locked keeps them hidden.
+    wlmtk_root_switch_to_next_workspace(root_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, ws2_ptr, wlmtk_root_get_current_workspace(root_ptr));
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_workspace_element(ws1_ptr)->visible);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_workspace_element(ws2_ptr)->visible);
+
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_root_unlock(root_ptr, &fe_ptr->element));
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_workspace_element(ws1_ptr)->visible);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_workspace_element(ws2_ptr)->visible);
+    wlmtk_element_destroy(&fe_ptr->element);
+
+    wlmtk_root_remove_workspace(root_ptr, ws2_ptr);
+    wlmtk_workspace_destroy(ws2_ptr);
+    wlmtk_root_remove_workspace(root_ptr, ws1_ptr);
+    wlmtk_workspace_destroy(ws1_ptr);
+    wlmtk_root_destroy(root_ptr);
+    wlr_output_layout_destroy(wlr_output_layout_ptr);
+    wl_display_destroy(wl_display_ptr);
+    wlr_scene_node_destroy(&wlr_scene_ptr->tree.node);
+}
+
+
+/* ------------------------------------------------------------------------- */
+/** Swipes between workspaces: Tracks motion, and settles or switches. */
+void test_swipe(bs_test_t *test_ptr)
+{
+    struct wlr_scene *wlr_scene_ptr = wlr_scene_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_scene_ptr);
+    struct wl_display *wl_display_ptr = wl_display_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_display_ptr);
+    struct wlr_output_layout *wlr_output_layout_ptr =
+        wlr_output_layout_create(wl_display_ptr);
+    wlmtk_root_t *root_ptr = wlmtk_root_create(
+        wlr_scene_ptr, wlr_output_layout_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, root_ptr);
+    root_ptr->extents.width = 100;
+
+    static const wlmtk_tile_style_t tstyle = {};
+    wlmtk_workspace_t *ws_ptrs[3];
+    for (size_t i = 0; i < 3; ++i) {
+        ws_ptrs[i] = wlmtk_workspace_create(
+            wlr_output_layout_ptr, "ws", &tstyle);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws_ptrs[i]);
+        wlmtk_root_add_workspace(root_ptr, ws_ptrs[i]);
+    }
+    wlmtk_element_t *e1_ptr = wlmtk_workspace_element(ws_ptrs[0]);
+    wlmtk_element_t *e2_ptr = wlmtk_workspace_element(ws_ptrs[1]);
+    wlmtk_element_t *e3_ptr = wlmtk_workspace_element(ws_ptrs[2]);
+
+    // Moving left reveals the next workspace, on the right.
+    wlmtk_root_swipe_begin(root_ptr, 0);
+    wlmtk_root_swipe_update(root_ptr, -30, 10);
+    BS_TEST_VERIFY_EQ(test_ptr, -30, e1_ptr->wlr_scene_node_ptr->x);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, e1_ptr->x);
+    BS_TEST_VERIFY_TRUE(test_ptr, e2_ptr->visible);
+    BS_TEST_VERIFY_EQ(test_ptr, 70, e2_ptr->wlr_scene_node_ptr->x);
+
+    // Reversing reveals the previous one instead.
+    wlmtk_root_swipe_update(root_ptr, 60, 20);
+    BS_TEST_VERIFY_EQ(test_ptr, 30, e1_ptr->wlr_scene_node_ptr->x);
+    BS_TEST_VERIFY_FALSE(test_ptr, e2_ptr->visible);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, e2_ptr->wlr_scene_node_ptr->x);
+    BS_TEST_VERIFY_TRUE(test_ptr, e3_ptr->visible);
+    BS_TEST_VERIFY_EQ(test_ptr, -70, e3_ptr->wlr_scene_node_ptr->x);
+
+    // Released after a pause, less than half-way: Returns.
+    wlmtk_root_swipe_end(root_ptr, 200, false);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, ws_ptrs[0], wlmtk_root_get_current_workspace(root_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, e1_ptr->wlr_scene_node_ptr->x);
+    BS_TEST_VERIFY_FALSE(test_ptr, e3_ptr->visible);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, e3_ptr->wlr_scene_node_ptr->x);
+
+    // More than half-way: Switches.
+    wlmtk_root_swipe_begin(root_ptr, 300);
+    wlmtk_root_swipe_update(root_ptr, -80, 310);
+    wlmtk_root_swipe_end(root_ptr, 320, false);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, ws_ptrs[1], wlmtk_root_get_current_workspace(root_ptr));
+    BS_TEST_VERIFY_FALSE(test_ptr, e1_ptr->visible);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, e1_ptr->wlr_scene_node_ptr->x);
+    BS_TEST_VERIFY_TRUE(test_ptr, e2_ptr->visible);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, e2_ptr->wlr_scene_node_ptr->x);
+
+    // A short, quick flick switches as well. Unless cancelled.
+    wlmtk_root_swipe_begin(root_ptr, 400);
+    wlmtk_root_swipe_update(root_ptr, -10, 405);
+    wlmtk_root_swipe_update(root_ptr, -10, 410);
+    wlmtk_root_swipe_end(root_ptr, 410, true);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, ws_ptrs[1], wlmtk_root_get_current_workspace(root_ptr));
+    wlmtk_root_swipe_begin(root_ptr, 500);
+    wlmtk_root_swipe_update(root_ptr, -10, 505);
+    wlmtk_root_swipe_update(root_ptr, -10, 510);
+    wlmtk_root_swipe_end(root_ptr, 510, false);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, ws_ptrs[2], wlmtk_root_get_current_workspace(root_ptr));
+
+    // A switch from elsewhere ends the swipe.
+    wlmtk_root_swipe_begin(root_ptr, 600);
+    wlmtk_root_swipe_update(root_ptr, 40, 610);
+    BS_TEST_VERIFY_TRUE(test_ptr, e2_ptr->visible);
+    wlmtk_root_switch_to_workspace(root_ptr, 0);
+    BS_TEST_VERIFY_FALSE(test_ptr, root_ptr->swipe.active);
+    BS_TEST_VERIFY_FALSE(test_ptr, e2_ptr->visible);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, e2_ptr->wlr_scene_node_ptr->x);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, e3_ptr->wlr_scene_node_ptr->x);
+
+    for (size_t i = 0; i < 3; ++i) {
+        wlmtk_root_remove_workspace(root_ptr, ws_ptrs[i]);
+        wlmtk_workspace_destroy(ws_ptrs[i]);
+    }
+    wlmtk_root_destroy(root_ptr);
+    wlr_output_layout_destroy(wlr_output_layout_ptr);
+    wl_display_destroy(wl_display_ptr);
+    wlr_scene_node_destroy(&wlr_scene_ptr->tree.node);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Callback for @ref wlmtk_window_group_for_each: Unmaps the window. */
+static void _test_window_groups_unmap(wlmtk_window_t *window_ptr, void *ud_ptr)
+{
+    size_t *calls_ptr = ud_ptr;
+    ++*calls_ptr;
+    wlmtk_workspace_unmap_window(
+        wlmtk_window_get_workspace(window_ptr), window_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests that windows are grouped by client, as they get (un)mapped. */
+void test_window_groups(bs_test_t *test_ptr)
+{
+    struct wl_display *wl_display_ptr = wl_display_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_display_ptr);
+    struct wlr_output_layout *wlr_output_layout_ptr =
+        wlr_output_layout_create(wl_display_ptr);
+    wlmtk_root_t *root_ptr = wlmtk_root_create(NULL, wlr_output_layout_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, root_ptr);
+    static const wlmtk_tile_style_t tstyle = {};
+    wlmtk_workspace_t *ws1_ptr = wlmtk_workspace_create(
+        wlr_output_layout_ptr, "1", &tstyle);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_root_add_workspace(root_ptr, ws1_ptr));
+    wlmtk_workspace_t *ws2_ptr = wlmtk_workspace_create(
+        wlr_output_layout_ptr, "2", &tstyle);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_root_add_workspace(root_ptr, ws2_ptr));
+
+    // Two windows of client 42, on different workspaces. One of client 0.
+    wlmtk_fake_window_t *fw1_ptr = wlmtk_fake_window_create();
+    fw1_ptr->fake_content_ptr->content.client.pid = 42;
+    wlmtk_fake_window_t *fw2_ptr = wlmtk_fake_window_create();
+    fw2_ptr->fake_content_ptr->content.client.pid = 42;
+    wlmtk_fake_window_t *fw3_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL, wlmtk_root_get_window_group(root_ptr, 42));
+    wlmtk_workspace_map_window(ws1_ptr, fw1_ptr->window_ptr);
+    wlmtk_workspace_map_window(ws2_ptr, fw2_ptr->window_ptr);
+    wlmtk_workspace_map_window(ws1_ptr, fw3_ptr->window_ptr);
+
+    wlmtk_window_group_t *g_ptr = wlmtk_root_get_window_group(root_ptr, 42);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, g_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, wlmtk_window_group_size(g_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, g_ptr, wlmtk_window_get_group(
+                          fw2_ptr->window_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, wlmtk_window_get_group(
+                          fw3_ptr->window_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL, wlmtk_root_get_window_group(root_ptr, 0));
+
+    // Moving to another workspace keeps the window in the group.
+    wlmtk_workspace_unmap_window(ws2_ptr, fw2_ptr->window_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmtk_window_group_size(g_ptr));
+    wlmtk_workspace_map_window(ws1_ptr, fw2_ptr->window_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, wlmtk_window_group_size(g_ptr));
+
+    // Unmapping all from the group's iteration. Then, the group is gone.
+    size_t calls = 0;
+    wlmtk_window_group_for_each(g_ptr, _test_window_groups_unmap, &calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, calls);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL, wlmtk_root_get_window_group(root_ptr, 42));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, wlmtk_window_get_group(
+                          fw1_ptr->window_ptr));
+
+    wlmtk_workspace_unmap_window(ws1_ptr, fw3_ptr->window_ptr);
+    wlmtk_fake_window_destroy(fw3_ptr);
+    wlmtk_fake_window_destroy(fw2_ptr);
+    wlmtk_fake_window_destroy(fw1_ptr);
+    wlmtk_root_destroy(root_ptr);
+    wlr_output_layout_destroy(wlr_output_layout_ptr);
+    wl_display_destroy(wl_display_ptr);
+}
+
 /* == End of root.c ======================================================== */
@@ -19,8 +19,42 @@
  */
 
 #include <libbase/libbase.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
 #include <toolkit/style.h>
 
+/* == Declarations ========================================================= */
+
+/** Key of an interned style: Its contents. */
+typedef struct {
+    /** Points to the style's contents. */
+    const void                *data_ptr;
+    /** Size of the style, in bytes. */
+    size_t                    size;
+} _wlmtk_style_key_t;
+
+/** An interned style. */
+typedef struct {
+    /** Node of @ref _wlmtk_style_tree_ptr. */
+    bs_avltree_node_t         avlnode;
+    /** The key. `data_ptr` points to `data`. */
+    _wlmtk_style_key_t        key;
+    /** Number of references held on the style. */
+    int                       references;
+    /** The style's contents. Aligned for any of the style structs. */
+    max_align_t               data[];
+} _wlmtk_style_interned_t;
+
+static int _wlmtk_style_interned_cmp(
+    const bs_avltree_node_t *avlnode_ptr,
+    const void *key_ptr);
+
+/* == Data ================================================================= */
+
+/** Interned styles, by @ref _wlmtk_style_key_t. Created on first use. */
+static bs_avltree_t *_wlmtk_style_tree_ptr = NULL;
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -37,4 +71,114 @@ cairo_font_weight_t wlmtk_style_font_weight_cairo_from_wlmtk(
     return CAIRO_FONT_WEIGHT_NORMAL;
 }
 
+/* ------------------------------------------------------------------------- */
+const void *wlmtk_style_intern(const void *style_ptr, size_t size)
+{
+    if (NULL == _wlmtk_style_tree_ptr) {
+        _wlmtk_style_tree_ptr = bs_avltree_create(
+            _wlmtk_style_interned_cmp, NULL);
+        if (NULL == _wlmtk_style_tree_ptr) return NULL;
+    }
+
+    _wlmtk_style_key_t key = { .data_ptr = style_ptr, .size = size };
+    bs_avltree_node_t *avlnode_ptr = bs_avltree_lookup(
+        _wlmtk_style_tree_ptr, &key);
+    if (NULL != avlnode_ptr) {
+        _wlmtk_style_interned_t *interned_ptr = BS_CONTAINER_OF(
+            avlnode_ptr, _wlmtk_style_interned_t, avlnode);
+        ++interned_ptr->references;
+        return interned_ptr->data;
+    }
+
+    _wlmtk_style_interned_t *interned_ptr = logged_calloc(
+        1, sizeof(_wlmtk_style_interned_t) + size);
+    if (NULL == interned_ptr) return NULL;
+    memcpy(interned_ptr->data, style_ptr, size);
+    interned_ptr->key.data_ptr = interned_ptr->data;
+    interned_ptr->key.size = size;
+    interned_ptr->references = 1;
+    BS_ASSERT(bs_avltree_insert(
+                  _wlmtk_style_tree_ptr, &interned_ptr->key,
+                  &interned_ptr->avlnode, false));
+    return interned_ptr->data;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_style_release(const void *interned_ptr)
+{
+    _wlmtk_style_interned_t *i_ptr = (_wlmtk_style_interned_t*)(
+        (const char*)interned_ptr - offsetof(_wlmtk_style_interned_t, data));
+    if (0 < --i_ptr->references) return;
+
+    bs_avltree_delete(_wlmtk_style_tree_ptr, &i_ptr->key);
+    free(i_ptr);
+
+    if (0 == bs_avltree_size(_wlmtk_style_tree_ptr)) {
+        bs_avltree_destroy(_wlmtk_style_tree_ptr);
+        _wlmtk_style_tree_ptr = NULL;
+    }
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Compares @ref _wlmtk_style_interned_t against a @ref _wlmtk_style_key_t. */
+int _wlmtk_style_interned_cmp(
+    const bs_avltree_node_t *avlnode_ptr,
+    const void *key_ptr)
+{
+    const _wlmtk_style_key_t *k1_ptr = &BS_CONTAINER_OF(
+        avlnode_ptr, _wlmtk_style_interned_t, avlnode)->key;
+    const _wlmtk_style_key_t *k2_ptr = key_ptr;
+    if (k1_ptr->size != k2_ptr->size) {
+        return k1_ptr->size < k2_ptr->size ? -1 : 1;
+    }
+    return memcmp(k1_ptr->data_ptr, k2_ptr->data_ptr, k1_ptr->size);
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_intern(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_style_test_cases[] = {
+    { 1, "intern", test_intern },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Tests @ref wlmtk_style_intern: Identical styles share a pointer. */
+void test_intern(bs_test_t *test_ptr)
+{
+    // Contents are compared bytewise, so clear the padding.
+    wlmtk_margin_style_t m1, m2, m3;
+    memset(&m1, 0, sizeof(m1));
+    m1.width = 2;
+    m1.color = 0xff102030;
+    memcpy(&m2, &m1, sizeof(m2));
+    memcpy(&m3, &m1, sizeof(m3));
+    m3.width = 3;
+
+    const wlmtk_margin_style_t *i1_ptr = WLMTK_STYLE_INTERN(&m1);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, i1_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, &m1, i1_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, i1_ptr->width);
+
+    const wlmtk_margin_style_t *i2_ptr = WLMTK_STYLE_INTERN(&m2);
+    BS_TEST_VERIFY_EQ(test_ptr, i1_ptr, i2_ptr);
+    const wlmtk_margin_style_t *i3_ptr = WLMTK_STYLE_INTERN(&m3);
+    BS_TEST_VERIFY_NEQ(test_ptr, i1_ptr, i3_ptr);
+
+    // Modifying the source doesn't affect the interned style.
+    m1.width = 3;
+    BS_TEST_VERIFY_EQ(test_ptr, 2, i1_ptr->width);
+
+    // Released on last reference; the tree is dropped when empty.
+    wlmtk_style_release(i1_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, i2_ptr, WLMTK_STYLE_INTERN(&m2));
+    wlmtk_style_release(i2_ptr);
+    wlmtk_style_release(i2_ptr);
+    wlmtk_style_release(i3_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, _wlmtk_style_tree_ptr);
+}
+
 /* == End of style.c ======================================================= */
@@ -21,6 +21,7 @@
 #include "surface.h"
 
 #include <libbase/libbase.h>
+#include <pixman.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <wayland-server-protocol.h>
@@ -38,6 +39,7 @@
 #include "container.h"
 #include "gfxbuf.h"  // IWYU pragma: keep
 #include "input.h"
+#include "trace.h"
 #include "util.h"
 
 /* == Declarations ========================================================= */
@@ -156,6 +158,21 @@ void wlmtk_surface_get_size(
     if (NULL != height_ptr) *height_ptr = surface_ptr->committed_height;
 }
 
+/* ------------------------------------------------------------------------- */
+bool wlmtk_surface_is_opaque(wlmtk_surface_t *surface_ptr)
+{
+    struct wlr_surface *wlr_surface_ptr = surface_ptr->wlr_surface_ptr;
+    if (NULL == wlr_surface_ptr) return false;
+    if (0 >= wlr_surface_ptr->current.width ||
+        0 >= wlr_surface_ptr->current.height) return false;
+
+    pixman_box32_t box = {
+        .x2 = wlr_surface_ptr->current.width,
+        .y2 = wlr_surface_ptr->current.height };
+    return PIXMAN_REGION_IN == pixman_region32_contains_rectangle(
+        &wlr_surface_ptr->opaque_region, &box);
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmtk_surface_set_activated(
     wlmtk_surface_t *surface_ptr,
@@ -243,6 +260,7 @@ bool _wlmtk_surface_init(
     }
     surface_ptr->orig_super_element_vmt = wlmtk_element_extend(
         &surface_ptr->super_element, &surface_element_vmt);
+    surface_ptr->super_element.type = WLMTK_ELEMENT_SURFACE;
     wlmtk_util_connect_listener_signal(
         &surface_ptr->super_element.events.pointer_leave,
         &surface_ptr->element_pointer_leave_listener,
@@ -417,43 +435,33 @@ bool _wlmtk_surface_element_pointer_motion(
     surface_ptr->orig_super_element_vmt.pointer_motion(
         element_ptr, motion_event_ptr);
 
-    if (NULL == surface_ptr->super_element.wlr_scene_node_ptr) return false;
-
-    // Get the layout local coordinates of the node, so we can adjust the
-    // node-local (x, y) for the `wlr_scene_node_at` call.
-    int lx, ly;
-    if (!wlr_scene_node_coords(
-            surface_ptr->super_element.wlr_scene_node_ptr, &lx, &ly)) {
-        return false;
-    }
-    // Get the node below the cursor. Return if there's no buffer node.
-    double node_x, node_y;
-    struct wlr_scene_node *wlr_scene_node_ptr = wlr_scene_node_at(
-        surface_ptr->super_element.wlr_scene_node_ptr,
-        motion_event_ptr->x + lx,
-        motion_event_ptr->y + ly,
-        &node_x,
-        &node_y);
-
-    if (NULL == wlr_scene_node_ptr ||
-        WLR_SCENE_NODE_BUFFER != wlr_scene_node_ptr->type) {
-        return false;
-    }
-
-    struct wlr_scene_buffer *wlr_scene_buffer_ptr =
-        wlr_scene_buffer_from_node(wlr_scene_node_ptr);
-    struct wlr_scene_surface *wlr_scene_surface_ptr =
-        wlr_scene_surface_try_from_buffer(wlr_scene_buffer_ptr);
-    if (NULL == wlr_scene_surface_ptr) {
-        return true;
+    if (NULL == surface_ptr->super_element.wlr_scene_node_ptr ||
+        !surface_ptr->super_element.wlr_scene_node_ptr->enabled ||
+        NULL == surface_ptr->wlr_surface_ptr) return false;
+
+    // The subsurface tree is placed at the element's origin, so the element
+    // coordinates are local to the root surface. Look up the (sub)surface
+    // directly in the surface tree, rather than walking the scene graph for
+    // the layout coordinates, and then again for the node. Most surfaces do
+    // not have subsurfaces: These only need to check their input region.
+    struct wlr_surface *wlr_surface_ptr = surface_ptr->wlr_surface_ptr;
+    double node_x = motion_event_ptr->x, node_y = motion_event_ptr->y;
+    if (wl_list_empty(&wlr_surface_ptr->current.subsurfaces_below) &&
+        wl_list_empty(&wlr_surface_ptr->current.subsurfaces_above)) {
+        if (!wlr_surface_point_accepts_input(
+                wlr_surface_ptr, node_x, node_y)) return false;
+    } else {
+        wlr_surface_ptr = wlr_surface_surface_at(
+            surface_ptr->wlr_surface_ptr,
+            motion_event_ptr->x, motion_event_ptr->y,
+            &node_x, &node_y);
+        if (NULL == wlr_surface_ptr) return false;
     }
 
-    BS_ASSERT(surface_ptr->wlr_surface_ptr ==
-              wlr_surface_get_root_surface(wlr_scene_surface_ptr->surface));
     if (NULL != surface_ptr->wlr_seat_ptr) {
         wlr_seat_pointer_notify_enter(
             surface_ptr->wlr_seat_ptr,
-            wlr_scene_surface_ptr->surface,
+            wlr_surface_ptr,
             node_x, node_y);
         wlr_seat_pointer_notify_motion(
             surface_ptr->wlr_seat_ptr,
@@ -627,9 +635,13 @@ void _wlmtk_surface_handle_surface_commit(
     struct wl_listener *listener_ptr,
     __UNUSED__ void *data_ptr)
 {
+    WLMTK_TRACE_SPAN("surface_commit");
     wlmtk_surface_t *surface_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmtk_surface_t, surface_commit_listener);
 
+    // The surface-local size: A `wp_viewport` destination size, if set.
+    // Otherwise the buffer's size, divided by its scale. Hit testing uses
+    // the same through wlr_surface_point_accepts_input().
     _wlmtk_surface_commit_size(
         surface_ptr,
         surface_ptr->wlr_surface_ptr->current.width,
@@ -713,6 +725,9 @@ void _wlmtk_surface_commit_size(
         surface_ptr->committed_height != height) {
         surface_ptr->committed_width = width;
         surface_ptr->committed_height = height;
+        surface_ptr->super_element.leaf_width = width;
+        surface_ptr->super_element.leaf_height = height;
+        wlmtk_element_invalidate_extents(&surface_ptr->super_element);
     }
 
     if (NULL != surface_ptr->super_element.parent_container_ptr) {
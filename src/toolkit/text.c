@@ -0,0 +1,652 @@
+/* ========================================================================= */
+/**
+ * @file text.c
+ *
+ * @copyright
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "text.h"
+
+#include <inttypes.h>
+#include <libbase/libbase.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* == Declarations ========================================================= */
+
+/** A resolved font: Face, weight and size. */
+typedef struct {
+    /** Node in @ref wlmtk_text_cache_t::fonts. */
+    bs_dllist_node_t          dlnode;
+    /** The style this font was resolved from. */
+    wlmtk_style_font_t        style;
+    /** The font, as resolved by cairo. */
+    cairo_scaled_font_t       *scaled_font_ptr;
+    /** Number of runs referencing this font. */
+    size_t                    runs;
+    /** Whether the font is in @ref wlmtk_text_cache_t::fonts. */
+    bool                      cached;
+} wlmtk_text_font_t;
+
+/** A string, shaped into glyphs of a font. */
+typedef struct {
+    /** Node in @ref wlmtk_text_cache_t::runs. */
+    bs_dllist_node_t          dlnode;
+    /** Font the glyphs refer to. */
+    wlmtk_text_font_t         *font_ptr;
+    /** Hash of `text_ptr`. */
+    uint64_t                  hash;
+    /** The string. */
+    char                      *text_ptr;
+    /** Glyphs, positioned relative to the origin. */
+    cairo_glyph_t             *glyphs_ptr;
+    /** Number of glyphs at `glyphs_ptr`. */
+    int                       num_glyphs;
+    /** Extents of the glyphs. */
+    cairo_text_extents_t      extents;
+    /** Number of draws using the run outside the lock. */
+    size_t                    pins;
+    /** Whether the run is in @ref wlmtk_text_cache_t::runs. */
+    bool                      cached;
+} wlmtk_text_run_t;
+
+/** State of the text cache. */
+typedef struct {
+    /** Guards the cache: Text is also drawn on rasterizer threads. */
+    pthread_mutex_t           mutex;
+    /** Fonts, most recently used first. */
+    bs_dllist_t               fonts;
+    /** Runs, most recently used first. */
+    bs_dllist_t               runs;
+    /** Statistics. */
+    wlmtk_text_stats_t        stats;
+} wlmtk_text_cache_t;
+
+static wlmtk_text_run_t *_wlmtk_text_run_acquire(
+    const wlmtk_style_font_t *font_style_ptr,
+    const char *text_ptr);
+static void _wlmtk_text_run_release(wlmtk_text_run_t *run_ptr);
+static wlmtk_text_run_t *_wlmtk_text_run_get(
+    const wlmtk_style_font_t *font_style_ptr,
+    const char *text_ptr);
+static void _wlmtk_text_run_uncache(wlmtk_text_run_t *run_ptr);
+static wlmtk_text_run_t *_wlmtk_text_run_create(
+    wlmtk_text_font_t *font_ptr,
+    uint64_t hash,
+    const char *text_ptr);
+static void _wlmtk_text_run_destroy(wlmtk_text_run_t *run_ptr);
+static size_t _wlmtk_text_run_bytes(const wlmtk_text_run_t *run_ptr);
+static wlmtk_text_font_t *_wlmtk_text_font_get(
+    const wlmtk_style_font_t *font_style_ptr);
+static void _wlmtk_text_font_destroy(wlmtk_text_font_t *font_ptr);
+static bool _wlmtk_text_font_style_equals(
+    const wlmtk_style_font_t *a_ptr,
+    const wlmtk_style_font_t *b_ptr);
+static uint64_t _wlmtk_text_hash(const char *text_ptr);
+
+/* == Data ================================================================= */
+
+/** The text cache. */
+static wlmtk_text_cache_t     _wlmtk_text_cache = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER
+};
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_text_draw(
+    cairo_t *cairo_ptr,
+    double x,
+    double y,
+    const wlmtk_style_font_t *font_style_ptr,
+    uint32_t color,
+    const char *text_ptr)
+{
+    // Draws without holding the lock: The pinned run outlives eviction.
+    wlmtk_text_run_t *run_ptr = _wlmtk_text_run_acquire(
+        font_style_ptr, text_ptr);
+    if (NULL == run_ptr) return false;
+
+    cairo_save(cairo_ptr);
+    cairo_set_scaled_font(cairo_ptr, run_ptr->font_ptr->scaled_font_ptr);
+    cairo_set_source_argb8888(cairo_ptr, color);
+    cairo_translate(cairo_ptr, x, y);
+    cairo_show_glyphs(cairo_ptr, run_ptr->glyphs_ptr, run_ptr->num_glyphs);
+    cairo_restore(cairo_ptr);
+    _wlmtk_text_run_release(run_ptr);
+    return CAIRO_STATUS_SUCCESS == cairo_status(cairo_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_text_extents(
+    const wlmtk_style_font_t *font_style_ptr,
+    const char *text_ptr,
+    cairo_text_extents_t *extents_ptr)
+{
+    pthread_mutex_lock(&_wlmtk_text_cache.mutex);
+    wlmtk_text_run_t *run_ptr = _wlmtk_text_run_get(font_style_ptr, text_ptr);
+    if (NULL != run_ptr) *extents_ptr = run_ptr->extents;
+    pthread_mutex_unlock(&_wlmtk_text_cache.mutex);
+    return NULL != run_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_text_flush(void)
+{
+    pthread_mutex_lock(&_wlmtk_text_cache.mutex);
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                        &_wlmtk_text_cache.runs))) {
+        _wlmtk_text_run_uncache(
+            BS_CONTAINER_OF(dlnode_ptr, wlmtk_text_run_t, dlnode));
+    }
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                        &_wlmtk_text_cache.fonts))) {
+        wlmtk_text_font_t *font_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_text_font_t, dlnode);
+        font_ptr->cached = false;
+        // A pinned run destroys its font once released.
+        if (0 == font_ptr->runs) _wlmtk_text_font_destroy(font_ptr);
+    }
+    _wlmtk_text_cache.stats.runs = 0;
+    _wlmtk_text_cache.stats.fonts = 0;
+    pthread_mutex_unlock(&_wlmtk_text_cache.mutex);
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_text_evict(unsigned percent)
+{
+    pthread_mutex_lock(&_wlmtk_text_cache.mutex);
+    size_t runs = _wlmtk_text_cache.stats.runs * BS_MIN(percent, 100u) / 100;
+    size_t bytes = 0;
+    for (; 0 < runs; --runs) {
+        bs_dllist_node_t *dlnode_ptr = _wlmtk_text_cache.runs.tail_ptr;
+        bs_dllist_remove(&_wlmtk_text_cache.runs, dlnode_ptr);
+        wlmtk_text_run_t *run_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_text_run_t, dlnode);
+        bytes += _wlmtk_text_run_bytes(run_ptr);
+        _wlmtk_text_run_uncache(run_ptr);
+        _wlmtk_text_cache.stats.runs--;
+        _wlmtk_text_cache.stats.evictions++;
+    }
+    pthread_mutex_unlock(&_wlmtk_text_cache.mutex);
+    return bytes;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_text_get_stats(wlmtk_text_stats_t *stats_ptr)
+{
+    pthread_mutex_lock(&_wlmtk_text_cache.mutex);
+    *stats_ptr = _wlmtk_text_cache.stats;
+    pthread_mutex_unlock(&_wlmtk_text_cache.mutex);
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the run for `text_ptr` in the given font, pinned. Takes the lock.
+ *
+ * @param font_style_ptr
+ * @param text_ptr
+ *
+ * @return The run, or NULL on error. It stays valid without holding the
+ *     lock, even when evicted, until @ref _wlmtk_text_run_release.
+ */
+wlmtk_text_run_t *_wlmtk_text_run_acquire(
+    const wlmtk_style_font_t *font_style_ptr,
+    const char *text_ptr)
+{
+    pthread_mutex_lock(&_wlmtk_text_cache.mutex);
+    wlmtk_text_run_t *run_ptr = _wlmtk_text_run_get(font_style_ptr, text_ptr);
+    if (NULL != run_ptr) run_ptr->pins++;
+    pthread_mutex_unlock(&_wlmtk_text_cache.mutex);
+    return run_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Unpins a run from @ref _wlmtk_text_run_acquire. Takes the lock. Destroys
+ * the run if it was evicted meanwhile, and this was the last pin.
+ *
+ * @param run_ptr
+ */
+void _wlmtk_text_run_release(wlmtk_text_run_t *run_ptr)
+{
+    pthread_mutex_lock(&_wlmtk_text_cache.mutex);
+    run_ptr->pins--;
+    if (0 == run_ptr->pins && !run_ptr->cached) {
+        _wlmtk_text_run_destroy(run_ptr);
+    }
+    pthread_mutex_unlock(&_wlmtk_text_cache.mutex);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the run for `text_ptr` in the given font. Looks it up in the
+ * cache, or shapes it and evicts the least recently used run if the cache
+ * exceeds @ref WLMTK_TEXT_MAX_RUNS.
+ *
+ * @param font_style_ptr
+ * @param text_ptr
+ *
+ * @return The run, or NULL on error. The run remains owned by the cache,
+ *     and is valid while holding the lock, or while pinned.
+ */
+wlmtk_text_run_t *_wlmtk_text_run_get(
+    const wlmtk_style_font_t *font_style_ptr,
+    const char *text_ptr)
+{
+    uint64_t hash = _wlmtk_text_hash(text_ptr);
+    for (bs_dllist_node_t *dlnode_ptr = _wlmtk_text_cache.runs.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_text_run_t *run_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_text_run_t, dlnode);
+        if (hash == run_ptr->hash &&
+            0 == strcmp(text_ptr, run_ptr->text_ptr) &&
+            _wlmtk_text_font_style_equals(
+                font_style_ptr, &run_ptr->font_ptr->style)) {
+            bs_dllist_remove(&_wlmtk_text_cache.runs, dlnode_ptr);
+            bs_dllist_push_front(&_wlmtk_text_cache.runs, dlnode_ptr);
+            _wlmtk_text_cache.stats.hits++;
+            return run_ptr;
+        }
+    }
+
+    wlmtk_text_font_t *font_ptr = _wlmtk_text_font_get(font_style_ptr);
+    if (NULL == font_ptr) return NULL;
+    wlmtk_text_run_t *run_ptr = _wlmtk_text_run_create(
+        font_ptr, hash, text_ptr);
+    if (NULL == run_ptr) return NULL;
+    _wlmtk_text_cache.stats.misses++;
+
+    bs_dllist_push_front(&_wlmtk_text_cache.runs, &run_ptr->dlnode);
+    run_ptr->cached = true;
+    _wlmtk_text_cache.stats.runs++;
+    while (WLMTK_TEXT_MAX_RUNS < _wlmtk_text_cache.stats.runs) {
+        bs_dllist_node_t *dlnode_ptr = _wlmtk_text_cache.runs.tail_ptr;
+        bs_dllist_remove(&_wlmtk_text_cache.runs, dlnode_ptr);
+        _wlmtk_text_run_uncache(
+            BS_CONTAINER_OF(dlnode_ptr, wlmtk_text_run_t, dlnode));
+        _wlmtk_text_cache.stats.runs--;
+        _wlmtk_text_cache.stats.evictions++;
+    }
+    return run_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Marks a run as out of the cache, and destroys it unless it is pinned.
+ * Expects the run to be removed from @ref wlmtk_text_cache_t::runs.
+ *
+ * @param run_ptr
+ */
+void _wlmtk_text_run_uncache(wlmtk_text_run_t *run_ptr)
+{
+    run_ptr->cached = false;
+    if (0 == run_ptr->pins) _wlmtk_text_run_destroy(run_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Shapes `text_ptr` into glyphs of `font_ptr`.
+ *
+ * @param font_ptr
+ * @param hash
+ * @param text_ptr
+ *
+ * @return The run, or NULL on error. Must be destroyed by calling
+ *     @ref _wlmtk_text_run_destroy.
+ */
+wlmtk_text_run_t *_wlmtk_text_run_create(
+    wlmtk_text_font_t *font_ptr,
+    uint64_t hash,
+    const char *text_ptr)
+{
+    wlmtk_text_run_t *run_ptr = logged_calloc(1, sizeof(wlmtk_text_run_t));
+    if (NULL == run_ptr) return NULL;
+    run_ptr->font_ptr = font_ptr;
+    font_ptr->runs++;
+    run_ptr->hash = hash;
+
+    run_ptr->text_ptr = logged_strdup(text_ptr);
+    if (NULL == run_ptr->text_ptr) {
+        _wlmtk_text_run_destroy(run_ptr);
+        return NULL;
+    }
+
+    cairo_status_t status = cairo_scaled_font_text_to_glyphs(
+        font_ptr->scaled_font_ptr, 0, 0, text_ptr, -1,
+        &run_ptr->glyphs_ptr, &run_ptr->num_glyphs,
+        NULL, NULL, NULL);
+    if (CAIRO_STATUS_SUCCESS != status) {
+        bs_log(BS_ERROR, "Failed cairo_scaled_font_text_to_glyphs(%p, "
+               "\"%s\"): %s", font_ptr->scaled_font_ptr, text_ptr,
+               cairo_status_to_string(status));
+        run_ptr->glyphs_ptr = NULL;
+        _wlmtk_text_run_destroy(run_ptr);
+        return NULL;
+    }
+    cairo_scaled_font_glyph_extents(
+        font_ptr->scaled_font_ptr,
+        run_ptr->glyphs_ptr, run_ptr->num_glyphs,
+        &run_ptr->extents);
+    return run_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Destroys the run. Destroys the font too, if it was the font's last run
+ * and the font is not in the cache.
+ *
+ * @param run_ptr
+ */
+void _wlmtk_text_run_destroy(wlmtk_text_run_t *run_ptr)
+{
+    if (NULL != run_ptr->glyphs_ptr) {
+        cairo_glyph_free(run_ptr->glyphs_ptr);
+        run_ptr->glyphs_ptr = NULL;
+    }
+    if (NULL != run_ptr->text_ptr) {
+        free(run_ptr->text_ptr);
+        run_ptr->text_ptr = NULL;
+    }
+    if (NULL != run_ptr->font_ptr) {
+        wlmtk_text_font_t *font_ptr = run_ptr->font_ptr;
+        font_ptr->runs--;
+        if (0 == font_ptr->runs && !font_ptr->cached) {
+            _wlmtk_text_font_destroy(font_ptr);
+        }
+        run_ptr->font_ptr = NULL;
+    }
+    free(run_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Bytes held by the run and its string and glyphs. */
+size_t _wlmtk_text_run_bytes(const wlmtk_text_run_t *run_ptr)
+{
+    return sizeof(wlmtk_text_run_t) + strlen(run_ptr->text_ptr) + 1 +
+        (size_t)run_ptr->num_glyphs * sizeof(cairo_glyph_t);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the font for `font_style_ptr`, resolving it if not cached yet.
+ *
+ * Fonts are resolved through a scratch image surface, so that they carry
+ * the same options as when selected on a gfxbuf-backed cairo context. If
+ * the cache exceeds @ref WLMTK_TEXT_MAX_FONTS, the least recently used
+ * font leaves the cache, and is destroyed once it isn't used by any run.
+ *
+ * @param font_style_ptr
+ *
+ * @return The font, or NULL on error.
+ */
+wlmtk_text_font_t *_wlmtk_text_font_get(
+    const wlmtk_style_font_t *font_style_ptr)
+{
+    for (bs_dllist_node_t *dlnode_ptr = _wlmtk_text_cache.fonts.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_text_font_t *font_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_text_font_t, dlnode);
+        if (_wlmtk_text_font_style_equals(font_style_ptr, &font_ptr->style)) {
+            bs_dllist_remove(&_wlmtk_text_cache.fonts, dlnode_ptr);
+            bs_dllist_push_front(&_wlmtk_text_cache.fonts, dlnode_ptr);
+            return font_ptr;
+        }
+    }
+
+    wlmtk_text_font_t *font_ptr = logged_calloc(1, sizeof(wlmtk_text_font_t));
+    if (NULL == font_ptr) return NULL;
+    font_ptr->style = *font_style_ptr;
+
+    cairo_surface_t *surface_ptr = cairo_image_surface_create(
+        CAIRO_FORMAT_ARGB32, 1, 1);
+    cairo_t *cairo_ptr = cairo_create(surface_ptr);
+    cairo_surface_destroy(surface_ptr);
+    cairo_select_font_face(
+        cairo_ptr,
+        font_style_ptr->face,
+        CAIRO_FONT_SLANT_NORMAL,
+        wlmtk_style_font_weight_cairo_from_wlmtk(font_style_ptr->weight));
+    cairo_set_font_size(cairo_ptr, font_style_ptr->size);
+    font_ptr->scaled_font_ptr = cairo_scaled_font_reference(
+        cairo_get_scaled_font(cairo_ptr));
+    cairo_destroy(cairo_ptr);
+    if (CAIRO_STATUS_SUCCESS != cairo_scaled_font_status(
+            font_ptr->scaled_font_ptr)) {
+        bs_log(BS_ERROR, "Failed to resolve font \"%s\", size %"PRIu64,
+               font_style_ptr->face, font_style_ptr->size);
+        _wlmtk_text_font_destroy(font_ptr);
+        return NULL;
+    }
+
+    bs_dllist_push_front(&_wlmtk_text_cache.fonts, &font_ptr->dlnode);
+    font_ptr->cached = true;
+    _wlmtk_text_cache.stats.fonts++;
+    if (WLMTK_TEXT_MAX_FONTS < _wlmtk_text_cache.stats.fonts) {
+        bs_dllist_node_t *dlnode_ptr = _wlmtk_text_cache.fonts.tail_ptr;
+        bs_dllist_remove(&_wlmtk_text_cache.fonts, dlnode_ptr);
+        _wlmtk_text_cache.stats.fonts--;
+        wlmtk_text_font_t *old_font_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_text_font_t, dlnode);
+        old_font_ptr->cached = false;
+        if (0 == old_font_ptr->runs) _wlmtk_text_font_destroy(old_font_ptr);
+    }
+    return font_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the font. Expects it to be out of the cache, and unused. */
+void _wlmtk_text_font_destroy(wlmtk_text_font_t *font_ptr)
+{
+    if (NULL != font_ptr->scaled_font_ptr) {
+        cairo_scaled_font_destroy(font_ptr->scaled_font_ptr);
+        font_ptr->scaled_font_ptr = NULL;
+    }
+    free(font_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Whether both font styles resolve to the same font. */
+bool _wlmtk_text_font_style_equals(
+    const wlmtk_style_font_t *a_ptr,
+    const wlmtk_style_font_t *b_ptr)
+{
+    return (a_ptr->size == b_ptr->size &&
+            a_ptr->weight == b_ptr->weight &&
+            0 == strncmp(a_ptr->face, b_ptr->face,
+                         WLMTK_STYLE_FONT_FACE_LENGTH));
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return The FNV-1a hash of `text_ptr`. */
+uint64_t _wlmtk_text_hash(const char *text_ptr)
+{
+    uint64_t hash = 0xcbf29ce484222325;
+    for (; *text_ptr; ++text_ptr) {
+        hash = (hash ^ (uint8_t)*text_ptr) * 0x100000001b3;
+    }
+    return hash;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_cache(bs_test_t *test_ptr);
+static void test_draw(bs_test_t *test_ptr);
+static void test_pin(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_text_test_cases[] = {
+    { 1, "cache", test_cache },
+    { 1, "draw", test_draw },
+    { 1, "pin", test_pin },
+    { 0, NULL, NULL }
+};
+
+/** Font style used in the tests. */
+static const wlmtk_style_font_t _wlmtk_text_test_font = {
+    .face = "Helvetica",
+    .weight = WLMTK_FONT_WEIGHT_BOLD,
+    .size = 15,
+};
+
+/* ------------------------------------------------------------------------- */
+/** Verifies runs and fonts are cached, counted and evicted. */
+void test_cache(bs_test_t *test_ptr)
+{
+    wlmtk_text_flush();
+    wlmtk_text_stats_t stats0, stats;
+    wlmtk_text_get_stats(&stats0);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, stats0.fonts);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, stats0.runs);
+
+    cairo_text_extents_t e1, e2;
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_text_extents(&_wlmtk_text_test_font, "Title", &e1));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_text_extents(&_wlmtk_text_test_font, "Title", &e2));
+    BS_TEST_VERIFY_TRUE(test_ptr, 0 < e1.x_advance);
+    BS_TEST_VERIFY_EQ(test_ptr, e1.x_advance, e2.x_advance);
+    wlmtk_text_get_stats(&stats);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats.fonts);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats.runs);
+    BS_TEST_VERIFY_EQ(test_ptr, stats0.hits + 1, stats.hits);
+    BS_TEST_VERIFY_EQ(test_ptr, stats0.misses + 1, stats.misses);
+
+    // A different weight is a different font.
+    wlmtk_style_font_t font = _wlmtk_text_test_font;
+    font.weight = WLMTK_FONT_WEIGHT_NORMAL;
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_text_extents(&font, "Title", &e2));
+    wlmtk_text_get_stats(&stats);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, stats.fonts);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, stats.runs);
+
+    // Exceed the limit of runs: The oldest ones get evicted.
+    for (int i = 0; i < WLMTK_TEXT_MAX_RUNS; ++i) {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%d", i);
+        BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_text_extents(&font, buf, &e2));
+    }
+    wlmtk_text_get_stats(&stats);
+    BS_TEST_VERIFY_EQ(test_ptr, WLMTK_TEXT_MAX_RUNS, stats.runs);
+    BS_TEST_VERIFY_EQ(test_ptr, stats0.evictions + 2, stats.evictions);
+
+    // Under memory pressure: Evicts half of the runs, keeps the fonts.
+    BS_TEST_VERIFY_TRUE(test_ptr, 0 < wlmtk_text_evict(50));
+    wlmtk_text_get_stats(&stats);
+    BS_TEST_VERIFY_EQ(test_ptr, WLMTK_TEXT_MAX_RUNS / 2, stats.runs);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, stats.fonts);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_text_evict(0));
+
+    wlmtk_text_flush();
+    wlmtk_text_get_stats(&stats);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, stats.fonts);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, stats.runs);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies drawing from the cache looks the same as cairo_show_text(). */
+void test_draw(bs_test_t *test_ptr)
+{
+    bs_gfxbuf_t *c_ptr = bs_gfxbuf_create(80, 22);
+    bs_gfxbuf_t *t_ptr = bs_gfxbuf_create(80, 22);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, c_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, t_ptr);
+
+    cairo_t *cairo_ptr = cairo_create_from_bs_gfxbuf(c_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, cairo_ptr);
+    cairo_select_font_face(
+        cairo_ptr, _wlmtk_text_test_font.face,
+        CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+    cairo_set_font_size(cairo_ptr, _wlmtk_text_test_font.size);
+    cairo_set_source_argb8888(cairo_ptr, 0xffc0d0e0);
+    cairo_move_to(cairo_ptr, 6, 17);
+    cairo_show_text(cairo_ptr, "Title");
+    cairo_destroy(cairo_ptr);
+
+    cairo_ptr = cairo_create_from_bs_gfxbuf(t_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, cairo_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_text_draw(
+            cairo_ptr, 6, 17, &_wlmtk_text_test_font, 0xffc0d0e0, "Title"));
+    // Again, now served from the cache.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_text_draw(
+            cairo_ptr, 6, 17, &_wlmtk_text_test_font, 0xffc0d0e0, "Title"));
+    cairo_destroy(cairo_ptr);
+
+    // The second draw blends over the first. Compare against a double draw.
+    cairo_ptr = cairo_create_from_bs_gfxbuf(c_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, cairo_ptr);
+    cairo_select_font_face(
+        cairo_ptr, _wlmtk_text_test_font.face,
+        CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+    cairo_set_font_size(cairo_ptr, _wlmtk_text_test_font.size);
+    cairo_set_source_argb8888(cairo_ptr, 0xffc0d0e0);
+    cairo_move_to(cairo_ptr, 6, 17);
+    cairo_show_text(cairo_ptr, "Title");
+    cairo_destroy(cairo_ptr);
+
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0, memcmp(
+            c_ptr->data_ptr, t_ptr->data_ptr,
+            c_ptr->pixels_per_line * c_ptr->height * sizeof(uint32_t)));
+
+    bs_gfxbuf_destroy(t_ptr);
+    bs_gfxbuf_destroy(c_ptr);
+    wlmtk_text_flush();
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies a pinned run, and its font, outlive their eviction. */
+void test_pin(bs_test_t *test_ptr)
+{
+    wlmtk_text_flush();
+    wlmtk_text_run_t *run_ptr = _wlmtk_text_run_acquire(
+        &_wlmtk_text_test_font, "Title");
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, run_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, run_ptr->cached);
+
+    // A lookup of the same text, while pinned, finds the same run.
+    wlmtk_text_run_t *run2_ptr = _wlmtk_text_run_acquire(
+        &_wlmtk_text_test_font, "Title");
+    BS_TEST_VERIFY_EQ(test_ptr, run_ptr, run2_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, run_ptr->pins);
+    _wlmtk_text_run_release(run2_ptr);
+
+    // Flushing leaves the pinned run intact, but out of the cache.
+    wlmtk_text_flush();
+    wlmtk_text_stats_t stats;
+    wlmtk_text_get_stats(&stats);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, stats.runs);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, stats.fonts);
+    BS_TEST_VERIFY_FALSE(test_ptr, run_ptr->cached);
+    BS_TEST_VERIFY_STREQ(test_ptr, "Title", run_ptr->text_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, run_ptr->font_ptr->runs);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, CAIRO_STATUS_SUCCESS,
+        cairo_scaled_font_status(run_ptr->font_ptr->scaled_font_ptr));
+
+    // Releasing the last pin destroys run and font. Checked by valgrind.
+    _wlmtk_text_run_release(run_ptr);
+}
+
+/* == End of text.c ======================================================== */
@@ -0,0 +1,482 @@
+/* ========================================================================= */
+/**
+ * @file thumbnail.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "thumbnail.h"
+
+#include <drm_fourcc.h>
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wayland-server-protocol.h>
+#define WLR_USE_UNSTABLE
+#include <wlr/render/allocator.h>
+#include <wlr/render/drm_format_set.h>
+#include <wlr/render/pass.h>
+#include <wlr/render/wlr_renderer.h>
+#include <wlr/render/wlr_texture.h>
+#include <wlr/types/wlr_buffer.h>
+#include <wlr/types/wlr_scene.h>
+#include <wlr/util/box.h>
+#undef WLR_USE_UNSTABLE
+
+#include "buffer.h"
+#include "container.h"
+#include "gfxbuf.h"
+
+/* == Declarations ========================================================= */
+
+/** State of a thumbnail. */
+struct _wlmtk_thumbnail_t {
+    /** The element to capture. */
+    wlmtk_element_t           *element_ptr;
+    /** Maximum width of the capture. */
+    int                       max_width;
+    /** Maximum height of the capture. */
+    int                       max_height;
+    /** The captured buffer, or NULL. */
+    struct wlr_buffer         *wlr_buffer_ptr;
+    /** Whether @ref wlmtk_thumbnail_t::wlr_buffer_ptr is stale. */
+    bool                      stale;
+};
+
+/** Renderer and allocator, see @ref wlmtk_thumbnail_set_renderer. */
+typedef struct {
+    /** The renderer. */
+    struct wlr_renderer       *wlr_renderer_ptr;
+    /** The allocator for captured buffers. */
+    struct wlr_allocator      *wlr_allocator_ptr;
+} _wlmtk_thumbnail_renderer_t;
+
+/** Context for the iterators over the element's scene buffers. */
+typedef struct {
+    /** Position of the captured node. Buffer positions are relative. */
+    int                       node_x;
+    /** Position of the captured node. Buffer positions are relative. */
+    int                       node_y;
+    /** Bounding box of the buffers, relative to the node. */
+    struct wlr_box            bounds;
+    /** Downscaling factor. */
+    double                    scale;
+    /** The render pass, while rendering. */
+    struct wlr_render_pass    *wlr_render_pass_ptr;
+    /** Textures created for the pass. Destroyed after submitting it. */
+    struct wlr_texture        **texture_ptrs;
+    /** Number of textures in @ref _wlmtk_thumbnail_ctx_t::texture_ptrs. */
+    size_t                    textures;
+    /** Capacity of @ref _wlmtk_thumbnail_ctx_t::texture_ptrs. */
+    size_t                    capacity;
+} _wlmtk_thumbnail_ctx_t;
+
+static struct wlr_box _wlmtk_thumbnail_buffer_box(
+    struct wlr_scene_buffer *wlr_scene_buffer_ptr,
+    int sx,
+    int sy,
+    _wlmtk_thumbnail_ctx_t *ctx_ptr);
+static void _wlmtk_thumbnail_add_bounds(
+    struct wlr_scene_buffer *wlr_scene_buffer_ptr,
+    int sx,
+    int sy,
+    void *ud_ptr);
+static void _wlmtk_thumbnail_render_buffer(
+    struct wlr_scene_buffer *wlr_scene_buffer_ptr,
+    int sx,
+    int sy,
+    void *ud_ptr);
+static struct wlr_texture *_wlmtk_thumbnail_texture(
+    _wlmtk_thumbnail_ctx_t *ctx_ptr,
+    struct wlr_buffer *wlr_buffer_ptr);
+static double _wlmtk_thumbnail_fit(
+    int width,
+    int height,
+    int max_width,
+    int max_height);
+
+/* == Data ================================================================= */
+
+/** The renderer and allocator. */
+static _wlmtk_thumbnail_renderer_t _wlmtk_thumbnail_renderer;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_thumbnail_set_renderer(
+    struct wlr_renderer *wlr_renderer_ptr,
+    struct wlr_allocator *wlr_allocator_ptr)
+{
+    _wlmtk_thumbnail_renderer.wlr_renderer_ptr = wlr_renderer_ptr;
+    _wlmtk_thumbnail_renderer.wlr_allocator_ptr = wlr_allocator_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+wlmtk_thumbnail_t *wlmtk_thumbnail_create(
+    wlmtk_element_t *element_ptr,
+    int max_width,
+    int max_height)
+{
+    wlmtk_thumbnail_t *thumbnail_ptr = logged_calloc(
+        1, sizeof(wlmtk_thumbnail_t));
+    if (NULL == thumbnail_ptr) return NULL;
+    thumbnail_ptr->element_ptr = element_ptr;
+    thumbnail_ptr->max_width = max_width;
+    thumbnail_ptr->max_height = max_height;
+    thumbnail_ptr->stale = true;
+    return thumbnail_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_thumbnail_destroy(wlmtk_thumbnail_t *thumbnail_ptr)
+{
+    if (NULL != thumbnail_ptr->wlr_buffer_ptr) {
+        wlr_buffer_drop(thumbnail_ptr->wlr_buffer_ptr);
+        thumbnail_ptr->wlr_buffer_ptr = NULL;
+    }
+    free(thumbnail_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_thumbnail_invalidate(wlmtk_thumbnail_t *thumbnail_ptr)
+{
+    thumbnail_ptr->stale = true;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_thumbnail_capture(wlmtk_thumbnail_t *thumbnail_ptr)
+{
+    if (!thumbnail_ptr->stale) return true;
+    _wlmtk_thumbnail_renderer_t *r_ptr = &_wlmtk_thumbnail_renderer;
+    struct wlr_scene_node *wlr_scene_node_ptr =
+        thumbnail_ptr->element_ptr->wlr_scene_node_ptr;
+    if (NULL == r_ptr->wlr_renderer_ptr ||
+        NULL == r_ptr->wlr_allocator_ptr ||
+        NULL == wlr_scene_node_ptr ||
+        !wlr_scene_node_ptr->enabled) return false;
+
+    // Iterated positions include the node's own position.
+    _wlmtk_thumbnail_ctx_t ctx = {
+        .node_x = wlr_scene_node_ptr->x,
+        .node_y = wlr_scene_node_ptr->y
+    };
+    wlr_scene_node_for_each_buffer(
+        wlr_scene_node_ptr, _wlmtk_thumbnail_add_bounds, &ctx);
+    if (wlr_box_empty(&ctx.bounds)) return false;
+    ctx.scale = _wlmtk_thumbnail_fit(
+        ctx.bounds.width, ctx.bounds.height,
+        thumbnail_ptr->max_width, thumbnail_ptr->max_height);
+    int width = BS_MAX(1, (int)(ctx.bounds.width * ctx.scale + 0.5));
+    int height = BS_MAX(1, (int)(ctx.bounds.height * ctx.scale + 0.5));
+
+    struct wlr_buffer *wlr_buffer_ptr = thumbnail_ptr->wlr_buffer_ptr;
+    if (NULL == wlr_buffer_ptr ||
+        wlr_buffer_ptr->width != width ||
+        wlr_buffer_ptr->height != height) {
+        uint64_t modifier = DRM_FORMAT_MOD_INVALID;
+        struct wlr_drm_format format = {
+            .format = DRM_FORMAT_ARGB8888,
+            .len = 1,
+            .capacity = 1,
+            .modifiers = &modifier
+        };
+        wlr_buffer_ptr = wlr_allocator_create_buffer(
+            r_ptr->wlr_allocator_ptr, width, height, &format);
+        if (NULL == wlr_buffer_ptr) {
+            bs_log(BS_WARNING, "Failed wlr_allocator_create_buffer(%p, %d, "
+                   "%d) for thumbnail %p", r_ptr->wlr_allocator_ptr,
+                   width, height, thumbnail_ptr);
+            return false;
+        }
+    }
+
+    ctx.wlr_render_pass_ptr = wlr_renderer_begin_buffer_pass(
+        r_ptr->wlr_renderer_ptr, wlr_buffer_ptr, NULL);
+    if (NULL == ctx.wlr_render_pass_ptr) {
+        bs_log(BS_WARNING, "Failed wlr_renderer_begin_buffer_pass(%p, %p)",
+               r_ptr->wlr_renderer_ptr, wlr_buffer_ptr);
+        if (wlr_buffer_ptr != thumbnail_ptr->wlr_buffer_ptr) {
+            wlr_buffer_drop(wlr_buffer_ptr);
+        }
+        return false;
+    }
+    wlr_render_pass_add_rect(
+        ctx.wlr_render_pass_ptr,
+        &(struct wlr_render_rect_options){
+            .box = { .width = width, .height = height },
+            .color = { .r = 0, .g = 0, .b = 0, .a = 0 },
+            .blend_mode = WLR_RENDER_BLEND_MODE_NONE });
+    wlr_scene_node_for_each_buffer(
+        wlr_scene_node_ptr, _wlmtk_thumbnail_render_buffer, &ctx);
+    bool rv = wlr_render_pass_submit(ctx.wlr_render_pass_ptr);
+    for (size_t i = 0; i < ctx.textures; ++i) {
+        wlr_texture_destroy(ctx.texture_ptrs[i]);
+    }
+    if (NULL != ctx.texture_ptrs) free(ctx.texture_ptrs);
+
+    if (wlr_buffer_ptr != thumbnail_ptr->wlr_buffer_ptr) {
+        if (NULL != thumbnail_ptr->wlr_buffer_ptr) {
+            wlr_buffer_drop(thumbnail_ptr->wlr_buffer_ptr);
+        }
+        thumbnail_ptr->wlr_buffer_ptr = wlr_buffer_ptr;
+    }
+    if (!rv) {
+        bs_log(BS_WARNING, "Failed wlr_render_pass_submit() for thumbnail %p",
+               thumbnail_ptr);
+        return false;
+    }
+    thumbnail_ptr->stale = false;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+struct wlr_buffer *wlmtk_thumbnail_buffer(wlmtk_thumbnail_t *thumbnail_ptr)
+{
+    return thumbnail_ptr->wlr_buffer_ptr;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes the box of a scene buffer, relative to the captured node.
+ *
+ * @param wlr_scene_buffer_ptr
+ * @param sx
+ * @param sy
+ * @param ctx_ptr
+ *
+ * @return The box. Empty, if the scene buffer has no buffer.
+ */
+struct wlr_box _wlmtk_thumbnail_buffer_box(
+    struct wlr_scene_buffer *wlr_scene_buffer_ptr,
+    int sx,
+    int sy,
+    _wlmtk_thumbnail_ctx_t *ctx_ptr)
+{
+    struct wlr_box box = {
+        .x = sx - ctx_ptr->node_x,
+        .y = sy - ctx_ptr->node_y,
+        .width = wlr_scene_buffer_ptr->dst_width,
+        .height = wlr_scene_buffer_ptr->dst_height
+    };
+    struct wlr_buffer *wlr_buffer_ptr = wlr_scene_buffer_ptr->buffer;
+    if (NULL == wlr_buffer_ptr) return (struct wlr_box){};
+    if (0 >= box.width || 0 >= box.height) {
+        box.width = wlr_buffer_ptr->width;
+        box.height = wlr_buffer_ptr->height;
+        if (wlr_scene_buffer_ptr->transform & WL_OUTPUT_TRANSFORM_90) {
+            box.width = wlr_buffer_ptr->height;
+            box.height = wlr_buffer_ptr->width;
+        }
+    }
+    return box;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Iterator: Extends the bounding box by the scene buffer's box. */
+void _wlmtk_thumbnail_add_bounds(
+    struct wlr_scene_buffer *wlr_scene_buffer_ptr,
+    int sx,
+    int sy,
+    void *ud_ptr)
+{
+    _wlmtk_thumbnail_ctx_t *ctx_ptr = ud_ptr;
+    struct wlr_box box = _wlmtk_thumbnail_buffer_box(
+        wlr_scene_buffer_ptr, sx, sy, ctx_ptr);
+    if (wlr_box_empty(&box)) return;
+    if (wlr_box_empty(&ctx_ptr->bounds)) {
+        ctx_ptr->bounds = box;
+        return;
+    }
+    int x2 = BS_MAX(ctx_ptr->bounds.x + ctx_ptr->bounds.width,
+                    box.x + box.width);
+    int y2 = BS_MAX(ctx_ptr->bounds.y + ctx_ptr->bounds.height,
+                    box.y + box.height);
+    ctx_ptr->bounds.x = BS_MIN(ctx_ptr->bounds.x, box.x);
+    ctx_ptr->bounds.y = BS_MIN(ctx_ptr->bounds.y, box.y);
+    ctx_ptr->bounds.width = x2 - ctx_ptr->bounds.x;
+    ctx_ptr->bounds.height = y2 - ctx_ptr->bounds.y;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Iterator: Renders the scene buffer, downscaled, into the pass. */
+void _wlmtk_thumbnail_render_buffer(
+    struct wlr_scene_buffer *wlr_scene_buffer_ptr,
+    int sx,
+    int sy,
+    void *ud_ptr)
+{
+    _wlmtk_thumbnail_ctx_t *ctx_ptr = ud_ptr;
+    struct wlr_box box = _wlmtk_thumbnail_buffer_box(
+        wlr_scene_buffer_ptr, sx, sy, ctx_ptr);
+    if (wlr_box_empty(&box)) return;
+    struct wlr_texture *wlr_texture_ptr = _wlmtk_thumbnail_texture(
+        ctx_ptr, wlr_scene_buffer_ptr->buffer);
+    if (NULL == wlr_texture_ptr) return;
+
+    double scale = ctx_ptr->scale;
+    int x1 = (int)((box.x - ctx_ptr->bounds.x) * scale + 0.5);
+    int y1 = (int)((box.y - ctx_ptr->bounds.y) * scale + 0.5);
+    int x2 = (int)((box.x + box.width - ctx_ptr->bounds.x) * scale + 0.5);
+    int y2 = (int)((box.y + box.height - ctx_ptr->bounds.y) * scale + 0.5);
+    if (x2 <= x1 || y2 <= y1) return;
+    wlr_render_pass_add_texture(
+        ctx_ptr->wlr_render_pass_ptr,
+        &(struct wlr_render_texture_options){
+            .texture = wlr_texture_ptr,
+            .src_box = wlr_scene_buffer_ptr->src_box,
+            .dst_box = { .x = x1, .y = y1,
+                         .width = x2 - x1, .height = y2 - y1 },
+            .alpha = &wlr_scene_buffer_ptr->opacity,
+            .transform = wlr_scene_buffer_ptr->transform,
+            .filter_mode = WLR_SCALE_FILTER_BILINEAR });
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns a texture for the buffer. Uses the client buffer's texture, if
+ * there is one. Otherwise imports the buffer, and stores the texture for
+ * destruction after the pass.
+ *
+ * @param ctx_ptr
+ * @param wlr_buffer_ptr
+ *
+ * @return The texture, or NULL on error.
+ */
+struct wlr_texture *_wlmtk_thumbnail_texture(
+    _wlmtk_thumbnail_ctx_t *ctx_ptr,
+    struct wlr_buffer *wlr_buffer_ptr)
+{
+    struct wlr_client_buffer *wlr_client_buffer_ptr = wlr_client_buffer_get(
+        wlr_buffer_ptr);
+    if (NULL != wlr_client_buffer_ptr &&
+        NULL != wlr_client_buffer_ptr->texture) {
+        return wlr_client_buffer_ptr->texture;
+    }
+
+    if (ctx_ptr->textures >= ctx_ptr->capacity) {
+        size_t capacity = BS_MAX(8U, 2 * ctx_ptr->capacity);
+        struct wlr_texture **texture_ptrs = logged_calloc(
+            capacity, sizeof(struct wlr_texture *));
+        if (NULL == texture_ptrs) return NULL;
+        if (0 < ctx_ptr->textures) {
+            memcpy(texture_ptrs, ctx_ptr->texture_ptrs,
+                   ctx_ptr->textures * sizeof(struct wlr_texture *));
+        }
+        if (NULL != ctx_ptr->texture_ptrs) free(ctx_ptr->texture_ptrs);
+        ctx_ptr->texture_ptrs = texture_ptrs;
+        ctx_ptr->capacity = capacity;
+    }
+    struct wlr_texture *wlr_texture_ptr = wlr_texture_from_buffer(
+        _wlmtk_thumbnail_renderer.wlr_renderer_ptr, wlr_buffer_ptr);
+    if (NULL == wlr_texture_ptr) return NULL;
+    ctx_ptr->texture_ptrs[ctx_ptr->textures++] = wlr_texture_ptr;
+    return wlr_texture_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes the factor for downscaling `width` x `height` to fit into
+ * `max_width` x `max_height`, keeping the aspect ratio. Never upscales.
+ *
+ * @param width
+ * @param height
+ * @param max_width
+ * @param max_height
+ *
+ * @return The factor, at most 1.
+ */
+double _wlmtk_thumbnail_fit(
+    int width,
+    int height,
+    int max_width,
+    int max_height)
+{
+    double scale = 1.0;
+    if (width > max_width) scale = (double)max_width / width;
+    if (height * scale > max_height) scale = (double)max_height / height;
+    return scale;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_fit(bs_test_t *test_ptr);
+static void test_capture(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_thumbnail_test_cases[] = {
+    { 1, "fit", test_fit },
+    { 1, "capture", test_capture },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Verifies @ref _wlmtk_thumbnail_fit keeps the aspect ratio. */
+void test_fit(bs_test_t *test_ptr)
+{
+    BS_TEST_VERIFY_EQ(test_ptr, 1.0, _wlmtk_thumbnail_fit(100, 50, 256, 256));
+    BS_TEST_VERIFY_EQ(test_ptr, 0.25, _wlmtk_thumbnail_fit(40, 20, 10, 10));
+    BS_TEST_VERIFY_EQ(test_ptr, 0.5, _wlmtk_thumbnail_fit(200, 512, 256, 256));
+    BS_TEST_VERIFY_EQ(test_ptr, 0.25, _wlmtk_thumbnail_fit(20, 40, 10, 10));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Without renderer, nothing is captured. Invalidation marks it stale. */
+void test_capture(bs_test_t *test_ptr)
+{
+    wlmtk_container_t *fake_parent_ptr = wlmtk_container_create_fake_parent();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fake_parent_ptr);
+    wlmtk_buffer_t buffer;
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, wlmtk_buffer_init(&buffer));
+    wlmtk_container_add_element(fake_parent_ptr, &buffer.super_element);
+    wlmtk_element_set_visible(&buffer.super_element, true);
+    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(40, 20);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_buffer_ptr);
+    wlmtk_buffer_set(&buffer, wlr_buffer_ptr);
+    wlr_buffer_drop(wlr_buffer_ptr);
+
+    wlmtk_thumbnail_t *t_ptr = wlmtk_thumbnail_create(
+        &buffer.super_element, 16, 16);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, t_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_thumbnail_capture(t_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, wlmtk_thumbnail_buffer(t_ptr));
+
+    // Bounds of the element's buffers, relative to the element.
+    wlmtk_element_set_position(&buffer.super_element, 10, 5);
+    struct wlr_scene_node *node_ptr = buffer.super_element.wlr_scene_node_ptr;
+    _wlmtk_thumbnail_ctx_t ctx = { .node_x = node_ptr->x,
+                                   .node_y = node_ptr->y };
+    wlr_scene_node_for_each_buffer(
+        node_ptr, _wlmtk_thumbnail_add_bounds, &ctx);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, ctx.bounds.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, ctx.bounds.y);
+    BS_TEST_VERIFY_EQ(test_ptr, 40, ctx.bounds.width);
+    BS_TEST_VERIFY_EQ(test_ptr, 20, ctx.bounds.height);
+
+    t_ptr->stale = false;
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_thumbnail_capture(t_ptr));
+    wlmtk_thumbnail_invalidate(t_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_thumbnail_capture(t_ptr));
+
+    wlmtk_thumbnail_destroy(t_ptr);
+    wlmtk_container_remove_element(fake_parent_ptr, &buffer.super_element);
+    wlmtk_buffer_fini(&buffer);
+    wlmtk_container_destroy_fake_parent(fake_parent_ptr);
+}
+
+/* == End of thumbnail.c =================================================== */
@@ -23,6 +23,7 @@
 #include <cairo.h>
 #include <inttypes.h>
 #include <libbase/libbase.h>
+#include <math.h>
 #include <string.h>
 
 #include "gfxbuf.h"  // IWYU pragma: keep
@@ -32,8 +33,16 @@
 
 static void _wlmtk_tile_update_layout(wlmtk_container_t *container_ptr);
 
+static void _wlmtk_tile_buffer_output_scale_changed(
+    wlmtk_buffer_t *buffer_ptr,
+    double scale);
+
+static void _wlmtk_tile_set_background(
+    wlmtk_tile_t *tile_ptr,
+    struct wlr_buffer *wlr_buffer_ptr);
 static struct wlr_buffer *_wlmtk_tile_create_buffer(
-    const wlmtk_tile_style_t *style_ptr);
+    const wlmtk_tile_style_t *style_ptr,
+    double scale);
 
 /* == Data ================================================================= */
 
@@ -42,6 +51,11 @@ static const wlmtk_container_vmt_t _wlmtk_tile_container_vmt = {
     .update_layout = _wlmtk_tile_update_layout
 };
 
+/** Virtual methods of @ref wlmtk_tile_t::buffer. */
+static const wlmtk_buffer_vmt_t _wlmtk_tile_buffer_vmt = {
+    .output_scale_changed = _wlmtk_tile_buffer_output_scale_changed
+};
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -62,18 +76,20 @@ bool wlmtk_tile_init(
         wlmtk_tile_fini(tile_ptr);
         return false;
     }
+    tile_ptr->orig_buffer_vmt = wlmtk_buffer_extend(
+        &tile_ptr->buffer, &_wlmtk_tile_buffer_vmt);
     wlmtk_element_set_visible(wlmtk_buffer_element(&tile_ptr->buffer), true);
     wlmtk_container_add_element(
         &tile_ptr->super_container,
         wlmtk_buffer_element(&tile_ptr->buffer));
 
     struct wlr_buffer *wlr_buffer_ptr = _wlmtk_tile_create_buffer(
-        &tile_ptr->style);
+        &tile_ptr->style, 1.0);
     if (NULL == wlr_buffer_ptr) {
         wlmtk_tile_fini(tile_ptr);
         return false;
     }
-    wlmtk_tile_set_background_buffer(tile_ptr, wlr_buffer_ptr);
+    _wlmtk_tile_set_background(tile_ptr, wlr_buffer_ptr);
     wlr_buffer_drop(wlr_buffer_ptr);
 
     return true;
@@ -82,6 +98,14 @@ bool wlmtk_tile_init(
 /* ------------------------------------------------------------------------- */
 void wlmtk_tile_fini(wlmtk_tile_t *tile_ptr)
 {
+    for (size_t i = 0; i < WLMTK_TILE_SCALED_BACKGROUNDS; ++i) {
+        wlmtk_tile_scaled_background_t *bg_ptr =
+            &tile_ptr->scaled_backgrounds[i];
+        if (NULL == bg_ptr->wlr_buffer_ptr) continue;
+        wlr_buffer_unlock(bg_ptr->wlr_buffer_ptr);
+        bg_ptr->wlr_buffer_ptr = NULL;
+    }
+
     if (NULL != tile_ptr->background_wlr_buffer_ptr) {
         wlr_buffer_unlock(tile_ptr->background_wlr_buffer_ptr);
         tile_ptr->background_wlr_buffer_ptr = NULL;
@@ -105,11 +129,8 @@ bool wlmtk_tile_set_background_buffer(
     if (tile_ptr->style.size != (uint64_t)wlr_buffer_ptr->width ||
         tile_ptr->style.size != (uint64_t)wlr_buffer_ptr->height) return false;
 
-    if (NULL != tile_ptr->background_wlr_buffer_ptr) {
-        wlr_buffer_unlock(tile_ptr->background_wlr_buffer_ptr);
-    }
-    tile_ptr->background_wlr_buffer_ptr = wlr_buffer_lock(wlr_buffer_ptr);
-    wlmtk_buffer_set(&tile_ptr->buffer, tile_ptr->background_wlr_buffer_ptr);
+    tile_ptr->custom_background = true;
+    _wlmtk_tile_set_background(tile_ptr, wlr_buffer_ptr);
     return true;
 }
 
@@ -193,33 +214,100 @@ void _wlmtk_tile_update_layout(__UNUSED__ wlmtk_container_t *container_ptr)
 }
 
 /* ------------------------------------------------------------------------- */
-/** Crates a wlr_buffer with background, as described in `style_ptr`. */
+/**
+ * Implements @ref wlmtk_buffer_vmt_t::output_scale_changed. Shows the default
+ * background rendered at `scale`, from the tile's cache if available. Custom
+ * backgrounds are left as they are.
+ *
+ * @param buffer_ptr
+ * @param scale
+ */
+void _wlmtk_tile_buffer_output_scale_changed(
+    wlmtk_buffer_t *buffer_ptr,
+    double scale)
+{
+    wlmtk_tile_t *tile_ptr = BS_CONTAINER_OF(buffer_ptr, wlmtk_tile_t, buffer);
+    if (tile_ptr->custom_background) return;
+    if (1.0 == scale) {
+        wlmtk_buffer_set(buffer_ptr, tile_ptr->background_wlr_buffer_ptr);
+        return;
+    }
+
+    for (size_t i = 0; i < WLMTK_TILE_SCALED_BACKGROUNDS; ++i) {
+        wlmtk_tile_scaled_background_t *bg_ptr =
+            &tile_ptr->scaled_backgrounds[i];
+        if (scale == bg_ptr->scale) {
+            wlmtk_buffer_set_scaled(buffer_ptr, bg_ptr->wlr_buffer_ptr, scale);
+            return;
+        }
+    }
+
+    struct wlr_buffer *wlr_buffer_ptr = _wlmtk_tile_create_buffer(
+        &tile_ptr->style, scale);
+    if (NULL == wlr_buffer_ptr) {
+        bs_log(BS_WARNING, "Failed to render tile %p at scale %.2f",
+               tile_ptr, scale);
+        return;
+    }
+    wlmtk_tile_scaled_background_t *bg_ptr =
+        &tile_ptr->scaled_backgrounds[tile_ptr->next_scaled_background];
+    tile_ptr->next_scaled_background = (tile_ptr->next_scaled_background + 1) %
+        WLMTK_TILE_SCALED_BACKGROUNDS;
+    wlmtk_buffer_set_scaled(buffer_ptr, wlr_buffer_ptr, scale);
+    if (NULL != bg_ptr->wlr_buffer_ptr) {
+        wlr_buffer_unlock(bg_ptr->wlr_buffer_ptr);
+    }
+    bg_ptr->scale = scale;
+    bg_ptr->wlr_buffer_ptr = wlr_buffer_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Sets `wlr_buffer_ptr` as the tile's background at 1x. */
+void _wlmtk_tile_set_background(
+    wlmtk_tile_t *tile_ptr,
+    struct wlr_buffer *wlr_buffer_ptr)
+{
+    if (NULL != tile_ptr->background_wlr_buffer_ptr) {
+        wlr_buffer_unlock(tile_ptr->background_wlr_buffer_ptr);
+    }
+    tile_ptr->background_wlr_buffer_ptr = wlr_buffer_lock(wlr_buffer_ptr);
+    wlmtk_buffer_set(&tile_ptr->buffer, tile_ptr->background_wlr_buffer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Crates a wlr_buffer with background, as described in `style_ptr`, and
+ * rendered at `scale` buffer pixels per logical pixel.
+ */
 struct wlr_buffer *_wlmtk_tile_create_buffer(
-    const wlmtk_tile_style_t *style_ptr)
+    const wlmtk_tile_style_t *style_ptr,
+    double scale)
 {
+    unsigned size = lround(style_ptr->size * scale);
     struct wlr_buffer* wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
-        style_ptr->size, style_ptr->size);
+        size, size);
     if (NULL == wlr_buffer_ptr) return NULL;
+    wlmtk_gfxbuf_set_memstat_subsystem(wlr_buffer_ptr, WLMTK_MEMSTAT_TILES);
 
-    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
-    if (NULL == cairo_ptr) {
+    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr);
+    if (!wlmaker_primitives_gfxbuf_fill(gfxbuf_ptr, &style_ptr->fill) ||
+        !wlmaker_primitives_gfxbuf_draw_bezel_at(
+            gfxbuf_ptr, 0, 0, size, size,
+            style_ptr->bezel_width * scale, true)) {
         wlr_buffer_drop(wlr_buffer_ptr);
         return NULL;
     }
-
-    wlmaker_primitives_cairo_fill(cairo_ptr, &style_ptr->fill);
-    wlmaker_primitives_draw_bezel(cairo_ptr, style_ptr->bezel_width, true);
-
-    cairo_destroy(cairo_ptr);
     return wlr_buffer_ptr;
 }
 
 /* == Unit tests =========================================================== */
 
 static void test_init_fini(bs_test_t *test_ptr);
+static void test_scale(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_tile_test_cases[] = {
     { 1, "init_fini", test_init_fini },
+    { 1, "scale", test_scale },
     { 0, NULL, NULL }
 };
 
@@ -249,4 +337,33 @@ static void test_init_fini(bs_test_t *test_ptr)
     wlmtk_tile_fini(&tile);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Verifies backgrounds are rendered per output scale, and re-used. */
+void test_scale(bs_test_t *test_ptr)
+{
+    wlmtk_tile_t tile;
+    wlmtk_tile_style_t style = { .size = 64, .bezel_width = 2 };
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, wlmtk_tile_init(&tile, &style));
+    wlmtk_buffer_t *buffer_ptr = &tile.buffer;
+    struct wlr_buffer *bg1_ptr = tile.background_wlr_buffer_ptr;
+
+    wlmtk_buffer_set_output_scale(buffer_ptr, 2.0);
+    struct wlr_buffer *bg2_ptr = buffer_ptr->wlr_buffer_ptr;
+    BS_TEST_VERIFY_NEQ(test_ptr, bg1_ptr, bg2_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 128, bg2_ptr->width);
+    struct wlr_box box = wlmtk_element_get_dimensions_box(
+        wlmtk_buffer_element(buffer_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 64, box.width);
+    BS_TEST_VERIFY_EQ(test_ptr, 64, box.height);
+
+    wlmtk_buffer_set_output_scale(buffer_ptr, 1.0);
+    BS_TEST_VERIFY_EQ(test_ptr, bg1_ptr, buffer_ptr->wlr_buffer_ptr);
+
+    // Back at 2x: Uses the cached background.
+    wlmtk_buffer_set_output_scale(buffer_ptr, 2.0);
+    BS_TEST_VERIFY_EQ(test_ptr, bg2_ptr, buffer_ptr->wlr_buffer_ptr);
+
+    wlmtk_tile_fini(&tile);
+}
+
 /* == End of tile.c ======================================================== */
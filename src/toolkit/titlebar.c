@@ -22,6 +22,7 @@
 
 #include <cairo.h>
 #include <libbase/libbase.h>
+#include <math.h>
 #include <stdlib.h>
 #define WLR_USE_UNSTABLE
 #include <wlr/interfaces/wlr_buffer.h>
@@ -29,9 +30,11 @@
 
 #include "box.h"
 #include "container.h"
+#include "pool.h"
 #include "primitives.h"
 #include "titlebar_button.h"
 #include "titlebar_title.h"
+#include "trace.h"
 #include "window.h"
 
 /* == Declarations ========================================================= */
@@ -66,12 +69,16 @@ struct _wlmtk_titlebar_t {
     int                       title_width;
     /** Whether the title bar is currently displayed as activated. */
     bool                      activated;
+    /** Whether the title bar is hibernated, ie. has no textures. */
+    bool                      hibernated;
+    /** Buffer pixels per logical pixel. See @ref wlmtk_titlebar_set_scale. */
+    double                    scale;
 
     /** Properties of the title bar. */
     uint32_t                  properties;
 
-    /** Title bar style. */
-    wlmtk_titlebar_style_t    style;
+    /** Title bar style. Interned, see @ref wlmtk_style_intern. */
+    const wlmtk_titlebar_style_t *style_ptr;
 };
 
 static void _wlmtk_titlebar_element_destroy(wlmtk_element_t *element_ptr);
@@ -80,9 +87,14 @@ static bool redraw_buffers(
     wlmtk_titlebar_t *titlebar_ptr,
     unsigned width);
 static bool redraw(wlmtk_titlebar_t *titlebar_ptr);
+static bool redraw_title(wlmtk_titlebar_t *titlebar_ptr);
 
 /* == Data ================================================================= */
 
+/** Pool for title bars. */
+static wlmtk_pool_t _wlmtk_titlebar_pool = WLMTK_POOL_INITIALIZER(
+    "titlebar", wlmtk_titlebar_t);
+
 /** Virtual method table extension for the titlebar's element superclass. */
 static const wlmtk_element_vmt_t titlebar_element_vmt = {
     .destroy = _wlmtk_titlebar_element_destroy
@@ -100,15 +112,19 @@ wlmtk_titlebar_t *wlmtk_titlebar_create(
     wlmtk_window_t *window_ptr,
     const wlmtk_titlebar_style_t *style_ptr)
 {
-    wlmtk_titlebar_t *titlebar_ptr = logged_calloc(
-        1, sizeof(wlmtk_titlebar_t));
+    wlmtk_titlebar_t *titlebar_ptr = wlmtk_pool_alloc(&_wlmtk_titlebar_pool);
     if (NULL == titlebar_ptr) return NULL;
-    titlebar_ptr->style = *style_ptr;
+    titlebar_ptr->style_ptr = WLMTK_STYLE_INTERN(style_ptr);
+    if (NULL == titlebar_ptr->style_ptr) {
+        wlmtk_pool_free(&_wlmtk_titlebar_pool, titlebar_ptr);
+        return NULL;
+    }
     titlebar_ptr->title_ptr = wlmtk_window_get_title(window_ptr);
+    titlebar_ptr->scale = 1.0;
 
     if (!wlmtk_box_init(&titlebar_ptr->super_box,
                         WLMTK_BOX_HORIZONTAL,
-                        &titlebar_ptr->style.margin)) {
+                        &titlebar_ptr->style_ptr->margin)) {
         wlmtk_titlebar_destroy(titlebar_ptr);
         return NULL;
     }
@@ -183,17 +199,20 @@ void wlmtk_titlebar_destroy(wlmtk_titlebar_t *titlebar_ptr)
     }
 
     if (NULL != titlebar_ptr->blurred_gfxbuf_ptr) {
-        bs_gfxbuf_destroy(titlebar_ptr->blurred_gfxbuf_ptr);
+        wlmaker_primitives_fill_gfxbuf_release(
+            titlebar_ptr->blurred_gfxbuf_ptr);
         titlebar_ptr->blurred_gfxbuf_ptr = NULL;
     }
     if (NULL != titlebar_ptr->focussed_gfxbuf_ptr) {
-        bs_gfxbuf_destroy(titlebar_ptr->focussed_gfxbuf_ptr);
+        wlmaker_primitives_fill_gfxbuf_release(
+            titlebar_ptr->focussed_gfxbuf_ptr);
         titlebar_ptr->focussed_gfxbuf_ptr = NULL;
     }
 
     wlmtk_box_fini(&titlebar_ptr->super_box);
 
-    free(titlebar_ptr);
+    wlmtk_style_release(titlebar_ptr->style_ptr);
+    wlmtk_pool_free(&_wlmtk_titlebar_pool, titlebar_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -202,6 +221,10 @@ bool wlmtk_titlebar_set_width(
     unsigned width)
 {
     if (titlebar_ptr->width == width) return true;
+    if (titlebar_ptr->hibernated) {
+        titlebar_ptr->width = width;
+        return true;
+    }
     if (!redraw_buffers(titlebar_ptr, width)) return false;
     BS_ASSERT(width == titlebar_ptr->width);
 
@@ -257,7 +280,87 @@ void wlmtk_titlebar_set_title(
     if (titlebar_ptr->title_ptr == title_ptr) return;
 
     titlebar_ptr->title_ptr = title_ptr;
-    redraw(titlebar_ptr);
+    // Only the title changed. The buttons are left as they were drawn.
+    redraw_title(titlebar_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_titlebar_set_scale(wlmtk_titlebar_t *titlebar_ptr, double scale)
+{
+    BS_ASSERT(1.0 <= scale);
+    if (titlebar_ptr->scale == scale) return true;
+    titlebar_ptr->scale = scale;
+    wlmtk_titlebar_title_set_scale(titlebar_ptr->titlebar_title_ptr, scale);
+    wlmtk_titlebar_button_set_scale(titlebar_ptr->minimize_button_ptr, scale);
+    wlmtk_titlebar_button_set_scale(titlebar_ptr->close_button_ptr, scale);
+    if (0 >= titlebar_ptr->width || titlebar_ptr->hibernated) return true;
+
+    if (!redraw_buffers(titlebar_ptr, titlebar_ptr->width)) return false;
+    return redraw(titlebar_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_titlebar_hibernate(wlmtk_titlebar_t *titlebar_ptr)
+{
+    if (titlebar_ptr->hibernated) return 0;
+    titlebar_ptr->hibernated = true;
+
+    size_t bytes = wlmtk_titlebar_title_release_buffers(
+        titlebar_ptr->titlebar_title_ptr);
+    bytes += wlmtk_titlebar_button_release_buffers(
+        titlebar_ptr->minimize_button_ptr);
+    bytes += wlmtk_titlebar_button_release_buffers(
+        titlebar_ptr->close_button_ptr);
+
+    if (NULL != titlebar_ptr->blurred_gfxbuf_ptr) {
+        wlmaker_primitives_fill_gfxbuf_release(
+            titlebar_ptr->blurred_gfxbuf_ptr);
+        titlebar_ptr->blurred_gfxbuf_ptr = NULL;
+    }
+    if (NULL != titlebar_ptr->focussed_gfxbuf_ptr) {
+        wlmaker_primitives_fill_gfxbuf_release(
+            titlebar_ptr->focussed_gfxbuf_ptr);
+        titlebar_ptr->focussed_gfxbuf_ptr = NULL;
+    }
+    return bytes;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_titlebar_add_footprint(
+    wlmtk_titlebar_t *titlebar_ptr,
+    wlmtk_memstat_footprint_t *footprint_ptr)
+{
+    bs_gfxbuf_t *gfxbuf_ptrs[] = {
+        titlebar_ptr->focussed_gfxbuf_ptr, titlebar_ptr->blurred_gfxbuf_ptr
+    };
+    wlmtk_memstat_footprint_add_struct(
+        footprint_ptr, sizeof(wlmtk_titlebar_t));
+    for (size_t i = 0; i < sizeof(gfxbuf_ptrs) / sizeof(gfxbuf_ptrs[0]); ++i) {
+        if (NULL == gfxbuf_ptrs[i]) continue;
+        wlmtk_memstat_footprint_add_buffer(
+            footprint_ptr,
+            (size_t)gfxbuf_ptrs[i]->pixels_per_line *
+            gfxbuf_ptrs[i]->height * sizeof(uint32_t),
+            true);
+    }
+    wlmtk_titlebar_title_add_footprint(
+        titlebar_ptr->titlebar_title_ptr, footprint_ptr);
+    wlmtk_titlebar_button_add_footprint(
+        titlebar_ptr->minimize_button_ptr, footprint_ptr);
+    wlmtk_titlebar_button_add_footprint(
+        titlebar_ptr->close_button_ptr, footprint_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_titlebar_wake(wlmtk_titlebar_t *titlebar_ptr)
+{
+    if (!titlebar_ptr->hibernated) return true;
+    titlebar_ptr->hibernated = false;
+
+    // Forces a redraw at the tracked width.
+    unsigned width = titlebar_ptr->width;
+    titlebar_ptr->width = 0;
+    return wlmtk_titlebar_set_width(titlebar_ptr, width);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -293,66 +396,55 @@ void _wlmtk_titlebar_compute_positions(wlmtk_titlebar_t *titlebar_ptr)
 
     // Room for a close button?
     titlebar_ptr->close_position = titlebar_ptr->width;
-    if (3 * titlebar_ptr->style.height < titlebar_ptr->width &&
+    if (3 * titlebar_ptr->style_ptr->height < titlebar_ptr->width &&
         (titlebar_ptr->properties & WLMTK_TITLEBAR_PROPERTY_CLOSE)) {
         titlebar_ptr->close_position =
             titlebar_ptr->width -
-            titlebar_ptr->style.height;
+            titlebar_ptr->style_ptr->height;
         titlebar_ptr->title_width -=
-            titlebar_ptr->style.height +
-            titlebar_ptr->style.margin.width;
+            titlebar_ptr->style_ptr->height +
+            titlebar_ptr->style_ptr->margin.width;
     }
 
     titlebar_ptr->title_position = 0;
     // Also having room for a minimize button?
-    if (4 * titlebar_ptr->style.height < titlebar_ptr->width &&
+    if (4 * titlebar_ptr->style_ptr->height < titlebar_ptr->width &&
         (titlebar_ptr->properties & WLMTK_TITLEBAR_PROPERTY_ICONIFY)) {
         titlebar_ptr->title_position =
-            titlebar_ptr->style.height +
-            titlebar_ptr->style.margin.width;
+            titlebar_ptr->style_ptr->height +
+            titlebar_ptr->style_ptr->margin.width;
         titlebar_ptr->title_width -=
-            titlebar_ptr->style.height +
-            titlebar_ptr->style.margin.width;
+            titlebar_ptr->style_ptr->height +
+            titlebar_ptr->style_ptr->margin.width;
     }
 }
 
 /* ------------------------------------------------------------------------- */
-/** Redraws the titlebar's background in appropriate size. */
+/** Redraws the titlebar's background in appropriate size, at the scale. */
 bool redraw_buffers(wlmtk_titlebar_t *titlebar_ptr, unsigned width)
 {
-    cairo_t *cairo_ptr;
-
-    bs_gfxbuf_t *focussed_gfxbuf_ptr = bs_gfxbuf_create(
-        width, titlebar_ptr->style.height);
+    WLMTK_TRACE_SPAN("titlebar_redraw_buffers");
+    const wlmtk_titlebar_style_t *style_ptr = titlebar_ptr->style_ptr;
+    unsigned pixel_width = lround(width * titlebar_ptr->scale);
+    unsigned pixel_height = lround(style_ptr->height * titlebar_ptr->scale);
+    bs_gfxbuf_t *focussed_gfxbuf_ptr = wlmaker_primitives_fill_gfxbuf_acquire(
+        &style_ptr->focussed_fill, pixel_width, pixel_height);
     if (NULL == focussed_gfxbuf_ptr) return false;
-    cairo_ptr = cairo_create_from_bs_gfxbuf(focussed_gfxbuf_ptr);
-    if (NULL == cairo_ptr) {
-        bs_gfxbuf_destroy(focussed_gfxbuf_ptr);
+    bs_gfxbuf_t *blurred_gfxbuf_ptr = wlmaker_primitives_fill_gfxbuf_acquire(
+        &style_ptr->blurred_fill, pixel_width, pixel_height);
+    if (NULL == blurred_gfxbuf_ptr) {
+        wlmaker_primitives_fill_gfxbuf_release(focussed_gfxbuf_ptr);
         return false;
     }
-    wlmaker_primitives_cairo_fill(
-        cairo_ptr, &titlebar_ptr->style.focussed_fill);
-    cairo_destroy(cairo_ptr);
-
-    bs_gfxbuf_t *blurred_gfxbuf_ptr = bs_gfxbuf_create(
-        width, titlebar_ptr->style.height);
-    if (NULL == blurred_gfxbuf_ptr) return false;
-    cairo_ptr = cairo_create_from_bs_gfxbuf(blurred_gfxbuf_ptr);
-    if (NULL == cairo_ptr) {
-        bs_gfxbuf_destroy(blurred_gfxbuf_ptr);
-        bs_gfxbuf_destroy(focussed_gfxbuf_ptr);
-        return false;
-    }
-    wlmaker_primitives_cairo_fill(
-        cairo_ptr, &titlebar_ptr->style.blurred_fill);
-    cairo_destroy(cairo_ptr);
 
     if (NULL != titlebar_ptr->focussed_gfxbuf_ptr) {
-        bs_gfxbuf_destroy(titlebar_ptr->focussed_gfxbuf_ptr);
+        wlmaker_primitives_fill_gfxbuf_release(
+            titlebar_ptr->focussed_gfxbuf_ptr);
     }
     titlebar_ptr->focussed_gfxbuf_ptr = focussed_gfxbuf_ptr;
     if (NULL != titlebar_ptr->blurred_gfxbuf_ptr) {
-        bs_gfxbuf_destroy(titlebar_ptr->blurred_gfxbuf_ptr);
+        wlmaker_primitives_fill_gfxbuf_release(
+            titlebar_ptr->blurred_gfxbuf_ptr);
     }
     titlebar_ptr->blurred_gfxbuf_ptr = blurred_gfxbuf_ptr;
     titlebar_ptr->width = width;
@@ -360,11 +452,11 @@ bool redraw_buffers(wlmtk_titlebar_t *titlebar_ptr, unsigned width)
 }
 
 /* ------------------------------------------------------------------------- */
-/** Redraws the titlebar elements. */
-bool redraw(wlmtk_titlebar_t *titlebar_ptr)
+/** Redraws only the title element. */
+bool redraw_title(wlmtk_titlebar_t *titlebar_ptr)
 {
-    // Guard clause: Nothing to do... yet.
-    if (0 >= titlebar_ptr->width) return true;
+    // Guard clause: Nothing to do... yet. Or while hibernated.
+    if (0 >= titlebar_ptr->width || titlebar_ptr->hibernated) return true;
 
     if (!wlmtk_titlebar_title_redraw(
             titlebar_ptr->titlebar_title_ptr,
@@ -374,11 +466,23 @@ bool redraw(wlmtk_titlebar_t *titlebar_ptr)
             titlebar_ptr->title_width,
             titlebar_ptr->activated,
             titlebar_ptr->title_ptr,
-            &titlebar_ptr->style)) {
+            titlebar_ptr->style_ptr)) {
         return false;
     }
     wlmtk_element_set_visible(
         wlmtk_titlebar_title_element(titlebar_ptr->titlebar_title_ptr), true);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Redraws the titlebar elements. */
+bool redraw(wlmtk_titlebar_t *titlebar_ptr)
+{
+    WLMTK_TRACE_SPAN("titlebar_redraw");
+    // Guard clause: Nothing to do... yet. Or while hibernated.
+    if (0 >= titlebar_ptr->width || titlebar_ptr->hibernated) return true;
+
+    if (!redraw_title(titlebar_ptr)) return false;
 
     if (0 < titlebar_ptr->title_position) {
         if (!wlmtk_titlebar_button_redraw(
@@ -386,7 +490,7 @@ bool redraw(wlmtk_titlebar_t *titlebar_ptr)
                 titlebar_ptr->focussed_gfxbuf_ptr,
                 titlebar_ptr->blurred_gfxbuf_ptr,
                 0,
-                &titlebar_ptr->style)) {
+                titlebar_ptr->style_ptr)) {
             return false;
         }
         wlmtk_element_set_visible(
@@ -404,7 +508,7 @@ bool redraw(wlmtk_titlebar_t *titlebar_ptr)
                 titlebar_ptr->focussed_gfxbuf_ptr,
                 titlebar_ptr->blurred_gfxbuf_ptr,
                 titlebar_ptr->close_position,
-                &titlebar_ptr->style)) {
+                titlebar_ptr->style_ptr)) {
             return false;
         }
         wlmtk_element_set_visible(
@@ -424,11 +528,15 @@ bool redraw(wlmtk_titlebar_t *titlebar_ptr)
 static void test_create_destroy(bs_test_t *test_ptr);
 static void test_variable_width(bs_test_t *test_ptr);
 static void test_properties(bs_test_t *test_ptr);
+static void test_hibernate(bs_test_t *test_ptr);
+static void test_scale(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_titlebar_test_cases[] = {
     { 1, "create_destroy", test_create_destroy },
     { 1, "variable_width", test_variable_width },
     { 1, "properties", test_properties },
+    { 1, "hibernate", test_hibernate },
+    { 1, "scale", test_scale },
     { 0, NULL, NULL }
 };
 
@@ -575,4 +683,72 @@ void test_properties(bs_test_t *test_ptr)
     wlmtk_fake_window_destroy(fake_window_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests that hibernation releases the textures, and waking redraws. */
+void test_hibernate(bs_test_t *test_ptr)
+{
+    wlmtk_fake_window_t *fake_window_ptr = wlmtk_fake_window_create();
+    wlmtk_titlebar_style_t style = { .height = 22, .margin = { .width = 2 } };
+    wlmtk_titlebar_t *titlebar_ptr = wlmtk_titlebar_create(
+        fake_window_ptr->window_ptr, &style);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, titlebar_ptr);
+    wlmtk_element_t *title_elem_ptr = wlmtk_titlebar_title_element(
+        titlebar_ptr->titlebar_title_ptr);
+    int width;
+
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_titlebar_set_width(titlebar_ptr, 89));
+    wlmtk_element_get_dimensions(title_elem_ptr, NULL, NULL, &width, NULL);
+    BS_TEST_VERIFY_EQ(test_ptr, 41, width);
+
+    // Hibernating releases the textures. Only once.
+    BS_TEST_VERIFY_NEQ(test_ptr, 0, wlmtk_titlebar_hibernate(titlebar_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, titlebar_ptr->focussed_gfxbuf_ptr);
+    wlmtk_element_get_dimensions(title_elem_ptr, NULL, NULL, &width, NULL);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, width);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_titlebar_hibernate(titlebar_ptr));
+
+    // A width change is tracked, but not drawn.
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_titlebar_set_width(titlebar_ptr, 67));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, titlebar_ptr->focussed_gfxbuf_ptr);
+    wlmtk_element_get_dimensions(title_elem_ptr, NULL, NULL, &width, NULL);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, width);
+
+    // Waking up draws at the current width.
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_titlebar_wake(titlebar_ptr));
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, titlebar_ptr->focussed_gfxbuf_ptr);
+    wlmtk_element_get_dimensions(title_elem_ptr, NULL, NULL, &width, NULL);
+    BS_TEST_VERIFY_EQ(test_ptr, 43, width);
+
+    wlmtk_element_destroy(wlmtk_titlebar_element(titlebar_ptr));
+    wlmtk_fake_window_destroy(fake_window_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests that scaling redraws at pixel size, and keeps the logical layout. */
+void test_scale(bs_test_t *test_ptr)
+{
+    wlmtk_fake_window_t *fake_window_ptr = wlmtk_fake_window_create();
+    wlmtk_titlebar_style_t style = { .height = 22, .margin = { .width = 2 } };
+    wlmtk_titlebar_t *titlebar_ptr = wlmtk_titlebar_create(
+        fake_window_ptr->window_ptr, &style);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, titlebar_ptr);
+    wlmtk_element_t *title_elem_ptr = wlmtk_titlebar_title_element(
+        titlebar_ptr->titlebar_title_ptr);
+    int width;
+
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_titlebar_set_width(titlebar_ptr, 89));
+    BS_TEST_VERIFY_EQ(test_ptr, 89, titlebar_ptr->focussed_gfxbuf_ptr->width);
+
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_titlebar_set_scale(titlebar_ptr, 1.5));
+    bs_gfxbuf_t *gfxbuf_ptr = titlebar_ptr->focussed_gfxbuf_ptr;
+    BS_TEST_VERIFY_EQ(test_ptr, 134, gfxbuf_ptr->width);
+    BS_TEST_VERIFY_EQ(test_ptr, 33, gfxbuf_ptr->height);
+    BS_TEST_VERIFY_EQ(test_ptr, 24, title_elem_ptr->x);
+    wlmtk_element_get_dimensions(title_elem_ptr, NULL, NULL, &width, NULL);
+    BS_TEST_VERIFY_EQ(test_ptr, 41, width);
+
+    wlmtk_element_destroy(wlmtk_titlebar_element(titlebar_ptr));
+    wlmtk_fake_window_destroy(fake_window_ptr);
+}
+
 /* == End of titlebar.c ==================================================== */
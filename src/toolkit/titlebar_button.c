@@ -22,6 +22,7 @@
 
 #include <libbase/libbase.h>
 #include <linux/input-event-codes.h>
+#include <math.h>
 #include <stdlib.h>
 #define WLR_USE_UNSTABLE
 #include <wlr/interfaces/wlr_buffer.h>
@@ -32,6 +33,7 @@
 #include "content.h"
 #include "gfxbuf.h"  // IWYU pragma: keep
 #include "input.h"
+#include "pool.h"
 #include "primitives.h"
 
 /* == Declarations ========================================================= */
@@ -56,6 +58,8 @@ struct _wlmtk_titlebar_button_t {
     struct wlr_buffer         *focussed_pressed_wlr_buffer_ptr;
     /** WLR buffer of the button when blurred. */
     struct wlr_buffer         *blurred_wlr_buffer_ptr;
+    /** Scale to draw at. See @ref wlmtk_titlebar_button_set_scale. */
+    double                    scale;
 };
 
 static void titlebar_button_element_destroy(wlmtk_element_t *element_ptr);
@@ -67,10 +71,15 @@ static struct wlr_buffer *create_buf(
     bool pressed,
     bool focussed,
     const wlmtk_titlebar_style_t *style_ptr,
-    wlmtk_titlebar_button_draw_t draw);
+    wlmtk_titlebar_button_draw_t draw,
+    double scale);
 
 /* == Data ================================================================= */
 
+/** Pool for title bar buttons. */
+static wlmtk_pool_t _wlmtk_titlebar_button_pool = WLMTK_POOL_INITIALIZER(
+    "titlebar_button", wlmtk_titlebar_button_t);
+
 /** Extension to the superclass element's virtual method table. */
 static const wlmtk_element_vmt_t titlebar_button_element_vmt = {
     .destroy = titlebar_button_element_destroy,
@@ -92,12 +101,13 @@ wlmtk_titlebar_button_t *wlmtk_titlebar_button_create(
     BS_ASSERT(NULL != window_ptr);
     BS_ASSERT(NULL != click_handler);
     BS_ASSERT(NULL != draw);
-    wlmtk_titlebar_button_t *titlebar_button_ptr = logged_calloc(
-        1, sizeof(wlmtk_titlebar_button_t));
+    wlmtk_titlebar_button_t *titlebar_button_ptr = wlmtk_pool_alloc(
+        &_wlmtk_titlebar_button_pool);
     if (NULL == titlebar_button_ptr) return NULL;
     titlebar_button_ptr->click_handler = click_handler;
     titlebar_button_ptr->window_ptr = window_ptr;
     titlebar_button_ptr->draw = draw;
+    titlebar_button_ptr->scale = 1.0;
 
     if (!wlmtk_button_init(&titlebar_button_ptr->super_button)) {
         wlmtk_titlebar_button_destroy(titlebar_button_ptr);
@@ -125,7 +135,7 @@ void wlmtk_titlebar_button_destroy(
         &titlebar_button_ptr->blurred_wlr_buffer_ptr);
 
     wlmtk_button_fini(&titlebar_button_ptr->super_button);
-    free(titlebar_button_ptr);
+    wlmtk_pool_free(&_wlmtk_titlebar_button_pool, titlebar_button_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -138,6 +148,50 @@ void wlmtk_titlebar_button_set_activated(
     update_buffers(titlebar_button_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_titlebar_button_release_buffers(
+    wlmtk_titlebar_button_t *titlebar_button_ptr)
+{
+    size_t bytes =
+        wlmtk_gfxbuf_wlr_buffer_bytes(
+            titlebar_button_ptr->focussed_released_wlr_buffer_ptr) +
+        wlmtk_gfxbuf_wlr_buffer_bytes(
+            titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr) +
+        wlmtk_gfxbuf_wlr_buffer_bytes(
+            titlebar_button_ptr->blurred_wlr_buffer_ptr);
+
+    wlmtk_button_set(&titlebar_button_ptr->super_button, NULL, NULL);
+    wlr_buffer_drop_nullify(
+        &titlebar_button_ptr->focussed_released_wlr_buffer_ptr);
+    wlr_buffer_drop_nullify(
+        &titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr);
+    wlr_buffer_drop_nullify(
+        &titlebar_button_ptr->blurred_wlr_buffer_ptr);
+    return bytes;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_titlebar_button_add_footprint(
+    wlmtk_titlebar_button_t *titlebar_button_ptr,
+    wlmtk_memstat_footprint_t *footprint_ptr)
+{
+    struct wlr_buffer *wlr_buffer_ptrs[] = {
+        titlebar_button_ptr->focussed_released_wlr_buffer_ptr,
+        titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr,
+        titlebar_button_ptr->blurred_wlr_buffer_ptr
+    };
+    wlmtk_memstat_footprint_add_struct(
+        footprint_ptr, sizeof(wlmtk_titlebar_button_t));
+    for (size_t i = 0;
+         i < sizeof(wlr_buffer_ptrs) / sizeof(wlr_buffer_ptrs[0]);
+         ++i) {
+        wlmtk_memstat_footprint_add_buffer(
+            footprint_ptr,
+            wlmtk_gfxbuf_wlr_buffer_bytes(wlr_buffer_ptrs[i]),
+            false);
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 bool wlmtk_titlebar_button_redraw(
     wlmtk_titlebar_button_t *titlebar_button_ptr,
@@ -146,20 +200,25 @@ bool wlmtk_titlebar_button_redraw(
     int position,
     const wlmtk_titlebar_style_t *style_ptr)
 {
+    // The backgrounds are in buffer pixels, at the scale.
+    double scale = titlebar_button_ptr->scale;
+    int size = lround(style_ptr->height * scale);
+    position = BS_MIN(lround(position * scale),
+                      (int)focussed_gfxbuf_ptr->width - size);
     BS_ASSERT(focussed_gfxbuf_ptr->width == blurred_gfxbuf_ptr->width);
     BS_ASSERT(focussed_gfxbuf_ptr->height == blurred_gfxbuf_ptr->height);
-    BS_ASSERT(style_ptr->height == focussed_gfxbuf_ptr->height);
-    BS_ASSERT(position + style_ptr->height <= focussed_gfxbuf_ptr->width);
+    BS_ASSERT(size == (int)focussed_gfxbuf_ptr->height);
+    BS_ASSERT(0 <= position);
 
     struct wlr_buffer *focussed_released_ptr = create_buf(
         focussed_gfxbuf_ptr, position, false, true, style_ptr,
-        titlebar_button_ptr->draw);
+        titlebar_button_ptr->draw, scale);
     struct wlr_buffer *focussed_pressed_ptr = create_buf(
         focussed_gfxbuf_ptr, position, true, true, style_ptr,
-        titlebar_button_ptr->draw);
+        titlebar_button_ptr->draw, scale);
     struct wlr_buffer *blurred_ptr = create_buf(
         blurred_gfxbuf_ptr, position, false, false, style_ptr,
-        titlebar_button_ptr->draw);
+        titlebar_button_ptr->draw, scale);
 
     if (NULL != focussed_released_ptr &&
         NULL != focussed_pressed_ptr &&
@@ -187,6 +246,15 @@ bool wlmtk_titlebar_button_redraw(
     return false;
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_titlebar_button_set_scale(
+    wlmtk_titlebar_button_t *titlebar_button_ptr,
+    double scale)
+{
+    BS_ASSERT(0 < scale);
+    titlebar_button_ptr->scale = scale;
+}
+
 /* ------------------------------------------------------------------------- */
 wlmtk_element_t *wlmtk_titlebar_button_element(
     wlmtk_titlebar_button_t *titlebar_button_ptr)
@@ -225,45 +293,56 @@ void update_buffers(wlmtk_titlebar_button_t *titlebar_button_ptr)
         NULL == titlebar_button_ptr->blurred_wlr_buffer_ptr) return;
 
     if (titlebar_button_ptr->activated) {
-        wlmtk_button_set(
+        wlmtk_button_set_scaled(
             &titlebar_button_ptr->super_button,
             titlebar_button_ptr->focussed_released_wlr_buffer_ptr,
-            titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr);
+            titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr,
+            titlebar_button_ptr->scale);
     } else {
-        wlmtk_button_set(
+        wlmtk_button_set_scaled(
             &titlebar_button_ptr->super_button,
             titlebar_button_ptr->blurred_wlr_buffer_ptr,
-            titlebar_button_ptr->blurred_wlr_buffer_ptr);
+            titlebar_button_ptr->blurred_wlr_buffer_ptr,
+            titlebar_button_ptr->scale);
     }
 }
 
 /* ------------------------------------------------------------------------- */
-/** Helper: Creates a WLR buffer for the button. */
+/** Helper: Creates a WLR buffer for the button, `position` in pixels. */
 struct wlr_buffer *create_buf(
     bs_gfxbuf_t *gfxbuf_ptr,
     int position,
     bool pressed,
     bool focussed,
     const wlmtk_titlebar_style_t *style_ptr,
-    wlmtk_titlebar_button_draw_t draw)
+    wlmtk_titlebar_button_draw_t draw,
+    double scale)
 {
-    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
-        style_ptr->height, style_ptr->height);
+    unsigned size = gfxbuf_ptr->height;
+    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer_uncleared(
+        size, size);
     if (NULL == wlr_buffer_ptr) return NULL;
+    wlmtk_gfxbuf_set_memstat_subsystem(
+        wlr_buffer_ptr, WLMTK_MEMSTAT_DECORATIONS);
 
     bs_gfxbuf_copy_area(
         bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr), 0, 0,
-        gfxbuf_ptr, position, 0, style_ptr->height, style_ptr->height);
+        gfxbuf_ptr, position, 0, size, size);
+    if (!wlmaker_primitives_gfxbuf_draw_bezel_at(
+            bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr), 0, 0,
+            size, size, style_ptr->bezel_width * scale, !pressed)) {
+        wlr_buffer_drop(wlr_buffer_ptr);
+        return NULL;
+    }
 
     cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
     if (NULL == cairo_ptr) {
         wlr_buffer_drop(wlr_buffer_ptr);
         return NULL;
     }
-    wlmaker_primitives_draw_bezel(
-        cairo_ptr, style_ptr->bezel_width, !pressed);
     uint32_t color = style_ptr->focussed_text_color;
     if (!focussed) color = style_ptr->blurred_text_color;
+    cairo_scale(cairo_ptr, scale, scale);
     draw(cairo_ptr, style_ptr->height, color);
     cairo_destroy(cairo_ptr);
 
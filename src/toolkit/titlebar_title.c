@@ -23,11 +23,15 @@
 #include <cairo.h>
 #include <libbase/libbase.h>
 #include <linux/input-event-codes.h>
+#include <math.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+#include <wayland-server-core.h>
 #include <wayland-server-protocol.h>
 #define WLR_USE_UNSTABLE
 #include <wlr/interfaces/wlr_buffer.h>
+#include <wlr/types/wlr_buffer.h>
 #include <wlr/version.h>
 #undef WLR_USE_UNSTABLE
 
@@ -35,11 +39,60 @@
 #include "gfxbuf.h"  // IWYU pragma: keep
 #include "input.h"
 #include "menu.h"
+#include "pool.h"
 #include "primitives.h"
+#include "raster.h"
 #include "window.h"
 
 /* == Declarations ========================================================= */
 
+/** Text layers are allocated in multiples of this width, in pixels. */
+#define WLMTK_TITLEBAR_TITLE_TEXT_WIDTH_STEP 256
+
+/** Argument of a job rasterizing a text layer. Owned by the job. */
+typedef struct {
+    /** Copy of the title to draw. */
+    char                      *title_ptr;
+    /** Font to draw the title with. */
+    wlmtk_style_font_t        font;
+    /** Color to draw the title with. */
+    uint32_t                  color;
+    /** Scale to draw at. */
+    double                    scale;
+    /** Width of the layer, in pixels. */
+    unsigned                  width;
+    /** Height of the layer, in pixels. */
+    unsigned                  height;
+} wlmtk_titlebar_title_text_arg_t;
+
+/**
+ * The title's text, rasterized onto a transparent layer. Kept for as long as
+ * title, font and color remain unchanged, and the layer is wide enough.
+ */
+typedef struct {
+    /** The rasterized text. NULL if not drawn yet. */
+    bs_gfxbuf_t               *gfxbuf_ptr;
+    /** The WLR buffer holding `gfxbuf_ptr`. Locked. */
+    struct wlr_buffer         *wlr_buffer_ptr;
+    /** Copy of the title that was drawn. */
+    char                      *title_ptr;
+    /** Font the title was drawn with. */
+    wlmtk_style_font_t        font;
+    /** Color the title was drawn with. */
+    uint32_t                  color;
+    /** Scale the title was drawn at. */
+    double                    scale;
+
+    /** Job rasterizing the next layer. NULL if none is outstanding. */
+    wlmtk_raster_job_t        *job_ptr;
+    /** Argument of `job_ptr`. */
+    wlmtk_titlebar_title_text_arg_t *job_arg_ptr;
+    /** Whether the job is being submitted: It may complete right away. */
+    bool                      submitting;
+    /** Back-link, to re-compose once the job completes. */
+    wlmtk_titlebar_title_t    *titlebar_title_ptr;
+} wlmtk_titlebar_title_text_t;
+
 /** State of the title bar's title. */
 struct _wlmtk_titlebar_title_t {
     /** Superclass: Buffer. */
@@ -51,6 +104,33 @@ struct _wlmtk_titlebar_title_t {
     struct wlr_buffer         *focussed_wlr_buffer_ptr;
     /** The drawn title, when blurred. */
     struct wlr_buffer         *blurred_wlr_buffer_ptr;
+
+    /** Text layer for the focussed title. */
+    wlmtk_titlebar_title_text_t focussed_text;
+    /** Text layer for the blurred title. */
+    wlmtk_titlebar_title_text_t blurred_text;
+
+    /** Scale to draw at. See @ref wlmtk_titlebar_title_set_scale. */
+    double                    scale;
+    /** Whether the title is drawn focussed (activated). */
+    bool                      activated;
+
+    /**
+     * Arguments to the last @ref wlmtk_titlebar_title_redraw. Used to
+     * re-compose, once text layers are rasterized. Owned by the titlebar.
+     */
+    struct {
+        /** Background for the focussed title. */
+        bs_gfxbuf_t           *focussed_gfxbuf_ptr;
+        /** Background for the blurred title. */
+        bs_gfxbuf_t           *blurred_gfxbuf_ptr;
+        /** Position of the title, in logical pixels. */
+        int                   position;
+        /** Width of the title, in logical pixels. */
+        int                   width;
+        /** Style of the titlebar. */
+        const wlmtk_titlebar_style_t *style_ptr;
+    } redraw;
 };
 
 static void _wlmtk_titlebar_title_element_destroy(
@@ -62,6 +142,9 @@ static bool _wlmtk_titlebar_title_element_pointer_axis(
     wlmtk_element_t *element_ptr,
     struct wlr_pointer_axis_event *wlr_pointer_axis_event_ptr);
 
+static void _wlmtk_titlebar_title_buffer_output_scale_changed(
+    wlmtk_buffer_t *buffer_ptr,
+    double scale);
 static void title_set_activated(
     wlmtk_titlebar_title_t *titlebar_title_ptr,
     bool activated);
@@ -69,12 +152,29 @@ struct wlr_buffer *title_create_buffer(
     bs_gfxbuf_t *gfxbuf_ptr,
     unsigned position,
     unsigned width,
-    uint32_t text_color,
+    bs_gfxbuf_t *text_gfxbuf_ptr,
+    const wlmtk_titlebar_style_t *style_ptr,
+    double scale);
+static bs_gfxbuf_t *title_text_get(
+    wlmtk_titlebar_title_text_t *text_ptr,
+    unsigned width,
+    unsigned height,
+    uint32_t color,
     const char *title_ptr,
-    const wlmtk_titlebar_style_t *style_ptr);
+    const wlmtk_style_font_t *font_ptr,
+    double scale);
+static bool title_text_pending(const wlmtk_titlebar_title_t *t_ptr);
+static void title_text_fini(wlmtk_titlebar_title_text_t *text_ptr);
+static bool title_text_draw(cairo_t *cairo_ptr, void *arg_ptr);
+static void title_text_arg_destroy(void *arg_ptr);
+static void title_text_done(struct wlr_buffer *wlr_buffer_ptr, void *ud_ptr);
 
 /* == Data ================================================================= */
 
+/** Pool for title bar titles. */
+static wlmtk_pool_t _wlmtk_titlebar_title_pool = WLMTK_POOL_INITIALIZER(
+    "titlebar_title", wlmtk_titlebar_title_t);
+
 /** Extension to the superclass elment's virtual method table. */
 static const wlmtk_element_vmt_t titlebar_title_element_vmt = {
     .destroy = _wlmtk_titlebar_title_element_destroy,
@@ -82,15 +182,23 @@ static const wlmtk_element_vmt_t titlebar_title_element_vmt = {
     .pointer_axis = _wlmtk_titlebar_title_element_pointer_axis,
 };
 
+/** Extension to the superclass buffer's virtual method table. */
+static const wlmtk_buffer_vmt_t titlebar_title_buffer_vmt = {
+    .output_scale_changed = _wlmtk_titlebar_title_buffer_output_scale_changed
+};
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
 wlmtk_titlebar_title_t *wlmtk_titlebar_title_create(wlmtk_window_t *window_ptr)
 {
-    wlmtk_titlebar_title_t *titlebar_title_ptr = logged_calloc(
-        1, sizeof(wlmtk_titlebar_title_t));
+    wlmtk_titlebar_title_t *titlebar_title_ptr = wlmtk_pool_alloc(
+        &_wlmtk_titlebar_title_pool);
     if (NULL == titlebar_title_ptr) return NULL;
     titlebar_title_ptr->window_ptr = window_ptr;
+    titlebar_title_ptr->scale = 1.0;
+    titlebar_title_ptr->focussed_text.titlebar_title_ptr = titlebar_title_ptr;
+    titlebar_title_ptr->blurred_text.titlebar_title_ptr = titlebar_title_ptr;
 
     if (!wlmtk_buffer_init(&titlebar_title_ptr->super_buffer)) {
         wlmtk_titlebar_title_destroy(titlebar_title_ptr);
@@ -99,6 +207,9 @@ wlmtk_titlebar_title_t *wlmtk_titlebar_title_create(wlmtk_window_t *window_ptr)
     wlmtk_element_extend(
         &titlebar_title_ptr->super_buffer.super_element,
         &titlebar_title_element_vmt);
+    wlmtk_buffer_extend(
+        &titlebar_title_ptr->super_buffer,
+        &titlebar_title_buffer_vmt);
 
     return titlebar_title_ptr;
 }
@@ -108,8 +219,10 @@ void wlmtk_titlebar_title_destroy(wlmtk_titlebar_title_t *titlebar_title_ptr)
 {
     wlr_buffer_drop_nullify(&titlebar_title_ptr->focussed_wlr_buffer_ptr);
     wlr_buffer_drop_nullify(&titlebar_title_ptr->blurred_wlr_buffer_ptr);
+    title_text_fini(&titlebar_title_ptr->focussed_text);
+    title_text_fini(&titlebar_title_ptr->blurred_text);
     wlmtk_buffer_fini(&titlebar_title_ptr->super_buffer);
-    free(titlebar_title_ptr);
+    wlmtk_pool_free(&_wlmtk_titlebar_title_pool, titlebar_title_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -123,20 +236,48 @@ bool wlmtk_titlebar_title_redraw(
     const char *title_ptr,
     const wlmtk_titlebar_style_t *style_ptr)
 {
+    titlebar_title_ptr->redraw.focussed_gfxbuf_ptr = focussed_gfxbuf_ptr;
+    titlebar_title_ptr->redraw.blurred_gfxbuf_ptr = blurred_gfxbuf_ptr;
+    titlebar_title_ptr->redraw.position = position;
+    titlebar_title_ptr->redraw.width = width;
+    titlebar_title_ptr->redraw.style_ptr = style_ptr;
+
+    // Backgrounds, position and width are in buffer pixels, at the scale.
+    // Rounding the width keeps the logical width: Shifts the position.
+    double scale = titlebar_title_ptr->scale;
+    int height = lround(style_ptr->height * scale);
+    width = lround(width * scale);
+    position = BS_MIN(lround(position * scale),
+                      (int)focussed_gfxbuf_ptr->width - width);
     BS_ASSERT(focussed_gfxbuf_ptr->width == blurred_gfxbuf_ptr->width);
-    BS_ASSERT(style_ptr->height == focussed_gfxbuf_ptr->height);
-    BS_ASSERT(style_ptr->height == blurred_gfxbuf_ptr->height);
+    BS_ASSERT(height == (int)focussed_gfxbuf_ptr->height);
+    BS_ASSERT(height == (int)blurred_gfxbuf_ptr->height);
     BS_ASSERT(position <= (int)focussed_gfxbuf_ptr->width);
     BS_ASSERT(position + width <= (int)focussed_gfxbuf_ptr->width);
 
     if (NULL == title_ptr) title_ptr = "";
 
+    // The text layers only get re-drawn if the title or style changed.
+    bs_gfxbuf_t *focussed_text_gfxbuf_ptr = title_text_get(
+        &titlebar_title_ptr->focussed_text, width, height,
+        style_ptr->focussed_text_color, title_ptr, &style_ptr->font, scale);
+    bs_gfxbuf_t *blurred_text_gfxbuf_ptr = title_text_get(
+        &titlebar_title_ptr->blurred_text, width, height,
+        style_ptr->blurred_text_color, title_ptr, &style_ptr->font, scale);
+    if (title_text_pending(titlebar_title_ptr)) {
+        // Shows the previous title at the new width, until rasterized.
+        title_set_activated(titlebar_title_ptr, activated);
+        return true;
+    }
+    if (NULL == focussed_text_gfxbuf_ptr ||
+        NULL == blurred_text_gfxbuf_ptr) return false;
+
     struct wlr_buffer *focussed_wlr_buffer_ptr = title_create_buffer(
         focussed_gfxbuf_ptr, position, width,
-        style_ptr->focussed_text_color, title_ptr, style_ptr);
+        focussed_text_gfxbuf_ptr, style_ptr, scale);
     struct wlr_buffer *blurred_wlr_buffer_ptr = title_create_buffer(
         blurred_gfxbuf_ptr, position, width,
-        style_ptr->blurred_text_color, title_ptr, style_ptr);
+        blurred_text_gfxbuf_ptr, style_ptr, scale);
 
     if (NULL == focussed_wlr_buffer_ptr ||
         NULL == blurred_wlr_buffer_ptr) {
@@ -154,6 +295,71 @@ bool wlmtk_titlebar_title_redraw(
     return true;
 }
 
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_titlebar_title_release_buffers(
+    wlmtk_titlebar_title_t *titlebar_title_ptr)
+{
+    size_t bytes =
+        wlmtk_gfxbuf_wlr_buffer_bytes(
+            titlebar_title_ptr->focussed_wlr_buffer_ptr) +
+        wlmtk_gfxbuf_wlr_buffer_bytes(
+            titlebar_title_ptr->blurred_wlr_buffer_ptr);
+    wlmtk_titlebar_title_text_t *text_ptrs[] = {
+        &titlebar_title_ptr->focussed_text, &titlebar_title_ptr->blurred_text
+    };
+    for (size_t i = 0; i < sizeof(text_ptrs) / sizeof(text_ptrs[0]); ++i) {
+        if (NULL == text_ptrs[i]->gfxbuf_ptr) continue;
+        bytes += (size_t)text_ptrs[i]->gfxbuf_ptr->width *
+            text_ptrs[i]->gfxbuf_ptr->height * sizeof(uint32_t);
+    }
+
+    wlmtk_buffer_set(&titlebar_title_ptr->super_buffer, NULL);
+    wlr_buffer_drop_nullify(&titlebar_title_ptr->focussed_wlr_buffer_ptr);
+    wlr_buffer_drop_nullify(&titlebar_title_ptr->blurred_wlr_buffer_ptr);
+    title_text_fini(&titlebar_title_ptr->focussed_text);
+    title_text_fini(&titlebar_title_ptr->blurred_text);
+    return bytes;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_titlebar_title_add_footprint(
+    wlmtk_titlebar_title_t *titlebar_title_ptr,
+    wlmtk_memstat_footprint_t *footprint_ptr)
+{
+    wlmtk_memstat_footprint_add_struct(
+        footprint_ptr, sizeof(wlmtk_titlebar_title_t));
+    wlmtk_memstat_footprint_add_buffer(
+        footprint_ptr,
+        wlmtk_gfxbuf_wlr_buffer_bytes(
+            titlebar_title_ptr->focussed_wlr_buffer_ptr),
+        false);
+    wlmtk_memstat_footprint_add_buffer(
+        footprint_ptr,
+        wlmtk_gfxbuf_wlr_buffer_bytes(
+            titlebar_title_ptr->blurred_wlr_buffer_ptr),
+        false);
+    wlmtk_titlebar_title_text_t *text_ptrs[] = {
+        &titlebar_title_ptr->focussed_text, &titlebar_title_ptr->blurred_text
+    };
+    for (size_t i = 0; i < sizeof(text_ptrs) / sizeof(text_ptrs[0]); ++i) {
+        if (NULL == text_ptrs[i]->gfxbuf_ptr) continue;
+        wlmtk_memstat_footprint_add_buffer(
+            footprint_ptr,
+            (size_t)text_ptrs[i]->gfxbuf_ptr->width *
+            text_ptrs[i]->gfxbuf_ptr->height * sizeof(uint32_t),
+            false);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_titlebar_title_set_scale(
+    wlmtk_titlebar_title_t *titlebar_title_ptr,
+    double scale)
+{
+    BS_ASSERT(0 < scale);
+    titlebar_title_ptr->scale = scale;
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmtk_titlebar_title_set_activated(
     wlmtk_titlebar_title_t *titlebar_title_ptr,
@@ -208,6 +414,7 @@ bool _wlmtk_titlebar_title_element_pointer_button(
 /* ------------------------------------------------------------------------- */
 /**
  * Handles pointer axis events: Scroll wheel up will shade, down will unshade.
+ * Acts on whole steps only, see @ref wlmtk_pointer_axis_steps.
  *
  * @param element_ptr
  * @param wlr_pointer_axis_event_ptr
@@ -238,14 +445,32 @@ bool _wlmtk_titlebar_title_element_pointer_axis(
         return false;
     }
 
-    if (wlr_pointer_axis_event_ptr->delta > 0) {
+    int steps = wlmtk_pointer_axis_steps(wlr_pointer_axis_event_ptr);
+    if (steps > 0) {
         wlmtk_window_request_shaded(titlebar_title_ptr->window_ptr, false);
-    } else if (wlr_pointer_axis_event_ptr->delta < 0) {
+    } else if (steps < 0) {
         wlmtk_window_request_shaded(titlebar_title_ptr->window_ptr, true);
     }
     return true;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_buffer_vmt_t::output_scale_changed. The title spans
+ * most of the titlebar: Its output's scale applies to all decorations.
+ *
+ * @param buffer_ptr
+ * @param scale
+ */
+void _wlmtk_titlebar_title_buffer_output_scale_changed(
+    wlmtk_buffer_t *buffer_ptr,
+    double scale)
+{
+    wlmtk_titlebar_title_t *titlebar_title_ptr = BS_CONTAINER_OF(
+        buffer_ptr, wlmtk_titlebar_title_t, super_buffer);
+    wlmtk_window_set_decoration_scale(titlebar_title_ptr->window_ptr, scale);
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Sets whether the title is drawn focussed (activated) or blurred.
@@ -257,11 +482,20 @@ void title_set_activated(
     wlmtk_titlebar_title_t *titlebar_title_ptr,
     bool activated)
 {
-    wlmtk_buffer_set(
+    titlebar_title_ptr->activated = activated;
+    wlmtk_buffer_set_scaled(
         &titlebar_title_ptr->super_buffer,
         activated ?
         titlebar_title_ptr->focussed_wlr_buffer_ptr :
-        titlebar_title_ptr->blurred_wlr_buffer_ptr);
+        titlebar_title_ptr->blurred_wlr_buffer_ptr,
+        titlebar_title_ptr->scale);
+    if (title_text_pending(titlebar_title_ptr) &&
+        0 < titlebar_title_ptr->redraw.width) {
+        wlmtk_buffer_set_stretched(
+            &titlebar_title_ptr->super_buffer,
+            titlebar_title_ptr->redraw.width,
+            titlebar_title_ptr->redraw.style_ptr->height);
+    }
 }
 
 /* ------------------------------------------------------------------------- */
@@ -271,9 +505,10 @@ void title_set_activated(
  * @param gfxbuf_ptr
  * @param position
  * @param width
- * @param text_color
- * @param title_ptr
+ * @param text_gfxbuf_ptr     The rasterized title text, at least `width`
+ *                            wide. Gets composited over the background.
  * @param style_ptr
+ * @param scale               Buffer pixels per logical pixel.
  *
  * @return A pointer to a `struct wlr_buffer` with the texture.
  */
@@ -281,47 +516,249 @@ struct wlr_buffer *title_create_buffer(
     bs_gfxbuf_t *gfxbuf_ptr,
     unsigned position,
     unsigned width,
-    uint32_t text_color,
-    const char *title_ptr,
-    const wlmtk_titlebar_style_t *style_ptr)
+    bs_gfxbuf_t *text_gfxbuf_ptr,
+    const wlmtk_titlebar_style_t *style_ptr,
+    double scale)
 {
-    BS_ASSERT(NULL != title_ptr);
-    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
-        width, style_ptr->height);
+    unsigned height = text_gfxbuf_ptr->height;
+    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer_uncleared(
+        width, height);
     if (NULL == wlr_buffer_ptr) return NULL;
+    wlmtk_gfxbuf_set_memstat_subsystem(
+        wlr_buffer_ptr, WLMTK_MEMSTAT_DECORATIONS);
 
     bs_gfxbuf_copy_area(
         bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr),
         0, 0,
         gfxbuf_ptr,
         position, 0,
-        width, style_ptr->height);
+        width, height);
+    if (!wlmaker_primitives_gfxbuf_draw_bezel_at(
+            bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr), 0, 0, width,
+            height, style_ptr->bezel_width * scale, true)) {
+        wlr_buffer_drop(wlr_buffer_ptr);
+        return NULL;
+    }
 
     cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
     if (NULL == cairo_ptr) {
         wlr_buffer_drop(wlr_buffer_ptr);
         return NULL;
     }
-    wlmaker_primitives_draw_bezel_at(
-        cairo_ptr, 0, 0, width,
-        style_ptr->height, style_ptr->bezel_width, true);
-    wlmaker_primitives_draw_window_title(
-        cairo_ptr, &style_ptr->font, title_ptr, text_color);
+
+    cairo_t *text_cairo_ptr = cairo_create_from_bs_gfxbuf(text_gfxbuf_ptr);
+    if (NULL == text_cairo_ptr) {
+        cairo_destroy(cairo_ptr);
+        wlr_buffer_drop(wlr_buffer_ptr);
+        return NULL;
+    }
+    cairo_set_source_surface(
+        cairo_ptr, cairo_get_target(text_cairo_ptr), 0, 0);
+    cairo_paint(cairo_ptr);
+    cairo_destroy(text_cairo_ptr);
     cairo_destroy(cairo_ptr);
 
     return wlr_buffer_ptr;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the layer with the rasterized title text, re-drawing it if title,
+ * font or color changed, or if it isn't wide enough.
+ *
+ * The layer is rasterized through @ref wlmtk_raster_submit. If that is
+ * deferred, this returns NULL while the job is outstanding, and the title
+ * gets re-composed once it completes.
+ *
+ * @param text_ptr
+ * @param width               Minimum width of the layer.
+ * @param height
+ * @param color
+ * @param title_ptr
+ * @param font_ptr
+ * @param scale               Buffer pixels per logical pixel.
+ *
+ * @return The layer, or NULL on error or while rasterizing.
+ */
+bs_gfxbuf_t *title_text_get(
+    wlmtk_titlebar_title_text_t *text_ptr,
+    unsigned width,
+    unsigned height,
+    uint32_t color,
+    const char *title_ptr,
+    const wlmtk_style_font_t *font_ptr,
+    double scale)
+{
+    if (NULL != text_ptr->gfxbuf_ptr &&
+        width <= text_ptr->gfxbuf_ptr->width &&
+        height == text_ptr->gfxbuf_ptr->height &&
+        color == text_ptr->color &&
+        scale == text_ptr->scale &&
+        0 == strcmp(title_ptr, text_ptr->title_ptr) &&
+        0 == strcmp(font_ptr->face, text_ptr->font.face) &&
+        font_ptr->weight == text_ptr->font.weight &&
+        font_ptr->size == text_ptr->font.size) {
+        // A stale job would replace the current layer: Drop it.
+        wlmtk_raster_cancel(text_ptr->job_ptr);
+        text_ptr->job_ptr = NULL;
+        return text_ptr->gfxbuf_ptr;
+    }
+
+    // The outstanding job will do, if it draws the same.
+    wlmtk_titlebar_title_text_arg_t *arg_ptr = text_ptr->job_arg_ptr;
+    if (NULL != text_ptr->job_ptr &&
+        width <= arg_ptr->width &&
+        height == arg_ptr->height &&
+        color == arg_ptr->color &&
+        scale == arg_ptr->scale &&
+        0 == strcmp(title_ptr, arg_ptr->title_ptr) &&
+        0 == strcmp(font_ptr->face, arg_ptr->font.face) &&
+        font_ptr->weight == arg_ptr->font.weight &&
+        font_ptr->size == arg_ptr->font.size) {
+        return NULL;
+    }
+    wlmtk_raster_cancel(text_ptr->job_ptr);
+    text_ptr->job_ptr = NULL;
+
+    arg_ptr = logged_calloc(1, sizeof(wlmtk_titlebar_title_text_arg_t));
+    if (NULL == arg_ptr) return NULL;
+    arg_ptr->title_ptr = logged_strdup(title_ptr);
+    if (NULL == arg_ptr->title_ptr) {
+        free(arg_ptr);
+        return NULL;
+    }
+    arg_ptr->font = *font_ptr;
+    arg_ptr->color = color;
+    arg_ptr->scale = scale;
+    // Rounded up, so that growing widths rarely require a re-draw.
+    arg_ptr->width = BS_MAX(1, width);
+    arg_ptr->width = (arg_ptr->width +
+                      WLMTK_TITLEBAR_TITLE_TEXT_WIDTH_STEP - 1) /
+        WLMTK_TITLEBAR_TITLE_TEXT_WIDTH_STEP *
+        WLMTK_TITLEBAR_TITLE_TEXT_WIDTH_STEP;
+    arg_ptr->height = height;
+
+    // Completes right away, unless rasterizing is deferred.
+    text_ptr->job_arg_ptr = arg_ptr;
+    text_ptr->submitting = true;
+    text_ptr->job_ptr = wlmtk_raster_submit(
+        arg_ptr->width, arg_ptr->height, title_text_draw, arg_ptr,
+        title_text_arg_destroy, title_text_done, text_ptr);
+    text_ptr->submitting = false;
+    if (NULL != text_ptr->job_ptr) return NULL;
+    text_ptr->job_arg_ptr = NULL;
+    return text_ptr->gfxbuf_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return whether any of the title's text layers is being rasterized. */
+bool title_text_pending(const wlmtk_titlebar_title_t *t_ptr)
+{
+    return (NULL != t_ptr->focussed_text.job_ptr ||
+            NULL != t_ptr->blurred_text.job_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Releases the resources of the text layer. Cancels an outstanding job. */
+void title_text_fini(wlmtk_titlebar_title_text_t *text_ptr)
+{
+    wlmtk_raster_cancel(text_ptr->job_ptr);
+    text_ptr->job_ptr = NULL;
+    text_ptr->job_arg_ptr = NULL;
+
+    wlr_buffer_drop_nullify(&text_ptr->wlr_buffer_ptr);
+    text_ptr->gfxbuf_ptr = NULL;
+    if (NULL != text_ptr->title_ptr) {
+        free(text_ptr->title_ptr);
+        text_ptr->title_ptr = NULL;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_raster_draw_t: Draws the title text. Runs on a
+ * rasterizer thread, hence uses only the argument.
+ *
+ * @param cairo_ptr
+ * @param arg_ptr             Points to @ref wlmtk_titlebar_title_text_arg_t.
+ *
+ * @return true.
+ */
+bool title_text_draw(cairo_t *cairo_ptr, void *arg_ptr)
+{
+    wlmtk_titlebar_title_text_arg_t *a_ptr = arg_ptr;
+    cairo_scale(cairo_ptr, a_ptr->scale, a_ptr->scale);
+    wlmaker_primitives_draw_window_title(
+        cairo_ptr, &a_ptr->font, a_ptr->title_ptr, a_ptr->color);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the @ref wlmtk_titlebar_title_text_arg_t at `arg_ptr`. */
+void title_text_arg_destroy(void *arg_ptr)
+{
+    wlmtk_titlebar_title_text_arg_t *a_ptr = arg_ptr;
+    free(a_ptr->title_ptr);
+    free(a_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_raster_done_t: Takes the rasterized text as the
+ * layer. Re-composes the title, unless the job completed while submitting.
+ *
+ * @param wlr_buffer_ptr
+ * @param ud_ptr              Points to @ref wlmtk_titlebar_title_text_t.
+ */
+void title_text_done(struct wlr_buffer *wlr_buffer_ptr, void *ud_ptr)
+{
+    wlmtk_titlebar_title_text_t *text_ptr = ud_ptr;
+    wlmtk_titlebar_title_text_arg_t *arg_ptr = text_ptr->job_arg_ptr;
+    text_ptr->job_ptr = NULL;
+    text_ptr->job_arg_ptr = NULL;
+    title_text_fini(text_ptr);
+    if (NULL == wlr_buffer_ptr) return;
+
+    text_ptr->title_ptr = logged_strdup(arg_ptr->title_ptr);
+    if (NULL == text_ptr->title_ptr) return;
+    text_ptr->wlr_buffer_ptr = wlr_buffer_lock(wlr_buffer_ptr);
+    wlmtk_gfxbuf_set_memstat_subsystem(
+        text_ptr->wlr_buffer_ptr, WLMTK_MEMSTAT_DECORATIONS);
+    text_ptr->gfxbuf_ptr = bs_gfxbuf_from_wlr_buffer(text_ptr->wlr_buffer_ptr);
+    text_ptr->font = arg_ptr->font;
+    text_ptr->color = arg_ptr->color;
+    text_ptr->scale = arg_ptr->scale;
+    if (text_ptr->submitting) return;
+
+    wlmtk_titlebar_title_t *titlebar_title_ptr = text_ptr->titlebar_title_ptr;
+    if (!wlmtk_titlebar_title_redraw(
+            titlebar_title_ptr,
+            titlebar_title_ptr->redraw.focussed_gfxbuf_ptr,
+            titlebar_title_ptr->redraw.blurred_gfxbuf_ptr,
+            titlebar_title_ptr->redraw.position,
+            titlebar_title_ptr->redraw.width,
+            titlebar_title_ptr->activated,
+            arg_ptr->title_ptr,
+            titlebar_title_ptr->redraw.style_ptr)) {
+        bs_log(BS_WARNING, "Failed to re-compose title %p",
+               titlebar_title_ptr);
+    }
+}
+
 /* == Unit tests =========================================================== */
 
 static void test_title(bs_test_t *test_ptr);
 static void test_shade(bs_test_t *test_ptr);
+static void test_text_layer(bs_test_t *test_ptr);
+static void test_deferred(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_titlebar_title_test_cases[] = {
     // TODO(kaeser@gubbe.ch): Re-enable, once figuring out why this fails on
     // Trixie when running as a github action.
     { 0, "title", test_title },
     { 1, "shade", test_shade },
+    { 1, "text_layer", test_text_layer },
+    { 1, "deferred", test_deferred },
     { 0, NULL, NULL }
 };
 
@@ -468,6 +905,20 @@ void test_shade(bs_test_t *test_ptr)
         test_ptr,
         wlmtk_window_is_shaded(fake_window_ptr->window_ptr));
 
+    // A fraction of a high-resolution wheel's detent: No step, stays.
+    axis_event.delta_discrete = -WLR_POINTER_AXIS_DISCRETE_STEP / 4;
+    axis_event.delta = -0.01;
+    wlmtk_element_pointer_axis(element_ptr, &axis_event);
+    BS_TEST_VERIFY_FALSE(
+        test_ptr,
+        wlmtk_window_is_shaded(fake_window_ptr->window_ptr));
+    axis_event.delta_discrete = -WLR_POINTER_AXIS_DISCRETE_STEP;
+    wlmtk_element_pointer_axis(element_ptr, &axis_event);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_window_is_shaded(fake_window_ptr->window_ptr));
+    axis_event.delta_discrete = 0;
+
     // Source 'finger from a touchpad' is accepted, too.
 #if WLR_VERSION_NUM >= (18 << 8)
     axis_event.source = WL_POINTER_AXIS_SOURCE_FINGER;
@@ -502,4 +953,150 @@ void test_shade(bs_test_t *test_ptr)
     wlmtk_fake_window_destroy(fake_window_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Verifies the text layer is kept across width changes. */
+void test_text_layer(bs_test_t *test_ptr)
+{
+    const wlmtk_titlebar_style_t style = {
+        .focussed_text_color = 0xffc0c0c0,
+        .blurred_text_color = 0xff808080,
+        .height = 22,
+        .font = { .face = "Helvetica", .size = 15 },
+        .bezel_width = 1
+    };
+    bs_gfxbuf_t *focussed_gfxbuf_ptr = bs_gfxbuf_create(400, 22);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, focussed_gfxbuf_ptr);
+    bs_gfxbuf_t *blurred_gfxbuf_ptr = bs_gfxbuf_create(400, 22);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, blurred_gfxbuf_ptr);
+
+    wlmtk_fake_window_t *fake_window_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fake_window_ptr);
+    wlmtk_titlebar_title_t *titlebar_title_ptr = wlmtk_titlebar_title_create(
+        fake_window_ptr->window_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, titlebar_title_ptr);
+
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_titlebar_title_redraw(
+            titlebar_title_ptr, focussed_gfxbuf_ptr, blurred_gfxbuf_ptr,
+            10, 90, true, "Title", &style));
+    bs_gfxbuf_t *text_gfxbuf_ptr =
+        titlebar_title_ptr->focussed_text.gfxbuf_ptr;
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, text_gfxbuf_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMTK_TITLEBAR_TITLE_TEXT_WIDTH_STEP,
+        text_gfxbuf_ptr->width);
+
+    // Another width, within the layer: Layer remains.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_titlebar_title_redraw(
+            titlebar_title_ptr, focussed_gfxbuf_ptr, blurred_gfxbuf_ptr,
+            10, 120, true, "Title", &style));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, text_gfxbuf_ptr,
+        titlebar_title_ptr->focussed_text.gfxbuf_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 120,
+        bs_gfxbuf_from_wlr_buffer(
+            titlebar_title_ptr->focussed_wlr_buffer_ptr)->width);
+
+    // Exceeding the layer's width, or changing title: Re-drawn.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_titlebar_title_redraw(
+            titlebar_title_ptr, focussed_gfxbuf_ptr, blurred_gfxbuf_ptr,
+            10, 300, true, "Title", &style));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 2 * WLMTK_TITLEBAR_TITLE_TEXT_WIDTH_STEP,
+        titlebar_title_ptr->focussed_text.gfxbuf_ptr->width);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_titlebar_title_redraw(
+            titlebar_title_ptr, focussed_gfxbuf_ptr, blurred_gfxbuf_ptr,
+            10, 300, true, "Other", &style));
+    BS_TEST_VERIFY_STREQ(
+        test_ptr, "Other", titlebar_title_ptr->blurred_text.title_ptr);
+
+    wlmtk_element_destroy(wlmtk_titlebar_title_element(titlebar_title_ptr));
+    wlmtk_fake_window_destroy(fake_window_ptr);
+    bs_gfxbuf_destroy(focussed_gfxbuf_ptr);
+    bs_gfxbuf_destroy(blurred_gfxbuf_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies the title is re-composed once rasterized on threads. */
+void test_deferred(bs_test_t *test_ptr)
+{
+    const wlmtk_titlebar_style_t style = {
+        .focussed_text_color = 0xffc0c0c0,
+        .blurred_text_color = 0xff808080,
+        .height = 22,
+        .font = { .face = "Helvetica", .size = 15 },
+        .bezel_width = 1
+    };
+    bs_gfxbuf_t *focussed_gfxbuf_ptr = bs_gfxbuf_create(400, 22);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, focussed_gfxbuf_ptr);
+    bs_gfxbuf_t *blurred_gfxbuf_ptr = bs_gfxbuf_create(400, 22);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, blurred_gfxbuf_ptr);
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(
+        test_ptr, wlmtk_raster_defer(wl_event_loop_ptr));
+
+    wlmtk_fake_window_t *fake_window_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fake_window_ptr);
+    wlmtk_titlebar_title_t *titlebar_title_ptr = wlmtk_titlebar_title_create(
+        fake_window_ptr->window_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, titlebar_title_ptr);
+    wlmtk_buffer_t *buffer_ptr = &titlebar_title_ptr->super_buffer;
+
+    // Nothing to show, until the layers are rasterized.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_titlebar_title_redraw(
+            titlebar_title_ptr, focussed_gfxbuf_ptr, blurred_gfxbuf_ptr,
+            10, 90, true, "Title", &style));
+    BS_TEST_VERIFY_TRUE(test_ptr, title_text_pending(titlebar_title_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, buffer_ptr->wlr_buffer_ptr);
+    for (int i = 0; i < 100 && title_text_pending(titlebar_title_ptr); ++i) {
+        wl_event_loop_dispatch(wl_event_loop_ptr, 10);
+    }
+    BS_TEST_VERIFY_FALSE(test_ptr, title_text_pending(titlebar_title_ptr));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, buffer_ptr->wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 90, buffer_ptr->wlr_buffer_ptr->width);
+
+    // A new title: Shows the previous one stretched, until re-composed.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_titlebar_title_redraw(
+            titlebar_title_ptr, focussed_gfxbuf_ptr, blurred_gfxbuf_ptr,
+            10, 120, false, "Other", &style));
+    BS_TEST_VERIFY_EQ(test_ptr, 90, buffer_ptr->wlr_buffer_ptr->width);
+    BS_TEST_VERIFY_EQ(test_ptr, 120, buffer_ptr->stretch_width);
+    for (int i = 0; i < 100 && title_text_pending(titlebar_title_ptr); ++i) {
+        wl_event_loop_dispatch(wl_event_loop_ptr, 10);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 0, buffer_ptr->stretch_width);
+    BS_TEST_VERIFY_EQ(test_ptr, 120, buffer_ptr->wlr_buffer_ptr->width);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, titlebar_title_ptr->blurred_wlr_buffer_ptr,
+        buffer_ptr->wlr_buffer_ptr);
+
+    // Destroying with an outstanding job cancels it.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_titlebar_title_redraw(
+            titlebar_title_ptr, focussed_gfxbuf_ptr, blurred_gfxbuf_ptr,
+            10, 120, false, "Third", &style));
+    BS_TEST_VERIFY_TRUE(test_ptr, title_text_pending(titlebar_title_ptr));
+    wlmtk_element_destroy(wlmtk_titlebar_title_element(titlebar_title_ptr));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_raster_defer(NULL));
+
+    wlmtk_fake_window_destroy(fake_window_ptr);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+    bs_gfxbuf_destroy(focussed_gfxbuf_ptr);
+    bs_gfxbuf_destroy(blurred_gfxbuf_ptr);
+}
+
 /* == End of titlebar_title.c ============================================== */
@@ -0,0 +1,563 @@
+/* ========================================================================= */
+/**
+ * @file trace.c
+ *
+ * @copyright
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "trace.h"
+
+#include <libbase/libbase.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+
+/* == Declarations ========================================================= */
+
+/** A recorded span. */
+typedef struct {
+    /** Name of the span. */
+    const char                *name_ptr;
+    /** Begin, on CLOCK_MONOTONIC, in nanoseconds. */
+    uint64_t                  begin_nsec;
+    /** End, on CLOCK_MONOTONIC, in nanoseconds. */
+    uint64_t                  end_nsec;
+} wlmtk_trace_event_t;
+
+/** Ring buffer of a thread's spans. Written only by that thread. */
+typedef struct {
+    /** Node within @ref _wlmtk_trace_rings. */
+    bs_dllist_node_t          dlnode;
+    /** Thread ID, as reported in the trace. */
+    pid_t                     tid;
+    /** Number of spans written so far. Slot is `written % events`. */
+    _Atomic uint64_t          written;
+    /** The spans. */
+    wlmtk_trace_event_t       events[WLMTK_TRACE_EVENTS];
+} wlmtk_trace_ring_t;
+
+static wlmtk_trace_ring_t *_wlmtk_trace_ring(void);
+static void _wlmtk_trace_key_create(void);
+static void _wlmtk_trace_ring_destroy(void *ring_ptr);
+static wlmtk_trace_event_t *_wlmtk_trace_ring_copy(
+    wlmtk_trace_ring_t *ring_ptr,
+    uint64_t *begin_ptr,
+    uint64_t *end_ptr);
+static bool _wlmtk_trace_ring_write(
+    wlmtk_trace_ring_t *ring_ptr,
+    FILE *file_ptr,
+    pid_t pid,
+    bool *first_ptr);
+static void _wlmtk_trace_ring_aggregate(
+    wlmtk_trace_ring_t *ring_ptr,
+    uint64_t since_nsec,
+    wlmtk_trace_hotspot_t *hotspots_ptr,
+    size_t *hotspots_size_ptr);
+static int _wlmtk_trace_hotspot_compare(const void *a_ptr, const void *b_ptr);
+static uint64_t _wlmtk_trace_now_nsec(void);
+
+/* == Data ================================================================= */
+
+/** The calling thread's ring. Set up on the thread's first span. */
+static _Thread_local wlmtk_trace_ring_t *_wlmtk_trace_thread_ring_ptr;
+/** Whether setting up the calling thread's ring had failed. */
+static _Thread_local bool     _wlmtk_trace_thread_failed;
+
+/** Rings of all threads. See @ref wlmtk_trace_ring_t::dlnode. */
+static bs_dllist_t            _wlmtk_trace_rings;
+/** Guards @ref _wlmtk_trace_rings. Not taken when recording. */
+static pthread_mutex_t        _wlmtk_trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+/** Key for releasing a thread's ring when the thread exits. */
+static pthread_key_t          _wlmtk_trace_key;
+/** Guards creating @ref _wlmtk_trace_key. */
+static pthread_once_t         _wlmtk_trace_key_once = PTHREAD_ONCE_INIT;
+
+/** Distinct span names considered by @ref wlmtk_trace_get_hotspots. */
+static const size_t           _wlmtk_trace_max_names = 256;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmtk_trace_span_t wlmtk_trace_span_begin(const char *name_ptr)
+{
+    return (wlmtk_trace_span_t){
+        .name_ptr = name_ptr,
+        .begin_nsec = _wlmtk_trace_now_nsec()
+    };
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_trace_span_end(wlmtk_trace_span_t *span_ptr)
+{
+    wlmtk_trace_ring_t *ring_ptr = _wlmtk_trace_ring();
+    if (NULL == ring_ptr) return;
+
+    // Only this thread writes `written`: A relaxed load is current.
+    uint64_t w = atomic_load_explicit(&ring_ptr->written,
+                                      memory_order_relaxed);
+    ring_ptr->events[w % WLMTK_TRACE_EVENTS] = (wlmtk_trace_event_t){
+        .name_ptr = span_ptr->name_ptr,
+        .begin_nsec = span_ptr->begin_nsec,
+        .end_nsec = _wlmtk_trace_now_nsec()
+    };
+    atomic_store_explicit(&ring_ptr->written, w + 1, memory_order_release);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_trace_write(FILE *file_ptr)
+{
+    pid_t pid = getpid();
+    bool first = true, rv = true;
+
+    if (0 > fprintf(file_ptr, "{\"traceEvents\":[")) return false;
+    pthread_mutex_lock(&_wlmtk_trace_mutex);
+    for (bs_dllist_node_t *dlnode_ptr = _wlmtk_trace_rings.head_ptr;
+         rv && NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        rv = _wlmtk_trace_ring_write(
+            BS_CONTAINER_OF(dlnode_ptr, wlmtk_trace_ring_t, dlnode),
+            file_ptr, pid, &first);
+    }
+    pthread_mutex_unlock(&_wlmtk_trace_mutex);
+    if (!rv || 0 > fprintf(file_ptr, "]}\n")) return false;
+    return 0 == fflush(file_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_trace_get_hotspots(
+    uint64_t since_nsec,
+    wlmtk_trace_hotspot_t *hotspots_ptr,
+    size_t max_hotspots)
+{
+    wlmtk_trace_hotspot_t *all_ptr = logged_calloc(
+        _wlmtk_trace_max_names, sizeof(wlmtk_trace_hotspot_t));
+    if (NULL == all_ptr) return 0;
+
+    size_t size = 0;
+    pthread_mutex_lock(&_wlmtk_trace_mutex);
+    for (bs_dllist_node_t *dlnode_ptr = _wlmtk_trace_rings.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        _wlmtk_trace_ring_aggregate(
+            BS_CONTAINER_OF(dlnode_ptr, wlmtk_trace_ring_t, dlnode),
+            since_nsec, all_ptr, &size);
+    }
+    pthread_mutex_unlock(&_wlmtk_trace_mutex);
+
+    qsort(all_ptr, size, sizeof(wlmtk_trace_hotspot_t),
+          _wlmtk_trace_hotspot_compare);
+    size = BS_MIN(size, max_hotspots);
+    memcpy(hotspots_ptr, all_ptr, size * sizeof(wlmtk_trace_hotspot_t));
+    free(all_ptr);
+    return size;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** @return The calling thread's ring, creating it if needed. Or NULL. */
+wlmtk_trace_ring_t *_wlmtk_trace_ring(void)
+{
+    if (NULL != _wlmtk_trace_thread_ring_ptr) {
+        return _wlmtk_trace_thread_ring_ptr;
+    }
+    if (_wlmtk_trace_thread_failed) return NULL;
+
+    _wlmtk_trace_thread_failed = true;
+    if (0 != pthread_once(&_wlmtk_trace_key_once, _wlmtk_trace_key_create)) {
+        return NULL;
+    }
+    wlmtk_trace_ring_t *ring_ptr = logged_calloc(
+        1, sizeof(wlmtk_trace_ring_t));
+    if (NULL == ring_ptr) return NULL;
+    ring_ptr->tid = (pid_t)syscall(SYS_gettid);
+    atomic_init(&ring_ptr->written, 0);
+    if (0 != pthread_setspecific(_wlmtk_trace_key, ring_ptr)) {
+        free(ring_ptr);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&_wlmtk_trace_mutex);
+    bs_dllist_push_back(&_wlmtk_trace_rings, &ring_ptr->dlnode);
+    pthread_mutex_unlock(&_wlmtk_trace_mutex);
+    _wlmtk_trace_thread_failed = false;
+    _wlmtk_trace_thread_ring_ptr = ring_ptr;
+    return ring_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Creates @ref _wlmtk_trace_key. Called once, via `pthread_once`. */
+void _wlmtk_trace_key_create(void)
+{
+    if (0 != pthread_key_create(&_wlmtk_trace_key,
+                                _wlmtk_trace_ring_destroy)) {
+        bs_log(BS_WARNING, "Failed pthread_key_create(%p, %p)",
+               &_wlmtk_trace_key, _wlmtk_trace_ring_destroy);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Unregisters and frees the ring of a thread that exits. */
+void _wlmtk_trace_ring_destroy(void *ring_ptr)
+{
+    wlmtk_trace_ring_t *r_ptr = ring_ptr;
+    pthread_mutex_lock(&_wlmtk_trace_mutex);
+    bs_dllist_remove(&_wlmtk_trace_rings, &r_ptr->dlnode);
+    pthread_mutex_unlock(&_wlmtk_trace_mutex);
+    free(r_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Copies the ring's spans. The owning thread may keep recording: Spans that
+ * were overwritten while copying are excluded from the returned range.
+ *
+ * @param ring_ptr
+ * @param begin_ptr           Set to the sequence number of the first valid
+ *                            span.
+ * @param end_ptr             Set to the sequence number past the last span.
+ *
+ * @return The copy, of @ref WLMTK_TRACE_EVENTS elements, indexed by the
+ *     sequence number modulo @ref WLMTK_TRACE_EVENTS. Must be free'd. NULL
+ *     on error.
+ */
+wlmtk_trace_event_t *_wlmtk_trace_ring_copy(
+    wlmtk_trace_ring_t *ring_ptr,
+    uint64_t *begin_ptr,
+    uint64_t *end_ptr)
+{
+    wlmtk_trace_event_t *events_ptr = logged_calloc(
+        WLMTK_TRACE_EVENTS, sizeof(wlmtk_trace_event_t));
+    if (NULL == events_ptr) return NULL;
+
+    uint64_t end = atomic_load_explicit(&ring_ptr->written,
+                                        memory_order_acquire);
+    uint64_t begin = WLMTK_TRACE_EVENTS < end ? end - WLMTK_TRACE_EVENTS : 0;
+    for (uint64_t i = begin; i < end; ++i) {
+        events_ptr[i % WLMTK_TRACE_EVENTS] =
+            ring_ptr->events[i % WLMTK_TRACE_EVENTS];
+    }
+    // Slots the writer got to since, including the one it may be writing
+    // right now, could have been torn.
+    atomic_thread_fence(memory_order_acquire);
+    uint64_t now = atomic_load_explicit(&ring_ptr->written,
+                                        memory_order_relaxed);
+    if (now + 1 > begin + WLMTK_TRACE_EVENTS) {
+        begin = BS_MIN(end, now + 1 - WLMTK_TRACE_EVENTS);
+    }
+    *begin_ptr = begin;
+    *end_ptr = end;
+    return events_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Writes the ring's spans as complete ("X") events.
+ *
+ * @param ring_ptr
+ * @param file_ptr
+ * @param pid
+ * @param first_ptr           Whether no event was written yet. Updated.
+ *
+ * @return true on success.
+ */
+bool _wlmtk_trace_ring_write(
+    wlmtk_trace_ring_t *ring_ptr,
+    FILE *file_ptr,
+    pid_t pid,
+    bool *first_ptr)
+{
+    uint64_t begin, end;
+    wlmtk_trace_event_t *events_ptr = _wlmtk_trace_ring_copy(
+        ring_ptr, &begin, &end);
+    if (NULL == events_ptr) return false;
+
+    bool rv = true;
+    for (uint64_t i = begin; rv && i < end; ++i) {
+        wlmtk_trace_event_t *e_ptr = &events_ptr[i % WLMTK_TRACE_EVENTS];
+        // Timestamps in microseconds. Names are literals from the source,
+        // so require no escaping.
+        rv = 0 <= fprintf(
+            file_ptr,
+            "%s{\"name\":\"%s\",\"cat\":\"wlmaker\",\"ph\":\"X\","
+            "\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d}",
+            *first_ptr ? "" : ",",
+            e_ptr->name_ptr,
+            e_ptr->begin_nsec / 1e3,
+            (e_ptr->end_nsec - e_ptr->begin_nsec) / 1e3,
+            pid, ring_ptr->tid);
+        *first_ptr = false;
+    }
+    free(events_ptr);
+    return rv;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Adds the ring's spans that ended at or after `since_nsec` to the hotspots.
+ * Names beyond @ref _wlmtk_trace_max_names are ignored.
+ *
+ * @param ring_ptr
+ * @param since_nsec
+ * @param hotspots_ptr        Array of @ref _wlmtk_trace_max_names elements.
+ * @param hotspots_size_ptr   Number of elements in use. Updated.
+ */
+void _wlmtk_trace_ring_aggregate(
+    wlmtk_trace_ring_t *ring_ptr,
+    uint64_t since_nsec,
+    wlmtk_trace_hotspot_t *hotspots_ptr,
+    size_t *hotspots_size_ptr)
+{
+    uint64_t begin, end;
+    wlmtk_trace_event_t *events_ptr = _wlmtk_trace_ring_copy(
+        ring_ptr, &begin, &end);
+    if (NULL == events_ptr) return;
+
+    for (uint64_t i = begin; i < end; ++i) {
+        wlmtk_trace_event_t *e_ptr = &events_ptr[i % WLMTK_TRACE_EVENTS];
+        if (e_ptr->end_nsec < since_nsec) continue;
+
+        size_t n = 0;
+        while (n < *hotspots_size_ptr &&
+               hotspots_ptr[n].name_ptr != e_ptr->name_ptr) ++n;
+        if (n >= _wlmtk_trace_max_names) continue;
+        if (n == *hotspots_size_ptr) {
+            hotspots_ptr[n].name_ptr = e_ptr->name_ptr;
+            ++*hotspots_size_ptr;
+        }
+
+        uint64_t duration_nsec = e_ptr->end_nsec - e_ptr->begin_nsec;
+        hotspots_ptr[n].count++;
+        hotspots_ptr[n].total_nsec += duration_nsec;
+        hotspots_ptr[n].max_nsec = BS_MAX(hotspots_ptr[n].max_nsec,
+                                          duration_nsec);
+    }
+    free(events_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Orders @ref wlmtk_trace_hotspot_t by descending total duration. */
+int _wlmtk_trace_hotspot_compare(const void *a_ptr, const void *b_ptr)
+{
+    const wlmtk_trace_hotspot_t *a = a_ptr, *b = b_ptr;
+    if (a->total_nsec > b->total_nsec) return -1;
+    if (a->total_nsec < b->total_nsec) return 1;
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return The current time of CLOCK_MONOTONIC, in nanoseconds. */
+uint64_t _wlmtk_trace_now_nsec(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + now.tv_nsec;
+}
+
+/* == Unit tests =========================================================== */
+
+static char *_wlmtk_trace_test_write(void);
+static size_t _wlmtk_trace_test_count(
+    const char *haystack_ptr,
+    const char *needle_ptr);
+static void *_wlmtk_trace_test_thread(void *arg_ptr);
+
+static void test_span(bs_test_t *test_ptr);
+static void test_wrap(bs_test_t *test_ptr);
+static void test_threads(bs_test_t *test_ptr);
+static void test_hotspots(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_trace_test_cases[] = {
+    { 1, "span", test_span },
+    { 1, "wrap", test_wrap },
+    { 1, "threads", test_threads },
+    { 1, "hotspots", test_hotspots },
+    { 0, NULL, NULL }
+};
+
+/** Arguments for @ref _wlmtk_trace_test_thread. */
+typedef struct {
+    /** Synchronizes the thread's steps with the test. */
+    pthread_barrier_t         barrier;
+    /** Thread ID of the thread. */
+    pid_t                     tid;
+} wlmtk_trace_test_thread_arg_t;
+
+/* ------------------------------------------------------------------------- */
+/** @return The trace, written into a buffer that must be free'd. Or NULL. */
+char *_wlmtk_trace_test_write(void)
+{
+    char *buf_ptr = NULL;
+    size_t size = 0;
+    FILE *file_ptr = open_memstream(&buf_ptr, &size);
+    if (NULL == file_ptr) return NULL;
+    bool rv = wlmtk_trace_write(file_ptr);
+    fclose(file_ptr);
+    if (!rv) {
+        free(buf_ptr);
+        return NULL;
+    }
+    return buf_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Number of occurrences of `needle_ptr` in `haystack_ptr`. */
+size_t _wlmtk_trace_test_count(
+    const char *haystack_ptr,
+    const char *needle_ptr)
+{
+    size_t count = 0;
+    for (const char *s = strstr(haystack_ptr, needle_ptr);
+         NULL != s;
+         s = strstr(s + 1, needle_ptr)) {
+        ++count;
+    }
+    return count;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Records a span, and waits for the test to check it before exiting. */
+void *_wlmtk_trace_test_thread(void *arg_ptr)
+{
+    wlmtk_trace_test_thread_arg_t *a_ptr = arg_ptr;
+    wlmtk_trace_span_t span = wlmtk_trace_span_begin("test_thread");
+    wlmtk_trace_span_end(&span);
+    a_ptr->tid = (pid_t)syscall(SYS_gettid);
+    pthread_barrier_wait(&a_ptr->barrier);
+    pthread_barrier_wait(&a_ptr->barrier);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** A scoped span gets recorded when the scope is left. */
+void test_span(bs_test_t *test_ptr)
+{
+    {
+        WLMTK_TRACE_SPAN("test_span");
+    }
+
+    char *buf_ptr = _wlmtk_trace_test_write();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, buf_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, strncmp(buf_ptr, "{\"traceEvents\":[", 16));
+#if defined(WLMTK_TRACE_DISABLED)
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, strstr(buf_ptr, "test_span"));
+#else  // defined(WLMTK_TRACE_DISABLED)
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL,
+        strstr(buf_ptr, "{\"name\":\"test_span\",\"cat\":\"wlmaker\","
+               "\"ph\":\"X\",\"ts\":"));
+#endif  // defined(WLMTK_TRACE_DISABLED)
+    free(buf_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Older spans get overwritten once the ring is full. */
+void test_wrap(bs_test_t *test_ptr)
+{
+    wlmtk_trace_span_t span = wlmtk_trace_span_begin("test_wrap_old");
+    wlmtk_trace_span_end(&span);
+    for (size_t i = 0; i < WLMTK_TRACE_EVENTS; ++i) {
+        span = wlmtk_trace_span_begin("test_wrap_new");
+        wlmtk_trace_span_end(&span);
+    }
+
+    char *buf_ptr = _wlmtk_trace_test_write();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, buf_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, strstr(buf_ptr, "test_wrap_old"));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMTK_TRACE_EVENTS,
+        _wlmtk_trace_test_count(buf_ptr, "\"test_wrap_new\""));
+    free(buf_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Spans are reported with their thread's ID, until the thread exits. */
+void test_threads(bs_test_t *test_ptr)
+{
+    wlmtk_trace_test_thread_arg_t arg = {};
+    BS_TEST_VERIFY_TRUE_OR_RETURN(
+        test_ptr, 0 == pthread_barrier_init(&arg.barrier, NULL, 2));
+    pthread_t thread;
+    if (0 != pthread_create(&thread, NULL, _wlmtk_trace_test_thread, &arg)) {
+        BS_TEST_FAIL(test_ptr, "Failed pthread_create");
+        pthread_barrier_destroy(&arg.barrier);
+        return;
+    }
+    pthread_barrier_wait(&arg.barrier);
+
+    // The thread is the only one with this ID, and recorded only one span.
+    char expected[32];
+    snprintf(expected, sizeof(expected), "\"tid\":%d}", arg.tid);
+    char *buf_ptr = _wlmtk_trace_test_write();
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, buf_ptr);
+    if (NULL != buf_ptr) {
+        BS_TEST_VERIFY_NEQ(test_ptr, NULL, strstr(buf_ptr, "\"test_thread\""));
+        BS_TEST_VERIFY_EQ(
+            test_ptr, 1, _wlmtk_trace_test_count(buf_ptr, expected));
+        free(buf_ptr);
+    }
+
+    pthread_barrier_wait(&arg.barrier);
+    pthread_join(thread, NULL);
+    pthread_barrier_destroy(&arg.barrier);
+
+    buf_ptr = _wlmtk_trace_test_write();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, buf_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, strstr(buf_ptr, "test_thread"));
+    free(buf_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Hotspots aggregate by name, ordered by total duration. */
+void test_hotspots(bs_test_t *test_ptr)
+{
+    static const char *short_ptr = "test_hotspots_short";
+    static const char *long_ptr = "test_hotspots_long";
+    uint64_t since_nsec = _wlmtk_trace_now_nsec();
+
+    for (int i = 0; i < 3; ++i) {
+        wlmtk_trace_span_t span = wlmtk_trace_span_begin(short_ptr);
+        span.begin_nsec -= 1000;
+        wlmtk_trace_span_end(&span);
+    }
+    wlmtk_trace_span_t span = wlmtk_trace_span_begin(long_ptr);
+    span.begin_nsec -= 1000000;
+    wlmtk_trace_span_end(&span);
+
+    wlmtk_trace_hotspot_t hotspots[4];
+    size_t n = wlmtk_trace_get_hotspots(since_nsec, hotspots, 4);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, 2 <= n);
+    BS_TEST_VERIFY_EQ(test_ptr, long_ptr, hotspots[0].name_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, hotspots[0].count);
+    BS_TEST_VERIFY_TRUE(test_ptr, 1000000 <= hotspots[0].max_nsec);
+    size_t i = 1;
+    while (i < n && hotspots[i].name_ptr != short_ptr) ++i;
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, i < n);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, hotspots[i].count);
+    BS_TEST_VERIFY_TRUE(test_ptr, 3000 <= hotspots[i].total_nsec);
+
+    // Only the top entry, if asked for just one.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 1, wlmtk_trace_get_hotspots(since_nsec, hotspots, 1));
+    BS_TEST_VERIFY_EQ(test_ptr, long_ptr, hotspots[0].name_ptr);
+}
+
+/* == End of trace.c ======================================================= */
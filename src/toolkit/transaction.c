@@ -0,0 +1,298 @@
+/* ========================================================================= */
+/**
+ * @file transaction.c
+ *
+ * @copyright
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "transaction.h"
+
+#include <libbase/libbase.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wayland-server-core.h>
+
+#include "window.h"
+
+/* == Declarations ========================================================= */
+
+/** State of a transaction. */
+struct _wlmtk_transaction_t {
+    /** Node within @ref _wlmtk_transactions. */
+    bs_dllist_node_t          dlnode;
+    /** Windows that have not yet committed their requested configures. */
+    wlmtk_window_t            **window_ptrs;
+    /** Number of elements in use at `window_ptrs`. */
+    size_t                    windows_size;
+    /** Allocated number of elements at `window_ptrs`. */
+    size_t                    windows_capacity;
+    /** Whether @ref wlmtk_transaction_commit was called. */
+    bool                      committed;
+    /** Timer for the timeout, once committed. */
+    struct wl_event_source    *timer_ptr;
+};
+
+static void _wlmtk_transaction_complete(wlmtk_transaction_t *transaction_ptr);
+static int _wlmtk_transaction_handle_timer(void *data_ptr);
+
+/* == Data ================================================================= */
+
+/** Event loop for the transaction timeouts. NULL if not enabled. */
+static struct wl_event_loop   *_wlmtk_transaction_event_loop_ptr = NULL;
+/** Committed transactions, still waiting for their windows. */
+static bs_dllist_t            _wlmtk_transactions;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_transaction_enable(struct wl_event_loop *wl_event_loop_ptr)
+{
+    _wlmtk_transaction_event_loop_ptr = wl_event_loop_ptr;
+    if (NULL != wl_event_loop_ptr) return;
+
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = _wlmtk_transactions.head_ptr)) {
+        _wlmtk_transaction_complete(
+            BS_CONTAINER_OF(dlnode_ptr, wlmtk_transaction_t, dlnode));
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+wlmtk_transaction_t *wlmtk_transaction_create(void)
+{
+    if (NULL == _wlmtk_transaction_event_loop_ptr) return NULL;
+    return logged_calloc(1, sizeof(wlmtk_transaction_t));
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_transaction_add_window(
+    wlmtk_transaction_t *transaction_ptr,
+    wlmtk_window_t *window_ptr)
+{
+    if (NULL == transaction_ptr ||
+        NULL != wlmtk_window_get_transaction(window_ptr)) return true;
+
+    if (transaction_ptr->windows_size >= transaction_ptr->windows_capacity) {
+        size_t capacity = BS_MAX(8U, 2 * transaction_ptr->windows_capacity);
+        wlmtk_window_t **window_ptrs = logged_calloc(
+            capacity, sizeof(wlmtk_window_t*));
+        if (NULL == window_ptrs) return false;
+        if (NULL != transaction_ptr->window_ptrs) {
+            memcpy(window_ptrs, transaction_ptr->window_ptrs,
+                   transaction_ptr->windows_size * sizeof(wlmtk_window_t*));
+            free(transaction_ptr->window_ptrs);
+        }
+        transaction_ptr->window_ptrs = window_ptrs;
+        transaction_ptr->windows_capacity = capacity;
+    }
+
+    // Nothing to wait for, if the window has no pending updates.
+    if (!wlmtk_window_set_transaction(window_ptr, transaction_ptr)) {
+        return true;
+    }
+    transaction_ptr->window_ptrs[transaction_ptr->windows_size++] =
+        window_ptr;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_transaction_commit(wlmtk_transaction_t *transaction_ptr)
+{
+    if (NULL == transaction_ptr) return;
+    BS_ASSERT(!transaction_ptr->committed);
+    transaction_ptr->committed = true;
+    bs_dllist_push_back(&_wlmtk_transactions, &transaction_ptr->dlnode);
+
+    if (0 == transaction_ptr->windows_size ||
+        NULL == _wlmtk_transaction_event_loop_ptr) {
+        _wlmtk_transaction_complete(transaction_ptr);
+        return;
+    }
+
+    transaction_ptr->timer_ptr = wl_event_loop_add_timer(
+        _wlmtk_transaction_event_loop_ptr,
+        _wlmtk_transaction_handle_timer,
+        transaction_ptr);
+    if (NULL == transaction_ptr->timer_ptr) {
+        bs_log(BS_WARNING, "Failed wl_event_loop_add_timer(%p, %p, %p)",
+               _wlmtk_transaction_event_loop_ptr,
+               _wlmtk_transaction_handle_timer,
+               transaction_ptr);
+        _wlmtk_transaction_complete(transaction_ptr);
+        return;
+    }
+    wl_event_source_timer_update(
+        transaction_ptr->timer_ptr, WLMTK_TRANSACTION_TIMEOUT_MSEC);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_transaction_window_done(
+    wlmtk_transaction_t *transaction_ptr,
+    wlmtk_window_t *window_ptr)
+{
+    for (size_t i = 0; i < transaction_ptr->windows_size; ++i) {
+        if (transaction_ptr->window_ptrs[i] != window_ptr) continue;
+        wlmtk_window_set_transaction(window_ptr, NULL);
+        transaction_ptr->window_ptrs[i] =
+            transaction_ptr->window_ptrs[--transaction_ptr->windows_size];
+        break;
+    }
+
+    if (transaction_ptr->committed && 0 == transaction_ptr->windows_size) {
+        _wlmtk_transaction_complete(transaction_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_transaction_frames_held(void)
+{
+    return !bs_dllist_empty(&_wlmtk_transactions);
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Completes the transaction: Releases the remaining windows and destroys it.
+ *
+ * @param transaction_ptr
+ */
+void _wlmtk_transaction_complete(wlmtk_transaction_t *transaction_ptr)
+{
+    for (size_t i = 0; i < transaction_ptr->windows_size; ++i) {
+        wlmtk_window_set_transaction(transaction_ptr->window_ptrs[i], NULL);
+    }
+    transaction_ptr->windows_size = 0;
+
+    if (NULL != transaction_ptr->timer_ptr) {
+        wl_event_source_remove(transaction_ptr->timer_ptr);
+        transaction_ptr->timer_ptr = NULL;
+    }
+    if (transaction_ptr->committed) {
+        bs_dllist_remove(&_wlmtk_transactions, &transaction_ptr->dlnode);
+    }
+    if (NULL != transaction_ptr->window_ptrs) {
+        free(transaction_ptr->window_ptrs);
+        transaction_ptr->window_ptrs = NULL;
+    }
+    free(transaction_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Timer callback: Completes the transaction, late windows or not. */
+int _wlmtk_transaction_handle_timer(void *data_ptr)
+{
+    wlmtk_transaction_t *transaction_ptr = data_ptr;
+    bs_log(BS_DEBUG, "Transaction %p: Timed out, with %zu windows pending.",
+           transaction_ptr, transaction_ptr->windows_size);
+    _wlmtk_transaction_complete(transaction_ptr);
+    return 0;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_commit(bs_test_t *test_ptr);
+static void test_disable(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_transaction_test_cases[] = {
+    { 1, "commit", test_commit },
+    { 1, "disable", test_disable },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Frames are held until all windows committed. */
+void test_commit(bs_test_t *test_ptr)
+{
+    // Not enabled: No transaction, and no-ops.
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, wlmtk_transaction_create());
+    wlmtk_transaction_commit(NULL);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_transaction_frames_held());
+
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    wlmtk_transaction_enable(wl_event_loop_ptr);
+    wlmtk_fake_window_t *fw1_ptr = wlmtk_fake_window_create();
+    wlmtk_fake_window_t *fw2_ptr = wlmtk_fake_window_create();
+    wlmtk_fake_window_t *fw3_ptr = wlmtk_fake_window_create();
+
+    wlmtk_transaction_t *t_ptr = wlmtk_transaction_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, t_ptr);
+    wlmtk_window_request_position_and_size(fw1_ptr->window_ptr, 0, 0, 10, 10);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_transaction_add_window(t_ptr, fw1_ptr->window_ptr));
+    wlmtk_window_request_position_and_size(fw2_ptr->window_ptr, 0, 0, 20, 10);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_transaction_add_window(t_ptr, fw2_ptr->window_ptr));
+    // Window 3 has nothing pending, so is ignored.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_transaction_add_window(t_ptr, fw3_ptr->window_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL, wlmtk_window_get_transaction(fw3_ptr->window_ptr));
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_transaction_frames_held());
+
+    // Commit of window 1 before the transaction is committed.
+    wlmtk_fake_window_commit_size(fw1_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL, wlmtk_window_get_transaction(fw1_ptr->window_ptr));
+    wlmtk_transaction_commit(t_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_transaction_frames_held());
+
+    // The last window commits: Complete.
+    wlmtk_fake_window_commit_size(fw2_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_transaction_frames_held());
+
+    // A destroyed window completes, too.
+    t_ptr = wlmtk_transaction_create();
+    wlmtk_window_request_position_and_size(fw3_ptr->window_ptr, 0, 0, 30, 10);
+    wlmtk_transaction_add_window(t_ptr, fw3_ptr->window_ptr);
+    wlmtk_transaction_commit(t_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_transaction_frames_held());
+    wlmtk_fake_window_destroy(fw3_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_transaction_frames_held());
+
+    wlmtk_fake_window_destroy(fw2_ptr);
+    wlmtk_fake_window_destroy(fw1_ptr);
+    wlmtk_transaction_enable(NULL);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Disabling completes pending transactions. */
+void test_disable(bs_test_t *test_ptr)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    wlmtk_transaction_enable(wl_event_loop_ptr);
+    wlmtk_fake_window_t *fw_ptr = wlmtk_fake_window_create();
+
+    wlmtk_transaction_t *t_ptr = wlmtk_transaction_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, t_ptr);
+    wlmtk_window_request_position_and_size(fw_ptr->window_ptr, 0, 0, 10, 10);
+    wlmtk_transaction_add_window(t_ptr, fw_ptr->window_ptr);
+    wlmtk_transaction_commit(t_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_transaction_frames_held());
+
+    wlmtk_transaction_enable(NULL);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_transaction_frames_held());
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL, wlmtk_window_get_transaction(fw_ptr->window_ptr));
+
+    wlmtk_fake_window_destroy(fw_ptr);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
+/* == End of transaction.c ================================================= */
@@ -20,8 +20,14 @@
 
 #include "util.h"
 
+#include <inttypes.h>
 #include <libbase/libbase.h>
+#include <limits.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
 #include <wayland-util.h>
 
 /* == Declarations ========================================================= */
@@ -51,6 +57,30 @@ bool wlmtk_util_wl_list_for_each(
     return rv;
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_util_client_resolve(wlmtk_util_client_t *client_ptr)
+{
+    client_ptr->cmdline[0] = '\0';
+    if (0 == client_ptr->pid) return;
+
+    // The command line's arguments are NUL-separated: Keeps just the first.
+    char fname[PATH_MAX], cmdline[PATH_MAX];
+    snprintf(fname, sizeof(fname), "/proc/%"PRIdMAX"/cmdline",
+             (intmax_t)client_ptr->pid);
+    ssize_t read_bytes = bs_file_read_buffer(fname, cmdline, sizeof(cmdline));
+    if (0 >= read_bytes) return;
+    snprintf(client_ptr->cmdline, sizeof(client_ptr->cmdline), "%s",
+             cmdline);
+}
+
+/* ------------------------------------------------------------------------- */
+const char *wlmtk_util_client_executable(
+    const wlmtk_util_client_t *client_ptr)
+{
+    const char *slash_ptr = strrchr(client_ptr->cmdline, '/');
+    return (NULL != slash_ptr) ? slash_ptr + 1 : client_ptr->cmdline;
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmtk_util_connect_listener_signal(
     struct wl_signal *signal_ptr,
@@ -98,6 +128,38 @@ void wlmtk_util_clear_test_listener(
     test_listener_ptr->last_data_ptr = NULL;
 }
 
+/* ------------------------------------------------------------------------- */
+bool wlmtk_util_simd_supported(wlmtk_util_simd_t simd)
+{
+    switch (simd) {
+    case WLMTK_UTIL_SIMD_NONE:
+        return true;
+#if defined(WLMTK_UTIL_SIMD_X86)
+    case WLMTK_UTIL_SIMD_SSE2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2");
+    case WLMTK_UTIL_SIMD_AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#elif defined(WLMTK_UTIL_SIMD_NEON)
+    case WLMTK_UTIL_SIMD_AARCH64_NEON:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+wlmtk_util_simd_t wlmtk_util_simd_best(void)
+{
+    for (int simd = WLMTK_UTIL_SIMD_MAX - 1; simd > WLMTK_UTIL_SIMD_NONE;
+         --simd) {
+        if (wlmtk_util_simd_supported(simd)) return simd;
+    }
+    return WLMTK_UTIL_SIMD_NONE;
+}
+
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -121,10 +183,14 @@ void _wlmtk_util_test_listener_handler(
 
 static void test_wl_list_for_each(bs_test_t *test_ptr);
 static void test_listener(bs_test_t *test_ptr);
+static void test_client(bs_test_t *test_ptr);
+static void test_simd(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_util_test_cases[] = {
     { 1, "wl_list_for_each", test_wl_list_for_each },
     { 1, "listener", test_listener },
+    { 1, "client", test_client },
+    { 1, "simd", test_simd },
     { 0, NULL, NULL }
 };
 
@@ -228,4 +294,42 @@ static void test_listener(bs_test_t *test_ptr)
     wlmtk_util_disconnect_test_listener(&l1);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Resolves the process metadata, and the executable's name. */
+static void test_client(bs_test_t *test_ptr)
+{
+    wlmtk_util_client_t client = { .pid = getpid() };
+    wlmtk_util_client_resolve(&client);
+    BS_TEST_VERIFY_NEQ(test_ptr, '\0', client.cmdline[0]);
+    const char *executable_ptr = wlmtk_util_client_executable(&client);
+    BS_TEST_VERIFY_NEQ(test_ptr, '\0', executable_ptr[0]);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, strchr(executable_ptr, '/'));
+
+    // Without a process: Stays empty.
+    client = (wlmtk_util_client_t){ .cmdline = "stale" };
+    wlmtk_util_client_resolve(&client);
+    BS_TEST_VERIFY_STREQ(test_ptr, "", client.cmdline);
+    BS_TEST_VERIFY_STREQ(test_ptr, "", wlmtk_util_client_executable(&client));
+
+    strcpy(client.cmdline, "/usr/bin/foot");
+    BS_TEST_VERIFY_STREQ(
+        test_ptr, "foot", wlmtk_util_client_executable(&client));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies the preferred SIMD instruction set is a supported one. */
+static void test_simd(bs_test_t *test_ptr)
+{
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_util_simd_supported(WLMTK_UTIL_SIMD_NONE));
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlmtk_util_simd_supported(WLMTK_UTIL_SIMD_MAX));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_util_simd_supported(wlmtk_util_simd_best()));
+#if defined(WLMTK_UTIL_SIMD_X86)
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlmtk_util_simd_supported(WLMTK_UTIL_SIMD_AARCH64_NEON));
+#endif
+}
+
 /* == End of util.c ======================================================== */
@@ -25,6 +25,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 /// Include unstable interfaces of wlroots.
 #define WLR_USE_UNSTABLE
 #include <wlr/types/wlr_keyboard.h>
@@ -33,21 +34,27 @@
 #include <wlr/types/wlr_seat.h>
 #undef WLR_USE_UNSTABLE
 
+#include "animation.h"
 #include "bordered.h"
 #include "box.h"
 #include "container.h"
+#include "gfxbuf.h"  // IWYU pragma: keep
 #include "input.h"
 #include "resizebar.h"
 #include "surface.h"
 #include "test.h"  // IWYU pragma: keep
+#include "thumbnail.h"
 #include "tile.h"
 #include "titlebar.h"
+#include "transaction.h"
 #include "workspace.h"
 
 /* == Declarations ========================================================= */
 
-/** Maximum number of pending state updates. */
+/** Number of pending state updates held without allocating. Power of 2. */
 #define WLMTK_WINDOW_MAX_PENDING 64
+/** Limit to how far the ring of pending updates may grow. Power of 2. */
+#define WLMTK_WINDOW_MAX_PENDING_LIMIT 4096
 
 /** Virtual method table for the window. */
 typedef struct {
@@ -64,8 +71,6 @@ typedef struct {
 
 /** Pending positional updates for @ref wlmtk_window_t::content_ptr. */
 typedef struct {
-    /** Node within @ref wlmtk_window_t::pending_updates. */
-    bs_dllist_node_t          dlnode;
     /** Serial of the update. */
     uint32_t                  serial;
     /** Pending X position of the surface. */
@@ -104,6 +109,10 @@ struct _wlmtk_window_t {
     struct wlr_seat           *wlr_seat_ptr;
     /** Element in @ref wlmtk_workspace_t::windows, when mapped. */
     bs_dllist_node_t          dlnode;
+    /** The group of the client's windows, when mapped. Or NULL. */
+    wlmtk_window_group_t      *group_ptr;
+    /** Element of the windows of @ref wlmtk_window_t::group_ptr. */
+    bs_dllist_node_t          group_dlnode;
 
     /** Content of the window. */
     wlmtk_content_t           *content_ptr;
@@ -121,13 +130,51 @@ struct _wlmtk_window_t {
 
     /** Window title. Set through @ref wlmtk_window_set_title. */
     char                      *title_ptr;
+    /**
+     * Former title, still shown by the titlebar while the redraw is
+     * deferred. See @ref wlmtk_window_defer_titles.
+     */
+    char                      *drawn_title_ptr;
+    /** Element of `_wlmtk_window_title_queue`, while queued. */
+    bs_dllist_node_t          title_dlnode;
+    /** Whether `title_dlnode` is in `_wlmtk_window_title_queue`. */
+    bool                      title_queued;
 
-    /** Pending updates. */
-    bs_dllist_t               pending_updates;
-    /** List of udpates currently available. */
-    bs_dllist_t               available_updates;
-    /** Pre-alloocated updates. */
+    /**
+     * Ring of pending updates, ordered by serial. Points to
+     * `pre_allocated_updates`, unless it had to grow beyond.
+     */
+    wlmtk_pending_update_t    *pending_updates_ptr;
+    /** Capacity of `pending_updates_ptr`. A power of 2. */
+    size_t                    pending_capacity;
+    /** Index of the oldest pending update in `pending_updates_ptr`. */
+    size_t                    pending_head;
+    /** Number of pending updates. */
+    size_t                    pending_size;
+    /** Pre-allocated updates. */
     wlmtk_pending_update_t    pre_allocated_updates[WLMTK_WINDOW_MAX_PENDING];
+    /** Whether @ref wlmtk_window_serial was called yet. */
+    bool                      has_acked_serial;
+    /** Most recent serial passed to @ref wlmtk_window_serial. */
+    uint32_t                  acked_serial;
+    /** Counts calls to @ref wlmtk_window_serial. Detects synchronous acks. */
+    uint64_t                  serial_calls;
+
+    /** Transaction to report to, once there are no more pending updates. */
+    wlmtk_transaction_t       *transaction_ptr;
+
+    /** Whether a paced request is in flight, ie. not yet committed. */
+    bool                      paced_in_flight;
+    /** Serial of the paced request in flight. */
+    uint32_t                  paced_serial;
+    /** Time when the paced request in flight was sent. */
+    uint32_t                  paced_time_msec;
+    /** Whether there is a coalesced request, waiting to be sent. */
+    bool                      paced_pending;
+    /** Position and size of the coalesced request. */
+    struct wlr_box            paced_box;
+    /** Time of the coalesced request. */
+    uint32_t                  paced_pending_time_msec;
 
     /** This window's properties. */
     uint32_t                  properties;
@@ -161,9 +208,16 @@ struct _wlmtk_window_t {
     bool                      server_side_decorated;
     /** Stores whether the window is activated (keyboard focus). */
     bool                      activated;
+    /** Whether the window is hibernated. See @ref wlmtk_window_hibernate. */
+    bool                      hibernated;
+
+    /** The window's style. Interned, see @ref wlmtk_style_intern. */
+    const wlmtk_window_style_t *style_ptr;
 
-    /** The style used for this window. */
-    wlmtk_window_style_t      style;
+    /** Thumbnail of the window. Created on first capture. */
+    wlmtk_thumbnail_t         *thumbnail_ptr;
+    /** Scale of the output the decorations are shown on. At least 1. */
+    double                    decoration_scale;
 };
 
 /** State of a fake window: Includes the public record and the window. */
@@ -199,7 +253,7 @@ static void _wlmtk_window_create_resizebar(wlmtk_window_t *window_ptr);
 static void _wlmtk_window_destroy_titlebar(wlmtk_window_t *window_ptr);
 static void _wlmtk_window_destroy_resizebar(wlmtk_window_t *window_ptr);
 static void _wlmtk_window_apply_decoration(wlmtk_window_t *window_ptr);
-static void _wlmtk_window_request_position_and_size_decorated(
+static uint32_t _wlmtk_window_request_position_and_size_decorated(
     wlmtk_window_t *window_ptr,
     int x,
     int y,
@@ -209,20 +263,55 @@ static void _wlmtk_window_request_position_and_size_decorated(
     bool include_resizebar,
     bool include_extra);
 
-static wlmtk_pending_update_t *_wlmtk_window_prepare_update(
-    wlmtk_window_t *window_ptr);
-static void _wlmtk_window_release_update(
+static void _wlmtk_window_send_paced(
+    wlmtk_window_t *window_ptr,
+    const struct wlr_box *box_ptr,
+    uint32_t time_msec);
+static uint32_t _wlmtk_window_request_size(
+    wlmtk_window_t *window_ptr,
+    int x,
+    int y,
+    int width,
+    int height);
+static void _wlmtk_window_push_update(
+    wlmtk_window_t *window_ptr,
+    const wlmtk_pending_update_t *update_ptr);
+static bool _wlmtk_window_grow_updates(wlmtk_window_t *window_ptr);
+static wlmtk_pending_update_t *_wlmtk_window_update_at(
     wlmtk_window_t *window_ptr,
-    wlmtk_pending_update_t *update_ptr);
+    size_t idx);
+static void _wlmtk_window_apply_updates(
+    wlmtk_window_t *window_ptr,
+    size_t count);
 
 static void _wlmtk_window_menu_request_close_handler(
     struct wl_listener *listener_ptr,
     void *data_ptr);
+static void _wlmtk_window_queue_title(wlmtk_window_t *window_ptr);
+static void _wlmtk_window_settle_title(
+    wlmtk_window_t *window_ptr,
+    bool redraw);
+static int _wlmtk_window_handle_title_timer(void *data_ptr);
+static uint64_t _wlmtk_window_now_msec(void);
 static struct wlr_output *_wlmtk_window_get_wlr_output(
     wlmtk_window_t *window_ptr);
 
 /* == Data ================================================================= */
 
+/** Duration of the shading animation. */
+static const uint64_t _wlmtk_window_shade_msec = 150;
+
+/** Minimum interval between title redraws: About one frame, at 60Hz. */
+static const uint64_t _wlmtk_window_title_msec = 16;
+/** Timer for deferred title redraws. See @ref wlmtk_window_defer_titles. */
+static struct wl_event_source *_wlmtk_window_title_timer_ptr = NULL;
+/** Whether `_wlmtk_window_title_timer_ptr` is armed. */
+static bool _wlmtk_window_title_timer_armed = false;
+/** Windows with a deferred title redraw, by `title_dlnode`. */
+static bs_dllist_t _wlmtk_window_title_queue = {};
+/** When deferred titles were last redrawn, in msec of CLOCK_MONOTONIC. */
+static uint64_t _wlmtk_window_title_flush_msec = 0;
+
 /** Virtual method table for the window's element superclass. */
 static const wlmtk_element_vmt_t window_element_vmt = {
     .pointer_button = _wlmtk_window_element_pointer_button,
@@ -255,7 +344,12 @@ wlmtk_window_t *wlmtk_window_create(
 {
     wlmtk_window_t *window_ptr = logged_calloc(1, sizeof(wlmtk_window_t));
     if (NULL == window_ptr) return NULL;
-    window_ptr->style = *style_ptr;
+    window_ptr->style_ptr = WLMTK_STYLE_INTERN(style_ptr);
+    window_ptr->decoration_scale = 1.0;
+    if (NULL == window_ptr->style_ptr) {
+        free(window_ptr);
+        return NULL;
+    }
     window_ptr->wlr_seat_ptr = wlr_seat_ptr;
 
     if (!_wlmtk_window_init(
@@ -380,6 +474,54 @@ void wlmtk_window_set_server_side_decorated(
 
 }
 
+/* ------------------------------------------------------------------------- */
+bool wlmtk_window_set_style(
+    wlmtk_window_t *window_ptr,
+    const wlmtk_window_style_t *style_ptr)
+{
+    const wlmtk_window_style_t *new_style_ptr = WLMTK_STYLE_INTERN(style_ptr);
+    if (NULL == new_style_ptr) return false;
+    if (new_style_ptr == window_ptr->style_ptr) {
+        wlmtk_style_release(new_style_ptr);
+        return false;
+    }
+
+    // Decoration elements copy their style on creation. Drop the ones that
+    // changed, _wlmtk_window_apply_decoration() will re-create them.
+    if (NULL != window_ptr->titlebar_ptr &&
+        0 != memcmp(&window_ptr->style_ptr->titlebar,
+                    &new_style_ptr->titlebar,
+                    sizeof(new_style_ptr->titlebar))) {
+        wlmtk_box_remove_element(
+            &window_ptr->box,
+            wlmtk_titlebar_element(window_ptr->titlebar_ptr));
+        wlmtk_titlebar_destroy(window_ptr->titlebar_ptr);
+        window_ptr->titlebar_ptr = NULL;
+    }
+    if (NULL != window_ptr->resizebar_ptr &&
+        0 != memcmp(&window_ptr->style_ptr->resizebar,
+                    &new_style_ptr->resizebar,
+                    sizeof(new_style_ptr->resizebar))) {
+        wlmtk_box_remove_element(
+            &window_ptr->box,
+            wlmtk_resizebar_element(window_ptr->resizebar_ptr));
+        wlmtk_resizebar_destroy(window_ptr->resizebar_ptr);
+        window_ptr->resizebar_ptr = NULL;
+    }
+
+    wlmtk_style_release(window_ptr->style_ptr);
+    window_ptr->style_ptr = new_style_ptr;
+    wlmtk_box_set_style(&window_ptr->box, &window_ptr->style_ptr->margin);
+    _wlmtk_window_apply_decoration(window_ptr);
+
+    if (window_ptr->shaded && NULL != window_ptr->resizebar_ptr) {
+        wlmtk_element_set_visible(
+            wlmtk_resizebar_element(window_ptr->resizebar_ptr), false);
+    }
+    wlmtk_container_update_layout(&window_ptr->box.super_container);
+    return true;
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmtk_window_set_properties(
     wlmtk_window_t *window_ptr,
@@ -401,6 +543,12 @@ void wlmtk_window_set_properties(
     }
 }
 
+/* ------------------------------------------------------------------------- */
+uint32_t wlmtk_window_get_properties(wlmtk_window_t *window_ptr)
+{
+    return window_ptr->properties;
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmtk_window_set_title(
     wlmtk_window_t *window_ptr,
@@ -417,13 +565,27 @@ void wlmtk_window_set_title(
         BS_ASSERT(NULL != new_title_ptr);
     }
 
-    if (NULL != window_ptr->title_ptr) {
-        if (0 == strcmp(window_ptr->title_ptr, new_title_ptr)) {
-            free(new_title_ptr);
-            return;
+    if (NULL != window_ptr->title_ptr &&
+        0 == strcmp(window_ptr->title_ptr, new_title_ptr)) {
+        free(new_title_ptr);
+        return;
+    }
+
+    if (NULL != window_ptr->titlebar_ptr &&
+        NULL != _wlmtk_window_title_timer_ptr) {
+        // The titlebar keeps pointing to the title it shows. Keep that one
+        // until the deferred redraw, and drop any intermediate title.
+        if (NULL == window_ptr->drawn_title_ptr) {
+            window_ptr->drawn_title_ptr = window_ptr->title_ptr;
+        } else {
+            free(window_ptr->title_ptr);
         }
-        free(window_ptr->title_ptr);
+        window_ptr->title_ptr = new_title_ptr;
+        _wlmtk_window_queue_title(window_ptr);
+        return;
     }
+
+    if (NULL != window_ptr->title_ptr) free(window_ptr->title_ptr);
     window_ptr->title_ptr = new_title_ptr;
 
     if (NULL != window_ptr->titlebar_ptr) {
@@ -432,6 +594,32 @@ void wlmtk_window_set_title(
     }
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_window_defer_titles(struct wl_event_loop *wl_event_loop_ptr)
+{
+    if (NULL != _wlmtk_window_title_timer_ptr) {
+        wl_event_source_remove(_wlmtk_window_title_timer_ptr);
+        _wlmtk_window_title_timer_ptr = NULL;
+        _wlmtk_window_title_timer_armed = false;
+    }
+
+    // Redraws what is pending, also when switching to another loop.
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = _wlmtk_window_title_queue.head_ptr)) {
+        _wlmtk_window_settle_title(
+            BS_CONTAINER_OF(dlnode_ptr, wlmtk_window_t, title_dlnode),
+            true);
+    }
+
+    if (NULL == wl_event_loop_ptr) return;
+    _wlmtk_window_title_timer_ptr = wl_event_loop_add_timer(
+        wl_event_loop_ptr, _wlmtk_window_handle_title_timer, NULL);
+    if (NULL == _wlmtk_window_title_timer_ptr) {
+        bs_log(BS_WARNING, "Failed wl_event_loop_add_timer(%p, ...). "
+               "Titles will be redrawn immediately.", wl_event_loop_ptr);
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 const char *wlmtk_window_get_title(wlmtk_window_t *window_ptr)
 {
@@ -549,15 +737,8 @@ void wlmtk_window_request_fullscreen_position(
     struct wlr_box box = wlmtk_workspace_get_fullscreen_extents(
         wlmtk_window_get_workspace(window_ptr),
         wlr_output_ptr);
-    uint32_t serial = wlmtk_content_request_size(
-        window_ptr->content_ptr, box.width, box.height);
-    wlmtk_pending_update_t *pending_update_ptr = _wlmtk_window_prepare_update(
-        window_ptr);
-    pending_update_ptr->serial = serial;
-    pending_update_ptr->x = box.x;
-    pending_update_ptr->y = box.y;
-    pending_update_ptr->width = box.width;
-    pending_update_ptr->height = box.height;
+    _wlmtk_window_request_size(
+        window_ptr, box.x, box.y, box.width, box.height);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -582,6 +763,42 @@ bool wlmtk_window_is_fullscreen(wlmtk_window_t *window_ptr)
     return window_ptr->fullscreen;
 }
 
+/* ------------------------------------------------------------------------- */
+struct wlr_buffer *wlmtk_window_thumbnail(wlmtk_window_t *window_ptr)
+{
+    if (NULL == window_ptr->thumbnail_ptr) {
+        window_ptr->thumbnail_ptr = wlmtk_thumbnail_create(
+            wlmtk_window_element(window_ptr),
+            WLMTK_WINDOW_THUMBNAIL_SIZE,
+            WLMTK_WINDOW_THUMBNAIL_SIZE);
+        if (NULL == window_ptr->thumbnail_ptr) return NULL;
+    }
+    wlmtk_thumbnail_capture(window_ptr->thumbnail_ptr);
+    return wlmtk_thumbnail_buffer(window_ptr->thumbnail_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_window_invalidate_thumbnail(wlmtk_window_t *window_ptr)
+{
+    if (NULL == window_ptr->thumbnail_ptr) return;
+    wlmtk_thumbnail_invalidate(window_ptr->thumbnail_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_window_set_decoration_scale(wlmtk_window_t *window_ptr,
+                                       double scale)
+{
+    scale = BS_MAX(1.0, scale);
+    if (window_ptr->decoration_scale == scale) return;
+    window_ptr->decoration_scale = scale;
+    if (NULL != window_ptr->titlebar_ptr) {
+        wlmtk_titlebar_set_scale(window_ptr->titlebar_ptr, scale);
+    }
+    if (NULL != window_ptr->resizebar_ptr) {
+        wlmtk_resizebar_set_scale(window_ptr->resizebar_ptr, scale);
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmtk_window_request_shaded(wlmtk_window_t *window_ptr, bool shaded)
 {
@@ -589,6 +806,21 @@ void wlmtk_window_request_shaded(wlmtk_window_t *window_ptr, bool shaded)
         !window_ptr->server_side_decorated ||
         window_ptr->shaded == shaded) return;
 
+    // Shading rolls up a snapshot, towards the titlebar. The client is not
+    // re-configured for it.
+    struct wlr_box box = wlmtk_element_get_dimensions_box(
+        wlmtk_window_element(window_ptr));
+    if (shaded && NULL != window_ptr->titlebar_ptr && 0 < box.height) {
+        struct wlr_box titlebar_box = wlmtk_element_get_dimensions_box(
+            wlmtk_titlebar_element(window_ptr->titlebar_ptr));
+        wlmtk_animation_props_t to = wlmtk_animation_props_identity;
+        to.clip = (double)titlebar_box.height / box.height;
+        wlmtk_animation_snapshot(
+            wlmtk_window_element(window_ptr),
+            &wlmtk_animation_props_identity, &to,
+            _wlmtk_window_shade_msec);
+    }
+
     wlmtk_element_set_visible(
         wlmtk_content_element(window_ptr->content_ptr), !shaded);
     if (NULL != window_ptr->resizebar_ptr) {
@@ -674,6 +906,95 @@ void wlmtk_window_set_position(wlmtk_window_t *window_ptr, int x, int y)
     wlmtk_element_set_position(wlmtk_window_element(window_ptr), x, y);
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_window_translate(wlmtk_window_t *window_ptr, int x, int y)
+{
+    window_ptr->organic_size.x = x;
+    window_ptr->organic_size.y = y;
+    wlmtk_element_t *element_ptr = wlmtk_window_element(window_ptr);
+    if (NULL == element_ptr->parent_container_ptr) {
+        wlmtk_element_set_position(element_ptr, x, y);
+        return;
+    }
+    wlmtk_container_translate_element(
+        element_ptr->parent_container_ptr, element_ptr, x, y);
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_window_hibernate(wlmtk_window_t *window_ptr)
+{
+    if (window_ptr->hibernated) return 0;
+    window_ptr->hibernated = true;
+
+    size_t bytes = 0;
+    if (NULL != window_ptr->titlebar_ptr) {
+        bytes += wlmtk_titlebar_hibernate(window_ptr->titlebar_ptr);
+    }
+    if (NULL != window_ptr->resizebar_ptr) {
+        bytes += wlmtk_resizebar_hibernate(window_ptr->resizebar_ptr);
+    }
+    return bytes;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_window_wake(wlmtk_window_t *window_ptr)
+{
+    if (!window_ptr->hibernated) return;
+    window_ptr->hibernated = false;
+
+    if (NULL != window_ptr->titlebar_ptr &&
+        !wlmtk_titlebar_wake(window_ptr->titlebar_ptr)) {
+        bs_log(BS_WARNING, "Failed wlmtk_titlebar_wake(%p)",
+               window_ptr->titlebar_ptr);
+    }
+    if (NULL != window_ptr->resizebar_ptr &&
+        !wlmtk_resizebar_wake(window_ptr->resizebar_ptr)) {
+        bs_log(BS_WARNING, "Failed wlmtk_resizebar_wake(%p)",
+               window_ptr->resizebar_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_window_get_footprint(
+    wlmtk_window_t *window_ptr,
+    wlmtk_memstat_footprint_t *footprint_ptr)
+{
+    *footprint_ptr = (wlmtk_memstat_footprint_t){};
+    size_t bytes = sizeof(wlmtk_window_t);
+    if (NULL != window_ptr->title_ptr) {
+        bytes += strlen(window_ptr->title_ptr) + 1;
+    }
+    if (NULL != window_ptr->drawn_title_ptr) {
+        bytes += strlen(window_ptr->drawn_title_ptr) + 1;
+    }
+    if (window_ptr->pending_updates_ptr !=
+        window_ptr->pre_allocated_updates) {
+        bytes += window_ptr->pending_capacity *
+            sizeof(wlmtk_pending_update_t);
+    }
+    wlmtk_memstat_footprint_add_struct(footprint_ptr, bytes);
+
+    if (NULL != window_ptr->titlebar_ptr) {
+        wlmtk_titlebar_add_footprint(window_ptr->titlebar_ptr, footprint_ptr);
+    }
+    if (NULL != window_ptr->resizebar_ptr) {
+        wlmtk_resizebar_add_footprint(
+            window_ptr->resizebar_ptr, footprint_ptr);
+    }
+    if (NULL != window_ptr->thumbnail_ptr) {
+        wlmtk_memstat_footprint_add_buffer(
+            footprint_ptr,
+            wlmtk_gfxbuf_wlr_buffer_bytes(
+                wlmtk_thumbnail_buffer(window_ptr->thumbnail_ptr)),
+            false);
+    }
+
+    wlmtk_memstat_footprint_add_scene_node(
+        footprint_ptr,
+        wlmtk_window_element(window_ptr)->wlr_scene_node_ptr,
+        wlmtk_content_element(window_ptr->content_ptr)->wlr_scene_node_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmtk_window_get_size(
     wlmtk_window_t *window_ptr,
@@ -686,12 +1007,12 @@ void wlmtk_window_get_size(
     *height_ptr = dimensions.height;
 
     if (NULL != window_ptr->titlebar_ptr) {
-        *height_ptr += window_ptr->style.titlebar.height +
-            window_ptr->style.margin.width;
+        *height_ptr += window_ptr->style_ptr->titlebar.height +
+            window_ptr->style_ptr->margin.width;
     }
     if (NULL != window_ptr->resizebar_ptr) {
-        *height_ptr += window_ptr->style.resizebar.height +
-            window_ptr->style.margin.width;
+        *height_ptr += window_ptr->style_ptr->resizebar.height +
+            window_ptr->style_ptr->margin.width;
     }
     *height_ptr += 2 * window_ptr->super_bordered.style.width;
 
@@ -710,6 +1031,34 @@ struct wlr_box wlmtk_window_get_position_and_size(
     return box;
 }
 
+/* ------------------------------------------------------------------------- */
+bool wlmtk_window_get_opaque_box(
+    wlmtk_window_t *window_ptr,
+    struct wlr_box *box_ptr)
+{
+    wlmtk_element_t *window_element_ptr = wlmtk_window_element(window_ptr);
+    if (!window_element_ptr->visible ||
+        window_ptr->shaded ||
+        !window_ptr->content_ptr->opaque) return false;
+
+    // Content is nested in the window's containers: Sum up the offsets.
+    struct wlr_box box = {};
+    for (wlmtk_element_t *e_ptr = wlmtk_content_element(
+             window_ptr->content_ptr);
+         NULL != e_ptr && e_ptr != window_element_ptr;
+         e_ptr = NULL != e_ptr->parent_container_ptr ?
+             &e_ptr->parent_container_ptr->super_element : NULL) {
+        box.x += e_ptr->x;
+        box.y += e_ptr->y;
+    }
+    box.x += window_element_ptr->x;
+    box.y += window_element_ptr->y;
+    wlmtk_content_get_size(window_ptr->content_ptr, &box.width, &box.height);
+    if (0 >= box.width || 0 >= box.height) return false;
+    *box_ptr = box;
+    return true;
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmtk_window_request_position_and_size(
     wlmtk_window_t *window_ptr,
@@ -730,32 +1079,99 @@ void wlmtk_window_request_position_and_size(
     window_ptr->organic_size.height = height;
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_window_request_position_and_size_paced(
+    wlmtk_window_t *window_ptr,
+    int x,
+    int y,
+    int width,
+    int height,
+    uint32_t time_msec)
+{
+    struct wlr_box box = { .x = x, .y = y, .width = width, .height = height };
+    if (window_ptr->paced_in_flight &&
+        (int32_t)(time_msec - window_ptr->paced_time_msec) <
+        WLMTK_WINDOW_PACED_DEADLINE_MSEC) {
+        window_ptr->paced_box = box;
+        window_ptr->paced_pending_time_msec = time_msec;
+        window_ptr->paced_pending = true;
+        return;
+    }
+    _wlmtk_window_send_paced(window_ptr, &box, time_msec);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_window_flush_paced(wlmtk_window_t *window_ptr)
+{
+    if (!window_ptr->paced_pending) return;
+    _wlmtk_window_send_paced(window_ptr, &window_ptr->paced_box,
+                             window_ptr->paced_pending_time_msec);
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmtk_window_serial(wlmtk_window_t *window_ptr, uint32_t serial)
 {
-    bs_dllist_node_t *dlnode_ptr;
+    window_ptr->has_acked_serial = true;
+    window_ptr->acked_serial = serial;
+    window_ptr->serial_calls++;
+    wlmtk_window_invalidate_thumbnail(window_ptr);
 
-    if (!window_ptr->inorganic_sizing &&
-        NULL == window_ptr->pending_updates.head_ptr) {
+    if (!window_ptr->inorganic_sizing && 0 == window_ptr->pending_size) {
         wlmtk_window_get_size(window_ptr,
                               &window_ptr->organic_size.width,
                               &window_ptr->organic_size.height);
-        return;
     }
 
-    while (NULL != (dlnode_ptr = window_ptr->pending_updates.head_ptr)) {
-        wlmtk_pending_update_t *pending_update_ptr = BS_CONTAINER_OF(
-            dlnode_ptr, wlmtk_pending_update_t, dlnode);
+    // Serials are ascending along the ring: Binary search for the number
+    // of updates at or before `serial`.
+    size_t lo = 0, hi = window_ptr->pending_size;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int32_t delta =
+            _wlmtk_window_update_at(window_ptr, mid)->serial - serial;
+        if (0 < delta) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    _wlmtk_window_apply_updates(window_ptr, lo);
+
+    // The client caught up: Send what was coalesced meanwhile, if anything.
+    if (window_ptr->paced_in_flight &&
+        0 >= (int32_t)(window_ptr->paced_serial - serial)) {
+        window_ptr->paced_in_flight = false;
+        wlmtk_window_flush_paced(window_ptr);
+    }
 
-        int32_t delta = pending_update_ptr->serial - serial;
-        if (0 < delta) break;
+    if (NULL != window_ptr->transaction_ptr &&
+        0 == window_ptr->pending_size) {
+        wlmtk_transaction_window_done(window_ptr->transaction_ptr, window_ptr);
+    }
+}
 
-        wlmtk_element_set_position(
-            wlmtk_window_element(window_ptr),
-            pending_update_ptr->x,
-            pending_update_ptr->y);
-        _wlmtk_window_release_update(window_ptr, pending_update_ptr);
+/* ------------------------------------------------------------------------- */
+bool wlmtk_window_has_pending_updates(wlmtk_window_t *window_ptr)
+{
+    return 0 < window_ptr->pending_size;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_window_set_transaction(
+    wlmtk_window_t *window_ptr,
+    wlmtk_transaction_t *transaction_ptr)
+{
+    if (NULL != transaction_ptr && 0 == window_ptr->pending_size) {
+        return false;
     }
+    window_ptr->transaction_ptr = transaction_ptr;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+wlmtk_transaction_t *wlmtk_window_get_transaction(wlmtk_window_t *window_ptr)
+{
+    return window_ptr->transaction_ptr;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -764,6 +1180,10 @@ void wlmtk_window_set_workspace(
     wlmtk_workspace_t *workspace_ptr)
 {
     window_ptr->workspace_ptr = workspace_ptr;
+    // A title change while not on a workspace was not drawn. Do it now.
+    if (NULL != workspace_ptr && !window_ptr->title_queued) {
+        _wlmtk_window_settle_title(window_ptr, true);
+    }
 
     wl_signal_emit(&window_ptr->events.state_changed, window_ptr);
 }
@@ -774,6 +1194,32 @@ wlmtk_workspace_t *wlmtk_window_get_workspace(wlmtk_window_t *window_ptr)
     return window_ptr->workspace_ptr;
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_window_set_group(
+    wlmtk_window_t *window_ptr,
+    wlmtk_window_group_t *group_ptr)
+{
+    window_ptr->group_ptr = group_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+wlmtk_window_group_t *wlmtk_window_get_group(wlmtk_window_t *window_ptr)
+{
+    return window_ptr->group_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+wlmtk_window_t *wlmtk_window_from_group_dlnode(bs_dllist_node_t *dlnode_ptr)
+{
+    return BS_CONTAINER_OF(dlnode_ptr, wlmtk_window_t, group_dlnode);
+}
+
+/* ------------------------------------------------------------------------- */
+bs_dllist_node_t *wlmtk_group_dlnode_from_window(wlmtk_window_t *window_ptr)
+{
+    return &window_ptr->group_dlnode;
+}
+
 /* ------------------------------------------------------------------------- */
 const wlmtk_util_client_t *wlmtk_window_get_client_ptr(
     wlmtk_window_t *window_ptr)
@@ -801,14 +1247,12 @@ bool _wlmtk_window_init(
     BS_ASSERT(NULL != window_ptr);
     window_ptr->vmt = _wlmtk_window_vmt;
 
-    for (size_t i = 0; i < WLMTK_WINDOW_MAX_PENDING; ++i) {
-        bs_dllist_push_back(&window_ptr->available_updates,
-                            &window_ptr->pre_allocated_updates[i].dlnode);
-    }
+    window_ptr->pending_updates_ptr = &window_ptr->pre_allocated_updates[0];
+    window_ptr->pending_capacity = WLMTK_WINDOW_MAX_PENDING;
 
     if (!wlmtk_box_init(&window_ptr->box,
                         WLMTK_BOX_VERTICAL,
-                        &window_ptr->style.margin)) {
+                        &window_ptr->style_ptr->margin)) {
         _wlmtk_window_fini(window_ptr);
         return false;
     }
@@ -817,7 +1261,7 @@ bool _wlmtk_window_init(
 
     if (!wlmtk_bordered_init(&window_ptr->super_bordered,
                              &window_ptr->box.super_container.super_element,
-                             &window_ptr->style.border)) {
+                             &window_ptr->style_ptr->border)) {
         _wlmtk_window_fini(window_ptr);
         return false;
     }
@@ -848,6 +1292,13 @@ bool _wlmtk_window_init(
  */
 void _wlmtk_window_fini(wlmtk_window_t *window_ptr)
 {
+    if (NULL != window_ptr->thumbnail_ptr) {
+        wlmtk_thumbnail_destroy(window_ptr->thumbnail_ptr);
+        window_ptr->thumbnail_ptr = NULL;
+    }
+    if (NULL != window_ptr->transaction_ptr) {
+        wlmtk_transaction_window_done(window_ptr->transaction_ptr, window_ptr);
+    }
     if (NULL != window_ptr->window_menu_ptr) {
         wlmtk_util_disconnect_listener(
             &window_ptr->menu_request_close_listener);
@@ -872,6 +1323,7 @@ void _wlmtk_window_fini(wlmtk_window_t *window_ptr)
         window_ptr->element_ptr = NULL;
     }
 
+    _wlmtk_window_settle_title(window_ptr, false);
     if (NULL != window_ptr->title_ptr) {
         free(window_ptr->title_ptr);
         window_ptr->title_ptr = NULL;
@@ -879,6 +1331,18 @@ void _wlmtk_window_fini(wlmtk_window_t *window_ptr)
 
     wlmtk_bordered_fini(&window_ptr->super_bordered);
     wlmtk_box_fini(&window_ptr->box);
+
+    if (NULL != window_ptr->pending_updates_ptr &&
+        window_ptr->pending_updates_ptr !=
+        &window_ptr->pre_allocated_updates[0]) {
+        free(window_ptr->pending_updates_ptr);
+    }
+    window_ptr->pending_updates_ptr = NULL;
+
+    if (NULL != window_ptr->style_ptr) {
+        wlmtk_style_release(window_ptr->style_ptr);
+        window_ptr->style_ptr = NULL;
+    }
 }
 
 /* ------------------------------------------------------------------------- */
@@ -997,6 +1461,8 @@ void _wlmtk_window_container_update_layout(wlmtk_container_t *container_ptr)
 void _wlmtk_window_request_minimize(wlmtk_window_t *window_ptr)
 {
     bs_log(BS_INFO, "Requesting window %p to minimize.", window_ptr);
+    // Captured while still shown, for previews of the minimized window.
+    wlmtk_window_thumbnail(window_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -1026,9 +1492,10 @@ void _wlmtk_window_create_titlebar(wlmtk_window_t *window_ptr)
     // Guard clause: Don't add decoration.
     if (NULL != window_ptr->titlebar_ptr) return;
 
-    // Create decoration.
+    // Create decoration. It will show the current title.
+    _wlmtk_window_settle_title(window_ptr, false);
     window_ptr->titlebar_ptr = wlmtk_titlebar_create(
-        window_ptr, &window_ptr->style.titlebar);
+        window_ptr, &window_ptr->style_ptr->titlebar);
     BS_ASSERT(NULL != window_ptr->titlebar_ptr);
     uint32_t properties = 0;
     if (window_ptr->properties & WLMTK_WINDOW_PROPERTY_ICONIFIABLE) {
@@ -1040,6 +1507,11 @@ void _wlmtk_window_create_titlebar(wlmtk_window_t *window_ptr)
     wlmtk_titlebar_set_properties(window_ptr->titlebar_ptr, properties);
     wlmtk_titlebar_set_activated(
         window_ptr->titlebar_ptr, window_ptr->activated);
+    wlmtk_titlebar_set_scale(
+        window_ptr->titlebar_ptr, window_ptr->decoration_scale);
+    if (window_ptr->hibernated) {
+        wlmtk_titlebar_hibernate(window_ptr->titlebar_ptr);
+    }
     wlmtk_element_set_visible(
         wlmtk_titlebar_element(window_ptr->titlebar_ptr), true);
     // Hm, if the content has a popup that extends over the titlebar area,
@@ -1060,8 +1532,13 @@ void _wlmtk_window_create_resizebar(wlmtk_window_t *window_ptr)
     if (NULL != window_ptr->resizebar_ptr) return;
 
     window_ptr->resizebar_ptr = wlmtk_resizebar_create(
-        window_ptr, &window_ptr->style.resizebar);
+        window_ptr, &window_ptr->style_ptr->resizebar);
     BS_ASSERT(NULL != window_ptr->resizebar_ptr);
+    wlmtk_resizebar_set_scale(
+        window_ptr->resizebar_ptr, window_ptr->decoration_scale);
+    if (window_ptr->hibernated) {
+        wlmtk_resizebar_hibernate(window_ptr->resizebar_ptr);
+    }
     wlmtk_element_set_visible(
         wlmtk_resizebar_element(window_ptr->resizebar_ptr), true);
     wlmtk_box_add_element_back(
@@ -1082,6 +1559,7 @@ void _wlmtk_window_destroy_titlebar(wlmtk_window_t *window_ptr)
         wlmtk_titlebar_element(window_ptr->titlebar_ptr));
     wlmtk_titlebar_destroy(window_ptr->titlebar_ptr);
     window_ptr->titlebar_ptr = NULL;
+    _wlmtk_window_settle_title(window_ptr, false);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -1105,7 +1583,7 @@ void _wlmtk_window_destroy_resizebar(wlmtk_window_t *window_ptr)
 /** Applies window decoration depending on current state. */
 void _wlmtk_window_apply_decoration(wlmtk_window_t *window_ptr)
 {
-    wlmtk_margin_style_t bstyle = window_ptr->style.border;
+    wlmtk_margin_style_t bstyle = window_ptr->style_ptr->border;
 
     if (window_ptr->server_side_decorated && !window_ptr->fullscreen) {
         _wlmtk_window_create_titlebar(window_ptr);
@@ -1137,8 +1615,10 @@ void _wlmtk_window_apply_decoration(wlmtk_window_t *window_ptr)
  * @param include_titlebar
  * @param include_resizebar
  * @param include_extra
+ *
+ * @return The serial of the request.
  */
-void _wlmtk_window_request_position_and_size_decorated(
+uint32_t _wlmtk_window_request_position_and_size_decorated(
     wlmtk_window_t *window_ptr,
     int x,
     int y,
@@ -1150,16 +1630,16 @@ void _wlmtk_window_request_position_and_size_decorated(
 {
     // Correct for borders, margin and decoration.
     if (include_titlebar) {
-        height -= window_ptr->style.titlebar.height +
-            window_ptr->style.margin.width;
+        height -= window_ptr->style_ptr->titlebar.height +
+            window_ptr->style_ptr->margin.width;
     }
     if (include_resizebar) {
-        height -= window_ptr->style.resizebar.height +
-            window_ptr->style.margin.width;
+        height -= window_ptr->style_ptr->resizebar.height +
+            window_ptr->style_ptr->margin.width;
     }
     if (include_titlebar || include_resizebar) {
-        height -= 2 * window_ptr->style.border.width;
-        width -= 2 * window_ptr->style.border.width;
+        height -= 2 * window_ptr->style_ptr->border.width;
+        width -= 2 * window_ptr->style_ptr->border.width;
     }
 
     // Account for potential extra size beyond the content: For example, by
@@ -1176,63 +1656,182 @@ void _wlmtk_window_request_position_and_size_decorated(
     height = BS_MAX(0, height);
     width = BS_MAX(0, width);
 
-    uint32_t serial = wlmtk_content_request_size(
-        window_ptr->content_ptr, width, height);
-
-    wlmtk_pending_update_t *pending_update_ptr =
-        _wlmtk_window_prepare_update(window_ptr);
-    pending_update_ptr->serial = serial;
-    pending_update_ptr->x = x;
-    pending_update_ptr->y = y;
-    pending_update_ptr->width = width;
-    pending_update_ptr->height = height;
+    return _wlmtk_window_request_size(window_ptr, x, y, width, height);
+}
 
-    // TODO(kaeser@gubbe.ch): Handle synchronous case: @ref wlmtk_window_serial
-    // may have been called early, so we should check if serial had just been
-    // called before (or is below the last @wlmt_window_serial). In that case,
-    // the pending state should be applied right away.
+/* ------------------------------------------------------------------------- */
+/**
+ * Sends a paced request, and tracks it as in flight.
+ *
+ * @param window_ptr
+ * @param box_ptr
+ * @param time_msec
+ */
+void _wlmtk_window_send_paced(
+    wlmtk_window_t *window_ptr,
+    const struct wlr_box *box_ptr,
+    uint32_t time_msec)
+{
+    uint32_t serial = _wlmtk_window_request_position_and_size_decorated(
+        window_ptr, box_ptr->x, box_ptr->y, box_ptr->width, box_ptr->height,
+        NULL != window_ptr->titlebar_ptr,
+        NULL != window_ptr->resizebar_ptr,
+        true);
+    window_ptr->organic_size = *box_ptr;
+    window_ptr->paced_serial = serial;
+    window_ptr->paced_in_flight = true;
+    window_ptr->paced_time_msec = time_msec;
+    window_ptr->paced_pending = false;
 }
 
 /* ------------------------------------------------------------------------- */
 /**
- * Prepares a positional update: Allocates an item and attach it to the end
- * of the list of pending updates.
+ * Requests the content's size, and tracks the position to apply once the
+ * client commits the returned serial.
+ *
+ * If the serial was already acknowledged -- either synchronously, while
+ * requesting the size, or it is older than the last acknowledged serial --
+ * the update is applied right away.
  *
  * @param window_ptr
+ * @param x
+ * @param y
+ * @param width
+ * @param height
  *
- * @return A pointer to a @ref wlmtk_pending_update_t, already positioned at the
- *     back of @ref wlmtk_window_t::pending_updates.
+ * @return The serial returned by @ref wlmtk_content_request_size.
  */
-wlmtk_pending_update_t *_wlmtk_window_prepare_update(
-    wlmtk_window_t *window_ptr)
+uint32_t _wlmtk_window_request_size(
+    wlmtk_window_t *window_ptr,
+    int x,
+    int y,
+    int width,
+    int height)
 {
-    bs_dllist_node_t *dlnode_ptr = bs_dllist_pop_front(
-        &window_ptr->available_updates);
-    if (NULL == dlnode_ptr) {
-        dlnode_ptr = bs_dllist_pop_front(&window_ptr->pending_updates);
-        bs_log(BS_WARNING, "Window %p: No updates available.", window_ptr);
-        // TODO(kaeser@gubbe.ch): Hm, should we apply this (old) update?
+    uint64_t serial_calls = window_ptr->serial_calls;
+    wlmtk_pending_update_t update = {
+        .serial = wlmtk_content_request_size(
+            window_ptr->content_ptr, width, height),
+        .x = x,
+        .y = y,
+        .width = width,
+        .height = height
+    };
+    _wlmtk_window_push_update(window_ptr, &update);
+
+    int32_t delta = update.serial - window_ptr->acked_serial;
+    if (window_ptr->has_acked_serial &&
+        (0 > delta ||
+         (0 == delta && serial_calls != window_ptr->serial_calls))) {
+        wlmtk_window_serial(window_ptr, window_ptr->acked_serial);
     }
-    wlmtk_pending_update_t *update_ptr = BS_CONTAINER_OF(
-        dlnode_ptr, wlmtk_pending_update_t, dlnode);
-    bs_dllist_push_back(&window_ptr->pending_updates, &update_ptr->dlnode);
-    return update_ptr;
+    return update.serial;
 }
 
 /* ------------------------------------------------------------------------- */
 /**
- * Releases a pending positional update. Moves it to the list of
- * @ref wlmtk_window_t::available_updates.
+ * Appends a positional update to the ring of pending updates. Supersedes
+ * the most recent update, if that has the same serial. Grows the ring if
+ * needed, or applies the oldest update if it cannot grow further.
  *
  * @param window_ptr
  * @param update_ptr
  */
-void _wlmtk_window_release_update(
+void _wlmtk_window_push_update(
+    wlmtk_window_t *window_ptr,
+    const wlmtk_pending_update_t *update_ptr)
+{
+    if (0 < window_ptr->pending_size) {
+        wlmtk_pending_update_t *tail_ptr = _wlmtk_window_update_at(
+            window_ptr, window_ptr->pending_size - 1);
+        if (tail_ptr->serial == update_ptr->serial) {
+            *tail_ptr = *update_ptr;
+            return;
+        }
+    }
+
+    if (window_ptr->pending_size >= window_ptr->pending_capacity &&
+        !_wlmtk_window_grow_updates(window_ptr)) {
+        bs_log(BS_WARNING, "Window %p: No updates available.", window_ptr);
+        _wlmtk_window_apply_updates(window_ptr, 1);
+    }
+
+    *_wlmtk_window_update_at(window_ptr, window_ptr->pending_size) =
+        *update_ptr;
+    window_ptr->pending_size++;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Doubles the capacity of the ring of pending updates.
+ *
+ * @param window_ptr
+ *
+ * @return true on success, false if at the limit or on allocation failure.
+ */
+bool _wlmtk_window_grow_updates(wlmtk_window_t *window_ptr)
+{
+    size_t capacity = 2 * window_ptr->pending_capacity;
+    if (capacity > WLMTK_WINDOW_MAX_PENDING_LIMIT) return false;
+    wlmtk_pending_update_t *updates_ptr = logged_calloc(
+        capacity, sizeof(wlmtk_pending_update_t));
+    if (NULL == updates_ptr) return false;
+
+    for (size_t i = 0; i < window_ptr->pending_size; ++i) {
+        updates_ptr[i] = *_wlmtk_window_update_at(window_ptr, i);
+    }
+    if (window_ptr->pending_updates_ptr !=
+        &window_ptr->pre_allocated_updates[0]) {
+        free(window_ptr->pending_updates_ptr);
+    }
+    window_ptr->pending_updates_ptr = updates_ptr;
+    window_ptr->pending_capacity = capacity;
+    window_ptr->pending_head = 0;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the pending update at position `idx`, counted from the oldest.
+ *
+ * @param window_ptr
+ * @param idx
+ *
+ * @return Pointer to the update.
+ */
+wlmtk_pending_update_t *_wlmtk_window_update_at(
     wlmtk_window_t *window_ptr,
-    wlmtk_pending_update_t *update_ptr)
+    size_t idx)
 {
-    bs_dllist_remove(&window_ptr->pending_updates, &update_ptr->dlnode);
-    bs_dllist_push_front(&window_ptr->available_updates, &update_ptr->dlnode);
+    return &window_ptr->pending_updates_ptr[
+        (window_ptr->pending_head + idx) &
+        (window_ptr->pending_capacity - 1)];
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Applies the `count` oldest pending updates, and drops them from the ring.
+ * Only the most recent of these sets the position: The earlier ones are
+ * superseded.
+ *
+ * @param window_ptr
+ * @param count
+ */
+void _wlmtk_window_apply_updates(
+    wlmtk_window_t *window_ptr,
+    size_t count)
+{
+    if (0 == count) return;
+    BS_ASSERT(count <= window_ptr->pending_size);
+
+    wlmtk_pending_update_t *update_ptr =
+        _wlmtk_window_update_at(window_ptr, count - 1);
+    window_ptr->pending_head = (window_ptr->pending_head + count) &
+        (window_ptr->pending_capacity - 1);
+    window_ptr->pending_size -= count;
+
+    wlmtk_element_set_position(
+        wlmtk_window_element(window_ptr), update_ptr->x, update_ptr->y);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -1246,6 +1845,97 @@ void _wlmtk_window_menu_request_close_handler(
     wlmtk_window_menu_set_enabled(window_ptr, false);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Enqueues the window for a deferred title redraw, and arms the timer. The
+ * redraw happens at the end of the current frame interval, and at most once
+ * per interval for any burst of updates.
+ *
+ * @param window_ptr
+ */
+void _wlmtk_window_queue_title(wlmtk_window_t *window_ptr)
+{
+    if (!window_ptr->title_queued) {
+        bs_dllist_push_back(&_wlmtk_window_title_queue,
+                            &window_ptr->title_dlnode);
+        window_ptr->title_queued = true;
+    }
+    if (_wlmtk_window_title_timer_armed) return;
+
+    uint64_t elapsed_msec =
+        _wlmtk_window_now_msec() - _wlmtk_window_title_flush_msec;
+    int delay_msec = 1;  // 0 would disarm the timer.
+    if (elapsed_msec < _wlmtk_window_title_msec) {
+        delay_msec = BS_MAX(
+            1, (int)(_wlmtk_window_title_msec - elapsed_msec));
+    }
+    wl_event_source_timer_update(_wlmtk_window_title_timer_ptr, delay_msec);
+    _wlmtk_window_title_timer_armed = true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Ends a deferred title update: Dequeues the window and releases the title
+ * the titlebar was still showing.
+ *
+ * @param window_ptr
+ * @param redraw              Whether to show the current title on the
+ *                            titlebar. Must be false if the titlebar is being
+ *                            created or was destroyed.
+ */
+void _wlmtk_window_settle_title(wlmtk_window_t *window_ptr, bool redraw)
+{
+    if (window_ptr->title_queued) {
+        bs_dllist_remove(&_wlmtk_window_title_queue,
+                         &window_ptr->title_dlnode);
+        window_ptr->title_queued = false;
+    }
+    if (NULL == window_ptr->drawn_title_ptr) return;
+
+    if (redraw && NULL != window_ptr->titlebar_ptr) {
+        wlmtk_titlebar_set_title(window_ptr->titlebar_ptr,
+                                 window_ptr->title_ptr);
+    }
+    free(window_ptr->drawn_title_ptr);
+    window_ptr->drawn_title_ptr = NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Redraws the deferred titles. Windows that are not on a workspace (eg.
+ * minimized or unmapped) are skipped: Their titlebar keeps the former title
+ * until @ref wlmtk_window_set_workspace puts them back on a workspace.
+ *
+ * @param data_ptr
+ *
+ * @return 0
+ */
+int _wlmtk_window_handle_title_timer(__UNUSED__ void *data_ptr)
+{
+    _wlmtk_window_title_timer_armed = false;
+    _wlmtk_window_title_flush_msec = _wlmtk_window_now_msec();
+
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                        &_wlmtk_window_title_queue))) {
+        wlmtk_window_t *window_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_window_t, title_dlnode);
+        window_ptr->title_queued = false;
+        if (NULL == window_ptr->workspace_ptr) continue;
+        _wlmtk_window_settle_title(window_ptr, true);
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return The current time of CLOCK_MONOTONIC, in milliseconds. */
+uint64_t _wlmtk_window_now_msec(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Gets the struct wlr_output that the window prefers, or is on.
@@ -1316,7 +2006,13 @@ wlmtk_fake_window_t *wlmtk_fake_window_create(void)
         return NULL;
     }
 
-    fake_window_state_ptr->window.style.border.width = 1;
+    wlmtk_window_style_t style = {};
+    style.border.width = 1;
+    fake_window_state_ptr->window.style_ptr = WLMTK_STYLE_INTERN(&style);
+    if (NULL == fake_window_state_ptr->window.style_ptr) {
+        wlmtk_fake_window_destroy(&fake_window_state_ptr->fake_window);
+        return NULL;
+    }
     if (!_wlmtk_window_init(
             &fake_window_state_ptr->window,
             wlmtk_content_element(
@@ -1414,9 +2110,11 @@ void _wlmtk_fake_window_request_resize(
 
 static void test_create_destroy(bs_test_t *test_ptr);
 static void test_set_title(bs_test_t *test_ptr);
+static void test_defer_titles(bs_test_t *test_ptr);
 static void test_request_close(bs_test_t *test_ptr);
 static void test_set_activated(bs_test_t *test_ptr);
 static void test_server_side_decorated(bs_test_t *test_ptr);
+static void test_set_style(bs_test_t *test_ptr);
 static void test_server_side_decorated_properties(bs_test_t *test_ptr);
 static void test_maximize(bs_test_t *test_ptr);
 static void test_maximize_outputs(bs_test_t *test_ptr);
@@ -1424,14 +2122,20 @@ static void test_fullscreen(bs_test_t *test_ptr);
 static void test_fullscreen_unmap(bs_test_t *test_ptr);
 static void test_fullscreen_outputs(bs_test_t *test_ptr);
 static void test_shade(bs_test_t *test_ptr);
+static void test_paced(bs_test_t *test_ptr);
+static void test_pending_updates(bs_test_t *test_ptr);
+static void test_content_commits(bs_test_t *test_ptr);
 static void test_fake(bs_test_t *test_ptr);
+static void test_footprint(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_window_test_cases[] = {
     { 1, "create_destroy", test_create_destroy },
     { 1, "set_title", test_set_title },
+    { 1, "defer_titles", test_defer_titles },
     { 1, "request_close", test_request_close },
     { 1, "set_activated", test_set_activated },
     { 1, "set_server_side_decorated", test_server_side_decorated },
+    { 1, "set_style", test_set_style },
     { 1, "set_server_side_decorated_properties",
       test_server_side_decorated_properties },
     { 1, "maximize", test_maximize },
@@ -1440,7 +2144,11 @@ const bs_test_case_t wlmtk_window_test_cases[] = {
     { 1, "fullscreen_unmap", test_fullscreen_unmap },
     { 1, "fullscreen_outputs", test_fullscreen_outputs },
     { 1, "shade", test_shade },
+    { 1, "paced", test_paced },
+    { 1, "pending_updates", test_pending_updates },
+    { 1, "content_commits", test_content_commits },
     { 1, "fake", test_fake },
+    { 1, "footprint", test_footprint },
     { 0, NULL, NULL }
 };
 
@@ -1496,6 +2204,68 @@ void test_set_title(bs_test_t *test_ptr)
     wlmtk_fake_window_destroy(fw_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests @ref wlmtk_window_defer_titles: Redraws once, and only if shown. */
+void test_defer_titles(bs_test_t *test_ptr)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    struct wl_display *display_ptr = wl_display_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, display_ptr);
+    struct wlr_output_layout *wlr_output_layout_ptr =
+        wlr_output_layout_create(display_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_output_layout_ptr);
+    struct wlr_output output = { .width = 1024, .height = 768, .scale = 1 };
+    wlmtk_test_wlr_output_init(&output);
+    wlr_output_layout_add(wlr_output_layout_ptr, &output, 0, 0);
+
+    wlmtk_workspace_t *ws_ptr = wlmtk_workspace_create(
+        wlr_output_layout_ptr, "test", &_wlmtk_workspace_test_tile_style);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws_ptr);
+    wlmtk_fake_window_t *fw_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fw_ptr);
+    wlmtk_window_t *window_ptr = fw_ptr->window_ptr;
+    wlmtk_workspace_map_window(ws_ptr, window_ptr);
+    wlmtk_window_set_server_side_decorated(window_ptr, true);
+    wlmtk_window_set_title(window_ptr, "Zero");
+
+    // A burst of updates: The title is current, the titlebar not yet.
+    wlmtk_window_defer_titles(wl_event_loop_ptr);
+    wlmtk_window_set_title(window_ptr, "One");
+    wlmtk_window_set_title(window_ptr, "Two");
+    BS_TEST_VERIFY_STREQ(test_ptr, "Two", wlmtk_window_get_title(window_ptr));
+    BS_TEST_VERIFY_STREQ(test_ptr, "Zero", window_ptr->drawn_title_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, window_ptr->title_queued);
+
+    // The timer redraws, once.
+    _wlmtk_window_handle_title_timer(NULL);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, window_ptr->drawn_title_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, window_ptr->title_queued);
+
+    // Not on a workspace: Skips the redraw until mapped again.
+    wlmtk_workspace_unmap_window(ws_ptr, window_ptr);
+    wlmtk_window_set_title(window_ptr, "Three");
+    _wlmtk_window_handle_title_timer(NULL);
+    BS_TEST_VERIFY_STREQ(test_ptr, "Two", window_ptr->drawn_title_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, window_ptr->title_queued);
+    wlmtk_workspace_map_window(ws_ptr, window_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, window_ptr->drawn_title_ptr);
+
+    // Disabling redraws what is pending.
+    wlmtk_window_set_title(window_ptr, "Four");
+    BS_TEST_VERIFY_TRUE(test_ptr, window_ptr->title_queued);
+    wlmtk_window_defer_titles(NULL);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, window_ptr->drawn_title_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, window_ptr->title_queued);
+
+    wlmtk_window_set_server_side_decorated(window_ptr, false);
+    wlmtk_workspace_unmap_window(ws_ptr, window_ptr);
+    wlmtk_fake_window_destroy(fw_ptr);
+    wlmtk_workspace_destroy(ws_ptr);
+    wl_display_destroy(display_ptr);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Tests activation. */
 void test_request_close(bs_test_t *test_ptr)
@@ -1593,6 +2363,45 @@ void test_server_side_decorated(bs_test_t *test_ptr)
     wl_display_destroy(display_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests @ref wlmtk_window_set_style: Applies only changed styles. */
+void test_set_style(bs_test_t *test_ptr)
+{
+    wlmtk_fake_window_t *fw_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fw_ptr);
+    wlmtk_window_t *window_ptr = fw_ptr->window_ptr;
+    wlmtk_window_set_server_side_decorated(window_ptr, true);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, window_ptr->titlebar_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, window_ptr->resizebar_ptr);
+
+    // Same style: Nothing to do.
+    wlmtk_window_style_t style = *window_ptr->style_ptr;
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_window_set_style(window_ptr, &style));
+
+    // Changed border and margin: Applied in-place.
+    style.border.width = 3;
+    style.margin.width = 2;
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_window_set_style(window_ptr, &style));
+    BS_TEST_VERIFY_EQ(test_ptr, 3, window_ptr->super_bordered.style.width);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, window_ptr->box.style.width);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, window_ptr->titlebar_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, window_ptr->resizebar_ptr);
+
+    // Changed titlebar: Re-created, and hidden resizebar stays hidden.
+    wlmtk_window_request_shaded(window_ptr, true);
+    style.titlebar.height = 24;
+    style.resizebar.height = 9;
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_window_set_style(window_ptr, &style));
+    BS_TEST_VERIFY_EQ(test_ptr, 24, window_ptr->style_ptr->titlebar.height);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, window_ptr->titlebar_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, window_ptr->resizebar_ptr);
+    BS_TEST_VERIFY_FALSE(
+        test_ptr,
+        wlmtk_resizebar_element(window_ptr->resizebar_ptr)->visible);
+
+    wlmtk_fake_window_destroy(fw_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Tests server-side decoration depending on properties. */
 void test_server_side_decorated_properties(bs_test_t *test_ptr)
@@ -1883,6 +2692,8 @@ void test_fullscreen(bs_test_t *test_ptr)
     BS_TEST_VERIFY_EQ(test_ptr, 768, box.height);
     BS_TEST_VERIFY_EQ(test_ptr, 1, l.calls);
     wlmtk_util_clear_test_listener(&l);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_workspace_has_fullscreen_window(ws_ptr, &output));
 
     BS_TEST_VERIFY_TRUE(test_ptr, fw_ptr->fake_content_ptr->activated);
     BS_TEST_VERIFY_EQ(
@@ -1903,6 +2714,8 @@ void test_fullscreen(bs_test_t *test_ptr)
     wlmtk_fake_window_commit_size(fw_ptr);
     wlmtk_window_commit_fullscreen(fw_ptr->window_ptr, false);
     BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_window_is_fullscreen(fw_ptr->window_ptr));
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlmtk_workspace_has_fullscreen_window(ws_ptr, &output));
     box = wlmtk_window_get_position_and_size(fw_ptr->window_ptr);
     BS_TEST_VERIFY_EQ(test_ptr, 20, box.x);
     BS_TEST_VERIFY_EQ(test_ptr, 10, box.y);
@@ -2114,6 +2927,129 @@ void test_shade(bs_test_t *test_ptr)
     wlmtk_fake_window_destroy(fw_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Verifies paced requests are coalesced until committed, or until late. */
+void test_paced(bs_test_t *test_ptr)
+{
+    wlmtk_fake_window_t *fw_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fw_ptr);
+    wlmtk_fake_content_t *fc_ptr = fw_ptr->fake_content_ptr;
+
+    fc_ptr->serial = 1;
+    wlmtk_window_request_position_and_size_paced(
+        fw_ptr->window_ptr, 0, 0, 200, 100, 1000);
+    int w = fc_ptr->requested_width;
+
+    // In flight: Coalesced.
+    wlmtk_window_request_position_and_size_paced(
+        fw_ptr->window_ptr, 0, 0, 205, 100, 1005);
+    wlmtk_window_request_position_and_size_paced(
+        fw_ptr->window_ptr, 0, 0, 210, 100, 1010);
+    BS_TEST_VERIFY_EQ(test_ptr, w, fc_ptr->requested_width);
+
+    // The client commits: Sends the most recent request.
+    fc_ptr->serial = 2;
+    wlmtk_fake_window_commit_size(fw_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, w + 10, fc_ptr->requested_width);
+
+    // Coalesced, until the request in flight is past the deadline.
+    wlmtk_window_request_position_and_size_paced(
+        fw_ptr->window_ptr, 0, 0, 220, 100, 1020);
+    BS_TEST_VERIFY_EQ(test_ptr, w + 10, fc_ptr->requested_width);
+    wlmtk_window_request_position_and_size_paced(
+        fw_ptr->window_ptr, 0, 0, 230, 100,
+        1010 + WLMTK_WINDOW_PACED_DEADLINE_MSEC);
+    BS_TEST_VERIFY_EQ(test_ptr, w + 30, fc_ptr->requested_width);
+
+    // Flushing sends what is coalesced.
+    wlmtk_window_request_position_and_size_paced(
+        fw_ptr->window_ptr, 0, 0, 240, 100,
+        1011 + WLMTK_WINDOW_PACED_DEADLINE_MSEC);
+    BS_TEST_VERIFY_EQ(test_ptr, w + 30, fc_ptr->requested_width);
+    wlmtk_window_flush_paced(fw_ptr->window_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, w + 40, fc_ptr->requested_width);
+
+    wlmtk_fake_window_destroy(fw_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies the ring of pending updates grows, supersedes and syncs. */
+void test_pending_updates(bs_test_t *test_ptr)
+{
+    wlmtk_fake_window_t *fw_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fw_ptr);
+    wlmtk_fake_content_t *fc_ptr = fw_ptr->fake_content_ptr;
+    wlmtk_element_t *e_ptr = wlmtk_window_element(fw_ptr->window_ptr);
+
+    // More updates than pre-allocated: None is lost.
+    for (int i = 1; i <= 4 * WLMTK_WINDOW_MAX_PENDING; ++i) {
+        fc_ptr->serial = i;
+        wlmtk_window_request_position_and_size(
+            fw_ptr->window_ptr, i, 0, 100, 50);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 0, e_ptr->x);
+    fc_ptr->serial = 3 * WLMTK_WINDOW_MAX_PENDING;
+    wlmtk_fake_window_commit_size(fw_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 3 * WLMTK_WINDOW_MAX_PENDING, e_ptr->x);
+    fc_ptr->serial = 4 * WLMTK_WINDOW_MAX_PENDING;
+    wlmtk_fake_window_commit_size(fw_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 4 * WLMTK_WINDOW_MAX_PENDING, e_ptr->x);
+
+    // Same serial: The later update supersedes the earlier.
+    fc_ptr->serial = 1000;
+    wlmtk_window_request_position_and_size(fw_ptr->window_ptr, 1, 0, 100, 50);
+    wlmtk_window_request_position_and_size(fw_ptr->window_ptr, 2, 0, 100, 50);
+    BS_TEST_VERIFY_EQ(test_ptr, 4 * WLMTK_WINDOW_MAX_PENDING, e_ptr->x);
+    wlmtk_fake_window_commit_size(fw_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, e_ptr->x);
+
+    // A serial that was already acknowledged: Applied right away.
+    fc_ptr->serial = 999;
+    wlmtk_window_request_position_and_size(fw_ptr->window_ptr, 7, 0, 100, 50);
+    BS_TEST_VERIFY_EQ(test_ptr, 7, e_ptr->x);
+
+    wlmtk_fake_window_destroy(fw_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies repeated content commits skip the window, unless pending. */
+void test_content_commits(bs_test_t *test_ptr)
+{
+    wlmtk_fake_window_t *fw_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fw_ptr);
+    wlmtk_fake_content_t *fc_ptr = fw_ptr->fake_content_ptr;
+    wlmtk_content_t *c_ptr = &fc_ptr->content;
+    wlmtk_element_t *e_ptr = wlmtk_window_element(fw_ptr->window_ptr);
+
+    fc_ptr->serial = 1;
+    wlmtk_window_request_position_and_size(fw_ptr->window_ptr, 0, 0, 100, 50);
+    wlmtk_fake_window_commit_size(fw_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, c_ptr->resized_commits);
+    uint64_t serial_calls = fw_ptr->window_ptr->serial_calls;
+
+    // Same size and serial: Only damage.
+    wlmtk_fake_window_commit_size(fw_ptr);
+    wlmtk_fake_window_commit_size(fw_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, c_ptr->unchanged_commits);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, serial_calls, fw_ptr->window_ptr->serial_calls);
+
+    // Same size and serial, but an update is pending: Applied.
+    wlmtk_window_request_position_and_size(fw_ptr->window_ptr, 5, 0, 100, 50);
+    wlmtk_fake_window_commit_size(fw_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 5, e_ptr->x);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, c_ptr->serial_commits);
+
+    // A new serial at the same size goes to the window.
+    fc_ptr->serial = 2;
+    wlmtk_fake_window_commit_size(fw_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, c_ptr->serial_commits);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, c_ptr->unchanged_commits);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, c_ptr->resized_commits);
+
+    wlmtk_fake_window_destroy(fw_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Tests fake window ctor and dtor. */
 void test_fake(bs_test_t *test_ptr)
@@ -2123,4 +3059,59 @@ void test_fake(bs_test_t *test_ptr)
     wlmtk_fake_window_destroy(fake_window_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Tests @ref wlmtk_window_get_footprint: A decorated 640x480 window stays
+ * within a budget, and hibernating releases the accounted textures.
+ */
+void test_footprint(bs_test_t *test_ptr)
+{
+    wlmtk_container_t *c_ptr = wlmtk_container_create_fake_parent();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, c_ptr);
+    wlmtk_fake_window_t *fw_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fw_ptr);
+    wlmtk_window_t *window_ptr = fw_ptr->window_ptr;
+
+    wlmtk_window_style_t style = *window_ptr->style_ptr;
+    style.titlebar.height = 22;
+    style.resizebar.height = 7;
+    style.border.width = 1;
+    wlmtk_window_set_style(window_ptr, &style);
+    wlmtk_window_set_server_side_decorated(window_ptr, true);
+    wlmtk_window_set_title(window_ptr, "Footprint");
+    wlmtk_window_request_position_and_size(window_ptr, 0, 0, 640, 480);
+    wlmtk_fake_window_commit_size(fw_ptr);
+    wlmtk_container_add_element(c_ptr, wlmtk_window_element(window_ptr));
+
+    wlmtk_memstat_footprint_t fp;
+    wlmtk_window_get_footprint(window_ptr, &fp);
+    BS_TEST_VERIFY_NEQ(test_ptr, 0, fp.buffers);
+    BS_TEST_VERIFY_NEQ(test_ptr, 0, fp.shared_buffers);
+    BS_TEST_VERIFY_NEQ(test_ptr, 0, fp.scene_nodes);
+
+    // Textures: At most 8 layers on the width of the titlebar (backgrounds,
+    // title, text and buttons; focussed and blurred), and 3 on the resize
+    // bar (background, released and pressed areas).
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        fp.buffer_bytes + fp.shared_buffer_bytes <=
+        (8 * 22 + 3 * 7) * 640 * sizeof(uint32_t));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, fp.struct_bytes + fp.scene_node_bytes <= 64 * 1024);
+
+    // Hibernating releases exactly the textures that are not shared.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, fp.buffer_bytes, wlmtk_window_hibernate(window_ptr));
+    wlmtk_memstat_footprint_t hibernated_fp;
+    wlmtk_window_get_footprint(window_ptr, &hibernated_fp);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, hibernated_fp.buffers);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, hibernated_fp.shared_buffers);
+    BS_TEST_VERIFY_EQ(test_ptr, fp.scene_nodes, hibernated_fp.scene_nodes);
+    wlmtk_window_wake(window_ptr);
+
+    wlmtk_container_remove_element(c_ptr, wlmtk_window_element(window_ptr));
+    wlmtk_fake_window_destroy(fw_ptr);
+    wlmtk_container_destroy_fake_parent(c_ptr);
+}
+
 /* == End of window.c ====================================================== */
@@ -22,7 +22,9 @@
 
 #include <libbase/libbase.h>
 #include <linux/input-event-codes.h>
+#include <pixman.h>
 #include <stdlib.h>
+#include <string.h>
 #include <wayland-server-core.h>
 #include <wayland-util.h>
 
@@ -39,13 +41,44 @@
 #include "fsm.h"
 #include "input.h"
 #include "layer.h"
+#include "layout_epoch.h"
+#include "placement.h"
+#include "rectangle.h"
 #include "surface.h"
 #include "test.h"  // IWYU pragma: keep
 #include "tile.h"
+#include "transaction.h"
 #include "util.h"
 
 /* == Declarations ========================================================= */
 
+/** Width of the outline's lines, for @ref WLMTK_WORKSPACE_DRAG_OUTLINE. */
+#define WLMTK_WORKSPACE_OUTLINE_WIDTH 2
+/** Color of the outline, for @ref WLMTK_WORKSPACE_DRAG_OUTLINE. */
+#define WLMTK_WORKSPACE_OUTLINE_COLOR 0xffc0c0c0
+
+/** A change to a window, enqueued within a transaction. */
+typedef struct {
+    /** The window to change. */
+    wlmtk_window_t            *window_ptr;
+    /** Workspace to move the window to, or NULL to keep it. */
+    wlmtk_workspace_t         *target_workspace_ptr;
+    /** Whether `box` is to be applied. */
+    bool                      has_box;
+    /** Position and size to request. */
+    struct wlr_box            box;
+} _wlmtk_workspace_change_t;
+
+/** Sorted and de-duplicated edge coordinates, for snapping. */
+typedef struct {
+    /** The coordinates. */
+    int                       *values;
+    /** Number of elements in use at `values`. */
+    size_t                    size;
+    /** Allocated number of elements at `values`. */
+    size_t                    capacity;
+} _wlmtk_workspace_edges_t;
+
 /** State of the workspace. */
 struct _wlmtk_workspace_t {
     /** Superclass: Container. */
@@ -68,6 +101,8 @@ struct _wlmtk_workspace_t {
 
     /** Whether this workspace is enabled, ie. can have activated windows. */
     bool                      enabled;
+    /** Whether this workspace is hibernated. */
+    bool                      hibernated;
     /** Container that holds the windows, ie. the window layer. */
     wlmtk_container_t         window_container;
     /** Container that holds the fullscreen elements. Should have only one. */
@@ -76,6 +111,15 @@ struct _wlmtk_workspace_t {
     /** List of toplevel windows. Via @ref wlmtk_window_t::dlnode. */
     bs_dllist_t               windows;
 
+    /** Nesting depth of @ref wlmtk_workspace_begin_transaction. */
+    int                       transaction_depth;
+    /** Changes enqueued within the transaction. */
+    _wlmtk_workspace_change_t *changes_ptr;
+    /** Number of elements in use at `changes_ptr`. */
+    size_t                    changes_size;
+    /** Allocated number of elements at `changes_ptr`. */
+    size_t                    changes_capacity;
+
     /** The activated window. */
     wlmtk_window_t            *activated_window_ptr;
     /** The most recent activated window, if none is activated now. */
@@ -98,6 +142,27 @@ struct _wlmtk_workspace_t {
     /** Edges currently active for resizing: `enum wlr_edges`. */
     uint32_t                  resize_edges;
 
+    /** How windows are presented while moved or resized. */
+    wlmtk_workspace_drag_mode_t drag_mode;
+    /** Free-space index for placing new windows. */
+    wlmtk_placement_t         *placement_ptr;
+    /** How new windows get placed. */
+    wlmtk_placement_policy_t  placement_policy;
+    /** Distance for snapping moved windows to edges. 0 to not snap. */
+    int                       snap_distance;
+    /** Vertical edges to snap to, captured when beginning a move. */
+    _wlmtk_workspace_edges_t  snap_x_edges;
+    /** Horizontal edges to snap to, captured when beginning a move. */
+    _wlmtk_workspace_edges_t  snap_y_edges;
+    /** Holds the outline's rectangles, above all other elements. */
+    wlmtk_container_t         outline_container;
+    /** The outline's top, bottom, left and right edge. */
+    wlmtk_rectangle_t         *outline_rectangle_ptrs[4];
+    /** Whether the outline is shown, ie. `outline_box` is to be applied. */
+    bool                      outline_active;
+    /** Position and size the outline currently shows. */
+    struct wlr_box            outline_box;
+
     /** Top left X coordinate of workspace. */
     int                       x1;
     /** Top left Y coordinate of workspace. */
@@ -119,7 +184,7 @@ struct _wlmtk_workspace_t {
     /** Copy of the tile's style, for dimensions; */
     wlmtk_tile_style_t        tile_style;
 
-    /** Listener for wlr_output_layout::events.change. */
+    /** Listener for layout epochs, see @ref wlmtk_layout_epoch_connect. */
     struct wl_listener        output_layout_change_listener;
     /** Listener for @ref wlmtk_element_events_t::pointer_leave. */
     struct wl_listener        element_pointer_leave_listener;
@@ -130,6 +195,20 @@ struct _wlmtk_workspace_t {
 };
 
 static void _wlmtk_workspace_element_destroy(wlmtk_element_t *element_ptr);
+static void _wlmtk_workspace_map_window(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_window_t *window_ptr,
+    bool activate);
+static void _wlmtk_workspace_unmap_window(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_window_t *window_ptr,
+    bool reactivate,
+    wlmtk_container_t *park_container_ptr);
+static void _wlmtk_workspace_activate_top_window(
+    wlmtk_workspace_t *workspace_ptr);
+static _wlmtk_workspace_change_t *_wlmtk_workspace_change_for_window(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_window_t *window_ptr);
 static void _wlmtk_workspace_element_get_dimensions(
     wlmtk_element_t *element_ptr,
     int *left_ptr,
@@ -158,11 +237,50 @@ static void _wlmtk_workspace_handle_element_pointer_leave(
 static void _wlmtk_window_reposition_window(
     bs_dllist_node_t *dlnode_ptr,
     void *ud_ptr);
+static void _wlmtk_workspace_update_occlusion(
+    wlmtk_workspace_t *workspace_ptr);
+static bool _wlmtk_workspace_occlude_output(
+    struct wl_list *link_ptr,
+    void *ud_ptr);
+static size_t _wlmtk_workspace_occlude_windows(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_container_t *container_ptr,
+    pixman_region32_t *covered_ptr);
+static bool _wlmtk_workspace_element_shown(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_element_t *element_ptr);
+
+static void _wlmtk_workspace_outline_show(
+    wlmtk_workspace_t *workspace_ptr,
+    const struct wlr_box *box_ptr);
+static void _wlmtk_workspace_outline_hide(wlmtk_workspace_t *workspace_ptr);
+
+static void _wlmtk_workspace_capture_snap_edges(
+    wlmtk_workspace_t *workspace_ptr);
+static void _wlmtk_workspace_add_snap_box(
+    const struct wlr_box *box_ptr,
+    void *ud_ptr);
+static bool _wlmtk_workspace_edges_add(
+    _wlmtk_workspace_edges_t *edges_ptr,
+    int value);
+static void _wlmtk_workspace_edges_sort(_wlmtk_workspace_edges_t *edges_ptr);
+static int _wlmtk_workspace_edges_cmp(const void *a_ptr, const void *b_ptr);
+static int _wlmtk_workspace_snap(
+    const _wlmtk_workspace_edges_t *edges_ptr,
+    int position,
+    int size,
+    int distance);
+static bool _wlmtk_workspace_edges_nearest(
+    const _wlmtk_workspace_edges_t *edges_ptr,
+    int value,
+    int *delta_ptr);
 
 static bool pfsm_move_begin(wlmtk_fsm_t *fsm_ptr, void *ud_ptr);
 static bool pfsm_move_motion(wlmtk_fsm_t *fsm_ptr, void *ud_ptr);
+static bool pfsm_move_release(wlmtk_fsm_t *fsm_ptr, void *ud_ptr);
 static bool pfsm_resize_begin(wlmtk_fsm_t *fsm_ptr, void *ud_ptr);
 static bool pfsm_resize_motion(wlmtk_fsm_t *fsm_ptr, void *ud_ptr);
+static bool pfsm_resize_release(wlmtk_fsm_t *fsm_ptr, void *ud_ptr);
 static bool pfsm_reset(wlmtk_fsm_t *fsm_ptr, void *ud_ptr);
 
 /* == Data ================================================================= */
@@ -196,15 +314,19 @@ const wlmtk_element_vmt_t     workspace_element_vmt = {
 static const wlmtk_fsm_transition_t pfsm_transitions[] = {
     { PFSMS_PASSTHROUGH, PFSME_BEGIN_MOVE, PFSMS_MOVE, pfsm_move_begin },
     { PFSMS_MOVE, PFSME_MOTION, PFSMS_MOVE, pfsm_move_motion },
-    { PFSMS_MOVE, PFSME_RELEASED, PFSMS_PASSTHROUGH, pfsm_reset },
+    { PFSMS_MOVE, PFSME_RELEASED, PFSMS_PASSTHROUGH, pfsm_move_release },
     { PFSMS_MOVE, PFSME_RESET, PFSMS_PASSTHROUGH, pfsm_reset },
     { PFSMS_PASSTHROUGH, PFSME_BEGIN_RESIZE, PFSMS_RESIZE, pfsm_resize_begin },
     { PFSMS_RESIZE, PFSME_MOTION, PFSMS_RESIZE, pfsm_resize_motion },
-    { PFSMS_RESIZE, PFSME_RELEASED, PFSMS_PASSTHROUGH, pfsm_reset },
+    { PFSMS_RESIZE, PFSME_RELEASED, PFSMS_PASSTHROUGH, pfsm_resize_release },
     { PFSMS_RESIZE, PFSME_RESET, PFSMS_PASSTHROUGH, pfsm_reset },
     WLMTK_FSM_TRANSITION_SENTINEL,
 };
 
+/** Lookup table for @ref pfsm_transitions. Shared by all workspaces. */
+static wlmtk_fsm_table_t pfsm_table = WLMTK_FSM_TABLE_INITIALIZER(
+    pfsm_transitions);
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -223,6 +345,11 @@ wlmtk_workspace_t *wlmtk_workspace_create(
         wlmtk_workspace_destroy(workspace_ptr);
         return NULL;
     }
+    workspace_ptr->placement_ptr = wlmtk_placement_create();
+    if (NULL == workspace_ptr->placement_ptr) {
+        wlmtk_workspace_destroy(workspace_ptr);
+        return NULL;
+    }
 
     if (!wlmtk_container_init(&workspace_ptr->super_container)) {
         wlmtk_workspace_destroy(workspace_ptr);
@@ -240,6 +367,9 @@ wlmtk_workspace_t *wlmtk_workspace_create(
         wlmtk_workspace_destroy(workspace_ptr);
         return NULL;
     }
+    // The window layer may hold many windows. Use the index for lookups.
+    wlmtk_container_set_spatial_index(&workspace_ptr->window_container, 128);
+    workspace_ptr->window_container.order_independent_layout = true;
     wlmtk_element_set_visible(
         &workspace_ptr->window_container.super_element,
         true);
@@ -320,10 +450,35 @@ wlmtk_workspace_t *wlmtk_workspace_create(
         wlmtk_layer_element(workspace_ptr->overlay_layer_ptr));
     wlmtk_layer_set_workspace(workspace_ptr->overlay_layer_ptr, workspace_ptr);
 
-    wlmtk_fsm_init(&workspace_ptr->fsm, pfsm_transitions, PFSMS_PASSTHROUGH);
+    if (!wlmtk_container_init(&workspace_ptr->outline_container)) {
+        wlmtk_workspace_destroy(workspace_ptr);
+        return NULL;
+    }
+    // The outline is just for show: It must not take pointer focus.
+    wlmtk_element_set_input_transparent(
+        &workspace_ptr->outline_container.super_element, true);
+    for (size_t i = 0; i < 4; ++i) {
+        wlmtk_rectangle_t *r_ptr = wlmtk_rectangle_create(
+            0, 0, WLMTK_WORKSPACE_OUTLINE_COLOR);
+        if (NULL == r_ptr) {
+            wlmtk_workspace_destroy(workspace_ptr);
+            return NULL;
+        }
+        workspace_ptr->outline_rectangle_ptrs[i] = r_ptr;
+        wlmtk_element_set_visible(wlmtk_rectangle_element(r_ptr), true);
+        wlmtk_container_add_element(
+            &workspace_ptr->outline_container,
+            wlmtk_rectangle_element(r_ptr));
+    }
+    wlmtk_container_add_element(
+        &workspace_ptr->super_container,
+        &workspace_ptr->outline_container.super_element);
+
+    wlmtk_fsm_init_table(&workspace_ptr->fsm, &pfsm_table, PFSMS_PASSTHROUGH);
 
-    wlmtk_util_connect_listener_signal(
-        &workspace_ptr->wlr_output_layout_ptr->events.change,
+    wlmtk_layout_epoch_connect(
+        workspace_ptr->wlr_output_layout_ptr,
+        WLMTK_LAYOUT_EPOCH_STAGE_WORKSPACES,
         &workspace_ptr->output_layout_change_listener,
         _wlmtk_workspace_handle_output_layout_change);
     _wlmtk_workspace_handle_output_layout_change(
@@ -339,6 +494,35 @@ void wlmtk_workspace_destroy(wlmtk_workspace_t *workspace_ptr)
     wlmtk_util_disconnect_listener(
         &workspace_ptr->output_layout_change_listener);
 
+    if (NULL != workspace_ptr->placement_ptr) {
+        wlmtk_placement_destroy(workspace_ptr->placement_ptr);
+        workspace_ptr->placement_ptr = NULL;
+    }
+    if (NULL != workspace_ptr->snap_x_edges.values) {
+        free(workspace_ptr->snap_x_edges.values);
+        workspace_ptr->snap_x_edges.values = NULL;
+    }
+    if (NULL != workspace_ptr->snap_y_edges.values) {
+        free(workspace_ptr->snap_y_edges.values);
+        workspace_ptr->snap_y_edges.values = NULL;
+    }
+
+    if (NULL != workspace_ptr->outline_container.super_element.parent_container_ptr) {
+        wlmtk_container_remove_element(
+            &workspace_ptr->super_container,
+            &workspace_ptr->outline_container.super_element);
+    }
+    for (size_t i = 0; i < 4; ++i) {
+        wlmtk_rectangle_t *r_ptr = workspace_ptr->outline_rectangle_ptrs[i];
+        if (NULL == r_ptr) continue;
+        wlmtk_container_remove_element(
+            &workspace_ptr->outline_container,
+            wlmtk_rectangle_element(r_ptr));
+        wlmtk_rectangle_destroy(r_ptr);
+        workspace_ptr->outline_rectangle_ptrs[i] = NULL;
+    }
+    wlmtk_container_fini(&workspace_ptr->outline_container);
+
     if (NULL != workspace_ptr->overlay_layer_ptr) {
         wlmtk_layer_set_workspace(workspace_ptr->overlay_layer_ptr, NULL);
         wlmtk_container_remove_element(
@@ -390,6 +574,10 @@ void wlmtk_workspace_destroy(wlmtk_workspace_t *workspace_ptr)
 
     wlmtk_container_fini(&workspace_ptr->super_container);
 
+    if (NULL != workspace_ptr->changes_ptr) {
+        free(workspace_ptr->changes_ptr);
+        workspace_ptr->changes_ptr = NULL;
+    }
     if (NULL != workspace_ptr->name_ptr) {
         free(workspace_ptr->name_ptr);
         workspace_ptr->name_ptr = NULL;
@@ -535,80 +723,164 @@ bool wlmtk_workspace_enabled(wlmtk_workspace_t *workspace_ptr)
 }
 
 /* ------------------------------------------------------------------------- */
-void wlmtk_workspace_map_window(wlmtk_workspace_t *workspace_ptr,
-                                wlmtk_window_t *window_ptr)
+size_t wlmtk_workspace_hibernate(wlmtk_workspace_t *workspace_ptr)
 {
-    BS_ASSERT(NULL == wlmtk_window_get_workspace(window_ptr));
+    if (workspace_ptr->hibernated) return 0;
+    workspace_ptr->hibernated = true;
+
+    size_t bytes = 0;
+    for (bs_dllist_node_t *dlnode_ptr = workspace_ptr->windows.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        bytes += wlmtk_window_hibernate(wlmtk_window_from_dlnode(dlnode_ptr));
+    }
+    return bytes;
+}
 
-    wlmtk_element_set_visible(wlmtk_window_element(window_ptr), true);
-    wlmtk_container_add_element(
-        &workspace_ptr->window_container,
-        wlmtk_window_element(window_ptr));
-    bs_dllist_push_front(&workspace_ptr->windows,
-                         wlmtk_dlnode_from_window(window_ptr));
-    wlmtk_window_set_workspace(window_ptr, workspace_ptr);
+/* ------------------------------------------------------------------------- */
+bool wlmtk_workspace_hibernated(wlmtk_workspace_t *workspace_ptr)
+{
+    return workspace_ptr->hibernated;
+}
 
-    wlmtk_workspace_activate_window(workspace_ptr, window_ptr);
+/* ------------------------------------------------------------------------- */
+void wlmtk_workspace_wake(wlmtk_workspace_t *workspace_ptr)
+{
+    if (!workspace_ptr->hibernated) return;
+    workspace_ptr->hibernated = false;
 
-    if (NULL != workspace_ptr->root_ptr) {
-        wl_signal_emit(
-            &wlmtk_root_events(workspace_ptr->root_ptr)->window_mapped,
-            window_ptr);
+    for (bs_dllist_node_t *dlnode_ptr = workspace_ptr->windows.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_window_wake(wlmtk_window_from_dlnode(dlnode_ptr));
     }
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_workspace_map_window(wlmtk_workspace_t *workspace_ptr,
+                                wlmtk_window_t *window_ptr)
+{
+    _wlmtk_workspace_map_window(workspace_ptr, window_ptr, true);
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmtk_workspace_unmap_window(wlmtk_workspace_t *workspace_ptr,
                                   wlmtk_window_t *window_ptr)
 {
-    bool need_activation = false;
+    _wlmtk_workspace_unmap_window(workspace_ptr, window_ptr, true, NULL);
+}
 
-    BS_ASSERT(workspace_ptr == wlmtk_window_get_workspace(window_ptr));
+/* ------------------------------------------------------------------------- */
+void wlmtk_workspace_park_window(wlmtk_workspace_t *workspace_ptr,
+                                 wlmtk_window_t *window_ptr,
+                                 wlmtk_container_t *container_ptr)
+{
+    _wlmtk_workspace_unmap_window(
+        workspace_ptr, window_ptr, true, container_ptr);
+}
 
-    if (workspace_ptr->grabbed_window_ptr == window_ptr) {
-        wlmtk_fsm_event(&workspace_ptr->fsm, PFSME_RESET, NULL);
-        BS_ASSERT(NULL == workspace_ptr->grabbed_window_ptr);
-    }
+/* ------------------------------------------------------------------------- */
+void wlmtk_workspace_begin_transaction(wlmtk_workspace_t *workspace_ptr)
+{
+    workspace_ptr->transaction_depth++;
+}
 
-    if (workspace_ptr->activated_window_ptr == window_ptr) {
-        wlmtk_workspace_activate_window(workspace_ptr, NULL);
-        need_activation = true;
+/* ------------------------------------------------------------------------- */
+bool wlmtk_workspace_enqueue_position_and_size(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_window_t *window_ptr,
+    int x,
+    int y,
+    int width,
+    int height)
+{
+    BS_ASSERT(workspace_ptr == wlmtk_window_get_workspace(window_ptr));
+    if (0 >= workspace_ptr->transaction_depth) {
+        wlmtk_window_request_position_and_size(
+            window_ptr, x, y, width, height);
+        return true;
     }
-    if (workspace_ptr->formerly_activated_window_ptr == window_ptr) {
-        workspace_ptr->formerly_activated_window_ptr = NULL;
-        need_activation = true;
+
+    _wlmtk_workspace_change_t *change_ptr =
+        _wlmtk_workspace_change_for_window(workspace_ptr, window_ptr);
+    if (NULL == change_ptr) return false;
+    change_ptr->has_box = true;
+    change_ptr->box = (struct wlr_box){
+        .x = x, .y = y, .width = width, .height = height };
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_workspace_enqueue_move_to_workspace(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_window_t *window_ptr,
+    wlmtk_workspace_t *target_workspace_ptr)
+{
+    BS_ASSERT(workspace_ptr == wlmtk_window_get_workspace(window_ptr));
+    if (0 >= workspace_ptr->transaction_depth) {
+        if (target_workspace_ptr == workspace_ptr) return true;
+        wlmtk_workspace_unmap_window(workspace_ptr, window_ptr);
+        wlmtk_workspace_map_window(target_workspace_ptr, window_ptr);
+        return true;
     }
 
-    wlmtk_element_set_visible(wlmtk_window_element(window_ptr), false);
+    _wlmtk_workspace_change_t *change_ptr =
+        _wlmtk_workspace_change_for_window(workspace_ptr, window_ptr);
+    if (NULL == change_ptr) return false;
+    change_ptr->target_workspace_ptr = target_workspace_ptr;
+    return true;
+}
 
-    if (wlmtk_window_is_fullscreen(window_ptr)) {
-        wlmtk_container_remove_element(
-            &workspace_ptr->fullscreen_container,
-            wlmtk_window_element(window_ptr));
-    } else {
-        wlmtk_container_remove_element(
-            &workspace_ptr->window_container,
-            wlmtk_window_element(window_ptr));
+/* ------------------------------------------------------------------------- */
+void wlmtk_workspace_commit_transaction(wlmtk_workspace_t *workspace_ptr)
+{
+    BS_ASSERT(0 < workspace_ptr->transaction_depth);
+    if (0 < --workspace_ptr->transaction_depth) return;
+
+    // First pass: Workspace changes. Activation is settled once, after.
+    bool need_activation = false;
+    wlmtk_workspace_t *last_target_workspace_ptr = NULL;
+    wlmtk_window_t *last_moved_window_ptr = NULL;
+    for (size_t i = 0; i < workspace_ptr->changes_size; ++i) {
+        _wlmtk_workspace_change_t *change_ptr = &workspace_ptr->changes_ptr[i];
+        wlmtk_workspace_t *target_ptr = change_ptr->target_workspace_ptr;
+        if (NULL == target_ptr || target_ptr == workspace_ptr) continue;
+
+        if (workspace_ptr->activated_window_ptr == change_ptr->window_ptr ||
+            workspace_ptr->formerly_activated_window_ptr ==
+            change_ptr->window_ptr) {
+            need_activation = true;
+        }
+        _wlmtk_workspace_unmap_window(
+            workspace_ptr, change_ptr->window_ptr, false, NULL);
+        _wlmtk_workspace_map_window(
+            target_ptr, change_ptr->window_ptr, false);
+        last_target_workspace_ptr = target_ptr;
+        last_moved_window_ptr = change_ptr->window_ptr;
     }
-    bs_dllist_remove(&workspace_ptr->windows,
-                     wlmtk_dlnode_from_window(window_ptr));
-    wlmtk_window_set_workspace(window_ptr, NULL);
-    if (NULL != workspace_ptr->root_ptr) {
-        wl_signal_emit(
-            &wlmtk_root_events(workspace_ptr->root_ptr)->window_unmapped,
-            window_ptr);
+    if (need_activation) _wlmtk_workspace_activate_top_window(workspace_ptr);
+    if (NULL != last_moved_window_ptr) {
+        wlmtk_workspace_activate_window(
+            last_target_workspace_ptr, last_moved_window_ptr);
     }
 
-    if (need_activation) {
-        // FIXME: What about raising?
-        bs_dllist_node_t *dlnode_ptr =
-            workspace_ptr->window_container.elements.head_ptr;
-        if (NULL != dlnode_ptr) {
-            wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
-            wlmtk_window_t *window_ptr = wlmtk_window_from_element(element_ptr);
-            wlmtk_workspace_activate_window(workspace_ptr, window_ptr);
-        }
+    // Second pass: Geometry. Configures go out back-to-back, and the
+    // results get presented together, once all windows committed.
+    wlmtk_transaction_t *transaction_ptr = wlmtk_transaction_create();
+    for (size_t i = 0; i < workspace_ptr->changes_size; ++i) {
+        _wlmtk_workspace_change_t *change_ptr = &workspace_ptr->changes_ptr[i];
+        if (!change_ptr->has_box) continue;
+        wlmtk_window_request_position_and_size(
+            change_ptr->window_ptr,
+            change_ptr->box.x, change_ptr->box.y,
+            change_ptr->box.width, change_ptr->box.height);
+        wlmtk_transaction_add_window(transaction_ptr, change_ptr->window_ptr);
     }
+    workspace_ptr->changes_size = 0;
+    wlmtk_transaction_commit(transaction_ptr);
+
+    // And a single layout pass for all the scene changes.
+    wlmtk_container_flush_layout();
 }
 
 /* ------------------------------------------------------------------------- */
@@ -691,6 +963,49 @@ void wlmtk_workspace_window_to_fullscreen(
         bs_dllist_push_front(&workspace_ptr->windows,
                              wlmtk_dlnode_from_window(window_ptr));
     }
+    _wlmtk_workspace_update_occlusion(workspace_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_workspace_has_fullscreen_window(
+    wlmtk_workspace_t *workspace_ptr,
+    struct wlr_output *wlr_output_ptr)
+{
+    for (bs_dllist_node_t *dlnode_ptr =
+             workspace_ptr->fullscreen_container.elements.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
+        struct wlr_box box = wlmtk_element_get_dimensions_box(element_ptr);
+        int x, y;
+        wlmtk_element_get_position(element_ptr, &x, &y);
+        if (wlr_output_ptr == wlr_output_layout_output_at(
+                workspace_ptr->wlr_output_layout_ptr,
+                x + box.x + box.width / 2,
+                y + box.y + box.height / 2)) return true;
+    }
+    return false;
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_workspace_update_occlusion(wlmtk_workspace_t *workspace_ptr)
+{
+    pixman_region32_t covered;
+    pixman_region32_init(&covered);
+    // Fullscreen windows are stacked above all other windows.
+    size_t occluded = _wlmtk_workspace_occlude_windows(
+        workspace_ptr, &workspace_ptr->fullscreen_container, &covered);
+    occluded += _wlmtk_workspace_occlude_windows(
+        workspace_ptr, &workspace_ptr->window_container, &covered);
+    pixman_region32_fini(&covered);
+
+    // With per-output workspaces, the outputs showing this workspace change
+    // without the fullscreen windows changing.
+    if (NULL != workspace_ptr->root_ptr &&
+        wlmtk_root_per_output_workspaces(workspace_ptr->root_ptr)) {
+        _wlmtk_workspace_update_occlusion(workspace_ptr);
+    }
+    return occluded;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -711,6 +1026,89 @@ void wlmtk_workspace_begin_window_resize(
     wlmtk_fsm_event(&workspace_ptr->fsm, PFSME_BEGIN_RESIZE, window_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_workspace_set_drag_mode(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_workspace_drag_mode_t drag_mode)
+{
+    workspace_ptr->drag_mode = drag_mode;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_workspace_set_snap_distance(
+    wlmtk_workspace_t *workspace_ptr,
+    int distance)
+{
+    workspace_ptr->snap_distance = BS_MAX(0, distance);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_workspace_set_placement_policy(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_placement_policy_t policy)
+{
+    workspace_ptr->placement_policy = policy;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_workspace_place_window(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_window_t *window_ptr,
+    int pointer_x,
+    int pointer_y)
+{
+    wlmtk_workspace_place_window_with_policy(
+        workspace_ptr, window_ptr, workspace_ptr->placement_policy,
+        pointer_x, pointer_y);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_workspace_place_window_with_policy(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_window_t *window_ptr,
+    wlmtk_placement_policy_t policy,
+    int pointer_x,
+    int pointer_y)
+{
+    BS_ASSERT(workspace_ptr == wlmtk_window_get_workspace(window_ptr));
+    if (wlmtk_window_is_fullscreen(window_ptr) ||
+        wlmtk_window_is_maximized(window_ptr)) return;
+
+    // Places within the output of the pointer.
+    wlmtk_placement_set_area(
+        workspace_ptr->placement_ptr,
+        wlmtk_workspace_get_maximize_extents(
+            workspace_ptr,
+            wlr_output_layout_output_at(
+                workspace_ptr->wlr_output_layout_ptr,
+                pointer_x, pointer_y)));
+
+    // Brings the index up to date: Only windows that moved invalidate it.
+    for (bs_dllist_node_t *dlnode_ptr = workspace_ptr->windows.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_window_t *w_ptr = wlmtk_window_from_dlnode(dlnode_ptr);
+        if (w_ptr == window_ptr) continue;
+        if (wlmtk_window_is_fullscreen(w_ptr)) {
+            wlmtk_placement_remove(workspace_ptr->placement_ptr, w_ptr);
+            continue;
+        }
+        wlmtk_placement_update(
+            workspace_ptr->placement_ptr,
+            w_ptr,
+            wlmtk_window_get_position_and_size(w_ptr));
+    }
+
+    struct wlr_box box = wlmtk_window_get_position_and_size(window_ptr);
+    box = wlmtk_placement_place(
+        workspace_ptr->placement_ptr,
+        policy,
+        box.width, box.height,
+        pointer_x, pointer_y);
+    wlmtk_window_set_position(window_ptr, box.x, box.y);
+    wlmtk_placement_update(workspace_ptr->placement_ptr, window_ptr, box);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Acticates `window_ptr`. Will de-activate an earlier window. */
 void wlmtk_workspace_activate_window(
@@ -835,6 +1233,185 @@ wlmtk_workspace_t *wlmtk_workspace_from_dlnode(
 
 /* == Local (static) methods =============================================== */
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Maps the window. See @ref wlmtk_workspace_map_window.
+ *
+ * @param workspace_ptr
+ * @param window_ptr
+ * @param activate            Whether to activate the window.
+ */
+void _wlmtk_workspace_map_window(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_window_t *window_ptr,
+    bool activate)
+{
+    BS_ASSERT(NULL == wlmtk_window_get_workspace(window_ptr));
+
+    // Windows may come from a hibernated workspace, or go to one.
+    if (workspace_ptr->hibernated) {
+        wlmtk_window_hibernate(window_ptr);
+    } else {
+        wlmtk_window_wake(window_ptr);
+    }
+    wlmtk_element_set_visible(wlmtk_window_element(window_ptr), true);
+    if (NULL != wlmtk_window_element(window_ptr)->parent_container_ptr) {
+        // Parked, see wlmtk_workspace_park_window(): Keeps the scene nodes.
+        wlmtk_container_move_element(
+            &workspace_ptr->window_container,
+            wlmtk_window_element(window_ptr));
+    } else {
+        wlmtk_container_add_element(
+            &workspace_ptr->window_container,
+            wlmtk_window_element(window_ptr));
+    }
+    bs_dllist_push_front(&workspace_ptr->windows,
+                         wlmtk_dlnode_from_window(window_ptr));
+    wlmtk_window_set_workspace(window_ptr, workspace_ptr);
+
+    if (activate) wlmtk_workspace_activate_window(workspace_ptr, window_ptr);
+
+    if (NULL != workspace_ptr->root_ptr) {
+        wlmtk_root_add_to_window_group(workspace_ptr->root_ptr, window_ptr);
+        wl_signal_emit(
+            &wlmtk_root_events(workspace_ptr->root_ptr)->window_mapped,
+            window_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Unmaps the window. See @ref wlmtk_workspace_unmap_window.
+ *
+ * @param workspace_ptr
+ * @param window_ptr
+ * @param reactivate          Whether to activate another window, if
+ *                            `window_ptr` was the (formerly) activated one.
+ * @param park_container_ptr  Optional: Container to move the window to,
+ *                            see @ref wlmtk_workspace_park_window. If NULL,
+ *                            the window is removed from the container.
+ */
+void _wlmtk_workspace_unmap_window(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_window_t *window_ptr,
+    bool reactivate,
+    wlmtk_container_t *park_container_ptr)
+{
+    bool need_activation = false;
+
+    BS_ASSERT(workspace_ptr == wlmtk_window_get_workspace(window_ptr));
+
+    if (workspace_ptr->grabbed_window_ptr == window_ptr) {
+        wlmtk_fsm_event(&workspace_ptr->fsm, PFSME_RESET, NULL);
+        BS_ASSERT(NULL == workspace_ptr->grabbed_window_ptr);
+    }
+
+    if (workspace_ptr->activated_window_ptr == window_ptr) {
+        wlmtk_workspace_activate_window(workspace_ptr, NULL);
+        need_activation = true;
+    }
+    if (workspace_ptr->formerly_activated_window_ptr == window_ptr) {
+        workspace_ptr->formerly_activated_window_ptr = NULL;
+        need_activation = true;
+    }
+
+    // Drops a change still enqueued for the window. Not while committing.
+    for (size_t i = 0; reactivate && i < workspace_ptr->changes_size; ++i) {
+        if (workspace_ptr->changes_ptr[i].window_ptr != window_ptr) continue;
+        workspace_ptr->changes_ptr[i] =
+            workspace_ptr->changes_ptr[--workspace_ptr->changes_size];
+        break;
+    }
+
+    wlmtk_element_set_visible(wlmtk_window_element(window_ptr), false);
+    wlmtk_element_set_occluded(wlmtk_window_element(window_ptr), false);
+
+    if (NULL != park_container_ptr) {
+        wlmtk_container_move_element(
+            park_container_ptr, wlmtk_window_element(window_ptr));
+    } else if (wlmtk_window_is_fullscreen(window_ptr)) {
+        wlmtk_container_remove_element(
+            &workspace_ptr->fullscreen_container,
+            wlmtk_window_element(window_ptr));
+    } else {
+        wlmtk_container_remove_element(
+            &workspace_ptr->window_container,
+            wlmtk_window_element(window_ptr));
+    }
+    if (wlmtk_window_is_fullscreen(window_ptr)) {
+        _wlmtk_workspace_update_occlusion(workspace_ptr);
+    }
+    bs_dllist_remove(&workspace_ptr->windows,
+                     wlmtk_dlnode_from_window(window_ptr));
+    wlmtk_placement_remove(workspace_ptr->placement_ptr, window_ptr);
+    wlmtk_window_set_workspace(window_ptr, NULL);
+    if (NULL != workspace_ptr->root_ptr) {
+        wlmtk_root_remove_from_window_group(
+            workspace_ptr->root_ptr, window_ptr);
+        wl_signal_emit(
+            &wlmtk_root_events(workspace_ptr->root_ptr)->window_unmapped,
+            window_ptr);
+    }
+
+    if (need_activation && reactivate) {
+        _wlmtk_workspace_activate_top_window(workspace_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Activates the topmost window of the window layer, if any. */
+void _wlmtk_workspace_activate_top_window(wlmtk_workspace_t *workspace_ptr)
+{
+    // FIXME: What about raising?
+    bs_dllist_node_t *dlnode_ptr =
+        workspace_ptr->window_container.elements.head_ptr;
+    if (NULL != dlnode_ptr) {
+        wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
+        wlmtk_window_t *window_ptr = wlmtk_window_from_element(element_ptr);
+        wlmtk_workspace_activate_window(workspace_ptr, window_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the change enqueued for `window_ptr`, or adds a new one.
+ *
+ * @param workspace_ptr
+ * @param window_ptr
+ *
+ * @return Pointer to the change, or NULL on allocation failure.
+ */
+_wlmtk_workspace_change_t *_wlmtk_workspace_change_for_window(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_window_t *window_ptr)
+{
+    for (size_t i = 0; i < workspace_ptr->changes_size; ++i) {
+        if (workspace_ptr->changes_ptr[i].window_ptr == window_ptr) {
+            return &workspace_ptr->changes_ptr[i];
+        }
+    }
+
+    if (workspace_ptr->changes_size >= workspace_ptr->changes_capacity) {
+        size_t capacity = BS_MAX(8U, 2 * workspace_ptr->changes_capacity);
+        _wlmtk_workspace_change_t *changes_ptr = logged_calloc(
+            capacity, sizeof(_wlmtk_workspace_change_t));
+        if (NULL == changes_ptr) return NULL;
+        if (NULL != workspace_ptr->changes_ptr) {
+            memcpy(changes_ptr, workspace_ptr->changes_ptr,
+                   workspace_ptr->changes_size *
+                   sizeof(_wlmtk_workspace_change_t));
+            free(workspace_ptr->changes_ptr);
+        }
+        workspace_ptr->changes_ptr = changes_ptr;
+        workspace_ptr->changes_capacity = capacity;
+    }
+
+    _wlmtk_workspace_change_t *change_ptr =
+        &workspace_ptr->changes_ptr[workspace_ptr->changes_size++];
+    *change_ptr = (_wlmtk_workspace_change_t){ .window_ptr = window_ptr };
+    return change_ptr;
+}
+
 /* ------------------------------------------------------------------------- */
 /** Virtual destructor, wraps to our dtor. */
 void _wlmtk_workspace_element_destroy(wlmtk_element_t *element_ptr)
@@ -953,13 +1530,154 @@ void _wlmtk_workspace_handle_output_layout_change(
     workspace_ptr->y1 = extents.y;
     workspace_ptr->x2 = extents.x + extents.width;
     workspace_ptr->y2 = extents.y + extents.height;
+    wlmtk_element_invalidate_extents(
+        &workspace_ptr->super_container.super_element);
+
+    // Re-positioned windows get presented together.
+    wlmtk_transaction_t *transaction_ptr = wlmtk_transaction_create();
+    for (bs_dllist_node_t *dlnode_ptr = workspace_ptr->windows.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        _wlmtk_window_reposition_window(dlnode_ptr, workspace_ptr);
+        wlmtk_transaction_add_window(
+            transaction_ptr, wlmtk_window_from_dlnode(dlnode_ptr));
+    }
+    wlmtk_transaction_commit(transaction_ptr);
+    _wlmtk_workspace_update_occlusion(workspace_ptr);
+}
 
-    bs_dllist_for_each(
-        &workspace_ptr->windows,
-        _wlmtk_window_reposition_window,
+/* ------------------------------------------------------------------------- */
+/**
+ * Occludes the panels of all layers on outputs covered by a fullscreen
+ * window. This takes the background, dock, clip and layer shells out of the
+ * scene output, so that it may scan out the client's buffer directly.
+ *
+ * @param workspace_ptr
+ */
+void _wlmtk_workspace_update_occlusion(wlmtk_workspace_t *workspace_ptr)
+{
+    wlmtk_util_wl_list_for_each(
+        &workspace_ptr->wlr_output_layout_ptr->outputs,
+        _wlmtk_workspace_occlude_output,
         workspace_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Occludes the windows of `container_ptr` that are within `covered_ptr`, top
+ * to bottom. Adds the opaque area of each non-occluded window to it. Windows
+ * on an output that does not show the workspace are occluded, too.
+ *
+ * @param workspace_ptr
+ * @param container_ptr
+ * @param covered_ptr
+ *
+ * @return Number of occluded windows.
+ */
+size_t _wlmtk_workspace_occlude_windows(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_container_t *container_ptr,
+    pixman_region32_t *covered_ptr)
+{
+    size_t occluded_windows = 0;
+    for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
+        if (!element_ptr->visible) continue;
+        if (!_wlmtk_workspace_element_shown(workspace_ptr, element_ptr)) {
+            wlmtk_element_set_occluded(element_ptr, true);
+            ++occluded_windows;
+            continue;
+        }
+
+        struct wlr_box box = wlmtk_element_get_dimensions_box(element_ptr);
+        pixman_box32_t extents = {
+            .x1 = element_ptr->x + box.x,
+            .y1 = element_ptr->y + box.y,
+            .x2 = element_ptr->x + box.x + box.width,
+            .y2 = element_ptr->y + box.y + box.height };
+        bool occluded = PIXMAN_REGION_IN == pixman_region32_contains_rectangle(
+            covered_ptr, &extents);
+        wlmtk_element_set_occluded(element_ptr, occluded);
+        if (occluded) {
+            ++occluded_windows;
+            continue;
+        }
+
+        if (wlmtk_window_get_opaque_box(
+                wlmtk_window_from_element(element_ptr), &box)) {
+            pixman_region32_union_rect(
+                covered_ptr, covered_ptr,
+                box.x, box.y, box.width, box.height);
+        }
+    }
+    return occluded_windows;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns whether the output at the center of `element_ptr` shows the
+ * workspace. Always true, unless per-output workspaces are enabled.
+ *
+ * @param workspace_ptr
+ * @param element_ptr
+ */
+bool _wlmtk_workspace_element_shown(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_element_t *element_ptr)
+{
+    if (NULL == workspace_ptr->root_ptr ||
+        !wlmtk_root_per_output_workspaces(workspace_ptr->root_ptr)) {
+        return true;
+    }
+
+    struct wlr_box box = wlmtk_element_get_dimensions_box(element_ptr);
+    double x = element_ptr->x + box.x + box.width / 2.0;
+    double y = element_ptr->y + box.y + box.height / 2.0;
+    struct wlr_output *wlr_output_ptr = wlr_output_layout_output_at(
+        workspace_ptr->wlr_output_layout_ptr, x, y);
+    if (NULL == wlr_output_ptr) {
+        double cx, cy;
+        wlr_output_layout_closest_point(
+            workspace_ptr->wlr_output_layout_ptr, NULL, x, y, &cx, &cy);
+        wlr_output_ptr = wlr_output_layout_output_at(
+            workspace_ptr->wlr_output_layout_ptr, cx, cy);
+    }
+    return wlmtk_root_workspace_shown_on_output(
+        workspace_ptr->root_ptr, workspace_ptr, wlr_output_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Sets occlusion of layers on the output at `link_ptr`. Always true. */
+bool _wlmtk_workspace_occlude_output(
+    struct wl_list *link_ptr,
+    void *ud_ptr)
+{
+    struct wlr_output *wlr_output_ptr = BS_CONTAINER_OF(
+        link_ptr, struct wlr_output_layout_output, link)->output;
+    wlmtk_workspace_t *workspace_ptr = ud_ptr;
+    bool occluded = wlmtk_workspace_has_fullscreen_window(
+        workspace_ptr, wlr_output_ptr);
+    if (NULL != workspace_ptr->root_ptr &&
+        !wlmtk_root_workspace_shown_on_output(
+            workspace_ptr->root_ptr, workspace_ptr, wlr_output_ptr)) {
+        occluded = true;
+    }
+
+    wlmtk_layer_t *layer_ptrs[] = {
+        workspace_ptr->background_layer_ptr,
+        workspace_ptr->bottom_layer_ptr,
+        workspace_ptr->top_layer_ptr,
+        workspace_ptr->overlay_layer_ptr };
+    for (size_t i = 0; i < sizeof(layer_ptrs) / sizeof(layer_ptrs[0]); ++i) {
+        if (NULL == layer_ptrs[i]) continue;
+        wlmtk_layer_set_output_occluded(
+            layer_ptrs[i], wlr_output_ptr, occluded);
+    }
+    return true;
+}
+
 /* ------------------------------------------------------------------------- */
 /** Handles @ref wlmtk_element_events_t::pointer_leave. Reset state machine. */
 void _wlmtk_workspace_handle_element_pointer_leave(
@@ -1013,11 +1731,242 @@ void _wlmtk_window_reposition_window(
         return;
     }
 
-    wlmtk_window_request_position_and_size(
-        window_ptr, output_box.x, output_box.y, wbox.width, wbox.height);
+    wlmtk_window_request_position_and_size(
+        window_ptr, output_box.x, output_box.y, wbox.width, wbox.height);
+}
+
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Shows the outline at the position and size of `box_ptr`.
+ *
+ * @param workspace_ptr
+ * @param box_ptr
+ */
+void _wlmtk_workspace_outline_show(
+    wlmtk_workspace_t *workspace_ptr,
+    const struct wlr_box *box_ptr)
+{
+    int w = BS_MIN(WLMTK_WORKSPACE_OUTLINE_WIDTH, box_ptr->width);
+    int h = BS_MIN(WLMTK_WORKSPACE_OUTLINE_WIDTH, box_ptr->height);
+    struct wlr_box edges[4] = {
+        { box_ptr->x, box_ptr->y, box_ptr->width, h },
+        { box_ptr->x, box_ptr->y + box_ptr->height - h, box_ptr->width, h },
+        { box_ptr->x, box_ptr->y, w, box_ptr->height },
+        { box_ptr->x + box_ptr->width - w, box_ptr->y, w, box_ptr->height }
+    };
+    for (size_t i = 0; i < 4; ++i) {
+        wlmtk_rectangle_t *r_ptr = workspace_ptr->outline_rectangle_ptrs[i];
+        wlmtk_rectangle_set_size(r_ptr, edges[i].width, edges[i].height);
+        wlmtk_element_set_position(
+            wlmtk_rectangle_element(r_ptr), edges[i].x, edges[i].y);
+    }
+
+    workspace_ptr->outline_box = *box_ptr;
+    if (!workspace_ptr->outline_active) {
+        wlmtk_element_set_visible(
+            &workspace_ptr->outline_container.super_element, true);
+        workspace_ptr->outline_active = true;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Hides the outline, if shown. */
+void _wlmtk_workspace_outline_hide(wlmtk_workspace_t *workspace_ptr)
+{
+    if (!workspace_ptr->outline_active) return;
+    wlmtk_element_set_visible(
+        &workspace_ptr->outline_container.super_element, false);
+    workspace_ptr->outline_active = false;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Captures the edges that the grabbed window may snap to: Of the outputs,
+ * the layer panels and the other windows. Sorted, so that each motion only
+ * needs a binary search.
+ *
+ * @param workspace_ptr
+ */
+void _wlmtk_workspace_capture_snap_edges(wlmtk_workspace_t *workspace_ptr)
+{
+    workspace_ptr->snap_x_edges.size = 0;
+    workspace_ptr->snap_y_edges.size = 0;
+    if (0 >= workspace_ptr->snap_distance) return;
+
+    struct wlr_output_layout_output *wlr_output_layout_output_ptr;
+    wl_list_for_each(wlr_output_layout_output_ptr,
+                     &workspace_ptr->wlr_output_layout_ptr->outputs,
+                     link) {
+        struct wlr_box box;
+        wlr_output_layout_get_box(
+            workspace_ptr->wlr_output_layout_ptr,
+            wlr_output_layout_output_ptr->output,
+            &box);
+        _wlmtk_workspace_add_snap_box(&box, workspace_ptr);
+    }
+
+    wlmtk_layer_t *layer_ptrs[] = {
+        workspace_ptr->background_layer_ptr,
+        workspace_ptr->bottom_layer_ptr,
+        workspace_ptr->top_layer_ptr,
+        workspace_ptr->overlay_layer_ptr };
+    for (size_t i = 0; i < sizeof(layer_ptrs) / sizeof(layer_ptrs[0]); ++i) {
+        if (NULL == layer_ptrs[i]) continue;
+        wlmtk_layer_for_each_panel_box(
+            layer_ptrs[i], _wlmtk_workspace_add_snap_box, workspace_ptr);
+    }
+
+    for (bs_dllist_node_t *dlnode_ptr = workspace_ptr->windows.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_window_t *window_ptr = wlmtk_window_from_dlnode(dlnode_ptr);
+        if (window_ptr == workspace_ptr->grabbed_window_ptr ||
+            !wlmtk_window_element(window_ptr)->visible) continue;
+        struct wlr_box box = wlmtk_window_get_position_and_size(window_ptr);
+        _wlmtk_workspace_add_snap_box(&box, workspace_ptr);
+    }
+
+    _wlmtk_workspace_edges_sort(&workspace_ptr->snap_x_edges);
+    _wlmtk_workspace_edges_sort(&workspace_ptr->snap_y_edges);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Adds the edges of `box_ptr` to the snap edges of workspace `ud_ptr`. */
+void _wlmtk_workspace_add_snap_box(
+    const struct wlr_box *box_ptr,
+    void *ud_ptr)
+{
+    wlmtk_workspace_t *workspace_ptr = ud_ptr;
+    if (wlr_box_empty(box_ptr)) return;
+    _wlmtk_workspace_edges_add(&workspace_ptr->snap_x_edges, box_ptr->x);
+    _wlmtk_workspace_edges_add(
+        &workspace_ptr->snap_x_edges, box_ptr->x + box_ptr->width);
+    _wlmtk_workspace_edges_add(&workspace_ptr->snap_y_edges, box_ptr->y);
+    _wlmtk_workspace_edges_add(
+        &workspace_ptr->snap_y_edges, box_ptr->y + box_ptr->height);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Appends `value` to `edges_ptr`. Returns false on allocation failure. */
+bool _wlmtk_workspace_edges_add(
+    _wlmtk_workspace_edges_t *edges_ptr,
+    int value)
+{
+    if (edges_ptr->size >= edges_ptr->capacity) {
+        size_t new_capacity = BS_MAX(16U, 2 * edges_ptr->capacity);
+        int *new_values = logged_calloc(new_capacity, sizeof(int));
+        if (NULL == new_values) return false;
+        if (0 < edges_ptr->size) {
+            memcpy(new_values, edges_ptr->values,
+                   edges_ptr->size * sizeof(int));
+        }
+        if (NULL != edges_ptr->values) free(edges_ptr->values);
+        edges_ptr->values = new_values;
+        edges_ptr->capacity = new_capacity;
+    }
+    edges_ptr->values[edges_ptr->size++] = value;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Sorts the edges, and removes duplicates. */
+void _wlmtk_workspace_edges_sort(_wlmtk_workspace_edges_t *edges_ptr)
+{
+    if (0 == edges_ptr->size) return;
+    qsort(edges_ptr->values, edges_ptr->size, sizeof(int),
+          _wlmtk_workspace_edges_cmp);
+    size_t size = 1;
+    for (size_t i = 1; i < edges_ptr->size; ++i) {
+        if (edges_ptr->values[i] == edges_ptr->values[size - 1]) continue;
+        edges_ptr->values[size++] = edges_ptr->values[i];
+    }
+    edges_ptr->size = size;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Comparator for qsort of `int`. */
+int _wlmtk_workspace_edges_cmp(const void *a_ptr, const void *b_ptr)
+{
+    int a = *(const int*)a_ptr, b = *(const int*)b_ptr;
+    return (a > b) - (a < b);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Snaps a window's extent along one axis: Moves it so that its start or end
+ * aligns with the nearest edge within `distance`.
+ *
+ * @param edges_ptr
+ * @param position            The window's start.
+ * @param size                The window's extent.
+ * @param distance
+ *
+ * @return The snapped start position, or `position` if there is no edge
+ *     within `distance`.
+ */
+int _wlmtk_workspace_snap(
+    const _wlmtk_workspace_edges_t *edges_ptr,
+    int position,
+    int size,
+    int distance)
+{
+    if (0 >= distance) return position;
+
+    int start_delta, end_delta;
+    bool start = _wlmtk_workspace_edges_nearest(
+        edges_ptr, position, &start_delta);
+    bool end = _wlmtk_workspace_edges_nearest(
+        edges_ptr, position + size, &end_delta);
+    start = start && abs(start_delta) <= distance;
+    end = end && abs(end_delta) <= distance;
+
+    if (start && (!end || abs(start_delta) <= abs(end_delta))) {
+        return position + start_delta;
+    }
+    if (end) return position + end_delta;
+    return position;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Finds the edge nearest to `value`, by binary search.
+ *
+ * @param edges_ptr
+ * @param value
+ * @param delta_ptr           Set to the offset from `value` to the edge.
+ *
+ * @return false if there are no edges.
+ */
+bool _wlmtk_workspace_edges_nearest(
+    const _wlmtk_workspace_edges_t *edges_ptr,
+    int value,
+    int *delta_ptr)
+{
+    if (0 == edges_ptr->size) return false;
+
+    // Lower bound: First edge that is not less than `value`.
+    size_t low = 0, high = edges_ptr->size;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (edges_ptr->values[mid] < value) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    if (low < edges_ptr->size) {
+        *delta_ptr = edges_ptr->values[low] - value;
+        if (0 < low && value - edges_ptr->values[low - 1] < *delta_ptr) {
+            *delta_ptr = edges_ptr->values[low - 1] - value;
+        }
+    } else {
+        *delta_ptr = edges_ptr->values[low - 1] - value;
+    }
+    return true;
 }
 
-
 /* ------------------------------------------------------------------------- */
 /** Initiates a move. */
 bool pfsm_move_begin(wlmtk_fsm_t *fsm_ptr, void *ud_ptr)
@@ -1035,6 +1984,11 @@ bool pfsm_move_begin(wlmtk_fsm_t *fsm_ptr, void *ud_ptr)
         wlmtk_window_element(workspace_ptr->grabbed_window_ptr),
         &workspace_ptr->initial_x,
         &workspace_ptr->initial_y);
+    wlmtk_window_get_size(
+        workspace_ptr->grabbed_window_ptr,
+        &workspace_ptr->initial_width,
+        &workspace_ptr->initial_height);
+    _wlmtk_workspace_capture_snap_edges(workspace_ptr);
 
     // TODO(kaeser@gubbe.ch): When in move mode, set (and keep) a corresponding
     // cursor image.
@@ -1055,14 +2009,53 @@ bool pfsm_move_motion(wlmtk_fsm_t *fsm_ptr, __UNUSED__ void *ud_ptr)
         workspace_ptr->super_container.super_element.last_pointer_motion_event.y -
         workspace_ptr->motion_y;
 
-    wlmtk_window_set_position(
-        workspace_ptr->grabbed_window_ptr,
+    int x = _wlmtk_workspace_snap(
+        &workspace_ptr->snap_x_edges,
         workspace_ptr->initial_x + rel_x,
-        workspace_ptr->initial_y + rel_y);
+        workspace_ptr->initial_width,
+        workspace_ptr->snap_distance);
+    int y = _wlmtk_workspace_snap(
+        &workspace_ptr->snap_y_edges,
+        workspace_ptr->initial_y + rel_y,
+        workspace_ptr->initial_height,
+        workspace_ptr->snap_distance);
+
+    if (WLMTK_WORKSPACE_DRAG_OUTLINE == workspace_ptr->drag_mode) {
+        struct wlr_box box = {
+            .x = x,
+            .y = y,
+            .width = workspace_ptr->initial_width,
+            .height = workspace_ptr->initial_height
+        };
+        _wlmtk_workspace_outline_show(workspace_ptr, &box);
+        return true;
+    }
+
+    // Translation only: The motion event updates pointer focus, right after.
+    wlmtk_window_translate(workspace_ptr->grabbed_window_ptr, x, y);
 
     return true;
 }
 
+/* ------------------------------------------------------------------------- */
+/** Ends a move: Moves the window to where the outline is, if shown. */
+bool pfsm_move_release(wlmtk_fsm_t *fsm_ptr, void *ud_ptr)
+{
+    wlmtk_workspace_t *workspace_ptr = BS_CONTAINER_OF(
+        fsm_ptr, wlmtk_workspace_t, fsm);
+
+    if (workspace_ptr->outline_active) {
+        wlmtk_window_set_position(
+            workspace_ptr->grabbed_window_ptr,
+            workspace_ptr->outline_box.x,
+            workspace_ptr->outline_box.y);
+    } else {
+        // Translations skipped this. Catch up, the pointer may not move.
+        wlmtk_container_update_pointer_focus(&workspace_ptr->window_container);
+    }
+    return pfsm_reset(fsm_ptr, ud_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Initiates a resize. */
 bool pfsm_resize_begin(wlmtk_fsm_t *fsm_ptr, void *ud_ptr)
@@ -1124,19 +2117,54 @@ bool pfsm_resize_motion(wlmtk_fsm_t *fsm_ptr, __UNUSED__ void *ud_ptr)
         if (right <= left) right = left + 1;
     }
 
-    wlmtk_window_request_position_and_size(
+    if (WLMTK_WORKSPACE_DRAG_OUTLINE == workspace_ptr->drag_mode) {
+        struct wlr_box box = {
+            .x = left, .y = top, .width = right - left, .height = bottom - top
+        };
+        _wlmtk_workspace_outline_show(workspace_ptr, &box);
+        return true;
+    }
+
+    // Paced, to not flood the client with configures it can't keep up with.
+    wlmtk_pointer_motion_event_t *mev_ptr =
+        &workspace_ptr->super_container.super_element.last_pointer_motion_event;
+    wlmtk_window_request_position_and_size_paced(
         workspace_ptr->grabbed_window_ptr,
         left, top,
-        right - left, bottom - top);
+        right - left, bottom - top,
+        mev_ptr->time_msec);
     return true;
 }
 
+/* ------------------------------------------------------------------------- */
+/** Ends a resize: Configures the window to the outline, if shown. */
+bool pfsm_resize_release(wlmtk_fsm_t *fsm_ptr, void *ud_ptr)
+{
+    wlmtk_workspace_t *workspace_ptr = BS_CONTAINER_OF(
+        fsm_ptr, wlmtk_workspace_t, fsm);
+
+    if (workspace_ptr->outline_active) {
+        wlmtk_window_request_position_and_size(
+            workspace_ptr->grabbed_window_ptr,
+            workspace_ptr->outline_box.x,
+            workspace_ptr->outline_box.y,
+            workspace_ptr->outline_box.width,
+            workspace_ptr->outline_box.height);
+    }
+    return pfsm_reset(fsm_ptr, ud_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Resets the state machine. */
 bool pfsm_reset(wlmtk_fsm_t *fsm_ptr, __UNUSED__ void *ud_ptr)
 {
     wlmtk_workspace_t *workspace_ptr = BS_CONTAINER_OF(
         fsm_ptr, wlmtk_workspace_t, fsm);
+    // Don't leave the last coalesced resize behind.
+    if (NULL != workspace_ptr->grabbed_window_ptr) {
+        wlmtk_window_flush_paced(workspace_ptr->grabbed_window_ptr);
+    }
+    _wlmtk_workspace_outline_hide(workspace_ptr);
     workspace_ptr->grabbed_window_ptr = NULL;
     return true;
 }
@@ -1146,25 +2174,35 @@ bool pfsm_reset(wlmtk_fsm_t *fsm_ptr, __UNUSED__ void *ud_ptr)
 static void test_create_destroy(bs_test_t *test_ptr);
 static void test_map_unmap(bs_test_t *test_ptr);
 static void test_move(bs_test_t *test_ptr);
+static void test_move_snap(bs_test_t *test_ptr);
 static void test_unmap_during_move(bs_test_t *test_ptr);
 static void test_resize(bs_test_t *test_ptr);
+static void test_outline(bs_test_t *test_ptr);
 static void test_enable(bs_test_t *test_ptr);
 static void test_activate(bs_test_t *test_ptr);
 static void test_activate_cycling(bs_test_t *test_ptr);
+static void test_transaction(bs_test_t *test_ptr);
 static void test_multi_output_extents(bs_test_t *test_ptr);
 static void test_multi_output_reposition(bs_test_t *test_ptr);
+static void test_occlusion(bs_test_t *test_ptr);
+static void test_place_window(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_workspace_test_cases[] = {
     { 1, "create_destroy", test_create_destroy },
     { 1, "map_unmap", test_map_unmap },
     { 1, "move", test_move },
+    { 1, "move_snap", test_move_snap },
     { 1, "unmap_during_move", test_unmap_during_move },
     { 1, "resize", test_resize },
+    { 1, "outline", test_outline },
     { 1, "enable", test_enable } ,
     { 1, "activate", test_activate },
     { 1, "activate_cycling", test_activate_cycling },
+    { 1, "transaction", test_transaction },
     { 1, "multi_output_extents", test_multi_output_extents },
     { 1, "multi_output_reposition", test_multi_output_reposition },
+    { 1, "occlusion", test_occlusion },
+    { 1, "place_window", test_place_window },
     { 0, NULL, NULL }
 };
 
@@ -1289,6 +2327,31 @@ void test_map_unmap(bs_test_t *test_ptr)
     BS_TEST_VERIFY_EQ(test_ptr, 0, bs_dllist_size(wdl_ptr));
     BS_TEST_VERIFY_EQ(test_ptr, 1, unmapped.calls);
 
+    // Parking: Unmaps the window, but keeps its scene node for next map.
+    wlmtk_container_t parking;
+    BS_TEST_VERIFY_TRUE_OR_RETURN(
+        test_ptr,
+        wlmtk_container_init_attached(&parking, &wlr_scene_ptr->tree));
+    wlmtk_workspace_map_window(workspace_ptr, fw_ptr->window_ptr);
+    struct wlr_scene_node *node_ptr =
+        wlmtk_window_element(fw_ptr->window_ptr)->wlr_scene_node_ptr;
+    wlmtk_workspace_park_window(workspace_ptr, fw_ptr->window_ptr, &parking);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, wlmtk_window_get_workspace(
+                          fw_ptr->window_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, bs_dllist_size(wdl_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 2, unmapped.calls);
+    BS_TEST_VERIFY_FALSE(test_ptr, node_ptr->enabled);
+    BS_TEST_VERIFY_EQ(test_ptr, node_ptr, wlmtk_window_element(
+                          fw_ptr->window_ptr)->wlr_scene_node_ptr);
+    wlmtk_workspace_map_window(workspace_ptr, fw_ptr->window_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, node_ptr, wlmtk_window_element(
+                          fw_ptr->window_ptr)->wlr_scene_node_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, node_ptr->enabled);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, bs_dllist_size(wdl_ptr));
+    BS_TEST_VERIFY_TRUE(test_ptr, bs_dllist_empty(&parking.elements));
+    wlmtk_workspace_unmap_window(workspace_ptr, fw_ptr->window_ptr);
+    wlmtk_container_fini(&parking);
+
     wlmtk_util_disconnect_test_listener(&mapped);
     wlmtk_util_disconnect_test_listener(&unmapped);
     wlmtk_fake_window_destroy(fw_ptr);
@@ -1357,6 +2420,69 @@ void test_move(bs_test_t *test_ptr)
     wl_display_destroy(display_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests snapping to window and output edges when moving a window. */
+void test_move_snap(bs_test_t *test_ptr)
+{
+    struct wl_display *display_ptr = wl_display_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, display_ptr);
+    struct wlr_output_layout *wlr_output_layout_ptr =
+        wlr_output_layout_create(display_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_output_layout_ptr);
+    struct wlr_output output = { .width = 1024, .height = 768, .scale = 1 };
+    wlmtk_test_wlr_output_init(&output);
+    wlr_output_layout_add(wlr_output_layout_ptr, &output, 0, 0);
+    wlmtk_workspace_t *ws_ptr = wlmtk_workspace_create(
+        wlr_output_layout_ptr, "t", &_wlmtk_workspace_test_tile_style);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws_ptr);
+    wlmtk_workspace_set_snap_distance(ws_ptr, 10);
+
+    wlmtk_fake_window_t *fw1_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fw1_ptr);
+    wlmtk_workspace_map_window(ws_ptr, fw1_ptr->window_ptr);
+    wlmtk_window_request_position_and_size(
+        fw1_ptr->window_ptr, 0, 0, 200, 100);
+    wlmtk_fake_window_commit_size(fw1_ptr);
+    wlmtk_fake_window_t *fw2_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fw2_ptr);
+    wlmtk_workspace_map_window(ws_ptr, fw2_ptr->window_ptr);
+    wlmtk_window_request_position_and_size(
+        fw2_ptr->window_ptr, 500, 300, 100, 100);
+    wlmtk_fake_window_commit_size(fw2_ptr);
+    wlmtk_element_t *e2_ptr = wlmtk_window_element(fw2_ptr->window_ptr);
+
+    wlmtk_pointer_motion_event_t mev = { .x = 500, .y = 300 };
+    wlmtk_element_pointer_motion(wlmtk_workspace_element(ws_ptr), &mev);
+    wlmtk_workspace_begin_window_move(ws_ptr, fw2_ptr->window_ptr);
+
+    // Left edge near the first window's right edge: Snaps to it.
+    mev = (wlmtk_pointer_motion_event_t){ .x = 206, .y = 300 };
+    wlmtk_element_pointer_motion(wlmtk_workspace_element(ws_ptr), &mev);
+    BS_TEST_VERIFY_EQ(test_ptr, 200, e2_ptr->x);
+    BS_TEST_VERIFY_EQ(test_ptr, 300, e2_ptr->y);
+
+    // Right edge near the output's right edge, top near the first window's
+    // bottom edge.
+    mev = (wlmtk_pointer_motion_event_t){ .x = 920, .y = 95 };
+    wlmtk_element_pointer_motion(wlmtk_workspace_element(ws_ptr), &mev);
+    BS_TEST_VERIFY_EQ(test_ptr, 924, e2_ptr->x);
+    BS_TEST_VERIFY_EQ(test_ptr, 100, e2_ptr->y);
+
+    // Beyond the distance: Follows the pointer.
+    mev = (wlmtk_pointer_motion_event_t){ .x = 700, .y = 400 };
+    wlmtk_element_pointer_motion(wlmtk_workspace_element(ws_ptr), &mev);
+    BS_TEST_VERIFY_EQ(test_ptr, 700, e2_ptr->x);
+    BS_TEST_VERIFY_EQ(test_ptr, 400, e2_ptr->y);
+
+    wlmtk_workspace_unmap_window(ws_ptr, fw2_ptr->window_ptr);
+    wlmtk_fake_window_destroy(fw2_ptr);
+    wlmtk_workspace_unmap_window(ws_ptr, fw1_ptr->window_ptr);
+    wlmtk_fake_window_destroy(fw1_ptr);
+    wlmtk_workspace_destroy(ws_ptr);
+    wlr_output_layout_destroy(wlr_output_layout_ptr);
+    wl_display_destroy(display_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Tests moving a window that unmaps during the move. */
 void test_unmap_during_move(bs_test_t *test_ptr)
@@ -1477,6 +2603,75 @@ void test_resize(bs_test_t *test_ptr)
     wl_display_destroy(display_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests move and resize with @ref WLMTK_WORKSPACE_DRAG_OUTLINE. */
+void test_outline(bs_test_t *test_ptr)
+{
+    struct wl_display *display_ptr = wl_display_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, display_ptr);
+    struct wlr_output_layout *wlr_output_layout_ptr =
+        wlr_output_layout_create(display_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_output_layout_ptr);
+    struct wlr_output output = { .width = 1024, .height = 768, .scale = 1 };
+    wlmtk_test_wlr_output_init(&output);
+    wlr_output_layout_add(wlr_output_layout_ptr, &output, 0, 0);
+
+    wlmtk_workspace_t *ws_ptr = wlmtk_workspace_create(
+        wlr_output_layout_ptr, "t", &_wlmtk_workspace_test_tile_style);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws_ptr);
+    wlmtk_workspace_set_drag_mode(ws_ptr, WLMTK_WORKSPACE_DRAG_OUTLINE);
+    wlmtk_element_t *outline_element_ptr =
+        &ws_ptr->outline_container.super_element;
+
+    wlmtk_fake_window_t *fw_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fw_ptr);
+    wlmtk_window_request_position_and_size(fw_ptr->window_ptr, 0, 0, 40, 20);
+    wlmtk_fake_window_commit_size(fw_ptr);
+    wlmtk_pointer_motion_event_t mev = { .x = 0, .y = 0 };
+    wlmtk_element_pointer_motion(wlmtk_workspace_element(ws_ptr),  &mev);
+    wlmtk_workspace_map_window(ws_ptr, fw_ptr->window_ptr);
+    wlmtk_button_event_t button_event = {
+        .button = BTN_LEFT,
+        .type = WLMTK_BUTTON_UP,
+        .time_msec = 44,
+    };
+
+    // Move: Only the outline moves, until the button is released.
+    wlmtk_workspace_begin_window_move(ws_ptr, fw_ptr->window_ptr);
+    mev = (wlmtk_pointer_motion_event_t){ .x = 3, .y = 4 };
+    wlmtk_element_pointer_motion(wlmtk_workspace_element(ws_ptr), &mev);
+    BS_TEST_VERIFY_TRUE(test_ptr, outline_element_ptr->visible);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_window_element(fw_ptr->window_ptr)->x);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_window_element(fw_ptr->window_ptr)->y);
+    wlmtk_element_pointer_button(
+        wlmtk_workspace_element(ws_ptr), &button_event);
+    BS_TEST_VERIFY_FALSE(test_ptr, outline_element_ptr->visible);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, wlmtk_window_element(fw_ptr->window_ptr)->x);
+    BS_TEST_VERIFY_EQ(test_ptr, 4, wlmtk_window_element(fw_ptr->window_ptr)->y);
+
+    // Resize: The client is configured only when the button is released.
+    wlmtk_workspace_begin_window_resize(
+        ws_ptr, fw_ptr->window_ptr, WLR_EDGE_BOTTOM | WLR_EDGE_RIGHT);
+    fw_ptr->fake_content_ptr->serial = 1;
+    mev = (wlmtk_pointer_motion_event_t){ .x = 5, .y = 7 };
+    wlmtk_element_pointer_motion(wlmtk_workspace_element(ws_ptr), &mev);
+    mev = (wlmtk_pointer_motion_event_t){ .x = 13, .y = 14 };
+    wlmtk_element_pointer_motion(wlmtk_workspace_element(ws_ptr), &mev);
+    BS_TEST_VERIFY_TRUE(test_ptr, outline_element_ptr->visible);
+    BS_TEST_VERIFY_EQ(test_ptr, 40, fw_ptr->fake_content_ptr->requested_width);
+    BS_TEST_VERIFY_EQ(test_ptr, 20, fw_ptr->fake_content_ptr->requested_height);
+    wlmtk_element_pointer_button(
+        wlmtk_workspace_element(ws_ptr), &button_event);
+    BS_TEST_VERIFY_FALSE(test_ptr, outline_element_ptr->visible);
+    BS_TEST_VERIFY_EQ(test_ptr, 50, fw_ptr->fake_content_ptr->requested_width);
+    BS_TEST_VERIFY_EQ(test_ptr, 30, fw_ptr->fake_content_ptr->requested_height);
+
+    wlmtk_workspace_unmap_window(ws_ptr, fw_ptr->window_ptr);
+    wlmtk_fake_window_destroy(fw_ptr);
+    wlmtk_workspace_destroy(ws_ptr);
+    wl_display_destroy(display_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Tests enabling or disabling the workspace. */
 void test_enable(bs_test_t *test_ptr)
@@ -1755,6 +2950,94 @@ void test_activate_cycling(bs_test_t *test_ptr)
     wl_display_destroy(display_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests batched window changes through a transaction. */
+void test_transaction(bs_test_t *test_ptr)
+{
+    struct wl_display *display_ptr = wl_display_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, display_ptr);
+    struct wlr_output_layout *wlr_output_layout_ptr =
+        wlr_output_layout_create(display_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_output_layout_ptr);
+    struct wlr_output output = { .width = 1024, .height = 768, .scale = 1 };
+    wlmtk_test_wlr_output_init(&output);
+    wlr_output_layout_add(wlr_output_layout_ptr, &output, 0, 0);
+
+    wlmtk_workspace_t *ws1_ptr = wlmtk_workspace_create(
+        wlr_output_layout_ptr, "1", &_wlmtk_workspace_test_tile_style);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws1_ptr);
+    wlmtk_workspace_enable(ws1_ptr, true);
+    wlmtk_workspace_t *ws2_ptr = wlmtk_workspace_create(
+        wlr_output_layout_ptr, "2", &_wlmtk_workspace_test_tile_style);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws2_ptr);
+
+    wlmtk_fake_window_t *fw1_ptr = wlmtk_fake_window_create();
+    wlmtk_workspace_map_window(ws1_ptr, fw1_ptr->window_ptr);
+    wlmtk_fake_window_t *fw2_ptr = wlmtk_fake_window_create();
+    wlmtk_workspace_map_window(ws1_ptr, fw2_ptr->window_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_window_is_activated(fw2_ptr->window_ptr));
+
+    // Nested transaction: Nothing is applied before the outermost commit.
+    wlmtk_workspace_begin_transaction(ws1_ptr);
+    wlmtk_workspace_begin_transaction(ws1_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_workspace_enqueue_position_and_size(
+            ws1_ptr, fw1_ptr->window_ptr, 10, 20, 100, 50));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_workspace_enqueue_position_and_size(
+            ws1_ptr, fw2_ptr->window_ptr, 10, 20, 100, 50));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_workspace_enqueue_position_and_size(
+            ws1_ptr, fw2_ptr->window_ptr, 30, 40, 200, 60));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_workspace_enqueue_move_to_workspace(
+            ws1_ptr, fw2_ptr->window_ptr, ws2_ptr));
+    wlmtk_workspace_commit_transaction(ws1_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0, fw1_ptr->fake_content_ptr->requested_width);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, ws1_ptr, wlmtk_window_get_workspace(fw2_ptr->window_ptr));
+
+    wlmtk_workspace_commit_transaction(ws1_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 100, fw1_ptr->fake_content_ptr->requested_width);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 50, fw1_ptr->fake_content_ptr->requested_height);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 200, fw2_ptr->fake_content_ptr->requested_width);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 60, fw2_ptr->fake_content_ptr->requested_height);
+
+    // Window 2 moved, and got activated there. Window 1 took over.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, ws2_ptr, wlmtk_window_get_workspace(fw2_ptr->window_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr,
+        fw1_ptr->window_ptr,
+        wlmtk_workspace_get_activated_window(ws1_ptr));
+
+    // Unmapping a window drops its enqueued change.
+    wlmtk_workspace_begin_transaction(ws1_ptr);
+    wlmtk_workspace_enqueue_move_to_workspace(
+        ws1_ptr, fw1_ptr->window_ptr, ws2_ptr);
+    wlmtk_workspace_unmap_window(ws1_ptr, fw1_ptr->window_ptr);
+    wlmtk_workspace_commit_transaction(ws1_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL, wlmtk_window_get_workspace(fw1_ptr->window_ptr));
+
+    wlmtk_workspace_unmap_window(ws2_ptr, fw2_ptr->window_ptr);
+    wlmtk_fake_window_destroy(fw2_ptr);
+    wlmtk_fake_window_destroy(fw1_ptr);
+    wlmtk_workspace_destroy(ws2_ptr);
+    wlmtk_workspace_destroy(ws1_ptr);
+    wl_display_destroy(display_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Tests extents with multiple outputs. */
 void test_multi_output_extents(bs_test_t *test_ptr)
@@ -1899,4 +3182,122 @@ void test_multi_output_reposition(bs_test_t *test_ptr)
     wlr_output_layout_destroy(wlr_output_layout_ptr);
     wl_display_destroy(display_ptr);
 }
+/* ------------------------------------------------------------------------- */
+/** Tests that windows covered by opaque windows above are occluded. */
+void test_occlusion(bs_test_t *test_ptr)
+{
+    struct wl_display *display_ptr = wl_display_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, display_ptr);
+    struct wlr_output_layout *wlr_output_layout_ptr =
+        wlr_output_layout_create(display_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_output_layout_ptr);
+    struct wlr_output output = { .width = 1024, .height = 768, .scale = 1 };
+    wlmtk_test_wlr_output_init(&output);
+    wlr_output_layout_add(wlr_output_layout_ptr, &output, 0, 0);
+    wlmtk_workspace_t *ws_ptr = wlmtk_workspace_create(
+        wlr_output_layout_ptr, "t", &_wlmtk_workspace_test_tile_style);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws_ptr);
+
+    wlmtk_fake_window_t *fw1_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fw1_ptr);
+    wlmtk_workspace_map_window(ws_ptr, fw1_ptr->window_ptr);
+    wlmtk_window_request_position_and_size(
+        fw1_ptr->window_ptr, 100, 100, 200, 100);
+    wlmtk_fake_window_commit_size(fw1_ptr);
+    wlmtk_element_t *e1_ptr = wlmtk_window_element(fw1_ptr->window_ptr);
+
+    // Second window is mapped on top, and covers the first one.
+    wlmtk_fake_window_t *fw2_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fw2_ptr);
+    wlmtk_workspace_map_window(ws_ptr, fw2_ptr->window_ptr);
+    wlmtk_window_request_position_and_size(
+        fw2_ptr->window_ptr, 0, 0, 400, 300);
+    wlmtk_fake_window_commit_size(fw2_ptr);
+
+    // Not opaque: Nothing is occluded.
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_workspace_update_occlusion(ws_ptr));
+    BS_TEST_VERIFY_FALSE(test_ptr, e1_ptr->occluded);
+
+    wlmtk_content_set_opaque(&fw2_ptr->fake_content_ptr->content, true);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmtk_workspace_update_occlusion(ws_ptr));
+    BS_TEST_VERIFY_TRUE(test_ptr, e1_ptr->occluded);
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlmtk_window_element(fw2_ptr->window_ptr)->occluded);
+
+    // Partially covered only: Not occluded.
+    wlmtk_window_request_position_and_size(
+        fw1_ptr->window_ptr, 300, 100, 200, 100);
+    wlmtk_fake_window_commit_size(fw1_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_workspace_update_occlusion(ws_ptr));
+    BS_TEST_VERIFY_FALSE(test_ptr, e1_ptr->occluded);
+
+    // Covered again, then unmapped: Clears occlusion.
+    wlmtk_window_request_position_and_size(
+        fw1_ptr->window_ptr, 100, 100, 200, 100);
+    wlmtk_fake_window_commit_size(fw1_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmtk_workspace_update_occlusion(ws_ptr));
+    wlmtk_workspace_unmap_window(ws_ptr, fw1_ptr->window_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, e1_ptr->occluded);
+    wlmtk_fake_window_destroy(fw1_ptr);
+
+    wlmtk_workspace_unmap_window(ws_ptr, fw2_ptr->window_ptr);
+    wlmtk_fake_window_destroy(fw2_ptr);
+    wlmtk_workspace_destroy(ws_ptr);
+    wlr_output_layout_destroy(wlr_output_layout_ptr);
+    wl_display_destroy(display_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests placing new windows next to the existing ones. */
+void test_place_window(bs_test_t *test_ptr)
+{
+    struct wl_display *display_ptr = wl_display_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, display_ptr);
+    struct wlr_output_layout *wlr_output_layout_ptr =
+        wlr_output_layout_create(display_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_output_layout_ptr);
+    struct wlr_output output = { .width = 1024, .height = 768, .scale = 1 };
+    wlmtk_test_wlr_output_init(&output);
+    wlr_output_layout_add(wlr_output_layout_ptr, &output, 0, 0);
+    wlmtk_workspace_t *ws_ptr = wlmtk_workspace_create(
+        wlr_output_layout_ptr, "t", &_wlmtk_workspace_test_tile_style);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws_ptr);
+
+    wlmtk_fake_window_t *fw1_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fw1_ptr);
+    wlmtk_workspace_map_window(ws_ptr, fw1_ptr->window_ptr);
+    wlmtk_window_request_position_and_size(
+        fw1_ptr->window_ptr, 0, 0, 400, 300);
+    wlmtk_fake_window_commit_size(fw1_ptr);
+
+    // Smart: Right of the first window.
+    wlmtk_fake_window_t *fw2_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fw2_ptr);
+    wlmtk_workspace_map_window(ws_ptr, fw2_ptr->window_ptr);
+    wlmtk_window_request_position_and_size(
+        fw2_ptr->window_ptr, 500, 500, 200, 100);
+    wlmtk_fake_window_commit_size(fw2_ptr);
+    wlmtk_workspace_place_window(ws_ptr, fw2_ptr->window_ptr, 10, 10);
+    struct wlr_box box = wlmtk_window_get_position_and_size(
+        fw2_ptr->window_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 400, box.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, box.y);
+
+    // Under the pointer: Centered.
+    wlmtk_workspace_set_placement_policy(
+        ws_ptr, WLMTK_PLACEMENT_UNDER_POINTER);
+    wlmtk_workspace_place_window(ws_ptr, fw2_ptr->window_ptr, 600, 400);
+    box = wlmtk_window_get_position_and_size(fw2_ptr->window_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 500, box.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 350, box.y);
+
+    wlmtk_workspace_unmap_window(ws_ptr, fw2_ptr->window_ptr);
+    wlmtk_fake_window_destroy(fw2_ptr);
+    wlmtk_workspace_unmap_window(ws_ptr, fw1_ptr->window_ptr);
+    wlmtk_fake_window_destroy(fw1_ptr);
+    wlmtk_workspace_destroy(ws_ptr);
+    wlr_output_layout_destroy(wlr_output_layout_ptr);
+    wl_display_destroy(display_ptr);
+}
+
 /* == End of workspace.c =================================================== */
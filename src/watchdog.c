@@ -0,0 +1,415 @@
+/* ========================================================================= */
+/**
+ * @file watchdog.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "watchdog.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <libbase/libbase.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "backtrace.h"
+
+/* == Declarations ========================================================= */
+
+/** State of the event loop watchdog. */
+struct _wlmaker_watchdog_t {
+    /** Threshold for considering the loop as stalled, in milliseconds. */
+    uint32_t                  threshold_msec;
+    /** The thread running the event loop. Is backtraced on stalls. */
+    pthread_t                 loop_thread;
+    /** File descriptor of the event loop. Polled by the helper thread. */
+    int                       loop_fd;
+
+    /** Written by the helper thread, to ping the event loop. */
+    int                       ping_fd;
+    /** Event source for `ping_fd`, dispatched on the event loop. */
+    struct wl_event_source    *ping_event_source_ptr;
+    /** Written by the event loop when it dispatched the ping. */
+    int                       pong_fd;
+    /** Written for stopping the helper thread. */
+    int                       quit_fd;
+
+    /** The helper thread. */
+    pthread_t                 thread;
+    /** Whether `thread` was started. */
+    bool                      thread_started;
+
+    /** Number of pings sent. */
+    _Atomic uint64_t          pings;
+    /** Number of stalls detected. */
+    _Atomic uint64_t          stalls;
+    /** Sum of the ping-to-pong durations, in nanoseconds. */
+    _Atomic uint64_t          latency_nsec_sum;
+    /** Longest ping-to-pong duration, in nanoseconds. */
+    _Atomic uint64_t          latency_nsec_max;
+    /** Stalls that were not reported, due to the rate limit. */
+    uint64_t                  suppressed_stalls;
+    /** When the last stall was reported, on CLOCK_MONOTONIC. */
+    uint64_t                  last_report_nsec;
+};
+
+static void *_wlmaker_watchdog_thread(void *arg_ptr);
+static int _wlmaker_watchdog_wait(
+    wlmaker_watchdog_t *watchdog_ptr,
+    int fd,
+    int timeout_msec);
+static void _wlmaker_watchdog_report_stall(wlmaker_watchdog_t *watchdog_ptr);
+static int _wlmaker_watchdog_handle_ping(
+    int fd,
+    uint32_t mask,
+    void *data_ptr);
+static uint64_t _wlmaker_watchdog_now_nsec(void);
+
+/* == Data ================================================================= */
+
+/** Minimum interval between two reported stalls, in milliseconds. */
+static const uint64_t _wlmaker_watchdog_report_interval_msec = 10000;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmaker_watchdog_t *wlmaker_watchdog_create(
+    struct wl_event_loop *wl_event_loop_ptr,
+    uint32_t threshold_msec)
+{
+    wlmaker_watchdog_t *watchdog_ptr = logged_calloc(
+        1, sizeof(wlmaker_watchdog_t));
+    if (NULL == watchdog_ptr) return NULL;
+    watchdog_ptr->threshold_msec = BS_MAX(1u, threshold_msec);
+    watchdog_ptr->loop_thread = pthread_self();
+    watchdog_ptr->loop_fd = wl_event_loop_get_fd(wl_event_loop_ptr);
+    watchdog_ptr->ping_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    watchdog_ptr->pong_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    watchdog_ptr->quit_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (0 > watchdog_ptr->ping_fd ||
+        0 > watchdog_ptr->pong_fd ||
+        0 > watchdog_ptr->quit_fd) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed eventfd(0, %d)",
+               EFD_CLOEXEC | EFD_NONBLOCK);
+        wlmaker_watchdog_destroy(watchdog_ptr);
+        return NULL;
+    }
+
+    watchdog_ptr->ping_event_source_ptr = wl_event_loop_add_fd(
+        wl_event_loop_ptr,
+        watchdog_ptr->ping_fd,
+        WL_EVENT_READABLE,
+        _wlmaker_watchdog_handle_ping,
+        watchdog_ptr);
+    if (NULL == watchdog_ptr->ping_event_source_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_fd(%p, %d, ...)",
+               wl_event_loop_ptr, watchdog_ptr->ping_fd);
+        wlmaker_watchdog_destroy(watchdog_ptr);
+        return NULL;
+    }
+
+    int rv = pthread_create(
+        &watchdog_ptr->thread, NULL, _wlmaker_watchdog_thread, watchdog_ptr);
+    if (0 != rv) {
+        errno = rv;
+        bs_log(BS_ERROR | BS_ERRNO, "Failed pthread_create()");
+        wlmaker_watchdog_destroy(watchdog_ptr);
+        return NULL;
+    }
+    watchdog_ptr->thread_started = true;
+    return watchdog_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_watchdog_destroy(wlmaker_watchdog_t *watchdog_ptr)
+{
+    if (watchdog_ptr->thread_started) {
+        uint64_t value = 1;
+        if (sizeof(value) != write(
+                watchdog_ptr->quit_fd, &value, sizeof(value))) {
+            bs_log(BS_WARNING | BS_ERRNO, "Failed write(%d, ...)",
+                   watchdog_ptr->quit_fd);
+        }
+        pthread_join(watchdog_ptr->thread, NULL);
+        watchdog_ptr->thread_started = false;
+    }
+
+    if (NULL != watchdog_ptr->ping_event_source_ptr) {
+        wl_event_source_remove(watchdog_ptr->ping_event_source_ptr);
+        watchdog_ptr->ping_event_source_ptr = NULL;
+    }
+    int *fd_ptrs[] = {
+        &watchdog_ptr->ping_fd, &watchdog_ptr->pong_fd, &watchdog_ptr->quit_fd
+    };
+    for (size_t i = 0; i < sizeof(fd_ptrs) / sizeof(fd_ptrs[0]); ++i) {
+        if (0 <= *fd_ptrs[i]) {
+            close(*fd_ptrs[i]);
+            *fd_ptrs[i] = -1;
+        }
+    }
+    free(watchdog_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_watchdog_get_stats(
+    wlmaker_watchdog_t *watchdog_ptr,
+    wlmaker_watchdog_stats_t *stats_ptr)
+{
+    stats_ptr->pings = atomic_load(&watchdog_ptr->pings);
+    stats_ptr->stalls = atomic_load(&watchdog_ptr->stalls);
+    stats_ptr->latency_nsec_sum = atomic_load(
+        &watchdog_ptr->latency_nsec_sum);
+    stats_ptr->latency_nsec_max = atomic_load(
+        &watchdog_ptr->latency_nsec_max);
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * The helper thread. Waits for the event loop to have events pending, then
+ * pings it and waits for the pong. Reports a stall if the pong does not
+ * arrive within the threshold.
+ *
+ * @param arg_ptr             Points to the @ref wlmaker_watchdog_t.
+ *
+ * @return NULL.
+ */
+void *_wlmaker_watchdog_thread(void *arg_ptr)
+{
+    wlmaker_watchdog_t *watchdog_ptr = arg_ptr;
+    int threshold_msec = watchdog_ptr->threshold_msec;
+    uint64_t value = 1;
+
+    for (;;) {
+        // Blocks until the loop has events, ie. while it is idle.
+        if (0 >= _wlmaker_watchdog_wait(
+                watchdog_ptr, watchdog_ptr->loop_fd, -1)) break;
+
+        uint64_t ping_nsec = _wlmaker_watchdog_now_nsec();
+        if (sizeof(value) != write(
+                watchdog_ptr->ping_fd, &value, sizeof(value))) {
+            bs_log(BS_WARNING | BS_ERRNO, "Failed write(%d, ...)",
+                   watchdog_ptr->ping_fd);
+            break;
+        }
+        atomic_fetch_add(&watchdog_ptr->pings, 1);
+
+        int rv = _wlmaker_watchdog_wait(
+            watchdog_ptr, watchdog_ptr->pong_fd, threshold_msec);
+        if (0 > rv) break;
+        if (0 == rv) {
+            atomic_fetch_add(&watchdog_ptr->stalls, 1);
+            _wlmaker_watchdog_report_stall(watchdog_ptr);
+            if (0 >= _wlmaker_watchdog_wait(
+                    watchdog_ptr, watchdog_ptr->pong_fd, -1)) break;
+            bs_log(BS_WARNING, "Event loop stalled for %"PRIu64" ms.",
+                   (_wlmaker_watchdog_now_nsec() - ping_nsec) / 1000000);
+        }
+        if (sizeof(value) != read(
+                watchdog_ptr->pong_fd, &value, sizeof(value))) {
+            bs_log(BS_WARNING | BS_ERRNO, "Failed read(%d, ...)",
+                   watchdog_ptr->pong_fd);
+        }
+        uint64_t latency_nsec = _wlmaker_watchdog_now_nsec() - ping_nsec;
+        atomic_fetch_add(&watchdog_ptr->latency_nsec_sum, latency_nsec);
+        if (latency_nsec > atomic_load(&watchdog_ptr->latency_nsec_max)) {
+            // Only this thread writes the maximum.
+            atomic_store(&watchdog_ptr->latency_nsec_max, latency_nsec);
+        }
+
+        // At most one ping per threshold: A busy loop stays busy in between.
+        if (0 != _wlmaker_watchdog_wait(
+                watchdog_ptr, watchdog_ptr->quit_fd, threshold_msec)) break;
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Waits for `fd` to become readable, or for the watchdog to stop.
+ *
+ * @param watchdog_ptr
+ * @param fd
+ * @param timeout_msec        Timeout, or -1 to wait indefinitely.
+ *
+ * @return 1 if `fd` is readable, 0 on timeout, and -1 if the watchdog is
+ *     stopping, or on error. For `fd` being the quit FD, returns 1 if the
+ *     watchdog is stopping.
+ */
+int _wlmaker_watchdog_wait(
+    wlmaker_watchdog_t *watchdog_ptr,
+    int fd,
+    int timeout_msec)
+{
+    struct pollfd pollfds[2] = {
+        { .fd = fd, .events = POLLIN },
+        { .fd = watchdog_ptr->quit_fd, .events = POLLIN }
+    };
+    for (;;) {
+        int rv = poll(pollfds, 2, timeout_msec);
+        if (0 > rv && EINTR == errno) continue;
+        if (0 > rv) {
+            bs_log(BS_WARNING | BS_ERRNO, "Failed poll(%p, 2, %d)",
+                   pollfds, timeout_msec);
+            return -1;
+        }
+        if (0 == rv) return 0;
+        if (fd != watchdog_ptr->quit_fd && (pollfds[1].revents & POLLIN)) {
+            return -1;
+        }
+        return 1;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Logs a stall and a backtrace of the loop's thread. Rate-limited. */
+void _wlmaker_watchdog_report_stall(wlmaker_watchdog_t *watchdog_ptr)
+{
+    uint64_t now_nsec = _wlmaker_watchdog_now_nsec();
+    if (0 != watchdog_ptr->last_report_nsec &&
+        now_nsec - watchdog_ptr->last_report_nsec <
+        _wlmaker_watchdog_report_interval_msec * 1000000) {
+        watchdog_ptr->suppressed_stalls++;
+        return;
+    }
+    watchdog_ptr->last_report_nsec = now_nsec;
+
+    bs_log(BS_WARNING, "Event loop did not dispatch for %"PRIu32" ms. "
+           "%"PRIu64" stalls not reported since last report. Backtrace:",
+           watchdog_ptr->threshold_msec, watchdog_ptr->suppressed_stalls);
+    watchdog_ptr->suppressed_stalls = 0;
+    wlmaker_backtrace_log_thread(watchdog_ptr->loop_thread, BS_WARNING);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles the ping on the event loop: Answers with a pong. */
+int _wlmaker_watchdog_handle_ping(
+    int fd,
+    __UNUSED__ uint32_t mask,
+    void *data_ptr)
+{
+    wlmaker_watchdog_t *watchdog_ptr = data_ptr;
+    uint64_t value;
+    if (sizeof(value) != read(fd, &value, sizeof(value))) return 0;
+    value = 1;
+    if (sizeof(value) != write(
+            watchdog_ptr->pong_fd, &value, sizeof(value))) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed write(%d, ...)",
+               watchdog_ptr->pong_fd);
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return The current time of CLOCK_MONOTONIC, in nanoseconds. */
+uint64_t _wlmaker_watchdog_now_nsec(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + now.tv_nsec;
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlmaker_watchdog_test_idle(bs_test_t *test_ptr);
+static void _wlmaker_watchdog_test_stall(bs_test_t *test_ptr);
+static int _wlmaker_watchdog_test_handle_fd(
+    int fd,
+    uint32_t mask,
+    void *data_ptr);
+
+const bs_test_case_t wlmaker_watchdog_test_cases[] = {
+    { 1, "idle", _wlmaker_watchdog_test_idle },
+    { 1, "stall", _wlmaker_watchdog_test_stall },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** An idle loop does not get pinged. */
+void _wlmaker_watchdog_test_idle(bs_test_t *test_ptr)
+{
+    struct wl_event_loop *loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, loop_ptr);
+    wlmaker_watchdog_t *w_ptr = wlmaker_watchdog_create(loop_ptr, 10);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, w_ptr);
+
+    wl_event_loop_dispatch(loop_ptr, 50);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, atomic_load(&w_ptr->pings));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, atomic_load(&w_ptr->stalls));
+
+    wlmaker_watchdog_destroy(w_ptr);
+    wl_event_loop_destroy(loop_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Pending events not dispatched within the threshold are a stall. */
+void _wlmaker_watchdog_test_stall(bs_test_t *test_ptr)
+{
+    struct wl_event_loop *loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, loop_ptr);
+    wlmaker_watchdog_t *w_ptr = wlmaker_watchdog_create(loop_ptr, 10);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, w_ptr);
+
+    // A readable FD has the loop pending. Then, hold off dispatching.
+    int fd = eventfd(1, EFD_CLOEXEC | EFD_NONBLOCK);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, 0 <= fd);
+    struct wl_event_source *src_ptr = wl_event_loop_add_fd(
+        loop_ptr, fd, WL_EVENT_READABLE, _wlmaker_watchdog_test_handle_fd,
+        NULL);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, src_ptr);
+    struct timespec ts = { .tv_nsec = 100 * 1000000 };
+    nanosleep(&ts, NULL);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, atomic_load(&w_ptr->pings));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, atomic_load(&w_ptr->stalls));
+
+    // Dispatches the ping, which ends the stall.
+    wl_event_loop_dispatch(loop_ptr, 0);
+    nanosleep(&ts, NULL);
+    wlmaker_watchdog_stats_t stats;
+    wlmaker_watchdog_get_stats(w_ptr, &stats);
+    BS_TEST_VERIFY_TRUE(test_ptr, stats.latency_nsec_max >= 50000000);
+    BS_TEST_VERIFY_EQ(test_ptr, stats.latency_nsec_max,
+                      stats.latency_nsec_sum);
+
+    if (NULL != src_ptr) wl_event_source_remove(src_ptr);
+    close(fd);
+    wlmaker_watchdog_destroy(w_ptr);
+    wl_event_loop_destroy(loop_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Test handler: Drains the eventfd. */
+int _wlmaker_watchdog_test_handle_fd(
+    int fd,
+    __UNUSED__ uint32_t mask,
+    __UNUSED__ void *data_ptr)
+{
+    uint64_t value;
+    if (sizeof(value) != read(fd, &value, sizeof(value))) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed read(%d, ...)", fd);
+    }
+    return 0;
+}
+
+/* == End of watchdog.c ==================================================== */
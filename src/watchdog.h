@@ -0,0 +1,95 @@
+/* ========================================================================= */
+/**
+ * @file watchdog.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WATCHDOG_H__
+#define __WATCHDOG_H__
+
+#include <libbase/libbase.h>
+#include <stdint.h>
+#include <wayland-server-core.h>
+
+/** Forward declaration: Watchdog of the event loop. */
+typedef struct _wlmaker_watchdog_t wlmaker_watchdog_t;
+
+/** Counters of the watchdog. Cumulative. */
+typedef struct {
+    /** Number of pings sent to the event loop. */
+    uint64_t                  pings;
+    /** Number of stalls detected, including those not reported. */
+    uint64_t                  stalls;
+    /** Sum of the durations until the loop dispatched a ping, in nsec. */
+    uint64_t                  latency_nsec_sum;
+    /** Longest duration until the loop dispatched a ping, in nsec. */
+    uint64_t                  latency_nsec_max;
+} wlmaker_watchdog_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Creates a watchdog for the event loop, running on a helper thread.
+ *
+ * Whenever the event loop has events pending, the helper thread pings it
+ * through an event source of its own, and waits for the loop to dispatch
+ * it. If that takes longer than `threshold_msec`, the loop is considered
+ * stalled: The watchdog logs a warning and a backtrace of the thread that
+ * created the watchdog, ie. the thread that runs the loop. Once the loop
+ * dispatches the ping, the duration of the stall is logged.
+ *
+ * Pings are sent at most once per `threshold_msec`, and only while the loop
+ * has events pending. An idle loop does not wake the helper thread. Stall
+ * reports are rate-limited.
+ *
+ * @param wl_event_loop_ptr
+ * @param threshold_msec
+ *
+ * @return Pointer to the watchdog, or NULL on error. Must be destroyed by
+ *     @ref wlmaker_watchdog_destroy, from the same thread.
+ */
+wlmaker_watchdog_t *wlmaker_watchdog_create(
+    struct wl_event_loop *wl_event_loop_ptr,
+    uint32_t threshold_msec);
+
+/**
+ * Stops the helper thread and destroys the watchdog.
+ *
+ * @param watchdog_ptr
+ */
+void wlmaker_watchdog_destroy(wlmaker_watchdog_t *watchdog_ptr);
+
+/**
+ * Retrieves the counters of the watchdog. Safe to call from the loop.
+ *
+ * @param watchdog_ptr
+ * @param stats_ptr
+ */
+void wlmaker_watchdog_get_stats(
+    wlmaker_watchdog_t *watchdog_ptr,
+    wlmaker_watchdog_stats_t *stats_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_watchdog_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WATCHDOG_H__ */
+/* == End of watchdog.h ==================================================== */
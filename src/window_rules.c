@@ -0,0 +1,1068 @@
+/* ========================================================================= */
+/**
+ * @file window_rules.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "window_rules.h"
+
+#include <inttypes.h>
+#include <libbase/libbase.h>
+#include <libbase/plist.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+/* == Declarations ========================================================= */
+
+/** Operations of the states of @ref wlmaker_window_rules_automaton_t. */
+typedef enum {
+    /** Consumes the character in `arg`. */
+    WLMAKER_WINDOW_RULES_OP_LITERAL,
+    /** Consumes any character: `?`. */
+    WLMAKER_WINDOW_RULES_OP_ANY,
+    /** Consumes a character of the class at `arg`: `[...]`. */
+    WLMAKER_WINDOW_RULES_OP_CLASS,
+    /** Consumes any number of characters: `*`. */
+    WLMAKER_WINDOW_RULES_OP_STAR,
+    /** Final state of the pattern of rule `arg`. Consumes nothing. */
+    WLMAKER_WINDOW_RULES_OP_ACCEPT
+} wlmaker_window_rules_op_t;
+
+/** A state of the automaton. */
+typedef struct {
+    /** What the state matches. */
+    wlmaker_window_rules_op_t op;
+    /** Character, class index or rule index. See `op`. */
+    size_t                    arg;
+} wlmaker_window_rules_state_t;
+
+/** A character class, from a bracket expression. A bit per byte value. */
+typedef struct {
+    /** The bits. */
+    uint64_t                  bits[4];
+} wlmaker_window_rules_class_t;
+
+/**
+ * Non-deterministic automaton of a set of glob patterns.
+ *
+ * The patterns are stored one after another, each terminated by an `ACCEPT`
+ * state. Matching tracks the set of active states as a bitset, and thus
+ * runs all patterns in a single pass over the string.
+ */
+typedef struct {
+    /** The states of all patterns. */
+    wlmaker_window_rules_state_t *states_ptr;
+    /** Number of states. */
+    size_t                    states;
+    /** Character classes, referred to by `CLASS` states. */
+    wlmaker_window_rules_class_t *classes_ptr;
+    /** Number of classes. */
+    size_t                    classes;
+    /** Number of 64-bit words of each of the bitsets below. */
+    size_t                    words;
+    /** The start states of all patterns. Closed over skippable `*`. */
+    uint64_t                  *initial_ptr;
+    /** Scratch: Active states. */
+    uint64_t                  *current_ptr;
+    /** Scratch: States active after the next character. */
+    uint64_t                  *next_ptr;
+} wlmaker_window_rules_automaton_t;
+
+/** A rule, as decoded from the `WindowRules` array. */
+typedef struct {
+    /** Condition on the app ID. Empty if unconditional. */
+    char                      *app_id_ptr;
+    /** Condition on the title. Empty if unconditional. */
+    char                      *title_ptr;
+    /** See @ref wlmaker_window_rule_t::workspace. */
+    uint64_t                  workspace;
+    /** See @ref wlmaker_window_rule_t::decoration. */
+    wlmaker_window_rule_decoration_t decoration;
+    /** See @ref wlmaker_window_rule_t::placement. */
+    wlmaker_window_rule_placement_t placement;
+    /** See @ref wlmaker_window_rule_t::width. */
+    uint64_t                  width;
+    /** See @ref wlmaker_window_rule_t::height. */
+    uint64_t                  height;
+    /** See @ref wlmaker_window_rule_t::skip_task_list. */
+    bool                      skip_task_list;
+
+    /** Index of the rule. */
+    size_t                    index;
+    /** Element of @ref wlmaker_window_rules_t::buckets_ptr, if literal. */
+    bs_dllist_node_t          bucket_dlnode;
+} wlmaker_window_rules_entry_t;
+
+/** A cached result of @ref wlmaker_window_rules_match. */
+typedef struct {
+    /** Whether the entry holds a result. */
+    bool                      valid;
+    /** Process ID of the client. 0 if there was no client. */
+    pid_t                     pid;
+    /** App ID that was matched. */
+    char                      *app_id_ptr;
+    /** Title that was matched. */
+    char                      *title_ptr;
+    /** The result. */
+    wlmaker_window_rule_t     rule;
+} wlmaker_window_rules_cached_t;
+
+/** Number of cached results. Must be a power of 2. */
+#define WLMAKER_WINDOW_RULES_CACHE_SIZE 32
+
+/** State of the compiled window rules. */
+struct _wlmaker_window_rules_t {
+    /** The rules, in order of the configuration. */
+    wlmaker_window_rules_entry_t *entries_ptr;
+    /** Number of elements at `entries_ptr`. */
+    size_t                    entries;
+
+    /** Rules with a literal app ID, hashed by it. */
+    bs_dllist_t               *buckets_ptr;
+    /** Number of buckets. A power of 2. */
+    size_t                    buckets;
+    /** Automaton of the app ID patterns that are not literal. */
+    wlmaker_window_rules_automaton_t app_id_automaton;
+    /** Automaton of the title patterns. */
+    wlmaker_window_rules_automaton_t title_automaton;
+
+    /** Number of 64-bit words in each of the bitsets of rules below. */
+    size_t                    words;
+    /** Rules without `AppId`. */
+    uint64_t                  *any_app_id_ptr;
+    /** Rules without `Title`. */
+    uint64_t                  *any_title_ptr;
+    /** Scratch: Rules whose `AppId` matched. */
+    uint64_t                  *app_id_matches_ptr;
+    /** Scratch: Rules whose `Title` matched. */
+    uint64_t                  *title_matches_ptr;
+
+    /** Cached results, by hash of client, app ID and title. */
+    wlmaker_window_rules_cached_t cache[WLMAKER_WINDOW_RULES_CACHE_SIZE];
+    /** Number of evaluations. */
+    uint64_t                  lookups;
+    /** Number of evaluations answered from the cache. */
+    uint64_t                  cache_hits;
+};
+
+static bool _wlmaker_window_rules_configure(
+    wlmaker_window_rules_t *rules_ptr,
+    bspl_array_t *array_ptr);
+static bool _wlmaker_window_rules_compile(wlmaker_window_rules_t *rules_ptr);
+static bool _wlmaker_window_rules_is_literal(const char *pattern_ptr);
+static uint64_t _wlmaker_window_rules_hash(const char *str_ptr);
+static void _wlmaker_window_rules_evaluate(
+    wlmaker_window_rules_t *rules_ptr,
+    const char *app_id_ptr,
+    const char *title_ptr,
+    wlmaker_window_rule_t *rule_ptr);
+static void _wlmaker_window_rules_cache_clear(
+    wlmaker_window_rules_t *rules_ptr);
+
+static bool _wlmaker_window_rules_automaton_init(
+    wlmaker_window_rules_automaton_t *automaton_ptr,
+    size_t max_states,
+    size_t max_classes);
+static void _wlmaker_window_rules_automaton_fini(
+    wlmaker_window_rules_automaton_t *automaton_ptr);
+static void _wlmaker_window_rules_automaton_add(
+    wlmaker_window_rules_automaton_t *automaton_ptr,
+    const char *pattern_ptr,
+    size_t rule_index);
+static void _wlmaker_window_rules_automaton_finalize(
+    wlmaker_window_rules_automaton_t *automaton_ptr);
+static void _wlmaker_window_rules_automaton_match(
+    wlmaker_window_rules_automaton_t *automaton_ptr,
+    const char *str_ptr,
+    uint64_t *matches_ptr);
+static void _wlmaker_window_rules_automaton_enter(
+    const wlmaker_window_rules_automaton_t *automaton_ptr,
+    uint64_t *set_ptr,
+    size_t state);
+static const char *_wlmaker_window_rules_parse_class(
+    const char *pattern_ptr,
+    wlmaker_window_rules_class_t *class_ptr);
+
+/* == Data ================================================================= */
+
+/** Plist descriptor of @ref wlmaker_window_rule_decoration_t. */
+static const bspl_enum_desc_t _wlmaker_window_rules_decoration_desc[] = {
+    BSPL_ENUM("Default", WLMAKER_WINDOW_RULE_DECORATION_DEFAULT),
+    BSPL_ENUM("Server", WLMAKER_WINDOW_RULE_DECORATION_SERVER),
+    BSPL_ENUM("None", WLMAKER_WINDOW_RULE_DECORATION_NONE),
+    BSPL_ENUM_SENTINEL()
+};
+
+/** Plist descriptor of @ref wlmaker_window_rule_placement_t. */
+static const bspl_enum_desc_t _wlmaker_window_rules_placement_desc[] = {
+    BSPL_ENUM("Default", WLMAKER_WINDOW_RULE_PLACEMENT_DEFAULT),
+    BSPL_ENUM("Smart", WLMAKER_WINDOW_RULE_PLACEMENT_SMART),
+    BSPL_ENUM("Cascade", WLMAKER_WINDOW_RULE_PLACEMENT_CASCADE),
+    BSPL_ENUM("UnderPointer", WLMAKER_WINDOW_RULE_PLACEMENT_UNDER_POINTER),
+    BSPL_ENUM_SENTINEL()
+};
+
+/** Descriptor of a rule, in the `WindowRules` array. */
+static const bspl_desc_t _wlmaker_window_rules_entry_desc[] = {
+    BSPL_DESC_STRING(
+        "AppId", false, wlmaker_window_rules_entry_t,
+        app_id_ptr, app_id_ptr, ""),
+    BSPL_DESC_STRING(
+        "Title", false, wlmaker_window_rules_entry_t,
+        title_ptr, title_ptr, ""),
+    BSPL_DESC_UINT64(
+        "Workspace", false, wlmaker_window_rules_entry_t,
+        workspace, workspace, 0),
+    BSPL_DESC_ENUM(
+        "Decoration", false, wlmaker_window_rules_entry_t,
+        decoration, decoration, WLMAKER_WINDOW_RULE_DECORATION_DEFAULT,
+        _wlmaker_window_rules_decoration_desc),
+    BSPL_DESC_ENUM(
+        "Placement", false, wlmaker_window_rules_entry_t,
+        placement, placement, WLMAKER_WINDOW_RULE_PLACEMENT_DEFAULT,
+        _wlmaker_window_rules_placement_desc),
+    BSPL_DESC_UINT64(
+        "Width", false, wlmaker_window_rules_entry_t, width, width, 0),
+    BSPL_DESC_UINT64(
+        "Height", false, wlmaker_window_rules_entry_t, height, height, 0),
+    BSPL_DESC_BOOL(
+        "SkipTaskList", false, wlmaker_window_rules_entry_t,
+        skip_task_list, skip_task_list, false),
+    BSPL_DESC_SENTINEL(),
+};
+
+/** Placement policies of @ref wlmaker_window_rule_placement_t. */
+static const wlmtk_placement_policy_t _wlmaker_window_rules_policies[] = {
+    [WLMAKER_WINDOW_RULE_PLACEMENT_SMART] = WLMTK_PLACEMENT_SMART,
+    [WLMAKER_WINDOW_RULE_PLACEMENT_CASCADE] = WLMTK_PLACEMENT_CASCADE,
+    [WLMAKER_WINDOW_RULE_PLACEMENT_UNDER_POINTER] =
+    WLMTK_PLACEMENT_UNDER_POINTER,
+};
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmaker_window_rules_t *wlmaker_window_rules_create(bspl_array_t *array_ptr)
+{
+    wlmaker_window_rules_t *rules_ptr = logged_calloc(
+        1, sizeof(wlmaker_window_rules_t));
+    if (NULL == rules_ptr) return NULL;
+
+    if (!_wlmaker_window_rules_configure(rules_ptr, array_ptr) ||
+        !_wlmaker_window_rules_compile(rules_ptr)) {
+        wlmaker_window_rules_destroy(rules_ptr);
+        return NULL;
+    }
+    return rules_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_window_rules_destroy(wlmaker_window_rules_t *rules_ptr)
+{
+    _wlmaker_window_rules_cache_clear(rules_ptr);
+
+    if (NULL != rules_ptr->any_app_id_ptr) {
+        free(rules_ptr->any_app_id_ptr);
+        rules_ptr->any_app_id_ptr = NULL;
+    }
+    _wlmaker_window_rules_automaton_fini(&rules_ptr->title_automaton);
+    _wlmaker_window_rules_automaton_fini(&rules_ptr->app_id_automaton);
+    if (NULL != rules_ptr->buckets_ptr) {
+        free(rules_ptr->buckets_ptr);
+        rules_ptr->buckets_ptr = NULL;
+    }
+
+    for (size_t i = 0; i < rules_ptr->entries; ++i) {
+        bspl_decoded_destroy(_wlmaker_window_rules_entry_desc,
+                             &rules_ptr->entries_ptr[i]);
+    }
+    rules_ptr->entries = 0;
+    if (NULL != rules_ptr->entries_ptr) {
+        free(rules_ptr->entries_ptr);
+        rules_ptr->entries_ptr = NULL;
+    }
+    free(rules_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_window_rules_match(
+    wlmaker_window_rules_t *rules_ptr,
+    const wlmtk_util_client_t *client_ptr,
+    const char *app_id_ptr,
+    const char *title_ptr,
+    wlmaker_window_rule_t *rule_ptr)
+{
+    if (NULL == app_id_ptr) app_id_ptr = "";
+    if (NULL == title_ptr) title_ptr = "";
+    pid_t pid = (NULL != client_ptr) ? client_ptr->pid : 0;
+    ++rules_ptr->lookups;
+
+    uint64_t hash = _wlmaker_window_rules_hash(app_id_ptr) ^
+        (_wlmaker_window_rules_hash(title_ptr) * 31) ^
+        ((uint64_t)pid * UINT64_C(0x9e3779b97f4a7c15));
+    wlmaker_window_rules_cached_t *cached_ptr = &rules_ptr->cache[
+        (hash ^ (hash >> 32)) & (WLMAKER_WINDOW_RULES_CACHE_SIZE - 1)];
+    if (cached_ptr->valid &&
+        cached_ptr->pid == pid &&
+        0 == strcmp(cached_ptr->app_id_ptr, app_id_ptr) &&
+        0 == strcmp(cached_ptr->title_ptr, title_ptr)) {
+        ++rules_ptr->cache_hits;
+        *rule_ptr = cached_ptr->rule;
+        return;
+    }
+
+    _wlmaker_window_rules_evaluate(rules_ptr, app_id_ptr, title_ptr, rule_ptr);
+
+    // Replaces what was cached in that slot. Not caching is no error.
+    char *cached_app_id_ptr = logged_strdup(app_id_ptr);
+    char *cached_title_ptr = logged_strdup(title_ptr);
+    if (NULL == cached_app_id_ptr || NULL == cached_title_ptr) {
+        if (NULL != cached_app_id_ptr) free(cached_app_id_ptr);
+        if (NULL != cached_title_ptr) free(cached_title_ptr);
+        return;
+    }
+    if (cached_ptr->valid) {
+        free(cached_ptr->app_id_ptr);
+        free(cached_ptr->title_ptr);
+    }
+    cached_ptr->valid = true;
+    cached_ptr->pid = pid;
+    cached_ptr->app_id_ptr = cached_app_id_ptr;
+    cached_ptr->title_ptr = cached_title_ptr;
+    cached_ptr->rule = *rule_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_window_rules_map_window(
+    wlmaker_window_rules_t *rules_ptr,
+    wlmtk_root_t *root_ptr,
+    wlmtk_window_t *window_ptr,
+    const char *app_id_ptr,
+    int pointer_x,
+    int pointer_y)
+{
+    wlmaker_window_rule_t rule = {};
+    if (NULL != rules_ptr) {
+        wlmaker_window_rules_match(
+            rules_ptr,
+            wlmtk_window_get_client_ptr(window_ptr),
+            app_id_ptr,
+            wlmtk_window_get_title(window_ptr),
+            &rule);
+    }
+
+    wlmtk_workspace_t *workspace_ptr = NULL;
+    if (0 < rule.workspace) {
+        workspace_ptr = wlmtk_root_get_workspace(
+            root_ptr, rule.workspace - 1);
+        if (NULL == workspace_ptr) {
+            bs_log(BS_WARNING, "Window rule for \"%s\": No workspace %"PRIu64
+                   ", using the current.",
+                   NULL != app_id_ptr ? app_id_ptr : "", rule.workspace);
+        }
+    }
+    if (NULL == workspace_ptr) {
+        workspace_ptr = wlmtk_root_get_current_workspace(root_ptr);
+    }
+
+    switch (rule.decoration) {
+    case WLMAKER_WINDOW_RULE_DECORATION_SERVER:
+        wlmtk_window_set_server_side_decorated(window_ptr, true);
+        break;
+    case WLMAKER_WINDOW_RULE_DECORATION_NONE:
+        wlmtk_window_set_server_side_decorated(window_ptr, false);
+        break;
+    default:
+        break;
+    }
+    if (rule.skip_task_list) {
+        wlmtk_window_set_properties(
+            window_ptr,
+            wlmtk_window_get_properties(window_ptr) |
+            WLMTK_WINDOW_PROPERTY_SKIP_TASK_LIST);
+    }
+
+    wlmtk_workspace_map_window(workspace_ptr, window_ptr);
+    if (WLMAKER_WINDOW_RULE_PLACEMENT_DEFAULT == rule.placement) {
+        wlmtk_workspace_place_window(
+            workspace_ptr, window_ptr, pointer_x, pointer_y);
+    } else {
+        wlmtk_workspace_place_window_with_policy(
+            workspace_ptr, window_ptr,
+            _wlmaker_window_rules_policies[rule.placement],
+            pointer_x, pointer_y);
+    }
+
+    if (0 < rule.width || 0 < rule.height) {
+        struct wlr_box box = wlmtk_window_get_position_and_size(window_ptr);
+        wlmtk_window_request_position_and_size(
+            window_ptr, box.x, box.y,
+            0 < rule.width ? (int)rule.width : box.width,
+            0 < rule.height ? (int)rule.height : box.height);
+    }
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Decodes the rules.
+ *
+ * @param rules_ptr
+ * @param array_ptr           May be NULL.
+ *
+ * @return true on success.
+ */
+bool _wlmaker_window_rules_configure(
+    wlmaker_window_rules_t *rules_ptr,
+    bspl_array_t *array_ptr)
+{
+    size_t entries = (NULL != array_ptr) ? bspl_array_size(array_ptr) : 0;
+    if (0 == entries) return true;
+    rules_ptr->entries_ptr = logged_calloc(
+        entries, sizeof(wlmaker_window_rules_entry_t));
+    if (NULL == rules_ptr->entries_ptr) return false;
+    for (size_t i = 0; i < entries; ++i) {
+        // Counted before decoding: A partially decoded entry gets released.
+        wlmaker_window_rules_entry_t *entry_ptr = &rules_ptr->entries_ptr[i];
+        rules_ptr->entries = i + 1;
+        entry_ptr->index = i;
+        bspl_dict_t *dict_ptr = bspl_dict_from_object(
+            bspl_array_at(array_ptr, i));
+        if (NULL == dict_ptr ||
+            !bspl_decode_dict(
+                dict_ptr, _wlmaker_window_rules_entry_desc, entry_ptr)) {
+            bs_log(BS_ERROR, "Failed to decode element %zu of "
+                   "'WindowRules'.", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Compiles the decoded rules: Hashes the literal app IDs, and builds the
+ * automata of all other patterns.
+ *
+ * @param rules_ptr
+ *
+ * @return true on success.
+ */
+bool _wlmaker_window_rules_compile(wlmaker_window_rules_t *rules_ptr)
+{
+    rules_ptr->words = BS_MAX((size_t)1, (rules_ptr->entries + 63) / 64);
+    rules_ptr->any_app_id_ptr = logged_calloc(
+        4 * rules_ptr->words, sizeof(uint64_t));
+    if (NULL == rules_ptr->any_app_id_ptr) return false;
+    rules_ptr->any_title_ptr = rules_ptr->any_app_id_ptr + rules_ptr->words;
+    rules_ptr->app_id_matches_ptr =
+        rules_ptr->any_title_ptr + rules_ptr->words;
+    rules_ptr->title_matches_ptr =
+        rules_ptr->app_id_matches_ptr + rules_ptr->words;
+
+    // At least twice the buckets as there are rules, for short chains.
+    rules_ptr->buckets = 16;
+    while (rules_ptr->buckets < 2 * rules_ptr->entries) {
+        rules_ptr->buckets *= 2;
+    }
+    rules_ptr->buckets_ptr = logged_calloc(
+        rules_ptr->buckets, sizeof(bs_dllist_t));
+    if (NULL == rules_ptr->buckets_ptr) return false;
+
+    // A pattern needs at most a state per character, plus the accept state.
+    size_t app_id_states = 0, app_id_classes = 0;
+    size_t title_states = 0, title_classes = 0;
+    for (size_t i = 0; i < rules_ptr->entries; ++i) {
+        wlmaker_window_rules_entry_t *entry_ptr = &rules_ptr->entries_ptr[i];
+        if (!_wlmaker_window_rules_is_literal(entry_ptr->app_id_ptr)) {
+            app_id_states += strlen(entry_ptr->app_id_ptr) + 1;
+            for (const char *c_ptr = entry_ptr->app_id_ptr; *c_ptr; ++c_ptr) {
+                if ('[' == *c_ptr) ++app_id_classes;
+            }
+        }
+        if (0 != *entry_ptr->title_ptr) {
+            title_states += strlen(entry_ptr->title_ptr) + 1;
+            for (const char *c_ptr = entry_ptr->title_ptr; *c_ptr; ++c_ptr) {
+                if ('[' == *c_ptr) ++title_classes;
+            }
+        }
+    }
+    if (!_wlmaker_window_rules_automaton_init(
+            &rules_ptr->app_id_automaton, app_id_states, app_id_classes) ||
+        !_wlmaker_window_rules_automaton_init(
+            &rules_ptr->title_automaton, title_states, title_classes)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < rules_ptr->entries; ++i) {
+        wlmaker_window_rules_entry_t *entry_ptr = &rules_ptr->entries_ptr[i];
+        if (0 == *entry_ptr->app_id_ptr) {
+            rules_ptr->any_app_id_ptr[i / 64] |= UINT64_C(1) << (i % 64);
+        } else if (_wlmaker_window_rules_is_literal(entry_ptr->app_id_ptr)) {
+            bs_dllist_push_back(
+                &rules_ptr->buckets_ptr[
+                    _wlmaker_window_rules_hash(entry_ptr->app_id_ptr) &
+                    (rules_ptr->buckets - 1)],
+                &entry_ptr->bucket_dlnode);
+        } else {
+            _wlmaker_window_rules_automaton_add(
+                &rules_ptr->app_id_automaton, entry_ptr->app_id_ptr, i);
+        }
+
+        if (0 == *entry_ptr->title_ptr) {
+            rules_ptr->any_title_ptr[i / 64] |= UINT64_C(1) << (i % 64);
+        } else {
+            _wlmaker_window_rules_automaton_add(
+                &rules_ptr->title_automaton, entry_ptr->title_ptr, i);
+        }
+    }
+    _wlmaker_window_rules_automaton_finalize(&rules_ptr->app_id_automaton);
+    _wlmaker_window_rules_automaton_finalize(&rules_ptr->title_automaton);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Whether `pattern_ptr` is a non-empty pattern without wildcards. */
+bool _wlmaker_window_rules_is_literal(const char *pattern_ptr)
+{
+    if (0 == *pattern_ptr) return false;
+    return NULL == strpbrk(pattern_ptr, "*?[\\");
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return FNV-1a hash of `str_ptr`. */
+uint64_t _wlmaker_window_rules_hash(const char *str_ptr)
+{
+    uint64_t hash = UINT64_C(14695981039346656037);
+    for (const char *c_ptr = str_ptr; *c_ptr; ++c_ptr) {
+        hash = (hash ^ (uint8_t)*c_ptr) * UINT64_C(1099511628211);
+    }
+    return hash;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Evaluates all rules, without the cache.
+ *
+ * @param rules_ptr
+ * @param app_id_ptr
+ * @param title_ptr
+ * @param rule_ptr
+ */
+void _wlmaker_window_rules_evaluate(
+    wlmaker_window_rules_t *rules_ptr,
+    const char *app_id_ptr,
+    const char *title_ptr,
+    wlmaker_window_rule_t *rule_ptr)
+{
+    *rule_ptr = (wlmaker_window_rule_t){};
+    if (0 == rules_ptr->entries) return;
+
+    size_t words = rules_ptr->words;
+    memcpy(rules_ptr->app_id_matches_ptr, rules_ptr->any_app_id_ptr,
+           words * sizeof(uint64_t));
+    memcpy(rules_ptr->title_matches_ptr, rules_ptr->any_title_ptr,
+           words * sizeof(uint64_t));
+
+    bs_dllist_t *bucket_ptr = &rules_ptr->buckets_ptr[
+        _wlmaker_window_rules_hash(app_id_ptr) & (rules_ptr->buckets - 1)];
+    for (bs_dllist_node_t *dlnode_ptr = bucket_ptr->head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_window_rules_entry_t *entry_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_window_rules_entry_t, bucket_dlnode);
+        if (0 != strcmp(entry_ptr->app_id_ptr, app_id_ptr)) continue;
+        rules_ptr->app_id_matches_ptr[entry_ptr->index / 64] |=
+            UINT64_C(1) << (entry_ptr->index % 64);
+    }
+    _wlmaker_window_rules_automaton_match(
+        &rules_ptr->app_id_automaton, app_id_ptr,
+        rules_ptr->app_id_matches_ptr);
+    _wlmaker_window_rules_automaton_match(
+        &rules_ptr->title_automaton, title_ptr,
+        rules_ptr->title_matches_ptr);
+
+    // Applies the matching rules in order. Later ones override.
+    for (size_t w = 0; w < words; ++w) {
+        uint64_t bits = (rules_ptr->app_id_matches_ptr[w] &
+                         rules_ptr->title_matches_ptr[w]);
+        while (0 != bits) {
+            wlmaker_window_rules_entry_t *entry_ptr =
+                &rules_ptr->entries_ptr[w * 64 + __builtin_ctzll(bits)];
+            bits &= bits - 1;
+
+            if (0 < entry_ptr->workspace) {
+                rule_ptr->workspace = entry_ptr->workspace;
+            }
+            if (WLMAKER_WINDOW_RULE_DECORATION_DEFAULT !=
+                entry_ptr->decoration) {
+                rule_ptr->decoration = entry_ptr->decoration;
+            }
+            if (WLMAKER_WINDOW_RULE_PLACEMENT_DEFAULT !=
+                entry_ptr->placement) {
+                rule_ptr->placement = entry_ptr->placement;
+            }
+            if (0 < entry_ptr->width) rule_ptr->width = entry_ptr->width;
+            if (0 < entry_ptr->height) rule_ptr->height = entry_ptr->height;
+            if (entry_ptr->skip_task_list) rule_ptr->skip_task_list = true;
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Releases all cached results. */
+void _wlmaker_window_rules_cache_clear(wlmaker_window_rules_t *rules_ptr)
+{
+    for (size_t i = 0; i < WLMAKER_WINDOW_RULES_CACHE_SIZE; ++i) {
+        wlmaker_window_rules_cached_t *cached_ptr = &rules_ptr->cache[i];
+        if (!cached_ptr->valid) continue;
+        free(cached_ptr->app_id_ptr);
+        free(cached_ptr->title_ptr);
+        *cached_ptr = (wlmaker_window_rules_cached_t){};
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Initializes the automaton, with space for the given numbers of states
+ * and classes.
+ *
+ * @param automaton_ptr
+ * @param max_states
+ * @param max_classes
+ *
+ * @return true on success.
+ */
+bool _wlmaker_window_rules_automaton_init(
+    wlmaker_window_rules_automaton_t *automaton_ptr,
+    size_t max_states,
+    size_t max_classes)
+{
+    if (0 < max_states) {
+        automaton_ptr->states_ptr = logged_calloc(
+            max_states, sizeof(wlmaker_window_rules_state_t));
+        if (NULL == automaton_ptr->states_ptr) return false;
+    }
+    if (0 < max_classes) {
+        automaton_ptr->classes_ptr = logged_calloc(
+            max_classes, sizeof(wlmaker_window_rules_class_t));
+        if (NULL == automaton_ptr->classes_ptr) return false;
+    }
+
+    automaton_ptr->words = BS_MAX((size_t)1, (max_states + 63) / 64);
+    automaton_ptr->initial_ptr = logged_calloc(
+        3 * automaton_ptr->words, sizeof(uint64_t));
+    if (NULL == automaton_ptr->initial_ptr) return false;
+    automaton_ptr->current_ptr =
+        automaton_ptr->initial_ptr + automaton_ptr->words;
+    automaton_ptr->next_ptr =
+        automaton_ptr->current_ptr + automaton_ptr->words;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Releases the automaton's resources. */
+void _wlmaker_window_rules_automaton_fini(
+    wlmaker_window_rules_automaton_t *automaton_ptr)
+{
+    if (NULL != automaton_ptr->initial_ptr) {
+        free(automaton_ptr->initial_ptr);
+        automaton_ptr->initial_ptr = NULL;
+    }
+    if (NULL != automaton_ptr->classes_ptr) {
+        free(automaton_ptr->classes_ptr);
+        automaton_ptr->classes_ptr = NULL;
+    }
+    if (NULL != automaton_ptr->states_ptr) {
+        free(automaton_ptr->states_ptr);
+        automaton_ptr->states_ptr = NULL;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Compiles the glob pattern into states of the automaton. Consecutive `*`
+ * are merged. A `[` without closing `]` is taken literally, as is the
+ * character following a `\`.
+ *
+ * @param automaton_ptr
+ * @param pattern_ptr
+ * @param rule_index          Index of the rule, reported on match.
+ */
+void _wlmaker_window_rules_automaton_add(
+    wlmaker_window_rules_automaton_t *automaton_ptr,
+    const char *pattern_ptr,
+    size_t rule_index)
+{
+    wlmaker_window_rules_state_t *states_ptr = automaton_ptr->states_ptr;
+    for (const char *c_ptr = pattern_ptr; *c_ptr; ++c_ptr) {
+        wlmaker_window_rules_state_t *state_ptr =
+            &states_ptr[automaton_ptr->states];
+        switch (*c_ptr) {
+        case '*':
+            if (c_ptr != pattern_ptr &&
+                WLMAKER_WINDOW_RULES_OP_STAR == state_ptr[-1].op) continue;
+            state_ptr->op = WLMAKER_WINDOW_RULES_OP_STAR;
+            break;
+        case '?':
+            state_ptr->op = WLMAKER_WINDOW_RULES_OP_ANY;
+            break;
+        case '[': {
+            const char *end_ptr = _wlmaker_window_rules_parse_class(
+                c_ptr + 1,
+                &automaton_ptr->classes_ptr[automaton_ptr->classes]);
+            if (NULL == end_ptr) {
+                state_ptr->op = WLMAKER_WINDOW_RULES_OP_LITERAL;
+                state_ptr->arg = (uint8_t)'[';
+                break;
+            }
+            state_ptr->op = WLMAKER_WINDOW_RULES_OP_CLASS;
+            state_ptr->arg = automaton_ptr->classes++;
+            c_ptr = end_ptr;
+            break;
+        }
+        case '\\':
+            if (0 != c_ptr[1]) ++c_ptr;
+            state_ptr->op = WLMAKER_WINDOW_RULES_OP_LITERAL;
+            state_ptr->arg = (uint8_t)*c_ptr;
+            break;
+        default:
+            state_ptr->op = WLMAKER_WINDOW_RULES_OP_LITERAL;
+            state_ptr->arg = (uint8_t)*c_ptr;
+            break;
+        }
+        ++automaton_ptr->states;
+    }
+
+    states_ptr[automaton_ptr->states].op = WLMAKER_WINDOW_RULES_OP_ACCEPT;
+    states_ptr[automaton_ptr->states].arg = rule_index;
+    ++automaton_ptr->states;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Computes the initial states, once all patterns are added. */
+void _wlmaker_window_rules_automaton_finalize(
+    wlmaker_window_rules_automaton_t *automaton_ptr)
+{
+    for (size_t s = 0; s < automaton_ptr->states; ++s) {
+        if (0 == s ||
+            WLMAKER_WINDOW_RULES_OP_ACCEPT ==
+            automaton_ptr->states_ptr[s - 1].op) {
+            _wlmaker_window_rules_automaton_enter(
+                automaton_ptr, automaton_ptr->initial_ptr, s);
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Runs the automaton over `str_ptr`, and flags the rules of all patterns
+ * that match the entire string.
+ *
+ * @param automaton_ptr
+ * @param str_ptr
+ * @param matches_ptr         Bitset of the rules. Bits of the rules that
+ *                            match will be set, others are left as they are.
+ */
+void _wlmaker_window_rules_automaton_match(
+    wlmaker_window_rules_automaton_t *automaton_ptr,
+    const char *str_ptr,
+    uint64_t *matches_ptr)
+{
+    if (0 == automaton_ptr->states) return;
+    size_t words = automaton_ptr->words;
+    uint64_t *current_ptr = automaton_ptr->current_ptr;
+    uint64_t *next_ptr = automaton_ptr->next_ptr;
+    memcpy(current_ptr, automaton_ptr->initial_ptr, words * sizeof(uint64_t));
+
+    for (const char *c_ptr = str_ptr; *c_ptr; ++c_ptr) {
+        uint8_t c = (uint8_t)*c_ptr;
+        bool active = false;
+        memset(next_ptr, 0, words * sizeof(uint64_t));
+        for (size_t w = 0; w < words; ++w) {
+            uint64_t bits = current_ptr[w];
+            while (0 != bits) {
+                size_t s = w * 64 + __builtin_ctzll(bits);
+                bits &= bits - 1;
+                const wlmaker_window_rules_state_t *state_ptr =
+                    &automaton_ptr->states_ptr[s];
+                const wlmaker_window_rules_class_t *class_ptr;
+                size_t next_state = s + 1;
+                switch (state_ptr->op) {
+                case WLMAKER_WINDOW_RULES_OP_LITERAL:
+                    if (c != state_ptr->arg) continue;
+                    break;
+                case WLMAKER_WINDOW_RULES_OP_CLASS:
+                    class_ptr = &automaton_ptr->classes_ptr[state_ptr->arg];
+                    if (0 == (class_ptr->bits[c / 64] &
+                              (UINT64_C(1) << (c % 64)))) continue;
+                    break;
+                case WLMAKER_WINDOW_RULES_OP_STAR:
+                    // Stays. The state past it is part of the closure.
+                    next_state = s;
+                    break;
+                case WLMAKER_WINDOW_RULES_OP_ACCEPT:
+                    continue;
+                default:
+                    break;
+                }
+                _wlmaker_window_rules_automaton_enter(
+                    automaton_ptr, next_ptr, next_state);
+                active = true;
+            }
+        }
+        if (!active) return;
+        uint64_t *swap_ptr = current_ptr;
+        current_ptr = next_ptr;
+        next_ptr = swap_ptr;
+    }
+
+    for (size_t w = 0; w < words; ++w) {
+        uint64_t bits = current_ptr[w];
+        while (0 != bits) {
+            size_t s = w * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            const wlmaker_window_rules_state_t *state_ptr =
+                &automaton_ptr->states_ptr[s];
+            if (WLMAKER_WINDOW_RULES_OP_ACCEPT != state_ptr->op) continue;
+            matches_ptr[state_ptr->arg / 64] |=
+                UINT64_C(1) << (state_ptr->arg % 64);
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Adds `state` to the set, and the states past it while it can be skipped:
+ * `*` also matches the empty string.
+ *
+ * @param automaton_ptr
+ * @param set_ptr
+ * @param state
+ */
+void _wlmaker_window_rules_automaton_enter(
+    const wlmaker_window_rules_automaton_t *automaton_ptr,
+    uint64_t *set_ptr,
+    size_t state)
+{
+    for (;;) {
+        set_ptr[state / 64] |= UINT64_C(1) << (state % 64);
+        if (WLMAKER_WINDOW_RULES_OP_STAR !=
+            automaton_ptr->states_ptr[state].op) return;
+        ++state;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Parses a bracket expression, as in `fnmatch(3)`: A leading `!` or `^`
+ * negates, a leading `]` is part of the set, and `a-z` denotes a range.
+ *
+ * @param pattern_ptr         Points to the character after the `[`.
+ * @param class_ptr           Will be set to the class.
+ *
+ * @return Pointer to the closing `]`, or NULL if there is none.
+ */
+const char *_wlmaker_window_rules_parse_class(
+    const char *pattern_ptr,
+    wlmaker_window_rules_class_t *class_ptr)
+{
+    *class_ptr = (wlmaker_window_rules_class_t){};
+    const char *c_ptr = pattern_ptr;
+    bool negate = false;
+    if ('!' == *c_ptr || '^' == *c_ptr) {
+        negate = true;
+        ++c_ptr;
+    }
+
+    const char *first_ptr = c_ptr;
+    for (; *c_ptr && (']' != *c_ptr || c_ptr == first_ptr); ++c_ptr) {
+        uint8_t from = (uint8_t)*c_ptr, to = from;
+        if ('-' == c_ptr[1] && 0 != c_ptr[2] && ']' != c_ptr[2]) {
+            to = (uint8_t)c_ptr[2];
+            c_ptr += 2;
+        }
+        for (unsigned c = from; c <= to; ++c) {
+            class_ptr->bits[c / 64] |= UINT64_C(1) << (c % 64);
+        }
+    }
+    if (0 == *c_ptr) return NULL;
+
+    if (negate) {
+        for (size_t i = 0; i < 4; ++i) {
+            class_ptr->bits[i] = ~class_ptr->bits[i];
+        }
+    }
+    return c_ptr;
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlmaker_window_rules_test_glob(bs_test_t *test_ptr);
+static void _wlmaker_window_rules_test_match(bs_test_t *test_ptr);
+static void _wlmaker_window_rules_test_cache(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_window_rules_test_cases[] = {
+    { 1, "glob", _wlmaker_window_rules_test_glob },
+    { 1, "match", _wlmaker_window_rules_test_match },
+    { 1, "cache", _wlmaker_window_rules_test_cache },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Matches all patterns of the automaton at once, as `fnmatch(3)` would. */
+void _wlmaker_window_rules_test_glob(bs_test_t *test_ptr)
+{
+    static const char *patterns[] = {
+        "abc", "a*c", "*", "a?c", "a[bx-z]c", "a[!b]c", "a\\*c", "**c*",
+        "[]]", "a[b"
+    };
+    static const struct { const char *str_ptr; uint64_t matches; } tests[] = {
+        { "abc", 0x09f },
+        { "ac", 0x086 },
+        { "aXc", 0x0ae },
+        { "ayc", 0x0be },
+        { "a*c", 0x0ee },
+        { "cat", 0x084 },
+        { "]", 0x104 },
+        { "a[b", 0x204 },
+        { "", 0x004 },
+    };
+    wlmaker_window_rules_automaton_t automaton = {};
+    BS_TEST_VERIFY_TRUE_OR_RETURN(
+        test_ptr,
+        _wlmaker_window_rules_automaton_init(&automaton, 64, 8));
+    for (size_t i = 0; i < sizeof(patterns) / sizeof(patterns[0]); ++i) {
+        _wlmaker_window_rules_automaton_add(&automaton, patterns[i], i);
+    }
+    _wlmaker_window_rules_automaton_finalize(&automaton);
+
+    for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); ++i) {
+        uint64_t matches = 0;
+        _wlmaker_window_rules_automaton_match(
+            &automaton, tests[i].str_ptr, &matches);
+        BS_TEST_VERIFY_EQ(test_ptr, tests[i].matches, matches);
+    }
+    _wlmaker_window_rules_automaton_fini(&automaton);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Applies the rules that match app ID and title, later ones overriding. */
+void _wlmaker_window_rules_test_match(bs_test_t *test_ptr)
+{
+    bspl_array_t *array_ptr = bspl_array_from_object(
+        bspl_create_object_from_plist_string(
+            "({AppId = foot; Workspace = 2;}, "
+            "{AppId = \"org.*\"; Decoration = None;}, "
+            "{Title = \"*vim*\"; SkipTaskList = True;}, "
+            "{AppId = foot; Title = htop; Width = 640; Placement = Cascade;}, "
+            "{AppId = \"[a-c]?x\"; Workspace = 3; Decoration = Server;})"));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, array_ptr);
+    wlmaker_window_rules_t *rules_ptr = wlmaker_window_rules_create(
+        array_ptr);
+    bspl_array_unref(array_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, rules_ptr);
+    wlmaker_window_rule_t rule;
+
+    // 'foot' is hashed, the other app IDs are in the automaton.
+    BS_TEST_VERIFY_EQ(test_ptr, 5, rules_ptr->entries);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, rules_ptr->app_id_automaton.states);
+
+    wlmaker_window_rules_match(rules_ptr, NULL, "foot", "bash", &rule);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, rule.workspace);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, rule.width);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMAKER_WINDOW_RULE_PLACEMENT_DEFAULT, rule.placement);
+
+    wlmaker_window_rules_match(rules_ptr, NULL, "foot", "htop", &rule);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, rule.workspace);
+    BS_TEST_VERIFY_EQ(test_ptr, 640, rule.width);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, rule.height);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMAKER_WINDOW_RULE_PLACEMENT_CASCADE, rule.placement);
+
+    wlmaker_window_rules_match(rules_ptr, NULL, "org.vim", "vim", &rule);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, rule.workspace);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMAKER_WINDOW_RULE_DECORATION_NONE, rule.decoration);
+    BS_TEST_VERIFY_TRUE(test_ptr, rule.skip_task_list);
+
+    wlmaker_window_rules_match(rules_ptr, NULL, "bax", NULL, &rule);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, rule.workspace);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMAKER_WINDOW_RULE_DECORATION_SERVER, rule.decoration);
+    BS_TEST_VERIFY_FALSE(test_ptr, rule.skip_task_list);
+
+    // No match: All defaults.
+    wlmaker_window_rules_match(rules_ptr, NULL, "dax", "Foot", &rule);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, rule.workspace);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMAKER_WINDOW_RULE_DECORATION_DEFAULT, rule.decoration);
+    wlmaker_window_rules_destroy(rules_ptr);
+
+    // Without rules, and with a rule that fails to decode.
+    rules_ptr = wlmaker_window_rules_create(NULL);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, rules_ptr);
+    wlmaker_window_rules_match(rules_ptr, NULL, "foot", "bash", &rule);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, rule.workspace);
+    wlmaker_window_rules_destroy(rules_ptr);
+    array_ptr = bspl_array_from_object(
+        bspl_create_object_from_plist_string("({Placement = Nowhere;})"));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, array_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, wlmaker_window_rules_create(array_ptr));
+    bspl_array_unref(array_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Results are cached by client, app ID and title. */
+void _wlmaker_window_rules_test_cache(bs_test_t *test_ptr)
+{
+    bspl_array_t *array_ptr = bspl_array_from_object(
+        bspl_create_object_from_plist_string(
+            "({AppId = \"f*\"; Workspace = 2;})"));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, array_ptr);
+    wlmaker_window_rules_t *rules_ptr = wlmaker_window_rules_create(
+        array_ptr);
+    bspl_array_unref(array_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, rules_ptr);
+    wlmtk_util_client_t client = { .pid = 42 };
+    wlmaker_window_rule_t rule;
+
+    wlmaker_window_rules_match(rules_ptr, &client, "foot", "a", &rule);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, rule.workspace);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, rules_ptr->cache_hits);
+    wlmaker_window_rules_match(rules_ptr, &client, "foot", "a", &rule);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, rule.workspace);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, rules_ptr->cache_hits);
+
+    // Another title, or another client, is evaluated.
+    wlmaker_window_rules_match(rules_ptr, &client, "foot", "b", &rule);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, rules_ptr->cache_hits);
+    client.pid = 43;
+    wlmaker_window_rules_match(rules_ptr, &client, "bar", "a", &rule);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, rule.workspace);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, rules_ptr->cache_hits);
+    BS_TEST_VERIFY_EQ(test_ptr, 4, rules_ptr->lookups);
+
+    wlmaker_window_rules_destroy(rules_ptr);
+}
+
+/* == End of window_rules.c ================================================ */
@@ -0,0 +1,149 @@
+/* ========================================================================= */
+/**
+ * @file window_rules.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WINDOW_RULES_H__
+#define __WINDOW_RULES_H__
+
+#include <libbase/libbase.h>
+#include <libbase/plist.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Forward declaration: Compiled window rules. */
+typedef struct _wlmaker_window_rules_t wlmaker_window_rules_t;
+
+#include "toolkit/toolkit.h"
+
+/** Server-side decoration, as set by the `Decoration` of a rule. */
+typedef enum {
+    /** Not set by the rule: Keeps what the decoration manager chose. */
+    WLMAKER_WINDOW_RULE_DECORATION_DEFAULT,
+    /** Enables server-side decoration. */
+    WLMAKER_WINDOW_RULE_DECORATION_SERVER,
+    /** Disables server-side decoration. */
+    WLMAKER_WINDOW_RULE_DECORATION_NONE
+} wlmaker_window_rule_decoration_t;
+
+/** Placement, as set by the `Placement` of a rule. */
+typedef enum {
+    /** Not set by the rule: Uses the workspace's placement policy. */
+    WLMAKER_WINDOW_RULE_PLACEMENT_DEFAULT,
+    /** @ref WLMTK_PLACEMENT_SMART. */
+    WLMAKER_WINDOW_RULE_PLACEMENT_SMART,
+    /** @ref WLMTK_PLACEMENT_CASCADE. */
+    WLMAKER_WINDOW_RULE_PLACEMENT_CASCADE,
+    /** @ref WLMTK_PLACEMENT_UNDER_POINTER. */
+    WLMAKER_WINDOW_RULE_PLACEMENT_UNDER_POINTER
+} wlmaker_window_rule_placement_t;
+
+/** Settings of the rules that apply to a window. */
+typedef struct {
+    /** Workspace to map the window to, starting at 1. 0 for the current. */
+    uint64_t                  workspace;
+    /** Server-side decoration. */
+    wlmaker_window_rule_decoration_t decoration;
+    /** Placement of the window. */
+    wlmaker_window_rule_placement_t placement;
+    /** Initial width. 0 keeps the width chosen by the client. */
+    uint64_t                  width;
+    /** Initial height. 0 keeps the height chosen by the client. */
+    uint64_t                  height;
+    /** Whether to omit the window from the task list. */
+    bool                      skip_task_list;
+} wlmaker_window_rule_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Compiles the rules of the `WindowRules` config array.
+ *
+ * Each element is a dict with the conditions `AppId` and `Title`, and the
+ * settings. Both conditions are optional, and may be glob patterns as for
+ * `fnmatch(3)`: Support `*`, `?`, bracket expressions and `\` escapes.
+ * Rules with a literal `AppId` are indexed in a hash table. All other
+ * patterns are compiled into one automaton per condition, which matches all
+ * patterns in a single pass over the string.
+ *
+ * @param array_ptr           The `WindowRules` array, or NULL.
+ *
+ * @return Pointer to the rules, or NULL on error. Must be destroyed by
+ *     calling @ref wlmaker_window_rules_destroy.
+ */
+wlmaker_window_rules_t *wlmaker_window_rules_create(bspl_array_t *array_ptr);
+
+/**
+ * Destroys the rules.
+ *
+ * @param rules_ptr
+ */
+void wlmaker_window_rules_destroy(wlmaker_window_rules_t *rules_ptr);
+
+/**
+ * Evaluates the rules for a window.
+ *
+ * All rules that match apply, in order of the configuration: A rule's
+ * setting overrides what earlier rules set. Results are cached per client,
+ * app ID and title: Clients usually open several windows of the same kind.
+ *
+ * @param rules_ptr
+ * @param client_ptr          Client of the window. May be NULL.
+ * @param app_id_ptr          App ID of the window, or XWayland class. May be
+ *                            NULL, which matches like an empty string.
+ * @param title_ptr           Title of the window. May be NULL.
+ * @param rule_ptr            Will be set to the settings that apply.
+ */
+void wlmaker_window_rules_match(
+    wlmaker_window_rules_t *rules_ptr,
+    const wlmtk_util_client_t *client_ptr,
+    const char *app_id_ptr,
+    const char *title_ptr,
+    wlmaker_window_rule_t *rule_ptr);
+
+/**
+ * Maps a new window, as configured by the rules that apply: To the rule's
+ * workspace, with the rule's decoration, placement and size. Otherwise maps
+ * it to the current workspace and places it there, near the pointer.
+ *
+ * @param rules_ptr           May be NULL, then no rule applies.
+ * @param root_ptr
+ * @param window_ptr
+ * @param app_id_ptr          App ID of the window, or XWayland class. May be
+ *                            NULL.
+ * @param pointer_x
+ * @param pointer_y
+ */
+void wlmaker_window_rules_map_window(
+    wlmaker_window_rules_t *rules_ptr,
+    wlmtk_root_t *root_ptr,
+    wlmtk_window_t *window_ptr,
+    const char *app_id_ptr,
+    int pointer_x,
+    int pointer_y);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_window_rules_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WINDOW_RULES_H__ */
+/* == End of window_rules.h ================================================ */
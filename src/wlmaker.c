@@ -25,10 +25,12 @@
 #include <libbase/plist.h>
 #include <limits.h>
 #include <regex.h>
+#include <signal.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <wayland-server-core.h>
 /// Use non-stable features of wlroots.
 #define WLR_USE_UNSTABLE
@@ -38,16 +40,24 @@
 #include "../etc/root_menu.h"
 #include "../etc/style.h"  // IWYU pragma: keep
 #include "action.h"
+#include "autostart.h"
 #include "backend/backend.h"
 #include "background.h"
 #include "backtrace.h"
 #include "clip.h"
 #include "config.h"
+#include "debug_overlay.h"
 #include "dock.h"
+#include "mem_pressure.h"
+#include "memlock.h"
+#include "priority.h"
 #include "root_menu.h"
 #include "server.h"
+#include "startup_profile.h"
+#include "stats_socket.h"
 #include "task_list.h"
 #include "toolkit/toolkit.h"
+#include "watchdog.h"
 
 /** Will hold the value of --config_file. */
 static char *wlmaker_arg_config_file_ptr = NULL;
@@ -57,6 +67,18 @@ static char *wlmaker_arg_state_file_ptr = NULL;
 static char *wlmaker_arg_style_file_ptr = NULL;
 /** Will hold the value of --root_menu_file. */
 static char *wlmaker_arg_root_menu_file_ptr = NULL;
+/** Will hold the value of --startup_profile. */
+static bool wlmaker_arg_startup_profile = false;
+/** Will hold the value of --startup_trace_file. */
+static char *wlmaker_arg_startup_trace_file_ptr = NULL;
+/** Will hold the value of --watchdog_msec. */
+static uint32_t wlmaker_arg_watchdog_msec = 50;
+/** Will hold the value of --stats_socket. */
+static bool wlmaker_arg_stats_socket = false;
+/** Will hold the value of --priority. */
+static wlmaker_priority_t wlmaker_arg_priority = WLMAKER_PRIORITY_NORMAL;
+/** Will hold the value of --lock_memory_mib. */
+static uint32_t wlmaker_arg_lock_memory_mib = 0;
 
 /** Startup options for the server. */
 static wlmaker_server_options_t wlmaker_server_options = {
@@ -74,6 +96,14 @@ static const bs_arg_enum_table_t wlmaker_log_levels[] = {
     { .name_ptr = NULL },
 };
 
+/** Priorities of the compositor thread. */
+static const bs_arg_enum_table_t wlmaker_priorities[] = {
+    { .name_ptr = "NORMAL", WLMAKER_PRIORITY_NORMAL },
+    { .name_ptr = "NICE", WLMAKER_PRIORITY_NICE },
+    { .name_ptr = "REALTIME", WLMAKER_PRIORITY_REALTIME },
+    { .name_ptr = NULL },
+};
+
 /** Definition of commandline arguments. */
 static const bs_arg_t wlmaker_args[] = {
 #if defined(WLMAKER_HAVE_XWAYLAND)
@@ -129,13 +159,54 @@ static const bs_arg_t wlmaker_args[] = {
         "preferred dimensions.",
         0, 0, UINT32_MAX,
         &wlmaker_server_options.width),
+    BS_ARG_BOOL(
+        "startup_profile",
+        "Optional: Whether to log the duration of each startup phase, once "
+        "startup completed. Disabled by default.",
+        false,
+        &wlmaker_arg_startup_profile),
+    BS_ARG_STRING(
+        "startup_trace_file",
+        "Optional: Path to a file for writing the startup phases to, as "
+        "JSON in the Chrome trace event format.",
+        NULL,
+        &wlmaker_arg_startup_trace_file_ptr),
+    BS_ARG_UINT32(
+        "watchdog_msec",
+        "Optional: Logs a warning and a backtrace when the event loop does "
+        "not dispatch pending events within this many milliseconds. Set to "
+        "0 to disable the watchdog.",
+        50, 0, UINT32_MAX,
+        &wlmaker_arg_watchdog_msec),
+    BS_ARG_BOOL(
+        "stats_socket",
+        "Optional: Whether to export runtime statistics on a Unix socket, "
+        "at $XDG_RUNTIME_DIR/<wayland socket>.stats. Disabled by default.",
+        false,
+        &wlmaker_arg_stats_socket),
+    BS_ARG_ENUM(
+        "priority",
+        "Optional: Scheduling priority of the compositor thread. One of "
+        "NORMAL, NICE (nice -10) or REALTIME (SCHED_RR, falling back to "
+        "NICE). Requires CAP_SYS_NICE, or RLIMIT_NICE resp. RLIMIT_RTPRIO. "
+        "Launched applications are always scheduled normally.",
+        "NORMAL",
+        &wlmaker_priorities[0],
+        (int*)&wlmaker_arg_priority),
+    BS_ARG_UINT32(
+        "lock_memory_mib",
+        "Optional: Locks the compositor's code, and an arena of this many "
+        "MiB for hot toolkit structures, in memory. Avoids page faults on "
+        "the frame path. Subject to RLIMIT_MEMLOCK. 0 to disable.",
+        0,
+        0,
+        UINT32_MAX,
+        &wlmaker_arg_lock_memory_mib),
     BS_ARG_SENTINEL()
 };
 
-/** References auto-started subprocesses. */
-static bs_ptr_stack_t         wlmaker_subprocess_stack;
-/** References to the created backgrounds. */
-static bs_ptr_stack_t         wlmaker_background_stack;
+/** The created backgrounds. Workspaces of same color and image share one. */
+static bs_dllist_t            wlmaker_backgrounds;
 
 /** Compiled regular expression for extracting file & line no. from wlr_log. */
 static regex_t                wlmaker_wlr_log_regex;
@@ -149,6 +220,8 @@ typedef struct {
     char            name[32];
     /** Background color. */
     uint32_t        color;
+    /** Optional path to the wallpaper image. Empty for none. */
+    char            image[256];
 } wlmaker_workspace_style_t;
 
 /** Style descriptor for the "Workspace" dict of wlmaker-state.plist. */
@@ -157,6 +230,58 @@ static const bspl_desc_t wlmaker_workspace_style_desc[] = {
         "Name", true, wlmaker_workspace_style_t, name, name, 32, NULL),
     BSPL_DESC_ARGB32(
         "Color", false, wlmaker_workspace_style_t, color, color, 0),
+    BSPL_DESC_CHARBUF(
+        "Image", false, wlmaker_workspace_style_t, image, image, 256, ""),
+    BSPL_DESC_SENTINEL()
+};
+
+/** Contents of the "MoveResize" dict of wlmaker.plist. */
+typedef struct {
+    /** How windows are presented while moved or resized. */
+    wlmtk_workspace_drag_mode_t mode;
+    /** Distance for snapping moved windows to edges, in pixels. */
+    uint64_t                  snap_distance;
+} wlmaker_move_resize_config_t;
+
+/** Plist descriptor of @ref wlmtk_workspace_drag_mode_t. */
+static const bspl_enum_desc_t wlmaker_drag_mode_desc[] = {
+    BSPL_ENUM("Opaque", WLMTK_WORKSPACE_DRAG_OPAQUE),
+    BSPL_ENUM("Outline", WLMTK_WORKSPACE_DRAG_OUTLINE),
+    BSPL_ENUM_SENTINEL()
+};
+
+/** Descriptor for the "MoveResize" dict of wlmaker.plist. */
+static const bspl_desc_t wlmaker_move_resize_config_desc[] = {
+    BSPL_DESC_ENUM("Mode", false, wlmaker_move_resize_config_t, mode, mode,
+                   WLMTK_WORKSPACE_DRAG_OPAQUE, wlmaker_drag_mode_desc),
+    BSPL_DESC_UINT64("SnapDistance", false, wlmaker_move_resize_config_t,
+                     snap_distance, snap_distance, 0),
+    BSPL_DESC_SENTINEL()
+};
+
+/** Contents of the "Workspaces" dict of wlmaker.plist. */
+typedef struct {
+    /** Whether each output shows a workspace of its own. */
+    bool                      per_output;
+    /** How new windows get placed. */
+    wlmtk_placement_policy_t  placement;
+} wlmaker_workspaces_config_t;
+
+/** Plist descriptor of @ref wlmtk_placement_policy_t. */
+static const bspl_enum_desc_t wlmaker_placement_desc[] = {
+    BSPL_ENUM("Smart", WLMTK_PLACEMENT_SMART),
+    BSPL_ENUM("Cascade", WLMTK_PLACEMENT_CASCADE),
+    BSPL_ENUM("UnderPointer", WLMTK_PLACEMENT_UNDER_POINTER),
+    BSPL_ENUM_SENTINEL()
+};
+
+/** Descriptor for the "Workspaces" dict of wlmaker.plist. */
+static const bspl_desc_t wlmaker_workspaces_config_desc[] = {
+    BSPL_DESC_BOOL("PerOutput", false, wlmaker_workspaces_config_t,
+                   per_output, per_output, false),
+    BSPL_DESC_ENUM("Placement", false, wlmaker_workspaces_config_t,
+                   placement, placement, WLMTK_PLACEMENT_SMART,
+                   wlmaker_placement_desc),
     BSPL_DESC_SENTINEL()
 };
 
@@ -210,26 +335,6 @@ static void wlr_to_bs_log(
         &buf[matches[0].rm_eo]);
 }
 
-/* ------------------------------------------------------------------------- */
-/** Launches a sub-process, and keeps it on the subprocess stack. */
-bool start_subprocess(const char *cmdline_ptr)
-{
-    bs_subprocess_t *sp_ptr = bs_subprocess_create_cmdline(cmdline_ptr);
-    if (NULL == sp_ptr) {
-        bs_log(BS_ERROR, "Failed bs_subprocess_create_cmdline(\"%s\")",
-               cmdline_ptr);
-        return false;
-    }
-    if (!bs_subprocess_start(sp_ptr)) {
-        bs_log(BS_ERROR, "Failed bs_subprocess_start for \"%s\"",
-               cmdline_ptr);
-        return false;
-    }
-    // Push to stack. Ignore errors: We'll keep it running untracked.
-    bs_ptr_stack_push(&wlmaker_subprocess_stack, sp_ptr);
-    return true;
-}
-
 /* ------------------------------------------------------------------------- */
 /** Creates workspaces as configured in the state dict. */
 bool create_workspaces(
@@ -240,6 +345,35 @@ bool create_workspaces(
         state_dict_ptr, "Workspaces");
     if (NULL == array_ptr) return false;
 
+    // Optional: Defaults to opaque move and resize.
+    wlmaker_move_resize_config_t move_resize = {
+        .mode = WLMTK_WORKSPACE_DRAG_OPAQUE
+    };
+    bspl_dict_t *move_resize_dict_ptr = bspl_dict_get_dict(
+        server_ptr->config_dict_ptr, "MoveResize");
+    if (NULL != move_resize_dict_ptr &&
+        !bspl_decode_dict(move_resize_dict_ptr,
+                          wlmaker_move_resize_config_desc,
+                          &move_resize)) {
+        bs_log(BS_ERROR, "Failed to decode \"MoveResize\" dict");
+        return false;
+    }
+
+    // Optional: Defaults to one workspace shown across all outputs, and
+    // smart placement.
+    wlmaker_workspaces_config_t workspaces = {
+        .placement = WLMTK_PLACEMENT_SMART
+    };
+    bspl_dict_t *workspaces_dict_ptr = bspl_dict_get_dict(
+        server_ptr->config_dict_ptr, "Workspaces");
+    if (NULL != workspaces_dict_ptr &&
+        !bspl_decode_dict(workspaces_dict_ptr,
+                          wlmaker_workspaces_config_desc,
+                          &workspaces)) {
+        bs_log(BS_ERROR, "Failed to decode \"Workspaces\" dict");
+        return false;
+    }
+
     bool rv = true;
     for (size_t i = 0; i < bspl_array_size(array_ptr); ++i) {
         bspl_dict_t *dict_ptr = bspl_dict_from_object(
@@ -268,25 +402,64 @@ bool create_workspaces(
             rv = false;
             break;
         }
+        wlmtk_workspace_set_drag_mode(workspace_ptr, move_resize.mode);
+        wlmtk_workspace_set_snap_distance(
+            workspace_ptr, BS_MIN(move_resize.snap_distance, 1000U));
+        wlmtk_workspace_set_placement_policy(
+            workspace_ptr, workspaces.placement);
 
         if (s.color == 0) {
             s.color = server_ptr->style.background_color;
         }
-        wlmaker_background_t *background_ptr = wlmaker_background_create(
-            workspace_ptr,
-            server_ptr->wlr_output_layout_ptr,
-            s.color);
-        if (NULL == background_ptr) {
-            bs_log(BS_ERROR, "Failed wlmaker_background()");
+        char full_path[PATH_MAX];
+        const char *image_path_ptr = NULL;
+        if (0 < strlen(s.image)) {
+            image_path_ptr = bs_file_resolve_path(s.image, full_path);
+            if (NULL == image_path_ptr) {
+                bs_log(BS_WARNING | BS_ERRNO,
+                       "Failed bs_file_resolve_path(%s, %p) for workspace "
+                       "\"%s\", using color only.",
+                       s.image, full_path, s.name);
+            }
+        }
+        wlmaker_background_t *background_ptr = wlmaker_background_find(
+            &wlmaker_backgrounds, s.color, image_path_ptr);
+        if (NULL != background_ptr) {
+            if (!wlmaker_background_add_workspace(
+                    background_ptr, workspace_ptr)) {
+                bs_log(BS_ERROR, "Failed wlmaker_background_add_workspace()");
+                rv = false;
+                break;
+            }
+        } else {
+            background_ptr = wlmaker_background_create(
+                server_ptr->root_ptr,
+                workspace_ptr,
+                server_ptr->wlr_output_layout_ptr,
+                s.color,
+                image_path_ptr);
+            if (NULL == background_ptr) {
+                bs_log(BS_ERROR, "Failed wlmaker_background()");
+                rv = false;
+                break;
+            }
+            bs_dllist_push_back(
+                &wlmaker_backgrounds,
+                wlmaker_dlnode_from_background(background_ptr));
+        }
+
+        if (!wlmtk_root_add_workspace(server_ptr->root_ptr, workspace_ptr)) {
+            bs_log(BS_ERROR, "Failed wlmtk_root_add_workspace(\"%s\")",
+                   s.name);
             rv = false;
             break;
         }
-        BS_ASSERT(bs_ptr_stack_push(
-                      &wlmaker_background_stack, background_ptr));
-
-        wlmtk_root_add_workspace(server_ptr->root_ptr, workspace_ptr);
     }
 
+    if (rv) {
+        wlmtk_root_set_per_output_workspaces(
+            server_ptr->root_ptr, workspaces.per_output);
+    }
     return rv;
 }
 
@@ -304,16 +477,306 @@ static const char *_wlmaker_style_fname_ptrs[] = {
     NULL  // Sentinel.
 };
 
+/** Delay from the last change of state until the state file is written. */
+static const uint64_t _wlmaker_state_writer_debounce_msec = 1000;
+
+/** Components created after the first frame, from an idle callback. */
+typedef struct {
+    /** Back-link to server. */
+    wlmaker_server_t          *server_ptr;
+    /** The state, for dock and clip. */
+    bspl_dict_t               *state_dict_ptr;
+    /** Startup profile, to report once all is created. */
+    wlmaker_startup_profile_t *profile_ptr;
+    /** The dock. */
+    wlmaker_dock_t            *dock_ptr;
+    /** The clip. */
+    wlmaker_clip_t            *clip_ptr;
+    /** The task list. */
+    wlmaker_task_list_t       *task_list_ptr;
+    /** The debug overlay. */
+    wlmaker_debug_overlay_t   *debug_overlay_ptr;
+    /** Whether creating any of the deferred components failed. */
+    bool                      failed;
+} wlmaker_deferred_t;
+
+/** State for reloading configuration and style, on request or SIGHUP. */
+typedef struct {
+    /** Back-link to server. */
+    wlmaker_server_t          *server_ptr;
+    /** Handle of the currently-bound keys. */
+    wlmaker_action_handle_t   *action_handle_ptr;
+    /** Listener for @ref wlmaker_server_t::reload_event. */
+    struct wl_listener        reload_listener;
+    /** Event source for SIGHUP. */
+    struct wl_event_source    *sighup_event_source_ptr;
+    /** Idle event source, while a reload is pending. */
+    struct wl_event_source    *idle_event_source_ptr;
+} wlmaker_reload_t;
+
+static wlmaker_state_writer_t *create_state_writer(
+    wlmaker_server_t *server_ptr,
+    const char *fname_ptr);
+static void report_startup_profile(wlmaker_startup_profile_t *profile_ptr);
+static bool load_style(wlmaker_config_style_t *style_ptr);
+static void schedule_reload(wlmaker_reload_t *reload_ptr);
+static void handle_reload(struct wl_listener *listener_ptr, void *data_ptr);
+static int handle_sighup(int signal_number, void *data_ptr);
+static void reload(void *data_ptr);
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates root menu, dock, clip, task list and debug overlay. Called from
+ * an idle callback, so that time to first frame does not depend on their
+ * size.
+ *
+ * Terminates the display if any of these components fails.
+ *
+ * @param data_ptr            Points to a @ref wlmaker_deferred_t.
+ */
+static void create_deferred(void *data_ptr)
+{
+    wlmaker_deferred_t *deferred_ptr = data_ptr;
+    wlmaker_server_t *server_ptr = deferred_ptr->server_ptr;
+
+    wlmaker_startup_profile_phase(deferred_ptr->profile_ptr, "root_menu");
+    // TODO(kaeser@gubbe.ch): Uh, that's ugly...
+    server_ptr->root_menu_ptr = wlmaker_root_menu_create(
+        server_ptr,
+        &server_ptr->style.window,
+        &server_ptr->style.menu);
+    if (NULL != server_ptr->root_menu_ptr) {
+        wlmtk_menu_set_open(
+            wlmaker_root_menu_menu(server_ptr->root_menu_ptr),
+            false);
+    }
+
+    wlmaker_startup_profile_phase(
+        deferred_ptr->profile_ptr, "create_dock_clip_tasks");
+    deferred_ptr->dock_ptr = wlmaker_dock_create(
+        server_ptr, deferred_ptr->state_dict_ptr, &server_ptr->style);
+    deferred_ptr->clip_ptr = wlmaker_clip_create(
+        server_ptr, deferred_ptr->state_dict_ptr, &server_ptr->style);
+    deferred_ptr->task_list_ptr = wlmaker_task_list_create(
+        server_ptr, &server_ptr->style);
+    deferred_ptr->debug_overlay_ptr = wlmaker_debug_overlay_create(
+        server_ptr, &server_ptr->style);
+    if (NULL == server_ptr->root_menu_ptr ||
+        NULL == deferred_ptr->dock_ptr ||
+        NULL == deferred_ptr->clip_ptr ||
+        NULL == deferred_ptr->task_list_ptr ||
+        NULL == deferred_ptr->debug_overlay_ptr) {
+        bs_log(BS_ERROR, "Failed to create root menu, dock, clip, task list "
+               "or debug overlay.");
+        deferred_ptr->failed = true;
+        wl_display_terminate(server_ptr->wl_display_ptr);
+        return;
+    }
+    report_startup_profile(deferred_ptr->profile_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates the writer for the state file: At `fname_ptr` if given through
+ * --state_file, or at `~/.wlmaker-state.plist`. That is found first when
+ * loading the state, next time.
+ *
+ * @param server_ptr
+ * @param fname_ptr           Value of --state_file, or NULL.
+ *
+ * @return The state writer, or NULL if the state won't be persisted.
+ */
+static wlmaker_state_writer_t *create_state_writer(
+    wlmaker_server_t *server_ptr,
+    const char *fname_ptr)
+{
+    char path[PATH_MAX];
+    if (NULL == fname_ptr) {
+        const char *home_ptr = getenv("HOME");
+        if (NULL == home_ptr || '\0' == *home_ptr) {
+            bs_log(BS_WARNING, "HOME not set, not persisting the state.");
+            return NULL;
+        }
+        int rv = snprintf(
+            path, sizeof(path), "%s/.wlmaker-state.plist", home_ptr);
+        if (0 > rv || sizeof(path) <= (size_t)rv) {
+            bs_log(BS_WARNING, "Path too long, not persisting the state.");
+            return NULL;
+        }
+        fname_ptr = path;
+    }
+
+    wlmaker_state_writer_t *state_writer_ptr = wlmaker_state_writer_create(
+        wl_display_get_event_loop(server_ptr->wl_display_ptr),
+        fname_ptr,
+        _wlmaker_state_writer_debounce_msec);
+    if (NULL == state_writer_ptr) {
+        bs_log(BS_WARNING, "Failed wlmaker_state_writer_create(%s), not "
+               "persisting the state.", fname_ptr);
+    }
+    return state_writer_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Reports the startup profile, as requested by --startup_profile and
+ * --startup_trace_file.
+ *
+ * @param profile_ptr
+ */
+static void report_startup_profile(wlmaker_startup_profile_t *profile_ptr)
+{
+    wlmaker_startup_profile_end(profile_ptr);
+    if (wlmaker_arg_startup_profile) {
+        wlmaker_startup_profile_log(profile_ptr, BS_INFO);
+    }
+
+    if (NULL == wlmaker_arg_startup_trace_file_ptr) return;
+    FILE *file_ptr = fopen(wlmaker_arg_startup_trace_file_ptr, "w");
+    if (NULL == file_ptr) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed fopen(%s, \"w\")",
+               wlmaker_arg_startup_trace_file_ptr);
+        return;
+    }
+    if (!wlmaker_startup_profile_write_trace(profile_ptr, file_ptr)) {
+        bs_log(BS_WARNING, "Failed to write startup trace to %s",
+               wlmaker_arg_startup_trace_file_ptr);
+    }
+    fclose(file_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Loads and decodes the style, from --style_file or the default locations.
+ *
+ * @param style_ptr           Decoded into. Must be released by calling
+ *                            bspl_decoded_destroy().
+ *
+ * @return true on success.
+ */
+static bool load_style(wlmaker_config_style_t *style_ptr)
+{
+    bspl_dict_t *style_dict_ptr = bspl_dict_from_object(
+        wlmaker_plist_load(
+            "style",
+            wlmaker_arg_style_file_ptr,
+            _wlmaker_style_fname_ptrs,
+            embedded_binary_style_data,
+            embedded_binary_style_size));
+    if (NULL == style_dict_ptr) return false;
+    bool rv = bspl_decode_dict(
+        style_dict_ptr, wlmaker_config_style_desc, style_ptr);
+    bspl_dict_unref(style_dict_ptr);
+    return rv;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Schedules a reload from an idle callback. Key bindings are re-bound when
+ * reloading, hence this must not run from within a key binding's callback.
+ *
+ * @param reload_ptr
+ */
+static void schedule_reload(wlmaker_reload_t *reload_ptr)
+{
+    if (NULL != reload_ptr->idle_event_source_ptr) return;
+    reload_ptr->idle_event_source_ptr = wl_event_loop_add_idle(
+        wl_display_get_event_loop(reload_ptr->server_ptr->wl_display_ptr),
+        reload,
+        reload_ptr);
+    if (NULL == reload_ptr->idle_event_source_ptr) {
+        bs_log(BS_WARNING, "Failed wl_event_loop_add_idle()");
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles @ref wlmaker_server_t::reload_event: Schedules a reload. */
+static void handle_reload(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    schedule_reload(BS_CONTAINER_OF(
+                        listener_ptr, wlmaker_reload_t, reload_listener));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles SIGHUP: Schedules a reload. */
+static int handle_sighup(__UNUSED__ int signal_number, void *data_ptr)
+{
+    schedule_reload(data_ptr);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Re-loads configuration and style. Re-binds the keys from the new
+ * configuration, and applies the new style to windows where it changed.
+ * Keeps the current configuration or style if loading fails.
+ *
+ * @param data_ptr            Points to a @ref wlmaker_reload_t.
+ */
+static void reload(void *data_ptr)
+{
+    wlmaker_reload_t *reload_ptr = data_ptr;
+    wlmaker_server_t *server_ptr = reload_ptr->server_ptr;
+    reload_ptr->idle_event_source_ptr = NULL;
+
+    bspl_dict_t *config_dict_ptr = wlmaker_config_load(
+        wlmaker_arg_config_file_ptr);
+    if (NULL == config_dict_ptr) {
+        bs_log(BS_WARNING, "Failed to reload configuration, keeping current.");
+    } else {
+        wlmaker_action_unbind_keys(reload_ptr->action_handle_ptr);
+        wlmaker_action_handle_t *action_handle_ptr = wlmaker_action_bind_keys(
+            server_ptr,
+            bspl_dict_get_dict(config_dict_ptr,
+                               wlmaker_action_config_dict_key));
+        if (NULL == action_handle_ptr) {
+            bs_log(BS_WARNING, "Failed to bind keys, keeping current.");
+            action_handle_ptr = wlmaker_action_bind_keys(
+                server_ptr,
+                bspl_dict_get_dict(server_ptr->config_dict_ptr,
+                                   wlmaker_action_config_dict_key));
+            bspl_dict_unref(config_dict_ptr);
+        } else {
+            bspl_dict_unref(server_ptr->config_dict_ptr);
+            server_ptr->config_dict_ptr = config_dict_ptr;
+        }
+        // Both are the same bindings as before, hence this must succeed.
+        reload_ptr->action_handle_ptr = BS_ASSERT_NOTNULL(action_handle_ptr);
+
+        wlmaker_window_rules_t *window_rules_ptr = wlmaker_window_rules_create(
+            bspl_dict_get_array(server_ptr->config_dict_ptr, "WindowRules"));
+        if (NULL == window_rules_ptr) {
+            bs_log(BS_WARNING, "Failed to compile window rules, keeping "
+                   "current.");
+        } else {
+            if (NULL != server_ptr->window_rules_ptr) {
+                wlmaker_window_rules_destroy(server_ptr->window_rules_ptr);
+            }
+            server_ptr->window_rules_ptr = window_rules_ptr;
+        }
+    }
+
+    wlmaker_config_style_t style = {};
+    if (load_style(&style)) {
+        wlmaker_server_apply_style(server_ptr, &style);
+    } else {
+        bs_log(BS_WARNING, "Failed to reload style, keeping current.");
+    }
+    bspl_decoded_destroy(wlmaker_config_style_desc, &style);
+}
+
 /* == Main program ========================================================= */
 /** The main program. */
 int main(__UNUSED__ int argc, __UNUSED__ const char **argv)
 {
-    wlmaker_dock_t            *dock_ptr = NULL;
-    wlmaker_clip_t            *clip_ptr = NULL;
-    wlmaker_task_list_t       *task_list_ptr = NULL;
     int                       rv = EXIT_SUCCESS;
 
     if (!wlmaker_backtrace_setup(argv[0])) return EXIT_FAILURE;
+    wlmaker_startup_profile_t *profile_ptr = wlmaker_startup_profile_create();
+    if (NULL == profile_ptr) return EXIT_FAILURE;
+    wlmaker_startup_profile_phase(profile_ptr, "parse_args");
 
     rv = regcomp(
         &wlmaker_wlr_log_regex,
@@ -328,48 +791,60 @@ int main(__UNUSED__ int argc, __UNUSED__ const char **argv)
 
     wlr_log_init(WLR_DEBUG, wlr_to_bs_log);
     bs_log_severity = BS_INFO;  // Will be overwritten in bs_arg_parse().
-    BS_ASSERT(bs_ptr_stack_init(&wlmaker_subprocess_stack));
-    BS_ASSERT(bs_ptr_stack_init(&wlmaker_background_stack));
 
     if (!bs_arg_parse(wlmaker_args, BS_ARG_MODE_NO_EXTRA, &argc, argv)) {
         fprintf(stderr, "Failed to parse commandline arguments.\n");
         bs_arg_print_usage(stderr, wlmaker_args);
         return EXIT_FAILURE;
     }
+    // Early, before any thread is created: Threads and subprocesses created
+    // later get reset to normal priority, through SCHED_RESET_ON_FORK.
+    if (!wlmaker_priority_raise(wlmaker_arg_priority)) {
+        bs_log(BS_WARNING, "Failed to raise priority, continuing.");
+    }
+    // Also before allocating: The arena only serves allocations made after.
+    if (0 < wlmaker_arg_lock_memory_mib) {
+        if (!wlmaker_memlock_code()) {
+            bs_log(BS_WARNING, "Failed to lock code in memory, continuing.");
+        }
+        if (!wlmtk_arena_lock((size_t)wlmaker_arg_lock_memory_mib << 20)) {
+            bs_log(BS_WARNING, "Failed to lock %u MiB arena, continuing.",
+                   (unsigned)wlmaker_arg_lock_memory_mib);
+        }
+    }
+
+    wlmaker_startup_profile_phase(profile_ptr, "load_config");
     bspl_dict_t *config_dict_ptr = wlmaker_config_load(
         wlmaker_arg_config_file_ptr);
-    if (NULL != wlmaker_arg_config_file_ptr) free(wlmaker_arg_config_file_ptr);
     if (NULL == config_dict_ptr) {
         fprintf(stderr, "Failed to load & initialize configuration.\n");
         return EXIT_FAILURE;
     }
 
+    wlmaker_startup_profile_phase(profile_ptr, "load_state");
     bspl_dict_t *state_dict_ptr = wlmaker_state_load(
         wlmaker_arg_state_file_ptr);
-    if (NULL != wlmaker_arg_state_file_ptr) free(wlmaker_arg_state_file_ptr);
     if (NULL == state_dict_ptr) {
         fprintf(stderr, "Failed to load & initialize state.\n");
+        free(wlmaker_arg_state_file_ptr);
         return EXIT_FAILURE;
     }
 
+    wlmaker_startup_profile_phase(profile_ptr, "create_server");
     wlmaker_server_t *server_ptr = wlmaker_server_create(
         config_dict_ptr, &wlmaker_server_options);
-    if (NULL == server_ptr) return EXIT_FAILURE;
+    if (NULL == server_ptr) {
+        free(wlmaker_arg_state_file_ptr);
+        return EXIT_FAILURE;
+    }
+    server_ptr->state_writer_ptr = create_state_writer(
+        server_ptr, wlmaker_arg_state_file_ptr);
+    if (NULL != wlmaker_arg_state_file_ptr) free(wlmaker_arg_state_file_ptr);
 
-    bspl_dict_t *style_dict_ptr = bspl_dict_from_object(
-        wlmaker_plist_load(
-            "style",
-            wlmaker_arg_style_file_ptr,
-            _wlmaker_style_fname_ptrs,
-            embedded_binary_style_data,
-            embedded_binary_style_size));
-    if (NULL == style_dict_ptr) return EXIT_FAILURE;
-    if (!bspl_decode_dict(
-            style_dict_ptr,
-            wlmaker_config_style_desc,
-            &server_ptr->style)) return EXIT_FAILURE;
-    bspl_dict_unref(style_dict_ptr);
+    wlmaker_startup_profile_phase(profile_ptr, "load_style");
+    if (!load_style(&server_ptr->style)) return EXIT_FAILURE;
 
+    wlmaker_startup_profile_phase(profile_ptr, "load_root_menu");
     server_ptr->root_menu_array_ptr = bspl_array_from_object(
         wlmaker_plist_load(
             "root menu",
@@ -378,18 +853,8 @@ int main(__UNUSED__ int argc, __UNUSED__ const char **argv)
             embedded_binary_root_menu_data,
             embedded_binary_root_menu_size));
     if (NULL == server_ptr->root_menu_array_ptr) return EXIT_FAILURE;
-    // TODO(kaeser@gubbe.ch): Uh, that's ugly...
-    server_ptr->root_menu_ptr = wlmaker_root_menu_create(
-        server_ptr,
-        &server_ptr->style.window,
-        &server_ptr->style.menu);
-    if (NULL == server_ptr->root_menu_ptr) {
-        return EXIT_FAILURE;
-    }
-    wlmtk_menu_set_open(
-        wlmaker_root_menu_menu(server_ptr->root_menu_ptr),
-        false);
 
+    wlmaker_startup_profile_phase(profile_ptr, "bind_keys");
     wlmaker_action_handle_t *action_handle_ptr = wlmaker_action_bind_keys(
         server_ptr,
         bspl_dict_get_dict(config_dict_ptr, wlmaker_action_config_dict_key));
@@ -398,12 +863,34 @@ int main(__UNUSED__ int argc, __UNUSED__ const char **argv)
         return EXIT_FAILURE;
     }
 
+    wlmaker_reload_t reload = {
+        .server_ptr = server_ptr,
+        .action_handle_ptr = action_handle_ptr
+    };
+    wlmtk_util_connect_listener_signal(
+        &server_ptr->reload_event,
+        &reload.reload_listener,
+        handle_reload);
+    reload.sighup_event_source_ptr = wl_event_loop_add_signal(
+        wl_display_get_event_loop(server_ptr->wl_display_ptr),
+        SIGHUP,
+        handle_sighup,
+        &reload);
+
+    wlmaker_startup_profile_phase(profile_ptr, "create_workspaces");
     if (!create_workspaces(state_dict_ptr, server_ptr)) {
         return EXIT_FAILURE;
     }
 
     rv = EXIT_SUCCESS;
+    wlmaker_deferred_t deferred = {
+        .server_ptr = server_ptr,
+        .state_dict_ptr = state_dict_ptr,
+        .profile_ptr = profile_ptr
+    };
+    wlmaker_startup_profile_phase(profile_ptr, "start_backend");
     if (wlr_backend_start(wlmbe_backend_wlr(server_ptr->backend_ptr))) {
+        wlmbe_backend_configure_pending_outputs(server_ptr->backend_ptr);
 
         if (0 >= wlmbe_num_outputs(server_ptr->wlr_output_layout_ptr)) {
             bs_log(BS_ERROR, "No outputs available!");
@@ -415,26 +902,58 @@ int main(__UNUSED__ int argc, __UNUSED__ const char **argv)
 
         setenv("WAYLAND_DISPLAY", server_ptr->wl_socket_name_ptr, true);
 
-        bspl_array_t *autostarted_ptr = bspl_dict_get_array(
-            config_dict_ptr, "Autostart");
-        if (NULL != autostarted_ptr) {
-            for (size_t i = 0; i < bspl_array_size(autostarted_ptr); ++i) {
-                const char *cmd_ptr = bspl_array_string_value_at(
-                    autostarted_ptr, i);
-                if (!start_subprocess(cmd_ptr)) return EXIT_FAILURE;
+        // The outputs' first frames are already scheduled as idle events.
+        // Idle events run in order, so the deferred components get created
+        // right after these first frames are rendered.
+        wlmaker_startup_profile_phase(profile_ptr, "first_frame");
+        if (NULL == wl_event_loop_add_idle(
+                wl_display_get_event_loop(server_ptr->wl_display_ptr),
+                create_deferred,
+                &deferred)) {
+            bs_log(BS_ERROR, "Failed wl_event_loop_add_idle()");
+            rv = EXIT_FAILURE;
+        } else {
+            // Starts from an idle event: After the deferred components.
+            wlmaker_autostart_t *autostart_ptr = NULL;
+            bspl_array_t *autostart_array_ptr = bspl_dict_get_array(
+                config_dict_ptr, "Autostart");
+            if (NULL != autostart_array_ptr) {
+                autostart_ptr = wlmaker_autostart_create(
+                    wl_display_get_event_loop(server_ptr->wl_display_ptr),
+                    server_ptr->monitor_ptr,
+                    autostart_array_ptr,
+                    bspl_dict_get_dict(config_dict_ptr, "AutostartSchedule"));
+                if (NULL == autostart_ptr) return EXIT_FAILURE;
             }
-        }
 
-        dock_ptr = wlmaker_dock_create(
-            server_ptr, state_dict_ptr, &server_ptr->style);
-        clip_ptr = wlmaker_clip_create(
-            server_ptr, state_dict_ptr, &server_ptr->style);
-        task_list_ptr = wlmaker_task_list_create(
-            server_ptr, &server_ptr->style);
-        if (NULL == dock_ptr || NULL == clip_ptr || NULL == task_list_ptr) {
-            bs_log(BS_ERROR, "Failed to create dock, clip or task list.");
-        } else {
+            wlmaker_watchdog_t *watchdog_ptr = NULL;
+            if (0 < wlmaker_arg_watchdog_msec) {
+                watchdog_ptr = wlmaker_watchdog_create(
+                    wl_display_get_event_loop(server_ptr->wl_display_ptr),
+                    wlmaker_arg_watchdog_msec);
+            }
+            // Optional: Caches are then just not trimmed under pressure.
+            wlmaker_mem_pressure_t *mem_pressure_ptr =
+                wlmaker_mem_pressure_create(
+                    wl_display_get_event_loop(server_ptr->wl_display_ptr),
+                    NULL);
+            wlmaker_stats_socket_t *stats_socket_ptr = NULL;
+            if (wlmaker_arg_stats_socket) {
+                stats_socket_ptr = wlmaker_stats_socket_create(
+                    server_ptr, watchdog_ptr);
+            }
             wl_display_run(server_ptr->wl_display_ptr);
+            if (NULL != stats_socket_ptr) {
+                wlmaker_stats_socket_destroy(stats_socket_ptr);
+            }
+            if (NULL != mem_pressure_ptr) {
+                wlmaker_mem_pressure_destroy(mem_pressure_ptr);
+            }
+            if (NULL != watchdog_ptr) wlmaker_watchdog_destroy(watchdog_ptr);
+            if (NULL != autostart_ptr) {
+                wlmaker_autostart_destroy(autostart_ptr);
+            }
+            if (deferred.failed) rv = EXIT_FAILURE;
         }
 
     } else {
@@ -442,28 +961,44 @@ int main(__UNUSED__ int argc, __UNUSED__ const char **argv)
         rv = EXIT_FAILURE;
     }
 
-    wlmaker_background_t *bg_ptr;
-    while (NULL != (bg_ptr = bs_ptr_stack_pop(&wlmaker_background_stack))) {
-        wlmaker_background_destroy(bg_ptr);
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&wlmaker_backgrounds))) {
+        wlmaker_background_destroy(wlmaker_background_from_dlnode(dlnode_ptr));
     }
-    bs_ptr_stack_fini(&wlmaker_background_stack);
 
-    if (NULL != task_list_ptr) wlmaker_task_list_destroy(task_list_ptr);
-    if (NULL != clip_ptr) wlmaker_clip_destroy(clip_ptr);
-    if (NULL != dock_ptr) wlmaker_dock_destroy(dock_ptr);
-    wlmaker_action_unbind_keys(action_handle_ptr);
+    if (NULL != deferred.debug_overlay_ptr) {
+        wlmaker_debug_overlay_destroy(deferred.debug_overlay_ptr);
+    }
+    if (NULL != deferred.task_list_ptr) {
+        wlmaker_task_list_destroy(deferred.task_list_ptr);
+    }
+    if (NULL != deferred.clip_ptr) wlmaker_clip_destroy(deferred.clip_ptr);
+    if (NULL != deferred.dock_ptr) wlmaker_dock_destroy(deferred.dock_ptr);
+    if (NULL != server_ptr->state_writer_ptr) {
+        wlmaker_state_writer_destroy(server_ptr->state_writer_ptr);
+        server_ptr->state_writer_ptr = NULL;
+    }
+    if (NULL != reload.idle_event_source_ptr) {
+        wl_event_source_remove(reload.idle_event_source_ptr);
+    }
+    if (NULL != reload.sighup_event_source_ptr) {
+        wl_event_source_remove(reload.sighup_event_source_ptr);
+    }
+    wlmtk_util_disconnect_listener(&reload.reload_listener);
+    wlmaker_action_unbind_keys(reload.action_handle_ptr);
     bspl_array_unref(server_ptr->root_menu_array_ptr);
     wlmaker_server_destroy(server_ptr);
-
-    bs_subprocess_t *sp_ptr;
-    while (NULL != (sp_ptr = bs_ptr_stack_pop(&wlmaker_subprocess_stack))) {
-        bs_subprocess_destroy(sp_ptr);
-    }
-    bs_ptr_stack_fini(&wlmaker_subprocess_stack);
+    // Frees what remains cached, so none of it shows as leaked.
+    wlmtk_cache_evict(100);
 
     bspl_dict_unref(config_dict_ptr);
     bspl_dict_unref(state_dict_ptr);
+    if (NULL != wlmaker_arg_config_file_ptr) free(wlmaker_arg_config_file_ptr);
     regfree(&wlmaker_wlr_log_regex);
+    if (NULL != wlmaker_arg_startup_trace_file_ptr) {
+        free(wlmaker_arg_startup_trace_file_ptr);
+    }
+    wlmaker_startup_profile_destroy(profile_ptr);
     return rv;
 }
 
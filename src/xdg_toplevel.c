@@ -30,14 +30,18 @@
 #include <wayland-util.h>
 #define WLR_USE_UNSTABLE
 #include <wlr/types/wlr_compositor.h>
+#include <wlr/types/wlr_cursor.h>
 #include <wlr/util/box.h>
 #include <wlr/version.h>
 #undef WLR_USE_UNSTABLE
 
 #include "config.h"
+#include "cursor.h"
 #include "server.h"
+#include "subprocess_monitor.h"
 #include "tl_menu.h"
 #include "toolkit/toolkit.h"
+#include "window_rules.h"
 #include "xdg_popup.h"
 
 /* == Declarations ========================================================= */
@@ -154,6 +158,9 @@ static void content_request_close(
 static void content_set_activated(
     wlmtk_content_t *content_ptr,
     bool activated);
+static bool _xdg_toplevel_settled(
+    xdg_toplevel_surface_t *xdg_tl_surface_ptr,
+    uint32_t *serial_ptr);
 
 /* == Data ================================================================= */
 
@@ -246,6 +253,7 @@ xdg_toplevel_surface_t *xdg_toplevel_surface_create(
         &xdg_tl_surface_ptr->super_content.client.pid,
         &xdg_tl_surface_ptr->super_content.client.uid,
         &xdg_tl_surface_ptr->super_content.client.gid);
+    wlmtk_util_client_resolve(&xdg_tl_surface_ptr->super_content.client);
 
     wlmtk_util_connect_listener_signal(
 #if WLR_VERSION_NUM >= (18 << 8)
@@ -352,6 +360,11 @@ uint32_t content_request_maximized(
     xdg_toplevel_surface_t *xdg_tl_surface_ptr = BS_CONTAINER_OF(
         content_ptr, xdg_toplevel_surface_t, super_content);
 
+    uint32_t serial;
+    if (xdg_tl_surface_ptr->wlr_xdg_toplevel_ptr->current.maximized ==
+        maximized &&
+        _xdg_toplevel_settled(xdg_tl_surface_ptr, &serial)) return serial;
+
     return wlr_xdg_toplevel_set_maximized(
         xdg_tl_surface_ptr->wlr_xdg_toplevel_ptr, maximized);
 }
@@ -365,6 +378,11 @@ uint32_t content_request_fullscreen(
     xdg_toplevel_surface_t *xdg_tl_surface_ptr = BS_CONTAINER_OF(
         content_ptr, xdg_toplevel_surface_t, super_content);
 
+    uint32_t serial;
+    if (xdg_tl_surface_ptr->wlr_xdg_toplevel_ptr->current.fullscreen ==
+        fullscreen &&
+        _xdg_toplevel_settled(xdg_tl_surface_ptr, &serial)) return serial;
+
     return wlr_xdg_toplevel_set_fullscreen(
         xdg_tl_surface_ptr->wlr_xdg_toplevel_ptr, fullscreen);
 }
@@ -387,6 +405,23 @@ uint32_t content_request_size(
     xdg_toplevel_surface_t *xdg_tl_surface_ptr = BS_CONTAINER_OF(
         content_ptr, xdg_toplevel_surface_t, super_content);
 
+    uint32_t serial;
+    struct wlr_xdg_toplevel_state *current_ptr =
+        &xdg_tl_surface_ptr->wlr_xdg_toplevel_ptr->current;
+    if (current_ptr->width == width && current_ptr->height == height &&
+        _xdg_toplevel_settled(xdg_tl_surface_ptr, &serial)) {
+        // Nothing to wait for: Replays the commit, for the window to apply
+        // the update right away.
+        struct wlr_box *geometry_ptr =
+            &xdg_tl_surface_ptr->wlr_xdg_toplevel_ptr->base->current.geometry;
+        // It repeats the last commit: Must not be skipped as unchanged.
+        xdg_tl_surface_ptr->super_content.has_committed = false;
+        wlmtk_content_commit(
+            &xdg_tl_surface_ptr->super_content,
+            geometry_ptr->width, geometry_ptr->height, serial);
+        return serial;
+    }
+
     return wlr_xdg_toplevel_set_size(
         xdg_tl_surface_ptr->wlr_xdg_toplevel_ptr, width, height);
 }
@@ -420,12 +455,46 @@ void content_set_activated(
     xdg_toplevel_surface_t *xdg_tl_surface_ptr = BS_CONTAINER_OF(
         content_ptr, xdg_toplevel_surface_t, super_content);
 
-    wlr_xdg_toplevel_set_activated(
-        xdg_tl_surface_ptr->wlr_xdg_toplevel_ptr, activated);
+    // Skip if already scheduled (or sent): Each call would schedule another
+    // configure, eg. on each click into an already-activated window.
+    if (xdg_tl_surface_ptr->wlr_xdg_toplevel_ptr->scheduled.activated !=
+        activated) {
+        wlr_xdg_toplevel_set_activated(
+            xdg_tl_surface_ptr->wlr_xdg_toplevel_ptr, activated);
+    }
 
     wlmtk_surface_set_activated(xdg_tl_surface_ptr->surface_ptr, activated);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Checks whether the toplevel is settled: It acknowledged the most recent
+ * configure, and no further configure is scheduled. A request for a state
+ * the toplevel already has is then redundant, and is not sent.
+ *
+ * Requests within the same event loop iteration do not need this: wlroots
+ * sends the scheduled configure once idle, and returns the same serial.
+ *
+ * @param xdg_tl_surface_ptr
+ * @param serial_ptr          Set to the serial of the acknowledged
+ *                            configure, if settled.
+ *
+ * @return Whether the toplevel is settled.
+ */
+bool _xdg_toplevel_settled(
+    xdg_toplevel_surface_t *xdg_tl_surface_ptr,
+    uint32_t *serial_ptr)
+{
+    struct wlr_xdg_surface *wlr_xdg_surface_ptr =
+        xdg_tl_surface_ptr->wlr_xdg_toplevel_ptr->base;
+    if (!wlr_xdg_surface_ptr->initialized ||
+        NULL != wlr_xdg_surface_ptr->configure_idle ||
+        !wl_list_empty(&wlr_xdg_surface_ptr->configure_list)) return false;
+
+    *serial_ptr = wlr_xdg_surface_ptr->current.configure_serial;
+    return true;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Handler for the `destroy` signal of the `wlr_xdg_surface::events`.
@@ -496,7 +565,8 @@ void handle_new_popup(
  * Handler for the `map` signal.
  *
  * Issued when the XDG toplevel is fully configured and ready to be shown.
- * Will add it to the current workspace.
+ * Will add it to the workspace as per the window rules, unless the
+ * subprocess monitor holds it back.
  *
  * @param listener_ptr
  * @param data_ptr
@@ -508,13 +578,19 @@ void handle_surface_map(
     xdg_toplevel_surface_t *xdg_tl_surface_ptr = BS_CONTAINER_OF(
         listener_ptr, xdg_toplevel_surface_t, surface_map_listener);
 
-    wlmtk_workspace_t *workspace_ptr =
-        wlmtk_root_get_current_workspace(
-            xdg_tl_surface_ptr->server_ptr->root_ptr);
-
-    wlmtk_workspace_map_window(
-        workspace_ptr,
-        xdg_tl_surface_ptr->super_content.window_ptr);
+    wlmtk_window_t *window_ptr = xdg_tl_surface_ptr->super_content.window_ptr;
+    if (NULL != xdg_tl_surface_ptr->server_ptr->monitor_ptr &&
+        wlmaker_subprocess_monitor_hold_window(
+            xdg_tl_surface_ptr->server_ptr->monitor_ptr, window_ptr)) return;
+
+    struct wlr_cursor *wlr_cursor_ptr =
+        xdg_tl_surface_ptr->server_ptr->cursor_ptr->wlr_cursor_ptr;
+    wlmaker_window_rules_map_window(
+        xdg_tl_surface_ptr->server_ptr->window_rules_ptr,
+        xdg_tl_surface_ptr->server_ptr->root_ptr,
+        window_ptr,
+        xdg_tl_surface_ptr->wlr_xdg_toplevel_ptr->app_id,
+        wlr_cursor_ptr->x, wlr_cursor_ptr->y);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -532,6 +608,9 @@ void handle_surface_unmap(
         listener_ptr, xdg_toplevel_surface_t, surface_unmap_listener);
 
     wlmtk_window_t *window_ptr = xdg_tl_surface_ptr->super_content.window_ptr;
+    if (NULL != xdg_tl_surface_ptr->server_ptr->monitor_ptr &&
+        wlmaker_subprocess_monitor_unhold_window(
+            xdg_tl_surface_ptr->server_ptr->monitor_ptr, window_ptr)) return;
     wlmtk_workspace_unmap_window(
         wlmtk_window_get_workspace(window_ptr),
         window_ptr);
@@ -548,6 +627,7 @@ void handle_surface_commit(
     struct wl_listener *listener_ptr,
     __UNUSED__ void *data_ptr)
 {
+    WLMTK_TRACE_SPAN("xdg_toplevel_commit");
     xdg_toplevel_surface_t *xdg_tl_surface_ptr = BS_CONTAINER_OF(
         listener_ptr, xdg_toplevel_surface_t, surface_commit_listener);
 
@@ -566,6 +646,9 @@ void handle_surface_commit(
         xdg_tl_surface_ptr->wlr_xdg_toplevel_ptr->base->current.geometry.width,
         xdg_tl_surface_ptr->wlr_xdg_toplevel_ptr->base->current.geometry.height,
         xdg_tl_surface_ptr->wlr_xdg_toplevel_ptr->base->current.configure_serial);
+    wlmtk_content_set_opaque(
+        &xdg_tl_surface_ptr->super_content,
+        wlmtk_surface_is_opaque(xdg_tl_surface_ptr->surface_ptr));
 
     wlmtk_window_commit_maximized(
         xdg_tl_surface_ptr->super_content.window_ptr,
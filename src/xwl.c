@@ -70,6 +70,7 @@
 
 #if defined(WLMAKER_HAVE_XWAYLAND)
 #include <inttypes.h>
+#include <libbase/plist.h>
 #include <string.h>
 #include <wayland-server-core.h>
 #include <xcb/xcb.h>
@@ -91,6 +92,11 @@ struct _wlmaker_xwl_t {
 #if defined(WLMAKER_HAVE_XWAYLAND)
     /** XWayland server and XWM. */
     struct wlr_xwayland       *wlr_xwayland_ptr;
+    /**
+     * Whether to start the XWayland server only once the first X11 client
+     * connects. From the "XWayland" dict's `Lazy`.
+     */
+    bool                      lazy;
 
     /** Listener for the `ready` signal raised by `wlr_xwayland`. */
     struct wl_listener        ready_listener;
@@ -126,6 +132,12 @@ static const char *xwl_atom_name_map[XWL_MAX_ATOM_ID] = {
     [NET_WM_WINDOW_TYPE_NOTIFICATION] = "_NET_WM_WINDOW_TYPE_NOTIFICATION",
 };
 
+/** Descriptor for the "XWayland" dict of wlmaker.plist. */
+static const bspl_desc_t _wlmaker_xwl_desc[] = {
+    BSPL_DESC_BOOL("Lazy", false, wlmaker_xwl_t, lazy, lazy, true),
+    BSPL_DESC_SENTINEL(),
+};
+
 /* == Exported methods ===================================================== */
 
 #endif  // defined(WLMAKER_HAVE_XWAYLAND)
@@ -138,14 +150,27 @@ wlmaker_xwl_t *wlmaker_xwl_create(wlmaker_server_t *server_ptr)
     xwl_ptr->server_ptr = server_ptr;
 
 #if defined(WLMAKER_HAVE_XWAYLAND)
+    // Optional: Defaults to start XWayland on the first X11 connection. The
+    // socket is bound right away, so `DISPLAY` can be exported below.
+    xwl_ptr->lazy = true;
+    bspl_dict_t *dict_ptr = bspl_dict_get_dict(
+        server_ptr->config_dict_ptr, "XWayland");
+    if (NULL != dict_ptr &&
+        !bspl_decode_dict(dict_ptr, _wlmaker_xwl_desc, xwl_ptr)) {
+        bs_log(BS_ERROR, "Failed to decode \"XWayland\" dict");
+        wlmaker_xwl_destroy(xwl_ptr);
+        return NULL;
+    }
+
     xwl_ptr->wlr_xwayland_ptr = wlr_xwayland_create(
         server_ptr->wl_display_ptr,
         wlmbe_backend_compositor(server_ptr->backend_ptr),
-        false);
+        xwl_ptr->lazy);
     if (NULL == xwl_ptr->wlr_xwayland_ptr) {
-        bs_log(BS_ERROR, "Failed wlr_xwayland_create(%p, %p, false).",
+        bs_log(BS_ERROR, "Failed wlr_xwayland_create(%p, %p, %d).",
                server_ptr->wl_display_ptr,
-               wlmbe_backend_compositor(server_ptr->backend_ptr));
+               wlmbe_backend_compositor(server_ptr->backend_ptr),
+               xwl_ptr->lazy);
         wlmaker_xwl_destroy(xwl_ptr);
         return NULL;
     }
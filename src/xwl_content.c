@@ -56,6 +56,12 @@ struct _wlmaker_xwl_content_t {
 
     /** A fake configure serial, tracked here. */
     uint32_t                  serial;
+    /** Whether @ref wlmtk_content_commit was called since associating. */
+    bool                      committed;
+    /** The serial passed to the last @ref wlmtk_content_commit. */
+    uint32_t                  committed_serial;
+    /** The window the content was in, at the last commit. */
+    wlmtk_window_t            *committed_window_ptr;
 
     /** Listener for the `destroy` signal of `wlr_xwayland_surface`. */
     struct wl_listener        destroy_listener;
@@ -86,6 +92,15 @@ struct _wlmaker_xwl_content_t {
 
     /** Listener for `surface_commit` of the `wlr_surface`. */
     struct wl_listener        surface_commit_listener;
+
+    /** Idle source for applying the coalesced geometry requests. */
+    struct wl_event_source    *geometry_idle_ptr;
+    /** Whether a `set_geometry` is pending to be applied. */
+    bool                      geometry_pending;
+    /** Whether a `request_configure` is pending to be ACKed. */
+    bool                      configure_pending;
+    /** The latest pending configure event, if `configure_pending`. */
+    struct wlr_xwayland_surface_configure_event pending_configure;
 };
 
 static void _xwl_content_handle_destroy(
@@ -137,6 +152,11 @@ static void _xwl_content_content_set_activated(
 
 static void _xwl_content_apply_decorations(
     wlmaker_xwl_content_t *xwl_content_ptr);
+static void _xwl_content_schedule_geometry(
+    wlmaker_xwl_content_t *xwl_content_ptr);
+static void _xwl_content_flush_geometry(
+    wlmaker_xwl_content_t *xwl_content_ptr);
+static void _xwl_content_handle_geometry_idle(void *data_ptr);
 static void _xwl_content_adjust_absolute_pos(
     wlmtk_content_t *content_ptr, int *x_ptr, int *y_ptr);
 
@@ -219,6 +239,12 @@ void wlmaker_xwl_content_destroy(wlmaker_xwl_content_t *xwl_content_ptr)
 {
     bs_log(BS_INFO, "Destroy XWL content %p", xwl_content_ptr);
 
+    // Pending geometry requests are dropped: The surface is going away.
+    if (NULL != xwl_content_ptr->geometry_idle_ptr) {
+        wl_event_source_remove(xwl_content_ptr->geometry_idle_ptr);
+        xwl_content_ptr->geometry_idle_ptr = NULL;
+    }
+
     if (NULL != wlmtk_content_get_parent_content(&xwl_content_ptr->content)) {
         wlmtk_content_remove_popup(
             wlmtk_content_get_parent_content(&xwl_content_ptr->content),
@@ -264,6 +290,12 @@ wlmtk_surface_t *wlmtk_surface_from_xwl_content(
     return xwl_content_ptr->surface_ptr;
 }
 
+/* ------------------------------------------------------------------------- */
+const char *wlmaker_xwl_content_class(wlmaker_xwl_content_t *xwl_content_ptr)
+{
+    return xwl_content_ptr->wlr_xwayland_surface_ptr->class;
+}
+
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -308,11 +340,11 @@ void _xwl_content_handle_request_configure(
     // -> if we have content/surface: check what that means, with respect to
     //    the surface::commit handler.
 
-    // It appears this needs to be ACKed with a surface_configure.
-    wlr_xwayland_surface_configure(
-        xwl_content_ptr->wlr_xwayland_surface_ptr,
-        cfg_event_ptr->x, cfg_event_ptr->y,
-        cfg_event_ptr->width, cfg_event_ptr->height);
+    // It appears this needs to be ACKed with a surface_configure. Clients
+    // may send a burst of these: Only the latest is ACKed, once idle.
+    xwl_content_ptr->pending_configure = *cfg_event_ptr;
+    xwl_content_ptr->configure_pending = true;
+    _xwl_content_schedule_geometry(xwl_content_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -377,6 +409,7 @@ void _xwl_content_handle_associate(
     xwl_content_ptr->content.client = (wlmtk_util_client_t){};
     xwl_content_ptr->content.client.pid =
         xwl_content_ptr->wlr_xwayland_surface_ptr->pid;
+    wlmtk_util_client_resolve(&xwl_content_ptr->content.client);
 
     // Currently we treat parent-less windows AND modal windows as toplevel.
     // Modal windows should actually be child wlmtk_window_t, but that isn't
@@ -446,6 +479,7 @@ void _xwl_content_handle_dissociate(
         xwl_content_ptr->surface_ptr = NULL;
     }
     wl_list_remove(&xwl_content_ptr->surface_commit_listener.link);
+    xwl_content_ptr->committed = false;
 
     bs_log(BS_INFO, "Dissociate XWL content %p from wlr_surface %p",
            xwl_content_ptr, xwl_content_ptr->wlr_xwayland_surface_ptr->surface);
@@ -554,17 +588,9 @@ void _xwl_content_handle_set_geometry(
     wlmaker_xwl_content_t *xwl_content_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmaker_xwl_content_t, set_geometry_listener);
 
-    // For XWayland, the surface's position is given relative to the "root"
-    // of the specified windows. For @ref wlmtk_element_t, the position is
-    // just relative to the pareent @ref wlmtk_container_t. So we need to
-    // subtract each parent popup's position.
-    int x = xwl_content_ptr->wlr_xwayland_surface_ptr->x;
-    int y = xwl_content_ptr->wlr_xwayland_surface_ptr->y;
-    _xwl_content_adjust_absolute_pos(
-        xwl_content_ptr->content.parent_content_ptr, &x, &y);
-
-    wlmtk_element_set_position(
-        wlmtk_content_element(&xwl_content_ptr->content), x, y);
+    // Applied once idle, from the surface's latest position.
+    xwl_content_ptr->geometry_pending = true;
+    _xwl_content_schedule_geometry(xwl_content_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -573,19 +599,48 @@ void _xwl_content_handle_surface_commit(
     struct wl_listener *listener_ptr,
     __UNUSED__ void *data_ptr)
 {
+    WLMTK_TRACE_SPAN("xwl_content_commit");
     wlmaker_xwl_content_t *xwl_content_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmaker_xwl_content_t, surface_commit_listener);
 
-    bs_log(BS_DEBUG, "XWL content %p commit surface %p, current %d x %d",
-           xwl_content_ptr, xwl_content_ptr->wlr_xwayland_surface_ptr->surface,
-           xwl_content_ptr->wlr_xwayland_surface_ptr->surface->current.width,
-           xwl_content_ptr->wlr_xwayland_surface_ptr->surface->current.height);
+    struct wlr_surface *wlr_surface_ptr =
+        xwl_content_ptr->wlr_xwayland_surface_ptr->surface;
 
-    wlmtk_content_commit(
-        &xwl_content_ptr->content,
-        xwl_content_ptr->wlr_xwayland_surface_ptr->surface->current.width,
-        xwl_content_ptr->wlr_xwayland_surface_ptr->surface->current.height,
-        xwl_content_ptr->serial);
+    // Any commit may change the pixels.
+    if (NULL != xwl_content_ptr->content.window_ptr) {
+        wlmtk_window_invalidate_thumbnail(xwl_content_ptr->content.window_ptr);
+    }
+
+    // Fast path: Same size, and no configure since the last commit. There
+    // is nothing for the toolkit to process. Frequent for games & videos.
+    if (!xwl_content_ptr->committed ||
+        xwl_content_ptr->committed_serial != xwl_content_ptr->serial ||
+        xwl_content_ptr->committed_window_ptr !=
+        xwl_content_ptr->content.window_ptr ||
+        xwl_content_ptr->content.committed_width !=
+        wlr_surface_ptr->current.width ||
+        xwl_content_ptr->content.committed_height !=
+        wlr_surface_ptr->current.height) {
+        WLMTK_LOG_DEBUG("XWL content %p commit surface %p, current %d x %d",
+                        xwl_content_ptr, wlr_surface_ptr,
+                        wlr_surface_ptr->current.width,
+                        wlr_surface_ptr->current.height);
+
+        wlmtk_content_commit(
+            &xwl_content_ptr->content,
+            wlr_surface_ptr->current.width,
+            wlr_surface_ptr->current.height,
+            xwl_content_ptr->serial);
+        xwl_content_ptr->committed = true;
+        xwl_content_ptr->committed_serial = xwl_content_ptr->serial;
+        xwl_content_ptr->committed_window_ptr =
+            xwl_content_ptr->content.window_ptr;
+    }
+    if (NULL != xwl_content_ptr->surface_ptr) {
+        wlmtk_content_set_opaque(
+            &xwl_content_ptr->content,
+            wlmtk_surface_is_opaque(xwl_content_ptr->surface_ptr));
+    }
 }
 
 /* ------------------------------------------------------------------------- */
@@ -693,6 +748,91 @@ void _xwl_content_apply_decorations(wlmaker_xwl_content_t *xwl_content_ptr)
     }
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Schedules applying the pending geometry requests once the event loop is
+ * idle. That coalesces bursts of `request_configure` and `set_geometry`, as
+ * sent by some X11 toolkits, into a single configure and reposition.
+ *
+ * Applies right away if there is no event loop, or on failure.
+ *
+ * @param xwl_content_ptr
+ */
+void _xwl_content_schedule_geometry(wlmaker_xwl_content_t *xwl_content_ptr)
+{
+    if (NULL != xwl_content_ptr->geometry_idle_ptr) return;
+
+    if (NULL != xwl_content_ptr->server_ptr->wl_display_ptr) {
+        xwl_content_ptr->geometry_idle_ptr = wl_event_loop_add_idle(
+            wl_display_get_event_loop(
+                xwl_content_ptr->server_ptr->wl_display_ptr),
+            _xwl_content_handle_geometry_idle,
+            xwl_content_ptr);
+        if (NULL != xwl_content_ptr->geometry_idle_ptr) return;
+        bs_log(BS_WARNING, "Failed wl_event_loop_add_idle(), applying now");
+    }
+    _xwl_content_flush_geometry(xwl_content_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Applies the pending geometry requests: ACKs the latest configure request,
+ * and positions the content at the surface's latest position.
+ *
+ * @param xwl_content_ptr
+ */
+void _xwl_content_flush_geometry(wlmaker_xwl_content_t *xwl_content_ptr)
+{
+    if (NULL != xwl_content_ptr->geometry_idle_ptr) {
+        wl_event_source_remove(xwl_content_ptr->geometry_idle_ptr);
+        xwl_content_ptr->geometry_idle_ptr = NULL;
+    }
+
+    if (xwl_content_ptr->configure_pending) {
+        xwl_content_ptr->configure_pending = false;
+        struct wlr_xwayland_surface_configure_event *cfg_event_ptr =
+            &xwl_content_ptr->pending_configure;
+        wlr_xwayland_surface_configure(
+            xwl_content_ptr->wlr_xwayland_surface_ptr,
+            cfg_event_ptr->x, cfg_event_ptr->y,
+            cfg_event_ptr->width, cfg_event_ptr->height);
+    }
+
+    if (xwl_content_ptr->geometry_pending) {
+        xwl_content_ptr->geometry_pending = false;
+
+        // The parent's position must be current, so apply its first.
+        wlmtk_content_t *parent_content_ptr =
+            xwl_content_ptr->content.parent_content_ptr;
+        if (NULL != parent_content_ptr) {
+            _xwl_content_flush_geometry(BS_CONTAINER_OF(
+                parent_content_ptr, wlmaker_xwl_content_t, content));
+        }
+
+        // For XWayland, the surface's position is given relative to the
+        // "root" of the specified windows. For @ref wlmtk_element_t, the
+        // position is just relative to the pareent @ref wlmtk_container_t.
+        // So we need to subtract each parent popup's position.
+        int x = xwl_content_ptr->wlr_xwayland_surface_ptr->x;
+        int y = xwl_content_ptr->wlr_xwayland_surface_ptr->y;
+        _xwl_content_adjust_absolute_pos(
+            xwl_content_ptr->content.parent_content_ptr, &x, &y);
+
+        wlmtk_element_set_position(
+            wlmtk_content_element(&xwl_content_ptr->content), x, y);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Idle callback: Applies the pending geometry requests. */
+void _xwl_content_handle_geometry_idle(void *data_ptr)
+{
+    wlmaker_xwl_content_t *xwl_content_ptr = data_ptr;
+    // The idle source is destroyed after dispatching.
+    xwl_content_ptr->geometry_idle_ptr = NULL;
+    _xwl_content_flush_geometry(xwl_content_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Adjusts the absolute position by subtracting each parent's position.
@@ -719,6 +859,7 @@ static void _xwl_content_adjust_absolute_pos(
 
 static void test_create_destroy(bs_test_t *test_ptr);
 static void test_nested(bs_test_t *test_ptr);
+static void test_coalesce_geometry(bs_test_t *test_ptr);
 
 static void fake_init_wlr_xwayland_surface(
     struct wlr_xwayland_surface* wlr_xwayland_surface_ptr);
@@ -726,6 +867,7 @@ static void fake_init_wlr_xwayland_surface(
 const bs_test_case_t wlmaker_xwl_content_test_cases[] = {
     { 1, "create_destroy", test_create_destroy },
     { 1, "nested", test_nested },
+    { 1, "coalesce_geometry", test_coalesce_geometry },
     { 0, NULL, NULL },
 };
 
@@ -808,6 +950,45 @@ void test_nested(bs_test_t *test_ptr)
     wlmaker_xwl_content_destroy(content0_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests that `set_geometry` bursts are applied once, when idle. */
+void test_coalesce_geometry(bs_test_t *test_ptr)
+{
+    wlmaker_server_t server = { .wl_display_ptr = wl_display_create() };
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, server.wl_display_ptr);
+    struct wl_event_loop *wl_event_loop_ptr = wl_display_get_event_loop(
+        server.wl_display_ptr);
+
+    struct wlr_xwayland_surface surface;
+    fake_init_wlr_xwayland_surface(&surface);
+    wlmaker_xwl_content_t *content_ptr = wlmaker_xwl_content_create(
+        &surface, NULL, &server);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, content_ptr);
+    wlmtk_element_t *element_ptr = wlmtk_content_element(
+        &content_ptr->content);
+
+    surface.x = 100;
+    surface.y = 10;
+    wl_signal_emit_mutable(&surface.events.set_geometry, NULL);
+    surface.x = 200;
+    surface.y = 20;
+    wl_signal_emit_mutable(&surface.events.set_geometry, NULL);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, element_ptr->x);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, element_ptr->y);
+
+    wl_event_loop_dispatch_idle(wl_event_loop_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 200, element_ptr->x);
+    BS_TEST_VERIFY_EQ(test_ptr, 20, element_ptr->y);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, content_ptr->geometry_idle_ptr);
+
+    // A pending request is dropped on destroy.
+    wl_signal_emit_mutable(&surface.events.set_geometry, NULL);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, content_ptr->geometry_idle_ptr);
+    wlmaker_xwl_content_destroy(content_ptr);
+    wl_event_loop_dispatch_idle(wl_event_loop_ptr);
+    wl_display_destroy(server.wl_display_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Fake-initializes the `wlr_xwayland_surface_ptr`. */
 void fake_init_wlr_xwayland_surface(
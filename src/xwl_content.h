@@ -65,6 +65,8 @@ wlmtk_content_t *wlmtk_content_from_xwl_content(
 /** Gets the @ref wlmtk_surface_t. Only valid if associated. */
 wlmtk_surface_t *wlmtk_surface_from_xwl_content(
     wlmaker_xwl_content_t *xwl_content_ptr);
+/** @return The X11 window class of the XWL content, or NULL. */
+const char *wlmaker_xwl_content_class(wlmaker_xwl_content_t *xwl_content_ptr);
 
 /** Unit tests for XWL content. */
 extern const bs_test_case_t wlmaker_xwl_content_test_cases[];
@@ -25,9 +25,14 @@
 #include <stdlib.h>
 #include <wayland-server-core.h>
 #include <wayland-util.h>
+#define WLR_USE_UNSTABLE
+#include <wlr/types/wlr_cursor.h>
+#undef WLR_USE_UNSTABLE
 
 #include "config.h"
+#include "cursor.h"
 #include "tl_menu.h"
+#include "window_rules.h"
 
 /* == Declarations ========================================================= */
 
@@ -38,6 +43,8 @@ struct _wlmaker_xwl_toplevel_t {
 
     /** Back-link to server. */
     wlmaker_server_t          *server_ptr;
+    /** The XWayland content of this toplevel. */
+    wlmaker_xwl_content_t     *content_ptr;
 
     /** The toplevel's window menu. */
     wlmaker_tl_menu_t         *tl_menu_ptr;
@@ -66,6 +73,7 @@ wlmaker_xwl_toplevel_t *wlmaker_xwl_toplevel_create(
         1, sizeof(wlmaker_xwl_toplevel_t));
     if (NULL == xwl_toplevel_ptr) return NULL;
     xwl_toplevel_ptr->server_ptr = server_ptr;
+    xwl_toplevel_ptr->content_ptr = content_ptr;
 
     xwl_toplevel_ptr->window_ptr = wlmtk_window_create(
         wlmtk_content_from_xwl_content(content_ptr),
@@ -104,6 +112,12 @@ wlmaker_xwl_toplevel_t *wlmaker_xwl_toplevel_create(
 void wlmaker_xwl_toplevel_destroy(
     wlmaker_xwl_toplevel_t *xwl_toplevel_ptr)
 {
+    // The menu's items live in the window's menu. Destroy it first.
+    if (NULL != xwl_toplevel_ptr->tl_menu_ptr) {
+        wlmaker_tl_menu_destroy(xwl_toplevel_ptr->tl_menu_ptr);
+        xwl_toplevel_ptr->tl_menu_ptr = NULL;
+    }
+
     if (NULL != xwl_toplevel_ptr->window_ptr) {
         wl_signal_emit(&xwl_toplevel_ptr->server_ptr->window_destroyed_event,
                        xwl_toplevel_ptr->window_ptr);
@@ -117,11 +131,6 @@ void wlmaker_xwl_toplevel_destroy(
     wl_list_remove(&xwl_toplevel_ptr->surface_unmap_listener.link);
     wl_list_remove(&xwl_toplevel_ptr->surface_map_listener.link);
 
-    if (NULL != xwl_toplevel_ptr->tl_menu_ptr) {
-        wlmaker_tl_menu_destroy(xwl_toplevel_ptr->tl_menu_ptr);
-        xwl_toplevel_ptr->tl_menu_ptr = NULL;
-    }
-
     free(xwl_toplevel_ptr);
 }
 
@@ -153,12 +162,14 @@ void _xwl_toplevel_handle_surface_map(
     wlmaker_xwl_toplevel_t *xwl_toplevel_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmaker_xwl_toplevel_t, surface_map_listener);
 
-    wlmtk_workspace_t *workspace_ptr =
-        wlmtk_root_get_current_workspace(
-            xwl_toplevel_ptr->server_ptr->root_ptr);
-
-    wlmtk_workspace_map_window(workspace_ptr, xwl_toplevel_ptr->window_ptr);
-    wlmtk_window_set_position(xwl_toplevel_ptr->window_ptr, 40, 30);
+    struct wlr_cursor *wlr_cursor_ptr =
+        xwl_toplevel_ptr->server_ptr->cursor_ptr->wlr_cursor_ptr;
+    wlmaker_window_rules_map_window(
+        xwl_toplevel_ptr->server_ptr->window_rules_ptr,
+        xwl_toplevel_ptr->server_ptr->root_ptr,
+        xwl_toplevel_ptr->window_ptr,
+        wlmaker_xwl_content_class(xwl_toplevel_ptr->content_ptr),
+        wlr_cursor_ptr->x, wlr_cursor_ptr->y);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -170,9 +181,11 @@ void _xwl_toplevel_handle_surface_unmap(
     wlmaker_xwl_toplevel_t *xwl_toplevel_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmaker_xwl_toplevel_t, surface_unmap_listener);
 
-    wlmtk_workspace_unmap_window(
-        wlmtk_window_get_workspace(xwl_toplevel_ptr->window_ptr),
+    // Not mapped, eg. when hidden by a launcher.
+    wlmtk_workspace_t *workspace_ptr = wlmtk_window_get_workspace(
         xwl_toplevel_ptr->window_ptr);
+    if (NULL == workspace_ptr) return;
+    wlmtk_workspace_unmap_window(workspace_ptr, xwl_toplevel_ptr->window_ptr);
 }
 
 #endif  // defined(WLMAKER_HAVE_XWAYLAND)
@@ -22,12 +22,16 @@
 #include <stddef.h>
 
 #include "backend/backend.h"
+#include "backend/magnifier.h"
 #include "backend/output_config.h"
+#include "backend/remote.h"
 
 /** Backend unit tests. */
 const bs_test_set_t backend_tests[] = {
     { 1, "backend", wlmbe_backend_test_cases },
+    { 1, "magnifier", wlmbe_magnifier_test_cases },
     { 1, "output_config", wlmbe_output_config_test_cases },
+    { 1, "remote", wlmbe_remote_test_cases },
     { 0, NULL, NULL }
 };
 
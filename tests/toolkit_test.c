@@ -25,29 +25,46 @@
 
 /** Toolkit unit tests. */
 const bs_test_set_t toolkit_tests[] = {
+    { 1, "alloctrack", wlmtk_alloctrack_test_cases },
+    { 1, "animation", wlmtk_animation_test_cases },
+    { 1, "arena", wlmtk_arena_test_cases },
     { 1, "bordered", wlmtk_bordered_test_cases },
     { 1, "box", wlmtk_box_test_cases },
+    { 1, "buffer", wlmtk_buffer_test_cases },
     { 1, "button", wlmtk_button_test_cases },
+    { 1, "cache", wlmtk_cache_test_cases },
     { 1, "container", wlmtk_container_test_cases },
     { 1, "content", wlmtk_content_test_cases },
     { 1, "dock", wlmtk_dock_test_cases },
     { 1, "element", wlmtk_element_test_cases },
     { 1, "fsm", wlmtk_fsm_test_cases },
+    { 1, "gfxbuf", wlmtk_gfxbuf_test_cases },
     { 1, "image", wlmtk_image_test_cases },
+    { 1, "latency", wlmtk_latency_test_cases },
     { 1, "layer", wlmtk_layer_test_cases },
+    { 1, "layout_epoch", wlmtk_layout_epoch_test_cases },
+    { 1, "memstat", wlmtk_memstat_test_cases },
     { 1, "menu", wlmtk_menu_test_cases },
     { 1, "menu_item", wlmtk_menu_item_test_cases },
     { 1, "pane", wlmtk_pane_test_cases },
     { 1, "panel", wlmtk_panel_test_cases },
+    { 1, "placement", wlmtk_placement_test_cases },
+    { 1, "pool", wlmtk_pool_test_cases },
+    { 1, "raster", wlmtk_raster_test_cases },
     { 1, "surface", wlmtk_surface_test_cases },
     { 1, "rectangle", wlmtk_rectangle_test_cases },
     { 1, "resizebar", wlmtk_resizebar_test_cases },
     { 1, "resizebar_area", wlmtk_resizebar_area_test_cases },
     { 1, "root", wlmtk_root_test_cases },
+    { 1, "style", wlmtk_style_test_cases },
+    { 1, "text", wlmtk_text_test_cases },
+    { 1, "thumbnail", wlmtk_thumbnail_test_cases },
     { 1, "tile", wlmtk_tile_test_cases },
     { 1, "titlebar", wlmtk_titlebar_test_cases },
     { 1, "titlebar_button", wlmtk_titlebar_button_test_cases },
     { 1, "titlebar_title", wlmtk_titlebar_title_test_cases },
+    { 1, "trace", wlmtk_trace_test_cases },
+    { 1, "transaction", wlmtk_transaction_test_cases },
     { 1, "util", wlmtk_util_test_cases },
     { 1, "window", wlmtk_window_test_cases },
     { 1, "workspace", wlmtk_workspace_test_cases },
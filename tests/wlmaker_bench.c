@@ -0,0 +1,538 @@
+/* ========================================================================= */
+/**
+ * @file wlmaker_bench.c
+ *
+ * Input-event throughput benchmark for the compositor. Creates a server on
+ * the wlroots headless backend, with one headless output and a workspace
+ * holding N fake windows. Then registers a synthetic `wlr_pointer` and a
+ * synthetic `wlr_keyboard` with the backend, and injects streams of motion,
+ * button and key events into them. Reports the CPU time spent per event as
+ * JSON on stdout, which covers the whole path from the device signal down to
+ * the toolkit, including the cursor's `position_updated` listeners (hot
+ * corner) and the idle monitor. These two are also reported in isolation.
+ *
+ * Events are injected as fast as possible, unless a rate is given: Then they
+ * are paced at that rate, with the event loop dispatching in between. That
+ * lets idle sources and timers fire as they would in a live session. For
+ * example, `wlmaker_bench 64 10000 1000` for a 1 kHz mouse over 64 windows.
+ *
+ * `debug_log` is the cost of one debug log statement in a hot path, while
+ * the log level is above DEBUG. It is zero when built with
+ * `config_LOG_MIN_LEVEL` above DEBUG, which is reported as `log_min_level`.
+ * Comparing `key` across both builds gives the overhead removed per event.
+ *
+ * Usage: wlmaker_bench [windows [events [rate_hz]]]
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <inttypes.h>
+#include <libbase/libbase.h>
+#include <libbase/plist.h>
+#include <linux/input-event-codes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <wayland-server-core.h>
+
+#define WLR_USE_UNSTABLE
+#include <wlr/backend.h>
+#include <wlr/backend/headless.h>
+#include <wlr/backend/multi.h>
+#include <wlr/interfaces/wlr_keyboard.h>
+#include <wlr/interfaces/wlr_pointer.h>
+#include <wlr/types/wlr_cursor.h>
+#include <wlr/types/wlr_keyboard.h>
+#include <wlr/types/wlr_pointer.h>
+#include <wlr/util/box.h>
+#include <wlr/util/log.h>
+#undef WLR_USE_UNSTABLE
+
+#include "action.h"
+#include "backend/backend.h"
+#include "config.h"
+#include "cursor.h"
+#include "idle.h"
+#include "server.h"
+#include "toolkit/toolkit.h"
+
+/* == Declarations ========================================================= */
+
+/** The compositor under benchmark. */
+typedef struct {
+    /** The server, on the headless backend. */
+    wlmaker_server_t          *server_ptr;
+    /** Configuration the server was created from. */
+    bspl_dict_t               *config_dict_ptr;
+    /** Key bindings, as configured. */
+    wlmaker_action_handle_t   *action_handle_ptr;
+    /** The workspace holding the windows. */
+    wlmtk_workspace_t         *workspace_ptr;
+    /** Number of windows. */
+    size_t                    windows;
+    /** The windows. */
+    wlmtk_fake_window_t       **fake_window_ptrs;
+
+    /** Synthetic pointer device. */
+    struct wlr_pointer        wlr_pointer;
+    /** Synthetic keyboard device. */
+    struct wlr_keyboard       wlr_keyboard;
+
+    /** Pacing: Events per second, or 0 for injecting as fast as possible. */
+    uint64_t                  rate_hz;
+} bench_server_t;
+
+/** Injects the i-th event of a stream. */
+typedef void (*bench_fn_t)(bench_server_t *server_ptr, size_t i);
+
+/** Descriptor of a benchmark. */
+typedef struct {
+    /** Name, as used for the key in the JSON output. */
+    const char                *name_ptr;
+    /** The operation. */
+    bench_fn_t                fn;
+} bench_t;
+
+static bool bench_server_init(
+    bench_server_t *bench_server_ptr,
+    size_t windows,
+    uint64_t rate_hz);
+static void bench_server_fini(bench_server_t *bench_server_ptr);
+static void bench_add_headless_output(
+    struct wlr_backend *wlr_backend_ptr,
+    void *data_ptr);
+static double bench_run(
+    bench_server_t *bench_server_ptr,
+    const bench_t *bench_ptr,
+    size_t events);
+static void bench_dispatch_until(
+    bench_server_t *bench_server_ptr,
+    uint64_t deadline_nsec);
+static uint64_t bench_nsec(void);
+static uint64_t bench_cpu_nsec(void);
+
+static void bench_pointer_motion(bench_server_t *bench_server_ptr, size_t i);
+static void bench_pointer_button(bench_server_t *bench_server_ptr, size_t i);
+static void bench_key(bench_server_t *bench_server_ptr, size_t i);
+static void bench_position_updated(
+    bench_server_t *bench_server_ptr,
+    size_t i);
+static void bench_idle_reset(bench_server_t *bench_server_ptr, size_t i);
+static void bench_debug_log(bench_server_t *bench_server_ptr, size_t i);
+
+/* == Data ================================================================= */
+
+/** Dimensions of the headless output. */
+static const struct wlr_box bench_output_box = {
+    .width = 1920, .height = 1080
+};
+/** Width of a window, in pixels. */
+static const int bench_window_width = 200;
+/** Height of a window, in pixels. */
+static const int bench_window_height = 150;
+/** Number of windows per row, when arranging them. */
+static const size_t bench_columns = 8;
+
+/** Startup options: Fixed output size, no XWayland. */
+static const wlmaker_server_options_t bench_server_options = {
+    .start_xwayland = false,
+    .width = 1920,
+    .height = 1080,
+};
+
+/** Synthetic pointer. */
+static const struct wlr_pointer_impl bench_pointer_impl = {
+    .name = "wlmaker-bench-pointer"
+};
+/** Synthetic keyboard. */
+static const struct wlr_keyboard_impl bench_keyboard_impl = {
+    .name = "wlmaker-bench-keyboard"
+};
+
+/** The benchmarks to run. */
+static const bench_t bench_set[] = {
+    { "pointer_motion", bench_pointer_motion },
+    { "pointer_button", bench_pointer_button },
+    { "key", bench_key },
+    { "position_updated", bench_position_updated },
+    { "idle_reset", bench_idle_reset },
+    { "debug_log", bench_debug_log },
+    { NULL, NULL }
+};
+
+/* == Main program ========================================================= */
+
+/** Main program: Runs all benchmarks, prints results as JSON. */
+int main(int argc, const char **argv)
+{
+    size_t windows = 1 < argc ? strtoul(argv[1], NULL, 10) : 64;
+    size_t events = 2 < argc ? strtoul(argv[2], NULL, 10) : 10000;
+    uint64_t rate_hz = 3 < argc ? strtoull(argv[3], NULL, 10) : 0;
+    if (0 == events) {
+        fprintf(stderr, "Usage: %s [windows [events [rate_hz]]]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The server's log output would dominate the measurement.
+    wlr_log_init(WLR_ERROR, NULL);
+    bs_log_severity = BS_WARNING;
+
+    bench_server_t bench_server;
+    if (!bench_server_init(&bench_server, windows, rate_hz)) {
+        bs_log(BS_ERROR, "Failed bench_server_init(%p, %zu, %"PRIu64")",
+               &bench_server, windows, rate_hz);
+        bench_server_fini(&bench_server);
+        return EXIT_FAILURE;
+    }
+
+    printf("{\n  \"windows\": %zu,\n  \"events\": %zu,\n"
+           "  \"rate_hz\": %"PRIu64",\n  \"log_min_level\": %d,\n"
+           "  \"cpu_ns_per_event\": {",
+           windows, events, rate_hz, WLMTK_LOG_MIN_LEVEL);
+    for (const bench_t *bench_ptr = &bench_set[0];
+         NULL != bench_ptr->name_ptr;
+         ++bench_ptr) {
+        printf("%s\n    \"%s\": %.1f",
+               bench_ptr == &bench_set[0] ? "" : ",",
+               bench_ptr->name_ptr,
+               bench_run(&bench_server, bench_ptr, events));
+    }
+    printf("\n  }\n}\n");
+
+    bench_server_fini(&bench_server);
+    return EXIT_SUCCESS;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates the server on a headless backend, with one output, a workspace of
+ * `windows` fake windows, and the synthetic input devices.
+ *
+ * @param bench_server_ptr
+ * @param windows
+ * @param rate_hz
+ *
+ * @return true on success. On failure, bench_server_fini() must be called.
+ */
+bool bench_server_init(
+    bench_server_t *bench_server_ptr,
+    size_t windows,
+    uint64_t rate_hz)
+{
+    *bench_server_ptr = (bench_server_t){
+        .windows = windows,
+        .rate_hz = rate_hz
+    };
+
+    // Permit overriding, eg. for benchmarking with a GPU renderer.
+    setenv("WLR_BACKENDS", "headless", false);
+    setenv("WLR_RENDERER", "pixman", false);
+    setenv("WLR_LIBINPUT_NO_DEVICES", "1", false);
+
+    bench_server_ptr->config_dict_ptr = wlmaker_config_load(NULL);
+    if (NULL == bench_server_ptr->config_dict_ptr) return false;
+    bench_server_ptr->server_ptr = wlmaker_server_create(
+        bench_server_ptr->config_dict_ptr, &bench_server_options);
+    if (NULL == bench_server_ptr->server_ptr) return false;
+    wlmaker_server_t *server_ptr = bench_server_ptr->server_ptr;
+
+    bench_server_ptr->action_handle_ptr = wlmaker_action_bind_keys(
+        server_ptr,
+        bspl_dict_get_dict(bench_server_ptr->config_dict_ptr,
+                           wlmaker_action_config_dict_key));
+    if (NULL == bench_server_ptr->action_handle_ptr) return false;
+
+    static const wlmtk_tile_style_t tile_style = {};
+    bench_server_ptr->workspace_ptr = wlmtk_workspace_create(
+        server_ptr->wlr_output_layout_ptr, "Bench", &tile_style);
+    if (NULL == bench_server_ptr->workspace_ptr) return false;
+    wlmtk_root_add_workspace(
+        server_ptr->root_ptr, bench_server_ptr->workspace_ptr);
+
+    struct wlr_backend *wlr_backend_ptr = wlmbe_backend_wlr(
+        server_ptr->backend_ptr);
+    if (!wlr_backend_start(wlr_backend_ptr)) return false;
+    wlr_multi_for_each_backend(
+        wlr_backend_ptr, bench_add_headless_output, NULL);
+    wl_event_loop_dispatch(
+        wl_display_get_event_loop(server_ptr->wl_display_ptr), 0);
+    if (0 >= wlmbe_num_outputs(server_ptr->wlr_output_layout_ptr)) {
+        bs_log(BS_ERROR, "No headless output. Is WLR_BACKENDS overridden?");
+        return false;
+    }
+
+    bench_server_ptr->fake_window_ptrs = logged_calloc(
+        windows, sizeof(wlmtk_fake_window_t*));
+    if (0 < windows && NULL == bench_server_ptr->fake_window_ptrs) {
+        return false;
+    }
+    for (size_t w = 0; w < windows; ++w) {
+        wlmtk_fake_window_t *fw_ptr = wlmtk_fake_window_create();
+        if (NULL == fw_ptr) return false;
+        bench_server_ptr->fake_window_ptrs[w] = fw_ptr;
+        wlmtk_fake_surface_commit_size(
+            fw_ptr->fake_surface_ptr,
+            bench_window_width, bench_window_height);
+        wlmtk_workspace_map_window(
+            bench_server_ptr->workspace_ptr, fw_ptr->window_ptr);
+        // Overlapping grid. Wraps around once it fills the output.
+        wlmtk_window_set_position(
+            fw_ptr->window_ptr,
+            ((w % bench_columns) * bench_window_width * 3 / 4) %
+            bench_output_box.width,
+            ((w / bench_columns) * bench_window_height * 3 / 4) %
+            bench_output_box.height);
+    }
+
+    // Registers the devices, as if libinput had discovered them.
+    wlr_pointer_init(&bench_server_ptr->wlr_pointer, &bench_pointer_impl,
+                     bench_pointer_impl.name);
+    wl_signal_emit(&wlr_backend_ptr->events.new_input,
+                   &bench_server_ptr->wlr_pointer.base);
+    wlr_keyboard_init(&bench_server_ptr->wlr_keyboard, &bench_keyboard_impl,
+                      bench_keyboard_impl.name);
+    wl_signal_emit(&wlr_backend_ptr->events.new_input,
+                   &bench_server_ptr->wlr_keyboard.base);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys devices, windows and server. */
+void bench_server_fini(bench_server_t *bench_server_ptr)
+{
+    // Finalizing a device emits it's destroy signal, unregistering it.
+    if (NULL != bench_server_ptr->wlr_keyboard.impl) {
+        wlr_keyboard_finish(&bench_server_ptr->wlr_keyboard);
+    }
+    if (NULL != bench_server_ptr->wlr_pointer.impl) {
+        wlr_pointer_finish(&bench_server_ptr->wlr_pointer);
+    }
+
+    for (size_t w = 0;
+         NULL != bench_server_ptr->fake_window_ptrs &&
+             w < bench_server_ptr->windows;
+         ++w) {
+        wlmtk_fake_window_t *fw_ptr = bench_server_ptr->fake_window_ptrs[w];
+        if (NULL == fw_ptr) continue;
+        if (NULL != wlmtk_window_get_workspace(fw_ptr->window_ptr)) {
+            wlmtk_workspace_unmap_window(
+                bench_server_ptr->workspace_ptr, fw_ptr->window_ptr);
+        }
+        wlmtk_fake_window_destroy(fw_ptr);
+    }
+    if (NULL != bench_server_ptr->fake_window_ptrs) {
+        free(bench_server_ptr->fake_window_ptrs);
+        bench_server_ptr->fake_window_ptrs = NULL;
+    }
+
+    if (NULL != bench_server_ptr->action_handle_ptr) {
+        wlmaker_action_unbind_keys(bench_server_ptr->action_handle_ptr);
+        bench_server_ptr->action_handle_ptr = NULL;
+    }
+    // The server's root owns the workspace, and destroys it.
+    if (NULL != bench_server_ptr->server_ptr) {
+        wlmaker_server_destroy(bench_server_ptr->server_ptr);
+        bench_server_ptr->server_ptr = NULL;
+    }
+    if (NULL != bench_server_ptr->config_dict_ptr) {
+        bspl_dict_unref(bench_server_ptr->config_dict_ptr);
+        bench_server_ptr->config_dict_ptr = NULL;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Callback for `wlr_multi_for_each_backend`: Adds an output if headless. */
+void bench_add_headless_output(
+    struct wlr_backend *wlr_backend_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    if (!wlr_backend_is_headless(wlr_backend_ptr)) return;
+    wlr_headless_add_output(
+        wlr_backend_ptr,
+        bench_output_box.width,
+        bench_output_box.height);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Runs one benchmark: A warm-up round, then `events` measured injections.
+ *
+ * When paced, the event loop is dispatched until each event's deadline.
+ * Otherwise, it is dispatched without waiting after each event, so that
+ * deferred work (eg. coalesced motion) is accounted for. Sleeping in the
+ * event loop costs no CPU time, so the per-event figure is comparable.
+ *
+ * @param bench_server_ptr
+ * @param bench_ptr
+ * @param events
+ *
+ * @return CPU nanoseconds per event.
+ */
+double bench_run(
+    bench_server_t *bench_server_ptr,
+    const bench_t *bench_ptr,
+    size_t events)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_display_get_event_loop(
+        bench_server_ptr->server_ptr->wl_display_ptr);
+
+    for (size_t i = 0; i < BS_MIN(events, 100u); ++i) {
+        bench_ptr->fn(bench_server_ptr, i);
+        wl_event_loop_dispatch(wl_event_loop_ptr, 0);
+    }
+
+    uint64_t period_nsec = 0 < bench_server_ptr->rate_hz ?
+        1000000000u / bench_server_ptr->rate_hz : 0;
+    uint64_t next_nsec = bench_nsec();
+    uint64_t start_cpu_nsec = bench_cpu_nsec();
+    for (size_t i = 0; i < events; ++i) {
+        bench_ptr->fn(bench_server_ptr, i);
+        if (0 < period_nsec) {
+            next_nsec += period_nsec;
+            bench_dispatch_until(bench_server_ptr, next_nsec);
+        } else {
+            wl_event_loop_dispatch(wl_event_loop_ptr, 0);
+        }
+    }
+    uint64_t elapsed_cpu_nsec = bench_cpu_nsec() - start_cpu_nsec;
+    return (double)elapsed_cpu_nsec / (double)events;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Dispatches the server's event loop until `deadline_nsec` has passed. */
+void bench_dispatch_until(
+    bench_server_t *bench_server_ptr,
+    uint64_t deadline_nsec)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_display_get_event_loop(
+        bench_server_ptr->server_ptr->wl_display_ptr);
+    for (uint64_t now_nsec = bench_nsec();
+         now_nsec < deadline_nsec;
+         now_nsec = bench_nsec()) {
+        // Rounds up: Any remainder is spent in the next iteration.
+        int timeout_msec = (deadline_nsec - now_nsec + 999999u) / 1000000u;
+        wl_event_loop_dispatch(wl_event_loop_ptr, timeout_msec);
+    }
+    // Pending idle sources run on the next dispatch, without waiting.
+    wl_event_loop_dispatch(wl_event_loop_ptr, 0);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns a monotonic timestamp, in nanoseconds. */
+uint64_t bench_nsec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns the CPU time consumed by the process, in nanoseconds. */
+uint64_t bench_cpu_nsec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Moves the synthetic pointer back and forth diagonally across the output,
+ * so it crosses windows and, at the end of each sweep, the hot corners.
+ * Followed by a frame event, as libinput would send.
+ */
+void bench_pointer_motion(bench_server_t *bench_server_ptr, size_t i)
+{
+    struct wlr_pointer *wlr_pointer_ptr = &bench_server_ptr->wlr_pointer;
+    double d = (i / 256) & 1 ? -8.0 : 8.0;
+    struct wlr_pointer_motion_event e = {
+        .pointer = wlr_pointer_ptr,
+        .time_msec = i,
+        .delta_x = d,
+        .delta_y = d * 9 / 16,
+        .unaccel_dx = d,
+        .unaccel_dy = d * 9 / 16
+    };
+    wl_signal_emit(&wlr_pointer_ptr->events.motion, &e);
+    wl_signal_emit(&wlr_pointer_ptr->events.frame, wlr_pointer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Alternates right-button presses and releases, at the pointer position. */
+void bench_pointer_button(bench_server_t *bench_server_ptr, size_t i)
+{
+    struct wlr_pointer *wlr_pointer_ptr = &bench_server_ptr->wlr_pointer;
+    struct wlr_pointer_button_event e = {
+        .pointer = wlr_pointer_ptr,
+        .time_msec = i,
+        .button = BTN_RIGHT,
+        .state = (i & 1) ?
+        WL_POINTER_BUTTON_STATE_RELEASED : WL_POINTER_BUTTON_STATE_PRESSED
+    };
+    wl_signal_emit(&wlr_pointer_ptr->events.button, &e);
+    wl_signal_emit(&wlr_pointer_ptr->events.frame, wlr_pointer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Alternates presses and releases of letter keys. These are not bound, so
+ * they are looked up in the bindings and then forwarded to the seat.
+ */
+void bench_key(bench_server_t *bench_server_ptr, size_t i)
+{
+    static const uint32_t keycodes[] = { KEY_A, KEY_S, KEY_D, KEY_F };
+    struct wlr_keyboard_key_event e = {
+        .time_msec = i,
+        .keycode = keycodes[(i / 2) % (sizeof(keycodes) / sizeof(uint32_t))],
+        .update_state = true,
+        .state = (i & 1) ?
+        WL_KEYBOARD_KEY_STATE_RELEASED : WL_KEYBOARD_KEY_STATE_PRESSED
+    };
+    wlr_keyboard_notify_key(&bench_server_ptr->wlr_keyboard, &e);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * The listeners of @ref wlmaker_cursor_t::position_updated only, eg. the hot
+ * corner. Moves the position along the top edge, into the top-left corner.
+ */
+void bench_position_updated(bench_server_t *bench_server_ptr, size_t i)
+{
+    wlmaker_cursor_t *cursor_ptr = bench_server_ptr->server_ptr->cursor_ptr;
+    cursor_ptr->wlr_cursor_ptr->x = (double)(i % 64);
+    cursor_ptr->wlr_cursor_ptr->y = 0;
+    wl_signal_emit(&cursor_ptr->position_updated, cursor_ptr->wlr_cursor_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** The idle monitor's share of each input event. */
+void bench_idle_reset(bench_server_t *bench_server_ptr, __UNUSED__ size_t i)
+{
+    wlmaker_idle_monitor_reset(bench_server_ptr->server_ptr->idle_monitor_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** A debug log statement, as on the key path. Not logged: Level is above. */
+void bench_debug_log(bench_server_t *bench_server_ptr, size_t i)
+{
+    WLMTK_LOG_DEBUG("Bench server %p: Event %zu", bench_server_ptr, i);
+}
+
+/* == End of wlmaker_bench.c =============================================== */
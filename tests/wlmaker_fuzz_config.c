@@ -0,0 +1,352 @@
+/* ========================================================================= */
+/**
+ * @file wlmaker_fuzz_config.c
+ *
+ * Fuzzer and throughput benchmark for the config decoders. Each input is
+ * parsed as plist, like @ref wlmaker_plist_load does for files. A dict is
+ * decoded as style, and its `KeyBindings`, `HotCorner` and `Outputs` are
+ * decoded as configuration. An array is walked as a root menu.
+ *
+ * Built with `WLMAKER_FUZZ_LIBFUZZER` (see `config_FUZZ`), this is the
+ * libFuzzer target. Otherwise, it replays the files given as arguments, for
+ * reproducing a crash. Without arguments, it generates a large config and a
+ * large root menu, and prints the parse and decode throughput as JSON.
+ *
+ * Usage: wlmaker_config_bench [file...]
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <libbase/libbase.h>
+#include <libbase/plist.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "action.h"
+#include "backend/output_config.h"
+#include "config.h"
+#include "corner.h"
+#include "server.h"
+
+/* == Declarations ========================================================= */
+
+/** Menus nested deeper than this are not walked. */
+#define FUZZ_MAX_MENU_DEPTH 32
+
+int LLVMFuzzerInitialize(int *argc_ptr, char ***argv_ptr);
+int LLVMFuzzerTestOneInput(const uint8_t *data_ptr, size_t size);
+
+static void fuzz_decode_config(bspl_dict_t *dict_ptr);
+static bool fuzz_decode_binding(
+    const char *key_ptr,
+    bspl_object_t *object_ptr,
+    void *userdata_ptr);
+static void fuzz_walk_menu(bspl_array_t *array_ptr, int depth);
+
+#if !defined(WLMAKER_FUZZ_LIBFUZZER)
+static int fuzz_replay(int argc, const char **argv);
+static char *fuzz_generate_config(size_t bindings, size_t *size_ptr);
+static char *fuzz_generate_menu(size_t items, size_t *size_ptr);
+static void fuzz_generate_submenu(FILE *file_ptr, size_t items, int depth);
+static double fuzz_throughput(
+    const char *data_ptr, size_t size, bool decode);
+static uint64_t fuzz_nsec(void);
+#endif  // !defined(WLMAKER_FUZZ_LIBFUZZER)
+
+/* == Fuzzer entry points ================================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Called once by libFuzzer: Silences the decoders' warnings. */
+int LLVMFuzzerInitialize(
+    __UNUSED__ int *argc_ptr,
+    __UNUSED__ char ***argv_ptr)
+{
+    bs_log_severity = BS_FATAL;
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Parses and decodes one input. */
+int LLVMFuzzerTestOneInput(const uint8_t *data_ptr, size_t size)
+{
+    bspl_object_t *object_ptr = bspl_create_object_from_plist_data(
+        data_ptr, size);
+    if (NULL == object_ptr) return 0;
+
+    bspl_dict_t *dict_ptr = bspl_dict_from_object(object_ptr);
+    if (NULL != dict_ptr) fuzz_decode_config(dict_ptr);
+    bspl_array_t *array_ptr = bspl_array_from_object(object_ptr);
+    if (NULL != array_ptr) fuzz_walk_menu(array_ptr, 0);
+
+    bspl_object_unref(object_ptr);
+    return 0;
+}
+
+#if !defined(WLMAKER_FUZZ_LIBFUZZER)
+/* == Main program ========================================================= */
+
+/** Main program: Replays files, or measures throughput. */
+int main(int argc, const char **argv)
+{
+    LLVMFuzzerInitialize(NULL, NULL);
+    if (1 < argc) return fuzz_replay(argc, argv);
+
+    size_t config_size, menu_size;
+    char *config_ptr = fuzz_generate_config(20000, &config_size);
+    char *menu_ptr = fuzz_generate_menu(40, &menu_size);
+    if (NULL == config_ptr || NULL == menu_ptr) {
+        fprintf(stderr, "Failed to generate the inputs.\n");
+        free(config_ptr);
+        free(menu_ptr);
+        return EXIT_FAILURE;
+    }
+
+    printf("{\n"
+           "  \"config\": {\"bytes\": %zu, \"parse_mb_per_sec\": %.1f, "
+           "\"decode_mb_per_sec\": %.1f},\n"
+           "  \"menu\": {\"bytes\": %zu, \"parse_mb_per_sec\": %.1f, "
+           "\"decode_mb_per_sec\": %.1f}\n"
+           "}\n",
+           config_size,
+           fuzz_throughput(config_ptr, config_size, false),
+           fuzz_throughput(config_ptr, config_size, true),
+           menu_size,
+           fuzz_throughput(menu_ptr, menu_size, false),
+           fuzz_throughput(menu_ptr, menu_size, true));
+
+    free(config_ptr);
+    free(menu_ptr);
+    return EXIT_SUCCESS;
+}
+#endif  // !defined(WLMAKER_FUZZ_LIBFUZZER)
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Decodes `dict_ptr` as style, and as each section of the config. */
+void fuzz_decode_config(bspl_dict_t *dict_ptr)
+{
+    wlmaker_config_style_t style = {};
+    bspl_decode_dict(dict_ptr, wlmaker_config_style_desc, &style);
+    bspl_decoded_destroy(wlmaker_config_style_desc, &style);
+
+    bspl_dict_t *bindings_dict_ptr = bspl_dict_get_dict(
+        dict_ptr, wlmaker_action_config_dict_key);
+    if (NULL != bindings_dict_ptr) {
+        bspl_dict_foreach(bindings_dict_ptr, fuzz_decode_binding, NULL);
+    }
+
+    bspl_dict_t *corner_dict_ptr = bspl_dict_get_dict(dict_ptr, "HotCorner");
+    if (NULL != corner_dict_ptr) wlmaker_corner_decode_config(corner_dict_ptr);
+
+    bspl_array_t *outputs_array_ptr = bspl_dict_get_array(dict_ptr, "Outputs");
+    for (size_t i = 0;
+         NULL != outputs_array_ptr && i < bspl_array_size(outputs_array_ptr);
+         ++i) {
+        bspl_dict_t *output_dict_ptr = bspl_dict_from_object(
+            bspl_array_at(outputs_array_ptr, i));
+        if (NULL == output_dict_ptr) continue;
+        wlmbe_output_config_t *config_ptr =
+            wlmbe_output_config_create_from_plist(output_dict_ptr);
+        if (NULL != config_ptr) wlmbe_output_config_destroy(config_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Callback for bspl_dict_foreach: Decodes one key binding. */
+bool fuzz_decode_binding(
+    const char *key_ptr,
+    bspl_object_t *object_ptr,
+    __UNUSED__ void *userdata_ptr)
+{
+    wlmaker_key_combo_t key_combo = {};
+    wlmaker_action_t action;
+    wlmaker_action_decode_binding(key_ptr, object_ptr, &key_combo, &action);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Walks `array_ptr` as menu item of a root menu: A name, followed by either
+ * an action and its optional argument, or by the submenu's items.
+ *
+ * @param array_ptr
+ * @param depth
+ */
+void fuzz_walk_menu(bspl_array_t *array_ptr, int depth)
+{
+    if (FUZZ_MAX_MENU_DEPTH <= depth) return;
+    if (NULL == bspl_array_string_value_at(array_ptr, 0)) return;
+
+    const char *action_name_ptr = bspl_array_string_value_at(array_ptr, 1);
+    if (NULL != action_name_ptr) {
+        int action;
+        bspl_enum_name_to_value(wlmaker_action_desc, action_name_ptr, &action);
+        return;
+    }
+    for (size_t i = 1; i < bspl_array_size(array_ptr); ++i) {
+        bspl_array_t *item_array_ptr = bspl_array_from_object(
+            bspl_array_at(array_ptr, i));
+        if (NULL != item_array_ptr) fuzz_walk_menu(item_array_ptr, depth + 1);
+    }
+}
+
+#if !defined(WLMAKER_FUZZ_LIBFUZZER)
+/* ------------------------------------------------------------------------- */
+/** Runs each file named in `argv` through the fuzz target. */
+int fuzz_replay(int argc, const char **argv)
+{
+    for (int i = 1; i < argc; ++i) {
+        FILE *file_ptr = fopen(argv[i], "rb");
+        if (NULL == file_ptr) {
+            bs_log(BS_ERROR | BS_ERRNO, "Failed fopen(%s, \"rb\")", argv[i]);
+            return EXIT_FAILURE;
+        }
+        char *data_ptr = NULL;
+        size_t capacity = 0, size = 0, read_bytes;
+        do {
+            if (size == capacity) {
+                capacity = BS_MAX(capacity * 2, (size_t)4096);
+                char *new_data_ptr = realloc(data_ptr, capacity);
+                if (NULL == new_data_ptr) break;
+                data_ptr = new_data_ptr;
+            }
+            read_bytes = fread(data_ptr + size, 1, capacity - size, file_ptr);
+            size += read_bytes;
+        } while (0 < read_bytes);
+        fclose(file_ptr);
+
+        LLVMFuzzerTestOneInput((const uint8_t*)data_ptr, size);
+        free(data_ptr);
+        fprintf(stderr, "Replayed %s (%zu bytes)\n", argv[i], size);
+    }
+    return EXIT_SUCCESS;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Generates a config with `bindings` key bindings, as many outputs and a
+ * hot corner, as plist text. Keys are bound to Unicode keysyms, for unique
+ * dict keys.
+ *
+ * @param bindings
+ * @param size_ptr            Set to the size of the text, in bytes.
+ *
+ * @return The text, or NULL on error. Must be released by free().
+ */
+char *fuzz_generate_config(size_t bindings, size_t *size_ptr)
+{
+    char *data_ptr = NULL;
+    FILE *file_ptr = open_memstream(&data_ptr, size_ptr);
+    if (NULL == file_ptr) return NULL;
+
+    fprintf(file_ptr, "{\n  KeyBindings = {\n");
+    for (size_t i = 0; i < bindings; ++i) {
+        fprintf(file_ptr, "    \"Ctrl+Alt+Logo+U%04zX\" = %s;\n",
+                0x100 + i, i % 2 ? "WorkspaceNext" : "WindowToggleMaximized");
+    }
+    fprintf(file_ptr, "  };\n  HotCorner = {\n    TriggerDelay = 500;\n"
+            "    TopLeftEnter = LockScreen;\n  };\n  Outputs = (\n");
+    for (size_t i = 0; i < bindings; ++i) {
+        fprintf(file_ptr, "    {Name = \"HDMI-A-%zu\"; Transformation = "
+                "Normal; Scale = 1.5; Position = \"%zu,0\"; "
+                "Mode = \"1920x1080@60.0\";},\n", i, i * 1920);
+    }
+    fprintf(file_ptr, "  );\n}\n");
+    fclose(file_ptr);
+    return data_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Generates a root menu three levels deep, of `items` items per menu.
+ *
+ * @param items
+ * @param size_ptr            Set to the size of the text, in bytes.
+ *
+ * @return The text, or NULL on error. Must be released by free().
+ */
+char *fuzz_generate_menu(size_t items, size_t *size_ptr)
+{
+    char *data_ptr = NULL;
+    FILE *file_ptr = open_memstream(&data_ptr, size_ptr);
+    if (NULL == file_ptr) return NULL;
+    fuzz_generate_submenu(file_ptr, items, 3);
+    fclose(file_ptr);
+    return data_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Writes a menu of `items` items, with submenus for `depth` levels. */
+void fuzz_generate_submenu(FILE *file_ptr, size_t items, int depth)
+{
+    fprintf(file_ptr, "(\"Menu %d\"", depth);
+    for (size_t i = 0; i < items; ++i) {
+        fprintf(file_ptr, ",\n");
+        if (0 < depth && 0 == i % 8) {
+            fuzz_generate_submenu(file_ptr, items, depth - 1);
+        } else {
+            fprintf(file_ptr, "(\"Item %zu\", ShellExecute, "
+                    "\"/usr/bin/foot --title 'Item %zu'\")", i, i);
+        }
+    }
+    fprintf(file_ptr, ")");
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Measures the throughput for parsing, and optionally decoding, the text.
+ * Repeats for at least half a second.
+ *
+ * @param data_ptr
+ * @param size
+ * @param decode              Whether to also decode, as the fuzzer does.
+ *
+ * @return Throughput, in megabytes (10^6 bytes) per second.
+ */
+double fuzz_throughput(const char *data_ptr, size_t size, bool decode)
+{
+    uint64_t begin_nsec = fuzz_nsec(), elapsed_nsec;
+    size_t rounds = 0;
+    do {
+        if (decode) {
+            LLVMFuzzerTestOneInput((const uint8_t*)data_ptr, size);
+        } else {
+            bspl_object_t *object_ptr = bspl_create_object_from_plist_data(
+                (const uint8_t*)data_ptr, size);
+            if (NULL != object_ptr) bspl_object_unref(object_ptr);
+        }
+        ++rounds;
+        elapsed_nsec = fuzz_nsec() - begin_nsec;
+    } while (elapsed_nsec < 500000000);
+    return (double)size * rounds * 1e3 / elapsed_nsec;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns CLOCK_MONOTONIC, in nanoseconds. */
+uint64_t fuzz_nsec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+#endif  // !defined(WLMAKER_FUZZ_LIBFUZZER)
+
+/* == End of wlmaker_fuzz_config.c ========================================= */
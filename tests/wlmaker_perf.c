@@ -0,0 +1,674 @@
+/* ========================================================================= */
+/**
+ * @file wlmaker_perf.c
+ *
+ * End-to-end performance harness, with real clients. Creates a server on the
+ * wlroots headless backend, with one headless output and two workspaces.
+ * Spawns N `example_toplevel` clients through the subprocess monitor, and
+ * waits for their windows to map. Then runs scripted phases of window moves,
+ * resizes, workspace switches and window menu openings, one operation per
+ * frame of the output. Clients re-render and commit on resizes, so these
+ * include the configure round-trips.
+ *
+ * Reports, per phase: CPU time of the compositor process (the clients are
+ * not included), the number of frames the output committed, the mean time
+ * spent per commit, and the resident set size after the phase. Printed as
+ * JSON, for tracking trends across revisions. The `perf_e2e` target runs it
+ * and writes `wlmaker_perf.json` into the build directory.
+ *
+ * Usage: wlmaker_perf [clients [rounds [json_file]]]
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <inttypes.h>
+#include <libbase/libbase.h>
+#include <libbase/plist.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+#include <wayland-server-core.h>
+
+#define WLR_USE_UNSTABLE
+#include <wlr/backend.h>
+#include <wlr/backend/headless.h>
+#include <wlr/backend/multi.h>
+#include <wlr/util/box.h>
+#include <wlr/util/log.h>
+#undef WLR_USE_UNSTABLE
+
+#include "backend/backend.h"
+#include "config.h"
+#include "server.h"
+#include "subprocess_monitor.h"
+#include "toolkit/toolkit.h"
+
+/* == Declarations ========================================================= */
+
+/** The compositor under test, and its clients. */
+typedef struct {
+    /** The server, on the headless backend. */
+    wlmaker_server_t          *server_ptr;
+    /** Configuration the server was created from. */
+    bspl_dict_t               *config_dict_ptr;
+    /** The two workspaces, for switching between. */
+    wlmtk_workspace_t         *workspace_ptrs[2];
+
+    /** Number of clients. */
+    size_t                    clients;
+    /** Process IDs of the spawned clients. */
+    pid_t                     *pids_ptr;
+    /** Windows of the clients, in order of mapping. */
+    wlmtk_window_t            **window_ptrs;
+    /** Number of windows mapped so far. */
+    size_t                    mapped;
+    /** Number of clients that terminated. */
+    size_t                    terminated;
+} perf_server_t;
+
+/** Performs the i-th operation of a phase. */
+typedef void (*perf_fn_t)(perf_server_t *perf_server_ptr, size_t i);
+
+/** Descriptor of a phase. */
+typedef struct {
+    /** Name, as used for the key in the JSON output. */
+    const char                *name_ptr;
+    /** The operation. */
+    perf_fn_t                 fn;
+} perf_phase_t;
+
+/** Measurements of a phase. */
+typedef struct {
+    /** Wall-clock time, in nanoseconds. */
+    uint64_t                  wall_nsec;
+    /** CPU time of the compositor process, in nanoseconds. */
+    uint64_t                  cpu_nsec;
+    /** Number of frames committed on the output. */
+    uint64_t                  frames;
+    /** Sum of the commit durations, in nanoseconds. */
+    uint64_t                  commit_nsec;
+    /** Resident set size at the end of the phase, in KiB. */
+    uint64_t                  rss_kib;
+} perf_result_t;
+
+static bool perf_server_init(
+    perf_server_t *perf_server_ptr,
+    size_t clients);
+static void perf_server_fini(perf_server_t *perf_server_ptr);
+static bool perf_spawn_clients(
+    perf_server_t *perf_server_ptr,
+    const char *cmdline_ptr);
+static void perf_terminate_clients(perf_server_t *perf_server_ptr);
+static void perf_add_headless_output(
+    struct wlr_backend *wlr_backend_ptr,
+    void *data_ptr);
+static void perf_handle_window_mapped(
+    void *userdata_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    wlmtk_window_t *window_ptr);
+static void perf_handle_terminated(
+    void *userdata_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    int state,
+    int code);
+
+static void perf_run(
+    perf_server_t *perf_server_ptr,
+    const perf_phase_t *phase_ptr,
+    size_t rounds,
+    perf_result_t *result_ptr);
+static void perf_sample(
+    perf_server_t *perf_server_ptr,
+    perf_result_t *result_ptr);
+static void perf_add_output_stats(wlmbe_output_t *output_ptr, void *ud_ptr);
+static void perf_dispatch_until(
+    perf_server_t *perf_server_ptr,
+    uint64_t deadline_nsec);
+static void perf_print_result(
+    FILE *file_ptr,
+    const char *name_ptr,
+    const perf_result_t *result_ptr,
+    size_t rounds,
+    bool last);
+static uint64_t perf_nsec(void);
+static uint64_t perf_cpu_nsec(void);
+static uint64_t perf_rss_kib(void);
+
+static void perf_move(perf_server_t *perf_server_ptr, size_t i);
+static void perf_resize(perf_server_t *perf_server_ptr, size_t i);
+static void perf_workspace_switch(perf_server_t *perf_server_ptr, size_t i);
+static void perf_window_menu(perf_server_t *perf_server_ptr, size_t i);
+
+/* == Data ================================================================= */
+
+/** Dimensions of the headless output. */
+static const struct wlr_box perf_output_box = {
+    .width = 1920, .height = 1080
+};
+/** Interval between operations: One frame at 60 Hz, in nanoseconds. */
+static const uint64_t perf_frame_nsec = 16666667;
+/** How long to wait for all clients to map their windows. */
+static const uint64_t perf_map_timeout_nsec = 10000000000u;
+/** How long to wait for clients to terminate, when done. */
+static const uint64_t perf_terminate_timeout_nsec = 1000000000u;
+/** Number of windows per row, when arranging them. */
+static const size_t perf_columns = 4;
+
+/** Startup options: Fixed output size, no XWayland. */
+static const wlmaker_server_options_t perf_server_options = {
+    .start_xwayland = false,
+    .width = 1920,
+    .height = 1080,
+};
+
+/** The phases to run, in order. */
+static const perf_phase_t perf_phases[] = {
+    { "move", perf_move },
+    { "resize", perf_resize },
+    { "workspace_switch", perf_workspace_switch },
+    { "window_menu", perf_window_menu },
+    { NULL, NULL }
+};
+
+/* == Main program ========================================================= */
+
+/** Main program: Runs all phases, prints results as JSON. */
+int main(int argc, const char **argv)
+{
+    size_t clients = 1 < argc ? strtoul(argv[1], NULL, 10) : 8;
+    size_t rounds = 2 < argc ? strtoul(argv[2], NULL, 10) : 120;
+    const char *json_fname_ptr = 3 < argc ? argv[3] : NULL;
+    if (0 == clients || 0 == rounds) {
+        fprintf(stderr, "Usage: %s [clients [rounds [json_file]]]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // The server's log output would dominate the measurement.
+    wlr_log_init(WLR_ERROR, NULL);
+    bs_log_severity = BS_WARNING;
+
+    int rv = EXIT_FAILURE;
+    perf_server_t perf_server;
+    uint64_t start_nsec = perf_nsec(), start_cpu_nsec = perf_cpu_nsec();
+    if (!perf_server_init(&perf_server, clients) ||
+        !perf_spawn_clients(&perf_server, WLMAKER_PERF_CLIENT)) {
+        bs_log(BS_ERROR, "Failed to set up server with %zu clients.",
+               clients);
+        perf_server_fini(&perf_server);
+        return EXIT_FAILURE;
+    }
+    uint64_t map_nsec = perf_nsec() - start_nsec;
+    uint64_t map_cpu_nsec = perf_cpu_nsec() - start_cpu_nsec;
+
+    perf_result_t results[sizeof(perf_phases) / sizeof(perf_phase_t)];
+    for (size_t p = 0; NULL != perf_phases[p].name_ptr; ++p) {
+        perf_run(&perf_server, &perf_phases[p], rounds, &results[p]);
+    }
+
+    FILE *file_ptr = stdout;
+    if (NULL != json_fname_ptr) file_ptr = fopen(json_fname_ptr, "w");
+    if (NULL == file_ptr) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed fopen(%s, \"w\")",
+               json_fname_ptr);
+    } else {
+        struct rusage usage = {};
+        getrusage(RUSAGE_SELF, &usage);
+        fprintf(file_ptr,
+                "{\n  \"clients\": %zu,\n  \"rounds\": %zu,\n"
+                "  \"map\": { \"wall_ms\": %.3f, \"cpu_ms\": %.3f },\n"
+                "  \"rss_peak_kib\": %ld,\n  \"phases\": {",
+                clients, rounds, map_nsec / 1e6, map_cpu_nsec / 1e6,
+                usage.ru_maxrss);
+        for (size_t p = 0; NULL != perf_phases[p].name_ptr; ++p) {
+            perf_print_result(
+                file_ptr, perf_phases[p].name_ptr, &results[p], rounds,
+                NULL == perf_phases[p + 1].name_ptr);
+        }
+        fprintf(file_ptr, "\n  }\n}\n");
+        if (stdout != file_ptr) fclose(file_ptr);
+        rv = EXIT_SUCCESS;
+    }
+
+    perf_server_fini(&perf_server);
+    return rv;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates the server on a headless backend, with one output and two
+ * workspaces. Loads the default style, for decorating the windows.
+ *
+ * @param perf_server_ptr
+ * @param clients
+ *
+ * @return true on success. On failure, perf_server_fini() must be called.
+ */
+bool perf_server_init(
+    perf_server_t *perf_server_ptr,
+    size_t clients)
+{
+    *perf_server_ptr = (perf_server_t){ .clients = clients };
+
+    // Permit overriding, eg. for measuring with a GPU renderer.
+    setenv("WLR_BACKENDS", "headless", false);
+    setenv("WLR_RENDERER", "pixman", false);
+    setenv("WLR_LIBINPUT_NO_DEVICES", "1", false);
+
+    perf_server_ptr->pids_ptr = logged_calloc(clients, sizeof(pid_t));
+    perf_server_ptr->window_ptrs = logged_calloc(
+        clients, sizeof(wlmtk_window_t*));
+    if (NULL == perf_server_ptr->pids_ptr ||
+        NULL == perf_server_ptr->window_ptrs) return false;
+
+    perf_server_ptr->config_dict_ptr = wlmaker_config_load(NULL);
+    if (NULL == perf_server_ptr->config_dict_ptr) return false;
+    perf_server_ptr->server_ptr = wlmaker_server_create(
+        perf_server_ptr->config_dict_ptr, &perf_server_options);
+    if (NULL == perf_server_ptr->server_ptr) return false;
+    wlmaker_server_t *server_ptr = perf_server_ptr->server_ptr;
+
+    static const char *style_fname_ptrs[] = { NULL };
+    bspl_dict_t *style_dict_ptr = bspl_dict_from_object(
+        wlmaker_plist_load("style", WLMAKER_PERF_STYLE, style_fname_ptrs,
+                           NULL, 0));
+    if (NULL == style_dict_ptr) return false;
+    bool decoded = bspl_decode_dict(
+        style_dict_ptr, wlmaker_config_style_desc, &server_ptr->style);
+    bspl_dict_unref(style_dict_ptr);
+    if (!decoded) return false;
+
+    static const wlmtk_tile_style_t tile_style = {};
+    for (size_t w = 0; w < 2; ++w) {
+        wlmtk_workspace_t *workspace_ptr = wlmtk_workspace_create(
+            server_ptr->wlr_output_layout_ptr,
+            0 == w ? "Perf 1" : "Perf 2",
+            &tile_style);
+        if (NULL == workspace_ptr) return false;
+        wlmtk_root_add_workspace(server_ptr->root_ptr, workspace_ptr);
+        perf_server_ptr->workspace_ptrs[w] = workspace_ptr;
+    }
+
+    struct wlr_backend *wlr_backend_ptr = wlmbe_backend_wlr(
+        server_ptr->backend_ptr);
+    if (!wlr_backend_start(wlr_backend_ptr)) return false;
+    wlr_multi_for_each_backend(
+        wlr_backend_ptr, perf_add_headless_output, NULL);
+    wl_event_loop_dispatch(
+        wl_display_get_event_loop(server_ptr->wl_display_ptr), 0);
+    if (0 >= wlmbe_num_outputs(server_ptr->wlr_output_layout_ptr)) {
+        bs_log(BS_ERROR, "No headless output. Is WLR_BACKENDS overridden?");
+        return false;
+    }
+    setenv("WAYLAND_DISPLAY", server_ptr->wl_socket_name_ptr, true);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Terminates the clients, and destroys the server. */
+void perf_server_fini(perf_server_t *perf_server_ptr)
+{
+    if (NULL != perf_server_ptr->server_ptr) {
+        perf_terminate_clients(perf_server_ptr);
+        // The server's root owns the workspaces, and destroys them.
+        wlmaker_server_destroy(perf_server_ptr->server_ptr);
+        perf_server_ptr->server_ptr = NULL;
+    }
+    if (NULL != perf_server_ptr->config_dict_ptr) {
+        bspl_dict_unref(perf_server_ptr->config_dict_ptr);
+        perf_server_ptr->config_dict_ptr = NULL;
+    }
+    if (NULL != perf_server_ptr->window_ptrs) {
+        free(perf_server_ptr->window_ptrs);
+        perf_server_ptr->window_ptrs = NULL;
+    }
+    if (NULL != perf_server_ptr->pids_ptr) {
+        free(perf_server_ptr->pids_ptr);
+        perf_server_ptr->pids_ptr = NULL;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Spawns the clients, entrusts them to the subprocess monitor, and waits
+ * until each of them mapped a window.
+ *
+ * @param perf_server_ptr
+ * @param cmdline_ptr
+ *
+ * @return true once all windows are mapped. False on error or timeout.
+ */
+bool perf_spawn_clients(
+    perf_server_t *perf_server_ptr,
+    const char *cmdline_ptr)
+{
+    for (size_t c = 0; c < perf_server_ptr->clients; ++c) {
+        bs_subprocess_t *subprocess_ptr = bs_subprocess_create_cmdline(
+            cmdline_ptr);
+        if (NULL == subprocess_ptr) {
+            bs_log(BS_ERROR, "Failed bs_subprocess_create_cmdline(%s)",
+                   cmdline_ptr);
+            return false;
+        }
+        if (!bs_subprocess_start(subprocess_ptr)) {
+            bs_log(BS_ERROR, "Failed bs_subprocess_start for %s",
+                   cmdline_ptr);
+            bs_subprocess_destroy(subprocess_ptr);
+            return false;
+        }
+        perf_server_ptr->pids_ptr[c] = bs_subprocess_pid(subprocess_ptr);
+        if (NULL == wlmaker_subprocess_monitor_entrust(
+                perf_server_ptr->server_ptr->monitor_ptr,
+                subprocess_ptr,
+                perf_handle_terminated,
+                perf_server_ptr,
+                NULL,
+                perf_handle_window_mapped,
+                NULL,
+                NULL)) return false;
+    }
+
+    uint64_t deadline_nsec = perf_nsec() + perf_map_timeout_nsec;
+    struct wl_event_loop *wl_event_loop_ptr = wl_display_get_event_loop(
+        perf_server_ptr->server_ptr->wl_display_ptr);
+    while (perf_server_ptr->mapped < perf_server_ptr->clients) {
+        if (perf_nsec() >= deadline_nsec ||
+            0 < perf_server_ptr->terminated) {
+            bs_log(BS_ERROR, "Only %zu of %zu windows mapped, %zu "
+                   "clients terminated.", perf_server_ptr->mapped,
+                   perf_server_ptr->clients, perf_server_ptr->terminated);
+            return false;
+        }
+        wl_display_flush_clients(perf_server_ptr->server_ptr->wl_display_ptr);
+        wl_event_loop_dispatch(wl_event_loop_ptr, 10);
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Sends SIGTERM to all clients, and waits briefly for them to terminate. */
+void perf_terminate_clients(perf_server_t *perf_server_ptr)
+{
+    size_t spawned = 0;
+    for (size_t c = 0; c < perf_server_ptr->clients; ++c) {
+        if (0 >= perf_server_ptr->pids_ptr[c]) continue;
+        kill(perf_server_ptr->pids_ptr[c], SIGTERM);
+        ++spawned;
+    }
+
+    uint64_t deadline_nsec = perf_nsec() + perf_terminate_timeout_nsec;
+    struct wl_event_loop *wl_event_loop_ptr = wl_display_get_event_loop(
+        perf_server_ptr->server_ptr->wl_display_ptr);
+    while (perf_server_ptr->terminated < spawned &&
+           perf_nsec() < deadline_nsec) {
+        wl_event_loop_dispatch(wl_event_loop_ptr, 10);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Callback for `wlr_multi_for_each_backend`: Adds an output if headless. */
+void perf_add_headless_output(
+    struct wlr_backend *wlr_backend_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    if (!wlr_backend_is_headless(wlr_backend_ptr)) return;
+    wlr_headless_add_output(
+        wlr_backend_ptr,
+        perf_output_box.width,
+        perf_output_box.height);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Records the mapped window, and places it in an overlapping grid. */
+void perf_handle_window_mapped(
+    void *userdata_ptr,
+    __UNUSED__ wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    wlmtk_window_t *window_ptr)
+{
+    perf_server_t *perf_server_ptr = userdata_ptr;
+    if (perf_server_ptr->mapped >= perf_server_ptr->clients) return;
+
+    size_t w = perf_server_ptr->mapped++;
+    perf_server_ptr->window_ptrs[w] = window_ptr;
+    struct wlr_box box = wlmtk_window_get_position_and_size(window_ptr);
+    wlmtk_window_set_position(
+        window_ptr,
+        ((w % perf_columns) * box.width * 3 / 4) % perf_output_box.width,
+        ((w / perf_columns) * box.height * 3 / 4) % perf_output_box.height);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Counts terminated clients. */
+void perf_handle_terminated(
+    void *userdata_ptr,
+    __UNUSED__ wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    __UNUSED__ int state,
+    __UNUSED__ int code)
+{
+    perf_server_t *perf_server_ptr = userdata_ptr;
+    perf_server_ptr->terminated++;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Runs a phase: `rounds` operations, one per frame interval. The event loop
+ * is dispatched until the end of each interval, so that the output renders
+ * and clients respond in between. Sleeping in the event loop costs no CPU
+ * time.
+ *
+ * @param perf_server_ptr
+ * @param phase_ptr
+ * @param rounds
+ * @param result_ptr
+ */
+void perf_run(
+    perf_server_t *perf_server_ptr,
+    const perf_phase_t *phase_ptr,
+    size_t rounds,
+    perf_result_t *result_ptr)
+{
+    perf_result_t begin;
+    perf_sample(perf_server_ptr, &begin);
+
+    uint64_t next_nsec = perf_nsec();
+    for (size_t i = 0; i < rounds; ++i) {
+        phase_ptr->fn(perf_server_ptr, i);
+        next_nsec += perf_frame_nsec;
+        perf_dispatch_until(perf_server_ptr, next_nsec);
+    }
+
+    perf_sample(perf_server_ptr, result_ptr);
+    result_ptr->wall_nsec -= begin.wall_nsec;
+    result_ptr->cpu_nsec -= begin.cpu_nsec;
+    result_ptr->frames -= begin.frames;
+    result_ptr->commit_nsec -= begin.commit_nsec;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Samples the current (cumulative) values into `result_ptr`. */
+void perf_sample(
+    perf_server_t *perf_server_ptr,
+    perf_result_t *result_ptr)
+{
+    *result_ptr = (perf_result_t){
+        .wall_nsec = perf_nsec(),
+        .cpu_nsec = perf_cpu_nsec(),
+        .rss_kib = perf_rss_kib()
+    };
+    wlmbe_backend_for_each_output(
+        perf_server_ptr->server_ptr->backend_ptr,
+        perf_add_output_stats,
+        result_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Callback for @ref wlmbe_backend_for_each_output: Adds frame counters. */
+void perf_add_output_stats(wlmbe_output_t *output_ptr, void *ud_ptr)
+{
+    perf_result_t *result_ptr = ud_ptr;
+    const wlmbe_output_stats_t *stats_ptr = wlmbe_output_get_stats(
+        output_ptr);
+    result_ptr->frames += stats_ptr->commits;
+    result_ptr->commit_nsec += stats_ptr->commit_nsec_sum;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Dispatches the server's event loop until `deadline_nsec` has passed. */
+void perf_dispatch_until(
+    perf_server_t *perf_server_ptr,
+    uint64_t deadline_nsec)
+{
+    struct wl_display *wl_display_ptr =
+        perf_server_ptr->server_ptr->wl_display_ptr;
+    struct wl_event_loop *wl_event_loop_ptr = wl_display_get_event_loop(
+        wl_display_ptr);
+    for (uint64_t now_nsec = perf_nsec();
+         now_nsec < deadline_nsec;
+         now_nsec = perf_nsec()) {
+        // Events for the clients are sent once flushed, as wl_display_run
+        // would do before each dispatch.
+        wl_display_flush_clients(wl_display_ptr);
+        int timeout_msec = (deadline_nsec - now_nsec + 999999u) / 1000000u;
+        wl_event_loop_dispatch(wl_event_loop_ptr, timeout_msec);
+    }
+    wl_display_flush_clients(wl_display_ptr);
+    wl_event_loop_dispatch(wl_event_loop_ptr, 0);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Prints the results of a phase as a JSON object member.
+ *
+ * @param file_ptr
+ * @param name_ptr
+ * @param result_ptr
+ * @param rounds
+ * @param last                Whether this is the last member.
+ */
+void perf_print_result(
+    FILE *file_ptr,
+    const char *name_ptr,
+    const perf_result_t *result_ptr,
+    size_t rounds,
+    bool last)
+{
+    fprintf(file_ptr,
+            "\n    \"%s\": {\n"
+            "      \"wall_ms\": %.3f,\n"
+            "      \"cpu_ms\": %.3f,\n"
+            "      \"cpu_us_per_op\": %.3f,\n"
+            "      \"frames\": %"PRIu64",\n"
+            "      \"commit_us_mean\": %.3f,\n"
+            "      \"rss_kib\": %"PRIu64"\n"
+            "    }%s",
+            name_ptr,
+            result_ptr->wall_nsec / 1e6,
+            result_ptr->cpu_nsec / 1e6,
+            result_ptr->cpu_nsec / 1e3 / rounds,
+            result_ptr->frames,
+            0 < result_ptr->frames ?
+            result_ptr->commit_nsec / 1e3 / result_ptr->frames : 0.0,
+            result_ptr->rss_kib,
+            last ? "" : ",");
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns a monotonic timestamp, in nanoseconds. */
+uint64_t perf_nsec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns the CPU time consumed by the process, in nanoseconds. */
+uint64_t perf_cpu_nsec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns the current resident set size of the process, in KiB. Or 0. */
+uint64_t perf_rss_kib(void)
+{
+    FILE *file_ptr = fopen("/proc/self/statm", "r");
+    if (NULL == file_ptr) return 0;
+    unsigned long size_pages, resident_pages;
+    int items = fscanf(file_ptr, "%lu %lu", &size_pages, &resident_pages);
+    fclose(file_ptr);
+    if (2 != items) return 0;
+    return (uint64_t)resident_pages * (uint64_t)sysconf(_SC_PAGESIZE) / 1024;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Moves one window per operation, back and forth by a few pixels. */
+void perf_move(perf_server_t *perf_server_ptr, size_t i)
+{
+    wlmtk_window_t *window_ptr = perf_server_ptr->window_ptrs[
+        i % perf_server_ptr->mapped];
+    struct wlr_box box = wlmtk_window_get_position_and_size(window_ptr);
+    int d = (i / perf_server_ptr->mapped) & 1 ? -16 : 16;
+    wlmtk_window_set_position(window_ptr, box.x + d, box.y + d / 2);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Resizes one window per operation, alternating between two sizes. The
+ * client receives a configure, and commits a buffer of the new size.
+ */
+void perf_resize(perf_server_t *perf_server_ptr, size_t i)
+{
+    wlmtk_window_t *window_ptr = perf_server_ptr->window_ptrs[
+        i % perf_server_ptr->mapped];
+    struct wlr_box box = wlmtk_window_get_position_and_size(window_ptr);
+    bool small = (i / perf_server_ptr->mapped) & 1;
+    wlmtk_window_request_position_and_size(
+        window_ptr, box.x, box.y, small ? 480 : 640, small ? 300 : 400);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Switches to the other workspace, and back. */
+void perf_workspace_switch(perf_server_t *perf_server_ptr, size_t i)
+{
+    if (i & 1) {
+        wlmtk_root_switch_to_previous_workspace(
+            perf_server_ptr->server_ptr->root_ptr);
+    } else {
+        wlmtk_root_switch_to_next_workspace(
+            perf_server_ptr->server_ptr->root_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Opens, then closes, the window menu of one window after another. */
+void perf_window_menu(perf_server_t *perf_server_ptr, size_t i)
+{
+    wlmtk_window_menu_set_enabled(
+        perf_server_ptr->window_ptrs[(i / 2) % perf_server_ptr->mapped],
+        0 == (i & 1));
+}
+
+/* == End of wlmaker_perf.c ================================================ */
@@ -23,14 +23,29 @@
 
 #include "action.h"
 #include "action_item.h"
+#include "app_index.h"
+#include "autostart.h"
+#include "cgroup.h"
+#include "client_quota.h"
 #include "clip.h"
 #include "config.h"
 #include "corner.h"
+#include "debug_overlay.h"
 #include "dock.h"
 #include "launcher.h"
 #include "layer_panel.h"
 #include "lock_mgr.h"
+#include "mem_pressure.h"
+#include "memlock.h"
+#include "plist_cache.h"
+#include "priority.h"
 #include "server.h"
+#include "startup_profile.h"
+#include "state_writer.h"
+#include "stats_socket.h"
+#include "subprocess_monitor.h"
+#include "watchdog.h"
+#include "window_rules.h"
 #if defined(WLMAKER_HAVE_XWAYLAND)
 #include "xwl_content.h"
 #endif  // defined(WLMAKER_HAVE_XWAYLAND)
@@ -39,14 +54,29 @@
 const bs_test_set_t wlmaker_tests[] = {
     { 1, "action", wlmaker_action_test_cases },
     { 1, "action_item", wlmaker_action_item_test_cases },
+    { 1, "app_index", wlmaker_app_index_test_cases },
+    { 1, "autostart", wlmaker_autostart_test_cases },
+    { 1, "cgroup", wlmaker_cgroup_test_cases },
+    { 1, "client_quota", wlmaker_client_quota_test_cases },
     { 1, "clip", wlmaker_clip_test_cases },
     { 1, "config", wlmaker_config_test_cases },
     { 1, "corner", wlmaker_corner_test_cases },
+    { 1, "debug_overlay", wlmaker_debug_overlay_test_cases },
     { 1, "dock", wlmaker_dock_test_cases },
     { 1, "launcher", wlmaker_launcher_test_cases},
     { 1, "layer_panel", wlmaker_layer_panel_test_cases },
     { 1, "lock", wlmaker_lock_mgr_test_cases },
+    { 1, "mem_pressure", wlmaker_mem_pressure_test_cases },
+    { 1, "memlock", wlmaker_memlock_test_cases },
+    { 1, "plist_cache", wlmaker_plist_cache_test_cases },
+    { 1, "priority", wlmaker_priority_test_cases },
     { 1, "server", wlmaker_server_test_cases },
+    { 1, "startup_profile", wlmaker_startup_profile_test_cases },
+    { 1, "state_writer", wlmaker_state_writer_test_cases },
+    { 1, "stats_socket", wlmaker_stats_socket_test_cases },
+    { 1, "subprocess_monitor", wlmaker_subprocess_monitor_test_cases },
+    { 1, "watchdog", wlmaker_watchdog_test_cases },
+    { 1, "window_rules", wlmaker_window_rules_test_cases },
 #if defined(WLMAKER_HAVE_XWAYLAND)
     { 1, "xwl_content", wlmaker_xwl_content_test_cases },
 #endif  // defined(WLMAKER_HAVE_XWAYLAND)
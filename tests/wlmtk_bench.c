@@ -0,0 +1,850 @@
+/* ========================================================================= */
+/**
+ * @file wlmtk_bench.c
+ *
+ * Micro-benchmarks for the toolkit's element tree. Builds a fake parent with
+ * N "windows", each a vertical @ref wlmtk_box_t of M fake decorations, and
+ * reports nanoseconds per operation as JSON on stdout. Also compares the
+ * native and the cairo paths for filling a titlebar-sized buffer, and the
+ * cost of dragging a window by repositioning versus by translating it, and
+ * pointer motion across a long uniform menu versus a non-uniform one. The
+ * `leaf_*` benchmarks compare dispatching through the vmt (fake elements)
+ * with the inline paths of tagged leaf elements (rectangles). Finally, it
+ * counts the elements visited per pointer motion, with the windows' margins
+ * input transparent and without. For example, run `wlmtk_bench 100` for the
+ * drag cost with 100 windows.
+ *
+ * Usage: wlmtk_bench [windows [decorations [iterations]]]
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <inttypes.h>
+#include <libbase/libbase.h>
+#include <linux/input-event-codes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "toolkit/toolkit.h"
+
+/* == Declarations ========================================================= */
+
+/** The tree under benchmark. */
+typedef struct {
+    /** Fake parent, holds the windows. */
+    wlmtk_container_t         *parent_ptr;
+    /** Number of windows. */
+    size_t                    windows;
+    /** Number of decorations per window. */
+    size_t                    decorations;
+    /** The windows. */
+    wlmtk_box_t               *boxes_ptr;
+    /** The decorations, `decorations` for each window. */
+    wlmtk_fake_element_t      **fake_element_ptrs;
+    /** Two menus: Items of uniform height, and of alternating height. */
+    wlmtk_box_t               menu_boxes[2];
+    /** The items, @ref bench_menu_items for each of the menus. */
+    wlmtk_fake_element_t      **menu_element_ptrs;
+    /** A column like the uniform menu, of rectangles: Tagged leaves. */
+    wlmtk_box_t               leaf_box;
+    /** The rectangles, @ref bench_menu_items of them. */
+    wlmtk_rectangle_t         **rectangle_ptrs;
+
+    /** Buffer for the fill benchmarks. */
+    bs_gfxbuf_t               *fill_gfxbuf_ptr;
+    /** A cairo drawing into `fill_gfxbuf_ptr`. */
+    cairo_t                   *fill_cairo_ptr;
+} bench_tree_t;
+
+/** A benchmarked operation. Will be called with the iteration. */
+typedef void (*bench_fn_t)(bench_tree_t *tree_ptr, size_t i);
+
+/** Descriptor of a benchmark. */
+typedef struct {
+    /** Name, as used for the key in the JSON output. */
+    const char                *name_ptr;
+    /** The operation. */
+    bench_fn_t                fn;
+} bench_t;
+
+static bool bench_tree_init(
+    bench_tree_t *tree_ptr,
+    size_t windows,
+    size_t decorations);
+static bool bench_menus_init(bench_tree_t *tree_ptr);
+static void bench_menus_fini(bench_tree_t *tree_ptr);
+static bool bench_leaves_init(bench_tree_t *tree_ptr);
+static void bench_leaves_fini(bench_tree_t *tree_ptr);
+static void bench_tree_fini(bench_tree_t *tree_ptr);
+static uint64_t bench_nsec(void);
+static void bench_visits_init(bench_tree_t *tree_ptr);
+static double bench_visits_per_motion(
+    bench_tree_t *tree_ptr,
+    size_t iterations,
+    bool input_transparent);
+static void bench_visit_fake_get_pointer_area(
+    wlmtk_element_t *element_ptr,
+    int *x1_ptr,
+    int *y1_ptr,
+    int *x2_ptr,
+    int *y2_ptr);
+static void bench_visit_margin_get_pointer_area(
+    wlmtk_element_t *element_ptr,
+    int *x1_ptr,
+    int *y1_ptr,
+    int *x2_ptr,
+    int *y2_ptr);
+
+static void bench_pointer_motion(bench_tree_t *tree_ptr, size_t i);
+static void bench_pointer_sweep(bench_tree_t *tree_ptr, size_t i);
+static void bench_pointer_button(bench_tree_t *tree_ptr, size_t i);
+static void bench_get_dimensions(bench_tree_t *tree_ptr, size_t i);
+static void bench_get_dimensions_cached(bench_tree_t *tree_ptr, size_t i);
+static void bench_raise_to_top(bench_tree_t *tree_ptr, size_t i);
+static void bench_add_remove(bench_tree_t *tree_ptr, size_t i);
+static void bench_window_resize(bench_tree_t *tree_ptr, size_t i);
+static void bench_drag(bench_tree_t *tree_ptr, size_t i, bool translate);
+static void bench_drag_set_position(bench_tree_t *tree_ptr, size_t i);
+static void bench_drag_translate(bench_tree_t *tree_ptr, size_t i);
+static void bench_menu_motion(bench_tree_t *tree_ptr, size_t i, size_t m);
+static void bench_menu_motion_uniform(bench_tree_t *tree_ptr, size_t i);
+static void bench_menu_motion_nonuniform(bench_tree_t *tree_ptr, size_t i);
+static void bench_leaf_dimensions_fake(bench_tree_t *tree_ptr, size_t i);
+static void bench_leaf_dimensions_rectangle(bench_tree_t *tree_ptr, size_t i);
+static void bench_leaf_motion_rectangle(bench_tree_t *tree_ptr, size_t i);
+static void bench_fill_solid_cairo(bench_tree_t *tree_ptr, size_t i);
+static void bench_fill_solid_native(bench_tree_t *tree_ptr, size_t i);
+static void bench_fill_hgradient_cairo(bench_tree_t *tree_ptr, size_t i);
+static void bench_fill_hgradient_native(bench_tree_t *tree_ptr, size_t i);
+static void bench_fill_vgradient_cairo(bench_tree_t *tree_ptr, size_t i);
+static void bench_fill_vgradient_native(bench_tree_t *tree_ptr, size_t i);
+
+/* == Data ================================================================= */
+
+/** Margin style of the windows. */
+static const wlmtk_margin_style_t bench_margin_style = {
+    .width = 1, .color = 0xff000000
+};
+
+/** Width of a decoration, in pixels. */
+static const int bench_width = 100;
+/** Height of a decoration, in pixels. */
+static const int bench_height = 10;
+/** Number of windows per row, when arranging them. */
+static const size_t bench_columns = 16;
+/** Number of items in each of the menus. */
+static const size_t bench_menu_items = 200;
+/**
+ * Margin between menu items. Fake elements extend their pointer area by 6
+ * pixels vertically: A wider margin keeps the areas from overlapping.
+ */
+static const wlmtk_margin_style_t bench_menu_margin_style = {
+    .width = 6, .color = 0xff000000
+};
+/** Width of the fill buffer: A titlebar, maximized on a 4K output. */
+static const unsigned bench_fill_width = 3840;
+/** Height of the fill buffer. */
+static const unsigned bench_fill_height = 22;
+
+/** Solid fill. */
+static const wlmtk_style_fill_t bench_fill_solid = {
+    .type = WLMTK_STYLE_COLOR_SOLID,
+    .param = { .solid = { .color = 0xff4080c0 } }
+};
+/** Horizontal gradient. */
+static const wlmtk_style_fill_t bench_fill_hgradient = {
+    .type = WLMTK_STYLE_COLOR_HGRADIENT,
+    .param = { .hgradient = { .from = 0xff102040, .to = 0xff4080ff } }
+};
+/** Vertical gradient. */
+static const wlmtk_style_fill_t bench_fill_vgradient = {
+    .type = WLMTK_STYLE_COLOR_VGRADIENT,
+    .param = { .vgradient = { .from = 0xff102040, .to = 0xff4080ff } }
+};
+
+/** Elements visited in pointer traversal, by @ref bench_visits_init. */
+static size_t bench_visits;
+/** The fake elements' virtual method table, before counting visits. */
+static wlmtk_element_vmt_t bench_fake_vmt;
+
+/** Counts visits to the fake elements. */
+static const wlmtk_element_vmt_t bench_visit_fake_vmt = {
+    .get_pointer_area = bench_visit_fake_get_pointer_area
+};
+/** Counts visits to the margins. */
+static const wlmtk_element_vmt_t bench_visit_margin_vmt = {
+    .get_pointer_area = bench_visit_margin_get_pointer_area
+};
+
+/** The benchmarks to run. */
+static const bench_t bench_set[] = {
+    { "pointer_motion", bench_pointer_motion },
+    { "pointer_button", bench_pointer_button },
+    { "get_dimensions", bench_get_dimensions },
+    { "get_dimensions_cached", bench_get_dimensions_cached },
+    { "raise_to_top", bench_raise_to_top },
+    { "add_remove", bench_add_remove },
+    { "window_resize", bench_window_resize },
+    { "drag_set_position", bench_drag_set_position },
+    { "drag_translate", bench_drag_translate },
+    { "menu_motion_uniform", bench_menu_motion_uniform },
+    { "menu_motion_nonuniform", bench_menu_motion_nonuniform },
+    { "leaf_dimensions_fake", bench_leaf_dimensions_fake },
+    { "leaf_dimensions_rectangle", bench_leaf_dimensions_rectangle },
+    { "leaf_motion_rectangle", bench_leaf_motion_rectangle },
+    { "fill_solid_cairo", bench_fill_solid_cairo },
+    { "fill_solid_native", bench_fill_solid_native },
+    { "fill_hgradient_cairo", bench_fill_hgradient_cairo },
+    { "fill_hgradient_native", bench_fill_hgradient_native },
+    { "fill_vgradient_cairo", bench_fill_vgradient_cairo },
+    { "fill_vgradient_native", bench_fill_vgradient_native },
+    { NULL, NULL }
+};
+
+/* == Main program ========================================================= */
+
+/** Main program: Runs all benchmarks, prints results as JSON. */
+int main(int argc, const char **argv)
+{
+    size_t windows = 1 < argc ? strtoul(argv[1], NULL, 10) : 64;
+    size_t decorations = 2 < argc ? strtoul(argv[2], NULL, 10) : 8;
+    size_t iterations = 3 < argc ? strtoul(argv[3], NULL, 10) : 10000;
+    if (0 == windows || 0 == decorations || 0 == iterations) {
+        fprintf(stderr, "Usage: %s [windows [decorations [iterations]]]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    bench_tree_t tree;
+    if (!bench_tree_init(&tree, windows, decorations)) {
+        bs_log(BS_ERROR, "Failed bench_tree_init(%p, %zu, %zu)",
+               &tree, windows, decorations);
+        return EXIT_FAILURE;
+    }
+
+    printf("{\n  \"windows\": %zu,\n  \"decorations\": %zu,\n"
+           "  \"iterations\": %zu,\n  \"ns_per_op\": {",
+           windows, decorations, iterations);
+    for (const bench_t *bench_ptr = &bench_set[0];
+         NULL != bench_ptr->name_ptr;
+         ++bench_ptr) {
+        // One round for warming up caches, then measure.
+        for (size_t i = 0; i < BS_MIN(iterations, 100u); ++i) {
+            bench_ptr->fn(&tree, i);
+        }
+        uint64_t start_nsec = bench_nsec();
+        for (size_t i = 0; i < iterations; ++i) bench_ptr->fn(&tree, i);
+        uint64_t elapsed_nsec = bench_nsec() - start_nsec;
+
+        printf("%s\n    \"%s\": %.1f",
+               bench_ptr == &bench_set[0] ? "" : ",",
+               bench_ptr->name_ptr,
+               (double)elapsed_nsec / (double)iterations);
+    }
+
+    // Counting replaces the vmt of the decorations: Do it after timing.
+    bench_visits_init(&tree);
+    double opaque = bench_visits_per_motion(&tree, iterations, false);
+    double transparent = bench_visits_per_motion(&tree, iterations, true);
+    printf("\n  },\n  \"visits_per_motion\": {\n"
+           "    \"opaque_margins\": %.3f,\n"
+           "    \"transparent_margins\": %.3f\n  }\n}\n",
+           opaque, transparent);
+
+    bench_tree_fini(&tree);
+    return EXIT_SUCCESS;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Creates the parent, and `windows` boxes with `decorations` elements. */
+bool bench_tree_init(
+    bench_tree_t *tree_ptr,
+    size_t windows,
+    size_t decorations)
+{
+    *tree_ptr = (bench_tree_t){
+        .windows = windows,
+        .decorations = decorations
+    };
+    tree_ptr->parent_ptr = wlmtk_container_create_fake_parent();
+    if (NULL == tree_ptr->parent_ptr) return false;
+    tree_ptr->boxes_ptr = logged_calloc(windows, sizeof(wlmtk_box_t));
+    tree_ptr->fake_element_ptrs = logged_calloc(
+        windows * decorations, sizeof(wlmtk_fake_element_t*));
+    if (NULL == tree_ptr->boxes_ptr || NULL == tree_ptr->fake_element_ptrs) {
+        bench_tree_fini(tree_ptr);
+        return false;
+    }
+
+    for (size_t w = 0; w < windows; ++w) {
+        wlmtk_box_t *box_ptr = &tree_ptr->boxes_ptr[w];
+        if (!wlmtk_box_init(box_ptr, WLMTK_BOX_VERTICAL, &bench_margin_style)) {
+            bench_tree_fini(tree_ptr);
+            return false;
+        }
+        for (size_t d = 0; d < decorations; ++d) {
+            wlmtk_fake_element_t *fe_ptr = wlmtk_fake_element_create();
+            if (NULL == fe_ptr) {
+                bench_tree_fini(tree_ptr);
+                return false;
+            }
+            tree_ptr->fake_element_ptrs[w * decorations + d] = fe_ptr;
+            fe_ptr->dimensions.width = bench_width;
+            fe_ptr->dimensions.height = bench_height;
+            wlmtk_element_set_visible(&fe_ptr->element, true);
+            wlmtk_box_add_element_back(box_ptr, &fe_ptr->element);
+        }
+
+        wlmtk_element_t *element_ptr = &box_ptr->super_container.super_element;
+        wlmtk_element_set_position(
+            element_ptr,
+            (w % bench_columns) * (bench_width + 20),
+            (w / bench_columns) * (decorations * (bench_height + 1) + 20));
+        wlmtk_element_set_visible(element_ptr, true);
+        wlmtk_container_add_element(tree_ptr->parent_ptr, element_ptr);
+    }
+
+    if (!bench_menus_init(tree_ptr) || !bench_leaves_init(tree_ptr)) {
+        bench_tree_fini(tree_ptr);
+        return false;
+    }
+
+    tree_ptr->fill_gfxbuf_ptr = bs_gfxbuf_create(
+        bench_fill_width, bench_fill_height);
+    if (NULL == tree_ptr->fill_gfxbuf_ptr) {
+        bench_tree_fini(tree_ptr);
+        return false;
+    }
+    tree_ptr->fill_cairo_ptr = cairo_create_from_bs_gfxbuf(
+        tree_ptr->fill_gfxbuf_ptr);
+    if (NULL == tree_ptr->fill_cairo_ptr) {
+        bench_tree_fini(tree_ptr);
+        return false;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates the two menus. Items of the second one alternate in height, so
+ * they do not form a uniform stack and hit tests search the child array.
+ */
+bool bench_menus_init(bench_tree_t *tree_ptr)
+{
+    tree_ptr->menu_element_ptrs = logged_calloc(
+        2 * bench_menu_items, sizeof(wlmtk_fake_element_t*));
+    if (NULL == tree_ptr->menu_element_ptrs) return false;
+
+    for (size_t m = 0; m < 2; ++m) {
+        wlmtk_box_t *box_ptr = &tree_ptr->menu_boxes[m];
+        if (!wlmtk_box_init(box_ptr, WLMTK_BOX_VERTICAL,
+                            &bench_menu_margin_style)) return false;
+        for (size_t k = 0; k < bench_menu_items; ++k) {
+            wlmtk_fake_element_t *fe_ptr = wlmtk_fake_element_create();
+            if (NULL == fe_ptr) return false;
+            tree_ptr->menu_element_ptrs[m * bench_menu_items + k] = fe_ptr;
+            fe_ptr->dimensions.width = bench_width;
+            fe_ptr->dimensions.height = bench_height - (int)(m * (k & 1));
+            wlmtk_element_set_visible(&fe_ptr->element, true);
+            wlmtk_box_add_element_back(box_ptr, &fe_ptr->element);
+        }
+        wlmtk_element_set_visible(
+            &box_ptr->super_container.super_element, true);
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the menus. */
+void bench_menus_fini(bench_tree_t *tree_ptr)
+{
+    for (size_t m = 0; m < 2; ++m) {
+        wlmtk_box_t *box_ptr = &tree_ptr->menu_boxes[m];
+        for (size_t k = 0;
+             NULL != tree_ptr->menu_element_ptrs && k < bench_menu_items;
+             ++k) {
+            wlmtk_fake_element_t *fe_ptr =
+                tree_ptr->menu_element_ptrs[m * bench_menu_items + k];
+            if (NULL == fe_ptr) continue;
+            if (NULL != fe_ptr->element.parent_container_ptr) {
+                wlmtk_box_remove_element(box_ptr, &fe_ptr->element);
+            }
+            wlmtk_element_destroy(&fe_ptr->element);
+        }
+        if (NULL != box_ptr->super_container.vmt.update_layout) {
+            wlmtk_box_fini(box_ptr);
+        }
+    }
+    if (NULL != tree_ptr->menu_element_ptrs) {
+        free(tree_ptr->menu_element_ptrs);
+        tree_ptr->menu_element_ptrs = NULL;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates a column of rectangles, laid out like the uniform menu. Their
+ * dimensions and pointer areas are read inline, not through the vmt: Compare
+ * with the fake elements of the menu, which dispatch through the vmt.
+ */
+bool bench_leaves_init(bench_tree_t *tree_ptr)
+{
+    tree_ptr->rectangle_ptrs = logged_calloc(
+        bench_menu_items, sizeof(wlmtk_rectangle_t*));
+    if (NULL == tree_ptr->rectangle_ptrs) return false;
+
+    wlmtk_box_t *box_ptr = &tree_ptr->leaf_box;
+    if (!wlmtk_box_init(box_ptr, WLMTK_BOX_VERTICAL,
+                        &bench_menu_margin_style)) return false;
+    for (size_t k = 0; k < bench_menu_items; ++k) {
+        wlmtk_rectangle_t *r_ptr = wlmtk_rectangle_create(
+            bench_width, bench_height, 0xff4080c0);
+        if (NULL == r_ptr) return false;
+        tree_ptr->rectangle_ptrs[k] = r_ptr;
+        wlmtk_element_set_visible(wlmtk_rectangle_element(r_ptr), true);
+        wlmtk_box_add_element_back(box_ptr, wlmtk_rectangle_element(r_ptr));
+    }
+    wlmtk_element_set_visible(&box_ptr->super_container.super_element, true);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the column of rectangles. */
+void bench_leaves_fini(bench_tree_t *tree_ptr)
+{
+    wlmtk_box_t *box_ptr = &tree_ptr->leaf_box;
+    for (size_t k = 0;
+         NULL != tree_ptr->rectangle_ptrs && k < bench_menu_items;
+         ++k) {
+        wlmtk_rectangle_t *r_ptr = tree_ptr->rectangle_ptrs[k];
+        if (NULL == r_ptr) continue;
+        wlmtk_element_t *element_ptr = wlmtk_rectangle_element(r_ptr);
+        if (NULL != element_ptr->parent_container_ptr) {
+            wlmtk_box_remove_element(box_ptr, element_ptr);
+        }
+        wlmtk_rectangle_destroy(r_ptr);
+    }
+    if (NULL != box_ptr->super_container.vmt.update_layout) {
+        wlmtk_box_fini(box_ptr);
+    }
+    if (NULL != tree_ptr->rectangle_ptrs) {
+        free(tree_ptr->rectangle_ptrs);
+        tree_ptr->rectangle_ptrs = NULL;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the tree. */
+void bench_tree_fini(bench_tree_t *tree_ptr)
+{
+    bench_leaves_fini(tree_ptr);
+    bench_menus_fini(tree_ptr);
+    if (NULL != tree_ptr->fill_cairo_ptr) {
+        cairo_destroy(tree_ptr->fill_cairo_ptr);
+        tree_ptr->fill_cairo_ptr = NULL;
+    }
+    if (NULL != tree_ptr->fill_gfxbuf_ptr) {
+        bs_gfxbuf_destroy(tree_ptr->fill_gfxbuf_ptr);
+        tree_ptr->fill_gfxbuf_ptr = NULL;
+    }
+
+    for (size_t w = 0; NULL != tree_ptr->boxes_ptr && w < tree_ptr->windows;
+         ++w) {
+        wlmtk_box_t *box_ptr = &tree_ptr->boxes_ptr[w];
+        wlmtk_element_t *element_ptr = &box_ptr->super_container.super_element;
+        if (NULL != element_ptr->parent_container_ptr) {
+            wlmtk_container_remove_element(
+                element_ptr->parent_container_ptr, element_ptr);
+        }
+        for (size_t d = 0;
+             NULL != tree_ptr->fake_element_ptrs && d < tree_ptr->decorations;
+             ++d) {
+            wlmtk_fake_element_t *fe_ptr =
+                tree_ptr->fake_element_ptrs[w * tree_ptr->decorations + d];
+            if (NULL == fe_ptr) continue;
+            if (NULL != fe_ptr->element.parent_container_ptr) {
+                wlmtk_box_remove_element(box_ptr, &fe_ptr->element);
+            }
+            wlmtk_element_destroy(&fe_ptr->element);
+        }
+        // Boxes are zero-initialized: Skip those never initialized.
+        if (NULL != box_ptr->super_container.vmt.update_layout) {
+            wlmtk_box_fini(box_ptr);
+        }
+    }
+
+    if (NULL != tree_ptr->fake_element_ptrs) {
+        free(tree_ptr->fake_element_ptrs);
+        tree_ptr->fake_element_ptrs = NULL;
+    }
+    if (NULL != tree_ptr->boxes_ptr) {
+        free(tree_ptr->boxes_ptr);
+        tree_ptr->boxes_ptr = NULL;
+    }
+    if (NULL != tree_ptr->parent_ptr) {
+        wlmtk_container_destroy_fake_parent(tree_ptr->parent_ptr);
+        tree_ptr->parent_ptr = NULL;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns a monotonic timestamp, in nanoseconds. */
+uint64_t bench_nsec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Counts visits to the decorations and margins of all windows: Each visit
+ * reads the element's pointer area. The margins get the empty pointer area
+ * they had before they were input transparent, so that an opaque margin
+ * costs what it did then.
+ */
+void bench_visits_init(bench_tree_t *tree_ptr)
+{
+    for (size_t w = 0; w < tree_ptr->windows; ++w) {
+        wlmtk_element_extend(&tree_ptr->boxes_ptr[w].margin_element,
+                             &bench_visit_margin_vmt);
+        for (size_t d = 0; d < tree_ptr->decorations; ++d) {
+            bench_fake_vmt = wlmtk_element_extend(
+                &tree_ptr->fake_element_ptrs[
+                    w * tree_ptr->decorations + d]->element,
+                &bench_visit_fake_vmt);
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Sweeps the pointer over every row of the windows, margins included, and
+ * returns the average number of elements visited per motion.
+ *
+ * @param tree_ptr
+ * @param iterations
+ * @param input_transparent   Whether the windows' margins are set input
+ *                            transparent.
+ */
+double bench_visits_per_motion(
+    bench_tree_t *tree_ptr,
+    size_t iterations,
+    bool input_transparent)
+{
+    for (size_t w = 0; w < tree_ptr->windows; ++w) {
+        wlmtk_element_set_input_transparent(
+            &tree_ptr->boxes_ptr[w].margin_element, input_transparent);
+    }
+    // Leaves out the visits for rebuilding the child arrays.
+    for (size_t i = 0; i < BS_MIN(iterations, 100u); ++i) {
+        bench_pointer_sweep(tree_ptr, i);
+    }
+    bench_visits = 0;
+    for (size_t i = 0; i < iterations; ++i) bench_pointer_sweep(tree_ptr, i);
+    return (double)bench_visits / (double)iterations;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Counts the visit, and forwards to the fake element's implementation. */
+void bench_visit_fake_get_pointer_area(
+    wlmtk_element_t *element_ptr,
+    int *x1_ptr,
+    int *y1_ptr,
+    int *x2_ptr,
+    int *y2_ptr)
+{
+    ++bench_visits;
+    bench_fake_vmt.get_pointer_area(
+        element_ptr, x1_ptr, y1_ptr, x2_ptr, y2_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Counts the visit. The pointer area is empty. */
+void bench_visit_margin_get_pointer_area(
+    __UNUSED__ wlmtk_element_t *element_ptr,
+    int *x1_ptr,
+    int *y1_ptr,
+    int *x2_ptr,
+    int *y2_ptr)
+{
+    ++bench_visits;
+    if (NULL != x1_ptr) *x1_ptr = 0;
+    if (NULL != y1_ptr) *y1_ptr = 0;
+    if (NULL != x2_ptr) *x2_ptr = 0;
+    if (NULL != y2_ptr) *y2_ptr = 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Moves the pointer across windows & decorations. */
+void bench_pointer_motion(bench_tree_t *tree_ptr, size_t i)
+{
+    size_t w = i % tree_ptr->windows;
+    size_t d = (i / tree_ptr->windows) % tree_ptr->decorations;
+    wlmtk_pointer_motion_event_t e = {
+        .x = (w % bench_columns) * (bench_width + 20) + (i % bench_width),
+        .y = ((w / bench_columns) *
+              (tree_ptr->decorations * (bench_height + 1) + 20) +
+              d * (bench_height + 1) + bench_height / 2),
+        .time_msec = i
+    };
+    wlmtk_element_pointer_motion(&tree_ptr->parent_ptr->super_element, &e);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Moves the pointer across windows, over every row: Also the margins. */
+void bench_pointer_sweep(bench_tree_t *tree_ptr, size_t i)
+{
+    size_t rows = tree_ptr->decorations * (bench_height + 1);
+    size_t w = i % tree_ptr->windows;
+    size_t row = (i / tree_ptr->windows) % rows;
+    wlmtk_pointer_motion_event_t e = {
+        .x = (w % bench_columns) * (bench_width + 20) + (i % bench_width),
+        .y = (w / bench_columns) * (rows + 20) + row,
+        .time_msec = i
+    };
+    wlmtk_element_pointer_motion(&tree_ptr->parent_ptr->super_element, &e);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Alternates button down and up events, at the current pointer position. */
+void bench_pointer_button(bench_tree_t *tree_ptr, size_t i)
+{
+    wlmtk_button_event_t e = {
+        .button = BTN_LEFT,
+        .type = (i & 1) ? WLMTK_BUTTON_UP : WLMTK_BUTTON_DOWN,
+        .time_msec = i
+    };
+    wlmtk_element_pointer_button(&tree_ptr->parent_ptr->super_element, &e);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Dimensions of the parent, after a decoration reported a change. */
+void bench_get_dimensions(bench_tree_t *tree_ptr, size_t i)
+{
+    size_t n = tree_ptr->windows * tree_ptr->decorations;
+    wlmtk_element_invalidate_extents(
+        &tree_ptr->fake_element_ptrs[i % n]->element);
+    wlmtk_element_get_dimensions_box(&tree_ptr->parent_ptr->super_element);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Dimensions of the parent, without changes. */
+void bench_get_dimensions_cached(bench_tree_t *tree_ptr,
+                                 __UNUSED__ size_t i)
+{
+    wlmtk_element_get_dimensions_box(&tree_ptr->parent_ptr->super_element);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Raises the windows to top, one after another. */
+void bench_raise_to_top(bench_tree_t *tree_ptr, size_t i)
+{
+    wlmtk_box_t *box_ptr = &tree_ptr->boxes_ptr[i % tree_ptr->windows];
+    wlmtk_container_raise_element_to_top(
+        tree_ptr->parent_ptr, &box_ptr->super_container.super_element);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Removes a window, and adds it back. */
+void bench_add_remove(bench_tree_t *tree_ptr, size_t i)
+{
+    wlmtk_box_t *box_ptr = &tree_ptr->boxes_ptr[i % tree_ptr->windows];
+    wlmtk_element_t *element_ptr = &box_ptr->super_container.super_element;
+    wlmtk_container_remove_element(tree_ptr->parent_ptr, element_ptr);
+    wlmtk_container_add_element(tree_ptr->parent_ptr, element_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Resizes all decorations of a window, and lays it out again. */
+void bench_window_resize(bench_tree_t *tree_ptr, size_t i)
+{
+    size_t w = i % tree_ptr->windows;
+    int width = bench_width + (int)(i % 7) - 3;
+    for (size_t d = 0; d < tree_ptr->decorations; ++d) {
+        wlmtk_fake_element_t *fe_ptr =
+            tree_ptr->fake_element_ptrs[w * tree_ptr->decorations + d];
+        fe_ptr->dimensions.width = width;
+        wlmtk_element_invalidate_extents(&fe_ptr->element);
+    }
+    wlmtk_container_update_layout(
+        &tree_ptr->boxes_ptr[w].super_container);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Drags the first window by a few pixels, followed by the pointer motion
+ * that caused it. Puts the window back into place after each lap.
+ *
+ * @param tree_ptr
+ * @param i
+ * @param translate           Whether to use the translation fast path.
+ */
+void bench_drag(bench_tree_t *tree_ptr, size_t i, bool translate)
+{
+    wlmtk_element_t *element_ptr =
+        &tree_ptr->boxes_ptr[0].super_container.super_element;
+    int x = i % 16, y = (i / 2) % 16;
+    if (translate) {
+        wlmtk_container_translate_element(
+            tree_ptr->parent_ptr, element_ptr, x, y);
+    } else {
+        wlmtk_element_set_position(element_ptr, x, y);
+    }
+
+    wlmtk_pointer_motion_event_t e = {
+        .x = x + bench_width / 2,
+        .y = y + bench_height / 2,
+        .time_msec = i
+    };
+    wlmtk_element_pointer_motion(&tree_ptr->parent_ptr->super_element, &e);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Drags a window using @ref wlmtk_element_set_position. */
+void bench_drag_set_position(bench_tree_t *tree_ptr, size_t i)
+{
+    bench_drag(tree_ptr, i, false);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Drags a window using @ref wlmtk_container_translate_element. */
+void bench_drag_translate(bench_tree_t *tree_ptr, size_t i)
+{
+    bench_drag(tree_ptr, i, true);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Moves the pointer from item to item of menu `m`. */
+void bench_menu_motion(bench_tree_t *tree_ptr, size_t i, size_t m)
+{
+    wlmtk_fake_element_t *fe_ptr = tree_ptr->menu_element_ptrs[
+        m * bench_menu_items + (i * 7) % bench_menu_items];
+    int x, y;
+    wlmtk_element_get_position(&fe_ptr->element, &x, &y);
+    wlmtk_pointer_motion_event_t e = {
+        .x = x + bench_width / 2,
+        .y = y + fe_ptr->dimensions.height / 2,
+        .time_msec = i
+    };
+    wlmtk_element_pointer_motion(
+        &tree_ptr->menu_boxes[m].super_container.super_element, &e);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Pointer motion across a menu of uniform items: Computes the index. */
+void bench_menu_motion_uniform(bench_tree_t *tree_ptr, size_t i)
+{
+    bench_menu_motion(tree_ptr, i, 0);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Pointer motion across a menu of non-uniform items: Searches. */
+void bench_menu_motion_nonuniform(bench_tree_t *tree_ptr, size_t i)
+{
+    bench_menu_motion(tree_ptr, i, 1);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Dimensions of the uniform menu, after one of its items changed. */
+void bench_leaf_dimensions_fake(bench_tree_t *tree_ptr, size_t i)
+{
+    wlmtk_element_invalidate_extents(
+        &tree_ptr->menu_element_ptrs[i % bench_menu_items]->element);
+    wlmtk_element_get_dimensions_box(
+        &tree_ptr->menu_boxes[0].super_container.super_element);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Same as @ref bench_leaf_dimensions_fake, for the rectangles. */
+void bench_leaf_dimensions_rectangle(bench_tree_t *tree_ptr, size_t i)
+{
+    wlmtk_element_invalidate_extents(
+        wlmtk_rectangle_element(tree_ptr->rectangle_ptrs[
+                                    i % bench_menu_items]));
+    wlmtk_element_get_dimensions_box(
+        &tree_ptr->leaf_box.super_container.super_element);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Pointer motion across the rectangles. Compare to the uniform menu. */
+void bench_leaf_motion_rectangle(bench_tree_t *tree_ptr, size_t i)
+{
+    wlmtk_element_t *element_ptr = wlmtk_rectangle_element(
+        tree_ptr->rectangle_ptrs[(i * 7) % bench_menu_items]);
+    int x, y;
+    wlmtk_element_get_position(element_ptr, &x, &y);
+    wlmtk_pointer_motion_event_t e = {
+        .x = x + bench_width / 2,
+        .y = y + bench_height / 2,
+        .time_msec = i
+    };
+    wlmtk_element_pointer_motion(
+        &tree_ptr->leaf_box.super_container.super_element, &e);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Fills the buffer with a solid color, using cairo. */
+void bench_fill_solid_cairo(bench_tree_t *tree_ptr, __UNUSED__ size_t i)
+{
+    wlmaker_primitives_cairo_fill(tree_ptr->fill_cairo_ptr, &bench_fill_solid);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Fills the buffer with a solid color, using the native path. */
+void bench_fill_solid_native(bench_tree_t *tree_ptr, __UNUSED__ size_t i)
+{
+    wlmaker_primitives_gfxbuf_fill(
+        tree_ptr->fill_gfxbuf_ptr, &bench_fill_solid);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Fills the buffer with a horizontal gradient, using cairo. */
+void bench_fill_hgradient_cairo(bench_tree_t *tree_ptr, __UNUSED__ size_t i)
+{
+    wlmaker_primitives_cairo_fill(
+        tree_ptr->fill_cairo_ptr, &bench_fill_hgradient);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Fills the buffer with a horizontal gradient, using the native path. */
+void bench_fill_hgradient_native(bench_tree_t *tree_ptr, __UNUSED__ size_t i)
+{
+    wlmaker_primitives_gfxbuf_fill(
+        tree_ptr->fill_gfxbuf_ptr, &bench_fill_hgradient);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Fills the buffer with a vertical gradient, using cairo. */
+void bench_fill_vgradient_cairo(bench_tree_t *tree_ptr, __UNUSED__ size_t i)
+{
+    wlmaker_primitives_cairo_fill(
+        tree_ptr->fill_cairo_ptr, &bench_fill_vgradient);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Fills the buffer with a vertical gradient, using the native path. */
+void bench_fill_vgradient_native(bench_tree_t *tree_ptr, __UNUSED__ size_t i)
+{
+    wlmaker_primitives_gfxbuf_fill(
+        tree_ptr->fill_gfxbuf_ptr, &bench_fill_vgradient);
+}
+
+/* == End of wlmtk_bench.c ================================================= */